@@ -0,0 +1,39 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <rgl/api/core.h>
+
+/******************************** NODES ********************************/
+
+/**
+ * Creates or modifies GlVisualizePointsNode.
+ * The node shows the point cloud of its input in a window, rendered with OpenGL directly from GPU memory:
+ * points are copied into an OpenGL buffer mapped to CUDA (CUDA-GL interop), without copying them to the host.
+ * Points are colored by height (Z), with the color scale repeated every color_height_period.
+ * The view is controlled with the mouse: dragging rotates it around the origin, scrolling zooms it.
+ * Windows are managed by a separate thread; closing the window makes the node do nothing.
+ * OpenGL has to be provided by the same GPU as used by RGL.
+ * Graph input: point cloud
+ * Graph output: none
+ * @param node If (*node) == nullptr, a new node will be created. Otherwise, (*node) will be modified.
+ * @param window_name The window name.
+ * @param window_width The window width.
+ * @param window_height The window height.
+ * @param color_height_period Height (in distance units) of the color scale, must be positive.
+ */
+RGL_API rgl_status_t rgl_node_points_visualize_gl(rgl_node_t* node, const char* window_name, int32_t window_width,
+                                                  int32_t window_height, float color_height_period);
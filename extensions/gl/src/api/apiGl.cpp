@@ -0,0 +1,51 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <rgl/api/extensions/gl.h>
+#include <api/apiCommon.hpp>
+#include <graph/NodesGl.hpp>
+#include <tape/TapeGl.hpp>
+
+extern "C" {
+
+RGL_API rgl_status_t rgl_node_points_visualize_gl(rgl_node_t* node, const char* window_name, int32_t window_width,
+                                                  int32_t window_height, float color_height_period)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_visualize_gl(node={}, window_name={}, window_width={}, window_height={}, "
+		            "color_height_period={})",
+		            repr(node), window_name, window_width, window_height, color_height_period);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(window_name != nullptr);
+		CHECK_ARG(window_name[0] != '\0');
+		CHECK_ARG(window_width > 0);
+		CHECK_ARG(window_height > 0);
+		CHECK_ARG(color_height_period > 0.0f);
+
+		createOrUpdateNode<GlVisualizePointsNode>(node, window_name, window_width, window_height, color_height_period);
+	});
+	TAPE_HOOK(node, window_name, window_width, window_height, color_height_period);
+	return status;
+}
+
+void TapeGl::tape_node_points_visualize_gl(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_visualize_gl(&node, yamlNode[1].as<std::string>().c_str(), yamlNode[2].as<int32_t>(),
+	                             yamlNode[3].as<int32_t>(), yamlNode[4].as<float>());
+	state.nodes.insert({nodeId, node});
+}
+}
@@ -0,0 +1,255 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <cmath>
+
+#define GLFW_INCLUDE_GLEXT
+#include <GLFW/glfw3.h>
+#include <cuda_gl_interop.h>
+
+#include <graph/NodesGl.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <macros/cuda.hpp>
+#include <ThreadConfig.hpp>
+
+// Buffer objects are not a part of OpenGL 1.1 ABI, their functions are loaded once a context is current.
+static struct
+{
+	PFNGLGENBUFFERSPROC genBuffers{nullptr};
+	PFNGLBINDBUFFERPROC bindBuffer{nullptr};
+	PFNGLBUFFERDATAPROC bufferData{nullptr};
+	PFNGLDELETEBUFFERSPROC deleteBuffers{nullptr};
+} gl;
+
+void GlVisualizePointsNode::setParameters(const char* windowName, int windowWidth, int windowHeight, float colorHeightPeriod)
+{
+	if (viewer != nullptr) {
+		throw std::invalid_argument("GlVisualizePointsNode parameters cannot be changed!");
+	}
+	viewer = std::make_shared<Viewer>();
+	viewer->windowName = windowName;
+	viewer->windowWidth = windowWidth;
+	viewer->windowHeight = windowHeight;
+	viewer->colorHeightPeriod = colorHeightPeriod;
+	viewer->stagedPoints = DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::create(arrayMgr);
+
+	ViewerThread& thread = getViewerThread();
+	std::lock_guard lock{thread.viewersMutex};
+	thread.viewers.push_back(viewer);
+}
+
+void GlVisualizePointsNode::enqueueExecImpl()
+{
+	if (viewer->isClosed) {
+		return; // No need to update points because the window was closed
+	}
+	std::lock_guard lock{viewer->stagingMutex};
+	CHECK_CUDA(cudaStreamWaitEvent(getStreamHandle(), viewer->consumedEvent->getHandle()));
+	viewer->stagedPoints->copyFrom(input->getFieldData(XYZ_VEC3_F32));
+	CHECK_CUDA(cudaEventRecord(viewer->stagedEvent->getHandle(), getStreamHandle()));
+	viewer->hasStagedPoints = true;
+}
+
+GlVisualizePointsNode::~GlVisualizePointsNode()
+{
+	// The viewer thread closes the window, keeping the viewer until then.
+	if (viewer != nullptr) {
+		viewer->closeRequested = true;
+	}
+}
+
+GlVisualizePointsNode::ViewerThread& GlVisualizePointsNode::getViewerThread()
+{
+	static ViewerThread viewerThread;
+	return viewerThread;
+}
+
+void GlVisualizePointsNode::ViewerThread::runViewers()
+try {
+	ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-gl-viewer"};
+	if (glfwInit() != GLFW_TRUE) {
+		throw std::runtime_error("failed to initialize GLFW");
+	}
+	CudaStream::Ptr stream = CudaStream::create(cudaStreamNonBlocking);
+	while (!shouldQuit) {
+		std::vector<Viewer::Ptr> currentViewers;
+		{
+			std::lock_guard lock{viewersMutex};
+			currentViewers.assign(viewers.begin(), viewers.end());
+		}
+		for (auto&& viewer : currentViewers) {
+			if (viewer->window == nullptr) {
+				viewer->open();
+			}
+			// Remove viewer if requested, either by user (GUI) or the node
+			if (viewer->closeRequested || glfwWindowShouldClose(viewer->window)) {
+				viewer->close();
+				viewer->isClosed = true;
+				std::lock_guard lock{viewersMutex};
+				viewers.remove(viewer);
+				continue;
+			}
+			viewer->updatePoints(stream->getHandle());
+			viewer->draw();
+		}
+		glfwWaitEventsTimeout(1.0 / FRAME_RATE);
+	}
+	std::lock_guard lock{viewersMutex};
+	for (auto&& viewer : viewers) {
+		if (viewer->window != nullptr) {
+			viewer->close();
+		}
+		viewer->isClosed = true;
+	}
+	glfwTerminate();
+}
+catch (std::exception& e) {
+	RGL_WARN("GL viewer thread captured exception: {}", e.what());
+}
+catch (...) {
+	RGL_WARN("GL viewer thread captured unknown exception :((");
+}
+
+void GlVisualizePointsNode::Viewer::open()
+{
+	window = glfwCreateWindow(windowWidth, windowHeight, windowName.c_str(), nullptr, nullptr);
+	if (window == nullptr) {
+		throw std::runtime_error(fmt::format("failed to create window '{}'", windowName));
+	}
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0); // Frame rate is limited by the viewer thread, which serves all windows
+	if (gl.genBuffers == nullptr) {
+		gl.genBuffers = reinterpret_cast<PFNGLGENBUFFERSPROC>(glfwGetProcAddress("glGenBuffers"));
+		gl.bindBuffer = reinterpret_cast<PFNGLBINDBUFFERPROC>(glfwGetProcAddress("glBindBuffer"));
+		gl.bufferData = reinterpret_cast<PFNGLBUFFERDATAPROC>(glfwGetProcAddress("glBufferData"));
+		gl.deleteBuffers = reinterpret_cast<PFNGLDELETEBUFFERSPROC>(glfwGetProcAddress("glDeleteBuffers"));
+	}
+
+	// Dragging (with any button) rotates the view around the origin, scrolling zooms it.
+	glfwSetWindowUserPointer(window, this);
+	glfwSetCursorPosCallback(window, [](GLFWwindow* window, double x, double y) {
+		auto* viewer = static_cast<Viewer*>(glfwGetWindowUserPointer(window));
+		bool isDragged = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS ||
+		                 glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+		if (isDragged && viewer->dragCursorPos.has_value()) {
+			viewer->cameraYaw += static_cast<float>(x - viewer->dragCursorPos->first) * 0.3f;
+			viewer->cameraPitch += static_cast<float>(y - viewer->dragCursorPos->second) * 0.3f;
+			viewer->cameraPitch = std::clamp(viewer->cameraPitch, -89.0f, 89.0f);
+		}
+		viewer->dragCursorPos = isDragged ? std::optional{std::pair{x, y}} : std::nullopt;
+	});
+	glfwSetScrollCallback(window, [](GLFWwindow* window, double, double yOffset) {
+		auto* viewer = static_cast<Viewer*>(glfwGetWindowUserPointer(window));
+		viewer->cameraDistance *= std::pow(0.9f, static_cast<float>(yOffset));
+	});
+}
+
+void GlVisualizePointsNode::Viewer::updatePoints(cudaStream_t stream)
+{
+	std::lock_guard lock{stagingMutex};
+	if (!hasStagedPoints) {
+		return;
+	}
+	hasStagedPoints = false;
+	glfwMakeContextCurrent(window);
+
+	// Buffer grows geometrically; registration is done again for the new storage.
+	std::size_t pointCount = stagedPoints->getCount();
+	if (bufferCapacity < pointCount) {
+		if (bufferResource != nullptr) {
+			CHECK_CUDA(cudaGraphicsUnregisterResource(bufferResource));
+		}
+		if (buffer == 0) {
+			gl.genBuffers(1, &buffer);
+		}
+		bufferCapacity = std::max(pointCount, 2 * bufferCapacity);
+		gl.bindBuffer(GL_ARRAY_BUFFER, buffer);
+		gl.bufferData(GL_ARRAY_BUFFER, bufferCapacity * (sizeof(Field<XYZ_VEC3_F32>::type) + sizeof(uint32_t)), nullptr,
+		              GL_DYNAMIC_DRAW);
+		gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+		CHECK_CUDA(cudaGraphicsGLRegisterBuffer(&bufferResource, buffer, cudaGraphicsRegisterFlagsWriteDiscard));
+	}
+
+	CHECK_CUDA(cudaStreamWaitEvent(stream, stagedEvent->getHandle()));
+	if (pointCount > 0) {
+		// Mapping waits for OpenGL commands reading the buffer, unmapping makes OpenGL wait for the copy.
+		CHECK_CUDA(cudaGraphicsMapResources(1, &bufferResource, stream));
+		void* mappedPtr = nullptr;
+		std::size_t mappedSize = 0;
+		CHECK_CUDA(cudaGraphicsResourceGetMappedPointer(&mappedPtr, &mappedSize, bufferResource));
+		auto* positions = static_cast<Field<XYZ_VEC3_F32>::type*>(mappedPtr);
+		auto* colors = reinterpret_cast<uint32_t*>(positions + bufferCapacity);
+		CHECK_CUDA(cudaMemcpyAsync(positions, stagedPoints->getReadPtr(), pointCount * sizeof(Field<XYZ_VEC3_F32>::type),
+		                           cudaMemcpyDeviceToDevice, stream));
+		gpuColorizeByHeight(stream, pointCount, stagedPoints->getReadPtr(), colorHeightPeriod, colors);
+		CHECK_CUDA(cudaGraphicsUnmapResources(1, &bufferResource, stream));
+	}
+	CHECK_CUDA(cudaEventRecord(consumedEvent->getHandle(), stream));
+	drawnPointCount = pointCount;
+}
+
+void GlVisualizePointsNode::Viewer::draw()
+{
+	glfwMakeContextCurrent(window);
+	int width = 0, height = 0;
+	glfwGetFramebufferSize(window, &width, &height);
+	glViewport(0, 0, width, height);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glEnable(GL_DEPTH_TEST);
+
+	// Perspective camera orbiting the origin, with Z axis up.
+	constexpr float Z_NEAR = 0.1f, Z_FAR = 1000.0f, HALF_FOV_TAN = 0.5f;
+	float top = Z_NEAR * HALF_FOV_TAN;
+	float right = top * (height > 0 ? static_cast<float>(width) / static_cast<float>(height) : 1.0f);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glFrustum(-right, right, -top, top, Z_NEAR, Z_FAR);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+	glTranslatef(0.0f, 0.0f, -cameraDistance);
+	glRotatef(cameraPitch - 90.0f, 1.0f, 0.0f, 0.0f);
+	glRotatef(cameraYaw, 0.0f, 0.0f, 1.0f);
+
+	if (drawnPointCount > 0) {
+		gl.bindBuffer(GL_ARRAY_BUFFER, buffer);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(3, GL_FLOAT, 0, nullptr);
+		std::size_t colorsOffset = bufferCapacity * sizeof(Field<XYZ_VEC3_F32>::type);
+		glColorPointer(4, GL_UNSIGNED_BYTE, 0, reinterpret_cast<const void*>(colorsOffset));
+		glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(drawnPointCount));
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	glfwSwapBuffers(window);
+}
+
+void GlVisualizePointsNode::Viewer::close()
+{
+	glfwMakeContextCurrent(window);
+	if (bufferResource != nullptr) {
+		CHECK_CUDA(cudaGraphicsUnregisterResource(bufferResource));
+		bufferResource = nullptr;
+	}
+	if (buffer != 0) {
+		gl.deleteBuffers(1, &buffer);
+		buffer = 0;
+	}
+	glfwDestroyWindow(window);
+	window = nullptr;
+}
@@ -0,0 +1,109 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <graph/Node.hpp>
+#include <graph/Interfaces.hpp>
+#include <CudaEvent.hpp>
+
+struct GLFWwindow;
+
+struct GlVisualizePointsNode : IPointsNodeSingleInput
+{
+	static const int FRAME_RATE = 60;
+	using Ptr = std::shared_ptr<GlVisualizePointsNode>;
+	void setParameters(const char* windowName, int windowWidth, int windowHeight, float colorHeightPeriod);
+
+	// Node
+	void enqueueExecImpl() override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+	virtual ~GlVisualizePointsNode();
+
+private:
+	// Window of the node, shared with the viewer thread, so that the node may be destroyed without waiting for it.
+	// Points are staged by the graph thread in device memory and copied by the viewer thread into the OpenGL buffer
+	// mapped to CUDA; both copies are ordered with events on the GPU, so that neither thread waits for the other's work.
+	struct Viewer
+	{
+		using Ptr = std::shared_ptr<Viewer>;
+
+		std::string windowName;
+		int windowWidth;
+		int windowHeight;
+		float colorHeightPeriod;
+
+		// Staging: graph thread waits (in its stream) for consumedEvent before overwriting stagedPoints,
+		// viewer thread waits (in its stream) for stagedEvent before reading them.
+		std::mutex stagingMutex;
+		DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr stagedPoints;
+		CudaEvent::Ptr stagedEvent = CudaEvent::create();
+		CudaEvent::Ptr consumedEvent = CudaEvent::create();
+		bool hasStagedPoints{false};
+
+		std::atomic<bool> closeRequested{false}; // By the node on destruction
+		std::atomic<bool> isClosed{false};       // By the viewer thread, e.g. when the user closed the window
+
+		// Accessed only by the viewer thread
+		GLFWwindow* window{nullptr};
+		unsigned int buffer{0}; // Positions of bufferCapacity points, followed by their colors (RGBA8)
+		std::size_t bufferCapacity{0};
+		cudaGraphicsResource_t bufferResource{nullptr};
+		std::size_t drawnPointCount{0};
+		float cameraYaw{-45.0f};
+		float cameraPitch{30.0f};
+		float cameraDistance{10.0f};
+		std::optional<std::pair<double, double>> dragCursorPos;
+
+		void open();
+		void updatePoints(cudaStream_t stream);
+		void draw();
+		void close();
+	};
+
+	Viewer::Ptr viewer;
+
+	// All calls to GLFW and OpenGL are made from a single thread, serving all windows.
+	struct ViewerThread
+	{
+		void runViewers();
+		ViewerThread() { thread = std::thread(&ViewerThread::runViewers, this); }
+		~ViewerThread()
+		{
+			// This might be called when the main thread is doing exit
+			shouldQuit = true;
+			thread.join();
+		}
+
+		std::thread thread;
+		std::atomic<bool> shouldQuit{false};
+		std::mutex viewersMutex;
+
+		// Adding: client thread
+		// Removing: viewer thread
+		std::list<Viewer::Ptr> viewers;
+	};
+
+	static ViewerThread& getViewerThread(); // Started on first use, thread-safe
+};
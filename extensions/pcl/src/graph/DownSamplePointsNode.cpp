@@ -40,45 +40,39 @@ void DownSamplePointsNode::enqueueExecImpl()
 		return;
 	}
 
-	// Get formatted input data (SSE2-aligned XYZ)
+	// Get formatted input data (SSE2-aligned XYZ), downloaded directly into the persistent cloud
 	FormatPointsNode::formatAsync(formattedInput, input, getRequiredFieldList(), gpuFieldDescBuilder);
-	formattedInputHst->copyFrom(formattedInput);
-
-	// Copy data into pcl::PointCloud
-	auto pointCount = input->getPointCount();
-	auto toFilter = std::make_shared<pcl::PointCloud<PCLPoint>>();
-	toFilter->reserve(pointCount);
-	const PCLPoint* begin = reinterpret_cast<const PCLPoint*>(formattedInputHst->getReadPtr());
-	const PCLPoint* end = begin + pointCount;
-	toFilter->assign(begin, end, pointCount);
+	toFilter.resize(input->getPointCount());
+	toFilter.enqueueDownload(formattedInput->getReadPtr(), getStreamHandle());
+	CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
 
 	// Set indices that will help find out which points have been removed
-	for (int i = 0; i < toFilter->size(); ++i) {
-		toFilter->points[i].label = i;
+	for (int i = 0; i < toFilter.cloud->size(); ++i) {
+		toFilter.cloud->points[i].label = i;
 	}
 	pcl::VoxelGrid<PCLPoint> voxelGrid{};
-	voxelGrid.setInputCloud(toFilter);
+	voxelGrid.setInputCloud(toFilter.cloud);
 	voxelGrid.setLeafSize(leafDims.x(), leafDims.y(), leafDims.z());
 
-	// Perform filtering
-	auto filtered = std::make_shared<pcl::PointCloud<PCLPoint>>();
-	voxelGrid.filter(*filtered);
+	// Perform filtering (output cloud keeps its storage between frames)
+	voxelGrid.filter(filteredCloud);
 
 	// Warn if nothing changed
-	bool pclReduced = filtered->size() < toFilter->size();
+	bool pclReduced = filteredCloud.size() < toFilter.cloud->size();
 	if (!pclReduced) {
-		auto details = fmt::format("original: {}; filtered: {}; leafDims: {}", toFilter->size(), filtered->size(), leafDims);
+		auto details = fmt::format("original: {}; filtered: {}; leafDims: {}", toFilter.cloud->size(), filteredCloud.size(),
+		                           leafDims);
 		RGL_WARN("Down-sampling node had no effect! ({})", details);
 	}
-	filteredPoints->copyFromExternal(filtered->data(), filtered->size());
-	filteredIndices->resize(filtered->size(), false, false);
+	filteredPoints->copyFromExternal(filteredCloud.data(), filteredCloud.size());
+	filteredIndices->resize(filteredCloud.size(), false, false);
 
 	size_t offset = offsetof(PCLPoint, label);
 	size_t stride = sizeof(PCLPoint);
 	size_t size = sizeof(PCLPoint::label);
 	auto&& dst = reinterpret_cast<char*>(filteredIndices->getWritePtr());
 	auto&& src = reinterpret_cast<const char*>(filteredPoints->getReadPtr());
-	gpuCutField(getStreamHandle(), filtered->size(), dst, src, offset, stride, size);
+	gpuCutField(getStreamHandle(), filteredCloud.size(), dst, src, offset, stride, size);
 
 	// getFieldData may be called in client's thread from rgl_graph_get_result_data
 	// Doing job there would be:
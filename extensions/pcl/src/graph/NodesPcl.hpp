@@ -24,6 +24,7 @@
 #include <graph/Node.hpp>
 #include <graph/Interfaces.hpp>
 #include <graph/PCLVisualizerFix.hpp>
+#include <graph/PinnedPointCloud.hpp>
 #include <CacheManager.hpp>
 
 struct DownSamplePointsNode : IPointsNodeSingleInput
@@ -34,6 +35,7 @@ struct DownSamplePointsNode : IPointsNodeSingleInput
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override;
+	bool isHostCompute() const override { return true; }
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override;
@@ -49,7 +51,8 @@ struct DownSamplePointsNode : IPointsNodeSingleInput
 private:
 	Vec3f leafDims;
 	DeviceAsyncArray<char>::Ptr formattedInput = DeviceAsyncArray<char>::create(arrayMgr);
-	HostPinnedArray<char>::Ptr formattedInputHst = HostPinnedArray<char>::create();
+	PinnedPointCloud<pcl::PointXYZL> toFilter;
+	pcl::PointCloud<pcl::PointXYZL> filteredCloud;
 	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr filteredIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(
 	    arrayMgr);
 	DeviceAsyncArray<pcl::PointXYZL>::Ptr filteredPoints = DeviceAsyncArray<pcl::PointXYZL>::create(arrayMgr);
@@ -67,6 +70,7 @@ struct RemoveGroundPointsNode : IPointsNodeSingleInput
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override;
+	bool isHostCompute() const override { return true; }
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override;
@@ -84,10 +88,9 @@ private:
 	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr filteredIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(
 	    arrayMgr);
 	DeviceAsyncArray<char>::Ptr formattedInput = DeviceAsyncArray<char>::create(arrayMgr);
-	HostPinnedArray<char>::Ptr formattedInputHost = HostPinnedArray<char>::create();
 
 	// PCL members
-	pcl::PointCloud<pcl::PointXYZ>::Ptr toFilterPointCloud = std::make_shared<pcl::PointCloud<pcl::PointXYZ>>();
+	PinnedPointCloud<pcl::PointXYZ> toFilter;
 	pcl::PointIndices::Ptr groundIndices = std::make_shared<pcl::PointIndices>();
 	pcl::ModelCoefficients planeCoefficients;
 	pcl::SACSegmentation<pcl::PointXYZ> segmentation;
@@ -108,6 +111,7 @@ struct VisualizePointsNode : IPointsNodeSingleInput
 
 	// Node
 	void enqueueExecImpl() override;
+	bool isHostCompute() const override { return true; }
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override;
@@ -0,0 +1,82 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+
+#include <pcl/point_cloud.h>
+
+#include <macros/cuda.hpp>
+#include <macros/handleDestructorException.hpp>
+
+/**
+ * Persistent pcl::PointCloud, which storage of points is page-locked (cudaHostRegister), so that points formatted
+ * on the device may be downloaded directly into it (pcl::PointCloud does not allow a custom allocator of points).
+ * Storage grows geometrically and is registered again only when it grows, so steady-state frames do not allocate.
+ */
+template<typename PointT>
+struct PinnedPointCloud
+{
+	PinnedPointCloud() = default;
+	PinnedPointCloud(const PinnedPointCloud&) = delete;
+	PinnedPointCloud& operator=(const PinnedPointCloud&) = delete;
+
+	~PinnedPointCloud()
+	try {
+		unregisterPoints();
+	}
+	HANDLE_DESTRUCTOR_EXCEPTION
+
+	/**
+	 * Resizes the cloud (to a single row), keeping its storage unless it is too small. Contents are not preserved.
+	 */
+	void resize(std::size_t pointCount)
+	{
+		if (cloud->points.capacity() < pointCount) {
+			unregisterPoints();
+			cloud->points.clear();
+			cloud->points.reserve(std::max(pointCount, 2 * cloud->points.capacity()));
+			CHECK_CUDA(cudaHostRegister(cloud->points.data(), cloud->points.capacity() * sizeof(PointT),
+			                            cudaHostRegisterDefault));
+			registeredPoints = cloud->points.data();
+		}
+		cloud->resize(pointCount);
+	}
+
+	/**
+	 * Enqueues download of a device array of points into the cloud, which has to be resized to their count before.
+	 */
+	void enqueueDownload(const void* devicePoints, cudaStream_t stream)
+	{
+		CHECK_CUDA(cudaMemcpyAsync(cloud->points.data(), devicePoints, cloud->size() * sizeof(PointT), cudaMemcpyDeviceToHost,
+		                           stream));
+	}
+
+	// The pointer is fixed for the lifetime of this object, so it may be given to PCL algorithms once.
+	const typename pcl::PointCloud<PointT>::Ptr cloud = std::make_shared<pcl::PointCloud<PointT>>();
+
+private:
+	void unregisterPoints()
+	{
+		if (registeredPoints != nullptr) {
+			CHECK_CUDA(cudaHostUnregister(registeredPoints));
+			registeredPoints = nullptr;
+		}
+	}
+
+	PointT* registeredPoints{nullptr};
+};
@@ -33,7 +33,7 @@ void RemoveGroundPointsNode::setParameters(rgl_axis_t sensorUpAxis, float ground
 	segmentation.setOptimizeCoefficients(true);
 	segmentation.setMethodType(pcl::SAC_RANSAC);
 	segmentation.setDistanceThreshold(groundDistanceThreshold);
-	segmentation.setInputCloud(toFilterPointCloud);
+	segmentation.setInputCloud(toFilter.cloud);
 	constexpr int maxIterations = 500;
 	segmentation.setMaxIterations(maxIterations);
 }
@@ -57,16 +57,12 @@ void RemoveGroundPointsNode::enqueueExecImpl()
 		return;
 	}
 
-	// Get formatted input data (SSE2-aligned XYZ)
+	// Get formatted input data (SSE2-aligned XYZ), downloaded directly into the persistent cloud
 	FormatPointsNode::formatAsync(formattedInput, input, getRequiredFieldList(), gpuFieldDescBuilder);
-	formattedInputHost->copyFrom(formattedInput);
-
-	// Copy data into pcl::PointCloud
 	auto pointCount = input->getPointCount();
-	toFilterPointCloud->resize(pointCount);
-	const pcl::PointXYZ* begin = reinterpret_cast<const pcl::PointXYZ*>(formattedInputHost->getReadPtr());
-	const pcl::PointXYZ* end = begin + pointCount;
-	toFilterPointCloud->assign(begin, end, pointCount);
+	toFilter.resize(pointCount);
+	toFilter.enqueueDownload(formattedInput->getReadPtr(), getStreamHandle());
+	CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
 
 	// Segment ground and approximate plane coefficients
 	segmentation.segment(*groundIndices, planeCoefficients);
@@ -74,7 +70,7 @@ void RemoveGroundPointsNode::enqueueExecImpl()
 	// Select ground indices (points within given distance to approximate plane model). Can be optimized (GPU?)
 	auto planeCoefficientsEigen = Eigen::Vector4f(planeCoefficients.values[0], planeCoefficients.values[1],
 	                                              planeCoefficients.values[2], planeCoefficients.values[3]);
-	auto planeModel = pcl::SampleConsensusModelPerpendicularPlane<pcl::PointXYZ>(toFilterPointCloud);
+	auto planeModel = pcl::SampleConsensusModelPerpendicularPlane<pcl::PointXYZ>(toFilter.cloud);
 	planeModel.selectWithinDistance(planeCoefficientsEigen, groundFilterDistance, groundIndices->indices);
 
 	// Compute non-ground indices. Can be optimized (GPU?)
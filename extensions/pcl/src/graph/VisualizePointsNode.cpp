@@ -14,6 +14,7 @@
 
 #include <graph/NodesCore.hpp>
 #include <graph/NodesPcl.hpp>
+#include <ThreadConfig.hpp>
 
 void VisualizePointsNode::setParameters(const char* windowName, int windowWidth, int windowHeight, bool fullscreen)
 {
@@ -36,6 +37,7 @@ void VisualizePointsNode::setParameters(const char* windowName, int windowWidth,
 // All calls to the viewers must be executed from the same thread
 void VisualizePointsNode::VisualizeThread::runVisualize()
 try {
+	ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-pcl-viewer"};
 	// We cannot initialize iterator without having lock!
 	static std::optional<decltype(visualizeNodes)::iterator> it = std::nullopt;
 	VisualizePointsNode::Ptr node = nullptr;
@@ -53,6 +53,19 @@ typedef enum
 	QOS_POLICY_HISTORY_KEEP_ALL = 2
 } rgl_qos_policy_history_t;
 
+/******************************** CONFIGURATION ********************************/
+
+/**
+ * Configures the ROS2 node of RGL, which is created along with the first ROS2 RGL Node and destroyed with the last one.
+ * It may be called only when no ROS2 RGL Node exists; the configuration applies to ROS2 nodes created afterwards.
+ * @param use_intra_process_comms If true, messages to subscribers in the same process (and ROS2 context) are passed
+ *                                without serialization. ROS2 (Humble) supports it only with volatile durability,
+ *                                hence publishers with QOS_POLICY_DURABILITY_TRANSIENT_LOCAL cannot be created then.
+ * @param executor_thread_count If positive, the node is spun by RGL in a multi-threaded executor with that many threads,
+ *                              separate from graph threads and the publishing thread. Zero (default): the node is not spun.
+ */
+RGL_API rgl_status_t rgl_configure_ros2(bool use_intra_process_comms, int32_t executor_thread_count);
+
 /******************************** NODES ********************************/
 
 /**
@@ -60,6 +73,9 @@ typedef enum
  * The node publishes a PointCloud2 message to the ROS2 topic using default Quality of Service settings.
  * Fields and their layout in the binary data blob will be automatically determined based on the preceding FormatNode.
  * The message header stamp gets time from the raytraced scene. If the scene has no time, header will get the actual time.
+ * Messages are published asynchronously, in a background thread. If it falls behind, the oldest pending messages are dropped.
+ * If the ROS2 middleware supports loaning messages of this type (see rclcpp::Publisher::can_loan_messages),
+ * the point cloud is copied directly into the loaned message.
  * Graph input: FormatNode
  * Graph output: point cloud
  * @param node If (*node) == nullptr, a new node will be created. Otherwise, (*node) will be modified.
@@ -73,6 +89,7 @@ RGL_API rgl_status_t rgl_node_points_ros2_publish(rgl_node_t* node, const char*
  * The node publishes a PointCloud2 message to the ROS2 topic with Quality of Service specified.
  * Fields and their layout in the binary data blob will be automatically determined based on the preceding FormatNode.
  * The message header stamp gets time from the raytraced scene. If the scene has no time, header will get the actual time.
+ * Messages are published asynchronously, in a background thread. If it falls behind, the oldest pending messages are dropped.
  * Graph input: FormatNode
  * Graph output: point cloud
  * @param node If (*node) == nullptr, a new node will be created. Otherwise, (*node) will be modified.
@@ -88,10 +105,35 @@ RGL_API rgl_status_t rgl_node_points_ros2_publish_with_qos(rgl_node_t* node, con
                                                            rgl_qos_policy_durability_t qos_durability,
                                                            rgl_qos_policy_history_t qos_history, int32_t qos_history_depth);
 
+/**
+ * Creates or modifies Ros2PublishDevicePointsNode.
+ * The node publishes point clouds kept in device memory, for consumers running on the GPU in the same process
+ * (e.g. in the same component container), without serializing them on the host.
+ * Messages are of type rgl::Ros2DevicePointCloud (see ros2_device_point_cloud.hpp), adapted to sensor_msgs/PointCloud2
+ * as in REP-2007: intra-process subscribers of the adapted type receive the device buffer of points, along with
+ * a CUDA event to wait for, and hold it as long as they keep the message; other subscribers receive PointCloud2.
+ * The publisher communicates intra-process, so the durability must not be transient local.
+ * Fields, header stamps and asynchronous publishing are as in rgl_node_points_ros2_publish_with_qos.
+ * Graph input: FormatNode
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new node will be created. Otherwise, (*node) will be modified.
+ * @param topic_name Topic name to publish on.
+ * @param frame_id Frame this data is associated with.
+ * @param qos_reliability QoS reliability policy.
+ * @param qos_durability QoS durability policy. It must not be QOS_POLICY_DURABILITY_TRANSIENT_LOCAL.
+ * @param qos_history QoS history policy.
+ * @param qos_history_depth QoS history depth. If history policy is KEEP_ALL, depth is ignored but must always be non-negative.
+ */
+RGL_API rgl_status_t rgl_node_points_ros2_publish_device(rgl_node_t* node, const char* topic_name, const char* frame_id,
+                                                         rgl_qos_policy_reliability_t qos_reliability,
+                                                         rgl_qos_policy_durability_t qos_durability,
+                                                         rgl_qos_policy_history_t qos_history, int32_t qos_history_depth);
+
 /**
  * Creates or modifies Ros2PublishRadarScanNode.
  * The node publishes a RadarScan message to the ROS2 topic using specified Quality of Service settings.
  * The message header stamp gets time from the raytraced scene. If the scene has no time, header will get the actual time.
+ * Messages are published asynchronously, in a background thread. If it falls behind, the oldest pending messages are dropped.
  * Graph input: point cloud
  * Graph output: point cloud
  * @param node If (*node) == nullptr, a new node will be created. Otherwise, (*node) will be modified.
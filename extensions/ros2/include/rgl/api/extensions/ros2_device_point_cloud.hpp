@@ -0,0 +1,90 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <cuda_runtime.h>
+
+#include <rclcpp/type_adapter.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+namespace rgl {
+
+/**
+ * Point cloud kept in device memory, published by rgl_node_points_ros2_publish_device (see ros2.h).
+ * It is adapted (REP-2007) to sensor_msgs/PointCloud2: subscribers of this type in the same process receive
+ * the device buffer, others receive PointCloud2, downloaded by rclcpp only if there are such subscribers.
+ */
+struct Ros2DevicePointCloud
+{
+	sensor_msgs::msg::PointCloud2 description; // Header and layout of points; its data is empty
+	const void* deviceData{nullptr};           // description.row_step * description.height bytes
+	cudaEvent_t dataReady{nullptr};            // Consumers must make their streams wait for it before reading the data
+	std::shared_ptr<const void> holder;        // Keeps the data and the event valid as long as the message is held
+
+	std::size_t getDataSize() const { return static_cast<std::size_t>(description.row_step) * description.height; }
+};
+
+} // namespace rgl
+
+template<>
+struct rclcpp::TypeAdapter<rgl::Ros2DevicePointCloud, sensor_msgs::msg::PointCloud2>
+{
+	using is_specialized = std::true_type;
+	using custom_type = rgl::Ros2DevicePointCloud;
+	using ros_message_type = sensor_msgs::msg::PointCloud2;
+
+	static void convert_to_ros_message(const custom_type& source, ros_message_type& destination)
+	{
+		destination = source.description;
+		destination.data.resize(source.getDataSize());
+		if (source.dataReady != nullptr) {
+			check(cudaEventSynchronize(source.dataReady));
+		}
+		check(cudaMemcpy(destination.data.data(), source.deviceData, destination.data.size(), cudaMemcpyDeviceToHost));
+	}
+
+	static void convert_to_custom(const ros_message_type& source, custom_type& destination)
+	{
+		destination.description.header = source.header;
+		destination.description.height = source.height;
+		destination.description.width = source.width;
+		destination.description.fields = source.fields;
+		destination.description.is_bigendian = source.is_bigendian;
+		destination.description.point_step = source.point_step;
+		destination.description.row_step = source.row_step;
+		destination.description.is_dense = source.is_dense;
+		void* deviceData = nullptr;
+		check(cudaMalloc(&deviceData, source.data.size()));
+		auto freeData = [](const void* data) { cudaFree(const_cast<void*>(data)); };
+		destination.holder = std::shared_ptr<const void>(deviceData, freeData);
+		check(cudaMemcpy(deviceData, source.data.data(), source.data.size(), cudaMemcpyHostToDevice));
+		destination.deviceData = deviceData;
+		destination.dataReady = nullptr; // Copied synchronously
+	}
+
+private:
+	static void check(cudaError_t status)
+	{
+		if (status != cudaSuccess) {
+			throw std::runtime_error(std::string("Ros2DevicePointCloud conversion failed: ") + cudaGetErrorString(status));
+		}
+	}
+};
+
+RCLCPP_USING_CUSTOM_TYPE_AS_ROS_MESSAGE_TYPE(rgl::Ros2DevicePointCloud, sensor_msgs::msg::PointCloud2);
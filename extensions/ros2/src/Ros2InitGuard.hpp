@@ -14,21 +14,33 @@
 
 #pragma once
 
+#include <thread>
+
 #include <RGLExceptions.hpp>
+#include <ThreadConfig.hpp>
+#include <Ros2PublishQueue.hpp>
 #include <rclcpp/rclcpp.hpp>
 
 /**
  * Wrapper around RGL-specific ROS2 resources shared between RGL Nodes.
  * - Handles (de)initialization of rclcpp and creation of ROS2 node
  * - Keeps track of ROS2 publishers to avoid creating duplicates
+ * - Owns the thread publishing messages (see Ros2PublishQueue)
+ * - Optionally, spins the ROS2 node in its own executor (serving e.g. parameters and the clock), with its own threads
  */
 struct Ros2InitGuard
 {
+	struct Config
+	{
+		bool useIntraProcessComms{false}; // Requires volatile durability of all publishers
+		int32_t executorThreadCount{0};   // Zero: the node is not spun by RGL
+	};
+
 	rclcpp::Node& getNode() const { return *node; }
+	Ros2PublishQueue& getPublishQueue() const { return *publishQueue; }
 
 	static inline std::shared_ptr<Ros2InitGuard> acquire()
 	{
-		static std::weak_ptr<Ros2InitGuard> weak{};
 		std::shared_ptr<Ros2InitGuard> shared{};
 		if (auto locked = weak.lock()) {
 			shared = locked;
@@ -39,20 +51,36 @@ struct Ros2InitGuard
 		return shared;
 	}
 
+	// The node is created with the configuration, so it may be changed only while no RGL Node uses ROS2.
+	static inline void configure(const Config& newConfig)
+	{
+		if (!weak.expired()) {
+			throw InvalidAPIArgument("ROS2 may be configured only when no ROS2 node exists (e.g. before creating them)");
+		}
+		config = newConfig;
+	}
+
 	template<typename T>
-	rclcpp::Publisher<T>::SharedPtr createUniquePublisher(const std::string& topicName, const rclcpp::QoS& qos)
+	rclcpp::Publisher<T>::SharedPtr createUniquePublisher(const std::string& topicName, const rclcpp::QoS& qos,
+	                                                      const rclcpp::PublisherOptions& options = {})
 	{
 		if (hasTopic(topicName)) {
 			auto msg = fmt::format("ROS2 publisher with the same topic name ({}) already exist!", topicName);
 			throw InvalidAPIArgument(msg);
 		}
-		auto publisher = node->create_publisher<T>(topicName, qos);
+		auto publisher = node->create_publisher<T>(topicName, qos, options);
 		publishers.insert({topicName, publisher});
 		return publisher;
 	}
 
 	~Ros2InitGuard()
 	{
+		// Pending messages are dropped; publishing must stop before ROS2 is shut down.
+		publishQueue.reset();
+		if (executor != nullptr) {
+			executor->cancel();
+			spinThread.join();
+		}
 		if (isRclcppInitializedByRGL) {
 			rclcpp::shutdown();
 			isRclcppInitializedByRGL = false;
@@ -67,7 +95,18 @@ private:
 			rclcpp::init(0, nullptr);
 			isRclcppInitializedByRGL = true;
 		}
-		node = std::make_shared<rclcpp::Node>(nodeName);
+		auto options = rclcpp::NodeOptions().use_intra_process_comms(config.useIntraProcessComms);
+		node = std::make_shared<rclcpp::Node>(nodeName, options);
+		publishQueue = std::make_unique<Ros2PublishQueue>();
+		if (config.executorThreadCount > 0) {
+			executor = std::make_unique<rclcpp::executors::MultiThreadedExecutor>(rclcpp::ExecutorOptions(),
+			                                                                      config.executorThreadCount);
+			executor->add_node(node);
+			spinThread = std::thread([this]() {
+				ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-ros2-spin"};
+				executor->spin();
+			});
+		}
 	}
 
 	bool hasTopic(const std::string& query)
@@ -80,7 +119,12 @@ private:
 
 private:
 	rclcpp::Node::SharedPtr node;
+	std::unique_ptr<Ros2PublishQueue> publishQueue;
+	std::unique_ptr<rclcpp::executors::MultiThreadedExecutor> executor;
+	std::thread spinThread;
 	bool isRclcppInitializedByRGL{false};
 	std::map<std::string, std::weak_ptr<rclcpp::PublisherBase>> publishers;
 	inline static std::string nodeName = "RobotecGPULidar";
+	inline static std::weak_ptr<Ros2InitGuard> weak{};
+	inline static Config config{};
 };
@@ -0,0 +1,85 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <Ros2PublishQueue.hpp>
+
+#include <algorithm>
+
+#include <Logger.hpp>
+#include <ThreadConfig.hpp>
+
+Ros2PublishQueue::Ros2PublishQueue() { publisher = std::thread(&Ros2PublishQueue::publisherMain, this); }
+
+Ros2PublishQueue::~Ros2PublishQueue()
+{
+	{
+		std::lock_guard lock{mutex};
+		isShutdownRequested = true;
+	}
+	condition.notify_all();
+	publisher.join();
+}
+
+void Ros2PublishQueue::submit(const void* owner, cudaStream_t stream, std::function<void()> publish)
+{
+	CudaEvent::Ptr dataReady = CudaEvent::create();
+	CHECK_CUDA(cudaEventRecord(dataReady->getHandle(), stream));
+	{
+		std::lock_guard lock{mutex};
+		auto isOwned = [owner](const Job& job) { return job.owner == owner; };
+		if (static_cast<std::size_t>(std::ranges::count_if(pendingJobs, isOwned)) >= MAX_PENDING_PER_OWNER) {
+			pendingJobs.erase(std::ranges::find_if(pendingJobs, isOwned));
+			droppedCount += 1;
+			RGL_DEBUG("ROS2 publishing is too slow, dropped the oldest pending message (dropped in total: {})",
+			          droppedCount);
+		}
+		pendingJobs.push_back({.owner = owner, .dataReady = std::move(dataReady), .publish = std::move(publish)});
+	}
+	condition.notify_one();
+}
+
+uint64_t Ros2PublishQueue::getDroppedCount() const
+{
+	std::lock_guard lock{mutex};
+	return droppedCount;
+}
+
+void Ros2PublishQueue::publisherMain()
+{
+	ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-ros2-publish"};
+	while (true) {
+		Job job;
+		{
+			std::unique_lock lock{mutex};
+			condition.wait(lock, [this]() { return !pendingJobs.empty() || isShutdownRequested; });
+			if (isShutdownRequested) {
+				return;
+			}
+			job = std::move(pendingJobs.front());
+			pendingJobs.pop_front();
+		}
+		// Errors cannot be reported to the graph run that submitted the message, which has already completed.
+		try {
+			CudaDevice::bindCurrentThread();
+			CHECK_CUDA(cudaEventSynchronize(job.dataReady->getHandle()));
+			job.publish();
+		}
+		catch (std::exception& e) {
+			RGL_ERROR("Failed to publish ROS2 message: {}", e.what());
+		}
+		catch (...) {
+			RGL_ERROR("Failed to publish ROS2 message due to unknown exception");
+		}
+	}
+}
@@ -0,0 +1,64 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <CudaEvent.hpp>
+
+/**
+ * Publishes ROS2 messages in a dedicated thread, so that graph threads do not wait for the GPU and the middleware
+ * (e.g. reliable QoS with slow subscribers). Each owner (e.g. a Node) has at most MAX_PENDING_PER_OWNER messages
+ * waiting to be published; when it is exceeded, the oldest one is dropped, so that publishing never blocks graph runs.
+ */
+struct Ros2PublishQueue
+{
+	Ros2PublishQueue();
+	~Ros2PublishQueue();
+
+	Ros2PublishQueue(const Ros2PublishQueue&) = delete;
+	Ros2PublishQueue& operator=(const Ros2PublishQueue&) = delete;
+
+	/**
+	 * Queues publish to be called once all the work enqueued so far in the stream is completed.
+	 */
+	void submit(const void* owner, cudaStream_t stream, std::function<void()> publish);
+
+	uint64_t getDroppedCount() const;
+
+private:
+	void publisherMain();
+
+	struct Job
+	{
+		const void* owner;
+		CudaEvent::Ptr dataReady;
+		std::function<void()> publish;
+	};
+
+	static constexpr std::size_t MAX_PENDING_PER_OWNER = 4;
+
+	std::deque<Job> pendingJobs;
+	uint64_t droppedCount{0};
+	mutable std::mutex mutex;
+	std::condition_variable condition;
+	bool isShutdownRequested{false};
+	std::thread publisher;
+};
@@ -36,6 +36,25 @@ static_assert((int) QOS_POLICY_HISTORY_KEEP_ALL == (int) RMW_QOS_POLICY_HISTORY_
 
 extern "C" {
 
+RGL_API rgl_status_t rgl_configure_ros2(bool use_intra_process_comms, int32_t executor_thread_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_DEBUG("rgl_configure_ros2(use_intra_process_comms={}, executor_thread_count={})", use_intra_process_comms,
+		          executor_thread_count);
+		CHECK_ARG(executor_thread_count >= 0);
+
+		Ros2InitGuard::configure({.useIntraProcessComms = use_intra_process_comms,
+		                          .executorThreadCount = executor_thread_count});
+	});
+	TAPE_HOOK(use_intra_process_comms, executor_thread_count);
+	return status;
+}
+
+void TapeRos2::tape_configure_ros2(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_configure_ros2(yamlNode[0].as<bool>(), yamlNode[1].as<int32_t>());
+}
+
 RGL_API rgl_status_t rgl_node_points_ros2_publish(rgl_node_t* node, const char* topic_name, const char* frame_id)
 {
 	auto status = rglSafeCall([&]() {
@@ -92,6 +111,39 @@ void TapeRos2::tape_node_points_ros2_publish_with_qos(const YAML::Node& yamlNode
 	state.nodes.insert(std::make_pair(nodeId, node));
 }
 
+RGL_API rgl_status_t rgl_node_points_ros2_publish_device(rgl_node_t* node, const char* topic_name, const char* frame_id,
+                                                         rgl_qos_policy_reliability_t qos_reliability,
+                                                         rgl_qos_policy_durability_t qos_durability,
+                                                         rgl_qos_policy_history_t qos_history, int32_t qos_history_depth)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_DEBUG("rgl_node_points_ros2_publish_device(node={}, topic_name={}, frame_id={}, qos_reliability={}, "
+		          "qos_durability={}, qos_history={}, qos_history_depth={})",
+		          repr(node), topic_name, frame_id, qos_reliability, qos_durability, qos_history, qos_history_depth);
+		CHECK_ARG(topic_name != nullptr);
+		CHECK_ARG(topic_name[0] != '\0');
+		CHECK_ARG(frame_id != nullptr);
+		CHECK_ARG(frame_id[0] != '\0');
+		CHECK_ARG(qos_history_depth >= 0);
+
+		createOrUpdateNode<Ros2PublishDevicePointsNode>(node, topic_name, frame_id, qos_reliability, qos_durability,
+		                                                qos_history, qos_history_depth);
+	});
+	TAPE_HOOK(node, topic_name, frame_id, qos_reliability, qos_durability, qos_history, qos_history_depth);
+	return status;
+}
+
+void TapeRos2::tape_node_points_ros2_publish_device(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes[nodeId] : nullptr;
+	rgl_node_points_ros2_publish_device(&node, yamlNode[1].as<std::string>().c_str(), yamlNode[2].as<std::string>().c_str(),
+	                                    (rgl_qos_policy_reliability_t) yamlNode[3].as<int>(),
+	                                    (rgl_qos_policy_durability_t) yamlNode[4].as<int>(),
+	                                    (rgl_qos_policy_history_t) yamlNode[5].as<int>(), yamlNode[6].as<int32_t>());
+	state.nodes.insert(std::make_pair(nodeId, node));
+}
+
 RGL_API rgl_status_t rgl_node_publish_ros2_radarscan(rgl_node_t* node, const char* topic_name, const char* frame_id,
                                                      rgl_qos_policy_reliability_t qos_reliability,
                                                      rgl_qos_policy_durability_t qos_durability,
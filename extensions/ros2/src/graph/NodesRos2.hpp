@@ -26,6 +26,7 @@
 #include <visualization_msgs/msg/marker_array.hpp>
 #include <Ros2InitGuard.hpp>
 #include <radar_msgs/msg/radar_scan.hpp>
+#include <rgl/api/extensions/ros2_device_point_cloud.hpp>
 
 struct Ros2Node : IPointsNodeSingleInput
 {
@@ -52,6 +53,23 @@ protected:
 
 	virtual void ros2EnqueueExecImpl() = 0;
 	virtual void ros2ValidateImpl() = 0;
+
+	/**
+	 * Returns host buffer for data of a message to be published asynchronously (see Ros2PublishQueue).
+	 * Buffers are reused once messages holding them are published or dropped.
+	 */
+	HostPinnedArray<char>::Ptr acquireMessageDataBuffer()
+	{
+		for (auto&& buffer : messageDataBuffers) {
+			if (buffer.use_count() == 1) {
+				return buffer;
+			}
+		}
+		return messageDataBuffers.emplace_back(HostPinnedArray<char>::create());
+	}
+
+private:
+	std::vector<HostPinnedArray<char>::Ptr> messageDataBuffers;
 };
 
 struct Ros2PublishPointsNode : Ros2Node
@@ -69,16 +87,54 @@ struct Ros2PublishPointsNode : Ros2Node
 
 	~Ros2PublishPointsNode() override = default;
 
+	// Describes layout of formatted points, also for other point cloud publishers.
+	static void updateRos2Message(sensor_msgs::msg::PointCloud2& message, const std::vector<rgl_field_t>& fields,
+	                              bool isDense);
+
 private:
 	DeviceAsyncArray<char>::Ptr inputFmtData = DeviceAsyncArray<char>::create(arrayMgr);
 
 	rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr ros2Publisher;
 	sensor_msgs::msg::PointCloud2 ros2Message;
 
-	void updateRos2Message(const std::vector<rgl_field_t>& fields, bool isDense);
+	static void publish(rclcpp::Publisher<sensor_msgs::msg::PointCloud2>& publisher, sensor_msgs::msg::PointCloud2& message,
+	                    const HostPinnedArray<char>& data, size_t size);
 };
 
 
+/**
+ * Publishes formatted points kept in device memory, as rgl::Ros2DevicePointCloud adapted to PointCloud2 (REP-2007).
+ * Subscribers in the same process get the device buffer (with intra-process communication); others get PointCloud2.
+ * Each message holds its own device copy of the points (pooled), since the input is overwritten by the next run.
+ */
+struct Ros2PublishDevicePointsNode : Ros2Node
+{
+	using Ptr = std::shared_ptr<Ros2PublishDevicePointsNode>;
+	using AdaptedType = rclcpp::TypeAdapter<rgl::Ros2DevicePointCloud, sensor_msgs::msg::PointCloud2>;
+
+	void setParameters(const char* topicName, const char* frameId, rgl_qos_policy_reliability_t qosReliability,
+	                   rgl_qos_policy_durability_t qosDurability, rgl_qos_policy_history_t qosHistory, int32_t qosHistoryDepth);
+
+	// Ros2Node
+	void ros2ValidateImpl() override;
+	void ros2EnqueueExecImpl() override;
+
+	~Ros2PublishDevicePointsNode() override = default;
+
+private:
+	struct MessageData
+	{
+		DeviceSyncArray<char>::Ptr points = DeviceSyncArray<char>::create(); // Freed by the last holder, in any thread
+		CudaEvent::Ptr ready = CudaEvent::create();
+	};
+
+	rclcpp::Publisher<AdaptedType>::SharedPtr ros2Publisher;
+	rgl::Ros2DevicePointCloud ros2Message;
+	std::vector<std::shared_ptr<MessageData>> messageDataBuffers;
+
+	std::shared_ptr<MessageData> acquireMessageData();
+};
+
 struct Ros2PublishPointVelocityMarkersNode : Ros2Node
 {
 	using Ptr = std::shared_ptr<Ros2PublishPointVelocityMarkersNode>;
@@ -93,14 +149,10 @@ struct Ros2PublishPointVelocityMarkersNode : Ros2Node
 	~Ros2PublishPointVelocityMarkersNode() override = default;
 
 private:
-	std::string frameId;
 	rclcpp::Publisher<visualization_msgs::msg::Marker>::SharedPtr linesPublisher;
-	HostPinnedArray<Vec3f>::Ptr pos = HostPinnedArray<Vec3f>::create();
-	HostPinnedArray<Vec3f>::Ptr vel = HostPinnedArray<Vec3f>::create();
+	DeviceAsyncArray<double>::Ptr linePoints = DeviceAsyncArray<double>::create(arrayMgr);
 	visualization_msgs::msg::Marker marker;
 	rgl_field_t velocityField;
-
-	const visualization_msgs::msg::Marker& makeLinesMarker();
 };
 
 struct Ros2PublishRadarScanNode : Ros2Node
@@ -0,0 +1,85 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesRos2.hpp>
+#include <graph/GraphRunCtx.hpp>
+#include <RGLFields.hpp>
+
+void Ros2PublishDevicePointsNode::setParameters(const char* topicName, const char* frameId,
+                                                rgl_qos_policy_reliability_t qosReliability,
+                                                rgl_qos_policy_durability_t qosDurability,
+                                                rgl_qos_policy_history_t qosHistory, int32_t qosHistoryDepth)
+{
+	ros2Message.description.header.frame_id = frameId;
+	auto qos = rclcpp::QoS(qosHistoryDepth);
+	qos.reliability(static_cast<rmw_qos_reliability_policy_t>(qosReliability));
+	qos.durability(static_cast<rmw_qos_durability_policy_t>(qosDurability));
+	qos.history(static_cast<rmw_qos_history_policy_t>(qosHistory));
+	if (qos.durability() == rclcpp::DurabilityPolicy::TransientLocal) {
+		throw InvalidAPIArgument("device point clouds are published intra-process, which requires volatile durability");
+	}
+	// Only this publisher communicates intra-process, so that other publishers may use any QoS.
+	rclcpp::PublisherOptions options;
+	options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+	ros2Publisher = ros2InitGuard->createUniquePublisher<AdaptedType>(topicName, qos, options);
+}
+
+void Ros2PublishDevicePointsNode::ros2ValidateImpl()
+{
+	if (std::dynamic_pointer_cast<FormatPointsNode>(input) == nullptr) {
+		auto msg = fmt::format("{} requires a formatted point cloud (FormatPointsNode as the input)", getName());
+		throw InvalidPipeline(msg);
+	}
+	Ros2PublishPointsNode::updateRos2Message(ros2Message.description, input->getRequiredFieldList(), input->isDense());
+}
+
+void Ros2PublishDevicePointsNode::ros2EnqueueExecImpl()
+{
+	auto formatInput = std::static_pointer_cast<FormatPointsNode>(input);
+	IAnyArray::ConstPtr formatted = formatInput->getDeviceFrame();
+	size_t size = ros2Message.description.point_step * input->getPointCount();
+	// Input's buffer is overwritten by the next run, possibly before subscribers are done with the message.
+	std::shared_ptr<MessageData> messageData = acquireMessageData();
+	messageData->points->resize(size, false, false);
+	CHECK_CUDA(cudaMemcpyAsync(messageData->points->getRawWritePtr(), formatted->getRawReadPtr(), size,
+	                           cudaMemcpyDeviceToDevice, getStreamHandle()));
+	CHECK_CUDA(cudaEventRecord(messageData->ready->getHandle(), getStreamHandle()));
+
+	ros2Message.description.width = input->getWidth();
+	ros2Message.description.height = input->getHeight();
+	ros2Message.description.row_step = ros2Message.description.point_step * ros2Message.description.width;
+	std::optional<Time> sceneTime = getGraphRunCtx()->getSceneTime();
+	ros2Message.description.header.stamp =
+	    sceneTime.has_value() ? sceneTime->asRos2Msg() :
+	                            static_cast<builtin_interfaces::msg::Time>(ros2InitGuard->getNode().get_clock()->now());
+	ros2Message.deviceData = messageData->points->getRawReadPtr();
+	ros2Message.dataReady = messageData->ready->getHandle();
+	ros2Message.holder = messageData;
+	ros2InitGuard->getPublishQueue().submit(this, getStreamHandle(), [publisher = ros2Publisher, message = ros2Message]() {
+		// Intra-process subscribers take the message as it is; it is converted to PointCloud2 for the others.
+		publisher->publish(std::make_unique<rgl::Ros2DevicePointCloud>(message));
+	});
+	ros2Message.holder.reset();
+}
+
+std::shared_ptr<Ros2PublishDevicePointsNode::MessageData> Ros2PublishDevicePointsNode::acquireMessageData()
+{
+	// Buffers are reused once all messages holding them are released by subscribers (or dropped).
+	for (auto&& buffer : messageDataBuffers) {
+		if (buffer.use_count() == 1) {
+			return buffer;
+		}
+	}
+	return messageDataBuffers.emplace_back(std::make_shared<MessageData>());
+}
@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
+
 #include <graph/NodesRos2.hpp>
-#include <scene/Scene.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <graph/GraphRunCtx.hpp>
 
 void Ros2PublishPointVelocityMarkersNode::setParameters(const char* topicName, const char* frameId, rgl_field_t velocityField)
 {
@@ -23,10 +26,18 @@ void Ros2PublishPointVelocityMarkersNode::setParameters(const char* topicName, c
 		                       getName(), toString(velocityField));
 		throw InvalidAPIArgument(msg);
 	}
-	this->frameId = frameId;
 	auto qos = rclcpp::QoS(10); // Use system default QoS
 	linesPublisher = ros2InitGuard->createUniquePublisher<visualization_msgs::msg::Marker>(topicName, qos);
 	this->velocityField = velocityField;
+
+	marker.header.frame_id = frameId;
+	marker.action = visualization_msgs::msg::Marker::ADD;
+	marker.color.r = 1.0;
+	marker.color.g = 1.0;
+	marker.color.b = 1.0;
+	marker.color.a = 0.32;
+	marker.type = visualization_msgs::msg::Marker::LINE_LIST;
+	marker.scale.x = 0.02; // Line width diameter
 }
 
 void Ros2PublishPointVelocityMarkersNode::ros2ValidateImpl()
@@ -35,37 +46,32 @@ void Ros2PublishPointVelocityMarkersNode::ros2ValidateImpl()
 		throw InvalidPipeline(fmt::format("{} requires a compacted point cloud (dense)", getName()));
 	}
 }
+
 void Ros2PublishPointVelocityMarkersNode::ros2EnqueueExecImpl()
 {
-	pos->copyFrom(input->getFieldData(RGL_FIELD_XYZ_VEC3_F32));
-	vel->copyFrom(input->getFieldData(velocityField));
-	linesPublisher->publish(makeLinesMarker());
-}
+	// Lines are built on the GPU directly in the layout of marker's points, so that they are copied with a single memcpy.
+	static_assert(sizeof(geometry_msgs::msg::Point) == 3 * sizeof(double));
+	size_t pointCount = input->getPointCount();
+	const auto* points = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	const auto* velocities = input->getFieldData(velocityField)->asTyped<Vec3f>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	linePoints->resize(pointCount * 6, false, false);
+	gpuMakeLineSegments(getStreamHandle(), pointCount, points, velocities, linePoints->getWritePtr());
 
-const visualization_msgs::msg::Marker& Ros2PublishPointVelocityMarkersNode::makeLinesMarker()
-{
-	marker.header.stamp = Scene::instance().getTime().has_value() ?
-	                          Scene::instance().getTime().value().asRos2Msg() :
-	                          static_cast<builtin_interfaces::msg::Time>(ros2InitGuard->getNode().get_clock()->now());
-	marker.header.frame_id = this->frameId;
-	marker.action = visualization_msgs::msg::Marker::ADD;
-	marker.color.r = 1.0;
-	marker.color.g = 1.0;
-	marker.color.b = 1.0;
-	marker.color.a = 0.32;
-	marker.type = visualization_msgs::msg::Marker::LINE_LIST;
-	marker.scale.x = 0.02; // Line width diameter
-	marker.points.resize(pos->getCount() * 2);
-	geometry_msgs::msg::Point origin, end;
-	for (int i = 0; i < pos->getCount(); i++) {
-		origin.x = pos->at(i).x();
-		origin.y = pos->at(i).y();
-		origin.z = pos->at(i).z();
-		end.x = origin.x + vel->at(i).x();
-		end.y = origin.y + vel->at(i).y();
-		end.z = origin.z + vel->at(i).z();
-		marker.points[2 * i] = origin;
-		marker.points[2 * i + 1] = end;
-	}
-	return marker;
-}
\ No newline at end of file
+	size_t size = linePoints->getCount() * sizeof(double);
+	HostPinnedArray<char>::Ptr messageData = acquireMessageDataBuffer();
+	messageData->resize(size, false, false);
+	CHECK_CUDA(cudaMemcpyAsync(messageData->getWritePtr(), linePoints->getReadPtr(), size, cudaMemcpyDeviceToHost,
+	                           getStreamHandle()));
+
+	// Stamped with the time of the scene raytraced by the graph, i.e. the one of its snapshot used in this run.
+	std::optional<Time> sceneTime = getGraphRunCtx()->getSceneTime();
+	marker.header.stamp = sceneTime.has_value() ?
+	                      sceneTime->asRos2Msg() :
+	                      static_cast<builtin_interfaces::msg::Time>(ros2InitGuard->getNode().get_clock()->now());
+	ros2InitGuard->getPublishQueue().submit(
+	    this, getStreamHandle(), [publisher = linesPublisher, message = marker, messageData, pointCount]() mutable {
+		    message.points.resize(pointCount * 2);
+		    std::memcpy(message.points.data(), messageData->getReadPtr(), messageData->getCount());
+		    publisher->publish(message);
+	    });
+}
@@ -13,7 +13,7 @@
 // limitations under the License.
 
 #include <graph/NodesRos2.hpp>
-#include <scene/Scene.hpp>
+#include <graph/GraphRunCtx.hpp>
 #include <RGLFields.hpp>
 
 void Ros2PublishPointsNode::setParameters(const char* topicName, const char* frameId,
@@ -31,41 +31,66 @@ void Ros2PublishPointsNode::setParameters(const char* topicName, const char* fra
 
 void Ros2PublishPointsNode::ros2ValidateImpl()
 {
-	if (input->getHeight() != 1) {
-		throw InvalidPipeline("ROS2 publish supports unorganized pointclouds only");
-	}
-
 	if (!input->hasField(RGL_FIELD_DYNAMIC_FORMAT)) {
 		auto msg = fmt::format("{} requires a formatted point cloud", getName());
 		throw InvalidPipeline(msg);
 	}
 
-	updateRos2Message(input->getRequiredFieldList(), input->isDense());
+	updateRos2Message(ros2Message, input->getRequiredFieldList(), input->isDense());
 }
 
 void Ros2PublishPointsNode::ros2EnqueueExecImpl()
 {
-	auto fieldData = input->getFieldData(RGL_FIELD_DYNAMIC_FORMAT)->asTyped<char>()->asSubclass<HostArray>();
-	int count = input->getPointCount();
-	ros2Message.data.resize(ros2Message.point_step * count);
-	const void* src = fieldData->getRawReadPtr();
-	size_t size = fieldData->getCount() * fieldData->getSizeOf();
-	CHECK_CUDA(cudaMemcpyAsync(ros2Message.data.data(), src, size, cudaMemcpyDefault, getStreamHandle()));
-	CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
-	ros2Message.width = count;
+	size_t size = ros2Message.point_step * input->getPointCount();
+	// Frames of FormatPointsNode are shared by all publishers of the cloud, without further copies (see getHostFrame).
+	// Buffers of other inputs are overwritten by the next run, possibly before the message is published.
+	HostPinnedArray<char>::ConstPtr messageData = nullptr;
+	if (auto formatInput = std::dynamic_pointer_cast<FormatPointsNode>(input)) {
+		messageData = formatInput->getHostFrame();
+	}
+	else {
+		auto fieldData = input->getFieldData(RGL_FIELD_DYNAMIC_FORMAT)->asTyped<char>()->asSubclass<HostArray>();
+		HostPinnedArray<char>::Ptr messageDataCopy = acquireMessageDataBuffer();
+		messageDataCopy->resize(size, false, false);
+		CHECK_CUDA(cudaMemcpyAsync(messageDataCopy->getRawWritePtr(), fieldData->getRawReadPtr(), size, cudaMemcpyDefault,
+		                           getStreamHandle()));
+		messageData = messageDataCopy;
+	}
+	// Organized point clouds (e.g. from rays with layout) are published as such.
+	ros2Message.width = input->getWidth();
+	ros2Message.height = input->getHeight();
 	ros2Message.row_step = ros2Message.point_step * ros2Message.width;
-	// TODO(msz-rai): Assign scene to the Graph.
-	// For now, only default scene is supported.
-	ros2Message.header.stamp = Scene::instance().getTime().has_value() ?
-	                               Scene::instance().getTime()->asRos2Msg() :
-	                               static_cast<builtin_interfaces::msg::Time>(ros2InitGuard->getNode().get_clock()->now());
-	ros2Publisher->publish(ros2Message);
+	// Stamped with the time of the scene raytraced by the graph, i.e. the one of its snapshot used in this run.
+	std::optional<Time> sceneTime = getGraphRunCtx()->getSceneTime();
+	ros2Message.header.stamp = sceneTime.has_value() ?
+	                           sceneTime->asRos2Msg() :
+	                           static_cast<builtin_interfaces::msg::Time>(ros2InitGuard->getNode().get_clock()->now());
+	ros2InitGuard->getPublishQueue().submit(this, getStreamHandle(),
+	                                        [publisher = ros2Publisher, message = ros2Message, messageData, size]() mutable {
+		                                        publish(*publisher, message, *messageData, size);
+	                                        });
 }
 
+void Ros2PublishPointsNode::publish(rclcpp::Publisher<sensor_msgs::msg::PointCloud2>& publisher,
+                                    sensor_msgs::msg::PointCloud2& message, const HostPinnedArray<char>& data, size_t size)
+{
+	// Middleware able to loan messages (e.g. shared-memory transport) provides their memory,
+	// so that the data is copied directly into it and is not serialized for subscribers on the same host.
+	if (publisher.can_loan_messages()) {
+		auto loanedMessage = publisher.borrow_loaned_message();
+		loanedMessage.get() = std::move(message);
+		loanedMessage.get().data.assign(data.getReadPtr(), data.getReadPtr() + size);
+		publisher.publish(std::move(loanedMessage));
+		return;
+	}
+	message.data.assign(data.getReadPtr(), data.getReadPtr() + size);
+	publisher.publish(message);
+}
 
-void Ros2PublishPointsNode::updateRos2Message(const std::vector<rgl_field_t>& fields, bool isDense)
+void Ros2PublishPointsNode::updateRos2Message(sensor_msgs::msg::PointCloud2& message, const std::vector<rgl_field_t>& fields,
+                                              bool isDense)
 {
-	ros2Message.fields.clear();
+	message.fields.clear();
 	int offset = 0;
 	for (const auto& field : fields) {
 		auto ros2fields = toRos2Fields(field);
@@ -74,7 +99,7 @@ void Ros2PublishPointsNode::updateRos2Message(const std::vector<rgl_field_t>& fi
 
 		for (int i = 0; i < ros2sizes.size(); ++i) {
 			if (ros2fields.size() > i && ros2names.size() > i) {
-				ros2Message.fields.push_back([&] {
+				message.fields.push_back([&] {
 					auto ret = sensor_msgs::msg::PointField();
 					ret.name = ros2names[i];
 					ret.datatype = ros2fields[i];
@@ -86,8 +111,8 @@ void Ros2PublishPointsNode::updateRos2Message(const std::vector<rgl_field_t>& fi
 			offset += ros2sizes[i];
 		}
 	}
-	ros2Message.height = 1;
-	ros2Message.point_step = offset;
-	ros2Message.is_dense = isDense;
-	ros2Message.is_bigendian = false;
+	message.height = 1;
+	message.point_step = offset;
+	message.is_dense = isDense;
+	message.is_bigendian = false;
 }
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
+
 #include <graph/NodesRos2.hpp>
-#include <scene/Scene.hpp>
+#include <graph/GraphRunCtx.hpp>
 
 void Ros2PublishRadarScanNode::setParameters(const char* topicName, const char* frameId,
                                              rgl_qos_policy_reliability_t qosReliability,
@@ -37,15 +39,26 @@ void Ros2PublishRadarScanNode::ros2ValidateImpl()
 
 void Ros2PublishRadarScanNode::ros2EnqueueExecImpl()
 {
-	ros2Message.header.stamp = Scene::instance().getTime().has_value() ?
-	                               Scene::instance().getTime().value().asRos2Msg() :
-	                               static_cast<builtin_interfaces::msg::Time>(ros2InitGuard->getNode().get_clock()->now());
+	// Stamped with the time of the scene raytraced by the graph, i.e. the one of its snapshot used in this run.
+	std::optional<Time> sceneTime = getGraphRunCtx()->getSceneTime();
+	ros2Message.header.stamp = sceneTime.has_value() ?
+	                           sceneTime->asRos2Msg() :
+	                           static_cast<builtin_interfaces::msg::Time>(ros2InitGuard->getNode().get_clock()->now());
 	std::vector<rgl_field_t> fields = this->getRequiredFieldList();
 	FormatPointsNode::formatAsync(formattedData, input, fields, fieldDescBuilder);
-	ros2Message.returns.resize(input->getPointCount());
-	CHECK_CUDA(cudaMemcpyAsync(ros2Message.returns.data(), formattedData->getReadPtr(),
-	                           formattedData->getSizeOf() * formattedData->getCount(), cudaMemcpyDeviceToHost,
+	// Formatted fields (see getRequiredFieldList) are the layout of RadarReturn, so that they are copied with a single memcpy.
+	static_assert(sizeof(radar_msgs::msg::RadarReturn) == 5 * sizeof(float));
+	size_t pointCount = input->getPointCount();
+	size_t size = pointCount * sizeof(radar_msgs::msg::RadarReturn);
+	HostPinnedArray<char>::Ptr messageData = acquireMessageDataBuffer();
+	messageData->resize(size, false, false);
+	CHECK_CUDA(cudaMemcpyAsync(messageData->getWritePtr(), formattedData->getReadPtr(), size, cudaMemcpyDeviceToHost,
 	                           formattedData->getStream()->getHandle()));
-	CHECK_CUDA(cudaStreamSynchronize(formattedData->getStream()->getHandle()));
-	ros2Publisher->publish(ros2Message);
+	ros2InitGuard->getPublishQueue().submit(
+	    this, formattedData->getStream()->getHandle(),
+	    [publisher = ros2Publisher, message = ros2Message, messageData, pointCount]() mutable {
+		    message.returns.resize(pointCount);
+		    std::memcpy(message.returns.data(), messageData->getReadPtr(), messageData->getCount());
+		    publisher->publish(message);
+	    });
 }
@@ -19,15 +19,19 @@
 
 class TapeRos2
 {
+	static void tape_configure_ros2(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_ros2_publish(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_ros2_publish_with_qos(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_ros2_publish_device(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_publish_ros2_radarscan(const YAML::Node& yamlNode, PlaybackState& state);
 
 	// Called once in the translation unit
 	static inline bool autoExtendTapeFunctions = std::invoke([]() {
 		std::map<std::string, TapeFunction> tapeFunctions = {
+		    TAPE_CALL_MAPPING("rgl_configure_ros2", TapeRos2::tape_configure_ros2),
 		    TAPE_CALL_MAPPING("rgl_node_points_ros2_publish", TapeRos2::tape_node_points_ros2_publish),
 		    TAPE_CALL_MAPPING("rgl_node_points_ros2_publish_with_qos", TapeRos2::tape_node_points_ros2_publish_with_qos),
+		    TAPE_CALL_MAPPING("rgl_node_points_ros2_publish_device", TapeRos2::tape_node_points_ros2_publish_device),
 		    TAPE_CALL_MAPPING("rgl_node_publish_ros2_radarscan", TapeRos2::tape_node_publish_ros2_radarscan),
 		};
 		TapePlayer::extendTapeFunctions(tapeFunctions);
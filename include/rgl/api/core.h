@@ -61,6 +61,16 @@
 // It is assigned by default if the user does not specify it.
 #define RGL_DEFAULT_ENTITY_ID 268435455
 
+// Default class ID is assigned to Entities without a class set by the user.
+// It is also reported for rays that does not hit any Entity.
+#define RGL_DEFAULT_CLASS_ID 0
+
+// Resolution (in meters) of RGL_FIELD_XYZ_VEC3_I16, giving the range of +-65.534 m.
+#define RGL_QUANTIZED_XYZ_STEP 0.002f
+
+// Default visibility mask of Entities and RaytraceNodes: all 8 layers, i.e. every Entity is visible to every sensor.
+#define RGL_DEFAULT_VISIBILITY_MASK 255
+
 /**
  * Two consecutive 32-bit floats.
  */
@@ -151,6 +161,256 @@ static_assert(std::is_trivial_v<rgl_radar_scope_t>);
 static_assert(std::is_standard_layout_v<rgl_radar_scope_t>);
 #endif
 
+/**
+ * Parameters of the FMCW (frequency-modulated continuous-wave) radar signal and its processing.
+ * The beat signal is sampled samples_per_chirp times per chirp (range bins) over chirp_count chirps (Doppler bins).
+ */
+typedef struct
+{
+	/**
+	 * The center frequency of the chirp (in Hz).
+	 */
+	float center_frequency;
+	/**
+	 * The frequency sweep of the chirp (in Hz); determines the range resolution.
+	 */
+	float bandwidth;
+	/**
+	 * The duration of a single chirp, also the interval between chirps (in seconds); determines the speed resolution.
+	 */
+	float chirp_duration;
+	/**
+	 * The number of samples of the beat signal per chirp.
+	 */
+	int32_t samples_per_chirp;
+	/**
+	 * The number of chirps processed together.
+	 */
+	int32_t chirp_count;
+	/**
+	 * The power transmitted by the radar (in dBm).
+	 */
+	float power_transmitted;
+	/**
+	 * The gain of the radar's antennas and any other gains of the device (in dBi).
+	 */
+	float cumulative_device_gain;
+	/**
+	 * The power of the receiver noise in a single sample (in dBm).
+	 */
+	float noise_power;
+	/**
+	 * The number of guard cells of CFAR detection in each direction (range and Doppler) around the tested cell.
+	 */
+	int32_t cfar_guard_cells;
+	/**
+	 * The number of training cells of CFAR detection in each direction, beyond the guard cells.
+	 */
+	int32_t cfar_training_cells;
+	/**
+	 * The minimum ratio of the power of a cell to the estimated noise power to report a detection (in dB).
+	 */
+	float cfar_threshold;
+} rgl_radar_fmcw_config_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_radar_fmcw_config_t) == 11 * sizeof(float));
+static_assert(std::is_trivial_v<rgl_radar_fmcw_config_t>);
+static_assert(std::is_standard_layout_v<rgl_radar_fmcw_config_t>);
+#endif
+
+/**
+ * Timings of a single Node, see rgl_graph_get_node_stats.
+ */
+typedef struct
+{
+	/**
+	 * Number of graph runs in which the Node has been timed.
+	 */
+	uint64_t sample_count;
+	/**
+	 * CPU time (in milliseconds) of enqueueing Node's work in the most recent timed run.
+	 */
+	float enqueue_cpu_time_ms;
+	/**
+	 * GPU time (in milliseconds) of Node's work (excluding copies to result buffers) in the most recent timed run.
+	 */
+	float exec_gpu_time_ms;
+	/**
+	 * GPU time (in milliseconds) of copies to buffers registered with rgl_graph_set_result_buffer in the most recent timed run.
+	 */
+	float result_copy_gpu_time_ms;
+	/**
+	 * Sum of peak capacities (in bytes) of the Node's device arrays, as of the most recent timed run.
+	 */
+	uint64_t array_peak_bytes;
+} rgl_node_stats_t;
+
+#ifdef __cplusplus
+static_assert(std::is_trivial_v<rgl_node_stats_t>);
+static_assert(std::is_standard_layout_v<rgl_node_stats_t>);
+#endif
+
+/**
+ * Process-wide counters of operations not attributable to a single Node, see rgl_get_performance_counters.
+ * Counts and times (in milliseconds of CPU time) are cumulative since the library has been loaded.
+ */
+typedef struct
+{
+	/**
+	 * Builds and refits of Scenes' acceleration structures, performed before raytracing modified Scenes.
+	 */
+	uint64_t as_build_count;
+	double as_build_time_ms;
+	/**
+	 * Builds of Scenes' shader binding tables, performed before raytracing modified Scenes.
+	 */
+	uint64_t sbt_build_count;
+	double sbt_build_time_ms;
+	/**
+	 * Calls to rgl_graph_get_result_data, including the time of waiting for the results.
+	 */
+	uint64_t result_copy_count;
+	double result_copy_time_ms;
+	/**
+	 * Number of Node runs timed so far, see rgl_configure_performance_sampling.
+	 */
+	uint64_t sampled_node_run_count;
+	/**
+	 * Waits of API calls for the tape writer thread, when too much recorded data is pending (see rgl_tape_record_begin).
+	 */
+	uint64_t tape_stall_count;
+	double tape_stall_time_ms;
+	/**
+	 * Peak amount (in bytes) of recorded data pending to be written to the tape.
+	 */
+	uint64_t tape_queue_peak_bytes;
+	/**
+	 * Log messages dropped because the logging queue was full, see rgl_configure_logging_queue.
+	 */
+	uint64_t log_dropped_count;
+	/**
+	 * Allocations of memory of internal arrays (device and pinned host), which do not happen in steady-state frames:
+	 * arrays grow geometrically and keep their capacity unless they stay much smaller for many frames.
+	 */
+	uint64_t array_allocation_count;
+	/**
+	 * Runs of RaytraceNodes which kept their previous output instead of tracing, see rgl_graph_configure_result_cache.
+	 */
+	uint64_t raytrace_cache_hit_count;
+	/**
+	 * Rays traced by RaytraceNodes; each return of a multi-return lidar is a separate ray.
+	 */
+	uint64_t traced_ray_count;
+	/**
+	 * Builds (and updates of deformable meshes) of geometry acceleration structures, and builds and refits
+	 * of scenes' instance acceleration structures. Their total time is included in as_build_time_ms.
+	 */
+	uint64_t gas_build_count;
+	uint64_t ias_build_count;
+	uint64_t ias_refit_count;
+	/**
+	 * Bytes of arrays copied between the host and the device, e.g. inputs of API calls and results.
+	 * Small transfers made by nodes internally (e.g. counts of points) are not included.
+	 * See also host_to_host_bytes and device_to_device_bytes.
+	 */
+	uint64_t host_to_device_bytes;
+	uint64_t device_to_host_bytes;
+	/**
+	 * Current capacity (in bytes) of internal arrays in device memory and in pinned host memory.
+	 */
+	uint64_t device_array_bytes;
+	uint64_t host_pinned_array_bytes;
+	/**
+	 * Recorded data (in bytes) currently pending to be written to the tape.
+	 */
+	uint64_t tape_queue_bytes;
+	/**
+	 * Bytes of arrays copied within the host or within the device memory, e.g. when arrays grow preserving their data.
+	 */
+	uint64_t host_to_host_bytes;
+	uint64_t device_to_device_bytes;
+	/**
+	 * Waits for all running graphs, e.g. by calls modifying meshes or textures used by them.
+	 */
+	uint64_t synchronize_all_count;
+	double synchronize_all_time_ms;
+} rgl_performance_counters_t;
+
+#ifdef __cplusplus
+static_assert(std::is_trivial_v<rgl_performance_counters_t>);
+static_assert(std::is_standard_layout_v<rgl_performance_counters_t>);
+#endif
+
+/**
+ * Kinds of memory of RGL's internal arrays, see rgl_get_memory_kind_stats.
+ */
+typedef enum : int32_t
+{
+	RGL_MEMORY_KIND_DEVICE_ASYNC = 0, // Allocated in stream order, see rgl_configure_device_memory_pool
+	RGL_MEMORY_KIND_DEVICE_SYNC = 1,
+	RGL_MEMORY_KIND_HOST_PAGEABLE = 2,
+	RGL_MEMORY_KIND_HOST_PINNED = 3, // See rgl_configure_host_pinned_memory_pool
+	RGL_MEMORY_KIND_DEVICE_MANAGED = 4,
+} rgl_memory_kind_t;
+
+/**
+ * Accounting of allocations of internal arrays of a memory kind, since the start of the process.
+ * Arrays keep their capacity, so steady-state frames make no allocations (allocation_count does not change).
+ */
+typedef struct
+{
+	uint64_t live_bytes; // Currently allocated
+	uint64_t peak_bytes; // Maximum of live_bytes
+	uint64_t allocation_count;
+	uint64_t deallocation_count;
+} rgl_memory_kind_stats_t;
+
+#ifdef __cplusplus
+static_assert(std::is_trivial_v<rgl_memory_kind_stats_t>);
+static_assert(std::is_standard_layout_v<rgl_memory_kind_stats_t>);
+#endif
+
+/**
+ * Device memory (in bytes) held by subsystems of RGL, see rgl_get_memory_usage.
+ */
+typedef struct
+{
+	/**
+	 * GASes of all Meshes (including their compacted copies), see rgl_configure_gas_eviction.
+	 */
+	uint64_t gas_bytes;
+	/**
+	 * Temporary buffers shared by all GAS builds (one per stream building them), sized for the largest GAS built so far.
+	 */
+	uint64_t gas_scratch_bytes;
+	/**
+	 * Vertices, indices and texture coordinates of all Meshes.
+	 */
+	uint64_t mesh_bytes;
+	/**
+	 * IASes of all Scenes (both versions, with their scratch buffers, instances and transforms).
+	 */
+	uint64_t ias_bytes;
+	/**
+	 * Shader binding tables of all Scenes (both versions).
+	 */
+	uint64_t sbt_bytes;
+	/**
+	 * Arrays of Nodes allocated from the device memory pool (see rgl_get_device_memory_pool_stats).
+	 */
+	uint64_t node_bytes;
+	/**
+	 * Texels of all Textures (shared ones counted once).
+	 */
+	uint64_t texture_bytes;
+} rgl_memory_usage_t;
+
+#ifdef __cplusplus
+static_assert(std::is_trivial_v<rgl_memory_usage_t>);
+static_assert(std::is_standard_layout_v<rgl_memory_usage_t>);
+#endif
+
 /**
  * Represents on-GPU Mesh that can be referenced by Entities on the Scene.
  * Each Mesh can be referenced by any number of Entities on different Scenes.
@@ -193,6 +453,7 @@ typedef enum : int32_t
 	RGL_EXTENSION_ROS2 = 1,
 	RGL_EXTENSION_UDP = 2,
 	RGL_EXTENSION_SNOW = 3,
+	RGL_EXTENSION_GL = 4,
 	RGL_EXTENSION_COUNT
 } rgl_extension_t;
 
@@ -374,6 +635,40 @@ typedef enum : int32_t
 	 */
 	RGL_FIELD_RAY_POSE_MAT3x4_F32,
 
+	/**
+	 * Semantic class of the hit Entity, see rgl_entity_set_class_id.
+	 * RGL_DEFAULT_CLASS_ID for non-hits and particles of weather effects.
+	 */
+	RGL_FIELD_CLASS_ID_U16,
+
+	/**
+	 * Compact variants of geometric fields, computed by the raytrace node only (nodes modifying the above fields,
+	 * e.g. points_transform or noise, do not update them). Half-precision floats are stored as IEEE 754 binary16 bits.
+	 * Note: ROS2 PointField has no half-precision type, such components are published as UINT16.
+	 */
+	RGL_FIELD_XYZ_VEC3_F16,
+	RGL_FIELD_DISTANCE_F16,
+	RGL_FIELD_NORMAL_VEC3_F16,
+
+	/**
+	 * Hit-point coordinates in the sensor frame (relative to the ray origin), in units of RGL_QUANTIZED_XYZ_STEP.
+	 * Coordinates out of range saturate at +-INT16_MAX steps. Non-hits at infinite distance are not representable
+	 * (their coordinates are undefined), so they should be compacted out (see RGL_FIELD_IS_HIT_I32).
+	 */
+	RGL_FIELD_XYZ_VEC3_I16,
+
+	/**
+	 * Surface variation of the neighbourhood of the point, estimated by rgl_node_points_estimate_normals.
+	 * Ratio of the smallest eigenvalue of neighbourhood's covariance to their sum, in range [0, 1/3] (0 is a plane).
+	 */
+	RGL_FIELD_CURVATURE_F32,
+
+	/**
+	 * Identifier of the cluster of the point, assigned by rgl_node_points_cluster_euclidean.
+	 * Clusters are numbered consecutively from 0 (in the order of their lowest point index), -1 means no cluster.
+	 */
+	RGL_FIELD_CLUSTER_ID_I32,
+
 	// Dummy fields
 	RGL_FIELD_PADDING_8 = 1024,
 	RGL_FIELD_PADDING_16,
@@ -392,8 +687,305 @@ typedef enum : int32_t
 	RGL_AXIS_Z = 3,
 } rgl_axis_t;
 
+/**
+ * Kind of the return reported in RGL_FIELD_RETURN_TYPE_U8.
+ */
+typedef enum : int32_t
+{
+	RGL_RETURN_TYPE_UNKNOWN = 0,
+	RGL_RETURN_TYPE_FIRST = 1,
+	RGL_RETURN_TYPE_LAST = 2,
+	RGL_RETURN_TYPE_STRONGEST = 3,
+	RGL_RETURN_TYPE_MULTIPATH = 4, // Surface met by a reflection of the ray, see rgl_node_raytrace_configure_multipath
+} rgl_return_type_t;
+
+/**
+ * Selects which intersections along the ray are reported by RaytraceNode.
+ * Dual modes produce two points per ray, see `rgl_node_raytrace_configure_return_mode`.
+ * The strongest return is the one with the highest intensity; on equal intensities, the closer one is chosen.
+ */
+typedef enum : int32_t
+{
+	RGL_RETURN_MODE_FIRST = 0,
+	RGL_RETURN_MODE_LAST = 1,
+	RGL_RETURN_MODE_STRONGEST = 2,
+	RGL_RETURN_MODE_DUAL_FIRST_LAST = 3,
+	RGL_RETURN_MODE_DUAL_STRONGEST_LAST = 4,
+} rgl_return_mode_t;
+
+/**
+ * Selects how results of sub-rays of a divergent beam are reduced to a single point,
+ * see `rgl_node_raytrace_configure_beam_divergence`.
+ */
+typedef enum : int32_t
+{
+	RGL_BEAM_REDUCTION_NEAREST = 0,   // Hit of the sub-ray with the shortest distance
+	RGL_BEAM_REDUCTION_MEAN = 1,      // Mean distance of hitting sub-rays, along the central (or first hitting) sub-ray
+	RGL_BEAM_REDUCTION_STRONGEST = 2, // Hit of the sub-ray with the smallest incident angle
+} rgl_beam_reduction_t;
+
+/**
+ * Coordinate frame of results of RaytraceNode, see `rgl_node_raytrace_configure_output_frame`.
+ */
+typedef enum : int32_t
+{
+	RGL_OUTPUT_FRAME_WORLD = 0,  // Frame of the scene
+	RGL_OUTPUT_FRAME_SENSOR = 1, // Frame of the ray origin (sensor), i.e. rays without transforms applied by RaysTransformNode
+} rgl_output_frame_t;
+
+/**
+ * Storage format of vertices of a compressed Mesh, see `rgl_mesh_compress`.
+ */
+typedef enum : int32_t
+{
+	RGL_VERTEX_FORMAT_FLOAT32 = 0, // Vertices are left as they are
+	RGL_VERTEX_FORMAT_FLOAT16 = 1, // Half-precision floats; suitable for meshes placed near their local origin
+	RGL_VERTEX_FORMAT_SNORM16 = 2, // 16-bit integers normalized to the bounding box of the Mesh
+} rgl_vertex_format_t;
+
+/**
+ * Storage format of a Texture on the GPU, see `rgl_texture_create_mipmapped`.
+ */
+typedef enum : int32_t
+{
+	RGL_TEXTURE_FORMAT_R8 = 0,  // One byte per texel, as provided
+	RGL_TEXTURE_FORMAT_BC4 = 1, // Block-compressed to 8 bytes per 4x4 texels (lossy); dimensions must be multiples of 4
+} rgl_texture_format_t;
+
+/**
+ * Shape of a region of space, see `rgl_region_t`.
+ */
+typedef enum : int32_t
+{
+	RGL_REGION_SHAPE_BOX = 0,           // Axis-aligned box spanned between `min` and `max` corners
+	RGL_REGION_SHAPE_CYLINDER = 1,      // Cylinder around Z axis; radius in [min.x, max.x], height in [min.z, max.z]
+	RGL_REGION_SHAPE_DISTANCE_BAND = 2, // Spherical shell around the origin; distance in [min.x, max.x]
+} rgl_region_shape_t;
+
+/**
+ * Region of space (in the coordinate frame of points) used to crop point clouds, see `rgl_node_points_compact_by_region`.
+ * Bounds are inclusive. Components of `min` and `max` not used by the shape are ignored.
+ */
+typedef struct
+{
+	rgl_region_shape_t shape;
+	rgl_vec3f min;
+	rgl_vec3f max;
+	/**
+	 * If true, points have to be outside the region, otherwise they have to be inside it.
+	 */
+	bool exclude;
+} rgl_region_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_region_t) == 8 * sizeof(float));
+static_assert(std::is_trivial_v<rgl_region_t>);
+static_assert(std::is_standard_layout_v<rgl_region_t>);
+#endif
+
+/**
+ * Comparison of a field value (left-hand side) with an operand (right-hand side), see `rgl_field_predicate_t`.
+ */
+typedef enum : int32_t
+{
+	RGL_COMPARISON_EQUAL = 0,
+	RGL_COMPARISON_NOT_EQUAL = 1,
+	RGL_COMPARISON_LESS = 2,
+	RGL_COMPARISON_LESS_EQUAL = 3,
+	RGL_COMPARISON_GREATER = 4,
+	RGL_COMPARISON_GREATER_EQUAL = 5,
+} rgl_comparison_t;
+
+/**
+ * Condition on the value of a scalar field of a point, e.g. `RGL_FIELD_DISTANCE_F32 < 50`,
+ * see `rgl_node_points_compact_by_predicates`.
+ * Values of all the scalar fields are represented exactly by double; the operand is compared with them without rounding.
+ */
+typedef struct
+{
+	rgl_field_t field;
+	rgl_comparison_t comparison;
+	double value;
+} rgl_field_predicate_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_field_predicate_t) == 2 * sizeof(int32_t) + sizeof(double));
+static_assert(std::is_trivial_v<rgl_field_predicate_t>);
+static_assert(std::is_standard_layout_v<rgl_field_predicate_t>);
+#endif
+
+/**
+ * Cell of an occupancy grid, see `rgl_node_points_occupancy_grid`.
+ */
+typedef struct
+{
+	int32_t hit_count;  // Number of hit points in the cell
+	int32_t miss_count; // Number of rays crossing the cell without ending in it (zero unless ray casting is enabled)
+	float min_height;   // Lowest Z of hit points in the cell, +infinity if there are none
+	float max_height;   // Highest Z of hit points in the cell, -infinity if there are none
+} rgl_occupancy_cell_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_occupancy_cell_t) == 4 * sizeof(int32_t));
+static_assert(std::is_trivial_v<rgl_occupancy_cell_t>);
+static_assert(std::is_standard_layout_v<rgl_occupancy_cell_t>);
+#endif
+
+/**
+ * Axis-aligned bounding box of a cluster of points, see `rgl_node_points_cluster_boxes`.
+ */
+typedef struct
+{
+	rgl_vec3f min;       // Lowest coordinates of points of the cluster
+	rgl_vec3f max;       // Highest coordinates of points of the cluster
+	int32_t point_count; // Number of points in the cluster
+} rgl_cluster_box_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_cluster_box_t) == 7 * sizeof(float));
+static_assert(std::is_trivial_v<rgl_cluster_box_t>);
+static_assert(std::is_standard_layout_v<rgl_cluster_box_t>);
+#endif
+
+/**
+ * Formats of point cloud files written by `rgl_node_points_write_file`.
+ */
+typedef enum : int32_t
+{
+	RGL_POINT_FILE_FORMAT_PCD = 0, // Binary PCD v0.7, all fields of the formatted point cloud
+	RGL_POINT_FILE_FORMAT_PLY = 1, // Binary (little endian) PLY, all fields of the formatted point cloud as vertex properties
+	RGL_POINT_FILE_FORMAT_LAS = 2, // LAS 1.2 (point data format 0): XYZ, intensity and classification (from class id)
+} rgl_point_file_format_t;
+
+/**
+ * Layout of the shared memory written by `rgl_node_points_shm_publish`, so that readers need only this header.
+ * The shared memory object begins with rgl_shm_ring_header_t, followed by `slot_count` rgl_shm_slot_header_t,
+ * followed by point data of the slots (each `slot_data_size` bytes, at `data_offset` from the beginning of the object).
+ */
+#define RGL_SHM_RING_MAGIC 0x52474C52 // "RGLR"
+#define RGL_SHM_RING_VERSION 1
+#define RGL_SHM_MAX_FIELD_COUNT 32
+#define RGL_SHM_IPC_HANDLE_SIZE 64 // sizeof(cudaIpcMemHandle_t)
+
+typedef struct
+{
+	uint32_t magic;           // RGL_SHM_RING_MAGIC, written last when the ring is created
+	uint32_t version;         // RGL_SHM_RING_VERSION
+	int32_t slot_count;       // Number of slots, frame N is written to the slot (N % slot_count)
+	int32_t reserved;         // Zero
+	uint64_t slot_data_size;  // Capacity (in bytes) of each slot's point data
+	uint64_t latest_frame_id; // Frame id of the most recently completed slot, zero if none; accessed atomically
+} rgl_shm_ring_header_t;
+
+typedef struct
+{
+	/**
+	 * Sequence lock of the slot, accessed atomically: odd while the slot is being written, even otherwise.
+	 * Reader copies the slot (header and data) between two loads (acquire) of the sequence;
+	 * the copy is consistent if both loads returned the same even value.
+	 */
+	uint64_t sequence;
+	uint64_t frame_id;       // Identifier of the graph run which produced the point cloud
+	uint64_t timestamp_ns;   // Time of the raytraced scene (see `rgl_scene_set_time`), zero if not set
+	int32_t width;           // Point cloud is organized if height > 1
+	int32_t height;          //
+	int32_t point_size;      // Size (in bytes) of a single point formatted from `fields`
+	int32_t field_count;     // Number of elements in `fields`
+	int32_t fields[RGL_SHM_MAX_FIELD_COUNT]; // Layout of a point, see `rgl_node_points_format`
+	uint64_t data_offset;    // Offset of the slot's point data from the beginning of the shared memory object
+	int32_t is_dense;        // Non-zero if all points are hits
+	int32_t has_device_data; // Non-zero if the point data is also in the device buffer described by `device_ipc_handle`
+	// cudaIpcMemHandle_t of the slot's device buffer (same size as host data), to be opened with cudaIpcOpenMemHandle.
+	// Handle does not change over the lifetime of the ring; the device buffer is guarded by `sequence` as the host data.
+	char device_ipc_handle[RGL_SHM_IPC_HANDLE_SIZE];
+} rgl_shm_slot_header_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_shm_ring_header_t) == 32);
+static_assert(std::is_trivial_v<rgl_shm_ring_header_t>);
+static_assert(std::is_standard_layout_v<rgl_shm_ring_header_t>);
+static_assert(sizeof(rgl_shm_slot_header_t) == 8 * 3 + 4 * (4 + RGL_SHM_MAX_FIELD_COUNT) + 8 + 4 * 2 + RGL_SHM_IPC_HANDLE_SIZE);
+static_assert(std::is_trivial_v<rgl_shm_slot_header_t>);
+static_assert(std::is_standard_layout_v<rgl_shm_slot_header_t>);
+#endif
+
+/**
+ * Layout of the byte stream produced by `rgl_node_points_compress`.
+ * The stream begins with rgl_compressed_points_header_t, followed by ceil(point_count / RGL_COMPRESSED_POINTS_BLOCK_SIZE)
+ * blocks of consecutive points. Blocks are independent: each begins with rgl_compressed_block_header_t, followed by
+ * the deltas of X, then Y, then Z coordinates of the remaining points of the block.
+ * Coordinates are quantized as round(coordinate / xyz_step); delta of a point is its quantized coordinate minus that of
+ * the previous point, zigzag-encoded ((delta << 1) ^ (delta >> 31)) into an unsigned integer.
+ * Deltas of an axis are bit-packed with the axis' bit width (least significant bits first) into little-endian 32-bit words,
+ * so they take ceil((points in the block - 1) * bit width / 32) words.
+ */
+#define RGL_COMPRESSED_POINTS_MAGIC 0x43474C52 // "RGLC"
+#define RGL_COMPRESSED_POINTS_VERSION 1
+#define RGL_COMPRESSED_POINTS_BLOCK_SIZE 128
+
+typedef struct
+{
+	uint32_t magic;       // RGL_COMPRESSED_POINTS_MAGIC
+	uint32_t version;     // RGL_COMPRESSED_POINTS_VERSION
+	uint32_t point_count; // Number of encoded points
+	float xyz_step;       // Quantization step (in units of coordinates, e.g. meters)
+} rgl_compressed_points_header_t;
+
+typedef struct
+{
+	int32_t first[3];      // Quantized coordinates of the first point of the block
+	uint8_t bit_widths[3]; // Bit widths (0 to 32) of deltas of X, Y and Z
+	uint8_t reserved;      // Zero
+} rgl_compressed_block_header_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_compressed_points_header_t) == 16);
+static_assert(std::is_trivial_v<rgl_compressed_points_header_t>);
+static_assert(std::is_standard_layout_v<rgl_compressed_points_header_t>);
+static_assert(sizeof(rgl_compressed_block_header_t) == 16);
+static_assert(std::is_trivial_v<rgl_compressed_block_header_t>);
+static_assert(std::is_standard_layout_v<rgl_compressed_block_header_t>);
+#endif
+
+/**
+ * Closest hit of a ray traced with `rgl_scene_raycast_batch`.
+ */
+typedef struct
+{
+	float distance;    // Distance from the ray origin to the hit, infinity if the ray missed
+	int32_t entity_id; // Id of the hit Entity (see `rgl_entity_set_id`), RGL_ENTITY_INVALID_ID if the ray missed
+} rgl_raycast_hit_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(rgl_raycast_hit_t) == 8);
+static_assert(std::is_trivial_v<rgl_raycast_hit_t>);
+static_assert(std::is_standard_layout_v<rgl_raycast_hit_t>);
+#endif
+
+/**
+ * Callback notifying that the data requested by `rgl_graph_get_result_data_async` is ready (or could not be delivered).
+ * @param status Status of the request; data is available only if it is RGL_SUCCESS.
+ * @param user_data Pointer passed to `rgl_graph_get_result_data_async`.
+ */
+typedef void (*rgl_result_callback_t)(rgl_status_t status, void* user_data);
+
 /******************************** GENERAL ********************************/
 
+/*
+ * API calls may be made concurrently from different threads, under the following rules:
+ * - Calls using the same graph (running it, getting its results, changing parameters of its nodes) are serialized.
+ *   Calls using different graphs do not wait for each other, i.e. graphs may be run and read by separate threads.
+ * - Changing structure of a graph (adding, removing or destroying its nodes) must not be done concurrently
+ *   with other calls using the graph.
+ * - Edits of entities and scenes are serialized by a lock shared by all scenes, which is also held by rgl_graph_run
+ *   when it acquires the scene version to be raytraced. Since the edits are short and running graphs raytrace
+ *   their own versions of scenes, entities may be updated by one thread while graphs are run by others.
+ * - Calls modifying meshes or textures (and some scene settings) wait until all affected graphs finish,
+ *   and rgl_graph_run waits for them.
+ * - Status of the last call (see rgl_get_last_error_string) is kept per thread. Unrecoverable errors affect all threads.
+ * - An object must not be used by one thread while it is being destroyed by another.
+ */
+
 /**
  * Returns data describing semantic version as described in https://semver.org/
  * Version string can be obtained by formatting "{out_major}.{out_minor}.{out_patch}".
@@ -425,8 +1017,206 @@ RGL_API rgl_status_t rgl_get_extension_info(rgl_extension_t extension, int32_t*
 RGL_API rgl_status_t rgl_configure_logging(rgl_log_level_t log_level, const char* log_file_path, bool use_stdout);
 
 /**
- * Returns a pointer to a string explaining the last error. This function always succeeds.
- * Returned pointer is valid only until the next RGL API call.
+ * Optionally makes logs written by a background thread, so that calling threads (including graph threads) never wait
+ * for writing to the file or stdout. Messages are passed through a bounded queue; when it is full, the oldest ones are
+ * dropped and counted (see `log_dropped_count` in rgl_performance_counters_t).
+ * Sinks configured by rgl_configure_logging are kept, and vice versa.
+ * @param queue_size Maximum number of queued messages. Zero (the default) makes logging synchronous.
+ */
+RGL_API rgl_status_t rgl_configure_logging_queue(int32_t queue_size);
+
+/**
+ * Configures stream-ordered memory pool used for device memory of graph nodes.
+ * By default, the pool keeps all memory freed to it (i.e. the release threshold is unlimited),
+ * so that steady-state graph runs do not allocate memory from the driver.
+ * @param release_threshold Amount of unused memory (in bytes) the pool may hold; the excess is released to the OS.
+ * @param reserved_size Amount of memory (in bytes) to pre-allocate in the pool. Must not exceed release_threshold.
+ */
+RGL_API rgl_status_t rgl_configure_device_memory_pool(uint64_t release_threshold, uint64_t reserved_size);
+
+/**
+ * Returns counters of the device memory pool (see rgl_configure_device_memory_pool).
+ * @param out_reserved_bytes Amount of memory (in bytes) currently allocated by the pool from the driver.
+ * @param out_used_bytes Amount of memory (in bytes) currently allocated from the pool.
+ * @param out_allocation_count Number of allocations made from the pool. Steady-state graph runs do not increase it.
+ */
+RGL_API rgl_status_t rgl_get_device_memory_pool_stats(uint64_t* out_reserved_bytes, uint64_t* out_used_bytes,
+                                                      uint64_t* out_allocation_count);
+
+/**
+ * Configures the pool of page-locked host memory used for staging transfers between the host and the device.
+ * Page-locking memory is expensive, so the pool keeps freed blocks for reuse, up to the given limit (256 MiB by default).
+ * @param max_cached_bytes Amount of unused memory (in bytes) the pool may hold; the excess is released to the OS.
+ */
+RGL_API rgl_status_t rgl_configure_host_pinned_memory_pool(uint64_t max_cached_bytes);
+
+/**
+ * Returns counters of the pinned host memory pool (see rgl_configure_host_pinned_memory_pool).
+ * @param out_cached_bytes Amount of unused memory (in bytes) currently held by the pool.
+ * @param out_used_bytes Amount of memory (in bytes) currently allocated from the pool.
+ * @param out_allocation_count Number of blocks page-locked by the pool. Steady-state graph runs do not increase it.
+ */
+RGL_API rgl_status_t rgl_get_host_pinned_memory_pool_stats(uint64_t* out_cached_bytes, uint64_t* out_used_bytes,
+                                                           uint64_t* out_allocation_count);
+
+/**
+ * Returns device memory held by subsystems of RGL, e.g. to find out whether memory of streamed-out Meshes was reclaimed.
+ * Memory is reported as allocated (i.e. including the capacity of arrays kept for reuse), not as requested.
+ * @param out_usage Address to store the usage
+ */
+RGL_API rgl_status_t rgl_get_memory_usage(rgl_memory_usage_t* out_usage);
+
+/**
+ * Returns accounting of allocations of internal arrays of the given memory kind, see rgl_memory_kind_stats_t.
+ * Bytes copied between memories are reported by rgl_get_performance_counters, per direction.
+ * @param kind Memory kind of arrays.
+ * @param out_stats Non-null pointer where the statistics will be stored.
+ */
+RGL_API rgl_status_t rgl_get_memory_kind_stats(rgl_memory_kind_t kind, rgl_memory_kind_stats_t* out_stats);
+
+/**
+ * Configures eviction of GASes of Meshes unused by all Scenes, i.e. not used by any Entity and not referenced by
+ * AS versions possibly used by running graphs. When memory of all GASes exceeds the budget, GASes of the least
+ * recently used Meshes are released, until it fits the budget. Evicted GAS is built again when its Mesh is used.
+ * Checked whenever a graph acquires a Scene (e.g. once per frame for a single raytraced Scene).
+ * GASes of compressed Meshes (see rgl_mesh_compress) are never evicted, since they could not be built again.
+ * @param gas_budget_bytes Memory (in bytes) of all GASes above which eviction starts; UINT64_MAX (the default) disables it.
+ * @param min_unused_frames Number of acquisitions of Scenes for which a Mesh must remain unused to be evicted.
+ */
+RGL_API rgl_status_t rgl_configure_gas_eviction(uint64_t gas_budget_bytes, int32_t min_unused_frames);
+
+/**
+ * Configures retaining Meshes destroyed by the client (by rgl_mesh_destroy or rgl_cleanup), so that rgl_mesh_create
+ * called again with identical vertices and indices (e.g. when a map is loaded again) returns a new handle to the retained
+ * Mesh instead of uploading its data and building its GAS anew. Meshes are looked up by a hash of their contents,
+ * which are verified before reuse. Only Meshes not modified after creation (e.g. by rgl_mesh_update_vertices,
+ * rgl_mesh_set_texture_coords or rgl_mesh_compress) are retained. Retained Meshes are reported by rgl_get_memory_usage.
+ * By default, Meshes are not retained.
+ * @param enabled If false, no Meshes are retained and the retained ones are freed.
+ * @param budget_bytes Memory (in bytes, GASes and geometry) of retained Meshes; the least recently retained are freed above it.
+ */
+RGL_API rgl_status_t rgl_configure_mesh_cache(bool enabled, uint64_t budget_bytes);
+
+/**
+ * Configures timing of Nodes' execution, see rgl_graph_get_node_stats.
+ * Nodes are timed in every N-th run of their graph, which bounds the overhead of synchronizing timing events.
+ * Nodes replayed as a part of a captured CUDA graph are not timed. By default, Nodes are not timed.
+ * @param frame_interval Interval N (in graph runs) between timed runs. Zero disables timing.
+ */
+RGL_API rgl_status_t rgl_configure_performance_sampling(int32_t frame_interval);
+
+/**
+ * Returns process-wide performance counters, see rgl_performance_counters_t. They are always collected.
+ * @param out_counters Non-null pointer where the counters will be stored.
+ */
+RGL_API rgl_status_t rgl_get_performance_counters(rgl_performance_counters_t* out_counters);
+
+/**
+ * Configures export of metrics for monitoring systems: performance counters (see rgl_performance_counters_t)
+ * and histograms of latencies of graph runs, from rgl_graph_run to completion of the run's GPU work.
+ * Latencies are measured only while metrics are enabled; by default, they are disabled.
+ * @param enabled If false, latencies are not measured and the HTTP endpoint is stopped.
+ * @param http_port If non-zero (and enabled), metrics are served in OpenMetrics (Prometheus) text format over HTTP
+ * on this TCP port, on all network interfaces. The endpoint is not supported on Windows.
+ */
+RGL_API rgl_status_t rgl_configure_metrics(bool enabled, int32_t http_port);
+
+/**
+ * Returns metrics (see rgl_configure_metrics) in OpenMetrics (Prometheus) text format,
+ * so that they can be forwarded to a monitoring system by the client, without the HTTP endpoint.
+ * @param out_text Address to store a pointer to the null-terminated text.
+ * Returned pointer is valid only until the next call of this function in the calling thread.
+ */
+RGL_API rgl_status_t rgl_get_metrics_text(const char** out_text);
+
+/**
+ * Starts recording a timeline of RGL's work in the process: API calls, enqueuing and synchronization of graphs
+ * (the ranges visible in NVIDIA Nsight, see NVTX) and GPU execution of nodes (except runs replayed from CUDA graphs).
+ * It is meant for short sessions, e.g. a few frames: GPU work is timed with CUDA events, adding overhead to each node run.
+ * @param max_event_count Number of events recorded by each thread; further events are dropped (and counted).
+ */
+RGL_API rgl_status_t rgl_trace_start(int32_t max_event_count);
+
+/**
+ * Stops recording started with rgl_trace_start and writes the timeline in Chrome Trace Event Format (JSON),
+ * which can be opened in Perfetto UI (ui.perfetto.dev) or chrome://tracing. Waits for traced GPU work to complete.
+ * @param file_path Path of the output file. It will be overwritten if it exists.
+ */
+RGL_API rgl_status_t rgl_trace_stop(const char* file_path);
+
+/**
+ * Configures the disk cache of OptiX programs, which RGL compiles from PTX when it is initialized.
+ * With the cache, compilation is skipped in subsequent processes, unless the driver or RGL binary changes.
+ * By default, the cache is enabled in the OptiX default location.
+ * Must be called before the initialization, i.e. before rgl_warmup and any call using the scene or raytracing.
+ * @param enabled If false, programs are compiled on every initialization.
+ * @param cache_path Directory of the cache. Pass nullptr to keep the default one.
+ * @param max_size_bytes Size above which the least recently used entries are evicted. Zero keeps the default size.
+ */
+RGL_API rgl_status_t rgl_configure_program_cache(bool enabled, const char* cache_path, uint64_t max_size_bytes);
+
+/**
+ * Enables motion blur: moving Entities are traced at the time of each ray (see rgl_node_rays_set_time_offsets),
+ * instead of all rays of a sweep seeing them in the pose set for the scene time.
+ * The pose at a ray's time is extrapolated from the Entity's poses in the current and the previous frame
+ * (requires rgl_scene_set_time) and is kept for offsets beyond the frame duration. Entities posed from device memory
+ * are not motion-blurred. It makes traversal somewhat slower in all Scenes, hence it is disabled by default.
+ * Must be called before the initialization, i.e. before rgl_warmup and any call using the scene or raytracing.
+ * @param enabled If true, motion blur is used in all Scenes.
+ */
+RGL_API rgl_status_t rgl_configure_motion_blur(bool enabled);
+
+/**
+ * Sets the limit of registers per thread in OptiX programs, which RGL compiles when it is initialized.
+ * Lower limits allow more threads to run concurrently (occupancy), but spill more values to memory;
+ * the best value depends on the GPU and enabled features. By default, the limit is 100.
+ * Must be called before the initialization, i.e. before rgl_warmup and any call using the scene or raytracing.
+ * @param max_register_count Register limit. Zero lets OptiX choose one.
+ */
+RGL_API rgl_status_t rgl_configure_max_register_count(int32_t max_register_count);
+
+/**
+ * Initializes the GPU context, compiles OptiX programs and creates the device memory pool and the default scene.
+ * Otherwise, this happens on their first use, usually in the first frame.
+ * Calling this function is optional.
+ */
+RGL_API rgl_status_t rgl_warmup(void);
+
+/**
+ * Selects the CUDA device used by RGL in this process. By default, it is device 0.
+ * The scene, graphs and all their resources live on a single device; to use several GPUs,
+ * run one process per device and shard sensors between the processes.
+ * Must be called before any resources are created, i.e. before rgl_warmup and any call creating API objects.
+ * @param device_index Index of the CUDA device, as in cudaSetDevice.
+ */
+RGL_API rgl_status_t rgl_configure_device(int32_t device_index);
+
+/**
+ * Returns the number of CUDA devices available to RGL. RGL requires a CUDA-enabled GPU: on hosts without one
+ * (or without the NVIDIA driver), this returns zero and other calls using the GPU fail.
+ * It lets clients (e.g. CI jobs on CPU-only machines) detect that before creating any resources.
+ * @param out_device_count Address to store the number of devices.
+ */
+RGL_API rgl_status_t rgl_get_device_count(int32_t* out_device_count);
+
+/**
+ * Configures CPU affinity of threads started by RGL, which by default may run on all CPUs of the process.
+ * Graph workers enqueue graph runs and execute host compute nodes; I/O threads write files and tapes, stream meshes,
+ * serve metrics, publish to ROS2 and run visualizers. Threads are named "rgl-<role>[-<index>]" for profilers.
+ * The configuration applies to running threads and to threads started later. Not supported on Windows.
+ * @param graph_worker_cpus Array of indices of CPUs for graph workers. May be nullptr if the count is zero.
+ * @param graph_worker_cpu_count Number of elements in graph_worker_cpus. Zero means no restriction (see below).
+ * @param io_cpus Array of indices of CPUs for I/O threads. May be nullptr if the count is zero.
+ * @param io_cpu_count Number of elements in io_cpus. Zero means no restriction (see below).
+ * @param prefer_gpu_numa_node If true, roles without CPUs given are restricted to CPUs of the NUMA node
+ * the selected GPU (see rgl_configure_device) is attached to; on single-node machines, this has no effect.
+ */
+RGL_API rgl_status_t rgl_configure_threads(const int32_t* graph_worker_cpus, int32_t graph_worker_cpu_count,
+                                           const int32_t* io_cpus, int32_t io_cpu_count, bool prefer_gpu_numa_node);
+
+/**
+ * Returns a pointer to a string explaining the last error of an API call made by the calling thread.
+ * This function always succeeds. Returned pointer is valid only until the next RGL API call in the calling thread.
  * @param out_error Address to store a pointer to the string explaining the error's cause.
  */
 RGL_API void rgl_get_last_error_string(const char** out_error_string);
@@ -452,6 +1242,76 @@ RGL_API rgl_status_t rgl_cleanup(void);
 RGL_API rgl_status_t rgl_mesh_create(rgl_mesh_t* out_mesh, const rgl_vec3f* vertices, int32_t vertex_count,
                                      const rgl_vec3i* indices, int32_t index_count);
 
+/**
+ * Creates multiple Meshes at once. It is equivalent to calling rgl_mesh_create for each Mesh,
+ * but significantly faster when loading many Meshes, since data is uploaded to the GPU in a single batch.
+ * Provided arrays are copied to the GPU before this function returns.
+ * @param out_meshes An array of mesh_count elements to store the resulting Mesh handles
+ * @param mesh_count Number of Meshes to create
+ * @param vertices An array of mesh_count pointers to vertex arrays (see rgl_mesh_create)
+ * @param vertex_counts An array of mesh_count numbers of elements in the respective vertex arrays
+ * @param indices An array of mesh_count pointers to index arrays (see rgl_mesh_create)
+ * @param index_counts An array of mesh_count numbers of elements in the respective index arrays
+ */
+RGL_API rgl_status_t rgl_mesh_create_batch(rgl_mesh_t* out_meshes, int32_t mesh_count, const rgl_vec3f* const* vertices,
+                                           const int32_t* vertex_counts, const rgl_vec3i* const* indices,
+                                           const int32_t* index_counts);
+
+/**
+ * Creates a Mesh like rgl_mesh_create, but returns without waiting for running graphs and for the upload of its data:
+ * the data are copied to the host memory and then uploaded (and GAS is built) on a background thread, in its own stream.
+ * Until the Mesh is ready (see rgl_mesh_is_ready), Entities using it may be created, but they are not visible to lidars;
+ * they become visible in the first graph run after that. Other operations on the Mesh wait for it to be ready.
+ * Meant for streaming the scene (e.g. tiles of a map) while graphs are running.
+ * @param out_mesh Address to store the resulting Mesh handle
+ * @param vertices An array of rgl_vec3f or binary-compatible data representing Mesh vertices
+ * @param vertex_count Number of elements in the vertices array
+ * @param indices An array of rgl_vec3i or binary-compatible data representing Mesh indices
+ * @param index_count Number of elements in the indices array
+ */
+RGL_API rgl_status_t rgl_mesh_create_async(rgl_mesh_t* out_mesh, const rgl_vec3f* vertices, int32_t vertex_count,
+                                           const rgl_vec3i* indices, int32_t index_count);
+
+/**
+ * Creates a Mesh of spheres, e.g. to represent particles or leaves of dense vegetation without tessellating them.
+ * Spheres are intersected by OptiX built-in programs, which takes much less memory and traversal time than their triangles.
+ * Vertices of such a Mesh are the centers of the spheres and can be updated with rgl_mesh_update_vertices.
+ * Texture coordinates, skinning and compression are not available for spheres. Requires OptiX 7.5 or newer.
+ * Provided arrays are copied to the GPU before this function returns.
+ * @param out_mesh Address to store the resulting Mesh handle
+ * @param centers An array of sphere_count centers of the spheres
+ * @param radii An array of sphere_count positive radii of the spheres
+ * @param sphere_count Number of spheres
+ */
+RGL_API rgl_status_t rgl_mesh_create_spheres(rgl_mesh_t* out_mesh, const rgl_vec3f* centers, const float* radii,
+                                             int32_t sphere_count);
+
+/**
+ * Creates a Mesh of round linear curves, e.g. to represent cables or grass blades without tessellating them.
+ * Each segment is a tube from vertex segment_indices[i] to vertex segment_indices[i] + 1, with radius interpolated
+ * linearly between radii of these vertices and rounded ends; a polyline of n vertices is described by n - 1 segments.
+ * Curves are intersected by OptiX built-in programs. Vertices can be updated with rgl_mesh_update_vertices.
+ * Texture coordinates, skinning and compression are not available for curves.
+ * Provided arrays are copied to the GPU before this function returns.
+ * @param out_mesh Address to store the resulting Mesh handle
+ * @param vertices An array of vertex_count control points of the curves
+ * @param radii An array of vertex_count positive radii of the curves at the respective vertices
+ * @param vertex_count Number of vertices
+ * @param segment_indices An array of segment_count indices of the first vertex of each segment
+ * @param segment_count Number of segments
+ */
+RGL_API rgl_status_t rgl_mesh_create_curves(rgl_mesh_t* out_mesh, const rgl_vec3f* vertices, const float* radii,
+                                            int32_t vertex_count, const int32_t* segment_indices, int32_t segment_count);
+
+/**
+ * Checks, without blocking, whether the data and GAS of the given Mesh are uploaded to the GPU.
+ * Meshes created with other functions than rgl_mesh_create_async are always ready.
+ * If the background upload has failed, its error is returned (and the Mesh never becomes ready).
+ * @param mesh Mesh to check
+ * @param out_ready Address to store the result
+ */
+RGL_API rgl_status_t rgl_mesh_is_ready(rgl_mesh_t mesh, bool* out_ready);
+
 /**
  * Assign texture coordinates to given Mesh. Pair of texture coordinates is assigned to each vertex.
  *
@@ -461,6 +1321,24 @@ RGL_API rgl_status_t rgl_mesh_create(rgl_mesh_t* out_mesh, const rgl_vec3f* vert
  */
 RGL_API rgl_status_t rgl_mesh_set_texture_coords(rgl_mesh_t mesh, const rgl_vec2f* uvs, int32_t uv_count);
 
+/**
+ * Makes parts of the given Mesh transparent to rays, as given by an alpha texture (e.g. alpha-tested leaves).
+ * Each triangle is split into 4^subdivision_level micro-triangles, which are opaque if the alpha sampled at their centers
+ * (at the Mesh texture coordinates, see rgl_mesh_set_texture_coords) is at least alpha_cutoff, and transparent otherwise.
+ * The result is stored as an opacity micromap, resolved by the hardware during traversal, so it costs little raytracing time.
+ * Higher subdivision levels follow the texture more closely, at the cost of memory (one bit per micro-triangle
+ * of each triangle that is neither fully opaque nor fully transparent).
+ * Texture coordinates must be set before; the Mesh must not be compressed. Requires OptiX 7.6 or newer.
+ * @param mesh Mesh to set the opacity of
+ * @param alpha_texels Alpha texture, width * height bytes in row-major order (as rgl_texture_create texels)
+ * @param width Width of the alpha texture
+ * @param height Height of the alpha texture
+ * @param alpha_cutoff Lowest alpha (normalized to [0, 1]) of opaque surface
+ * @param subdivision_level Level of subdivision of each triangle, in range [0, 12]
+ */
+RGL_API rgl_status_t rgl_mesh_set_opacity_micromap(rgl_mesh_t mesh, const void* alpha_texels, int32_t width, int32_t height,
+                                                   float alpha_cutoff, int32_t subdivision_level);
+
 /**
  * Informs that the given Mesh will be no longer used.
  * The Mesh will be destroyed after all referring Entities are destroyed.
@@ -478,6 +1356,78 @@ RGL_API rgl_status_t rgl_mesh_destroy(rgl_mesh_t mesh);
  */
 RGL_API rgl_status_t rgl_mesh_update_vertices(rgl_mesh_t mesh, const rgl_vec3f* vertices, int32_t vertex_count);
 
+/**
+ * Updates vertex data of multiple Meshes at once. It is equivalent to calling rgl_mesh_update_vertices for each Mesh,
+ * but data is uploaded to the GPU in a single batch. The number of vertices of each Mesh must not change.
+ * If validation of any Mesh fails, none of them is modified.
+ * @param meshes An array of mesh_count Meshes to modify
+ * @param mesh_count Number of Meshes to modify
+ * @param vertices An array of mesh_count pointers to vertex arrays (see rgl_mesh_update_vertices)
+ * @param vertex_counts An array of mesh_count numbers of elements in the respective vertex arrays
+ */
+RGL_API rgl_status_t rgl_mesh_update_vertices_batch(const rgl_mesh_t* meshes, int32_t mesh_count,
+                                                    const rgl_vec3f* const* vertices, const int32_t* vertex_counts);
+
+/**
+ * Makes the Mesh skinned: its current vertices become the bind pose, deformed on the GPU by transforms of bones
+ * (see rgl_mesh_update_bones), so that animated characters do not have to upload all their vertices every frame.
+ * Each vertex is influenced by up to four bones. Influences are uploaded once; skinned Mesh cannot be compressed.
+ * @param mesh Mesh to skin
+ * @param bone_indices An array of 4 * vertex_count indices of bones influencing consecutive vertices
+ * @param bone_weights An array of 4 * vertex_count non-negative weights of the respective bones; weights of each vertex
+ * must sum up to 1 and bones of zero weights are ignored
+ * @param vertex_count Number of vertices of the Mesh
+ * @param bone_count Number of bones; indices of bones must be less than it
+ */
+RGL_API rgl_status_t rgl_mesh_set_skinning(rgl_mesh_t mesh, const int32_t* bone_indices, const float* bone_weights,
+                                           int32_t vertex_count, int32_t bone_count);
+
+/**
+ * Updates vertices of a skinned Mesh (see rgl_mesh_set_skinning) by transforming its bind pose with the given bones:
+ * each vertex is the weighted sum of the bind-pose vertex transformed by its bones. Only the transforms are uploaded.
+ * Like rgl_mesh_update_vertices, provides the displacement of vertices used to compute velocities.
+ * @param mesh Skinned Mesh to update
+ * @param bone_transforms An array of bone_count transforms from the bind pose to the current pose of the bones
+ * @param bone_count Number of bones, equal to the one given in rgl_mesh_set_skinning
+ */
+RGL_API rgl_status_t rgl_mesh_update_bones(rgl_mesh_t mesh, const rgl_mat3x4f* bone_transforms, int32_t bone_count);
+
+/**
+ * Registers states of vertices of a looped animation (e.g. a walk cycle, a rotating fan or a wheel),
+ * so that they can be shown by rgl_mesh_set_keyframe instead of uploading vertices with rgl_mesh_update_vertices.
+ * An acceleration structure is built for each keyframe up front, so switching keyframes needs no GAS update;
+ * keyframes take as much GPU memory as that many Meshes. The Mesh switches to the first keyframe.
+ * Calling rgl_mesh_set_keyframes again replaces the keyframes. Compressed Meshes cannot have keyframes.
+ * @param mesh Mesh to modify
+ * @param vertices An array of rgl_vec3f with vertices of all keyframes, one keyframe after another
+ * @param vertex_count Number of elements in the vertices array: the vertex count of the Mesh times keyframe_count
+ * @param keyframe_count Number of keyframes
+ */
+RGL_API rgl_status_t rgl_mesh_set_keyframes(rgl_mesh_t mesh, const rgl_vec3f* vertices, int32_t vertex_count,
+                                            int32_t keyframe_count);
+
+/**
+ * Switches the Mesh to one of its keyframes (see rgl_mesh_set_keyframes). Vertices are copied on the GPU only.
+ * Like rgl_mesh_update_vertices, provides the displacement of vertices used to compute velocities;
+ * it should be called after rgl_scene_set_time. Other modifications of vertices (e.g. rgl_mesh_update_vertices)
+ * leave the keyframe, until rgl_mesh_set_keyframe is called again.
+ * @param mesh Mesh with keyframes
+ * @param keyframe_index Index of the keyframe, in the order given in rgl_mesh_set_keyframes
+ */
+RGL_API rgl_status_t rgl_mesh_set_keyframe(rgl_mesh_t mesh, int32_t keyframe_index);
+
+/**
+ * Reduces GPU memory used by the Mesh data read when computing hit attributes (e.g. normals, velocities).
+ * Indices are stored in 16 bits if the Mesh has at most 65536 vertices; vertices are stored in the given format.
+ * Ray intersections are unaffected, since the acceleration structure is built from the exact vertices beforehand.
+ * Hit points are computed from the compressed vertices, hence their precision depends on the format.
+ * Vertices of a compressed Mesh cannot be updated; compressing it again is an error.
+ * This function is intended for static Meshes, e.g. when loading a map.
+ * @param mesh Mesh to compress
+ * @param vertex_format Storage format of vertices
+ */
+RGL_API rgl_status_t rgl_mesh_compress(rgl_mesh_t mesh, rgl_vertex_format_t vertex_format);
+
 /**
  * Assigns value true to out_alive if the given mesh is known and has not been destroyed,
  * assigns value false otherwise.
@@ -497,6 +1447,19 @@ RGL_API rgl_status_t rgl_mesh_is_alive(rgl_mesh_t mesh, bool* out_alive);
  */
 RGL_API rgl_status_t rgl_entity_create(rgl_entity_t* out_entity, rgl_scene_t scene, rgl_mesh_t mesh);
 
+/**
+ * Creates count Entities sharing the same Mesh and adds them to the given Scene at once.
+ * This is equivalent to calling rgl_entity_create and rgl_entity_set_pose for each transform,
+ * but the Scene is updated only once, which matters when placing thousands of instances (e.g. vegetation).
+ * @param out_entities Array of count handles to be filled with the created Entities.
+ * @param scene Scene where the Entities will be added. Pass NULL to use the default Scene.
+ * @param mesh Handle to the Mesh shared by all created Entities.
+ * @param transforms Array of count transforms, one per created Entity.
+ * @param count Number of Entities to create.
+ */
+RGL_API rgl_status_t rgl_entity_create_instanced(rgl_entity_t* out_entities, rgl_scene_t scene, rgl_mesh_t mesh,
+                                                 const rgl_mat3x4f* transforms, int32_t count);
+
 /**
  * Removes an Entity from the Scene and releases its resources (memory).
  * This operation does not affect the Entity's Mesh since it can be shared among other Entities.
@@ -507,11 +1470,38 @@ RGL_API rgl_status_t rgl_entity_destroy(rgl_entity_t entity);
 /**
  * Changes transform (position, rotation, scaling) of the given Entity.
  * Should be called after rgl_scene_set_time to ensure proper velocity computation.
+ * Velocity is the displacement since the Entity's pose at the previous scene time, interpolated between the last few poses
+ * set; an Entity not posed in a frame is considered still since its last pose.
  * @param entity Entity to modify
  * @param transform Pointer to rgl_mat3x4f (or binary-compatible data) representing desired (Entity -> world) coordinate system transform.
  */
 RGL_API rgl_status_t rgl_entity_set_pose(rgl_entity_t entity, const rgl_mat3x4f* transform);
 
+/**
+ * Changes transforms of multiple Entities at once. It is equivalent to calling rgl_entity_set_pose for each Entity,
+ * but the call overhead is paid once, which matters when thousands of Entities move in each frame.
+ * Entities may belong to different Scenes. If validation of any Entity fails, none of them is modified.
+ * @param entities An array of entity_count Entities to modify
+ * @param entity_count Number of Entities to modify
+ * @param transforms An array of entity_count rgl_mat3x4f (or binary-compatible data), see rgl_entity_set_pose
+ */
+RGL_API rgl_status_t rgl_entity_set_pose_batch(const rgl_entity_t* entities, int32_t entity_count,
+                                               const rgl_mat3x4f* transforms);
+
+/**
+ * Changes transforms of multiple Entities from an array in device memory, e.g. computed by the client's CUDA kernels,
+ * without copying them to the host. Otherwise, it is equivalent to rgl_entity_set_pose_batch.
+ * The array is read after the given event is completed and may be reused by the client when this function returns.
+ * Velocities are computed from the transforms set in consecutive frames, as with rgl_entity_set_pose.
+ * All Entities must belong to the same Scene and must not be repeated.
+ * @param entities An array (in host memory) of entity_count Entities to modify
+ * @param entity_count Number of Entities to modify
+ * @param device_transforms An array (in device memory) of entity_count rgl_mat3x4f, see rgl_entity_set_pose
+ * @param ready_event CUDA event (cudaEvent_t) recorded after the transforms are written. It may be null if they are ready.
+ */
+RGL_API rgl_status_t rgl_entity_set_pose_batch_device(const rgl_entity_t* entities, int32_t entity_count,
+                                                      const rgl_mat3x4f* device_transforms, void* ready_event);
+
 /**
  * Set instance ID of the given Entity.
  * @param entity Entity to modify
@@ -519,6 +1509,24 @@ RGL_API rgl_status_t rgl_entity_set_pose(rgl_entity_t entity, const rgl_mat3x4f*
  */
 RGL_API rgl_status_t rgl_entity_set_id(rgl_entity_t entity, int32_t id);
 
+/**
+ * Set semantic class ID of the given Entity, reported in RGL_FIELD_CLASS_ID_U16 of points hitting it.
+ * Unlike the instance ID, many Entities may share the same class ID.
+ * @param entity Entity to modify
+ * @param class_id Class ID to set, in range [0, 65535]. If not set, RGL_DEFAULT_CLASS_ID is used.
+ */
+RGL_API rgl_status_t rgl_entity_set_class_id(rgl_entity_t entity, int32_t class_id);
+
+/**
+ * Set constant intensity of the given Entity, reported in RGL_FIELD_INTENSITY_F32 of points hitting it,
+ * e.g. reflectivity of its material. It is cheaper than an intensity texture of a single texel: no texture coordinates
+ * are needed and no texture is sampled. If the Entity has an intensity texture (and its Mesh texture coordinates),
+ * the texture is used instead.
+ * @param entity Entity to modify
+ * @param intensity Intensity to set, non-negative. If not set, the intensity of untextured Entities is zero.
+ */
+RGL_API rgl_status_t rgl_entity_set_intensity(rgl_entity_t entity, float intensity);
+
 /**
  * Assign intensity texture to the given Entity. The assumption is that the Entity can hold only one intensity texture.
  * @param entity Entity to modify.
@@ -526,6 +1534,37 @@ RGL_API rgl_status_t rgl_entity_set_id(rgl_entity_t entity, int32_t id);
  */
 RGL_API rgl_status_t rgl_entity_set_intensity_texture(rgl_entity_t entity, rgl_texture_t texture);
 
+/**
+ * Registers a level-of-detail Mesh of the given Entity, used in place of the Entity's Mesh when the Entity is at least
+ * min_distance away from the LOD origin of its Scene (see rgl_scene_set_lod_origin), until a farther LOD applies.
+ * Coarser meshes of distant Entities make traversal faster and reduce GPU memory bandwidth,
+ * at the cost of hit points (and their attributes) being computed from the coarser geometry.
+ * The LOD is selected when the Scene is prepared for raytracing, i.e. in rgl_graph_run, from the pose of the Entity's origin.
+ * @param entity Entity to modify
+ * @param mesh Mesh to use at the given distance. Pass NULL to remove the LOD registered with the given min_distance.
+ * @param min_distance Minimal distance (in meters) of using the Mesh. Must be positive.
+ */
+RGL_API rgl_status_t rgl_entity_set_lod_mesh(rgl_entity_t entity, rgl_mesh_t mesh, float min_distance);
+
+/**
+ * Assigns the given Entity to layers (e.g. vegetation, radar-only reflectors), each bit of the mask being one of 8 layers.
+ * The Entity is visible to a RaytraceNode only if their masks share a layer (see rgl_node_raytrace_configure_visibility_mask).
+ * Invisible Entities are culled during traversal, so it is cheaper than filtering hits or keeping separate Scenes.
+ * @param entity Entity to modify
+ * @param mask Visibility mask in range [0, 255]. Default is RGL_DEFAULT_VISIBILITY_MASK. Zero hides the Entity entirely.
+ */
+RGL_API rgl_status_t rgl_entity_set_visibility_mask(rgl_entity_t entity, int32_t mask);
+
+/**
+ * Marks the given Entity as static (e.g. map geometry) or dynamic (default), which is a hint for building the Scene's AS.
+ * Static Entities are kept in a separate, compacted IAS rebuilt only when any of them changes (e.g. its pose is set),
+ * so that per-frame AS updates scale with the number of dynamic Entities only. Changing the hint rebuilds the AS.
+ * Entities posed from device memory (see rgl_entity_set_pose_batch_device) are always treated as dynamic.
+ * @param entity Entity to modify
+ * @param is_static True if the Entity is not expected to change.
+ */
+RGL_API rgl_status_t rgl_entity_set_static(rgl_entity_t entity, bool is_static);
+
 /**
  * Assigns value true to out_alive if the given entity is known and has not been destroyed,
  * assigns value false otherwise.
@@ -546,6 +1585,22 @@ RGL_API rgl_status_t rgl_entity_is_alive(rgl_entity_t entity, bool* out_alive);
  */
 RGL_API rgl_status_t rgl_texture_create(rgl_texture_t* out_texture, const void* texels, int32_t width, int32_t height);
 
+/**
+ * Creates a Texture (see rgl_texture_create) with a chain of mip levels, optionally stored compressed.
+ * Levels are generated from the given texels by halving their resolution.
+ * A level is sampled according to the beam footprint on the hit surface, which is derived from the beam divergence
+ * of the RaytraceNode (see rgl_node_raytrace_configure_beam_divergence); without divergence, the full resolution is sampled.
+ * @param out_texture Handle to the created Texture.
+ * @param texels Pointer to the full-resolution texture data, as in rgl_texture_create.
+ * @param width Width of the texture. Has to be positive.
+ * @param height Height of the texture. Has to be positive.
+ * @param mip_level_count Requested number of levels, including the full-resolution one. Has to be positive.
+ * The chain ends earlier if the resolution cannot be halved further (in the given format).
+ * @param format Storage format of all levels.
+ */
+RGL_API rgl_status_t rgl_texture_create_mipmapped(rgl_texture_t* out_texture, const void* texels, int32_t width,
+                                                  int32_t height, int32_t mip_level_count, rgl_texture_format_t format);
+
 /**
  * Informs that the given texture will be no longer used.
  * The texture will be destroyed after all referring Entities are destroyed.
@@ -563,6 +1618,36 @@ RGL_API rgl_status_t rgl_texture_is_alive(rgl_texture_t texture, bool* out_alive
 
 /******************************** SCENE ********************************/
 
+/**
+ * Creates a Scene, independent of the default one and other created Scenes.
+ * Each Scene has its own Entities, time and configuration; Meshes and Textures may be shared among Scenes.
+ * Graphs raytracing different Scenes do not wait for each other when one of the Scenes is modified.
+ * @param out_scene Handle to the created Scene.
+ */
+RGL_API rgl_status_t rgl_scene_create(rgl_scene_t* out_scene);
+
+/**
+ * Destroys the Scene along with all its Entities. Meshes and Textures used by the Entities are not affected.
+ * The default Scene cannot be destroyed. Raytrace nodes still using the Scene will see it empty.
+ * @param scene Scene to be destroyed.
+ */
+RGL_API rgl_status_t rgl_scene_destroy(rgl_scene_t scene);
+
+/**
+ * Creates a Scene with copies of all Entities of the given one (including poses of their last two updates, used for
+ * velocity) and its time and configuration, e.g. to run variations of a scenario from a common prefix concurrently.
+ * Copies use the same Meshes and Textures, so forking uploads nothing and GASes are shared; Meshes (e.g. their vertices)
+ * are not copied, so modifying a Mesh affects all Scenes. A Scene which is never raytraced may serve as a checkpoint,
+ * to be forked again for each following variation.
+ * @param out_scene Handle to the created Scene.
+ * @param scene Scene to be forked. Pass NULL to use the default Scene.
+ * @param entities Entities of the forked Scene whose copies are to be returned; copies of others are not accessible.
+ * @param entity_count Number of elements in entities.
+ * @param out_entities Address to store handles of copies of entities (in the same order), may be NULL if entity_count is 0.
+ */
+RGL_API rgl_status_t rgl_scene_fork(rgl_scene_t* out_scene, rgl_scene_t scene, const rgl_entity_t* entities,
+                                    int32_t entity_count, rgl_entity_t* out_entities);
+
 /**
  * Sets time for the given Scene.
  * Time indicates a specific point when the ray trace is performed in the simulation timeline.
@@ -573,6 +1658,55 @@ RGL_API rgl_status_t rgl_texture_is_alive(rgl_texture_t texture, bool* out_alive
  */
 RGL_API rgl_status_t rgl_scene_set_time(rgl_scene_t scene, uint64_t nanoseconds);
 
+/**
+ * Configures compaction of meshes' acceleration structures (GAS) in the given Scene.
+ * Compaction reduces GPU memory usage (typically ~10%), but it is costly, so it is disabled by default.
+ * When enabled, GAS of a mesh is compacted asynchronously (in background) after it remained unchanged
+ * for the given number of frames, where a frame is marked by calling rgl_scene_set_time.
+ * Compaction applies to meshes which GAS is built after this call, so it should be called before loading the scene.
+ * @param scene Scene to configure. Pass NULL to use the default Scene.
+ * @param enable If true, GAS compaction will be enabled.
+ * @param static_frame_count Number of frames a mesh has to remain unchanged before it is compacted. Must be non-negative.
+ */
+RGL_API rgl_status_t rgl_scene_configure_gas_compaction(rgl_scene_t scene, bool enable, int32_t static_frame_count);
+
+/**
+ * Configures batching of raytracing in the given Scene.
+ * When enabled, rays of all raytrace nodes in a graph are traced in a single launch, which reduces launch overhead
+ * and improves GPU utilization for sensors with a low number of rays (e.g. multiple lidars sharing a ray pattern).
+ * Results are the same, but raytrace nodes are executed together, i.e. before any node depending on their results.
+ * Batching does not apply to raytrace nodes in separate graphs. It is disabled by default.
+ * @param scene Scene to configure. Pass NULL to use the default Scene.
+ * @param enable If true, raytrace batching will be enabled.
+ */
+RGL_API rgl_status_t rgl_scene_configure_raytrace_batching(rgl_scene_t scene, bool enable);
+
+/**
+ * Sets the point (typically, the position of the vehicle carrying sensors) distances to Entities are measured from
+ * to select their level-of-detail meshes (see rgl_entity_set_lod_mesh). It should be updated when the sensors move.
+ * Until it is set, Entities use their base meshes.
+ * @param scene Scene to configure. Pass NULL to use the default Scene.
+ * @param origin Pointer to the position in world coordinates.
+ */
+RGL_API rgl_status_t rgl_scene_set_lod_origin(rgl_scene_t scene, const rgl_vec3f* origin);
+
+/**
+ * Traces the given rays in the current state of the Scene and reports the closest hit of each ray,
+ * without building a graph. Meant for many (e.g. thousands per frame) generic queries, such as line-of-sight checks
+ * or snapping objects to the ground, reusing the acceleration structure built for sensors.
+ * Rays are traced in a single launch; the call returns when hits are written.
+ * Arrays may be in host or device memory (e.g. written by the client's kernels), each independently.
+ * Raytracing settings of sensors (e.g. visibility masks, non-hit distances, noise) do not apply.
+ * @param scene Scene to raytrace. Pass NULL to use the default Scene.
+ * @param origins Array of ray origins in world coordinates.
+ * @param directions Array of ray directions in world coordinates, need not be normalized.
+ * @param ray_count Number of rays, i.e. elements of each array.
+ * @param max_distance Rays do not hit surfaces further than this distance.
+ * @param out_hits Array to write the closest hit of each ray to.
+ */
+RGL_API rgl_status_t rgl_scene_raycast_batch(rgl_scene_t scene, const rgl_vec3f* origins, const rgl_vec3f* directions,
+                                             int32_t ray_count, float max_distance, rgl_raycast_hit_t* out_hits);
+
 /******************************** NODES ********************************/
 
 /**
@@ -587,6 +1721,43 @@ RGL_API rgl_status_t rgl_scene_set_time(rgl_scene_t scene, uint64_t nanoseconds)
  */
 RGL_API rgl_status_t rgl_node_rays_from_mat3x4f(rgl_node_t* node, const rgl_mat3x4f* rays, int32_t ray_count);
 
+/**
+ * Creates or modifies FromDirectionsRaysNode.
+ * The Node provides initial rays given by their directions only, all starting at the origin of the device-local frame.
+ * It is a compact alternative to rgl_node_rays_from_mat3x4f (3 instead of 12 floats per ray).
+ * Such rays are transformed by TransformRaysNode without per-ray work and are natively supported by RaytraceNode
+ * and GaussianNoiseAngularRaysNode, however, RaytraceNode cannot output RGL_FIELD_RAY_POSE_MAT3x4_F32 for them.
+ * A ray of the given direction is oriented as in rgl_node_rays_from_pattern.
+ * Input: none
+ * Output: rays
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param directions Pointer to ray directions (not necessarily normalized).
+ * @param ray_count Size of the `directions` array
+ */
+RGL_API rgl_status_t rgl_node_rays_from_directions(rgl_node_t* node, const rgl_vec3f* directions, int32_t ray_count);
+
+/**
+ * Creates or modifies FromPatternRaysNode.
+ * The Node generates rays of a spinning lidar on the GPU from a compact description of its firing pattern,
+ * instead of uploading a matrix per ray. Rays form a (azimuth_step_count x ring_count) layout (see rgl_node_rays_set_layout),
+ * a ray of azimuth a and elevation e points in (sin(a) * cos(e), sin(e), cos(a) * cos(e)) direction (Z forward, Y up),
+ * ring ids are ring indices, and the time offset of a ray is `azimuth_idx * azimuth_step_time + ring_time_offsets[ring_idx]`.
+ * Rays are regenerated only when the Node is modified.
+ * Input: none
+ * Output: rays
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param ring_elevations Pointer to elevations of rings in radians.
+ * @param ring_time_offsets Pointer to firing time offsets of rings within an azimuth step in milliseconds.
+ * @param ring_count Size of the `ring_elevations` and `ring_time_offsets` arrays.
+ * @param azimuth_start Azimuth of the first step in radians.
+ * @param azimuth_step Azimuth increment between consecutive steps in radians.
+ * @param azimuth_step_count Number of azimuth steps.
+ * @param azimuth_step_time Time between consecutive azimuth steps in milliseconds.
+ */
+RGL_API rgl_status_t rgl_node_rays_from_pattern(rgl_node_t* node, const float* ring_elevations, const float* ring_time_offsets,
+                                                int32_t ring_count, float azimuth_start, float azimuth_step,
+                                                int32_t azimuth_step_count, float azimuth_step_time);
+
 /**
  * Creates or modifies SetRingIdsRaysNode.
  * The Node assigns ring ids for existing rays.
@@ -612,6 +1783,19 @@ RGL_API rgl_status_t rgl_node_rays_set_ring_ids(rgl_node_t* node, const int32_t*
  */
 RGL_API rgl_status_t rgl_node_rays_set_range(rgl_node_t* node, const rgl_vec2f* ranges, int32_t ranges_count);
 
+/**
+ * Creates or modifies SetLayoutRaysNode.
+ * The node declares that existing rays form a 2D grid of width x height rays, stored in row-major order
+ * (e.g. width = azimuth steps, height = rings for spinning lidars).
+ * Rays are then raytraced in a 2D launch (improving ray coherence) and the raytrace node outputs an organized point cloud.
+ * Input: rays
+ * Output: rays
+ * @param node If (*node) == nullptr, a new node will be created. Otherwise, (*node) will be modified.
+ * @param width Number of rays in a single row. Must be positive.
+ * @param height Number of rows. Must be positive. Width * height must be equal to the number of rays.
+ */
+RGL_API rgl_status_t rgl_node_rays_set_layout(rgl_node_t* node, int32_t width, int32_t height);
+
 /**
  * Creates or modifies SetTimeOffsetsRaysNode.
  * The node assigns time offsets for existing rays.
@@ -646,10 +1830,10 @@ RGL_API rgl_status_t rgl_node_rays_transform(rgl_node_t* node, const rgl_mat3x4f
  */
 RGL_API rgl_status_t rgl_node_points_transform(rgl_node_t* node, const rgl_mat3x4f* transform);
 
-// TODO: remove scene parameter here and in other API calls
 /**
  * Creates or modifies RaytraceNode.
  * The Node performs GPU-accelerated raytracing on the given Scene.
+ * All RaytraceNodes in a graph have to use the same Scene.
  * Fields to be computed will be automatically determined based on connected FormatNodes and YieldPointsNodes
  * Graph input: rays
  * Graph output: point cloud (sparse)
@@ -695,6 +1879,199 @@ RGL_API rgl_status_t rgl_node_raytrace_configure_distortion(rgl_node_t node, boo
  */
 RGL_API rgl_status_t rgl_node_raytrace_configure_non_hits(rgl_node_t node, float nearDistance, float farDistance);
 
+/**
+ * Modifies RaytraceNode to report multiple returns per ray.
+ * Intersections along the ray are collected in a single launch (up to a fixed number of surfaces per ray),
+ * and the ones selected by `return_mode` are written to the output; RGL_FIELD_RETURN_TYPE_U8 tells which return a point is.
+ * In dual modes, the output contains two points per ray: all first-listed returns (FIRST or STRONGEST) followed by all LAST returns.
+ * If the ray hits only one surface, both points describe the same hit.
+ * Default mode is RGL_RETURN_MODE_FIRST. Field RGL_FIELD_RAY_POSE_MAT3x4_F32 gives the pose of the ray of each point.
+ * @param node RaytraceNode to modify.
+ * @param return_mode Return mode to use.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_return_mode(rgl_node_t node, rgl_return_mode_t return_mode);
+
+/**
+ * Modifies RaytraceNode to model beam divergence.
+ * Each ray is traced as `sample_count` sub-rays spread over a cone of the given divergence angle
+ * (the first one is the central ray), whose results are reduced on the GPU to a single point per ray, as selected by `reduction`.
+ * Hence, the output has as many points as without divergence.
+ * Beam divergence is available in RGL_RETURN_MODE_FIRST return mode only.
+ * @param node RaytraceNode to modify.
+ * @param divergence_angle Full apex angle of the beam cone in radians. Zero disables the feature.
+ * @param sample_count Number of sub-rays per ray. One disables the feature.
+ * @param reduction Method of reducing sub-ray results.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_beam_divergence(rgl_node_t node, float divergence_angle, int32_t sample_count,
+                                                                 rgl_beam_reduction_t reduction);
+
+/**
+ * Modifies RaytraceNode to apply Gaussian noise while raytracing, without separate noise nodes and intermediate buffers.
+ * Angular noise rotates each ray around `angular_axis` of the ray origin frame before tracing (as GaussianNoiseAngularRaysNode).
+ * Distance noise moves each hit point along the ray (as GaussianNoiseDistanceNode); non-hits are not affected.
+ * Noise is drawn independently per ray, hit and run. All-zero parameters disable the feature (default).
+ * @param node RaytraceNode to modify.
+ * @param angular_mean Angular noise mean in radians.
+ * @param angular_st_dev Angular noise standard deviation in radians.
+ * @param angular_axis Axis on which angular noise will be performed.
+ * @param distance_mean Distance noise mean in meters.
+ * @param distance_st_dev_base Distance noise standard deviation base in meters.
+ * @param distance_st_dev_rise_per_meter Distance noise standard deviation rise per meter.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_noise(rgl_node_t node, float angular_mean, float angular_st_dev,
+                                                       rgl_axis_t angular_axis, float distance_mean, float distance_st_dev_base,
+                                                       float distance_st_dev_rise_per_meter);
+
+/**
+ * Modifies RaytraceNode to model weather (snow, rain or fog) as a homogeneous medium of particles along the rays,
+ * without adding any geometry to the scene.
+ * Each ray meets a particle at a random distance, drawn from the exponential distribution with rate `extinction_coefficient`.
+ * If the particle is closer than the surface hit (and not closer than the minimum range), the ray ends there:
+ * the particle is reported as a hit with `particle_intensity`, RGL_ENTITY_INVALID_ID, zero absolute velocity
+ * and normal facing the sensor. In multi-return modes, the particle is the last hit of the ray.
+ * Intensity of surface hits is attenuated by exp(-2 * extinction_coefficient * distance).
+ * Particles are drawn independently per ray and run, from the same seed as the noise (see rgl_node_raytrace_configure_noise).
+ * @param node RaytraceNode to modify.
+ * @param extinction_coefficient Extinction coefficient of the medium in 1/meters (roughly 3.9 / visibility in meters).
+ *                               Zero disables the feature (default).
+ * @param particle_intensity Intensity reported for particle hits.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_weather(rgl_node_t node, float extinction_coefficient,
+                                                         float particle_intensity);
+
+/**
+ * Modifies RaytraceNode to model multipath propagation (e.g. of radar waves), tracing reflections in the same launch.
+ * After hitting a surface, the ray is reflected specularly up to `bounce_count` times; the surface met by each bounce
+ * is reported as the next return (RGL_RETURN_TYPE_MULTIPATH), as if the echo came back along the same path:
+ * at the distance equal to the length of the whole path, along the original ray (ghost target), with intensity
+ * of the surface attenuated by `reflectivity` per reflection (and by the weather along the path, if configured).
+ * Normals, incident angles and velocities are of the surface met. The output contains 1 + `bounce_count` points per ray:
+ * first returns of all rays, followed by the returns of each bounce; returns of bounces that missed are non-hits.
+ * Bounces end at the maximum range, counted along the path; they do not meet weather particles.
+ * Multipath is available in RGL_RETURN_MODE_FIRST return mode only, without dense output.
+ * @param node RaytraceNode to modify.
+ * @param bounce_count Number of reflections traced per ray, up to 3. Zero disables the feature (default).
+ * @param reflectivity Fraction of intensity kept by each reflection, in range (0, 1].
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_multipath(rgl_node_t node, int32_t bounce_count, float reflectivity);
+
+/**
+ * Modifies RaytraceNode to trace only Entities sharing at least one layer with the given mask,
+ * see rgl_entity_set_visibility_mask. Weather particles are not Entities and are not affected.
+ * @param node RaytraceNode to modify.
+ * @param mask Visibility mask in range [1, 255]. Default is RGL_DEFAULT_VISIBILITY_MASK.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_visibility_mask(rgl_node_t node, int32_t mask);
+
+/**
+ * Modifies RaytraceNode to trace only Entities within the given range from the origin of its rays,
+ * which is useful for sensors with a range much smaller than the Scene (e.g. radars in a large map).
+ * Entities are culled by their bounding spheres in a GPU kernel, which hides the other ones in a copy of the Scene's IAS.
+ * The copy is reused while the Scene's IAS is unchanged and the origin moved less than movement_threshold,
+ * so the range is extended by the threshold. Entities posed from device memory are never culled.
+ * Rays longer than the range may miss culled Entities, so it should not be smaller than the maximum range of rays.
+ * @param node RaytraceNode to modify.
+ * @param range Culling range in meters. Zero disables culling (default).
+ * @param movement_threshold Distance in meters the origin may move without culling again. Must be non-negative.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_culling(rgl_node_t node, float range, float movement_threshold);
+
+/**
+ * Modifies RaytraceNode to trace incrementally, which is useful for static sensors in mostly static Scenes.
+ * Results of the previous run are kept for rays that did not change and which segments miss the bounding spheres
+ * (both former and current) of Entities changed since then; only the remaining rays are traced, patching the output.
+ * Incremental tracing applies only if the node's configuration and fields are the same as in the previous run,
+ * no mesh of the Scene was updated (vertices) and results are deterministic, i.e. without noise, weather, velocity
+ * distortion and the TIME_STAMP_F64 field; rays traced in a batch with other nodes are always traced in full.
+ * Otherwise, all rays are traced (and the next run may be incremental again).
+ * @param node RaytraceNode to modify.
+ * @param enable If true, incremental tracing is enabled. Disabled by default.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_incremental(rgl_node_t node, bool enable);
+
+/**
+ * Modifies RaytraceNode to trace rays in the order of their directions (Morton codes of octahedral-mapped directions),
+ * which improves coherence of GPU threads for scattered patterns (e.g. rosettes of MEMS lidars or random sampling).
+ * Output is in the order of rays anyway. Rays are sorted in each run, so it is not worth enabling for regular patterns.
+ * @param node RaytraceNode to modify.
+ * @param enable If true, rays are sorted before tracing. Disabled by default.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_ray_sorting(rgl_node_t node, bool enable);
+
+/**
+ * Modifies RaytraceNode to trace rays in slices of a sweep (e.g. of a spinning lidar), matching poses of moving Entities
+ * to firing times of rays without running the graph for each slice. Rays are split by their time offsets
+ * (see rgl_node_rays_set_time_offsets) into slices of equal ray counts; each slice is traced in a copy of the Scene's IAS
+ * with Entities moved to the time of the slice, extrapolating their motion since the previous frame (see rgl_scene_set_time).
+ * Copies are refitted alternately in two buffers, so that preparing the next slice overlaps tracing the current one.
+ * Slicing does not apply with motion blur enabled (rgl_configure_motion_blur traces each ray at its own time),
+ * without time offsets, or before the second frame; then rays are traced at once.
+ * Culling and incremental tracing do not apply to sliced traces; graphs with sliced nodes are not traced in a batch
+ * (see rgl_scene_configure_raytrace_batching).
+ * @param node RaytraceNode to modify.
+ * @param slice_count Number of slices, 1 disables slicing (default).
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_time_slicing(rgl_node_t node, int32_t slice_count);
+
+/**
+ * Modifies RaytraceNode to trace rays in chunks of columns of the ray layout (e.g. azimuth ranges of a spinning lidar),
+ * each signalled by its own CUDA event, so that consumers may read outputs of a chunk before the whole sweep is traced,
+ * see rgl_graph_get_result_chunk. Without a layout (rgl_node_rays_set_layout), chunks are ranges of consecutive rays.
+ * Columns are split into chunks of (nearly) equal sizes; there are at most as many chunks as columns.
+ * Downstream nodes run once all chunks are traced, as without streaming.
+ * Streaming is not supported with dense output, ray sorting or time slicing; graphs with streamed nodes are not traced
+ * in a batch (see rgl_scene_configure_raytrace_batching).
+ * @param node RaytraceNode to modify.
+ * @param chunk_count Number of chunks, 1 disables streaming (default).
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_streaming(rgl_node_t node, int32_t chunk_count);
+
+/**
+ * Modifies RaytraceNode to skip rays that keep missing the Scene (e.g. towards the sky), saving the tracing budget
+ * for the rest of the field of view. Rays that missed in the given number of consecutive runs are reported as non-hits
+ * (see rgl_node_raytrace_configure_non_hits) without tracing; each of them is still traced once every probe period runs
+ * (in runs staggered between rays), so that it is traced again every run once it hits a surface.
+ * The output layout is the same as without skipping. Skipped rays report no weather particles and no hits below
+ * the minimum range. Counters of misses are reset when the number of rays changes or the node is reconfigured.
+ * @param node RaytraceNode to modify.
+ * @param miss_frame_count Number of consecutive runs with the ray missing, after which it is skipped, up to 255.
+ * 0 disables skipping (default).
+ * @param probe_period Number of runs between traces of a skipped ray.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_ray_skipping(rgl_node_t node, int32_t miss_frame_count,
+                                                              int32_t probe_period);
+
+/**
+ * Modifies RaytraceNode to output only hits, packed into a dense point cloud (of height 1) in unspecified order,
+ * instead of a point per ray. Saves memory and the compaction step; RAY_IDX_U32 field identifies the ray of each point.
+ * Supported only in RGL_RETURN_MODE_FIRST and without RAY_POSE_MAT3x4_F32 field; otherwise, the graph run fails.
+ * @param node RaytraceNode to modify.
+ * @param enable If true, only hits are output. Disabled by default.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_dense_output(rgl_node_t node, bool enable);
+
+/**
+ * Modifies RaytraceNode to write points already formatted, when its only child is a FormatPointsNode
+ * of fields computed during tracing (all except RAY_POSE_MAT3x4_F32) and nodes below need only RGL_FIELD_DYNAMIC_FORMAT.
+ * Avoids writing the fields separately and the formatting pass; otherwise, the fields are formatted as usual.
+ * When fused, fields of the point cloud are available only formatted (results of single fields are unspecified).
+ * @param node RaytraceNode to modify.
+ * @param enable If true, formatting is fused into raytracing when possible. Disabled by default.
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_fused_format(rgl_node_t node, bool enable);
+
+/**
+ * Modifies RaytraceNode to write XYZ, normals (including their half-precision variants) and absolute velocities of points
+ * in the given frame, instead of the world frame. Avoids transforming the point cloud by TransformPointsNode
+ * (e.g. back to the sensor frame).
+ * The sensor frame follows the rays in each run. Other fields (e.g. relative velocities, XYZ_VEC3_I16) are not affected.
+ * @param node RaytraceNode to modify.
+ * @param frame Frame of the output, RGL_OUTPUT_FRAME_WORLD by default.
+ * @param transform Transform from the `frame` to the output frame, applied after it (identity to output in the `frame`).
+ */
+RGL_API rgl_status_t rgl_node_raytrace_configure_output_frame(rgl_node_t node, rgl_output_frame_t frame,
+                                                              const rgl_mat3x4f* transform);
+
 /**
  * Creates or modifies FormatPointsNode.
  * The Node converts internal representation into a binary format defined by the `fields` array.
@@ -718,6 +2095,55 @@ RGL_API rgl_status_t rgl_node_points_format(rgl_node_t* node, const rgl_field_t*
  */
 RGL_API rgl_status_t rgl_node_points_yield(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count);
 
+/**
+ * Creates or modifies ShmPublishPointsNode.
+ * The Node writes formatted point clouds into a ring of slots in a POSIX shared memory object,
+ * so that processes on the same host may read them without serialization (layout: see `rgl_shm_ring_header_t`).
+ * Optionally, each slot's data is also copied to a device buffer exported with CUDA IPC,
+ * giving CUDA-IPC-capable readers zero-copy access on the GPU.
+ * Writing never waits for readers: a slot is overwritten after `slot_count` frames, readers detect it by the slot's sequence.
+ * The Node owns the shared memory object: it is created (replacing an existing one) by the Node and unlinked on destruction.
+ * The Node is not available on Windows.
+ * Graph input: point cloud (formatted, see `rgl_node_points_format`)
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param shm_name Name of the shared memory object (see shm_open), e.g. "/rgl_lidar_top".
+ * @param slot_count Number of slots in the ring, the number of frames readers may lag behind.
+ * @param slot_data_size Capacity (in bytes) of each slot's point data; graph run fails if a point cloud does not fit.
+ * @param export_device_buffers If true, point data is also copied to device buffers exported with CUDA IPC.
+ */
+RGL_API rgl_status_t rgl_node_points_shm_publish(rgl_node_t* node, const char* shm_name, int32_t slot_count,
+                                                 int64_t slot_data_size, bool export_device_buffers);
+
+/**
+ * Creates or modifies WritePointsFileNode.
+ * The Node writes the formatted point cloud of each run to a separate file, named `<path_prefix><frame id>.<extension>`,
+ * where the frame id (see `rgl_graph_get_result_frame_id`) is zero-padded to 6 digits.
+ * Point data is copied to one of two page-locked staging buffers and written by a background thread,
+ * so that graph runs wait only if both buffers are still being written. Files are complete once the Node is destroyed.
+ * Errors of writing are reported by the next run of the Node.
+ * Graph input: point cloud (formatted, see `rgl_node_points_format`; RGL_FIELD_XYZ_VEC3_F32 is required for LAS)
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param path_prefix Prefix of paths of the files, e.g. "/data/run_1/lidar_". Directories must exist.
+ * @param format Format of the files.
+ */
+RGL_API rgl_status_t rgl_node_points_write_file(rgl_node_t* node, const char* path_prefix, rgl_point_file_format_t format);
+
+/**
+ * Creates or modifies CompressPointsNode.
+ * The Node encodes RGL_FIELD_XYZ_VEC3_F32 of points, in their order (e.g. the firing order of the lidar),
+ * into a compact byte stream of quantized deltas, see `rgl_compressed_points_header_t` for its layout.
+ * Compression is best for neighboring points close to each other, i.e. compacted hits in the firing order.
+ * Quantized coordinates are clamped to +-(2^30 - 1) steps, non-finite coordinates (e.g. of non-hits) are not representable.
+ * The stream is yielded in RGL_FIELD_DYNAMIC_FORMAT (one byte per element); the Node's point cloud is the stream.
+ * Graph input: point cloud
+ * Graph output: point cloud (compressed stream)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param xyz_step Quantization step of coordinates, e.g. 0.001 for millimeters. Has to be positive.
+ */
+RGL_API rgl_status_t rgl_node_points_compress(rgl_node_t* node, float xyz_step);
+
 /**
  * Creates or modifies CompactPointsNode.
  * The Node removes non-hit points. In other words, it converts a point cloud into a dense one.
@@ -733,6 +2159,7 @@ rgl_node_points_compact(rgl_node_t* node);
  * The Node removes points if the given field is set to a non-zero value.
  * Currently supported fields are RGL_FIELD_IS_HIT_I32 and RGL_FIELD_IS_GROUND_I32.
  * In other words, it converts a point cloud into a dense one.
+ * It is a shorthand for `rgl_node_points_compact_by_predicates` with the single predicate `field != 0`.
  * Graph input: point cloud
  * Graph output: point cloud (compacted)
  * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
@@ -740,6 +2167,96 @@ rgl_node_points_compact(rgl_node_t* node);
  */
 RGL_API rgl_status_t rgl_node_points_compact_by_field(rgl_node_t* node, rgl_field_t field);
 
+/**
+ * Creates or modifies CompactByFieldPointsNode, keeping only points satisfying the given predicates.
+ * Predicates may refer to any scalar fields (i.e. not vectors nor matrices) and are evaluated during stream compaction,
+ * so that compacting by several conditions takes a single pass, as opposed to chaining several Nodes.
+ * Graph input: point cloud
+ * Graph output: point cloud (compacted)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param predicates Pointer to the array of predicates, see `rgl_field_predicate_t`.
+ * @param predicate_count Number of elements in the `predicates` array. Has to be positive.
+ * @param match_any If true, points satisfying any of the predicates are kept. Otherwise, points have to satisfy all of them.
+ */
+RGL_API rgl_status_t rgl_node_points_compact_by_predicates(rgl_node_t* node, const rgl_field_predicate_t* predicates,
+                                                           int32_t predicate_count, bool match_any);
+
+/**
+ * Creates or modifies CompactByRegionPointsNode.
+ * The Node keeps only points satisfying all the given regions, i.e. being inside every region
+ * which is not excluded and outside every excluded one (see `rgl_region_t`).
+ * Regions are evaluated on XYZ_VEC3_F32 of the input, therefore they are expressed in its coordinate frame;
+ * use `rgl_node_points_transform` beforehand to crop in another frame.
+ * Regions are evaluated during stream compaction, so that cropping takes a single pass over points.
+ * Graph input: point cloud
+ * Graph output: point cloud (compacted)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param regions Pointer to the array of regions. May be NULL if `region_count` is zero (all points are kept).
+ * @param region_count Number of elements in the `regions` array. Has to be non-negative.
+ */
+RGL_API rgl_status_t rgl_node_points_compact_by_region(rgl_node_t* node, const rgl_region_t* regions,
+                                                       int32_t region_count);
+
+/**
+ * Creates or modifies RangeImagePointsNode.
+ * The Node projects hit points onto a dense range image of `height` rows and `width` columns.
+ * The row of a point is its RGL_FIELD_RING_ID_U16; the column is given by its RGL_FIELD_AZIMUTH_F32
+ * linearly mapped from [azimuth_min, azimuth_max) onto [0, width). Points outside the image are skipped.
+ * If several points fall into the same pixel, the nearest one is kept.
+ * Output point cloud is non-dense and has `height` x `width` points in row-major order, with fields:
+ * - RGL_FIELD_IS_HIT_I32 telling whether any point fell into the pixel,
+ * - RGL_FIELD_DISTANCE_F32, and RGL_FIELD_INTENSITY_F32 and RGL_FIELD_ENTITY_ID_I32 if present in the input.
+ * Channels of empty pixels are zero (RGL_ENTITY_INVALID_ID for entity ids).
+ * The image stays in device memory, see `rgl_graph_get_result_device_ptr` to pass it to other CUDA consumers.
+ * Graph input: point cloud
+ * Graph output: point cloud (range image)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param height Number of rows of the image. Has to be positive.
+ * @param width Number of columns of the image. Has to be positive.
+ * @param azimuth_min Azimuth (in radians) of the left edge of the image.
+ * @param azimuth_max Azimuth (in radians) of the right edge of the image. Has to be greater than `azimuth_min`.
+ */
+RGL_API rgl_status_t rgl_node_points_range_image(rgl_node_t* node, int32_t height, int32_t width, float azimuth_min,
+                                                 float azimuth_max);
+
+/**
+ * Creates or modifies OccupancyGridPointsNode.
+ * The Node bins hit points (all points, if RGL_FIELD_IS_HIT_I32 is not present) by their RGL_FIELD_XYZ_VEC3_F32
+ * into an axis-aligned grid of `size_x` x `size_y` x `size_z` cells (a 2D grid, if `size_z` == 1), see `rgl_occupancy_cell_t`.
+ * Points outside the grid are skipped. Optionally, rays are cast through the grid to count misses,
+ * see `rgl_node_points_occupancy_grid_configure_ray_casting`.
+ * The grid is yielded as a single dense buffer of cells (with X index changing fastest, then Y, then Z)
+ * in RGL_FIELD_DYNAMIC_FORMAT. The Node's point cloud has `size_x` x (`size_y` * `size_z`) cells and no other fields.
+ * The grid stays in device memory, see `rgl_graph_get_result_device_ptr` to pass it to other CUDA consumers.
+ * Any modification of the grid or the accumulation mode clears the cells.
+ * Graph input: point cloud
+ * Graph output: point cloud (occupancy grid)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param grid_min Pointer to the corner of the grid with the lowest coordinates, in the coordinate frame of points.
+ * @param cell_size Pointer to the dimensions of a cell. They have to be positive.
+ * @param size_x Number of cells along X axis. Has to be positive.
+ * @param size_y Number of cells along Y axis. Has to be positive.
+ * @param size_z Number of cells along Z axis. Has to be positive.
+ * @param accumulate If true, cells are accumulated over runs (e.g. of points transformed to the world frame),
+ * otherwise, they are cleared in every run.
+ */
+RGL_API rgl_status_t rgl_node_points_occupancy_grid(rgl_node_t* node, const rgl_vec3f* grid_min, const rgl_vec3f* cell_size,
+                                                    int32_t size_x, int32_t size_y, int32_t size_z, bool accumulate);
+
+/**
+ * Configures casting rays through the occupancy grid. Each ray goes from `ray_origin` to its point
+ * and increments `miss_count` of the cells it crosses before the cell of the hit point.
+ * Non-hits increment cells up to their point as well, which requires finite non-hit distances,
+ * see `rgl_node_raytrace_configure_non_hits`; non-hits with non-finite coordinates are skipped.
+ * Ray casting is disabled by default.
+ * @param node OccupancyGridPointsNode to configure.
+ * @param enable If true, rays are cast in the following runs.
+ * @param ray_origin Pointer to the origin of rays (e.g. the sensor position), in the coordinate frame of points.
+ * When accumulating points of a moving sensor, it should be updated before every run.
+ */
+RGL_API rgl_status_t rgl_node_points_occupancy_grid_configure_ray_casting(rgl_node_t node, bool enable,
+                                                                          const rgl_vec3f* ray_origin);
+
 /**
  * Creates or modifies SpatialMergePointsNode.
  * The Node merges point clouds spatially (e.g., multiple lidars outputs into one point cloud).
@@ -768,6 +2285,34 @@ RGL_API rgl_status_t rgl_node_points_spatial_merge(rgl_node_t* node, const rgl_f
  */
 RGL_API rgl_status_t rgl_node_points_temporal_merge(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count);
 
+/**
+ * Creates or modifies TemporalMergePointsNode, which keeps only recent point clouds in a ring buffer in device memory.
+ * When a point cloud does not fit, the oldest point clouds are evicted until it does.
+ * Optionally, point clouds older than the given time window (measured in the scene time, see rgl_scene_set_time)
+ * are evicted as well. Point clouds larger than max_point_count are truncated.
+ * Otherwise, the Node behaves as the one created by rgl_node_points_temporal_merge.
+ * Graph input: point cloud
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param fields Fields to be merged.
+ * @param field_count Number of elements in the `fields` array.
+ * @param max_point_count Capacity of the ring buffer, i.e. the maximum number of merged points.
+ * @param time_window Time window in seconds; if zero, point clouds are evicted only when the ring buffer is full.
+ */
+RGL_API rgl_status_t rgl_node_points_temporal_merge_ring(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count,
+                                                         int32_t max_point_count, double time_window);
+
+/**
+ * Configures TemporalMergePointsNode to keep merged points in unified (managed) memory instead of device memory
+ * (or host memory, for the Node created by rgl_node_points_temporal_merge), so that long accumulations may exceed
+ * device memory. Memory prefers to reside on the device; only the range written in a run (and, for the ring buffer,
+ * the merged output) is prefetched there, older points are migrated on demand.
+ * Already merged points are dropped. Managed memory is disabled by default.
+ * @param node TemporalMergePointsNode to configure.
+ * @param enable If true, points are merged in managed memory.
+ */
+RGL_API rgl_status_t rgl_node_points_temporal_merge_configure_managed_memory(rgl_node_t node, bool enable);
+
 /**
  * Creates or modifies FromArrayPointsNode.
  * The Node provides initial points for its children Nodes.
@@ -791,6 +2336,23 @@ RGL_API rgl_status_t rgl_node_points_temporal_merge(rgl_node_t* node, const rgl_
 RGL_API rgl_status_t rgl_node_points_from_array(rgl_node_t* node, const void* points, int32_t points_count,
                                                 const rgl_field_t* fields, int32_t field_count);
 
+/**
+ * Creates or modifies FromArrayPointsNode, which reads points in place, without copying them.
+ * Points are given as in rgl_node_points_from_array, but in device-accessible memory: device, managed, or page-locked
+ * host memory (cudaMallocHost, cudaHostRegister). They are split into fields on the device in each rgl_graph_run,
+ * so the content may be updated by the client between runs (e.g. with the next recorded cloud) without calling this function.
+ * The memory must stay valid and must not be modified during rgl_graph_run, as long as the Node is used.
+ * Input: none
+ * Output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param points Device-accessible pointer to the array of points, see rgl_node_points_from_array.
+ * @param points_count Number of elements in the `points` array.
+ * @param fields Subsequent fields to be present in the binary input.
+ * @param field_count Number of elements in the `fields` array.
+ */
+RGL_API rgl_status_t rgl_node_points_from_device_array(rgl_node_t* node, const void* points, int32_t points_count,
+                                                       const rgl_field_t* fields, int32_t field_count);
+
 /**
  * Creates or modifies RadarPostprocessPointsNode.
  * The Node processes point cloud to create radar-like output.
@@ -819,6 +2381,25 @@ RGL_API rgl_status_t rgl_node_points_radar_postprocess(rgl_node_t* node, const r
                                                        float cumulative_device_gain, float received_noise_mean,
                                                        float received_noise_st_dev);
 
+/**
+ * Creates or modifies RadarRangeDopplerPointsNode.
+ * The Node simulates the signal of an FMCW radar (single receive channel): echoes of input points, scaled by
+ * the radar equation with RCS factors computed as in rgl_node_points_radar_postprocess, are synthesized into
+ * the beat signal, which is range-Doppler processed with a 2D FFT (cuFFT) and tested by cell-averaging CFAR.
+ * Everything is done on the GPU. Points beyond the unambiguous (maximum) range and non-hits do not echo.
+ * The output is the range-Doppler map organized as chirp_count rows (zero speed in the middle) of samples_per_chirp
+ * range bins, with fields: RGL_FIELD_DISTANCE_F32 and RGL_FIELD_RADIAL_SPEED_F32 of the bin, RGL_FIELD_POWER_F32
+ * (in dBm), RGL_FIELD_NOISE_F32 (CFAR's estimate, in dBm), RGL_FIELD_SNR_F32 (in dB) and RGL_FIELD_IS_HIT_I32 (detection).
+ * Graph input: point cloud
+ * Graph output: point cloud (range-Doppler map)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param config Pointer to the parameters of the signal and its processing. See `rgl_radar_fmcw_config_t` for more details.
+ * @param ray_azimuth_step The azimuth step between rays (in radians).
+ * @param ray_elevation_step The elevation step between rays (in radians).
+ */
+RGL_API rgl_status_t rgl_node_points_radar_range_doppler(rgl_node_t* node, const rgl_radar_fmcw_config_t* config,
+                                                         float ray_azimuth_step, float ray_elevation_step);
+
 /**
  * Creates or modifies FilterGroundPointsNode.
  * The Node adds RGL_FIELD_IS_GROUND_I32 which indicates the point is on the ground. Points are not removed.
@@ -832,6 +2413,142 @@ RGL_API rgl_status_t rgl_node_points_radar_postprocess(rgl_node_t* node, const r
 RGL_API rgl_status_t rgl_node_points_filter_ground(rgl_node_t* node, const rgl_vec3f* sensor_up_vector,
                                                    float ground_angle_threshold);
 
+/**
+ * Creates or modifies FilterGroundPlanePointsNode.
+ * The Node adds RGL_FIELD_IS_GROUND_I32 (with the same convention as rgl_node_points_filter_ground). Points are not removed.
+ * The ground is approximated by a plane fitted to the point cloud with RANSAC, evaluating all hypotheses in parallel on the GPU.
+ * Unlike rgl_node_points_remove_ground (PCL extension), normals are not needed and no data is copied to the host.
+ * Graph input: point cloud
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param sensor_up_vector Pointer to single Vec3 describing up vector of the point cloud's frame.
+ * @param ground_angle_threshold The maximum allowed angle between the plane normal and the up vector (in radians). Used when fitting plane model.
+ * @param ground_distance_threshold The maximum point's distance to the plane to consider it an inlier (in distance units). Used when fitting plane model.
+ * @param ground_filter_distance The maximum point's distance to the fitted plane to mark that point as ground (in distance units).
+ * @param max_iterations Number of plane hypotheses to evaluate.
+ */
+RGL_API rgl_status_t rgl_node_points_filter_ground_plane(rgl_node_t* node, const rgl_vec3f* sensor_up_vector,
+                                                         float ground_angle_threshold, float ground_distance_threshold,
+                                                         float ground_filter_distance, int32_t max_iterations);
+
+/**
+ * Creates or modifies VoxelDownsamplePointsNode.
+ * The Node reduces the number of points by keeping the first point (in the input order) of each occupied voxel.
+ * Unlike rgl_node_points_downsample (PCL extension), the whole computation is done on the GPU.
+ * Output points are ordered by voxels.
+ * Graph input: point cloud
+ * Graph output: point cloud (downsampled, unorganized)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param leaf_size_* Dimensions of the voxel.
+ */
+RGL_API rgl_status_t rgl_node_points_voxel_downsample(rgl_node_t* node, float leaf_size_x, float leaf_size_y,
+                                                      float leaf_size_z);
+
+/**
+ * Creates or modifies SortPointsNode.
+ * The Node reorders points by the value of a scalar field, e.g. to restore the firing order of the sensor
+ * (by RGL_FIELD_TIME_STAMP_F64, RGL_FIELD_AZIMUTH_F32 or RGL_FIELD_RAY_IDX_U32) after compaction or merging.
+ * The sort is stable: points with equal values keep their input order. NaNs are placed after (or before, if descending)
+ * all other values. The whole computation is done on the GPU.
+ * Graph input: point cloud
+ * Graph output: point cloud (sorted, unorganized)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param key_field Scalar field to sort by, see `rgl_field_predicate_t`.
+ * @param descending If true, points are sorted from the highest value, otherwise from the lowest one.
+ */
+RGL_API rgl_status_t rgl_node_points_sort(rgl_node_t* node, rgl_field_t key_field, bool descending);
+
+/**
+ * Creates or modifies EstimateNormalsPointsNode.
+ * The Node estimates normals of the sensed surface with PCA of the neighbourhood (points within the radius) of each point,
+ * like PCL's NormalEstimation, but on the GPU. Unlike the mesh normal computed by raytracing, they are affected
+ * by the noise and sampling of the point cloud. Normals are oriented towards the sensor.
+ * The Node replaces RGL_FIELD_NORMAL_VEC3_F32 and adds RGL_FIELD_CURVATURE_F32; both are NaN for points
+ * with less than 2 neighbours (or collinear ones, for the normal) and for non-hits (if RGL_FIELD_IS_HIT_I32 is present).
+ * Neighbours of organized point clouds (e.g. rings x azimuths, see rgl_node_rays_set_layout) are searched
+ * in the 5x5 window of adjacent rows and columns, otherwise in a spatial hash grid.
+ * Graph input: point cloud
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param radius Radius of the neighbourhood (in distance units).
+ */
+RGL_API rgl_status_t rgl_node_points_estimate_normals(rgl_node_t* node, float radius);
+
+/**
+ * Creates or modifies EuclideanClusterPointsNode.
+ * The Node segments the point cloud into objects, like PCL's EuclideanClusterExtraction, but on the GPU:
+ * clusters are connected components of points linked when their distance is within the tolerance.
+ * Neighbours are searched in a spatial hash grid (of the tolerance size) and joined with concurrent union-find.
+ * The Node adds RGL_FIELD_CLUSTER_ID_I32; clusters with less than `min_cluster_size` or more than `max_cluster_size` points,
+ * non-hits (if RGL_FIELD_IS_HIT_I32 is present) and non-finite points get -1.
+ * Graph input: point cloud
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param tolerance Maximum distance between linked points (in distance units).
+ * @param min_cluster_size Minimum number of points of a cluster.
+ * @param max_cluster_size Maximum number of points of a cluster.
+ */
+RGL_API rgl_status_t rgl_node_points_cluster_euclidean(rgl_node_t* node, float tolerance, int32_t min_cluster_size,
+                                                       int32_t max_cluster_size);
+
+/**
+ * Creates or modifies ClusterBoxesPointsNode.
+ * The Node computes axis-aligned bounding boxes of clusters given by RGL_FIELD_CLUSTER_ID_I32
+ * (see `rgl_node_points_cluster_euclidean`), one for each cluster id in order, see `rgl_cluster_box_t`.
+ * Boxes are available as RGL_FIELD_DYNAMIC_FORMAT with the point size of rgl_cluster_box_t.
+ * Graph input: point cloud
+ * Graph output: point cloud (cluster boxes)
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ */
+RGL_API rgl_status_t rgl_node_points_cluster_boxes(rgl_node_t* node);
+
+/**
+ * Creates or modifies SpatialIndexPointsNode.
+ * The Node builds a spatial index (a hash grid of cells of the `cell_size`, sorted on the GPU) over RGL_FIELD_XYZ_VEC3_F32
+ * of the point cloud, which passes through unchanged. Once the graph is run, the index answers batched spatial queries,
+ * see `rgl_node_points_spatial_index_query_nearest` and `rgl_node_points_spatial_index_query_radius`.
+ * Non-hits (if RGL_FIELD_IS_HIT_I32 is present) and non-finite points are never found.
+ * Queries scan all cells within the search distance, so the cell size should be comparable to the typical search distance.
+ * Points in a box are selected without an index by `rgl_node_points_compact_by_region`.
+ * Graph input: point cloud
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param cell_size Size of the cells of the grid (in distance units).
+ */
+RGL_API rgl_status_t rgl_node_points_spatial_index(rgl_node_t* node, float cell_size);
+
+/**
+ * Finds the nearest point (in the last run of the graph) to each of the query points, in parallel on the GPU.
+ * Blocks until results of the node are available, like `rgl_graph_get_result_data`.
+ * Equidistant points are resolved by the lower index.
+ * @param node SpatialIndexPointsNode, see `rgl_node_points_spatial_index`.
+ * @param queries Query points, in the frame of the point cloud.
+ * @param query_count Number of elements in `queries`.
+ * @param max_distance Maximum distance of the nearest point; farther points are not found.
+ * @param out_indices Array of `query_count` indices of the nearest points in the point cloud (-1 if none was found).
+ * @param out_distances Array of `query_count` distances to the nearest points (+infinity if none was found).
+ */
+RGL_API rgl_status_t rgl_node_points_spatial_index_query_nearest(rgl_node_t node, const rgl_vec3f* queries,
+                                                                 int32_t query_count, float max_distance,
+                                                                 int32_t* out_indices, float* out_distances);
+
+/**
+ * Finds points (in the last run of the graph) within the radius of each of the query points, in parallel on the GPU.
+ * Blocks until results of the node are available, like `rgl_graph_get_result_data`.
+ * At most `max_neighbour_count` points are found for a query, in no particular order.
+ * @param node SpatialIndexPointsNode, see `rgl_node_points_spatial_index`.
+ * @param queries Query points, in the frame of the point cloud.
+ * @param query_count Number of elements in `queries`.
+ * @param radius Radius of the search (in distance units).
+ * @param max_neighbour_count Maximum number of points found for a query.
+ * @param out_indices Array of `query_count` x `max_neighbour_count` indices of points in the point cloud, row per query,
+ *                    padded with -1.
+ * @param out_counts Array of `query_count` numbers of points found for queries.
+ */
+RGL_API rgl_status_t rgl_node_points_spatial_index_query_radius(rgl_node_t node, const rgl_vec3f* queries, int32_t query_count,
+                                                                float radius, int32_t max_neighbour_count,
+                                                                int32_t* out_indices, int32_t* out_counts);
+
 /**
  * Creates or modifies GaussianNoiseAngularRaysNode.
  * Applies angular noise to the rays before raycasting.
@@ -879,6 +2596,29 @@ RGL_API rgl_status_t rgl_node_gaussian_noise_angular_hitpoint(rgl_node_t* node,
 RGL_API rgl_status_t rgl_node_gaussian_noise_distance(rgl_node_t* node, float mean, float st_dev_base,
                                                       float st_dev_rise_per_meter);
 
+/**
+ * Creates or modifies GaussianNoiseTransformPointsNode.
+ * Equivalent to GaussianNoiseAngularHitpointNode, GaussianNoiseDistanceNode and TransformPointsNode connected in that order,
+ * but reads and writes points only once.
+ * Note: affects on RGL_FIELD_XYZ_VEC3_F32 and RGL_DISTANCE_F32 (if present).
+ * Should be used after the raytrace Node.
+ * Graph input: point cloud
+ * Graph output: point cloud
+ * @param node If (*node) == nullptr, a new Node will be created. Otherwise, (*node) will be modified.
+ * @param angular_mean Angular hitpoint noise mean in radians.
+ * @param angular_st_dev Angular hitpoint noise standard deviation in radians.
+ * @param angular_axis Axis on which angular hitpoint noise will be performed.
+ * @param distance_mean Distance noise mean in meters.
+ * @param distance_st_dev_base Distance noise standard deviation base in meters.
+ * @param distance_st_dev_rise_per_meter Distance noise standard deviation rise per meter.
+ * @param transform Pointer to a single 3x4 affine matrix describing the transformation applied after the noise.
+ */
+RGL_API rgl_status_t rgl_node_gaussian_noise_transform_points(rgl_node_t* node, float angular_mean, float angular_st_dev,
+                                                              rgl_axis_t angular_axis, float distance_mean,
+                                                              float distance_st_dev_base,
+                                                              float distance_st_dev_rise_per_meter,
+                                                              const rgl_mat3x4f* transform);
+
 /**
  * Assigns value true to out_alive if the given node is known and has not been destroyed,
  * assigns value false otherwise.
@@ -896,6 +2636,28 @@ RGL_API rgl_status_t rgl_node_is_alive(rgl_node_t node, bool* out_alive);
  */
 RGL_API rgl_status_t rgl_graph_run(rgl_node_t node);
 
+/**
+ * Prepares the RGL graph containing provided Node to run, so that its first run is as fast as steady-state ones:
+ * the graph is validated and arrays of its Nodes are allocated for the given maximum number of rays (points).
+ * Raytracing Nodes reserve their arrays for all of their returns. Capacity much larger than needed by subsequent runs
+ * is eventually released, as in steady state. Device memory comes from the pool, see rgl_configure_device_memory_pool.
+ * The graph must not be running; this function waits until allocations are done.
+ * @param node Any Node from the graph to prepare
+ * @param max_ray_count Maximum number of rays (and points produced by Nodes) expected in the graph's runs
+ */
+RGL_API rgl_status_t rgl_graph_prepare(rgl_node_t node, int32_t max_ray_count);
+
+/**
+ * Starts execution of multiple RGL graphs at once, e.g. of all sensors in a frame.
+ * It is equivalent to calling rgl_graph_run for each graph, but all graphs are validated before any of them starts
+ * (if any is invalid, none is run), and graphs raytracing the same Scene share its version, which is prepared once
+ * (the same Scene time applies to all of them). Passing more than one Node of the same graph runs it once.
+ * This function is asynchronous.
+ * @param nodes An array of node_count Nodes, any Node from each graph to execute
+ * @param node_count Number of elements in the nodes array
+ */
+RGL_API rgl_status_t rgl_graph_run_batch(const rgl_node_t* nodes, int32_t node_count);
+
 /**
  * Destroys RGL graph (all connected Nodes) containing the provided Node.
  * @param node Any Node from the graph to destroy
@@ -913,6 +2675,15 @@ RGL_API rgl_status_t rgl_graph_destroy(rgl_node_t node);
  */
 RGL_API rgl_status_t rgl_graph_get_result_size(rgl_node_t node, rgl_field_t field, int32_t* out_count, int32_t* out_size_of);
 
+/**
+ * Obtains identifier of the graph run (frame) which produced the current results of the Node.
+ * Frame ids of a graph start from 1 and are incremented by each rgl_graph_run, zero means the Node has not been run yet.
+ * If the result is not yet available, this function will block.
+ * @param node Node to get frame id of its results.
+ * @param out_frame_id Non-null pointer where frame id will be stored.
+ */
+RGL_API rgl_status_t rgl_graph_get_result_frame_id(rgl_node_t node, uint64_t* out_frame_id);
+
 /**
  * Obtains the result data of any Node in the graph.
  * If the result is not yet available, this function will block.
@@ -922,6 +2693,112 @@ RGL_API rgl_status_t rgl_graph_get_result_size(rgl_node_t node, rgl_field_t fiel
  */
 RGL_API rgl_status_t rgl_graph_get_result_data(rgl_node_t node, rgl_field_t field, void* data);
 
+/**
+ * Obtains the result data of multiple fields of the Node at once. It is equivalent to calling rgl_graph_get_result_data
+ * for each field, but copies of all fields are awaited once. If any field cannot be obtained, no data is written.
+ * If the result is not yet available, this function will block.
+ * @param node Node to get output from
+ * @param fields An array of field_count fields to get output from (see rgl_graph_get_result_data)
+ * @param field_count Number of elements in the fields array
+ * @param dsts An array of field_count buffers, each of size (*out_count) * (*out_size_of) of the respective field
+ *             (see rgl_graph_get_result_size)
+ * @param out_counts If not NULL, an array of field_count elements to store the number of elements of each field
+ */
+RGL_API rgl_status_t rgl_graph_get_results(rgl_node_t node, const rgl_field_t* fields, int32_t field_count,
+                                           void* const* dsts, int32_t* out_counts);
+
+/**
+ * Asynchronous counterpart of rgl_graph_get_result_data, which does not block the calling thread.
+ * The copy is performed once the Node is executed; the callback is invoked from an RGL worker thread when data is ready.
+ * If the Node's run fails, the callback is invoked with the error status.
+ * The callback must not block and must not call RGL API functions.
+ * The buffer must remain valid until the callback is invoked. The next rgl_graph_run of the graph waits for pending copies.
+ * Copies to page-locked memory are faster and do not involve RGL worker threads in the transfer.
+ * @param node Node to get output from
+ * @param field Field to get output from. Formatted output with FormatNode should be marked as RGL_FIELD_DYNAMIC_FORMAT.
+ * @param dst Destination buffer of size (*out_count) * (*out_size_of), see rgl_graph_get_result_size(...).
+ * @param callback Non-null callback invoked when the data is ready.
+ * @param user_data Pointer passed to the callback. It may be null.
+ */
+RGL_API rgl_status_t rgl_graph_get_result_data_async(rgl_node_t node, rgl_field_t field, void* dst,
+                                                     rgl_result_callback_t callback, void* user_data);
+
+/**
+ * Obtains device pointer to the result data of any Node in the graph, for consumption by CUDA code (e.g. CUDA-graphics interop)
+ * without copying results to the host. Results may still be computed when this function returns.
+ * Before reading the data, the consumer must make its stream wait for the returned event (cudaStreamWaitEvent),
+ * or synchronize the event (cudaEventSynchronize).
+ * The pointer and the event remain valid until the next rgl_graph_run of the graph, or until the graph is modified.
+ * The consumer must finish reading the data before calling rgl_graph_run again.
+ * @param node Node to get output from
+ * @param field Field to get output from. Formatted output with FormatNode should be marked as RGL_FIELD_DYNAMIC_FORMAT.
+ * @param out_device_ptr Non-null pointer where the device pointer will be stored.
+ * @param out_count Returns the number of available elements (e.g., points). It may be null.
+ * @param out_event Non-null pointer where the CUDA event (cudaEvent_t) will be stored.
+ */
+RGL_API rgl_status_t rgl_graph_get_result_device_ptr(rgl_node_t node, rgl_field_t field, const void** out_device_ptr,
+                                                     int32_t* out_count, void** out_event);
+
+/**
+ * Obtains a chunk of the output of a streaming RaytraceNode (see rgl_node_raytrace_configure_streaming):
+ * the range of layout columns it covers and the CUDA event (cudaEvent_t) recorded once its points are written.
+ * Points of the chunk are those with column index (point index modulo layout width) in the range, for each return.
+ * Combined with rgl_graph_get_result_device_ptr of the RaytraceNode, it allows a consumer to process chunks of a sweep
+ * as soon as they are traced, by making its stream wait for the event of each chunk.
+ * Events remain valid until the next rgl_graph_run of the graph, or until the graph is modified.
+ * @param node Streaming RaytraceNode to get output from.
+ * @param chunk_index Index of the chunk, in the order of columns.
+ * @param out_column_begin Returns the first column of the chunk. It may be null.
+ * @param out_column_count Returns the number of columns of the chunk. It may be null.
+ * @param out_event Non-null pointer where the CUDA event (cudaEvent_t) will be stored.
+ */
+RGL_API rgl_status_t rgl_graph_get_result_chunk(rgl_node_t node, int32_t chunk_index, int32_t* out_column_begin,
+                                                int32_t* out_column_count, void** out_event);
+
+/**
+ * Exports the result data of any Node in the graph as a DLPack tensor, to be consumed without copies by frameworks
+ * supporting DLPack (e.g. wrapped into a "dltensor" PyCapsule for torch.from_dlpack, cupy.from_dlpack or jax.dlpack).
+ * The tensor is two-dimensional: points x components of the field (e.g. N x 3 float32 for XYZ_VEC3_F32);
+ * formatted output (RGL_FIELD_DYNAMIC_FORMAT) is described as N x point size bytes.
+ * Device, host (pinned or pageable) and managed memory are reported with corresponding DLPack device types.
+ * As with rgl_graph_get_result_device_ptr, results may still be computed when this function returns:
+ * the consumer must make its stream wait for the returned event (cudaEvent_t) before reading the data.
+ * The tensor keeps the memory alive until its deleter is called, but the data is overwritten by the next rgl_graph_run
+ * of the graph; the consumer must finish reading it (or copy it) before running the graph again.
+ * @param node Node to get output from
+ * @param field Field to get output from. It must not be a padding.
+ * @param out_dl_managed_tensor Non-null pointer where the DLManagedTensor* (see dlpack.h) will be stored.
+ *                              The consumer owns it and must call its deleter.
+ * @param out_event Non-null pointer where the CUDA event (cudaEvent_t) will be stored.
+ */
+RGL_API rgl_status_t rgl_graph_get_result_dlpack(rgl_node_t node, rgl_field_t field, void** out_dl_managed_tensor,
+                                                 void** out_event);
+
+/**
+ * Registers a buffer into which the result data of the Node is copied in each rgl_graph_run, as the part of the graph run.
+ * Unlike rgl_graph_get_result_data, the client's thread does not take part in the copy (no intermediate host buffer).
+ * The buffer may be device memory or host memory. Host memory which is not page-locked is registered (cudaHostRegister)
+ * as long as the buffer is used by the Node. The buffer must not be accessed by the client while the graph is running.
+ * If the result does not fit in the buffer, the graph run fails.
+ * Readiness of the data can be polled with rgl_graph_get_result_buffer_status.
+ * @param node Node to get output from
+ * @param field Field to get output from. Formatted output with FormatNode should be marked as RGL_FIELD_DYNAMIC_FORMAT.
+ * @param buffer Destination buffer of the results. Passing null unregisters the previous buffer.
+ * @param buffer_size Size of the buffer in bytes.
+ */
+RGL_API rgl_status_t rgl_graph_set_result_buffer(rgl_node_t node, rgl_field_t field, void* buffer, int64_t buffer_size);
+
+/**
+ * Obtains non-blocking status of the result buffer registered with rgl_graph_set_result_buffer.
+ * If the graph run has failed, the error will be returned.
+ * @param node Node to which the buffer has been registered.
+ * @param field Field of the registered buffer.
+ * @param out_ready Non-null pointer where true is stored if the results of the current run are available in the buffer.
+ * @param out_count Returns the number of elements copied to the buffer, valid if *out_ready is true. It may be null.
+ */
+RGL_API rgl_status_t rgl_graph_get_result_buffer_status(rgl_node_t node, rgl_field_t field, bool* out_ready,
+                                                        int32_t* out_count);
+
 /**
  * Adds child to the parent Node
  * @param parent Node that will be set as the parent of (child)
@@ -939,6 +2816,7 @@ RGL_API rgl_status_t rgl_graph_node_remove_child(rgl_node_t parent, rgl_node_t c
 /**
  * Allows to set relative node's priority, which determine their execution order.
  * Nodes will be executed in descending order of their priorities.
+ * Pending runs of different graphs are dispatched in descending order of graph priorities (max priority of graph's nodes).
  * This is useful when some branch needs to be executed before another.
  * By default, all nodes have set priority to 0.
  * Setting node priority to a value higher than the priority of its parent will also bump parent's priority.
@@ -955,3 +2833,82 @@ RGL_API rgl_status_t rgl_graph_node_set_priority(rgl_node_t node, int32_t priori
  * @param out_priority Non-null pointer where priority will be stored.
  */
 RGL_API rgl_status_t rgl_graph_node_get_priority(rgl_node_t node, int32_t* out_priority);
+
+/**
+ * Sets priority of CUDA streams the graph is executed in, so that the GPU schedules work of urgent graphs
+ * (e.g. the front lidar) before work of others (e.g. debug visualization) when they run concurrently.
+ * Level 0 is the lowest (default) priority; levels beyond the range supported by the device are clamped to the highest.
+ * Without this call, the level is derived from node priorities (see rgl_graph_node_set_priority), negative ones being 0.
+ * Nodes added to the graph later keep their setting; the call should be repeated after changing graph's structure.
+ * @param node Any node of the graph.
+ * @param priority Non-negative level of GPU priority.
+ */
+RGL_API rgl_status_t rgl_graph_set_gpu_priority(rgl_node_t node, int32_t priority);
+
+/**
+ * Seeds random numbers (e.g. noise) generated by nodes of the graph, which by default are seeded randomly.
+ * Random numbers are keyed by (seed, frame, element), where frames are counted from seeding.
+ * Therefore, running the graph on identical inputs after seeding it with the same value gives bit-identical results.
+ * Seeds of nodes are derived from the given one and positions of nodes in the graph (traversed from the given node),
+ * which are the same for graphs built (nodes created and connected) in the same order.
+ * Nodes added to the graph later are not seeded; the call should be repeated after changing graph's structure.
+ * @param node Any node of the graph to seed.
+ * @param seed Seed value.
+ */
+RGL_API rgl_status_t rgl_graph_set_random_seed(rgl_node_t node, uint64_t seed);
+
+/**
+ * Enables or disables caching results of RaytraceNodes of the graph, which is useful e.g. when a simulation is paused
+ * or the sensor stands still in a static scene. A cached RaytraceNode does not trace rays (keeping its previous output)
+ * if nothing affecting it changed since the previous run: neither the scene (entities, meshes, textures), nor node's
+ * configuration and fields, nor the sensor pose and rays (nodes providing them were not modified).
+ * The cache does not apply to RaytraceNodes with noise or weather, with dense output, or traced in a batch;
+ * noisy (random in each run) nodes providing rays (e.g. rgl_node_gaussian_noise_angular_ray) prevent it, too.
+ * If the TIME_STAMP_F64 field is computed, scene time has to be the same as well.
+ * Nodes added to the graph later keep their setting; the call should be repeated after changing graph's structure.
+ * @param node Any node of the graph.
+ * @param enable If true, result cache is enabled. Disabled by default.
+ */
+RGL_API rgl_status_t rgl_graph_configure_result_cache(rgl_node_t node, bool enable);
+
+/**
+ * Enables or disables reusing memory of intermediate results of the graph's nodes (e.g. transformed or noised points).
+ * With memory reuse, nodes release their intermediate arrays as soon as the last node consuming them has been enqueued,
+ * so that nodes enqueued later reuse the memory; peak usage depends on the width of the graph rather than on its length.
+ * Only intermediates consumed in the same branch (CUDA stream) are released; nodes without outputs keep their results.
+ * Afterwards, fields backed by released intermediates (as provided by any node, e.g. forwarded to a leaf node) cannot be
+ * read with rgl_graph_get_result_data* or rgl_graph_get_result_device_ptr; they are available from rgl_node_points_yield
+ * (rgl_graph_get_result_data copies its host cache) and from result buffers (see rgl_graph_set_result_buffer).
+ * Nodes of such graph are not captured into CUDA graphs (replayed in steady state), since intermediates move in each run.
+ * Nodes added to the graph later keep their setting; the call should be repeated after changing graph's structure.
+ * @param node Any node of the graph.
+ * @param enable If true, memory reuse is enabled. Disabled by default.
+ */
+RGL_API rgl_status_t rgl_graph_configure_memory_reuse(rgl_node_t node, bool enable);
+
+/**
+ * Enables or disables dropping frames of the graph, which is useful in real-time setups, where a late frame is worse
+ * than none. With frame dropping, rgl_graph_run (and rgl_graph_run_batch) skips the run instead of waiting
+ * if the previous run of the graph has not completed yet (on the CPU or on the GPU); results of the previous run are kept.
+ * Skipped runs are counted, see rgl_graph_get_dropped_frame_count.
+ * Nodes added to the graph later keep their setting; the call should be repeated after changing graph's structure.
+ * @param node Any node of the graph.
+ * @param enable If true, frame dropping is enabled. Disabled by default.
+ */
+RGL_API rgl_status_t rgl_graph_configure_frame_dropping(rgl_node_t node, bool enable);
+
+/**
+ * Obtains the number of runs of the graph skipped because of frame dropping (see rgl_graph_configure_frame_dropping).
+ * The counter starts from zero when the structure of the graph changes.
+ * @param node Any node of the graph.
+ * @param out_count Non-null pointer where the number of dropped frames will be stored.
+ */
+RGL_API rgl_status_t rgl_graph_get_dropped_frame_count(rgl_node_t node, int32_t* out_count);
+
+/**
+ * Obtains timings of the Node measured in runs selected by rgl_configure_performance_sampling.
+ * This function does not block: GPU times are updated once the GPU completes the timed run.
+ * @param node Node to get timings of.
+ * @param out_stats Non-null pointer where the timings will be stored.
+ */
+RGL_API rgl_status_t rgl_graph_get_node_stats(rgl_node_t node, rgl_node_stats_t* out_stats);
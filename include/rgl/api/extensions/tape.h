@@ -18,7 +18,8 @@
 
 /**
  * Starts recording all API calls.
- * Two files will be created at the path location: .yaml and .bin file.
+ * Two files will be created at the path location: .tape and .bin file.
+ * Calls are written to the files asynchronously, in a background thread; the files are complete after rgl_tape_record_end.
  * Only one record session can be executed at the same time.
  * Currently, Windows is not supported: throws RGL_TAPE_ERROR
  * @param path path to output files (should contain filename without extension)
@@ -37,6 +38,22 @@ RGL_API rgl_status_t rgl_tape_record_end();
  */
 RGL_API rgl_status_t rgl_tape_record_is_active(bool* is_active);
 
+/**
+ * Starts replicating all API calls to a remote worker (tools/rglServer), e.g. to simulate sensors on other GPU servers
+ * while this process remains the authority of the scene. Calls are encoded as in tapes and streamed in a background
+ * thread; the worker plays them in its own Scene, in place of the default one (see rglServer), then reports their
+ * status, and failures are logged as warnings. Objects created before the replication began are not replicated, so
+ * it should begin before the scene is built. Results are not streamed back; workers publish them with their graphs.
+ * Can be used along with tape recording. Currently, Windows is not supported: throws RGL_TAPE_ERROR
+ * @param address Address of the worker: "<host>:<port>", or path of a Unix domain socket
+ */
+RGL_API rgl_status_t rgl_replication_begin(const char* address);
+
+/**
+ * Waits until all calls are sent and played by the worker, then stops replicating and disconnects.
+ */
+RGL_API rgl_status_t rgl_replication_end();
+
 /**
  * Loads recorded API calls from files and exectues them.
  * Currently, Windows is not supported: throws RGL_TAPE_ERROR
@@ -65,6 +65,8 @@ def main():
                         help="Build RGL with UDP extension (closed-source extension)")
     parser.add_argument("--with-snow", action='store_true',
                         help="Build RGL with snow simulation extension (closed-source extension)")
+    parser.add_argument("--with-gl", action='store_true',
+                        help="Build RGL with OpenGL extension (requires OpenGL and GLFW)")
     parser.add_argument("--cmake", type=str, default="",
                         help="Pass arguments to cmake. Usage: --cmake=\"args...\"")
     if on_linux():
@@ -154,7 +156,8 @@ def main():
         f"-DRGL_BUILD_PCL_EXTENSION={'ON' if args.with_pcl else 'OFF'}",
         f"-DRGL_BUILD_ROS2_EXTENSION={'ON' if args.with_ros2 else 'OFF'}",
         f"-DRGL_BUILD_UDP_EXTENSION={'ON' if args.with_udp else 'OFF'}",
-        f"-DRGL_BUILD_SNOW_EXTENSION={'ON' if args.with_snow else 'OFF'}"
+        f"-DRGL_BUILD_SNOW_EXTENSION={'ON' if args.with_snow else 'OFF'}",
+        f"-DRGL_BUILD_GL_EXTENSION={'ON' if args.with_gl else 'OFF'}"
     ]
 
     if on_linux():
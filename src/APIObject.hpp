@@ -14,9 +14,13 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
 #include <spdlog/fmt/fmt.h>
 #include <macros/cuda.hpp>
 #include <macros/dataDeclspec.hpp>
@@ -24,23 +28,185 @@
 #include <typingUtils.hpp>
 #include <RGLExceptions.hpp>
 
+/**
+ * Registry of live API objects of one type, addressed by generational handles.
+ * A handle encodes an index of a slot and the generation of the object in it, so that handles of released objects
+ * (even if their slot is reused) are detected. Lookups are lock-free: the slot is found in a chunked array
+ * (chunks are never moved or freed) and the handle is valid if its generation matches the slot's one.
+ * Registering and releasing objects are serialized with a mutex.
+ * Looking up a handle while another thread releases the same object is a misuse of the API (as with raw pointers).
+ */
+template<typename T>
+struct APIObjectRegistry
+{
+	static_assert(sizeof(void*) == sizeof(uint64_t), "handles require 64-bit pointers");
+	static constexpr std::size_t CHUNK_SIZE = 1024;
+	static constexpr std::size_t MAX_CHUNK_COUNT = 4096; // Up to ~4M live objects of one type
+
+	APIObjectRegistry() = default;
+	APIObjectRegistry(const APIObjectRegistry&) = delete;
+	APIObjectRegistry& operator=(const APIObjectRegistry&) = delete;
+
+	~APIObjectRegistry()
+	{
+		for (auto&& chunk : chunks) {
+			delete chunk.load(std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * @return Object of the given handle, or nullptr if the handle is invalid (e.g. its object has been released).
+	 */
+	const std::shared_ptr<T>* find(const void* handle) const
+	{
+		auto value = reinterpret_cast<uintptr_t>(handle);
+		auto index = static_cast<uint32_t>(value & UINT32_MAX);
+		auto generation = static_cast<uint32_t>(value >> 32);
+		if (index == 0 || (generation & 1) == 0 || (index - 1) / CHUNK_SIZE >= MAX_CHUNK_COUNT) {
+			return nullptr;
+		}
+		const Chunk* chunk = chunks[(index - 1) / CHUNK_SIZE].load(std::memory_order_acquire);
+		if (chunk == nullptr) {
+			return nullptr;
+		}
+		const Slot& slot = chunk->slots[(index - 1) % CHUNK_SIZE];
+		return slot.generation.load(std::memory_order_acquire) == generation ? &slot.object : nullptr;
+	}
+
+	/**
+	 * Registers the object and returns its handle.
+	 */
+	T* insert(std::shared_ptr<T> object)
+	{
+		std::scoped_lock lock{mutex};
+		uint32_t index = 0; // Zero-based here, one-based in handles, so that handles are never null
+		if (!freeIndices.empty()) {
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+		else {
+			if (nextIndex / CHUNK_SIZE >= MAX_CHUNK_COUNT) {
+				throw std::length_error(fmt::format("too many instances of {}", name(typeid(T))));
+			}
+			if (nextIndex % CHUNK_SIZE == 0) {
+				chunks[nextIndex / CHUNK_SIZE].store(new Chunk(), std::memory_order_release);
+			}
+			index = nextIndex++;
+		}
+		Slot& slot = getSlot(index);
+		// Odd generations denote live objects; the generation is published after the object.
+		uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+		slot.object = std::move(object);
+		slot.generation.store(generation, std::memory_order_release);
+		liveObjects.emplace_back(index);
+		slot.liveIdx = liveObjects.size() - 1;
+		return reinterpret_cast<T*>(static_cast<uintptr_t>(generation) << 32 | (index + 1));
+	}
+
+	/**
+	 * Unregisters the object of the given (valid) handle.
+	 * @return The object, so that it is destroyed outside the registry's lock.
+	 */
+	std::shared_ptr<T> erase(const void* handle)
+	{
+		std::scoped_lock lock{mutex};
+		if (find(handle) == nullptr) {
+			return nullptr;
+		}
+		return eraseAt(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(handle) & UINT32_MAX) - 1);
+	}
+
+	/**
+	 * Unregisters all objects satisfying the predicate (all, if none given).
+	 */
+	template<typename Predicate>
+	void eraseIf(Predicate&& predicate)
+	{
+		std::vector<std::shared_ptr<T>> erased;
+		{
+			std::scoped_lock lock{mutex};
+			for (std::size_t i = liveObjects.size(); i-- > 0;) {
+				if (predicate(getSlot(liveObjects[i]).object)) {
+					erased.emplace_back(eraseAt(liveObjects[i]));
+				}
+			}
+		}
+		// Objects are destroyed here, in the reverse order of registration.
+	}
+
+	std::vector<std::shared_ptr<T>> getAll() const
+	{
+		std::scoped_lock lock{mutex};
+		std::vector<std::shared_ptr<T>> objects;
+		objects.reserve(liveObjects.size());
+		for (auto&& index : liveObjects) {
+			objects.emplace_back(getSlot(index).object);
+		}
+		return objects;
+	}
+
+	std::size_t size() const
+	{
+		std::scoped_lock lock{mutex};
+		return liveObjects.size();
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<uint32_t> generation{0};
+		std::shared_ptr<T> object;
+		std::size_t liveIdx{0}; // Position in liveObjects
+	};
+
+	struct Chunk
+	{
+		std::array<Slot, CHUNK_SIZE> slots;
+	};
+
+	Slot& getSlot(uint32_t index) const
+	{
+		return chunks[index / CHUNK_SIZE].load(std::memory_order_relaxed)->slots[index % CHUNK_SIZE];
+	}
+
+	std::shared_ptr<T> eraseAt(uint32_t index)
+	{
+		Slot& slot = getSlot(index);
+		slot.generation.store(slot.generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		std::shared_ptr<T> object = std::move(slot.object);
+		slot.object = nullptr;
+		// Swap-remove from the list of live objects
+		getSlot(liveObjects.back()).liveIdx = slot.liveIdx;
+		liveObjects[slot.liveIdx] = liveObjects.back();
+		liveObjects.pop_back();
+		freeIndices.emplace_back(index);
+		return object;
+	}
+
+	std::array<std::atomic<Chunk*>, MAX_CHUNK_COUNT> chunks{};
+	mutable std::mutex mutex;
+	std::vector<uint32_t> liveObjects; // Indices of slots with live objects
+	std::vector<uint32_t> freeIndices;
+	uint32_t nextIndex{0};
+};
 
 /**
  * Objects shared through C-API should inherit from APIObject<T>, which:
  * - Tracks instances, which may be helpful to e.g. debug leaks on the client side.
+ * - Gives out generational handles (see APIObjectRegistry) instead of raw pointers, which detect use-after-free.
  * - Disallows to make stack instantiations, which cannot be reliably returned through C-API
  * - Disables automatic copying and moving
  */
 template<typename T>
 struct APIObject
 {
-	static DATA_DECLSPEC std::unordered_map<APIObject<T>*, std::shared_ptr<T>> instances;
+	static DATA_DECLSPEC APIObjectRegistry<T> instances;
 
 	// Constructs T instance + 2 shared_ptrs:
 	// - One is stored in instances to account for non-C++ usage
 	//   - This must be manually deleted via release(T*)
 	// - One is returned and can be:
-	//   - .get()-ed to return to non-C++ code
+	//   - ->getHandle()-ed to return to non-C++ code
 	//   - passed within C++ code (as a convenience for e.g. testing)
 	template<typename... Args>
 	static std::shared_ptr<T> create(Args&&... args)
@@ -53,31 +219,31 @@ struct APIObject
 	{
 		// Cannot use std::make_shared due to private constructor
 		auto ptr = std::shared_ptr<SubClass>(new SubClass(std::forward<Args>(args)...));
-		// Implicit static cast converts ptr to std::shared_ptr<Base> (this changes value returned by .get())
-		instances.insert({ptr.get(), ptr});
+		ptr->handle = instances.insert(ptr);
 		return ptr;
 	}
 
-	// Translates raw pointers coming from C-api into shared object
+	// Translates handles coming from C-api into shared object
 	// This allows to detect / prevent user from:
 	// - Use-after-free
 	// - Passing invalid handle type (e.g. mesh instead of entity)
-	// In both cases 'this' will be not found in 'instances'.
-	static std::shared_ptr<T> validatePtr(T* rawPtr)
+	// In both cases the handle will be not found in 'instances'.
+	// The returned reference is valid until the object is released.
+	static const std::shared_ptr<T>& validatePtr(T* rawPtr)
 	{
-		auto it = instances.find(rawPtr);
-		if (it == instances.end()) {
+		const std::shared_ptr<T>* object = instances.find(rawPtr);
+		if (object == nullptr) {
 			auto msg = fmt::format("RGL API Error: Object does not exist: {} {}", name(typeid(T)),
 			                       reinterpret_cast<void*>(rawPtr));
 			throw InvalidAPIObject(msg);
 		}
-		return it->second;
+		return *object;
 	}
 
 	template<typename SubClass>
 	static std::shared_ptr<SubClass> validatePtr(T* rawPtr)
 	{
-		auto node = validatePtr(rawPtr);
+		const auto& node = validatePtr(rawPtr);
 		auto subclass = std::dynamic_pointer_cast<SubClass>(node);
 		if (subclass != nullptr) {
 			return subclass;
@@ -87,12 +253,19 @@ struct APIObject
 		throw InvalidAPIObject(msg);
 	}
 
+	static bool isAlive(T* rawPtr) { return instances.find(rawPtr) != nullptr; }
+
 	static void release(T* toDestroy)
 	{
 		validatePtr(toDestroy);
 		instances.erase(toDestroy);
 	}
 
+	/**
+	 * @return Handle to be returned through C-API; nullptr if the object is not registered (e.g. default Scene).
+	 */
+	T* getHandle() const { return handle; }
+
 	APIObject(APIObject<T>&) = delete;
 	APIObject(APIObject<T>&&) = delete;
 	APIObject<T>& operator=(APIObject<T>&) = delete;
@@ -101,10 +274,16 @@ struct APIObject
 
 protected:
 	APIObject() = default;
+
+	// Registers a released object again (e.g. one retained for reuse), giving it a new handle.
+	static void reregister(const std::shared_ptr<T>& object) { object->handle = instances.insert(object); }
+
+private:
+	T* handle{nullptr};
 };
 
 // This should be used in .cpp file to make an instance of static variable(s) of APIObject<Type>
 #define API_OBJECT_INSTANCE(Type)                                                                                              \
 	template<typename T>                                                                                                       \
-	DATA_DECLSPEC std::unordered_map<APIObject<T>*, std::shared_ptr<T>> APIObject<T>::instances;                               \
+	DATA_DECLSPEC APIObjectRegistry<T> APIObject<T>::instances;                                                                \
 	template struct APIObject<Type>
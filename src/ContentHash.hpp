@@ -0,0 +1,42 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Fast, non-cryptographic hash of array contents (FNV-1a over 64-bit words),
+// used to detect API calls passing data identical to the one already held by a node.
+template<typename T>
+uint64_t hashContent(const T* data, size_t count)
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+	constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+	const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+	const size_t size = sizeof(T) * count;
+	uint64_t hash = FNV_OFFSET_BASIS;
+	size_t offset = 0;
+	for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, bytes + offset, sizeof(uint64_t));
+		hash = (hash ^ word) * FNV_PRIME;
+	}
+	for (; offset < size; ++offset) {
+		hash = (hash ^ bytes[offset]) * FNV_PRIME;
+	}
+	return hash;
+}
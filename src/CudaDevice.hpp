@@ -0,0 +1,90 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <macros/cuda.hpp>
+
+/**
+ * Process-wide selection of the CUDA device used by RGL, see rgl_configure_device.
+ * CUDA runtime keeps the current device per thread, so each thread issuing CUDA calls (API callers and RGL workers)
+ * binds itself to the selected device. The device cannot be changed once RGL has created any resource on it.
+ */
+struct CudaDevice
+{
+	static void select(int32_t deviceIdx)
+	{
+		std::lock_guard lock{mutex};
+		if (isInUse.load(std::memory_order_relaxed)) {
+			throw std::invalid_argument(fmt::format("device has to be selected before RGL creates any resources on device {}",
+			                                        selected.load(std::memory_order_relaxed)));
+		}
+		int32_t deviceCount = getCount();
+		if (deviceIdx >= deviceCount) {
+			throw std::invalid_argument(fmt::format("device {} requested, but only {} are available", deviceIdx, deviceCount));
+		}
+		selected.store(deviceIdx, std::memory_order_relaxed);
+		bindCurrentThread();
+	}
+
+	static int32_t getSelected() { return selected.load(std::memory_order_relaxed); }
+
+	/**
+	 * Returns the number of CUDA devices; zero on hosts without a GPU or a driver, instead of failing.
+	 */
+	static int32_t getCount()
+	{
+		int deviceCount = 0;
+		cudaError_t error = cudaGetDeviceCount(&deviceCount);
+		if (error == cudaErrorNoDevice || error == cudaErrorInsufficientDriver) {
+			cudaGetLastError(); // Clears the error
+			return 0;
+		}
+		CHECK_CUDA(error);
+		return deviceCount;
+	}
+
+	static void bindCurrentThread()
+	{
+		thread_local int32_t boundDevice = 0; // CUDA default
+		int32_t device = getSelected();
+		if (boundDevice != device) {
+			CHECK_CUDA(cudaSetDevice(device));
+			boundDevice = device;
+		}
+	}
+
+	/**
+	 * Called on creation of device resources (memory, streams, events, OptiX context), which prevents changing the device.
+	 */
+	static void markInUse()
+	{
+		if (!isInUse.load(std::memory_order_relaxed)) {
+			std::lock_guard lock{mutex};
+			isInUse.store(true, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	static inline std::mutex mutex;
+	static inline std::atomic<int32_t> selected{0};
+	static inline std::atomic<bool> isInUse{false};
+};
@@ -14,6 +14,7 @@
 
 #pragma once
 #include <macros/cuda.hpp>
+#include <CudaDevice.hpp>
 #include <Logger.hpp>
 #include <macros/handleDestructorException.hpp>
 
@@ -36,7 +37,11 @@ struct CudaEvent
 	HANDLE_DESTRUCTOR_EXCEPTION
 
 private:
-	explicit CudaEvent(int flag) { CHECK_CUDA(cudaEventCreateWithFlags(&event, flag)); }
+	explicit CudaEvent(int flag)
+	{
+		CudaDevice::markInUse();
+		CHECK_CUDA(cudaEventCreateWithFlags(&event, flag));
+	}
 
 private:
 	cudaEvent_t event{nullptr};
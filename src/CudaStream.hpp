@@ -15,6 +15,7 @@
 #pragma once
 
 #include <macros/cuda.hpp>
+#include <CudaDevice.hpp>
 #include <macros/handleDestructorException.hpp>
 #include <Logger.hpp>
 
@@ -23,7 +24,11 @@ struct CudaStream
 {
 	using Ptr = std::shared_ptr<CudaStream>;
 
-	static CudaStream::Ptr create(unsigned flags = 0U) { return CudaStream::Ptr(new CudaStream(flags)); }
+	// Lower numbers are higher priorities, see cudaDeviceGetStreamPriorityRange; 0 is the default (lowest) priority.
+	static CudaStream::Ptr create(unsigned flags = 0U, int priority = 0)
+	{
+		return CudaStream::Ptr(new CudaStream(flags, priority));
+	}
 
 	static CudaStream::Ptr getNullStream()
 	{
@@ -33,13 +38,15 @@ struct CudaStream
 		return nullStream;
 	}
 
+	// Each thread has its own, so that copies of different client's threads do not wait for each other.
 	static CudaStream::Ptr getCopyStream()
 	{
-		static CudaStream::Ptr copyStream{new CudaStream(cudaStreamNonBlocking)};
+		static thread_local CudaStream::Ptr copyStream{new CudaStream(cudaStreamNonBlocking)};
 		return copyStream;
 	}
 
 	cudaStream_t getHandle() { return stream; }
+	int getPriority() const { return priority; }
 
 	~CudaStream()
 	try {
@@ -56,8 +63,13 @@ private:
 	CudaStream() {}
 
 	// Constructs a new stream
-	explicit CudaStream(unsigned flags) { CHECK_CUDA(cudaStreamCreateWithFlags(&stream, flags)); }
+	explicit CudaStream(unsigned flags, int priority = 0) : priority(priority)
+	{
+		CudaDevice::markInUse();
+		CHECK_CUDA(cudaStreamCreateWithPriority(&stream, flags, priority));
+	}
 
 private:
 	cudaStream_t stream{nullptr};
+	int priority{0};
 };
@@ -0,0 +1,124 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <CudaDevice.hpp>
+#include <RGLFields.hpp>
+#include <memory/IAnyArray.hpp>
+
+/**
+ * Structures binary-compatible with DLManagedTensor of dlpack.h (ABI of DLPack 0.x, stable since 0.6),
+ * so that results can be handed to PyTorch, CuPy, JAX etc. (e.g. as a "dltensor" PyCapsule) without depending on DLPack.
+ */
+namespace dlpack {
+enum DeviceType : int32_t
+{
+	CPU = 1,
+	CUDA = 2,
+	CUDA_HOST = 3,
+	CUDA_MANAGED = 13,
+};
+
+enum DataTypeCode : uint8_t
+{
+	INT = 0,
+	UINT = 1,
+	FLOAT = 2,
+};
+
+struct Device
+{
+	int32_t deviceType;
+	int32_t deviceId;
+};
+
+struct DataType
+{
+	uint8_t code;
+	uint8_t bits;
+	uint16_t lanes;
+};
+
+struct Tensor
+{
+	void* data;
+	Device device;
+	int32_t ndim;
+	DataType dtype;
+	int64_t* shape;
+	int64_t* strides; // Null for compact row-major tensors
+	uint64_t byteOffset;
+};
+
+struct ManagedTensor
+{
+	Tensor tensor;
+	void* managerCtx;
+	void (*deleter)(ManagedTensor* self);
+};
+} // namespace dlpack
+
+/**
+ * Wraps the array of a field into a DLPack tensor, without copying, as a 2D tensor [point, component].
+ * The tensor holds the array until the consumer calls its deleter; contents are overwritten by the next graph run.
+ * Formatted fields (RGL_FIELD_DYNAMIC_FORMAT) are described as bytes of each point.
+ */
+inline dlpack::ManagedTensor* createDLPackTensor(IAnyArray::ConstPtr array, rgl_field_t field, std::size_t pointSize)
+{
+	struct Holder
+	{
+		dlpack::ManagedTensor managed;
+		IAnyArray::ConstPtr array;
+		std::array<int64_t, 2> shape;
+	};
+
+	dlpack::DataType dtype{.code = dlpack::UINT, .bits = 8, .lanes = 1};
+	int64_t componentCount = static_cast<int64_t>(pointSize);
+	if (field != RGL_FIELD_DYNAMIC_FORMAT) {
+		componentCount = static_cast<int64_t>(getFieldComponentNames(field).size());
+		bool isHalf = field == XYZ_VEC3_F16 || field == DISTANCE_F16 || field == NORMAL_VEC3_F16;
+		char kind = getFieldComponentKind(field);
+		dtype.code = isHalf || kind == 'F' ? dlpack::FLOAT : kind == 'I' ? dlpack::INT : dlpack::UINT;
+		dtype.bits = static_cast<uint8_t>(8 * getFieldSize(field) / componentCount);
+	}
+
+	dlpack::DeviceType deviceType = dlpack::CPU;
+	switch (array->getMemoryKind()) {
+		case MemoryKind::DeviceAsync:
+		case MemoryKind::DeviceSync: deviceType = dlpack::CUDA; break;
+		case MemoryKind::DeviceManaged: deviceType = dlpack::CUDA_MANAGED; break;
+		case MemoryKind::HostPinned: deviceType = dlpack::CUDA_HOST; break;
+		case MemoryKind::HostPageable: deviceType = dlpack::CPU; break;
+	}
+
+	auto* holder = new Holder{.array = array};
+	int64_t pointCount = static_cast<int64_t>(array->getCount() * array->getSizeOf() / pointSize);
+	holder->shape = {pointCount, componentCount};
+	holder->managed.tensor = dlpack::Tensor{
+	    .data = const_cast<void*>(array->getRawReadPtr()), // DLPack has no const tensors; consumers must not write
+	    .device = {.deviceType = deviceType, .deviceId = deviceType == dlpack::CPU ? 0 : CudaDevice::getSelected()},
+	    .ndim = 2,
+	    .dtype = dtype,
+	    .shape = holder->shape.data(),
+	    .strides = nullptr,
+	    .byteOffset = 0,
+	};
+	holder->managed.managerCtx = holder;
+	holder->managed.deleter = [](dlpack::ManagedTensor* self) { delete static_cast<Holder*>(self->managerCtx); };
+	return &holder->managed;
+}
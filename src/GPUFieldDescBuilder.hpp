@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <type_traits>
 #include <typeinfo>
 
@@ -26,43 +28,72 @@
 // Builder for GPUFieldDesc. Separated struct to avoid polluting gpu-visible header (gpu/GPUFieldDesc.hpp).
 struct GPUFieldDescBuilder
 {
-	// TODO: This class has (had?) a hidden bug. If hostBuffer was not zeroed on each build,
+	// TODO: This class has (had?) a hidden bug. If descriptors were not zeroed on each build,
 	// TODO: fillSizeAndOffset would leave trash in some GPUFieldDesc causing cudaIllegalMemoryAccess
 	// TODO: Also, this class is over-engineered; likely due to using GPUFieldDesc for both directions of formatting
 	// TODO: This should be fixed by splitting GPUFieldDesc into two separate structs and merging fill* methods.
 
-	const DeviceAsyncArray<GPUFieldDesc>& buildReadableAsync(CudaStream::Ptr stream,
-	                                                         const std::vector<std::pair<rgl_field_t, const void*>>& fieldsData)
+	explicit GPUFieldDescBuilder(StreamBoundObjectsManager& arrayMgr)
+	  : deviceBuffer(DeviceAsyncArray<GPUFieldDesc>::create(arrayMgr))
+	{}
+
+	const GPUFieldDescs& buildReadableAsync(CudaStream::Ptr stream,
+	                                        const std::vector<std::pair<rgl_field_t, const void*>>& fieldsData)
 	{
-		hostBuffer->clear(false);
-		hostBuffer->resize(fieldsData.size(), true, false);
+		descs.assign(fieldsData.size(), GPUFieldDesc{});
 		fillSizeAndOffset(getFields(fieldsData));
 		fillPointers(fieldsData);
-		deviceBuffer->setStream(stream);
-		deviceBuffer->copyFrom(hostBuffer);
-		return *deviceBuffer;
+		return finish(stream);
 	}
 
-	const DeviceAsyncArray<GPUFieldDesc>& buildWritableAsync(CudaStream::Ptr stream,
-	                                                         const std::vector<std::pair<rgl_field_t, void*>>& fieldsData)
+	const GPUFieldDescs& buildWritableAsync(CudaStream::Ptr stream,
+	                                        const std::vector<std::pair<rgl_field_t, void*>>& fieldsData)
 	{
-		hostBuffer->clear(false);
-		hostBuffer->resize(fieldsData.size(), true, false);
+		descs.assign(fieldsData.size(), GPUFieldDesc{});
 		fillSizeAndOffset(getFields(fieldsData));
 		fillPointers(fieldsData);
-		deviceBuffer->setStream(stream);
-		deviceBuffer->copyFrom(hostBuffer);
-		return *deviceBuffer;
+		return finish(stream);
 	}
 
 private:
+	// Few descriptors are passed in kernel parameters; others are uploaded only if they (fields or pointers) have changed.
+	const GPUFieldDescs& finish(const CudaStream::Ptr& stream)
+	{
+		if (descs.size() <= GPUFieldDescs::INLINE_CAPACITY) {
+			result.devicePtr = nullptr;
+			std::copy(descs.begin(), descs.end(), result.inlined);
+			return result;
+		}
+		bool isUploaded = deviceBuffer->getStream() == stream && hostBuffer->getCount() == descs.size() &&
+		                  std::memcmp(hostBuffer->getReadPtr(), descs.data(), descs.size() * sizeof(GPUFieldDesc)) == 0;
+		if (!isUploaded) {
+			hostBuffer->resize(descs.size(), false, false);
+			std::copy(descs.begin(), descs.end(), hostBuffer->getWritePtr());
+			uploadAsync(stream);
+		}
+		result.devicePtr = deviceBuffer->getReadPtr();
+		return result;
+	}
+
+	// The copy is not synchronized (so that it can be captured in a CUDA graph); hostBuffer must not be rebuilt before it ends.
+	// Users synchronize the stream before building again (FromArrayPointsNode in setParameters, others between graph runs).
+	void uploadAsync(const CudaStream::Ptr& stream)
+	{
+		if (deviceBuffer->getStream() != stream) {
+			deviceBuffer->setStream(stream);
+		}
+		deviceBuffer->resize(hostBuffer->getCount(), false, false);
+		CHECK_CUDA(cudaMemcpyAsync(deviceBuffer->getWritePtr(), hostBuffer->getReadPtr(),
+		                           hostBuffer->getCount() * sizeof(GPUFieldDesc), cudaMemcpyHostToDevice, stream->getHandle()));
+	}
+
 	void fillSizeAndOffset(const std::vector<rgl_field_t>& fields)
 	{
 		std::size_t offset = 0;
 		std::size_t gpuFieldIdx = 0;
 		for (auto field : fields) {
 			if (!isDummy(field)) {
-				(*hostBuffer)[gpuFieldIdx] = GPUFieldDesc{
+				descs[gpuFieldIdx] = GPUFieldDesc{
 				    .readDataPtr = nullptr, .writeDataPtr = nullptr, .size = getFieldSize(field), .dstOffset = offset};
 			}
 			++gpuFieldIdx;
@@ -83,22 +114,24 @@ private:
 	void fillPointers(const std::vector<std::pair<rgl_field_t, T>>& fieldsData)
 	{
 		static_assert(std::is_same_v<T, void*> || std::is_same_v<T, const void*>);
-		for (size_t i = 0; i < hostBuffer->getCount(); ++i) {
+		for (size_t i = 0; i < descs.size(); ++i) {
 			if (fieldsData[i].second == nullptr) { // dummy field
 				continue;
 			}
 			if constexpr (std::is_same_v<T, const void*>) {
-				(*hostBuffer)[i].readDataPtr = static_cast<const char*>(fieldsData[i].second);
+				descs[i].readDataPtr = static_cast<const char*>(fieldsData[i].second);
 				continue;
 			}
 			if constexpr (std::is_same_v<T, void*>) {
-				(*hostBuffer)[i].writeDataPtr = static_cast<char*>(fieldsData[i].second);
+				descs[i].writeDataPtr = static_cast<char*>(fieldsData[i].second);
 				continue;
 			}
 		}
 	}
 
 private:
-	HostPinnedArray<GPUFieldDesc>::Ptr hostBuffer = HostPinnedArray<GPUFieldDesc>::create();
-	DeviceAsyncArray<GPUFieldDesc>::Ptr deviceBuffer = DeviceAsyncArray<GPUFieldDesc>::create(CudaStream::getNullStream());
+	std::vector<GPUFieldDesc> descs;
+	GPUFieldDescs result{};
+	HostPinnedArray<GPUFieldDesc>::Ptr hostBuffer = HostPinnedArray<GPUFieldDesc>::create(); // Last uploaded
+	DeviceAsyncArray<GPUFieldDesc>::Ptr deviceBuffer;
 };
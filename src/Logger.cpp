@@ -48,7 +48,7 @@ void Logger::configure(rgl_log_level_t logLevel, std::optional<std::filesystem::
 		sinkList.push_back(stdoutSink);
 	}
 
-	mainLogger = std::make_shared<spdlog::logger>("RGL", sinkList.begin(), sinkList.end());
+	createLogger(std::move(sinkList));
 	mainLogger->set_level(static_cast<spdlog::level::level_enum>(logLevel));
 	mainLogger->set_pattern("[%c]: %v");
 	mainLogger->info("Logging configured: level={}, file={}, stdout={}",
@@ -57,3 +57,35 @@ void Logger::configure(rgl_log_level_t logLevel, std::optional<std::filesystem::
 	// https://spdlog.docsforge.com/master/3.custom-formatting/#pattern-flags
 	mainLogger->set_pattern("[%T][%6i us][%l]: %v");
 }
+
+void Logger::configureQueue(std::size_t newQueueSize)
+{
+	spdlog::level::level_enum level = mainLogger->level();
+	queueSize = newQueueSize;
+	createLogger(mainLogger->sinks());
+	mainLogger->set_level(level);
+	mainLogger->info("Logging queue configured: size={}", queueSize);
+}
+
+uint64_t Logger::getDroppedMessageCount() const
+{
+	return droppedByFormerQueues + (threadPool != nullptr ? threadPool->overrun_counter() : 0);
+}
+
+void Logger::createLogger(std::vector<spdlog::sink_ptr> sinks)
+{
+	// Former queue is drained (by its destructor) when the logger using it is replaced.
+	auto formerThreadPool = std::move(threadPool);
+	if (formerThreadPool != nullptr) {
+		droppedByFormerQueues += formerThreadPool->overrun_counter();
+	}
+	if (queueSize > 0) {
+		threadPool = std::make_shared<spdlog::details::thread_pool>(queueSize, 1);
+		mainLogger = std::make_shared<spdlog::async_logger>("RGL", sinks.begin(), sinks.end(), threadPool,
+		                                                    spdlog::async_overflow_policy::overrun_oldest);
+	}
+	else {
+		mainLogger = std::make_shared<spdlog::logger>("RGL", sinks.begin(), sinks.end());
+	}
+	mainLogger->set_pattern("[%T][%6i us][%l]: %v");
+}
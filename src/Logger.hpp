@@ -17,6 +17,7 @@
 #include <optional>
 
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
@@ -30,12 +31,30 @@ struct Logger
 	static Logger& getOrCreate();
 	void configure(rgl_log_level_t logLevel, std::optional<std::filesystem::path> logFilePath, bool useStdout);
 	void configure(rgl_log_level_t logLevel, const char* logFilePath, bool useStdout);
+
+	/**
+	 * Switches to logging from a background thread through a bounded queue of the given number of messages,
+	 * where the oldest messages are dropped when it is full, so that logging threads never wait for sinks (e.g. file I/O).
+	 * Zero restores synchronous logging. Sinks are kept as configured.
+	 */
+	void configureQueue(std::size_t queueSize);
+
+	/**
+	 * Returns the number of messages dropped from the queue (see configureQueue) since the start of the process.
+	 */
+	uint64_t getDroppedMessageCount() const;
+
 	void flush() { mainLogger->flush(); }
 	spdlog::logger& getLogger() { return *mainLogger; }
 
 private:
 	Logger();
+	void createLogger(std::vector<spdlog::sink_ptr> sinks);
+
 	std::shared_ptr<spdlog::logger> mainLogger;
+	std::shared_ptr<spdlog::details::thread_pool> threadPool; // Only when logging through a queue
+	std::size_t queueSize{0};
+	uint64_t droppedByFormerQueues{0};
 };
 
 #define RGL_TRACE Logger::getOrCreate().getLogger().trace
@@ -0,0 +1,246 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <string_view>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include <spdlog/fmt/fmt.h>
+
+#include <MetricsExporter.hpp>
+#include <PerformanceCounters.hpp>
+#include <Logger.hpp>
+#include <RGLExceptions.hpp>
+#include <ThreadConfig.hpp>
+#include <macros/handleDestructorException.hpp>
+
+void MetricsExporter::RunLatencyHistogram::add(std::chrono::steady_clock::duration latency)
+{
+	double latencyMs = std::chrono::duration<double, std::milli>(latency).count();
+	std::size_t bucketIdx = 0;
+	while (bucketIdx < BUCKET_BOUNDS_MS.size() && latencyMs > BUCKET_BOUNDS_MS[bucketIdx]) {
+		++bucketIdx;
+	}
+	bucketCounts[bucketIdx].fetch_add(1, std::memory_order_relaxed);
+	sumNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count(), std::memory_order_relaxed);
+}
+
+MetricsExporter::~MetricsExporter()
+try {
+	stopEndpoint();
+}
+HANDLE_DESTRUCTOR_EXCEPTION
+
+void MetricsExporter::configure(bool isEnabled, uint16_t httpPort)
+{
+	std::lock_guard lock{endpointMutex};
+	enabled.store(isEnabled, std::memory_order_relaxed);
+	stopEndpoint();
+	if (!isEnabled || httpPort == 0) {
+		return;
+	}
+#ifdef _WIN32
+	throw InvalidAPIArgument("metrics HTTP endpoint is not supported on Windows");
+#else
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		throw std::runtime_error(fmt::format("cannot create metrics endpoint socket: {}", std::strerror(errno)));
+	}
+	int reuse = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	sockaddr_in address{.sin_family = AF_INET, .sin_port = htons(httpPort)};
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+		auto msg = fmt::format("cannot listen for metrics requests on port {}: {}", httpPort, std::strerror(errno));
+		close(fd);
+		throw InvalidAPIArgument(msg);
+	}
+	listenFd = fd;
+	endpointThread = std::thread(&MetricsExporter::serveEndpoint, this);
+	RGL_INFO("Serving metrics on port {}", httpPort);
+#endif // _WIN32
+}
+
+void MetricsExporter::stopEndpoint()
+{
+#ifndef _WIN32
+	if (listenFd < 0) {
+		return;
+	}
+	shutdown(listenFd, SHUT_RDWR); // Wakes up the thread waiting in accept()
+	endpointThread.join();
+	close(listenFd);
+	listenFd = -1;
+#endif // _WIN32
+}
+
+void MetricsExporter::serveEndpoint()
+{
+#ifndef _WIN32
+	ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-metrics"};
+	constexpr std::size_t MAX_REQUEST_BYTES = 8192;
+	std::string request;
+	while (true) {
+		int clientFd = accept(listenFd, nullptr, nullptr);
+		if (clientFd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			return; // Shut down
+		}
+		// Any request is answered with metrics, once its headers are received; a body is not expected.
+		request.clear();
+		char chunk[1024];
+		while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+			ssize_t count = read(clientFd, chunk, sizeof(chunk));
+			if (count <= 0) {
+				break;
+			}
+			request.append(chunk, count);
+		}
+		if (request.starts_with("GET ")) {
+			std::string body = render();
+			std::string response = fmt::format("HTTP/1.1 200 OK\r\n"
+			                                   "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+			                                   "Content-Length: {}\r\nConnection: close\r\n\r\n{}",
+			                                   body.size(), body);
+			std::string_view remaining = response;
+			while (!remaining.empty()) {
+				ssize_t count = send(clientFd, remaining.data(), remaining.size(), MSG_NOSIGNAL);
+				if (count <= 0) {
+					break;
+				}
+				remaining.remove_prefix(count);
+			}
+		}
+		close(clientFd);
+	}
+#endif // _WIN32
+}
+
+std::shared_ptr<MetricsExporter::RunLatencyHistogram> MetricsExporter::createRunLatencyHistogram(uint32_t graphOrdinal)
+{
+	auto histogram = std::make_shared<RunLatencyHistogram>();
+	std::lock_guard lock{mutex};
+	runLatencies[graphOrdinal] = histogram;
+	return histogram;
+}
+
+std::string MetricsExporter::render()
+{
+	rgl_performance_counters_t counters = PerformanceCounters::instance().get();
+	counters.log_dropped_count = Logger::getOrCreate().getDroppedMessageCount();
+
+	fmt::memory_buffer out;
+	auto appendFamily = [&](std::string_view name, std::string_view type, std::string_view unit, std::string_view help) {
+		fmt::format_to(std::back_inserter(out), "# TYPE {} {}\n", name, type);
+		if (!unit.empty()) {
+			fmt::format_to(std::back_inserter(out), "# UNIT {} {}\n", name, unit);
+		}
+		fmt::format_to(std::back_inserter(out), "# HELP {} {}\n", name, help);
+	};
+	auto appendCounter = [&](std::string_view name, std::string_view unit, std::string_view help, auto value) {
+		appendFamily(name, "counter", unit, help);
+		fmt::format_to(std::back_inserter(out), "{}_total {}\n", name, value);
+	};
+	auto appendGauge = [&](std::string_view name, std::string_view unit, std::string_view help, auto value) {
+		appendFamily(name, "gauge", unit, help);
+		fmt::format_to(std::back_inserter(out), "{} {}\n", name, value);
+	};
+
+	appendFamily("rgl_graph_run_latency_seconds", "histogram", "seconds",
+	             "Time from submitting a graph run to completion of its GPU work.");
+	{
+		std::lock_guard lock{mutex};
+		for (auto it = runLatencies.begin(); it != runLatencies.end();) {
+			auto histogram = it->second.lock();
+			if (histogram == nullptr) {
+				it = runLatencies.erase(it); // The graph has been destroyed
+				continue;
+			}
+			uint64_t cumulativeCount = 0;
+			for (std::size_t i = 0; i < histogram->bucketCounts.size(); ++i) {
+				cumulativeCount += histogram->bucketCounts[i].load(std::memory_order_relaxed);
+				auto bound = i < RunLatencyHistogram::BUCKET_BOUNDS_MS.size() ?
+				                 fmt::format("{}", RunLatencyHistogram::BUCKET_BOUNDS_MS[i] * 1.0e-3) :
+				                 std::string("+Inf");
+				fmt::format_to(std::back_inserter(out), "rgl_graph_run_latency_seconds_bucket{{graph=\"{}\",le=\"{}\"}} {}\n",
+				               it->first, bound, cumulativeCount);
+			}
+			double sumSeconds = static_cast<double>(histogram->sumNs.load(std::memory_order_relaxed)) * 1.0e-9;
+			fmt::format_to(std::back_inserter(out), "rgl_graph_run_latency_seconds_sum{{graph=\"{}\"}} {}\n", it->first,
+			               sumSeconds);
+			// The +Inf bucket counts all runs; the count is consistent with it, although buckets are read one by one.
+			fmt::format_to(std::back_inserter(out), "rgl_graph_run_latency_seconds_count{{graph=\"{}\"}} {}\n", it->first,
+			               cumulativeCount);
+			++it;
+		}
+	}
+
+	appendCounter("rgl_traced_rays", "", "Rays traced by RaytraceNodes.", counters.traced_ray_count);
+	appendCounter("rgl_raytrace_cache_hits", "", "Runs of RaytraceNodes reusing the previous output.",
+	              counters.raytrace_cache_hit_count);
+	appendCounter("rgl_gas_builds", "", "Builds and updates of geometry acceleration structures.", counters.gas_build_count);
+	appendCounter("rgl_ias_builds", "", "Builds of instance acceleration structures.", counters.ias_build_count);
+	appendCounter("rgl_ias_refits", "", "Refits of instance acceleration structures.", counters.ias_refit_count);
+	appendCounter("rgl_as_build_seconds", "seconds", "CPU time of building acceleration structures.",
+	              counters.as_build_time_ms * 1.0e-3);
+	appendCounter("rgl_sbt_build_seconds", "seconds", "CPU time of building shader binding tables.",
+	              counters.sbt_build_time_ms * 1.0e-3);
+	appendCounter("rgl_result_copy_seconds", "seconds", "Time of copying results to the client.",
+	              counters.result_copy_time_ms * 1.0e-3);
+	appendCounter("rgl_synchronize_all_seconds", "seconds", "Time of waiting for all running graphs.",
+	              counters.synchronize_all_time_ms * 1.0e-3);
+
+	appendFamily("rgl_transferred_bytes", "counter", "bytes", "Bytes of arrays copied between the host and the device.");
+	fmt::format_to(std::back_inserter(out), "rgl_transferred_bytes_total{{direction=\"host_to_device\"}} {}\n",
+	               counters.host_to_device_bytes);
+	fmt::format_to(std::back_inserter(out), "rgl_transferred_bytes_total{{direction=\"device_to_host\"}} {}\n",
+	               counters.device_to_host_bytes);
+	fmt::format_to(std::back_inserter(out), "rgl_transferred_bytes_total{{direction=\"host_to_host\"}} {}\n",
+	               counters.host_to_host_bytes);
+	fmt::format_to(std::back_inserter(out), "rgl_transferred_bytes_total{{direction=\"device_to_device\"}} {}\n",
+	               counters.device_to_device_bytes);
+	static constexpr std::array<std::pair<MemoryKind, std::string_view>, MEMORY_KIND_COUNT> MEMORY_KIND_LABELS = {{
+	    {MemoryKind::DeviceAsync, "device_async"},
+	    {MemoryKind::DeviceSync, "device_sync"},
+	    {MemoryKind::HostPageable, "host_pageable"},
+	    {MemoryKind::HostPinned, "host_pinned"},
+	    {MemoryKind::DeviceManaged, "device_managed"},
+	}};
+	appendFamily("rgl_array_bytes", "gauge", "bytes", "Memory of internal arrays currently allocated.");
+	for (auto&& [kind, label] : MEMORY_KIND_LABELS) {
+		fmt::format_to(std::back_inserter(out), "rgl_array_bytes{{memory=\"{}\"}} {}\n", label,
+		               PerformanceCounters::instance().getMemoryKindCounters(kind).get().live_bytes);
+	}
+	appendFamily("rgl_array_memory_allocations", "counter", "", "Allocations of memory of internal arrays.");
+	for (auto&& [kind, label] : MEMORY_KIND_LABELS) {
+		fmt::format_to(std::back_inserter(out), "rgl_array_memory_allocations_total{{memory=\"{}\"}} {}\n", label,
+		               PerformanceCounters::instance().getMemoryKindCounters(kind).get().allocation_count);
+	}
+
+	appendGauge("rgl_tape_queue_bytes", "bytes", "Recorded data pending to be written to the tape.", counters.tape_queue_bytes);
+	appendCounter("rgl_tape_stalls", "", "Waits of API calls for the tape writer thread.", counters.tape_stall_count);
+	appendCounter("rgl_log_dropped_messages", "", "Log messages dropped from the full logging queue.",
+	              counters.log_dropped_count);
+	fmt::format_to(std::back_inserter(out), "# EOF\n");
+	return fmt::to_string(out);
+}
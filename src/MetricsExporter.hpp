@@ -0,0 +1,80 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Exposes PerformanceCounters and latencies of graph runs as OpenMetrics (Prometheus) text,
+ * returned by rgl_get_metrics_text and optionally served over HTTP, see rgl_configure_metrics.
+ */
+struct MetricsExporter
+{
+	/**
+	 * Histogram of times from submitting runs of a graph to completion of their GPU work.
+	 */
+	struct RunLatencyHistogram
+	{
+		static constexpr std::array<double, 10> BUCKET_BOUNDS_MS = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
+
+		void add(std::chrono::steady_clock::duration latency);
+
+	private:
+		friend struct MetricsExporter;
+		std::array<std::atomic<uint64_t>, BUCKET_BOUNDS_MS.size() + 1> bucketCounts{}; // Last one is +Inf
+		std::atomic<uint64_t> sumNs{0};
+	};
+
+	static MetricsExporter& instance()
+	{
+		static MetricsExporter exporter;
+		return exporter;
+	}
+
+	/**
+	 * Enables measurement of graph run latencies and (re)starts the HTTP endpoint on the given port, unless it is zero.
+	 */
+	void configure(bool enabled, uint16_t httpPort);
+	bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+	/**
+	 * Returns a histogram of the graph, exported as long as it is held (i.e. until the graph is destroyed).
+	 */
+	std::shared_ptr<RunLatencyHistogram> createRunLatencyHistogram(uint32_t graphOrdinal);
+
+	std::string render();
+
+private:
+	MetricsExporter() = default;
+	~MetricsExporter();
+	void stopEndpoint();
+	void serveEndpoint();
+
+	std::atomic<bool> enabled{false};
+	std::mutex mutex;
+	std::map<uint32_t, std::weak_ptr<RunLatencyHistogram>> runLatencies;
+
+	std::mutex endpointMutex;
+	int listenFd{-1};
+	std::thread endpointThread;
+};
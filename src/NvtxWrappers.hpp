@@ -1,8 +1,12 @@
 #pragma once
 
 #include <cinttypes>
+#include <cstdlib>
 #include <nvtx3/nvToolsExt.h>
 #include <optional>
+#include <string>
+
+#include <TraceRecorder.hpp>
 
 constexpr uint32_t NVTX_CAT_API = 0; // Positive numbers = graphOrdinal
 constexpr uint32_t NVTX_COL_SYNC = 0xffffd700;
@@ -11,12 +15,27 @@ constexpr uint32_t NVTX_COL_WORK = 0xff90ee90;
 constexpr uint32_t NVTX_COL_CALL = 0xff9370db;
 
 
+/**
+ * Marks its scope as a named range for profilers and for the trace recorder (see TraceRecorder).
+ * Without a profiler attached or a trace being recorded, it neither formats the name nor calls NVTX,
+ * since ranges are used in per-frame API calls.
+ */
 struct NvtxRange
 {
 	template<typename... Args>
 	NvtxRange(uint32_t category, uint32_t color, fmt::format_string<Args...> fmt, Args... args)
 	{
+		bool isTraced = TraceRecorder::instance().isRecording();
+		if (!isToolAttached() && !isTraced) [[likely]] {
+			return;
+		}
 		auto msg = fmt::format(fmt, std::forward<Args>(args)...);
+		if (isTraced) {
+			trace.emplace(TracedRange{.name = msg, .category = category, .begin = TraceRecorder::Clock::now()});
+		}
+		if (!isToolAttached()) {
+			return;
+		}
 		nvtxEventAttributes_t eventAttributes = {0};
 		eventAttributes.version = NVTX_VERSION;
 		eventAttributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
@@ -33,8 +52,34 @@ struct NvtxRange
 	NvtxRange& operator=(const NvtxRange&) = delete;
 	NvtxRange& operator=(NvtxRange&&) = delete;
 
-	~NvtxRange() { nvtxRangeEnd(correlationId); }
+	~NvtxRange()
+	{
+		if (correlationId.has_value()) {
+			nvtxRangeEnd(*correlationId);
+		}
+		if (trace.has_value()) {
+			TraceRecorder::instance().addCpuRange(std::move(trace->name), trace->category, trace->begin,
+			                                      TraceRecorder::Clock::now());
+		}
+	}
+
+	/**
+	 * NVTX calls are forwarded to a tool only if it is injected into the process (as profilers do) via this variable.
+	 */
+	static bool isToolAttached()
+	{
+		static const bool isAttached = std::getenv("NVTX_INJECTION64_PATH") != nullptr;
+		return isAttached;
+	}
 
 private:
-	nvtxRangeId_t correlationId;
+	struct TracedRange
+	{
+		std::string name;
+		TraceRecorder::Category category;
+		TraceRecorder::Clock::time_point begin;
+	};
+
+	std::optional<nvtxRangeId_t> correlationId;
+	std::optional<TracedRange> trace;
 };
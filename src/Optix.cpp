@@ -13,18 +13,22 @@
 // limitations under the License.
 
 #include <cassert>
+#include <chrono>
 #include <stdexcept>
 #include <cstring>
+#include <vector>
 
 #include <cuda.h>
 #include <nvml.h>
 #include <optix.h>
 #include <optix_stubs.h>
+#include <optix_stack_size.h>
 #include <optix_function_table_definition.h>
 #include <cuda_runtime_api.h>
 #include <spdlog/fmt/fmt.h>
 
 #include <Optix.hpp>
+#include <CudaDevice.hpp>
 #include <Logger.hpp>
 #include <gpu/optixProgramsPtx.hpp>
 #include <macros/optix.hpp>
@@ -36,6 +40,9 @@
 #define OPTIX_LOG_LEVEL_WARN 3
 #define OPTIX_LOG_LEVEL_INFO 4
 
+// Only raygen traces rays (closest-hit and miss programs do not).
+static constexpr unsigned MAX_TRACE_DEPTH = 1;
+
 static std::pair<int, int> getCudaMajorMinor(int version) { return {version / 1000, (version % 1000) / 10}; }
 
 static std::optional<std::string> wrapError(nvmlReturn_t status)
@@ -53,7 +60,7 @@ static CUcontext getCurrentDeviceContext()
 	CUresult status;
 
 	CUdevice device;
-	status = cuDeviceGet(&device, 0);
+	status = cuDeviceGet(&device, CudaDevice::getSelected());
 	if (status != CUDA_SUCCESS) {
 		cuGetErrorString(status, &error);
 		throw std::runtime_error(fmt::format("failed to get current CUDA device: {} ({})\n", error, status));
@@ -125,8 +132,49 @@ Optix& Optix::getOrCreate()
 	return instance;
 }
 
+void Optix::configureProgramCache(bool enabled, std::optional<std::string> location, uint64_t maxSizeBytes)
+{
+	std::lock_guard lock{programCacheMutex};
+	if (isCreated) {
+		throw std::invalid_argument("program cache has to be configured before OptiX programs are compiled, "
+		                            "i.e. before rgl_warmup or the first use of the scene or raytracing");
+	}
+	programCacheConfig = ProgramCacheConfig{enabled, std::move(location), maxSizeBytes};
+}
+
+void Optix::configureMotionBlur(bool enabled)
+{
+	std::lock_guard lock{programCacheMutex};
+	if (isCreated) {
+		throw std::invalid_argument("motion blur has to be configured before OptiX programs are compiled, "
+		                            "i.e. before rgl_warmup or the first use of the scene or raytracing");
+	}
+	motionBlurEnabled = enabled;
+}
+
+void Optix::configureMaxRegisterCount(int32_t count)
+{
+	std::lock_guard lock{programCacheMutex};
+	if (isCreated) {
+		throw std::invalid_argument("register count has to be configured before OptiX programs are compiled, "
+		                            "i.e. before rgl_warmup or the first use of the scene or raytracing");
+	}
+	maxRegisterCount = count;
+}
+
+bool Optix::isMotionBlurEnabled()
+{
+	std::lock_guard lock{programCacheMutex};
+	return motionBlurEnabled;
+}
+
 Optix::Optix()
 {
+	{
+		std::lock_guard lock{programCacheMutex};
+		isCreated = true;
+	}
+	CudaDevice::markInUse();
 	logVersions();
 	CHECK_OPTIX(optixInit());
 	CHECK_OPTIX(optixDeviceContextCreate(getCurrentDeviceContext(), nullptr, &context));
@@ -149,9 +197,48 @@ Optix::Optix()
 	};
 
 	CHECK_OPTIX(optixDeviceContextSetLogCallback(context, cb, nullptr, OPTIX_LOG_LEVEL_INFO));
+	queryShaderExecutionReordering();
+	applyProgramCacheConfig();
 	initializeStaticOptixStructures();
 }
 
+void Optix::queryShaderExecutionReordering()
+{
+	// Hit objects are available since OptiX 8; older devices run them without reordering, so it is used only if supported.
+#if OPTIX_VERSION >= 80000
+	unsigned flags = 0;
+	CHECK_OPTIX(optixDeviceContextGetProperty(context, OPTIX_DEVICE_PROPERTY_SHADER_EXECUTION_REORDERING, &flags,
+	                                          sizeof(flags)));
+	isShaderExecutionReorderingSupported = (flags & OPTIX_DEVICE_PROPERTY_SHADER_EXECUTION_REORDERING_FLAG_STANDARD) != 0;
+#endif
+	RGL_INFO("OptiX shader execution reordering {}", isShaderExecutionReorderingSupported ? "enabled" : "not supported");
+}
+
+void Optix::applyProgramCacheConfig()
+{
+	if (programCacheConfig.has_value()) {
+		CHECK_OPTIX(optixDeviceContextSetCacheEnabled(context, programCacheConfig->isEnabled ? 1 : 0));
+		if (programCacheConfig->isEnabled && programCacheConfig->location.has_value()) {
+			CHECK_OPTIX(optixDeviceContextSetCacheLocation(context, programCacheConfig->location->c_str()));
+		}
+		if (programCacheConfig->isEnabled && programCacheConfig->maxSizeBytes > 0) {
+			// Garbage collection is triggered above the high watermark and shrinks the cache down to the low one.
+			CHECK_OPTIX(optixDeviceContextSetCacheDatabaseSizes(context, programCacheConfig->maxSizeBytes / 2,
+			                                                    programCacheConfig->maxSizeBytes));
+		}
+	}
+
+	int isEnabled = 0;
+	CHECK_OPTIX(optixDeviceContextGetCacheEnabled(context, &isEnabled));
+	if (isEnabled == 0) {
+		RGL_INFO("OptiX program cache disabled");
+		return;
+	}
+	char location[1024] = {0};
+	CHECK_OPTIX(optixDeviceContextGetCacheLocation(context, location, sizeof(location)));
+	RGL_INFO("OptiX program cache location: {}", location);
+}
+
 Optix::~Optix()
 {
 	// On Windows, when program is terminated, CUDA gets unloaded before OptiX.
@@ -165,12 +252,26 @@ Optix::~Optix()
 		optixPipelineDestroy(pipeline);
 	}
 
-	for (auto&& programGroup : {raygenPG, missPG, hitgroupPG}) {
+	for (auto&& programGroup : {raygenPG, missPG}) {
 		if (programGroup) {
 			optixProgramGroupDestroy(programGroup);
 		}
 	}
 
+	for (auto&& primitivePGs : hitgroupPGs) {
+		for (auto&& programGroup : primitivePGs) {
+			if (programGroup) {
+				optixProgramGroupDestroy(programGroup);
+			}
+		}
+	}
+
+	for (auto&& intersectionModule : intersectionModules) {
+		if (intersectionModule) {
+			optixModuleDestroy(intersectionModule);
+		}
+	}
+
 	if (module) {
 		optixModuleDestroy(module);
 	}
@@ -182,7 +283,7 @@ Optix::~Optix()
 
 void Optix::initializeStaticOptixStructures()
 {
-	OptixModuleCompileOptions moduleCompileOptions = {.maxRegisterCount = 100,
+	OptixModuleCompileOptions moduleCompileOptions = {.maxRegisterCount = maxRegisterCount,
 #ifdef NDEBUG
 	                                                  .optLevel = OPTIX_COMPILE_OPTIMIZATION_LEVEL_2,
 	                                                  .debugLevel = OPTIX_COMPILE_DEBUG_LEVEL_NONE
@@ -192,17 +293,29 @@ void Optix::initializeStaticOptixStructures()
 #endif
 	};
 
+	// See MESH_PRIMITIVE_*; built-in spheres are available since OptiX 7.5.
+	unsigned primitiveTypeFlags = OPTIX_PRIMITIVE_TYPE_FLAGS_TRIANGLE | OPTIX_PRIMITIVE_TYPE_FLAGS_ROUND_LINEAR;
+#if OPTIX_VERSION >= 70500
+	primitiveTypeFlags |= OPTIX_PRIMITIVE_TYPE_FLAGS_SPHERE;
+#endif
+
 	OptixPipelineCompileOptions pipelineCompileOptions = {
-	    .usesMotionBlur = false,
+	    .usesMotionBlur = motionBlurEnabled,
 	    .traversableGraphFlags = OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_ANY,
-	    .numPayloadValues = 3,   // Ray origin: X, Y, Z
+	    // Ray origin: X, Y, Z; hit count, strongest intensity, hit distance (multi-return);
+	    // trace mode, probed incident angle, overridden distance (beam divergence)
+	    .numPayloadValues = 9,
 	    .numAttributeValues = 2, // Triangle barycentrics: X, Y
 	    .exceptionFlags = OPTIX_EXCEPTION_FLAG_NONE,
-	    .pipelineLaunchParamsVariableName = "ctx",
+	    .pipelineLaunchParamsVariableName = "launchParams",
+	    .usesPrimitiveTypeFlags = primitiveTypeFlags,
+#if OPTIX_VERSION >= 70600
+	    .allowOpacityMicromaps = 1, // See Mesh::setOpacityMicromap
+#endif
 	};
 
 	OptixPipelineLinkOptions pipelineLinkOptions = {
-	    .maxTraceDepth = 2,
+	    .maxTraceDepth = MAX_TRACE_DEPTH,
 #ifdef NDEBUG
 	    .debugLevel = OPTIX_COMPILE_DEBUG_LEVEL_NONE,
 #else
@@ -210,8 +323,13 @@ void Optix::initializeStaticOptixStructures()
 #endif
 	};
 
+	// Compilation is skipped on a hit in the program cache, so the time tells whether the cache works.
+	auto compileBegin = std::chrono::steady_clock::now();
 	CHECK_OPTIX(optixModuleCreateFromPTX(context, &moduleCompileOptions, &pipelineCompileOptions, optixProgramsPtx,
 	                                     strlen(optixProgramsPtx), nullptr, nullptr, &module));
+	RGL_INFO("OptiX module created in {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+	                                              std::chrono::steady_clock::now() - compileBegin)
+	                                              .count());
 
 	OptixProgramGroupOptions pgOptions = {};
 	OptixProgramGroupDesc raygenDesc = {
@@ -227,27 +345,79 @@ void Optix::initializeStaticOptixStructures()
 
 	CHECK_OPTIX(optixProgramGroupCreate(context, &missDesc, 1, &pgOptions, nullptr, nullptr, &missPG));
 
-	OptixProgramGroupDesc hitgroupDesc = {
-	    .kind = OPTIX_PROGRAM_GROUP_KIND_HITGROUP,
-	    .hitgroup = {
-	                 .moduleCH = module,
-	                 .entryFunctionNameCH = "__closesthit__",
-	                 .moduleAH = module,
-	                 .entryFunctionNameAH = "__anyhit__",
-	                 }
-    };
-
-	CHECK_OPTIX(optixProgramGroupCreate(context, &hitgroupDesc, 1, &pgOptions, nullptr, nullptr, &hitgroupPG));
+	// Variants of closest-hit program computing only requested groups of fields, indexed by CLOSEST_HIT_FEATURE_* bits.
+	const char* closestHitEntryNames[CLOSEST_HIT_VARIANT_COUNT] = {
+	    "__closesthit__",
+	    "__closesthit__normal",
+	    "__closesthit__velocity",
+	    "__closesthit__normal_velocity",
+	};
+	// Spheres and curves share the closest-hit programs of triangles, but use built-in intersection programs.
+	auto getBuiltinISModule = [&](OptixPrimitiveType primitiveType) {
+		OptixBuiltinISOptions builtinISOptions = {
+		    .builtinISModuleType = primitiveType,
+		    .usesMotionBlur = motionBlurEnabled,
+#if OPTIX_VERSION >= 70400
+		    .buildFlags = OPTIX_BUILD_FLAG_PREFER_FAST_TRACE | OPTIX_BUILD_FLAG_ALLOW_UPDATE, // As GASes, see Mesh::buildGAS
+#endif
+		};
+		OptixModule builtinISModule = nullptr;
+		CHECK_OPTIX(optixBuiltinISModuleGet(context, &moduleCompileOptions, &pipelineCompileOptions, &builtinISOptions,
+		                                    &builtinISModule));
+		return builtinISModule;
+	};
+	intersectionModules[MESH_PRIMITIVE_CURVES] = getBuiltinISModule(OPTIX_PRIMITIVE_TYPE_ROUND_LINEAR);
+#if OPTIX_VERSION >= 70500
+	intersectionModules[MESH_PRIMITIVE_SPHERES] = getBuiltinISModule(OPTIX_PRIMITIVE_TYPE_SPHERE);
+#endif
 
-	OptixProgramGroup programGroups[] = {raygenPG, missPG, hitgroupPG};
+	std::vector<OptixProgramGroup> programGroups = {raygenPG, missPG};
+	for (unsigned primitiveType = 0; primitiveType < MESH_PRIMITIVE_TYPE_COUNT; ++primitiveType) {
+		bool isTriangle = primitiveType == MESH_PRIMITIVE_TRIANGLES;
+		if (!isTriangle && intersectionModules[primitiveType] == nullptr) {
+			continue; // Not supported by this OptiX version
+		}
+		for (unsigned variant = 0; variant < CLOSEST_HIT_VARIANT_COUNT; ++variant) {
+			OptixProgramGroupDesc hitgroupDesc = {
+			    .kind = OPTIX_PROGRAM_GROUP_KIND_HITGROUP,
+			    .hitgroup = {
+			                 .moduleCH = module,
+			                 .entryFunctionNameCH = closestHitEntryNames[variant],
+			                 .moduleAH = module,
+			                 .entryFunctionNameAH = "__anyhit__",
+			                 .moduleIS = intersectionModules[primitiveType],
+			                 .entryFunctionNameIS = nullptr,
+			                 }
+			};
+
+			OptixProgramGroup& programGroup = hitgroupPGs[primitiveType][variant];
+			CHECK_OPTIX(optixProgramGroupCreate(context, &hitgroupDesc, 1, &pgOptions, nullptr, nullptr, &programGroup));
+			programGroups.emplace_back(programGroup);
+		}
+	}
 
-	CHECK_OPTIX(optixPipelineCreate(context, &pipelineCompileOptions, &pipelineLinkOptions, programGroups,
-	                                sizeof(programGroups) / sizeof(programGroups[0]), nullptr, nullptr, &pipeline));
+	CHECK_OPTIX(optixPipelineCreate(context, &pipelineCompileOptions, &pipelineLinkOptions, programGroups.data(),
+	                                programGroups.size(), nullptr, nullptr, &pipeline));
 
-	CHECK_OPTIX(optixPipelineSetStackSize(pipeline,
-	                                      2 * 1024, // directCallableStackSizeFromTraversal
-	                                      2 * 1024, // directCallableStackSizeFromState
-	                                      2 * 1024, // continuationStackSize
-	                                      3         // maxTraversableGraphDepth
+	// Stack sizes are computed from the actual programs, so that no more stack than needed is reserved per thread.
+	OptixStackSizes stackSizes = {};
+	for (auto&& programGroup : programGroups) {
+#if OPTIX_VERSION >= 70700
+		CHECK_OPTIX(optixUtilAccumulateStackSizes(programGroup, &stackSizes, pipeline));
+#else
+		CHECK_OPTIX(optixUtilAccumulateStackSizes(programGroup, &stackSizes));
+#endif
+	}
+	unsigned directCallableStackSizeFromTraversal = 0;
+	unsigned directCallableStackSizeFromState = 0;
+	unsigned continuationStackSize = 0;
+	CHECK_OPTIX(optixUtilComputeStackSizes(&stackSizes, MAX_TRACE_DEPTH, 0, 0, &directCallableStackSizeFromTraversal,
+	                                       &directCallableStackSizeFromState, &continuationStackSize));
+	CHECK_OPTIX(optixPipelineSetStackSize(pipeline, directCallableStackSizeFromTraversal, directCallableStackSizeFromState,
+	                                      continuationStackSize,
+	                                      motionBlurEnabled ? 4 : 3 // maxTraversableGraphDepth, see Scene
 	                                      ));
+	RGL_INFO("OptiX pipeline created with register limit {} and continuation stack size {} B",
+	         maxRegisterCount == OPTIX_COMPILE_DEFAULT_MAX_REGISTER_COUNT ? "default" : std::to_string(maxRegisterCount),
+	         continuationStackSize);
 }
@@ -14,14 +14,42 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <optix_types.h>
 
+#include <gpu/RaytraceRequestContext.hpp>
+
 // RAII object to (de)fillSizeAndOffset OptiX and CUDA
 struct Optix
 {
 	static Optix& getOrCreate();
 	static void logVersions();
 
+	/**
+	 * Configures OptiX disk cache of compiled programs. Programs are compiled once, when the instance is created,
+	 * hence the cache has to be configured before (see rgl_configure_program_cache).
+	 * Unset location or zero size keep OptiX defaults.
+	 */
+	static void configureProgramCache(bool enabled, std::optional<std::string> location, uint64_t maxSizeBytes);
+
+	/**
+	 * Enables motion blur in the pipeline, so that scenes build motion transforms (see rgl_configure_motion_blur).
+	 * Like the program cache, it has to be configured before the instance is created.
+	 */
+	static void configureMotionBlur(bool enabled);
+	static bool isMotionBlurEnabled();
+
+	/**
+	 * Sets the register limit of compiled programs; lower limits allow more threads per SM, at the cost of spills.
+	 * Zero lets OptiX choose (see rgl_configure_max_register_count). Like the program cache, it has to be configured before.
+	 */
+	static void configureMaxRegisterCount(int32_t count);
+
 	Optix();
 	~Optix();
 
@@ -30,8 +58,28 @@ struct Optix
 	OptixPipeline pipeline = nullptr;
 	OptixProgramGroup raygenPG = nullptr;
 	OptixProgramGroup missPG = nullptr;
-	OptixProgramGroup hitgroupPG = nullptr;
+	// Built-in intersection programs, indexed by MESH_PRIMITIVE_*; NULL for triangles (and spheres before OptiX 7.5).
+	std::array<OptixModule, MESH_PRIMITIVE_TYPE_COUNT> intersectionModules{};
+	// Indexed by MESH_PRIMITIVE_* and closest-hit variant, see CLOSEST_HIT_FEATURE_*
+	std::array<std::array<OptixProgramGroup, CLOSEST_HIT_VARIANT_COUNT>, MESH_PRIMITIVE_TYPE_COUNT> hitgroupPGs{};
+	// Whether raygen reorders threads by hits before running closest-hit programs, see RaytraceLaunchParams.
+	bool isShaderExecutionReorderingSupported{false};
 
 private:
 	void initializeStaticOptixStructures();
+	void queryShaderExecutionReordering();
+	void applyProgramCacheConfig();
+
+	struct ProgramCacheConfig
+	{
+		bool isEnabled;
+		std::optional<std::string> location;
+		uint64_t maxSizeBytes;
+	};
+
+	static inline std::mutex programCacheMutex;
+	static inline std::optional<ProgramCacheConfig> programCacheConfig;
+	static inline bool motionBlurEnabled{false};
+	static inline int32_t maxRegisterCount{100};
+	static inline bool isCreated{false};
 };
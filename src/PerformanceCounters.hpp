@@ -0,0 +1,218 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <rgl/api/core.h>
+#include <memory/MemoryKind.hpp>
+
+static_assert(static_cast<int32_t>(MemoryKind::DeviceAsync) == RGL_MEMORY_KIND_DEVICE_ASYNC);
+static_assert(static_cast<int32_t>(MemoryKind::DeviceSync) == RGL_MEMORY_KIND_DEVICE_SYNC);
+static_assert(static_cast<int32_t>(MemoryKind::HostPageable) == RGL_MEMORY_KIND_HOST_PAGEABLE);
+static_assert(static_cast<int32_t>(MemoryKind::HostPinned) == RGL_MEMORY_KIND_HOST_PINNED);
+static_assert(static_cast<int32_t>(MemoryKind::DeviceManaged) == RGL_MEMORY_KIND_DEVICE_MANAGED);
+
+/**
+ * Process-wide, always-on timings of work not attributable to a single node (see rgl_get_performance_counters)
+ * and the interval of sampling per-node timings (see Node::getStats()).
+ * Counters are cumulative, so that telemetry may compute averages over its own reporting period.
+ */
+struct PerformanceCounters
+{
+	/**
+	 * Accumulates the number and the total duration of timed operations.
+	 */
+	struct Counter
+	{
+		void add(std::chrono::steady_clock::duration duration)
+		{
+			count.fetch_add(1, std::memory_order_relaxed);
+			totalNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+			                  std::memory_order_relaxed);
+		}
+
+		uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+		double getTotalMs() const { return static_cast<double>(totalNs.load(std::memory_order_relaxed)) * 1.0e-6; }
+
+	private:
+		std::atomic<uint64_t> count{0};
+		std::atomic<uint64_t> totalNs{0};
+	};
+
+	/**
+	 * Accounting of memory of a MemoryKind allocated through MemoryOperations, see rgl_get_memory_kind_stats.
+	 */
+	struct MemoryKindCounters
+	{
+		void addAllocation(uint64_t bytes)
+		{
+			allocationCount.fetch_add(1, std::memory_order_relaxed);
+			uint64_t newLiveBytes = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+			uint64_t currentPeakBytes = peakBytes.load(std::memory_order_relaxed);
+			while (currentPeakBytes < newLiveBytes &&
+			       !peakBytes.compare_exchange_weak(currentPeakBytes, newLiveBytes, std::memory_order_relaxed)) {}
+		}
+
+		void addDeallocation(uint64_t bytes)
+		{
+			deallocationCount.fetch_add(1, std::memory_order_relaxed);
+			liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+		}
+
+		rgl_memory_kind_stats_t get() const
+		{
+			return {
+			    .live_bytes = liveBytes.load(std::memory_order_relaxed),
+			    .peak_bytes = peakBytes.load(std::memory_order_relaxed),
+			    .allocation_count = allocationCount.load(std::memory_order_relaxed),
+			    .deallocation_count = deallocationCount.load(std::memory_order_relaxed),
+			};
+		}
+
+		std::atomic<uint64_t> liveBytes{0};
+
+	private:
+		std::atomic<uint64_t> peakBytes{0};
+		std::atomic<uint64_t> allocationCount{0};
+		std::atomic<uint64_t> deallocationCount{0};
+	};
+
+	/**
+	 * RAII object adding the CPU time of its scope to the counter.
+	 */
+	struct ScopedTimer
+	{
+		explicit ScopedTimer(Counter& counter) : counter(counter), begin(std::chrono::steady_clock::now()) {}
+		~ScopedTimer() { counter.add(std::chrono::steady_clock::now() - begin); }
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		Counter& counter;
+		std::chrono::steady_clock::time_point begin;
+	};
+
+	static PerformanceCounters& instance()
+	{
+		static PerformanceCounters counters;
+		return counters;
+	}
+
+	/**
+	 * Nodes are timed in every frameInterval-th run of their graph; zero disables sampling.
+	 */
+	void setSamplingInterval(uint32_t frameInterval) { samplingInterval.store(frameInterval, std::memory_order_relaxed); }
+
+	bool isFrameSampled(uint64_t frameId) const
+	{
+		uint32_t interval = samplingInterval.load(std::memory_order_relaxed);
+		return interval > 0 && frameId % interval == 0;
+	}
+
+	/**
+	 * Updates current and maximum size of the queue of calls waiting for the tape writer thread, see TapeRecorder.
+	 */
+	void updateTapeQueueBytes(uint64_t queuedBytes)
+	{
+		tapeQueueBytes.store(queuedBytes, std::memory_order_relaxed);
+		uint64_t peakBytes = tapeQueuePeakBytes.load(std::memory_order_relaxed);
+		while (peakBytes < queuedBytes &&
+		       !tapeQueuePeakBytes.compare_exchange_weak(peakBytes, queuedBytes, std::memory_order_relaxed)) {}
+	}
+
+	/**
+	 * Counts a copy between host or device memories, in the counter of its direction.
+	 */
+	void addTransfer(bool isSrcHost, bool isDstHost, uint64_t bytes)
+	{
+		auto& counter = isSrcHost ? (isDstHost ? hostToHostBytes : hostToDeviceBytes) :
+		                            (isDstHost ? deviceToHostBytes : deviceToDeviceBytes);
+		counter.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	MemoryKindCounters& getMemoryKindCounters(MemoryKind kind) { return memoryKinds.at(static_cast<std::size_t>(kind)); }
+	const MemoryKindCounters& getMemoryKindCounters(MemoryKind kind) const
+	{
+		return memoryKinds.at(static_cast<std::size_t>(kind));
+	}
+
+	rgl_performance_counters_t get() const
+	{
+		return {
+		    .as_build_count = asBuild.getCount(),
+		    .as_build_time_ms = asBuild.getTotalMs(),
+		    .sbt_build_count = sbtBuild.getCount(),
+		    .sbt_build_time_ms = sbtBuild.getTotalMs(),
+		    .result_copy_count = resultCopy.getCount(),
+		    .result_copy_time_ms = resultCopy.getTotalMs(),
+		    .sampled_node_run_count = sampledNodeRunCount.load(std::memory_order_relaxed),
+		    .tape_stall_count = tapeStall.getCount(),
+		    .tape_stall_time_ms = tapeStall.getTotalMs(),
+		    .tape_queue_peak_bytes = tapeQueuePeakBytes.load(std::memory_order_relaxed),
+		    .array_allocation_count = arrayAllocationCount.load(std::memory_order_relaxed),
+		    .raytrace_cache_hit_count = raytraceCacheHitCount.load(std::memory_order_relaxed),
+		    .traced_ray_count = tracedRayCount.load(std::memory_order_relaxed),
+		    .gas_build_count = gasBuildCount.load(std::memory_order_relaxed),
+		    .ias_build_count = iasBuildCount.load(std::memory_order_relaxed),
+		    .ias_refit_count = iasRefitCount.load(std::memory_order_relaxed),
+		    .host_to_device_bytes = hostToDeviceBytes.load(std::memory_order_relaxed),
+		    .device_to_host_bytes = deviceToHostBytes.load(std::memory_order_relaxed),
+		    .device_array_bytes = getLiveBytes(MemoryKind::DeviceAsync) + getLiveBytes(MemoryKind::DeviceSync) +
+		                          getLiveBytes(MemoryKind::DeviceManaged),
+		    .host_pinned_array_bytes = getLiveBytes(MemoryKind::HostPinned),
+		    .tape_queue_bytes = tapeQueueBytes.load(std::memory_order_relaxed),
+		    .host_to_host_bytes = hostToHostBytes.load(std::memory_order_relaxed),
+		    .device_to_device_bytes = deviceToDeviceBytes.load(std::memory_order_relaxed),
+		    .synchronize_all_count = synchronizeAll.getCount(),
+		    .synchronize_all_time_ms = synchronizeAll.getTotalMs(),
+		};
+	}
+
+	Counter asBuild;        // Builds and refits of the scene's acceleration structures
+	Counter sbtBuild;       // Builds of the scene's shader binding table
+	Counter resultCopy;     // Calls to rgl_graph_get_result_data
+	Counter tapeStall;      // Waits of recorded API calls for the tape writer thread
+	Counter synchronizeAll; // Waits for all graphs, e.g. before modifying a mesh, see GraphRunCtx::synchronizeAll
+	std::atomic<uint64_t> sampledNodeRunCount{0};
+	std::atomic<uint64_t> tapeQueuePeakBytes{0};
+	std::atomic<uint64_t> arrayAllocationCount{0}; // Allocations of Arrays' memory, see Array::reallocate
+	std::atomic<uint64_t> raytraceCacheHitCount{0}; // Runs of RaytraceNodes skipped, see RaytraceNode::isResultCacheHit
+	std::atomic<uint64_t> tracedRayCount{0};        // Rays (times returns) of OptiX launches of RaytraceNodes
+	std::atomic<uint64_t> gasBuildCount{0};         // Builds and updates of meshes' GASes
+	std::atomic<uint64_t> iasBuildCount{0};         // Builds of scenes' IASes
+	std::atomic<uint64_t> iasRefitCount{0};         // Refits of scenes' IASes
+	std::atomic<uint64_t> hostToDeviceBytes{0};     // See addTransfer
+	std::atomic<uint64_t> deviceToHostBytes{0};
+	std::atomic<uint64_t> hostToHostBytes{0};
+	std::atomic<uint64_t> deviceToDeviceBytes{0};
+	std::atomic<uint64_t> tapeQueueBytes{0};        // Recorded data currently pending to be written to the tape
+
+private:
+	PerformanceCounters() = default;
+
+	uint64_t getLiveBytes(MemoryKind kind) const
+	{
+		return getMemoryKindCounters(kind).liveBytes.load(std::memory_order_relaxed);
+	}
+
+	std::array<MemoryKindCounters, MEMORY_KIND_COUNT> memoryKinds;
+
+	std::atomic<uint32_t> samplingInterval{0};
+};
@@ -56,6 +56,13 @@ typedef unsigned char TextureTexelFormat;
 #define NORMAL_VEC3_F32 RGL_FIELD_NORMAL_VEC3_F32
 #define INCIDENT_ANGLE_F32 RGL_FIELD_INCIDENT_ANGLE_F32
 #define RAY_POSE_MAT3x4_F32 RGL_FIELD_RAY_POSE_MAT3x4_F32
+#define CLASS_ID_U16 RGL_FIELD_CLASS_ID_U16
+#define XYZ_VEC3_F16 RGL_FIELD_XYZ_VEC3_F16
+#define DISTANCE_F16 RGL_FIELD_DISTANCE_F16
+#define NORMAL_VEC3_F16 RGL_FIELD_NORMAL_VEC3_F16
+#define XYZ_VEC3_I16 RGL_FIELD_XYZ_VEC3_I16
+#define CURVATURE_F32 RGL_FIELD_CURVATURE_F32
+#define CLUSTER_ID_I32 RGL_FIELD_CLUSTER_ID_I32
 #define PADDING_8 RGL_FIELD_PADDING_8
 #define PADDING_16 RGL_FIELD_PADDING_16
 #define PADDING_32 RGL_FIELD_PADDING_32
@@ -85,6 +92,13 @@ inline const std::set<rgl_field_t>& getAllRealFields()
 	    NORMAL_VEC3_F32,
 	    INCIDENT_ANGLE_F32,
 	    RAY_POSE_MAT3x4_F32,
+	    CLASS_ID_U16,
+	    XYZ_VEC3_F16,
+	    DISTANCE_F16,
+	    NORMAL_VEC3_F16,
+	    XYZ_VEC3_I16,
+	    CURVATURE_F32,
+	    CLUSTER_ID_I32,
 	};
 	return allRealFields;
 }
@@ -136,6 +150,13 @@ FIELD(SNR_F32, float);
 FIELD(NORMAL_VEC3_F32, Vec3f);
 FIELD(INCIDENT_ANGLE_F32, float);
 FIELD(RAY_POSE_MAT3x4_F32, Mat3x4f);
+FIELD(CLASS_ID_U16, uint16_t);
+FIELD(XYZ_VEC3_F16, Vec3u16);   // Bits of __half
+FIELD(DISTANCE_F16, uint16_t);  // Bits of __half
+FIELD(NORMAL_VEC3_F16, Vec3u16); // Bits of __half
+FIELD(XYZ_VEC3_I16, Vec3i16);
+FIELD(CURVATURE_F32, float);
+FIELD(CLUSTER_ID_I32, int32_t);
 
 inline std::size_t getFieldSize(rgl_field_t type)
 {
@@ -162,6 +183,13 @@ inline std::size_t getFieldSize(rgl_field_t type)
 		case NORMAL_VEC3_F32: return Field<NORMAL_VEC3_F32>::size;
 		case INCIDENT_ANGLE_F32: return Field<INCIDENT_ANGLE_F32>::size;
 		case RAY_POSE_MAT3x4_F32: return Field<RAY_POSE_MAT3x4_F32>::size;
+		case CLASS_ID_U16: return Field<CLASS_ID_U16>::size;
+		case XYZ_VEC3_F16: return Field<XYZ_VEC3_F16>::size;
+		case DISTANCE_F16: return Field<DISTANCE_F16>::size;
+		case NORMAL_VEC3_F16: return Field<NORMAL_VEC3_F16>::size;
+		case XYZ_VEC3_I16: return Field<XYZ_VEC3_I16>::size;
+		case CURVATURE_F32: return Field<CURVATURE_F32>::size;
+		case CLUSTER_ID_I32: return Field<CLUSTER_ID_I32>::size;
 		case PADDING_8: return Field<PADDING_8>::size;
 		case PADDING_16: return Field<PADDING_16>::size;
 		case PADDING_32: return Field<PADDING_32>::size;
@@ -188,6 +216,16 @@ inline bool isDummy(rgl_field_t type)
 	return dummies.find(type) != dummies.end();
 }
 
+// Fields holding a single number per point, which can be compared with a value (see rgl_field_predicate_t).
+inline bool isScalar(rgl_field_t type)
+{
+	static std::set<rgl_field_t> nonScalars = {
+	    XYZ_VEC3_F32, ABSOLUTE_VELOCITY_VEC3_F32, RELATIVE_VELOCITY_VEC3_F32, NORMAL_VEC3_F32, RAY_POSE_MAT3x4_F32,
+	    XYZ_VEC3_F16, NORMAL_VEC3_F16, XYZ_VEC3_I16,
+	};
+	return getAllRealFields().contains(type) && !nonScalars.contains(type);
+}
+
 // This header is included by nvcc (GPU-side compiler) which fails to compile IAnyArray and subclasses.
 // Therefore, we use forward declaration and shared_ptr<IAnyArray> instead of IAnyArray::Ptr
 struct IAnyArray;
@@ -222,6 +260,13 @@ inline std::shared_ptr<IAnyArray> createArray(rgl_field_t type, Args&&... args)
 		case NORMAL_VEC3_F32: return Subclass<Field<NORMAL_VEC3_F32>::type>::create(std::forward<Args>(args)...);
 		case INCIDENT_ANGLE_F32: return Subclass<Field<INCIDENT_ANGLE_F32>::type>::create(std::forward<Args>(args)...);
 		case RAY_POSE_MAT3x4_F32: return Subclass<Field<RAY_POSE_MAT3x4_F32>::type>::create(std::forward<Args>(args)...);
+		case CLASS_ID_U16: return Subclass<Field<CLASS_ID_U16>::type>::create(std::forward<Args>(args)...);
+		case XYZ_VEC3_F16: return Subclass<Field<XYZ_VEC3_F16>::type>::create(std::forward<Args>(args)...);
+		case DISTANCE_F16: return Subclass<Field<DISTANCE_F16>::type>::create(std::forward<Args>(args)...);
+		case NORMAL_VEC3_F16: return Subclass<Field<NORMAL_VEC3_F16>::type>::create(std::forward<Args>(args)...);
+		case XYZ_VEC3_I16: return Subclass<Field<XYZ_VEC3_I16>::type>::create(std::forward<Args>(args)...);
+		case CURVATURE_F32: return Subclass<Field<CURVATURE_F32>::type>::create(std::forward<Args>(args)...);
+		case CLUSTER_ID_I32: return Subclass<Field<CLUSTER_ID_I32>::type>::create(std::forward<Args>(args)...);
 	}
 	throw std::invalid_argument(fmt::format("createArray: unknown RGL field {}", type));
 }
@@ -251,6 +296,13 @@ inline std::string toString(rgl_field_t type)
 		case NORMAL_VEC3_F32: return "NORMAL_VEC3_F32";
 		case INCIDENT_ANGLE_F32: return "INCIDENT_ANGLE_F32";
 		case RAY_POSE_MAT3x4_F32: return "RAY_POSE_MAT3x4_F32";
+		case CLASS_ID_U16: return "CLASS_ID_U16";
+		case XYZ_VEC3_F16: return "XYZ_VEC3_F16";
+		case DISTANCE_F16: return "DISTANCE_F16";
+		case NORMAL_VEC3_F16: return "NORMAL_VEC3_F16";
+		case XYZ_VEC3_I16: return "XYZ_VEC3_I16";
+		case CURVATURE_F32: return "CURVATURE_F32";
+		case CLUSTER_ID_I32: return "CLUSTER_ID_I32";
 		case PADDING_8: return "PADDING_8";
 		case PADDING_16: return "PADDING_16";
 		case PADDING_32: return "PADDING_32";
@@ -258,6 +310,72 @@ inline std::string toString(rgl_field_t type)
 	}
 }
 
+// Names of scalar components of the field (e.g. x, y, z), as used in point cloud file formats and ROS2 messages.
+// Dummy fields have no components.
+inline std::vector<std::string> getFieldComponentNames(rgl_field_t type)
+{
+	switch (type) {
+		case XYZ_VEC3_F32: return {"x", "y", "z"};
+		case IS_HIT_I32: return {"is_hit"};
+		case IS_GROUND_I32: return {"is_ground"};
+		case ENTITY_ID_I32: return {"entity_id"};
+		case RAY_IDX_U32: return {"ray_idx"};
+		case INTENSITY_F32: return {"intensity"};
+		case RING_ID_U16: return {"ring"};
+		case AZIMUTH_F32: return {"azimuth"};
+		case ELEVATION_F32: return {"elevation"};
+		case DISTANCE_F32: return {"distance"};
+		case RETURN_TYPE_U8: return {"return_type"};
+		case TIME_STAMP_F64: return {"time_stamp"};
+		case ABSOLUTE_VELOCITY_VEC3_F32: return {"abs_vx", "abs_vy", "abs_vz"};
+		case RELATIVE_VELOCITY_VEC3_F32: return {"rel_vx", "rel_vy", "rel_vz"};
+		case RADIAL_SPEED_F32: return {"radial_speed"};
+		case POWER_F32: return {"power"};
+		case RCS_F32: return {"rcs"};
+		case NOISE_F32: return {"noise"};
+		case SNR_F32: return {"snr"};
+		case NORMAL_VEC3_F32: return {"nx", "ny", "nz"};
+		case INCIDENT_ANGLE_F32: return {"incident_angle"};
+		case RAY_POSE_MAT3x4_F32: return {"m00", "m01", "m02", "m03", "m10", "m11", "m12", "m13", "m20", "m21", "m22", "m23"};
+		case CLASS_ID_U16: return {"class_id"};
+		case XYZ_VEC3_F16: return {"x", "y", "z"};
+		case DISTANCE_F16: return {"distance"};
+		case NORMAL_VEC3_F16: return {"nx", "ny", "nz"};
+		case XYZ_VEC3_I16: return {"x", "y", "z"};
+		case CURVATURE_F32: return {"curvature"};
+		case CLUSTER_ID_I32: return {"cluster_id"};
+		case PADDING_8: return {};
+		case PADDING_16: return {};
+		case PADDING_32: return {};
+	}
+	throw std::invalid_argument(fmt::format("getFieldComponentNames: unknown RGL field {}", type));
+}
+
+// Kind of scalar components of the field: 'F' (floating point), 'I' (signed) or 'U' (unsigned integer), as in PCD files.
+// All components of a field have the same kind and size. Half-precision floats are not supported by the file formats,
+// so their bits are reported as unsigned integers.
+inline char getFieldComponentKind(rgl_field_t type)
+{
+	switch (type) {
+		case IS_HIT_I32:
+		case IS_GROUND_I32:
+		case ENTITY_ID_I32:
+		case CLUSTER_ID_I32:
+		case XYZ_VEC3_I16: return 'I';
+		case XYZ_VEC3_F16:
+		case DISTANCE_F16:
+		case NORMAL_VEC3_F16:
+		case RAY_IDX_U32:
+		case RING_ID_U16:
+		case RETURN_TYPE_U8:
+		case CLASS_ID_U16:
+		case PADDING_8:
+		case PADDING_16:
+		case PADDING_32: return 'U';
+		default: return 'F';
+	}
+}
+
 #if RGL_BUILD_ROS2_EXTENSION
 #include <sensor_msgs/msg/point_cloud2.hpp>
 
@@ -302,6 +420,20 @@ inline std::vector<uint8_t> toRos2Fields(rgl_field_t type)
 			    sensor_msgs::msg::PointField::FLOAT32, sensor_msgs::msg::PointField::FLOAT32,
 			    sensor_msgs::msg::PointField::FLOAT32, sensor_msgs::msg::PointField::FLOAT32,
 			};
+		case CLASS_ID_U16: return {sensor_msgs::msg::PointField::UINT16};
+		// PointField has no half-precision type, bits are published as UINT16.
+		case XYZ_VEC3_F16:
+			return {sensor_msgs::msg::PointField::UINT16, sensor_msgs::msg::PointField::UINT16,
+			        sensor_msgs::msg::PointField::UINT16};
+		case DISTANCE_F16: return {sensor_msgs::msg::PointField::UINT16};
+		case NORMAL_VEC3_F16:
+			return {sensor_msgs::msg::PointField::UINT16, sensor_msgs::msg::PointField::UINT16,
+			        sensor_msgs::msg::PointField::UINT16};
+		case XYZ_VEC3_I16:
+			return {sensor_msgs::msg::PointField::INT16, sensor_msgs::msg::PointField::INT16,
+			        sensor_msgs::msg::PointField::INT16};
+		case CURVATURE_F32: return {sensor_msgs::msg::PointField::FLOAT32};
+		case CLUSTER_ID_I32: return {sensor_msgs::msg::PointField::INT32};
 		case PADDING_8: return {};
 		case PADDING_16: return {};
 		case PADDING_32: return {};
@@ -309,37 +441,7 @@ inline std::vector<uint8_t> toRos2Fields(rgl_field_t type)
 	throw std::invalid_argument(fmt::format("toRos2Fields: unknown RGL field {}", type));
 }
 
-inline std::vector<std::string> toRos2Names(rgl_field_t type)
-{
-	switch (type) {
-		case XYZ_VEC3_F32: return {"x", "y", "z"};
-		case IS_HIT_I32: return {"is_hit"};
-		case IS_GROUND_I32: return {"is_ground"};
-		case ENTITY_ID_I32: return {"entity_id"};
-		case RAY_IDX_U32: return {"ray_idx"};
-		case INTENSITY_F32: return {"intensity"};
-		case RING_ID_U16: return {"ring"};
-		case AZIMUTH_F32: return {"azimuth"};
-		case ELEVATION_F32: return {"elevation"};
-		case DISTANCE_F32: return {"distance"};
-		case RETURN_TYPE_U8: return {"return_type"};
-		case TIME_STAMP_F64: return {"time_stamp"};
-		case ABSOLUTE_VELOCITY_VEC3_F32: return {"abs_vx", "abs_vy", "abs_vz"};
-		case RELATIVE_VELOCITY_VEC3_F32: return {"rel_vx", "rel_vy", "rel_vz"};
-		case RADIAL_SPEED_F32: return {"radial_speed"};
-		case POWER_F32: return {"power"};
-		case RCS_F32: return {"rcs"};
-		case NOISE_F32: return {"noise"};
-		case SNR_F32: return {"snr"};
-		case NORMAL_VEC3_F32: return {"nx", "ny", "nz"};
-		case INCIDENT_ANGLE_F32: return {"incident_angle"};
-		case RAY_POSE_MAT3x4_F32: return {"m00", "m01", "m02", "m03", "m10", "m11", "m12", "m13", "m20", "m21", "m22", "m23"};
-		case PADDING_8: return {};
-		case PADDING_16: return {};
-		case PADDING_32: return {};
-	}
-	throw std::invalid_argument(fmt::format("toRos2Names: unknown RGL field {}", type));
-}
+inline std::vector<std::string> toRos2Names(rgl_field_t type) { return getFieldComponentNames(type); }
 
 inline std::vector<std::size_t> toRos2Sizes(rgl_field_t type)
 {
@@ -349,6 +451,9 @@ inline std::vector<std::size_t> toRos2Sizes(rgl_field_t type)
 		case ABSOLUTE_VELOCITY_VEC3_F32: return {sizeof(float), sizeof(float), sizeof(float)};
 		case RELATIVE_VELOCITY_VEC3_F32: return {sizeof(float), sizeof(float), sizeof(float)};
 		case NORMAL_VEC3_F32: return {sizeof(float), sizeof(float), sizeof(float)};
+		case XYZ_VEC3_F16: return {sizeof(uint16_t), sizeof(uint16_t), sizeof(uint16_t)};
+		case NORMAL_VEC3_F16: return {sizeof(uint16_t), sizeof(uint16_t), sizeof(uint16_t)};
+		case XYZ_VEC3_I16: return {sizeof(int16_t), sizeof(int16_t), sizeof(int16_t)};
 		case RAY_POSE_MAT3x4_F32:
 			return {
 			    sizeof(float), sizeof(float), sizeof(float), sizeof(float), sizeof(float), sizeof(float),
@@ -73,6 +73,19 @@ struct StreamBoundObjectsManager
 		currentStream = newStream;
 	}
 
+	/**
+	 * Calls the function for each registered object that still exists.
+	 */
+	template<typename Func>
+	void forEachObject(Func&& func) const
+	{
+		for (auto&& objectWeakPtr : streamBoundObjects) {
+			if (auto objectSharedPtr = objectWeakPtr.lock()) {
+				func(objectSharedPtr);
+			}
+		}
+	}
+
 	CudaStream::Ptr getStream()
 	{
 		if (auto ptr = currentStream.lock()) {
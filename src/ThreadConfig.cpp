@@ -0,0 +1,151 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif // _WIN32
+
+#include <spdlog/fmt/fmt.h>
+
+#include <ThreadConfig.hpp>
+#include <CudaDevice.hpp>
+#include <Logger.hpp>
+#include <RGLExceptions.hpp>
+
+#ifndef _WIN32
+// Affinity of the thread loading RGL, normally inherited from the process.
+static const cpu_set_t initialAffinity = []() {
+	cpu_set_t cpuSet;
+	if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+		CPU_ZERO(&cpuSet);
+		for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+			CPU_SET(cpu, &cpuSet);
+		}
+	}
+	return cpuSet;
+}();
+#endif // _WIN32
+
+// Parses CPU list in the format of sysfs, e.g. "0-15,32-47".
+static std::vector<int32_t> parseCpuList(const std::string& text)
+{
+	std::vector<int32_t> cpus;
+	std::stringstream ranges{text};
+	std::string range;
+	while (std::getline(ranges, range, ',')) {
+		if (range.empty() || !std::isdigit(static_cast<unsigned char>(range.front()))) {
+			continue;
+		}
+		auto dashPos = range.find('-');
+		int32_t first = std::stoi(range.substr(0, dashPos));
+		int32_t last = dashPos == std::string::npos ? first : std::stoi(range.substr(dashPos + 1));
+		for (int32_t cpu = first; cpu <= last; ++cpu) {
+			cpus.push_back(cpu);
+		}
+	}
+	return cpus;
+}
+
+// Returns CPUs of the NUMA node the selected GPU is attached to, or an empty set if it is not known (e.g. single node).
+static std::vector<int32_t> getGpuNumaNodeCpus()
+{
+	char pciBusId[32] = {};
+	CHECK_CUDA(cudaDeviceGetPCIBusId(pciBusId, sizeof(pciBusId), CudaDevice::getSelected()));
+	std::string busId{pciBusId};
+	std::ranges::transform(busId, busId.begin(), [](unsigned char c) { return std::tolower(c); });
+	int32_t numaNode = -1;
+	std::ifstream{fmt::format("/sys/bus/pci/devices/{}/numa_node", busId)} >> numaNode;
+	if (numaNode < 0) {
+		RGL_DEBUG("NUMA node of GPU {} is not known", busId);
+		return {};
+	}
+	std::string cpuList;
+	std::ifstream{fmt::format("/sys/devices/system/node/node{}/cpulist", numaNode)} >> cpuList;
+	RGL_DEBUG("GPU {} is attached to NUMA node {} with CPUs {}", busId, numaNode, cpuList);
+	return parseCpuList(cpuList);
+}
+
+ThreadConfig::ScopedThread::ScopedThread(ThreadRole role, const std::string& name) : role(role), nativeHandle(0)
+{
+#ifndef _WIN32
+	nativeHandle = static_cast<uint64_t>(pthread_self());
+	// Linux limits names to 15 characters.
+	pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#endif // _WIN32
+	std::lock_guard lock{mutex};
+	threads.insert(this);
+	try {
+		apply(*this, getCpus(role));
+	}
+	catch (std::exception& e) {
+		RGL_WARN("Cannot set affinity of thread {}: {}", name, e.what());
+	}
+}
+
+ThreadConfig::ScopedThread::~ScopedThread()
+{
+	std::lock_guard lock{mutex};
+	threads.erase(this);
+}
+
+void ThreadConfig::configure(std::vector<int32_t> graphWorkerCpusToSet, std::vector<int32_t> ioCpusToSet,
+                             bool preferGpuNumaNode)
+{
+#ifdef _WIN32
+	if (!graphWorkerCpusToSet.empty() || !ioCpusToSet.empty() || preferGpuNumaNode) {
+		throw InvalidAPIArgument("thread affinity is not supported on Windows");
+	}
+#endif // _WIN32
+	auto numaNodeCpus = preferGpuNumaNode ? getGpuNumaNodeCpus() : std::vector<int32_t>{};
+	std::lock_guard lock{mutex};
+	graphWorkerCpus = std::move(graphWorkerCpusToSet);
+	ioCpus = std::move(ioCpusToSet);
+	gpuNumaNodeCpus = std::move(numaNodeCpus);
+	for (auto&& thread : threads) {
+		apply(*thread, getCpus(thread->role));
+	}
+}
+
+std::vector<int32_t> ThreadConfig::getCpus(ThreadRole role)
+{
+	const auto& roleCpus = role == ThreadRole::GraphWorker ? graphWorkerCpus : ioCpus;
+	return roleCpus.empty() ? gpuNumaNodeCpus : roleCpus;
+}
+
+void ThreadConfig::apply(const ScopedThread& thread, const std::vector<int32_t>& cpus)
+{
+#ifndef _WIN32
+	// No restriction means CPUs the process was allowed to run on when RGL was loaded.
+	cpu_set_t cpuSet = initialAffinity;
+	if (!cpus.empty()) {
+		CPU_ZERO(&cpuSet);
+	}
+	for (auto&& cpu : cpus) {
+		if (cpu < CPU_SETSIZE) {
+			CPU_SET(cpu, &cpuSet);
+		}
+	}
+	int error = pthread_setaffinity_np(static_cast<pthread_t>(thread.nativeHandle), sizeof(cpuSet), &cpuSet);
+	if (error != 0) {
+		throw InvalidAPIArgument(fmt::format("cannot set affinity to {} CPUs: {}", cpus.size(), std::strerror(error)));
+	}
+#endif // _WIN32
+}
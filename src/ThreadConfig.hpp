@@ -0,0 +1,71 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+enum class ThreadRole
+{
+	GraphWorker, // Graph scheduler and host compute workers
+	Io,          // Writing files and tapes, streaming meshes, publishing, visualization
+};
+
+/**
+ * Process-wide names and CPU affinities of threads started by RGL, see rgl_configure_threads.
+ * Each thread registers itself for its lifetime (see ScopedThread), so that reconfiguration applies to running threads.
+ * State is kept in static members (as in CudaDevice), which outlive singletons owning the threads.
+ */
+struct ThreadConfig
+{
+	static constexpr int32_t MAX_CPU_COUNT = 1024; // As in Linux' default cpu_set_t
+
+	/**
+	 * Registers the calling thread: names it (visible in profilers and debuggers) and applies the affinity of its role.
+	 * Created at the beginning of the thread's main function.
+	 */
+	struct ScopedThread
+	{
+		ScopedThread(ThreadRole role, const std::string& name);
+		~ScopedThread();
+
+		ScopedThread(const ScopedThread&) = delete;
+		ScopedThread& operator=(const ScopedThread&) = delete;
+
+	private:
+		friend struct ThreadConfig;
+		ThreadRole role;
+		uint64_t nativeHandle;
+	};
+
+	/**
+	 * Sets CPUs of threads of each role; an empty set allows all CPUs, or CPUs of the GPU's NUMA node if preferred.
+	 * Throws if the affinity cannot be applied (e.g. none of the given CPUs is online).
+	 */
+	static void configure(std::vector<int32_t> graphWorkerCpus, std::vector<int32_t> ioCpus, bool preferGpuNumaNode);
+
+private:
+	static std::vector<int32_t> getCpus(ThreadRole role);
+	static void apply(const ScopedThread& thread, const std::vector<int32_t>& cpus);
+
+	static inline std::mutex mutex;
+	static inline std::unordered_set<const ScopedThread*> threads;
+	static inline std::vector<int32_t> graphWorkerCpus;
+	static inline std::vector<int32_t> ioCpus;
+	static inline std::vector<int32_t> gpuNumaNodeCpus; // Empty if not preferred or not known
+};
@@ -0,0 +1,170 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <TraceRecorder.hpp>
+#include <NvtxWrappers.hpp>
+#include <RGLExceptions.hpp>
+
+// Trace viewers group events by (pid, tid); GPU ranges are shown as a separate process, on tracks of enqueuing threads.
+static constexpr int CPU_TRACE_PID = 1;
+static constexpr int GPU_TRACE_PID = 2;
+
+static std::string escapeJson(const std::string& text)
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+	for (char c : text) {
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+			escaped += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20) {
+			escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+		}
+		else {
+			escaped += c;
+		}
+	}
+	return escaped;
+}
+
+static std::string getCategoryName(TraceRecorder::Category category)
+{
+	return category == NVTX_CAT_API ? "api" : fmt::format("graph{}", category);
+}
+
+void TraceRecorder::start(std::size_t maxEvents)
+{
+	std::lock_guard lock{mutex};
+	if (isRecording()) {
+		throw InvalidAPIArgument("trace is already being recorded");
+	}
+	maxEventsPerThread = maxEvents;
+	if (gpuReference == nullptr) {
+		gpuReference = CudaEvent::create(cudaEventDefault);
+	}
+	CHECK_CUDA(cudaEventRecord(gpuReference->getHandle(), nullptr));
+	CHECK_CUDA(cudaEventSynchronize(gpuReference->getHandle()));
+	hostReference = Clock::now();
+	sessionBegin = hostReference;
+	sessionId.fetch_add(1, std::memory_order_relaxed);
+	recording.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop(const std::filesystem::path& path)
+{
+	std::lock_guard lock{mutex};
+	if (!isRecording()) {
+		throw InvalidAPIArgument("trace is not being recorded");
+	}
+	recording.store(false, std::memory_order_relaxed);
+	// Threads still holding buffers of this session register new ones in the next session.
+	auto buffers = std::move(threadBuffers);
+	threadBuffers.clear();
+	write(path, buffers);
+}
+
+void TraceRecorder::addCpuRange(std::string name, Category category, Clock::time_point begin, Clock::time_point end)
+{
+	addEvent({.name = std::move(name), .category = category, .begin = begin, .end = end});
+}
+
+void TraceRecorder::addGpuRange(std::string name, Category category, CudaEvent::Ptr begin, CudaEvent::Ptr end)
+{
+	addEvent({.name = std::move(name), .category = category, .gpuBegin = std::move(begin), .gpuEnd = std::move(end)});
+}
+
+void TraceRecorder::addEvent(Event&& event)
+{
+	ThreadBuffer* buffer = getThreadBuffer();
+	if (buffer == nullptr) {
+		return; // Stopped in the meantime
+	}
+	// Only the owning thread writes, so the count is modified without contention.
+	std::size_t idx = buffer->count.load(std::memory_order_relaxed);
+	if (idx >= buffer->events.size()) {
+		buffer->droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	buffer->events[idx] = std::move(event);
+	buffer->count.store(idx + 1, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::getThreadBuffer()
+{
+	static std::atomic<uint64_t> threadCount{0};
+	thread_local uint64_t threadId = threadCount.fetch_add(1, std::memory_order_relaxed) + 1;
+	thread_local std::shared_ptr<ThreadBuffer> buffer;
+	if (buffer != nullptr && buffer->sessionId == sessionId.load(std::memory_order_relaxed)) [[likely]] {
+		return buffer.get();
+	}
+	// Once per thread and session.
+	std::lock_guard lock{mutex};
+	if (!isRecording()) {
+		return nullptr;
+	}
+	buffer = std::make_shared<ThreadBuffer>();
+	buffer->sessionId = sessionId.load(std::memory_order_relaxed);
+	buffer->threadId = threadId;
+	buffer->events.resize(maxEventsPerThread);
+	threadBuffers.emplace_back(buffer);
+	return buffer.get();
+}
+
+void TraceRecorder::write(const std::filesystem::path& path, const std::vector<std::shared_ptr<ThreadBuffer>>& buffers)
+{
+	std::FILE* file = std::fopen(path.string().c_str(), "w");
+	if (file == nullptr) {
+		throw InvalidFilePath(fmt::format("cannot open trace file: {}", path.string()));
+	}
+	auto toUs = [this](Clock::time_point time) {
+		return std::chrono::duration<double, std::micro>(time - sessionBegin).count();
+	};
+	fmt::print(file, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fmt::print(file, "{{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":{},\"args\":{{\"name\":\"RGL CPU\"}}}},\n",
+	           CPU_TRACE_PID);
+	fmt::print(file, "{{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":{},\"args\":{{\"name\":\"RGL GPU\"}}}}", GPU_TRACE_PID);
+	uint64_t droppedCount = 0;
+	for (auto&& buffer : buffers) {
+		droppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+		std::size_t count = buffer->count.load(std::memory_order_acquire);
+		for (std::size_t i = 0; i < count; ++i) {
+			Event& event = buffer->events[i];
+			int pid = CPU_TRACE_PID;
+			if (event.gpuBegin != nullptr) {
+				// Events of failed runs may have never been recorded, such ranges are skipped.
+				float beginMs = 0.0f, endMs = 0.0f;
+				if (cudaEventSynchronize(event.gpuEnd->getHandle()) != cudaSuccess ||
+				    cudaEventElapsedTime(&beginMs, gpuReference->getHandle(), event.gpuBegin->getHandle()) != cudaSuccess ||
+				    cudaEventElapsedTime(&endMs, gpuReference->getHandle(), event.gpuEnd->getHandle()) != cudaSuccess) {
+					cudaGetLastError(); // Clears the error
+					continue;
+				}
+				using FloatMs = std::chrono::duration<float, std::milli>;
+				event.begin = hostReference + std::chrono::duration_cast<Clock::duration>(FloatMs(beginMs));
+				event.end = hostReference + std::chrono::duration_cast<Clock::duration>(FloatMs(endMs));
+				pid = GPU_TRACE_PID;
+			}
+			fmt::print(file, ",\n{{\"ph\":\"X\",\"name\":\"{}\",\"cat\":\"{}\",\"pid\":{},\"tid\":{},",
+			           escapeJson(event.name), getCategoryName(event.category), pid, buffer->threadId);
+			fmt::print(file, "\"ts\":{:.3f},\"dur\":{:.3f}}}", toUs(event.begin), toUs(event.end) - toUs(event.begin));
+		}
+	}
+	fmt::print(file, "\n],\"otherData\":{{\"dropped_event_count\":{}}}}}\n", droppedCount);
+	std::fclose(file);
+}
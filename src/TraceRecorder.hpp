@@ -0,0 +1,101 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <CudaEvent.hpp>
+
+/**
+ * In-process recorder of the ranges marked for profilers (see NvtxRange) and of GPU execution of nodes,
+ * written as a Chrome trace (JSON Trace Event Format, opened by chrome://tracing and Perfetto UI), see rgl_trace_start.
+ * Each thread appends to its own preallocated buffer without locking; events beyond its capacity are dropped.
+ */
+struct TraceRecorder
+{
+	/**
+	 * Category of a range: NVTX_CAT_API or graphOrdinal (see NvtxWrappers.hpp).
+	 */
+	using Category = uint32_t;
+	using Clock = std::chrono::steady_clock;
+
+	static TraceRecorder& instance()
+	{
+		static TraceRecorder recorder;
+		return recorder;
+	}
+
+	bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+
+	/**
+	 * Starts recording, with room for maxEventsPerThread events in each thread's buffer.
+	 */
+	void start(std::size_t maxEventsPerThread);
+
+	/**
+	 * Stops recording and writes recorded events. Waits for GPU ranges to complete.
+	 */
+	void stop(const std::filesystem::path& path);
+
+	void addCpuRange(std::string name, Category category, Clock::time_point begin, Clock::time_point end);
+
+	/**
+	 * Adds a range of GPU work between two events, which must be (or will be) recorded with timing enabled.
+	 */
+	void addGpuRange(std::string name, Category category, CudaEvent::Ptr begin, CudaEvent::Ptr end);
+
+private:
+	struct Event
+	{
+		std::string name;
+		Category category;
+		Clock::time_point begin;
+		Clock::time_point end;
+		CudaEvent::Ptr gpuBegin; // Null for CPU ranges
+		CudaEvent::Ptr gpuEnd;
+	};
+
+	struct ThreadBuffer
+	{
+		uint64_t sessionId;
+		uint64_t threadId;
+		std::vector<Event> events;
+		std::atomic<std::size_t> count{0}; // Published with release, after the event is written
+		std::atomic<uint64_t> droppedCount{0};
+	};
+
+	TraceRecorder() = default;
+	void addEvent(Event&& event);
+	ThreadBuffer* getThreadBuffer();
+	void write(const std::filesystem::path& path, const std::vector<std::shared_ptr<ThreadBuffer>>& buffers);
+
+	std::atomic<bool> recording{false};
+	std::atomic<uint64_t> sessionId{0};
+	std::size_t maxEventsPerThread{0};
+
+	// Guards registration of buffers and the session (start / stop); not taken when appending events.
+	std::mutex mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+	CudaEvent::Ptr gpuReference; // Recorded on start, GPU timestamps are relative to it
+	Clock::time_point hostReference;
+	Clock::time_point sessionBegin;
+};
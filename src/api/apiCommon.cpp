@@ -14,8 +14,9 @@
 
 #include <api/apiCommon.hpp>
 
-rgl_status_t lastStatusCode = RGL_SUCCESS;
-std::optional<std::string> lastStatusString = std::nullopt;
+thread_local rgl_status_t lastStatusCode = RGL_SUCCESS;
+thread_local std::optional<std::string> lastStatusString = std::nullopt;
+std::atomic<rgl_status_t> unrecoverableStatusCode = RGL_SUCCESS;
 
 static bool isCompiledWithAutoTape() { return !std::string(RGL_AUTO_TAPE_PATH).empty(); }
 
@@ -60,6 +61,9 @@ rgl_status_t updateAPIState(rgl_status_t status, std::optional<std::string> auxE
 		if (canContinueAfterStatus(lastStatusCode)) {
 			RGL_ERROR("Recoverable error (code={}): {}", lastStatusCode, msg);
 		} else {
+			// The first unrecoverable error is kept, e.g. to know that logging does not work.
+			rgl_status_t expected = RGL_SUCCESS;
+			unrecoverableStatusCode.compare_exchange_strong(expected, status);
 			RGL_CRITICAL("Unrecoverable error (code={}): {}", lastStatusCode, msg);
 		}
 		Logger::getOrCreate().flush();
@@ -69,14 +73,21 @@ rgl_status_t updateAPIState(rgl_status_t status, std::optional<std::string> auxE
 
 void rglLazyInit()
 {
+	static std::atomic<bool> initDone = false;
+	if (initDone.load(std::memory_order::acquire)) {
+		return;
+	}
+	// Other client's threads wait for the initialization; the initializing one re-enters through rglSafeCall.
+	static std::recursive_mutex initMutex;
+	std::lock_guard initLock{initMutex};
 	static bool initCalled = false;
 	if (initCalled) {
 		return;
 	}
 	initCalled = true;
 	rgl_status_t initStatus = rglSafeCall([&]() {
+		// OptiX is initialized on its first use (or in rgl_warmup), so that its program cache can be configured before.
 		Logger::getOrCreate();
-		Optix::getOrCreate();
 		if (isCompiledWithAutoTape()) {
 			auto path = std::filesystem::path(RGL_AUTO_TAPE_PATH);
 			RGL_INFO("Starting RGL Auto Tape on path '{}'", path.string());
@@ -87,4 +98,5 @@ void rglLazyInit()
 		// If initialization fails, change error code to unrecoverable one and preserve original message
 		updateAPIState(RGL_INITIALIZATION_ERROR, lastStatusString);
 	}
+	initDone.store(true, std::memory_order::release);
 }
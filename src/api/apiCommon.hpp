@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cmath>
 #include <thread>
 #include <spdlog/common.h>
@@ -25,6 +26,7 @@
 #include <rgl/api/core.h>
 
 #include <Optix.hpp>
+#include <CudaDevice.hpp>
 #include <graph/Node.hpp>
 #include <graph/GraphRunCtx.hpp>
 
@@ -34,7 +36,13 @@
 
 #include <repr.hpp>
 
-#define RGL_API_LOG RGL_TRACE
+// Arguments (e.g. repr() of arrays) are evaluated only if the call is going to be logged.
+#define RGL_API_LOG(...)                                                                                                       \
+	do                                                                                                                         \
+		if (Logger::getOrCreate().getLogger().should_log(spdlog::level::trace)) [[unlikely]] {                                 \
+			RGL_TRACE(__VA_ARGS__);                                                                                            \
+		}                                                                                                                      \
+	while (0)
 
 #define CHECK_ARG(expr)                                                                                                        \
 	do                                                                                                                         \
@@ -44,8 +52,10 @@
 		}                                                                                                                      \
 	while (0)
 
-extern rgl_status_t lastStatusCode;
-extern std::optional<std::string> lastStatusString;
+// Status of the last API call is kept per client's thread; an unrecoverable error affects all threads.
+extern thread_local rgl_status_t lastStatusCode;
+extern thread_local std::optional<std::string> lastStatusString;
+extern std::atomic<rgl_status_t> unrecoverableStatusCode;
 
 void rglLazyInit();
 const char* getLastErrorString() noexcept;
@@ -56,8 +66,8 @@ template<typename Fn>
 rgl_status_t rglSafeCall(Fn fn)
 {
 	rglLazyInit(); // Trigger initialization on the first API call
-	if (!canContinueAfterStatus(lastStatusCode)) {
-		if (lastStatusCode != RGL_LOGGING_ERROR) {
+	if (rgl_status_t fatalStatus = unrecoverableStatusCode.load(); fatalStatus != RGL_SUCCESS) {
+		if (fatalStatus != RGL_LOGGING_ERROR) {
 			RGL_CRITICAL("Logging disabled due to the previous fatal error");
 			try {
 				Logger::getOrCreate().configure(RGL_LOG_LEVEL_OFF, std::nullopt, false);
@@ -68,6 +78,7 @@ rgl_status_t rglSafeCall(Fn fn)
 		return updateAPIState(RGL_INVALID_STATE);
 	}
 	try {
+		CudaDevice::bindCurrentThread();
 		std::invoke(fn);
 	}
 #if RGL_BUILD_ROS2_EXTENSION
@@ -105,14 +116,45 @@ rgl_status_t rglSafeCall(Fn fn)
 	return updateAPIState(RGL_SUCCESS);
 }
 
+/**
+ * Waits until graphs are idle (all or only the ones raytracing the given scene) and keeps them so as long as it exists,
+ * i.e. rgl_graph_run waits. Used by calls modifying objects used by graph threads (e.g. meshes shared by scenes).
+ * Edits of scenes are locked as well, see Scene::lockEdits().
+ */
+class IdleGraphsGuard
+{
+public:
+	explicit IdleGraphsGuard(const Scene* scene = nullptr) : runsLock(GraphRunCtx::blockRuns())
+	{
+		if (scene != nullptr) {
+			GraphRunCtx::synchronizeScene(*scene);
+		} else {
+			GraphRunCtx::synchronizeAll();
+		}
+		editsLock = Scene::lockEdits();
+	}
+
+private:
+	std::unique_lock<std::shared_mutex> runsLock; // Locked before graphs and scene edits, see rgl_graph_run
+	std::unique_lock<std::recursive_mutex> editsLock;
+};
+
 template<typename NodeType, typename... Args>
 void createOrUpdateNode(rgl_node_t* nodeRawPtr, Args&&... args)
 {
 	std::shared_ptr<NodeType> node;
+	GraphRunCtx::ClientLock graphLock; // Other client's threads may be using the graph (e.g. getting its results)
 	if (*nodeRawPtr == nullptr) {
 		node = Node::create<NodeType>();
 	} else {
 		node = Node::validatePtr<NodeType>(*nodeRawPtr);
+		graphLock = GraphRunCtx::lockGraphOf(node);
+		// Nodes holding large data may detect that it is identical, then there is nothing to upload or revalidate.
+		if constexpr (requires { node->isUnchangedBy(args...); }) {
+			if (node->isUnchangedBy(args...)) {
+				return;
+			}
+		}
 	}
 
 	// As of now, there's no guarantee that changing node parameter won't influence other nodes
@@ -122,20 +164,22 @@ void createOrUpdateNode(rgl_node_t* nodeRawPtr, Args&&... args)
 	}
 
 	// TODO: The magic below detects calls changing rgl_field_t* (e.g. FormatPointsNode) or changing rays definition
-	// TODO: Such changes may require recomputing required fields in RaytraceNode
-	// TODO: or performing validation in nodes dependent on ray count (e.g. SetRingIdsRaysNode)
+	// TODO: Changed fields may require recomputing required fields in RaytraceNode (upstream), hence the whole graph.
+	// TODO: Changed rays require validation only in nodes dependent on ray count (e.g. SetRingIdsRaysNode), i.e. outputs.
 	// TODO: However, taking care of this manually is very bug prone.
 	// TODO: There are other ways to automate this, however, for now this should be enough.
 	bool fieldsModified = (std::is_same_v<Args, std::vector<rgl_field_t>> || ...);
-	bool raysModified = std::is_same_v<NodeType, FromMat3x4fRaysNode>;
-	bool graphValidationNeeded = fieldsModified || raysModified;
-	if (graphValidationNeeded && node->hasGraphRunCtx()) {
+	bool raysModified = std::is_same_v<NodeType, FromMat3x4fRaysNode> || std::is_same_v<NodeType, FromDirectionsRaysNode> ||
+	                    std::is_same_v<NodeType, FromPatternRaysNode>;
+	if (fieldsModified && node->hasGraphRunCtx()) {
 		node->getGraphRunCtx()->markNodesDirty();
+	} else if (raysModified) {
+		GraphRunCtx::markNodeAndOutputsDirty(node);
 	}
 
 	node->setParameters(std::forward<Args>(args)...);
 	node->dirty = true;
-	*nodeRawPtr = node.get();
+	*nodeRawPtr = node->getHandle();
 }
 
 inline void handleDestructorException(std::exception_ptr e, const char* what)
@@ -146,10 +190,7 @@ inline void handleDestructorException(std::exception_ptr e, const char* what)
 	// We may be in graph thread which should get gracefully killed:
 	// TODO: Implement this in a thread-safe manner (accessing GraphRunCtx::instances)
 	for (auto&& ctx : GraphRunCtx::instances) {
-		if (!ctx->maybeThread.has_value()) {
-			continue;
-		}
-		if (ctx->maybeThread.value().get_id() != std::this_thread::get_id()) {
+		if (!ctx->isThisThreadGraphThread()) {
 			continue;
 		}
 		// We're a graph thread. Mark remaining nodes as executed and set exception.
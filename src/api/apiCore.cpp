@@ -12,6 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <set>
+
 #include <rgl/api/core.h>
 #include <rgl/api/extensions/tape.h>
 
@@ -26,7 +32,15 @@
 
 #include <graph/NodesCore.hpp>
 #include <graph/GraphRunCtx.hpp>
+#include <memory/DeviceMemoryPool.hpp>
+#include <memory/HostPinnedMemoryPool.hpp>
+#include <CudaEvent.hpp>
+#include <DLPack.hpp>
+#include <MetricsExporter.hpp>
 #include <NvtxWrappers.hpp>
+#include <PerformanceCounters.hpp>
+#include <ThreadConfig.hpp>
+#include <TraceRecorder.hpp>
 
 extern "C" {
 
@@ -89,6 +103,7 @@ RGL_API rgl_status_t rgl_get_extension_info(rgl_extension_t extension, int32_t*
 			case RGL_EXTENSION_ROS2: *out_available = RGL_BUILD_ROS2_EXTENSION; break;
 			case RGL_EXTENSION_UDP: *out_available = RGL_BUILD_UDP_EXTENSION; break;
 			case RGL_EXTENSION_SNOW: *out_available = RGL_BUILD_SNOW_EXTENSION; break;
+			case RGL_EXTENSION_GL: *out_available = RGL_BUILD_GL_EXTENSION; break;
 			default: throw std::invalid_argument(fmt::format("queried unknown RGL extension: {}", extension));
 		}
 	});
@@ -124,885 +139,3274 @@ void TapeCore::tape_configure_logging(const YAML::Node& yamlNode, PlaybackState&
 	                      yamlNode[2].as<bool>());
 }
 
-RGL_API void rgl_get_last_error_string(const char** out_error_string)
+RGL_API rgl_status_t rgl_configure_logging_queue(int32_t queue_size)
 {
-	if (out_error_string == nullptr) {
-		return;
-	}
-	// NO LOGGING HERE SINCE IT MAY THROW!
-	*out_error_string = getLastErrorString();
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_configure_logging_queue(queue_size={})", queue_size);
+		CHECK_ARG(queue_size >= 0);
+		Logger::getOrCreate().configureQueue(static_cast<std::size_t>(queue_size));
+	});
+	TAPE_HOOK(queue_size);
+	return status;
 }
 
-RGL_API rgl_status_t rgl_cleanup(void)
+void TapeCore::tape_configure_logging_queue(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_configure_logging_queue(yamlNode[0].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_configure_device_memory_pool(uint64_t release_threshold, uint64_t reserved_size)
 {
 	auto status = rglSafeCall([&]() {
-		// First, delete nodes, because there might be a thread accessing other structures.
-		while (!Node::instances.empty()) {
-			auto node = Node::instances.begin()->second;
-			if (node->hasGraphRunCtx()) {
-				try {
-					// This iterates over all nodes and may trigger pending exceptions
-					node->getGraphRunCtx()->detachAndDestroy();
-				}
-				catch (std::exception& e) {
-					RGL_WARN("rgl_cleanup: caught pending exception in Node {}: {}", node->getName(), e.what());
-					continue; // Some node has thrown exception so this graph has not been detached, try again
-				}
-			}
-			auto connectedNodes = node->disconnectConnectedNodes();
-			for (auto&& nodeToRelease : connectedNodes) {
-				Node::release(nodeToRelease.get());
-			}
-		}
-		Entity::instances.clear();
-		Mesh::instances.clear();
-		Texture::instances.clear();
-		Scene::instance().clear();
+		RGL_API_LOG("rgl_configure_device_memory_pool(release_threshold={}, reserved_size={})", release_threshold,
+		            reserved_size);
+		CHECK_ARG(reserved_size <= release_threshold);
+		DeviceMemoryPool::instance().configure(release_threshold, reserved_size);
 	});
-	TAPE_HOOK();
+	TAPE_HOOK(release_threshold, reserved_size);
 	return status;
 }
 
-void TapeCore::tape_cleanup(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_device_memory_pool(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_cleanup();
-	state.clear();
+	rgl_configure_device_memory_pool(yamlNode[0].as<uint64_t>(), yamlNode[1].as<uint64_t>());
 }
 
-RGL_API rgl_status_t rgl_mesh_create(rgl_mesh_t* out_mesh, const rgl_vec3f* vertices, int32_t vertex_count,
-                                     const rgl_vec3i* indices, int32_t index_count)
+RGL_API rgl_status_t rgl_get_device_memory_pool_stats(uint64_t* out_reserved_bytes, uint64_t* out_used_bytes,
+                                                      uint64_t* out_allocation_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_mesh_create(out_mesh={}, vertices={}, indices={})", (void*) out_mesh, repr(vertices, vertex_count),
-		            repr(indices, index_count, 1));
-		CHECK_ARG(out_mesh != nullptr);
-		CHECK_ARG(vertices != nullptr);
-		CHECK_ARG(vertex_count > 0);
-		CHECK_ARG(indices != nullptr);
-		CHECK_ARG(index_count > 0);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		*out_mesh = Mesh::create(reinterpret_cast<const Vec3f*>(vertices), vertex_count,
-		                         reinterpret_cast<const Vec3i*>(indices), index_count)
-		                .get();
+		RGL_API_LOG("rgl_get_device_memory_pool_stats(out_reserved_bytes={}, out_used_bytes={}, out_allocation_count={})",
+		            (void*) out_reserved_bytes, (void*) out_used_bytes, (void*) out_allocation_count);
+		CHECK_ARG(out_reserved_bytes != nullptr);
+		CHECK_ARG(out_used_bytes != nullptr);
+		CHECK_ARG(out_allocation_count != nullptr);
+		*out_reserved_bytes = DeviceMemoryPool::instance().getReservedBytes();
+		*out_used_bytes = DeviceMemoryPool::instance().getUsedBytes();
+		*out_allocation_count = DeviceMemoryPool::instance().getAllocationCount();
 	});
-	TAPE_HOOK(out_mesh, TAPE_ARRAY(vertices, vertex_count), vertex_count, TAPE_ARRAY(indices, index_count), index_count);
+	TAPE_HOOK(out_reserved_bytes, out_used_bytes, out_allocation_count);
 	return status;
 }
 
-void TapeCore::tape_mesh_create(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_get_device_memory_pool_stats(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_mesh_t mesh = nullptr;
-	rgl_mesh_create(&mesh, state.getPtr<const rgl_vec3f>(yamlNode[1]), yamlNode[2].as<int32_t>(),
-	                state.getPtr<const rgl_vec3i>(yamlNode[3]), yamlNode[4].as<int32_t>());
-	state.meshes.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), mesh));
+	// Stats depend on the whole process' history, so they are not compared with the recorded ones.
+	uint64_t out_reserved_bytes, out_used_bytes, out_allocation_count;
+	rgl_get_device_memory_pool_stats(&out_reserved_bytes, &out_used_bytes, &out_allocation_count);
 }
 
-RGL_API rgl_status_t rgl_mesh_set_texture_coords(rgl_mesh_t mesh, const rgl_vec2f* uvs, int32_t uv_count)
+RGL_API rgl_status_t rgl_configure_host_pinned_memory_pool(uint64_t max_cached_bytes)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_mesh_set_texture_coords(mesh={}, uvs={}, uv_count={})", (void*) mesh, repr(uvs, uv_count), uv_count);
-		CHECK_ARG(mesh != nullptr);
-		CHECK_ARG(uvs != nullptr);
-		CHECK_ARG(uv_count > 0);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		Mesh::validatePtr(mesh)->setTexCoords(reinterpret_cast<const Vec2f*>(uvs), uv_count);
+		RGL_API_LOG("rgl_configure_host_pinned_memory_pool(max_cached_bytes={})", max_cached_bytes);
+		HostPinnedMemoryPool::instance().configure(max_cached_bytes);
 	});
-	TAPE_HOOK(mesh, TAPE_ARRAY(uvs, uv_count), uv_count);
+	TAPE_HOOK(max_cached_bytes);
 	return status;
 }
 
-void TapeCore::tape_mesh_set_texture_coords(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_host_pinned_memory_pool(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_mesh_set_texture_coords(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_vec2f>(yamlNode[1]),
-	                            yamlNode[2].as<int32_t>());
+	rgl_configure_host_pinned_memory_pool(yamlNode[0].as<uint64_t>());
 }
 
-RGL_API rgl_status_t rgl_mesh_destroy(rgl_mesh_t mesh)
+RGL_API rgl_status_t rgl_get_host_pinned_memory_pool_stats(uint64_t* out_cached_bytes, uint64_t* out_used_bytes,
+                                                           uint64_t* out_allocation_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_mesh_destroy(mesh={})", (void*) mesh);
-		CHECK_ARG(mesh != nullptr);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		Mesh::release(mesh);
+		RGL_API_LOG("rgl_get_host_pinned_memory_pool_stats(out_cached_bytes={}, out_used_bytes={}, out_allocation_count={})",
+		            (void*) out_cached_bytes, (void*) out_used_bytes, (void*) out_allocation_count);
+		CHECK_ARG(out_cached_bytes != nullptr);
+		CHECK_ARG(out_used_bytes != nullptr);
+		CHECK_ARG(out_allocation_count != nullptr);
+		*out_cached_bytes = HostPinnedMemoryPool::instance().getCachedBytes();
+		*out_used_bytes = HostPinnedMemoryPool::instance().getUsedBytes();
+		*out_allocation_count = HostPinnedMemoryPool::instance().getAllocationCount();
 	});
-	TAPE_HOOK(mesh);
+	TAPE_HOOK(out_cached_bytes, out_used_bytes, out_allocation_count);
 	return status;
 }
 
-void TapeCore::tape_mesh_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_get_host_pinned_memory_pool_stats(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	auto meshId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_mesh_destroy(state.meshes.at(meshId));
-	state.meshes.erase(meshId);
+	// Stats depend on the whole process' history, so they are not compared with the recorded ones.
+	uint64_t out_cached_bytes, out_used_bytes, out_allocation_count;
+	rgl_get_host_pinned_memory_pool_stats(&out_cached_bytes, &out_used_bytes, &out_allocation_count);
 }
 
-RGL_API rgl_status_t rgl_mesh_update_vertices(rgl_mesh_t mesh, const rgl_vec3f* vertices, int32_t vertex_count)
+RGL_API rgl_status_t rgl_get_memory_usage(rgl_memory_usage_t* out_usage)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_mesh_update_vertices(mesh={}, vertices={})", (void*) mesh, repr(vertices, vertex_count));
-		CHECK_ARG(mesh != nullptr);
-		CHECK_ARG(vertices != nullptr);
-		CHECK_ARG(vertex_count > 0);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		Mesh::validatePtr(mesh)->updateVertices(reinterpret_cast<const Vec3f*>(vertices), vertex_count);
+		RGL_API_LOG("rgl_get_memory_usage(out_usage={})", (void*) out_usage);
+		CHECK_ARG(out_usage != nullptr);
+		auto editsLock = Scene::lockEdits(); // Scenes and meshes are modified under this lock, also by graph threads
+		*out_usage = {};
+		Scene::forEachMesh([out_usage](Mesh& mesh) {
+			out_usage->gas_bytes += mesh.getGASBytes();
+			out_usage->mesh_bytes += mesh.getGeometryBytes();
+		});
+		Scene::forEach([out_usage](Scene& scene) {
+			out_usage->ias_bytes += scene.getIASBytes();
+			out_usage->sbt_bytes += scene.getSBTBytes();
+		});
+		out_usage->gas_scratch_bytes = SharedASBuildTemp::getAllocatedBytes();
+		out_usage->node_bytes = DeviceMemoryPool::instance().getUsedBytes();
+		out_usage->texture_bytes = Texture::getAllocatedBytes();
 	});
-	TAPE_HOOK(mesh, TAPE_ARRAY(vertices, vertex_count), vertex_count);
+	TAPE_HOOK(out_usage);
 	return status;
 }
 
-void TapeCore::tape_mesh_update_vertices(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_get_memory_usage(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_mesh_update_vertices(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_vec3f>(yamlNode[1]),
-	                         yamlNode[2].as<int32_t>());
+	// Usage depends on the whole process' history, so it is not compared with the recorded one.
+	rgl_memory_usage_t out_usage;
+	rgl_get_memory_usage(&out_usage);
 }
 
-rgl_status_t rgl_mesh_is_alive(rgl_mesh_t mesh, bool* out_alive)
+RGL_API rgl_status_t rgl_get_memory_kind_stats(rgl_memory_kind_t kind, rgl_memory_kind_stats_t* out_stats)
 {
 	auto status = rglSafeCall([&]() {
-		CHECK_ARG(out_alive != nullptr);
-		*out_alive = Mesh::instances.contains(mesh);
+		RGL_API_LOG("rgl_get_memory_kind_stats(kind={}, out_stats={})", kind, (void*) out_stats);
+		CHECK_ARG(kind >= RGL_MEMORY_KIND_DEVICE_ASYNC && kind <= RGL_MEMORY_KIND_DEVICE_MANAGED);
+		CHECK_ARG(out_stats != nullptr);
+		*out_stats = PerformanceCounters::instance().getMemoryKindCounters(static_cast<MemoryKind>(kind)).get();
 	});
-	TAPE_HOOK(mesh, out_alive);
+	TAPE_HOOK(kind, out_stats);
 	return status;
 }
 
-RGL_API rgl_status_t rgl_entity_create(rgl_entity_t* out_entity, rgl_scene_t scene, rgl_mesh_t mesh)
+void TapeCore::tape_get_memory_kind_stats(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_memory_kind_stats_t out_stats;
+	rgl_get_memory_kind_stats(static_cast<rgl_memory_kind_t>(yamlNode[0].as<int32_t>()), &out_stats);
+}
+
+RGL_API rgl_status_t rgl_configure_gas_eviction(uint64_t gas_budget_bytes, int32_t min_unused_frames)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_entity_create(out_entity={}, scene={}, mesh={})", (void*) out_entity, (void*) scene, (void*) mesh);
-		CHECK_ARG(out_entity != nullptr);
-		CHECK_ARG(mesh != nullptr);
-		CHECK_ARG(scene == nullptr);   // TODO: remove once rgl_scene_t param is removed
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		*out_entity = Entity::create(Mesh::validatePtr(mesh)).get();
+		RGL_API_LOG("rgl_configure_gas_eviction(gas_budget_bytes={}, min_unused_frames={})", gas_budget_bytes,
+		            min_unused_frames);
+		CHECK_ARG(min_unused_frames >= 0);
+		std::optional<std::size_t> budget;
+		if (gas_budget_bytes != std::numeric_limits<uint64_t>::max()) {
+			budget = gas_budget_bytes;
+		}
+		Scene::configureGASEviction(budget, static_cast<std::size_t>(min_unused_frames));
 	});
-	TAPE_HOOK(out_entity, scene, mesh);
+	TAPE_HOOK(gas_budget_bytes, min_unused_frames);
 	return status;
 }
 
-void TapeCore::tape_entity_create(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_gas_eviction(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_entity_t entity = nullptr;
-	rgl_entity_create(&entity, nullptr, state.meshes.at(yamlNode[2].as<TapeAPIObjectID>()));
-	state.entities.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), entity));
+	rgl_configure_gas_eviction(yamlNode[0].as<uint64_t>(), yamlNode[1].as<int32_t>());
 }
 
-RGL_API rgl_status_t rgl_entity_destroy(rgl_entity_t entity)
+RGL_API rgl_status_t rgl_configure_mesh_cache(bool enabled, uint64_t budget_bytes)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_entity_destroy(entity={})", (void*) entity);
-		CHECK_ARG(entity != nullptr);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		auto entitySafe = Entity::validatePtr(entity);
-		Scene::instance().removeEntity(entitySafe);
-		Entity::release(entity);
+		RGL_API_LOG("rgl_configure_mesh_cache(enabled={}, budget_bytes={})", enabled, budget_bytes);
+		IdleGraphsGuard idleGraphs; // Freed meshes might be used by graph threads
+		Mesh::configureCache(enabled, budget_bytes);
 	});
-	TAPE_HOOK(entity);
+	TAPE_HOOK(enabled, budget_bytes);
 	return status;
 }
 
-void TapeCore::tape_entity_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_mesh_cache(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	auto entityId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_entity_destroy(state.entities.at(entityId));
-	state.entities.erase(entityId);
+	rgl_configure_mesh_cache(yamlNode[0].as<bool>(), yamlNode[1].as<uint64_t>());
 }
 
-RGL_API rgl_status_t rgl_entity_set_pose(rgl_entity_t entity, const rgl_mat3x4f* transform)
+RGL_API rgl_status_t rgl_configure_performance_sampling(int32_t frame_interval)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_entity_set_pose(entity={}, transform={})", (void*) entity, repr(transform, 1));
-		CHECK_ARG(entity != nullptr);
-		CHECK_ARG(transform != nullptr);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		auto tf = Mat3x4f::fromRaw(reinterpret_cast<const float*>(&transform->value[0][0]));
-		Entity::validatePtr(entity)->setTransform(tf);
+		RGL_API_LOG("rgl_configure_performance_sampling(frame_interval={})", frame_interval);
+		CHECK_ARG(frame_interval >= 0);
+		PerformanceCounters::instance().setSamplingInterval(static_cast<uint32_t>(frame_interval));
 	});
-	TAPE_HOOK(entity, transform);
+	TAPE_HOOK(frame_interval);
 	return status;
 }
 
-void TapeCore::tape_entity_set_pose(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_performance_sampling(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_entity_set_pose(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_mat3x4f>(yamlNode[1]));
+	rgl_configure_performance_sampling(yamlNode[0].as<int32_t>());
 }
 
-RGL_API rgl_status_t rgl_entity_set_id(rgl_entity_t entity, int32_t id)
+RGL_API rgl_status_t rgl_get_performance_counters(rgl_performance_counters_t* out_counters)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_entity_set_id(entity={}, id={})", (void*) entity, id);
-		CHECK_ARG(entity != nullptr);
-		CHECK_ARG(id != RGL_ENTITY_INVALID_ID);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		Entity::validatePtr(entity)->setId(id);
+		RGL_API_LOG("rgl_get_performance_counters(out_counters={})", (void*) out_counters);
+		CHECK_ARG(out_counters != nullptr);
+		*out_counters = PerformanceCounters::instance().get();
+		out_counters->log_dropped_count = Logger::getOrCreate().getDroppedMessageCount();
 	});
-	TAPE_HOOK(entity, id);
+	TAPE_HOOK(out_counters);
 	return status;
 }
 
-void TapeCore::tape_entity_set_id(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_get_performance_counters(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_entity_set_id(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<Field<ENTITY_ID_I32>::type>());
+	// Timings are not reproducible, so they are not compared with the recorded ones.
+	rgl_performance_counters_t out_counters;
+	rgl_get_performance_counters(&out_counters);
 }
 
-RGL_API rgl_status_t rgl_entity_set_intensity_texture(rgl_entity_t entity, rgl_texture_t texture)
+RGL_API rgl_status_t rgl_configure_metrics(bool enabled, int32_t http_port)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_entity_set_intensity_texture(entity={}, texture={})", (void*) entity, (void*) texture);
-		CHECK_ARG(entity != nullptr);
-		CHECK_ARG(texture != nullptr);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		Entity::validatePtr(entity)->setIntensityTexture(Texture::validatePtr(texture));
+		RGL_API_LOG("rgl_configure_metrics(enabled={}, http_port={})", enabled, http_port);
+		CHECK_ARG(http_port >= 0 && http_port <= UINT16_MAX);
+		MetricsExporter::instance().configure(enabled, static_cast<uint16_t>(http_port));
 	});
-
-	TAPE_HOOK(entity, texture);
+	TAPE_HOOK(enabled, http_port);
 	return status;
 }
 
-void TapeCore::tape_entity_set_intensity_texture(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_metrics(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_entity_set_intensity_texture(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()),
-	                                 state.textures.at(yamlNode[1].as<TapeAPIObjectID>()));
+	rgl_configure_metrics(yamlNode[0].as<bool>(), yamlNode[1].as<int32_t>());
 }
 
-rgl_status_t rgl_entity_is_alive(rgl_entity_t entity, bool* out_alive)
+RGL_API rgl_status_t rgl_get_metrics_text(const char** out_text)
 {
 	auto status = rglSafeCall([&]() {
-		CHECK_ARG(out_alive != nullptr);
-		*out_alive = Entity::instances.contains(entity);
+		RGL_API_LOG("rgl_get_metrics_text(out_text={})", (void*) out_text);
+		CHECK_ARG(out_text != nullptr);
+		thread_local std::string text;
+		text = MetricsExporter::instance().render();
+		*out_text = text.c_str();
 	});
-	TAPE_HOOK(entity, out_alive);
+	TAPE_HOOK(out_text);
 	return status;
 }
 
-RGL_API rgl_status_t rgl_texture_create(rgl_texture_t* out_texture, const void* texels, int32_t width, int32_t height)
+void TapeCore::tape_get_metrics_text(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	const char* text = nullptr;
+	rgl_get_metrics_text(&text);
+}
+
+RGL_API rgl_status_t rgl_trace_start(int32_t max_event_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_texture_create(out_texture={}, width={}, height={})", (void*) out_texture, width, height);
-		CHECK_ARG(out_texture != nullptr);
-		CHECK_ARG(texels != nullptr);
-		CHECK_ARG(width > 0);
-		CHECK_ARG(height > 0);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		*out_texture = Texture::create(texels, width, height).get();
+		RGL_API_LOG("rgl_trace_start(max_event_count={})", max_event_count);
+		CHECK_ARG(max_event_count > 0);
+		TraceRecorder::instance().start(static_cast<std::size_t>(max_event_count));
 	});
-	TAPE_HOOK(out_texture, TAPE_ARRAY(texels, (width * height * sizeof(TextureTexelFormat))), width, height);
+	TAPE_HOOK(max_event_count);
 	return status;
 }
 
-void TapeCore::tape_texture_create(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_trace_start(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_texture_t texture = nullptr;
-
-	rgl_texture_create(&texture, state.getPtr<const void>(yamlNode[1]), yamlNode[2].as<int32_t>(), yamlNode[3].as<int32_t>());
-
-	state.textures.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), texture));
+	rgl_trace_start(yamlNode[0].as<int32_t>());
 }
 
-RGL_API rgl_status_t rgl_texture_destroy(rgl_texture_t texture)
+RGL_API rgl_status_t rgl_trace_stop(const char* file_path)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_texture_destroy(texture={})", (void*) texture);
-		CHECK_ARG(texture != nullptr);
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
-		Texture::release(texture);
+		RGL_API_LOG("rgl_trace_stop(file_path={})", file_path);
+		CHECK_ARG(file_path != nullptr);
+		CHECK_ARG(file_path[0] != '\0');
+		TraceRecorder::instance().stop(file_path);
 	});
-	TAPE_HOOK(texture);
+	TAPE_HOOK(file_path);
 	return status;
 }
 
-void TapeCore::tape_texture_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_trace_stop(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	auto textureId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_texture_destroy(state.textures.at(textureId));
-	state.textures.erase(textureId);
+	rgl_trace_stop(yamlNode[0].as<std::string>().c_str());
 }
 
-rgl_status_t rgl_texture_is_alive(rgl_texture_t texture, bool* out_alive)
+RGL_API rgl_status_t rgl_configure_program_cache(bool enabled, const char* cache_path, uint64_t max_size_bytes)
 {
 	auto status = rglSafeCall([&]() {
-		CHECK_ARG(out_alive != nullptr);
-		*out_alive = Texture::instances.contains(texture);
+		RGL_API_LOG("rgl_configure_program_cache(enabled={}, cache_path={}, max_size_bytes={})", enabled,
+		            cache_path != nullptr ? cache_path : "nullptr", max_size_bytes);
+		CHECK_ARG(cache_path == nullptr || cache_path[0] != '\0');
+		Optix::configureProgramCache(enabled, cache_path != nullptr ? std::optional<std::string>(cache_path) : std::nullopt,
+		                             max_size_bytes);
 	});
-	TAPE_HOOK(texture, out_alive);
+	TAPE_HOOK(enabled, cache_path, max_size_bytes);
 	return status;
 }
 
-RGL_API rgl_status_t rgl_scene_set_time(rgl_scene_t scene, uint64_t nanoseconds)
+void TapeCore::tape_configure_program_cache(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_scene_set_time(scene={}, nanoseconds={})", (void*) scene, nanoseconds);
-		CHECK_ARG(scene == nullptr);   // TODO: remove once rgl_scene_t param is removed
-		GraphRunCtx::synchronizeAll(); // Prevent races with graph threads
+	// Cache location is specific to the recording machine and the player has OptiX initialized already.
+}
 
-		Scene::instance().setTime(Time::nanoseconds(nanoseconds));
+RGL_API rgl_status_t rgl_configure_motion_blur(bool enabled)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_configure_motion_blur(enabled={})", enabled);
+		Optix::configureMotionBlur(enabled);
 	});
-	TAPE_HOOK(scene, nanoseconds);
+	TAPE_HOOK(enabled);
 	return status;
 }
 
-void TapeCore::tape_scene_set_time(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_motion_blur(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_scene_set_time(nullptr, yamlNode[1].as<uint64_t>());
+	// Fails if the player has OptiX initialized already, then the tape is played without motion blur.
+	rgl_configure_motion_blur(yamlNode[0].as<bool>());
 }
 
-RGL_API rgl_status_t rgl_graph_run(rgl_node_t raw_node)
+RGL_API rgl_status_t rgl_configure_max_register_count(int32_t max_register_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_run(node={})", repr(raw_node));
-		CHECK_ARG(raw_node != nullptr);
-		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_run"};
-		auto node = Node::validatePtr(raw_node);
-		if (!node->hasGraphRunCtx()) {
-			GraphRunCtx::createAndAttach(node);
-		}
-		node->getGraphRunCtx()->executeAsync();
+		RGL_API_LOG("rgl_configure_max_register_count(max_register_count={})", max_register_count);
+		CHECK_ARG(max_register_count >= 0);
+		Optix::configureMaxRegisterCount(max_register_count);
 	});
-	TAPE_HOOK(raw_node);
+	TAPE_HOOK(max_register_count);
 	return status;
 }
 
-void TapeCore::tape_graph_run(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_max_register_count(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_graph_run(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()));
+	// Fails if the player has OptiX initialized already, then the tape is played with the player's limit.
+	rgl_configure_max_register_count(yamlNode[0].as<int32_t>());
 }
 
-RGL_API rgl_status_t rgl_graph_destroy(rgl_node_t raw_node)
+RGL_API rgl_status_t rgl_warmup()
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_destroy(node={})", repr(raw_node));
-		CHECK_ARG(raw_node != nullptr);
-		auto node = Node::validatePtr(raw_node);
-		if (node->hasGraphRunCtx()) {
-			node->getGraphRunCtx()->detachAndDestroy();
-		}
-		auto allNodes = node->disconnectConnectedNodes();
-		for (auto&& nodeToRelease : allNodes) {
-			Node::release(nodeToRelease.get());
-		}
+		RGL_API_LOG("rgl_warmup()");
+		Optix::getOrCreate();
+		DeviceMemoryPool::instance();
+		Mesh::getStream();
+		Scene::defaultInstance();
 	});
-	TAPE_HOOK(raw_node);
+	TAPE_HOOK();
 	return status;
 }
 
-void TapeCore::tape_graph_destroy(const YAML::Node& yamlNode, PlaybackState& state)
-{
-	rgl_node_t userNode = state.nodes.at(yamlNode[0].as<TapeAPIObjectID>());
-	std::set<Node::Ptr> graph = Node::validatePtr(userNode)->getConnectedComponentNodes();
-	std::set<TapeAPIObjectID> graphNodeIds;
-
-	for (auto const& graphNode : graph) {
-		for (auto const& [key, val] : state.nodes) {
-			auto tapeNodePtr = Node::validatePtr(val).get();
-			if (graphNode.get() == tapeNodePtr) {
-				graphNodeIds.insert(key);
-				break;
-			}
-		}
-	}
+void TapeCore::tape_warmup(const YAML::Node& yamlNode, PlaybackState& state) { rgl_warmup(); }
 
-	rgl_graph_destroy(userNode);
+RGL_API rgl_status_t rgl_configure_device(int32_t device_index)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_configure_device(device_index={})", device_index);
+		CHECK_ARG(device_index >= 0);
+		CudaDevice::select(device_index);
+	});
+	TAPE_HOOK(device_index);
+	return status;
+}
 
-	while (!graphNodeIds.empty()) {
-		TapeAPIObjectID nodeId = *graphNodeIds.begin();
-		state.nodes.erase(nodeId);
-		graphNodeIds.erase(nodeId);
-	}
+void TapeCore::tape_configure_device(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	// Devices are specific to the recording machine and the player uses its device already.
 }
 
-RGL_API rgl_status_t rgl_graph_get_result_size(rgl_node_t node, rgl_field_t field, int32_t* out_count, int32_t* out_size_of)
+RGL_API rgl_status_t rgl_get_device_count(int32_t* out_device_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_get_result_size(node={}, field={}, out_count={}, out_size_of={})", repr(node), field,
-		            (void*) out_count, (void*) out_size_of);
-		CHECK_ARG(node != nullptr);
-		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_get_result_size"};
+		RGL_API_LOG("rgl_get_device_count(out_device_count={})", (void*) out_device_count);
+		CHECK_ARG(out_device_count != nullptr);
+		*out_device_count = CudaDevice::getCount();
+	});
+	TAPE_HOOK(out_device_count);
+	return status;
+}
 
-		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
-		pointCloudNode->waitForResults();
-		auto elemCount = (int32_t) pointCloudNode->getPointCount();
-		auto elemSize = (int32_t) pointCloudNode->getFieldPointSize(field);
+void TapeCore::tape_get_device_count(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	int32_t deviceCount = 0;
+	rgl_get_device_count(&deviceCount);
+}
 
-		if (out_count != nullptr) {
-			*out_count = elemCount;
-		}
-		if (out_size_of != nullptr) {
-			*out_size_of = elemSize;
-		}
+RGL_API rgl_status_t rgl_configure_threads(const int32_t* graph_worker_cpus, int32_t graph_worker_cpu_count,
+                                           const int32_t* io_cpus, int32_t io_cpu_count, bool prefer_gpu_numa_node)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_configure_threads(graph_worker_cpus={}, io_cpus={}, prefer_gpu_numa_node={})",
+		            repr(graph_worker_cpus, graph_worker_cpu_count), repr(io_cpus, io_cpu_count), prefer_gpu_numa_node);
+		CHECK_ARG(graph_worker_cpu_count >= 0);
+		CHECK_ARG(graph_worker_cpus != nullptr || graph_worker_cpu_count == 0);
+		CHECK_ARG(io_cpu_count >= 0);
+		CHECK_ARG(io_cpus != nullptr || io_cpu_count == 0);
+		auto isValidCpu = [](int32_t cpu) { return cpu >= 0 && cpu < ThreadConfig::MAX_CPU_COUNT; };
+		CHECK_ARG(std::all_of(graph_worker_cpus, graph_worker_cpus + graph_worker_cpu_count, isValidCpu));
+		CHECK_ARG(std::all_of(io_cpus, io_cpus + io_cpu_count, isValidCpu));
+
+		ThreadConfig::configure({graph_worker_cpus, graph_worker_cpus + graph_worker_cpu_count},
+		                        {io_cpus, io_cpus + io_cpu_count}, prefer_gpu_numa_node);
 	});
-	TAPE_HOOK(node, field, out_count, out_size_of);
+	TAPE_HOOK(TAPE_ARRAY(graph_worker_cpus, graph_worker_cpu_count), graph_worker_cpu_count,
+	          TAPE_ARRAY(io_cpus, io_cpu_count), io_cpu_count, prefer_gpu_numa_node);
 	return status;
 }
 
-void TapeCore::tape_graph_get_result_size(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_configure_threads(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	int32_t out_count, out_size_of;
-	rgl_graph_get_result_size(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), (rgl_field_t) yamlNode[1].as<int>(),
-	                          &out_count, &out_size_of);
-
-	auto tape_count = yamlNode[2].as<int32_t>();
-	auto tape_size_of = yamlNode[3].as<int32_t>();
-	// These warnings may be caused e.g. by gaussian noise (different seed -> different hits)
-	if (out_count != tape_count) {
-		RGL_WARN("tape_graph_get_result_size: actual count ({}) differs from tape count ({})", out_count, tape_count);
-	}
-	if (out_size_of != tape_size_of) {
-		RGL_WARN("tape_graph_get_result_size: actual sizeof ({}) differs from tape sizeof ({})", out_size_of, tape_size_of);
-	}
+	// CPUs are specific to the recording machine, like devices.
 }
 
-RGL_API rgl_status_t rgl_graph_get_result_data(rgl_node_t node, rgl_field_t field, void* dst)
+RGL_API void rgl_get_last_error_string(const char** out_error_string)
+{
+	if (out_error_string == nullptr) {
+		return;
+	}
+	// NO LOGGING HERE SINCE IT MAY THROW!
+	*out_error_string = getLastErrorString();
+}
+
+RGL_API rgl_status_t rgl_cleanup(void)
+{
+	auto status = rglSafeCall([&]() {
+		// First, delete nodes, because there might be a thread accessing other structures.
+		while (Node::instances.size() > 0) {
+			auto node = Node::instances.getAll().front();
+			if (node->hasGraphRunCtx()) {
+				try {
+					// This iterates over all nodes and may trigger pending exceptions
+					node->getGraphRunCtx()->detachAndDestroy();
+				}
+				catch (std::exception& e) {
+					RGL_WARN("rgl_cleanup: caught pending exception in Node {}: {}", node->getName(), e.what());
+					continue; // Some node has thrown exception so this graph has not been detached, try again
+				}
+			}
+			auto connectedNodes = node->disconnectConnectedNodes();
+			for (auto&& nodeToRelease : connectedNodes) {
+				Node::release(nodeToRelease->getHandle());
+			}
+		}
+		auto all = [](auto&&) { return true; };
+		Entity::instances.eraseIf(all);
+		for (auto&& mesh : Mesh::instances.getAll()) {
+			Mesh::retainReleased(mesh);
+		}
+		Mesh::instances.eraseIf(all);
+		Texture::instances.eraseIf(all);
+		for (auto&& scene : Scene::instances.getAll()) {
+			scene->clear();
+		}
+		Scene::instances.eraseIf(all);
+		Scene::defaultInstance()->clear();
+	});
+	TAPE_HOOK();
+	return status;
+}
+
+void TapeCore::tape_cleanup(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_cleanup();
+	state.clear();
+}
+
+RGL_API rgl_status_t rgl_mesh_create(rgl_mesh_t* out_mesh, const rgl_vec3f* vertices, int32_t vertex_count,
+                                     const rgl_vec3i* indices, int32_t index_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_create(out_mesh={}, vertices={}, indices={})", (void*) out_mesh, repr(vertices, vertex_count),
+		            repr(indices, index_count, 1));
+		CHECK_ARG(out_mesh != nullptr);
+		CHECK_ARG(vertices != nullptr);
+		CHECK_ARG(vertex_count > 0);
+		CHECK_ARG(indices != nullptr);
+		CHECK_ARG(index_count > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		*out_mesh = Mesh::createCached(reinterpret_cast<const Vec3f*>(vertices), vertex_count,
+		                               reinterpret_cast<const Vec3i*>(indices), index_count)
+		                ->getHandle();
+	});
+	TAPE_HOOK(out_mesh, TAPE_ARRAY(vertices, vertex_count), vertex_count, TAPE_ARRAY(indices, index_count), index_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_create(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_t mesh = nullptr;
+	rgl_mesh_create(&mesh, state.getPtr<const rgl_vec3f>(yamlNode[1]), yamlNode[2].as<int32_t>(),
+	                state.getPtr<const rgl_vec3i>(yamlNode[3]), yamlNode[4].as<int32_t>());
+	state.meshes.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), mesh));
+}
+
+RGL_API rgl_status_t rgl_mesh_create_batch(rgl_mesh_t* out_meshes, int32_t mesh_count, const rgl_vec3f* const* vertices,
+                                           const int32_t* vertex_counts, const rgl_vec3i* const* indices,
+                                           const int32_t* index_counts)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_create_batch(out_meshes={}, mesh_count={})", (void*) out_meshes, mesh_count);
+		CHECK_ARG(out_meshes != nullptr);
+		CHECK_ARG(mesh_count > 0);
+		CHECK_ARG(vertices != nullptr);
+		CHECK_ARG(vertex_counts != nullptr);
+		CHECK_ARG(indices != nullptr);
+		CHECK_ARG(index_counts != nullptr);
+		std::vector<Mesh::Geometry> geometries;
+		geometries.reserve(mesh_count);
+		for (int32_t i = 0; i < mesh_count; ++i) {
+			CHECK_ARG(vertices[i] != nullptr);
+			CHECK_ARG(vertex_counts[i] > 0);
+			CHECK_ARG(indices[i] != nullptr);
+			CHECK_ARG(index_counts[i] > 0);
+			geometries.emplace_back(Mesh::Geometry{
+			    .vertices = reinterpret_cast<const Vec3f*>(vertices[i]),
+			    .vertexCount = static_cast<std::size_t>(vertex_counts[i]),
+			    .indices = reinterpret_cast<const Vec3i*>(indices[i]),
+			    .indexCount = static_cast<std::size_t>(index_counts[i]),
+			});
+		}
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		auto meshes = Mesh::createBatch(geometries, Mesh::getStream());
+		for (int32_t i = 0; i < mesh_count; ++i) {
+			out_meshes[i] = meshes[i]->getHandle();
+		}
+	});
+	// Recorded as a sequence of rgl_mesh_create calls, which are equivalent.
+	if (status == RGL_SUCCESS) {
+		for (int32_t i = 0; i < mesh_count; ++i) {
+			TAPE_HOOK_AS("rgl_mesh_create", &out_meshes[i], TAPE_ARRAY(vertices[i], vertex_counts[i]), vertex_counts[i],
+			             TAPE_ARRAY(indices[i], index_counts[i]), index_counts[i]);
+		}
+	}
+	return status;
+}
+
+RGL_API rgl_status_t rgl_mesh_create_async(rgl_mesh_t* out_mesh, const rgl_vec3f* vertices, int32_t vertex_count,
+                                           const rgl_vec3i* indices, int32_t index_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_create_async(out_mesh={}, vertices={}, indices={})", (void*) out_mesh,
+		            repr(vertices, vertex_count), repr(indices, index_count, 1));
+		CHECK_ARG(out_mesh != nullptr);
+		CHECK_ARG(vertices != nullptr);
+		CHECK_ARG(vertex_count > 0);
+		CHECK_ARG(indices != nullptr);
+		CHECK_ARG(index_count > 0);
+		// No IdleGraphsGuard: the mesh is not used by any graph until it is ready.
+		auto* vertexData = reinterpret_cast<const Vec3f*>(vertices);
+		auto* indexData = reinterpret_cast<const Vec3i*>(indices);
+		*out_mesh = Mesh::createStreamed({vertexData, vertexData + vertex_count}, {indexData, indexData + index_count})
+		                ->getHandle();
+	});
+	TAPE_HOOK(out_mesh, TAPE_ARRAY(vertices, vertex_count), vertex_count, TAPE_ARRAY(indices, index_count), index_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_create_async(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_t mesh = nullptr;
+	rgl_mesh_create_async(&mesh, state.getPtr<const rgl_vec3f>(yamlNode[1]), yamlNode[2].as<int32_t>(),
+	                      state.getPtr<const rgl_vec3i>(yamlNode[3]), yamlNode[4].as<int32_t>());
+	state.meshes.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), mesh));
+}
+
+RGL_API rgl_status_t rgl_mesh_create_spheres(rgl_mesh_t* out_mesh, const rgl_vec3f* centers, const float* radii,
+                                             int32_t sphere_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_create_spheres(out_mesh={}, centers={}, radii={})", (void*) out_mesh,
+		            repr(centers, sphere_count), repr(radii, sphere_count));
+		CHECK_ARG(out_mesh != nullptr);
+		CHECK_ARG(centers != nullptr);
+		CHECK_ARG(radii != nullptr);
+		CHECK_ARG(sphere_count > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		*out_mesh = Mesh::createSpheres(reinterpret_cast<const Vec3f*>(centers), radii, sphere_count)->getHandle();
+	});
+	TAPE_HOOK(out_mesh, TAPE_ARRAY(centers, sphere_count), TAPE_ARRAY(radii, sphere_count), sphere_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_create_spheres(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_t mesh = nullptr;
+	rgl_mesh_create_spheres(&mesh, state.getPtr<const rgl_vec3f>(yamlNode[1]), state.getPtr<const float>(yamlNode[2]),
+	                        yamlNode[3].as<int32_t>());
+	state.meshes.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), mesh));
+}
+
+RGL_API rgl_status_t rgl_mesh_create_curves(rgl_mesh_t* out_mesh, const rgl_vec3f* vertices, const float* radii,
+                                            int32_t vertex_count, const int32_t* segment_indices, int32_t segment_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_create_curves(out_mesh={}, vertices={}, radii={}, segment_indices={})", (void*) out_mesh,
+		            repr(vertices, vertex_count), repr(radii, vertex_count), repr(segment_indices, segment_count));
+		CHECK_ARG(out_mesh != nullptr);
+		CHECK_ARG(vertices != nullptr);
+		CHECK_ARG(radii != nullptr);
+		CHECK_ARG(vertex_count > 1);
+		CHECK_ARG(segment_indices != nullptr);
+		CHECK_ARG(segment_count > 0);
+		for (int32_t i = 0; i < segment_count; ++i) {
+			CHECK_ARG(segment_indices[i] >= 0);
+		}
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		*out_mesh = Mesh::createCurves(reinterpret_cast<const Vec3f*>(vertices), radii, vertex_count,
+		                               reinterpret_cast<const uint32_t*>(segment_indices), segment_count)
+		                ->getHandle();
+	});
+	TAPE_HOOK(out_mesh, TAPE_ARRAY(vertices, vertex_count), TAPE_ARRAY(radii, vertex_count), vertex_count,
+	          TAPE_ARRAY(segment_indices, segment_count), segment_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_create_curves(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_t mesh = nullptr;
+	rgl_mesh_create_curves(&mesh, state.getPtr<const rgl_vec3f>(yamlNode[1]), state.getPtr<const float>(yamlNode[2]),
+	                       yamlNode[3].as<int32_t>(), state.getPtr<const int32_t>(yamlNode[4]), yamlNode[5].as<int32_t>());
+	state.meshes.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), mesh));
+}
+
+RGL_API rgl_status_t rgl_mesh_is_ready(rgl_mesh_t mesh, bool* out_ready)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_is_ready(mesh={}, out_ready={})", (void*) mesh, (void*) out_ready);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(out_ready != nullptr);
+		auto meshPtr = Mesh::validatePtr(mesh);
+		*out_ready = meshPtr->isReady();
+		if (!*out_ready && !meshPtr->isStreamingPending()) {
+			meshPtr->waitForStreaming(); // Rethrows the error of the upload
+		}
+	});
+	TAPE_HOOK(mesh, out_ready);
+	return status;
+}
+
+void TapeCore::tape_mesh_is_ready(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	bool ready = false;
+	rgl_mesh_is_ready(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), &ready);
+}
+
+RGL_API rgl_status_t rgl_mesh_set_texture_coords(rgl_mesh_t mesh, const rgl_vec2f* uvs, int32_t uv_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_set_texture_coords(mesh={}, uvs={}, uv_count={})", (void*) mesh, repr(uvs, uv_count), uv_count);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(uvs != nullptr);
+		CHECK_ARG(uv_count > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::validatePtr(mesh)->setTexCoords(reinterpret_cast<const Vec2f*>(uvs), uv_count);
+	});
+	TAPE_HOOK(mesh, TAPE_ARRAY(uvs, uv_count), uv_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_set_texture_coords(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_set_texture_coords(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_vec2f>(yamlNode[1]),
+	                            yamlNode[2].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_mesh_set_opacity_micromap(rgl_mesh_t mesh, const void* alpha_texels, int32_t width, int32_t height,
+                                                   float alpha_cutoff, int32_t subdivision_level)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_set_opacity_micromap(mesh={}, alpha_texels={}, width={}, height={}, alpha_cutoff={}, "
+		            "subdivision_level={})",
+		            (void*) mesh, alpha_texels, width, height, alpha_cutoff, subdivision_level);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(alpha_texels != nullptr);
+		CHECK_ARG(width > 0);
+		CHECK_ARG(height > 0);
+		CHECK_ARG(subdivision_level >= 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::validatePtr(mesh)->setOpacityMicromap(static_cast<const uint8_t*>(alpha_texels), width, height, alpha_cutoff,
+		                                            subdivision_level);
+	});
+	TAPE_HOOK(mesh, TAPE_ARRAY(alpha_texels, (width * height * sizeof(TextureTexelFormat))), width, height, alpha_cutoff,
+	          subdivision_level);
+	return status;
+}
+
+void TapeCore::tape_mesh_set_opacity_micromap(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_set_opacity_micromap(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const void>(yamlNode[1]),
+	                              yamlNode[2].as<int32_t>(), yamlNode[3].as<int32_t>(), yamlNode[4].as<float>(),
+	                              yamlNode[5].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_mesh_destroy(rgl_mesh_t mesh)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_destroy(mesh={})", (void*) mesh);
+		CHECK_ARG(mesh != nullptr);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		auto retained = Mesh::validatePtr(mesh);
+		Mesh::release(mesh);
+		Mesh::retainReleased(retained);
+	});
+	TAPE_HOOK(mesh);
+	return status;
+}
+
+void TapeCore::tape_mesh_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto meshId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_mesh_destroy(state.meshes.at(meshId));
+	state.meshes.erase(meshId);
+}
+
+RGL_API rgl_status_t rgl_mesh_update_vertices(rgl_mesh_t mesh, const rgl_vec3f* vertices, int32_t vertex_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_update_vertices(mesh={}, vertices={})", (void*) mesh, repr(vertices, vertex_count));
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(vertices != nullptr);
+		CHECK_ARG(vertex_count > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::validatePtr(mesh)->updateVertices(reinterpret_cast<const Vec3f*>(vertices), vertex_count);
+	});
+	TAPE_HOOK(mesh, TAPE_ARRAY(vertices, vertex_count), vertex_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_update_vertices(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_update_vertices(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_vec3f>(yamlNode[1]),
+	                         yamlNode[2].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_mesh_update_vertices_batch(const rgl_mesh_t* meshes, int32_t mesh_count,
+                                                    const rgl_vec3f* const* vertices, const int32_t* vertex_counts)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_update_vertices_batch(meshes={}, mesh_count={})", (void*) meshes, mesh_count);
+		CHECK_ARG(meshes != nullptr);
+		CHECK_ARG(mesh_count > 0);
+		CHECK_ARG(vertices != nullptr);
+		CHECK_ARG(vertex_counts != nullptr);
+		std::vector<std::shared_ptr<Mesh>> meshPtrs;
+		std::vector<std::pair<const Vec3f*, std::size_t>> meshVertices;
+		meshPtrs.reserve(mesh_count);
+		meshVertices.reserve(mesh_count);
+		for (int32_t i = 0; i < mesh_count; ++i) {
+			CHECK_ARG(meshes[i] != nullptr);
+			CHECK_ARG(vertices[i] != nullptr);
+			CHECK_ARG(vertex_counts[i] > 0);
+			meshPtrs.emplace_back(Mesh::validatePtr(meshes[i]));
+			meshVertices.emplace_back(reinterpret_cast<const Vec3f*>(vertices[i]), vertex_counts[i]);
+		}
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::updateVerticesBatch(meshPtrs, meshVertices, Mesh::getStream());
+	});
+	// Recorded as a sequence of rgl_mesh_update_vertices calls, which are equivalent.
+	if (status == RGL_SUCCESS) {
+		for (int32_t i = 0; i < mesh_count; ++i) {
+			TAPE_HOOK_AS("rgl_mesh_update_vertices", meshes[i], TAPE_ARRAY(vertices[i], vertex_counts[i]), vertex_counts[i]);
+		}
+	}
+	return status;
+}
+
+RGL_API rgl_status_t rgl_mesh_set_skinning(rgl_mesh_t mesh, const int32_t* bone_indices, const float* bone_weights,
+                                           int32_t vertex_count, int32_t bone_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_set_skinning(mesh={}, bone_indices={}, bone_weights={}, bone_count={})", (void*) mesh,
+		            repr(bone_indices, 4 * vertex_count), repr(bone_weights, 4 * vertex_count), bone_count);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(bone_indices != nullptr);
+		CHECK_ARG(bone_weights != nullptr);
+		CHECK_ARG(vertex_count > 0);
+		CHECK_ARG(bone_count > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::validatePtr(mesh)->setSkinning(reinterpret_cast<const Vec4i*>(bone_indices),
+		                                     reinterpret_cast<const Vec4f*>(bone_weights), vertex_count, bone_count);
+	});
+	TAPE_HOOK(mesh, TAPE_ARRAY(bone_indices, 4 * vertex_count), TAPE_ARRAY(bone_weights, 4 * vertex_count), vertex_count,
+	          bone_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_set_skinning(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_set_skinning(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const int32_t>(yamlNode[1]),
+	                      state.getPtr<const float>(yamlNode[2]), yamlNode[3].as<int32_t>(), yamlNode[4].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_mesh_update_bones(rgl_mesh_t mesh, const rgl_mat3x4f* bone_transforms, int32_t bone_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_update_bones(mesh={}, bone_transforms={})", (void*) mesh, repr(bone_transforms, bone_count));
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(bone_transforms != nullptr);
+		CHECK_ARG(bone_count > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		std::vector<Mat3x4f> boneTransforms;
+		boneTransforms.reserve(bone_count);
+		for (int32_t i = 0; i < bone_count; ++i) {
+			boneTransforms.emplace_back(Mat3x4f::fromRGL(bone_transforms[i]));
+		}
+		Mesh::validatePtr(mesh)->updateBones(boneTransforms.data(), boneTransforms.size());
+	});
+	TAPE_HOOK(mesh, TAPE_ARRAY(bone_transforms, bone_count), bone_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_update_bones(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_update_bones(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_mat3x4f>(yamlNode[1]),
+	                      yamlNode[2].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_mesh_set_keyframes(rgl_mesh_t mesh, const rgl_vec3f* vertices, int32_t vertex_count,
+                                            int32_t keyframe_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_set_keyframes(mesh={}, vertices={}, keyframe_count={})", (void*) mesh,
+		            repr(vertices, vertex_count), keyframe_count);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(vertices != nullptr);
+		CHECK_ARG(vertex_count > 0);
+		CHECK_ARG(keyframe_count > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::validatePtr(mesh)->setKeyframes(reinterpret_cast<const Vec3f*>(vertices), vertex_count, keyframe_count);
+	});
+	TAPE_HOOK(mesh, TAPE_ARRAY(vertices, vertex_count), vertex_count, keyframe_count);
+	return status;
+}
+
+void TapeCore::tape_mesh_set_keyframes(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_set_keyframes(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_vec3f>(yamlNode[1]),
+	                       yamlNode[2].as<int32_t>(), yamlNode[3].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_mesh_set_keyframe(rgl_mesh_t mesh, int32_t keyframe_index)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_set_keyframe(mesh={}, keyframe_index={})", (void*) mesh, keyframe_index);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(keyframe_index >= 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::validatePtr(mesh)->setKeyframe(keyframe_index);
+	});
+	TAPE_HOOK(mesh, keyframe_index);
+	return status;
+}
+
+void TapeCore::tape_mesh_set_keyframe(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_set_keyframe(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_mesh_compress(rgl_mesh_t mesh, rgl_vertex_format_t vertex_format)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_mesh_compress(mesh={}, vertex_format={})", (void*) mesh, vertex_format);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(vertex_format >= RGL_VERTEX_FORMAT_FLOAT32 && vertex_format <= RGL_VERTEX_FORMAT_SNORM16);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Mesh::validatePtr(mesh)->compress(vertex_format);
+	});
+	TAPE_HOOK(mesh, vertex_format);
+	return status;
+}
+
+void TapeCore::tape_mesh_compress(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_mesh_compress(state.meshes.at(yamlNode[0].as<TapeAPIObjectID>()), (rgl_vertex_format_t) yamlNode[1].as<size_t>());
+}
+
+rgl_status_t rgl_mesh_is_alive(rgl_mesh_t mesh, bool* out_alive)
+{
+	auto status = rglSafeCall([&]() {
+		CHECK_ARG(out_alive != nullptr);
+		*out_alive = Mesh::isAlive(mesh);
+	});
+	TAPE_HOOK(mesh, out_alive);
+	return status;
+}
+
+RGL_API rgl_status_t rgl_entity_create(rgl_entity_t* out_entity, rgl_scene_t scene, rgl_mesh_t mesh)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_create(out_entity={}, scene={}, mesh={})", (void*) out_entity, (void*) scene, (void*) mesh);
+		CHECK_ARG(out_entity != nullptr);
+		CHECK_ARG(mesh != nullptr);
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		*out_entity = Entity::create(Mesh::validatePtr(mesh), Scene::validateOrDefault(scene))->getHandle();
+	});
+	TAPE_HOOK(out_entity, scene, mesh);
+	return status;
+}
+
+void TapeCore::tape_entity_create(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_t entity = nullptr;
+	rgl_entity_create(&entity, state.getScene(yamlNode[1]), state.meshes.at(yamlNode[2].as<TapeAPIObjectID>()));
+	state.entities.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), entity));
+}
+
+RGL_API rgl_status_t rgl_entity_create_instanced(rgl_entity_t* out_entities, rgl_scene_t scene, rgl_mesh_t mesh,
+                                                 const rgl_mat3x4f* transforms, int32_t count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_create_instanced(out_entities={}, scene={}, mesh={}, transforms={}, count={})",
+		            (void*) out_entities, (void*) scene, (void*) mesh, (void*) transforms, count);
+		CHECK_ARG(out_entities != nullptr);
+		CHECK_ARG(mesh != nullptr);
+		CHECK_ARG(transforms != nullptr);
+		CHECK_ARG(count > 0);
+		std::vector<Mat3x4f> tfs;
+		tfs.reserve(count);
+		for (int32_t i = 0; i < count; ++i) {
+			tfs.emplace_back(Mat3x4f::fromRGL(transforms[i]));
+		}
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		auto entities = Entity::createInstanced(Mesh::validatePtr(mesh), Scene::validateOrDefault(scene), tfs.data(), count);
+		for (int32_t i = 0; i < count; ++i) {
+			out_entities[i] = entities[i]->getHandle();
+		}
+	});
+	// Recorded as a sequence of rgl_entity_create and rgl_entity_set_pose calls, which are equivalent.
+	if (status == RGL_SUCCESS) {
+		for (int32_t i = 0; i < count; ++i) {
+			TAPE_HOOK_AS("rgl_entity_create", &out_entities[i], scene, mesh);
+			TAPE_HOOK_AS("rgl_entity_set_pose", out_entities[i], &transforms[i]);
+		}
+	}
+	return status;
+}
+
+RGL_API rgl_status_t rgl_entity_destroy(rgl_entity_t entity)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_destroy(entity={})", (void*) entity);
+		CHECK_ARG(entity != nullptr);
+		// Running graphs use scene snapshots, which retain entity's mesh and texture.
+		auto entitySafe = Entity::validatePtr(entity);
+		auto editsLock = Scene::lockEdits();
+		entitySafe->getScene().removeEntity(entitySafe);
+		Entity::release(entity);
+	});
+	TAPE_HOOK(entity);
+	return status;
+}
+
+void TapeCore::tape_entity_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto entityId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_entity_destroy(state.entities.at(entityId));
+	state.entities.erase(entityId);
+}
+
+RGL_API rgl_status_t rgl_entity_set_pose(rgl_entity_t entity, const rgl_mat3x4f* transform)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_pose(entity={}, transform={})", (void*) entity, repr(transform, 1));
+		CHECK_ARG(entity != nullptr);
+		CHECK_ARG(transform != nullptr);
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto tf = Mat3x4f::fromRaw(reinterpret_cast<const float*>(&transform->value[0][0]));
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setTransform(tf);
+	});
+	TAPE_HOOK(entity, transform);
+	return status;
+}
+
+void TapeCore::tape_entity_set_pose(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_set_pose(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), state.getPtr<const rgl_mat3x4f>(yamlNode[1]));
+}
+
+RGL_API rgl_status_t rgl_entity_set_pose_batch(const rgl_entity_t* entities, int32_t entity_count,
+                                               const rgl_mat3x4f* transforms)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_pose_batch(entities={}, entity_count={}, transforms={})", (void*) entities, entity_count,
+		            (void*) transforms);
+		CHECK_ARG(entities != nullptr);
+		CHECK_ARG(entity_count > 0);
+		CHECK_ARG(transforms != nullptr);
+		// Validate everything first to avoid partial update
+		std::vector<std::shared_ptr<Entity>> entityPtrs;
+		entityPtrs.reserve(entity_count);
+		for (int32_t i = 0; i < entity_count; ++i) {
+			CHECK_ARG(entities[i] != nullptr);
+			entityPtrs.emplace_back(Entity::validatePtr(entities[i]));
+		}
+		// Running graphs use scene snapshots, no need to synchronize them.
+		// Transforms only invalidate the IAS, which is refitted once, when the next graph run acquires a snapshot.
+		auto editsLock = Scene::lockEdits();
+		for (int32_t i = 0; i < entity_count; ++i) {
+			entityPtrs[i]->setTransform(Mat3x4f::fromRaw(reinterpret_cast<const float*>(&transforms[i].value[0][0])));
+		}
+	});
+	// Recorded as a sequence of rgl_entity_set_pose calls, which are equivalent.
+	if (status == RGL_SUCCESS) {
+		for (int32_t i = 0; i < entity_count; ++i) {
+			TAPE_HOOK_AS("rgl_entity_set_pose", entities[i], &transforms[i]);
+		}
+	}
+	return status;
+}
+
+RGL_API rgl_status_t rgl_entity_set_pose_batch_device(const rgl_entity_t* entities, int32_t entity_count,
+                                                      const rgl_mat3x4f* device_transforms, void* ready_event)
+{
+	std::vector<rgl_mat3x4f> tapedTransforms;
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_pose_batch_device(entities={}, entity_count={}, device_transforms={}, ready_event={})",
+		            (void*) entities, entity_count, (void*) device_transforms, ready_event);
+		CHECK_ARG(entities != nullptr);
+		CHECK_ARG(entity_count > 0);
+		CHECK_ARG(device_transforms != nullptr);
+		std::vector<std::shared_ptr<Entity>> entityPtrs;
+		entityPtrs.reserve(entity_count);
+		std::set<Entity*> uniqueEntities;
+		for (int32_t i = 0; i < entity_count; ++i) {
+			CHECK_ARG(entities[i] != nullptr);
+			entityPtrs.emplace_back(Entity::validatePtr(entities[i]));
+			if (!uniqueEntities.insert(entityPtrs.back().get()).second) {
+				throw std::invalid_argument(fmt::format("entity {} is repeated", (void*) entities[i]));
+			}
+			if (&entityPtrs.back()->getScene() != &entityPtrs.front()->getScene()) {
+				throw std::invalid_argument("all entities must belong to the same scene");
+			}
+		}
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		entityPtrs.front()->getScene().setEntityTransformsFromDevice(entityPtrs,
+		                                                             reinterpret_cast<const Mat3x4f*>(device_transforms),
+		                                                             static_cast<cudaEvent_t>(ready_event));
+		// Transforms were read (the event has completed), copying them to the host is needed only when recording.
+		if (tapeRecorder.has_value()) {
+			tapedTransforms.resize(entity_count);
+			CHECK_CUDA(cudaMemcpy(tapedTransforms.data(), device_transforms, entity_count * sizeof(rgl_mat3x4f),
+			                      cudaMemcpyDeviceToHost));
+		}
+	});
+	// Recorded as a sequence of rgl_entity_set_pose calls, which are equivalent.
+	if (status == RGL_SUCCESS && !tapedTransforms.empty()) {
+		for (int32_t i = 0; i < entity_count; ++i) {
+			TAPE_HOOK_AS("rgl_entity_set_pose", entities[i], &tapedTransforms[i]);
+		}
+	}
+	return status;
+}
+
+RGL_API rgl_status_t rgl_entity_set_id(rgl_entity_t entity, int32_t id)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_id(entity={}, id={})", (void*) entity, id);
+		CHECK_ARG(entity != nullptr);
+		CHECK_ARG(id != RGL_ENTITY_INVALID_ID);
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setId(id);
+	});
+	TAPE_HOOK(entity, id);
+	return status;
+}
+
+void TapeCore::tape_entity_set_id(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_set_id(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<Field<ENTITY_ID_I32>::type>());
+}
+
+RGL_API rgl_status_t rgl_entity_set_class_id(rgl_entity_t entity, int32_t class_id)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_class_id(entity={}, class_id={})", (void*) entity, class_id);
+		CHECK_ARG(entity != nullptr);
+		CHECK_ARG(class_id >= 0 && class_id <= std::numeric_limits<Field<CLASS_ID_U16>::type>::max());
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setClassId(static_cast<Field<CLASS_ID_U16>::type>(class_id));
+	});
+	TAPE_HOOK(entity, class_id);
+	return status;
+}
+
+void TapeCore::tape_entity_set_class_id(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_set_class_id(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_entity_set_intensity(rgl_entity_t entity, float intensity)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_intensity(entity={}, intensity={})", (void*) entity, intensity);
+		CHECK_ARG(entity != nullptr);
+		CHECK_ARG(std::isfinite(intensity) && intensity >= 0.0f);
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setIntensity(intensity);
+	});
+	TAPE_HOOK(entity, intensity);
+	return status;
+}
+
+void TapeCore::tape_entity_set_intensity(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_set_intensity(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<float>());
+}
+
+RGL_API rgl_status_t rgl_entity_set_intensity_texture(rgl_entity_t entity, rgl_texture_t texture)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_intensity_texture(entity={}, texture={})", (void*) entity, (void*) texture);
+		CHECK_ARG(entity != nullptr);
+		CHECK_ARG(texture != nullptr);
+		// Running graphs use scene snapshots, which retain the previous texture.
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setIntensityTexture(Texture::validatePtr(texture));
+	});
+
+	TAPE_HOOK(entity, texture);
+	return status;
+}
+
+void TapeCore::tape_entity_set_intensity_texture(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_set_intensity_texture(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                                 state.textures.at(yamlNode[1].as<TapeAPIObjectID>()));
+}
+
+RGL_API rgl_status_t rgl_entity_set_lod_mesh(rgl_entity_t entity, rgl_mesh_t mesh, float min_distance)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_lod_mesh(entity={}, mesh={}, min_distance={})", (void*) entity, (void*) mesh,
+		            min_distance);
+		CHECK_ARG(entity != nullptr);
+		CHECK_ARG(min_distance > 0.0f);
+		// Running graphs use scene snapshots, which retain meshes selected previously.
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setLodMesh(min_distance, mesh != nullptr ? Mesh::validatePtr(mesh) : nullptr);
+	});
+	TAPE_HOOK(entity, mesh, min_distance);
+	return status;
+}
+
+void TapeCore::tape_entity_set_lod_mesh(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto meshId = yamlNode[1].as<TapeAPIObjectID>();
+	rgl_entity_set_lod_mesh(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                        meshId == 0 ? nullptr : state.meshes.at(meshId), yamlNode[2].as<float>());
+}
+
+RGL_API rgl_status_t rgl_entity_set_visibility_mask(rgl_entity_t entity, int32_t mask)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_visibility_mask(entity={}, mask={:#x})", (void*) entity, mask);
+		CHECK_ARG(entity != nullptr);
+		CHECK_ARG(mask >= 0 && mask <= 0xFF);
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setVisibilityMask(static_cast<uint8_t>(mask));
+	});
+	TAPE_HOOK(entity, mask);
+	return status;
+}
+
+void TapeCore::tape_entity_set_visibility_mask(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_set_visibility_mask(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_entity_set_static(rgl_entity_t entity, bool is_static)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_entity_set_static(entity={}, is_static={})", (void*) entity, is_static);
+		CHECK_ARG(entity != nullptr);
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		Entity::validatePtr(entity)->setStatic(is_static);
+	});
+	TAPE_HOOK(entity, is_static);
+	return status;
+}
+
+void TapeCore::tape_entity_set_static(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_entity_set_static(state.entities.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<bool>());
+}
+
+rgl_status_t rgl_entity_is_alive(rgl_entity_t entity, bool* out_alive)
+{
+	auto status = rglSafeCall([&]() {
+		CHECK_ARG(out_alive != nullptr);
+		*out_alive = Entity::isAlive(entity);
+	});
+	TAPE_HOOK(entity, out_alive);
+	return status;
+}
+
+RGL_API rgl_status_t rgl_texture_create(rgl_texture_t* out_texture, const void* texels, int32_t width, int32_t height)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_texture_create(out_texture={}, width={}, height={})", (void*) out_texture, width, height);
+		CHECK_ARG(out_texture != nullptr);
+		CHECK_ARG(texels != nullptr);
+		CHECK_ARG(width > 0);
+		CHECK_ARG(height > 0);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		*out_texture = Texture::create(texels, width, height)->getHandle();
+	});
+	TAPE_HOOK(out_texture, TAPE_ARRAY(texels, (width * height * sizeof(TextureTexelFormat))), width, height);
+	return status;
+}
+
+void TapeCore::tape_texture_create(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_texture_t texture = nullptr;
+
+	rgl_texture_create(&texture, state.getPtr<const void>(yamlNode[1]), yamlNode[2].as<int32_t>(), yamlNode[3].as<int32_t>());
+
+	state.textures.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), texture));
+}
+
+RGL_API rgl_status_t rgl_texture_create_mipmapped(rgl_texture_t* out_texture, const void* texels, int32_t width,
+                                                  int32_t height, int32_t mip_level_count, rgl_texture_format_t format)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_texture_create_mipmapped(out_texture={}, width={}, height={}, mip_level_count={}, format={})",
+		            (void*) out_texture, width, height, mip_level_count, format);
+		CHECK_ARG(out_texture != nullptr);
+		CHECK_ARG(texels != nullptr);
+		CHECK_ARG(width > 0);
+		CHECK_ARG(height > 0);
+		CHECK_ARG(mip_level_count > 0);
+		CHECK_ARG(format >= RGL_TEXTURE_FORMAT_R8 && format <= RGL_TEXTURE_FORMAT_BC4);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		*out_texture = Texture::create(texels, width, height, mip_level_count, format)->getHandle();
+	});
+	TAPE_HOOK(out_texture, TAPE_ARRAY(texels, (width * height * sizeof(TextureTexelFormat))), width, height, mip_level_count,
+	          format);
+	return status;
+}
+
+void TapeCore::tape_texture_create_mipmapped(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_texture_t texture = nullptr;
+	rgl_texture_create_mipmapped(&texture, state.getPtr<const void>(yamlNode[1]), yamlNode[2].as<int32_t>(),
+	                             yamlNode[3].as<int32_t>(), yamlNode[4].as<int32_t>(),
+	                             (rgl_texture_format_t) yamlNode[5].as<size_t>());
+	state.textures.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), texture));
+}
+
+RGL_API rgl_status_t rgl_texture_destroy(rgl_texture_t texture)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_texture_destroy(texture={})", (void*) texture);
+		CHECK_ARG(texture != nullptr);
+		IdleGraphsGuard idleGraphs; // Prevent races with graph threads
+		Texture::release(texture);
+	});
+	TAPE_HOOK(texture);
+	return status;
+}
+
+void TapeCore::tape_texture_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto textureId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_texture_destroy(state.textures.at(textureId));
+	state.textures.erase(textureId);
+}
+
+rgl_status_t rgl_texture_is_alive(rgl_texture_t texture, bool* out_alive)
+{
+	auto status = rglSafeCall([&]() {
+		CHECK_ARG(out_alive != nullptr);
+		*out_alive = Texture::isAlive(texture);
+	});
+	TAPE_HOOK(texture, out_alive);
+	return status;
+}
+
+RGL_API rgl_status_t rgl_scene_create(rgl_scene_t* out_scene)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_create(out_scene={})", (void*) out_scene);
+		CHECK_ARG(out_scene != nullptr);
+		*out_scene = Scene::create()->getHandle();
+	});
+	TAPE_HOOK(out_scene);
+	return status;
+}
+
+void TapeCore::tape_scene_create(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_scene_t scene = nullptr;
+	rgl_scene_create(&scene);
+	state.scenes.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), scene));
+}
+
+RGL_API rgl_status_t rgl_scene_destroy(rgl_scene_t scene)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_destroy(scene={})", (void*) scene);
+		CHECK_ARG(scene != nullptr);
+		auto sceneSafe = Scene::validatePtr(scene);
+		IdleGraphsGuard idleGraphs{sceneSafe.get()}; // Prevent races with graph threads
+		Entity::instances.eraseIf([&](auto&& entity) { return &entity->getScene() == sceneSafe.get(); });
+		sceneSafe->clear();
+		Scene::release(scene);
+	});
+	TAPE_HOOK(scene);
+	return status;
+}
+
+void TapeCore::tape_scene_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto sceneId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_scene_destroy(state.scenes.at(sceneId));
+	state.scenes.erase(sceneId);
+}
+
+RGL_API rgl_status_t rgl_scene_fork(rgl_scene_t* out_scene, rgl_scene_t scene, const rgl_entity_t* entities,
+                                    int32_t entity_count, rgl_entity_t* out_entities)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_fork(out_scene={}, scene={}, entities={}, entity_count={}, out_entities={})", (void*) out_scene,
+		            (void*) scene, (void*) entities, entity_count, (void*) out_entities);
+		CHECK_ARG(out_scene != nullptr);
+		CHECK_ARG(entity_count >= 0);
+		CHECK_ARG(entity_count == 0 || entities != nullptr);
+		CHECK_ARG(entity_count == 0 || out_entities != nullptr);
+		auto sceneSafe = Scene::validateOrDefault(scene);
+		std::vector<const Entity*> forkedEntities;
+		forkedEntities.reserve(entity_count);
+		for (int32_t i = 0; i < entity_count; ++i) {
+			CHECK_ARG(entities[i] != nullptr);
+			const auto& entity = Entity::validatePtr(entities[i]);
+			if (&entity->getScene() != sceneSafe.get()) {
+				auto msg = fmt::format("Invalid argument: entity {} does not belong to the forked scene", (void*) entities[i]);
+				throw std::invalid_argument(msg);
+			}
+			forkedEntities.emplace_back(entity.get());
+		}
+		// Running graphs use scene snapshots, no need to synchronize them.
+		auto editsLock = Scene::lockEdits();
+		std::unordered_map<const Entity*, std::shared_ptr<Entity>> copies;
+		auto forked = sceneSafe->fork(copies);
+		for (int32_t i = 0; i < entity_count; ++i) {
+			out_entities[i] = copies.at(forkedEntities[i])->getHandle();
+		}
+		*out_scene = forked->getHandle();
+	});
+	TAPE_HOOK(out_scene, scene, TAPE_ARRAY(entities, entity_count), entity_count, TAPE_ARRAY(out_entities, entity_count));
+	return status;
+}
+
+void TapeCore::tape_scene_fork(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto entityCount = yamlNode[3].as<int32_t>();
+	std::vector<rgl_entity_t> entities, outEntities(entityCount);
+	if (entityCount > 0) {
+		const auto* entityIds = state.getPtr<const rgl_entity_t>(yamlNode[2]);
+		for (int32_t i = 0; i < entityCount; ++i) {
+			entities.emplace_back(state.entities.at(reinterpret_cast<TapeAPIObjectID>(entityIds[i])));
+		}
+	}
+	rgl_scene_t scene = nullptr;
+	rgl_scene_fork(&scene, state.getScene(yamlNode[1]), entities.data(), entityCount, outEntities.data());
+	state.scenes.insert(std::make_pair(yamlNode[0].as<TapeAPIObjectID>(), scene));
+	if (entityCount > 0) {
+		const auto* outEntityIds = state.getPtr<const rgl_entity_t>(yamlNode[4]);
+		for (int32_t i = 0; i < entityCount; ++i) {
+			state.entities.insert(std::make_pair(reinterpret_cast<TapeAPIObjectID>(outEntityIds[i]), outEntities[i]));
+		}
+	}
+}
+
+RGL_API rgl_status_t rgl_scene_set_time(rgl_scene_t scene, uint64_t nanoseconds)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_set_time(scene={}, nanoseconds={})", (void*) scene, nanoseconds);
+		auto sceneSafe = Scene::validateOrDefault(scene);
+		// Running graphs use scene snapshots (including time), but GAS compaction may replace GASes in use.
+		// Meshes are shared by scenes, so graphs of all scenes are affected.
+		std::optional<IdleGraphsGuard> idleGraphs;
+		if (sceneSafe->isGASCompactionEnabled()) {
+			idleGraphs.emplace(); // Prevent races with graph threads
+		}
+
+		auto editsLock = Scene::lockEdits();
+		sceneSafe->setTime(Time::nanoseconds(nanoseconds));
+	});
+	TAPE_HOOK(scene, nanoseconds);
+	return status;
+}
+
+void TapeCore::tape_scene_set_time(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_scene_set_time(state.getScene(yamlNode[0]), yamlNode[1].as<uint64_t>());
+}
+
+RGL_API rgl_status_t rgl_scene_configure_gas_compaction(rgl_scene_t scene, bool enable, int32_t static_frame_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_configure_gas_compaction(scene={}, enable={}, static_frame_count={})", (void*) scene, enable,
+		            static_frame_count);
+		CHECK_ARG(static_frame_count >= 0);
+		auto sceneSafe = Scene::validateOrDefault(scene);
+		IdleGraphsGuard idleGraphs{sceneSafe.get()}; // Prevent races with graph threads
+
+		sceneSafe->setGASCompaction(enable ? std::optional<std::size_t>(static_frame_count) : std::nullopt);
+	});
+	TAPE_HOOK(scene, enable, static_frame_count);
+	return status;
+}
+
+void TapeCore::tape_scene_configure_gas_compaction(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_scene_configure_gas_compaction(state.getScene(yamlNode[0]), yamlNode[1].as<bool>(), yamlNode[2].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_scene_configure_raytrace_batching(rgl_scene_t scene, bool enable)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_configure_raytrace_batching(scene={}, enable={})", (void*) scene, enable);
+		auto sceneSafe = Scene::validateOrDefault(scene);
+		IdleGraphsGuard idleGraphs{sceneSafe.get()}; // Prevent races with graph threads
+
+		sceneSafe->setRaytraceBatching(enable);
+	});
+	TAPE_HOOK(scene, enable);
+	return status;
+}
+
+void TapeCore::tape_scene_configure_raytrace_batching(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_scene_configure_raytrace_batching(state.getScene(yamlNode[0]), yamlNode[1].as<bool>());
+}
+
+RGL_API rgl_status_t rgl_scene_set_lod_origin(rgl_scene_t scene, const rgl_vec3f* origin)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_set_lod_origin(scene={}, origin={})", (void*) scene, repr(origin));
+		CHECK_ARG(origin != nullptr);
+		// Running graphs use scene snapshots, the selection is updated when acquiring the next one.
+		auto editsLock = Scene::lockEdits();
+		Scene::validateOrDefault(scene)->setLodOrigin(Vec3f{origin->value[0], origin->value[1], origin->value[2]});
+	});
+	TAPE_HOOK(scene, origin);
+	return status;
+}
+
+void TapeCore::tape_scene_set_lod_origin(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_scene_set_lod_origin(state.getScene(yamlNode[0]), state.getPtr<const rgl_vec3f>(yamlNode[1]));
+}
+
+RGL_API rgl_status_t rgl_scene_raycast_batch(rgl_scene_t scene, const rgl_vec3f* origins, const rgl_vec3f* directions,
+                                             int32_t ray_count, float max_distance, rgl_raycast_hit_t* out_hits)
+{
+	std::vector<rgl_vec3f> tapedOrigins, tapedDirections;
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_scene_raycast_batch(scene={}, origins={}, directions={}, ray_count={}, max_distance={}, out_hits={})",
+		            (void*) scene, (void*) origins, (void*) directions, ray_count, max_distance, (void*) out_hits);
+		CHECK_ARG(origins != nullptr);
+		CHECK_ARG(directions != nullptr);
+		CHECK_ARG(ray_count > 0);
+		CHECK_ARG(max_distance > 0.0f);
+		CHECK_ARG(out_hits != nullptr);
+		auto sceneSafe = Scene::validateOrDefault(scene);
+		{
+			auto editsLock = Scene::lockEdits();
+			sceneSafe->raycastLocked(reinterpret_cast<const Vec3f*>(origins), reinterpret_cast<const Vec3f*>(directions),
+			                         ray_count, max_distance, out_hits);
+		}
+		// Arrays may be in device memory, copying them to the host is needed only when recording.
+		if (tapeRecorder.has_value()) {
+			tapedOrigins.resize(ray_count);
+			tapedDirections.resize(ray_count);
+			CHECK_CUDA(cudaMemcpy(tapedOrigins.data(), origins, ray_count * sizeof(rgl_vec3f), cudaMemcpyDefault));
+			CHECK_CUDA(cudaMemcpy(tapedDirections.data(), directions, ray_count * sizeof(rgl_vec3f), cudaMemcpyDefault));
+		}
+	});
+	if (status == RGL_SUCCESS && !tapedOrigins.empty()) {
+		TAPE_HOOK(scene, TAPE_ARRAY(tapedOrigins.data(), ray_count), TAPE_ARRAY(tapedDirections.data(), ray_count), ray_count,
+		          max_distance);
+	}
+	return status;
+}
+
+void TapeCore::tape_scene_raycast_batch(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	std::vector<rgl_raycast_hit_t> hits(yamlNode[3].as<int32_t>());
+	rgl_scene_raycast_batch(state.getScene(yamlNode[0]), state.getPtr<const rgl_vec3f>(yamlNode[1]),
+	                        state.getPtr<const rgl_vec3f>(yamlNode[2]), yamlNode[3].as<int32_t>(), yamlNode[4].as<float>(),
+	                        hits.data());
+}
+
+RGL_API rgl_status_t rgl_graph_run(rgl_node_t raw_node)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_run(node={})", repr(raw_node));
+		CHECK_ARG(raw_node != nullptr);
+		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_run"};
+		// Locks (in this order): runs (shared, see IdleGraphsGuard), the graph and scene edits (acquiring its snapshot).
+		GraphRunCtx::run(Node::validatePtr(raw_node));
+	});
+	TAPE_HOOK(raw_node);
+	return status;
+}
+
+void TapeCore::tape_graph_run(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_run(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()));
+}
+
+RGL_API rgl_status_t rgl_graph_prepare(rgl_node_t raw_node, int32_t max_ray_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_prepare(node={}, max_ray_count={})", repr(raw_node), max_ray_count);
+		CHECK_ARG(raw_node != nullptr);
+		CHECK_ARG(max_ray_count >= 0);
+		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_prepare"};
+		GraphRunCtx::prepare(Node::validatePtr(raw_node), max_ray_count);
+	});
+	TAPE_HOOK(raw_node, max_ray_count);
+	return status;
+}
+
+void TapeCore::tape_graph_prepare(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_prepare(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_graph_run_batch(const rgl_node_t* nodes, int32_t node_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_run_batch(nodes={}, node_count={})", (void*) nodes, node_count);
+		CHECK_ARG(nodes != nullptr);
+		CHECK_ARG(node_count > 0);
+		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_run_batch"};
+		std::vector<Node::Ptr> batchNodes;
+		batchNodes.reserve(node_count);
+		for (int32_t i = 0; i < node_count; ++i) {
+			CHECK_ARG(nodes[i] != nullptr);
+			batchNodes.emplace_back(Node::validatePtr(nodes[i]));
+		}
+		GraphRunCtx::runBatch(batchNodes);
+	});
+	// Recorded as a sequence of rgl_graph_run calls, which give the same results.
+	if (status == RGL_SUCCESS) {
+		for (int32_t i = 0; i < node_count; ++i) {
+			TAPE_HOOK_AS("rgl_graph_run", nodes[i]);
+		}
+	}
+	return status;
+}
+
+RGL_API rgl_status_t rgl_graph_destroy(rgl_node_t raw_node)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_destroy(node={})", repr(raw_node));
+		CHECK_ARG(raw_node != nullptr);
+		auto node = Node::validatePtr(raw_node);
+		if (node->hasGraphRunCtx()) {
+			node->getGraphRunCtx()->detachAndDestroy();
+		}
+		auto allNodes = node->disconnectConnectedNodes();
+		for (auto&& nodeToRelease : allNodes) {
+			Node::release(nodeToRelease.get());
+		}
+	});
+	TAPE_HOOK(raw_node);
+	return status;
+}
+
+void TapeCore::tape_graph_destroy(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_node_t userNode = state.nodes.at(yamlNode[0].as<TapeAPIObjectID>());
+	std::set<Node::Ptr> graph = Node::validatePtr(userNode)->getConnectedComponentNodes();
+	std::set<TapeAPIObjectID> graphNodeIds;
+
+	for (auto const& graphNode : graph) {
+		for (auto const& [key, val] : state.nodes) {
+			auto tapeNodePtr = Node::validatePtr(val).get();
+			if (graphNode.get() == tapeNodePtr) {
+				graphNodeIds.insert(key);
+				break;
+			}
+		}
+	}
+
+	rgl_graph_destroy(userNode);
+
+	while (!graphNodeIds.empty()) {
+		TapeAPIObjectID nodeId = *graphNodeIds.begin();
+		state.nodes.erase(nodeId);
+		graphNodeIds.erase(nodeId);
+	}
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_size(rgl_node_t node, rgl_field_t field, int32_t* out_count, int32_t* out_size_of)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_size(node={}, field={}, out_count={}, out_size_of={})", repr(node), field,
+		            (void*) out_count, (void*) out_size_of);
+		CHECK_ARG(node != nullptr);
+		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_get_result_size"};
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		pointCloudNode->waitForResults();
+		auto elemCount = (int32_t) pointCloudNode->getPointCount();
+		auto elemSize = (int32_t) pointCloudNode->getFieldPointSize(field);
+
+		if (out_count != nullptr) {
+			*out_count = elemCount;
+		}
+		if (out_size_of != nullptr) {
+			*out_size_of = elemSize;
+		}
+	});
+	TAPE_HOOK(node, field, out_count, out_size_of);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_size(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	int32_t out_count, out_size_of;
+	rgl_graph_get_result_size(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), (rgl_field_t) yamlNode[1].as<int>(),
+	                          &out_count, &out_size_of);
+
+	auto tape_count = yamlNode[2].as<int32_t>();
+	auto tape_size_of = yamlNode[3].as<int32_t>();
+	// These warnings may be caused e.g. by gaussian noise (different seed -> different hits)
+	if (out_count != tape_count) {
+		RGL_WARN("tape_graph_get_result_size: actual count ({}) differs from tape count ({})", out_count, tape_count);
+	}
+	if (out_size_of != tape_size_of) {
+		RGL_WARN("tape_graph_get_result_size: actual sizeof ({}) differs from tape sizeof ({})", out_size_of, tape_size_of);
+	}
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_frame_id(rgl_node_t node, uint64_t* out_frame_id)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_frame_id(node={}, out_frame_id={})", repr(node), (void*) out_frame_id);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(out_frame_id != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		if (nodeShared->isValid()) {
+			nodeShared->waitForResults(); // Otherwise, node has not been run since its creation or modification
+		}
+		*out_frame_id = nodeShared->getResultFrameId();
+	});
+	TAPE_HOOK(node, out_frame_id);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_frame_id(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto tape_frame_id = yamlNode[1].as<uint64_t>();
+	uint64_t out_frame_id;
+	rgl_graph_get_result_frame_id(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), &out_frame_id);
+	if (tape_frame_id != out_frame_id) {
+		RGL_WARN("tape_graph_get_result_frame_id: actual frame id ({}) differs from tape frame id ({})", out_frame_id,
+		         tape_frame_id);
+	}
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_data(rgl_node_t node, rgl_field_t field, void* dst)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_data(node={}, field={}, data={})", repr(node), field, (void*) dst);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(dst != nullptr);
+		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_get_result_data"};
+		PerformanceCounters::ScopedTimer timer{PerformanceCounters::instance().resultCopy};
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		if (!pointCloudNode->hasField(field)) {
+			auto msg = fmt::format("node {} does not provide field {}", pointCloudNode->getName(), toString(field));
+			throw InvalidPipeline(msg);
+		}
+
+		// This part is a bit tricky:
+		// The node is operating in a GraphRunCtx, i.e. in some CUDA stream.
+		// All its DAAs are bound to that stream. The stream may be busy with processing other nodes.
+		// We want to copy data without waiting until the aforementioned stream is synchronized.
+		// Therefore, we want to invoke the copy from the source DAA in a separate stream - copy stream.
+		// Take note, that since the source DAA is bound to a stream,
+		// it could be unsafe to issue operations in a different stream.
+		// E.g. If DAA was resized (data pointer already changed its value), but the reallocation didn't yet happen.
+		// However, with the current architecture, we can reasonably expect that no DAA is modified by other Node than its owner.
+		// Therefore, it should be sufficient to wait only for the stream operations issued by the given node (and, obviously, all previous).
+		// After that, all pending operations on the source DAA are done, and it is safe to use it in the copy stream.
+		pointCloudNode->waitForResults();
+
+		// YieldNode prefetches its fields to host memory as the part of its execution.
+		// If we are asked for a field from YieldNode, we can use its host cache and immediately memcpy it.
+		if (auto yieldNode = std::dynamic_pointer_cast<YieldPointsNode>(pointCloudNode)) {
+			if (const void* hostCache = yieldNode->getHostCache(field)) {
+				memcpy(dst, hostCache, yieldNode->getHostCacheSize(field));
+				return;
+			}
+		}
+		pointCloudNode->checkFieldNotReleased(field);
+
+		// Copy directly to dst; if dst is page-locked (e.g. registered with rgl_graph_set_result_buffer), this is a single DMA.
+		auto fieldArray = pointCloudNode->getFieldData(field);
+		const void* src = fieldArray->getRawReadPtr();
+		size_t size = fieldArray->getCount() * fieldArray->getSizeOf();
+		CHECK_CUDA(cudaMemcpyAsync(dst, src, size, cudaMemcpyDefault, CudaStream::getCopyStream()->getHandle()));
+		CHECK_CUDA(cudaStreamSynchronize(CudaStream::getCopyStream()->getHandle()));
+		PerformanceCounters::instance().addTransfer(isHost(fieldArray->getMemoryKind()), true, size);
+	});
+	TAPE_HOOK(node, field, dst);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_data(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_node_t node = state.nodes.at(yamlNode[0].as<TapeAPIObjectID>());
+	rgl_field_t field = (rgl_field_t) yamlNode[1].as<int>();
+	int32_t out_count, out_size_of;
+	rgl_graph_get_result_size(node, field, &out_count, &out_size_of);
+	std::vector<char> tmpVec;
+	tmpVec.reserve(out_count * out_size_of);
+	rgl_graph_get_result_data(node, field, tmpVec.data());
+}
+
+RGL_API rgl_status_t rgl_graph_get_results(rgl_node_t node, const rgl_field_t* fields, int32_t field_count, void* const* dsts,
+                                           int32_t* out_counts)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_results(node={}, fields={}, dsts={}, out_counts={})", repr(node), repr(fields, field_count),
+		            (void*) dsts, (void*) out_counts);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(fields != nullptr);
+		CHECK_ARG(field_count > 0);
+		CHECK_ARG(dsts != nullptr);
+		for (int32_t i = 0; i < field_count; ++i) {
+			CHECK_ARG(dsts[i] != nullptr);
+		}
+		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_get_results"};
+		PerformanceCounters::ScopedTimer timer{PerformanceCounters::instance().resultCopy};
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		for (int32_t i = 0; i < field_count; ++i) {
+			if (!pointCloudNode->hasField(fields[i])) {
+				auto msg = fmt::format("node {} does not provide field {}", pointCloudNode->getName(), toString(fields[i]));
+				throw InvalidPipeline(msg);
+			}
+		}
+		// Same as rgl_graph_get_result_data, except that copies of all fields are awaited at once.
+		pointCloudNode->waitForResults();
+		auto yieldNode = std::dynamic_pointer_cast<YieldPointsNode>(pointCloudNode);
+		auto isHostCached = [&](rgl_field_t field) {
+			return yieldNode != nullptr && yieldNode->getHostCache(field) != nullptr;
+		};
+		// Checked before any copy, so that failed call does not write to dsts.
+		for (int32_t i = 0; i < field_count; ++i) {
+			if (!isHostCached(fields[i])) {
+				pointCloudNode->checkFieldNotReleased(fields[i]);
+			}
+		}
+		cudaStream_t copyStream = CudaStream::getCopyStream()->getHandle();
+		for (int32_t i = 0; i < field_count; ++i) {
+			std::size_t size = 0;
+			if (isHostCached(fields[i])) {
+				size = yieldNode->getHostCacheSize(fields[i]);
+				memcpy(dsts[i], yieldNode->getHostCache(fields[i]), size);
+			} else {
+				auto fieldArray = pointCloudNode->getFieldData(fields[i]);
+				size = fieldArray->getCount() * fieldArray->getSizeOf();
+				CHECK_CUDA(cudaMemcpyAsync(dsts[i], fieldArray->getRawReadPtr(), size, cudaMemcpyDefault, copyStream));
+			}
+			if (out_counts != nullptr) {
+				out_counts[i] = static_cast<int32_t>(size / pointCloudNode->getFieldPointSize(fields[i]));
+			}
+		}
+		CHECK_CUDA(cudaStreamSynchronize(copyStream));
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(fields, field_count), field_count);
+	return status;
+}
+
+void TapeCore::tape_graph_get_results(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_node_t node = state.nodes.at(yamlNode[0].as<TapeAPIObjectID>());
+	const rgl_field_t* fields = state.getPtr<const rgl_field_t>(yamlNode[1]);
+	auto fieldCount = yamlNode[2].as<int32_t>();
+	std::vector<std::vector<char>> buffers(fieldCount);
+	std::vector<void*> dsts(fieldCount);
+	for (int32_t i = 0; i < fieldCount; ++i) {
+		int32_t out_count, out_size_of;
+		rgl_graph_get_result_size(node, fields[i], &out_count, &out_size_of);
+		buffers[i].resize(std::max(out_count * out_size_of, 1));
+		dsts[i] = buffers[i].data();
+	}
+	rgl_graph_get_results(node, fields, fieldCount, dsts.data(), nullptr);
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_data_async(rgl_node_t node, rgl_field_t field, void* dst,
+                                                     rgl_result_callback_t callback, void* user_data)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_data_async(node={}, field={}, dst={}, callback={}, user_data={})", repr(node), field,
+		            dst, (void*) callback, user_data);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(dst != nullptr);
+		CHECK_ARG(callback != nullptr);
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		if (!pointCloudNode->hasField(field)) {
+			auto msg = fmt::format("node {} does not provide field {}", pointCloudNode->getName(), toString(field));
+			throw InvalidPipeline(msg);
+		}
+
+		pointCloudNode->checkFieldNotReleased(field);
+
+		// Called in client's thread if the node has been already enqueued, otherwise in the graph thread.
+		// Either way, the copy is performed by a worker thread, so that neither client's nor graph thread waits for it.
+		pointCloudNode->callWhenResultsEnqueued([=](std::exception_ptr error) {
+			auto graphRunCtx = pointCloudNode->getGraphRunCtx();
+			IAnyArray::ConstPtr fieldArray = nullptr;
+			CudaEvent::Ptr dataReady = nullptr;
+			rgl_status_t enqueueStatus = rglSafeCall([&]() {
+				if (error != nullptr) {
+					std::rethrow_exception(error);
+				}
+				// In the graph thread, getFieldData() may enqueue lazily computed data, so dataReady is recorded after it.
+				fieldArray = pointCloudNode->getFieldData(field);
+				dataReady = CudaEvent::create();
+				cudaStream_t nodeStream = graphRunCtx->getNodeStream(*pointCloudNode)->getHandle();
+				CHECK_CUDA(cudaEventRecord(dataReady->getHandle(), nodeStream));
+			});
+			graphRunCtx->submitAuxiliaryJob([=]() {
+				rgl_status_t copyStatus = enqueueStatus;
+				if (copyStatus == RGL_SUCCESS) {
+					copyStatus = rglSafeCall([&]() {
+						cudaStream_t copyStream = CudaStream::getCopyStream()->getHandle();
+						auto data = fieldArray;
+						if (pointCloudNode->getPointCountDevicePtr() != nullptr) {
+							// The array obtained in the graph thread is sized for the upper bound; here the count is exact.
+							data = pointCloudNode->getFieldData(field);
+						}
+						size_t size = data->getCount() * data->getSizeOf();
+						CHECK_CUDA(cudaStreamWaitEvent(copyStream, dataReady->getHandle()));
+						CHECK_CUDA(cudaMemcpyAsync(dst, data->getRawReadPtr(), size, cudaMemcpyDefault, copyStream));
+						CHECK_CUDA(cudaStreamSynchronize(copyStream));
+					});
+				}
+				callback(copyStatus, user_data);
+			});
+		});
+	});
+	TAPE_HOOK(node, field);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_data_async(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_node_t node = state.nodes.at(yamlNode[0].as<TapeAPIObjectID>());
+	rgl_field_t field = (rgl_field_t) yamlNode[1].as<int>();
+	int32_t out_count, out_size_of;
+	if (rgl_graph_get_result_size(node, field, &out_count, &out_size_of) != RGL_SUCCESS) {
+		return;
+	}
+	std::vector<char> tmpVec(out_count * out_size_of);
+	std::promise<void> delivered;
+	auto onDelivered = [](rgl_status_t, void* promise) { static_cast<std::promise<void>*>(promise)->set_value(); };
+	if (rgl_graph_get_result_data_async(node, field, tmpVec.data(), onDelivered, &delivered) == RGL_SUCCESS) {
+		delivered.get_future().wait(); // tmpVec must outlive the copy
+	}
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_device_ptr(rgl_node_t node, rgl_field_t field, const void** out_device_ptr,
+                                                     int32_t* out_count, void** out_event)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_device_ptr(node={}, field={}, out_device_ptr={}, out_count={}, out_event={})",
+		            repr(node), field, (void*) out_device_ptr, (void*) out_count, (void*) out_event);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(out_device_ptr != nullptr);
+		CHECK_ARG(out_event != nullptr);
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		if (!pointCloudNode->hasField(field)) {
+			auto msg = fmt::format("node {} does not provide field {}", pointCloudNode->getName(), toString(field));
+			throw InvalidPipeline(msg);
+		}
+		pointCloudNode->checkFieldNotReleased(field);
+		// Only CPU part is awaited; the consumer synchronizes with the GPU work through the event.
+		pointCloudNode->waitForResultsEnqueued();
+
+		auto fieldArray = pointCloudNode->getFieldData(field);
+		if (isHost(fieldArray->getMemoryKind())) {
+			auto msg = fmt::format("field {} of node {} is not stored in device memory", toString(field),
+			                       pointCloudNode->getName());
+			throw InvalidPipeline(msg);
+		}
+		*out_device_ptr = fieldArray->getRawReadPtr();
+		*out_event = pointCloudNode->getExecCompletedEvent();
+		if (out_count != nullptr) {
+			*out_count = static_cast<int32_t>(fieldArray->getCount());
+		}
+	});
+	TAPE_HOOK(node, field);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_device_ptr(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	const void* out_device_ptr;
+	int32_t out_count;
+	void* out_event;
+	rgl_graph_get_result_device_ptr(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), (rgl_field_t) yamlNode[1].as<int>(),
+	                                &out_device_ptr, &out_count, &out_event);
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_chunk(rgl_node_t node, int32_t chunk_index, int32_t* out_column_begin,
+                                                int32_t* out_column_count, void** out_event)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_chunk(node={}, chunk_index={}, out_column_begin={}, out_column_count={}, "
+		            "out_event={})",
+		            repr(node), chunk_index, (void*) out_column_begin, (void*) out_column_count, (void*) out_event);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(chunk_index >= 0);
+		CHECK_ARG(out_event != nullptr);
+
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(raytraceNode);
+		if (!raytraceNode->isStreamed()) {
+			auto msg = fmt::format("node {} does not stream its output", raytraceNode->getName());
+			throw InvalidPipeline(msg);
+		}
+		// Only CPU part is awaited; the consumer synchronizes with the GPU work through the event.
+		raytraceNode->waitForResultsEnqueued();
+
+		const auto& chunks = raytraceNode->getStreamedChunks();
+		if (static_cast<std::size_t>(chunk_index) >= chunks.size()) {
+			auto msg = fmt::format("node {} has {} chunks, requested chunk {}", raytraceNode->getName(), chunks.size(),
+			                       chunk_index);
+			throw InvalidAPIArgument(msg);
+		}
+		const auto& chunk = chunks.at(chunk_index);
+		*out_event = chunk.completed->getHandle();
+		if (out_column_begin != nullptr) {
+			*out_column_begin = static_cast<int32_t>(chunk.columnBegin);
+		}
+		if (out_column_count != nullptr) {
+			*out_column_count = static_cast<int32_t>(chunk.columnCount);
+		}
+	});
+	TAPE_HOOK(node, chunk_index);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_chunk(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	int32_t out_column_begin;
+	int32_t out_column_count;
+	void* out_event;
+	rgl_graph_get_result_chunk(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<int32_t>(),
+	                           &out_column_begin, &out_column_count, &out_event);
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_dlpack(rgl_node_t node, rgl_field_t field, void** out_dl_managed_tensor,
+                                                 void** out_event)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_dlpack(node={}, field={}, out_dl_managed_tensor={}, out_event={})", repr(node), field,
+		            (void*) out_dl_managed_tensor, (void*) out_event);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(out_dl_managed_tensor != nullptr);
+		CHECK_ARG(out_event != nullptr);
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		if (!pointCloudNode->hasField(field)) {
+			auto msg = fmt::format("node {} does not provide field {}", pointCloudNode->getName(), toString(field));
+			throw InvalidPipeline(msg);
+		}
+		if (field != RGL_FIELD_DYNAMIC_FORMAT && isDummy(field)) {
+			throw InvalidAPIArgument(fmt::format("padding field {} has no data", toString(field)));
+		}
+		pointCloudNode->checkFieldNotReleased(field);
+		pointCloudNode->waitForResultsEnqueued();
+
+		auto fieldArray = pointCloudNode->getFieldData(field);
+		*out_dl_managed_tensor = createDLPackTensor(fieldArray, field, pointCloudNode->getFieldPointSize(field));
+		*out_event = pointCloudNode->getExecCompletedEvent();
+	});
+	TAPE_HOOK(node, field);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_dlpack(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	void* out_dl_managed_tensor = nullptr;
+	void* out_event;
+	rgl_status_t status = rgl_graph_get_result_dlpack(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                                                  (rgl_field_t) yamlNode[1].as<int>(), &out_dl_managed_tensor, &out_event);
+	if (status == RGL_SUCCESS) {
+		auto* tensor = static_cast<dlpack::ManagedTensor*>(out_dl_managed_tensor);
+		tensor->deleter(tensor);
+	}
+}
+
+RGL_API rgl_status_t rgl_graph_set_result_buffer(rgl_node_t node, rgl_field_t field, void* buffer, int64_t buffer_size)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_set_result_buffer(node={}, field={}, buffer={}, buffer_size={})", repr(node), field, buffer,
+		            buffer_size);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(buffer == nullptr || buffer_size > 0);
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		pointCloudNode->setResultBuffer(field, buffer, static_cast<std::size_t>(buffer_size));
+	});
+	TAPE_HOOK(node, field, buffer, buffer_size);
+	return status;
+}
+
+void TapeCore::tape_graph_set_result_buffer(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_node_t node = state.nodes.at(yamlNode[0].as<TapeAPIObjectID>());
+	rgl_field_t field = (rgl_field_t) yamlNode[1].as<int>();
+	void* buffer = nullptr;
+	int64_t bufferSize = yamlNode[3].as<int64_t>();
+	if (yamlNode[2].as<uintptr_t>() != 0) {
+		buffer = state.resultBuffers[{node, field}].emplace_back(bufferSize).data();
+	}
+	rgl_graph_set_result_buffer(node, field, buffer, bufferSize);
+}
+
+RGL_API rgl_status_t rgl_graph_get_result_buffer_status(rgl_node_t node, rgl_field_t field, bool* out_ready,
+                                                        int32_t* out_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_result_buffer_status(node={}, field={}, out_ready={}, out_count={})", repr(node), field,
+		            (void*) out_ready, (void*) out_count);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(out_ready != nullptr);
+
+		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(pointCloudNode);
+		if (!pointCloudNode->hasResultBuffer(field)) {
+			auto msg = fmt::format("no result buffer has been set for field {} of {}", toString(field),
+			                       pointCloudNode->getName());
+			throw InvalidPipeline(msg);
+		}
+		*out_ready = pointCloudNode->isResultReady();
+		if (*out_ready && out_count != nullptr) {
+			*out_count = static_cast<int32_t>(pointCloudNode->getResultBufferCount(field));
+		}
+	});
+	TAPE_HOOK(node, field);
+	return status;
+}
+
+void TapeCore::tape_graph_get_result_buffer_status(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	bool out_ready;
+	int32_t out_count;
+	rgl_graph_get_result_buffer_status(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), (rgl_field_t) yamlNode[1].as<int>(),
+	                                   &out_ready, &out_count);
+}
+
+RGL_API rgl_status_t rgl_graph_node_add_child(rgl_node_t parent, rgl_node_t child)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_node_add_child(parent={}, child={})", repr(parent), repr(child));
+		CHECK_ARG(parent != nullptr);
+		CHECK_ARG(child != nullptr);
+		CHECK_ARG(parent != child);
+
+		Node::validatePtr(parent)->addChild(Node::validatePtr(child));
+	});
+	TAPE_HOOK(parent, child);
+	return status;
+}
+
+void TapeCore::tape_graph_node_add_child(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_node_add_child(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                         state.nodes.at(yamlNode[1].as<TapeAPIObjectID>()));
+}
+
+RGL_API rgl_status_t rgl_graph_node_remove_child(rgl_node_t parent, rgl_node_t child)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_node_remove_child(parent={}, child={})", repr(parent), repr(child));
+		CHECK_ARG(parent != nullptr);
+		CHECK_ARG(child != nullptr);
+
+		Node::validatePtr(parent)->removeChild(Node::validatePtr(child));
+	});
+	TAPE_HOOK(parent, child);
+	return status;
+}
+
+void TapeCore::tape_graph_node_remove_child(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_node_remove_child(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                            state.nodes.at(yamlNode[1].as<TapeAPIObjectID>()));
+}
+
+RGL_API rgl_status_t rgl_graph_node_set_priority(rgl_node_t node, int32_t priority)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_node_set_priority(node={}, priority={})", repr(node), priority);
+		CHECK_ARG(node != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		if (nodeShared->hasGraphRunCtx()) {
+			nodeShared->getGraphRunCtx()->synchronize();
+		}
+		nodeShared->setPriority(priority);
+	});
+	TAPE_HOOK(node, priority);
+	return status;
+}
+
+void TapeCore::tape_graph_node_set_priority(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	auto priority = yamlNode[1].as<int32_t>();
+	rgl_graph_node_set_priority(node, priority);
+}
+
+RGL_API rgl_status_t rgl_graph_node_get_priority(rgl_node_t node, int32_t* out_priority)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_node_get_priority(node={}, priority={})", repr(node), (void*) out_priority);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(out_priority != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		// No need to synchronize
+		*out_priority = nodeShared->getPriority();
+	});
+	TAPE_HOOK(node, out_priority);
+	return status;
+}
+
+void TapeCore::tape_graph_node_get_priority(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	auto tape_priority = yamlNode[1].as<int32_t>();
+	int32_t out_priority;
+	rgl_graph_node_get_priority(node, &out_priority);
+	if (tape_priority != out_priority) {
+		RGL_WARN("tape_graph_node_get_priority: actual priority ({}) differs from tape priority ({})", out_priority,
+		         tape_priority);
+	}
+}
+
+RGL_API rgl_status_t rgl_graph_set_gpu_priority(rgl_node_t node, int32_t priority)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_set_gpu_priority(node={}, priority={})", repr(node), priority);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(priority >= 0);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		if (nodeShared->hasGraphRunCtx()) {
+			nodeShared->getGraphRunCtx()->synchronize();
+		}
+		for (auto&& graphNode : nodeShared->getConnectedComponentNodes()) {
+			graphNode->setGpuPriority(priority);
+		}
+	});
+	TAPE_HOOK(node, priority);
+	return status;
+}
+
+void TapeCore::tape_graph_set_gpu_priority(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_set_gpu_priority(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<int32_t>());
+}
+
+RGL_API rgl_status_t rgl_graph_set_random_seed(rgl_node_t node, uint64_t seed)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_set_random_seed(node={}, seed={})", repr(node), seed);
+		CHECK_ARG(node != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		if (nodeShared->hasGraphRunCtx()) {
+			nodeShared->getGraphRunCtx()->synchronize();
+		}
+		nodeShared->setGraphRandomSeed(seed);
+	});
+	TAPE_HOOK(node, seed);
+	return status;
+}
+
+void TapeCore::tape_graph_set_random_seed(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_set_random_seed(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<uint64_t>());
+}
+
+RGL_API rgl_status_t rgl_graph_configure_result_cache(rgl_node_t node, bool enable)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_configure_result_cache(node={}, enable={})", repr(node), enable);
+		CHECK_ARG(node != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		if (nodeShared->hasGraphRunCtx()) {
+			nodeShared->getGraphRunCtx()->synchronize();
+		}
+		for (auto&& raytraceNode : Node::getNodesOfType<RaytraceNode>(nodeShared->getConnectedComponentNodes())) {
+			raytraceNode->setResultCache(enable);
+		}
+	});
+	TAPE_HOOK(node, enable);
+	return status;
+}
+
+void TapeCore::tape_graph_configure_result_cache(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_configure_result_cache(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<bool>());
+}
+
+RGL_API rgl_status_t rgl_graph_configure_memory_reuse(rgl_node_t node, bool enable)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_configure_memory_reuse(node={}, enable={})", repr(node), enable);
+		CHECK_ARG(node != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		if (nodeShared->hasGraphRunCtx()) {
+			nodeShared->getGraphRunCtx()->synchronize();
+		}
+		for (auto&& graphNode : nodeShared->getConnectedComponentNodes()) {
+			graphNode->setMemoryReuse(enable);
+		}
+	});
+	TAPE_HOOK(node, enable);
+	return status;
+}
+
+void TapeCore::tape_graph_configure_memory_reuse(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_configure_memory_reuse(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<bool>());
+}
+
+RGL_API rgl_status_t rgl_graph_configure_frame_dropping(rgl_node_t node, bool enable)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_configure_frame_dropping(node={}, enable={})", repr(node), enable);
+		CHECK_ARG(node != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		for (auto&& graphNode : nodeShared->getConnectedComponentNodes()) {
+			graphNode->setFrameDropping(enable);
+		}
+	});
+	TAPE_HOOK(node, enable);
+	return status;
+}
+
+void TapeCore::tape_graph_configure_frame_dropping(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_graph_configure_frame_dropping(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), yamlNode[1].as<bool>());
+}
+
+RGL_API rgl_status_t rgl_graph_get_dropped_frame_count(rgl_node_t node, int32_t* out_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_dropped_frame_count(node={}, out_count={})", repr(node), (void*) out_count);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(out_count != nullptr);
+
+		Node::Ptr nodeShared = Node::validatePtr(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(nodeShared);
+		auto droppedFrameCount = nodeShared->hasGraphRunCtx() ? nodeShared->getGraphRunCtx()->getDroppedFrameCount() : 0;
+		*out_count = static_cast<int32_t>(droppedFrameCount);
+	});
+	TAPE_HOOK(node, out_count);
+	return status;
+}
+
+void TapeCore::tape_graph_get_dropped_frame_count(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	// Dropped frames depend on timings, so they are not compared with the recorded ones.
+	int32_t out_count = 0;
+	rgl_graph_get_dropped_frame_count(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), &out_count);
+}
+
+RGL_API rgl_status_t rgl_graph_get_node_stats(rgl_node_t node, rgl_node_stats_t* out_stats)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_graph_get_node_stats(node={}, out_stats={})", repr(node), (void*) out_stats);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(out_stats != nullptr);
+		*out_stats = Node::validatePtr(node)->getStats();
+	});
+	TAPE_HOOK(node, out_stats);
+	return status;
+}
+
+void TapeCore::tape_graph_get_node_stats(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	// Timings are not reproducible, so they are not compared with the recorded ones.
+	rgl_node_stats_t out_stats;
+	rgl_graph_get_node_stats(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()), &out_stats);
+}
+
+RGL_API rgl_status_t rgl_node_rays_from_mat3x4f(rgl_node_t* node, const rgl_mat3x4f* rays, int32_t ray_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_from_mat3x4f(node={}, rays={})", repr(node), repr(rays, ray_count));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(rays != nullptr);
+		CHECK_ARG(ray_count > 0);
+		createOrUpdateNode<FromMat3x4fRaysNode>(node, reinterpret_cast<const Mat3x4f*>(rays), (size_t) ray_count);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(rays, ray_count), ray_count);
+	return status;
+}
+
+void TapeCore::tape_node_rays_from_mat3x4f(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_from_mat3x4f(&node, state.getPtr<const rgl_mat3x4f>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_rays_from_directions(rgl_node_t* node, const rgl_vec3f* directions, int32_t ray_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_from_directions(node={}, directions={})", repr(node), repr(directions, ray_count));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(directions != nullptr);
+		CHECK_ARG(ray_count > 0);
+		createOrUpdateNode<FromDirectionsRaysNode>(node, reinterpret_cast<const Vec3f*>(directions), (size_t) ray_count);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(directions, ray_count), ray_count);
+	return status;
+}
+
+void TapeCore::tape_node_rays_from_directions(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_from_directions(&node, state.getPtr<const rgl_vec3f>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_rays_from_pattern(rgl_node_t* node, const float* ring_elevations, const float* ring_time_offsets,
+                                                int32_t ring_count, float azimuth_start, float azimuth_step,
+                                                int32_t azimuth_step_count, float azimuth_step_time)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_from_pattern(node={}, ring_elevations={}, ring_time_offsets={}, azimuth_start={}, "
+		            "azimuth_step={}, azimuth_step_count={}, azimuth_step_time={})",
+		            repr(node), repr(ring_elevations, ring_count), repr(ring_time_offsets, ring_count), azimuth_start,
+		            azimuth_step, azimuth_step_count, azimuth_step_time);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(ring_elevations != nullptr);
+		CHECK_ARG(ring_time_offsets != nullptr);
+		CHECK_ARG(ring_count > 0);
+		CHECK_ARG(azimuth_step_count > 0);
+		createOrUpdateNode<FromPatternRaysNode>(node, ring_elevations, ring_time_offsets, (size_t) ring_count, azimuth_start,
+		                                        azimuth_step, (size_t) azimuth_step_count, azimuth_step_time);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(ring_elevations, ring_count), TAPE_ARRAY(ring_time_offsets, ring_count), ring_count,
+	          azimuth_start, azimuth_step, azimuth_step_count, azimuth_step_time);
+	return status;
+}
+
+void TapeCore::tape_node_rays_from_pattern(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_from_pattern(&node, state.getPtr<const float>(yamlNode[1]), state.getPtr<const float>(yamlNode[2]),
+	                           yamlNode[3].as<int32_t>(), yamlNode[4].as<float>(), yamlNode[5].as<float>(),
+	                           yamlNode[6].as<int32_t>(), yamlNode[7].as<float>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_rays_set_ring_ids(rgl_node_t* node, const int32_t* ring_ids, int32_t ring_ids_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_set_ring_ids(node={}, ring_ids={})", repr(node), repr(ring_ids, ring_ids_count));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(ring_ids != nullptr);
+		CHECK_ARG(ring_ids_count > 0);
+		createOrUpdateNode<SetRingIdsRaysNode>(node, ring_ids, (size_t) ring_ids_count);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(ring_ids, ring_ids_count), ring_ids_count);
+	return status;
+}
+
+void TapeCore::tape_node_rays_set_ring_ids(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_set_ring_ids(&node, state.getPtr<const int32_t>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_rays_set_range(rgl_node_t* node, const rgl_vec2f* ranges, int32_t ranges_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_set_range(node={}, ranges={})", repr(node), repr(ranges, ranges_count));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(ranges != nullptr);
+		CHECK_ARG(ranges_count > 0);
+		createOrUpdateNode<SetRangeRaysNode>(node, reinterpret_cast<const Vec2f*>(ranges), (size_t) ranges_count);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(ranges, ranges_count), ranges_count);
+	return status;
+}
+
+void TapeCore::tape_node_rays_set_range(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_set_range(&node, state.getPtr<const rgl_vec2f>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_rays_set_layout(rgl_node_t* node, int32_t width, int32_t height)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_set_layout(node={}, width={}, height={})", repr(node), width, height);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(width > 0);
+		CHECK_ARG(height > 0);
+		createOrUpdateNode<SetLayoutRaysNode>(node, width, height);
+	});
+	TAPE_HOOK(node, width, height);
+	return status;
+}
+
+void TapeCore::tape_node_rays_set_layout(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_set_layout(&node, yamlNode[1].as<int32_t>(), yamlNode[2].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_rays_set_time_offsets(rgl_node_t* node, const float* offsets, int32_t offsets_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_set_time_offsets(node={}, offsets={})", repr(node), repr(offsets, offsets_count));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(offsets != nullptr);
+		CHECK_ARG(offsets_count > 0);
+		createOrUpdateNode<SetTimeOffsetsRaysNode>(node, offsets, (size_t) offsets_count);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(offsets, offsets_count), offsets_count);
+	return status;
+}
+
+void TapeCore::tape_node_rays_set_time_offsets(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_set_time_offsets(&node, state.getPtr<const float>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_rays_transform(rgl_node_t* node, const rgl_mat3x4f* transform)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_rays_transform(node={}, transform={})", repr(node), repr(transform));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(transform != nullptr);
+
+		createOrUpdateNode<TransformRaysNode>(node, Mat3x4f::fromRGL(*transform));
+	});
+	TAPE_HOOK(node, transform);
+	return status;
+}
+
+void TapeCore::tape_node_rays_transform(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_rays_transform(&node, state.getPtr<const rgl_mat3x4f>(yamlNode[1]));
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_transform(rgl_node_t* node, const rgl_mat3x4f* transform)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_transform(node={}, transform={})", repr(node), repr(transform));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(transform != nullptr);
+
+		createOrUpdateNode<TransformPointsNode>(node, Mat3x4f::fromRGL(*transform));
+	});
+	TAPE_HOOK(node, transform);
+	return status;
+}
+
+void TapeCore::tape_node_points_transform(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_transform(&node, state.getPtr<const rgl_mat3x4f>(yamlNode[1]));
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_raytrace(rgl_node_t* node, rgl_scene_t scene)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace(node={}, scene={})", repr(node), (void*) scene);
+		CHECK_ARG(node != nullptr);
+
+		createOrUpdateNode<RaytraceNode>(node, Scene::validateOrDefault(scene));
+		auto raytraceNode = Node::validatePtr<RaytraceNode>(*node);
+	});
+	TAPE_HOOK(node, scene);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_raytrace(&node, state.getScene(yamlNode[1]));
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_velocity(rgl_node_t node, const rgl_vec3f* linear_velocity,
+                                                          const rgl_vec3f* angular_velocity)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_velocity(node={}, linear_velocity={}, angular_velocity={})", repr(node),
+		            repr(linear_velocity), repr(angular_velocity));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(linear_velocity != nullptr);
+		CHECK_ARG(angular_velocity != nullptr);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setVelocity(*reinterpret_cast<const Vec3f*>(linear_velocity),
+		                          *reinterpret_cast<const Vec3f*>(angular_velocity));
+	});
+	TAPE_HOOK(node, linear_velocity, angular_velocity);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_velocity(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_velocity(state.nodes.at(nodeId), state.getPtr<const rgl_vec3f>(yamlNode[1]),
+	                                     state.getPtr<const rgl_vec3f>(yamlNode[2]));
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_distortion(rgl_node_t node, bool enable)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_distortion(node={}, enable={})", repr(node), enable);
+		CHECK_ARG(node != nullptr);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->enableRayDistortion(enable);
+	});
+	TAPE_HOOK(node, enable);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_distortion(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_distortion(node, yamlNode[1].as<bool>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_non_hits(rgl_node_t node, float nearDistance, float farDistance)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_non_hits(node={}, nearDistance={}, farDistance={})", repr(node), nearDistance,
+		            farDistance);
+		CHECK_ARG(node != nullptr);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setNonHitDistanceValues(nearDistance, farDistance);
+	});
+	TAPE_HOOK(node, nearDistance, farDistance);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_non_hits(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_non_hits(node, yamlNode[1].as<float>(), yamlNode[2].as<float>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_return_mode(rgl_node_t node, rgl_return_mode_t return_mode)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_return_mode(node={}, return_mode={})", repr(node), return_mode);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(return_mode >= RGL_RETURN_MODE_FIRST && return_mode <= RGL_RETURN_MODE_DUAL_STRONGEST_LAST);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setReturnMode(return_mode);
+	});
+	TAPE_HOOK(node, return_mode);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_return_mode(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_return_mode(node, (rgl_return_mode_t) yamlNode[1].as<size_t>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_beam_divergence(rgl_node_t node, float divergence_angle, int32_t sample_count,
+                                                                 rgl_beam_reduction_t reduction)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_beam_divergence(node={}, divergence_angle={}, sample_count={}, reduction={})",
+		            repr(node), divergence_angle, sample_count, reduction);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(divergence_angle >= 0.0f && divergence_angle < static_cast<float>(M_PI));
+		CHECK_ARG(sample_count > 0);
+		CHECK_ARG(reduction >= RGL_BEAM_REDUCTION_NEAREST && reduction <= RGL_BEAM_REDUCTION_STRONGEST);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setBeamDivergence(divergence_angle, sample_count, reduction);
+	});
+	TAPE_HOOK(node, divergence_angle, sample_count, reduction);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_beam_divergence(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_beam_divergence(node, yamlNode[1].as<float>(), yamlNode[2].as<int32_t>(),
+	                                            (rgl_beam_reduction_t) yamlNode[3].as<size_t>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_noise(rgl_node_t node, float angular_mean, float angular_st_dev,
+                                                       rgl_axis_t angular_axis, float distance_mean, float distance_st_dev_base,
+                                                       float distance_st_dev_rise_per_meter)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_noise(node={}, angular_mean={}, angular_st_dev={}, angular_axis={}, "
+		            "distance_mean={}, distance_st_dev_base={}, distance_st_dev_rise_per_meter={})",
+		            repr(node), angular_mean, angular_st_dev, angular_axis, distance_mean, distance_st_dev_base,
+		            distance_st_dev_rise_per_meter);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(angular_st_dev >= 0);
+		CHECK_ARG((angular_axis == RGL_AXIS_X) || (angular_axis == RGL_AXIS_Y) || (angular_axis == RGL_AXIS_Z));
+		CHECK_ARG(distance_st_dev_base >= 0);
+		CHECK_ARG(distance_st_dev_rise_per_meter >= 0);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setNoise(angular_mean, angular_st_dev, angular_axis, distance_mean, distance_st_dev_base,
+		                       distance_st_dev_rise_per_meter);
+	});
+	TAPE_HOOK(node, angular_mean, angular_st_dev, angular_axis, distance_mean, distance_st_dev_base,
+	          distance_st_dev_rise_per_meter);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_noise(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_noise(node, yamlNode[1].as<float>(), yamlNode[2].as<float>(),
+	                                  (rgl_axis_t) yamlNode[3].as<size_t>(), yamlNode[4].as<float>(), yamlNode[5].as<float>(),
+	                                  yamlNode[6].as<float>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_weather(rgl_node_t node, float extinction_coefficient,
+                                                         float particle_intensity)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_weather(node={}, extinction_coefficient={}, particle_intensity={})",
+		            repr(node), extinction_coefficient, particle_intensity);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(extinction_coefficient >= 0.0f);
+		CHECK_ARG(particle_intensity >= 0.0f);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setWeather(extinction_coefficient, particle_intensity);
+	});
+	TAPE_HOOK(node, extinction_coefficient, particle_intensity);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_weather(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_weather(node, yamlNode[1].as<float>(), yamlNode[2].as<float>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_multipath(rgl_node_t node, int32_t bounce_count, float reflectivity)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_multipath(node={}, bounce_count={}, reflectivity={})", repr(node),
+		            bounce_count, reflectivity);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(bounce_count >= 0 && bounce_count <= static_cast<int32_t>(MULTIPATH_MAX_BOUNCE_COUNT));
+		CHECK_ARG(reflectivity > 0.0f && reflectivity <= 1.0f);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setMultipath(bounce_count, reflectivity);
+	});
+	TAPE_HOOK(node, bounce_count, reflectivity);
+	return status;
+}
+
+void TapeCore::tape_node_raytrace_configure_multipath(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_multipath(node, yamlNode[1].as<int32_t>(), yamlNode[2].as<float>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_visibility_mask(rgl_node_t node, int32_t mask)
 {
-	static auto buffer = HostPinnedArray<char>::create();
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_get_result_data(node={}, field={}, data={})", repr(node), field, (void*) dst);
+		RGL_API_LOG("rgl_node_raytrace_configure_visibility_mask(node={}, mask={:#x})", repr(node), mask);
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(dst != nullptr);
-		NvtxRange rg{NVTX_CAT_API, NVTX_COL_CALL, "rgl_graph_get_result_data"};
+		CHECK_ARG(mask > 0 && mask <= 0xFF);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setVisibilityMask(static_cast<uint8_t>(mask));
+	});
+	TAPE_HOOK(node, mask);
+	return status;
+}
 
-		auto pointCloudNode = Node::validatePtr<IPointsNode>(node);
-		if (!pointCloudNode->hasField(field)) {
-			auto msg = fmt::format("node {} does not provide field {}", pointCloudNode->getName(), toString(field));
-			throw InvalidPipeline(msg);
-		}
+void TapeCore::tape_node_raytrace_configure_visibility_mask(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_visibility_mask(node, yamlNode[1].as<int32_t>());
+}
 
-		// This part is a bit tricky:
-		// The node is operating in a GraphRunCtx, i.e. in some CUDA stream.
-		// All its DAAs are bound to that stream. The stream may be busy with processing other nodes.
-		// We want to copy data without waiting until the aforementioned stream is synchronized.
-		// Therefore, we want to invoke the copy from the source DAA in a separate stream - copy stream.
-		// Take note, that since the source DAA is bound to a stream,
-		// it could be unsafe to issue operations in a different stream.
-		// E.g. If DAA was resized (data pointer already changed its value), but the reallocation didn't yet happen.
-		// However, with the current architecture, we can reasonably expect that no DAA is modified by other Node than its owner.
-		// Therefore, it should be sufficient to wait only for the stream operations issued by the given node (and, obviously, all previous).
-		// After that, all pending operations on the source DAA are done, and it is safe to use it in the copy stream.
-		pointCloudNode->waitForResults();
+RGL_API rgl_status_t rgl_node_raytrace_configure_culling(rgl_node_t node, float range, float movement_threshold)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_culling(node={}, range={}, movement_threshold={})", repr(node), range,
+		            movement_threshold);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(range >= 0.0f);
+		CHECK_ARG(movement_threshold >= 0.0f);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setCulling(range, movement_threshold);
+	});
+	TAPE_HOOK(node, range, movement_threshold);
+	return status;
+}
 
-		// Temporary optimization to yield better results in AWSIM:
-		// YieldNode (which has complementary part of this optimization) prefetches XYZ to host mem.
-		// If we are asked for XYZ from YieldNode, we can use its host cache and immediately memcpy it.
-		// TODO: This should work for any field in YieldNode (encountered test fails for other fields)
-		if (auto yieldNode = std::dynamic_pointer_cast<YieldPointsNode>(pointCloudNode)) {
-			if (field == XYZ_VEC3_F32) {
-				auto fieldArray = yieldNode->getXYZCache();
-				size_t size = fieldArray->getCount() * fieldArray->getSizeOf();
-				memcpy(dst, fieldArray->getRawReadPtr(), size);
-				return;
-			}
-		}
+void TapeCore::tape_node_raytrace_configure_culling(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_culling(node, yamlNode[1].as<float>(), yamlNode[2].as<float>());
+}
 
-		auto fieldArray = pointCloudNode->getFieldData(field);
-		buffer->resize(fieldArray->getCount() * fieldArray->getSizeOf(), false, false);
-		void* bufferDst = buffer->getWritePtr();
-		const void* src = fieldArray->getRawReadPtr();
-		size_t size = fieldArray->getCount() * fieldArray->getSizeOf();
-		CHECK_CUDA(cudaMemcpyAsync(bufferDst, src, size, cudaMemcpyDefault, CudaStream::getCopyStream()->getHandle()));
-		CHECK_CUDA(cudaStreamSynchronize(CudaStream::getCopyStream()->getHandle()));
-		memcpy(dst, bufferDst, size);
+RGL_API rgl_status_t rgl_node_raytrace_configure_time_slicing(rgl_node_t node, int32_t slice_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_time_slicing(node={}, slice_count={})", repr(node), slice_count);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(slice_count > 0);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(raytraceNode);
+		if (raytraceNode->hasGraphRunCtx()) {
+			raytraceNode->getGraphRunCtx()->synchronize();
+		}
+		raytraceNode->setTimeSlicing(slice_count);
 	});
-	TAPE_HOOK(node, field, dst);
+	TAPE_HOOK(node, slice_count);
 	return status;
 }
 
-void TapeCore::tape_graph_get_result_data(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_raytrace_configure_time_slicing(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_node_t node = state.nodes.at(yamlNode[0].as<TapeAPIObjectID>());
-	rgl_field_t field = (rgl_field_t) yamlNode[1].as<int>();
-	int32_t out_count, out_size_of;
-	rgl_graph_get_result_size(node, field, &out_count, &out_size_of);
-	std::vector<char> tmpVec;
-	tmpVec.reserve(out_count * out_size_of);
-	rgl_graph_get_result_data(node, field, tmpVec.data());
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_time_slicing(node, yamlNode[1].as<int32_t>());
 }
 
-RGL_API rgl_status_t rgl_graph_node_add_child(rgl_node_t parent, rgl_node_t child)
+RGL_API rgl_status_t rgl_node_raytrace_configure_streaming(rgl_node_t node, int32_t chunk_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_node_add_child(parent={}, child={})", repr(parent), repr(child));
-		CHECK_ARG(parent != nullptr);
-		CHECK_ARG(child != nullptr);
-		CHECK_ARG(parent != child);
-
-		Node::validatePtr(parent)->addChild(Node::validatePtr(child));
+		RGL_API_LOG("rgl_node_raytrace_configure_streaming(node={}, chunk_count={})", repr(node), chunk_count);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(chunk_count > 0);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(raytraceNode);
+		if (raytraceNode->hasGraphRunCtx()) {
+			raytraceNode->getGraphRunCtx()->synchronize();
+		}
+		raytraceNode->setStreaming(chunk_count);
 	});
-	TAPE_HOOK(parent, child);
+	TAPE_HOOK(node, chunk_count);
 	return status;
 }
 
-void TapeCore::tape_graph_node_add_child(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_raytrace_configure_streaming(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_graph_node_add_child(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
-	                         state.nodes.at(yamlNode[1].as<TapeAPIObjectID>()));
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_streaming(node, yamlNode[1].as<int32_t>());
 }
 
-RGL_API rgl_status_t rgl_graph_node_remove_child(rgl_node_t parent, rgl_node_t child)
+RGL_API rgl_status_t rgl_node_raytrace_configure_ray_skipping(rgl_node_t node, int32_t miss_frame_count,
+                                                              int32_t probe_period)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_node_remove_child(parent={}, child={})", repr(parent), repr(child));
-		CHECK_ARG(parent != nullptr);
-		CHECK_ARG(child != nullptr);
-
-		Node::validatePtr(parent)->removeChild(Node::validatePtr(child));
+		RGL_API_LOG("rgl_node_raytrace_configure_ray_skipping(node={}, miss_frame_count={}, probe_period={})", repr(node),
+		            miss_frame_count, probe_period);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(miss_frame_count >= 0);
+		CHECK_ARG(miss_frame_count <= UINT8_MAX);
+		CHECK_ARG(probe_period > 0);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(raytraceNode);
+		if (raytraceNode->hasGraphRunCtx()) {
+			raytraceNode->getGraphRunCtx()->synchronize();
+		}
+		raytraceNode->setRaySkipping(miss_frame_count, probe_period);
 	});
-	TAPE_HOOK(parent, child);
+	TAPE_HOOK(node, miss_frame_count, probe_period);
 	return status;
 }
 
-void TapeCore::tape_graph_node_remove_child(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_raytrace_configure_ray_skipping(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	rgl_graph_node_remove_child(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
-	                            state.nodes.at(yamlNode[1].as<TapeAPIObjectID>()));
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_ray_skipping(node, yamlNode[1].as<int32_t>(), yamlNode[2].as<int32_t>());
 }
 
-RGL_API rgl_status_t rgl_graph_node_set_priority(rgl_node_t node, int32_t priority)
+RGL_API rgl_status_t rgl_node_raytrace_configure_incremental(rgl_node_t node, bool enable)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_node_set_priority(node={}, priority={})", repr(node), priority);
+		RGL_API_LOG("rgl_node_raytrace_configure_incremental(node={}, enable={})", repr(node), enable);
 		CHECK_ARG(node != nullptr);
-
-		Node::Ptr nodeShared = Node::validatePtr(node);
-		if (nodeShared->hasGraphRunCtx()) {
-			nodeShared->getGraphRunCtx()->synchronize();
-		}
-		nodeShared->setPriority(priority);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setIncremental(enable);
 	});
-	TAPE_HOOK(node, priority);
+	TAPE_HOOK(node, enable);
 	return status;
 }
 
-void TapeCore::tape_graph_node_set_priority(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_raytrace_configure_incremental(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.at(nodeId);
-	auto priority = yamlNode[1].as<int32_t>();
-	rgl_graph_node_set_priority(node, priority);
+	rgl_node_raytrace_configure_incremental(node, yamlNode[1].as<bool>());
 }
 
-RGL_API rgl_status_t rgl_graph_node_get_priority(rgl_node_t node, int32_t* out_priority)
+RGL_API rgl_status_t rgl_node_raytrace_configure_ray_sorting(rgl_node_t node, bool enable)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_graph_node_get_priority(node={}, priority={})", repr(node), (void*) out_priority);
+		RGL_API_LOG("rgl_node_raytrace_configure_ray_sorting(node={}, enable={})", repr(node), enable);
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(out_priority != nullptr);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setRaySorting(enable);
+	});
+	TAPE_HOOK(node, enable);
+	return status;
+}
 
-		Node::Ptr nodeShared = Node::validatePtr(node);
-		// No need to synchronize
-		*out_priority = nodeShared->getPriority();
+void TapeCore::tape_node_raytrace_configure_ray_sorting(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_ray_sorting(node, yamlNode[1].as<bool>());
+}
+
+RGL_API rgl_status_t rgl_node_raytrace_configure_dense_output(rgl_node_t node, bool enable)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_raytrace_configure_dense_output(node={}, enable={})", repr(node), enable);
+		CHECK_ARG(node != nullptr);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setDenseOutput(enable);
 	});
-	TAPE_HOOK(node, out_priority);
+	TAPE_HOOK(node, enable);
 	return status;
 }
 
-void TapeCore::tape_graph_node_get_priority(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_raytrace_configure_dense_output(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.at(nodeId);
-	auto tape_priority = yamlNode[1].as<int32_t>();
-	int32_t out_priority;
-	rgl_graph_node_get_priority(node, &out_priority);
-	if (tape_priority != out_priority) {
-		RGL_WARN("tape_graph_node_get_priority: actual priority ({}) differs from tape priority ({})", out_priority,
-		         tape_priority);
-	}
+	rgl_node_raytrace_configure_dense_output(node, yamlNode[1].as<bool>());
 }
 
-RGL_API rgl_status_t rgl_node_rays_from_mat3x4f(rgl_node_t* node, const rgl_mat3x4f* rays, int32_t ray_count)
+RGL_API rgl_status_t rgl_node_raytrace_configure_fused_format(rgl_node_t node, bool enable)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_rays_from_mat3x4f(node={}, rays={})", repr(node), repr(rays, ray_count));
+		RGL_API_LOG("rgl_node_raytrace_configure_fused_format(node={}, enable={})", repr(node), enable);
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(rays != nullptr);
-		CHECK_ARG(ray_count > 0);
-		createOrUpdateNode<FromMat3x4fRaysNode>(node, reinterpret_cast<const Mat3x4f*>(rays), (size_t) ray_count);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setFusedFormat(enable);
 	});
-	TAPE_HOOK(node, TAPE_ARRAY(rays, ray_count), ray_count);
+	TAPE_HOOK(node, enable);
 	return status;
 }
 
-void TapeCore::tape_node_rays_from_mat3x4f(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_raytrace_configure_fused_format(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_rays_from_mat3x4f(&node, state.getPtr<const rgl_mat3x4f>(yamlNode[1]), yamlNode[2].as<int32_t>());
-	state.nodes.insert({nodeId, node});
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_fused_format(node, yamlNode[1].as<bool>());
 }
 
-RGL_API rgl_status_t rgl_node_rays_set_ring_ids(rgl_node_t* node, const int32_t* ring_ids, int32_t ring_ids_count)
+RGL_API rgl_status_t rgl_node_raytrace_configure_output_frame(rgl_node_t node, rgl_output_frame_t frame,
+                                                              const rgl_mat3x4f* transform)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_rays_set_ring_ids(node={}, ring_ids={})", repr(node), repr(ring_ids, ring_ids_count));
+		RGL_API_LOG("rgl_node_raytrace_configure_output_frame(node={}, frame={}, transform={})", repr(node), frame,
+		            repr(transform, 1));
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(ring_ids != nullptr);
-		CHECK_ARG(ring_ids_count > 0);
-		createOrUpdateNode<SetRingIdsRaysNode>(node, ring_ids, (size_t) ring_ids_count);
+		CHECK_ARG(frame >= RGL_OUTPUT_FRAME_WORLD && frame <= RGL_OUTPUT_FRAME_SENSOR);
+		CHECK_ARG(transform != nullptr);
+		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
+		raytraceNode->setOutputFrame(frame, Mat3x4f::fromRGL(*transform));
 	});
-	TAPE_HOOK(node, TAPE_ARRAY(ring_ids, ring_ids_count), ring_ids_count);
+	TAPE_HOOK(node, frame, transform);
 	return status;
 }
 
-void TapeCore::tape_node_rays_set_ring_ids(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_raytrace_configure_output_frame(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_rays_set_ring_ids(&node, state.getPtr<const int32_t>(yamlNode[1]), yamlNode[2].as<int32_t>());
-	state.nodes.insert({nodeId, node});
+	rgl_node_t node = state.nodes.at(nodeId);
+	rgl_node_raytrace_configure_output_frame(node, (rgl_output_frame_t) yamlNode[1].as<int32_t>(),
+	                                         state.getPtr<const rgl_mat3x4f>(yamlNode[2]));
 }
 
-RGL_API rgl_status_t rgl_node_rays_set_range(rgl_node_t* node, const rgl_vec2f* ranges, int32_t ranges_count)
+RGL_API rgl_status_t rgl_node_points_format(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_rays_set_range(node={}, ranges={})", repr(node), repr(ranges, ranges_count));
+		RGL_API_LOG("rgl_node_points_format(node={}, fields={})", repr(node), repr(fields, field_count));
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(ranges != nullptr);
-		CHECK_ARG(ranges_count > 0);
-		createOrUpdateNode<SetRangeRaysNode>(node, reinterpret_cast<const Vec2f*>(ranges), (size_t) ranges_count);
+		CHECK_ARG(fields != nullptr);
+		CHECK_ARG(field_count > 0);
+
+		createOrUpdateNode<FormatPointsNode>(node, std::vector<rgl_field_t>{fields, fields + field_count});
 	});
-	TAPE_HOOK(node, TAPE_ARRAY(ranges, ranges_count), ranges_count);
+	TAPE_HOOK(node, TAPE_ARRAY(fields, field_count), field_count);
 	return status;
 }
 
-void TapeCore::tape_node_rays_set_range(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_format(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_rays_set_range(&node, state.getPtr<const rgl_vec2f>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	rgl_node_points_format(&node, state.getPtr<const rgl_field_t>(yamlNode[1]), yamlNode[2].as<int32_t>());
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_rays_set_time_offsets(rgl_node_t* node, const float* offsets, int32_t offsets_count)
+RGL_API rgl_status_t rgl_node_points_yield(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_rays_set_time_offsets(node={}, offsets={})", repr(node), repr(offsets, offsets_count));
+		RGL_API_LOG("rgl_pipeline_yield(node={}, fields={})", repr(node), repr(fields, field_count));
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(offsets != nullptr);
-		CHECK_ARG(offsets_count > 0);
-		createOrUpdateNode<SetTimeOffsetsRaysNode>(node, offsets, (size_t) offsets_count);
+		CHECK_ARG(fields != nullptr);
+		CHECK_ARG(field_count > 0);
+
+		createOrUpdateNode<YieldPointsNode>(node, std::vector<rgl_field_t>{fields, fields + field_count});
 	});
-	TAPE_HOOK(node, TAPE_ARRAY(offsets, offsets_count), offsets_count);
+	TAPE_HOOK(node, TAPE_ARRAY(fields, field_count), field_count);
 	return status;
 }
 
-void TapeCore::tape_node_rays_set_time_offsets(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_yield(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_rays_set_time_offsets(&node, state.getPtr<const float>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	rgl_node_points_yield(&node, state.getPtr<const rgl_field_t>(yamlNode[1]), yamlNode[2].as<int32_t>());
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_rays_transform(rgl_node_t* node, const rgl_mat3x4f* transform)
+RGL_API rgl_status_t rgl_node_points_shm_publish(rgl_node_t* node, const char* shm_name, int32_t slot_count,
+                                                 int64_t slot_data_size, bool export_device_buffers)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_rays_transform(node={}, transform={})", repr(node), repr(transform));
+		RGL_API_LOG("rgl_node_points_shm_publish(node={}, shm_name={}, slot_count={}, slot_data_size={}, "
+		            "export_device_buffers={})",
+		            repr(node), shm_name, slot_count, slot_data_size, export_device_buffers);
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(transform != nullptr);
+		CHECK_ARG(shm_name != nullptr);
+		CHECK_ARG(shm_name[0] == '/');
+		CHECK_ARG(slot_count > 0);
+		CHECK_ARG(slot_data_size > 0);
 
-		createOrUpdateNode<TransformRaysNode>(node, Mat3x4f::fromRGL(*transform));
+		createOrUpdateNode<ShmPublishPointsNode>(node, shm_name, slot_count, static_cast<std::size_t>(slot_data_size),
+		                                         export_device_buffers);
 	});
-	TAPE_HOOK(node, transform);
+	TAPE_HOOK(node, shm_name, slot_count, slot_data_size, export_device_buffers);
 	return status;
 }
 
-void TapeCore::tape_node_rays_transform(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_shm_publish(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_rays_transform(&node, state.getPtr<const rgl_mat3x4f>(yamlNode[1]));
+	rgl_node_points_shm_publish(&node, yamlNode[1].as<std::string>().c_str(), yamlNode[2].as<int32_t>(),
+	                            yamlNode[3].as<int64_t>(), yamlNode[4].as<bool>());
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_points_transform(rgl_node_t* node, const rgl_mat3x4f* transform)
+RGL_API rgl_status_t rgl_node_points_write_file(rgl_node_t* node, const char* path_prefix, rgl_point_file_format_t format)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_points_transform(node={}, transform={})", repr(node), repr(transform));
+		RGL_API_LOG("rgl_node_points_write_file(node={}, path_prefix={}, format={})", repr(node), path_prefix, format);
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(transform != nullptr);
+		CHECK_ARG(path_prefix != nullptr);
+		CHECK_ARG(path_prefix[0] != '\0');
+		CHECK_ARG(format >= RGL_POINT_FILE_FORMAT_PCD && format <= RGL_POINT_FILE_FORMAT_LAS);
 
-		createOrUpdateNode<TransformPointsNode>(node, Mat3x4f::fromRGL(*transform));
+		createOrUpdateNode<WritePointsFileNode>(node, path_prefix, format);
 	});
-	TAPE_HOOK(node, transform);
+	TAPE_HOOK(node, path_prefix, format);
 	return status;
 }
 
-void TapeCore::tape_node_points_transform(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_write_file(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_points_transform(&node, state.getPtr<const rgl_mat3x4f>(yamlNode[1]));
+	rgl_node_points_write_file(&node, yamlNode[1].as<std::string>().c_str(),
+	                           (rgl_point_file_format_t) yamlNode[2].as<int>());
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_raytrace(rgl_node_t* node, rgl_scene_t scene)
+RGL_API rgl_status_t rgl_node_points_compress(rgl_node_t* node, float xyz_step)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_raytrace(node={}, scene={})", repr(node), (void*) scene);
+		RGL_API_LOG("rgl_node_points_compress(node={}, xyz_step={})", repr(node), xyz_step);
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(scene == nullptr); // TODO: remove once rgl_scene_t param is removed
+		CHECK_ARG(xyz_step > 0.0f);
 
-		createOrUpdateNode<RaytraceNode>(node);
-		auto raytraceNode = Node::validatePtr<RaytraceNode>(*node);
+		createOrUpdateNode<CompressPointsNode>(node, xyz_step);
 	});
-	TAPE_HOOK(node, scene);
+	TAPE_HOOK(node, xyz_step);
 	return status;
 }
 
-void TapeCore::tape_node_raytrace(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_compress(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_raytrace(&node, nullptr);
+	rgl_node_points_compress(&node, yamlNode[1].as<float>());
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_raytrace_configure_velocity(rgl_node_t node, const rgl_vec3f* linear_velocity,
-                                                          const rgl_vec3f* angular_velocity)
+RGL_API rgl_status_t rgl_node_points_compact(rgl_node_t* node)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_raytrace_configure_velocity(node={}, linear_velocity={}, angular_velocity={})", repr(node),
-		            repr(linear_velocity), repr(angular_velocity));
+		RGL_API_LOG("rgl_node_points_compact(node={})", repr(node));
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(linear_velocity != nullptr);
-		CHECK_ARG(angular_velocity != nullptr);
-		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
-		raytraceNode->setVelocity(*reinterpret_cast<const Vec3f*>(linear_velocity),
-		                          *reinterpret_cast<const Vec3f*>(angular_velocity));
+
+		std::vector<rgl_field_predicate_t> predicates = {{RGL_FIELD_IS_HIT_I32, RGL_COMPARISON_NOT_EQUAL, 0.0}};
+		createOrUpdateNode<CompactByFieldPointsNode>(node, predicates, false);
 	});
-	TAPE_HOOK(node, linear_velocity, angular_velocity);
+	TAPE_HOOK(node);
 	return status;
 }
 
-void TapeCore::tape_node_raytrace_configure_velocity(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_compact(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_node_t node = state.nodes.at(nodeId);
-	rgl_node_raytrace_configure_velocity(state.nodes.at(nodeId), state.getPtr<const rgl_vec3f>(yamlNode[1]),
-	                                     state.getPtr<const rgl_vec3f>(yamlNode[2]));
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_compact(&node);
+	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_raytrace_configure_distortion(rgl_node_t node, bool enable)
+RGL_API rgl_status_t rgl_node_points_compact_by_field(rgl_node_t* node, rgl_field_t field)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_raytrace_configure_distortion(node={}, enable={})", repr(node), enable);
+		RGL_API_LOG("rgl_node_points_compact_by_field(node={}, field={})", repr(node), field);
 		CHECK_ARG(node != nullptr);
-		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
-		raytraceNode->enableRayDistortion(enable);
+		CHECK_ARG(field == IS_HIT_I32 || field == IS_GROUND_I32);
+
+		std::vector<rgl_field_predicate_t> predicates = {{field, RGL_COMPARISON_NOT_EQUAL, 0.0}};
+		createOrUpdateNode<CompactByFieldPointsNode>(node, predicates, false);
 	});
-	TAPE_HOOK(node, enable);
+	TAPE_HOOK(node, field);
 	return status;
 }
 
-void TapeCore::tape_node_raytrace_configure_distortion(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_compact_by_field(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_node_t node = state.nodes.at(nodeId);
-	rgl_node_raytrace_configure_distortion(node, yamlNode[1].as<bool>());
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_field_t field = (rgl_field_t) yamlNode[1].as<int>();
+	rgl_node_points_compact_by_field(&node, field);
+	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_raytrace_configure_non_hits(rgl_node_t node, float nearDistance, float farDistance)
+RGL_API rgl_status_t rgl_node_points_compact_by_predicates(rgl_node_t* node, const rgl_field_predicate_t* predicates,
+                                                           int32_t predicate_count, bool match_any)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_raytrace_configure_non_hits(node={}, nearDistance={}, farDistance={})", repr(node), nearDistance,
-		            farDistance);
+		RGL_API_LOG("rgl_node_points_compact_by_predicates(node={}, predicates={}, match_any={})", repr(node),
+		            repr(predicates, predicate_count), match_any);
 		CHECK_ARG(node != nullptr);
-		RaytraceNode::Ptr raytraceNode = Node::validatePtr<RaytraceNode>(node);
-		raytraceNode->setNonHitDistanceValues(nearDistance, farDistance);
+		CHECK_ARG(predicates != nullptr);
+		CHECK_ARG(predicate_count > 0);
+
+		for (int i = 0; i < predicate_count; ++i) {
+			const rgl_field_predicate_t& predicate = predicates[i];
+			CHECK_ARG(isScalar(predicate.field));
+			CHECK_ARG(predicate.comparison >= RGL_COMPARISON_EQUAL && predicate.comparison <= RGL_COMPARISON_GREATER_EQUAL);
+			CHECK_ARG(!std::isnan(predicate.value));
+		}
+
+		createOrUpdateNode<CompactByFieldPointsNode>(
+		    node, std::vector<rgl_field_predicate_t>{predicates, predicates + predicate_count}, match_any);
 	});
-	TAPE_HOOK(node, nearDistance, farDistance);
+	TAPE_HOOK(node, TAPE_ARRAY(predicates, predicate_count), predicate_count, match_any);
 	return status;
 }
 
-void TapeCore::tape_node_raytrace_configure_non_hits(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_compact_by_predicates(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_node_t node = state.nodes.at(nodeId);
-	rgl_node_raytrace_configure_non_hits(node, yamlNode[1].as<float>(), yamlNode[2].as<float>());
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_compact_by_predicates(&node, state.getPtr<const rgl_field_predicate_t>(yamlNode[1]),
+	                                      yamlNode[2].as<int32_t>(), yamlNode[3].as<bool>());
+	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_points_format(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count)
+RGL_API rgl_status_t rgl_node_points_compact_by_region(rgl_node_t* node, const rgl_region_t* regions, int32_t region_count)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_points_format(node={}, fields={})", repr(node), repr(fields, field_count));
+		RGL_API_LOG("rgl_node_points_compact_by_region(node={}, regions={})", repr(node), repr(regions, region_count));
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(fields != nullptr);
-		CHECK_ARG(field_count > 0);
+		CHECK_ARG(region_count >= 0);
+		CHECK_ARG(regions != nullptr || region_count == 0);
+
+		for (int i = 0; i < region_count; ++i) {
+			const rgl_region_t& region = regions[i];
+			CHECK_ARG(region.shape == RGL_REGION_SHAPE_BOX || region.shape == RGL_REGION_SHAPE_CYLINDER ||
+			          region.shape == RGL_REGION_SHAPE_DISTANCE_BAND);
+			CHECK_ARG(region.min.value[0] <= region.max.value[0]);
+			CHECK_ARG(region.shape != RGL_REGION_SHAPE_BOX || region.min.value[1] <= region.max.value[1]);
+			CHECK_ARG(region.shape == RGL_REGION_SHAPE_DISTANCE_BAND || region.min.value[2] <= region.max.value[2]);
+			CHECK_ARG(region.shape == RGL_REGION_SHAPE_BOX || region.min.value[0] >= 0.0f);
+		}
 
-		createOrUpdateNode<FormatPointsNode>(node, std::vector<rgl_field_t>{fields, fields + field_count});
+		createOrUpdateNode<CompactByRegionPointsNode>(node, regions, region_count);
 	});
-	TAPE_HOOK(node, TAPE_ARRAY(fields, field_count), field_count);
+	TAPE_HOOK(node, TAPE_ARRAY(regions, region_count), region_count);
 	return status;
 }
 
-void TapeCore::tape_node_points_format(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_compact_by_region(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_points_format(&node, state.getPtr<const rgl_field_t>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	auto regionCount = yamlNode[2].as<int32_t>();
+	auto regions = regionCount > 0 ? state.getPtr<const rgl_region_t>(yamlNode[1]) : nullptr;
+	rgl_node_points_compact_by_region(&node, regions, regionCount);
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_points_yield(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count)
+RGL_API rgl_status_t rgl_node_points_range_image(rgl_node_t* node, int32_t height, int32_t width, float azimuth_min,
+                                                 float azimuth_max)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_pipeline_yield(node={}, fields={})", repr(node), repr(fields, field_count));
+		RGL_API_LOG("rgl_node_points_range_image(node={}, height={}, width={}, azimuth_min={}, azimuth_max={})", repr(node),
+		            height, width, azimuth_min, azimuth_max);
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(fields != nullptr);
-		CHECK_ARG(field_count > 0);
+		CHECK_ARG(height > 0);
+		CHECK_ARG(width > 0);
+		CHECK_ARG(static_cast<int64_t>(height) * width <= std::numeric_limits<int32_t>::max());
+		CHECK_ARG(std::isfinite(azimuth_min));
+		CHECK_ARG(std::isfinite(azimuth_max));
+		CHECK_ARG(azimuth_min < azimuth_max);
 
-		createOrUpdateNode<YieldPointsNode>(node, std::vector<rgl_field_t>{fields, fields + field_count});
+		createOrUpdateNode<RangeImagePointsNode>(node, height, width, azimuth_min, azimuth_max);
 	});
-	TAPE_HOOK(node, TAPE_ARRAY(fields, field_count), field_count);
+	TAPE_HOOK(node, height, width, azimuth_min, azimuth_max);
 	return status;
 }
 
-void TapeCore::tape_node_points_yield(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_range_image(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_points_yield(&node, state.getPtr<const rgl_field_t>(yamlNode[1]), yamlNode[2].as<int32_t>());
+	rgl_node_points_range_image(&node, yamlNode[1].as<int32_t>(), yamlNode[2].as<int32_t>(), yamlNode[3].as<float>(),
+	                            yamlNode[4].as<float>());
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_points_compact(rgl_node_t* node)
+RGL_API rgl_status_t rgl_node_points_occupancy_grid(rgl_node_t* node, const rgl_vec3f* grid_min, const rgl_vec3f* cell_size,
+                                                    int32_t size_x, int32_t size_y, int32_t size_z, bool accumulate)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_points_compact(node={})", repr(node));
+		RGL_API_LOG("rgl_node_points_occupancy_grid(node={}, grid_min={}, cell_size={}, size_x={}, size_y={}, size_z={}, "
+		            "accumulate={})",
+		            repr(node), repr(grid_min), repr(cell_size), size_x, size_y, size_z, accumulate);
 		CHECK_ARG(node != nullptr);
-
-		createOrUpdateNode<CompactByFieldPointsNode>(node, RGL_FIELD_IS_HIT_I32);
+		CHECK_ARG(grid_min != nullptr);
+		CHECK_ARG(cell_size != nullptr);
+		CHECK_ARG(std::ranges::all_of(grid_min->value, [](float v) { return std::isfinite(v); }));
+		CHECK_ARG(std::ranges::all_of(cell_size->value, [](float v) { return std::isfinite(v) && v > 0.0f; }));
+		CHECK_ARG(size_x > 0);
+		CHECK_ARG(size_y > 0);
+		CHECK_ARG(size_z > 0);
+		CHECK_ARG(static_cast<int64_t>(size_x) * size_y * size_z <= std::numeric_limits<int32_t>::max());
+
+		createOrUpdateNode<OccupancyGridPointsNode>(node, *reinterpret_cast<const Vec3f*>(grid_min),
+		                                            *reinterpret_cast<const Vec3f*>(cell_size), Vec3i{size_x, size_y, size_z},
+		                                            accumulate);
 	});
-	TAPE_HOOK(node);
+	TAPE_HOOK(node, grid_min, cell_size, size_x, size_y, size_z, accumulate);
 	return status;
 }
 
-void TapeCore::tape_node_points_compact(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_occupancy_grid(const YAML::Node& yamlNode, PlaybackState& state)
 {
 	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
 	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_node_points_compact(&node);
+	rgl_node_points_occupancy_grid(&node, state.getPtr<const rgl_vec3f>(yamlNode[1]),
+	                               state.getPtr<const rgl_vec3f>(yamlNode[2]), yamlNode[3].as<int32_t>(),
+	                               yamlNode[4].as<int32_t>(), yamlNode[5].as<int32_t>(), yamlNode[6].as<bool>());
 	state.nodes.insert({nodeId, node});
 }
 
-RGL_API rgl_status_t rgl_node_points_compact_by_field(rgl_node_t* node, rgl_field_t field)
+RGL_API rgl_status_t rgl_node_points_occupancy_grid_configure_ray_casting(rgl_node_t node, bool enable,
+                                                                          const rgl_vec3f* ray_origin)
 {
 	auto status = rglSafeCall([&]() {
-		RGL_API_LOG("rgl_node_points_compact_by_field(node={}, field={})", repr(node), field);
+		RGL_API_LOG("rgl_node_points_occupancy_grid_configure_ray_casting(node={}, enable={}, ray_origin={})", repr(node),
+		            enable, repr(ray_origin));
 		CHECK_ARG(node != nullptr);
-		CHECK_ARG(field == IS_HIT_I32 || field == IS_GROUND_I32);
-
-		createOrUpdateNode<CompactByFieldPointsNode>(node, field);
+		CHECK_ARG(ray_origin != nullptr);
+		CHECK_ARG(std::ranges::all_of(ray_origin->value, [](float v) { return std::isfinite(v); }));
+		OccupancyGridPointsNode::Ptr occupancyGridNode = Node::validatePtr<OccupancyGridPointsNode>(node);
+		occupancyGridNode->setRayCasting(enable, *reinterpret_cast<const Vec3f*>(ray_origin));
 	});
-	TAPE_HOOK(node, field);
+	TAPE_HOOK(node, enable, ray_origin);
 	return status;
 }
 
-void TapeCore::tape_node_points_compact_by_field(const YAML::Node& yamlNode, PlaybackState& state)
+void TapeCore::tape_node_points_occupancy_grid_configure_ray_casting(const YAML::Node& yamlNode, PlaybackState& state)
 {
-	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
-	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
-	rgl_field_t field = (rgl_field_t) yamlNode[1].as<int>();
-	rgl_node_points_compact_by_field(&node, field);
-	state.nodes.insert({nodeId, node});
+	rgl_node_points_occupancy_grid_configure_ray_casting(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                                                     yamlNode[1].as<bool>(), state.getPtr<const rgl_vec3f>(yamlNode[2]));
 }
 
 RGL_API rgl_status_t rgl_node_points_spatial_merge(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count)
@@ -1049,6 +3453,52 @@ void TapeCore::tape_node_points_temporal_merge(const YAML::Node& yamlNode, Playb
 	state.nodes.insert({nodeId, node});
 }
 
+RGL_API rgl_status_t rgl_node_points_temporal_merge_ring(rgl_node_t* node, const rgl_field_t* fields, int32_t field_count,
+                                                         int32_t max_point_count, double time_window)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_temporal_merge_ring(node={}, fields={}, max_point_count={}, time_window={})", repr(node),
+		            repr(fields, field_count), max_point_count, time_window);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(fields != nullptr);
+		CHECK_ARG(field_count > 0);
+		CHECK_ARG(max_point_count > 0);
+		CHECK_ARG(time_window >= 0.0);
+
+		createOrUpdateNode<TemporalMergePointsNode>(node, std::vector<rgl_field_t>{fields, fields + field_count},
+		                                            static_cast<std::size_t>(max_point_count), time_window);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(fields, field_count), field_count, max_point_count, time_window);
+	return status;
+}
+
+void TapeCore::tape_node_points_temporal_merge_ring(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes[nodeId] : nullptr;
+	rgl_node_points_temporal_merge_ring(&node, state.getPtr<const rgl_field_t>(yamlNode[1]), yamlNode[2].as<int32_t>(),
+	                                    yamlNode[3].as<int32_t>(), yamlNode[4].as<double>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_temporal_merge_configure_managed_memory(rgl_node_t node, bool enable)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_temporal_merge_configure_managed_memory(node={}, enable={})", repr(node), enable);
+		CHECK_ARG(node != nullptr);
+		TemporalMergePointsNode::Ptr temporalMergeNode = Node::validatePtr<TemporalMergePointsNode>(node);
+		temporalMergeNode->setManagedMemory(enable);
+	});
+	TAPE_HOOK(node, enable);
+	return status;
+}
+
+void TapeCore::tape_node_points_temporal_merge_configure_managed_memory(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	rgl_node_points_temporal_merge_configure_managed_memory(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                                                        yamlNode[1].as<bool>());
+}
+
 RGL_API rgl_status_t rgl_node_points_from_array(rgl_node_t* node, const void* points, int32_t points_count,
                                                 const rgl_field_t* fields, int32_t field_count)
 {
@@ -1080,6 +3530,35 @@ void TapeCore::tape_node_points_from_array(const YAML::Node& yamlNode, PlaybackS
 	state.nodes.insert({nodeId, node});
 }
 
+RGL_API rgl_status_t rgl_node_points_from_device_array(rgl_node_t* node, const void* points, int32_t points_count,
+                                                       const rgl_field_t* fields, int32_t field_count)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_from_device_array(node={}, points=[{},{}], fields={})", repr(node), (void*) points,
+		            points_count, repr(fields, field_count));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(points != nullptr);
+		CHECK_ARG(points_count > 0);
+		CHECK_ARG(fields != nullptr);
+		CHECK_ARG(field_count > 0);
+
+		createOrUpdateNode<FromArrayPointsNode>(node, points, points_count,
+		                                        std::vector<rgl_field_t>{fields, fields + field_count}, true);
+	});
+	// Points are not on the host; tapes get their current content, played back as a regular (copied) array.
+	if (status == RGL_SUCCESS) {
+		std::size_t pointsSize = points_count * getPointSize(std::vector<rgl_field_t>{fields, fields + field_count});
+		auto downloadPoints = [&]() {
+			std::vector<char> hostPoints(pointsSize);
+			CHECK_CUDA(cudaMemcpy(hostPoints.data(), points, pointsSize, cudaMemcpyDefault));
+			return hostPoints;
+		};
+		TAPE_HOOK_AS("rgl_node_points_from_array", node, TAPE_ARRAY(downloadPoints().data(), pointsSize), points_count,
+		             TAPE_ARRAY(fields, field_count), field_count);
+	}
+	return status;
+}
+
 RGL_API rgl_status_t rgl_node_points_radar_postprocess(rgl_node_t* node, const rgl_radar_scope_t* radar_scopes,
                                                        int32_t radar_scopes_count, float ray_azimuth_step,
                                                        float ray_elevation_step, float frequency, float power_transmitted,
@@ -1131,6 +3610,39 @@ void TapeCore::tape_node_points_radar_postprocess(const YAML::Node& yamlNode, Pl
 	state.nodes.insert({nodeId, node});
 }
 
+RGL_API rgl_status_t rgl_node_points_radar_range_doppler(rgl_node_t* node, const rgl_radar_fmcw_config_t* config,
+                                                         float ray_azimuth_step, float ray_elevation_step)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_radar_range_doppler(node={}, config={}, ray_azimuth_step={}, ray_elevation_step={})",
+		            repr(node), repr(config, 1), ray_azimuth_step, ray_elevation_step);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(config != nullptr);
+		CHECK_ARG(ray_azimuth_step > 0);
+		CHECK_ARG(ray_elevation_step > 0);
+		CHECK_ARG(config->center_frequency > 0);
+		CHECK_ARG(config->bandwidth > 0);
+		CHECK_ARG(config->chirp_duration > 0);
+		CHECK_ARG(config->samples_per_chirp > 1);
+		CHECK_ARG(config->chirp_count > 1);
+		CHECK_ARG(config->cfar_guard_cells >= 0);
+		CHECK_ARG(config->cfar_training_cells > 0);
+
+		createOrUpdateNode<RadarRangeDopplerPointsNode>(node, *config, ray_azimuth_step, ray_elevation_step);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(config, 1), ray_azimuth_step, ray_elevation_step);
+	return status;
+}
+
+void TapeCore::tape_node_points_radar_range_doppler(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_radar_range_doppler(&node, state.getPtr<const rgl_radar_fmcw_config_t>(yamlNode[1]),
+	                                    yamlNode[2].as<float>(), yamlNode[3].as<float>());
+	state.nodes.insert({nodeId, node});
+}
+
 RGL_API rgl_status_t rgl_node_points_filter_ground(rgl_node_t* node, const rgl_vec3f* sensor_up_vector,
                                                    float ground_angle_threshold)
 {
@@ -1157,6 +3669,248 @@ void TapeCore::tape_node_points_filter_ground(const YAML::Node& yamlNode, Playba
 	state.nodes.insert({nodeId, node});
 }
 
+RGL_API rgl_status_t rgl_node_points_filter_ground_plane(rgl_node_t* node, const rgl_vec3f* sensor_up_vector,
+                                                         float ground_angle_threshold, float ground_distance_threshold,
+                                                         float ground_filter_distance, int32_t max_iterations)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_filter_ground_plane(node={}, sensor_up_vector={}, ground_angle_threshold={}, "
+		            "ground_distance_threshold={}, ground_filter_distance={}, max_iterations={})",
+		            repr(node), repr(sensor_up_vector, 1), ground_angle_threshold, ground_distance_threshold,
+		            ground_filter_distance, max_iterations);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(sensor_up_vector != nullptr);
+		CHECK_ARG(ground_angle_threshold >= 0);
+		CHECK_ARG(ground_distance_threshold >= 0);
+		CHECK_ARG(ground_filter_distance >= 0);
+		CHECK_ARG(max_iterations > 0);
+		auto upVector = *reinterpret_cast<const Vec3f*>(sensor_up_vector);
+		CHECK_ARG(upVector.length() > 0.0f);
+
+		createOrUpdateNode<FilterGroundPlanePointsNode>(node, upVector, ground_angle_threshold, ground_distance_threshold,
+		                                                ground_filter_distance, max_iterations);
+	});
+	TAPE_HOOK(node, sensor_up_vector, ground_angle_threshold, ground_distance_threshold, ground_filter_distance,
+	          max_iterations);
+	return status;
+}
+
+void TapeCore::tape_node_points_filter_ground_plane(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_filter_ground_plane(&node, state.getPtr<const rgl_vec3f>(yamlNode[1]), yamlNode[2].as<float>(),
+	                                    yamlNode[3].as<float>(), yamlNode[4].as<float>(), yamlNode[5].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_voxel_downsample(rgl_node_t* node, float leaf_size_x, float leaf_size_y,
+                                                      float leaf_size_z)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_voxel_downsample(node={}, leaf=({}, {}, {}))", repr(node), leaf_size_x, leaf_size_y,
+		            leaf_size_z);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(leaf_size_x > 0.0f);
+		CHECK_ARG(leaf_size_y > 0.0f);
+		CHECK_ARG(leaf_size_z > 0.0f);
+
+		createOrUpdateNode<VoxelDownsamplePointsNode>(node, Vec3f{leaf_size_x, leaf_size_y, leaf_size_z});
+	});
+	TAPE_HOOK(node, leaf_size_x, leaf_size_y, leaf_size_z);
+	return status;
+}
+
+void TapeCore::tape_node_points_voxel_downsample(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_voxel_downsample(&node, yamlNode[1].as<float>(), yamlNode[2].as<float>(), yamlNode[3].as<float>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_sort(rgl_node_t* node, rgl_field_t key_field, bool descending)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_sort(node={}, key_field={}, descending={})", repr(node), key_field, descending);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(isScalar(key_field));
+
+		createOrUpdateNode<SortPointsNode>(node, key_field, descending);
+	});
+	TAPE_HOOK(node, key_field, descending);
+	return status;
+}
+
+void TapeCore::tape_node_points_sort(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_field_t keyField = (rgl_field_t) yamlNode[1].as<int>();
+	rgl_node_points_sort(&node, keyField, yamlNode[2].as<bool>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_estimate_normals(rgl_node_t* node, float radius)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_estimate_normals(node={}, radius={})", repr(node), radius);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(radius > 0.0f);
+
+		createOrUpdateNode<EstimateNormalsPointsNode>(node, radius);
+	});
+	TAPE_HOOK(node, radius);
+	return status;
+}
+
+void TapeCore::tape_node_points_estimate_normals(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_estimate_normals(&node, yamlNode[1].as<float>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_cluster_euclidean(rgl_node_t* node, float tolerance, int32_t min_cluster_size,
+                                                       int32_t max_cluster_size)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_cluster_euclidean(node={}, tolerance={}, min_cluster_size={}, max_cluster_size={})",
+		            repr(node), tolerance, min_cluster_size, max_cluster_size);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(tolerance > 0.0f);
+		CHECK_ARG(min_cluster_size > 0);
+		CHECK_ARG(max_cluster_size >= min_cluster_size);
+
+		createOrUpdateNode<EuclideanClusterPointsNode>(node, tolerance, min_cluster_size, max_cluster_size);
+	});
+	TAPE_HOOK(node, tolerance, min_cluster_size, max_cluster_size);
+	return status;
+}
+
+void TapeCore::tape_node_points_cluster_euclidean(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_cluster_euclidean(&node, yamlNode[1].as<float>(), yamlNode[2].as<int32_t>(), yamlNode[3].as<int32_t>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_cluster_boxes(rgl_node_t* node)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_cluster_boxes(node={})", repr(node));
+		CHECK_ARG(node != nullptr);
+
+		createOrUpdateNode<ClusterBoxesPointsNode>(node);
+	});
+	TAPE_HOOK(node);
+	return status;
+}
+
+void TapeCore::tape_node_points_cluster_boxes(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_cluster_boxes(&node);
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_spatial_index(rgl_node_t* node, float cell_size)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_spatial_index(node={}, cell_size={})", repr(node), cell_size);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(cell_size > 0.0f);
+
+		createOrUpdateNode<SpatialIndexPointsNode>(node, cell_size);
+	});
+	TAPE_HOOK(node, cell_size);
+	return status;
+}
+
+void TapeCore::tape_node_points_spatial_index(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_points_spatial_index(&node, yamlNode[1].as<float>());
+	state.nodes.insert({nodeId, node});
+}
+
+RGL_API rgl_status_t rgl_node_points_spatial_index_query_nearest(rgl_node_t node, const rgl_vec3f* queries,
+                                                                 int32_t query_count, float max_distance,
+                                                                 int32_t* out_indices, float* out_distances)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_spatial_index_query_nearest(node={}, queries={}, max_distance={}, out_indices={}, "
+		            "out_distances={})",
+		            repr(node), repr(queries, query_count), max_distance, (void*) out_indices, (void*) out_distances);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(queries != nullptr);
+		CHECK_ARG(query_count >= 0);
+		CHECK_ARG(max_distance > 0.0f);
+		CHECK_ARG(out_indices != nullptr);
+		CHECK_ARG(out_distances != nullptr);
+
+		auto spatialIndexNode = Node::validatePtr<SpatialIndexPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(spatialIndexNode);
+		spatialIndexNode->waitForResults();
+		spatialIndexNode->queryNearest(reinterpret_cast<const Vec3f*>(queries), query_count, max_distance, out_indices,
+		                               out_distances);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(queries, query_count), query_count, max_distance, out_indices, out_distances);
+	return status;
+}
+
+void TapeCore::tape_node_points_spatial_index_query_nearest(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto queryCount = yamlNode[2].as<int32_t>();
+	std::vector<int32_t> indices(queryCount);
+	std::vector<float> distances(queryCount);
+	rgl_node_points_spatial_index_query_nearest(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                                            state.getPtr<const rgl_vec3f>(yamlNode[1]), queryCount,
+	                                            yamlNode[3].as<float>(), indices.data(), distances.data());
+}
+
+RGL_API rgl_status_t rgl_node_points_spatial_index_query_radius(rgl_node_t node, const rgl_vec3f* queries, int32_t query_count,
+                                                                float radius, int32_t max_neighbour_count,
+                                                                int32_t* out_indices, int32_t* out_counts)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_points_spatial_index_query_radius(node={}, queries={}, radius={}, max_neighbour_count={}, "
+		            "out_indices={}, out_counts={})",
+		            repr(node), repr(queries, query_count), radius, max_neighbour_count, (void*) out_indices,
+		            (void*) out_counts);
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(queries != nullptr);
+		CHECK_ARG(query_count >= 0);
+		CHECK_ARG(radius > 0.0f);
+		CHECK_ARG(max_neighbour_count > 0);
+		CHECK_ARG(out_indices != nullptr);
+		CHECK_ARG(out_counts != nullptr);
+
+		auto spatialIndexNode = Node::validatePtr<SpatialIndexPointsNode>(node);
+		auto graphLock = GraphRunCtx::lockGraphOf(spatialIndexNode);
+		spatialIndexNode->waitForResults();
+		spatialIndexNode->queryRadius(reinterpret_cast<const Vec3f*>(queries), query_count, radius, max_neighbour_count,
+		                              out_indices, out_counts);
+	});
+	TAPE_HOOK(node, TAPE_ARRAY(queries, query_count), query_count, radius, max_neighbour_count, out_indices, out_counts);
+	return status;
+}
+
+void TapeCore::tape_node_points_spatial_index_query_radius(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto queryCount = yamlNode[2].as<int32_t>();
+	auto maxNeighbourCount = yamlNode[4].as<int32_t>();
+	std::vector<int32_t> indices(static_cast<size_t>(queryCount) * maxNeighbourCount);
+	std::vector<int32_t> counts(queryCount);
+	rgl_node_points_spatial_index_query_radius(state.nodes.at(yamlNode[0].as<TapeAPIObjectID>()),
+	                                           state.getPtr<const rgl_vec3f>(yamlNode[1]), queryCount, yamlNode[3].as<float>(),
+	                                           maxNeighbourCount, indices.data(), counts.data());
+}
+
 RGL_API rgl_status_t rgl_node_gaussian_noise_angular_ray(rgl_node_t* node, float mean, float st_dev, rgl_axis_t rotation_axis)
 {
 	auto status = rglSafeCall([&]() {
@@ -1230,11 +3984,49 @@ void TapeCore::tape_node_gaussian_noise_distance(const YAML::Node& yamlNode, Pla
 	state.nodes.insert({nodeId, node});
 }
 
+RGL_API rgl_status_t rgl_node_gaussian_noise_transform_points(rgl_node_t* node, float angular_mean, float angular_st_dev,
+                                                              rgl_axis_t angular_axis, float distance_mean,
+                                                              float distance_st_dev_base,
+                                                              float distance_st_dev_rise_per_meter,
+                                                              const rgl_mat3x4f* transform)
+{
+	auto status = rglSafeCall([&]() {
+		RGL_API_LOG("rgl_node_gaussian_noise_transform_points(node={}, angular_mean={}, angular_st_dev={}, angular_axis={}, "
+		            "distance_mean={}, distance_st_dev_base={}, distance_st_dev_rise_per_meter={}, transform={})",
+		            repr(node), angular_mean, angular_st_dev, angular_axis, distance_mean, distance_st_dev_base,
+		            distance_st_dev_rise_per_meter, repr(transform));
+		CHECK_ARG(node != nullptr);
+		CHECK_ARG(angular_st_dev >= 0);
+		CHECK_ARG((angular_axis == RGL_AXIS_X) || (angular_axis == RGL_AXIS_Y) || (angular_axis == RGL_AXIS_Z));
+		CHECK_ARG(distance_st_dev_base >= 0);
+		CHECK_ARG(distance_st_dev_rise_per_meter >= 0);
+		CHECK_ARG(transform != nullptr);
+
+		createOrUpdateNode<GaussianNoiseTransformPointsNode>(node, angular_mean, angular_st_dev, angular_axis, distance_mean,
+		                                                     distance_st_dev_base, distance_st_dev_rise_per_meter,
+		                                                     Mat3x4f::fromRGL(*transform));
+	});
+	TAPE_HOOK(node, angular_mean, angular_st_dev, angular_axis, distance_mean, distance_st_dev_base,
+	          distance_st_dev_rise_per_meter, transform);
+	return status;
+}
+
+void TapeCore::tape_node_gaussian_noise_transform_points(const YAML::Node& yamlNode, PlaybackState& state)
+{
+	auto nodeId = yamlNode[0].as<TapeAPIObjectID>();
+	rgl_node_t node = state.nodes.contains(nodeId) ? state.nodes.at(nodeId) : nullptr;
+	rgl_node_gaussian_noise_transform_points(&node, yamlNode[1].as<float>(), yamlNode[2].as<float>(),
+	                                         (rgl_axis_t) yamlNode[3].as<size_t>(), yamlNode[4].as<float>(),
+	                                         yamlNode[5].as<float>(), yamlNode[6].as<float>(),
+	                                         state.getPtr<const rgl_mat3x4f>(yamlNode[7]));
+	state.nodes.insert({nodeId, node});
+}
+
 rgl_status_t rgl_node_is_alive(rgl_node_t node, bool* out_alive)
 {
 	auto status = rglSafeCall([&]() {
 		CHECK_ARG(out_alive != nullptr);
-		*out_alive = Node::instances.contains(node);
+		*out_alive = Node::isAlive(node);
 	});
 	TAPE_HOOK(node, out_alive);
 	return status;
@@ -1278,7 +4070,11 @@ RGL_API rgl_status_t rgl_tape_record_end()
 		if (!tapeRecorder.has_value()) {
 			throw RecordError("rgl_tape_record_end: no recording active");
 		} else {
+			std::exception_ptr writerError = tapeRecorder->finish();
 			tapeRecorder.reset();
+			if (writerError != nullptr) {
+				std::rethrow_exception(writerError);
+			}
 		}
 	});
 #endif //_WIN32
@@ -1293,6 +4089,34 @@ RGL_API rgl_status_t rgl_tape_record_is_active(bool* is_active)
 	});
 }
 
+RGL_API rgl_status_t rgl_replication_begin(const char* address)
+{
+	return rglSafeCall([&]() {
+		RGL_API_LOG("rgl_replication_begin(address={})", address);
+		CHECK_ARG(address != nullptr);
+		CHECK_ARG(address[0] != '\0');
+		if (replicationRecorder.has_value()) {
+			throw RecordError("rgl_replication_begin: replication already active");
+		}
+		replicationRecorder.emplace(std::string(address));
+	});
+}
+
+RGL_API rgl_status_t rgl_replication_end()
+{
+	return rglSafeCall([&]() {
+		RGL_API_LOG("rgl_replication_end()");
+		if (!replicationRecorder.has_value()) {
+			throw RecordError("rgl_replication_end: no replication active");
+		}
+		std::exception_ptr writerError = replicationRecorder->finish();
+		replicationRecorder.reset();
+		if (writerError != nullptr) {
+			std::rethrow_exception(writerError);
+		}
+	});
+}
+
 RGL_API rgl_status_t rgl_tape_play(const char* path)
 {
 #ifdef _WIN32
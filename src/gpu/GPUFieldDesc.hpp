@@ -16,6 +16,9 @@
 
 #include <type_traits>
 
+#include <rgl/api/core.h>
+#include <macros/cuda.hpp>
+
 // Used to send e.g. formatting request to GPU
 struct GPUFieldDesc
 {
@@ -29,3 +32,38 @@ struct GPUFieldDesc
 	size_t dstOffset;
 };
 static_assert(std::is_trivially_copyable<GPUFieldDesc>::value);
+
+// Descriptors of all fields for a formatting kernel. Up to INLINE_CAPACITY descriptors are passed by value
+// (in kernel parameters), which avoids uploading them; otherwise, they are read from device memory (devicePtr).
+struct GPUFieldDescs
+{
+	static constexpr size_t INLINE_CAPACITY = 16;
+
+	HostDevFn const GPUFieldDesc& operator[](size_t idx) const { return devicePtr != nullptr ? devicePtr[idx] : inlined[idx]; }
+
+	const GPUFieldDesc* devicePtr;
+	GPUFieldDesc inlined[INLINE_CAPACITY];
+};
+static_assert(std::is_trivially_copyable<GPUFieldDescs>::value);
+
+// Used to send merge request to GPU: pointCount points of a field are copied from src to dst,
+// which is the field's merged array at pointOffset.
+struct GPUMergeDesc
+{
+	const char* src;
+	char* dst;
+	size_t pointOffset;
+	size_t pointCount;
+	size_t fieldSize;
+};
+static_assert(std::is_trivially_copyable<GPUMergeDesc>::value);
+
+// Used to send compaction predicates to GPU: values of a scalar field (given by data) are compared with the operand.
+struct GPUFieldPredicate
+{
+	const char* data;
+	rgl_field_t field;
+	rgl_comparison_t comparison;
+	double value;
+};
+static_assert(std::is_trivially_copyable<GPUFieldPredicate>::value);
@@ -16,6 +16,38 @@
 
 #include <optix.h>
 #include <RGLFields.hpp>
+#include <gpu/ShaderBindingTableTypes.h>
+
+// Closest-hit program is compiled in several variants, each bit of the variant index enables computing a group of fields.
+// Variant is selected per launch, using SBT offset in optixTrace; SBT contains CLOSEST_HIT_VARIANT_COUNT records per mesh.
+static constexpr unsigned CLOSEST_HIT_FEATURE_NORMAL = 1 << 0;   // NORMAL_VEC3_F32, NORMAL_VEC3_F16, INCIDENT_ANGLE_F32
+static constexpr unsigned CLOSEST_HIT_FEATURE_VELOCITY = 1 << 1; // Point velocities, RADIAL_SPEED_F32
+static constexpr unsigned CLOSEST_HIT_VARIANT_COUNT = 4;
+
+// Kinds of primitives a mesh may consist of (see Mesh::getPrimitiveType); each has its own hitgroup programs,
+// since spheres and curves are intersected by OptiX built-in programs instead of the triangle hardware.
+static constexpr unsigned MESH_PRIMITIVE_TRIANGLES = 0;
+static constexpr unsigned MESH_PRIMITIVE_SPHERES = 1;
+static constexpr unsigned MESH_PRIMITIVE_CURVES = 2; // Round linear segments, see Mesh::createCurves
+static constexpr unsigned MESH_PRIMITIVE_TYPE_COUNT = 3;
+
+// Multi-return modes trace the ray repeatedly, starting each trace slightly behind the previous hit.
+static constexpr unsigned MULTI_RETURN_MAX_HIT_COUNT = 8;       // Surfaces considered along a single ray
+static constexpr float MULTI_RETURN_MIN_HIT_SEPARATION = 1e-3f; // Prevents hitting the same surface again
+
+// Payload value telling closest-hit and miss programs that the trace only probes a sub-ray of a divergent beam.
+static constexpr unsigned TRACE_MODE_SHADE = 0;
+static constexpr unsigned TRACE_MODE_BEAM_PROBE = 1;
+static constexpr unsigned TRACE_MODE_MULTIPATH_BOUNCE = 2; // Ray reflected specularly off the previous hit of the ray
+
+// Random numbers of a ray come from separate subsequences: one for ray angular noise, then one per hit for distance noise,
+// then one for the distance to the weather particle.
+static constexpr unsigned NOISE_SUBSEQUENCE_WEATHER = 1 + MULTI_RETURN_MAX_HIT_COUNT;
+static constexpr unsigned NOISE_SUBSEQUENCES_PER_RAY = 2 + MULTI_RETURN_MAX_HIT_COUNT;
+
+// Multipath returns follow the first return of the ray, see rgl_node_raytrace_configure_multipath.
+static constexpr unsigned MULTIPATH_MAX_BOUNCE_COUNT = 3;
+static_assert(MULTIPATH_MAX_BOUNCE_COUNT < MULTI_RETURN_MAX_HIT_COUNT); // Each return has its own distance noise
 
 struct RaytraceRequestContext
 {
@@ -28,9 +60,16 @@ struct RaytraceRequestContext
 	float farNonHitDistance;
 
 	const Mat3x4f* rays;
+	Mat3x4f raysTransform; // Applied to rays in raygen, see IRaysNode::getPendingRayTransform()
+	const Vec3f* rayDirections; // If not null, rays are given by directions in the ray origin frame instead of transforms
 	size_t rayCount;
+	size_t rayLayoutWidth; // Rays are stored row-major in (rayLayoutWidth x rayCount / rayLayoutWidth) layout
+	const uint32_t* rayIdxRemap; // If not null, maps launch (layout) indices to traced rays, see gpuComputeRayDirectionKeys
+	size_t launchIdxOffset;      // Added to launch indices, when the request traces a part of rays (see time slicing)
 
 	Mat3x4f rayOriginToWorld;
+	bool doTransformOutput; // If true, XYZ, normals and absolute velocities are written in the frame given by worldToOutput
+	Mat3x4f worldToOutput;  // See rgl_node_raytrace_configure_output_frame
 
 	const Vec2f* rayRanges;
 	size_t rayRangesCount;
@@ -42,10 +81,59 @@ struct RaytraceRequestContext
 	size_t rayTimeOffsetsCount;
 
 	OptixTraversableHandle scene;
+	unsigned visibilityMask; // Instances sharing no bit with it are culled, see rgl_node_raytrace_configure_visibility_mask
+	const EntityInstanceData* entityInstances;              // Indexed by instance index, see getEntityInstanceIndex()
+	const EntityTransformHistory* entityTransformHistories; // Indexed as entityInstances
+	const cudaTextureObject_t* textures;                    // Indexed by EntityInstanceData::textureIdx
 	double sceneTime;
+	double prevSceneTime; // Of the previous frame, velocities are displacements since then; valid if sceneDeltaTime > 0
 	float sceneDeltaTime;
+	unsigned closestHitVariant; // See CLOSEST_HIT_FEATURE_*
+	rgl_return_mode_t returnMode;
+	unsigned returnCount; // Points per ray; output is return-major: point index = returnIdx * rayCount + rayIdx
+	float beamHalfDivergence;
+	unsigned beamSampleCount; // Sub-rays per ray, 1 disables beam divergence
+	rgl_beam_reduction_t beamReduction;
+
+	// Noise is drawn from a counter-based RNG indexed by (seed, frame, ray), so every program may regenerate it on demand.
+	float rayAngularNoiseMean;
+	float rayAngularNoiseStDev;
+	rgl_axis_t rayAngularNoiseAxis;
+	float hitDistanceNoiseMean;
+	float hitDistanceNoiseStDevBase;
+	float hitDistanceNoiseStDevRisePerMeter;
+	uint64_t noiseSeed;
+	uint64_t noiseFrame;
+
+	// Weather is a homogeneous medium of particles (see rgl_node_raytrace_configure_weather), zero extinction disables it.
+	float weatherExtinctionCoefficient;
+	float weatherParticleIntensity;
+
+	// Multipath: rays are reflected specularly off their hits, reporting surfaces met by each bounce as further returns
+	// (see rgl_node_raytrace_configure_multipath); zero bounce count disables it.
+	unsigned multipathBounceCount;
+	float multipathReflectivity; // Attenuation of intensity per reflection
+
+	// Incremental mode (see RaytraceNode::setIncremental): if prevRays is not null, raygen stores there the world pose
+	// and range of each ray. If changedBounds are given as well, rays whose pose and range equal the stored ones and which
+	// segments miss all changed bounds (world spheres) are not traced, keeping their previous output.
+	Mat3x4f* incrementalPrevRays;
+	Vec2f* incrementalPrevRanges;
+	const Vec4f* incrementalChangedBounds;
+	const unsigned* incrementalChangedBoundsCount;
+
+	// Ray skipping (see RaytraceNode::setRaySkipping): if rayMissFrameCounts is not null, raygen counts there consecutive
+	// frames in which each ray missed; rays that missed in raySkippingMissFrameCount frames are reported as non-hits
+	// without tracing, except for probes every raySkippingProbePeriod frames (staggered by ray index).
+	uint8_t* rayMissFrameCounts;
+	unsigned raySkippingMissFrameCount;
+	unsigned raySkippingProbePeriod;
+	uint64_t raySkippingFrame;
 
 	// Output
+	uint32_t* denseHitCount; // If not null, only hits are written, each to the next slot counted here (dense output)
+	// If not 0, points are written interleaved (formatted) with this size; the pointers below are to fields of the first point.
+	unsigned formattedPointSize;
 	Field<XYZ_VEC3_F32>::type* xyz;
 	Field<IS_HIT_I32>::type* isHit;
 	Field<RAY_IDX_U32>::type* rayIdx;
@@ -54,6 +142,7 @@ struct RaytraceRequestContext
 	Field<INTENSITY_F32>::type* intensity;
 	Field<TIME_STAMP_F64>::type* timestamp;
 	Field<ENTITY_ID_I32>::type* entityId;
+	Field<CLASS_ID_U16>::type* classId;
 	Field<ABSOLUTE_VELOCITY_VEC3_F32>::type* pointAbsVelocity;
 	Field<RELATIVE_VELOCITY_VEC3_F32>::type* pointRelVelocity;
 	Field<RADIAL_SPEED_F32>::type* radialSpeed;
@@ -61,5 +150,21 @@ struct RaytraceRequestContext
 	Field<ELEVATION_F32>::type* elevation;
 	Field<NORMAL_VEC3_F32>::type* normal;
 	Field<INCIDENT_ANGLE_F32>::type* incidentAngle;
+	Field<RETURN_TYPE_U8>::type* returnType;
+	Field<XYZ_VEC3_F16>::type* xyzHalf;
+	Field<DISTANCE_F16>::type* distanceHalf;
+	Field<NORMAL_VEC3_F16>::type* normalHalf;
+	Field<XYZ_VEC3_I16>::type* xyzQuantized;
 };
 static_assert(std::is_trivially_copyable<RaytraceRequestContext>::value);
+
+// Pipeline launch parameters. Rays of several sensors may be traced in a single launch, where
+// launch indices X and Y are the ray position in the request's layout and launch index Z is the index of the request (sensor).
+struct RaytraceLaunchParams
+{
+	const RaytraceRequestContext* requests;
+	size_t requestCount;
+	// If set (and built with OptiX 8+), raygen traverses first and reorders threads by their hits before shading them.
+	bool useShaderExecutionReordering;
+};
+static_assert(std::is_trivially_copyable<RaytraceLaunchParams>::value);
@@ -6,27 +6,91 @@
 
 /**
  * This struct is a part of HitGroupRecord in SBT (Shader Binding Table).
+ * There is a single record per Mesh, shared by all Entities using it.
  * This data is available in raytracing callbacks.
  */
-struct EntitySBTData
+struct MeshSBTData
 {
+	// Compressed meshes (see Mesh::compress) have vertex or index NULL and use the respective alternative below.
 	const Vec3f* vertex;
 	const Vec3i* index;
 	size_t vertexCount;
 	size_t indexCount;
 
+	const uint16_t* index16;    // Three per triangle
+	const uint16_t* vertexHalf; // Three per vertex, bits of __half
+	const int16_t* vertexSnorm; // Three per vertex, decoded as vertexSnormOffset + vertexSnormScale * (value / 32767)
+	Vec3f vertexSnormOffset;
+	Vec3f vertexSnormScale;
+
+	// Curves (see Mesh::createCurves) have vertex of control points; segment i spans from segmentIndex[i] to the next one.
+	// Spheres have vertex of their centers. Neither has index.
+	const uint32_t* segmentIndex;
+
 	const Vec2f* textureCoords;
 	size_t textureCoordsCount;
-	cudaTextureObject_t texture;
-
-	// Info about the previous frame:
-	Mat3x4f prevFrameLocalToWorld; // Must not be used if !hasPrevFrameLocalToWorld
-	bool hasPrevFrameLocalToWorld; // False, if the previous frame pose is not available
 
 	const Vec3f* vertexDisplacementSincePrevFrame; // May be nullptr;
 };
-static_assert(std::is_trivially_copyable<EntitySBTData>::value);
-static_assert(std::is_trivially_constructible<EntitySBTData>::value);
+static_assert(std::is_trivially_copyable<MeshSBTData>::value);
+static_assert(std::is_trivially_constructible<MeshSBTData>::value);
+
+/**
+ * Per-Entity data, stored in a separate device buffer (outside of SBT) indexed by optixGetInstanceIndex().
+ * This data is available in raytracing callbacks.
+ */
+struct EntityInstanceData
+{
+	uint32_t textureIdx;     // Index in the table of texture objects (see Texture::getDeviceTable), zero if none
+	float textureTexelCount; // Texels of the full-resolution level, used to select the mip level
+	float intensity;         // Constant intensity, used if the texture is not sampled
+	uint16_t classId;        // Semantic class, reported as CLASS_ID_U16
+};
+static_assert(std::is_trivially_copyable<EntityInstanceData>::value);
+static_assert(std::is_trivially_constructible<EntityInstanceData>::value);
+
+/**
+ * Recent local-to-world transforms of an Entity with scene times they were set at, the newest first.
+ * Stored in a separate device buffer indexed by optixGetInstanceIndex() (as EntityInstanceData), uploaded along with
+ * instances, so that pose changes do not rebuild entity data. Used to find Entity's pose at any time, e.g. for velocity.
+ */
+struct EntityTransformHistory
+{
+	static constexpr int CAPACITY = 4;
+
+	Mat3x4f transforms[CAPACITY];
+	double times[CAPACITY]; // Seconds, non-increasing
+	int count;              // At least one; a transform set without scene time is the last one
+
+	/**
+	 * Returns the transform at the given scene time (seconds), interpolated linearly between the nearest entries.
+	 * Out of the history, the nearest entry is returned: in particular, Entity stays in its newest pose until it is set again.
+	 */
+	HostDevFn Mat3x4f getLocalToWorldAt(double time) const
+	{
+		if (time >= times[0]) {
+			return transforms[0];
+		}
+		for (int idx = 1; idx < count; ++idx) {
+			if (time < times[idx]) {
+				continue;
+			}
+			// Entries of equal times are skipped above, so the denominator is not zero.
+			const float factor = static_cast<float>((time - times[idx]) / (times[idx - 1] - times[idx]));
+			Mat3x4f interpolated;
+			for (int row = 0; row < 3; ++row) {
+				for (int col = 0; col < 4; ++col) {
+					const float older = transforms[idx].rc[row][col];
+					interpolated.rc[row][col] = older + (transforms[idx - 1].rc[row][col] - older) * factor;
+				}
+			}
+			return interpolated;
+		}
+		return transforms[count - 1];
+	}
+};
+static_assert(std::is_trivially_copyable<EntityTransformHistory>::value);
+static_assert(std::is_trivially_constructible<EntityTransformHistory>::value);
 
 
 struct __align__(OPTIX_SBT_RECORD_ALIGNMENT) RaygenRecord { char header[OPTIX_SBT_RECORD_HEADER_SIZE]; };
@@ -36,5 +100,5 @@ struct __align__(OPTIX_SBT_RECORD_ALIGNMENT) MissRecord { char header[OPTIX_SBT_
 struct __align__(OPTIX_SBT_RECORD_ALIGNMENT) HitgroupRecord
 {
 	char header[OPTIX_SBT_RECORD_HEADER_SIZE];
-	EntitySBTData data;
+	MeshSBTData data;
 };
@@ -17,25 +17,53 @@
 #include <gpu/kernelUtils.hpp>
 #include <gpu/gaussianNoiseKernels.hpp>
 
+// Philox algorithm chosen based on performance
+// https://stackoverflow.com/questions/18506697/curand-properties-of-generators
+// It is counter-based, so the generator of (seed, frame, element) is initialized in place, without any stored state.
+// Each element has its own subsequence; frames are offsets within it, far enough apart for two normal numbers.
+__device__ __forceinline__ curandStatePhilox4_32_10_t initRandomState(uint64_t seed, uint64_t frame, size_t idx)
+{
+	constexpr uint64_t RANDOM_NUMBERS_PER_FRAME = 4;
+	curandStatePhilox4_32_10_t state;
+	curand_init(seed, idx, frame * RANDOM_NUMBERS_PER_FRAME, &state);
+	return state;
+}
+
+__device__ __forceinline__ float randomNormal(uint64_t seed, uint64_t frame, size_t idx)
+{
+	curandStatePhilox4_32_10_t state = initRandomState(seed, frame, idx);
+	return curand_normal(&state);
+}
+
 __global__ void kAddGaussianNoiseAngularRay(size_t rayCount, float mean, float stDev, rgl_axis_t rotationAxis,
-                                            Mat3x4f lookAtOriginTransform, curandStatePhilox4_32_10_t* randomStates,
+                                            Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
                                             const Mat3x4f* inRays, Mat3x4f* outRays)
 {
 	LIMIT(rayCount);
 
-	float angularError = mean + curand_normal(&randomStates[tid]) * stDev;
+	float angularError = mean + randomNormal(seed, frame, tid) * stDev;
 	outRays[tid] = lookAtOriginTransform.inverse() *
 	               (Mat3x4f::rotationRad(rotationAxis, angularError) * (lookAtOriginTransform * inRays[tid]));
 }
 
+__global__ void kAddGaussianNoiseAngularRayDirections(size_t rayCount, float mean, float stDev, rgl_axis_t rotationAxis,
+                                                      uint64_t seed, uint64_t frame, const Vec3f* inDirections,
+                                                      Vec3f* outDirections)
+{
+	LIMIT(rayCount);
+
+	float angularError = mean + randomNormal(seed, frame, tid) * stDev;
+	outDirections[tid] = Mat3x4f::rotationRad(rotationAxis, angularError) * inDirections[tid]; // No translation
+}
+
 __global__ void kAddGaussianNoiseAngularHitpoint(size_t pointCount, float mean, float stDev, rgl_axis_t rotationAxis,
-                                                 Mat3x4f lookAtOriginTransform, curandStatePhilox4_32_10_t* randomStates,
+                                                 Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
                                                  const Field<XYZ_VEC3_F32>::type* inPoints,
                                                  Field<XYZ_VEC3_F32>::type* outPoints, Field<DISTANCE_F32>::type* outDistances)
 {
 	LIMIT(pointCount);
 
-	float angularError = mean + curand_normal(&randomStates[tid]) * stDev;
+	float angularError = mean + randomNormal(seed, frame, tid) * stDev;
 	Field<XYZ_VEC3_F32>::type originWithNoisePoint = Mat3x4f::rotationRad(rotationAxis, angularError) *
 	                                                 (lookAtOriginTransform * inPoints[tid]);
 
@@ -47,7 +75,7 @@ __global__ void kAddGaussianNoiseAngularHitpoint(size_t pointCount, float mean,
 }
 
 __global__ void kAddGaussianNoiseDistance(size_t pointCount, float mean, float stDevBase, float stDevRisePerMeter,
-                                          Mat3x4f lookAtOriginTransform, curandStatePhilox4_32_10_t* randomStates,
+                                          Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
                                           const Field<XYZ_VEC3_F32>::type* inPoints,
                                           const Field<DISTANCE_F32>::type* inDistances, Field<XYZ_VEC3_F32>::type* outPoints,
                                           Field<DISTANCE_F32>::type* outDistances)
@@ -56,7 +84,7 @@ __global__ void kAddGaussianNoiseDistance(size_t pointCount, float mean, float s
 
 	float distanceInducedStDev = inDistances[tid] * stDevRisePerMeter;
 	float totalStDev = distanceInducedStDev + stDevBase;
-	float distanceError = mean + curand_normal(&randomStates[tid]) * totalStDev;
+	float distanceError = mean + randomNormal(seed, frame, tid) * totalStDev;
 
 	Field<XYZ_VEC3_F32>::type pointInRayOriginTransform = lookAtOriginTransform * inPoints[tid];
 
@@ -65,28 +93,72 @@ __global__ void kAddGaussianNoiseDistance(size_t pointCount, float mean, float s
 	outDistances[tid] = inDistances[tid] + distanceError;
 }
 
+// Angular hitpoint noise, distance noise and transform applied in one pass, as if done by consecutive nodes.
+__global__ void kAddGaussianNoiseTransformPoints(size_t pointCount, GaussianNoisePointsParams noise, Mat3x4f transform,
+                                                 Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
+                                                 const Field<XYZ_VEC3_F32>::type* inPoints,
+                                                 Field<XYZ_VEC3_F32>::type* outPoints, Field<DISTANCE_F32>::type* outDistances)
+{
+	LIMIT(pointCount);
+
+	curandStatePhilox4_32_10_t randomState = initRandomState(seed, frame, tid);
+	const float2 normals = curand_normal2(&randomState);
+
+	float angularError = noise.angularMean + normals.x * noise.angularStDev;
+	Field<XYZ_VEC3_F32>::type pointInRayOriginTransform = Mat3x4f::rotationRad(noise.angularAxis, angularError) *
+	                                                      (lookAtOriginTransform * inPoints[tid]);
+
+	float distance = pointInRayOriginTransform.length();
+	float totalStDev = distance * noise.distanceStDevRisePerMeter + noise.distanceStDevBase;
+	float distanceError = noise.distanceMean + normals.y * totalStDev;
+	pointInRayOriginTransform = pointInRayOriginTransform + pointInRayOriginTransform.normalized() * distanceError;
+
+	if (outDistances != nullptr) {
+		outDistances[tid] = distance + distanceError;
+	}
+
+	outPoints[tid] = transform * (lookAtOriginTransform.inverse() * pointInRayOriginTransform);
+}
+
 void gpuAddGaussianNoiseAngularRay(cudaStream_t stream, size_t rayCount, float mean, float stDev, rgl_axis_t rotationAxis,
-                                   Mat3x4f lookAtOriginTransform, curandStatePhilox4_32_10_t* randomStates,
+                                   Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
                                    const Mat3x4f* inRays, Mat3x4f* outRays)
 {
-	run(kAddGaussianNoiseAngularRay, stream, rayCount, mean, stDev, rotationAxis, lookAtOriginTransform, randomStates, inRays,
+	run(kAddGaussianNoiseAngularRay, stream, rayCount, mean, stDev, rotationAxis, lookAtOriginTransform, seed, frame, inRays,
 	    outRays);
 }
 
+void gpuAddGaussianNoiseAngularRayDirections(cudaStream_t stream, size_t rayCount, float mean, float stDev,
+                                             rgl_axis_t rotationAxis, uint64_t seed, uint64_t frame, const Vec3f* inDirections,
+                                             Vec3f* outDirections)
+{
+	run(kAddGaussianNoiseAngularRayDirections, stream, rayCount, mean, stDev, rotationAxis, seed, frame, inDirections,
+	    outDirections);
+}
+
 void gpuAddGaussianNoiseAngularHitpoint(cudaStream_t stream, size_t pointCount, float mean, float stDev,
                                         rgl_axis_t rotationAxis, Mat3x4f lookAtOriginTransform,
-                                        curandStatePhilox4_32_10_t* randomStates, const Field<XYZ_VEC3_F32>::type* inPoints,
+                                        uint64_t seed, uint64_t frame, const Field<XYZ_VEC3_F32>::type* inPoints,
                                         Field<XYZ_VEC3_F32>::type* outPoints, Field<DISTANCE_F32>::type* outDistances)
 {
-	run(kAddGaussianNoiseAngularHitpoint, stream, pointCount, mean, stDev, rotationAxis, lookAtOriginTransform, randomStates,
+	run(kAddGaussianNoiseAngularHitpoint, stream, pointCount, mean, stDev, rotationAxis, lookAtOriginTransform, seed, frame,
 	    inPoints, outPoints, outDistances);
 }
 
 void gpuAddGaussianNoiseDistance(cudaStream_t stream, size_t pointCount, float mean, float stDevBase, float stDevRisePerMeter,
-                                 Mat3x4f lookAtOriginTransform, curandStatePhilox4_32_10_t* randomStates,
+                                 Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
                                  const Field<XYZ_VEC3_F32>::type* inPoints, const Field<DISTANCE_F32>::type* inDistances,
                                  Field<XYZ_VEC3_F32>::type* outPoints, Field<DISTANCE_F32>::type* outDistances)
 {
-	run(kAddGaussianNoiseDistance, stream, pointCount, mean, stDevBase, stDevRisePerMeter, lookAtOriginTransform, randomStates,
+	run(kAddGaussianNoiseDistance, stream, pointCount, mean, stDevBase, stDevRisePerMeter, lookAtOriginTransform, seed, frame,
 	    inPoints, inDistances, outPoints, outDistances);
-}
\ No newline at end of file
+}
+
+void gpuAddGaussianNoiseTransformPoints(cudaStream_t stream, size_t pointCount, const GaussianNoisePointsParams& noise,
+                                        Mat3x4f transform, Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
+                                        const Field<XYZ_VEC3_F32>::type* inPoints, Field<XYZ_VEC3_F32>::type* outPoints,
+                                        Field<DISTANCE_F32>::type* outDistances)
+{
+	run(kAddGaussianNoiseTransformPoints, stream, pointCount, noise, transform, lookAtOriginTransform, seed, frame, inPoints,
+	    outPoints, outDistances);
+}
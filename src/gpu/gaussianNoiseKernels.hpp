@@ -18,14 +18,34 @@
 #include <math/Mat3x4f.hpp>
 #include <RGLFields.hpp>
 
+// Noise is derived from (seed, frame, element index) only, so consecutive frames must use different frame values.
 void gpuAddGaussianNoiseAngularRay(cudaStream_t stream, size_t rayCount, float mean, float stDev, rgl_axis_t rotationAxis,
-                                   Mat3x4f lookAtOriginTransform, curandStatePhilox4_32_10_t* randomStates,
+                                   Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
                                    const Mat3x4f* inRays, Mat3x4f* outRays);
+void gpuAddGaussianNoiseAngularRayDirections(cudaStream_t stream, size_t rayCount, float mean, float stDev,
+                                             rgl_axis_t rotationAxis, uint64_t seed, uint64_t frame, const Vec3f* inDirections,
+                                             Vec3f* outDirections);
 void gpuAddGaussianNoiseAngularHitpoint(cudaStream_t stream, size_t pointCount, float mean, float stDev,
                                         rgl_axis_t rotationAxis, Mat3x4f lookAtOriginTransform,
-                                        curandStatePhilox4_32_10_t* randomStates, const Field<XYZ_VEC3_F32>::type* inPoints,
+                                        uint64_t seed, uint64_t frame, const Field<XYZ_VEC3_F32>::type* inPoints,
                                         Field<XYZ_VEC3_F32>::type* outPoints, Field<DISTANCE_F32>::type* outDistances);
 void gpuAddGaussianNoiseDistance(cudaStream_t stream, size_t pointCount, float mean, float stDevBase, float stDevRisePerMeter,
-                                 Mat3x4f lookAtOriginTransform, curandStatePhilox4_32_10_t* randomStates,
+                                 Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
                                  const Field<XYZ_VEC3_F32>::type* inPoints, const Field<DISTANCE_F32>::type* inDistances,
                                  Field<XYZ_VEC3_F32>::type* outPoints, Field<DISTANCE_F32>::type* outDistances);
+
+struct GaussianNoisePointsParams
+{
+	float angularMean;
+	float angularStDev;
+	rgl_axis_t angularAxis;
+	float distanceMean;
+	float distanceStDevBase;
+	float distanceStDevRisePerMeter;
+};
+
+// Applies angular hitpoint noise, distance noise and then the transform, reading and writing points once.
+void gpuAddGaussianNoiseTransformPoints(cudaStream_t stream, size_t pointCount, const GaussianNoisePointsParams& noise,
+                                        Mat3x4f transform, Mat3x4f lookAtOriginTransform, uint64_t seed, uint64_t frame,
+                                        const Field<XYZ_VEC3_F32>::type* inPoints, Field<XYZ_VEC3_F32>::type* outPoints,
+                                        Field<DISTANCE_F32>::type* outDistances);
@@ -12,25 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include <cuda.h>
-#include <curand_kernel.h>
 #include <gpu/kernelUtils.hpp>
 #include <gpu/helpersKernels.hpp>
 
-// Philox algorithm chosen based on performance
-// https://stackoverflow.com/questions/18506697/curand-properties-of-generators
-__global__ void kSetupRandomNumberGenerator(size_t pointCount, unsigned int seed, curandStatePhilox4_32_10_t* states)
-{
-	LIMIT(pointCount);
-	/* Each thread gets same seed, a different sequence number, no offset */
-	curand_init(seed, tid, 0, &states[tid]);
-}
-
-void gpuSetupRandomNumberGenerator(cudaStream_t stream, size_t elementsCount, unsigned int seed,
-                                   curandStatePhilox4_32_10_t* outPHILOXStates)
-{
-	run(kSetupRandomNumberGenerator, stream, elementsCount, seed, outPHILOXStates);
-}
 // Updates vertices and calculates their displacement.
 // Input: newVertices and oldVertices
 // Output: verticesDisplacement and newVertices
@@ -47,3 +34,212 @@ void gpuUpdateVertices(cudaStream_t stream, size_t vertexCount, Vec3f* newVertic
 {
 	run(kUpdateVertices, stream, vertexCount, newVerticesToDisplacement, oldToNewVertices);
 }
+
+__global__ void kSkinVertices(size_t vertexCount, const Vec3f* bindPoseVertices, const Vec4i* boneIndices,
+                              const Vec4f* boneWeights, const Mat3x4f* bones, Vec3f* displacement, Vec3f* vertices)
+{
+	LIMIT(vertexCount);
+	Vec3f bindPoseVertex = bindPoseVertices[tid];
+	Vec3f skinnedVertex{0.0f};
+	for (int i = 0; i < 4; ++i) {
+		float weight = boneWeights[tid][i];
+		if (weight != 0.0f) {
+			skinnedVertex += bones[boneIndices[tid][i]] * bindPoseVertex * Vec3f{weight};
+		}
+	}
+	displacement[tid] = skinnedVertex - vertices[tid];
+	vertices[tid] = skinnedVertex;
+}
+
+void gpuSkinVertices(cudaStream_t stream, size_t vertexCount, const Vec3f* bindPoseVertices, const Vec4i* boneIndices,
+                     const Vec4f* boneWeights, const Mat3x4f* bones, Vec3f* displacement, Vec3f* vertices)
+{
+	run(kSkinVertices, stream, vertexCount, bindPoseVertices, boneIndices, boneWeights, bones, displacement, vertices);
+}
+
+__global__ void kUpdateDeviceTransforms(size_t count, const Vec2i* slots, const Mat3x4f* transforms, Mat3x4f* slotTransforms,
+                                        Mat3x4f* slotFormerTransforms)
+{
+	LIMIT(count);
+	int slotIdx = slots[tid].x();
+	bool isNew = slots[tid].y() != 0;
+	slotFormerTransforms[slotIdx] = isNew ? transforms[tid] : slotTransforms[slotIdx];
+	slotTransforms[slotIdx] = transforms[tid];
+}
+
+__global__ void kScatterInstanceTransforms(size_t count, const Vec2i* targets, const Mat3x4f* slotTransforms,
+                                           OptixInstance* instances)
+{
+	LIMIT(count);
+	const Mat3x4f& transform = slotTransforms[targets[tid].y()];
+	memcpy(instances[targets[tid].x()].transform, transform.rc, sizeof(transform.rc));
+}
+
+__global__ void kScatterTransformHistories(size_t count, const Vec2i* targets, const Mat3x4f* slotTransforms,
+                                           const Mat3x4f* slotFormerTransforms, EntityTransformHistory* histories)
+{
+	LIMIT(count);
+	EntityTransformHistory& history = histories[targets[tid].x()];
+	history.transforms[0] = slotTransforms[targets[tid].y()];
+	if (history.count > 1) {
+		history.transforms[1] = slotFormerTransforms[targets[tid].y()];
+	}
+}
+
+__global__ void kCullInstances(size_t count, const OptixInstance* instances, const Vec4f* instanceBounds,
+                               Vec4f cullingSphere, OptixInstance* culledInstances)
+{
+	LIMIT(count);
+	OptixInstance instance = instances[tid];
+	Vec4f bounds = instanceBounds[tid];
+	Vec3f offset = {bounds[0] - cullingSphere[0], bounds[1] - cullingSphere[1], bounds[2] - cullingSphere[2]};
+	float reach = bounds[3] + cullingSphere[3];
+	if (offset.lengthSquared() > reach * reach) {
+		instance.visibilityMask = 0;
+	}
+	culledInstances[tid] = instance;
+}
+
+__global__ void kExtrapolateInstances(size_t count, const OptixInstance* instances,
+                                      const EntityTransformHistory* transformHistories, double prevFrameTime,
+                                      const float* rayTimeOffsets, const uint32_t* rayIdx, float frameTimeMs,
+                                      OptixInstance* outInstances)
+{
+	LIMIT(count);
+	OptixInstance instance = instances[tid];
+	// Instances that did not move since the previous frame stay in place, their previous pose is the current one.
+	const Mat3x4f prevFrameLocalToWorld = transformHistories[tid].getLocalToWorldAt(prevFrameTime);
+	// Matrices are extrapolated linearly, same as motion transforms (see Scene::makeMotionTransform).
+	const float factor = rayTimeOffsets[*rayIdx] / frameTimeMs;
+	for (int row = 0; row < 3; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			const float current = instance.transform[row * 4 + col];
+			const float prev = prevFrameLocalToWorld.rc[row][col];
+			instance.transform[row * 4 + col] = current + (current - prev) * factor;
+		}
+	}
+	outInstances[tid] = instance;
+}
+
+__global__ void kMakeRays(size_t count, const Vec3f* origins, const Vec3f* directions, Mat3x4f* outRays)
+{
+	LIMIT(count);
+	const Vec3f dir = directions[tid].normalized();
+	// Same rotation as of rays given by directions in raygen, see getRayFromDirection().
+	outRays[tid] = Mat3x4f::translation(origins[tid]) * Mat3x4f::rotationRad(-asinf(dir.y()), atan2f(dir.x(), dir.z()), 0.0f);
+}
+
+__device__ bool isInstanceEqual(const OptixInstance& lhs, const OptixInstance& rhs)
+{
+	for (int i = 0; i < 12; ++i) {
+		if (lhs.transform[i] != rhs.transform[i]) {
+			return false;
+		}
+	}
+	return lhs.instanceId == rhs.instanceId && lhs.sbtOffset == rhs.sbtOffset && lhs.visibilityMask == rhs.visibilityMask &&
+	       lhs.flags == rhs.flags && lhs.traversableHandle == rhs.traversableHandle;
+}
+
+__device__ bool isEntityInstanceEqual(const EntityInstanceData& lhs, const EntityInstanceData& rhs)
+{
+	return lhs.textureIdx == rhs.textureIdx && lhs.textureTexelCount == rhs.textureTexelCount && lhs.classId == rhs.classId;
+}
+
+// Histories are compared by the previous-frame pose only (used for velocity), since they change whenever a pose is set.
+__device__ bool isPrevFramePoseEqual(const EntityTransformHistory& lhs, double lhsPrevFrameTime,
+                                     const EntityTransformHistory& rhs, double rhsPrevFrameTime)
+{
+	const Mat3x4f lhsPose = lhs.getLocalToWorldAt(lhsPrevFrameTime);
+	const Mat3x4f rhsPose = rhs.getLocalToWorldAt(rhsPrevFrameTime);
+	for (int y = 0; y < 3; ++y) {
+		for (int x = 0; x < 4; ++x) {
+			if (lhsPose.rc[y][x] != rhsPose.rc[y][x]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+__device__ bool isBoundsEqual(const Vec4f& lhs, const Vec4f& rhs)
+{
+	return lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2] && lhs[3] == rhs[3];
+}
+
+__global__ void kFindChangedInstanceBounds(size_t maxCount, size_t prevCount, const OptixInstance* prevInstances,
+                                           const EntityInstanceData* prevEntityInstances,
+                                           const EntityTransformHistory* prevTransformHistories, double prevPrevFrameTime,
+                                           const Vec4f* prevInstanceBounds, size_t count, const OptixInstance* instances,
+                                           const EntityInstanceData* entityInstances,
+                                           const EntityTransformHistory* transformHistories, double prevFrameTime,
+                                           const Vec4f* instanceBounds, Vec4f* changedBounds, unsigned* changedCount)
+{
+	LIMIT(maxCount);
+	bool isInPrev = tid < prevCount;
+	bool isInCurrent = tid < count;
+	if (isInPrev && isInCurrent && isInstanceEqual(prevInstances[tid], instances[tid]) &&
+	    isEntityInstanceEqual(prevEntityInstances[tid], entityInstances[tid]) &&
+	    isPrevFramePoseEqual(prevTransformHistories[tid], prevPrevFrameTime, transformHistories[tid], prevFrameTime) &&
+	    isBoundsEqual(prevInstanceBounds[tid], instanceBounds[tid])) {
+		return;
+	}
+	unsigned outIdx = atomicAdd(changedCount, static_cast<unsigned>(isInPrev) + static_cast<unsigned>(isInCurrent));
+	if (isInPrev) {
+		changedBounds[outIdx++] = prevInstanceBounds[tid];
+	}
+	if (isInCurrent) {
+		changedBounds[outIdx] = instanceBounds[tid];
+	}
+}
+
+void gpuUpdateDeviceTransforms(cudaStream_t stream, size_t count, const Vec2i* slots, const Mat3x4f* transforms,
+                               Mat3x4f* slotTransforms, Mat3x4f* slotFormerTransforms)
+{
+	run(kUpdateDeviceTransforms, stream, count, slots, transforms, slotTransforms, slotFormerTransforms);
+}
+
+void gpuScatterInstanceTransforms(cudaStream_t stream, size_t count, const Vec2i* targets, const Mat3x4f* slotTransforms,
+                                  OptixInstance* instances)
+{
+	run(kScatterInstanceTransforms, stream, count, targets, slotTransforms, instances);
+}
+
+void gpuScatterTransformHistories(cudaStream_t stream, size_t count, const Vec2i* targets, const Mat3x4f* slotTransforms,
+                                  const Mat3x4f* slotFormerTransforms, EntityTransformHistory* histories)
+{
+	run(kScatterTransformHistories, stream, count, targets, slotTransforms, slotFormerTransforms, histories);
+}
+
+void gpuCullInstances(cudaStream_t stream, size_t count, const OptixInstance* instances, const Vec4f* instanceBounds,
+                      Vec4f cullingSphere, OptixInstance* culledInstances)
+{
+	run(kCullInstances, stream, count, instances, instanceBounds, cullingSphere, culledInstances);
+}
+
+void gpuExtrapolateInstances(cudaStream_t stream, size_t count, const OptixInstance* instances,
+                             const EntityTransformHistory* transformHistories, double prevFrameTime,
+                             const float* rayTimeOffsets, const uint32_t* rayIdx, float frameTimeMs,
+                             OptixInstance* outInstances)
+{
+	run(kExtrapolateInstances, stream, count, instances, transformHistories, prevFrameTime, rayTimeOffsets, rayIdx,
+	    frameTimeMs, outInstances);
+}
+
+void gpuMakeRays(cudaStream_t stream, size_t count, const Vec3f* origins, const Vec3f* directions, Mat3x4f* outRays)
+{
+	run(kMakeRays, stream, count, origins, directions, outRays);
+}
+
+void gpuFindChangedInstanceBounds(cudaStream_t stream, size_t prevCount, const OptixInstance* prevInstances,
+                                  const EntityInstanceData* prevEntityInstances,
+                                  const EntityTransformHistory* prevTransformHistories, double prevPrevFrameTime,
+                                  const Vec4f* prevInstanceBounds, size_t count, const OptixInstance* instances,
+                                  const EntityInstanceData* entityInstances, const EntityTransformHistory* transformHistories,
+                                  double prevFrameTime, const Vec4f* instanceBounds, Vec4f* changedBounds,
+                                  unsigned* changedCount)
+{
+	size_t maxCount = std::max(prevCount, count);
+	run(kFindChangedInstanceBounds, stream, maxCount, prevCount, prevInstances, prevEntityInstances, prevTransformHistories,
+	    prevPrevFrameTime, prevInstanceBounds, count, instances, entityInstances, transformHistories, prevFrameTime,
+	    instanceBounds, changedBounds, changedCount);
+}
@@ -14,11 +14,50 @@
 
 #pragma once
 #include <cuda.h>
-#include <curand_kernel.h>
 
 #include <math/Vector.hpp>
-
-void gpuSetupRandomNumberGenerator(cudaStream_t stream, size_t elementsCount, unsigned int seed,
-                                   curandStatePhilox4_32_10_t* outPHILOXStates);
+#include <math/Mat3x4f.hpp>
+#include <gpu/ShaderBindingTableTypes.h>
 
 void gpuUpdateVertices(cudaStream_t stream, size_t vertexCount, Vec3f* newVerticesToDisplacement, Vec3f* oldToNewVertices);
+
+// Linear blend skinning with up to four bones per vertex; displacement is the difference from the previous vertices.
+void gpuSkinVertices(cudaStream_t stream, size_t vertexCount, const Vec3f* bindPoseVertices, const Vec4i* boneIndices,
+                     const Vec4f* boneWeights, const Mat3x4f* bones, Vec3f* displacement, Vec3f* vertices);
+
+// Each slot is given as (slotIdx, isNew); former transform of a new slot is initialized to the current one.
+void gpuUpdateDeviceTransforms(cudaStream_t stream, size_t count, const Vec2i* slots, const Mat3x4f* transforms,
+                               Mat3x4f* slotTransforms, Mat3x4f* slotFormerTransforms);
+
+// Each target is given as (instanceIdx, slotIdx).
+void gpuScatterInstanceTransforms(cudaStream_t stream, size_t count, const Vec2i* targets, const Mat3x4f* slotTransforms,
+                                  OptixInstance* instances);
+// Sets the current and former (if kept in the history) matrices of histories of targets, their times are set on the host.
+void gpuScatterTransformHistories(cudaStream_t stream, size_t count, const Vec2i* targets, const Mat3x4f* slotTransforms,
+                                  const Mat3x4f* slotFormerTransforms, EntityTransformHistory* histories);
+
+// Copies instances, hiding (zero visibility mask) those which bounding spheres (xyz: center, w: radius) miss the given one.
+void gpuCullInstances(cudaStream_t stream, size_t count, const OptixInstance* instances, const Vec4f* instanceBounds,
+                      Vec4f cullingSphere, OptixInstance* culledInstances);
+
+// Copies instances, moving them to the time (in milliseconds since the scene time) of the ray of the given index:
+// their motion since the previous frame (lasting frameTimeMs, pose at prevFrameTime taken from history) is extrapolated.
+void gpuExtrapolateInstances(cudaStream_t stream, size_t count, const OptixInstance* instances,
+                             const EntityTransformHistory* transformHistories, double prevFrameTime,
+                             const float* rayTimeOffsets, const uint32_t* rayIdx, float frameTimeMs,
+                             OptixInstance* outInstances);
+
+// Rays given by origins and (non-zero) directions, oriented as rays traced by RaytraceNode (forward along their Z axis).
+void gpuMakeRays(cudaStream_t stream, size_t count, const Vec3f* origins, const Vec3f* directions, Mat3x4f* outRays);
+
+// Appends to changedBounds (and counts in changedCount, expected to be zeroed) both the former and the current bounding
+// sphere of each instance index, whose instance, entity data or pose at the previous frame time (from transform history)
+// differs between the two versions of the scene.
+// Indices present in one version only are reported with their bounds in that version. Requires 2 * max(counts) bounds.
+void gpuFindChangedInstanceBounds(cudaStream_t stream, size_t prevCount, const OptixInstance* prevInstances,
+                                  const EntityInstanceData* prevEntityInstances,
+                                  const EntityTransformHistory* prevTransformHistories, double prevPrevFrameTime,
+                                  const Vec4f* prevInstanceBounds, size_t count, const OptixInstance* instances,
+                                  const EntityInstanceData* entityInstances, const EntityTransformHistory* transformHistories,
+                                  double prevFrameTime, const Vec4f* instanceBounds, Vec4f* changedBounds,
+                                  unsigned* changedCount);
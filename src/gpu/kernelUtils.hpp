@@ -22,6 +22,16 @@
 		}                                                                                                                      \
 	} while (false)
 
+// Like LIMIT, but count is additionally bounded by the value in device memory (if not null),
+// so that work can be launched for an upper bound of elements, without knowing their exact count on host.
+#define LIMIT_DEVICE_COUNT(count, deviceCount)                                                                                 \
+	LIMIT(count);                                                                                                              \
+	do {                                                                                                                       \
+		if (deviceCount != nullptr && tid >= *deviceCount) {                                                                   \
+			return;                                                                                                            \
+		}                                                                                                                      \
+	} while (false)
+
 template<typename Kernel, typename... KernelArgs>
 void run(Kernel&& kernel, cudaStream_t stream, size_t threads, KernelArgs... kernelArgs)
 {
@@ -17,66 +17,494 @@
 #include <gpu/GPUFieldDesc.hpp>
 #include <macros/cuda.hpp>
 #include <vector>
+#include <algorithm>
+
+#include <cuda_fp16.h>
+#include <cfloat>
+#include <climits>
+#include <type_traits>
 
-#include <thrust/device_ptr.h>
-#include <thrust/scan.h>
 #include <thrust/complex.h>
+#include <curand_kernel.h>
+#include <cub/device/device_select.cuh>
+#include <cub/device/device_radix_sort.cuh>
+#include <cub/device/device_scan.cuh>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
 
-__global__ void kFormatSoaToAos(size_t pointCount, size_t pointSize, size_t fieldCount, const GPUFieldDesc* soaInData,
-                                char* aosOutData)
+template<typename Word>
+__device__ __forceinline__ void copyWords(char* dst, const char* src, size_t wordCount)
 {
-	LIMIT(pointCount);
+	for (size_t i = 0; i < wordCount; ++i) {
+		reinterpret_cast<Word*>(dst)[i] = reinterpret_cast<const Word*>(src)[i];
+	}
+}
+
+// Copies field's value between SoA and AoS using the widest memory accesses allowed by the alignment of both layouts.
+// The alignment is computed from bases, strides and offsets (not from thread's pointers), so it is uniform across the warp.
+__device__ __forceinline__ void copyField(char* dst, const char* src, size_t size, uintptr_t alignment)
+{
+	if (alignment % 16 == 0) {
+		copyWords<uint4>(dst, src, size / 16);
+	}
+	else if (alignment % 8 == 0) {
+		copyWords<uint2>(dst, src, size / 8);
+	}
+	else if (alignment % 4 == 0) {
+		copyWords<uint32_t>(dst, src, size / 4);
+	}
+	else if (alignment % 2 == 0) {
+		copyWords<uint16_t>(dst, src, size / 2);
+	}
+	else {
+		copyWords<uint8_t>(dst, src, size);
+	}
+}
+
+// As copyField, for a size known at compile time (loops are unrolled); zero stands for the runtime size.
+template<size_t FieldSize>
+__device__ __forceinline__ void copyFixedSizeField(char* dst, const char* src, size_t size, uintptr_t alignment)
+{
+	if constexpr (FieldSize == 0) {
+		copyField(dst, src, size, alignment);
+		return;
+	}
+	if constexpr (FieldSize % 16 == 0) {
+		if (alignment % 16 == 0) {
+			copyWords<uint4>(dst, src, FieldSize / 16);
+			return;
+		}
+	}
+	if constexpr (FieldSize % 8 == 0) {
+		if (alignment % 8 == 0) {
+			copyWords<uint2>(dst, src, FieldSize / 8);
+			return;
+		}
+	}
+	if constexpr (FieldSize % 4 == 0) {
+		if (alignment % 4 == 0) {
+			copyWords<uint32_t>(dst, src, FieldSize / 4);
+			return;
+		}
+	}
+	if constexpr (FieldSize % 2 == 0) {
+		if (alignment % 2 == 0) {
+			copyWords<uint16_t>(dst, src, FieldSize / 2);
+			return;
+		}
+	}
+	copyWords<uint8_t>(dst, src, FieldSize);
+}
+
+__device__ __forceinline__ uintptr_t getFieldAlignment(const char* aosData, size_t pointSize, const GPUFieldDesc& field,
+                                                      const char* soaData)
+{
+	return reinterpret_cast<uintptr_t>(aosData) | pointSize | field.dstOffset | reinterpret_cast<uintptr_t>(soaData) |
+	       field.size;
+}
+
+__global__ void kFormatSoaToAos(size_t pointCount, const uint32_t* devicePointCount, size_t pointSize, size_t fieldCount,
+                                GPUFieldDescs soaInData, char* aosOutData, int transformedFieldIdx, Mat3x4f xyzTransform)
+{
+	LIMIT_DEVICE_COUNT(pointCount, devicePointCount);
+	for (size_t i = 0; i < fieldCount; ++i) {
+		const GPUFieldDesc field = soaInData[i];
+		const char* src = field.readDataPtr + field.size * tid;
+		Field<XYZ_VEC3_F32>::type transformed;
+		if (static_cast<int>(i) == transformedFieldIdx) {
+			// Local value is aligned as the SoA array of XYZ is, so the alignment below holds for it as well.
+			transformed = xyzTransform * *reinterpret_cast<const Field<XYZ_VEC3_F32>::type*>(src);
+			src = reinterpret_cast<const char*>(&transformed);
+		}
+		uintptr_t alignment = getFieldAlignment(aosOutData, pointSize, field, field.readDataPtr);
+		copyField(aosOutData + pointSize * tid + field.dstOffset, src, field.size, alignment);
+	}
+}
+
+__global__ void kFormatSoaToAosGathered(size_t pointCount, const uint32_t* devicePointCount, size_t pointSize,
+                                        size_t fieldCount, GPUFieldDescs soaInData, const Field<RAY_IDX_U32>::type* indices,
+                                        char* aosOutData)
+{
+	LIMIT_DEVICE_COUNT(pointCount, devicePointCount);
+	size_t rIdx = indices[tid];
 	for (size_t i = 0; i < fieldCount; ++i) {
-		memcpy(aosOutData + pointSize * tid + soaInData[i].dstOffset, soaInData[i].readDataPtr + soaInData[i].size * tid,
-		       soaInData[i].size);
+		const GPUFieldDesc field = soaInData[i];
+		uintptr_t alignment = getFieldAlignment(aosOutData, pointSize, field, field.readDataPtr);
+		copyField(aosOutData + pointSize * tid + field.dstOffset, field.readDataPtr + field.size * rIdx, field.size, alignment);
 	}
 }
 
 __global__ void kFormatAosToSoa(size_t pointCount, size_t pointSize, size_t fieldCount, const char* aosInData,
-                                const GPUFieldDesc* soaOutData)
+                                GPUFieldDescs soaOutData)
 {
 	LIMIT(pointCount);
 	for (size_t i = 0; i < fieldCount; ++i) {
-		memcpy(soaOutData[i].writeDataPtr + soaOutData[i].size * tid, aosInData + pointSize * tid + soaOutData[i].dstOffset,
-		       soaOutData[i].size);
+		const GPUFieldDesc field = soaOutData[i];
+		uintptr_t alignment = getFieldAlignment(aosInData, pointSize, field, field.writeDataPtr);
+		copyField(field.writeDataPtr + field.size * tid, aosInData + pointSize * tid + field.dstOffset, field.size, alignment);
 	}
 }
 
+__global__ void kMakeLineSegments(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, const Vec3f* vectors,
+                                  double* outSegmentPoints)
+{
+	LIMIT(pointCount);
+	double* segment = outSegmentPoints + tid * 6;
+	for (int i = 0; i < 3; ++i) {
+		segment[i] = points[tid][i];
+		segment[i + 3] = static_cast<double>(points[tid][i]) + static_cast<double>(vectors[tid][i]);
+	}
+}
+
+__global__ void kColorizeByHeight(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, float heightPeriod,
+                                  uint32_t* outColors)
+{
+	LIMIT(pointCount);
+	float cycles = points[tid].z() / heightPeriod;
+	int value = static_cast<int>((cycles - floorf(cycles)) * 255.0f);
+	uint32_t r = value > 128 ? (value - 128) * 2 : 0;
+	uint32_t g = value < 128 ? 2 * value : 255 - ((value - 128) * 2);
+	uint32_t b = value < 128 ? 255 - (2 * value) : 0;
+	outColors[tid] = r | g << 8 | b << 16 | 0xFFu << 24; // Bytes in memory: R, G, B, A
+}
+
 __global__ void kTransformRays(size_t rayCount, const Mat3x4f* inRays, Mat3x4f* outRays, Mat3x4f transform)
 {
 	LIMIT(rayCount);
 	outRays[tid] = transform * inRays[tid];
 }
 
-__global__ void kTransformPoints(size_t pointCount, const Field<XYZ_VEC3_F32>::type* inPoints,
-                                 Field<XYZ_VEC3_F32>::type* outPoints, Mat3x4f transform)
+__global__ void kGenerateRaysFromPattern(size_t rayCount, size_t azimuthStepCount, const float* ringElevations,
+                                         const float* ringTimeOffsets, float azimuthStart, float azimuthStep,
+                                         float azimuthStepTime, Mat3x4f* outRays, int* outRingIds, float* outTimeOffsets)
+{
+	LIMIT(rayCount);
+	const size_t ringIdx = tid / azimuthStepCount;
+	const size_t azimuthIdx = tid % azimuthStepCount;
+	const float azimuth = azimuthStart + azimuthStep * static_cast<float>(azimuthIdx);
+	// Pitch by elevation (positive up), then yaw by azimuth around Y axis; rays point along Z axis.
+	outRays[tid] = Mat3x4f::rotationRad(-ringElevations[ringIdx], azimuth, 0.0f);
+	outRingIds[tid] = static_cast<int>(ringIdx);
+	outTimeOffsets[tid] = azimuthStepTime * static_cast<float>(azimuthIdx) + ringTimeOffsets[ringIdx];
+}
+
+__global__ void kMergePoints(size_t pointCount, size_t inputCount, size_t fieldCount, const GPUMergeDesc* descs)
 {
 	LIMIT(pointCount);
-	outPoints[tid] = transform * inPoints[tid];
+	// Descriptors are grouped by field, each group has descriptors of all inputs in the same order.
+	size_t inputIdx = 0;
+	while (tid >= descs[inputIdx].pointOffset + descs[inputIdx].pointCount) {
+		++inputIdx;
+	}
+	size_t localIdx = tid - descs[inputIdx].pointOffset;
+	for (size_t fieldIdx = 0; fieldIdx < fieldCount; ++fieldIdx) {
+		const GPUMergeDesc desc = descs[fieldIdx * inputCount + inputIdx];
+		memcpy(desc.dst + desc.fieldSize * localIdx, desc.src + desc.fieldSize * localIdx, desc.fieldSize);
+	}
+}
+
+// Packs coordinates of a 3D grid cell into 21 bits each (wrapping around very distant cells).
+// Packed keys never reach UINT64_MAX, so it may be used as a key of points outside of the grid.
+__device__ __forceinline__ uint64_t packGridCellKey(int64_t x, int64_t y, int64_t z)
+{
+	constexpr int64_t COORD_BIAS = 1 << 20;
+	constexpr uint64_t COORD_MASK = (1 << 21) - 1;
+	return (static_cast<uint64_t>(x + COORD_BIAS) & COORD_MASK) | ((static_cast<uint64_t>(y + COORD_BIAS) & COORD_MASK) << 21) |
+	       ((static_cast<uint64_t>(z + COORD_BIAS) & COORD_MASK) << 42);
+}
+
+__device__ __forceinline__ int64_t getGridCellCoord(float value, float cellSize)
+{
+	return static_cast<int64_t>(floorf(value / cellSize));
+}
+
+// Index of the first key not less than the given one.
+__device__ __forceinline__ size_t lowerBound(const uint64_t* sortedKeys, size_t count, uint64_t key)
+{
+	size_t begin = 0;
+	size_t end = count;
+	while (begin < end) {
+		const size_t mid = begin + (end - begin) / 2;
+		if (sortedKeys[mid] < key) {
+			begin = mid + 1;
+		}
+		else {
+			end = mid;
+		}
+	}
+	return begin;
+}
+
+__global__ void kComputeVoxelKeys(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, Vec3f leafDims,
+                                  const Field<RAY_IDX_U32>::type* inputIndices, uint64_t* outKeys,
+                                  Field<RAY_IDX_U32>::type* outIndices)
+{
+	LIMIT(pointCount);
+	// Non-finite points share a key.
+	const Vec3f point = points[tid];
+	uint64_t key = UINT64_MAX;
+	if (isfinite(point[0]) && isfinite(point[1]) && isfinite(point[2])) {
+		key = packGridCellKey(getGridCellCoord(point[0], leafDims[0]), getGridCellCoord(point[1], leafDims[1]),
+		                      getGridCellCoord(point[2], leafDims[2]));
+	}
+	outKeys[tid] = key;
+	outIndices[tid] = inputIndices != nullptr ? inputIndices[tid] : tid;
 }
 
-__global__ void kApplyCompaction(size_t pointCount, size_t fieldSize, const int32_t* shouldWrite,
-                                 const CompactionIndexType* writeIndex, char* dst, const char* src)
+__global__ void kMarkFirstInVoxel(size_t pointCount, const uint64_t* sortedKeys, int32_t* outIsFirst)
 {
 	LIMIT(pointCount);
-	int32_t rIdx = tid;
-	if (!shouldWrite[rIdx]) {
+	outIsFirst[tid] = tid == 0 || sortedKeys[tid] != sortedKeys[tid - 1];
+}
+
+// Moments of offsets of neighbours from the query point (accumulating them relative to the point keeps float precision).
+struct NeighbourhoodMoments
+{
+	int32_t count{0};
+	Vec3f sum{0.0f};
+	float xx{0.0f}, xy{0.0f}, xz{0.0f}, yy{0.0f}, yz{0.0f}, zz{0.0f};
+
+	__device__ void add(const Vec3f& offset)
+	{
+		count += 1;
+		sum += offset;
+		xx += offset.x() * offset.x();
+		xy += offset.x() * offset.y();
+		xz += offset.x() * offset.z();
+		yy += offset.y() * offset.y();
+		yz += offset.y() * offset.z();
+		zz += offset.z() * offset.z();
+	}
+};
+
+// Normal is the eigenvector of the smallest eigenvalue of neighbourhood's covariance (closed-form for symmetric 3x3),
+// curvature is the ratio of this eigenvalue to the sum of all eigenvalues (surface variation, as in PCL).
+__device__ void writeNormalAndCurvature(const NeighbourhoodMoments& moments, const Vec3f& point, const Vec3f& viewpoint,
+                                        Field<NORMAL_VEC3_F32>::type* outNormal, Field<CURVATURE_F32>::type* outCurvature)
+{
+	constexpr int32_t MIN_NEIGHBOUR_COUNT = 3; // Including the point itself
+	if (moments.count < MIN_NEIGHBOUR_COUNT) {
+		*outNormal = Vec3f{NAN};
+		*outCurvature = NAN;
 		return;
 	}
-	int wIdx = writeIndex[rIdx] - 1;
-	memcpy(dst + fieldSize * wIdx, src + fieldSize * rIdx, fieldSize);
+	const float n = static_cast<float>(moments.count);
+	const Vec3f mean = moments.sum / Vec3f{n};
+	const float a00 = moments.xx / n - mean.x() * mean.x();
+	const float a01 = moments.xy / n - mean.x() * mean.y();
+	const float a02 = moments.xz / n - mean.x() * mean.z();
+	const float a11 = moments.yy / n - mean.y() * mean.y();
+	const float a12 = moments.yz / n - mean.y() * mean.z();
+	const float a22 = moments.zz / n - mean.z() * mean.z();
+
+	const float trace = a00 + a11 + a22;
+	const float offDiagonal = a01 * a01 + a02 * a02 + a12 * a12;
+	float smallest = fminf(a00, fminf(a11, a22));
+	if (offDiagonal > 0.0f) {
+		const float q = trace / 3.0f;
+		const float p = sqrtf(((a00 - q) * (a00 - q) + (a11 - q) * (a11 - q) + (a22 - q) * (a22 - q) + 2.0f * offDiagonal) /
+		                      6.0f);
+		const float b00 = (a00 - q) / p, b11 = (a11 - q) / p, b22 = (a22 - q) / p;
+		const float b01 = a01 / p, b02 = a02 / p, b12 = a12 / p;
+		const float halfDet = (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) + b02 * (b01 * b12 - b11 * b02)) /
+		                      2.0f;
+		const float phi = acosf(fminf(fmaxf(halfDet, -1.0f), 1.0f)) / 3.0f;
+		smallest = q + 2.0f * p * cosf(phi + 2.0f * static_cast<float>(M_PI) / 3.0f);
+	}
+
+	// The eigenvector is orthogonal to rows of (A - smallest * I); the longest of their cross products is the most accurate.
+	const Vec3f row0{a00 - smallest, a01, a02};
+	const Vec3f row1{a01, a11 - smallest, a12};
+	const Vec3f row2{a02, a12, a22 - smallest};
+	Vec3f normal = row0.cross(row1);
+	const Vec3f cross02 = row0.cross(row2);
+	const Vec3f cross12 = row1.cross(row2);
+	normal = cross02.lengthSquared() > normal.lengthSquared() ? cross02 : normal;
+	normal = cross12.lengthSquared() > normal.lengthSquared() ? cross12 : normal;
+	if (normal.lengthSquared() > 0.0f) {
+		normal = normal.normalized();
+		normal = normal.dot(viewpoint - point) < 0.0f ? -normal : normal;
+	}
+	else {
+		normal = Vec3f{NAN}; // Neighbours are collinear (or coincide)
+	}
+	*outNormal = normal;
+	*outCurvature = trace > 0.0f ? fmaxf(smallest, 0.0f) / trace : 0.0f;
+}
+
+__global__ void kEstimateNormalsOrganized(size_t pointCount, size_t width, size_t height, int32_t windowRadius, float radius,
+                                          const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit,
+                                          Vec3f viewpoint, Field<NORMAL_VEC3_F32>::type* outNormals,
+                                          Field<CURVATURE_F32>::type* outCurvatures)
+{
+	LIMIT(pointCount);
+	NeighbourhoodMoments moments;
+	const Vec3f point = points[tid];
+	if (isHit == nullptr || isHit[tid]) {
+		const auto rowCount = static_cast<int64_t>(height);
+		const auto columnCount = static_cast<int64_t>(width);
+		const int64_t row = tid / columnCount;
+		const int64_t column = tid % columnCount;
+		const int64_t rowEnd = row + windowRadius < rowCount ? row + windowRadius + 1 : rowCount;
+		const int64_t columnEnd = column + windowRadius < columnCount ? column + windowRadius + 1 : columnCount;
+		for (int64_t y = row > windowRadius ? row - windowRadius : 0; y < rowEnd; ++y) {
+			for (int64_t x = column > windowRadius ? column - windowRadius : 0; x < columnEnd; ++x) {
+				const int64_t other = y * columnCount + x;
+				const Vec3f offset = points[other] - point;
+				if ((isHit == nullptr || isHit[other]) && offset.lengthSquared() <= radius * radius) {
+					moments.add(offset);
+				}
+			}
+		}
+	}
+	writeNormalAndCurvature(moments, point, viewpoint, &outNormals[tid], &outCurvatures[tid]);
+}
+
+__global__ void kEstimateNormalsHashed(size_t pointCount, float radius, const Field<XYZ_VEC3_F32>::type* points,
+                                       const Field<IS_HIT_I32>::type* isHit, const uint64_t* sortedCellKeys,
+                                       const Field<RAY_IDX_U32>::type* sortedIndices, Vec3f viewpoint,
+                                       Field<NORMAL_VEC3_F32>::type* outNormals, Field<CURVATURE_F32>::type* outCurvatures)
+{
+	LIMIT(pointCount);
+	NeighbourhoodMoments moments;
+	const Vec3f point = points[tid];
+	const bool isFinite = isfinite(point[0]) && isfinite(point[1]) && isfinite(point[2]);
+	if (isFinite && (isHit == nullptr || isHit[tid])) {
+		const int64_t cellX = getGridCellCoord(point[0], radius);
+		const int64_t cellY = getGridCellCoord(point[1], radius);
+		const int64_t cellZ = getGridCellCoord(point[2], radius);
+		for (int64_t dx = -1; dx <= 1; ++dx) {
+			for (int64_t dy = -1; dy <= 1; ++dy) {
+				for (int64_t dz = -1; dz <= 1; ++dz) {
+					const uint64_t key = packGridCellKey(cellX + dx, cellY + dy, cellZ + dz);
+					for (size_t i = lowerBound(sortedCellKeys, pointCount, key); i < pointCount && sortedCellKeys[i] == key;
+					     ++i) {
+						const uint32_t other = sortedIndices[i];
+						const Vec3f offset = points[other] - point;
+						// Wrapped cells may hold distant points.
+						if ((isHit == nullptr || isHit[other]) && offset.lengthSquared() <= radius * radius) {
+							moments.add(offset);
+						}
+					}
+				}
+			}
+		}
+	}
+	writeNormalAndCurvature(moments, point, viewpoint, &outNormals[tid], &outCurvatures[tid]);
+}
+
+// Spatial index queries: grid cells overlapping the bounding box of the search sphere are scanned.
+__global__ void kQueryNearestPoints(size_t queryCount, const Vec3f* queries, float cellSize, float maxDistance,
+                                    size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                                    const Field<IS_HIT_I32>::type* isHit, const uint64_t* sortedCellKeys,
+                                    const Field<RAY_IDX_U32>::type* sortedIndices, int32_t* outIndices, float* outDistances)
+{
+	LIMIT(queryCount);
+	const Vec3f query = queries[tid];
+	int32_t nearestIdx = -1;
+	float nearestDistanceSquared = maxDistance * maxDistance;
+	if (isfinite(query[0]) && isfinite(query[1]) && isfinite(query[2])) {
+		for (int64_t x = getGridCellCoord(query[0] - maxDistance, cellSize);
+		     x <= getGridCellCoord(query[0] + maxDistance, cellSize); ++x) {
+			for (int64_t y = getGridCellCoord(query[1] - maxDistance, cellSize);
+			     y <= getGridCellCoord(query[1] + maxDistance, cellSize); ++y) {
+				for (int64_t z = getGridCellCoord(query[2] - maxDistance, cellSize);
+				     z <= getGridCellCoord(query[2] + maxDistance, cellSize); ++z) {
+					const uint64_t key = packGridCellKey(x, y, z);
+					for (size_t i = lowerBound(sortedCellKeys, pointCount, key); i < pointCount && sortedCellKeys[i] == key;
+					     ++i) {
+						const int32_t other = static_cast<int32_t>(sortedIndices[i]);
+						if (isHit != nullptr && !isHit[other]) {
+							continue;
+						}
+						// Ties are resolved by the lower index, so that results do not depend on the scan order.
+						const float distanceSquared = (points[other] - query).lengthSquared();
+						if (distanceSquared < nearestDistanceSquared ||
+						    (distanceSquared == nearestDistanceSquared && (nearestIdx < 0 || other < nearestIdx))) {
+							nearestDistanceSquared = distanceSquared;
+							nearestIdx = other;
+						}
+					}
+				}
+			}
+		}
+	}
+	outIndices[tid] = nearestIdx;
+	outDistances[tid] = nearestIdx < 0 ? INFINITY : sqrtf(nearestDistanceSquared);
+}
+
+__global__ void kQueryRadiusPoints(size_t queryCount, const Vec3f* queries, float cellSize, float radius,
+                                   int32_t maxNeighbourCount, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                                   const Field<IS_HIT_I32>::type* isHit, const uint64_t* sortedCellKeys,
+                                   const Field<RAY_IDX_U32>::type* sortedIndices, int32_t* outIndices, int32_t* outCounts)
+{
+	LIMIT(queryCount);
+	const Vec3f query = queries[tid];
+	int32_t* neighbours = outIndices + tid * maxNeighbourCount;
+	int32_t count = 0;
+	if (isfinite(query[0]) && isfinite(query[1]) && isfinite(query[2])) {
+		for (int64_t x = getGridCellCoord(query[0] - radius, cellSize);
+		     x <= getGridCellCoord(query[0] + radius, cellSize) && count < maxNeighbourCount; ++x) {
+			for (int64_t y = getGridCellCoord(query[1] - radius, cellSize);
+			     y <= getGridCellCoord(query[1] + radius, cellSize) && count < maxNeighbourCount; ++y) {
+				for (int64_t z = getGridCellCoord(query[2] - radius, cellSize);
+				     z <= getGridCellCoord(query[2] + radius, cellSize) && count < maxNeighbourCount; ++z) {
+					const uint64_t key = packGridCellKey(x, y, z);
+					for (size_t i = lowerBound(sortedCellKeys, pointCount, key);
+					     i < pointCount && sortedCellKeys[i] == key && count < maxNeighbourCount; ++i) {
+						const uint32_t other = sortedIndices[i];
+						if ((isHit == nullptr || isHit[other]) && (points[other] - query).lengthSquared() <= radius * radius) {
+							neighbours[count++] = static_cast<int32_t>(other);
+						}
+					}
+				}
+			}
+		}
+	}
+	outCounts[tid] = count;
+	for (int32_t i = count; i < maxNeighbourCount; ++i) {
+		neighbours[i] = -1;
+	}
+}
+
+__global__ void kTransformPoints(size_t pointCount, const uint32_t* devicePointCount, const Field<XYZ_VEC3_F32>::type* inPoints,
+                                 Field<XYZ_VEC3_F32>::type* outPoints, Mat3x4f transform)
+{
+	LIMIT_DEVICE_COUNT(pointCount, devicePointCount);
+	outPoints[tid] = transform * inPoints[tid];
 }
 
+template<size_t FieldSize>
 __global__ void kCutField(size_t pointCount, char* dst, const char* src, size_t offset, size_t stride, size_t fieldSize)
 {
 	LIMIT(pointCount);
-	memcpy(dst + tid * fieldSize, src + tid * stride + offset, fieldSize);
+	uintptr_t alignment = reinterpret_cast<uintptr_t>(dst) | reinterpret_cast<uintptr_t>(src) | offset | stride | fieldSize;
+	copyFixedSizeField<FieldSize>(dst + tid * fieldSize, src + tid * stride + offset, fieldSize, alignment);
 }
 
-__global__ void kFilter(size_t count, const Field<RAY_IDX_U32>::type* indices, char* dst, char* src, size_t fieldSize)
+template<size_t FieldSize>
+__global__ void kFilter(size_t count, const uint32_t* deviceCount, const Field<RAY_IDX_U32>::type* indices, char* dst,
+                        const char* src, size_t fieldSize)
 {
-	LIMIT(count);
-	memcpy(dst + tid * fieldSize, src + indices[tid] * fieldSize, fieldSize);
+	LIMIT_DEVICE_COUNT(count, deviceCount);
+	uintptr_t alignment = reinterpret_cast<uintptr_t>(dst) | reinterpret_cast<uintptr_t>(src) | fieldSize;
+	copyFixedSizeField<FieldSize>(dst + tid * fieldSize, src + indices[tid] * fieldSize, fieldSize, alignment);
+}
+
+// Calls launch with std::integral_constant of the field size, if it is a size of RGL fields, or of zero otherwise.
+template<typename Launch>
+static void dispatchFieldSize(size_t fieldSize, Launch&& launch)
+{
+	switch (fieldSize) {
+		case 1: launch(std::integral_constant<size_t, 1>{}); break;
+		case 2: launch(std::integral_constant<size_t, 2>{}); break;
+		case 4: launch(std::integral_constant<size_t, 4>{}); break;
+		case 8: launch(std::integral_constant<size_t, 8>{}); break;
+		case 12: launch(std::integral_constant<size_t, 12>{}); break;
+		case 16: launch(std::integral_constant<size_t, 16>{}); break;
+		case 48: launch(std::integral_constant<size_t, 48>{}); break;
+		default: launch(std::integral_constant<size_t, 0>{}); break;
+	}
 }
 
 __device__ Vec3f reflectPolarization(const Vec3f& pol, const Vec3f& hitNormal, const Vec3f& rayDir)
@@ -211,6 +639,316 @@ __global__ void kRadarComputeEnergy(size_t count, float rayAzimuthStepRad, float
 	outBUBRFactor[tid] = {BU, BR, factor};
 }
 
+// Radar clustering: points are connected if their distance, azimuth and radial speed differences are all within thresholds
+// of the scope of the farther point. Clusters are connected components, found with union-find over grids of cells.
+// Every scope has its own grid, with cells of its thresholds, so that only points in neighbouring cells are tested.
+
+// Roots are always the lowest point index of their component, so linking is monotonic and safe to do concurrently.
+__device__ __forceinline__ uint32_t findClusterRoot(const uint32_t* parents, uint32_t idx)
+{
+	uint32_t parent = parents[idx];
+	while (parent != idx) {
+		idx = parent;
+		parent = parents[idx];
+	}
+	return idx;
+}
+
+__device__ __forceinline__ void uniteClusters(uint32_t* parents, uint32_t a, uint32_t b)
+{
+	while (true) {
+		a = findClusterRoot(parents, a);
+		b = findClusterRoot(parents, b);
+		if (a == b) {
+			return;
+		}
+		const uint32_t higher = max(a, b);
+		const uint32_t lower = min(a, b);
+		if (atomicCAS(&parents[higher], higher, lower) == higher) {
+			return;
+		}
+	}
+}
+
+// Cells are packed into 18 bits per coordinate (wrapping around), the scope index occupies the upper bits.
+__device__ __forceinline__ uint64_t packRadarCellKey(int32_t scopeIdx, int64_t x, int64_t y, int64_t z)
+{
+	constexpr int64_t COORD_BIAS = 1 << 17;
+	constexpr uint64_t COORD_MASK = (1 << 18) - 1;
+	return (static_cast<uint64_t>(scopeIdx) << 54) | (static_cast<uint64_t>(x + COORD_BIAS) & COORD_MASK) |
+	       ((static_cast<uint64_t>(y + COORD_BIAS) & COORD_MASK) << 18) |
+	       ((static_cast<uint64_t>(z + COORD_BIAS) & COORD_MASK) << 36);
+}
+
+// Zero threshold connects only equal values, which share any cell.
+__device__ __forceinline__ float getRadarCellSize(float threshold) { return threshold > 0.0f ? threshold : 1.0f; }
+
+__global__ void kRadarInitClusters(size_t pointCount, const Field<DISTANCE_F32>::type* distance,
+                                   const Field<AZIMUTH_F32>::type* azimuth, const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                                   size_t scopeCount, const rgl_radar_scope_t* scopes, int32_t* outScopeIndices,
+                                   uint32_t* outParents, uint64_t* outCellKeys, Field<RAY_IDX_U32>::type* outIndices)
+{
+	LIMIT(pointCount);
+	int32_t scopeIdx = -1;
+	for (int32_t i = 0; i < scopeCount && scopeIdx < 0; ++i) {
+		if (scopes[i].begin_distance <= distance[tid] && distance[tid] <= scopes[i].end_distance) {
+			scopeIdx = i;
+		}
+	}
+	outScopeIndices[tid] = scopeIdx;
+	outParents[tid] = tid;
+	outIndices[tid] = tid;
+	// Points out of all scopes are rejected.
+	if (scopeIdx < 0) {
+		outCellKeys[tid] = UINT64_MAX;
+		return;
+	}
+	const auto& scope = scopes[scopeIdx];
+	outCellKeys[tid] = packRadarCellKey(scopeIdx,
+	                                    getGridCellCoord(distance[tid], getRadarCellSize(scope.distance_separation_threshold)),
+	                                    getGridCellCoord(azimuth[tid], getRadarCellSize(scope.azimuth_separation_threshold)),
+	                                    getGridCellCoord(radialSpeed[tid],
+	                                                     getRadarCellSize(scope.radial_speed_separation_threshold)));
+}
+
+__global__ void kRadarUniteClusters(size_t pointCount, const uint64_t* sortedCellKeys,
+                                    const Field<RAY_IDX_U32>::type* sortedIndices, const Field<DISTANCE_F32>::type* distance,
+                                    const Field<AZIMUTH_F32>::type* azimuth, const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                                    size_t scopeCount, const rgl_radar_scope_t* scopes, const int32_t* scopeIndices,
+                                    uint32_t* parents)
+{
+	LIMIT(pointCount);
+	if (sortedCellKeys[tid] == UINT64_MAX) {
+		return;
+	}
+	const uint32_t idx = sortedIndices[tid];
+	// Every pair is tested once, by the thread of its nearer point, in the grid of the farther one (its thresholds apply).
+	for (int32_t scopeIdx = 0; scopeIdx < scopeCount; ++scopeIdx) {
+		const auto& scope = scopes[scopeIdx];
+		// The farther point must be within the scope.
+		if (distance[idx] > scope.end_distance || distance[idx] + scope.distance_separation_threshold < scope.begin_distance) {
+			continue;
+		}
+		const int64_t cellX = getGridCellCoord(distance[idx], getRadarCellSize(scope.distance_separation_threshold));
+		const int64_t cellY = getGridCellCoord(azimuth[idx], getRadarCellSize(scope.azimuth_separation_threshold));
+		const int64_t cellZ = getGridCellCoord(radialSpeed[idx], getRadarCellSize(scope.radial_speed_separation_threshold));
+		for (int64_t dx = -1; dx <= 1; ++dx) {
+			for (int64_t dy = -1; dy <= 1; ++dy) {
+				for (int64_t dz = -1; dz <= 1; ++dz) {
+					const uint64_t key = packRadarCellKey(scopeIdx, cellX + dx, cellY + dy, cellZ + dz);
+					for (size_t i = lowerBound(sortedCellKeys, pointCount, key); i < pointCount && sortedCellKeys[i] == key;
+					     ++i) {
+						const uint32_t other = sortedIndices[i];
+						const bool isOtherFarther = distance[other] > distance[idx] ||
+						                            (distance[other] == distance[idx] && other > idx);
+						// Wrapped cells may hold points of other scopes.
+						if (!isOtherFarther || scopeIndices[other] != scopeIdx) {
+							continue;
+						}
+						if (fabsf(distance[idx] - distance[other]) <= scope.distance_separation_threshold &&
+						    fabsf(azimuth[idx] - azimuth[other]) <= scope.azimuth_separation_threshold &&
+						    fabsf(radialSpeed[idx] - radialSpeed[other]) <= scope.radial_speed_separation_threshold) {
+							uniteClusters(parents, idx, other);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+__global__ void kRadarFindClusterRoots(size_t pointCount, const int32_t* scopeIndices, uint32_t* parents, int32_t* outIsRoot)
+{
+	LIMIT(pointCount);
+	if (scopeIndices[tid] < 0) {
+		outIsRoot[tid] = 0;
+		return;
+	}
+	const uint32_t root = findClusterRoot(parents, tid);
+	parents[tid] = root;
+	outIsRoot[tid] = root == tid;
+}
+
+__global__ void kRadarScatterClusterIds(size_t pointCount, const uint32_t* clusterCount,
+                                        const Field<RAY_IDX_U32>::type* clusterRoots, uint32_t* outClusterIdOfRoot)
+{
+	LIMIT_DEVICE_COUNT(pointCount, clusterCount);
+	outClusterIdOfRoot[clusterRoots[tid]] = tid;
+}
+
+__global__ void kRadarComputeClusterKeys(size_t pointCount, const int32_t* scopeIndices, const uint32_t* parents,
+                                         const uint32_t* clusterIdOfRoot, uint64_t* outKeys,
+                                         Field<RAY_IDX_U32>::type* outIndices)
+{
+	LIMIT(pointCount);
+	outKeys[tid] = scopeIndices[tid] < 0 ? UINT64_MAX : clusterIdOfRoot[parents[tid]];
+	outIndices[tid] = tid;
+}
+
+__global__ void kRadarReduceClusters(size_t clusterCount, size_t pointCount, const uint64_t* sortedClusterKeys,
+                                     const Field<RAY_IDX_U32>::type* sortedPointIndices,
+                                     const Field<DISTANCE_F32>::type* distance, const Field<AZIMUTH_F32>::type* azimuth,
+                                     const Field<ELEVATION_F32>::type* elevation,
+                                     const Vector<3, thrust::complex<float>>* bubrFactor, float powerBaseDbm,
+                                     float noiseMeanDb, float noiseStDevDb, uint64_t noiseSeed, uint64_t noiseFrame,
+                                     Field<RAY_IDX_U32>::type* outCenterIndices, Field<RCS_F32>::type* outRcs,
+                                     Field<POWER_F32>::type* outPower, Field<NOISE_F32>::type* outNoise,
+                                     Field<SNR_F32>::type* outSnr)
+{
+	LIMIT(clusterCount);
+	// Points of the cluster are contiguous and ordered by index (keys are sorted stably).
+	const size_t begin = lowerBound(sortedClusterKeys, pointCount, tid);
+	const size_t end = lowerBound(sortedClusterKeys, pointCount, tid + 1);
+
+	float minAzimuth = FLT_MAX, maxAzimuth = -FLT_MAX;
+	float minElevation = FLT_MAX, maxElevation = -FLT_MAX;
+	thrust::complex<float> AU = 0;
+	thrust::complex<float> AR = 0;
+	for (size_t i = begin; i < end; ++i) {
+		const uint32_t idx = sortedPointIndices[i];
+		minAzimuth = fminf(minAzimuth, azimuth[idx]);
+		maxAzimuth = fmaxf(maxAzimuth, azimuth[idx]);
+		minElevation = fminf(minElevation, elevation[idx]);
+		maxElevation = fmaxf(maxElevation, elevation[idx]);
+		AU += bubrFactor[idx][0] * bubrFactor[idx][2];
+		AR += bubrFactor[idx][1] * bubrFactor[idx][2];
+	}
+
+	// Directional center
+	const float meanAzimuth = (minAzimuth + maxAzimuth) / 2.0f;
+	const float meanElevation = (minElevation + maxElevation) / 2.0f;
+	float minDirectionalDistance = FLT_MAX;
+	uint32_t centerIdx = sortedPointIndices[begin];
+	for (size_t i = begin; i < end; ++i) {
+		const uint32_t idx = sortedPointIndices[i];
+		const float directionalDistance = fabsf(azimuth[idx] - meanAzimuth) + fabsf(elevation[idx] - meanElevation);
+		if (directionalDistance < minDirectionalDistance) {
+			minDirectionalDistance = directionalDistance;
+			centerIdx = idx;
+		}
+	}
+
+	// https://en.wikipedia.org/wiki/Radar_cross_section#Formulation
+	constexpr float pi = static_cast<float>(M_PI);
+	const float rcsDbsm = 10.0f * log10f(4.0f * pi * (thrust::norm(AU) + thrust::norm(AR)));
+	const float multiplier = 10.0f * log10f(powf(4.0f * pi, 3)) + 10.0f * log10f(powf(distance[centerIdx], 4));
+	const float powerReceived = powerBaseDbm + rcsDbsm - multiplier;
+
+	// Philox is counter-based, so a generator for the cluster is initialized cheaply, without stored state.
+	// Each cluster has its own subsequence; frames are offsets within it, far enough apart for a normal number.
+	curandStatePhilox4_32_10_t randomState;
+	curand_init(noiseSeed, tid, noiseFrame * 4, &randomState);
+	const float noise = noiseMeanDb + curand_normal(&randomState) * noiseStDevDb;
+
+	outCenterIndices[tid] = centerIdx;
+	outRcs[tid] = rcsDbsm;
+	outPower[tid] = powerReceived + noise; // power received + noise
+	outNoise[tid] = noise;
+	outSnr[tid] = outPower[tid] - noise;
+}
+
+__global__ void kRadarComputeEchoes(size_t pointCount, const Field<DISTANCE_F32>::type* distance,
+                                    const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                                    const Vector<3, thrust::complex<float>>* bubrFactor, float amplitudeBase,
+                                    float rangeBinsPerMeter, float dopplerCyclesPerSpeed, float maxDistance,
+                                    RadarEcho* outEchoes)
+{
+	LIMIT(pointCount);
+	// Non-hits and points beyond the unambiguous range do not echo.
+	const float pointDistance = distance[tid];
+	if (!(pointDistance > 0.0f && pointDistance < maxDistance) || !isfinite(radialSpeed[tid])) {
+		outEchoes[tid] = RadarEcho{.amplitude = 0.0f, .rangeBin = 0.0f, .dopplerCycles = 0.0f};
+		return;
+	}
+	// Radar equation as in kRadarReduceClusters, for the field (co-polarized component) instead of the power.
+	const thrust::complex<float> scatteredField = bubrFactor[tid][0] * bubrFactor[tid][2];
+	outEchoes[tid] = RadarEcho{
+	    .amplitude = scatteredField * (amplitudeBase / (pointDistance * pointDistance)),
+	    .rangeBin = pointDistance * rangeBinsPerMeter,
+	    .dopplerCycles = radialSpeed[tid] * dopplerCyclesPerSpeed,
+	};
+}
+
+__device__ __forceinline__ float getHannWindow(int idx, int count)
+{
+	return count > 1 ? 0.5f - 0.5f * cospif(2.0f * static_cast<float>(idx) / static_cast<float>(count - 1)) : 1.0f;
+}
+
+__global__ void kRadarSynthesizeBeatSignal(size_t signalSize, size_t echoCount, const RadarEcho* echoes,
+                                           int samplesPerChirp, int chirpCount, float noiseAmplitude, uint64_t noiseSeed,
+                                           uint64_t noiseFrame, thrust::complex<float>* outSignal)
+{
+	LIMIT(signalSize);
+	const int sampleIdx = tid % samplesPerChirp;
+	const int chirpIdx = tid / samplesPerChirp;
+	const float sampleFraction = static_cast<float>(sampleIdx) / static_cast<float>(samplesPerChirp);
+	// All threads read the same echo at a time, so that the reads are broadcast.
+	thrust::complex<float> sample = 0.0f;
+	for (size_t i = 0; i < echoCount; ++i) {
+		const RadarEcho& echo = echoes[i];
+		// Phase in cycles, wrapped before scaling to keep the precision for high range bins and chirp indices.
+		float cycles = echo.rangeBin * sampleFraction;
+		cycles = (cycles - floorf(cycles)) + echo.dopplerCycles * static_cast<float>(chirpIdx);
+		cycles -= floorf(cycles);
+		float sinPhase = 0.0f, cosPhase = 0.0f;
+		sincospif(2.0f * cycles, &sinPhase, &cosPhase);
+		sample += echo.amplitude * thrust::complex<float>(cosPhase, sinPhase);
+	}
+
+	// Receiver noise is complex Gaussian, drawn independently per sample and run.
+	curandStatePhilox4_32_10_t randomState;
+	curand_init(noiseSeed, tid, noiseFrame * 4, &randomState);
+	const float2 noise = curand_normal2(&randomState);
+	sample += thrust::complex<float>(noise.x, noise.y) * noiseAmplitude;
+	outSignal[tid] = sample * (getHannWindow(sampleIdx, samplesPerChirp) * getHannWindow(chirpIdx, chirpCount));
+}
+
+// Power of the spectrum cell at the given (shifted, so that zero speed is in the middle) Doppler row and range bin.
+__device__ __forceinline__ float getRangeDopplerPower(const thrust::complex<float>* spectrum, int samplesPerChirp,
+                                                      int chirpCount, int dopplerRow, int rangeBin, float powerScale)
+{
+	const int spectrumRow = (dopplerRow + chirpCount / 2) % chirpCount;
+	return thrust::norm(spectrum[spectrumRow * samplesPerChirp + rangeBin]) * powerScale;
+}
+
+__global__ void kRadarRangeDopplerCfar(size_t cellCount, int samplesPerChirp, int chirpCount,
+                                       const thrust::complex<float>* spectrum, float powerScale, float rangeBinSize,
+                                       float speedBinSize, int guardCells, int trainingCells, float thresholdRatio,
+                                       Field<DISTANCE_F32>::type* outDistance, Field<RADIAL_SPEED_F32>::type* outRadialSpeed,
+                                       Field<POWER_F32>::type* outPower, Field<NOISE_F32>::type* outNoise,
+                                       Field<SNR_F32>::type* outSnr, Field<IS_HIT_I32>::type* outIsDetection)
+{
+	LIMIT(cellCount);
+	const int rangeBin = tid % samplesPerChirp;
+	const int dopplerRow = tid / samplesPerChirp;
+	const float power = getRangeDopplerPower(spectrum, samplesPerChirp, chirpCount, dopplerRow, rangeBin, powerScale);
+
+	// Cell-averaging CFAR: the noise is estimated from training cells around the guard cells; Doppler wraps around.
+	const int windowRadius = guardCells + trainingCells;
+	float noiseSum = 0.0f;
+	int noiseCellCount = 0;
+	for (int dy = -windowRadius; dy <= windowRadius; ++dy) {
+		const int row = ((dopplerRow + dy) % chirpCount + chirpCount) % chirpCount;
+		for (int dx = -windowRadius; dx <= windowRadius; ++dx) {
+			const int bin = rangeBin + dx;
+			const bool isGuard = abs(dx) <= guardCells && abs(dy) <= guardCells;
+			if (bin < 0 || bin >= samplesPerChirp || isGuard) {
+				continue;
+			}
+			noiseSum += getRangeDopplerPower(spectrum, samplesPerChirp, chirpCount, row, bin, powerScale);
+			noiseCellCount += 1;
+		}
+	}
+	const float noise = noiseCellCount > 0 ? noiseSum / static_cast<float>(noiseCellCount) : 0.0f;
+
+	outDistance[tid] = static_cast<float>(rangeBin) * rangeBinSize;
+	outRadialSpeed[tid] = static_cast<float>(dopplerRow - chirpCount / 2) * speedBinSize;
+	outPower[tid] = 10.0f * log10f(power);
+	outNoise[tid] = 10.0f * log10f(noise);
+	outSnr[tid] = outPower[tid] - outNoise[tid];
+	outIsDetection[tid] = power > noise * thresholdRatio;
+}
+
 __global__ void kFilterGroundPoints(size_t pointCount, const Vec3f sensor_up_vector, float ground_angle_threshold,
                                     const Field<XYZ_VEC3_F32>::type* inPoints, const Field<NORMAL_VEC3_F32>::type* inNormalsPtr,
                                     Field<IS_GROUND_I32>::type* outNonGround, Mat3x4f lidarTransform)
@@ -223,29 +961,759 @@ __global__ void kFilterGroundPoints(size_t pointCount, const Vec3f sensor_up_vec
 	outNonGround[tid] = normalUpAngle > ground_angle_threshold;
 }
 
+// Deterministic integer hash (Wang's), used to sample RANSAC hypotheses without per-thread random generator state.
+__device__ __forceinline__ uint32_t hashIndex(uint32_t x)
+{
+	x = (x ^ 61) ^ (x >> 16);
+	x *= 9;
+	x = x ^ (x >> 4);
+	x *= 0x27d4eb2d;
+	return x ^ (x >> 15);
+}
+
+constexpr int GROUND_PLANE_BLOCK_SIZE = 256;
+
+// Each block evaluates one plane hypothesis (spanned by three sampled points) against all points.
+__global__ void kEvaluateGroundPlaneHypotheses(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, Vec3f upVector,
+                                               float minUpCosine, float distanceThreshold, Vec4f* outPlanes,
+                                               int32_t* outInlierCounts)
+{
+	__shared__ Vec4f plane;
+	__shared__ bool isPlaneValid;
+	__shared__ int32_t partialCounts[GROUND_PLANE_BLOCK_SIZE];
+
+	const uint32_t hypothesisIdx = blockIdx.x;
+	if (threadIdx.x == 0) {
+		const Vec3f a = points[hashIndex(3 * hypothesisIdx + 0) % pointCount];
+		const Vec3f b = points[hashIndex(3 * hypothesisIdx + 1) % pointCount];
+		const Vec3f c = points[hashIndex(3 * hypothesisIdx + 2) % pointCount];
+		Vec3f normal = (b - a).cross(c - a);
+		const float normalLength = normal.length();
+		isPlaneValid = isfinite(normalLength) && normalLength > 0.0f;
+		if (isPlaneValid) {
+			normal = normal / normalLength;
+			normal = normal.dot(upVector) < 0.0f ? -normal : normal;
+			// Plane has to be perpendicular to the up vector, up to the angle threshold.
+			isPlaneValid = normal.dot(upVector) >= minUpCosine;
+		}
+		plane = Vec4f(normal, -normal.dot(a));
+	}
+	__syncthreads();
+
+	if (!isPlaneValid) {
+		if (threadIdx.x == 0) {
+			outPlanes[hypothesisIdx] = plane;
+			outInlierCounts[hypothesisIdx] = 0;
+		}
+		return;
+	}
+
+	const Vec3f normal = {plane[0], plane[1], plane[2]};
+	int32_t inlierCount = 0;
+	for (size_t i = threadIdx.x; i < pointCount; i += blockDim.x) {
+		inlierCount += fabsf(normal.dot(points[i]) + plane[3]) <= distanceThreshold;
+	}
+	partialCounts[threadIdx.x] = inlierCount;
+	__syncthreads();
+
+	for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+		if (threadIdx.x < stride) {
+			partialCounts[threadIdx.x] += partialCounts[threadIdx.x + stride];
+		}
+		__syncthreads();
+	}
+
+	if (threadIdx.x == 0) {
+		outPlanes[hypothesisIdx] = plane;
+		outInlierCounts[hypothesisIdx] = partialCounts[0];
+	}
+}
+
+// Single block arg-max over hypotheses; ties are resolved towards the lower index, so the result is deterministic.
+__global__ void kSelectBestGroundPlane(size_t hypothesisCount, const Vec4f* planes, const int32_t* inlierCounts,
+                                       Vec4f* outPlane, int32_t* outInlierCount)
+{
+	__shared__ int32_t bestCounts[GROUND_PLANE_BLOCK_SIZE];
+	__shared__ uint32_t bestIndices[GROUND_PLANE_BLOCK_SIZE];
+
+	int32_t bestCount = -1;
+	uint32_t bestIdx = 0;
+	for (uint32_t i = threadIdx.x; i < hypothesisCount; i += blockDim.x) {
+		if (inlierCounts[i] > bestCount) {
+			bestCount = inlierCounts[i];
+			bestIdx = i;
+		}
+	}
+	bestCounts[threadIdx.x] = bestCount;
+	bestIndices[threadIdx.x] = bestIdx;
+	__syncthreads();
+
+	for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+		if (threadIdx.x < stride) {
+			const int32_t otherCount = bestCounts[threadIdx.x + stride];
+			const uint32_t otherIdx = bestIndices[threadIdx.x + stride];
+			if (otherCount > bestCounts[threadIdx.x] ||
+			    (otherCount == bestCounts[threadIdx.x] && otherIdx < bestIndices[threadIdx.x])) {
+				bestCounts[threadIdx.x] = otherCount;
+				bestIndices[threadIdx.x] = otherIdx;
+			}
+		}
+		__syncthreads();
+	}
+
+	if (threadIdx.x == 0) {
+		*outPlane = planes[bestIndices[0]];
+		*outInlierCount = max(bestCounts[0], 0);
+	}
+}
+
+__global__ void kMarkGroundPlanePoints(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, const Vec4f* plane,
+                                       const int32_t* planeInlierCount, float filterDistance,
+                                       Field<IS_GROUND_I32>::type* outNonGround)
+{
+	LIMIT(pointCount);
+	const Vec3f normal = {(*plane)[0], (*plane)[1], (*plane)[2]};
+	const bool isGround = *planeInlierCount > 0 && fabsf(normal.dot(points[tid]) + (*plane)[3]) <= filterDistance;
+	// Same convention as kFilterGroundPoints, so that CompactByFieldPointsNode removes ground points.
+	outNonGround[tid] = !isGround;
+}
+
+// Pixel keys pack the distance (bits of a non-negative float are ordered as unsigned integers) with the index of the point,
+// so that atomicMin keeps the nearest point (the first one among equally distant points).
+__global__ void kScatterRangeImage(size_t pointCount, const uint32_t* devicePointCount, const Field<IS_HIT_I32>::type* isHit,
+                                   const Field<RING_ID_U16>::type* ringIds, const Field<AZIMUTH_F32>::type* azimuths,
+                                   const Field<DISTANCE_F32>::type* distances, int32_t height, int32_t width,
+                                   float azimuthMin, float azimuthMax, unsigned long long* outPixelKeys)
+{
+	LIMIT_DEVICE_COUNT(pointCount, devicePointCount);
+	const float distance = distances[tid];
+	if (!isHit[tid] || !(distance >= 0.0f)) {
+		return;
+	}
+	const int32_t row = ringIds[tid];
+	const float column = floorf((azimuths[tid] - azimuthMin) / (azimuthMax - azimuthMin) * static_cast<float>(width));
+	if (row >= height || !(column >= 0.0f && column < static_cast<float>(width))) {
+		return;
+	}
+	const unsigned long long key = (static_cast<unsigned long long>(__float_as_uint(distance)) << 32) | tid;
+	atomicMin(&outPixelKeys[row * width + static_cast<int32_t>(column)], key);
+}
+
+__global__ void kGatherRangeImage(size_t pixelCount, const unsigned long long* pixelKeys,
+                                  const Field<DISTANCE_F32>::type* distances, const Field<INTENSITY_F32>::type* intensities,
+                                  const Field<ENTITY_ID_I32>::type* entityIds, Field<IS_HIT_I32>::type* outIsHit,
+                                  Field<DISTANCE_F32>::type* outDistances, Field<INTENSITY_F32>::type* outIntensities,
+                                  Field<ENTITY_ID_I32>::type* outEntityIds)
+{
+	LIMIT(pixelCount);
+	const unsigned long long key = pixelKeys[tid];
+	const bool isFilled = key != ULLONG_MAX;
+	const auto pointIdx = static_cast<uint32_t>(key & UINT32_MAX);
+	outIsHit[tid] = isFilled;
+	outDistances[tid] = isFilled ? distances[pointIdx] : 0.0f;
+	if (intensities != nullptr) {
+		outIntensities[tid] = isFilled ? intensities[pointIdx] : 0.0f;
+	}
+	if (entityIds != nullptr) {
+		outEntityIds[tid] = isFilled ? entityIds[pointIdx] : RGL_ENTITY_INVALID_ID;
+	}
+}
+
+__global__ void kClearOccupancyGrid(size_t cellCount, rgl_occupancy_cell_t* cells)
+{
+	LIMIT(cellCount);
+	cells[tid] = {.hit_count = 0, .miss_count = 0, .min_height = INFINITY, .max_height = -INFINITY};
+}
+
+// Bits of non-negative floats are ordered as signed integers, bits of negative floats are ordered reversely as unsigned ones.
+// Negative zero is replaced by zero, otherwise it would be the lowest integer (below negative floats).
+__device__ __forceinline__ void atomicMinFloat(float* address, float value)
+{
+	value = value == 0.0f ? 0.0f : value;
+	if (value >= 0.0f) {
+		atomicMin(reinterpret_cast<int*>(address), __float_as_int(value));
+	}
+	else {
+		atomicMax(reinterpret_cast<unsigned int*>(address), __float_as_uint(value));
+	}
+}
 
-void gpuFindCompaction(cudaStream_t stream, size_t pointCount, const int32_t* shouldCompact,
-                       CompactionIndexType* hitCountInclusive, size_t* outHitCount)
+__device__ __forceinline__ void atomicMaxFloat(float* address, float value)
 {
-	// beg and end could be used as const pointers, however thrust does not support it
-	auto beg = thrust::device_ptr<const int32_t>(shouldCompact);
-	auto end = thrust::device_ptr<const int32_t>(shouldCompact + pointCount);
-	auto dst = thrust::device_ptr<int32_t>(hitCountInclusive);
+	value = value == 0.0f ? 0.0f : value;
+	if (value >= 0.0f) {
+		atomicMax(reinterpret_cast<int*>(address), __float_as_int(value));
+	}
+	else {
+		atomicMin(reinterpret_cast<unsigned int*>(address), __float_as_uint(value));
+	}
+}
 
-	// Note: this will compile only in a .cu file
-	thrust::inclusive_scan(thrust::cuda::par.on(stream), beg, end, dst);
-	CHECK_CUDA(cudaMemcpyAsync(outHitCount, hitCountInclusive + pointCount - 1, sizeof(*hitCountInclusive), cudaMemcpyDefault,
-	                           stream));
+__device__ __forceinline__ bool isInsideGrid(const Vec3i& cell, const Vec3i& gridSize)
+{
+	return cell.x() >= 0 && cell.y() >= 0 && cell.z() >= 0 && cell.x() < gridSize.x() && cell.y() < gridSize.y() &&
+	       cell.z() < gridSize.z();
 }
 
-void gpuFormatSoaToAos(cudaStream_t stream, size_t pointCount, size_t pointSize, size_t fieldCount,
-                       const GPUFieldDesc* soaInData, char* aosOutData)
+__device__ __forceinline__ int32_t getOccupancyCellIdx(const Vec3i& cell, const Vec3i& gridSize)
 {
-	run(kFormatSoaToAos, stream, pointCount, pointSize, fieldCount, soaInData, aosOutData);
+	return cell.x() + gridSize.x() * (cell.y() + gridSize.y() * cell.z());
+}
+
+// Increments miss counts of cells crossed by the segment [from, to] given in units of cells relative to the grid,
+// using the traversal of Amanatides and Woo. The cell containing the end of the segment is skipped for hits.
+__device__ void castOccupancyRay(const Vec3f& from, const Vec3f& to, bool isHit, const Vec3i& gridSize,
+                                 rgl_occupancy_cell_t* cells)
+{
+	// The segment (parametrized by t in [0, 1]) is clipped to the grid box with the slab method.
+	const Vec3f dir = to - from;
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+	for (int axis = 0; axis < 3; ++axis) {
+		if (dir[axis] == 0.0f) {
+			if (from[axis] < 0.0f || from[axis] >= static_cast<float>(gridSize[axis])) {
+				return;
+			}
+			continue;
+		}
+		const float tLower = -from[axis] / dir[axis];
+		const float tUpper = (static_cast<float>(gridSize[axis]) - from[axis]) / dir[axis];
+		tEnter = fmaxf(tEnter, fminf(tLower, tUpper));
+		tExit = fminf(tExit, fmaxf(tLower, tUpper));
+	}
+	if (!(tEnter < tExit)) {
+		return;
+	}
+
+	const Vec3f start = from + dir * tEnter;
+	const Vec3i endCell{floorf(to.x()), floorf(to.y()), floorf(to.z())};
+	Vec3i cell, step;
+	Vec3f tNext; // Values of t at which the segment crosses the next cell boundary along each axis
+	for (int axis = 0; axis < 3; ++axis) {
+		cell[axis] = min(max(static_cast<int32_t>(floorf(start[axis])), 0), gridSize[axis] - 1);
+		step[axis] = dir[axis] > 0.0f ? 1 : (dir[axis] < 0.0f ? -1 : 0);
+		const float boundary = static_cast<float>(cell[axis] + (step[axis] > 0 ? 1 : 0));
+		tNext[axis] = step[axis] != 0 ? (boundary - from[axis]) / dir[axis] : INFINITY;
+	}
+	while (true) {
+		const bool isEndCell = cell.x() == endCell.x() && cell.y() == endCell.y() && cell.z() == endCell.z();
+		if (isEndCell && isHit) {
+			return;
+		}
+		atomicAdd(&cells[getOccupancyCellIdx(cell, gridSize)].miss_count, 1);
+		const int axis = tNext.x() <= tNext.y() ? (tNext.x() <= tNext.z() ? 0 : 2) : (tNext.y() <= tNext.z() ? 1 : 2);
+		if (isEndCell || tNext[axis] >= tExit) {
+			return;
+		}
+		cell[axis] += step[axis];
+		if (cell[axis] < 0 || cell[axis] >= gridSize[axis]) {
+			return;
+		}
+		tNext[axis] += static_cast<float>(step[axis]) / dir[axis];
+	}
+}
+
+__global__ void kAccumulateOccupancyGrid(size_t pointCount, const uint32_t* devicePointCount,
+                                         const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit,
+                                         Vec3f gridMin, Vec3f cellSize, Vec3i gridSize, bool castRays, Vec3f rayOrigin,
+                                         rgl_occupancy_cell_t* cells)
+{
+	LIMIT_DEVICE_COUNT(pointCount, devicePointCount);
+	const Vec3f point = points[tid];
+	const bool isPointHit = isHit == nullptr || isHit[tid];
+	const Vec3f pointInCells = (point - gridMin) / cellSize;
+	if (isPointHit) {
+		const Vec3i cell{floorf(pointInCells.x()), floorf(pointInCells.y()), floorf(pointInCells.z())};
+		if (isInsideGrid(cell, gridSize)) {
+			rgl_occupancy_cell_t& hitCell = cells[getOccupancyCellIdx(cell, gridSize)];
+			atomicAdd(&hitCell.hit_count, 1);
+			atomicMinFloat(&hitCell.min_height, point.z());
+			atomicMaxFloat(&hitCell.max_height, point.z());
+		}
+	}
+	if (castRays && isfinite(point.x()) && isfinite(point.y()) && isfinite(point.z())) {
+		castOccupancyRay((rayOrigin - gridMin) / cellSize, pointInCells, isPointHit, gridSize, cells);
+	}
+}
+
+// Euclidean clustering: like radar clustering, but points are linked by their distance, with a single grid
+// of cells of the tolerance size; invalid (non-hit or non-finite) points get UINT64_MAX keys.
+__global__ void kEuclideanInitClusters(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                                       const Field<IS_HIT_I32>::type* isHit, float tolerance, uint32_t* outParents,
+                                       uint64_t* outCellKeys, Field<RAY_IDX_U32>::type* outIndices)
+{
+	LIMIT(pointCount);
+	const Vec3f point = points[tid];
+	const bool isFinite = isfinite(point[0]) && isfinite(point[1]) && isfinite(point[2]);
+	outParents[tid] = tid;
+	outIndices[tid] = tid;
+	outCellKeys[tid] = isFinite && (isHit == nullptr || isHit[tid]) ?
+	                       packGridCellKey(getGridCellCoord(point[0], tolerance), getGridCellCoord(point[1], tolerance),
+	                                       getGridCellCoord(point[2], tolerance)) :
+	                       UINT64_MAX;
+}
+
+__global__ void kEuclideanUniteClusters(size_t pointCount, float tolerance, const Field<XYZ_VEC3_F32>::type* points,
+                                        const uint64_t* sortedCellKeys, const Field<RAY_IDX_U32>::type* sortedIndices,
+                                        uint32_t* parents)
+{
+	LIMIT(pointCount);
+	if (sortedCellKeys[tid] == UINT64_MAX) {
+		return;
+	}
+	const uint32_t idx = sortedIndices[tid];
+	const Vec3f point = points[idx];
+	const int64_t cellX = getGridCellCoord(point[0], tolerance);
+	const int64_t cellY = getGridCellCoord(point[1], tolerance);
+	const int64_t cellZ = getGridCellCoord(point[2], tolerance);
+	for (int64_t dx = -1; dx <= 1; ++dx) {
+		for (int64_t dy = -1; dy <= 1; ++dy) {
+			for (int64_t dz = -1; dz <= 1; ++dz) {
+				const uint64_t key = packGridCellKey(cellX + dx, cellY + dy, cellZ + dz);
+				for (size_t i = lowerBound(sortedCellKeys, pointCount, key); i < pointCount && sortedCellKeys[i] == key; ++i) {
+					const uint32_t other = sortedIndices[i];
+					// Every pair is tested once, by the thread of its lower index; wrapped cells may hold distant points.
+					if (other > idx && (points[other] - point).lengthSquared() <= tolerance * tolerance) {
+						uniteClusters(parents, idx, other);
+					}
+				}
+			}
+		}
+	}
+}
+
+__global__ void kEuclideanFindClusterRoots(size_t pointCount, const uint64_t* cellKeys, uint32_t* parents,
+                                           uint32_t* outClusterSizes)
+{
+	LIMIT(pointCount);
+	const uint32_t root = findClusterRoot(parents, tid);
+	parents[tid] = root;
+	if (cellKeys[tid] != UINT64_MAX) {
+		atomicAdd(&outClusterSizes[root], 1);
+	}
+}
+
+__global__ void kEuclideanMarkClusterRoots(size_t pointCount, const uint64_t* cellKeys, const uint32_t* parents,
+                                           const uint32_t* clusterSizes, uint32_t minClusterSize, uint32_t maxClusterSize,
+                                           int32_t* outIsRoot)
+{
+	LIMIT(pointCount);
+	outIsRoot[tid] = cellKeys[tid] != UINT64_MAX && parents[tid] == tid && minClusterSize <= clusterSizes[tid] &&
+	                 clusterSizes[tid] <= maxClusterSize;
+}
+
+__global__ void kEuclideanScatterClusterIds(size_t pointCount, const uint32_t* clusterCount,
+                                            const Field<RAY_IDX_U32>::type* clusterRoots,
+                                            Field<CLUSTER_ID_I32>::type* outClusterIdOfRoot)
+{
+	LIMIT_DEVICE_COUNT(pointCount, clusterCount);
+	outClusterIdOfRoot[clusterRoots[tid]] = static_cast<Field<CLUSTER_ID_I32>::type>(tid);
+}
+
+// Points of rejected clusters (and invalid points, which are their own roots) map to -1.
+__global__ void kEuclideanWriteClusterIds(size_t pointCount, const uint32_t* parents,
+                                          const Field<CLUSTER_ID_I32>::type* clusterIdOfRoot,
+                                          Field<CLUSTER_ID_I32>::type* outClusterIds)
+{
+	LIMIT(pointCount);
+	outClusterIds[tid] = clusterIdOfRoot[parents[tid]];
+}
+
+__global__ void kFindMaxClusterId(size_t pointCount, const Field<CLUSTER_ID_I32>::type* clusterIds, int32_t* outMaxClusterId)
+{
+	LIMIT(pointCount);
+	if (clusterIds[tid] >= 0) {
+		atomicMax(outMaxClusterId, clusterIds[tid]);
+	}
+}
+
+__global__ void kClearClusterBoxes(size_t clusterCount, rgl_cluster_box_t* boxes)
+{
+	LIMIT(clusterCount);
+	boxes[tid] = {.min = {INFINITY, INFINITY, INFINITY}, .max = {-INFINITY, -INFINITY, -INFINITY}, .point_count = 0};
+}
+
+__global__ void kAccumulateClusterBoxes(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                                        const Field<CLUSTER_ID_I32>::type* clusterIds, size_t clusterCount,
+                                        rgl_cluster_box_t* boxes)
+{
+	LIMIT(pointCount);
+	const int32_t clusterId = clusterIds[tid];
+	if (clusterId < 0 || static_cast<size_t>(clusterId) >= clusterCount) {
+		return;
+	}
+	rgl_cluster_box_t& box = boxes[clusterId];
+	for (int axis = 0; axis < 3; ++axis) {
+		atomicMinFloat(&box.min.value[axis], points[tid][axis]);
+		atomicMaxFloat(&box.max.value[axis], points[tid][axis]);
+	}
+	atomicAdd(&box.point_count, 1);
+}
+
+// Compression blocks are encoded by thread blocks, one thread per point.
+constexpr int COMPRESSION_BLOCK_SIZE = RGL_COMPRESSED_POINTS_BLOCK_SIZE;
+constexpr int32_t COMPRESSION_MAX_QUANTIZED = (1 << 30) - 1; // Deltas fit into int32_t
+
+__device__ Vec3i quantizeCompressedXyz(const Vec3f& point, float xyzStep)
+{
+	Vec3i quantized;
+	for (int axis = 0; axis < 3; ++axis) {
+		float steps = rintf(point[axis] / xyzStep);
+		steps = isnan(steps) ? 0.0f : fminf(fmaxf(steps, -COMPRESSION_MAX_QUANTIZED), COMPRESSION_MAX_QUANTIZED);
+		quantized[axis] = max(-COMPRESSION_MAX_QUANTIZED, min(static_cast<int32_t>(steps), COMPRESSION_MAX_QUANTIZED));
+	}
+	return quantized;
+}
+
+// Zigzag-encoded deltas are stored at indices of their points; bit widths are found by OR-ing deltas of the block.
+__global__ void kEncodeCompressedBlocks(size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, float xyzStep,
+                                        Vector<3, uint32_t>* outDeltas, rgl_compressed_block_header_t* outHeaders,
+                                        uint32_t* outBlockSizes)
+{
+	__shared__ uint32_t axisMasks[3];
+	if (threadIdx.x < 3) {
+		axisMasks[threadIdx.x] = 0;
+	}
+	__syncthreads();
+
+	const size_t blockBegin = static_cast<size_t>(blockIdx.x) * COMPRESSION_BLOCK_SIZE;
+	const size_t pointIdx = blockBegin + threadIdx.x;
+	Vec3i quantized{0};
+	if (pointIdx < pointCount) {
+		quantized = quantizeCompressedXyz(points[pointIdx], xyzStep);
+	}
+	if (pointIdx < pointCount && threadIdx.x > 0) {
+		const Vec3i previous = quantizeCompressedXyz(points[pointIdx - 1], xyzStep);
+		Vector<3, uint32_t> encoded;
+		for (int axis = 0; axis < 3; ++axis) {
+			const int32_t delta = quantized[axis] - previous[axis];
+			encoded[axis] = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+			atomicOr(&axisMasks[axis], encoded[axis]);
+		}
+		outDeltas[pointIdx] = encoded;
+	}
+	__syncthreads();
+
+	if (threadIdx.x == 0) {
+		const size_t deltaCount = min(pointCount - blockBegin, static_cast<size_t>(COMPRESSION_BLOCK_SIZE)) - 1;
+		rgl_compressed_block_header_t header{};
+		uint32_t blockSize = sizeof(rgl_compressed_block_header_t);
+		for (int axis = 0; axis < 3; ++axis) {
+			const int bitWidth = 32 - __clz(axisMasks[axis]);
+			header.first[axis] = quantized[axis];
+			header.bit_widths[axis] = static_cast<uint8_t>(bitWidth);
+			blockSize += (deltaCount * bitWidth + 31) / 32 * sizeof(uint32_t);
+		}
+		outHeaders[blockIdx.x] = header;
+		outBlockSizes[blockIdx.x] = blockSize;
+		if (blockIdx.x == 0) {
+			outBlockSizes[gridDim.x] = 0; // Exclusive scan of blockCount + 1 sizes gives the total size
+		}
+	}
+}
+
+// Each thread assembles one 32-bit word of every axis from the deltas overlapping it.
+__global__ void kPackCompressedBlocks(size_t pointCount, const Vector<3, uint32_t>* deltas,
+                                      const rgl_compressed_block_header_t* headers, const uint32_t* blockOffsets,
+                                      char* outBlocks)
+{
+	const rgl_compressed_block_header_t header = headers[blockIdx.x];
+	char* block = outBlocks + blockOffsets[blockIdx.x];
+	if (threadIdx.x == 0) {
+		*reinterpret_cast<rgl_compressed_block_header_t*>(block) = header;
+	}
+
+	const size_t blockBegin = static_cast<size_t>(blockIdx.x) * COMPRESSION_BLOCK_SIZE;
+	const size_t deltaCount = min(pointCount - blockBegin, static_cast<size_t>(COMPRESSION_BLOCK_SIZE)) - 1;
+	const Vector<3, uint32_t>* blockDeltas = deltas + blockBegin + 1;
+	auto* words = reinterpret_cast<uint32_t*>(block + sizeof(rgl_compressed_block_header_t));
+	for (int axis = 0; axis < 3; ++axis) {
+		const size_t bitWidth = header.bit_widths[axis];
+		const size_t wordCount = (deltaCount * bitWidth + 31) / 32;
+		if (threadIdx.x < wordCount) {
+			const int64_t firstBit = 32 * threadIdx.x;
+			uint32_t word = 0;
+			for (size_t deltaIdx = firstBit / bitWidth; deltaIdx < deltaCount && deltaIdx * bitWidth < firstBit + 32;
+			     ++deltaIdx) {
+				const int64_t shift = static_cast<int64_t>(deltaIdx * bitWidth) - firstBit;
+				const uint64_t value = blockDeltas[deltaIdx][axis];
+				word |= static_cast<uint32_t>(shift >= 0 ? value << shift : value >> -shift);
+			}
+			words[threadIdx.x] = word;
+		}
+		words += wordCount;
+	}
+}
+
+// CUB's DeviceSelect is a single-pass (decoupled look-back) stream compaction.
+// Its item count is int, but point counts are bounded by ray counts, which fit into it.
+// Flags may be computed on the fly by an iterator, so that predicates are evaluated within the same pass.
+template<typename InputIt, typename FlagIt>
+static cudaError_t selectFlagged(void* tempStorage, size_t& tempStorageSize, InputIt in, size_t pointCount,
+                                 FlagIt shouldSelect, Field<RAY_IDX_U32>::type* outIndices, uint32_t* outSelectedCount,
+                                 cudaStream_t stream)
+{
+	return cub::DeviceSelect::Flagged(tempStorage, tempStorageSize, in, shouldSelect, outIndices, outSelectedCount,
+	                                  static_cast<int>(pointCount), stream);
+}
+
+template<typename FlagIt>
+static void findCompaction(cudaStream_t stream, size_t pointCount, FlagIt shouldSelect,
+                           const Field<RAY_IDX_U32>::type* inputIndices, Field<RAY_IDX_U32>::type* outIndices,
+                           uint32_t* outSelectedCount, void* tempStorage, size_t tempStorageSize)
+{
+	if (inputIndices == nullptr) {
+		auto identity = thrust::counting_iterator<Field<RAY_IDX_U32>::type>(0);
+		CHECK_CUDA(selectFlagged(tempStorage, tempStorageSize, identity, pointCount, shouldSelect, outIndices, outSelectedCount,
+		                         stream));
+		return;
+	}
+	CHECK_CUDA(selectFlagged(tempStorage, tempStorageSize, inputIndices, pointCount, shouldSelect, outIndices, outSelectedCount,
+	                         stream));
+}
+
+template<typename FlagIt>
+static size_t findCompactionTempStorageSize(size_t pointCount, FlagIt shouldSelect)
+{
+	// The size does not depend on data, but may depend on the input iterator type, hence the max of both used types.
+	size_t identitySize = 0;
+	size_t composedSize = 0;
+	CHECK_CUDA(selectFlagged(nullptr, identitySize, thrust::counting_iterator<Field<RAY_IDX_U32>::type>(0), pointCount,
+	                         shouldSelect, nullptr, nullptr, nullptr));
+	CHECK_CUDA(selectFlagged(nullptr, composedSize, static_cast<const Field<RAY_IDX_U32>::type*>(nullptr), pointCount,
+	                         shouldSelect, nullptr, nullptr, nullptr));
+	return std::max(identitySize, composedSize);
+}
+
+// Tells whether the point satisfies all regions, see rgl_region_t.
+struct RegionsPredicate
+{
+	const Field<XYZ_VEC3_F32>::type* points;
+	const rgl_region_t* regions;
+	int32_t regionCount;
+
+	__device__ int32_t operator()(Field<RAY_IDX_U32>::type pointIdx) const
+	{
+		const Vec3f point = points[pointIdx];
+		for (int32_t i = 0; i < regionCount; ++i) {
+			const rgl_region_t region = regions[i];
+			const Vec3f min = {region.min.value[0], region.min.value[1], region.min.value[2]};
+			const Vec3f max = {region.max.value[0], region.max.value[1], region.max.value[2]};
+			bool isInside = false;
+			switch (region.shape) {
+				case RGL_REGION_SHAPE_BOX:
+					isInside = point.x() >= min.x() && point.x() <= max.x() && point.y() >= min.y() && point.y() <= max.y() &&
+					           point.z() >= min.z() && point.z() <= max.z();
+					break;
+				case RGL_REGION_SHAPE_CYLINDER: {
+					// Squared radii are compared, bounds are validated to be non-negative.
+					const float radiusSq = point.x() * point.x() + point.y() * point.y();
+					isInside = radiusSq >= min.x() * min.x() && radiusSq <= max.x() * max.x() && point.z() >= min.z() &&
+					           point.z() <= max.z();
+					break;
+				}
+				case RGL_REGION_SHAPE_DISTANCE_BAND: {
+					const float distanceSq = point.lengthSquared();
+					isInside = distanceSq >= min.x() * min.x() && distanceSq <= max.x() * max.x();
+					break;
+				}
+			}
+			if (isInside == region.exclude) {
+				return 0;
+			}
+		}
+		return 1;
+	}
+};
+
+template<rgl_field_t field>
+__device__ __forceinline__ double loadScalar(const char* data, Field<RAY_IDX_U32>::type pointIdx)
+{
+	return static_cast<double>(reinterpret_cast<const typename Field<field>::type*>(data)[pointIdx]);
+}
+
+// Fields are validated to be scalar (see isScalar) when predicates are set.
+__device__ double loadScalar(rgl_field_t field, const char* data, Field<RAY_IDX_U32>::type pointIdx)
+{
+	switch (field) {
+		case RAY_IDX_U32: return loadScalar<RAY_IDX_U32>(data, pointIdx);
+		case ENTITY_ID_I32: return loadScalar<ENTITY_ID_I32>(data, pointIdx);
+		case IS_HIT_I32: return loadScalar<IS_HIT_I32>(data, pointIdx);
+		case IS_GROUND_I32: return loadScalar<IS_GROUND_I32>(data, pointIdx);
+		case RING_ID_U16: return loadScalar<RING_ID_U16>(data, pointIdx);
+		case CLASS_ID_U16: return loadScalar<CLASS_ID_U16>(data, pointIdx);
+		case RETURN_TYPE_U8: return loadScalar<RETURN_TYPE_U8>(data, pointIdx);
+		case TIME_STAMP_F64: return loadScalar<TIME_STAMP_F64>(data, pointIdx);
+		case DISTANCE_F16:
+			return __half2float(__ushort_as_half(reinterpret_cast<const Field<DISTANCE_F16>::type*>(data)[pointIdx]));
+		default: return loadScalar<DISTANCE_F32>(data, pointIdx); // All the remaining scalar fields are floats
+	}
+}
+
+// Values of all scalar fields are exact in double, whose bits are mapped to integers ordered as the values:
+// the sign bit is flipped for non-negative values, all bits are flipped for negative ones.
+// Descending order is the reversed ascending one, so that the radix sort is the same (and stable) in both cases.
+// Spreads the lower 16 bits so that they occupy even bits.
+__device__ uint32_t spreadBits16(uint32_t v)
+{
+	v &= 0x0000FFFF;
+	v = (v | (v << 8)) & 0x00FF00FF;
+	v = (v | (v << 4)) & 0x0F0F0F0F;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+
+// Octahedral mapping folds the unit sphere onto a square, so that close directions map to close points of [-1, 1]^2.
+__global__ void kComputeRayDirectionKeys(size_t rayCount, const Mat3x4f* rays, const Vec3f* rayDirections, uint64_t* outKeys,
+                                         Field<RAY_IDX_U32>::type* outIndices)
+{
+	LIMIT(rayCount);
+	const Vec3f dir = rays != nullptr ? Vec3f{rays[tid].rc[0][2], rays[tid].rc[1][2], rays[tid].rc[2][2]} : rayDirections[tid];
+	const float norm = fabsf(dir.x()) + fabsf(dir.y()) + fabsf(dir.z());
+	float u = norm > 0.0f ? dir.x() / norm : 0.0f;
+	float v = norm > 0.0f ? dir.y() / norm : 0.0f;
+	if (dir.z() < 0.0f) {
+		const float foldedU = (1.0f - fabsf(v)) * copysignf(1.0f, u);
+		v = (1.0f - fabsf(u)) * copysignf(1.0f, v);
+		u = foldedU;
+	}
+	const auto quantize = [](float x) { return static_cast<uint32_t>(fminf(fmaxf((x + 1.0f) * 0.5f, 0.0f), 1.0f) * 65535.0f); };
+	outKeys[tid] = spreadBits16(quantize(u)) | (spreadBits16(quantize(v)) << 1);
+	outIndices[tid] = tid;
+}
+
+__global__ void kComputeRayTimeKeys(size_t rayCount, const float* rayTimeOffsets, uint64_t* outKeys,
+                                    Field<RAY_IDX_U32>::type* outIndices)
+{
+	LIMIT(rayCount);
+	const float timeOffset = rayTimeOffsets[tid];
+	const uint32_t bits = __float_as_uint(timeOffset == 0.0f ? 0.0f : timeOffset); // Negative zero is zero
+	outKeys[tid] = (bits >> 31) != 0 ? ~bits : bits | (1u << 31);
+	outIndices[tid] = tid;
+}
+
+__global__ void kComputeSortKeys(size_t pointCount, rgl_field_t keyField, const char* keyData, bool descending,
+                                 const Field<RAY_IDX_U32>::type* inputIndices, uint64_t* outKeys,
+                                 Field<RAY_IDX_U32>::type* outIndices)
+{
+	LIMIT(pointCount);
+	const double value = loadScalar(keyField, keyData, tid);
+	const auto bits = static_cast<uint64_t>(__double_as_longlong(value == 0.0 ? 0.0 : value)); // Negative zero is zero
+	const uint64_t key = (bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63);
+	outKeys[tid] = descending ? ~key : key;
+	outIndices[tid] = inputIndices != nullptr ? inputIndices[tid] : tid;
+}
+
+// Tells whether the point satisfies all (or any, if matchAny) predicates.
+struct FieldPredicatesPredicate
+{
+	const GPUFieldPredicate* predicates;
+	int32_t predicateCount;
+	bool matchAny;
+
+	__device__ int32_t operator()(Field<RAY_IDX_U32>::type pointIdx) const
+	{
+		for (int32_t i = 0; i < predicateCount; ++i) {
+			const GPUFieldPredicate& predicate = predicates[i];
+			const double value = loadScalar(predicate.field, predicate.data, pointIdx);
+			bool isSatisfied = false;
+			switch (predicate.comparison) {
+				case RGL_COMPARISON_EQUAL: isSatisfied = value == predicate.value; break;
+				case RGL_COMPARISON_NOT_EQUAL: isSatisfied = value != predicate.value; break;
+				case RGL_COMPARISON_LESS: isSatisfied = value < predicate.value; break;
+				case RGL_COMPARISON_LESS_EQUAL: isSatisfied = value <= predicate.value; break;
+				case RGL_COMPARISON_GREATER: isSatisfied = value > predicate.value; break;
+				case RGL_COMPARISON_GREATER_EQUAL: isSatisfied = value >= predicate.value; break;
+			}
+			if (isSatisfied == matchAny) {
+				return matchAny;
+			}
+		}
+		return !matchAny;
+	}
+};
+
+static auto makeFieldPredicateFlags(const GPUFieldPredicate* predicates, int32_t predicateCount, bool matchAny)
+{
+	return thrust::make_transform_iterator(thrust::counting_iterator<Field<RAY_IDX_U32>::type>(0),
+	                                       FieldPredicatesPredicate{predicates, predicateCount, matchAny});
+}
+
+static auto makeRegionFlags(const Field<XYZ_VEC3_F32>::type* points, const rgl_region_t* regions, int32_t regionCount)
+{
+	return thrust::make_transform_iterator(thrust::counting_iterator<Field<RAY_IDX_U32>::type>(0),
+	                                       RegionsPredicate{points, regions, regionCount});
+}
+
+size_t gpuFindCompactionTempStorageSize(size_t pointCount)
+{
+	return std::max({findCompactionTempStorageSize(pointCount, static_cast<const int32_t*>(nullptr)),
+	                 findCompactionTempStorageSize(pointCount, makeRegionFlags(nullptr, nullptr, 0)),
+	                 findCompactionTempStorageSize(pointCount, makeFieldPredicateFlags(nullptr, 0, false))});
+}
+
+void gpuFindCompaction(cudaStream_t stream, size_t pointCount, const int32_t* shouldSelect,
+                       const Field<RAY_IDX_U32>::type* inputIndices, Field<RAY_IDX_U32>::type* outIndices,
+                       uint32_t* outSelectedCount, void* tempStorage, size_t tempStorageSize)
+{
+	findCompaction(stream, pointCount, shouldSelect, inputIndices, outIndices, outSelectedCount, tempStorage, tempStorageSize);
+}
+
+void gpuFindCompactionByRegions(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                                const rgl_region_t* regions, int32_t regionCount, const Field<RAY_IDX_U32>::type* inputIndices,
+                                Field<RAY_IDX_U32>::type* outIndices, uint32_t* outSelectedCount, void* tempStorage,
+                                size_t tempStorageSize)
+{
+	findCompaction(stream, pointCount, makeRegionFlags(points, regions, regionCount), inputIndices, outIndices,
+	               outSelectedCount, tempStorage, tempStorageSize);
+}
+
+void gpuFindCompactionByPredicates(cudaStream_t stream, size_t pointCount, const GPUFieldPredicate* predicates,
+                                   int32_t predicateCount, bool matchAny, const Field<RAY_IDX_U32>::type* inputIndices,
+                                   Field<RAY_IDX_U32>::type* outIndices, uint32_t* outSelectedCount, void* tempStorage,
+                                   size_t tempStorageSize)
+{
+	findCompaction(stream, pointCount, makeFieldPredicateFlags(predicates, predicateCount, matchAny), inputIndices, outIndices,
+	               outSelectedCount, tempStorage, tempStorageSize);
+}
+
+void gpuComputeSortKeys(cudaStream_t stream, size_t pointCount, rgl_field_t keyField, const void* keyData, bool descending,
+                        const Field<RAY_IDX_U32>::type* inputIndices, uint64_t* outKeys, Field<RAY_IDX_U32>::type* outIndices)
+{
+	run(kComputeSortKeys, stream, pointCount, keyField, static_cast<const char*>(keyData), descending, inputIndices, outKeys,
+	    outIndices);
+}
+
+void gpuComputeRayDirectionKeys(cudaStream_t stream, size_t rayCount, const Mat3x4f* rays, const Vec3f* rayDirections,
+                                uint64_t* outKeys, Field<RAY_IDX_U32>::type* outIndices)
+{
+	run(kComputeRayDirectionKeys, stream, rayCount, rays, rayDirections, outKeys, outIndices);
+}
+
+void gpuComputeRayTimeKeys(cudaStream_t stream, size_t rayCount, const float* rayTimeOffsets, uint64_t* outKeys,
+                           Field<RAY_IDX_U32>::type* outIndices)
+{
+	run(kComputeRayTimeKeys, stream, rayCount, rayTimeOffsets, outKeys, outIndices);
+}
+
+void gpuFormatSoaToAos(cudaStream_t stream, size_t pointCount, const uint32_t* devicePointCount, size_t pointSize,
+                       size_t fieldCount, const GPUFieldDescs& soaInData, char* aosOutData, int transformedFieldIdx,
+                       Mat3x4f xyzTransform)
+{
+	run(kFormatSoaToAos, stream, pointCount, devicePointCount, pointSize, fieldCount, soaInData, aosOutData,
+	    transformedFieldIdx, xyzTransform);
+}
+
+void gpuFormatSoaToAosGathered(cudaStream_t stream, size_t pointCount, const uint32_t* devicePointCount, size_t pointSize,
+                               size_t fieldCount, const GPUFieldDescs& soaInData, const Field<RAY_IDX_U32>::type* indices,
+                               char* aosOutData)
+{
+	run(kFormatSoaToAosGathered, stream, pointCount, devicePointCount, pointSize, fieldCount, soaInData, indices, aosOutData);
 }
 
 void gpuFormatAosToSoa(cudaStream_t stream, size_t pointCount, size_t pointSize, size_t fieldCount, const char* aosInData,
-                       const GPUFieldDesc* soaOutData)
+                       const GPUFieldDescs& soaOutData)
 {
 	run(kFormatAosToSoa, stream, pointCount, pointSize, fieldCount, aosInData, soaOutData);
 }
@@ -255,28 +1723,117 @@ void gpuTransformRays(cudaStream_t stream, size_t rayCount, const Mat3x4f* inRay
 	run(kTransformRays, stream, rayCount, inRays, outRays, transform);
 };
 
-void gpuApplyCompaction(cudaStream_t stream, size_t pointCount, size_t fieldSize, const int* shouldWrite,
-                        const CompactionIndexType* writeIndex, char* dst, const char* src)
+void gpuMakeLineSegments(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, const Vec3f* vectors,
+                         double* outSegmentPoints)
+{
+	run(kMakeLineSegments, stream, pointCount, points, vectors, outSegmentPoints);
+}
+
+void gpuColorizeByHeight(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, float heightPeriod,
+                         uint32_t* outColors)
+{
+	run(kColorizeByHeight, stream, pointCount, points, heightPeriod, outColors);
+}
+
+void gpuGenerateRaysFromPattern(cudaStream_t stream, size_t ringCount, size_t azimuthStepCount, const float* ringElevations,
+                                const float* ringTimeOffsets, float azimuthStart, float azimuthStep, float azimuthStepTime,
+                                Mat3x4f* outRays, int* outRingIds, float* outTimeOffsets)
+{
+	run(kGenerateRaysFromPattern, stream, ringCount * azimuthStepCount, azimuthStepCount, ringElevations, ringTimeOffsets,
+	    azimuthStart, azimuthStep, azimuthStepTime, outRays, outRingIds, outTimeOffsets);
+}
+
+void gpuComputeVoxelKeys(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, Vec3f leafDims,
+                         const Field<RAY_IDX_U32>::type* inputIndices, uint64_t* outKeys,
+                         Field<RAY_IDX_U32>::type* outIndices)
+{
+	run(kComputeVoxelKeys, stream, pointCount, points, leafDims, inputIndices, outKeys, outIndices);
+}
+
+size_t gpuSortVoxelKeysTempStorageSize(size_t pointCount)
+{
+	size_t tempStorageSize = 0;
+	CHECK_CUDA(cub::DeviceRadixSort::SortPairs(nullptr, tempStorageSize, static_cast<const uint64_t*>(nullptr),
+	                                           static_cast<uint64_t*>(nullptr),
+	                                           static_cast<const Field<RAY_IDX_U32>::type*>(nullptr),
+	                                           static_cast<Field<RAY_IDX_U32>::type*>(nullptr), static_cast<int>(pointCount)));
+	return tempStorageSize;
+}
+
+void gpuSortVoxelKeys(cudaStream_t stream, size_t pointCount, const uint64_t* keys, uint64_t* sortedKeys,
+                      const Field<RAY_IDX_U32>::type* indices, Field<RAY_IDX_U32>::type* sortedIndices, void* tempStorage,
+                      size_t tempStorageSize)
+{
+	// Radix sort is stable, so points of a voxel keep their order.
+	CHECK_CUDA(cub::DeviceRadixSort::SortPairs(tempStorage, tempStorageSize, keys, sortedKeys, indices, sortedIndices,
+	                                           static_cast<int>(pointCount), 0, 64, stream));
+}
+
+void gpuMarkFirstInVoxel(cudaStream_t stream, size_t pointCount, const uint64_t* sortedKeys, int32_t* outIsFirst)
+{
+	run(kMarkFirstInVoxel, stream, pointCount, sortedKeys, outIsFirst);
+}
+
+void gpuEstimateNormalsOrganized(cudaStream_t stream, size_t width, size_t height, int32_t windowRadius, float radius,
+                                 const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit, Vec3f viewpoint,
+                                 Field<NORMAL_VEC3_F32>::type* outNormals, Field<CURVATURE_F32>::type* outCurvatures)
+{
+	run(kEstimateNormalsOrganized, stream, width * height, width, height, windowRadius, radius, points, isHit, viewpoint,
+	    outNormals, outCurvatures);
+}
+
+void gpuEstimateNormalsHashed(cudaStream_t stream, size_t pointCount, float radius, const Field<XYZ_VEC3_F32>::type* points,
+                              const Field<IS_HIT_I32>::type* isHit, const uint64_t* sortedCellKeys,
+                              const Field<RAY_IDX_U32>::type* sortedIndices, Vec3f viewpoint,
+                              Field<NORMAL_VEC3_F32>::type* outNormals, Field<CURVATURE_F32>::type* outCurvatures)
+{
+	run(kEstimateNormalsHashed, stream, pointCount, radius, points, isHit, sortedCellKeys, sortedIndices,
+	    viewpoint, outNormals, outCurvatures);
+}
+
+void gpuQueryNearestPoints(cudaStream_t stream, size_t queryCount, const Vec3f* queries, float cellSize, float maxDistance,
+                           size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit,
+                           const uint64_t* sortedCellKeys, const Field<RAY_IDX_U32>::type* sortedIndices, int32_t* outIndices,
+                           float* outDistances)
 {
-	run(kApplyCompaction, stream, pointCount, fieldSize, shouldWrite, writeIndex, dst, src);
+	run(kQueryNearestPoints, stream, queryCount, queries, cellSize, maxDistance, pointCount, points, isHit, sortedCellKeys,
+	    sortedIndices, outIndices, outDistances);
 }
 
-void gpuTransformPoints(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* inPoints,
-                        Field<XYZ_VEC3_F32>::type* outPoints, Mat3x4f transform)
+void gpuQueryRadiusPoints(cudaStream_t stream, size_t queryCount, const Vec3f* queries, float cellSize, float radius,
+                          int32_t maxNeighbourCount, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                          const Field<IS_HIT_I32>::type* isHit, const uint64_t* sortedCellKeys,
+                          const Field<RAY_IDX_U32>::type* sortedIndices, int32_t* outIndices, int32_t* outCounts)
 {
-	run(kTransformPoints, stream, pointCount, inPoints, outPoints, transform);
+	run(kQueryRadiusPoints, stream, queryCount, queries, cellSize, radius, maxNeighbourCount, pointCount, points, isHit,
+	    sortedCellKeys, sortedIndices, outIndices, outCounts);
+}
+
+void gpuMergePoints(cudaStream_t stream, size_t pointCount, size_t inputCount, size_t fieldCount, const GPUMergeDesc* descs)
+{
+	run(kMergePoints, stream, pointCount, inputCount, fieldCount, descs);
+}
+
+void gpuTransformPoints(cudaStream_t stream, size_t pointCount, const uint32_t* devicePointCount,
+                        const Field<XYZ_VEC3_F32>::type* inPoints, Field<XYZ_VEC3_F32>::type* outPoints, Mat3x4f transform)
+{
+	run(kTransformPoints, stream, pointCount, devicePointCount, inPoints, outPoints, transform);
 }
 
 void gpuCutField(cudaStream_t stream, size_t pointCount, char* dst, const char* src, size_t offset, size_t stride,
                  size_t fieldSize)
 {
-	run(kCutField, stream, pointCount, dst, src, offset, stride, fieldSize);
+	dispatchFieldSize(fieldSize, [&](auto size) {
+		run(kCutField<decltype(size)::value>, stream, pointCount, dst, src, offset, stride, fieldSize);
+	});
 }
 
-void gpuFilter(cudaStream_t stream, size_t count, const Field<RAY_IDX_U32>::type* indices, char* dst, const char* src,
-               size_t fieldSize)
+void gpuFilter(cudaStream_t stream, size_t count, const uint32_t* deviceCount, const Field<RAY_IDX_U32>::type* indices,
+               char* dst, const char* src, size_t fieldSize)
 {
-	run(kFilter, stream, count, indices, dst, src, fieldSize);
+	dispatchFieldSize(fieldSize, [&](auto size) {
+		run(kFilter<decltype(size)::value>, stream, count, deviceCount, indices, dst, src, fieldSize);
+	});
 }
 
 void gpuFilterGroundPoints(cudaStream_t stream, size_t pointCount, const Vec3f sensor_up_vector, float ground_angle_threshold,
@@ -287,6 +1844,229 @@ void gpuFilterGroundPoints(cudaStream_t stream, size_t pointCount, const Vec3f s
 	    lidarTransform);
 }
 
+void gpuRadarInitClusters(cudaStream_t stream, size_t pointCount, const Field<DISTANCE_F32>::type* distance,
+                          const Field<AZIMUTH_F32>::type* azimuth, const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                          size_t scopeCount, const rgl_radar_scope_t* scopes, int32_t* outScopeIndices, uint32_t* outParents,
+                          uint64_t* outCellKeys, Field<RAY_IDX_U32>::type* outIndices)
+{
+	run(kRadarInitClusters, stream, pointCount, distance, azimuth, radialSpeed, scopeCount, scopes, outScopeIndices, outParents,
+	    outCellKeys, outIndices);
+}
+
+void gpuRadarUniteClusters(cudaStream_t stream, size_t pointCount, const uint64_t* sortedCellKeys,
+                           const Field<RAY_IDX_U32>::type* sortedIndices, const Field<DISTANCE_F32>::type* distance,
+                           const Field<AZIMUTH_F32>::type* azimuth, const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                           size_t scopeCount, const rgl_radar_scope_t* scopes, const int32_t* scopeIndices,
+                           uint32_t* parents)
+{
+	run(kRadarUniteClusters, stream, pointCount, sortedCellKeys, sortedIndices, distance, azimuth, radialSpeed, scopeCount,
+	    scopes, scopeIndices, parents);
+}
+
+void gpuRadarFindClusterRoots(cudaStream_t stream, size_t pointCount, const int32_t* scopeIndices, uint32_t* parents,
+                              int32_t* outIsRoot)
+{
+	run(kRadarFindClusterRoots, stream, pointCount, scopeIndices, parents, outIsRoot);
+}
+
+void gpuRadarComputeClusterKeys(cudaStream_t stream, size_t pointCount, const uint32_t* clusterCount,
+                                const Field<RAY_IDX_U32>::type* clusterRoots, const int32_t* scopeIndices,
+                                const uint32_t* parents, uint32_t* clusterIdOfRoot, uint64_t* outKeys,
+                                Field<RAY_IDX_U32>::type* outIndices)
+{
+	run(kRadarScatterClusterIds, stream, pointCount, clusterCount, clusterRoots, clusterIdOfRoot);
+	run(kRadarComputeClusterKeys, stream, pointCount, scopeIndices, parents, clusterIdOfRoot, outKeys, outIndices);
+}
+
+void gpuRadarReduceClusters(cudaStream_t stream, size_t clusterCount, size_t pointCount, const uint64_t* sortedClusterKeys,
+                            const Field<RAY_IDX_U32>::type* sortedPointIndices, const Field<DISTANCE_F32>::type* distance,
+                            const Field<AZIMUTH_F32>::type* azimuth, const Field<ELEVATION_F32>::type* elevation,
+                            const Vector<3, thrust::complex<float>>* bubrFactor, float powerBaseDbm,
+                            float noiseMeanDb, float noiseStDevDb, uint64_t noiseSeed, uint64_t noiseFrame,
+                            Field<RAY_IDX_U32>::type* outCenterIndices, Field<RCS_F32>::type* outRcs,
+                            Field<POWER_F32>::type* outPower, Field<NOISE_F32>::type* outNoise, Field<SNR_F32>::type* outSnr)
+{
+	run(kRadarReduceClusters, stream, clusterCount, pointCount, sortedClusterKeys, sortedPointIndices, distance, azimuth,
+	    elevation, bubrFactor, powerBaseDbm, noiseMeanDb, noiseStDevDb, noiseSeed, noiseFrame, outCenterIndices, outRcs,
+	    outPower, outNoise, outSnr);
+}
+
+void gpuRadarComputeEchoes(cudaStream_t stream, size_t pointCount, const Field<DISTANCE_F32>::type* distance,
+                           const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                           const Vector<3, thrust::complex<float>>* bubrFactor, float amplitudeBase, float rangeBinsPerMeter,
+                           float dopplerCyclesPerSpeed, float maxDistance, RadarEcho* outEchoes)
+{
+	run(kRadarComputeEchoes, stream, pointCount, distance, radialSpeed, bubrFactor, amplitudeBase, rangeBinsPerMeter,
+	    dopplerCyclesPerSpeed, maxDistance, outEchoes);
+}
+
+void gpuRadarSynthesizeBeatSignal(cudaStream_t stream, size_t echoCount, const RadarEcho* echoes, int samplesPerChirp,
+                                  int chirpCount, float noiseAmplitude, uint64_t noiseSeed, uint64_t noiseFrame,
+                                  thrust::complex<float>* outSignal)
+{
+	run(kRadarSynthesizeBeatSignal, stream, static_cast<size_t>(samplesPerChirp) * chirpCount, echoCount, echoes,
+	    samplesPerChirp, chirpCount, noiseAmplitude, noiseSeed, noiseFrame, outSignal);
+}
+
+void gpuRadarRangeDopplerCfar(cudaStream_t stream, int samplesPerChirp, int chirpCount, const thrust::complex<float>* spectrum,
+                              float powerScale, float rangeBinSize, float speedBinSize, int guardCells, int trainingCells,
+                              float thresholdRatio, Field<DISTANCE_F32>::type* outDistance,
+                              Field<RADIAL_SPEED_F32>::type* outRadialSpeed, Field<POWER_F32>::type* outPower,
+                              Field<NOISE_F32>::type* outNoise, Field<SNR_F32>::type* outSnr,
+                              Field<IS_HIT_I32>::type* outIsDetection)
+{
+	run(kRadarRangeDopplerCfar, stream, static_cast<size_t>(samplesPerChirp) * chirpCount, samplesPerChirp, chirpCount,
+	    spectrum, powerScale, rangeBinSize, speedBinSize, guardCells, trainingCells, thresholdRatio, outDistance,
+	    outRadialSpeed, outPower, outNoise, outSnr, outIsDetection);
+}
+
+void gpuFitGroundPlane(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, Vec3f upVector,
+                       float groundAngleThreshold, float groundDistanceThreshold, size_t hypothesisCount,
+                       Vec4f* hypothesisPlanes, int32_t* hypothesisInlierCounts, Vec4f* outPlane, int32_t* outInlierCount)
+{
+	kEvaluateGroundPlaneHypotheses<<<hypothesisCount, GROUND_PLANE_BLOCK_SIZE, 0, stream>>>(
+	    pointCount, points, upVector.normalized(), cosf(groundAngleThreshold), groundDistanceThreshold, hypothesisPlanes,
+	    hypothesisInlierCounts);
+	CHECK_CUDA(cudaGetLastError());
+	kSelectBestGroundPlane<<<1, GROUND_PLANE_BLOCK_SIZE, 0, stream>>>(hypothesisCount, hypothesisPlanes, hypothesisInlierCounts,
+	                                                                  outPlane, outInlierCount);
+	CHECK_CUDA(cudaGetLastError());
+}
+
+void gpuMarkGroundPlanePoints(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                              const Vec4f* plane, const int32_t* planeInlierCount, float groundFilterDistance,
+                              Field<IS_GROUND_I32>::type* outNonGround)
+{
+	run(kMarkGroundPlanePoints, stream, pointCount, points, plane, planeInlierCount, groundFilterDistance, outNonGround);
+}
+
+void gpuMakeRangeImage(cudaStream_t stream, size_t pointCount, const uint32_t* devicePointCount,
+                       const Field<IS_HIT_I32>::type* isHit, const Field<RING_ID_U16>::type* ringIds,
+                       const Field<AZIMUTH_F32>::type* azimuths, const Field<DISTANCE_F32>::type* distances,
+                       const Field<INTENSITY_F32>::type* intensities, const Field<ENTITY_ID_I32>::type* entityIds,
+                       int32_t height, int32_t width, float azimuthMin, float azimuthMax, uint64_t* pixelKeys,
+                       Field<IS_HIT_I32>::type* outIsHit, Field<DISTANCE_F32>::type* outDistances,
+                       Field<INTENSITY_F32>::type* outIntensities, Field<ENTITY_ID_I32>::type* outEntityIds)
+{
+	static_assert(sizeof(uint64_t) == sizeof(unsigned long long));
+	auto* keys = reinterpret_cast<unsigned long long*>(pixelKeys);
+	size_t pixelCount = static_cast<size_t>(height) * width;
+	CHECK_CUDA(cudaMemsetAsync(keys, 0xFF, pixelCount * sizeof(*keys), stream)); // All keys are ULLONG_MAX (empty pixels)
+	if (pointCount > 0) {
+		run(kScatterRangeImage, stream, pointCount, devicePointCount, isHit, ringIds, azimuths, distances, height, width,
+		    azimuthMin, azimuthMax, keys);
+	}
+	run(kGatherRangeImage, stream, pixelCount, keys, distances, intensities, entityIds, outIsHit, outDistances, outIntensities,
+	    outEntityIds);
+}
+
+void gpuClearOccupancyGrid(cudaStream_t stream, size_t cellCount, rgl_occupancy_cell_t* cells)
+{
+	run(kClearOccupancyGrid, stream, cellCount, cells);
+}
+
+void gpuAccumulateOccupancyGrid(cudaStream_t stream, size_t pointCount, const uint32_t* devicePointCount,
+                                const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit, Vec3f gridMin,
+                                Vec3f cellSize, Vec3i gridSize, bool castRays, Vec3f rayOrigin, rgl_occupancy_cell_t* cells)
+{
+	if (pointCount == 0) {
+		return;
+	}
+	run(kAccumulateOccupancyGrid, stream, pointCount, devicePointCount, points, isHit, gridMin, cellSize, gridSize, castRays,
+	    rayOrigin, cells);
+}
+
+void gpuEuclideanInitClusters(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                              const Field<IS_HIT_I32>::type* isHit, float tolerance, uint32_t* outParents,
+                              uint64_t* outCellKeys, Field<RAY_IDX_U32>::type* outIndices)
+{
+	run(kEuclideanInitClusters, stream, pointCount, points, isHit, tolerance, outParents, outCellKeys, outIndices);
+}
+
+void gpuEuclideanUniteClusters(cudaStream_t stream, size_t pointCount, float tolerance, const Field<XYZ_VEC3_F32>::type* points,
+                               const uint64_t* sortedCellKeys, const Field<RAY_IDX_U32>::type* sortedIndices,
+                               uint32_t* parents)
+{
+	run(kEuclideanUniteClusters, stream, pointCount, tolerance, points, sortedCellKeys, sortedIndices, parents);
+}
+
+void gpuEuclideanFindClusterRoots(cudaStream_t stream, size_t pointCount, const uint64_t* cellKeys, uint32_t minClusterSize,
+                                  uint32_t maxClusterSize, uint32_t* parents, uint32_t* clusterSizes, int32_t* outIsRoot)
+{
+	CHECK_CUDA(cudaMemsetAsync(clusterSizes, 0, pointCount * sizeof(*clusterSizes), stream));
+	run(kEuclideanFindClusterRoots, stream, pointCount, cellKeys, parents, clusterSizes);
+	run(kEuclideanMarkClusterRoots, stream, pointCount, cellKeys, parents, clusterSizes, minClusterSize, maxClusterSize,
+	    outIsRoot);
+}
+
+void gpuEuclideanWriteClusterIds(cudaStream_t stream, size_t pointCount, const uint32_t* clusterCount,
+                                 const Field<RAY_IDX_U32>::type* clusterRoots, const uint32_t* parents,
+                                 Field<CLUSTER_ID_I32>::type* clusterIdOfRoot, Field<CLUSTER_ID_I32>::type* outClusterIds)
+{
+	CHECK_CUDA(cudaMemsetAsync(clusterIdOfRoot, 0xFF, pointCount * sizeof(*clusterIdOfRoot), stream)); // All ids are -1
+	run(kEuclideanScatterClusterIds, stream, pointCount, clusterCount, clusterRoots, clusterIdOfRoot);
+	run(kEuclideanWriteClusterIds, stream, pointCount, parents, clusterIdOfRoot, outClusterIds);
+}
+
+void gpuFindMaxClusterId(cudaStream_t stream, size_t pointCount, const Field<CLUSTER_ID_I32>::type* clusterIds,
+                         int32_t* outMaxClusterId)
+{
+	CHECK_CUDA(cudaMemsetAsync(outMaxClusterId, 0xFF, sizeof(*outMaxClusterId), stream)); // -1 if there are no clusters
+	run(kFindMaxClusterId, stream, pointCount, clusterIds, outMaxClusterId);
+}
+
+void gpuComputeClusterBoxes(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                            const Field<CLUSTER_ID_I32>::type* clusterIds, size_t clusterCount, rgl_cluster_box_t* outBoxes)
+{
+	run(kClearClusterBoxes, stream, clusterCount, outBoxes);
+	run(kAccumulateClusterBoxes, stream, pointCount, points, clusterIds, clusterCount, outBoxes);
+}
+
+size_t gpuCompressedBlockCount(size_t pointCount)
+{
+	return (pointCount + COMPRESSION_BLOCK_SIZE - 1) / COMPRESSION_BLOCK_SIZE;
+}
+
+size_t gpuScanCompressedBlockSizesTempStorageSize(size_t blockCount)
+{
+	size_t tempStorageSize = 0;
+	CHECK_CUDA(cub::DeviceScan::ExclusiveSum(nullptr, tempStorageSize, static_cast<const uint32_t*>(nullptr),
+	                                         static_cast<uint32_t*>(nullptr), static_cast<int>(blockCount + 1)));
+	return tempStorageSize;
+}
+
+void gpuEncodeCompressedBlocks(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, float xyzStep,
+                               Vector<3, uint32_t>* outDeltas, rgl_compressed_block_header_t* outHeaders,
+                               uint32_t* outBlockSizes)
+{
+	size_t blockCount = gpuCompressedBlockCount(pointCount);
+	if (blockCount == 0) {
+		return;
+	}
+	kEncodeCompressedBlocks<<<blockCount, COMPRESSION_BLOCK_SIZE, 0, stream>>>(pointCount, points, xyzStep, outDeltas,
+	                                                                           outHeaders, outBlockSizes);
+	CHECK_CUDA(cudaGetLastError());
+}
+
+void gpuScanCompressedBlockSizes(cudaStream_t stream, size_t blockCount, const uint32_t* blockSizes, uint32_t* outOffsets,
+                                 void* tempStorage, size_t tempStorageSize)
+{
+	CHECK_CUDA(cub::DeviceScan::ExclusiveSum(tempStorage, tempStorageSize, blockSizes, outOffsets,
+	                                         static_cast<int>(blockCount + 1), stream));
+}
+
+void gpuPackCompressedBlocks(cudaStream_t stream, size_t pointCount, const Vector<3, uint32_t>* deltas,
+                             const rgl_compressed_block_header_t* headers, const uint32_t* blockOffsets, char* outBlocks)
+{
+	size_t blockCount = gpuCompressedBlockCount(pointCount);
+	if (blockCount == 0) {
+		return;
+	}
+	kPackCompressedBlocks<<<blockCount, COMPRESSION_BLOCK_SIZE, 0, stream>>>(pointCount, deltas, headers, blockOffsets,
+	                                                                         outBlocks);
+	CHECK_CUDA(cudaGetLastError());
+}
+
 void gpuRadarComputeEnergy(cudaStream_t stream, size_t count, float rayAzimuthStepRad, float rayElevationStepRad, float freq,
                            Mat3x4f lookAtOriginTransform, const Field<RAY_POSE_MAT3x4_F32>::type* rayPose,
                            const Field<DISTANCE_F32>::type* hitDist, const Field<NORMAL_VEC3_F32>::type* hitNorm,
@@ -27,27 +27,198 @@
  * The following functions are asynchronous!
  */
 
-// This could be defined in CompactNode, however such include here causes mess because nvcc does not support C++20.
-using CompactionIndexType = int32_t;
-
-void gpuFindCompaction(cudaStream_t, size_t pointCount, const int32_t* shouldCompact, CompactionIndexType* hitCountInclusive,
-                       size_t* outHitCount);
-void gpuFormatSoaToAos(cudaStream_t, size_t pointCount, size_t pointSize, size_t fieldCount, const GPUFieldDesc* soaInData,
-                       char* aosOutData);
+// Selects (in a single pass) indices of points with non-zero shouldSelect, composed with inputIndices, if not null.
+// outIndices must fit pointCount elements; the number of selected points is written to device memory (outSelectedCount).
+// Temporary storage is provided by the caller, its required size is given by gpuFindCompactionTempStorageSize().
+size_t gpuFindCompactionTempStorageSize(size_t pointCount);
+void gpuFindCompaction(cudaStream_t, size_t pointCount, const int32_t* shouldSelect,
+                       const Field<RAY_IDX_U32>::type* inputIndices, Field<RAY_IDX_U32>::type* outIndices,
+                       uint32_t* outSelectedCount, void* tempStorage, size_t tempStorageSize);
+// As above, but selects points satisfying all (or any, if matchAny) predicates, evaluated during the same pass.
+void gpuFindCompactionByPredicates(cudaStream_t, size_t pointCount, const GPUFieldPredicate* predicates, int32_t predicateCount,
+                                   bool matchAny, const Field<RAY_IDX_U32>::type* inputIndices,
+                                   Field<RAY_IDX_U32>::type* outIndices, uint32_t* outSelectedCount, void* tempStorage,
+                                   size_t tempStorageSize);
+// As above, but selects points satisfying all regions (see rgl_region_t), evaluated on points during the same pass.
+void gpuFindCompactionByRegions(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                                const rgl_region_t* regions, int32_t regionCount, const Field<RAY_IDX_U32>::type* inputIndices,
+                                Field<RAY_IDX_U32>::type* outIndices, uint32_t* outSelectedCount, void* tempStorage,
+                                size_t tempStorageSize);
+// Functions taking devicePointCount (or deviceCount) launch work for pointCount (count) elements,
+// but process only the number of them given in device memory, if the pointer is not null.
+// The field at transformedFieldIdx (XYZ_VEC3_F32, if not negative) is transformed by xyzTransform.
+void gpuFormatSoaToAos(cudaStream_t, size_t pointCount, const uint32_t* devicePointCount, size_t pointSize, size_t fieldCount,
+                       const GPUFieldDescs& soaInData, char* aosOutData, int transformedFieldIdx, Mat3x4f xyzTransform);
+// Formats points given by indices (e.g. a selection made by compaction), without materializing selected fields.
+void gpuFormatSoaToAosGathered(cudaStream_t, size_t pointCount, const uint32_t* devicePointCount, size_t pointSize,
+                               size_t fieldCount, const GPUFieldDescs& soaInData, const Field<RAY_IDX_U32>::type* indices,
+                               char* aosOutData);
 void gpuFormatAosToSoa(cudaStream_t, size_t pointCount, size_t pointSize, size_t fieldCount, const char* aosInData,
-                       const GPUFieldDesc* soaOutData);
+                       const GPUFieldDescs& soaOutData);
 void gpuTransformRays(cudaStream_t, size_t rayCount, const Mat3x4f* inRays, Mat3x4f* outRays, Mat3x4f transform);
-void gpuApplyCompaction(cudaStream_t, size_t pointCount, size_t fieldSize, const int* shouldWrite,
-                        const CompactionIndexType* writeIndex, char* dst, const char* src);
-void gpuTransformPoints(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* inPoints,
-                        Field<XYZ_VEC3_F32>::type* outPoints, Mat3x4f transform);
+// Writes line segments from points along vectors (e.g. velocities) as pairs of double-precision points (x, y, z),
+// which is the layout of geometry_msgs/Point lists.
+void gpuMakeLineSegments(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, const Vec3f* vectors,
+                         double* outSegmentPoints);
+// Writes RGBA8 colors of points, mapping their heights (Z) to a blue-green-red scale repeated every heightPeriod.
+void gpuColorizeByHeight(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, float heightPeriod,
+                         uint32_t* outColors);
+// Generates rays, ring ids and time offsets of a (azimuthStepCount x ringCount) row-major pattern.
+void gpuGenerateRaysFromPattern(cudaStream_t, size_t ringCount, size_t azimuthStepCount, const float* ringElevations,
+                                const float* ringTimeOffsets, float azimuthStart, float azimuthStep, float azimuthStepTime,
+                                Mat3x4f* outRays, int* outRingIds, float* outTimeOffsets);
+// Voxel downsampling: points are sorted by keys of their voxels, then the first point of each voxel is selected
+// (with gpuFindCompaction() using isFirst as shouldSelect), which gives indices of points (composed with inputIndices).
+void gpuComputeVoxelKeys(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, Vec3f leafDims,
+                         const Field<RAY_IDX_U32>::type* inputIndices, uint64_t* outKeys, Field<RAY_IDX_U32>::type* outIndices);
+size_t gpuSortVoxelKeysTempStorageSize(size_t pointCount);
+void gpuSortVoxelKeys(cudaStream_t, size_t pointCount, const uint64_t* keys, uint64_t* sortedKeys,
+                      const Field<RAY_IDX_U32>::type* indices, Field<RAY_IDX_U32>::type* sortedIndices, void* tempStorage,
+                      size_t tempStorageSize);
+void gpuMarkFirstInVoxel(cudaStream_t, size_t pointCount, const uint64_t* sortedKeys, int32_t* outIsFirst);
+// Normal estimation: PCA of neighbours within the radius, oriented towards the viewpoint; NaNs if there are too few neighbours.
+// Neighbours are searched in the window of rows/columns of organized point cloud, or in the grid cells (of the radius size)
+// around the point, given by keys and indices sorted with gpuSortVoxelKeys. Points not hit (if isHit is given) are skipped.
+void gpuEstimateNormalsOrganized(cudaStream_t, size_t width, size_t height, int32_t windowRadius, float radius,
+                                 const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit, Vec3f viewpoint,
+                                 Field<NORMAL_VEC3_F32>::type* outNormals, Field<CURVATURE_F32>::type* outCurvatures);
+void gpuEstimateNormalsHashed(cudaStream_t, size_t pointCount, float radius, const Field<XYZ_VEC3_F32>::type* points,
+                              const Field<IS_HIT_I32>::type* isHit, const uint64_t* sortedCellKeys,
+                              const Field<RAY_IDX_U32>::type* sortedIndices, Vec3f viewpoint,
+                              Field<NORMAL_VEC3_F32>::type* outNormals, Field<CURVATURE_F32>::type* outCurvatures);
+// Spatial index: keys of grid cells (of the cellSize) sorted with gpuSortVoxelKeys are searched for points near queries,
+// skipping points not hit (if isHit is given). Missing results are -1 (and infinite distances).
+void gpuQueryNearestPoints(cudaStream_t, size_t queryCount, const Vec3f* queries, float cellSize, float maxDistance,
+                           size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit,
+                           const uint64_t* sortedCellKeys, const Field<RAY_IDX_U32>::type* sortedIndices, int32_t* outIndices,
+                           float* outDistances);
+void gpuQueryRadiusPoints(cudaStream_t, size_t queryCount, const Vec3f* queries, float cellSize, float radius,
+                          int32_t maxNeighbourCount, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                          const Field<IS_HIT_I32>::type* isHit, const uint64_t* sortedCellKeys,
+                          const Field<RAY_IDX_U32>::type* sortedIndices, int32_t* outIndices, int32_t* outCounts);
+// Sorting by a scalar field: keys ordered as the field values (reversely, if descending) are sorted with gpuSortVoxelKeys,
+// which gives indices of points (composed with inputIndices) in the stable order of values.
+void gpuComputeSortKeys(cudaStream_t, size_t pointCount, rgl_field_t keyField, const void* keyData, bool descending,
+                        const Field<RAY_IDX_U32>::type* inputIndices, uint64_t* outKeys, Field<RAY_IDX_U32>::type* outIndices);
+// Ray coherence sorting: keys are Morton codes of octahedral-mapped directions of rays (given by transforms or directions),
+// sorted with gpuSortVoxelKeys into the launch order of rays, so that neighbouring launch indices trace similar directions.
+void gpuComputeRayDirectionKeys(cudaStream_t, size_t rayCount, const Mat3x4f* rays, const Vec3f* rayDirections,
+                                uint64_t* outKeys, Field<RAY_IDX_U32>::type* outIndices);
+// Keys ordered as time offsets of rays, sorted with gpuSortVoxelKeys into the launch order of time-sliced traces.
+void gpuComputeRayTimeKeys(cudaStream_t, size_t rayCount, const float* rayTimeOffsets, uint64_t* outKeys,
+                           Field<RAY_IDX_U32>::type* outIndices);
+// Merges pointCount points of all fields and inputs in one launch; descs are grouped by field (fieldCount x inputCount).
+void gpuMergePoints(cudaStream_t, size_t pointCount, size_t inputCount, size_t fieldCount, const GPUMergeDesc* descs);
+void gpuTransformPoints(cudaStream_t, size_t pointCount, const uint32_t* devicePointCount,
+                        const Field<XYZ_VEC3_F32>::type* inPoints, Field<XYZ_VEC3_F32>::type* outPoints, Mat3x4f transform);
+// Scatters hit points into a height x width image (rows given by ring ids, columns by azimuths in [azimuthMin, azimuthMax)),
+// keeping the nearest point in each pixel. Channels of empty pixels are zeroed. Intensities and entity ids may be null.
+void gpuMakeRangeImage(cudaStream_t, size_t pointCount, const uint32_t* devicePointCount, const Field<IS_HIT_I32>::type* isHit,
+                       const Field<RING_ID_U16>::type* ringIds, const Field<AZIMUTH_F32>::type* azimuths,
+                       const Field<DISTANCE_F32>::type* distances, const Field<INTENSITY_F32>::type* intensities,
+                       const Field<ENTITY_ID_I32>::type* entityIds, int32_t height, int32_t width, float azimuthMin,
+                       float azimuthMax, uint64_t* pixelKeys, Field<IS_HIT_I32>::type* outIsHit,
+                       Field<DISTANCE_F32>::type* outDistances, Field<INTENSITY_F32>::type* outIntensities,
+                       Field<ENTITY_ID_I32>::type* outEntityIds);
+// Sets all cells of the grid to the empty state, see rgl_occupancy_cell_t.
+void gpuClearOccupancyGrid(cudaStream_t, size_t cellCount, rgl_occupancy_cell_t* cells);
+// Adds hit points (all points, if isHit is null) to the grid of gridSize cells spanned from gridMin.
+// If castRays, miss counts are incremented along the segments from rayOrigin to points.
+void gpuAccumulateOccupancyGrid(cudaStream_t, size_t pointCount, const uint32_t* devicePointCount,
+                                const Field<XYZ_VEC3_F32>::type* points, const Field<IS_HIT_I32>::type* isHit, Vec3f gridMin,
+                                Vec3f cellSize, Vec3i gridSize, bool castRays, Vec3f rayOrigin, rgl_occupancy_cell_t* cells);
+// Euclidean clustering: keys of grid cells (of the tolerance size) are sorted with gpuSortVoxelKeys, then points within
+// the tolerance are united (invalid points get UINT64_MAX keys). Roots of clusters of allowed sizes are selected with
+// gpuFindCompaction() using isRoot as shouldSelect, which gives ids of clusters (ordered by their lowest point index).
+void gpuEuclideanInitClusters(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                              const Field<IS_HIT_I32>::type* isHit, float tolerance, uint32_t* outParents,
+                              uint64_t* outCellKeys, Field<RAY_IDX_U32>::type* outIndices);
+void gpuEuclideanUniteClusters(cudaStream_t, size_t pointCount, float tolerance, const Field<XYZ_VEC3_F32>::type* points,
+                               const uint64_t* sortedCellKeys, const Field<RAY_IDX_U32>::type* sortedIndices,
+                               uint32_t* parents);
+void gpuEuclideanFindClusterRoots(cudaStream_t, size_t pointCount, const uint64_t* cellKeys, uint32_t minClusterSize,
+                                  uint32_t maxClusterSize, uint32_t* parents, uint32_t* clusterSizes, int32_t* outIsRoot);
+void gpuEuclideanWriteClusterIds(cudaStream_t, size_t pointCount, const uint32_t* clusterCount,
+                                 const Field<RAY_IDX_U32>::type* clusterRoots, const uint32_t* parents,
+                                 Field<CLUSTER_ID_I32>::type* clusterIdOfRoot, Field<CLUSTER_ID_I32>::type* outClusterIds);
+// Cluster boxes: the number of boxes (max id + 1) is needed on the host, then points are accumulated into their boxes.
+void gpuFindMaxClusterId(cudaStream_t, size_t pointCount, const Field<CLUSTER_ID_I32>::type* clusterIds,
+                         int32_t* outMaxClusterId);
+void gpuComputeClusterBoxes(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                            const Field<CLUSTER_ID_I32>::type* clusterIds, size_t clusterCount, rgl_cluster_box_t* outBoxes);
+// Point cloud compression (see rgl_compressed_points_header_t): blocks of points are encoded independently, first into
+// deltas, headers and sizes (blockCount + 1 elements, the last one is zero), then, once sizes are scanned into offsets
+// (relative to the first block), deltas are bit-packed into the blocks.
+size_t gpuCompressedBlockCount(size_t pointCount);
+size_t gpuScanCompressedBlockSizesTempStorageSize(size_t blockCount);
+void gpuEncodeCompressedBlocks(cudaStream_t, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, float xyzStep,
+                               Vector<3, uint32_t>* outDeltas, rgl_compressed_block_header_t* outHeaders,
+                               uint32_t* outBlockSizes);
+void gpuScanCompressedBlockSizes(cudaStream_t, size_t blockCount, const uint32_t* blockSizes, uint32_t* outOffsets,
+                                 void* tempStorage, size_t tempStorageSize);
+void gpuPackCompressedBlocks(cudaStream_t, size_t pointCount, const Vector<3, uint32_t>* deltas,
+                             const rgl_compressed_block_header_t* headers, const uint32_t* blockOffsets, char* outBlocks);
 void gpuCutField(cudaStream_t, size_t pointCount, char* dst, const char* src, size_t offset, size_t stride, size_t fieldSize);
-void gpuFilter(cudaStream_t, size_t count, const Field<RAY_IDX_U32>::type* indices, char* dst, const char* src,
-               size_t fieldSize);
+void gpuFilter(cudaStream_t, size_t count, const uint32_t* deviceCount, const Field<RAY_IDX_U32>::type* indices, char* dst,
+               const char* src, size_t fieldSize);
 void gpuFilterGroundPoints(cudaStream_t stream, size_t pointCount, const Vec3f sensor_up_axis, float ground_angle_threshold,
                            const Field<XYZ_VEC3_F32>::type* inPoints, const Field<NORMAL_VEC3_F32>::type* inNormalsPtr,
                            Field<IS_GROUND_I32>::type* outNonGround, Mat3x4f lidarTransform);
+// RANSAC plane fit: every hypothesis (plane through three sampled points, perpendicular to upVector up to the threshold)
+// is evaluated against all points in parallel; the best plane and its inlier count (0 if none was valid) stay on the device.
+void gpuFitGroundPlane(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points, Vec3f upVector,
+                       float groundAngleThreshold, float groundDistanceThreshold, size_t hypothesisCount,
+                       Vec4f* hypothesisPlanes, int32_t* hypothesisInlierCounts, Vec4f* outPlane, int32_t* outInlierCount);
+void gpuMarkGroundPlanePoints(cudaStream_t stream, size_t pointCount, const Field<XYZ_VEC3_F32>::type* points,
+                              const Vec4f* plane, const int32_t* planeInlierCount, float groundFilterDistance,
+                              Field<IS_GROUND_I32>::type* outNonGround);
 void gpuRadarComputeEnergy(cudaStream_t stream, size_t count, float rayAzimuthStepRad, float rayElevationStepRad, float freq,
                            Mat3x4f lookAtOriginTransform, const Field<RAY_POSE_MAT3x4_F32>::type* rayPose,
                            const Field<DISTANCE_F32>::type* hitDist, const Field<NORMAL_VEC3_F32>::type* hitNorm,
-                           const Field<XYZ_VEC3_F32>::type* hitPos, Vector<3, thrust::complex<float>>* outBUBRFactor);
\ No newline at end of file
+                           const Field<XYZ_VEC3_F32>::type* hitPos, Vector<3, thrust::complex<float>>* outBUBRFactor);
+// Radar clustering: cluster ids (ordered by the lowest point index of clusters) and keys of grid cells are sorted with
+// gpuSortVoxelKeys; points out of all radar scopes get UINT64_MAX keys.
+void gpuRadarInitClusters(cudaStream_t stream, size_t pointCount, const Field<DISTANCE_F32>::type* distance,
+                          const Field<AZIMUTH_F32>::type* azimuth, const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                          size_t scopeCount, const rgl_radar_scope_t* scopes, int32_t* outScopeIndices, uint32_t* outParents,
+                          uint64_t* outCellKeys, Field<RAY_IDX_U32>::type* outIndices);
+void gpuRadarUniteClusters(cudaStream_t stream, size_t pointCount, const uint64_t* sortedCellKeys,
+                           const Field<RAY_IDX_U32>::type* sortedIndices, const Field<DISTANCE_F32>::type* distance,
+                           const Field<AZIMUTH_F32>::type* azimuth, const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                           size_t scopeCount, const rgl_radar_scope_t* scopes, const int32_t* scopeIndices,
+                           uint32_t* parents);
+void gpuRadarFindClusterRoots(cudaStream_t stream, size_t pointCount, const int32_t* scopeIndices, uint32_t* parents,
+                              int32_t* outIsRoot);
+void gpuRadarComputeClusterKeys(cudaStream_t stream, size_t pointCount, const uint32_t* clusterCount,
+                                const Field<RAY_IDX_U32>::type* clusterRoots, const int32_t* scopeIndices,
+                                const uint32_t* parents, uint32_t* clusterIdOfRoot, uint64_t* outKeys,
+                                Field<RAY_IDX_U32>::type* outIndices);
+void gpuRadarReduceClusters(cudaStream_t stream, size_t clusterCount, size_t pointCount, const uint64_t* sortedClusterKeys,
+                            const Field<RAY_IDX_U32>::type* sortedPointIndices, const Field<DISTANCE_F32>::type* distance,
+                            const Field<AZIMUTH_F32>::type* azimuth, const Field<ELEVATION_F32>::type* elevation,
+                            const Vector<3, thrust::complex<float>>* bubrFactor, float powerBaseDbm,
+                            float noiseMeanDb, float noiseStDevDb, uint64_t noiseSeed, uint64_t noiseFrame,
+                            Field<RAY_IDX_U32>::type* outCenterIndices, Field<RCS_F32>::type* outRcs,
+                            Field<POWER_F32>::type* outPower, Field<NOISE_F32>::type* outNoise, Field<SNR_F32>::type* outSnr);
+// FMCW radar signal: echoes of points (zero amplitude for non-hits and points out of range) are synthesized into
+// the Hann-windowed beat signal with receiver noise (chirp-major: chirpCount x samplesPerChirp samples).
+// After its 2D FFT, the power of the range-Doppler map (zero speed in the middle row) is tested by cell-averaging CFAR.
+struct RadarEcho
+{
+	thrust::complex<float> amplitude;
+	float rangeBin;      // Beat frequency in range bins (cycles per chirp)
+	float dopplerCycles; // Phase shift between chirps in cycles
+};
+void gpuRadarComputeEchoes(cudaStream_t stream, size_t pointCount, const Field<DISTANCE_F32>::type* distance,
+                           const Field<RADIAL_SPEED_F32>::type* radialSpeed,
+                           const Vector<3, thrust::complex<float>>* bubrFactor, float amplitudeBase, float rangeBinsPerMeter,
+                           float dopplerCyclesPerSpeed, float maxDistance, RadarEcho* outEchoes);
+void gpuRadarSynthesizeBeatSignal(cudaStream_t stream, size_t echoCount, const RadarEcho* echoes, int samplesPerChirp,
+                                  int chirpCount, float noiseAmplitude, uint64_t noiseSeed, uint64_t noiseFrame,
+                                  thrust::complex<float>* outSignal);
+void gpuRadarRangeDopplerCfar(cudaStream_t stream, int samplesPerChirp, int chirpCount, const thrust::complex<float>* spectrum,
+                              float powerScale, float rangeBinSize, float speedBinSize, int guardCells, int trainingCells,
+                              float thresholdRatio, Field<DISTANCE_F32>::type* outDistance,
+                              Field<RADIAL_SPEED_F32>::type* outRadialSpeed, Field<POWER_F32>::type* outPower,
+                              Field<NOISE_F32>::type* outNoise, Field<SNR_F32>::type* outSnr,
+                              Field<IS_HIT_I32>::type* outIsDetection);
@@ -14,12 +14,16 @@
 
 #include <cuda_runtime.h>
 #include <math_constants.h>
+#include <optix.h>
 #include <optix_device.h>
 #include <cuda_fp16.h>
+#include <curand_kernel.h>
 
 #include <math/Vector.hpp>
 #include <math/Mat3x4f.hpp>
 #include <cassert>
+#include <climits>
+#include <type_traits>
 
 #include <gpu/RaytraceRequestContext.hpp>
 #include <gpu/ShaderBindingTableTypes.h>
@@ -28,7 +32,20 @@
 
 static constexpr float toDeg = (180.0f / M_PI);
 
-extern "C" static __constant__ RaytraceRequestContext ctx;
+extern "C" static __constant__ RaytraceLaunchParams launchParams;
+
+__forceinline__ __device__ const RaytraceRequestContext& getRequestCtx()
+{
+	return launchParams.requests[optixGetLaunchIndex().z];
+}
+
+// Rays may be traced in a coherent order (see RaytraceNode::setRaySorting), outputs are indexed by rays anyway.
+__forceinline__ __device__ int getRayIdx()
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const size_t launchIdx = ctx.launchIdxOffset + optixGetLaunchIndex().y * ctx.rayLayoutWidth + optixGetLaunchIndex().x;
+	return static_cast<int>(ctx.rayIdxRemap != nullptr && launchIdx < ctx.rayCount ? ctx.rayIdxRemap[launchIdx] : launchIdx);
+}
 
 struct Vec3fPayload
 {
@@ -55,86 +72,516 @@ __forceinline__ __device__ Vec3f decodePayloadVec3f(const Vec3fPayload& src)
 	};
 }
 
+// Philox is counter-based, so the same normal number is regenerated wherever it is needed, without any stored state.
+__forceinline__ __device__ float getNoiseNormal(int rayIdx, unsigned subsequenceIdx)
+{
+	constexpr uint64_t RANDOM_NUMBERS_PER_FRAME = 4;
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	curandStatePhilox4_32_10_t state;
+	curand_init(ctx.noiseSeed, static_cast<uint64_t>(rayIdx) * NOISE_SUBSEQUENCES_PER_RAY + subsequenceIdx,
+	            ctx.noiseFrame * RANDOM_NUMBERS_PER_FRAME, &state);
+	return curand_normal(&state);
+}
+
+// Uniform number in (0, 1], from the same counter-based scheme as getNoiseNormal().
+__forceinline__ __device__ float getNoiseUniform(int rayIdx, unsigned subsequenceIdx)
+{
+	constexpr uint64_t RANDOM_NUMBERS_PER_FRAME = 4;
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	curandStatePhilox4_32_10_t state;
+	curand_init(ctx.noiseSeed, static_cast<uint64_t>(rayIdx) * NOISE_SUBSEQUENCES_PER_RAY + subsequenceIdx,
+	            ctx.noiseFrame * RANDOM_NUMBERS_PER_FRAME, &state);
+	return curand_uniform(&state);
+}
+
+__forceinline__ __device__ float getMinRange(int rayIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	return ctx.rayRangesCount == 1 ? ctx.rayRanges[0].x() : ctx.rayRanges[rayIdx].x();
+}
+
+__forceinline__ __device__ float getMaxRange(int rayIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	return ctx.rayRangesCount == 1 ? ctx.rayRanges[0].y() : ctx.rayRanges[rayIdx].y();
+}
+
+// Time (in milliseconds since the scene time) selecting poses of motion-blurred instances, see rgl_configure_motion_blur.
+__forceinline__ __device__ float getRayTime(int rayIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	return ctx.rayTimeOffsets != nullptr ? ctx.rayTimeOffsets[rayIdx] : 0.0f;
+}
+
+// Distance at which the ray meets a weather particle, drawn from the exponential distribution of free paths in the medium.
+// Particles closer than the minimum range are not seen (as the surfaces are not), hence they do not terminate the ray.
+__forceinline__ __device__ float getWeatherParticleDistance(int rayIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	if (ctx.weatherExtinctionCoefficient <= 0.0f) {
+		return INFINITY;
+	}
+	const float distance = -logf(getNoiseUniform(rayIdx, NOISE_SUBSEQUENCE_WEATHER)) / ctx.weatherExtinctionCoefficient;
+	return distance < getMinRange(rayIdx) ? INFINITY : distance;
+}
+
+// Ray pose pointing along the given direction in the ray origin frame (pitch, then yaw around Y; rays point along Z).
+__forceinline__ __device__ Mat3x4f getRayFromDirection(const Vec3f& direction)
+{
+	const Vec3f dir = direction.normalized();
+	return getRequestCtx().rayOriginToWorld * Mat3x4f::rotationRad(-asinf(dir.y()), atan2f(dir.x(), dir.z()), 0.0f);
+}
+
+// Ray pose with angular noise applied in the ray origin frame (as GaussianNoiseAngularRaysNode does).
+__forceinline__ __device__ Mat3x4f getRay(int rayIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const Mat3x4f ray = ctx.rayDirections != nullptr ? getRayFromDirection(ctx.rayDirections[rayIdx]) :
+	                                                   ctx.raysTransform * ctx.rays[rayIdx];
+	if (ctx.rayAngularNoiseMean == 0.0f && ctx.rayAngularNoiseStDev == 0.0f) {
+		return ray;
+	}
+	const float angularError = ctx.rayAngularNoiseMean + getNoiseNormal(rayIdx, 0) * ctx.rayAngularNoiseStDev;
+	return ctx.rayOriginToWorld *
+	       (Mat3x4f::rotationRad(ctx.rayAngularNoiseAxis, angularError) * (ctx.rayOriginToWorld.inverse() * ray));
+}
+
+// Output index of the given return of the current ray.
+__forceinline__ __device__ int getOutIdx(unsigned returnIdx)
+{
+	return static_cast<int>(returnIdx * getRequestCtx().rayCount) + getRayIdx();
+}
+
+// Writes the output value of the point, which may be a field of interleaved (formatted) points, see formattedPointSize.
+template<typename T>
+__forceinline__ __device__ void writeOutput(T* output, int outIdx, const std::type_identity_t<T>& value)
+{
+	const unsigned formattedPointSize = getRequestCtx().formattedPointSize;
+	if (formattedPointSize == 0) {
+		output[outIdx] = value;
+		return;
+	}
+	// Fields of formatted points are not necessarily aligned.
+	memcpy(reinterpret_cast<char*>(output) + static_cast<size_t>(outIdx) * formattedPointSize, &value, sizeof(T));
+}
+
+__forceinline__ __device__ Field<RETURN_TYPE_U8>::type getReturnType(unsigned returnIdx)
+{
+	// Multipath returns follow the (single) return of the ray, see traceMultipath().
+	if (returnIdx > 0 && getRequestCtx().multipathBounceCount > 0) {
+		return RGL_RETURN_TYPE_MULTIPATH;
+	}
+	switch (getRequestCtx().returnMode) {
+		case RGL_RETURN_MODE_FIRST: return RGL_RETURN_TYPE_FIRST;
+		case RGL_RETURN_MODE_LAST: return RGL_RETURN_TYPE_LAST;
+		case RGL_RETURN_MODE_STRONGEST: return RGL_RETURN_TYPE_STRONGEST;
+		case RGL_RETURN_MODE_DUAL_FIRST_LAST: return returnIdx == 0 ? RGL_RETURN_TYPE_FIRST : RGL_RETURN_TYPE_LAST;
+		case RGL_RETURN_MODE_DUAL_STRONGEST_LAST: return returnIdx == 0 ? RGL_RETURN_TYPE_STRONGEST : RGL_RETURN_TYPE_LAST;
+	}
+	return RGL_RETURN_TYPE_UNKNOWN;
+}
+
+__forceinline__ __device__ bool isStrongestReturnRequested()
+{
+	const rgl_return_mode_t mode = getRequestCtx().returnMode;
+	return mode == RGL_RETURN_MODE_STRONGEST || mode == RGL_RETURN_MODE_DUAL_STRONGEST_LAST;
+}
+
+// Bit mask of returns the hit should be written to, given its index along the ray and whether it is the strongest one so far.
+__forceinline__ __device__ unsigned getReturnsToWrite(unsigned hitIdx, bool isStrongestSoFar)
+{
+	const bool isFirst = hitIdx == 0;
+	switch (getRequestCtx().returnMode) {
+		case RGL_RETURN_MODE_FIRST: return isFirst ? 1 : 0;
+		case RGL_RETURN_MODE_LAST: return 1;
+		case RGL_RETURN_MODE_STRONGEST: return isStrongestSoFar ? 1 : 0;
+		case RGL_RETURN_MODE_DUAL_FIRST_LAST: return (isFirst ? 1 : 0) | 2;
+		case RGL_RETURN_MODE_DUAL_STRONGEST_LAST: return (isStrongestSoFar ? 1 : 0) | 2;
+	}
+	return 0;
+}
+
+__forceinline__ __device__ uint16_t toHalfBits(float value) { return __half_as_ushort(__float2half_rn(value)); }
+
+__forceinline__ __device__ Vec3u16 toHalfBits(const Vec3f& value)
+{
+	return {toHalfBits(value.x()), toHalfBits(value.y()), toHalfBits(value.z())};
+}
+
+// See RGL_FIELD_XYZ_VEC3_I16.
+__forceinline__ __device__ Vec3i16 quantizeXyz(const Vec3f& value)
+{
+	Vec3i16 quantized;
+	for (int i = 0; i < 3; ++i) {
+		float steps = rintf(value[i] / RGL_QUANTIZED_XYZ_STEP);
+		quantized[i] = static_cast<int16_t>(isnan(steps) ? 0.0f : fminf(fmaxf(steps, -INT16_MAX), INT16_MAX));
+	}
+	return quantized;
+}
+
+// Hits are given in the world frame and transformed to the output frame here; non-hits are given in the output frame
+// (see saveNonHitRayResult).
 template<bool isFinite>
-__forceinline__ __device__ void saveRayResult(const Vec3f& xyz, float distance, float intensity, const int objectID,
-                                              const Vec3f& absVelocity, const Vec3f& relVelocity, float radialSpeed,
-                                              const Vec3f& normal, float incidentAngle)
+__forceinline__ __device__ void saveRayResult(unsigned returnIdx, const Vec3f& xyz, float distance, float intensity,
+                                              const int objectID, uint16_t classId, const Vec3f& absVelocity,
+                                              const Vec3f& relVelocity, float radialSpeed, const Vec3f& normal,
+                                              float incidentAngle)
 {
-	const int rayIdx = optixGetLaunchIndex().x;
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	Vec3f outXyz = xyz;
+	Vec3f outNormal = normal;
+	Vec3f outAbsVelocity = absVelocity;
+	if constexpr (isFinite) {
+		if (ctx.doTransformOutput) {
+			outXyz = ctx.worldToOutput * xyz;
+			outNormal = ctx.worldToOutput.rotation() * normal;
+			outAbsVelocity = ctx.worldToOutput.rotation() * absVelocity;
+		}
+	}
+	const int rayIdx = getRayIdx();
+	int outIdx = 0;
+	if (ctx.denseHitCount != nullptr) {
+		// Dense output: only hits are written, in the order slots are reserved (first return mode only).
+		if (!isFinite) {
+			return;
+		}
+		outIdx = static_cast<int>(atomicAdd(ctx.denseHitCount, 1));
+		const Mat3x4f rayLocal = ctx.rayOriginToWorld.inverse() * getRay(rayIdx);
+		if (ctx.azimuth != nullptr) {
+			writeOutput(ctx.azimuth, outIdx, rayLocal.toRotationYOrderZXYLeftHandRad());
+		}
+		if (ctx.elevation != nullptr) {
+			writeOutput(ctx.elevation, outIdx, rayLocal.toRotationXOrderZXYLeftHandRad());
+		}
+	}
+	else {
+		outIdx = getOutIdx(returnIdx);
+	}
 	if (ctx.xyz != nullptr) {
 		// Return actual XYZ of the hit point or infinity vector.
-		ctx.xyz[rayIdx] = xyz;
+		writeOutput(ctx.xyz, outIdx, outXyz);
 	}
 	if (ctx.isHit != nullptr) {
-		ctx.isHit[rayIdx] = isFinite;
+		writeOutput(ctx.isHit, outIdx, isFinite);
 	}
 	if (ctx.rayIdx != nullptr) {
-		ctx.rayIdx[rayIdx] = rayIdx;
+		writeOutput(ctx.rayIdx, outIdx, rayIdx);
 	}
 	if (ctx.ringIdx != nullptr && ctx.ringIds != nullptr) {
-		ctx.ringIdx[rayIdx] = ctx.ringIds[rayIdx % ctx.ringIdsCount];
+		writeOutput(ctx.ringIdx, outIdx, ctx.ringIds[rayIdx % ctx.ringIdsCount]);
 	}
 	if (ctx.distance != nullptr) {
-		ctx.distance[rayIdx] = distance;
+		writeOutput(ctx.distance, outIdx, distance);
 	}
 	if (ctx.intensity != nullptr) {
-		ctx.intensity[rayIdx] = intensity;
+		writeOutput(ctx.intensity, outIdx, intensity);
 	}
 	if (ctx.timestamp != nullptr) {
-		ctx.timestamp[rayIdx] = ctx.sceneTime;
+		writeOutput(ctx.timestamp, outIdx, ctx.sceneTime);
 	}
 	if (ctx.entityId != nullptr) {
-		ctx.entityId[rayIdx] = isFinite ? objectID : RGL_ENTITY_INVALID_ID;
+		writeOutput(ctx.entityId, outIdx, isFinite ? objectID : RGL_ENTITY_INVALID_ID);
+	}
+	if (ctx.classId != nullptr) {
+		writeOutput(ctx.classId, outIdx, isFinite ? classId : RGL_DEFAULT_CLASS_ID);
 	}
 	if (ctx.pointAbsVelocity != nullptr) {
-		ctx.pointAbsVelocity[rayIdx] = absVelocity;
+		writeOutput(ctx.pointAbsVelocity, outIdx, outAbsVelocity);
 	}
 	if (ctx.pointRelVelocity != nullptr) {
-		ctx.pointRelVelocity[rayIdx] = relVelocity;
+		writeOutput(ctx.pointRelVelocity, outIdx, relVelocity);
 	}
 	if (ctx.radialSpeed != nullptr) {
-		ctx.radialSpeed[rayIdx] = radialSpeed;
+		writeOutput(ctx.radialSpeed, outIdx, radialSpeed);
 	}
 	if (ctx.normal != nullptr) {
-		ctx.normal[rayIdx] = normal;
+		writeOutput(ctx.normal, outIdx, outNormal);
 	}
 	if (ctx.incidentAngle != nullptr) {
-		ctx.incidentAngle[rayIdx] = incidentAngle;
+		writeOutput(ctx.incidentAngle, outIdx, incidentAngle);
+	}
+	if (ctx.returnType != nullptr) {
+		writeOutput(ctx.returnType, outIdx, getReturnType(returnIdx));
+	}
+	if (ctx.xyzHalf != nullptr) {
+		writeOutput(ctx.xyzHalf, outIdx, toHalfBits(outXyz));
+	}
+	if (ctx.distanceHalf != nullptr) {
+		writeOutput(ctx.distanceHalf, outIdx, toHalfBits(distance));
+	}
+	if (ctx.normalHalf != nullptr) {
+		writeOutput(ctx.normalHalf, outIdx, toHalfBits(outNormal));
+	}
+	if (ctx.xyzQuantized != nullptr) {
+		Vec3f worldXyz = !isFinite && ctx.doTransformOutput ? ctx.worldToOutput.inverse() * xyz : xyz;
+		writeOutput(ctx.xyzQuantized, outIdx, quantizeXyz(ctx.rayOriginToWorld.inverse() * worldXyz));
 	}
 }
 
-__forceinline__ __device__ void saveNonHitRayResult(float nonHitDistance)
+// Writes non-hit to all returns of the ray, starting from the given one.
+__forceinline__ __device__ void saveNonHitRayResult(float nonHitDistance, unsigned firstReturnIdx = 0)
 {
-	Mat3x4f ray = ctx.rays[optixGetLaunchIndex().x];
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	// The ray is transformed before the displacement, which may be infinite, so that its components stay well-defined.
+	Mat3x4f ray = ctx.doTransformOutput ? ctx.worldToOutput * getRay(getRayIdx()) : getRay(getRayIdx());
 	Vec3f origin = ray * Vec3f{0, 0, 0};
 	Vec3f dir = ray * Vec3f{0, 0, 1} - origin;
 	Vec3f displacement = dir.normalized() * nonHitDistance;
 	displacement = {isnan(displacement.x()) ? 0 : displacement.x(), isnan(displacement.y()) ? 0 : displacement.y(),
 	                isnan(displacement.z()) ? 0 : displacement.z()};
 	Vec3f xyz = origin + displacement;
-	saveRayResult<false>(xyz, nonHitDistance, 0, RGL_ENTITY_INVALID_ID, Vec3f{NAN}, Vec3f{NAN}, 0.001f, Vec3f{NAN}, NAN);
+	for (unsigned returnIdx = firstReturnIdx; returnIdx < ctx.returnCount; ++returnIdx) {
+		saveRayResult<false>(returnIdx, xyz, nonHitDistance, 0, RGL_ENTITY_INVALID_ID, RGL_DEFAULT_CLASS_ID, Vec3f{NAN},
+		                     Vec3f{NAN}, 0.001f, Vec3f{NAN}, NAN);
+	}
+}
+
+// Mip level where a texel matches the beam footprint on the triangle, i.e. the beam (of the full divergence angle)
+// covers as many texels as the ratio of the footprint area to the texel area in the world space.
+__forceinline__ __device__ float getTextureLod(const EntityInstanceData& entityData, const Vec3f& A, const Vec3f& B,
+                                               const Vec3f& C, const Vec2f& uvA, const Vec2f& uvB, const Vec2f& uvC,
+                                               float distance)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const Vec3f wAB = optixTransformVectorFromObjectToWorldSpace(B - A);
+	const Vec3f wAC = optixTransformVectorFromObjectToWorldSpace(C - A);
+	const float worldArea = wAB.cross(wAC).length();
+	const Vec2f uvAB = uvB - uvA;
+	const Vec2f uvAC = uvC - uvA;
+	const float texelArea = fabsf(uvAB[0] * uvAC[1] - uvAB[1] * uvAC[0]) * entityData.textureTexelCount;
+	if (worldArea <= 0.0f || texelArea <= 0.0f) {
+		return 0.0f;
+	}
+	const float footprintWidth = 2.0f * distance * tanf(ctx.beamHalfDivergence);
+	// log2 of the footprint width in texels, computed from squared lengths
+	return fmaxf(0.0f, 0.5f * log2f(footprintWidth * footprintWidth * texelArea / worldArea));
+}
+
+// Normal is computed in the object space and transformed once (by the inverse transpose), instead of transforming vertices.
+__forceinline__ __device__ Vec3f getWorldNormal(const Vec3f& objectNormal)
+{
+	return Vec3f(optixTransformNormalFromObjectToWorldSpace(objectNormal)).normalized();
+}
+
+// Rotation of the sub-ray relative to the central ray of the beam.
+// Sub-rays (except the first, central one) are spread evenly over the beam cone along the golden-angle spiral.
+__forceinline__ __device__ Mat3x4f getBeamSampleRotation(unsigned sampleIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	if (sampleIdx == 0) {
+		return Mat3x4f::identity();
+	}
+	constexpr float goldenAngle = 2.39996323f;
+	const float offset = ctx.beamHalfDivergence *
+	                     sqrtf(static_cast<float>(sampleIdx) / static_cast<float>(ctx.beamSampleCount - 1));
+	const float phi = goldenAngle * static_cast<float>(sampleIdx);
+	return Mat3x4f::rotationRad(offset * cosf(phi), offset * sinf(phi), 0.0f);
+}
+
+// Probes all sub-rays of the beam (without writing results) and selects the one to be shaded according to the reduction.
+// For the mean reduction, outDistance is set to the mean distance of hitting sub-rays, otherwise to NaN.
+// Returns false if no sub-ray hit anything.
+__forceinline__ __device__ bool selectBeamSample(const Mat3x4f& ray, float maxRange, unsigned flags, Mat3x4f& outRay,
+                                                 float& outDistance)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const Mat3x4f centralRay = ray;
+	bool isSelected = false;
+	const float rayTime = getRayTime(getRayIdx());
+	float selectedDistance = 0.0f;
+	float selectedIncidentAngle = 0.0f;
+	float distanceSum = 0.0f;
+	unsigned hitSampleCount = 0;
+	for (unsigned sampleIdx = 0; sampleIdx < ctx.beamSampleCount; ++sampleIdx) {
+		const Mat3x4f sampleRay = centralRay * getBeamSampleRotation(sampleIdx);
+		const Vec3f origin = sampleRay * Vec3f{0, 0, 0};
+		const Vec3f dir = sampleRay * Vec3f{0, 0, 1} - origin;
+		Vec3fPayload originPayload = encodePayloadVec3f(origin);
+		unsigned isHit = 0, unusedIntensity = 0, distance = 0, incidentAngle = 0;
+		unsigned traceMode = TRACE_MODE_BEAM_PROBE, unusedDistanceOverride = __float_as_uint(NAN);
+		optixTrace(ctx.scene, origin, dir, 0.0f, maxRange, rayTime, OptixVisibilityMask(ctx.visibilityMask), flags,
+		           ctx.closestHitVariant, CLOSEST_HIT_VARIANT_COUNT, 0, originPayload.p0, originPayload.p1, originPayload.p2,
+		           isHit, unusedIntensity, distance, traceMode, incidentAngle, unusedDistanceOverride);
+		if (isHit == 0) {
+			continue;
+		}
+
+		const float sampleDistance = __uint_as_float(distance);
+		const float sampleIncidentAngle = __uint_as_float(incidentAngle);
+		bool isBetter = !isSelected;
+		if (ctx.beamReduction == RGL_BEAM_REDUCTION_NEAREST) {
+			isBetter = isBetter || sampleDistance < selectedDistance;
+		}
+		if (ctx.beamReduction == RGL_BEAM_REDUCTION_STRONGEST) {
+			isBetter = isBetter || sampleIncidentAngle < selectedIncidentAngle;
+		}
+		if (isBetter) {
+			isSelected = true;
+			selectedDistance = sampleDistance;
+			selectedIncidentAngle = sampleIncidentAngle;
+			outRay = sampleRay;
+		}
+		distanceSum += sampleDistance;
+		++hitSampleCount;
+	}
+	outDistance = ctx.beamReduction == RGL_BEAM_REDUCTION_MEAN && hitSampleCount > 0 ?
+	                  distanceSum / static_cast<float>(hitSampleCount) :
+	                  NAN;
+	return isSelected;
+}
+
+#if OPTIX_VERSION >= 80000
+static constexpr unsigned REORDER_HINT_BIT_COUNT = 2;
+
+// Hint for grouping threads shading similar hits (besides their hit programs, i.e. closest-hit variants and meshes):
+// closest-hit diverges mostly on sampling textures and on displacement of skinned meshes (see __closesthit__).
+__forceinline__ __device__ unsigned getHitObjectReorderHint()
+{
+	if (!optixHitObjectIsHit()) {
+		return 0;
+	}
+	// The same as getEntityInstanceIndex(), for the traversed hit.
+	const bool isTwoLevel = optixHitObjectGetTransformListSize() > 1 &&
+	                        optixGetTransformTypeFromHandle(optixHitObjectGetTransformListHandle(1)) ==
+	                            OPTIX_TRANSFORM_TYPE_INSTANCE;
+	const unsigned firstIndex = isTwoLevel ? optixGetInstanceIdFromHandle(optixHitObjectGetTransformListHandle(0)) : 0;
+	const EntityInstanceData& entityData = getRequestCtx().entityInstances[firstIndex + optixHitObjectGetInstanceIndex()];
+	const MeshSBTData& meshData = *(const MeshSBTData*) optixHitObjectGetSbtDataPointer();
+	const bool isTextured = entityData.textureIdx != 0;
+	const bool isSkinned = meshData.vertexDisplacementSincePrevFrame != nullptr;
+	return (isTextured ? 1u : 0u) | (isSkinned ? 2u : 0u);
+}
+#endif
+
+// Incremental mode: stores the ray and tells whether its previous result is still valid, i.e. the ray is the same and cannot
+// reach any instance changed since the previous frame (beam sub-rays diverge by at most the half angle from the ray).
+__forceinline__ __device__ bool storeRayAndCheckPrevResultValid(int rayIdx, const Mat3x4f& ray)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const float minRange = getMinRange(rayIdx);
+	const float maxRange = getMaxRange(rayIdx);
+	const Mat3x4f& prevRay = ctx.incrementalPrevRays[rayIdx];
+	const Vec2f& prevRange = ctx.incrementalPrevRanges[rayIdx];
+	bool isRayUnchanged = prevRange.x() == minRange && prevRange.y() == maxRange;
+	for (int y = 0; y < 3; ++y) {
+		for (int x = 0; x < 4; ++x) {
+			isRayUnchanged = isRayUnchanged && prevRay.rc[y][x] == ray.rc[y][x];
+		}
+	}
+	ctx.incrementalPrevRays[rayIdx] = ray;
+	ctx.incrementalPrevRanges[rayIdx] = Vec2f{minRange, maxRange};
+	if (ctx.incrementalChangedBounds == nullptr || !isRayUnchanged) {
+		return false;
+	}
+
+	const Vec3f origin = ray * Vec3f{0, 0, 0};
+	const Vec3f dir = (ray * Vec3f{0, 0, 1} - origin).normalized();
+	const float beamSpread = ctx.beamSampleCount > 1 ? tanf(ctx.beamHalfDivergence) : 0.0f;
+	for (unsigned i = 0; i < *ctx.incrementalChangedBoundsCount; ++i) {
+		const Vec4f& bounds = ctx.incrementalChangedBounds[i];
+		const Vec3f toCenter = Vec3f{bounds[0], bounds[1], bounds[2]} - origin;
+		const float t = fminf(fmaxf(toCenter.dot(dir), minRange), maxRange);
+		const float reach = bounds[3] + t * beamSpread;
+		if ((toCenter - dir * t).lengthSquared() <= reach * reach) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Ray skipping: tells whether the ray missed in enough consecutive frames to be skipped in this one.
+// Every probe period, each skipped ray is traced again to find surfaces that appeared in its way.
+__forceinline__ __device__ bool isRaySkipped(int rayIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const bool isProbe = (ctx.raySkippingFrame + rayIdx) % ctx.raySkippingProbePeriod == 0;
+	return ctx.rayMissFrameCounts[rayIdx] >= ctx.raySkippingMissFrameCount && !isProbe;
+}
+
+__forceinline__ __device__ void storeRayMiss(int rayIdx, bool isMiss)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	if (ctx.rayMissFrameCounts == nullptr) {
+		return;
+	}
+	uint8_t& missFrameCount = ctx.rayMissFrameCounts[rayIdx];
+	missFrameCount = isMiss ? min(missFrameCount + 1, UINT8_MAX) : 0;
+}
+
+// Multipath: reflects the ray specularly off its hit, up to multipathBounceCount times, and reports the surface met
+// by each bounce as the next return. Echoes are assumed to come back along the same path, so that returns appear along
+// the ray at the length of the path (ghost targets); each reflection attenuates them by multipathReflectivity.
+// Closest-hit program reports the normal of the hit surface in the origin payload, see __closesthit__.
+__forceinline__ __device__ void traceMultipath(int rayIdx, const Vec3f& origin, const Vec3f& dir, float hitDistance,
+                                               const Vec3f& hitNormal, float rayTime, unsigned flags)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const float maxRange = getMaxRange(rayIdx);
+	Vec3f bounceOrigin = origin + dir * hitDistance;
+	Vec3f bounceDir = dir.normalized();
+	Vec3f normal = hitNormal;
+	float pathLength = hitDistance * dir.length();
+	float attenuation = 1.0f;
+	unsigned returnIdx = 1;
+	for (; returnIdx < ctx.returnCount && pathLength < maxRange; ++returnIdx) {
+		bounceDir = bounceDir - normal * (2.0f * bounceDir.dot(normal));
+		attenuation *= ctx.multipathReflectivity;
+		Vec3fPayload bouncePayload = encodePayloadVec3f(bounceOrigin);
+		unsigned bounceReturnIdx = returnIdx, bouncePathLength = __float_as_uint(pathLength);
+		unsigned segmentLength = __float_as_uint(NAN), traceMode = TRACE_MODE_MULTIPATH_BOUNCE;
+		unsigned bounceAttenuation = __float_as_uint(attenuation), unusedDistanceOverride = __float_as_uint(NAN);
+		optixTrace(ctx.scene, bounceOrigin, bounceDir, MULTI_RETURN_MIN_HIT_SEPARATION, maxRange - pathLength, rayTime,
+		           OptixVisibilityMask(ctx.visibilityMask), flags, ctx.closestHitVariant, CLOSEST_HIT_VARIANT_COUNT, 0,
+		           bouncePayload.p0, bouncePayload.p1, bouncePayload.p2, bounceReturnIdx, bouncePathLength, segmentLength,
+		           traceMode, bounceAttenuation, unusedDistanceOverride);
+		if (isnan(__uint_as_float(segmentLength))) {
+			break; // Missed
+		}
+		bounceOrigin = bounceOrigin + bounceDir * __uint_as_float(segmentLength);
+		normal = decodePayloadVec3f(bouncePayload);
+		pathLength += __uint_as_float(segmentLength);
+	}
+	saveNonHitRayResult(ctx.farNonHitDistance, returnIdx);
 }
 
 extern "C" __global__ void __raygen__()
 {
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const int rayIdx = getRayIdx();
+	if (optixGetLaunchIndex().x >= ctx.rayLayoutWidth || static_cast<size_t>(rayIdx) >= ctx.rayCount) {
+		return; // Launch size is the largest layout among batched requests.
+	}
+
+	Mat3x4f ray = getRay(rayIdx);
+	if (ctx.incrementalPrevRays != nullptr && storeRayAndCheckPrevResultValid(rayIdx, ray)) {
+		return;
+	}
+
+	if (ctx.rayMissFrameCounts != nullptr && isRaySkipped(rayIdx)) {
+		saveNonHitRayResult(ctx.farNonHitDistance);
+		return;
+	}
+
 	if (ctx.scene == 0) {
+		storeRayMiss(rayIdx, true);
 		saveNonHitRayResult(ctx.farNonHitDistance);
 		return;
 	}
 
-	const int rayIdx = optixGetLaunchIndex().x;
-	Mat3x4f ray = ctx.rays[rayIdx];
 	const Mat3x4f rayLocal = ctx.rayOriginToWorld.inverse() * ray;
 
 	// Assuming up vector is Y, forward vector is Z (true for Unity).
 	// TODO(msz-rai): allow to define up and forward vectors in RGL
 	// Assuming rays are generated in left-handed coordinate system with the rotation applied in ZXY order.
 	// TODO(msz-rai): move ray generation to RGL to unify rotations
-	if (ctx.azimuth != nullptr) {
-		ctx.azimuth[rayIdx] = rayLocal.toRotationYOrderZXYLeftHandRad();
-	}
-	if (ctx.elevation != nullptr) {
-		ctx.elevation[rayIdx] = rayLocal.toRotationXOrderZXYLeftHandRad();
+	// In dense output mode, output slots are known only for hits, see saveRayResult().
+	for (unsigned returnIdx = 0; returnIdx < ctx.returnCount && ctx.denseHitCount == nullptr; ++returnIdx) {
+		if (ctx.azimuth != nullptr) {
+			writeOutput(ctx.azimuth, getOutIdx(returnIdx), rayLocal.toRotationYOrderZXYLeftHandRad());
+		}
+		if (ctx.elevation != nullptr) {
+			writeOutput(ctx.elevation, getOutIdx(returnIdx), rayLocal.toRotationXOrderZXYLeftHandRad());
+		}
 	}
 
 	if (ctx.doApplyDistortion) {
@@ -148,114 +595,308 @@ extern "C" __global__ void __raygen__()
 		ray = ctx.rayOriginToWorld * ray;
 	}
 
+	// Surfaces behind the weather particle are not traced; the miss program reports the particle instead (see __miss__).
+	const float weatherParticleDistance = getWeatherParticleDistance(rayIdx);
+	const bool isWeatherParticleInRange = weatherParticleDistance < getMaxRange(rayIdx);
+	float maxRange = fminf(getMaxRange(rayIdx), weatherParticleDistance);
+	unsigned int flags = OPTIX_RAY_FLAG_DISABLE_ANYHIT;
+
+	unsigned distanceOverride = __float_as_uint(NAN);
+	if (ctx.beamSampleCount > 1) {
+		// If all sub-rays missed the surfaces, but there is the weather particle, the central ray is traced to meet it.
+		float reducedDistance = NAN;
+		if (!selectBeamSample(ray, maxRange, flags, ray, reducedDistance) && !isWeatherParticleInRange) {
+			storeRayMiss(rayIdx, true);
+			saveNonHitRayResult(ctx.farNonHitDistance);
+			return;
+		}
+		distanceOverride = __float_as_uint(reducedDistance);
+	}
+
 	Vec3f origin = ray * Vec3f{0, 0, 0};
 	Vec3f dir = ray * Vec3f{0, 0, 1} - origin;
-	float maxRange = ctx.rayRangesCount == 1 ? ctx.rayRanges[0].y() : ctx.rayRanges[rayIdx].y();
-
-	unsigned int flags = OPTIX_RAY_FLAG_DISABLE_ANYHIT;
 	Vec3fPayload originPayload = encodePayloadVec3f(origin);
-	optixTrace(ctx.scene, origin, dir, 0.0f, maxRange, 0.0f, OptixVisibilityMask(255), flags, 0, 1, 0, originPayload.p0,
-	           originPayload.p1, originPayload.p2);
+	unsigned traceMode = TRACE_MODE_SHADE;
+	unsigned unusedIncidentAngle = 0;
+
+	// Closest-hit program increments hit count and reports the hit distance, which is where the next trace starts.
+	// Miss, or a hit closer than the minimum range, leaves the count unchanged and ends the loop.
+	const unsigned maxHitCount = ctx.returnMode == RGL_RETURN_MODE_FIRST ? 1 : MULTI_RETURN_MAX_HIT_COUNT;
+	unsigned hitCount = 0;
+	unsigned strongestIntensity = __float_as_uint(0.0f);
+	unsigned hitDistance = __float_as_uint(0.0f);
+	float minDistance = 0.0f;
+	const float rayTime = getRayTime(rayIdx);
+	for (unsigned i = 0; i < maxHitCount; ++i) {
+		const unsigned prevHitCount = hitCount;
+#if OPTIX_VERSION >= 80000
+		if (launchParams.useShaderExecutionReordering) {
+			optixTraverse(ctx.scene, origin, dir, minDistance, maxRange, rayTime, OptixVisibilityMask(ctx.visibilityMask),
+			              flags, ctx.closestHitVariant, CLOSEST_HIT_VARIANT_COUNT, 0, originPayload.p0, originPayload.p1,
+			              originPayload.p2, hitCount, strongestIntensity, hitDistance, traceMode, unusedIncidentAngle,
+			              distanceOverride);
+			optixReorder(getHitObjectReorderHint(), REORDER_HINT_BIT_COUNT);
+			optixInvoke(originPayload.p0, originPayload.p1, originPayload.p2, hitCount, strongestIntensity, hitDistance,
+			            traceMode, unusedIncidentAngle, distanceOverride);
+		}
+		else
+#endif
+			optixTrace(ctx.scene, origin, dir, minDistance, maxRange, rayTime, OptixVisibilityMask(ctx.visibilityMask),
+			           flags, ctx.closestHitVariant, CLOSEST_HIT_VARIANT_COUNT, 0, originPayload.p0, originPayload.p1,
+			           originPayload.p2, hitCount, strongestIntensity, hitDistance, traceMode, unusedIncidentAngle,
+			           distanceOverride);
+		if (hitCount == prevHitCount) {
+			break;
+		}
+		minDistance = __uint_as_float(hitDistance) + MULTI_RETURN_MIN_HIT_SEPARATION;
+	}
+	storeRayMiss(rayIdx, hitCount == 0);
+	// Otherwise, multipath returns are already written as non-hits (or the ray ended in the weather medium).
+	if (ctx.multipathBounceCount > 0 && hitCount > 0) {
+		const Vec3f hitNormal = decodePayloadVec3f(originPayload);
+		traceMultipath(rayIdx, origin, dir, __uint_as_float(hitDistance), hitNormal, rayTime, flags);
+	}
 }
 
-extern "C" __global__ void __closesthit__()
+// In two-level AS (see Scene), indices restart in the dynamic IAS, whose top-level instance id is its first index.
+// The transform list may also end with a motion transform of the instance, see getFrameTimeObjectToWorld().
+__forceinline__ __device__ unsigned getEntityInstanceIndex()
 {
-	const EntitySBTData& entityData = *(const EntitySBTData*) optixGetSbtDataPointer();
+	const bool isTwoLevel = optixGetTransformListSize() > 1 &&
+	                        optixGetTransformTypeFromHandle(optixGetTransformListHandle(1)) == OPTIX_TRANSFORM_TYPE_INSTANCE;
+	const unsigned firstIndex = isTwoLevel ? optixGetInstanceIdFromHandle(optixGetTransformListHandle(0)) : 0;
+	return firstIndex + optixGetInstanceIndex();
+}
 
-	const int primID = optixGetPrimitiveIndex();
-	assert(primID < entityData.indexCount);
-	const Vec3i triangleIndices = entityData.index[primID];
-	const float u = optixGetTriangleBarycentrics().x;
-	const float v = optixGetTriangleBarycentrics().y;
+// Local-to-world transform of the hit instance at the scene time, i.e. excluding its motion transform (if any).
+// Top-level IAS of two-level AS has identity transforms, so only the instance of the entity is taken into account.
+__forceinline__ __device__ Mat3x4f getFrameTimeObjectToWorld()
+{
+	const unsigned lastLevel = optixGetTransformListSize() - 1;
+	OptixTraversableHandle handle = optixGetTransformListHandle(lastLevel);
+	if (optixGetTransformTypeFromHandle(handle) == OPTIX_TRANSFORM_TYPE_MATRIX_MOTION_TRANSFORM) {
+		handle = optixGetTransformListHandle(lastLevel - 1);
+	}
+	const float4* rows = optixGetInstanceTransformFromHandle(handle);
+	Mat3x4f objectToWorld;
+	for (int row = 0; row < 3; ++row) {
+		objectToWorld.rc[row][0] = rows[row].x;
+		objectToWorld.rc[row][1] = rows[row].y;
+		objectToWorld.rc[row][2] = rows[row].z;
+		objectToWorld.rc[row][3] = rows[row].w;
+	}
+	return objectToWorld;
+}
 
-	assert(triangleIndices.x() < entityData.vertexCount);
-	assert(triangleIndices.y() < entityData.vertexCount);
-	assert(triangleIndices.z() < entityData.vertexCount);
+// Indices and vertices of compressed meshes are decoded here, see Mesh::compress().
+__forceinline__ __device__ Vec3i getTriangleIndices(const MeshSBTData& meshData, int primID)
+{
+	if (meshData.index16 != nullptr) {
+		const uint16_t* triangle = meshData.index16 + 3 * primID;
+		return {triangle[0], triangle[1], triangle[2]};
+	}
+	return meshData.index[primID];
+}
+
+__forceinline__ __device__ Vec3f getVertex(const MeshSBTData& meshData, int vertexIdx)
+{
+	if (meshData.vertexHalf != nullptr) {
+		const uint16_t* vertex = meshData.vertexHalf + 3 * vertexIdx;
+		return {__half2float(__ushort_as_half(vertex[0])), __half2float(__ushort_as_half(vertex[1])),
+		        __half2float(__ushort_as_half(vertex[2]))};
+	}
+	if (meshData.vertexSnorm != nullptr) {
+		const int16_t* vertex = meshData.vertexSnorm + 3 * vertexIdx;
+		const Vec3f normalized{static_cast<float>(vertex[0]), static_cast<float>(vertex[1]), static_cast<float>(vertex[2])};
+		return meshData.vertexSnormOffset + meshData.vertexSnormScale * (normalized / 32767.0f);
+	}
+	return meshData.vertex[vertexIdx];
+}
+
+// Per-vertex value of the hit sphere (i.e. of its center) or of the hit curve segment, interpolated along its axis.
+// Spheres and curves have no indices and no compressed vertices, see Mesh::createSpheres() and Mesh::createCurves().
+__forceinline__ __device__ Vec3f getBuiltinPrimitiveValue(const MeshSBTData& meshData, const Vec3f* perVertex, int primID)
+{
+	if (optixGetPrimitiveType() != OPTIX_PRIMITIVE_TYPE_ROUND_LINEAR) {
+		return perVertex[primID];
+	}
+	const uint32_t first = meshData.segmentIndex[primID];
+	const float t = optixGetCurveParameter();
+	return (1 - t) * perVertex[first] + t * perVertex[first + 1];
+}
 
-	const Vec3f& A = entityData.vertex[triangleIndices.x()];
-	const Vec3f& B = entityData.vertex[triangleIndices.y()];
-	const Vec3f& C = entityData.vertex[triangleIndices.z()];
+template<unsigned features>
+__forceinline__ __device__ void closestHit()
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	const MeshSBTData& meshData = *(const MeshSBTData*) optixGetSbtDataPointer();
+	const EntityInstanceData& entityData = ctx.entityInstances[getEntityInstanceIndex()];
+
+	const bool isBeamProbe = optixGetPayload_6() == TRACE_MODE_BEAM_PROBE;
+	const bool isMultipathBounce = optixGetPayload_6() == TRACE_MODE_MULTIPATH_BOUNCE;
+	const bool isIntensityRequested = ctx.intensity != nullptr || isStrongestReturnRequested();
+	const bool isTextureSampled = isIntensityRequested && meshData.textureCoords != nullptr && entityData.textureIdx != 0;
+	// Vertices are needed only for attributes of the triangle; otherwise, the hit point is derived from the ray.
+	const bool isTextureLodNeeded = isTextureSampled && ctx.beamHalfDivergence > 0.0f;
+	constexpr bool areTriangleFeaturesRequested = (features & (CLOSEST_HIT_FEATURE_NORMAL | CLOSEST_HIT_FEATURE_VELOCITY)) != 0;
+	const bool isMultipath = ctx.multipathBounceCount > 0; // Surface normal is needed to reflect the ray
+	const bool areVerticesNeeded = areTriangleFeaturesRequested || isBeamProbe || isTextureLodNeeded || isMultipath;
 
-	Vec3f hitObject = Vec3f((1 - u - v) * A + u * B + v * C);
-	Vec3f hitWorld = optixTransformPointFromObjectToWorldSpace(hitObject);
+	const int primID = optixGetPrimitiveIndex();
+	const bool isTriangle = optixGetPrimitiveType() == OPTIX_PRIMITIVE_TYPE_TRIANGLE;
+	assert(!isTriangle || primID < meshData.indexCount);
+	const Vec3i triangleIndices = isTriangle && (areVerticesNeeded || isTextureSampled) ? getTriangleIndices(meshData, primID)
+	                                                                                    : Vec3i{0};
+	const float u = isTriangle ? optixGetTriangleBarycentrics().x : 0.0f;
+	const float v = isTriangle ? optixGetTriangleBarycentrics().y : 0.0f;
+
+	assert(triangleIndices.x() < meshData.vertexCount);
+	assert(triangleIndices.y() < meshData.vertexCount);
+	assert(triangleIndices.z() < meshData.vertexCount);
+
+	Vec3f A{0}, B{0}, C{0}, objectNormal{0}, hitObject{0}, hitWorld{0};
+	if (areVerticesNeeded && isTriangle) {
+		A = getVertex(meshData, triangleIndices.x());
+		B = getVertex(meshData, triangleIndices.y());
+		C = getVertex(meshData, triangleIndices.z());
+		objectNormal = (B - A).cross(C - A);
+		hitObject = Vec3f((1 - u - v) * A + u * B + v * C);
+		hitWorld = optixTransformPointFromObjectToWorldSpace(hitObject);
+	}
+	else {
+		hitWorld = Vec3f(optixGetWorldRayOrigin()) + optixGetRayTmax() * Vec3f(optixGetWorldRayDirection());
+	}
+	if (areVerticesNeeded && !isTriangle) {
+		// Surface points away from the center of the sphere or from the axis of the curve (exact for constant radius).
+		hitObject = optixTransformPointFromWorldToObjectSpace(hitWorld);
+		objectNormal = hitObject - getBuiltinPrimitiveValue(meshData, meshData.vertex, primID);
+	}
 
 	int objectID = optixGetInstanceId();
 
 	Vec3f origin = decodePayloadVec3f({optixGetPayload_0(), optixGetPayload_1(), optixGetPayload_2()});
 
-	// TODO: Optimization - we can use inversesqrt here, which is one operation cheaper then sqrt.
-	float distance = sqrt(pow((hitWorld)[0] - (origin)[0], 2) + pow((hitWorld)[1] - (origin)[1], 2) +
-	                      pow((hitWorld)[2] - (origin)[2], 2));
+	float distance = (hitWorld - origin).length();
+
+	if (isBeamProbe) {
+		// Report distance and incident angle to raygen, which selects the sub-ray to be shaded.
+		const Vec3f rayDir = (hitWorld - origin).normalized();
+		optixSetPayload_3(1);
+		optixSetPayload_5(__float_as_uint(distance));
+		optixSetPayload_7(__float_as_uint(acosf(fabs(getWorldNormal(objectNormal).dot(rayDir)))));
+		return;
+	}
+
+	// Reduced distance of the divergent beam (mean reduction)
+	const float distanceOverride = __uint_as_float(optixGetPayload_8());
+	if (!isnan(distanceOverride)) {
+		hitWorld = origin + (hitWorld - origin).normalized() * distanceOverride;
+		distance = distanceOverride;
+	}
 
-	float minRange = ctx.rayRangesCount == 1 ? ctx.rayRanges[0].x() : ctx.rayRanges[optixGetLaunchIndex().x].x();
-	if (distance < minRange) {
-		saveNonHitRayResult(ctx.nearNonHitDistance);
+	if (isMultipath) {
+		// Raygen reflects the ray off this surface for the next bounce, see traceMultipath().
+		const Vec3fPayload normalPayload = encodePayloadVec3f(getWorldNormal(objectNormal));
+		optixSetPayload_0(normalPayload.p0);
+		optixSetPayload_1(normalPayload.p1);
+		optixSetPayload_2(normalPayload.p2);
+	}
+	if (isMultipathBounce) {
+		// The bounce starts at the previous hit; its return is reported at the length of the whole path.
+		optixSetPayload_5(__float_as_uint(distance));
+		distance += __uint_as_float(optixGetPayload_4());
+	}
+
+	const unsigned hitIdx = optixGetPayload_3();
+	if (distance < getMinRange(getRayIdx())) {
+		// Further hits are also farther than this one, so only the first hit may be closer than the minimum range.
+		if (hitIdx == 0) {
+			saveNonHitRayResult(ctx.nearNonHitDistance);
+		}
 		return;
 	}
 
 	// Fix XYZ if distortion is applied (XYZ must be calculated in sensor coordinate frame)
+	Vec3f hitOrigin = origin;
 	if (ctx.doApplyDistortion) {
-		const int rayIdx = optixGetLaunchIndex().x;
-		Mat3x4f undistortedRay = ctx.rays[rayIdx];
+		const int rayIdx = getRayIdx();
+		Mat3x4f undistortedRay = getRay(rayIdx);
 		Vec3f undistortedOrigin = undistortedRay * Vec3f{0, 0, 0};
 		Vec3f undistortedDir = undistortedRay * Vec3f{0, 0, 1} - undistortedOrigin;
 		hitWorld = undistortedOrigin + undistortedDir * distance;
+		hitOrigin = undistortedOrigin;
 	}
 
 	// Normal vector and incident angle
-	Vec3f rayDir = (hitWorld - origin).normalized();
-	const Vec3f wA = optixTransformPointFromObjectToWorldSpace(A);
-	const Vec3f wB = optixTransformPointFromObjectToWorldSpace(B);
-	const Vec3f wC = optixTransformPointFromObjectToWorldSpace(C);
-	const Vec3f wAB = wB - wA;
-	const Vec3f wCA = wC - wA;
-	const Vec3f wNormal = wAB.cross(wCA).normalized();
-	const float incidentAngle = acosf(fabs(wNormal.dot(rayDir)));
-
-	float intensity = 0;
-	bool isIntensityRequested = ctx.intensity != nullptr;
-	if (isIntensityRequested && entityData.textureCoords != nullptr && entityData.texture != 0) {
-		assert(triangleIndices.x() < entityData.textureCoordsCount);
-		assert(triangleIndices.y() < entityData.textureCoordsCount);
-		assert(triangleIndices.z() < entityData.textureCoordsCount);
-
-		const Vec2f& uvA = entityData.textureCoords[triangleIndices.x()];
-		const Vec2f& uvB = entityData.textureCoords[triangleIndices.y()];
-		const Vec2f& uvC = entityData.textureCoords[triangleIndices.z()];
+	Vec3f wNormal{NAN};
+	float incidentAngle{NAN};
+	if constexpr ((features & CLOSEST_HIT_FEATURE_NORMAL) != 0) {
+		Vec3f rayDir = (hitWorld - origin).normalized();
+		wNormal = getWorldNormal(objectNormal);
+		incidentAngle = acosf(fabs(wNormal.dot(rayDir)));
+	}
+
+	float intensity = entityData.intensity;
+	if (isTextureSampled) {
+		assert(triangleIndices.x() < meshData.textureCoordsCount);
+		assert(triangleIndices.y() < meshData.textureCoordsCount);
+		assert(triangleIndices.z() < meshData.textureCoordsCount);
+
+		const Vec2f& uvA = meshData.textureCoords[triangleIndices.x()];
+		const Vec2f& uvB = meshData.textureCoords[triangleIndices.y()];
+		const Vec2f& uvC = meshData.textureCoords[triangleIndices.z()];
 
 		Vec2f uv = (1 - u - v) * uvA + u * uvB + v * uvC;
 
-		intensity = tex2D<TextureTexelFormat>(entityData.texture, uv[0], uv[1]);
+		const float lod = isTextureLodNeeded ? getTextureLod(entityData, A, B, C, uvA, uvB, uvC, distance) : 0.0f;
+		// Texels are read normalized to [0, 1] (see Texture::createTextureObject), hence scaled back to their range.
+		intensity = tex2DLod<float>(ctx.textures[entityData.textureIdx], uv[0], uv[1], lod) * static_cast<float>(UCHAR_MAX);
+	}
+	if (isMultipathBounce) {
+		intensity *= __uint_as_float(optixGetPayload_7());
+	}
+	if (ctx.weatherExtinctionCoefficient > 0.0f) {
+		// Beer-Lambert attenuation on the way to the surface and back.
+		intensity *= expf(-2.0f * ctx.weatherExtinctionCoefficient * distance);
 	}
 
 	Vec3f absPointVelocity{NAN};
 	Vec3f relPointVelocity{NAN};
 	float radialSpeed{NAN};
-	bool isVelocityRequested = ctx.pointAbsVelocity != nullptr || ctx.pointRelVelocity != nullptr || ctx.radialSpeed != nullptr;
+	constexpr bool isVelocityRequested = (features & CLOSEST_HIT_FEATURE_VELOCITY) != 0;
 	if (ctx.sceneDeltaTime > 0 && isVelocityRequested) {
-		Vec3f displacementFromTransformChange = {0, 0, 0};
-		if (entityData.hasPrevFrameLocalToWorld) {
-			// Computing hit point velocity in simple words:
-			// From raytracing, we get hit point in Entity's coordinate frame (hitObject).
-			// Think of it as a marker dot on the Entity.
-			// Having access to Entity's previous pose, we can compute (entityData.prevFrameLocalToWorld * hitObject),
-			// where the marker dot would be in the previous raytracing frame (displacementVectorOrigin).
-			// Then, we can connect marker dot in previous raytracing frame with its current position and obtain displacementFromTransformChange vector
-			// Dividing displacementFromTransformChange by time elapsed from the previous raytracing frame yields velocity vector.
-			Vec3f displacementVectorOrigin = entityData.prevFrameLocalToWorld * hitObject;
-			displacementFromTransformChange = hitWorld - displacementVectorOrigin;
-		}
-
-		// Some entities may have skinned meshes - in this case entity.vertexDisplacementSincePrevFrame will be non-null
+		// Computing hit point velocity in simple words:
+		// From raytracing, we get hit point in Entity's coordinate frame (hitObject).
+		// Think of it as a marker dot on the Entity.
+		// Having access to Entity's previous pose, we can compute (prevFrameLocalToWorld * hitObject),
+		// where the marker dot would be in the previous raytracing frame (displacementVectorOrigin).
+		// Then, we can connect marker dot in previous raytracing frame with its current position and obtain displacementFromTransformChange vector
+		// Dividing displacementFromTransformChange by time elapsed from the previous raytracing frame yields velocity vector.
+		// The previous pose is interpolated from the history, so it is known even if the entity was not posed in that frame.
+		// Motion-blurred instances are hit at the ray time, so their position at the scene time is used instead.
+		const EntityTransformHistory& transformHistory = ctx.entityTransformHistories[getEntityInstanceIndex()];
+		Mat3x4f prevFrameLocalToWorld = transformHistory.getLocalToWorldAt(ctx.prevSceneTime);
+		Vec3f displacementVectorOrigin = prevFrameLocalToWorld * hitObject;
+		Vec3f displacementVectorEnd = optixGetRayTime() != 0.0f ? getFrameTimeObjectToWorld() * hitObject : hitWorld;
+		Vec3f displacementFromTransformChange = displacementVectorEnd - displacementVectorOrigin;
+
+		// Some entities may have skinned meshes - in this case mesh.vertexDisplacementSincePrevFrame will be non-null
 		Vec3f displacementFromSkinning = {0, 0, 0};
-		bool wasSkinned = entityData.vertexDisplacementSincePrevFrame != nullptr;
+		bool wasSkinned = meshData.vertexDisplacementSincePrevFrame != nullptr;
 		if (wasSkinned) {
 			Mat3x4f objectToWorld;
 			optixGetObjectToWorldTransformMatrix(reinterpret_cast<float*>(objectToWorld.rc));
-			const Vec3f& vA = entityData.vertexDisplacementSincePrevFrame[triangleIndices.x()];
-			const Vec3f& vB = entityData.vertexDisplacementSincePrevFrame[triangleIndices.y()];
-			const Vec3f& vC = entityData.vertexDisplacementSincePrevFrame[triangleIndices.z()];
-			displacementFromSkinning = objectToWorld.scaleVec() * Vec3f((1 - u - v) * vA + u * vB + v * vC);
+			Vec3f displacement{0};
+			if (isTriangle) {
+				const Vec3f& vA = meshData.vertexDisplacementSincePrevFrame[triangleIndices.x()];
+				const Vec3f& vB = meshData.vertexDisplacementSincePrevFrame[triangleIndices.y()];
+				const Vec3f& vC = meshData.vertexDisplacementSincePrevFrame[triangleIndices.z()];
+				displacement = Vec3f((1 - u - v) * vA + u * vB + v * vC);
+			}
+			else {
+				displacement = getBuiltinPrimitiveValue(meshData, meshData.vertexDisplacementSincePrevFrame, primID);
+			}
+			displacementFromSkinning = objectToWorld.scaleVec() * displacement;
 		}
 
 		absPointVelocity = (displacementFromTransformChange + displacementFromSkinning) /
@@ -273,10 +914,105 @@ extern "C" __global__ void __closesthit__()
 		radialSpeed = hitRays.normalized().dot(relPointVelocity);
 	}
 
-	saveRayResult<true>(hitWorld, distance, intensity, objectID, absPointVelocity, relPointVelocity, radialSpeed, wNormal,
-	                    incidentAngle);
+	if (isMultipathBounce) {
+		// Velocities are of the reflecting surface, but the return appears along the ray (see traceMultipath()).
+		const Mat3x4f ray = getRay(getRayIdx());
+		hitOrigin = ray * Vec3f{0, 0, 0};
+		hitWorld = hitOrigin + (ray * Vec3f{0, 0, 1} - hitOrigin).normalized() * distance;
+	}
+
+	// Distance noise is applied last, so that it does not affect values derived from the actual hit point (e.g. velocities).
+	if (ctx.hitDistanceNoiseMean != 0.0f || ctx.hitDistanceNoiseStDevBase != 0.0f ||
+	    ctx.hitDistanceNoiseStDevRisePerMeter != 0.0f) {
+		const float stDev = ctx.hitDistanceNoiseStDevBase + distance * ctx.hitDistanceNoiseStDevRisePerMeter;
+		const float distanceError = ctx.hitDistanceNoiseMean + getNoiseNormal(getRayIdx(), 1 + hitIdx) * stDev;
+		hitWorld = hitWorld + (hitWorld - hitOrigin).normalized() * distanceError;
+		distance += distanceError;
+	}
+
+	if (isMultipathBounce) {
+		saveRayResult<true>(hitIdx, hitWorld, distance, intensity, objectID, entityData.classId, absPointVelocity,
+		                    relPointVelocity, radialSpeed, wNormal, incidentAngle);
+		return;
+	}
+
+	// Report the hit to raygen (multi-return loop)
+	const bool isStrongestSoFar = hitIdx == 0 || intensity > __uint_as_float(optixGetPayload_4());
+	optixSetPayload_3(hitIdx + 1);
+	optixSetPayload_5(__float_as_uint(optixGetRayTmax()));
+	if (isStrongestSoFar) {
+		optixSetPayload_4(__float_as_uint(intensity));
+	}
+
+	const unsigned returnsToWrite = getReturnsToWrite(hitIdx, isStrongestSoFar);
+	for (unsigned returnIdx = 0; returnIdx < ctx.returnCount; ++returnIdx) {
+		if ((returnsToWrite & (1u << returnIdx)) != 0) {
+			saveRayResult<true>(returnIdx, hitWorld, distance, intensity, objectID, entityData.classId, absPointVelocity,
+			                    relPointVelocity, radialSpeed, wNormal, incidentAngle);
+		}
+	}
+}
+
+extern "C" __global__ void __closesthit__() { closestHit<0>(); }
+extern "C" __global__ void __closesthit__normal() { closestHit<CLOSEST_HIT_FEATURE_NORMAL>(); }
+extern "C" __global__ void __closesthit__velocity() { closestHit<CLOSEST_HIT_FEATURE_VELOCITY>(); }
+extern "C" __global__ void __closesthit__normal_velocity()
+{
+	closestHit<CLOSEST_HIT_FEATURE_NORMAL | CLOSEST_HIT_FEATURE_VELOCITY>();
+}
+
+// Reports the weather particle terminating the ray as its next hit.
+// Particles are still, they do not belong to any entity and face the sensor.
+__forceinline__ __device__ void saveWeatherParticleHit(float distance, unsigned hitIdx)
+{
+	const RaytraceRequestContext& ctx = getRequestCtx();
+	// XYZ is calculated in sensor coordinate frame, as in closest-hit program.
+	const Mat3x4f ray = getRay(getRayIdx());
+	const Vec3f origin = ray * Vec3f{0, 0, 0};
+	const Vec3f dir = (ray * Vec3f{0, 0, 1} - origin).normalized();
+	const Vec3f hitWorld = origin + dir * distance;
+
+	Vec3f relPointVelocity{NAN};
+	float radialSpeed{NAN};
+	if ((ctx.closestHitVariant & CLOSEST_HIT_FEATURE_VELOCITY) != 0 && ctx.sceneDeltaTime > 0) {
+		const Vec3f hitRays = ctx.rayOriginToWorld.inverse() * hitWorld;
+		relPointVelocity = Vec3f(.0f) - ctx.sensorLinearVelocityXYZ - ctx.sensorAngularVelocityRPY.cross(hitRays);
+		radialSpeed = hitRays.normalized().dot(relPointVelocity);
+	}
+
+	const float intensity = ctx.weatherParticleIntensity;
+	const bool isStrongestSoFar = hitIdx == 0 || intensity > __uint_as_float(optixGetPayload_4());
+	if (isStrongestSoFar) {
+		optixSetPayload_4(__float_as_uint(intensity));
+	}
+	const unsigned returnsToWrite = getReturnsToWrite(hitIdx, isStrongestSoFar);
+	for (unsigned returnIdx = 0; returnIdx < ctx.returnCount; ++returnIdx) {
+		if ((returnsToWrite & (1u << returnIdx)) != 0) {
+			saveRayResult<true>(returnIdx, hitWorld, distance, intensity, RGL_ENTITY_INVALID_ID, RGL_DEFAULT_CLASS_ID,
+			                    Vec3f{0.0f}, relPointVelocity, radialSpeed, Vec3f{0.0f} - dir, 0.0f);
+		}
+	}
+	// Particles scatter the ray, so it is not reflected further (multipath is available in the first return mode only).
+	if (ctx.multipathBounceCount > 0) {
+		saveNonHitRayResult(ctx.farNonHitDistance, 1);
+	}
 }
 
-extern "C" __global__ void __miss__() { saveNonHitRayResult(ctx.farNonHitDistance); }
+extern "C" __global__ void __miss__()
+{
+	if (optixGetPayload_6() != TRACE_MODE_SHADE) {
+		return; // Beam probes write nothing; raygen writes misses of multipath bounces, see traceMultipath().
+	}
+	// Raygen shortens the ray to the weather particle, if there is one in range.
+	const float tmax = optixGetRayTmax();
+	if (tmax < getMaxRange(getRayIdx())) {
+		saveWeatherParticleHit(tmax, optixGetPayload_3());
+		return;
+	}
+	// In multi-return modes, the ray passing beyond the last hit is not a non-hit.
+	if (optixGetPayload_3() == 0) {
+		saveNonHitRayResult(getRequestCtx().farNonHitDistance);
+	}
+}
 
 extern "C" __global__ void __anyhit__() {}
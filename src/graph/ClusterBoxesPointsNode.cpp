@@ -0,0 +1,61 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <RGLFields.hpp>
+
+void ClusterBoxesPointsNode::enqueueExecImpl()
+{
+	size_t pointCount = input->getPointCount();
+	if (pointCount == 0) {
+		boxes->resize(0, false, false);
+		return;
+	}
+
+	const auto* points = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	const auto* clusterIds = input->getFieldDataTyped<CLUSTER_ID_I32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+
+	// Only the number of clusters is needed on the host, to size the output.
+	maxClusterId->resize(1, false, false);
+	maxClusterIdHost->resize(1, false, false);
+	gpuFindMaxClusterId(getStreamHandle(), pointCount, clusterIds, maxClusterId->getWritePtr());
+	CHECK_CUDA(cudaMemcpyAsync(maxClusterIdHost->getWritePtr(), maxClusterId->getReadPtr(), sizeof(int32_t),
+	                           cudaMemcpyDeviceToHost, getStreamHandle()));
+	CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+	const size_t clusterCount = maxClusterIdHost->at(0) + 1;
+
+	boxes->resize(clusterCount, false, false);
+	if (clusterCount == 0) {
+		return;
+	}
+	gpuComputeClusterBoxes(getStreamHandle(), pointCount, points, clusterIds, clusterCount, boxes->getWritePtr());
+}
+
+IAnyArray::ConstPtr ClusterBoxesPointsNode::getFieldData(rgl_field_t field)
+{
+	if (!hasField(field)) {
+		throw InvalidPipeline(fmt::format("{} does not provide {}", getName(), toString(field)));
+	}
+	return boxes;
+}
+
+std::size_t ClusterBoxesPointsNode::getFieldPointSize(rgl_field_t field) const
+{
+	if (field == RGL_FIELD_DYNAMIC_FORMAT) {
+		return sizeof(rgl_cluster_box_t);
+	}
+	return getFieldSize(field);
+}
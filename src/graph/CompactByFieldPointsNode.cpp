@@ -14,92 +14,41 @@
 
 #include <graph/NodesCore.hpp>
 #include <gpu/nodeKernels.hpp>
-#include <RGLFields.hpp>
 #include <repr.hpp>
-#include <graph/GraphRunCtx.hpp>
 
-void CompactByFieldPointsNode::setParameters(rgl_field_t field) { this->fieldToCompactBy = field; }
-
-void CompactByFieldPointsNode::validateImpl()
+void CompactByFieldPointsNode::setParameters(const std::vector<rgl_field_predicate_t>& predicates, bool matchAny)
 {
-	IPointsNodeSingleInput::validateImpl();
-	// Needed to clear cache because fields in the pipeline may have changed
-	// In fact, the cache manager is no longer useful here
-	// To be kept/removed in some future refactor (when resolving comment in the `enqueueExecImpl`)
-	cacheManager.clear();
+	this->predicates = predicates;
+	this->matchAny = matchAny;
 }
 
-
-void CompactByFieldPointsNode::enqueueExecImpl()
+std::vector<rgl_field_t> CompactByFieldPointsNode::getRequiredFieldList() const
 {
-	cacheManager.trigger();
-	inclusivePrefixSum->resize(input->getHeight() * input->getWidth(), false, false);
-	size_t pointCount = input->getWidth() * input->getHeight();
-
-	auto requestedFieldData = input->getFieldData(fieldToCompactBy);
-	auto typedRequestedFieldDataPtr = requestedFieldData->asTyped<int32_t>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
-
-	if (pointCount > 0) {
-		gpuFindCompaction(getStreamHandle(), pointCount, typedRequestedFieldDataPtr, inclusivePrefixSum->getWritePtr(), &width);
-	}
-
-	// getFieldData may be called in client's thread from rgl_graph_get_result_data
-	// Doing job there would be:
-	// - unexpected (job was supposed to be done asynchronously)
-	// - hard to implement:
-	//     - to avoid blocking on yet-running graph stream, we would need do it in copy stream, which would require
-	//       temporary rebinding DAAs to copy stream, which seems like nightmarish idea
-	// Therefore, once we know what fields are requested, we compute them eagerly
-	// This is supposed to be removed in some future refactor (e.g. when introducing LayeredSoA)
-	for (auto&& field : cacheManager.getKeys()) {
-		getFieldData(field);
+	std::vector<rgl_field_t> fields;
+	for (auto&& predicate : predicates) {
+		if (std::ranges::find(fields, predicate.field) == fields.end()) {
+			fields.push_back(predicate.field);
+		}
 	}
+	return fields;
 }
 
-IAnyArray::ConstPtr CompactByFieldPointsNode::getFieldData(rgl_field_t field)
+void CompactByFieldPointsNode::enqueueFindSelection(size_t pointCount, const Field<RAY_IDX_U32>::type* inputIndices)
 {
-	std::lock_guard lock{getFieldDataMutex};
-
-	if (!cacheManager.contains(field)) {
-		auto fieldData = createArray<DeviceAsyncArray>(field, arrayMgr);
-		cacheManager.insert(field, fieldData, true);
-	}
-
-	if (!cacheManager.isLatest(field)) {
-		auto fieldData = cacheManager.getValue(field);
-		fieldData->resize(width, false, false);
-		if (width > 0) {
-			char* outPtr = static_cast<char*>(fieldData->getRawWritePtr());
-			if (!isDeviceAccessible(input->getFieldData(field)->getMemoryKind())) {
-				auto msg = fmt::format("CompactByFieldPointsNode requires its input to be device-accessible, {} is not", field);
-				throw InvalidPipeline(msg);
-			}
-			const char* inputPtr = static_cast<const char*>(input->getFieldData(field)->getRawReadPtr());
-
-			auto requestedFieldData = input->getFieldData(fieldToCompactBy);
-			auto typedRequestedFieldDataPtr = requestedFieldData->asTyped<int32_t>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
-
-			const CompactionIndexType* indices = inclusivePrefixSum->getReadPtr();
-			gpuApplyCompaction(getStreamHandle(), input->getPointCount(), getFieldSize(field), typedRequestedFieldDataPtr, indices, outPtr,
-			                   inputPtr);
-			bool calledFromEnqueue = graphRunCtx.value()->isThisThreadGraphThread();
-			if (!calledFromEnqueue) {
-				// This is a special case, where API calls getFieldData for this field for the first time
-				// We did not enqueued compaction in enqueueExecImpl, yet, we are asked for results.
-				// This operation was enqueued in the graph stream, but API won't wait for whole graph stream.
-				// Therefore, we need a manual sync here.
-				// TODO: remove this cancer.
-				CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
-			}
+	// Field arrays may be reallocated between runs, so that their pointers are gathered in each run.
+	gpuPredicatesHost.clear();
+	for (auto&& predicate : predicates) {
+		auto fieldData = input->getFieldData(predicate.field);
+		if (!isDeviceAccessible(fieldData->getMemoryKind())) {
+			auto msg = fmt::format("{} requires its input to be device-accessible, {} is not", getName(), predicate.field);
+			throw InvalidPipeline(msg);
 		}
-		cacheManager.setUpdated(field);
+		const char* data = static_cast<const char*>(fieldData->getRawReadPtr());
+		gpuPredicatesHost.push_back({data, predicate.field, predicate.comparison, predicate.value});
 	}
-
-	return std::const_pointer_cast<const IAnyArray>(cacheManager.getValue(field));
-}
-
-size_t CompactByFieldPointsNode::getWidth() const
-{
-	this->synchronize();
-	return width;
+	gpuPredicates->copyFromExternal(gpuPredicatesHost.data(), gpuPredicatesHost.size());
+	gpuFindCompactionByPredicates(getStreamHandle(), pointCount, gpuPredicates->getReadPtr(),
+	                              static_cast<int32_t>(gpuPredicates->getCount()), matchAny, inputIndices,
+	                              selectionIndices->getWritePtr(), selectedCount->getWritePtr(),
+	                              compactionTempStorage->getWritePtr(), compactionTempStorage->getCount());
 }
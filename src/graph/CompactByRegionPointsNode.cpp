@@ -0,0 +1,30 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+
+void CompactByRegionPointsNode::setParameters(const rgl_region_t* regionsRaw, int32_t regionCount)
+{
+	regions->copyFromExternal(regionsRaw, regionCount);
+}
+
+void CompactByRegionPointsNode::enqueueFindSelection(size_t pointCount, const Field<RAY_IDX_U32>::type* inputIndices)
+{
+	auto xyz = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	auto regionCount = static_cast<int32_t>(regions->getCount());
+	gpuFindCompactionByRegions(getStreamHandle(), pointCount, xyz, regions->getReadPtr(), regionCount, inputIndices,
+	                           selectionIndices->getWritePtr(), selectedCount->getWritePtr(),
+	                           compactionTempStorage->getWritePtr(), compactionTempStorage->getCount());
+}
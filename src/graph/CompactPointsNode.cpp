@@ -0,0 +1,138 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <RGLFields.hpp>
+#include <repr.hpp>
+#include <graph/GraphRunCtx.hpp>
+
+void CompactPointsNode::validateImpl()
+{
+	IPointsNodeSingleInput::validateImpl();
+	// Needed to clear cache because fields in the pipeline may have changed
+	// In fact, the cache manager is no longer useful here
+	// To be kept/removed in some future refactor (when resolving comment in the `enqueueExecImpl`)
+	cacheManager.clear();
+}
+
+
+void CompactPointsNode::enqueueExecImpl()
+{
+	cacheManager.trigger();
+	size_t pointCount = input->getWidth() * input->getHeight();
+
+	// Selection of a selection refers directly to the source of the input (indices are composed),
+	// so that chained compactions gather each field once, from the source.
+	auto inputSelection = std::dynamic_pointer_cast<IPointsSelection>(input);
+	selectionSource = inputSelection != nullptr ? inputSelection->getSelectionSource() : input;
+
+	// Indices and count are produced in a single pass; indices are allocated for the upper bound (all points selected).
+	// If all consumers accept it, the count stays on the device, otherwise it is needed on host to size field arrays.
+	selectionIndices->resize(pointCount, false, false);
+	width = 0;
+	pointCountUpperBound = pointCount;
+	isPointCountDeferred = pointCount > 0 && canProvideDevicePointCount();
+	if (pointCount > 0) {
+		const Field<RAY_IDX_U32>::type* inputIndices = inputSelection != nullptr ? inputSelection->getSelectionIndicesPtr()
+		                                                                         : nullptr;
+		compactionTempStorage->resize(gpuFindCompactionTempStorageSize(pointCount), false, false);
+		selectedCount->resize(1, false, false);
+		selectedCountHost->resize(1, false, false);
+		enqueueFindSelection(pointCount, inputIndices);
+		CHECK_CUDA(cudaMemcpyAsync(selectedCountHost->getWritePtr(), selectedCount->getReadPtr(), sizeof(uint32_t),
+		                           cudaMemcpyDeviceToHost, getStreamHandle()));
+		if (!isPointCountDeferred) {
+			CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+			width = selectedCountHost->at(0);
+			selectionIndices->resize(width, false, true);
+		}
+	}
+
+	// getFieldData may be called in client's thread from rgl_graph_get_result_data
+	// Doing job there would be:
+	// - unexpected (job was supposed to be done asynchronously)
+	// - hard to implement:
+	//     - to avoid blocking on yet-running graph stream, we would need do it in copy stream, which would require
+	//       temporary rebinding DAAs to copy stream, which seems like nightmarish idea
+	// Therefore, once we know what fields are requested, we compute them eagerly
+	// Fields are gathered from the selection source, so this is cheap even for chained selections
+	for (auto&& field : cacheManager.getKeys()) {
+		getFieldData(field);
+	}
+}
+
+void CompactPointsNode::releaseIntermediates()
+{
+	// Count is kept, it may be read on host (or by consumers on the device) to learn the size of the results.
+	compactionTempStorage->release();
+	selectionIndices->release();
+	for (auto&& field : cacheManager.getKeys()) {
+		cacheManager.getValue(field)->release();
+	}
+}
+
+IAnyArray::ConstPtr CompactPointsNode::getFieldData(rgl_field_t field)
+{
+	// Outside of the graph thread, arrays are trimmed to the exact count, which requires waiting for the node.
+	bool trimToDeviceCount = isPointCountDeferred && hasGraphRunCtx() && !graphRunCtx.value()->isThisThreadGraphThread();
+	if (trimToDeviceCount) {
+		this->synchronize();
+	}
+
+	std::lock_guard lock{getFieldDataMutex};
+
+	if (!cacheManager.contains(field)) {
+		auto fieldData = createArray<DeviceAsyncArray>(field, arrayMgr);
+		cacheManager.insert(field, fieldData, true);
+	}
+
+	if (!cacheManager.isLatest(field)) {
+		auto fieldData = cacheManager.getValue(field);
+		size_t count = isPointCountDeferred ? pointCountUpperBound : width;
+		fieldData->resize(count, false, false);
+		if (count > 0) {
+			char* outPtr = static_cast<char*>(fieldData->getRawWritePtr());
+			auto sourceData = selectionSource->getFieldData(field);
+			if (!isDeviceAccessible(sourceData->getMemoryKind())) {
+				auto msg = fmt::format("{} requires its input to be device-accessible, {} is not", getName(), field);
+				throw InvalidPipeline(msg);
+			}
+			const char* sourcePtr = static_cast<const char*>(sourceData->getRawReadPtr());
+			gpuFilter(getStreamHandle(), count, getPointCountDevicePtr(), selectionIndices->getReadPtr(), outPtr, sourcePtr,
+			          getFieldSize(field));
+			bool calledFromEnqueue = graphRunCtx.value()->isThisThreadGraphThread();
+			if (!calledFromEnqueue) {
+				// This is a special case, where API calls getFieldData for this field for the first time
+				// We did not enqueued compaction in enqueueExecImpl, yet, we are asked for results.
+				// This operation was enqueued in the graph stream, but API won't wait for whole graph stream.
+				// Therefore, we need a manual sync here.
+				// TODO: remove this cancer.
+				CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+			}
+		}
+		cacheManager.setUpdated(field);
+	}
+
+	if (trimToDeviceCount) {
+		cacheManager.getValue(field)->resize(selectedCountHost->at(0), false, true);
+	}
+	return std::const_pointer_cast<const IAnyArray>(cacheManager.getValue(field));
+}
+
+size_t CompactPointsNode::getWidth() const
+{
+	this->synchronize();
+	return isPointCountDeferred ? selectedCountHost->at(0) : width;
+}
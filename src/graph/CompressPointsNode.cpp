@@ -0,0 +1,81 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+
+void CompressPointsNode::setParameters(float xyzStep) { this->xyzStep = xyzStep; }
+
+void CompressPointsNode::enqueueExecImpl()
+{
+	auto pointCount = input->getPointCount();
+	auto blockCount = gpuCompressedBlockCount(pointCount);
+	cudaStream_t streamHandle = getStreamHandle();
+
+	streamHeader->resize(1, false, false);
+	streamHeader->at(0) = {
+	    .magic = RGL_COMPRESSED_POINTS_MAGIC,
+	    .version = RGL_COMPRESSED_POINTS_VERSION,
+	    .point_count = static_cast<uint32_t>(pointCount),
+	    .xyz_step = xyzStep,
+	};
+	blocksSizeHost->resize(1, false, false);
+	blocksSizeHost->at(0) = 0;
+	if (blockCount > 0) {
+		deltas->resize(pointCount, false, false);
+		blockHeaders->resize(blockCount, false, false);
+		blockSizes->resize(blockCount + 1, false, false);
+		blockOffsets->resize(blockCount + 1, false, false);
+		scanTempStorage->resize(gpuScanCompressedBlockSizesTempStorageSize(blockCount), false, false);
+		auto points = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+		gpuEncodeCompressedBlocks(streamHandle, pointCount, points, xyzStep, deltas->getWritePtr(),
+		                          blockHeaders->getWritePtr(), blockSizes->getWritePtr());
+		gpuScanCompressedBlockSizes(streamHandle, blockCount, blockSizes->getReadPtr(), blockOffsets->getWritePtr(),
+		                            scanTempStorage->getWritePtr(), scanTempStorage->getCount());
+		CHECK_CUDA(cudaMemcpyAsync(blocksSizeHost->getWritePtr(), blockOffsets->getReadPtr() + blockCount, sizeof(uint32_t),
+		                           cudaMemcpyDeviceToHost, streamHandle));
+	}
+	// Size of the stream is needed to allocate it; the header copy below is complete after the wait as well.
+	CHECK_CUDA(cudaStreamSynchronize(streamHandle));
+
+	stream->resize(sizeof(rgl_compressed_points_header_t) + blocksSizeHost->at(0), false, false);
+	CHECK_CUDA(cudaMemcpyAsync(stream->getWritePtr(), streamHeader->getReadPtr(), sizeof(rgl_compressed_points_header_t),
+	                           cudaMemcpyHostToDevice, streamHandle));
+	gpuPackCompressedBlocks(streamHandle, pointCount, deltas->getReadPtr(), blockHeaders->getReadPtr(),
+	                        blockOffsets->getReadPtr(), stream->getWritePtr() + sizeof(rgl_compressed_points_header_t));
+}
+
+size_t CompressPointsNode::getWidth() const
+{
+	this->synchronize();
+	return stream->getCount();
+}
+
+IAnyArray::ConstPtr CompressPointsNode::getFieldData(rgl_field_t field)
+{
+	if (!hasField(field)) {
+		throw InvalidPipeline(fmt::format("{} does not provide {}", getName(), toString(field)));
+	}
+	return stream;
+}
+
+std::size_t CompressPointsNode::getFieldPointSize(rgl_field_t field) const
+{
+	if (field == RGL_FIELD_DYNAMIC_FORMAT) {
+		return sizeof(char);
+	}
+	return getFieldSize(field);
+}
+
+std::string CompressPointsNode::getArgsString() const { return fmt::format("xyzStep={}", xyzStep); }
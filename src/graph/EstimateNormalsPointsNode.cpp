@@ -0,0 +1,71 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <RGLFields.hpp>
+
+void EstimateNormalsPointsNode::enqueueExecImpl()
+{
+	size_t pointCount = input->getPointCount();
+	outNormals->resize(pointCount, false, false);
+	outCurvatures->resize(pointCount, false, false);
+	if (pointCount == 0) {
+		return;
+	}
+
+	const auto* points = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	const Field<IS_HIT_I32>::type* isHit = nullptr;
+	if (input->hasField(IS_HIT_I32)) {
+		isHit = input->getFieldDataTyped<IS_HIT_I32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	}
+	// Sensor origin in the frame of points.
+	Vec3f viewpoint = input->getLookAtOriginTransform().inverse().translation();
+
+	// Neighbouring rings and azimuths of organized point clouds are adjacent in rows and columns.
+	if (input->getHeight() > 1) {
+		gpuEstimateNormalsOrganized(getStreamHandle(), input->getWidth(), input->getHeight(), ORGANIZED_WINDOW_RADIUS, radius,
+		                            points, isHit, viewpoint, outNormals->getWritePtr(), outCurvatures->getWritePtr());
+		return;
+	}
+
+	// Otherwise, neighbours within the radius are in the 27 grid cells (of the radius size) around the point.
+	cellKeys->resize(pointCount, false, false);
+	sortedCellKeys->resize(pointCount, false, false);
+	pointIndices->resize(pointCount, false, false);
+	sortedPointIndices->resize(pointCount, false, false);
+	tempStorage->resize(gpuSortVoxelKeysTempStorageSize(pointCount), false, false);
+	gpuComputeVoxelKeys(getStreamHandle(), pointCount, points, Vec3f{radius}, nullptr, cellKeys->getWritePtr(),
+	                    pointIndices->getWritePtr());
+	gpuSortVoxelKeys(getStreamHandle(), pointCount, cellKeys->getReadPtr(), sortedCellKeys->getWritePtr(),
+	                 pointIndices->getReadPtr(), sortedPointIndices->getWritePtr(), tempStorage->getWritePtr(),
+	                 tempStorage->getCount());
+	gpuEstimateNormalsHashed(getStreamHandle(), pointCount, radius, points, isHit, sortedCellKeys->getReadPtr(),
+	                         sortedPointIndices->getReadPtr(), viewpoint, outNormals->getWritePtr(),
+	                         outCurvatures->getWritePtr());
+}
+
+IAnyArray::ConstPtr EstimateNormalsPointsNode::getFieldData(rgl_field_t field)
+{
+	if (field == NORMAL_VEC3_F32) {
+		return outNormals;
+	}
+	if (field == CURVATURE_F32) {
+		return outCurvatures;
+	}
+	return input->getFieldData(field);
+}
+
+std::string EstimateNormalsPointsNode::getArgsString() const { return fmt::format("radius={}", radius); }
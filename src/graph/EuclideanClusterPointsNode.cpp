@@ -0,0 +1,83 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <RGLFields.hpp>
+
+#include <algorithm>
+
+void EuclideanClusterPointsNode::setParameters(float tolerance, int32_t minClusterSize, int32_t maxClusterSize)
+{
+	this->tolerance = tolerance;
+	this->minClusterSize = minClusterSize;
+	this->maxClusterSize = maxClusterSize;
+}
+
+void EuclideanClusterPointsNode::enqueueExecImpl()
+{
+	size_t pointCount = input->getPointCount();
+	outClusterIds->resize(pointCount, false, false);
+	if (pointCount == 0) {
+		return;
+	}
+
+	const auto* points = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	const Field<IS_HIT_I32>::type* isHit = nullptr;
+	if (input->hasField(IS_HIT_I32)) {
+		isHit = input->getFieldDataTyped<IS_HIT_I32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	}
+
+	clusterParents->resize(pointCount, false, false);
+	clusterSizes->resize(pointCount, false, false);
+	isClusterRoot->resize(pointCount, false, false);
+	clusterRoots->resize(pointCount, false, false);
+	clusterCount->resize(1, false, false);
+	clusterIdOfRoot->resize(pointCount, false, false);
+	cellKeys->resize(pointCount, false, false);
+	sortedCellKeys->resize(pointCount, false, false);
+	pointIndices->resize(pointCount, false, false);
+	sortedPointIndices->resize(pointCount, false, false);
+	tempStorage->resize(std::max(gpuSortVoxelKeysTempStorageSize(pointCount), gpuFindCompactionTempStorageSize(pointCount)),
+	                    false, false);
+
+	// Connected components of points (linked when within the tolerance) are found on the device.
+	gpuEuclideanInitClusters(getStreamHandle(), pointCount, points, isHit, tolerance, clusterParents->getWritePtr(),
+	                         cellKeys->getWritePtr(), pointIndices->getWritePtr());
+	gpuSortVoxelKeys(getStreamHandle(), pointCount, cellKeys->getReadPtr(), sortedCellKeys->getWritePtr(),
+	                 pointIndices->getReadPtr(), sortedPointIndices->getWritePtr(), tempStorage->getWritePtr(),
+	                 tempStorage->getCount());
+	gpuEuclideanUniteClusters(getStreamHandle(), pointCount, tolerance, points, sortedCellKeys->getReadPtr(),
+	                          sortedPointIndices->getReadPtr(), clusterParents->getWritePtr());
+	gpuEuclideanFindClusterRoots(getStreamHandle(), pointCount, cellKeys->getReadPtr(), minClusterSize, maxClusterSize,
+	                             clusterParents->getWritePtr(), clusterSizes->getWritePtr(), isClusterRoot->getWritePtr());
+	gpuFindCompaction(getStreamHandle(), pointCount, isClusterRoot->getReadPtr(), nullptr, clusterRoots->getWritePtr(),
+	                  clusterCount->getWritePtr(), tempStorage->getWritePtr(), tempStorage->getCount());
+	gpuEuclideanWriteClusterIds(getStreamHandle(), pointCount, clusterCount->getReadPtr(), clusterRoots->getReadPtr(),
+	                            clusterParents->getReadPtr(), clusterIdOfRoot->getWritePtr(), outClusterIds->getWritePtr());
+}
+
+IAnyArray::ConstPtr EuclideanClusterPointsNode::getFieldData(rgl_field_t field)
+{
+	if (field == CLUSTER_ID_I32) {
+		return outClusterIds;
+	}
+	return input->getFieldData(field);
+}
+
+std::string EuclideanClusterPointsNode::getArgsString() const
+{
+	return fmt::format("tolerance={}, clusterSize=[{}, {}]", tolerance, minClusterSize, maxClusterSize);
+}
@@ -0,0 +1,58 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+
+void FilterGroundPlanePointsNode::setParameters(const Vec3f& sensorUpVector, float groundAngleThreshold,
+                                                float groundDistanceThreshold, float groundFilterDistance,
+                                                int32_t maxIterations)
+{
+	this->sensorUpVector = sensorUpVector;
+	this->groundAngleThreshold = groundAngleThreshold;
+	this->groundDistanceThreshold = groundDistanceThreshold;
+	this->groundFilterDistance = groundFilterDistance;
+	this->maxIterations = maxIterations;
+}
+
+void FilterGroundPlanePointsNode::enqueueExecImpl()
+{
+	auto pointCount = input->getPointCount();
+	outNonGround->resize(pointCount, false, false);
+	if (pointCount == 0) {
+		return;
+	}
+
+	hypothesisPlanes->resize(maxIterations, false, false);
+	hypothesisInlierCounts->resize(maxIterations, false, false);
+	groundPlane->resize(1, false, false);
+	groundPlaneInlierCount->resize(1, false, false);
+
+	// The plane is fitted and applied on the device, so nothing is copied to the host.
+	const auto* inXyzPtr = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	gpuFitGroundPlane(getStreamHandle(), pointCount, inXyzPtr, sensorUpVector, groundAngleThreshold, groundDistanceThreshold,
+	                  maxIterations, hypothesisPlanes->getWritePtr(), hypothesisInlierCounts->getWritePtr(),
+	                  groundPlane->getWritePtr(), groundPlaneInlierCount->getWritePtr());
+	gpuMarkGroundPlanePoints(getStreamHandle(), pointCount, inXyzPtr, groundPlane->getReadPtr(),
+	                         groundPlaneInlierCount->getReadPtr(), groundFilterDistance, outNonGround->getWritePtr());
+}
+
+IAnyArray::ConstPtr FilterGroundPlanePointsNode::getFieldData(rgl_field_t field)
+{
+	if (field == IS_GROUND_I32) {
+		return outNonGround;
+	}
+
+	return input->getFieldData(field);
+}
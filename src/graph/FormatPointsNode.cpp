@@ -25,13 +25,67 @@ void FormatPointsNode::setParameters(const std::vector<rgl_field_t>& fields)
 	this->fields = fields;
 }
 
+bool FormatPointsNode::acceptsPendingXyzTransform() const
+{
+	// The transform is applied to formatted XYZ only; the field itself is forwarded from the input (see getFieldData()),
+	// so consumers needing it and result buffers of it (copied in the graph thread) are given transformed XYZ.
+	auto needsXyz = [](const Node::Ptr& output) {
+		auto pointsOutput = std::dynamic_pointer_cast<IPointsNode>(output);
+		if (pointsOutput == nullptr) {
+			return true;
+		}
+		auto requiredFields = pointsOutput->getRequiredFieldList();
+		return std::ranges::find(requiredFields, XYZ_VEC3_F32) != requiredFields.end();
+	};
+	return std::ranges::count(fields, XYZ_VEC3_F32) <= 1 && !hasResultBuffer(XYZ_VEC3_F32) &&
+	       std::ranges::none_of(outputs, needsXyz);
+}
+
 void FormatPointsNode::enqueueExecImpl()
 {
-	formatAsync(output, input, fields, gpuFieldDescBuilder);
-	auto bytes = getPointSize(fields) * input->getPointCount();
+	// RaytraceNode may have written the points formatted already (see RaytraceNode::setFusedFormat)
+	auto raytraceInput = std::dynamic_pointer_cast<RaytraceNode>(input);
+	IAnyArray::ConstPtr formatted = raytraceInput != nullptr ? raytraceInput->getFusedFormatData() : nullptr;
+	std::size_t bytes = 0;
+	if (formatted != nullptr) {
+		std::size_t pointCount = getPointCountDevicePtr() != nullptr ? getPointCountUpperBound() : getPointCount();
+		bytes = pointCount * getPointSize(fields);
+	}
+	else {
+		formatAsync(output, input, fields, gpuFieldDescBuilder);
+		formatted = output;
+		bytes = output->getCount();
+	}
+	outputDevice = formatted;
+	outputHost = acquireOutputHostBuffer();
 	outputHost->resize(bytes, false, false);
-	CHECK_CUDA(cudaMemcpyAsync(outputHost->getRawWritePtr(), output->getRawReadPtr(), bytes, cudaMemcpyDeviceToHost,
+	CHECK_CUDA(cudaMemcpyAsync(outputHost->getRawWritePtr(), formatted->getRawReadPtr(), bytes, cudaMemcpyDeviceToHost,
 	                           getStreamHandle()));
+	PerformanceCounters::instance().addTransfer(false, true, bytes);
+}
+
+void FormatPointsNode::reserveArrays(std::size_t maxPointCount)
+{
+	std::size_t maxBytes = maxPointCount * getPointSize(fields);
+	output->reserve(maxBytes, false);
+	// Host buffers held by consumers are not reallocated under them.
+	for (auto&& buffer : outputHostBuffers) {
+		if (buffer.use_count() == (buffer == outputHost ? 2 : 1)) {
+			buffer->reserve(maxBytes, true);
+		}
+	}
+}
+
+HostPinnedArray<char>::Ptr FormatPointsNode::acquireOutputHostBuffer()
+{
+	// Without consumers holding it, the last frame's buffer is reused, as is the case of synchronous consumers.
+	outputHost.reset();
+	for (auto&& buffer : outputHostBuffers) {
+		if (buffer.use_count() == 1) {
+			return buffer;
+		}
+	}
+	return outputHostBuffers.emplace_back(HostPinnedArray<char>::create());
 }
 
 void FormatPointsNode::formatAsync(DeviceAsyncArray<char>::Ptr output, const IPointsNode::Ptr& input,
@@ -39,19 +93,45 @@ void FormatPointsNode::formatAsync(DeviceAsyncArray<char>::Ptr output, const IPo
 {
 	// Prepare output array
 	std::size_t pointSize = getPointSize(fields);
-	std::size_t pointCount = input->getPointCount();
+	const uint32_t* devicePointCount = input->getPointCountDevicePtr();
+	std::size_t pointCount = devicePointCount != nullptr ? input->getPointCountUpperBound() : input->getPointCount();
 	output->resize(pointCount * pointSize, false, false);
 
+	// Selection (e.g. compaction) followed by formatting is fused: points are gathered from the selection source in one pass,
+	// so that selected arrays of the formatted fields are not materialized.
+	if (auto selection = std::dynamic_pointer_cast<IPointsSelection>(input)) {
+		if (pointCount == 0) {
+			return;
+		}
+		auto fieldsData = getFieldToPointerMappings(selection->getSelectionSource(), fields);
+		const GPUFieldDescs& gpuFields = gpuFieldDescBuilder.buildReadableAsync(output->getStream(), fieldsData);
+		gpuFormatSoaToAosGathered(output->getStream()->getHandle(), pointCount, devicePointCount, pointSize, fields.size(),
+		                          gpuFields, selection->getSelectionIndicesPtr(), output->getWritePtr());
+		return;
+	}
+
+	// Transform chained before formatting is applied to formatted XYZ, see TransformPointsNode.
+	auto pendingXyzTransform = input->getPendingXyzTransform();
+	auto xyzIt = std::ranges::find(fields, XYZ_VEC3_F32);
+	int transformedFieldIdx = pendingXyzTransform.has_value() && xyzIt != fields.end() ?
+	                              static_cast<int>(std::distance(fields.begin(), xyzIt)) :
+	                              -1;
+
 	// Kernel Call
-	const GPUFieldDesc* gpuFieldsPtr =
-	    gpuFieldDescBuilder.buildReadableAsync(output->getStream(), getFieldToPointerMappings(input, fields)).getReadPtr();
+	const GPUFieldDescs& gpuFields =
+	    gpuFieldDescBuilder.buildReadableAsync(output->getStream(), getFieldToPointerMappings(input, fields));
 	char* outputPtr = output->getWritePtr();
-	gpuFormatSoaToAos(output->getStream()->getHandle(), pointCount, pointSize, fields.size(), gpuFieldsPtr, outputPtr);
+	gpuFormatSoaToAos(output->getStream()->getHandle(), pointCount, devicePointCount, pointSize, fields.size(), gpuFields,
+	                  outputPtr, transformedFieldIdx, pendingXyzTransform.value_or(Mat3x4f::identity()));
 }
 
 IAnyArray::ConstPtr FormatPointsNode::getFieldData(rgl_field_t field)
 {
 	if (field == RGL_FIELD_DYNAMIC_FORMAT) {
+		// Outside of the graph thread, the array is trimmed to the exact count (see IPointsNode::getPointCountDevicePtr())
+		if (getPointCountDevicePtr() != nullptr && hasGraphRunCtx() && !graphRunCtx.value()->isThisThreadGraphThread()) {
+			outputHost->resize(getPointCount() * getPointSize(fields), false, true);
+		}
 		return outputHost;
 	}
 	return input->getFieldData(field);
@@ -15,7 +15,8 @@
 #include <graph/GraphRunCtx.hpp>
 #include <graph/NodesCore.hpp>
 
-void FromArrayPointsNode::setParameters(const void* points, size_t pointCount, const std::vector<rgl_field_t>& fields)
+void FromArrayPointsNode::setParameters(const void* points, size_t pointCount, const std::vector<rgl_field_t>& fields,
+                                        bool isDeviceAccessible)
 {
 	if (std::find(fields.begin(), fields.end(), RGL_FIELD_DYNAMIC_FORMAT) != fields.end()) {
 		throw InvalidAPIArgument("cannot create point cloud from field 'RGL_FIELD_DYNAMIC_FORMAT'");
@@ -34,17 +35,41 @@ void FromArrayPointsNode::setParameters(const void* points, size_t pointCount, c
 		}
 	}
 
+	devicePoints = nullptr;
+	devicePointsFields.clear();
+	if (isDeviceAccessible) {
+		cudaPointerAttributes attributes{};
+		CHECK_CUDA(cudaPointerGetAttributes(&attributes, points));
+		if (attributes.type == cudaMemoryTypeUnregistered || attributes.devicePointer == nullptr) {
+			throw InvalidAPIArgument("points are not device-accessible (allocate them on the device or use cudaHostRegister)");
+		}
+		// Page-locked host memory may be mapped at a different device address.
+		devicePoints = static_cast<const char*>(attributes.devicePointer);
+		devicePointsFields = fields;
+		return;
+	}
+
 	auto inputData = DeviceSyncArray<char>::create();
 	std::size_t pointSize = getPointSize(fields);
 	inputData->copyFromExternal(static_cast<const char*>(points), pointCount * pointSize);
 	const char* inputPtr = inputData->getReadPtr();
 
 	auto&& gpuFields = gpuFieldDescBuilder.buildWritableAsync(arrayMgr.getStream(), getFieldToPointerMappings(fields));
-	gpuFormatAosToSoa(arrayMgr.getStream()->getHandle(), pointCount, pointSize, fields.size(), inputPtr,
-	                  gpuFields.getReadPtr());
+	gpuFormatAosToSoa(arrayMgr.getStream()->getHandle(), pointCount, pointSize, fields.size(), inputPtr, gpuFields);
 	CHECK_CUDA(cudaStreamSynchronize(arrayMgr.getStream()->getHandle()));
 }
 
+void FromArrayPointsNode::enqueueExecImpl()
+{
+	if (devicePoints == nullptr) {
+		return; // Fields were filled by setParameters
+	}
+	auto&& gpuFields = gpuFieldDescBuilder.buildWritableAsync(arrayMgr.getStream(),
+	                                                          getFieldToPointerMappings(devicePointsFields));
+	gpuFormatAosToSoa(getStreamHandle(), width, getPointSize(devicePointsFields), devicePointsFields.size(), devicePoints,
+	                  gpuFields);
+}
+
 std::vector<std::pair<rgl_field_t, void*>> FromArrayPointsNode::getFieldToPointerMappings(
     const std::vector<rgl_field_t>& fields)
 {
@@ -14,4 +14,8 @@
 
 #include <graph/NodesCore.hpp>
 
-void FromMat3x4fRaysNode::setParameters(const Mat3x4f* raysRaw, size_t rayCount) { rays->copyFromExternal(raysRaw, rayCount); }
+void FromMat3x4fRaysNode::setParameters(const Mat3x4f* raysRaw, size_t rayCount)
+{
+	rays = SharedDeviceArrays::acquire(raysRaw, rayCount);
+	raysHash = hashContent(raysRaw, rayCount);
+}
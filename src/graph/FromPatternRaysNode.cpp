@@ -0,0 +1,47 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <memory/ArrayCopyBatch.hpp>
+
+void FromPatternRaysNode::setParameters(const float* ringElevations, const float* ringTimeOffsets, size_t ringCount,
+                                        float azimuthStart, float azimuthStep, size_t azimuthStepCount, float azimuthStepTime)
+{
+	ArrayCopyBatch ringsCopy{this->ringElevations->getStream()};
+	ringsCopy.copyFromExternal<float>(this->ringElevations, ringElevations, ringCount);
+	ringsCopy.copyFromExternal<float>(this->ringTimeOffsets, ringTimeOffsets, ringCount);
+	ringsCopy.execute();
+	this->azimuthStart = azimuthStart;
+	this->azimuthStep = azimuthStep;
+	this->azimuthStepCount = azimuthStepCount;
+	this->azimuthStepTime = azimuthStepTime;
+
+	// Sized here, so that children see the ray count before the pattern is generated.
+	rays->resize(ringCount * azimuthStepCount, false, false);
+	ringIds->resize(ringCount * azimuthStepCount, false, false);
+	timeOffsets->resize(ringCount * azimuthStepCount, false, false);
+	isPatternGenerated = false;
+}
+
+void FromPatternRaysNode::enqueueExecImpl()
+{
+	if (isPatternGenerated) {
+		return;
+	}
+	gpuGenerateRaysFromPattern(getStreamHandle(), ringElevations->getCount(), azimuthStepCount, ringElevations->getReadPtr(),
+	                           ringTimeOffsets->getReadPtr(), azimuthStart, azimuthStep, azimuthStepTime, rays->getWritePtr(),
+	                           ringIds->getWritePtr(), timeOffsets->getWritePtr());
+	isPatternGenerated = true;
+}
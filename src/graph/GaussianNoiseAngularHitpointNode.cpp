@@ -12,7 +12,6 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <gpu/helpersKernels.hpp>
 #include <gpu/gaussianNoiseKernels.hpp>
 #include <graph/NodesCore.hpp>
 
@@ -42,33 +41,58 @@ void GaussianNoiseAngularHitpointNode::validateImpl()
 void GaussianNoiseAngularHitpointNode::enqueueExecImpl()
 {
 	auto pointCount = input->getPointCount();
-	outXyz->resize(pointCount, false, false);
+	inPlaceXyz = getInPlaceFieldData<XYZ_VEC3_F32>();
+	inPlaceDistance = getInPlaceFieldData<DISTANCE_F32>();
+	if (inPlaceXyz == nullptr) {
+		outXyz->resize(pointCount, false, false);
+	}
+	auto* outXyzPtr = inPlaceXyz != nullptr ? inPlaceXyz->getWritePtr() : outXyz->getWritePtr();
 
 	Field<DISTANCE_F32>::type* outDistancePtr = nullptr;
-	if (outDistance != nullptr) {
+	if (inPlaceDistance != nullptr) {
+		outDistancePtr = inPlaceDistance->getWritePtr();
+	} else if (outDistance != nullptr) {
 		outDistance->resize(pointCount, false, false);
 		outDistancePtr = outDistance->getWritePtr();
 	}
 
-	if (randomizationStates->getCount() < pointCount) {
-		randomizationStates->resize(pointCount, false, false);
-		gpuSetupRandomNumberGenerator(getStreamHandle(), pointCount, randomDevice(), randomizationStates->getWritePtr());
-	}
-
 	const auto* inXyzPtr = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
-	auto* outXyzPtr = outXyz->getWritePtr();
-	auto* randPtr = randomizationStates->getWritePtr();
 	gpuAddGaussianNoiseAngularHitpoint(getStreamHandle(), pointCount, mean, stDev, rotationAxis,
-	                                   input->getLookAtOriginTransform(), randPtr, inXyzPtr, outXyzPtr, outDistancePtr);
+	                                   input->getLookAtOriginTransform(), randomSeed, randomFrameIdx++, inXyzPtr, outXyzPtr,
+	                                   outDistancePtr);
+}
+
+void GaussianNoiseAngularHitpointNode::releaseIntermediates()
+{
+	outXyz->release();
+	if (outDistance != nullptr) {
+		outDistance->release();
+	}
+}
+
+std::vector<rgl_field_t> GaussianNoiseAngularHitpointNode::getIntermediateFieldList() const
+{
+	if (outDistance != nullptr) {
+		return {XYZ_VEC3_F32, DISTANCE_F32};
+	}
+	return {XYZ_VEC3_F32};
 }
 
 IAnyArray::ConstPtr GaussianNoiseAngularHitpointNode::getFieldData(rgl_field_t field)
+{
+	if (auto ownedField = getOwnedFieldData(field)) {
+		return ownedField;
+	}
+	return input->getFieldData(field);
+}
+
+IAnyArray::Ptr GaussianNoiseAngularHitpointNode::getOwnedFieldData(rgl_field_t field)
 {
 	if (field == XYZ_VEC3_F32) {
-		return outXyz;
+		return inPlaceXyz != nullptr ? inPlaceXyz : outXyz;
 	}
 	if (field == DISTANCE_F32 && outDistance != nullptr) {
-		return outDistance;
+		return inPlaceDistance != nullptr ? inPlaceDistance : outDistance;
 	}
-	return input->getFieldData(field);
+	return nullptr;
 }
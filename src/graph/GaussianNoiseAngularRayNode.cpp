@@ -12,7 +12,6 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <gpu/helpersKernels.hpp>
 #include <gpu/gaussianNoiseKernels.hpp>
 #include <graph/NodesCore.hpp>
 
@@ -27,16 +26,21 @@ void GaussianNoiseAngularRaysNode::enqueueExecImpl()
 {
 	// In case rays have changed
 	auto rayCount = input->getRayCount();
-	rays->resize(rayCount, false, false);
 
-	if (randomizationStates->getCount() < rayCount) {
-		randomizationStates->resize(rayCount, false, false);
-		gpuSetupRandomNumberGenerator(getStreamHandle(), rayCount, randomDevice(), randomizationStates->getWritePtr());
+	// Directions are given in the ray origin frame (lookAt origin), where angular noise is applied.
+	if (auto inDirections = input->getRayDirections(); inDirections.has_value()) {
+		directions->resize(rayCount, false, false);
+		const auto* inDirectionsPtr = (*inDirections)->asSubclass<DeviceAsyncArray>()->getReadPtr();
+		gpuAddGaussianNoiseAngularRayDirections(getStreamHandle(), rayCount, mean, stDev, rotationAxis, randomSeed,
+		                                        randomFrameIdx++, inDirectionsPtr, directions->getWritePtr());
+		return;
 	}
 
+	rays->resize(rayCount, false, false);
+
 	const auto* inRaysPtr = input->getRays()->asSubclass<DeviceAsyncArray>()->getReadPtr();
 	auto* outRaysPtr = rays->getWritePtr();
-	auto* randPtr = randomizationStates->getWritePtr();
 	gpuAddGaussianNoiseAngularRay(getStreamHandle(), getRayCount(), mean, stDev, rotationAxis,
-	                              input->getCumulativeRayTransfrom().inverse(), randPtr, inRaysPtr, outRaysPtr);
+	                              input->getCumulativeRayTransfrom().inverse(), randomSeed, randomFrameIdx++, inRaysPtr,
+	                              outRaysPtr);
 }
@@ -14,7 +14,6 @@
 
 #include <graph/NodesCore.hpp>
 #include <gpu/gaussianNoiseKernels.hpp>
-#include <gpu/helpersKernels.hpp>
 
 void GaussianNoiseDistanceNode::setParameters(float mean, float stDevBase, float stDevRisePerMeter)
 {
@@ -26,30 +25,39 @@ void GaussianNoiseDistanceNode::setParameters(float mean, float stDevBase, float
 void GaussianNoiseDistanceNode::enqueueExecImpl()
 {
 	auto pointCount = input->getPointCount();
-	outXyz->resize(pointCount, false, false);
-	outDistance->resize(pointCount, false, false);
-
-	if (randomizationStates->getCount() < pointCount) {
-		randomizationStates->resize(pointCount, false, false);
-		gpuSetupRandomNumberGenerator(getStreamHandle(), pointCount, randomDevice(), randomizationStates->getWritePtr());
+	inPlaceXyz = getInPlaceFieldData<XYZ_VEC3_F32>();
+	inPlaceDistance = getInPlaceFieldData<DISTANCE_F32>();
+	if (inPlaceXyz == nullptr) {
+		outXyz->resize(pointCount, false, false);
+	}
+	if (inPlaceDistance == nullptr) {
+		outDistance->resize(pointCount, false, false);
 	}
 
 	const auto* inXyzPtr = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
 	const auto* inDistancePtr = input->getFieldDataTyped<DISTANCE_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
-	auto* outXyzPtr = outXyz->getWritePtr();
-	auto* outDistancePtr = outDistance->getWritePtr();
-	auto* randPtr = randomizationStates->getWritePtr();
+	auto* outXyzPtr = inPlaceXyz != nullptr ? inPlaceXyz->getWritePtr() : outXyz->getWritePtr();
+	auto* outDistancePtr = inPlaceDistance != nullptr ? inPlaceDistance->getWritePtr() : outDistance->getWritePtr();
 	gpuAddGaussianNoiseDistance(getStreamHandle(), pointCount, mean, stDevBase, stDevRisePerMeter,
-	                            input->getLookAtOriginTransform(), randPtr, inXyzPtr, inDistancePtr, outXyzPtr, outDistancePtr);
+	                            input->getLookAtOriginTransform(), randomSeed, randomFrameIdx++, inXyzPtr, inDistancePtr,
+	                            outXyzPtr, outDistancePtr);
 }
 
 IAnyArray::ConstPtr GaussianNoiseDistanceNode::getFieldData(rgl_field_t field)
+{
+	if (field == XYZ_VEC3_F32 || field == DISTANCE_F32) {
+		return getOwnedFieldData(field);
+	}
+	return input->getFieldData(field);
+}
+
+IAnyArray::Ptr GaussianNoiseDistanceNode::getOwnedFieldData(rgl_field_t field)
 {
 	if (field == XYZ_VEC3_F32) {
-		return outXyz;
+		return inPlaceXyz != nullptr ? inPlaceXyz : outXyz;
 	}
 	if (field == DISTANCE_F32) {
-		return outDistance;
+		return inPlaceDistance != nullptr ? inPlaceDistance : outDistance;
 	}
-	return input->getFieldData(field);
+	return nullptr;
 }
@@ -0,0 +1,109 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gpu/gaussianNoiseKernels.hpp>
+#include <graph/NodesCore.hpp>
+
+void GaussianNoiseTransformPointsNode::setParameters(float angularMean, float angularStDev, rgl_axis_t angularAxis,
+                                                     float distanceMean, float distanceStDevBase,
+                                                     float distanceStDevRisePerMeter, Mat3x4f transform)
+{
+	this->angularMean = angularMean;
+	this->angularStDev = angularStDev;
+	this->angularAxis = angularAxis;
+	this->distanceMean = distanceMean;
+	this->distanceStDevBase = distanceStDevBase;
+	this->distanceStDevRisePerMeter = distanceStDevRisePerMeter;
+	this->transform = transform;
+}
+
+void GaussianNoiseTransformPointsNode::validateImpl()
+{
+	IPointsNodeSingleInput::validateImpl();
+
+	// Same as GaussianNoiseAngularHitpointNode, DISTANCE_F32 is modified only if present.
+	if (input->hasField(DISTANCE_F32)) {
+		if (outDistance == nullptr) {
+			outDistance = DeviceAsyncArray<Field<DISTANCE_F32>::type>::create(arrayMgr);
+		}
+	} else {
+		outDistance.reset();
+	}
+}
+
+void GaussianNoiseTransformPointsNode::enqueueExecImpl()
+{
+	auto pointCount = input->getPointCount();
+	inPlaceXyz = getInPlaceFieldData<XYZ_VEC3_F32>();
+	inPlaceDistance = getInPlaceFieldData<DISTANCE_F32>();
+	if (inPlaceXyz == nullptr) {
+		outXyz->resize(pointCount, false, false);
+	}
+	auto* outXyzPtr = inPlaceXyz != nullptr ? inPlaceXyz->getWritePtr() : outXyz->getWritePtr();
+
+	Field<DISTANCE_F32>::type* outDistancePtr = nullptr;
+	if (inPlaceDistance != nullptr) {
+		outDistancePtr = inPlaceDistance->getWritePtr();
+	} else if (outDistance != nullptr) {
+		outDistance->resize(pointCount, false, false);
+		outDistancePtr = outDistance->getWritePtr();
+	}
+
+	GaussianNoisePointsParams noise = {
+	    .angularMean = angularMean,
+	    .angularStDev = angularStDev,
+	    .angularAxis = angularAxis,
+	    .distanceMean = distanceMean,
+	    .distanceStDevBase = distanceStDevBase,
+	    .distanceStDevRisePerMeter = distanceStDevRisePerMeter,
+	};
+	const auto* inXyzPtr = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	gpuAddGaussianNoiseTransformPoints(getStreamHandle(), pointCount, noise, transform, input->getLookAtOriginTransform(),
+	                                   randomSeed, randomFrameIdx++, inXyzPtr, outXyzPtr, outDistancePtr);
+}
+
+void GaussianNoiseTransformPointsNode::releaseIntermediates()
+{
+	outXyz->release();
+	if (outDistance != nullptr) {
+		outDistance->release();
+	}
+}
+
+std::vector<rgl_field_t> GaussianNoiseTransformPointsNode::getIntermediateFieldList() const
+{
+	if (outDistance != nullptr) {
+		return {XYZ_VEC3_F32, DISTANCE_F32};
+	}
+	return {XYZ_VEC3_F32};
+}
+
+IAnyArray::ConstPtr GaussianNoiseTransformPointsNode::getFieldData(rgl_field_t field)
+{
+	if (auto ownedField = getOwnedFieldData(field)) {
+		return ownedField;
+	}
+	return input->getFieldData(field);
+}
+
+IAnyArray::Ptr GaussianNoiseTransformPointsNode::getOwnedFieldData(rgl_field_t field)
+{
+	if (field == XYZ_VEC3_F32) {
+		return inPlaceXyz != nullptr ? inPlaceXyz : outXyz;
+	}
+	if (field == DISTANCE_F32 && outDistance != nullptr) {
+		return inPlaceDistance != nullptr ? inPlaceDistance : outDistance;
+	}
+	return nullptr;
+}
@@ -17,8 +17,17 @@
 #include <graph/Node.hpp>
 #include <macros/dataDeclspec.hpp>
 #include <NvtxWrappers.hpp>
+#include <PerformanceCounters.hpp>
+#include <scene/Scene.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
 
 DATA_DECLSPEC std::list<std::shared_ptr<GraphRunCtx>> GraphRunCtx::instances;
+DATA_DECLSPEC std::mutex GraphRunCtx::instancesMutex;
+DATA_DECLSPEC std::recursive_mutex GraphRunCtx::detachedGraphsMutex;
+DATA_DECLSPEC std::shared_mutex GraphRunCtx::runsMutex;
 
 std::shared_ptr<GraphRunCtx> GraphRunCtx::createAndAttach(std::shared_ptr<Node> node)
 {
@@ -32,6 +41,14 @@ std::shared_ptr<GraphRunCtx> GraphRunCtx::createAndAttach(std::shared_ptr<Node>
 			                       currentNode->getName(), node->getName());
 			throw std::logic_error(msg);
 		}
+	}
+	graphRunCtx->streamPriority = graphRunCtx->getCudaStreamPriority();
+	graphRunCtx->assignStreams(findExecutionOrder(graphRunCtx->nodes));
+	for (auto&& currentNode : graphRunCtx->nodes) {
+		graphRunCtx->frameId = std::max(graphRunCtx->frameId, currentNode->getResultFrameId());
+	}
+	std::lock_guard instancesLock{instancesMutex};
+	for (auto&& currentNode : graphRunCtx->nodes) {
 		currentNode->setGraphRunCtx(graphRunCtx);
 	}
 
@@ -41,97 +58,544 @@ std::shared_ptr<GraphRunCtx> GraphRunCtx::createAndAttach(std::shared_ptr<Node>
 	return graphRunCtx;
 }
 
+GraphRunCtx::ClientLock GraphRunCtx::lockGraphOf(const Node::Ptr& node)
+{
+	while (true) {
+		std::shared_ptr<GraphRunCtx> ctx;
+		{
+			std::lock_guard instancesLock{instancesMutex};
+			if (node->hasGraphRunCtx()) {
+				ctx = node->getGraphRunCtx();
+			}
+		}
+		std::unique_lock lock{ctx != nullptr ? ctx->clientMutex : detachedGraphsMutex};
+		// GraphRunCtx may have been created (by the first run) or destroyed in the meantime.
+		std::lock_guard instancesLock{instancesMutex};
+		if ((node->hasGraphRunCtx() ? node->getGraphRunCtx() : nullptr) == ctx) {
+			return {std::move(ctx), std::move(lock)};
+		}
+	}
+}
+
+void GraphRunCtx::run(const Node::Ptr& node)
+{
+	std::shared_lock runsLock{runsMutex};
+	{
+		std::lock_guard detachedLock{detachedGraphsMutex};
+		if (!node->hasGraphRunCtx()) {
+			createAndAttach(node);
+		}
+	}
+	auto [ctx, lock] = lockGraphOf(node);
+	if (ctx == nullptr) {
+		throw InvalidPipeline(fmt::format("structure of the graph of {} was changed while running it", node->getName()));
+	}
+	if (ctx->tryDropFrame()) {
+		return;
+	}
+	ctx->executeAsync();
+}
+
+void GraphRunCtx::prepare(const Node::Ptr& node, std::size_t maxPointCount)
+{
+	std::shared_lock runsLock{runsMutex};
+	{
+		std::lock_guard detachedLock{detachedGraphsMutex};
+		if (!node->hasGraphRunCtx()) {
+			createAndAttach(node);
+		}
+	}
+	auto [ctx, lock] = lockGraphOf(node);
+	if (ctx == nullptr) {
+		throw InvalidPipeline(fmt::format("structure of the graph of {} was changed while preparing it", node->getName()));
+	}
+	ctx->prepareExecution();
+	for (auto&& current : ctx->executionOrder) {
+		current->reserveArrays(maxPointCount);
+	}
+	for (auto&& stream : ctx->streams) {
+		CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+	}
+}
+
+void GraphRunCtx::runBatch(const std::vector<Node::Ptr>& nodes)
+{
+	std::shared_lock runsLock{runsMutex};
+	{
+		std::lock_guard detachedLock{detachedGraphsMutex};
+		for (auto&& node : nodes) {
+			if (!node->hasGraphRunCtx()) {
+				createAndAttach(node);
+			}
+		}
+	}
+	// Graphs are locked in the order of their GraphRunCtx addresses, so that overlapping batches do not deadlock.
+	std::map<GraphRunCtx*, Node::Ptr> graphNodes;
+	{
+		std::lock_guard instancesLock{instancesMutex};
+		for (auto&& node : nodes) {
+			if (node->hasGraphRunCtx()) {
+				graphNodes.try_emplace(node->getGraphRunCtx().get(), node);
+			}
+		}
+	}
+	std::vector<ClientLock> locks;
+	for (auto&& [expectedCtx, node] : graphNodes) {
+		locks.push_back(lockGraphOf(node));
+		if (locks.back().ctx.get() != expectedCtx) {
+			throw InvalidPipeline(fmt::format("structure of the graph of {} was changed while running it", node->getName()));
+		}
+		if (locks.back().ctx->tryDropFrame()) {
+			locks.pop_back();
+		}
+	}
+
+	// All graphs are validated before any of them is submitted, so that an invalid graph does not run the others.
+	std::vector<std::shared_ptr<Scene>> runScenes;
+	std::map<Scene*, std::size_t> sceneGraphCounts;
+	for (auto&& [ctx, lock] : locks) {
+		runScenes.push_back(ctx->prepareExecution());
+		if (runScenes.back() != nullptr) {
+			sceneGraphCounts[runScenes.back().get()] += 1;
+		}
+	}
+	// Graphs raytracing the same scene share its version, which is prepared once.
+	std::map<Scene*, std::vector<SceneSnapshot>> sceneSnapshots;
+	for (std::size_t graphIdx = 0; graphIdx < locks.size(); ++graphIdx) {
+		std::optional<SceneSnapshot> runSnapshot;
+		if (Scene* runScene = runScenes[graphIdx].get(); runScene != nullptr) {
+			auto [it, isFirst] = sceneSnapshots.try_emplace(runScene);
+			if (isFirst) {
+				it->second = runScene->acquireSnapshotsLocked(sceneGraphCounts.at(runScene));
+			}
+			runSnapshot = std::move(it->second.back());
+			it->second.pop_back();
+		}
+		locks[graphIdx].ctx->submitExecution(std::move(runScenes[graphIdx]), std::move(runSnapshot));
+	}
+}
+
 void GraphRunCtx::executeAsync()
+{
+	std::shared_ptr<Scene> runScene = prepareExecution();
+	std::optional<SceneSnapshot> runSnapshot;
+	if (runScene != nullptr) {
+		runSnapshot = runScene->acquireSnapshotLocked();
+	}
+	submitExecution(std::move(runScene), std::move(runSnapshot));
+}
+
+std::shared_ptr<Scene> GraphRunCtx::prepareExecution()
 {
 	synchronize(); // Wait until previous execution is completed
 
-	if (executionOrder.empty()) {
-		executionOrder = GraphRunCtx::findExecutionOrder(nodes);
+	std::shared_ptr<Scene> runScene = findScene();
+	bool isBatchingEnabled = runScene != nullptr && runScene->isRaytraceBatchingEnabled();
+	bool isExecutionOrderChanged = executionOrder.empty() || isExecutionOrderBatched != isBatchingEnabled ||
+	                               isTopologyChanged;
+	if (isExecutionOrderChanged) {
+		// Priorities may have changed; nodes' arrays are bound to streams recreated with the new one.
+		if (int cudaStreamPriority = getCudaStreamPriority(); cudaStreamPriority != streamPriority) {
+			streamPriority = cudaStreamPriority;
+			streams.clear();
+			nodeStreams.clear();
+			assignStreams(findExecutionOrder(nodes));
+			std::lock_guard instancesLock{instancesMutex};
+			for (auto&& node : nodes) {
+				node->setGraphRunCtx(shared_from_this());
+			}
+		}
+		// Order updated by attaching or detaching nodes is kept; RaytraceNodes are regrouped.
+		if (executionOrder.empty() || isExecutionOrderBatched != isBatchingEnabled) {
+			executionOrder = GraphRunCtx::findExecutionOrder(nodes);
+		}
+		isTopologyChanged = false;
+		raytraceBatch = isBatchingEnabled ? GraphRunCtx::groupRaytraceNodes(executionOrder) : std::vector<RaytraceNode::Ptr>{};
+		isExecutionOrderBatched = isBatchingEnabled;
+		for (auto&& segment : capturedSegments) {
+			segment.reset();
+		}
+		capturedSegments = findCapturedSegments();
+	}
+
+	// Modified nodes may have changed parameters, buffers or outputs; captured work cannot be reused.
+	bool isAnyNodeModified = std::ranges::any_of(executionOrder, [](const Node::Ptr& node) { return !node->isValid(); });
+	if (isAnyNodeModified) {
+		for (auto&& segment : capturedSegments) {
+			segment.reset();
+			segment.inputSizes.clear();
+		}
 	}
 
 	// Perform validation in client's thread, this makes error reporting easier.
-	for (auto&& current : executionOrder) {
-		RGL_DEBUG("Validating node: {}", *current);
-		current->validate();
+	// If no node was modified since the previous run, the graph is still valid.
+	if (isAnyNodeModified) {
+		for (auto&& current : executionOrder) {
+			RGL_DEBUG("Validating node: {}", *current);
+			current->validate();
+		}
+		RGL_DEBUG("Node validation completed"); // This also logs the time diff for the last one.
 	}
-	RGL_DEBUG("Node validation completed"); // This also logs the time diff for the last one.
+
+	// Fields consumed by nodes (and backed by their intermediates) are known once they are validated.
+	if (isExecutionOrderChanged || isAnyNodeModified) {
+		planIntermediateReleases();
+	}
+	return runScene;
+}
+
+void GraphRunCtx::submitExecution(std::shared_ptr<Scene> runScene, std::optional<SceneSnapshot> runSnapshot)
+{
+	frameId += 1;
 
 	// Clear execution states
 	executionStatus.clear();
 	for (auto&& node : executionOrder) {
 		executionStatus.try_emplace(node);
 	}
-	execThreadCanStart.store(false, std::memory_order_relaxed);
 
-	// TODO: this also applies to validation and executionStatus clearing
-	// In other parts of the code we rely on the following logic
-	// IF graph thread is working THEN this->thread.has_value()
-	// However, there is a very tight gap, where this is not true,
-	// because the graph thread could start before maybeThread is assigned.
-	// Therefore, the graph thread waits for execThreadCanStart
-	// which is set to true after client maybeThread has been assigned.
-	maybeThread = std::thread(&GraphRunCtx::executeThreadMain, this);
-	execThreadCanStart.store(true, std::memory_order::release);
+	// Scene version is fixed before scheduling, so that scene edits made during the run do not affect it.
+	if (runScene != nullptr) {
+		sceneSnapshot = std::move(runSnapshot);
+		scene = std::move(runScene);
+	}
+
+	isRunning = true;
+	{
+		std::lock_guard lock{workerMutex};
+		isRunRequested = true;
+	}
+	// The job keeps this GraphRunCtx alive until the scheduler's thread is done with it.
+	auto submitTime = std::chrono::steady_clock::now();
+	GraphScheduler::instance().submit(this, getPriority(), [self = shared_from_this(), submitTime]() {
+		self->executeThreadMain();
+		if (MetricsExporter::instance().isEnabled()) {
+			self->enqueueRunLatencyMeasurement(submitTime);
+		}
+		self->releaseSceneSnapshot();
+		{
+			std::lock_guard lock{self->workerMutex};
+			self->isRunRequested = false;
+		}
+		self->workerCondition.notify_all();
+	});
+}
+
+void GraphRunCtx::enqueueRunLatencyMeasurement(std::chrono::steady_clock::time_point submitTime)
+{
+	if (runLatency == nullptr) {
+		runLatency = MetricsExporter::instance().createRunLatencyHistogram(graphOrdinal);
+	}
+	struct Measurement
+	{
+		std::shared_ptr<MetricsExporter::RunLatencyHistogram> histogram;
+		std::chrono::steady_clock::time_point submitTime;
+		std::atomic<std::size_t> pendingStreamCount;
+	};
+	// Host functions only touch the measurement (they must not call CUDA); the last one completes it.
+	auto onStreamCompleted = [](void* data) {
+		auto* measurement = static_cast<Measurement*>(data);
+		if (measurement->pendingStreamCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			measurement->histogram->add(std::chrono::steady_clock::now() - measurement->submitTime);
+			delete measurement;
+		}
+	};
+	if (streams.empty()) {
+		runLatency->add(std::chrono::steady_clock::now() - submitTime);
+		return;
+	}
+	auto* measurement = new Measurement{runLatency, submitTime, streams.size()};
+	for (auto&& stream : streams) {
+		CHECK_CUDA(cudaLaunchHostFunc(stream->getHandle(), onStreamCompleted, measurement));
+	}
+}
+
+int32_t GraphRunCtx::getPriority() const
+{
+	return std::ranges::max(nodes | std::views::transform([](const Node::Ptr& node) { return node->getPriority(); }));
 }
 
+bool GraphRunCtx::tryDropFrame()
+{
+	bool isFrameDroppingEnabled = std::ranges::any_of(nodes, [](const Node::Ptr& node) {
+		return node->isFrameDroppingEnabled();
+	});
+	if (!isFrameDroppingEnabled || !isRunInProgress()) {
+		return false;
+	}
+	droppedFrameCount += 1;
+	RGL_DEBUG("Graph {} dropped frame (total: {}), because the previous run is still in progress", graphOrdinal,
+	          droppedFrameCount);
+	return true;
+}
 
-void GraphRunCtx::executeThreadMain()
-try {
-	// Wait for trigger from the client's thread
-	while (!execThreadCanStart.load(std::memory_order::acquire))
-		;
+bool GraphRunCtx::isRunInProgress()
+{
+	if (!isRunning) {
+		return false;
+	}
+	{
+		std::lock_guard lock{workerMutex};
+		if (isRunRequested || auxiliaryJobCount > 0) {
+			return true;
+		}
+	}
+	return std::ranges::any_of(streams, [](const CudaStream::Ptr& stream) {
+		cudaError_t status = cudaStreamQuery(stream->getHandle());
+		if (status == cudaErrorNotReady) {
+			return true;
+		}
+		CHECK_CUDA(status);
+		return false;
+	});
+}
 
-	for (auto&& node : executionOrder) {
-		RGL_DEBUG("Enqueueing node: {}", *node);
-		NvtxRange rg{graphOrdinal, NVTX_COL_WORK, "Enqueue({})", node->getName()};
-		node->enqueueExec();
-		executionStatus.at(node).enqueued.store(true);
-		executionStatus.at(node).enqueued.notify_all();
-	}
-	RGL_DEBUG("Node enqueueing done"); // This also logs the time diff for the last one
-}
-catch (...) {
-	// Exception most likely happened in a Node, but might have happened around executionOrder loop.
-	// We still need to communicate that nodes 'executed' (even though some may not have a chance to start).
-	// If we didn't, we could hang client's thread in synchronizeNodeCPU() waiting for a Node that will never run.
-	for (auto&& [node, state] : executionStatus) {
-		if (state.enqueued.load(std::memory_order::relaxed)) {
-			continue;
+int32_t GraphRunCtx::getStreamPriorityLevel() const
+{
+	std::optional<int32_t> gpuPriority;
+	for (auto&& node : nodes) {
+		if (auto nodeGpuPriority = node->getGpuPriority(); nodeGpuPriority.has_value()) {
+			gpuPriority = std::max(gpuPriority.value_or(*nodeGpuPriority), *nodeGpuPriority);
 		}
-		state.exceptionPtr = std::current_exception();
-		state.enqueued.store(true);
-		state.enqueued.notify_all();
 	}
+	return gpuPriority.value_or(getPriority());
 }
 
-std::vector<std::shared_ptr<Node>> GraphRunCtx::findExecutionOrder(std::set<std::shared_ptr<Node>> nodes)
+int GraphRunCtx::getCudaStreamPriority() const
 {
-	// Nodes already present in this vector need to be executed after the ones that are added later.
-	std::vector<std::shared_ptr<Node>> reverseOrder{};
-	std::function<void(std::shared_ptr<Node>)> dfsRec = [&](std::shared_ptr<Node> current) {
-		nodes.erase(current);
-		for (auto it = current->getOutputs().rbegin(); it != current->getOutputs().rend(); ++it) {
-			const auto& outputNode = *it;
-			if (nodes.contains(outputNode)) {
-				dfsRec(outputNode);
+	int leastPriority = 0, greatestPriority = 0;
+	CHECK_CUDA(cudaDeviceGetStreamPriorityRange(&leastPriority, &greatestPriority));
+	return leastPriority - std::clamp(getStreamPriorityLevel(), 0, leastPriority - greatestPriority);
+}
+
+void GraphRunCtx::executeThreadMain()
+{
+	auto markEnqueued = [this](const Node::Ptr& node) {
+		node->resultFrameId = frameId;
+		markNodeEnqueued(executionStatus.at(node));
+	};
+	std::unordered_map<Node::ConstPtr, std::shared_future<void>> hostComputeJobs;
+	try {
+		auto enqueueNode = [&](const Node::Ptr& node) {
+			if (node->isHostCompute()) {
+				RGL_DEBUG("Submitting host compute node: {}", *node);
+				hostComputeJobs.emplace(node, submitHostCompute(node));
+				return;
+			}
+			RGL_DEBUG("Enqueueing node: {}", *node);
+			NvtxRange rg{graphOrdinal, NVTX_COL_WORK, "Enqueue({})", node->getName()};
+			enqueueWaitForInputs(node);
+			node->enqueueExec();
+			markEnqueued(node);
+		};
+		// Nodes depending on host compute nodes (never part of captured segments) are deferred,
+		// so that independent work does not wait for CPU processing.
+		std::set<Node::Ptr> pendingNodes;
+		std::vector<Node::Ptr> deferredNodes;
+		auto nextSegment = capturedSegments.begin();
+		for (std::size_t nodeIdx = 0; nodeIdx < executionOrder.size();) {
+			if (nextSegment != capturedSegments.end() && nextSegment->beginIdx == nodeIdx) {
+				enqueueSegment(*nextSegment);
+				for (; nodeIdx < nextSegment->endIdx; ++nodeIdx) {
+					markEnqueued(executionOrder[nodeIdx]);
+				}
+				++nextSegment;
+				continue;
+			}
+			const auto& node = executionOrder[nodeIdx];
+			++nodeIdx;
+			bool isDeferred = std::ranges::any_of(node->getInputs(),
+			                                      [&](const Node::Ptr& input) { return pendingNodes.contains(input); });
+			if (isDeferred || node->isHostCompute()) {
+				pendingNodes.insert(node);
+			}
+			if (isDeferred) {
+				deferredNodes.push_back(node);
+				continue;
+			}
+			enqueueNode(node);
+			for (auto&& releasedNode : intermediateReleases[nodeIdx - 1]) {
+				RGL_DEBUG("Releasing intermediates of node: {}", *releasedNode);
+				releasedNode->releaseIntermediates();
 			}
 		}
-		reverseOrder.push_back(current);
-	};
-	// Get entry nodes (graphs may have many)
-	std::vector<Node::Ptr> entryNode;
+		for (auto&& node : deferredNodes) {
+			for (auto&& input : node->getInputs()) {
+				if (auto job = hostComputeJobs.find(input); job != hostComputeJobs.end()) {
+					NvtxRange rg{graphOrdinal, NVTX_COL_SYNC_CPU, "WaitHostCompute({})", input->getName()};
+					job->second.get(); // Rethrows input's error; the remaining nodes will not run
+				}
+			}
+			enqueueNode(node);
+		}
+		for (auto&& [node, job] : hostComputeJobs) {
+			job.wait(); // Errors of nodes without deferred outputs are reported when synchronizing those nodes
+		}
+		RGL_DEBUG("Node enqueueing done"); // This also logs the time diff for the last one
+	}
+	catch (...) {
+		// Exception most likely happened in a Node, but might have happened around executionOrder loop.
+		// We still need to communicate that nodes 'executed' (even though some may not have a chance to start).
+		// If we didn't, we could hang client's thread in synchronizeNodeCPU() waiting for a Node that will never run.
+		// Pending host compute jobs mark their nodes on their own.
+		for (auto&& [node, job] : hostComputeJobs) {
+			job.wait();
+		}
+		for (auto&& [node, state] : executionStatus) {
+			if (state.enqueued.load(std::memory_order::relaxed)) {
+				continue;
+			}
+			state.exceptionPtr = std::current_exception();
+			markNodeEnqueued(state);
+		}
+	}
+}
+
+std::shared_future<void> GraphRunCtx::submitHostCompute(const Node::Ptr& node)
+{
+	auto completed = std::make_shared<std::promise<void>>();
+	std::shared_future<void> future = completed->get_future().share();
+	GraphScheduler::instance().submitHostCompute(this, [this, node, completed]() {
+		std::exception_ptr error = nullptr;
+		try {
+			NvtxRange rg{graphOrdinal, NVTX_COL_WORK, "HostCompute({})", node->getName()};
+			enqueueWaitForInputs(node);
+			node->enqueueExec();
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		// Client's thread may consume (clear) exceptionPtr once the node is marked, hence the copy for the graph thread.
+		executionStatus.at(node).exceptionPtr = error;
+		node->resultFrameId = frameId;
+		markNodeEnqueued(executionStatus.at(node));
+		// Must be the last access to this GraphRunCtx; the graph thread finishes the run once all jobs are completed.
+		error != nullptr ? completed->set_exception(error) : completed->set_value();
+	});
+	return future;
+}
+
+void GraphRunCtx::markNodeEnqueued(NodeExecStatus& status)
+{
+	// Client's thread may consume exceptionPtr as soon as `enqueued` is set.
+	std::exception_ptr error = status.exceptionPtr;
+	std::vector<std::function<void(std::exception_ptr)>> callbacks;
+	{
+		std::lock_guard lock{enqueuedCallbacksMutex};
+		status.enqueued.store(true);
+		callbacks = std::move(status.enqueuedCallbacks);
+	}
+	status.enqueued.notify_all();
+	for (auto&& callback : callbacks) {
+		callback(error);
+	}
+}
+
+void GraphRunCtx::callWhenNodeEnqueued(const Node::ConstPtr& node, std::function<void(std::exception_ptr)> fn)
+{
+	if (!isRunning) {
+		fn(nullptr);
+		return;
+	}
+	auto& status = executionStatus.at(node);
+	{
+		std::lock_guard lock{enqueuedCallbacksMutex};
+		if (!status.enqueued.load()) {
+			status.enqueuedCallbacks.emplace_back(std::move(fn));
+			return;
+		}
+	}
+	fn(status.exceptionPtr);
+}
+
+void GraphRunCtx::submitAuxiliaryJob(std::function<void()> job)
+{
+	{
+		std::lock_guard lock{workerMutex};
+		auxiliaryJobCount += 1;
+	}
+	GraphScheduler::instance().submit(nullptr, getPriority(), [self = shared_from_this(), job = std::move(job)]() {
+		try {
+			job();
+		}
+		catch (std::exception& e) {
+			RGL_ERROR("Auxiliary job of graph {} failed: {}", self->graphOrdinal, e.what());
+		}
+		{
+			std::lock_guard lock{self->workerMutex};
+			self->auxiliaryJobCount -= 1;
+		}
+		self->workerCondition.notify_all();
+	});
+}
+
+void GraphRunCtx::releaseSceneSnapshot()
+{
+	if (!sceneSnapshot.has_value()) {
+		return;
+	}
+	// All RaytraceNodes share a single stream, see assignStreams().
+	auto raytraceNode = std::ranges::find_if(executionOrder, [](const Node::Ptr& node) {
+		return std::dynamic_pointer_cast<RaytraceNode>(node) != nullptr;
+	});
+	scene->releaseSnapshotLocked(*sceneSnapshot, getNodeStream(**raytraceNode)->getHandle());
+	sceneSnapshot.reset();
+	scene.reset();
+}
+
+std::shared_ptr<Scene> GraphRunCtx::findScene() const
+{
+	std::shared_ptr<Scene> graphScene = nullptr;
+	for (auto&& raytraceNode : Node::getNodesOfType<RaytraceNode>(nodes)) {
+		if (graphScene != nullptr && raytraceNode->getScene() != graphScene) {
+			throw InvalidPipeline("all RaytraceNodes in a graph must raytrace the same scene");
+		}
+		graphScene = raytraceNode->getScene();
+	}
+	return graphScene;
+}
+
+bool GraphRunCtx::isUsingScene(const Scene& scene) const
+{
+	return std::ranges::any_of(Node::getNodesOfType<RaytraceNode>(nodes), [&scene](const RaytraceNode::Ptr& raytraceNode) {
+		return raytraceNode->getScene().get() == &scene;
+	});
+}
+
+std::vector<std::shared_ptr<Node>> GraphRunCtx::findExecutionOrder(std::set<std::shared_ptr<Node>> nodes)
+{
+	// Get entry nodes (graphs may have many), i.e. without inputs among the nodes
+	std::vector<Node::Ptr> entryNodes;
 	for (auto&& node : nodes) {
-		if (node->getInputs().empty()) {
-			entryNode.push_back(node);
+		if (std::ranges::none_of(node->getInputs(), [&](const Node::Ptr& input) { return nodes.contains(input); })) {
+			entryNodes.push_back(node);
 		}
 	}
 	// Sort entry nodes by priority, ascending!
-	std::stable_sort(entryNode.begin(), entryNode.end(),
+	std::stable_sort(entryNodes.begin(), entryNodes.end(),
 	                 [](Node::Ptr lhs, Node::Ptr rhs) { return lhs->getPriority() < rhs->getPriority(); });
 
-	// Iterate in ascending order of entry priorities
-	for (auto&& node : entryNode) {
-		dfsRec(node);
+	// Depth-first search with an explicit stack, so that long chains do not exhaust the thread's stack.
+	// Nodes already present in this vector need to be executed after the ones that are added later.
+	std::vector<std::shared_ptr<Node>> reverseOrder{};
+	std::vector<std::pair<Node::Ptr, std::size_t>> stack; // Node and the number of its outputs visited (from the last one)
+	for (auto&& entryNode : entryNodes) {
+		nodes.erase(entryNode);
+		stack.emplace_back(entryNode, 0);
+		while (!stack.empty()) {
+			auto& [current, visitedOutputCount] = stack.back();
+			const auto& outputs = current->getOutputs();
+			if (visitedOutputCount == outputs.size()) {
+				reverseOrder.push_back(current);
+				stack.pop_back();
+				continue;
+			}
+			Node::Ptr outputNode = outputs[outputs.size() - 1 - visitedOutputCount];
+			visitedOutputCount += 1;
+			if (nodes.erase(outputNode) > 0) {
+				stack.emplace_back(std::move(outputNode), 0);
+			}
+		}
 	}
 
 	if (!nodes.empty()) {
@@ -141,50 +605,458 @@ std::vector<std::shared_ptr<Node>> GraphRunCtx::findExecutionOrder(std::set<std:
 	return {reverseOrder.rbegin(), reverseOrder.rend()};
 }
 
+std::vector<RaytraceNode::Ptr> GraphRunCtx::groupRaytraceNodes(std::vector<std::shared_ptr<Node>>& executionOrder)
+{
+	std::vector<RaytraceNode::Ptr> raytraceNodes;
+	for (auto&& node : executionOrder) {
+		if (auto raytraceNode = std::dynamic_pointer_cast<RaytraceNode>(node)) {
+			raytraceNodes.push_back(raytraceNode);
+		}
+	}
+	if (raytraceNodes.size() < 2) {
+		return {};
+	}
+	// Time-sliced and streamed nodes trace their rays in launches of their own.
+	auto isTracedAlone = [](const RaytraceNode::Ptr& node) { return node->isTimeSliced() || node->isStreamed(); };
+	if (std::ranges::any_of(raytraceNodes, isTracedAlone)) {
+		return {};
+	}
+	// The first RaytraceNode of the batch reads rays of all of them, so none of them may be deferred.
+	std::set<Node::Ptr> hostComputeDependents = findHostComputeDependents(executionOrder);
+	if (std::ranges::any_of(raytraceNodes, [&](const Node::Ptr& node) { return hostComputeDependents.contains(node); })) {
+		return {};
+	}
+
+	std::set<Node::Ptr> descendants;
+	std::function<void(Node::Ptr)> dfsRec = [&](Node::Ptr current) {
+		for (auto&& output : current->getOutputs()) {
+			if (descendants.insert(output).second) {
+				dfsRec(output);
+			}
+		}
+	};
+	for (auto&& raytraceNode : raytraceNodes) {
+		dfsRec(raytraceNode);
+	}
+	for (auto&& raytraceNode : raytraceNodes) {
+		if (descendants.contains(raytraceNode)) {
+			return {}; // Cannot be traced together with its ancestor.
+		}
+	}
+
+	// Stable partition preserves topological order: ancestors of RaytraceNodes are never their descendants.
+	auto isRaytraceNode = [](const Node::Ptr& node) { return std::dynamic_pointer_cast<RaytraceNode>(node) != nullptr; };
+	std::vector<Node::Ptr> reordered;
+	std::ranges::copy_if(executionOrder, std::back_inserter(reordered),
+	                     [&](const Node::Ptr& node) { return !isRaytraceNode(node) && !descendants.contains(node); });
+	std::ranges::copy(raytraceNodes, std::back_inserter(reordered));
+	std::ranges::copy_if(executionOrder, std::back_inserter(reordered),
+	                     [&](const Node::Ptr& node) { return descendants.contains(node); });
+	executionOrder = std::move(reordered);
+	return raytraceNodes;
+}
+
+std::set<Node::Ptr> GraphRunCtx::findHostComputeDependents(const std::vector<std::shared_ptr<Node>>& executionOrder)
+{
+	std::set<Node::Ptr> dependents;
+	for (auto&& node : executionOrder) {
+		bool isDependent = std::ranges::any_of(node->getInputs(),
+		                                       [&](const Node::Ptr& input) { return dependents.contains(input); });
+		if (isDependent || node->isHostCompute()) {
+			dependents.insert(node);
+		}
+	}
+	return dependents;
+}
+
+void GraphRunCtx::planIntermediateReleases()
+{
+	intermediateReleases.assign(executionOrder.size(), {});
+	releasedFields.clear();
+	inPlaceFields.clear();
+	std::set<Node::Ptr> hostComputeDependents = findHostComputeDependents(executionOrder);
+	std::unordered_map<const Node*, std::size_t> nodeIndices;
+	for (std::size_t nodeIdx = 0; nodeIdx < executionOrder.size(); ++nodeIdx) {
+		nodeIndices.emplace(executionOrder[nodeIdx].get(), nodeIdx);
+	}
+	auto getIntermediateFields = [](const Node::Ptr& node) {
+		auto pointsNode = std::dynamic_pointer_cast<IPointsNode>(node);
+		std::vector<rgl_field_t> fields = pointsNode != nullptr ? pointsNode->getIntermediateFieldList()
+		                                                        : std::vector<rgl_field_t>{};
+		return std::set<rgl_field_t>{fields.begin(), fields.end()};
+	};
+	std::unordered_map<const Node*, std::size_t> releaseIndices;
+	for (auto&& node : executionOrder) {
+		// Yielded results are pinned; nodes without outputs hold results of the graph.
+		bool isPinned = node->getOutputs().empty() || std::dynamic_pointer_cast<YieldPointsNode>(node) != nullptr;
+		if (!node->isMemoryReuseEnabled() || isPinned || hostComputeDependents.contains(node)) {
+			continue;
+		}
+		// Intermediates are consumed by direct outputs and by descendants requiring fields backed by them,
+		// unless a node on the way provides the field from its own intermediates.
+		std::unordered_map<const Node*, std::set<rgl_field_t>> nodeReleasedFields{{node.get(), getIntermediateFields(node)}};
+		std::set<Node::Ptr> descendants;
+		std::size_t lastConsumerIdx = 0;
+		std::function<void(const Node::Ptr&, const std::set<rgl_field_t>&)> dfsRec =
+		    [&](const Node::Ptr& current, const std::set<rgl_field_t>& fields) {
+			    for (auto&& output : current->getOutputs()) {
+				    descendants.insert(output);
+				    auto pointsOutput = std::dynamic_pointer_cast<IPointsNode>(output);
+				    bool isConsumer = current == node || pointsOutput == nullptr ||
+				                      std::ranges::any_of(pointsOutput->getRequiredFieldList(),
+				                                          [&](rgl_field_t field) { return fields.contains(field); });
+				    if (isConsumer) {
+					    lastConsumerIdx = std::max(lastConsumerIdx, nodeIndices.at(output.get()));
+				    }
+				    // Selections gather fields from their source when their consumers request them, so they do not hide them.
+				    std::set<rgl_field_t> providedFields = std::dynamic_pointer_cast<IPointsSelection>(output) == nullptr
+				                                               ? getIntermediateFields(output)
+				                                               : std::set<rgl_field_t>{};
+				    std::set<rgl_field_t> forwardedFields;
+				    std::ranges::set_difference(fields, providedFields, std::inserter(forwardedFields, forwardedFields.end()));
+				    if (!forwardedFields.empty()) {
+					    nodeReleasedFields[output.get()].insert(forwardedFields.begin(), forwardedFields.end());
+					    dfsRec(output, forwardedFields);
+				    }
+			    }
+		    };
+		dfsRec(node, nodeReleasedFields.at(node.get()));
+		bool isStreamOrdered = std::ranges::all_of(descendants, [&](const Node::Ptr& descendant) {
+			return getNodeStream(*descendant) == getNodeStream(*node) && !hostComputeDependents.contains(descendant);
+		});
+		if (!isStreamOrdered) {
+			continue;
+		}
+		releaseIndices.emplace(node.get(), lastConsumerIdx);
+		for (auto&& [releasedNode, fields] : nodeReleasedFields) {
+			releasedFields[releasedNode].insert(fields.begin(), fields.end());
+		}
+	}
+	// A released node being the only output of a released input may overwrite input's arrays: it provides these fields
+	// itself, so nothing reads input's ones after it (except for result buffers of the input, hence they are excluded).
+	// Overwritten arrays hold node's results, so the input releases them along with the node;
+	// the reverse order carries that along chains of such nodes.
+	for (auto&& node : executionOrder | std::views::reverse) {
+		auto pointsNode = std::dynamic_pointer_cast<IPointsNode>(node);
+		if (pointsNode == nullptr || !releaseIndices.contains(node.get()) || node->getInputs().size() != 1) {
+			continue;
+		}
+		const Node::Ptr& input = node->getInputs().front();
+		auto pointsInput = std::dynamic_pointer_cast<IPointsNode>(input);
+		bool isInputReused = pointsInput != nullptr && releaseIndices.contains(input.get()) &&
+		                     input->getOutputs().size() == 1 && std::dynamic_pointer_cast<RaytraceNode>(input) == nullptr;
+		if (!isInputReused) {
+			continue;
+		}
+		for (auto&& field : pointsNode->getInPlaceFieldList()) {
+			if (pointsInput->getOwnedFieldData(field) != nullptr && !input->hasResultBuffer(field)) {
+				inPlaceFields[node.get()].insert(field);
+			}
+		}
+		if (inPlaceFields.contains(node.get())) {
+			auto& inputReleaseIdx = releaseIndices.at(input.get());
+			inputReleaseIdx = std::max(inputReleaseIdx, releaseIndices.at(node.get()));
+		}
+	}
+	for (auto&& node : executionOrder) {
+		if (auto it = releaseIndices.find(node.get()); it != releaseIndices.end()) {
+			intermediateReleases[it->second].push_back(node);
+		}
+	}
+}
+
+std::vector<GraphRunCtx::CapturedSegment> GraphRunCtx::findCapturedSegments() const
+{
+	// Capturing a single node gives no benefit over launching its work directly.
+	static constexpr std::size_t MIN_SEGMENT_LENGTH = 2;
+	std::vector<CapturedSegment> segments;
+	// Released intermediates are allocated again in each run, pointers captured into CUDA graphs would be stale.
+	if (std::ranges::any_of(executionOrder, [](const Node::Ptr& node) { return node->isMemoryReuseEnabled(); })) {
+		return segments;
+	}
+	std::set<Node::Ptr> hostComputeDependents = findHostComputeDependents(executionOrder);
+	std::size_t beginIdx = 0;
+	auto closeSegment = [&](std::size_t endIdx) {
+		if (endIdx - beginIdx >= MIN_SEGMENT_LENGTH) {
+			segments.push_back({.beginIdx = beginIdx, .endIdx = endIdx});
+		}
+	};
+	for (std::size_t nodeIdx = 0; nodeIdx < executionOrder.size(); ++nodeIdx) {
+		const auto& node = executionOrder[nodeIdx];
+		if (!node->isCudaGraphCapturable() || !node->resultBuffers.empty() || hostComputeDependents.contains(node)) {
+			closeSegment(nodeIdx);
+			beginIdx = nodeIdx + 1;
+			continue;
+		}
+		// Segment is captured from a single stream.
+		if (nodeIdx > beginIdx && getNodeStream(*node) != getNodeStream(*executionOrder[nodeIdx - 1])) {
+			closeSegment(nodeIdx);
+			beginIdx = nodeIdx;
+		}
+	}
+	closeSegment(executionOrder.size());
+	return segments;
+}
+
+void GraphRunCtx::assignStreams(const std::vector<Node::Ptr>& orderedNodes)
+{
+	CudaStream::Ptr raytraceStream = nullptr;
+	for (auto&& [node, stream] : nodeStreams) {
+		if (dynamic_cast<const RaytraceNode*>(node) != nullptr) {
+			raytraceStream = stream;
+		}
+	}
+	auto createStream = [this]() { return streams.emplace_back(CudaStream::create(cudaStreamNonBlocking, streamPriority)); };
+	for (auto&& node : orderedNodes) {
+		if (std::dynamic_pointer_cast<RaytraceNode>(node) != nullptr) {
+			raytraceStream = raytraceStream != nullptr ? raytraceStream : createStream();
+			nodeStreams[node.get()] = raytraceStream;
+			continue;
+		}
+		const auto& inputs = node->getInputs();
+		bool isChain = inputs.size() == 1 && inputs.front()->getOutputs().size() == 1 &&
+		               std::dynamic_pointer_cast<RaytraceNode>(inputs.front()) == nullptr;
+		nodeStreams[node.get()] = isChain ? nodeStreams.at(inputs.front().get()) : createStream();
+	}
+}
+
+void GraphRunCtx::enqueueWaitForInputs(const Node::Ptr& node)
+{
+	for (auto&& input : node->getInputs()) {
+		if (getNodeStream(*input) != getNodeStream(*node)) {
+			node->enqueueWaitFor(*input);
+		}
+	}
+}
+
+std::vector<std::size_t> GraphRunCtx::getSegmentInputSizes(const CapturedSegment& segment) const
+{
+	auto segmentBegin = executionOrder.begin() + static_cast<std::ptrdiff_t>(segment.beginIdx);
+	auto segmentEnd = executionOrder.begin() + static_cast<std::ptrdiff_t>(segment.endIdx);
+	std::set<Node::Ptr> segmentNodes{segmentBegin, segmentEnd};
+	// Arrays of unchanged sizes may still be reallocated, when they release capacity; then pointers have to be captured again.
+	std::vector<std::size_t> sizes{IAnyArray::getCapacityReleaseCount()};
+	for (auto it = segmentBegin; it != segmentEnd; ++it) {
+		for (auto&& input : (*it)->getInputs()) {
+			if (segmentNodes.contains(input)) {
+				continue;
+			}
+			if (auto pointsInput = std::dynamic_pointer_cast<IPointsNode>(input)) {
+				// Device-resident count is read by the captured kernels, which are launched for the upper bound
+				if (pointsInput->getPointCountDevicePtr() != nullptr) {
+					sizes.push_back(pointsInput->getPointCountUpperBound());
+					continue;
+				}
+				sizes.push_back(pointsInput->getWidth());
+				sizes.push_back(pointsInput->getHeight());
+			}
+			if (auto raysInput = std::dynamic_pointer_cast<IRaysNode>(input)) {
+				sizes.push_back(raysInput->getRayCount());
+			}
+		}
+	}
+	return sizes;
+}
+
+void GraphRunCtx::enqueueSegment(CapturedSegment& segment)
+{
+	NvtxRange rg{graphOrdinal, NVTX_COL_WORK, "EnqueueSegment({}-{})", segment.beginIdx, segment.endIdx};
+	auto enqueueEagerly = [&]() {
+		for (std::size_t nodeIdx = segment.beginIdx; nodeIdx < segment.endIdx; ++nodeIdx) {
+			RGL_DEBUG("Enqueueing node: {}", *executionOrder[nodeIdx]);
+			executionOrder[nodeIdx]->enqueueExec();
+		}
+	};
+
+	// Cross-stream dependencies are enqueued outside of capture (events recorded elsewhere cannot be waited for inside).
+	cudaStream_t stream = getNodeStream(*executionOrder[segment.beginIdx])->getHandle();
+	for (std::size_t nodeIdx = segment.beginIdx; nodeIdx < segment.endIdx; ++nodeIdx) {
+		enqueueWaitForInputs(executionOrder[nodeIdx]);
+	}
+
+	std::vector<std::size_t> inputSizes = getSegmentInputSizes(segment);
+	bool isSteady = inputSizes == segment.inputSizes;
+	segment.inputSizes = std::move(inputSizes);
+
+	if (isSteady && segment.graphExec != nullptr) {
+		CHECK_CUDA(cudaGraphLaunch(segment.graphExec, stream));
+		return;
+	}
+	segment.reset();
+	if (!isSteady || segment.isCaptureFailed) {
+		enqueueEagerly();
+		return;
+	}
+
+	// Thread-local mode: other graph threads may continue to use the CUDA API freely.
+	CHECK_CUDA(cudaStreamBeginCapture(stream, cudaStreamCaptureModeThreadLocal));
+	bool isEnqueueFailed = false;
+	try {
+		enqueueEagerly();
+	}
+	catch (...) {
+		isEnqueueFailed = true; // Most likely, a node used an operation not permitted during capture.
+	}
+	cudaGraph_t graph = nullptr;
+	cudaError_t status = cudaStreamEndCapture(stream, &graph);
+	if (status == cudaSuccess && !isEnqueueFailed) {
+		status = cudaGraphInstantiateWithFlags(&segment.graphExec, graph, 0);
+	}
+	if (graph != nullptr) {
+		CHECK_CUDA(cudaGraphDestroy(graph));
+	}
+	if (isEnqueueFailed || status != cudaSuccess) {
+		// Captured work has not been executed, enqueue it again. Genuine errors will be thrown from there.
+		RGL_WARN("Failed to capture nodes {}-{} into CUDA graph, falling back to eager enqueue", segment.beginIdx,
+		         segment.endIdx);
+		(void) cudaGetLastError(); // Clear error of the failed capture.
+		segment.graphExec = nullptr;
+		segment.isCaptureFailed = true;
+		enqueueEagerly();
+		return;
+	}
+	CHECK_CUDA(cudaGraphLaunch(segment.graphExec, stream));
+}
+
+void GraphRunCtx::CapturedSegment::reset()
+{
+	if (graphExec != nullptr) {
+		CHECK_CUDA_NO_THROW(cudaGraphExecDestroy(graphExec));
+		graphExec = nullptr;
+	}
+}
+
 GraphRunCtx::~GraphRunCtx()
 {
-	// If GraphRunCtx is destroyed, we expect that thread was joined and stream was synced.
+	// If GraphRunCtx is destroyed, we expect that its run is done and streams were synced.
+
+	// Log error if any stream has pending work.
+	for (auto&& stream : streams) {
+		cudaError_t status = cudaStreamQuery(stream->getHandle());
+		if (status == cudaErrorNotReady) {
+			RGL_WARN("~GraphRunCtx(): stream has pending work!");
+			status = cudaSuccess; // Ignore further checks.
+		}
+		CHECK_CUDA_NO_THROW(status);
+	}
 
-	// Log error if stream has pending work.
-	cudaError_t status = cudaStreamQuery(stream->getHandle());
-	if (status == cudaErrorNotReady) {
-		RGL_WARN("~GraphRunCtx(): stream has pending work!");
-		status = cudaSuccess; // Ignore further checks.
+	if (isRunning) {
+		RGL_WARN("~GraphRunCtx(): graph is still running!");
 	}
-	CHECK_CUDA_NO_THROW(status);
 
-	if (maybeThread.has_value()) {
-		RGL_WARN("~GraphRunCtx(): maybeThread has value!");
+	for (auto&& segment : capturedSegments) {
+		segment.reset();
 	}
 }
 
 void GraphRunCtx::detachAndDestroy()
 {
+	std::lock_guard clientLock{clientMutex};
 	this->synchronize();
+	std::lock_guard instancesLock{instancesMutex};
 	for (auto&& node : nodes) {
 		node->setGraphRunCtx(std::nullopt);
 	}
 	erase_if(GraphRunCtx::instances, [&](std::shared_ptr<GraphRunCtx> ctx) { return ctx.get() == this; });
 }
 
+void GraphRunCtx::attachNodes(const std::set<Node::Ptr>& subgraphNodes)
+{
+	std::lock_guard clientLock{clientMutex};
+	// Subgraph's inputs from the graph precede it in the execution order, just like in the one found from scratch.
+	std::vector<Node::Ptr> subgraphOrder = findExecutionOrder(subgraphNodes);
+	nodes.insert(subgraphNodes.begin(), subgraphNodes.end());
+	assignStreams(subgraphOrder);
+	if (!executionOrder.empty()) {
+		executionOrder.insert(executionOrder.end(), subgraphOrder.begin(), subgraphOrder.end());
+		isTopologyChanged = true;
+	}
+	for (auto&& node : subgraphNodes) {
+		frameId = std::max(frameId, node->getResultFrameId());
+	}
+	for (auto&& segment : capturedSegments) {
+		segment.reset();
+	}
+	capturedSegments.clear();
+
+	std::lock_guard instancesLock{instancesMutex};
+	for (auto&& node : subgraphNodes) {
+		node->setGraphRunCtx(shared_from_this());
+	}
+}
+
+void GraphRunCtx::detachNodesUnreachableFrom(const Node::Ptr& node)
+{
+	std::lock_guard clientLock{clientMutex};
+	std::set<Node::Ptr> reachable{node};
+	std::vector<Node::Ptr> toVisit{node};
+	while (!toVisit.empty()) {
+		Node::Ptr current = std::move(toVisit.back());
+		toVisit.pop_back();
+		auto visit = [&](const Node::Ptr& neighbor) {
+			if (reachable.insert(neighbor).second) {
+				toVisit.push_back(neighbor);
+			}
+		};
+		std::ranges::for_each(current->getInputs(), visit);
+		std::ranges::for_each(current->getOutputs(), visit);
+	}
+	std::vector<Node::Ptr> detachedNodes;
+	std::ranges::copy_if(nodes, std::back_inserter(detachedNodes),
+	                     [&](const Node::Ptr& current) { return !reachable.contains(current); });
+
+	// The order remains topological without the detached nodes (or the removed link); derived data is recomputed.
+	std::erase_if(executionOrder, [&](const Node::Ptr& current) { return !reachable.contains(current); });
+	isTopologyChanged = true;
+	raytraceBatch.clear();
+	for (auto&& segment : capturedSegments) {
+		segment.reset();
+	}
+	capturedSegments.clear();
+	if (detachedNodes.empty()) {
+		return;
+	}
+
+	std::lock_guard instancesLock{instancesMutex};
+	for (auto&& detachedNode : detachedNodes) {
+		detachedNode->setGraphRunCtx(std::nullopt);
+		nodes.erase(detachedNode);
+		nodeStreams.erase(detachedNode.get());
+		executionStatus.erase(detachedNode);
+	}
+	std::erase_if(streams, [&](const CudaStream::Ptr& stream) {
+		return std::ranges::none_of(nodeStreams, [&](auto&& nodeStream) { return nodeStream.second == stream; });
+	});
+}
+
 void GraphRunCtx::synchronize()
 {
+	std::lock_guard clientLock{clientMutex};
 	NvtxRange rg{graphOrdinal, NVTX_COL_SYNC, "SyncGraph({})", graphOrdinal};
-	if (!maybeThread.has_value()) {
-		return; // Already synchronized or never run.
+	if (!isRunning) {
+		// Already synchronized or never run; auxiliary jobs may have been submitted since then.
+		std::unique_lock lock{workerMutex};
+		workerCondition.wait(lock, [this]() { return auxiliaryJobCount == 0; });
+		return;
 	}
 	// This order must be preserved.
 	for (auto&& node : executionOrder) {
 		synchronizeNodeCPU(node);
 	}
-	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
-	maybeThread->join();
-	maybeThread.reset();
+	for (auto&& stream : streams) {
+		CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+	}
+	{
+		// Scheduler's thread may still be finishing the run (e.g. reporting an exception), which touches executionStatus.
+		std::unique_lock lock{workerMutex};
+		workerCondition.wait(lock, [this]() { return !isRunRequested && auxiliaryJobCount == 0; });
+	}
+	isRunning = false;
 }
 
 void GraphRunCtx::synchronizeNodeCPU(Node::ConstPtr nodeToSynchronize)
 {
-	if (!maybeThread.has_value()) {
+	if (!isRunning) {
 		return; // Already synchronized or never run.
 	}
 	// Wait until node is executed
@@ -204,8 +1076,30 @@ void GraphRunCtx::synchronizeNodeCPU(Node::ConstPtr nodeToSynchronize)
 
 void GraphRunCtx::synchronizeAll()
 {
-	// No need to lock here, because the only concurrent modification may happen in the same thread.
-	for (auto&& ctx : GraphRunCtx::instances) {
+	PerformanceCounters::ScopedTimer timer{PerformanceCounters::instance().synchronizeAll};
+	// Graphs are awaited without holding instancesMutex, so that other client's threads may use theirs meanwhile.
+	std::vector<std::shared_ptr<GraphRunCtx>> ctxs;
+	{
+		std::lock_guard instancesLock{instancesMutex};
+		ctxs.assign(instances.begin(), instances.end());
+	}
+	for (auto&& ctx : ctxs) {
 		ctx->synchronize();
 	}
+}
+
+void GraphRunCtx::synchronizeScene(const Scene& scene)
+{
+	std::vector<std::shared_ptr<GraphRunCtx>> ctxs;
+	{
+		std::lock_guard instancesLock{instancesMutex};
+		ctxs.assign(instances.begin(), instances.end());
+	}
+	for (auto&& ctx : ctxs) {
+		// Scene of a graph may change only when its nodes are modified (see rgl_node_raytrace), which needs clientMutex.
+		std::lock_guard clientLock{ctx->clientMutex};
+		if (ctx->isUsingScene(scene)) {
+			ctx->synchronize();
+		}
+	}
 }
\ No newline at end of file
@@ -14,26 +14,80 @@
 
 #pragma once
 
+#include <functional>
+#include <future>
 #include <list>
+#include <map>
 #include <set>
 #include <vector>
-#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <unordered_map>
 
 #include <CudaStream.hpp>
+#include <MetricsExporter.hpp>
 #include <graph/Node.hpp>
 #include <graph/NodesCore.hpp>
+#include <graph/GraphScheduler.hpp>
+#include <scene/Scene.hpp>
 
 /**
  * Structure storing context for running a graph.
- * This is a 'volatile' struct - changing graph's structure destroys this context.
+ * This is a 'volatile' struct - changing graph's structure destroys this context, except for attaching and detaching
+ * subgraphs, which keep its streams and the execution order of the remaining nodes, see attachNodes().
  */
-struct GraphRunCtx
+struct GraphRunCtx : std::enable_shared_from_this<GraphRunCtx>
 {
 	friend Node;
 	friend void handleDestructorException(std::exception_ptr e, const char* what);
 
 	static std::shared_ptr<GraphRunCtx> createAndAttach(std::shared_ptr<Node> node);
 
+	/**
+	 * Lock of API calls using a graph, see lockGraphOf().
+	 * If the graph has never been run (has no GraphRunCtx), ctx is null and the lock prevents its first run.
+	 */
+	struct ClientLock
+	{
+		std::shared_ptr<GraphRunCtx> ctx;
+		std::unique_lock<std::recursive_mutex> lock;
+	};
+
+	/**
+	 * Serializes API calls using the graph of the node (running it, getting its results, changing its nodes),
+	 * which may be made from different client's threads. Calls using different graphs do not wait for each other.
+	 * Changing graph's structure (adding, removing or destroying nodes) is not guarded, i.e. it must not be done
+	 * concurrently with other calls using the graph.
+	 */
+	static ClientLock lockGraphOf(const Node::Ptr& node);
+
+	/**
+	 * Runs the graph of the node, creating its GraphRunCtx, if needed. Waits while runs are blocked, see blockRuns().
+	 * If frame dropping is enabled for any node of the graph and the previous run is still in progress,
+	 * the run is skipped (counted as dropped) instead of waiting for the previous one.
+	 */
+	static void run(const Node::Ptr& node);
+
+	/**
+	 * Validates the graph of the node (creating its GraphRunCtx, if needed) and reserves arrays of its nodes
+	 * for the given number of points, see Node::reserveArrays(). Waits for the previous run and the allocations.
+	 */
+	static void prepare(const Node::Ptr& node, std::size_t maxPointCount);
+
+	/**
+	 * Runs graphs of the given nodes together: all of them are validated before any is submitted, and graphs
+	 * raytracing the same scene share its version (AS and SBT are prepared once, see Scene::acquireSnapshotsLocked()).
+	 * Nodes of the same graph run it once. Graphs may drop their runs, as in run().
+	 */
+	static void runBatch(const std::vector<Node::Ptr>& nodes);
+
+	/**
+	 * Prevents graphs from being run (run() waits) as long as the returned lock is held, e.g. to modify shared meshes.
+	 * Graphs that are already running have to be awaited separately, see synchronizeAll().
+	 */
+	[[nodiscard]] static std::unique_lock<std::shared_mutex> blockRuns() { return std::unique_lock{runsMutex}; }
+
 	/**
 	 * Executes graph bound with this GraphRunCtx.
 	 */
@@ -45,10 +99,23 @@ struct GraphRunCtx
 	void detachAndDestroy();
 
 	/**
-	 * Waits until this GraphRunCtx
+	 * Binds nodes of a subgraph (which has no GraphRunCtx), just linked to the graph, with this GraphRunCtx.
+	 * Nodes of the graph keep their streams and relative execution order, the subgraph is executed after them.
+	 * Must be called after synchronize(), as well as linking the subgraph.
+	 */
+	void attachNodes(const std::set<Node::Ptr>& subgraphNodes);
+
+	/**
+	 * Unbinds nodes no longer connected with the given node (after removing a link) from this GraphRunCtx,
+	 * leaving the rest of the graph as it is. Must be called after synchronize(), as well as removing the link.
+	 */
+	void detachNodesUnreachableFrom(const Node::Ptr& node);
+
+	/**
+	 * Waits until this GraphRunCtx (may be called from any client's thread)
 	 * - finishes execution
-	 * - joins its thread
-	 * - synchronizes graph stream (all pending GPU operations)
+	 * - its run is no longer processed by GraphScheduler
+	 * - synchronizes graph streams (all pending GPU operations)
 	 */
 	void synchronize();
 
@@ -57,12 +124,38 @@ struct GraphRunCtx
 	 */
 	static void synchronizeAll();
 
+	/**
+	 * Ensures that no GraphRunCtx raytracing the given scene is running. Graphs using other scenes are not awaited.
+	 */
+	static void synchronizeScene(const Scene& scene);
+
 	/**
 	 * Waits until given node finishes its CPU execution.
 	 * The node may still have pending GPU operations.
 	 */
 	void synchronizeNodeCPU(Node::ConstPtr nodeToSynchronize);
 
+	/**
+	 * Calls the function once given node has been enqueued in the current run: immediately (in the calling thread),
+	 * if it has been already enqueued or the graph is not running; otherwise, in the graph thread, right after the node.
+	 * The function receives the error of node's execution, if any. It must not block.
+	 */
+	void callWhenNodeEnqueued(const Node::ConstPtr& node, std::function<void(std::exception_ptr)> fn);
+
+	/**
+	 * Queues a job related to results of this GraphRunCtx (e.g. delivering them asynchronously) to GraphScheduler.
+	 * The job must not wait for other jobs. Pending jobs are awaited by synchronize(), i.e. before the next run.
+	 */
+	void submitAuxiliaryJob(std::function<void()> job);
+
+	/**
+	 * Non-blocking counterpart of synchronizeNodeCPU().
+	 */
+	bool isNodeCPUCompleted(Node::ConstPtr node) const
+	{
+		return !isRunning || executionStatus.at(node).enqueued.load(std::memory_order::acquire);
+	}
+
 	/**
 	 * Marks all nodes dirty.
 	 */
@@ -73,34 +166,253 @@ struct GraphRunCtx
 		}
 	}
 
-	bool isThisThreadGraphThread() const
+	/**
+	 * Marks the node and all its (direct and indirect) outputs dirty, leaving the rest of the graph valid.
+	 */
+	static void markNodeAndOutputsDirty(const Node::Ptr& node)
 	{
-		return maybeThread.has_value() && maybeThread->get_id() == std::this_thread::get_id();
+		node->dirty = true;
+		for (auto&& output : node->getOutputs()) {
+			if (!output->dirty) {
+				markNodeAndOutputsDirty(output);
+			}
+		}
 	}
 
-	CudaStream::Ptr getStream() const { return stream; }
+	bool isThisThreadGraphThread() const { return GraphScheduler::getCurrentGraphRunCtx() == this; }
+
+	/**
+	 * Returns priority used by GraphScheduler to order runs of different graphs.
+	 * Since node's priority is never lower than its children priorities, this is the highest priority of entry nodes.
+	 */
+	int32_t getPriority() const;
+
+	/**
+	 * Returns urgency of graph's CUDA streams: 0 is the lowest (default), streams of higher levels are scheduled first.
+	 * This is the highest GPU priority set for graph's nodes (see Node::setGpuPriority()), otherwise getPriority().
+	 * Levels beyond the range supported by the device are clamped.
+	 */
+	int32_t getStreamPriorityLevel() const;
+
+	/**
+	 * Returns the number of runs skipped because of frame dropping (see run()) since this GraphRunCtx was created.
+	 */
+	uint64_t getDroppedFrameCount() const { return droppedFrameCount; }
+
+	/**
+	 * Returns identifier of the current (or the last) run.
+	 */
+	uint64_t getFrameId() const { return frameId; }
+
+	/**
+	 * Returns the number identifying the graph in profiler ranges (NVTX category, see NvtxWrappers.hpp).
+	 */
+	uint32_t getGraphOrdinal() const { return graphOrdinal; }
+
+	/**
+	 * Returns stream of the branch the node belongs to. Independent branches of the graph use separate streams,
+	 * so that their work may overlap on the GPU. Cross-branch dependencies are expressed with node's execCompleted events.
+	 */
+	CudaStream::Ptr getNodeStream(const Node& node) const { return nodeStreams.at(&node); }
 	const std::set<std::shared_ptr<Node>>& getNodes() const { return nodes; }
 
+	/**
+	 * Returns true if the field of the node may be backed by intermediates released in the current (or the last) run,
+	 * i.e. by the node or its ancestor with memory reuse enabled, see Node::setMemoryReuse() and planIntermediateReleases().
+	 * Such data is not available to the client, except for host cache of YieldPointsNodes and result buffers.
+	 */
+	bool isFieldReleased(const Node& node, rgl_field_t field) const
+	{
+		auto it = releasedFields.find(&node);
+		return it != releasedFields.end() && it->second.contains(field);
+	}
+
+	/**
+	 * Returns true if the node overwrites its input's array of the field in the current run, instead of using its own one.
+	 * That is the case when both nodes release their intermediates and nothing but the node reads the input's field,
+	 * see planIntermediateReleases().
+	 */
+	bool isFieldModifiedInPlace(const Node& node, rgl_field_t field) const
+	{
+		auto it = inPlaceFields.find(&node);
+		return it != inPlaceFields.end() && it->second.contains(field);
+	}
+
+	/**
+	 * Returns RaytraceNodes whose rays are traced in a single launch, enqueued by the first of them.
+	 * Empty if raytrace batching is disabled in the graph's Scene or the graph contains less than two RaytraceNodes.
+	 */
+	const std::vector<RaytraceNode::Ptr>& getRaytraceBatch() const { return raytraceBatch; }
+
+	/**
+	 * Returns version of the scene raytraced in the current run, see Scene::acquireSnapshotLocked().
+	 * Available only in the graph thread, if the graph contains any RaytraceNode.
+	 */
+	const SceneSnapshot& getSceneSnapshot() const { return sceneSnapshot.value(); }
+
+	/**
+	 * Returns time of the scene version raytraced in the current run, if the graph contains any RaytraceNode.
+	 */
+	std::optional<Time> getSceneTime() const { return sceneSnapshot.has_value() ? sceneSnapshot->time : std::nullopt; }
+
 	virtual ~GraphRunCtx();
 
 private:
-	GraphRunCtx() : stream(CudaStream::create(cudaStreamNonBlocking)) {}
+	GraphRunCtx() = default;
 
+	/**
+	 * Sorts nodes topologically, starting from the ones without inputs among the given nodes, in ascending priority.
+	 */
 	static std::vector<std::shared_ptr<Node>> findExecutionOrder(std::set<std::shared_ptr<Node>> nodes);
 
+	/**
+	 * Returns the scene raytraced by RaytraceNodes of the graph (or nullptr if there are none).
+	 * Throws InvalidPipeline if RaytraceNodes use different scenes; a graph is bound to a single scene.
+	 */
+	std::shared_ptr<Scene> findScene() const;
+	bool isUsingScene(const Scene& scene) const;
+
+	/**
+	 * First part of executeAsync(), done in client's thread: awaits the previous run and validates the graph.
+	 * Returns the scene to be raytraced, whose snapshot has to be passed to submitExecution().
+	 */
+	std::shared_ptr<Scene> prepareExecution();
+
+	/**
+	 * Second part of executeAsync(): starts the run of the graph validated by prepareExecution().
+	 */
+	void submitExecution(std::shared_ptr<Scene> runScene, std::optional<SceneSnapshot> runSnapshot);
+
+	/**
+	 * Adds the latency of the run, submitted at the given time, to the graph's histogram (see MetricsExporter)
+	 * once all its streams complete. Called by the graph thread after enqueueing the run.
+	 */
+	void enqueueRunLatencyMeasurement(std::chrono::steady_clock::time_point submitTime);
+
+	/**
+	 * Assigns streams to nodes (topologically sorted) without one. Node continues the branch (stream) of its input if it is
+	 * the only input and the input has no other outputs (chain). Otherwise (entry, fan-out, join), node starts a new branch.
+	 * All RaytraceNodes share a single stream, which allows to trace rays of all of them in a single launch.
+	 */
+	void assignStreams(const std::vector<Node::Ptr>& orderedNodes);
+
+	/**
+	 * Returns true (counting the dropped frame) if the requested run should be skipped, see run().
+	 */
+	bool tryDropFrame();
+
+	/**
+	 * Returns true if the current run has not completed yet, on the CPU (including auxiliary jobs) or on the GPU.
+	 * Does not block and does not report errors of the run; they are reported by the next synchronize().
+	 */
+	bool isRunInProgress();
+
+	/**
+	 * Returns CUDA stream priority corresponding to getStreamPriorityLevel().
+	 */
+	int getCudaStreamPriority() const;
+
+	/**
+	 * Makes node's stream wait for inputs executed in other streams.
+	 */
+	void enqueueWaitForInputs(const Node::Ptr& node);
+
+	/**
+	 * Reorders (topologically sorted) nodes, so that all RaytraceNodes are executed one after another
+	 * and can be traced in a single launch. Returns the RaytraceNodes, or nothing, if batching is not possible.
+	 */
+	static std::vector<RaytraceNode::Ptr> groupRaytraceNodes(std::vector<std::shared_ptr<Node>>& executionOrder);
+
+	/**
+	 * Returns host compute nodes (see Node::isHostCompute()) and nodes depending on them, directly or indirectly.
+	 */
+	static std::set<Node::Ptr> findHostComputeDependents(const std::vector<std::shared_ptr<Node>>& executionOrder);
+
+	/**
+	 * Computes lifetimes of intermediates from executionOrder: nodes with memory reuse enabled release them right after
+	 * the last of their consumers (see IPointsNode::getIntermediateFieldList()) has been enqueued, so that stream-ordered
+	 * allocations of the following nodes reuse the memory and peak usage depends on the width of the graph, not its length.
+	 * The release is stream-ordered, hence nodes with descendants in other streams or depending on host compute nodes
+	 * (which may still read them) keep their intermediates. Nodes without outputs are never released.
+	 * Nodes released along with their single input may overwrite input's arrays, see isFieldModifiedInPlace().
+	 */
+	void planIntermediateReleases();
+
+	/**
+	 * Executed by GraphScheduler's worker thread: enqueues nodes and notifies the client's thread on completion.
+	 * Host compute nodes are executed by GraphScheduler's host compute pool; nodes depending on them are enqueued
+	 * (in executionOrder) once all other nodes are, and only after their host compute inputs have finished.
+	 */
 	void executeThreadMain();
 
+	/**
+	 * Submits execution of the host compute node to GraphScheduler. The future is ready after the node is marked enqueued.
+	 */
+	std::shared_future<void> submitHostCompute(const Node::Ptr& node);
+
+	/**
+	 * Releases scene snapshot (if any) after the raytracing of the current run has been enqueued.
+	 */
+	void releaseSceneSnapshot();
+
+	/**
+	 * Consecutive (in executionOrder) capturable nodes, enqueued as a single CUDA graph in steady state.
+	 * The graph is captured in a run in which sizes of segment's inputs remain the same as in the previous run,
+	 * which implies that no buffer will be reallocated during capture. Then it is replayed as long as the sizes do not change
+	 * and no node in GraphRunCtx has been modified. Otherwise, nodes are enqueued eagerly.
+	 */
+	struct CapturedSegment
+	{
+		std::size_t beginIdx; // Range in executionOrder
+		std::size_t endIdx;
+		std::vector<std::size_t> inputSizes; // Sizes of inputs from outside of the segment, in the last run
+		cudaGraphExec_t graphExec{nullptr};
+		bool isCaptureFailed{false};
+
+		void reset();
+	};
+
+	std::vector<CapturedSegment> findCapturedSegments() const;
+	std::vector<std::size_t> getSegmentInputSizes(const CapturedSegment& segment) const;
+	void enqueueSegment(CapturedSegment& segment);
+
 	// Internal fields
-	CudaStream::Ptr stream;
-	std::optional<std::thread> maybeThread;
+	std::vector<CudaStream::Ptr> streams; // Owns streams referenced by nodeStreams (StreamBoundObjectsManager holds weak_ptr)
+	std::unordered_map<const Node*, CudaStream::Ptr> nodeStreams;
+	int streamPriority{0}; // CUDA priority of streams
+	bool isRunning{false};    // Accessed by client's threads only: true between executeAsync() and synchronize()
 	std::set<Node::Ptr> nodes;
 	std::vector<Node::Ptr> executionOrder;
+	std::vector<RaytraceNode::Ptr> raytraceBatch;
+	std::vector<CapturedSegment> capturedSegments;
+	std::vector<std::vector<Node::Ptr>> intermediateReleases; // Released after enqueueing the node of the same index
+	std::unordered_map<const Node*, std::set<rgl_field_t>> releasedFields; // See isFieldReleased()
+	std::unordered_map<const Node*, std::set<rgl_field_t>> inPlaceFields;  // See isFieldModifiedInPlace()
+	std::shared_ptr<Scene> scene; // Scene of the current run, retained until its snapshot is released
+	std::optional<SceneSnapshot> sceneSnapshot; // Acquired by client's thread, released by graph thread in each run
+	bool isExecutionOrderBatched{false};
+	bool isTopologyChanged{false}; // Execution order was updated by attaching or detaching nodes
 	uint32_t graphOrdinal; // I.e. How many graphs already existed when this was created + 1
+	uint64_t frameId{0};   // Continues from results of nodes, when GraphRunCtx is recreated
+	uint64_t droppedFrameCount{0};
+	std::shared_ptr<MetricsExporter::RunLatencyHistogram> runLatency; // Created once metrics are enabled
 
 	// Used to synchronize all existing instances (e.g. to safely access Scene).
 	// Modified by client's thread, read by graph thread
 	DATA_DECLSPEC static std::list<std::shared_ptr<GraphRunCtx>> instances;
 
+	// Guards instances and assignment of GraphRunCtx to nodes.
+	DATA_DECLSPEC static std::mutex instancesMutex;
+
+	// Held by client's threads using graphs without GraphRunCtx, see ClientLock.
+	DATA_DECLSPEC static std::recursive_mutex detachedGraphsMutex;
+
+	// Shared by run(), exclusive in blockRuns(). Locked before GraphRunCtx::clientMutex.
+	DATA_DECLSPEC static std::shared_mutex runsMutex;
+
+	// Serializes client's threads using this GraphRunCtx, see lockGraphOf().
+	std::recursive_mutex clientMutex;
+
 	// Communication between client's thread and graph thread
 	struct NodeExecStatus
 	{
@@ -110,8 +422,20 @@ private:
 		// exceptionPtr may be read by client's thread only after it acquire-read true `completed`
 		// exceptionPtr may be written by graph thread only before it release-stores true `completed`
 		std::exception_ptr exceptionPtr{nullptr};
+
+		// Registered by callWhenNodeEnqueued(), called by graph thread.
+		std::vector<std::function<void(std::exception_ptr)>> enqueuedCallbacks;
 	};
 
 	std::unordered_map<Node::ConstPtr, NodeExecStatus> executionStatus;
-	std::atomic<bool> execThreadCanStart;
+	std::mutex enqueuedCallbacksMutex; // Guards NodeExecStatus::enqueuedCallbacks and their transition with `enqueued`
+
+	void markNodeEnqueued(NodeExecStatus& status);
+
+	// isRunRequested is cleared by the scheduler's thread once it is done with the run.
+	// auxiliaryJobCount is decremented by the scheduler's thread once an auxiliary job is done.
+	std::mutex workerMutex;
+	std::condition_variable workerCondition;
+	bool isRunRequested{false};
+	std::size_t auxiliaryJobCount{0};
 };
@@ -0,0 +1,146 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/GraphScheduler.hpp>
+
+#include <algorithm>
+
+#include <Logger.hpp>
+#include <CudaDevice.hpp>
+#include <ThreadConfig.hpp>
+
+static thread_local const GraphRunCtx* currentGraphRunCtx = nullptr;
+
+// Heap comparator: the job with the highest priority (and the oldest among equal ones) is on top.
+static bool isScheduledLater(const auto& lhs, const auto& rhs)
+{
+	return lhs.priority != rhs.priority ? lhs.priority < rhs.priority : lhs.ordinal > rhs.ordinal;
+}
+
+GraphScheduler& GraphScheduler::instance()
+{
+	static GraphScheduler scheduler;
+	return scheduler;
+}
+
+GraphScheduler::GraphScheduler()
+{
+	unsigned workerCount = std::clamp(std::thread::hardware_concurrency(), 1U, MAX_WORKER_COUNT);
+	RGL_DEBUG("Starting graph scheduler with {} worker threads", workerCount);
+	for (unsigned i = 0; i < workerCount; ++i) {
+		workers.emplace_back(&GraphScheduler::workerMain, this, i);
+	}
+	unsigned hostComputeWorkerCount = std::clamp(std::thread::hardware_concurrency(), 1U, MAX_HOST_COMPUTE_WORKER_COUNT);
+	for (unsigned i = 0; i < hostComputeWorkerCount; ++i) {
+		hostComputeWorkers.emplace_back(&GraphScheduler::hostComputeWorkerMain, this, i);
+	}
+}
+
+GraphScheduler::~GraphScheduler()
+{
+	{
+		std::lock_guard lock{mutex};
+		isShutdownRequested = true;
+	}
+	condition.notify_all();
+	hostComputeCondition.notify_all();
+	for (auto&& worker : workers) {
+		worker.join();
+	}
+	for (auto&& worker : hostComputeWorkers) {
+		worker.join();
+	}
+}
+
+void GraphScheduler::submit(const GraphRunCtx* ctx, int32_t priority, std::function<void()> job)
+{
+	{
+		std::lock_guard lock{mutex};
+		pendingJobs.push_back({.ctx = ctx, .priority = priority, .ordinal = submittedJobCount++, .run = std::move(job)});
+		std::ranges::push_heap(pendingJobs, isScheduledLater<Job, Job>);
+	}
+	condition.notify_one();
+}
+
+void GraphScheduler::submitHostCompute(const GraphRunCtx* ctx, std::function<void()> job)
+{
+	{
+		std::lock_guard lock{mutex};
+		pendingHostComputeJobs.push_back({.ctx = ctx, .priority = 0, .ordinal = submittedJobCount++, .run = std::move(job)});
+	}
+	hostComputeCondition.notify_one();
+}
+
+const GraphRunCtx* GraphScheduler::getCurrentGraphRunCtx() { return currentGraphRunCtx; }
+
+void GraphScheduler::workerMain(unsigned workerIdx)
+{
+	ThreadConfig::ScopedThread registration{ThreadRole::GraphWorker, fmt::format("rgl-graph-{}", workerIdx)};
+	while (true) {
+		Job job;
+		{
+			std::unique_lock lock{mutex};
+			condition.wait(lock, [this]() { return !pendingJobs.empty() || isShutdownRequested; });
+			if (isShutdownRequested) {
+				return;
+			}
+			std::ranges::pop_heap(pendingJobs, isScheduledLater<Job, Job>);
+			job = std::move(pendingJobs.back());
+			pendingJobs.pop_back();
+		}
+		currentGraphRunCtx = job.ctx;
+		// Jobs report their errors on their own (see GraphRunCtx::executeThreadMain), this only keeps the worker alive.
+		try {
+			CudaDevice::bindCurrentThread();
+			job.run();
+		}
+		catch (std::exception& e) {
+			RGL_ERROR("Graph scheduler job failed: {}", e.what());
+		}
+		catch (...) {
+			RGL_ERROR("Graph scheduler job failed with unknown exception");
+		}
+		currentGraphRunCtx = nullptr;
+	}
+}
+
+void GraphScheduler::hostComputeWorkerMain(unsigned workerIdx)
+{
+	ThreadConfig::ScopedThread registration{ThreadRole::GraphWorker, fmt::format("rgl-hostcomp-{}", workerIdx)};
+	while (true) {
+		Job job;
+		{
+			std::unique_lock lock{mutex};
+			hostComputeCondition.wait(lock, [this]() { return !pendingHostComputeJobs.empty() || isShutdownRequested; });
+			if (isShutdownRequested) {
+				return;
+			}
+			job = std::move(pendingHostComputeJobs.front());
+			pendingHostComputeJobs.pop_front();
+		}
+		currentGraphRunCtx = job.ctx;
+		// Like graph runs, host compute jobs report their errors on their own.
+		try {
+			CudaDevice::bindCurrentThread();
+			job.run();
+		}
+		catch (std::exception& e) {
+			RGL_ERROR("Host compute job failed: {}", e.what());
+		}
+		catch (...) {
+			RGL_ERROR("Host compute job failed with unknown exception");
+		}
+		currentGraphRunCtx = nullptr;
+	}
+}
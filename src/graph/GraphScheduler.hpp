@@ -0,0 +1,87 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct GraphRunCtx;
+
+/**
+ * Process-wide, bounded pool of threads executing CPU part (enqueueing) of graph runs.
+ * Pending runs from all graphs are dispatched in order of descending priority (FIFO among equal priorities),
+ * so that a high-priority graph does not wait behind low-priority ones, while independent graphs run in parallel.
+ * Host compute nodes (see Node::isHostCompute()) are executed by a separate pool, since runs wait for them.
+ */
+struct GraphScheduler
+{
+	static GraphScheduler& instance();
+
+	/**
+	 * Queues job executing a run of the given GraphRunCtx.
+	 */
+	void submit(const GraphRunCtx* ctx, int32_t priority, std::function<void()> job);
+
+	/**
+	 * Queues job executing a host compute node of the given GraphRunCtx (FIFO).
+	 * The job is executed as if in the graph thread, i.e. getCurrentGraphRunCtx() returns the given ctx.
+	 */
+	void submitHostCompute(const GraphRunCtx* ctx, std::function<void()> job);
+
+	/**
+	 * Returns GraphRunCtx whose run is being executed by the calling thread, or nullptr if not called from the pool.
+	 */
+	static const GraphRunCtx* getCurrentGraphRunCtx();
+
+	GraphScheduler(const GraphScheduler&) = delete;
+	GraphScheduler(GraphScheduler&&) = delete;
+	GraphScheduler& operator=(const GraphScheduler&) = delete;
+	GraphScheduler& operator=(GraphScheduler&&) = delete;
+
+	~GraphScheduler();
+
+private:
+	GraphScheduler();
+
+	void workerMain(unsigned workerIdx);
+	void hostComputeWorkerMain(unsigned workerIdx);
+
+	struct Job
+	{
+		const GraphRunCtx* ctx;
+		int32_t priority;
+		uint64_t ordinal; // Submission order, resolves ties between equal priorities
+		std::function<void()> run;
+	};
+
+	static constexpr unsigned MAX_WORKER_COUNT = 8;
+	static constexpr unsigned MAX_HOST_COMPUTE_WORKER_COUNT = 4;
+
+	std::vector<std::thread> workers;
+	std::vector<Job> pendingJobs; // Kept as a heap, the top is the next job to run
+	uint64_t submittedJobCount{0};
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool isShutdownRequested{false};
+
+	std::vector<std::thread> hostComputeWorkers;
+	std::deque<Job> pendingHostComputeJobs;
+	std::condition_variable hostComputeCondition;
+};
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include <rgl/api/core.h>
 #include <math/Mat3x4f.hpp>
 #include <RGLFields.hpp>
@@ -41,7 +43,17 @@ struct IRaysNode : virtual Node
 	virtual std::optional<std::size_t> getTimeOffsetsCount() const = 0;
 	virtual std::optional<Array<float>::ConstPtr> getTimeOffsets() const = 0;
 
+	// Layout (width x height, e.g. azimuth steps x rings) of rays stored in row-major order
+	virtual std::optional<Vec2i> getLayout() const = 0;
+
 	virtual Mat3x4f getCumulativeRayTransfrom() const { return Mat3x4f::identity(); }
+
+	// Compact alternative to transforms: directions of rays sharing the origin given by getCumulativeRayTransfrom().
+	// If present, getRays() is empty; nodes using ray transforms have to handle directions or reject them.
+	virtual std::optional<Array<Vec3f>::ConstPtr> getRayDirections() const { return std::nullopt; }
+
+	// Transform not applied to getRays() yet, which only RaytraceNode (the sole consumer) may be given, see TransformRaysNode.
+	virtual std::optional<Mat3x4f> getPendingRayTransform() const { return std::nullopt; }
 };
 
 struct IRaysNodeSingleInput : IRaysNode
@@ -66,8 +78,13 @@ struct IRaysNodeSingleInput : IRaysNode
 	virtual std::optional<size_t> getTimeOffsetsCount() const override { return input->getTimeOffsetsCount(); }
 	virtual std::optional<Array<float>::ConstPtr> getTimeOffsets() const override { return input->getTimeOffsets(); }
 
+	// Layout
+	virtual std::optional<Vec2i> getLayout() const override { return input->getLayout(); }
+
 	virtual Mat3x4f getCumulativeRayTransfrom() const override { return input->getCumulativeRayTransfrom(); }
 
+	virtual std::optional<Array<Vec3f>::ConstPtr> getRayDirections() const override { return input->getRayDirections(); }
+
 protected:
 	IRaysNode::Ptr input{0};
 };
@@ -79,6 +96,14 @@ struct IPointsNode : virtual Node
 	// Node requirements
 	virtual std::vector<rgl_field_t> getRequiredFieldList() const { return {}; };
 
+	// Fields backed by node's own intermediates (see Node::releaseIntermediates()), which are kept as long as descendants
+	// require them; the node provides these fields itself, rather than forwarding them from the input.
+	virtual std::vector<rgl_field_t> getIntermediateFieldList() const { return {}; }
+
+	// Fields which the node may write to input's arrays (see getOwnedFieldData()) when nothing else reads them,
+	// rather than to its own ones; GraphRunCtx decides it in each run, see GraphRunCtx::isFieldModifiedInPlace().
+	virtual std::vector<rgl_field_t> getInPlaceFieldList() const { return {}; }
+
 	// Point cloud description
 	virtual bool isDense() const = 0;
 	virtual bool hasField(rgl_field_t field) const = 0;
@@ -86,12 +111,28 @@ struct IPointsNode : virtual Node
 	virtual std::size_t getHeight() const = 0;
 	virtual std::size_t getPointCount() const { return getWidth() * getHeight(); }
 
+	// Device-resident point count (upper-bound allocation mode):
+	// if not null, the count is known on the device only, once the node's work is done; getPointCount() waits for it.
+	// Such node is allocated for getPointCountUpperBound() points, and is given only to consumers accepting it
+	// (see Node::acceptsDevicePointCount()), which launch their work for the upper bound without a host sync.
+	// Field arrays obtained outside of the graph thread have the exact count.
+	virtual const uint32_t* getPointCountDevicePtr() const { return nullptr; }
+	virtual std::size_t getPointCountUpperBound() const { return getPointCount(); }
+
 	virtual Mat3x4f getLookAtOriginTransform() const { return Mat3x4f::identity(); }
 
+	// Transform not applied to XYZ_VEC3_F32 of getFieldData() yet, which in the graph thread only consumers accepting it
+	// (see Node::acceptsPendingXyzTransform()) may be given; outside the graph thread, XYZ is always transformed.
+	virtual std::optional<Mat3x4f> getPendingXyzTransform() const { return std::nullopt; }
+
 	// Data getters
 	virtual IAnyArray::ConstPtr getFieldData(rgl_field_t field) = 0;
 	virtual std::size_t getFieldPointSize(rgl_field_t field) const { return getFieldSize(field); }
 
+	// Array to which the node itself writes the field (possibly the one of its input, see getInPlaceFieldList()),
+	// so that its single output may overwrite it; nullptr if the field is forwarded or computed otherwise.
+	virtual IAnyArray::Ptr getOwnedFieldData(rgl_field_t field) { return nullptr; }
+
 	template<rgl_field_t field>
 	typename Array<typename Field<field>::type>::ConstPtr getFieldDataTyped()
 	{
@@ -99,6 +140,22 @@ struct IPointsNode : virtual Node
 	}
 };
 
+/**
+ * Point cloud being a selection of points of a source point cloud (layered SoA):
+ * its i-th point is the point getSelectionIndicesPtr()[i] of getSelectionSource().
+ * Selections of selections refer to the first non-selection source, so consumers (e.g. formatting or further selections)
+ * can gather fields directly from the source, skipping intermediate gathers.
+ */
+struct IPointsSelection
+{
+	virtual ~IPointsSelection() = default;
+
+	virtual IPointsNode::Ptr getSelectionSource() const = 0;
+
+	// Device memory with getPointCount() elements; valid in the stream order of the selecting node.
+	virtual const Field<RAY_IDX_U32>::type* getSelectionIndicesPtr() const = 0;
+};
+
 struct IPointsNodeSingleInput : IPointsNode
 {
 	using Ptr = std::shared_ptr<IPointsNodeSingleInput>;
@@ -126,6 +183,25 @@ struct IPointsNodeSingleInput : IPointsNode
 	virtual IAnyArray::ConstPtr getFieldData(rgl_field_t field) override { return input->getFieldData(field); }
 
 protected:
+	// Whether this node may provide device point count (own or forwarded): all its consumers must accept it.
+	// Result buffers are copied as a part of the node's work, so they need the count on host.
+	bool canProvideDevicePointCount() const
+	{
+		return resultBuffers.empty() &&
+		       std::ranges::all_of(outputs, [](const Node::Ptr& output) { return output->acceptsDevicePointCount(); });
+	}
+
+	// Input's array of the field, if this node overwrites it in the current run (see getInPlaceFieldList()); otherwise null.
+	template<rgl_field_t field>
+	typename DeviceAsyncArray<typename Field<field>::type>::Ptr getInPlaceFieldData()
+	{
+		if (!isFieldModifiedInPlace(field)) {
+			return nullptr;
+		}
+		auto inputField = input->getOwnedFieldData(field)->template asTyped<typename Field<field>::type>();
+		return inputField->template asSubclass<DeviceAsyncArray>();
+	}
+
 	IPointsNode::Ptr input{0};
 };
 
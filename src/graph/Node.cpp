@@ -15,6 +15,9 @@
 #include <graph/Node.hpp>
 #include <graph/NodesCore.hpp>
 #include <graph/GraphRunCtx.hpp>
+#include <macros/handleDestructorException.hpp>
+#include <PerformanceCounters.hpp>
+#include <TraceRecorder.hpp>
 
 API_OBJECT_INSTANCE(Node);
 
@@ -33,13 +36,20 @@ void Node::addChild(Node::Ptr child)
 		throw InvalidPipeline(msg);
 	}
 
-	// This might be a subject for future optimization.
-	// Invalidate graphCtx for all connected nodes of child and parent
-	if (this->hasGraphRunCtx()) {
-		this->getGraphRunCtx()->detachAndDestroy();
+	// A subgraph that has never been run with the graph is attached to its graphCtx,
+	// otherwise graphCtx is invalidated for all connected nodes of child and parent.
+	std::set<Node::Ptr> attachedNodes;
+	if (this->hasGraphRunCtx() && !child->hasGraphRunCtx()) {
+		attachedNodes = child->getConnectedComponentNodes();
+		this->getGraphRunCtx()->synchronize();
 	}
-	if (child->hasGraphRunCtx()) {
-		child->getGraphRunCtx()->detachAndDestroy();
+	else {
+		if (this->hasGraphRunCtx()) {
+			this->getGraphRunCtx()->detachAndDestroy();
+		}
+		if (child->hasGraphRunCtx()) {
+			child->getGraphRunCtx()->detachAndDestroy();
+		}
 	}
 
 	// Remove links
@@ -55,6 +65,10 @@ void Node::addChild(Node::Ptr child)
 		this->setPriority(maxChildPriority);
 	}
 
+	if (!attachedNodes.empty()) {
+		this->getGraphRunCtx()->attachNodes(attachedNodes);
+	}
+
 	this->dirty = true;
 	child->dirty = true;
 }
@@ -82,24 +96,26 @@ void Node::removeChild(Node::Ptr child)
 		throw InvalidPipeline(msg);
 	}
 
-	// This might be a subject for future optimization.
-	// Remove graphCtx for all connected nodes of child and parent
-	// Destroy graph (by invariant, shared by child and parent)
+	// GraphCtx (by invariant, shared by child and parent) is kept by nodes still connected with parent.
 	if (this->hasGraphRunCtx()) {
-		this->getGraphRunCtx()->detachAndDestroy();
+		this->getGraphRunCtx()->synchronize();
 	}
 
 	// Remove links
 	this->outputs.erase(childIt);
 	child->inputs.erase(thisIt);
 
+	if (this->hasGraphRunCtx()) {
+		this->getGraphRunCtx()->detachNodesUnreachableFrom(shared_from_this());
+	}
+
 	this->dirty = true;
 	child->dirty = true;
 }
 
 void Node::setGraphRunCtx(std::optional<std::shared_ptr<GraphRunCtx>> graph)
 {
-	arrayMgr.setStream(graph.has_value() ? graph.value()->getStream() : CudaStream::getNullStream());
+	arrayMgr.setStream(graph.has_value() ? graph.value()->getNodeStream(*this) : CudaStream::getNullStream());
 	this->graphRunCtx = graph;
 	this->dirty = true;
 }
@@ -115,6 +131,7 @@ void Node::validate()
 	}
 	this->validateImpl();
 	dirty = false;
+	validationCount += 1;
 }
 
 void Node::enqueueExec()
@@ -123,8 +140,83 @@ void Node::enqueueExec()
 		auto msg = fmt::format("{}: attempted to call enqueueExec() despite !isValid()", getName());
 		throw std::logic_error(msg);
 	}
-	this->enqueueExecImpl();
-	CHECK_CUDA(cudaEventRecord(execCompleted->getHandle(), getGraphRunCtx()->getStream()->getHandle()));
+	cudaStream_t stream = getStreamHandle();
+	cudaStreamCaptureStatus captureStatus = cudaStreamCaptureStatusNone;
+	CHECK_CUDA(cudaStreamIsCapturing(stream, &captureStatus));
+	bool isCaptured = captureStatus == cudaStreamCaptureStatusActive;
+
+	// Timing events cannot be captured, nodes replayed in CUDA graphs are timed only in runs enqueued eagerly.
+	bool isSampled = !isCaptured && PerformanceCounters::instance().isFrameSampled(getGraphRunCtx()->getFrameId());
+	bool isTraced = !isCaptured && TraceRecorder::instance().isRecording();
+	CudaEvent::Ptr traceBegin, traceEnd;
+	if (isTraced) {
+		traceBegin = CudaEvent::create(cudaEventDefault);
+		traceEnd = CudaEvent::create(cudaEventDefault);
+		CHECK_CUDA(cudaEventRecord(traceBegin->getHandle(), stream));
+	}
+	if (!isSampled) {
+		this->enqueueExecImpl();
+		enqueueResultBufferCopies();
+	}
+	else {
+		// Held until all events are recorded, so that getStats() never measures events of different runs.
+		std::lock_guard lock{statsMutex};
+		if (statsEvents == nullptr) {
+			statsEvents = std::make_unique<StatsEvents>();
+		}
+		auto enqueueBegin = std::chrono::steady_clock::now();
+		CHECK_CUDA(cudaEventRecord(statsEvents->execBegin->getHandle(), stream));
+		this->enqueueExecImpl();
+		CHECK_CUDA(cudaEventRecord(statsEvents->execEnd->getHandle(), stream));
+		enqueueResultBufferCopies();
+		CHECK_CUDA(cudaEventRecord(statsEvents->resultCopyEnd->getHandle(), stream));
+		std::chrono::duration<float, std::milli> enqueueTime = std::chrono::steady_clock::now() - enqueueBegin;
+		stats.enqueue_cpu_time_ms = enqueueTime.count();
+		stats.sample_count += 1;
+		stats.array_peak_bytes = 0;
+		arrayMgr.forEachObject([this](const IStreamBound::Ptr& object) {
+			if (auto array = std::dynamic_pointer_cast<const IAnyArray>(object)) {
+				stats.array_peak_bytes += array->getPeakCapacity() * array->getSizeOf();
+			}
+		});
+		isStatsGpuTimePending = true;
+		PerformanceCounters::instance().sampledNodeRunCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (isTraced) {
+		CHECK_CUDA(cudaEventRecord(traceEnd->getHandle(), stream));
+		auto graphOrdinal = getGraphRunCtx()->getGraphOrdinal();
+		TraceRecorder::instance().addGpuRange(getName(), graphOrdinal, std::move(traceBegin), std::move(traceEnd));
+	}
+
+	// When captured into a CUDA graph, the event must be recorded by each replay, so that it still can be waited for.
+	unsigned recordFlags = isCaptured ? cudaEventRecordExternal : cudaEventRecordDefault;
+	CHECK_CUDA(cudaEventRecordWithFlags(execCompleted->getHandle(), stream, recordFlags));
+}
+
+void Node::reserveArrays(std::size_t maxPointCount)
+{
+	arrayMgr.forEachObject([maxPointCount](const IStreamBound::Ptr& object) {
+		if (auto array = std::dynamic_pointer_cast<IAnyArray>(object)) {
+			array->reserve(maxPointCount, true);
+		}
+	});
+}
+
+rgl_node_stats_t Node::getStats()
+{
+	std::lock_guard lock{statsMutex};
+	if (isStatsGpuTimePending) {
+		cudaError_t status = cudaEventQuery(statsEvents->resultCopyEnd->getHandle());
+		if (status != cudaErrorNotReady) {
+			CHECK_CUDA(status);
+			CHECK_CUDA(cudaEventElapsedTime(&stats.exec_gpu_time_ms, statsEvents->execBegin->getHandle(),
+			                                statsEvents->execEnd->getHandle()));
+			CHECK_CUDA(cudaEventElapsedTime(&stats.result_copy_gpu_time_ms, statsEvents->execEnd->getHandle(),
+			                                statsEvents->resultCopyEnd->getHandle()));
+			isStatsGpuTimePending = false;
+		}
+	}
+	return stats;
 }
 
 std::set<Node::Ptr> Node::getConnectedComponentNodes()
@@ -150,6 +242,34 @@ std::set<Node::Ptr> Node::getConnectedComponentNodes()
 	return visited;
 }
 
+void Node::setGraphRandomSeed(uint64_t seed)
+{
+	// SplitMix64 finalizer, so that seeds of nodes are uncorrelated, even though derived from consecutive values.
+	auto mix = [](uint64_t value) {
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+		return value ^ (value >> 31);
+	};
+	std::set<Ptr> visited = {};
+	uint64_t nodeIdx = 0;
+	std::function<void(Ptr)> dfsRec = [&](Ptr current) {
+		visited.insert(current);
+		current->randomSeed = mix(seed + 0x9e3779b97f4a7c15ULL * ++nodeIdx);
+		current->randomFrameIdx = 0;
+		for (auto&& output : current->getOutputs()) {
+			if (!visited.contains(output)) {
+				dfsRec(output);
+			}
+		}
+		for (auto&& input : current->getInputs()) {
+			if (!visited.contains(input)) {
+				dfsRec(input);
+			}
+		}
+	};
+	dfsRec(shared_from_this());
+}
+
 std::set<Node::Ptr> Node::disconnectConnectedNodes()
 {
 	auto nodes = getConnectedComponentNodes();
@@ -183,7 +303,165 @@ void Node::waitForResults()
 	synchronize();
 }
 
-cudaStream_t Node::getStreamHandle() { return getGraphRunCtx()->getStream()->getHandle(); }
+bool Node::isResultReady()
+{
+	if (!isValid()) {
+		auto msg = fmt::format("Cannot get results from {}; it hasn't been run yet, or the run has failed", getName());
+		throw InvalidPipeline(msg);
+	}
+	if (!hasGraphRunCtx()) {
+		return true;
+	}
+	if (!graphRunCtx.value()->isNodeCPUCompleted(shared_from_this())) {
+		return false; // execCompleted may not be recorded yet
+	}
+	graphRunCtx.value()->synchronizeNodeCPU(shared_from_this()); // Does not block; rethrows error, if any
+	cudaError_t status = cudaEventQuery(execCompleted->getHandle());
+	if (status == cudaErrorNotReady) {
+		return false;
+	}
+	CHECK_CUDA(status);
+	return true;
+}
+
+Node::ResultBuffer::ResultBuffer(void* data, std::size_t size) : data(data), size(size)
+{
+	cudaPointerAttributes attributes{};
+	CHECK_CUDA(cudaPointerGetAttributes(&attributes, data));
+	if (attributes.type == cudaMemoryTypeUnregistered) {
+		CHECK_CUDA(cudaHostRegister(data, size, cudaHostRegisterDefault));
+		isHostRegistered = true;
+	}
+}
+
+Node::ResultBuffer::~ResultBuffer()
+try {
+	if (isHostRegistered) {
+		CHECK_CUDA(cudaHostUnregister(data));
+	}
+}
+HANDLE_DESTRUCTOR_EXCEPTION
+
+void Node::setResultBuffer(rgl_field_t field, void* buffer, std::size_t bufferSize)
+{
+	auto pointsNode = dynamic_cast<IPointsNode*>(this);
+	if (pointsNode == nullptr) {
+		auto msg = fmt::format("cannot set result buffer for {}, because it does not provide point fields", getName());
+		throw InvalidPipeline(msg);
+	}
+	// Buffer may be in use by pending copies
+	if (hasGraphRunCtx()) {
+		graphRunCtx.value()->synchronize();
+	}
+	// Old buffer must be unregistered first, in case the same memory is registered again.
+	resultBuffers.erase(field);
+	if (buffer != nullptr) {
+		resultBuffers.emplace(field, std::make_unique<ResultBuffer>(buffer, bufferSize));
+	}
+	if (hasGraphRunCtx()) {
+		// Nodes with result buffers are not captured into CUDA graphs; captured segments must be found again.
+		graphRunCtx.value()->executionOrder.clear();
+	}
+}
+
+void Node::setMemoryReuse(bool enabled)
+{
+	if (memoryReuseEnabled == enabled) {
+		return;
+	}
+	memoryReuseEnabled = enabled;
+	dirty = true; // E.g. to forget fields requested by the client, which may no longer be backed by the intermediates
+	if (hasGraphRunCtx()) {
+		// Synchronized with Graph thread on API level; releases are planned along with the execution order.
+		graphRunCtx.value()->executionOrder.clear();
+	}
+}
+
+void Node::setGpuPriority(int32_t level)
+{
+	if (gpuPriority == level) {
+		return;
+	}
+	gpuPriority = level;
+	if (hasGraphRunCtx()) {
+		// Synchronized with Graph thread on API level; streams are recreated along with the execution order.
+		graphRunCtx.value()->executionOrder.clear();
+	}
+}
+
+void Node::invalidateExecutionOrder()
+{
+	if (hasGraphRunCtx()) {
+		graphRunCtx.value()->executionOrder.clear();
+	}
+}
+
+void Node::checkFieldNotReleased(rgl_field_t field) const
+{
+	if (hasGraphRunCtx() && graphRunCtx.value()->isFieldReleased(*this, field)) {
+		auto msg = fmt::format("field {} of node {} is not kept after the run, because memory reuse is enabled; "
+		                       "read it from a YieldPointsNode or a result buffer instead",
+		                       toString(field), getName());
+		throw InvalidPipeline(msg);
+	}
+}
+
+bool Node::isFieldModifiedInPlace(rgl_field_t field) const
+{
+	return hasGraphRunCtx() && graphRunCtx.value()->isFieldModifiedInPlace(*this, field);
+}
+
+void Node::enqueueResultBufferCopies()
+{
+	if (resultBuffers.empty()) {
+		return;
+	}
+	auto pointsNode = dynamic_cast<IPointsNode*>(this);
+	for (auto&& [field, resultBuffer] : resultBuffers) {
+		if (!pointsNode->hasField(field)) {
+			auto msg = fmt::format("node {} does not provide field {} requested by result buffer", getName(), toString(field));
+			throw InvalidPipeline(msg);
+		}
+		auto fieldArray = pointsNode->getFieldData(field);
+		std::size_t size = fieldArray->getCount() * fieldArray->getSizeOf();
+		if (size > resultBuffer->size) {
+			auto msg = fmt::format("result buffer of {} bytes is too small for field {} of {} ({} bytes)", resultBuffer->size,
+			                       toString(field), getName(), size);
+			throw InvalidPipeline(msg);
+		}
+		const void* src = fieldArray->getRawReadPtr();
+		CHECK_CUDA(cudaMemcpyAsync(resultBuffer->data, src, size, cudaMemcpyDefault, getStreamHandle()));
+		PerformanceCounters::instance().addTransfer(isHost(fieldArray->getMemoryKind()), true, size);
+		resultBuffer->count = fieldArray->getCount();
+	}
+}
+
+void Node::waitForResultsEnqueued()
+{
+	if (!isValid()) {
+		auto msg = fmt::format("Cannot get results from {}; it hasn't been run yet, or the run has failed", getName());
+		throw InvalidPipeline(msg);
+	}
+	if (hasGraphRunCtx()) {
+		graphRunCtx.value()->synchronizeNodeCPU(shared_from_this());
+	}
+}
+
+void Node::callWhenResultsEnqueued(std::function<void(std::exception_ptr)> fn)
+{
+	if (!isValid()) {
+		auto msg = fmt::format("Cannot get results from {}; it hasn't been run yet, or the run has failed", getName());
+		throw InvalidPipeline(msg);
+	}
+	graphRunCtx.value()->callWhenNodeEnqueued(shared_from_this(), std::move(fn));
+}
+
+cudaStream_t Node::getStreamHandle() { return getGraphRunCtx()->getNodeStream(*this)->getHandle(); }
+
+void Node::enqueueWaitFor(const Node& other)
+{
+	CHECK_CUDA(cudaStreamWaitEvent(getStreamHandle(), other.execCompleted->getHandle()));
+}
 
 void Node::setPriority(int32_t requestedPriority)
 {
@@ -14,10 +14,15 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include <list>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <set>
+#include <unordered_map>
 
 #include <CudaEvent.hpp>
 #include <CudaStream.hpp>
@@ -93,6 +98,22 @@ struct Node : APIObject<Node>, std::enable_shared_from_this<Node>
 	 */
 	void waitForResults();
 
+	/**
+	 * Ensures that node's work has been enqueued by the graph thread, without waiting for the GPU.
+	 * Afterwards, getExecCompletedEvent() can be waited for to access node's results in stream order.
+	 */
+	void waitForResultsEnqueued();
+
+	/**
+	 * Non-blocking counterpart of waitForResultsEnqueued(), see GraphRunCtx::callWhenNodeEnqueued().
+	 */
+	void callWhenResultsEnqueued(std::function<void(std::exception_ptr)> fn);
+
+	/**
+	 * Event recorded after node's work (including copies to result buffers) in the current run.
+	 */
+	cudaEvent_t getExecCompletedEvent() const { return execCompleted->getHandle(); }
+
 	const std::vector<Node::Ptr>& getInputs() const { return inputs; }
 	const std::vector<Node::Ptr>& getOutputs() const { return outputs; }
 
@@ -110,6 +131,77 @@ struct Node : APIObject<Node>, std::enable_shared_from_this<Node>
 	void setPriority(int32_t);
 	int32_t getPriority() const { return priority; }
 
+	/**
+	 * Overrides priority of CUDA streams of node's graph, see GraphRunCtx::getStreamPriorityLevel().
+	 */
+	void setGpuPriority(int32_t level);
+	std::optional<int32_t> getGpuPriority() const { return gpuPriority; }
+
+	/**
+	 * Seeds random numbers of all nodes of the graph (see rgl_graph_set_random_seed) and restarts their sequences.
+	 * Seeds of nodes are derived from the given one and node's position in the graph, found by traversing it from this node
+	 * (outputs, then inputs, in order of connection), so that a graph built in the same order gets the same seeds.
+	 */
+	void setGraphRandomSeed(uint64_t seed);
+
+	/**
+	 * Allows GraphRunCtx to release node's intermediate arrays once its consumers have been enqueued,
+	 * see releaseIntermediates(). Afterwards, fields backed by them (also when forwarded by other nodes) can be read only
+	 * through YieldPointsNodes (host cache) and result buffers, see GraphRunCtx::isFieldReleased().
+	 */
+	void setMemoryReuse(bool enabled);
+	bool isMemoryReuseEnabled() const { return memoryReuseEnabled; }
+
+	/**
+	 * Allows GraphRunCtx to skip a run requested while the previous one is still in progress, see GraphRunCtx::run().
+	 */
+	void setFrameDropping(bool enabled) { frameDroppingEnabled = enabled; }
+	bool isFrameDroppingEnabled() const { return frameDroppingEnabled; }
+
+	/**
+	 * Throws InvalidPipeline if node's field is backed by intermediates released in the current run, see setMemoryReuse().
+	 */
+	void checkFieldNotReleased(rgl_field_t field) const;
+
+	/**
+	 * Returns identifier of the graph run (frame) which produced node's current results, zero if never run.
+	 * Frame ids of a graph are consecutive, also when the graph's structure is modified.
+	 */
+	uint64_t getResultFrameId() const { return resultFrameId; }
+
+	/**
+	 * Returns a counter which changes whenever node's output may change without any change of its inputs,
+	 * i.e. when the node is revalidated (e.g. its parameters are modified) or draws new random numbers (in each run).
+	 */
+	uint64_t getRevision() const { return validationCount + randomFrameIdx; }
+
+	/**
+	 * Registers buffer (device or host memory) to which given field of node's results is copied in each run,
+	 * as the part of node's execution, i.e. without involving client's thread. Passing nullptr unregisters the buffer.
+	 * Host memory which is not page-locked is registered (cudaHostRegister) as long as it is used by the node.
+	 * Node must provide the field (IPointsNode).
+	 */
+	void setResultBuffer(rgl_field_t field, void* buffer, std::size_t bufferSize);
+
+	bool hasResultBuffer(rgl_field_t field) const { return resultBuffers.contains(field); }
+
+	/**
+	 * Returns number of elements copied to the result buffer of the given field in the current (or the last) run.
+	 */
+	std::size_t getResultBufferCount(rgl_field_t field) const { return resultBuffers.at(field)->count; }
+
+	/**
+	 * Non-blocking counterpart of waitForResults(): returns true if node's results (including copies to result buffers)
+	 * of the current run are ready. If the run has failed, rethrows the error.
+	 */
+	bool isResultReady();
+
+	/**
+	 * Returns timings of the node measured in sampled runs, see PerformanceCounters::isFrameSampled().
+	 * Does not block; GPU times of the most recent sampled run are taken once the GPU has completed it.
+	 */
+	rgl_node_stats_t getStats();
+
 public: // Debug methods
 	std::string getName() const { return name(typeid(*this)); }
 
@@ -132,6 +224,55 @@ protected: // Member methods
 	 */
 	virtual void validateImpl() = 0;
 
+	/**
+	 * Capturable nodes enqueue only stream-ordered work (no host synchronization, no results read on host)
+	 * and its parameters depend only on node's parameters and the size of its input.
+	 * GraphRunCtx may capture consecutive capturable nodes into a CUDA graph and replay it instead of calling enqueueExec.
+	 */
+	virtual bool isCudaGraphCapturable() const { return false; }
+
+	/**
+	 * Host compute nodes spend their execution mostly on CPU (e.g. processing point cloud downloaded to host).
+	 * GraphRunCtx executes them on a worker pool, meanwhile enqueueing nodes which do not depend on them.
+	 */
+	virtual bool isHostCompute() const { return false; }
+
+	/**
+	 * Nodes accepting device point count handle inputs whose point count is resident in device memory
+	 * (see IPointsNode::getPointCountDevicePtr()) without waiting for the GPU to learn it.
+	 */
+	virtual bool acceptsDevicePointCount() const { return false; }
+
+	/**
+	 * Nodes accepting pending XYZ transform apply IPointsNode::getPendingXyzTransform() of their input themselves,
+	 * so that the input does not have to materialize transformed XYZ (see TransformPointsNode).
+	 */
+	virtual bool acceptsPendingXyzTransform() const { return false; }
+
+	/**
+	 * Frees (in stream order) arrays which are needed only until node's outputs have consumed them, see setMemoryReuse().
+	 * The next run allocates them again, possibly reusing memory released by other nodes of the stream.
+	 */
+	virtual void releaseIntermediates() {}
+
+	/**
+	 * Reserves (in stream order) node's arrays for the given number of points, see rgl_graph_prepare().
+	 * By default, all arrays created through arrayMgr are reserved for that many elements. Called after validation.
+	 */
+	virtual void reserveArrays(std::size_t maxPointCount);
+
+	/**
+	 * Returns true if the node writes the field to its input's array in the current run,
+	 * see IPointsNode::getInPlaceFieldList().
+	 */
+	bool isFieldModifiedInPlace(rgl_field_t field) const;
+
+	/**
+	 * Makes GraphRunCtx find the execution order (and what depends on it, e.g. raytrace batches) again in the next run.
+	 * Must be synchronized with Graph thread on API level.
+	 */
+	void invalidateExecutionOrder();
+
 	/**
 	 * @return True, if node can be executed.
 	 */
@@ -146,12 +287,44 @@ protected: // Member methods
 
 	cudaStream_t getStreamHandle();
 
+	/**
+	 * Makes this node's stream wait for the work enqueued so far by the other node (possibly in another stream).
+	 */
+	void enqueueWaitFor(const Node& other);
+
 	template<typename T>
 	typename T::Ptr getExactlyOneInputOfType()
 	{
 		return getExactlyOneNodeOfType<T>(inputs);
 	}
 
+private:
+	/**
+	 * Memory to which node's results are copied, see setResultBuffer().
+	 */
+	struct ResultBuffer
+	{
+		ResultBuffer(void* data, std::size_t size);
+		~ResultBuffer();
+
+		void* data;
+		std::size_t size;
+		std::size_t count{0};
+		bool isHostRegistered{false};
+	};
+
+	void enqueueResultBufferCopies();
+
+	/**
+	 * Events bracketing node's work in a sampled run, created on first use (timing events are more expensive).
+	 */
+	struct StatsEvents
+	{
+		CudaEvent::Ptr execBegin{CudaEvent::create(cudaEventDefault)};
+		CudaEvent::Ptr execEnd{CudaEvent::create(cudaEventDefault)};
+		CudaEvent::Ptr resultCopyEnd{CudaEvent::create(cudaEventDefault)};
+	};
+
 private: // Used by friend GraphRunCtx
 	/**
 	 * Called to set/change/clear current GraphRunCtx.
@@ -205,9 +378,26 @@ protected:
 	std::vector<Node::Ptr> inputs{};
 	std::vector<Node::Ptr> outputs{}; // Always sorted by priority (descending)
 	int32_t priority{0};              // Must be >= than children priorities
+	std::optional<int32_t> gpuPriority{std::nullopt};
 
 	bool dirty{true};
+	uint64_t validationCount{0};
 	CudaEvent::Ptr execCompleted{nullptr};
+	uint64_t resultFrameId{0}; // Written by graph thread, read by client's thread after waitForResults()
+	bool memoryReuseEnabled{false};
+	bool frameDroppingEnabled{false};
+
+	// Random numbers of the node (e.g. noise) come from a counter-based generator keyed by (seed, frame, element).
+	// Frames are counted from seeding, so that the same sequence of runs on the same inputs gives identical results.
+	uint64_t randomSeed = std::random_device{}();
+	uint64_t randomFrameIdx{0};
+	std::unordered_map<rgl_field_t, std::unique_ptr<ResultBuffer>> resultBuffers;
+
+	// Written by graph thread in sampled runs, read by client's thread in getStats()
+	std::mutex statsMutex;
+	std::unique_ptr<StatsEvents> statsEvents;
+	rgl_node_stats_t stats{};
+	bool isStatsGpuTimePending{false};
 
 	std::optional<std::shared_ptr<GraphRunCtx>> graphRunCtx; // Pointer may be destroyed e.g. on addChild
 	StreamBoundObjectsManager arrayMgr;
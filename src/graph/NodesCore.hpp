@@ -21,15 +21,26 @@
 #include <typeinfo>
 #include <ranges>
 #include <algorithm>
-#include <random>
-#include <curand_kernel.h>
+#include <array>
+#include <deque>
+#include <condition_variable>
+#include <mutex>
+
+#include <cufft.h>
 
 #include <graph/Node.hpp>
 #include <graph/Interfaces.hpp>
 #include <gpu/RaytraceRequestContext.hpp>
 #include <gpu/nodeKernels.hpp>
 #include <CacheManager.hpp>
+#include <CudaEvent.hpp>
+#include <Time.hpp>
 #include <GPUFieldDescBuilder.hpp>
+#include <ContentHash.hpp>
+#include <memory/SharedDeviceArrays.hpp>
+
+struct Scene;
+struct SceneSnapshot;
 
 
 struct FormatPointsNode : IPointsNodeSingleInput
@@ -39,6 +50,11 @@ struct FormatPointsNode : IPointsNodeSingleInput
 
 	// Node
 	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
+	bool acceptsDevicePointCount() const override { return canProvideDevicePointCount(); }
+	bool acceptsPendingXyzTransform() const override;
+	void releaseIntermediates() override { output->release(); } // Formatted points are provided from outputHost
+	void reserveArrays(std::size_t maxPointCount) override;
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override { return fields; }
@@ -48,6 +64,8 @@ struct FormatPointsNode : IPointsNodeSingleInput
 	{
 		return field == RGL_FIELD_DYNAMIC_FORMAT || std::find(fields.begin(), fields.end(), field) != fields.end();
 	}
+	const uint32_t* getPointCountDevicePtr() const override { return input->getPointCountDevicePtr(); }
+	std::size_t getPointCountUpperBound() const override { return input->getPointCountUpperBound(); }
 
 	// Data getters
 	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
@@ -57,6 +75,22 @@ struct FormatPointsNode : IPointsNodeSingleInput
 	static void formatAsync(DeviceAsyncArray<char>::Ptr output, const IPointsNode::Ptr& input,
 	                        const std::vector<rgl_field_t>& fields, GPUFieldDescBuilder& gpuFieldDescBuilder);
 
+	const std::vector<rgl_field_t>& getFields() const { return fields; }
+
+	/**
+	 * Returns the host copy of formatted points of the last run, downloaded once and shared by all host-side consumers.
+	 * It is not overwritten while held: the next run downloads into another buffer, so consumers processing the frame
+	 * asynchronously (e.g. publishers) may keep it instead of copying. Valid once the node's work is done (in stream order).
+	 * The array is allocated for getPointCountUpperBound() points, if the count is known on the device only.
+	 */
+	HostPinnedArray<char>::ConstPtr getHostFrame() const { return outputHost; }
+
+	/**
+	 * Returns the device array of formatted points of the last run, for device-side consumers in the graph thread.
+	 * It is overwritten by the next run.
+	 */
+	IAnyArray::ConstPtr getDeviceFrame() const { return outputDevice; }
+
 	// Needed to create GPUFieldDesc for other nodes
 	static std::vector<std::pair<rgl_field_t, const void*>> getFieldToPointerMappings(const IPointsNode::Ptr& input,
 	                                                                                  const std::vector<rgl_field_t>& fields);
@@ -65,72 +99,186 @@ private:
 	std::vector<rgl_field_t> fields;
 	DeviceAsyncArray<char>::Ptr output = DeviceAsyncArray<char>::create(arrayMgr);
 	HostPinnedArray<char>::Ptr outputHost = HostPinnedArray<char>::create();
-	GPUFieldDescBuilder gpuFieldDescBuilder;
+	std::vector<HostPinnedArray<char>::Ptr> outputHostBuffers{outputHost}; // Frames may be held by consumers
+	IAnyArray::ConstPtr outputDevice = output;                              // Output or fused output of RaytraceNode
+	GPUFieldDescBuilder gpuFieldDescBuilder{arrayMgr};
+
+	HostPinnedArray<char>::Ptr acquireOutputHostBuffer();
 };
 
-struct CompactByFieldPointsNode : IPointsNodeSingleInput
+/**
+ * Base of nodes selecting a subset of input points with a single pass of stream compaction (see gpuFindCompaction).
+ * Fields are gathered from the selection source only when requested.
+ */
+struct CompactPointsNode : IPointsNodeSingleInput, IPointsSelection
 {
-	using Ptr = std::shared_ptr<CompactByFieldPointsNode>;
-	void setParameters(rgl_field_t field);
-
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override;
+	void releaseIntermediates() override;
 
 	// Node requirements
-	std::vector<rgl_field_t> getRequiredFieldList() const override { return {IS_HIT_I32, IS_GROUND_I32}; }
+	std::vector<rgl_field_t> getIntermediateFieldList() const override
+	{
+		return {getAllRealFields().begin(), getAllRealFields().end()}; // Any field may be gathered on request
+	}
 
 	// Point cloud description
 	bool isDense() const override { return true; }
 	size_t getWidth() const override;
 	size_t getHeight() const override { return 1; }
+	const uint32_t* getPointCountDevicePtr() const override
+	{
+		return isPointCountDeferred ? selectedCount->getReadPtr() : nullptr;
+	}
+	std::size_t getPointCountUpperBound() const override
+	{
+		return isPointCountDeferred ? pointCountUpperBound : getPointCount();
+	}
 
 	// Data getters
 	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
 
+	// Selection
+	IPointsNode::Ptr getSelectionSource() const override { return selectionSource; }
+	const Field<RAY_IDX_U32>::type* getSelectionIndicesPtr() const override { return selectionIndices->getReadPtr(); }
+
+protected:
+	// Enqueues finding indices of selected input points (composed with inputIndices, if not null) into selectionIndices,
+	// and their count into selectedCount. Both arrays, as well as compactionTempStorage, are already sized.
+	virtual void enqueueFindSelection(size_t pointCount, const Field<RAY_IDX_U32>::type* inputIndices) = 0;
+
+	DeviceAsyncArray<char>::Ptr compactionTempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr selectedCount = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr selectionIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+
 private:
-	rgl_field_t fieldToCompactBy;
 	size_t width = {0};
-	DeviceAsyncArray<CompactionIndexType>::Ptr inclusivePrefixSum = DeviceAsyncArray<CompactionIndexType>::create(arrayMgr);
+	bool isPointCountDeferred = {false};
+	size_t pointCountUpperBound = {0};
+	HostPinnedArray<uint32_t>::Ptr selectedCountHost = HostPinnedArray<uint32_t>::create();
+	IPointsNode::Ptr selectionSource;
 	CacheManager<rgl_field_t, IAnyArray::Ptr> cacheManager;
 	std::mutex getFieldDataMutex;
 };
 
+struct CompactByFieldPointsNode : CompactPointsNode
+{
+	using Ptr = std::shared_ptr<CompactByFieldPointsNode>;
+	void setParameters(const std::vector<rgl_field_predicate_t>& predicates, bool matchAny);
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override;
+
+protected:
+	void enqueueFindSelection(size_t pointCount, const Field<RAY_IDX_U32>::type* inputIndices) override;
+
+private:
+	std::vector<rgl_field_predicate_t> predicates;
+	bool matchAny = {false};
+	std::vector<GPUFieldPredicate> gpuPredicatesHost;
+	DeviceAsyncArray<GPUFieldPredicate>::Ptr gpuPredicates = DeviceAsyncArray<GPUFieldPredicate>::create(arrayMgr);
+};
+
+struct CompactByRegionPointsNode : CompactPointsNode
+{
+	using Ptr = std::shared_ptr<CompactByRegionPointsNode>;
+	void setParameters(const rgl_region_t* regions, int32_t regionCount);
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+protected:
+	void enqueueFindSelection(size_t pointCount, const Field<RAY_IDX_U32>::type* inputIndices) override;
+
+private:
+	DeviceAsyncArray<rgl_region_t>::Ptr regions = DeviceAsyncArray<rgl_region_t>::create(arrayMgr);
+};
+
 struct RaytraceNode : IPointsNode
 {
 	using Ptr = std::shared_ptr<RaytraceNode>;
-	void setParameters();
+	void setParameters(std::shared_ptr<Scene> scene);
 
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override;
+	void reserveArrays(std::size_t maxPointCount) override { Node::reserveArrays(maxPointCount * getReturnCount()); }
 
 	// Point cloud description
-	bool isDense() const override { return false; }
+	bool isDense() const override { return isDenseOutput; }
 	bool hasField(rgl_field_t field) const override { return fieldData.contains(field); }
-	size_t getWidth() const override { return raysNode ? raysNode->getRayCount() : 0; }
-	size_t getHeight() const override { return 1; } // TODO: implement height in use_rays
-
-	Mat3x4f getLookAtOriginTransform() const override { return raysNode->getCumulativeRayTransfrom().inverse(); }
+	size_t getWidth() const override;
+	size_t getHeight() const override;
+	const uint32_t* getPointCountDevicePtr() const override
+	{
+		return isPointCountDeferred ? denseHitCount->getReadPtr() : nullptr;
+	}
+	std::size_t getPointCountUpperBound() const override
+	{
+		return isPointCountDeferred ? raysNode->getRayCount() : getPointCount();
+	}
 
-	// Data getters
-	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override
+	Mat3x4f getLookAtOriginTransform() const override
 	{
-		if (field == RAY_POSE_MAT3x4_F32) {
-			return raysNode->getRays();
-		}
-		return std::const_pointer_cast<const IAnyArray>(fieldData.at(field));
+		return raysNode->getCumulativeRayTransfrom().inverse() * getWorldToOutputTransform().inverse();
 	}
 
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
 	// RaytraceNode specific
 	void setVelocity(const Vec3f& linearVelocity, const Vec3f& angularVelocity);
 	void enableRayDistortion(bool enabled) { doApplyDistortion = enabled; }
 	void setNonHitDistanceValues(float nearDistance, float farDistance);
+	void setReturnMode(rgl_return_mode_t mode) { returnMode = mode; }
+	void setBeamDivergence(float divergenceAngle, int sampleCount, rgl_beam_reduction_t reduction);
+	void setNoise(float angularMean, float angularStDev, rgl_axis_t angularAxis, float distanceMean, float distanceStDevBase,
+	              float distanceStDevRisePerMeter);
+	void setWeather(float extinctionCoefficient, float particleIntensity);
+	void setMultipath(int bounceCount, float reflectivity);
+	void setVisibilityMask(uint8_t mask) { visibilityMask = mask; }
+	void setCulling(float range, float movementThreshold);
+	void setIncremental(bool enabled);
+	void setResultCache(bool enabled);
+	void setRaySorting(bool enabled) { isRaySortingEnabled = enabled; }
+	void setTimeSlicing(std::size_t sliceCount);
+	bool isTimeSliced() const { return timeSliceCount > 1; }
+	void setStreaming(std::size_t chunkCount);
+	bool isStreamed() const { return streamingChunkCount > 1; }
+	void setRaySkipping(int missFrameCount, int probePeriod);
+	void setDenseOutput(bool enabled) { isDenseOutput = enabled; }
+	void setFusedFormat(bool enabled) { isFusedFormatEnabled = enabled; }
+	void setOutputFrame(rgl_output_frame_t frame, const Mat3x4f& transform)
+	{
+		outputFrame = frame;
+		outputFrameTransform = transform;
+	}
+	// Formatted points written by raygen for the consumer FormatPointsNode, or nullptr if formatting is not fused.
+	DeviceAsyncArray<char>::ConstPtr getFusedFormatData() const
+	{
+		return fusedFormatFields.empty() ? nullptr : fusedFormatData;
+	}
+	std::size_t getRayCount() const { return raysNode->getRayCount(); }
+	const std::shared_ptr<Scene>& getScene() const { return scene; }
+
+	// In streaming mode, columns of the ray layout are traced in chunks, each completing with an event of its own.
+	struct StreamedChunk
+	{
+		std::size_t columnBegin;
+		std::size_t columnCount;
+		CudaEvent::Ptr completed = CudaEvent::create(); // Recorded in node's stream once outputs of the chunk are written
+	};
+	// Chunks of the last run; valid once the node is enqueued.
+	const std::vector<StreamedChunk>& getStreamedChunks() const { return streamedChunks; }
 
 private:
+	std::shared_ptr<Scene> scene;
 	IRaysNode::Ptr raysNode;
 
 	DeviceAsyncArray<Vec2f>::Ptr defaultRange = DeviceAsyncArray<Vec2f>::create(arrayMgr);
+	DeviceAsyncArray<Mat3x4f>::Ptr rayPoses = DeviceAsyncArray<Mat3x4f>::create(arrayMgr); // Only if the transform is pending
 	bool doApplyDistortion{false};
 	Vec3f sensorLinearVelocityXYZ{0, 0, 0};
 	Vec3f sensorAngularVelocityRPY{0, 0, 0};
@@ -138,8 +286,137 @@ private:
 	float nearNonHitDistance{std::numeric_limits<float>::infinity()};
 	float farNonHitDistance{std::numeric_limits<float>::infinity()};
 
-	HostPinnedArray<RaytraceRequestContext>::Ptr requestCtxHst = HostPinnedArray<RaytraceRequestContext>::create();
-	DeviceAsyncArray<RaytraceRequestContext>::Ptr requestCtxDev = DeviceAsyncArray<RaytraceRequestContext>::create(arrayMgr);
+	rgl_return_mode_t returnMode{RGL_RETURN_MODE_FIRST};
+
+	float beamDivergenceAngle{0.0f};
+	int beamSampleCount{1};
+	rgl_beam_reduction_t beamReduction{RGL_BEAM_REDUCTION_NEAREST};
+
+	float rayAngularNoiseMean{0.0f};
+	float rayAngularNoiseStDev{0.0f};
+	rgl_axis_t rayAngularNoiseAxis{RGL_AXIS_X};
+	float hitDistanceNoiseMean{0.0f};
+	float hitDistanceNoiseStDevBase{0.0f};
+	float hitDistanceNoiseStDevRisePerMeter{0.0f};
+
+	float weatherExtinctionCoefficient{0.0f};
+	float weatherParticleIntensity{0.0f};
+
+	int multipathBounceCount{0};
+	float multipathReflectivity{1.0f};
+
+	uint8_t visibilityMask{RGL_DEFAULT_VISIBILITY_MASK};
+
+	// Instances out of range are hidden in a culled copy of the scene's AS, see getCulledAS(); zero range disables it.
+	// The culled AS is reused while the scene's AS is unchanged and the rays' origin moved less than the threshold.
+	float cullingRange{0.0f};
+	float cullingMovementThreshold{0.0f};
+	std::optional<uint64_t> culledASVersion;
+	Vec3f culledASOrigin{0.0f, 0.0f, 0.0f};
+	OptixTraversableHandle culledAS{0};
+	DeviceAsyncArray<OptixInstance>::Ptr culledInstances = DeviceAsyncArray<OptixInstance>::create(arrayMgr);
+	DeviceAsyncArray<std::byte>::Ptr culledASTemp = DeviceAsyncArray<std::byte>::create(arrayMgr);
+	DeviceAsyncArray<std::byte>::Ptr culledASOutput = DeviceAsyncArray<std::byte>::create(arrayMgr);
+
+	// In dense output mode, only hits are written, to consecutive slots reserved in raygen (in no particular order).
+	// As in CompactPointsNode, the count stays on the device if all consumers accept it, see getPointCountDevicePtr().
+	bool isDenseOutput{false};
+	bool isPointCountDeferred{false};
+	DeviceAsyncArray<uint32_t>::Ptr denseHitCount = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	HostPinnedArray<uint32_t>::Ptr denseHitCountHost = HostPinnedArray<uint32_t>::create();
+
+	// If the only consumer is a FormatPointsNode of fields written by raygen, points are written formatted.
+	bool isFusedFormatEnabled{false};
+	std::vector<rgl_field_t> fusedFormatFields; // Empty if formatting is not fused
+	DeviceAsyncArray<char>::Ptr fusedFormatData = DeviceAsyncArray<char>::create(arrayMgr);
+
+	// Geometric fields are written in the output frame: outputFrameTransform applied to the outputFrame.
+	rgl_output_frame_t outputFrame{RGL_OUTPUT_FRAME_WORLD};
+	Mat3x4f outputFrameTransform{Mat3x4f::identity()};
+	Mat3x4f getWorldToOutputTransform() const;
+
+	// Rays may be traced in the order of their directions, which is coherent for scattered patterns; see getRayIdxRemap().
+	bool isRaySortingEnabled{false};
+	DeviceAsyncArray<uint64_t>::Ptr rayDirectionKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr sortedRayDirectionKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr rayIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr rayIdxRemap = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr raySortTempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+
+	// In time-sliced mode, rays are traced in slices (of equal ray counts) in order of their time offsets, each in a copy of
+	// the scene's AS with instances moved to the time of the slice, see enqueueTimeSlicedLaunch(). ASes are built (and then
+	// refitted) alternately in two buffers in a separate stream, so that the build of the next slice overlaps the launch.
+	struct TimeSliceAS
+	{
+		explicit TimeSliceAS(StreamBoundObjectsManager& arrayMgr)
+		  : instances(DeviceAsyncArray<OptixInstance>::create(arrayMgr)), output(DeviceAsyncArray<std::byte>::create(arrayMgr))
+		{}
+		DeviceAsyncArray<OptixInstance>::Ptr instances;
+		DeviceAsyncArray<std::byte>::Ptr output;
+		OptixTraversableHandle handle{0};
+		CudaEvent::Ptr built = CudaEvent::create();    // Recorded in the build stream
+		CudaEvent::Ptr launched = CudaEvent::create(); // Recorded in node's stream, after the launch of the slice
+	};
+	std::size_t timeSliceCount{1};
+	std::array<TimeSliceAS, 2> timeSliceASes{TimeSliceAS{arrayMgr}, TimeSliceAS{arrayMgr}};
+	DeviceAsyncArray<std::byte>::Ptr timeSliceASTemp = DeviceAsyncArray<std::byte>::create(arrayMgr);
+	CudaStream::Ptr timeSliceBuildStream{nullptr};
+	CudaEvent::Ptr timeSliceInputsReady = CudaEvent::create();
+
+	// In streaming mode, consumers may read outputs of each chunk as soon as it is traced, see enqueueStreamedLaunch().
+	// Culling and incremental tracing apply to all chunks, which are traced with a single upload of launch params.
+	std::size_t streamingChunkCount{1};
+	std::vector<StreamedChunk> streamedChunks;
+	bool isStreamedLaunchEnqueued{false}; // Otherwise (e.g. result cache hit), events of all chunks are recorded at once
+
+	// In incremental mode, rays that are unchanged and miss bounds of instances changed since the previous frame are not
+	// traced, keeping their previous output; see prepareIncrementalTrace() for when it applies.
+	// Instances of the previous frame are kept to find the changed ones (by index, see gpuFindChangedInstanceBounds).
+	bool isIncremental{false};
+	std::optional<RaytraceRequestContext> incrementalPrevRequestCtx; // Of the previous frame, if it can be patched
+	uint64_t incrementalPrevGASVersionSum{0};
+	DeviceAsyncArray<Mat3x4f>::Ptr incrementalPrevRays = DeviceAsyncArray<Mat3x4f>::create(arrayMgr);
+	DeviceAsyncArray<Vec2f>::Ptr incrementalPrevRanges = DeviceAsyncArray<Vec2f>::create(arrayMgr);
+	DeviceAsyncArray<OptixInstance>::Ptr incrementalPrevInstances = DeviceAsyncArray<OptixInstance>::create(arrayMgr);
+	DeviceAsyncArray<EntityInstanceData>::Ptr incrementalPrevEntityInstances =
+	    DeviceAsyncArray<EntityInstanceData>::create(arrayMgr);
+	DeviceAsyncArray<EntityTransformHistory>::Ptr incrementalPrevTransformHistories =
+	    DeviceAsyncArray<EntityTransformHistory>::create(arrayMgr);
+	DeviceAsyncArray<Vec4f>::Ptr incrementalPrevInstanceBounds = DeviceAsyncArray<Vec4f>::create(arrayMgr);
+	DeviceAsyncArray<Vec4f>::Ptr incrementalChangedBounds = DeviceAsyncArray<Vec4f>::create(arrayMgr);
+	DeviceAsyncArray<unsigned>::Ptr incrementalChangedBoundsCount = DeviceAsyncArray<unsigned>::create(arrayMgr);
+
+	// With ray skipping, rays that missed in raySkippingMissFrameCount consecutive frames are not traced, apart from probes
+	// every raySkippingProbePeriod frames. Counters of misses are indexed by ray, so they are reset when the ray count changes.
+	int raySkippingMissFrameCount{0};
+	int raySkippingProbePeriod{1};
+	uint64_t raySkippingFrameIdx{0};
+	DeviceAsyncArray<uint8_t>::Ptr rayMissFrameCounts = DeviceAsyncArray<uint8_t>::create(arrayMgr);
+
+	// With result cache, tracing is skipped (keeping the previous output) if the request, the scene version and revisions
+	// of upstream nodes are the same as in the previous run; see isResultCacheHit() for when it applies.
+	struct ResultCacheKey
+	{
+		RaytraceRequestContext requestCtx;
+		uint64_t asVersion;
+		uint64_t gasVersionSum;
+		uint64_t sbtVersion;
+		std::vector<std::pair<const Node*, uint64_t>> upstreamRevisions; // Including this node
+	};
+	bool isResultCacheEnabled{false};
+	std::optional<ResultCacheKey> resultCacheKey; // Of the previous run, if its output is kept
+
+	// Ring of slots holding launch params followed by requests of all nodes traced in the launch, see enqueueLaunch().
+	// Each launch uses the next slot, so that writing it does not have to wait until the previous launch reads its own.
+	struct LaunchSlot
+	{
+		HostPinnedArray<std::byte>::Ptr hst = HostPinnedArray<std::byte>::create();
+		DeviceSyncArray<std::byte>::Ptr dev = DeviceSyncArray<std::byte>::create();
+		CudaEvent::Ptr launchCompleted = CudaEvent::create();
+	};
+	static constexpr std::size_t LAUNCH_SLOT_COUNT = 3;
+	std::array<LaunchSlot, LAUNCH_SLOT_COUNT> launchSlots;
+	std::size_t nextLaunchSlot{0};
 
 	std::unordered_map<rgl_field_t, IAnyArray::Ptr> fieldData; // All should be DeviceAsyncArray
 
@@ -147,7 +424,29 @@ private:
 	auto getPtrTo();
 
 	std::set<rgl_field_t> findFieldsToCompute();
+	std::vector<rgl_field_t> findFusedFormat() const;
 	void setFields(const std::set<rgl_field_t>& fields);
+	unsigned getClosestHitVariant() const;
+	unsigned getReturnCount() const;
+	bool isRayPoseMaterialized() const;
+	size_t getRayLayoutWidth() const;
+	size_t getRayLayoutHeight() const;
+
+	// Traces rays of all given nodes (including this one) in a single launch, enqueued in this node's stream.
+	void enqueueLaunch(const std::vector<RaytraceNode*>& requesters);
+	void enqueueOptixLaunch(const std::vector<RaytraceRequestContext>& requestCtxs, std::size_t width, std::size_t height,
+	                        const OptixShaderBindingTable& sbt);
+	bool canTraceTimeSliced(const SceneSnapshot& sceneSnapshot) const;
+	void enqueueTimeSlicedLaunch(RaytraceRequestContext requestCtx, const SceneSnapshot& sceneSnapshot);
+	void updateStreamedChunks();
+	void enqueueStreamedLaunch(RaytraceRequestContext requestCtx, const SceneSnapshot& sceneSnapshot);
+	LaunchSlot& acquireLaunchSlot();
+	RaytraceRequestContext makeRequestCtx(const SceneSnapshot& sceneSnapshot);
+	OptixTraversableHandle getCulledAS(const SceneSnapshot& sceneSnapshot, cudaStream_t stream);
+	const uint32_t* getRayIdxRemap(cudaStream_t stream, bool isTimeOrdered = false);
+	void prepareIncrementalTrace(RaytraceRequestContext& requestCtx, const SceneSnapshot& sceneSnapshot, bool isBatched);
+	bool isResultCacheHit(const RaytraceRequestContext& requestCtx, const SceneSnapshot& sceneSnapshot);
+	std::vector<std::pair<const Node*, uint64_t>> getUpstreamRevisions() const;
 };
 
 struct TransformPointsNode : IPointsNodeSingleInput
@@ -158,19 +457,53 @@ struct TransformPointsNode : IPointsNodeSingleInput
 
 	// Node
 	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
+	bool acceptsDevicePointCount() const override { return canProvideDevicePointCount(); }
+	bool acceptsPendingXyzTransform() const override { return true; }
+	void releaseIntermediates() override { output->release(); }
 	std::string getArgsString() const override;
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+	// Deferred transform forwards input's XYZ, see getFieldData().
+	std::vector<rgl_field_t> getIntermediateFieldList() const override { return getMaterializedFieldList(); }
+	std::vector<rgl_field_t> getInPlaceFieldList() const override { return getMaterializedFieldList(); }
+
+	// Point cloud description
+	const uint32_t* getPointCountDevicePtr() const override { return input->getPointCountDevicePtr(); }
+	std::size_t getPointCountUpperBound() const override { return input->getPointCountUpperBound(); }
 
 	Mat3x4f getLookAtOriginTransform() const override { return transform.inverse() * input->getLookAtOriginTransform(); }
+	std::optional<Mat3x4f> getPendingXyzTransform() const override
+	{
+		return isTransformDeferred ? std::make_optional(getComposedTransform()) : std::nullopt;
+	}
 
 	// Data getters
 	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+	IAnyArray::Ptr getOwnedFieldData(rgl_field_t field) override;
 
 private:
+	// Transforms of consecutive nodes are composed; the result is applied once, by the first node that is not deferred.
+	Mat3x4f getComposedTransform() const { return transform * input->getPendingXyzTransform().value_or(Mat3x4f::identity()); }
+
+	// If all outputs accept it, they apply the transform instead, see enqueueExecImpl().
+	bool canDeferTransform() const;
+	std::vector<rgl_field_t> getMaterializedFieldList() const
+	{
+		return canDeferTransform() ? std::vector<rgl_field_t>{} : std::vector<rgl_field_t>{XYZ_VEC3_F32};
+	}
+	// Array written in the current run: input's XYZ overwritten in place or the own one.
+	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr getOutput() const
+	{
+		return inPlaceOutput != nullptr ? inPlaceOutput : output;
+	}
+
 	Mat3x4f transform;
+	bool isTransformDeferred{false}; // See canDeferTransform()
+	std::optional<uint64_t> deferredOutputFrameId; // Of the run whose output was materialized on request, see getFieldData()
 	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr output = DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr inPlaceOutput; // See IPointsNode::getInPlaceFieldList()
 };
 
 struct TransformRaysNode : IRaysNodeSingleInput
@@ -179,14 +512,25 @@ struct TransformRaysNode : IRaysNodeSingleInput
 	void setParameters(Mat3x4f transform) { this->transform = transform; }
 
 	// Node
+	void validateImpl() override;
 	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
 
 	// Data getters
-	Array<Mat3x4f>::ConstPtr getRays() const override { return transformedRays; }
+	// Directions are relative to the cumulative transform, so they are not transformed at all.
+	Array<Mat3x4f>::ConstPtr getRays() const override
+	{
+		return input->getRayDirections().has_value() || isTransformDeferred ? input->getRays() : transformedRays;
+	}
 	Mat3x4f getCumulativeRayTransfrom() const override { return transform * input->getCumulativeRayTransfrom(); }
+	std::optional<Mat3x4f> getPendingRayTransform() const override
+	{
+		return isTransformDeferred ? std::make_optional(transform) : std::nullopt;
+	}
 
 private:
 	Mat3x4f transform;
+	bool isTransformDeferred{false}; // If all outputs are RaytraceNodes, they apply the transform in raygen instead
 	DeviceAsyncArray<Mat3x4f>::Ptr transformedRays = DeviceAsyncArray<Mat3x4f>::create(arrayMgr);
 };
 
@@ -194,9 +538,15 @@ struct FromMat3x4fRaysNode : IRaysNode, INoInputNode
 {
 	using Ptr = std::shared_ptr<FromMat3x4fRaysNode>;
 	void setParameters(const Mat3x4f* raysRaw, size_t rayCount);
+	// Identical data requires neither an upload nor revalidation, see createOrUpdateNode()
+	bool isUnchangedBy(const Mat3x4f* raysRaw, size_t rayCount) const
+	{
+		return rayCount == rays->getCount() && hashContent(raysRaw, rayCount) == raysHash;
+	}
 
 	// Node
 	void enqueueExecImpl() override {}
+	bool isCudaGraphCapturable() const override { return true; }
 
 	// Transforms
 	size_t getRayCount() const override { return rays->getCount(); }
@@ -214,18 +564,110 @@ struct FromMat3x4fRaysNode : IRaysNode, INoInputNode
 	std::optional<size_t> getTimeOffsetsCount() const override { return std::nullopt; }
 	std::optional<Array<float>::ConstPtr> getTimeOffsets() const override { return std::nullopt; }
 
+	// Layout
+	std::optional<Vec2i> getLayout() const override { return std::nullopt; }
+
+private:
+	uint64_t raysHash{0};
+	DeviceAsyncArray<Mat3x4f>::ConstPtr rays = DeviceAsyncArray<Mat3x4f>::create(arrayMgr); // See SharedDeviceArrays
+};
+
+struct FromDirectionsRaysNode : IRaysNode, INoInputNode
+{
+	using Ptr = std::shared_ptr<FromDirectionsRaysNode>;
+	void setParameters(const Vec3f* directionsRaw, size_t rayCount);
+	bool isUnchangedBy(const Vec3f* directionsRaw, size_t rayCount) const
+	{
+		return rayCount == directions->getCount() && hashContent(directionsRaw, rayCount) == directionsHash;
+	}
+
+	// Node
+	void enqueueExecImpl() override {}
+	bool isCudaGraphCapturable() const override { return true; }
+
+	// Transforms
+	size_t getRayCount() const override { return directions->getCount(); }
+	Array<Mat3x4f>::ConstPtr getRays() const override { return rays; }
+	std::optional<Array<Vec3f>::ConstPtr> getRayDirections() const override { return directions; }
+
+	// Ring Ids
+	std::optional<size_t> getRingIdsCount() const override { return std::nullopt; }
+	std::optional<Array<int>::ConstPtr> getRingIds() const override { return std::nullopt; }
+
+	// Ranges
+	std::optional<size_t> getRangesCount() const override { return std::nullopt; }
+	std::optional<Array<Vec2f>::ConstPtr> getRanges() const override { return std::nullopt; }
+
+	// Firing time offsets
+	std::optional<size_t> getTimeOffsetsCount() const override { return std::nullopt; }
+	std::optional<Array<float>::ConstPtr> getTimeOffsets() const override { return std::nullopt; }
+
+	// Layout
+	std::optional<Vec2i> getLayout() const override { return std::nullopt; }
+
+private:
+	uint64_t directionsHash{0};
+	DeviceAsyncArray<Mat3x4f>::Ptr rays = DeviceAsyncArray<Mat3x4f>::create(arrayMgr); // Always empty
+	DeviceAsyncArray<Vec3f>::ConstPtr directions = DeviceAsyncArray<Vec3f>::create(arrayMgr); // See SharedDeviceArrays
+};
+
+struct FromPatternRaysNode : IRaysNode, INoInputNode
+{
+	using Ptr = std::shared_ptr<FromPatternRaysNode>;
+	void setParameters(const float* ringElevations, const float* ringTimeOffsets, size_t ringCount, float azimuthStart,
+	                   float azimuthStep, size_t azimuthStepCount, float azimuthStepTime);
+
+	// Node
+	void enqueueExecImpl() override;
+
+	// Transforms
+	size_t getRayCount() const override { return rays->getCount(); }
+	Array<Mat3x4f>::ConstPtr getRays() const override { return rays; }
+
+	// Ring Ids
+	std::optional<size_t> getRingIdsCount() const override { return ringIds->getCount(); }
+	std::optional<Array<int>::ConstPtr> getRingIds() const override { return ringIds; }
+
+	// Ranges
+	std::optional<size_t> getRangesCount() const override { return std::nullopt; }
+	std::optional<Array<Vec2f>::ConstPtr> getRanges() const override { return std::nullopt; }
+
+	// Firing time offsets
+	std::optional<size_t> getTimeOffsetsCount() const override { return timeOffsets->getCount(); }
+	std::optional<Array<float>::ConstPtr> getTimeOffsets() const override { return timeOffsets; }
+
+	// Layout
+	std::optional<Vec2i> getLayout() const override
+	{
+		return Vec2i{static_cast<int>(azimuthStepCount), static_cast<int>(ringElevations->getCount())};
+	}
+
 private:
+	float azimuthStart;
+	float azimuthStep;
+	size_t azimuthStepCount;
+	float azimuthStepTime;
+	bool isPatternGenerated{false}; // Rays are generated once per parameters change
+	DeviceAsyncArray<float>::Ptr ringElevations = DeviceAsyncArray<float>::create(arrayMgr);
+	DeviceAsyncArray<float>::Ptr ringTimeOffsets = DeviceAsyncArray<float>::create(arrayMgr);
 	DeviceAsyncArray<Mat3x4f>::Ptr rays = DeviceAsyncArray<Mat3x4f>::create(arrayMgr);
+	DeviceAsyncArray<int>::Ptr ringIds = DeviceAsyncArray<int>::create(arrayMgr);
+	DeviceAsyncArray<float>::Ptr timeOffsets = DeviceAsyncArray<float>::create(arrayMgr);
 };
 
 struct SetRingIdsRaysNode : IRaysNodeSingleInput
 {
 	using Ptr = std::shared_ptr<SetRingIdsRaysNode>;
 	void setParameters(const int* ringIdsRaw, size_t ringIdsCount);
+	bool isUnchangedBy(const int* ringIdsRaw, size_t ringIdsCount) const
+	{
+		return ringIdsCount == ringIds->getCount() && hashContent(ringIdsRaw, ringIdsCount) == ringIdsHash;
+	}
 
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override {}
+	bool isCudaGraphCapturable() const override { return true; }
 
 	// Rays description
 	std::optional<size_t> getRingIdsCount() const override { return ringIds->getCount(); }
@@ -234,17 +676,40 @@ struct SetRingIdsRaysNode : IRaysNodeSingleInput
 	std::optional<Array<int>::ConstPtr> getRingIds() const override { return ringIds; }
 
 private:
-	DeviceAsyncArray<int>::Ptr ringIds = DeviceAsyncArray<int>::create(arrayMgr);
+	uint64_t ringIdsHash{0};
+	DeviceAsyncArray<int>::ConstPtr ringIds = DeviceAsyncArray<int>::create(arrayMgr); // See SharedDeviceArrays
+};
+
+struct SetLayoutRaysNode : IRaysNodeSingleInput
+{
+	using Ptr = std::shared_ptr<SetLayoutRaysNode>;
+	void setParameters(int width, int height) { layout = {width, height}; }
+
+	// Node
+	void validateImpl() override;
+	void enqueueExecImpl() override {}
+	bool isCudaGraphCapturable() const override { return true; }
+
+	// Layout
+	std::optional<Vec2i> getLayout() const override { return layout; }
+
+private:
+	Vec2i layout{0, 0};
 };
 
 struct SetRangeRaysNode : IRaysNodeSingleInput
 {
 	using Ptr = std::shared_ptr<SetRangeRaysNode>;
 	void setParameters(const Vec2f* rangesRaw, size_t rangesCount);
+	bool isUnchangedBy(const Vec2f* rangesRaw, size_t rangesCount) const
+	{
+		return rangesCount == ranges->getCount() && hashContent(rangesRaw, rangesCount) == rangesHash;
+	}
 
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override {}
+	bool isCudaGraphCapturable() const override { return true; }
 
 	// Rays description
 	std::optional<std::size_t> getRangesCount() const override { return ranges->getCount(); }
@@ -253,17 +718,23 @@ struct SetRangeRaysNode : IRaysNodeSingleInput
 	std::optional<Array<Vec2f>::ConstPtr> getRanges() const override { return ranges; }
 
 private:
-	Array<Vec2f>::Ptr ranges = DeviceAsyncArray<Vec2f>::create(arrayMgr);
+	uint64_t rangesHash{0};
+	DeviceAsyncArray<Vec2f>::ConstPtr ranges = DeviceAsyncArray<Vec2f>::create(arrayMgr); // See SharedDeviceArrays
 };
 
 struct SetTimeOffsetsRaysNode : IRaysNodeSingleInput
 {
 	using Ptr = std::shared_ptr<SetTimeOffsetsRaysNode>;
 	void setParameters(const float* raysTimeOffsets, size_t timeOffsetsCount);
+	bool isUnchangedBy(const float* raysTimeOffsets, size_t timeOffsetsCount) const
+	{
+		return timeOffsetsCount == timeOffsets->getCount() && hashContent(raysTimeOffsets, timeOffsetsCount) == timeOffsetsHash;
+	}
 
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override {}
+	bool isCudaGraphCapturable() const override { return true; }
 
 	// Rays description
 	std::optional<size_t> getTimeOffsetsCount() const override { return timeOffsets->getCount(); }
@@ -272,7 +743,8 @@ struct SetTimeOffsetsRaysNode : IRaysNodeSingleInput
 	std::optional<Array<float>::ConstPtr> getTimeOffsets() const override { return timeOffsets; }
 
 private:
-	Array<float>::Ptr timeOffsets = DeviceAsyncArray<float>::create(arrayMgr);
+	uint64_t timeOffsetsHash{0};
+	DeviceAsyncArray<float>::ConstPtr timeOffsets = DeviceAsyncArray<float>::create(arrayMgr); // See SharedDeviceArrays
 };
 
 struct YieldPointsNode : IPointsNodeSingleInput
@@ -282,6 +754,8 @@ struct YieldPointsNode : IPointsNodeSingleInput
 
 	// Node
 	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
+	void reserveArrays(std::size_t maxPointCount) override;
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override { return fields; }
@@ -289,12 +763,158 @@ struct YieldPointsNode : IPointsNodeSingleInput
 	// Data getters
 	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override { return results.at(field); }
 
-	HostPinnedArray<Field<XYZ_VEC3_F32>::type>::Ptr getXYZCache() { return xyzHostCache; }
+	/**
+	 * Returns host copy of the field's data, prefetched as the part of node's execution, or nullptr for dummy fields.
+	 * Valid after waitForResults(). Its size is known also if arrays of the field were released, see Node::setMemoryReuse().
+	 */
+	const void* getHostCache(rgl_field_t field) const;
+	std::size_t getHostCacheSize(rgl_field_t field) const { return hostCacheRanges.at(field).second; }
 
 private:
+	// Offsets of fields in hostCache are aligned, so that host copies are friendly to vectorized memcpy.
+	static constexpr std::size_t HOST_CACHE_ALIGNMENT = 64;
+
 	std::vector<rgl_field_t> fields;
 	std::unordered_map<rgl_field_t, IAnyArray::ConstPtr> results;
-	HostPinnedArray<Field<XYZ_VEC3_F32>::type>::Ptr xyzHostCache = HostPinnedArray<Field<XYZ_VEC3_F32>::type>::create();
+	std::unordered_map<rgl_field_t, std::pair<std::size_t, std::size_t>> hostCacheRanges; // Offset and size in bytes
+	// All fields are prefetched to a single staging buffer (SoA), so that there is one allocation and one event to wait for.
+	HostPinnedArray<char>::Ptr hostCache = HostPinnedArray<char>::create();
+};
+
+/**
+ * Writes formatted point clouds into a ring in POSIX shared memory, see rgl_shm_ring_header_t.
+ * Slots are published in stream order (host functions bracketing the copies), so that graph thread does not wait for the GPU.
+ */
+struct ShmPublishPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<ShmPublishPointsNode>;
+	void setParameters(const char* shmName, int32_t slotCount, std::size_t slotDataSize, bool exportDeviceBuffers);
+
+	// Node
+	void validateImpl() override;
+	void enqueueExecImpl() override;
+	std::string getArgsString() const override;
+
+	~ShmPublishPointsNode() override;
+
+private:
+	// Slot's point data is aligned, so that readers may access it as an array of (aligned) points.
+	static constexpr std::size_t SLOT_DATA_ALIGNMENT = 256;
+
+	// Values of the slot header known when the frame is enqueued, written to the slot once its data is copied.
+	struct SlotCommit
+	{
+		rgl_shm_ring_header_t* ring;
+		rgl_shm_slot_header_t* slot;
+		rgl_shm_slot_header_t values;
+	};
+
+	void createRing();
+	void destroyRing();
+	rgl_shm_slot_header_t* getSlotHeader(std::size_t slotIdx) const;
+	static void beginSlotWrite(void* slotHeader);
+	static void commitSlotWrite(void* slotCommit);
+
+	std::string shmName;
+	int32_t slotCount{0};
+	std::size_t slotDataSize{0};
+	bool exportDeviceBuffers{false};
+
+	void* mapping{nullptr};
+	std::size_t mappingSize{0};
+	std::vector<void*> deviceBuffers;
+	std::vector<rgl_field_t> layout;
+	uint64_t writtenFrameCount{0};
+};
+
+/**
+ * Writes formatted point clouds to files (see rgl_point_file_format_t) in a background thread.
+ * Point data is staged in page-locked buffers, so that the graph thread waits only if the writer lags behind.
+ */
+struct WritePointsFileNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<WritePointsFileNode>;
+	void setParameters(const char* pathPrefix, rgl_point_file_format_t format);
+
+	// Node
+	void validateImpl() override;
+	void enqueueExecImpl() override;
+	std::string getArgsString() const override;
+
+	~WritePointsFileNode() override;
+
+private:
+	static constexpr std::size_t STAGING_BUFFER_COUNT = 2;
+
+	struct WriteJob
+	{
+		std::string path;
+		rgl_point_file_format_t format;
+		std::vector<rgl_field_t> layout;
+		std::size_t width;
+		std::size_t height;
+		CudaEvent::Ptr dataReady;
+		HostPinnedArray<char>::Ptr data;
+	};
+
+	void writerMain();
+	static void writeFile(const WriteJob& job);
+
+	std::string pathPrefix;
+	rgl_point_file_format_t format{RGL_POINT_FILE_FORMAT_PCD};
+	std::vector<rgl_field_t> layout;
+	std::array<HostPinnedArray<char>::Ptr, STAGING_BUFFER_COUNT> stagingBuffers{HostPinnedArray<char>::create(),
+	                                                                            HostPinnedArray<char>::create()};
+	std::size_t nextStagingBufferIdx{0};
+
+	std::thread writer;
+	std::deque<WriteJob> pendingJobs;
+	std::exception_ptr writeError; // Of the earliest failed job, rethrown by the next run
+	bool isShutdownRequested{false};
+	std::mutex mutex;
+	std::condition_variable jobSubmitted;
+	std::condition_variable jobCompleted; // Staging buffer of the job is released
+};
+
+/**
+ * Encodes XYZ of points into a byte stream of bit-packed quantized deltas (see rgl_compressed_points_header_t).
+ * Blocks of points are encoded in parallel: first their headers and sizes, then (at offsets scanned from the sizes)
+ * their deltas. The stream size is needed on host, so the node waits for the sizes in the middle of its work.
+ */
+struct CompressPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<CompressPointsNode>;
+	void setParameters(float xyzStep);
+
+	// Node
+	void enqueueExecImpl() override;
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+	// Point cloud description
+	bool isDense() const override { return true; }
+	bool hasField(rgl_field_t field) const override { return field == RGL_FIELD_DYNAMIC_FORMAT; }
+	size_t getWidth() const override;
+	size_t getHeight() const override { return 1; }
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+	std::size_t getFieldPointSize(rgl_field_t field) const override;
+
+private:
+	float xyzStep{0.001f};
+	DeviceAsyncArray<Vector<3, uint32_t>>::Ptr deltas = DeviceAsyncArray<Vector<3, uint32_t>>::create(arrayMgr);
+	DeviceAsyncArray<rgl_compressed_block_header_t>::Ptr blockHeaders =
+	    DeviceAsyncArray<rgl_compressed_block_header_t>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr blockSizes = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr blockOffsets = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr scanTempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+	HostPinnedArray<uint32_t>::Ptr blocksSizeHost = HostPinnedArray<uint32_t>::create();
+	HostPinnedArray<rgl_compressed_points_header_t>::Ptr streamHeader =
+	    HostPinnedArray<rgl_compressed_points_header_t>::create();
+	DeviceAsyncArray<char>::Ptr stream = DeviceAsyncArray<char>::create(arrayMgr);
 };
 
 struct SpatialMergePointsNode : IPointsNode
@@ -328,12 +948,20 @@ private:
 	std::vector<IPointsNode::Ptr> pointInputs;
 	std::unordered_map<rgl_field_t, IAnyArray::Ptr> mergedData;
 	std::size_t width = 0;
+	HostPinnedArray<GPUMergeDesc>::Ptr mergeDescsHost = HostPinnedArray<GPUMergeDesc>::create();
+	DeviceAsyncArray<GPUMergeDesc>::Ptr mergeDescs = DeviceAsyncArray<GPUMergeDesc>::create(arrayMgr);
 };
 
 struct TemporalMergePointsNode : IPointsNodeSingleInput
 {
-	using Ptr = std::shared_ptr<YieldPointsNode>;
+	using Ptr = std::shared_ptr<TemporalMergePointsNode>;
+	// Merges all point clouds in host memory.
 	void setParameters(const std::vector<rgl_field_t>& fields);
+	// Merges recent point clouds in a device ring buffer holding up to maxPointCount points.
+	// If timeWindow is positive, point clouds older than timeWindow seconds (in the scene time) are evicted as well.
+	void setParameters(const std::vector<rgl_field_t>& fields, std::size_t maxPointCount, double timeWindow);
+	// Keeps merged points in unified memory, so that they may exceed device memory; drops already merged points.
+	void setManagedMemory(bool enabled);
 
 	// Node
 	void validateImpl() override;
@@ -356,17 +984,42 @@ struct TemporalMergePointsNode : IPointsNodeSingleInput
 	}
 
 private:
+	// Merged point cloud stored in the ring buffer ([offset, offset + count) of ringData arrays).
+	struct RingFrame
+	{
+		std::size_t offset;
+		std::size_t count;
+		std::optional<Time> time;
+	};
+
+	bool isRingMode() const { return maxPointCount > 0; }
+	void enqueueRingMerge();
+	void mergeToRing(std::size_t pointCount);
+	IAnyArray::Ptr createMergeArray(rgl_field_t field, bool isOnDevice);
+	void prefetchToDevice(const IAnyArray::Ptr& array, std::size_t offset, std::size_t count);
+
 	std::unordered_map<rgl_field_t, IAnyArray::Ptr> mergedData;
 	std::size_t width = 0;
+	bool isManagedMemory = false;
+
+	// Ring buffer mode
+	std::size_t maxPointCount = 0;
+	double timeWindow = 0.0;
+	std::unordered_map<rgl_field_t, IAnyArray::Ptr> ringData;
+	std::deque<RingFrame> ringFrames;
+	std::size_t ringHead = 0;
 };
 
 struct FromArrayPointsNode : IPointsNode, INoInputNode
 {
 	using Ptr = std::shared_ptr<FromArrayPointsNode>;
-	void setParameters(const void* points, size_t pointCount, const std::vector<rgl_field_t>& fields);
+	// Points in device-accessible memory (device, managed or page-locked host) are not copied: they are read in each run,
+	// directly by the kernel splitting them into fields, so the client must keep them valid as long as the node is used.
+	void setParameters(const void* points, size_t pointCount, const std::vector<rgl_field_t>& fields,
+	                   bool isDeviceAccessible = false);
 
 	// Node
-	void enqueueExecImpl() override {}
+	void enqueueExecImpl() override;
 
 	// Point cloud description
 	bool isDense() const override
@@ -385,11 +1038,13 @@ struct FromArrayPointsNode : IPointsNode, INoInputNode
 	}
 
 private:
-	GPUFieldDescBuilder gpuFieldDescBuilder;
+	GPUFieldDescBuilder gpuFieldDescBuilder{arrayMgr};
 	std::vector<std::pair<rgl_field_t, void*>> getFieldToPointerMappings(const std::vector<rgl_field_t>& fields);
 
 	std::unordered_map<rgl_field_t, IAnyArray::Ptr> fieldData;
 	size_t width = 0;
+	const char* devicePoints = nullptr; // Read in place, in each run
+	std::vector<rgl_field_t> devicePointsFields;
 };
 
 struct GaussianNoiseAngularRaysNode : IRaysNodeSingleInput
@@ -402,17 +1057,22 @@ struct GaussianNoiseAngularRaysNode : IRaysNodeSingleInput
 	void enqueueExecImpl() override;
 
 	// Data getters
-	Array<Mat3x4f>::ConstPtr getRays() const override { return rays; }
+	Array<Mat3x4f>::ConstPtr getRays() const override
+	{
+		return input->getRayDirections().has_value() ? input->getRays() : rays;
+	}
+	std::optional<Array<Vec3f>::ConstPtr> getRayDirections() const override
+	{
+		return input->getRayDirections().has_value() ? std::make_optional(directions) : std::nullopt;
+	}
 
 private:
 	float mean;
 	float stDev;
 	rgl_axis_t rotationAxis;
-	std::random_device randomDevice;
 
-	DeviceAsyncArray<curandStatePhilox4_32_10_t>::Ptr randomizationStates =
-	    DeviceAsyncArray<curandStatePhilox4_32_10_t>::create(arrayMgr);
 	DeviceAsyncArray<Mat3x4f>::Ptr rays = DeviceAsyncArray<Mat3x4f>::create(arrayMgr);
+	DeviceAsyncArray<Vec3f>::Ptr directions = DeviceAsyncArray<Vec3f>::create(arrayMgr);
 };
 
 struct GaussianNoiseAngularHitpointNode : IPointsNodeSingleInput
@@ -424,23 +1084,27 @@ struct GaussianNoiseAngularHitpointNode : IPointsNodeSingleInput
 	// Node
 	void validateImpl() override;
 	void enqueueExecImpl() override;
+	void releaseIntermediates() override;
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+	std::vector<rgl_field_t> getIntermediateFieldList() const override;
+	std::vector<rgl_field_t> getInPlaceFieldList() const override { return getIntermediateFieldList(); }
 
 	// Data getters
 	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+	IAnyArray::Ptr getOwnedFieldData(rgl_field_t field) override;
 
 private:
 	float mean;
 	float stDev;
 	rgl_axis_t rotationAxis;
-	std::random_device randomDevice;
 
-	DeviceAsyncArray<curandStatePhilox4_32_10_t>::Ptr randomizationStates =
-	    DeviceAsyncArray<curandStatePhilox4_32_10_t>::create(arrayMgr);
 	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr outXyz = DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::create(arrayMgr);
 	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr outDistance = nullptr;
+	// Input's arrays overwritten in the current run instead of the above, see IPointsNode::getInPlaceFieldList()
+	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr inPlaceXyz;
+	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr inPlaceDistance;
 };
 
 struct GaussianNoiseDistanceNode : IPointsNodeSingleInput
@@ -451,24 +1115,72 @@ struct GaussianNoiseDistanceNode : IPointsNodeSingleInput
 
 	// Node
 	void enqueueExecImpl() override;
+	void releaseIntermediates() override
+	{
+		outXyz->release();
+		outDistance->release();
+	}
 
 	// Node requirements
 	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32, DISTANCE_F32}; };
+	std::vector<rgl_field_t> getIntermediateFieldList() const override { return {XYZ_VEC3_F32, DISTANCE_F32}; }
+	std::vector<rgl_field_t> getInPlaceFieldList() const override { return {XYZ_VEC3_F32, DISTANCE_F32}; }
 
 	// Data getters
 	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+	IAnyArray::Ptr getOwnedFieldData(rgl_field_t field) override;
 
 private:
 	float mean;
 	float stDevBase;
 	float stDevRisePerMeter;
-	std::random_device randomDevice;
 
-	DeviceAsyncArray<curandStatePhilox4_32_10_t>::Ptr randomizationStates =
-	    DeviceAsyncArray<curandStatePhilox4_32_10_t>::create(arrayMgr);
 	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr outXyz = DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::create(arrayMgr);
 	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr outDistance = DeviceAsyncArray<Field<DISTANCE_F32>::type>::create(
 	    arrayMgr);
+	// Input's arrays overwritten in the current run instead of the above, see IPointsNode::getInPlaceFieldList()
+	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr inPlaceXyz;
+	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr inPlaceDistance;
+};
+
+struct GaussianNoiseTransformPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<GaussianNoiseTransformPointsNode>;
+
+	void setParameters(float angularMean, float angularStDev, rgl_axis_t angularAxis, float distanceMean,
+	                   float distanceStDevBase, float distanceStDevRisePerMeter, Mat3x4f transform);
+
+	// Node
+	void validateImpl() override;
+	void enqueueExecImpl() override;
+	void releaseIntermediates() override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+	std::vector<rgl_field_t> getIntermediateFieldList() const override;
+	std::vector<rgl_field_t> getInPlaceFieldList() const override { return getIntermediateFieldList(); }
+
+	// Point cloud description
+	Mat3x4f getLookAtOriginTransform() const override { return transform.inverse() * input->getLookAtOriginTransform(); }
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+	IAnyArray::Ptr getOwnedFieldData(rgl_field_t field) override;
+
+private:
+	float angularMean;
+	float angularStDev;
+	rgl_axis_t angularAxis;
+	float distanceMean;
+	float distanceStDevBase;
+	float distanceStDevRisePerMeter;
+	Mat3x4f transform;
+
+	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr outXyz = DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr outDistance = nullptr;
+	// Input's arrays overwritten in the current run instead of the above, see IPointsNode::getInPlaceFieldList()
+	DeviceAsyncArray<Field<XYZ_VEC3_F32>::type>::Ptr inPlaceXyz;
+	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr inPlaceDistance;
 };
 
 struct RadarPostprocessPointsNode : IPointsNodeSingleInput
@@ -495,23 +1207,26 @@ struct RadarPostprocessPointsNode : IPointsNodeSingleInput
 
 private:
 	// Data containers
-	std::vector<Field<RAY_IDX_U32>::type> filteredIndicesHost;
 	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr filteredIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(
 	    arrayMgr);
-	HostPinnedArray<Field<DISTANCE_F32>::type>::Ptr distanceInputHost = HostPinnedArray<Field<DISTANCE_F32>::type>::create();
-	HostPinnedArray<Field<AZIMUTH_F32>::type>::Ptr azimuthInputHost = HostPinnedArray<Field<AZIMUTH_F32>::type>::create();
-	HostPinnedArray<Field<RADIAL_SPEED_F32>::type>::Ptr radialSpeedInputHost =
-	    HostPinnedArray<Field<RADIAL_SPEED_F32>::type>::create();
-	HostPinnedArray<Field<ELEVATION_F32>::type>::Ptr elevationInputHost = HostPinnedArray<Field<ELEVATION_F32>::type>::create();
 	DeviceAsyncArray<Vector<3, thrust::complex<float>>>::Ptr outBUBRFactorDev =
 	    DeviceAsyncArray<Vector<3, thrust::complex<float>>>::create(arrayMgr);
-	HostPinnedArray<Vector<3, thrust::complex<float>>>::Ptr outBUBRFactorHost =
-	    HostPinnedArray<Vector<3, thrust::complex<float>>>::create();
 
-	HostPageableArray<Field<RCS_F32>::type>::Ptr clusterRcsHost = HostPageableArray<Field<RCS_F32>::type>::create();
-	HostPageableArray<Field<POWER_F32>::type>::Ptr clusterPowerHost = HostPageableArray<Field<POWER_F32>::type>::create();
-	HostPageableArray<Field<NOISE_F32>::type>::Ptr clusterNoiseHost = HostPageableArray<Field<NOISE_F32>::type>::create();
-	HostPageableArray<Field<SNR_F32>::type>::Ptr clusterSnrHost = HostPageableArray<Field<SNR_F32>::type>::create();
+	// Clustering
+	DeviceAsyncArray<rgl_radar_scope_t>::Ptr radarScopesDev = DeviceAsyncArray<rgl_radar_scope_t>::create(arrayMgr);
+	DeviceAsyncArray<int32_t>::Ptr scopeIndices = DeviceAsyncArray<int32_t>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr clusterParents = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<int32_t>::Ptr isClusterRoot = DeviceAsyncArray<int32_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr clusterRoots = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr clusterIdOfRoot = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr clusterCount = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	HostPinnedArray<uint32_t>::Ptr clusterCountHost = HostPinnedArray<uint32_t>::create();
+	DeviceAsyncArray<uint64_t>::Ptr keys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr sortedKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr indices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr sortedIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr tempStorage = DeviceAsyncArray<char>::create(arrayMgr);
 
 	DeviceAsyncArray<Field<RCS_F32>::type>::Ptr clusterRcsDev = DeviceAsyncArray<Field<RCS_F32>::type>::create(arrayMgr);
 	DeviceAsyncArray<Field<POWER_F32>::type>::Ptr clusterPowerDev = DeviceAsyncArray<Field<POWER_F32>::type>::create(arrayMgr);
@@ -528,31 +1243,259 @@ private:
 
 	std::vector<rgl_radar_scope_t> radarScopes;
 
-	std::random_device randomDevice;
-
 	// RGL related members
 	std::mutex getFieldDataMutex;
 	mutable CacheManager<rgl_field_t, IAnyArray::Ptr> cacheManager;
+};
+
+/**
+ * Simulates the signal of an FMCW radar from hit points and processes it into the range-Doppler map with CFAR detections.
+ * The 2D FFT is done by cuFFT, with the plan created for the current signal size.
+ */
+struct RadarRangeDopplerPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<RadarRangeDopplerPointsNode>;
+	void setParameters(const rgl_radar_fmcw_config_t& config, float rayAzimuthStepRad, float rayElevationStepRad);
+	~RadarRangeDopplerPointsNode() override;
 
-	struct RadarCluster
+	// Node
+	void enqueueExecImpl() override;
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override
 	{
-		RadarCluster(Field<RAY_IDX_U32>::type index, float distance, float azimuth, float radialSpeed, float elevation);
-		RadarCluster(RadarCluster&& other) noexcept = default;
-		RadarCluster& operator=(RadarCluster&& other) noexcept = default;
+		return {DISTANCE_F32, RADIAL_SPEED_F32, RAY_POSE_MAT3x4_F32, NORMAL_VEC3_F32, XYZ_VEC3_F32};
+	}
 
-		void addPoint(Field<RAY_IDX_U32>::type index, float distance, float azimuth, float radialSpeed, float elevation);
-		inline bool isCandidate(float distance, float azimuth, float radialSpeed, const rgl_radar_scope_t& separations) const;
-		inline bool canMergeWith(const RadarCluster& other, const std::vector<rgl_radar_scope_t>& radarScopes) const;
-		void takeIndicesFrom(RadarCluster&& other);
-		Field<RAY_IDX_U32>::type findDirectionalCenterIndex(const Field<AZIMUTH_F32>::type* azimuths,
-		                                                    const Field<ELEVATION_F32>::type* elevations) const;
+	// Point cloud description
+	bool isDense() const override { return false; }
+	bool hasField(rgl_field_t field) const override;
+	size_t getWidth() const override { return config.samples_per_chirp; }
+	size_t getHeight() const override { return config.chirp_count; }
 
-		std::vector<Field<RAY_IDX_U32>::type> indices;
-		Vector<2, Field<DISTANCE_F32>::type> minMaxDistance;
-		Vector<2, Field<AZIMUTH_F32>::type> minMaxAzimuth;
-		Vector<2, Field<RADIAL_SPEED_F32>::type> minMaxRadialSpeed;
-		Vector<2, Field<ELEVATION_F32>::type> minMaxElevation; // For finding directional center only
-	};
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
+private:
+	rgl_radar_fmcw_config_t config;
+	float rayAzimuthStepRad;
+	float rayElevationStepRad;
+
+	cufftHandle fftPlan{};
+	std::pair<int32_t, int32_t> fftPlanSize{0, 0}; // (chirps, samples) of the created plan, zeros if none
+
+	DeviceAsyncArray<Vector<3, thrust::complex<float>>>::Ptr bubrFactors =
+	    DeviceAsyncArray<Vector<3, thrust::complex<float>>>::create(arrayMgr);
+	DeviceAsyncArray<RadarEcho>::Ptr echoes = DeviceAsyncArray<RadarEcho>::create(arrayMgr);
+	DeviceAsyncArray<thrust::complex<float>>::Ptr signal = DeviceAsyncArray<thrust::complex<float>>::create(arrayMgr);
+
+	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr outDistance = DeviceAsyncArray<Field<DISTANCE_F32>::type>::create(
+	    arrayMgr);
+	DeviceAsyncArray<Field<RADIAL_SPEED_F32>::type>::Ptr outRadialSpeed =
+	    DeviceAsyncArray<Field<RADIAL_SPEED_F32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<POWER_F32>::type>::Ptr outPower = DeviceAsyncArray<Field<POWER_F32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<NOISE_F32>::type>::Ptr outNoise = DeviceAsyncArray<Field<NOISE_F32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<SNR_F32>::type>::Ptr outSnr = DeviceAsyncArray<Field<SNR_F32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<IS_HIT_I32>::type>::Ptr outIsDetection = DeviceAsyncArray<Field<IS_HIT_I32>::type>::create(arrayMgr);
+};
+
+struct FilterGroundPlanePointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<FilterGroundPlanePointsNode>;
+	void setParameters(const Vec3f& sensorUpVector, float groundAngleThreshold, float groundDistanceThreshold,
+	                   float groundFilterDistance, int32_t maxIterations);
+
+	// Node
+	void enqueueExecImpl() override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; };
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
+private:
+	Vec3f sensorUpVector;
+	float groundAngleThreshold;
+	float groundDistanceThreshold;
+	float groundFilterDistance;
+	int32_t maxIterations;
+	DeviceAsyncArray<Vec4f>::Ptr hypothesisPlanes = DeviceAsyncArray<Vec4f>::create(arrayMgr);
+	DeviceAsyncArray<int32_t>::Ptr hypothesisInlierCounts = DeviceAsyncArray<int32_t>::create(arrayMgr);
+	DeviceAsyncArray<Vec4f>::Ptr groundPlane = DeviceAsyncArray<Vec4f>::create(arrayMgr);
+	DeviceAsyncArray<int32_t>::Ptr groundPlaneInlierCount = DeviceAsyncArray<int32_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<IS_GROUND_I32>::type>::Ptr outNonGround = DeviceAsyncArray<Field<IS_GROUND_I32>::type>::create(
+	    arrayMgr);
+};
+
+/**
+ * Projects hit points onto a dense image with rows given by RING_ID_U16 and columns by AZIMUTH_F32.
+ * Each pixel holds channels of the nearest point; IS_HIT_I32 tells whether any point fell into the pixel.
+ */
+struct RangeImagePointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<RangeImagePointsNode>;
+	void setParameters(int32_t height, int32_t width, float azimuthMin, float azimuthMax);
+
+	// Node
+	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
+	bool acceptsDevicePointCount() const override { return true; }
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override
+	{
+		return {IS_HIT_I32, RING_ID_U16, AZIMUTH_F32, DISTANCE_F32};
+	}
+
+	// Point cloud description
+	bool isDense() const override { return false; }
+	bool hasField(rgl_field_t field) const override;
+	size_t getWidth() const override { return width; }
+	size_t getHeight() const override { return height; }
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
+private:
+	int32_t height;
+	int32_t width;
+	float azimuthMin;
+	float azimuthMax;
+	DeviceAsyncArray<uint64_t>::Ptr pixelKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<IS_HIT_I32>::type>::Ptr outIsHit = DeviceAsyncArray<Field<IS_HIT_I32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<DISTANCE_F32>::type>::Ptr outDistance = DeviceAsyncArray<Field<DISTANCE_F32>::type>::create(
+	    arrayMgr);
+	DeviceAsyncArray<Field<INTENSITY_F32>::type>::Ptr outIntensity = DeviceAsyncArray<Field<INTENSITY_F32>::type>::create(
+	    arrayMgr);
+	DeviceAsyncArray<Field<ENTITY_ID_I32>::type>::Ptr outEntityId = DeviceAsyncArray<Field<ENTITY_ID_I32>::type>::create(
+	    arrayMgr);
+};
+
+/**
+ * Bins hit points into a dense grid of cells counting hits and their height range, optionally casting rays to count misses.
+ * Cells are kept in device memory and may be accumulated over runs; they are provided as RGL_FIELD_DYNAMIC_FORMAT.
+ */
+struct OccupancyGridPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<OccupancyGridPointsNode>;
+	void setParameters(const Vec3f& gridMin, const Vec3f& cellSize, const Vec3i& gridSize, bool accumulate);
+	void setRayCasting(bool enable, const Vec3f& origin);
+
+	// Node
+	void enqueueExecImpl() override;
+	bool acceptsDevicePointCount() const override { return true; }
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+	// Point cloud description
+	bool isDense() const override { return false; }
+	bool hasField(rgl_field_t field) const override { return field == RGL_FIELD_DYNAMIC_FORMAT; }
+	size_t getWidth() const override { return gridSize.x(); }
+	size_t getHeight() const override { return static_cast<size_t>(gridSize.y()) * gridSize.z(); }
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+	std::size_t getFieldPointSize(rgl_field_t field) const override;
+
+private:
+	Vec3f gridMin{0.0f};
+	Vec3f cellSize{1.0f};
+	Vec3i gridSize{0};
+	bool accumulate{false};
+	bool isClearNeeded{true};
+	bool isRayCastingEnabled{false};
+	Vec3f rayOrigin{0.0f};
+	DeviceAsyncArray<rgl_occupancy_cell_t>::Ptr cells = DeviceAsyncArray<rgl_occupancy_cell_t>::create(arrayMgr);
+};
+
+/**
+ * Reorders points by a scalar field (e.g. into the firing order by TIME_STAMP_F64 or AZIMUTH_F32) with a stable radix sort.
+ * Fields are gathered in the sorted order from the selection source only when requested, see IPointsSelection.
+ */
+struct SortPointsNode : IPointsNodeSingleInput, IPointsSelection
+{
+	using Ptr = std::shared_ptr<SortPointsNode>;
+	void setParameters(rgl_field_t keyField, bool descending);
+
+	// Node
+	void validateImpl() override;
+	void enqueueExecImpl() override;
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {keyField}; }
+
+	// Point cloud description
+	size_t getWidth() const override { return width; }
+	size_t getHeight() const override { return 1; }
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
+	// Selection
+	IPointsNode::Ptr getSelectionSource() const override { return selectionSource; }
+	const Field<RAY_IDX_U32>::type* getSelectionIndicesPtr() const override { return selectionIndices->getReadPtr(); }
+
+private:
+	rgl_field_t keyField;
+	bool descending;
+	size_t width = {0};
+	DeviceAsyncArray<uint64_t>::Ptr sortKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr sortedKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr pointIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr tempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+	IPointsNode::Ptr selectionSource;
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr selectionIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	CacheManager<rgl_field_t, IAnyArray::Ptr> cacheManager;
+	std::mutex getFieldDataMutex;
+};
+
+struct VoxelDownsamplePointsNode : IPointsNodeSingleInput, IPointsSelection
+{
+	using Ptr = std::shared_ptr<VoxelDownsamplePointsNode>;
+	void setParameters(const Vec3f& leafDims) { this->leafDims = leafDims; }
+
+	// Node
+	void validateImpl() override;
+	void enqueueExecImpl() override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+	// Point cloud description
+	size_t getWidth() const override;
+	size_t getHeight() const override { return 1; }
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
+	// Selection
+	IPointsNode::Ptr getSelectionSource() const override { return selectionSource; }
+	const Field<RAY_IDX_U32>::type* getSelectionIndicesPtr() const override { return selectionIndices->getReadPtr(); }
+
+private:
+	Vec3f leafDims;
+	size_t width = {0};
+	DeviceAsyncArray<uint64_t>::Ptr voxelKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr sortedVoxelKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr pointIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr sortedPointIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<int32_t>::Ptr isFirstInVoxel = DeviceAsyncArray<int32_t>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr tempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr voxelCount = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	HostPinnedArray<uint32_t>::Ptr voxelCountHost = HostPinnedArray<uint32_t>::create();
+	IPointsNode::Ptr selectionSource;
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr selectionIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	CacheManager<rgl_field_t, IAnyArray::Ptr> cacheManager;
+	std::mutex getFieldDataMutex;
 };
 
 struct FilterGroundPointsNode : IPointsNodeSingleInput
@@ -576,3 +1519,158 @@ private:
 	DeviceAsyncArray<Field<IS_GROUND_I32>::type>::Ptr outNonGround = DeviceAsyncArray<Field<IS_GROUND_I32>::type>::create(
 	    arrayMgr);
 };
+
+/**
+ * Estimates normals (NORMAL_VEC3_F32, replacing the input ones) and curvature (CURVATURE_F32) of points
+ * with PCA of their neighbourhoods, oriented towards the sensor. Neighbours are found in the row/column window
+ * of organized point clouds (rings x azimuths) or in a spatial hash grid with cells of the search radius otherwise.
+ */
+struct EstimateNormalsPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<EstimateNormalsPointsNode>;
+	void setParameters(float radius) { this->radius = radius; }
+
+	// Node
+	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+	// Data getters
+	bool hasField(rgl_field_t field) const override
+	{
+		return field == NORMAL_VEC3_F32 || field == CURVATURE_F32 || input->hasField(field);
+	}
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
+private:
+	// Half-size of the neighbourhood window (in rows and columns) of organized point clouds.
+	static constexpr int32_t ORGANIZED_WINDOW_RADIUS = 2;
+
+	float radius;
+	DeviceAsyncArray<uint64_t>::Ptr cellKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr sortedCellKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr pointIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr sortedPointIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr tempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+	DeviceAsyncArray<Field<NORMAL_VEC3_F32>::type>::Ptr outNormals = DeviceAsyncArray<Field<NORMAL_VEC3_F32>::type>::create(
+	    arrayMgr);
+	DeviceAsyncArray<Field<CURVATURE_F32>::type>::Ptr outCurvatures = DeviceAsyncArray<Field<CURVATURE_F32>::type>::create(
+	    arrayMgr);
+};
+
+/**
+ * Segments points into clusters (CLUSTER_ID_I32) of points linked within the tolerance, like PCL's Euclidean clustering.
+ * Connected components are found on the GPU with union-find over a spatial hash grid with cells of the tolerance size.
+ */
+struct EuclideanClusterPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<EuclideanClusterPointsNode>;
+	void setParameters(float tolerance, int32_t minClusterSize, int32_t maxClusterSize);
+
+	// Node
+	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+	// Data getters
+	bool hasField(rgl_field_t field) const override { return field == CLUSTER_ID_I32 || input->hasField(field); }
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+
+private:
+	float tolerance;
+	int32_t minClusterSize;
+	int32_t maxClusterSize;
+	DeviceAsyncArray<uint32_t>::Ptr clusterParents = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr clusterSizes = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<int32_t>::Ptr isClusterRoot = DeviceAsyncArray<int32_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr clusterRoots = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<uint32_t>::Ptr clusterCount = DeviceAsyncArray<uint32_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<CLUSTER_ID_I32>::type>::Ptr clusterIdOfRoot = DeviceAsyncArray<Field<CLUSTER_ID_I32>::type>::create(
+	    arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr cellKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr sortedCellKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr pointIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr sortedPointIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr tempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+	DeviceAsyncArray<Field<CLUSTER_ID_I32>::type>::Ptr outClusterIds = DeviceAsyncArray<Field<CLUSTER_ID_I32>::type>::create(
+	    arrayMgr);
+};
+
+/**
+ * Computes axis-aligned bounding boxes (rgl_cluster_box_t) of clusters given by CLUSTER_ID_I32, one per cluster id.
+ * The number of boxes is synchronized to the host, so the node is not capturable.
+ */
+struct ClusterBoxesPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<ClusterBoxesPointsNode>;
+	void setParameters() {}
+
+	// Node
+	void enqueueExecImpl() override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32, CLUSTER_ID_I32}; }
+
+	// Point cloud description
+	bool isDense() const override { return true; }
+	bool hasField(rgl_field_t field) const override { return field == RGL_FIELD_DYNAMIC_FORMAT; }
+	size_t getWidth() const override { return boxes->getCount(); }
+	size_t getHeight() const override { return 1; }
+
+	// Data getters
+	IAnyArray::ConstPtr getFieldData(rgl_field_t field) override;
+	std::size_t getFieldPointSize(rgl_field_t field) const override;
+
+private:
+	DeviceAsyncArray<int32_t>::Ptr maxClusterId = DeviceAsyncArray<int32_t>::create(arrayMgr);
+	HostPinnedArray<int32_t>::Ptr maxClusterIdHost = HostPinnedArray<int32_t>::create();
+	DeviceAsyncArray<rgl_cluster_box_t>::Ptr boxes = DeviceAsyncArray<rgl_cluster_box_t>::create(arrayMgr);
+};
+
+/**
+ * Builds a spatial index (hash grid of sorted cell keys) over XYZ_VEC3_F32 of points, passing the point cloud through.
+ * Once the graph is run, nearest and radius queries of many points are answered in parallel on the GPU.
+ */
+struct SpatialIndexPointsNode : IPointsNodeSingleInput
+{
+	using Ptr = std::shared_ptr<SpatialIndexPointsNode>;
+	void setParameters(float cellSize) { this->cellSize = cellSize; }
+
+	// Node
+	void enqueueExecImpl() override;
+	bool isCudaGraphCapturable() const override { return true; }
+	std::string getArgsString() const override;
+
+	// Node requirements
+	std::vector<rgl_field_t> getRequiredFieldList() const override { return {XYZ_VEC3_F32}; }
+
+	// Queries (of the last run, results must be ready); indices are of points in the output point cloud.
+	void queryNearest(const Vec3f* queries, size_t queryCount, float maxDistance, int32_t* outIndices, float* outDistances);
+	void queryRadius(const Vec3f* queries, size_t queryCount, float radius, int32_t maxNeighbourCount, int32_t* outIndices,
+	                 int32_t* outCounts);
+
+private:
+	const Field<IS_HIT_I32>::type* getIsHitPtr() const;
+
+	float cellSize;
+	DeviceAsyncArray<uint64_t>::Ptr cellKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<uint64_t>::Ptr sortedCellKeys = DeviceAsyncArray<uint64_t>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr pointIndices = DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<Field<RAY_IDX_U32>::type>::Ptr sortedPointIndices =
+	    DeviceAsyncArray<Field<RAY_IDX_U32>::type>::create(arrayMgr);
+	DeviceAsyncArray<char>::Ptr tempStorage = DeviceAsyncArray<char>::create(arrayMgr);
+
+	// Queries are issued by client's threads in the copy stream, after the node's stream is synchronized.
+	DeviceSyncArray<Vec3f>::Ptr queriesDev = DeviceSyncArray<Vec3f>::create();
+	DeviceSyncArray<int32_t>::Ptr resultIndicesDev = DeviceSyncArray<int32_t>::create();
+	DeviceSyncArray<float>::Ptr resultDistancesDev = DeviceSyncArray<float>::create();
+	DeviceSyncArray<int32_t>::Ptr resultCountsDev = DeviceSyncArray<int32_t>::create();
+};
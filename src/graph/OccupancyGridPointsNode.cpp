@@ -0,0 +1,78 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+
+#include <algorithm>
+
+void OccupancyGridPointsNode::setParameters(const Vec3f& gridMin, const Vec3f& cellSize, const Vec3i& gridSize, bool accumulate)
+{
+	// Re-setting the same grid (e.g. along with the ray origin) keeps accumulated cells.
+	bool isGridChanged = !std::ranges::equal(gridMin, this->gridMin) || !std::ranges::equal(cellSize, this->cellSize) ||
+	                     !std::ranges::equal(gridSize, this->gridSize) || accumulate != this->accumulate;
+	isClearNeeded = isClearNeeded || isGridChanged;
+	this->gridMin = gridMin;
+	this->cellSize = cellSize;
+	this->gridSize = gridSize;
+	this->accumulate = accumulate;
+}
+
+void OccupancyGridPointsNode::setRayCasting(bool enable, const Vec3f& origin)
+{
+	isRayCastingEnabled = enable;
+	rayOrigin = origin;
+}
+
+void OccupancyGridPointsNode::enqueueExecImpl()
+{
+	auto cellCount = getPointCount();
+	if (isClearNeeded || !accumulate) {
+		cells->resize(cellCount, false, false);
+		gpuClearOccupancyGrid(getStreamHandle(), cellCount, cells->getWritePtr());
+		isClearNeeded = false;
+	}
+
+	const uint32_t* devicePointCount = input->getPointCountDevicePtr();
+	auto pointCount = devicePointCount != nullptr ? input->getPointCountUpperBound() : input->getPointCount();
+	const Field<IS_HIT_I32>::type* isHit = nullptr;
+	if (input->hasField(IS_HIT_I32)) {
+		isHit = input->getFieldDataTyped<IS_HIT_I32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	}
+	gpuAccumulateOccupancyGrid(getStreamHandle(), pointCount, devicePointCount,
+	                           input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr(), isHit,
+	                           gridMin, cellSize, gridSize, isRayCastingEnabled, rayOrigin, cells->getWritePtr());
+}
+
+IAnyArray::ConstPtr OccupancyGridPointsNode::getFieldData(rgl_field_t field)
+{
+	if (!hasField(field)) {
+		throw InvalidPipeline(fmt::format("{} does not provide {}", getName(), toString(field)));
+	}
+	return cells;
+}
+
+std::size_t OccupancyGridPointsNode::getFieldPointSize(rgl_field_t field) const
+{
+	if (field == RGL_FIELD_DYNAMIC_FORMAT) {
+		return sizeof(rgl_occupancy_cell_t);
+	}
+	return getFieldSize(field);
+}
+
+std::string OccupancyGridPointsNode::getArgsString() const
+{
+	return fmt::format("{}x{}x{} cells of {} from {}, accumulate={}, rayCasting={}", gridSize.x(), gridSize.y(), gridSize.z(),
+	                   cellSize, gridMin, accumulate, isRayCastingEnabled);
+}
@@ -13,23 +13,11 @@
 // limitations under the License.
 
 #include <algorithm>
-#include <numbers>
 
 #include <repr.hpp>
 #include <graph/NodesCore.hpp>
 #include <gpu/nodeKernels.hpp>
 
-inline static std::optional<rgl_radar_scope_t> getRadarScopeWithinDistance(const std::vector<rgl_radar_scope_t>& radarScopes,
-                                                                           Field<DISTANCE_F32>::type distance)
-{
-	for (auto&& scope : radarScopes) {
-		if (scope.begin_distance <= distance && distance <= scope.end_distance) {
-			return scope;
-		}
-	}
-	return std::nullopt;
-}
-
 void RadarPostprocessPointsNode::setParameters(const std::vector<rgl_radar_scope_t>& radarScopes, float rayAzimuthStepRad,
                                                float rayElevationStepRad, float frequency, float powerTransmitted,
                                                float cumulativeDeviceGain, float receivedNoiseMean, float receivedNoiseStDev)
@@ -62,128 +50,83 @@ void RadarPostprocessPointsNode::enqueueExecImpl()
 {
 	cacheManager.trigger();
 
+	auto pointCount = input->getPointCount();
 	auto raysPtr = input->getFieldDataTyped<RAY_POSE_MAT3x4_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
 	auto distancePtr = input->getFieldDataTyped<DISTANCE_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
 	auto normalPtr = input->getFieldDataTyped<NORMAL_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
 	auto xyzPtr = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
-	outBUBRFactorDev->resize(input->getPointCount(), false, false);
-	gpuRadarComputeEnergy(getStreamHandle(), input->getPointCount(), rayAzimuthStepRad, rayElevationStepRad, frequencyHz,
+	outBUBRFactorDev->resize(pointCount, false, false);
+	gpuRadarComputeEnergy(getStreamHandle(), pointCount, rayAzimuthStepRad, rayElevationStepRad, frequencyHz,
 	                      input->getLookAtOriginTransform(), raysPtr, distancePtr, normalPtr, xyzPtr,
 	                      outBUBRFactorDev->getWritePtr());
-	outBUBRFactorHost->copyFrom(outBUBRFactorDev);
-	CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
 
-	if (input->getPointCount() == 0) {
+	if (pointCount == 0) {
 		filteredIndices->resize(0, false, false);
 		return;
 	}
 
-	distanceInputHost->copyFrom(input->getFieldData(DISTANCE_F32));
-	azimuthInputHost->copyFrom(input->getFieldData(AZIMUTH_F32));
-	radialSpeedInputHost->copyFrom(input->getFieldData(RADIAL_SPEED_F32));
-	elevationInputHost->copyFrom(input->getFieldData(ELEVATION_F32));
-
-	std::vector<RadarCluster> clusters;
-	for (int i = 0; i < input->getPointCount(); ++i) {
-		const auto distance = distanceInputHost->at(i);
-		const auto azimuth = azimuthInputHost->at(i);
-		const auto radialSpeed = radialSpeedInputHost->at(i);
-		const auto elevation = elevationInputHost->at(i);
-		bool isPointClustered = false;
-		const auto radarScope = getRadarScopeWithinDistance(radarScopes, distance);
-		if (!radarScope.has_value()) {
-			continue;
-		}
-		for (auto&& cluster : clusters) {
-			if (cluster.isCandidate(distance, azimuth, radialSpeed, radarScope.value())) {
-				cluster.addPoint(i, distance, azimuth, radialSpeed, elevation);
-				isPointClustered = true;
-				break;
-			}
-		}
-
-		if (!isPointClustered) {
-			// Create a new cluster
-			clusters.emplace_back(i, distance, azimuth, radialSpeed, elevation);
-		}
-	}
-
-	// Merge clusters if are close enough
-	bool allClustersGood = false;
-	while (clusters.size() > 1 && !allClustersGood) {
-		allClustersGood = true;
-		for (int i = 0; i < clusters.size(); ++i) {
-			for (int j = i + 1; j < clusters.size(); ++j) {
-				if (clusters[i].canMergeWith(clusters[j], radarScopes)) {
-					clusters[i].takeIndicesFrom(std::move(clusters[j]));
-					clusters.erase(clusters.begin() + j);
-					allClustersGood = false;
-					break;
-				}
-			}
-			if (!allClustersGood) {
-				break;
-			}
-		}
-	}
-
-	filteredIndicesHost.clear();
-	for (auto&& cluster : clusters) {
-		filteredIndicesHost.push_back(
-		    cluster.findDirectionalCenterIndex(azimuthInputHost->getReadPtr(), elevationInputHost->getReadPtr()));
-	}
-
-	filteredIndices->copyFromExternal(filteredIndicesHost.data(), filteredIndicesHost.size());
+	auto azimuthPtr = input->getFieldDataTyped<AZIMUTH_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	auto elevationPtr = input->getFieldDataTyped<ELEVATION_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	auto radialSpeedPtr = input->getFieldDataTyped<RADIAL_SPEED_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+
+	radarScopesDev->copyFromExternal(radarScopes.data(), radarScopes.size());
+	scopeIndices->resize(pointCount, false, false);
+	clusterParents->resize(pointCount, false, false);
+	isClusterRoot->resize(pointCount, false, false);
+	clusterRoots->resize(pointCount, false, false);
+	clusterIdOfRoot->resize(pointCount, false, false);
+	clusterCount->resize(1, false, false);
+	clusterCountHost->resize(1, false, false);
+	keys->resize(pointCount, false, false);
+	sortedKeys->resize(pointCount, false, false);
+	indices->resize(pointCount, false, false);
+	sortedIndices->resize(pointCount, false, false);
+	tempStorage->resize(std::max(gpuSortVoxelKeysTempStorageSize(pointCount), gpuFindCompactionTempStorageSize(pointCount)),
+	                    false, false);
+
+	// Connected components of points (linked when within separation thresholds) are found on the device.
+	gpuRadarInitClusters(getStreamHandle(), pointCount, distancePtr, azimuthPtr, radialSpeedPtr, radarScopes.size(),
+	                     radarScopesDev->getReadPtr(), scopeIndices->getWritePtr(), clusterParents->getWritePtr(),
+	                     keys->getWritePtr(), indices->getWritePtr());
+	gpuSortVoxelKeys(getStreamHandle(), pointCount, keys->getReadPtr(), sortedKeys->getWritePtr(), indices->getReadPtr(),
+	                 sortedIndices->getWritePtr(), tempStorage->getWritePtr(), tempStorage->getCount());
+	gpuRadarUniteClusters(getStreamHandle(), pointCount, sortedKeys->getReadPtr(), sortedIndices->getReadPtr(), distancePtr,
+	                      azimuthPtr, radialSpeedPtr, radarScopes.size(), radarScopesDev->getReadPtr(),
+	                      scopeIndices->getReadPtr(), clusterParents->getWritePtr());
+	gpuRadarFindClusterRoots(getStreamHandle(), pointCount, scopeIndices->getReadPtr(), clusterParents->getWritePtr(),
+	                         isClusterRoot->getWritePtr());
+	gpuFindCompaction(getStreamHandle(), pointCount, isClusterRoot->getReadPtr(), nullptr, clusterRoots->getWritePtr(),
+	                  clusterCount->getWritePtr(), tempStorage->getWritePtr(), tempStorage->getCount());
+
+	// Group points by clusters for per-cluster reductions.
+	gpuRadarComputeClusterKeys(getStreamHandle(), pointCount, clusterCount->getReadPtr(), clusterRoots->getReadPtr(),
+	                           scopeIndices->getReadPtr(), clusterParents->getReadPtr(), clusterIdOfRoot->getWritePtr(),
+	                           keys->getWritePtr(), indices->getWritePtr());
+	gpuSortVoxelKeys(getStreamHandle(), pointCount, keys->getReadPtr(), sortedKeys->getWritePtr(), indices->getReadPtr(),
+	                 sortedIndices->getWritePtr(), tempStorage->getWritePtr(), tempStorage->getCount());
+
+	// Only the number of clusters is needed on the host, to size the output.
+	CHECK_CUDA(cudaMemcpyAsync(clusterCountHost->getWritePtr(), clusterCount->getReadPtr(), sizeof(uint32_t),
+	                           cudaMemcpyDeviceToHost, getStreamHandle()));
+	CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+	const size_t outClusterCount = clusterCountHost->at(0);
 
 	const auto lambda = 299'792'458.0f / frequencyHz;
 	const auto lambdaSqrtDbsm = 10.0f * log10f(lambda * lambda);
+	const auto powerBaseDbm = powerTransmittedDbm + cumulativeDeviceGainDbi + cumulativeDeviceGainDbi + lambdaSqrtDbsm;
 
 	// Compute per-cluster properties
-	clusterRcsHost->resize(filteredIndicesHost.size(), false, false);
-	clusterPowerHost->resize(filteredIndicesHost.size(), false, false);
-	clusterNoiseHost->resize(filteredIndicesHost.size(), false, false);
-	clusterSnrHost->resize(filteredIndicesHost.size(), false, false);
-	std::normal_distribution<float> gaussianNoise(receivedNoiseMeanDb, receivedNoiseStDevDb);
-	for (int clusterIdx = 0; clusterIdx < clusters.size(); ++clusterIdx) {
-		std::complex<float> AU = 0;
-		std::complex<float> AR = 0;
-		auto&& cluster = clusters[clusterIdx];
-
-		for (const auto pointInCluster : cluster.indices) {
-			std::complex<float> BU = {outBUBRFactorHost->at(pointInCluster)[0].real(),
-			                          outBUBRFactorHost->at(pointInCluster)[0].imag()};
-			std::complex<float> BR = {outBUBRFactorHost->at(pointInCluster)[1].real(),
-			                          outBUBRFactorHost->at(pointInCluster)[1].imag()};
-			std::complex<float> factor = {outBUBRFactorHost->at(pointInCluster)[2].real(),
-			                              outBUBRFactorHost->at(pointInCluster)[2].imag()};
-			AU += BU * factor;
-			AR += BR * factor;
-		}
-
-		// https://en.wikipedia.org/wiki/Radar_cross_section#Formulation
-		const auto rcsDbsm = 10.0f * log10f(4.0f * std::numbers::pi_v<float> * (powf(abs(AU), 2) + powf(abs(AR), 2)));
-
-		// TODO: Handle nans in RCS.
-		if (std::isnan(rcsDbsm)) {
-			throw InvalidPipeline("RCS is NaN");
-		}
-
-		const auto distance = distanceInputHost->at(filteredIndicesHost.at(clusterIdx));
-		const auto multiplier = 10.0f * log10f(powf(4 * std::numbers::pi_v<float>, 3)) + 10.0f * log10f(powf(distance, 4));
-
-		const auto powerReceived = powerTransmittedDbm + cumulativeDeviceGainDbi + cumulativeDeviceGainDbi + rcsDbsm +
-		                           lambdaSqrtDbsm - multiplier;
-
-		clusterRcsHost->at(clusterIdx) = rcsDbsm;
-		clusterNoiseHost->at(clusterIdx) = gaussianNoise(randomDevice);
-		clusterPowerHost->at(clusterIdx) = powerReceived + clusterNoiseHost->at(clusterIdx); // power received + noise
-		clusterSnrHost->at(clusterIdx) = clusterPowerHost->at(clusterIdx) - clusterNoiseHost->at(clusterIdx);
-	}
-
-	clusterPowerDev->copyFrom(clusterPowerHost);
-	clusterRcsDev->copyFrom(clusterRcsHost);
-	clusterNoiseDev->copyFrom(clusterNoiseHost);
-	clusterSnrDev->copyFrom(clusterSnrHost);
+	// TODO: Handle nans in RCS.
+	filteredIndices->resize(outClusterCount, false, false);
+	clusterRcsDev->resize(outClusterCount, false, false);
+	clusterPowerDev->resize(outClusterCount, false, false);
+	clusterNoiseDev->resize(outClusterCount, false, false);
+	clusterSnrDev->resize(outClusterCount, false, false);
+	gpuRadarReduceClusters(getStreamHandle(), outClusterCount, pointCount, sortedKeys->getReadPtr(),
+	                       sortedIndices->getReadPtr(), distancePtr, azimuthPtr, elevationPtr, outBUBRFactorDev->getReadPtr(),
+	                       powerBaseDbm, receivedNoiseMeanDb, receivedNoiseStDevDb, randomSeed, randomFrameIdx++,
+	                       filteredIndices->getWritePtr(), clusterRcsDev->getWritePtr(), clusterPowerDev->getWritePtr(),
+	                       clusterNoiseDev->getWritePtr(), clusterSnrDev->getWritePtr());
 
 	// getFieldData may be called in client's thread from rgl_graph_get_result_data
 	// Doing job there would be:
@@ -237,7 +180,7 @@ IAnyArray::ConstPtr RadarPostprocessPointsNode::getFieldData(rgl_field_t field)
 			throw InvalidPipeline(msg);
 		}
 		const char* inputPtr = static_cast<const char*>(fieldArray->getRawReadPtr());
-		gpuFilter(getStreamHandle(), filteredIndices->getCount(), filteredIndices->getReadPtr(), outPtr, inputPtr,
+		gpuFilter(getStreamHandle(), filteredIndices->getCount(), nullptr, filteredIndices->getReadPtr(), outPtr, inputPtr,
 		          getFieldSize(field));
 		CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
 		cacheManager.setUpdated(field);
@@ -250,114 +193,3 @@ std::vector<rgl_field_t> RadarPostprocessPointsNode::getRequiredFieldList() cons
 {
 	return {DISTANCE_F32, AZIMUTH_F32, ELEVATION_F32, RADIAL_SPEED_F32, RAY_POSE_MAT3x4_F32, NORMAL_VEC3_F32, XYZ_VEC3_F32};
 }
-
-// RadarCluster methods implementation
-
-RadarPostprocessPointsNode::RadarCluster::RadarCluster(Field<RAY_IDX_U32>::type index, float distance, float azimuth,
-                                                       float radialSpeed, float elevation)
-{
-	indices.emplace_back(index);
-	minMaxDistance = {distance, distance};
-	minMaxAzimuth = {azimuth, azimuth};
-	minMaxRadialSpeed = {radialSpeed, radialSpeed};
-	minMaxElevation = {elevation, elevation};
-}
-
-void RadarPostprocessPointsNode::RadarCluster::addPoint(Field<RAY_IDX_U32>::type index, float distance, float azimuth,
-                                                        float radialSpeed, float elevation)
-{
-	indices.emplace_back(index);
-	minMaxDistance[0] = std::min(minMaxDistance[0], distance);
-	minMaxDistance[1] = std::max(minMaxDistance[1], distance);
-	minMaxAzimuth[0] = std::min(minMaxAzimuth[0], azimuth);
-	minMaxAzimuth[1] = std::max(minMaxAzimuth[1], azimuth);
-	minMaxRadialSpeed[0] = std::min(minMaxRadialSpeed[0], radialSpeed);
-	minMaxRadialSpeed[1] = std::max(minMaxRadialSpeed[1], radialSpeed);
-	minMaxElevation[0] = std::min(minMaxElevation[0], elevation);
-	minMaxElevation[1] = std::max(minMaxElevation[1], elevation);
-}
-
-inline bool RadarPostprocessPointsNode::RadarCluster::isCandidate(float distance, float azimuth, float radialSpeed,
-                                                                  const rgl_radar_scope_t& radarScope) const
-{
-	const auto isWithinDistanceLowerBound = distance + radarScope.distance_separation_threshold >= minMaxDistance[0];
-	const auto isWithinDistanceUpperBound = distance - radarScope.distance_separation_threshold <= minMaxDistance[1];
-	const auto isWithinAzimuthLowerBound = azimuth + radarScope.azimuth_separation_threshold >= minMaxAzimuth[0];
-	const auto isWithinAzimuthUpperBound = azimuth - radarScope.azimuth_separation_threshold <= minMaxAzimuth[1];
-	const auto isWithinRadialSpeedLowerBound = radialSpeed + radarScope.radial_speed_separation_threshold >=
-	                                           minMaxRadialSpeed[0];
-	const auto isWithinRadialSpeedUpperBound = radialSpeed - radarScope.radial_speed_separation_threshold <=
-	                                           minMaxRadialSpeed[1];
-	return isWithinDistanceLowerBound && isWithinDistanceUpperBound && isWithinAzimuthLowerBound && isWithinAzimuthUpperBound &&
-	       isWithinRadialSpeedLowerBound && isWithinRadialSpeedUpperBound;
-}
-
-inline bool RadarPostprocessPointsNode::RadarCluster::canMergeWith(const RadarCluster& other,
-                                                                   const std::vector<rgl_radar_scope_t>& radarScopes) const
-{
-	// Helper functions
-	auto doRangesOverlap = [](const Vec2f& a, const Vec2f& b) {
-		return (b[0] <= a[1] && b[1] >= a[0]) || (a[0] <= b[1] && a[1] >= b[0]);
-	};
-	auto areRangesWithinThreshold = [](const Vec2f& a, const Vec2f& b, float threshold) {
-		return std::abs(a[1] - b[0]) <= threshold || std::abs(b[1] - a[0]) <= threshold;
-	};
-
-	// Find distances that will be compared with each other:
-	// |---cluster1---|    |---cluster2---|
-	//                ^    ^
-	const float minDistanceToCompare = std::max(minMaxDistance[0], other.minMaxDistance[0]);
-	const float maxDistanceToCompare = std::min(minMaxDistance[1], other.minMaxDistance[1]);
-	const auto radarScope = getRadarScopeWithinDistance(radarScopes, std::max(minDistanceToCompare, maxDistanceToCompare));
-
-	assert(radarScope.has_value()); // Must have value because it was already checked when creating clusters
-
-	bool isDistanceGood = doRangesOverlap(minMaxDistance, other.minMaxDistance) ||
-	                      areRangesWithinThreshold(minMaxDistance, other.minMaxDistance,
-	                                               radarScope->distance_separation_threshold);
-
-	bool isAzimuthGood = doRangesOverlap(minMaxAzimuth, other.minMaxAzimuth) ||
-	                     areRangesWithinThreshold(minMaxAzimuth, other.minMaxAzimuth, radarScope->azimuth_separation_threshold);
-
-	bool isRadialSpeedGood = doRangesOverlap(minMaxRadialSpeed, other.minMaxRadialSpeed) ||
-	                         areRangesWithinThreshold(minMaxRadialSpeed, other.minMaxRadialSpeed,
-	                                                  radarScope->radial_speed_separation_threshold);
-
-	return isDistanceGood && isAzimuthGood && isRadialSpeedGood;
-}
-
-void RadarPostprocessPointsNode::RadarCluster::takeIndicesFrom(RadarCluster&& other)
-{
-	minMaxDistance[0] = std::min(minMaxDistance[0], other.minMaxDistance[0]);
-	minMaxDistance[1] = std::max(minMaxDistance[1], other.minMaxDistance[1]);
-	minMaxAzimuth[0] = std::min(minMaxAzimuth[0], other.minMaxAzimuth[0]);
-	minMaxAzimuth[1] = std::max(minMaxAzimuth[1], other.minMaxAzimuth[1]);
-	minMaxRadialSpeed[0] = std::min(minMaxRadialSpeed[0], other.minMaxRadialSpeed[0]);
-	minMaxRadialSpeed[1] = std::max(minMaxRadialSpeed[1], other.minMaxRadialSpeed[1]);
-	minMaxElevation[0] = std::min(minMaxElevation[0], other.minMaxElevation[0]);
-	minMaxElevation[1] = std::max(minMaxElevation[1], other.minMaxElevation[1]);
-
-	// Move indices
-	std::size_t n = indices.size();
-	indices.resize(indices.size() + other.indices.size());
-	std::move(other.indices.begin(), other.indices.end(), indices.begin() + n);
-}
-
-Field<RAY_IDX_U32>::type RadarPostprocessPointsNode::RadarCluster::findDirectionalCenterIndex(
-    const Field<AZIMUTH_F32>::type* azimuths, const Field<ELEVATION_F32>::type* elevations) const
-{
-	auto meanAzimuth = (minMaxAzimuth[0] + minMaxAzimuth[1]) / 2.0f;
-	auto meanElevation = (minMaxElevation[0] + minMaxElevation[1]) / 2.0f;
-
-	float minDistance = FLT_MAX;
-	uint32_t minIndex = indices.front();
-
-	for (auto&& i : indices) {
-		float distance = std::abs(azimuths[i] - meanAzimuth) + std::abs(elevations[i] - meanElevation);
-		if (distance < minDistance) {
-			minDistance = distance;
-			minIndex = i;
-		}
-	}
-	return minIndex;
-}
@@ -0,0 +1,140 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <numbers>
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <macros/cufft.hpp>
+#include <macros/handleDestructorException.hpp>
+#include <repr.hpp>
+
+static constexpr float SPEED_OF_LIGHT = 299'792'458.0f;
+
+// Sum of the Hann window, as applied by gpuRadarSynthesizeBeatSignal.
+static double getHannWindowSum(int32_t count)
+{
+	double sum = 0.0;
+	for (int32_t i = 0; i < count; ++i) {
+		sum += 0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * i / (count - 1));
+	}
+	return sum;
+}
+
+void RadarRangeDopplerPointsNode::setParameters(const rgl_radar_fmcw_config_t& config, float rayAzimuthStepRad,
+                                                float rayElevationStepRad)
+{
+	this->config = config;
+	this->rayAzimuthStepRad = rayAzimuthStepRad;
+	this->rayElevationStepRad = rayElevationStepRad;
+}
+
+void RadarRangeDopplerPointsNode::enqueueExecImpl()
+{
+	auto pointCount = input->getPointCount();
+	auto raysPtr = input->getFieldDataTyped<RAY_POSE_MAT3x4_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	auto distancePtr = input->getFieldDataTyped<DISTANCE_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	auto normalPtr = input->getFieldDataTyped<NORMAL_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	auto xyzPtr = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	auto radialSpeedPtr = input->getFieldDataTyped<RADIAL_SPEED_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	bubrFactors->resize(pointCount, false, false);
+	gpuRadarComputeEnergy(getStreamHandle(), pointCount, rayAzimuthStepRad, rayElevationStepRad, config.center_frequency,
+	                      input->getLookAtOriginTransform(), raysPtr, distancePtr, normalPtr, xyzPtr,
+	                      bubrFactors->getWritePtr());
+
+	// The beat signal is the transmitted chirp mixed with the conjugated echo, so that both the beat frequency
+	// (range bins per chirp: 2BR/c) and the phase shift between chirps (2 f_c v T_c / c cycles) grow with the range.
+	// Range migration within the chirps is neglected.
+	const float rangeBinSize = SPEED_OF_LIGHT / (2.0f * config.bandwidth);
+	const float dopplerCyclesPerSpeed = 2.0f * config.center_frequency * config.chirp_duration / SPEED_OF_LIGHT;
+	const float speedBinSize = 1.0f / (dopplerCyclesPerSpeed * static_cast<float>(config.chirp_count));
+	const float maxDistance = rangeBinSize * static_cast<float>(config.samples_per_chirp);
+
+	// Radar equation as in RadarPostprocessPointsNode, for amplitudes (square roots of powers in mW).
+	const float lambda = SPEED_OF_LIGHT / config.center_frequency;
+	const float powerBaseDbm = config.power_transmitted + 2.0f * config.cumulative_device_gain +
+	                           10.0f * log10f(lambda * lambda);
+	const double fourPi = 4.0 * std::numbers::pi;
+	const double powerBaseMw = std::pow(10.0, powerBaseDbm / 10.0);
+	const auto amplitudeBase = static_cast<float>(std::sqrt(powerBaseMw * fourPi / std::pow(fourPi, 3)));
+	const auto noiseAmplitude = static_cast<float>(std::sqrt(std::pow(10.0, config.noise_power / 10.0) / 2.0));
+
+	echoes->resize(pointCount, false, false);
+	gpuRadarComputeEchoes(getStreamHandle(), pointCount, distancePtr, radialSpeedPtr, bubrFactors->getReadPtr(),
+	                      amplitudeBase, 1.0f / rangeBinSize, dopplerCyclesPerSpeed, maxDistance, echoes->getWritePtr());
+
+	const auto cellCount = static_cast<size_t>(config.samples_per_chirp) * config.chirp_count;
+	signal->resize(cellCount, false, false);
+	gpuRadarSynthesizeBeatSignal(getStreamHandle(), pointCount, echoes->getReadPtr(), config.samples_per_chirp,
+	                             config.chirp_count, noiseAmplitude, randomSeed, randomFrameIdx++, signal->getWritePtr());
+
+	// Range and Doppler FFTs are done in place, as a single 2D transform of chirp-major samples.
+	const std::pair<int32_t, int32_t> signalSize{config.chirp_count, config.samples_per_chirp};
+	if (fftPlanSize != signalSize) {
+		if (fftPlanSize.first != 0) {
+			CHECK_CUFFT(cufftDestroy(fftPlan));
+			fftPlanSize = {0, 0};
+		}
+		CHECK_CUFFT(cufftPlan2d(&fftPlan, signalSize.first, signalSize.second, CUFFT_C2C));
+		fftPlanSize = signalSize;
+	}
+	CHECK_CUFFT(cufftSetStream(fftPlan, getStreamHandle()));
+	auto signalPtr = reinterpret_cast<cufftComplex*>(signal->getWritePtr());
+	CHECK_CUFFT(cufftExecC2C(fftPlan, signalPtr, signalPtr, CUFFT_FORWARD));
+
+	// Scaled by the coherent gain of windows, so that the peak power of an echo is its received power.
+	const double windowSum = getHannWindowSum(config.samples_per_chirp) * getHannWindowSum(config.chirp_count);
+	const auto powerScale = static_cast<float>(1.0 / (windowSum * windowSum));
+	const auto thresholdRatio = static_cast<float>(std::pow(10.0, config.cfar_threshold / 10.0));
+	outDistance->resize(cellCount, false, false);
+	outRadialSpeed->resize(cellCount, false, false);
+	outPower->resize(cellCount, false, false);
+	outNoise->resize(cellCount, false, false);
+	outSnr->resize(cellCount, false, false);
+	outIsDetection->resize(cellCount, false, false);
+	gpuRadarRangeDopplerCfar(getStreamHandle(), config.samples_per_chirp, config.chirp_count, signal->getReadPtr(), powerScale,
+	                         rangeBinSize, speedBinSize, config.cfar_guard_cells, config.cfar_training_cells, thresholdRatio,
+	                         outDistance->getWritePtr(), outRadialSpeed->getWritePtr(), outPower->getWritePtr(),
+	                         outNoise->getWritePtr(), outSnr->getWritePtr(), outIsDetection->getWritePtr());
+}
+
+bool RadarRangeDopplerPointsNode::hasField(rgl_field_t field) const
+{
+	return field == DISTANCE_F32 || field == RADIAL_SPEED_F32 || field == POWER_F32 || field == NOISE_F32 ||
+	       field == SNR_F32 || field == IS_HIT_I32;
+}
+
+IAnyArray::ConstPtr RadarRangeDopplerPointsNode::getFieldData(rgl_field_t field)
+{
+	switch (field) {
+		case DISTANCE_F32: return outDistance;
+		case RADIAL_SPEED_F32: return outRadialSpeed;
+		case POWER_F32: return outPower;
+		case NOISE_F32: return outNoise;
+		case SNR_F32: return outSnr;
+		case IS_HIT_I32: return outIsDetection;
+		default: throw InvalidPipeline(fmt::format("{} does not provide {}", getName(), toString(field)));
+	}
+}
+
+std::string RadarRangeDopplerPointsNode::getArgsString() const { return fmt::format("{}", config); }
+
+RadarRangeDopplerPointsNode::~RadarRangeDopplerPointsNode()
+try {
+	if (fftPlanSize.first != 0) {
+		CHECK_CUFFT(cufftDestroy(fftPlan));
+	}
+}
+HANDLE_DESTRUCTOR_EXCEPTION
@@ -0,0 +1,85 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <repr.hpp>
+
+void RangeImagePointsNode::setParameters(int32_t height, int32_t width, float azimuthMin, float azimuthMax)
+{
+	this->height = height;
+	this->width = width;
+	this->azimuthMin = azimuthMin;
+	this->azimuthMax = azimuthMax;
+}
+
+void RangeImagePointsNode::enqueueExecImpl()
+{
+	const uint32_t* devicePointCount = input->getPointCountDevicePtr();
+	auto pointCount = devicePointCount != nullptr ? input->getPointCountUpperBound() : input->getPointCount();
+	auto pixelCount = static_cast<size_t>(height) * width;
+	pixelKeys->resize(pixelCount, false, false);
+	outIsHit->resize(pixelCount, false, false);
+	outDistance->resize(pixelCount, false, false);
+
+	// Optional channels are produced only if the input has them.
+	const Field<INTENSITY_F32>::type* intensities = nullptr;
+	const Field<ENTITY_ID_I32>::type* entityIds = nullptr;
+	if (input->hasField(INTENSITY_F32)) {
+		intensities = input->getFieldDataTyped<INTENSITY_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+		outIntensity->resize(pixelCount, false, false);
+	}
+	if (input->hasField(ENTITY_ID_I32)) {
+		entityIds = input->getFieldDataTyped<ENTITY_ID_I32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+		outEntityId->resize(pixelCount, false, false);
+	}
+
+	gpuMakeRangeImage(getStreamHandle(), pointCount, devicePointCount,
+	                  input->getFieldDataTyped<IS_HIT_I32>()->asSubclass<DeviceAsyncArray>()->getReadPtr(),
+	                  input->getFieldDataTyped<RING_ID_U16>()->asSubclass<DeviceAsyncArray>()->getReadPtr(),
+	                  input->getFieldDataTyped<AZIMUTH_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr(),
+	                  input->getFieldDataTyped<DISTANCE_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr(), intensities,
+	                  entityIds, height, width, azimuthMin, azimuthMax, pixelKeys->getWritePtr(), outIsHit->getWritePtr(),
+	                  outDistance->getWritePtr(), intensities != nullptr ? outIntensity->getWritePtr() : nullptr,
+	                  entityIds != nullptr ? outEntityId->getWritePtr() : nullptr);
+}
+
+bool RangeImagePointsNode::hasField(rgl_field_t field) const
+{
+	if (field == IS_HIT_I32 || field == DISTANCE_F32) {
+		return true;
+	}
+	if (field == INTENSITY_F32 || field == ENTITY_ID_I32) {
+		return input->hasField(field);
+	}
+	return false;
+}
+
+IAnyArray::ConstPtr RangeImagePointsNode::getFieldData(rgl_field_t field)
+{
+	if (!hasField(field)) {
+		throw InvalidPipeline(fmt::format("{} does not provide {}", getName(), toString(field)));
+	}
+	switch (field) {
+		case IS_HIT_I32: return outIsHit;
+		case DISTANCE_F32: return outDistance;
+		case INTENSITY_F32: return outIntensity;
+		default: return outEntityId;
+	}
+}
+
+std::string RangeImagePointsNode::getArgsString() const
+{
+	return fmt::format("{}x{}, azimuth=[{}, {})", height, width, azimuthMin, azimuthMax);
+}
@@ -14,14 +14,28 @@
 
 #include <ranges>
 #include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <tuple>
 
 #include <graph/NodesCore.hpp>
+#include <graph/GraphRunCtx.hpp>
 #include <scene/Scene.hpp>
+#include <scene/Texture.hpp>
 #include <macros/optix.hpp>
+#include <memory/ArrayCopyBatch.hpp>
+#include <gpu/helpersKernels.hpp>
+#include <Optix.hpp>
+#include <PerformanceCounters.hpp>
 #include <RGLFields.hpp>
 
-void RaytraceNode::setParameters()
+void RaytraceNode::setParameters(std::shared_ptr<Scene> scene)
 {
+	this->scene = std::move(scene);
+	culledASVersion.reset();
+	if (cullingRange > 0.0f) {
+		this->scene->enableInstanceBounds();
+	}
 	const static Vec2f defaultRangeValue = Vec2f(0.0f, FLT_MAX);
 	defaultRange->copyFromExternal(&defaultRangeValue, 1);
 }
@@ -30,6 +44,7 @@ void RaytraceNode::validateImpl()
 {
 	// It should be viewed as a temporary solution. Will change in v14.
 	setFields(findFieldsToCompute());
+	fusedFormatFields = isFusedFormatEnabled ? findFusedFormat() : std::vector<rgl_field_t>{};
 
 	raysNode = getExactlyOneInputOfType<IRaysNode>();
 
@@ -38,7 +53,7 @@ void RaytraceNode::validateImpl()
 		throw InvalidPipeline(msg);
 	}
 
-	if (fieldData.contains(TIME_STAMP_F64) && !Scene::instance().getTime().has_value()) {
+	if (fieldData.contains(TIME_STAMP_F64) && !scene->getTime().has_value()) {
 		auto msg = fmt::format("requested for field TIME_STAMP_F64, but RaytraceNode cannot get time from scene");
 		throw InvalidPipeline(msg);
 	}
@@ -47,11 +62,57 @@ void RaytraceNode::validateImpl()
 		auto msg = fmt::format("requested for raytrace with velocity distortion, but RaytraceNode cannot get time offsets");
 		throw InvalidPipeline(msg);
 	}
+
+	if (fieldData.contains(RAY_POSE_MAT3x4_F32) && raysNode->getRayDirections().has_value()) {
+		auto msg = fmt::format("requested for field RAY_POSE_MAT3x4_F32, which is not available for rays given by directions");
+		throw InvalidPipeline(msg);
+	}
+
+	if (isDenseOutput && returnMode != RGL_RETURN_MODE_FIRST) {
+		auto msg = fmt::format("requested for dense output, which is supported in first return mode only");
+		throw InvalidPipeline(msg);
+	}
+
+	if (isDenseOutput && fieldData.contains(RAY_POSE_MAT3x4_F32)) {
+		auto msg = fmt::format("requested for field RAY_POSE_MAT3x4_F32, which is not available with dense output");
+		throw InvalidPipeline(msg);
+	}
+
+	bool isBeamDivergent = beamSampleCount > 1 && beamDivergenceAngle > 0.0f;
+	if (isBeamDivergent && returnMode != RGL_RETURN_MODE_FIRST) {
+		auto msg = fmt::format("requested for raytrace with beam divergence, which is supported in first return mode only");
+		throw InvalidPipeline(msg);
+	}
+
+	if (multipathBounceCount > 0 && returnMode != RGL_RETURN_MODE_FIRST) {
+		auto msg = fmt::format("requested for raytrace with multipath, which is supported in first return mode only");
+		throw InvalidPipeline(msg);
+	}
+
+	if (multipathBounceCount > 0 && isDenseOutput) {
+		auto msg = fmt::format("requested for raytrace with multipath, which is not supported with dense output");
+		throw InvalidPipeline(msg);
+	}
+
+	// Chunks are ranges of columns of the output, which does not hold for reordered or compacted rays.
+	if (isStreamed() && (isDenseOutput || isRaySortingEnabled || isTimeSliced())) {
+		auto msg = fmt::format("requested for raytrace with streaming, "
+		                       "which is not supported with dense output, ray sorting or time slicing");
+		throw InvalidPipeline(msg);
+	}
 }
 
 template<rgl_field_t field>
 auto RaytraceNode::getPtrTo()
 {
+	if (!fusedFormatFields.empty()) {
+		// Pointer to the field of the first formatted point, see RaytraceRequestContext::formattedPointSize.
+		auto it = std::ranges::find(fusedFormatFields, field);
+		std::size_t offset = getPointSize(std::vector<rgl_field_t>(fusedFormatFields.begin(), it));
+		return it != fusedFormatFields.end() ?
+		           reinterpret_cast<typename Field<field>::type*>(fusedFormatData->getWritePtr() + offset) :
+		           nullptr;
+	}
 	return fieldData.contains(field) ? fieldData.at(field)
 	                                       ->asTyped<typename Field<field>::type>()
 	                                       ->template asSubclass<DeviceAsyncArray>()
@@ -61,32 +122,581 @@ auto RaytraceNode::getPtrTo()
 
 void RaytraceNode::enqueueExecImpl()
 {
-	for (auto const& [_, data] : fieldData) {
-		data->resize(raysNode->getRayCount(), false, false);
+	// Ray poses are materialized only if requested, when TransformRaysNode left its transform to raygen
+	// or when there are more returns per ray (each return has the pose of its ray).
+	if (isRayPoseMaterialized()) {
+		const size_t rayCount = raysNode->getRayCount();
+		rayPoses->resize(rayCount * getReturnCount(), false, false);
+		for (unsigned returnIdx = 0; returnIdx < getReturnCount(); ++returnIdx) {
+			gpuTransformRays(getStreamHandle(), rayCount, raysNode->getRays()->asSubclass<DeviceAsyncArray>()->getReadPtr(),
+			                 rayPoses->getWritePtr() + returnIdx * rayCount,
+			                 raysNode->getPendingRayTransform().value_or(Mat3x4f::identity()));
+		}
+	}
+
+	isPointCountDeferred = isDenseOutput && canProvideDevicePointCount();
+	isStreamedLaunchEnqueued = false;
+	if (isStreamed()) {
+		updateStreamedChunks();
+	}
+	const auto& batch = getGraphRunCtx()->getRaytraceBatch();
+	bool isBatched = std::ranges::any_of(batch, [this](const RaytraceNode::Ptr& node) { return node.get() == this; });
+	if (isBatched) {
+		resultCacheKey.reset(); // Batched nodes are always traced, see isResultCacheHit()
+	}
+	if (!isBatched) {
+		enqueueLaunch({this});
+	}
+	else if (batch.front().get() == this) {
+		std::vector<RaytraceNode*> requesters;
+		auto getRawPtr = [](const RaytraceNode::Ptr& node) { return node.get(); };
+		std::ranges::transform(batch, std::back_inserter(requesters), getRawPtr);
+		// Inputs of other requesters may have been executed in other streams.
+		for (auto&& requester : requesters | std::views::drop(1)) {
+			for (auto&& input : requester->getInputs()) {
+				enqueueWaitFor(*input);
+			}
+		}
+		enqueueLaunch(requesters);
+	}
+	if (isStreamed() && !isStreamedLaunchEnqueued) {
+		for (auto&& chunk : streamedChunks) {
+			CHECK_CUDA(cudaEventRecord(chunk.completed->getHandle(), getStreamHandle()));
+		}
+	}
+	// Otherwise, rays of this node were traced by the first node in the batch (in the same stream).
+
+	if (isDenseOutput) {
+		// Hit count is needed on host, unless consumers accept it on the device; then the arrays are trimmed lazily.
+		denseHitCountHost->resize(1, false, false);
+		CHECK_CUDA(cudaMemcpyAsync(denseHitCountHost->getWritePtr(), denseHitCount->getReadPtr(), sizeof(uint32_t),
+		                           cudaMemcpyDeviceToHost, getStreamHandle()));
+		if (!isPointCountDeferred) {
+			CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+		}
+		// Formatted points (if fused) are copied by the consumer up to the count.
+		if (!isPointCountDeferred && fusedFormatFields.empty()) {
+			for (auto&& [_, data] : fieldData) {
+				data->resize(denseHitCountHost->at(0), false, true);
+			}
+		}
+	}
+}
+
+IAnyArray::ConstPtr RaytraceNode::getFieldData(rgl_field_t field)
+{
+	if (field == RAY_POSE_MAT3x4_F32) {
+		return isRayPoseMaterialized() ? rayPoses : raysNode->getRays();
+	}
+	// Outside of the graph thread, arrays are trimmed to the exact count, which requires waiting for the node.
+	bool trimToDeviceCount = isPointCountDeferred && hasGraphRunCtx() && !graphRunCtx.value()->isThisThreadGraphThread();
+	if (trimToDeviceCount && fusedFormatFields.empty()) {
+		this->synchronize();
+		fieldData.at(field)->resize(denseHitCountHost->at(0), false, true);
+	}
+	return std::const_pointer_cast<const IAnyArray>(fieldData.at(field));
+}
+
+void RaytraceNode::enqueueLaunch(const std::vector<RaytraceNode*>& requesters)
+{
+	// Scene version raytraced in this run is immutable, even if the scene is modified meanwhile (see comment in Scene).
+	const SceneSnapshot& sceneSnapshot = getGraphRunCtx()->getSceneSnapshot();
+	RaytraceRequestContext firstRequestCtx = requesters[0]->makeRequestCtx(sceneSnapshot);
+	if (requesters.size() == 1 && isResultCacheHit(firstRequestCtx, sceneSnapshot)) {
+		return;
+	}
+	scene->enqueueWaitForSnapshotLocked(sceneSnapshot, getStreamHandle());
+	if (requesters.size() == 1 && canTraceTimeSliced(sceneSnapshot)) {
+		enqueueTimeSlicedLaunch(firstRequestCtx, sceneSnapshot);
+		return;
+	}
+	if (requesters.size() == 1 && isStreamed() && !streamedChunks.empty()) {
+		enqueueStreamedLaunch(firstRequestCtx, sceneSnapshot);
+		return;
+	}
+
+	std::vector<RaytraceRequestContext> requestCtxs;
+	std::size_t maxWidth = 0, maxHeight = 0;
+	for (std::size_t i = 0; i < requesters.size(); ++i) {
+		RaytraceRequestContext requestCtx = i == 0 ? firstRequestCtx : requesters[i]->makeRequestCtx(sceneSnapshot);
+		requestCtx.scene = requesters[i]->getCulledAS(sceneSnapshot, getStreamHandle());
+		requestCtx.rayIdxRemap = requesters[i]->getRayIdxRemap(getStreamHandle());
+		requesters[i]->prepareIncrementalTrace(requestCtx, sceneSnapshot, requesters.size() > 1);
+		maxWidth = std::max(maxWidth, requesters[i]->getRayLayoutWidth());
+		maxHeight = std::max(maxHeight, requesters[i]->getRayLayoutHeight());
+		requestCtxs.push_back(requestCtx);
+	}
+	enqueueOptixLaunch(requestCtxs, maxWidth, maxHeight, sceneSnapshot.sbt);
+}
+
+void RaytraceNode::enqueueOptixLaunch(const std::vector<RaytraceRequestContext>& requestCtxs, std::size_t width,
+                                      std::size_t height, const OptixShaderBindingTable& sbt)
+{
+	LaunchSlot& slot = acquireLaunchSlot();
+
+	// Launch params and requests are uploaded with a single copy; requests directly follow params.
+	static_assert(sizeof(RaytraceLaunchParams) % alignof(RaytraceRequestContext) == 0);
+	std::size_t slotSize = sizeof(RaytraceLaunchParams) + sizeof(RaytraceRequestContext) * requestCtxs.size();
+	slot.hst->resize(slotSize, false, false);
+	slot.dev->resize(slotSize, false, false);
+	std::memcpy(slot.hst->getWritePtr() + sizeof(RaytraceLaunchParams), requestCtxs.data(),
+	            sizeof(RaytraceRequestContext) * requestCtxs.size());
+	RaytraceLaunchParams launchParams = {
+	    .requests = reinterpret_cast<const RaytraceRequestContext*>(slot.dev->getReadPtr() + sizeof(RaytraceLaunchParams)),
+	    .requestCount = requestCtxs.size(),
+	    .useShaderExecutionReordering = Optix::getOrCreate().isShaderExecutionReorderingSupported,
+	};
+	std::memcpy(slot.hst->getWritePtr(), &launchParams, sizeof(RaytraceLaunchParams));
+	CHECK_CUDA(cudaMemcpyAsync(slot.dev->getWritePtr(), slot.hst->getReadPtr(), slotSize, cudaMemcpyHostToDevice,
+	                           getStreamHandle()));
+
+	dim3 launchDims = {static_cast<unsigned int>(width), static_cast<unsigned int>(height),
+	                   static_cast<unsigned int>(requestCtxs.size())};
+	CHECK_OPTIX(optixLaunch(Optix::getOrCreate().pipeline, getStreamHandle(), slot.dev->getDeviceReadPtr(),
+	                        sizeof(RaytraceLaunchParams), &sbt, launchDims.x, launchDims.y, launchDims.z));
+	PerformanceCounters::instance().tracedRayCount.fetch_add(std::size_t{launchDims.x} * launchDims.y * launchDims.z,
+	                                                        std::memory_order_relaxed);
+	CHECK_CUDA(cudaEventRecord(slot.launchCompleted->getHandle(), getStreamHandle()));
+}
+
+RaytraceNode::LaunchSlot& RaytraceNode::acquireLaunchSlot()
+{
+	LaunchSlot& slot = launchSlots[nextLaunchSlot];
+	nextLaunchSlot = (nextLaunchSlot + 1) % LAUNCH_SLOT_COUNT;
+	// The slot was used LAUNCH_SLOT_COUNT launches ago, so the launch reading it has almost certainly completed.
+	CHECK_CUDA(cudaEventSynchronize(slot.launchCompleted->getHandle()));
+	return slot;
+}
+
+void RaytraceNode::updateStreamedChunks()
+{
+	std::size_t width = raysNode->getRayCount() > 0 ? getRayLayoutWidth() : 0;
+	std::size_t chunkCount = std::min(streamingChunkCount, width);
+	streamedChunks.resize(chunkCount);
+	for (std::size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx) {
+		streamedChunks[chunkIdx].columnBegin = width * chunkIdx / chunkCount;
+		streamedChunks[chunkIdx].columnCount = width * (chunkIdx + 1) / chunkCount - streamedChunks[chunkIdx].columnBegin;
+	}
+}
+
+void RaytraceNode::enqueueStreamedLaunch(RaytraceRequestContext requestCtx, const SceneSnapshot& sceneSnapshot)
+{
+	cudaStream_t stream = getStreamHandle();
+	requestCtx.scene = getCulledAS(sceneSnapshot, stream);
+	requestCtx.rayIdxRemap = getRayIdxRemap(stream);
+	prepareIncrementalTrace(requestCtx, sceneSnapshot, false);
+
+	// Each chunk has its own params and request, uploaded together, so that launches do not wait for launch slots.
+	// Params are kept 16-byte aligned, as are the device buffers.
+	constexpr std::size_t chunkStride = (sizeof(RaytraceLaunchParams) + sizeof(RaytraceRequestContext) + 15) / 16 * 16;
+	static_assert(sizeof(RaytraceLaunchParams) % alignof(RaytraceRequestContext) == 0);
+	LaunchSlot& slot = acquireLaunchSlot();
+	slot.hst->resize(chunkStride * streamedChunks.size(), false, false);
+	slot.dev->resize(chunkStride * streamedChunks.size(), false, false);
+	for (std::size_t chunkIdx = 0; chunkIdx < streamedChunks.size(); ++chunkIdx) {
+		// Launch indices start at the first column of the chunk; rows keep the width of the layout, see getRayIdx().
+		RaytraceRequestContext chunkRequestCtx = requestCtx;
+		chunkRequestCtx.launchIdxOffset = streamedChunks[chunkIdx].columnBegin;
+		RaytraceLaunchParams launchParams = {
+		    .requests = reinterpret_cast<const RaytraceRequestContext*>(slot.dev->getReadPtr() + chunkStride * chunkIdx +
+		                                                                sizeof(RaytraceLaunchParams)),
+		    .requestCount = 1,
+		    .useShaderExecutionReordering = Optix::getOrCreate().isShaderExecutionReorderingSupported,
+		};
+		std::byte* hostChunk = slot.hst->getWritePtr() + chunkStride * chunkIdx;
+		std::memcpy(hostChunk, &launchParams, sizeof(RaytraceLaunchParams));
+		std::memcpy(hostChunk + sizeof(RaytraceLaunchParams), &chunkRequestCtx, sizeof(RaytraceRequestContext));
+	}
+	CHECK_CUDA(cudaMemcpyAsync(slot.dev->getWritePtr(), slot.hst->getReadPtr(), chunkStride * streamedChunks.size(),
+	                           cudaMemcpyHostToDevice, stream));
+
+	std::size_t height = getRayLayoutHeight();
+	for (std::size_t chunkIdx = 0; chunkIdx < streamedChunks.size(); ++chunkIdx) {
+		const StreamedChunk& chunk = streamedChunks[chunkIdx];
+		CHECK_OPTIX(optixLaunch(Optix::getOrCreate().pipeline, stream, slot.dev->getDeviceReadPtr() + chunkStride * chunkIdx,
+		                        sizeof(RaytraceLaunchParams), &sceneSnapshot.sbt, chunk.columnCount, height, 1));
+		CHECK_CUDA(cudaEventRecord(chunk.completed->getHandle(), stream));
+	}
+	PerformanceCounters::instance().tracedRayCount.fetch_add(requestCtx.rayCount, std::memory_order_relaxed);
+	CHECK_CUDA(cudaEventRecord(slot.launchCompleted->getHandle(), stream));
+	isStreamedLaunchEnqueued = true;
+}
+
+bool RaytraceNode::canTraceTimeSliced(const SceneSnapshot& sceneSnapshot) const
+{
+	// With motion blur, each ray is already traced at its own time; without motion since the previous frame, slices are same.
+	bool hasFrameTime = sceneSnapshot.deltaTime.has_value() && sceneSnapshot.deltaTime->asSeconds() > 0.0;
+	return isTimeSliced() && raysNode->getTimeOffsets().has_value() && !Optix::isMotionBlurEnabled() && hasFrameTime &&
+	       sceneSnapshot.instanceCount > 0 && raysNode->getRayCount() > 0;
+}
+
+void RaytraceNode::enqueueTimeSlicedLaunch(RaytraceRequestContext requestCtx, const SceneSnapshot& sceneSnapshot)
+{
+	// Slices are traced in ASes of their own, so culling and incremental mode do not apply.
+	incrementalPrevRequestCtx.reset();
+	cudaStream_t stream = getStreamHandle();
+	requestCtx.rayIdxRemap = getRayIdxRemap(stream, true);
+	std::size_t rayCount = requestCtx.rayCount;
+	std::size_t sliceCount = std::min(timeSliceCount, rayCount);
+	auto frameTimeMs = static_cast<float>(sceneSnapshot.deltaTime->asSeconds() * 1000.0);
+
+	// Buffers of both ASes are allocated in node's stream, before the build stream uses them.
+	OptixBuildInput input = {
+	    .type = OPTIX_BUILD_INPUT_TYPE_INSTANCES,
+	    .instanceArray = {.numInstances = static_cast<unsigned int>(sceneSnapshot.instanceCount)},
+	};
+	OptixAccelBuildOptions options = {.buildFlags = OPTIX_BUILD_FLAG_PREFER_FAST_BUILD | OPTIX_BUILD_FLAG_ALLOW_UPDATE,
+	                                  .operation = OPTIX_BUILD_OPERATION_BUILD};
+	OptixAccelBufferSizes bufferSizes;
+	CHECK_OPTIX(optixAccelComputeMemoryUsage(Optix::getOrCreate().context, &options, &input, 1, &bufferSizes));
+	std::size_t tempSize = std::max(bufferSizes.tempSizeInBytes, bufferSizes.tempUpdateSizeInBytes);
+	timeSliceASTemp->resize(tempSize, false, false);
+	for (auto&& sliceAS : timeSliceASes) {
+		sliceAS.instances->resize(sceneSnapshot.instanceCount, false, false);
+		sliceAS.output->resize(bufferSizes.outputSizeInBytes, false, false);
+	}
+	if (timeSliceBuildStream == nullptr) {
+		timeSliceBuildStream = CudaStream::create(cudaStreamNonBlocking);
+	}
+	cudaStream_t buildStream = timeSliceBuildStream->getHandle();
+	CHECK_CUDA(cudaEventRecord(timeSliceInputsReady->getHandle(), stream));
+	CHECK_CUDA(cudaStreamWaitEvent(buildStream, timeSliceInputsReady->getHandle()));
+
+	for (std::size_t sliceIdx = 0; sliceIdx < sliceCount; ++sliceIdx) {
+		std::size_t sliceBegin = rayCount * sliceIdx / sliceCount;
+		std::size_t sliceEnd = rayCount * (sliceIdx + 1) / sliceCount;
+		TimeSliceAS& sliceAS = timeSliceASes[sliceIdx % timeSliceASes.size()];
+		bool isRefit = sliceIdx >= timeSliceASes.size();
+		if (isRefit) {
+			// The AS is still read by the launch of the slice before the previous one.
+			CHECK_CUDA(cudaStreamWaitEvent(buildStream, sliceAS.launched->getHandle()));
+		}
+		// Instances are moved to the time of the middle ray of the slice (in launch order), which is known on the device only.
+		gpuExtrapolateInstances(buildStream, sceneSnapshot.instanceCount, sceneSnapshot.instances,
+		                        sceneSnapshot.entityTransformHistories, requestCtx.prevSceneTime, requestCtx.rayTimeOffsets,
+		                        requestCtx.rayIdxRemap + (sliceBegin + sliceEnd) / 2, frameTimeMs,
+		                        sliceAS.instances->getWritePtr());
+		input.instanceArray.instances = sliceAS.instances->getDeviceReadPtr();
+		options.operation = isRefit ? OPTIX_BUILD_OPERATION_UPDATE : OPTIX_BUILD_OPERATION_BUILD;
+		CHECK_OPTIX(optixAccelBuild(Optix::getOrCreate().context, buildStream, &options, &input, 1,
+		                            timeSliceASTemp->getDeviceReadPtr(), tempSize, sliceAS.output->getDeviceReadPtr(),
+		                            bufferSizes.outputSizeInBytes, &sliceAS.handle, nullptr, 0));
+		CHECK_CUDA(cudaEventRecord(sliceAS.built->getHandle(), buildStream));
+
+		// Instances keep their indices, so the SBT and entity data of the snapshot remain valid.
+		RaytraceRequestContext sliceRequestCtx = requestCtx;
+		sliceRequestCtx.scene = sliceAS.handle;
+		sliceRequestCtx.launchIdxOffset = sliceBegin;
+		sliceRequestCtx.rayLayoutWidth = sliceEnd - sliceBegin;
+		CHECK_CUDA(cudaStreamWaitEvent(stream, sliceAS.built->getHandle()));
+		enqueueOptixLaunch({sliceRequestCtx}, sliceEnd - sliceBegin, 1, sceneSnapshot.sbt);
+		CHECK_CUDA(cudaEventRecord(sliceAS.launched->getHandle(), stream));
+	}
+}
+
+OptixTraversableHandle RaytraceNode::getCulledAS(const SceneSnapshot& sceneSnapshot, cudaStream_t stream)
+{
+	if (cullingRange == 0.0f || sceneSnapshot.instanceBounds == nullptr) {
+		return sceneSnapshot.as;
+	}
+	Vec3f origin = raysNode->getCumulativeRayTransfrom().translation();
+	bool isCachedValid = culledASVersion == sceneSnapshot.asVersion &&
+	                     (origin - culledASOrigin).length() <= cullingMovementThreshold;
+	if (isCachedValid) {
+		return culledAS;
 	}
 
-	// Even though we are in graph thread here, we can access Scene class (see comment there)
-	const Mat3x4f* raysPtr = raysNode->getRays()->asSubclass<DeviceAsyncArray>()->getReadPtr();
-	auto sceneAS = Scene::instance().getASLocked();
-	auto sceneSBT = Scene::instance().getSBTLocked();
-	dim3 launchDims = {static_cast<unsigned int>(raysNode->getRayCount()), 1, 1};
+	// Culled instances keep their indices, so the SBT and entity data of the snapshot remain valid.
+	culledInstances->resize(sceneSnapshot.instanceCount, false, false);
+	Vec4f cullingSphere{origin.x(), origin.y(), origin.z(), cullingRange + cullingMovementThreshold};
+	gpuCullInstances(stream, sceneSnapshot.instanceCount, sceneSnapshot.instances, sceneSnapshot.instanceBounds, cullingSphere,
+	                 culledInstances->getWritePtr());
+
+	// Instances with zero visibility mask are never traversed; builders are free to leave them out of the BVH.
+	OptixBuildInput input = {
+	    .type = OPTIX_BUILD_INPUT_TYPE_INSTANCES,
+	    .instanceArray = {.instances = culledInstances->getDeviceReadPtr(),
+	                      .numInstances = static_cast<unsigned int>(sceneSnapshot.instanceCount)},
+	};
+	OptixAccelBuildOptions options = {.buildFlags = OPTIX_BUILD_FLAG_PREFER_FAST_BUILD,
+	                                  .operation = OPTIX_BUILD_OPERATION_BUILD};
+	OptixAccelBufferSizes bufferSizes;
+	CHECK_OPTIX(optixAccelComputeMemoryUsage(Optix::getOrCreate().context, &options, &input, 1, &bufferSizes));
+	culledASTemp->resize(bufferSizes.tempSizeInBytes, false, false);
+	culledASOutput->resize(bufferSizes.outputSizeInBytes, false, false);
+	CHECK_OPTIX(optixAccelBuild(Optix::getOrCreate().context, stream, &options, &input, 1, culledASTemp->getDeviceReadPtr(),
+	                            bufferSizes.tempSizeInBytes, culledASOutput->getDeviceReadPtr(),
+	                            bufferSizes.outputSizeInBytes, &culledAS, nullptr, 0));
+	culledASVersion = sceneSnapshot.asVersion;
+	culledASOrigin = origin;
+	return culledAS;
+}
+
+const uint32_t* RaytraceNode::getRayIdxRemap(cudaStream_t stream, bool isTimeOrdered)
+{
+	if (!isRaySortingEnabled && !isTimeOrdered) {
+		return nullptr;
+	}
+	// Rays may be modified in place, so they are sorted in each run; it is cheap compared to tracing them.
+	std::size_t rayCount = raysNode->getRayCount();
+	auto rayDirections = raysNode->getRayDirections();
+	const Mat3x4f* raysPtr = rayDirections.has_value() ? nullptr :
+	                                                     raysNode->getRays()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	const Vec3f* rayDirectionsPtr = rayDirections.has_value() ?
+	                                    (*rayDirections)->asSubclass<DeviceAsyncArray>()->getReadPtr() :
+	                                    nullptr;
+	rayDirectionKeys->resize(rayCount, false, false);
+	sortedRayDirectionKeys->resize(rayCount, false, false);
+	rayIndices->resize(rayCount, false, false);
+	rayIdxRemap->resize(rayCount, false, false);
+	raySortTempStorage->resize(gpuSortVoxelKeysTempStorageSize(rayCount), false, false);
+	if (isTimeOrdered) {
+		const float* timeOffsetsPtr = (*raysNode->getTimeOffsets())->asSubclass<DeviceAsyncArray>()->getReadPtr();
+		gpuComputeRayTimeKeys(stream, rayCount, timeOffsetsPtr, rayDirectionKeys->getWritePtr(), rayIndices->getWritePtr());
+	}
+	else {
+		gpuComputeRayDirectionKeys(stream, rayCount, raysPtr, rayDirectionsPtr, rayDirectionKeys->getWritePtr(),
+		                           rayIndices->getWritePtr());
+	}
+	gpuSortVoxelKeys(stream, rayCount, rayDirectionKeys->getReadPtr(), sortedRayDirectionKeys->getWritePtr(),
+	                 rayIndices->getReadPtr(), rayIdxRemap->getWritePtr(), raySortTempStorage->getWritePtr(),
+	                 raySortTempStorage->getCount());
+	return rayIdxRemap->getReadPtr();
+}
+
+void RaytraceNode::setCulling(float range, float movementThreshold)
+{
+	cullingRange = range;
+	cullingMovementThreshold = movementThreshold;
+	culledASVersion.reset();
+	if (cullingRange > 0.0f) {
+		scene->enableInstanceBounds();
+	}
+}
+
+void RaytraceNode::setTimeSlicing(std::size_t sliceCount)
+{
+	if (isTimeSliced() != (sliceCount > 1)) {
+		invalidateExecutionOrder(); // Time-sliced nodes are not batched, see GraphRunCtx::groupRaytraceNodes()
+	}
+	timeSliceCount = sliceCount;
+}
+
+void RaytraceNode::setStreaming(std::size_t chunkCount)
+{
+	if (isStreamed() != (chunkCount > 1)) {
+		invalidateExecutionOrder(); // Streamed nodes are not batched, see GraphRunCtx::groupRaytraceNodes()
+	}
+	streamingChunkCount = chunkCount;
+}
+
+void RaytraceNode::setRaySkipping(int missFrameCount, int probePeriod)
+{
+	raySkippingMissFrameCount = missFrameCount;
+	raySkippingProbePeriod = probePeriod;
+	rayMissFrameCounts->clear(false); // Zeroed in the next run, see makeRequestCtx()
+}
+
+void RaytraceNode::setIncremental(bool enabled)
+{
+	isIncremental = enabled;
+	incrementalPrevRequestCtx.reset();
+	if (isIncremental) {
+		scene->enableInstanceBounds();
+	}
+}
+
+// Tells whether the output of the previous request is valid for the current one, given the same rays and scene.
+static bool isPrevOutputReusable(const RaytraceRequestContext& prev, const RaytraceRequestContext& ctx)
+{
+	auto getOutputs = [](const RaytraceRequestContext& c) {
+		return std::tie(c.xyz, c.isHit, c.rayIdx, c.ringIdx, c.distance, c.intensity, c.timestamp, c.entityId, c.classId,
+		                c.pointAbsVelocity, c.pointRelVelocity, c.radialSpeed, c.azimuth, c.elevation, c.normal,
+		                c.incidentAngle, c.returnType, c.xyzHalf, c.distanceHalf, c.normalHalf, c.xyzQuantized);
+	};
+	auto getSettings = [](const RaytraceRequestContext& c) {
+		return std::tie(c.nearNonHitDistance, c.farNonHitDistance, c.rayCount, c.rayLayoutWidth, c.rayOriginToWorld,
+		                c.worldToOutput, c.ringIds, c.ringIdsCount, c.visibilityMask, c.closestHitVariant, c.returnMode,
+		                c.returnCount, c.beamHalfDivergence, c.beamSampleCount, c.beamReduction, c.rayAngularNoiseMean,
+		                c.rayAngularNoiseAxis, c.hitDistanceNoiseMean, c.multipathBounceCount, c.multipathReflectivity,
+		                c.formattedPointSize);
+	};
+	auto isEqual = [](const Vec3f& lhs, const Vec3f& rhs) {
+		return lhs.x() == rhs.x() && lhs.y() == rhs.y() && lhs.z() == rhs.z();
+	};
+	// Velocities of unchanged entities are the same, as long as the time step is.
+	bool hasVelocities = ctx.pointAbsVelocity != nullptr || ctx.pointRelVelocity != nullptr || ctx.radialSpeed != nullptr;
+	return getOutputs(prev) == getOutputs(ctx) && getSettings(prev) == getSettings(ctx) &&
+	       isEqual(prev.sensorLinearVelocityXYZ, ctx.sensorLinearVelocityXYZ) &&
+	       isEqual(prev.sensorAngularVelocityRPY, ctx.sensorAngularVelocityRPY) &&
+	       (!hasVelocities || prev.sceneDeltaTime == ctx.sceneDeltaTime);
+}
+
+void RaytraceNode::prepareIncrementalTrace(RaytraceRequestContext& requestCtx, const SceneSnapshot& sceneSnapshot,
+                                           bool isBatched)
+{
+	// Random (per frame) and time-dependent results cannot be kept; without bounds, changed instances cannot be found.
+	bool isDeterministic = requestCtx.rayAngularNoiseStDev == 0.0f && requestCtx.hitDistanceNoiseStDevBase == 0.0f &&
+	                       requestCtx.hitDistanceNoiseStDevRisePerMeter == 0.0f &&
+	                       requestCtx.weatherExtinctionCoefficient == 0.0f && !requestCtx.doApplyDistortion &&
+	                       requestCtx.timestamp == nullptr && requestCtx.denseHitCount == nullptr;
+	bool hasBounds = sceneSnapshot.instanceCount == 0 || sceneSnapshot.instanceBounds != nullptr;
+	if (!isIncremental || isBatched || !isDeterministic || !hasBounds) {
+		incrementalPrevRequestCtx.reset();
+		return;
+	}
+
+	cudaStream_t stream = getStreamHandle();
+	bool canPatch = incrementalPrevRequestCtx.has_value() && isPrevOutputReusable(*incrementalPrevRequestCtx, requestCtx) &&
+	                incrementalPrevGASVersionSum == sceneSnapshot.gasVersionSum;
+	if (canPatch) {
+		std::size_t maxInstanceCount = std::max(incrementalPrevInstances->getCount(), sceneSnapshot.instanceCount);
+		incrementalChangedBounds->resize(2 * maxInstanceCount, false, false);
+		incrementalChangedBoundsCount->resize(1, false, false);
+		CHECK_CUDA(cudaMemsetAsync(incrementalChangedBoundsCount->getWritePtr(), 0, sizeof(unsigned), stream));
+		gpuFindChangedInstanceBounds(stream, incrementalPrevInstances->getCount(), incrementalPrevInstances->getReadPtr(),
+		                             incrementalPrevEntityInstances->getReadPtr(),
+		                             incrementalPrevTransformHistories->getReadPtr(), incrementalPrevRequestCtx->prevSceneTime,
+		                             incrementalPrevInstanceBounds->getReadPtr(), sceneSnapshot.instanceCount,
+		                             sceneSnapshot.instances, sceneSnapshot.entityInstances,
+		                             sceneSnapshot.entityTransformHistories, requestCtx.prevSceneTime,
+		                             sceneSnapshot.instanceBounds, incrementalChangedBounds->getWritePtr(),
+		                             incrementalChangedBoundsCount->getWritePtr());
+	}
+	// Queued after finding changes, so that the previous instances are replaced only once they are compared.
+	ArrayCopyBatch prevInstancesCopy{incrementalPrevInstances->getStream()};
+	prevInstancesCopy.copyFromExternal<OptixInstance>(incrementalPrevInstances, sceneSnapshot.instances,
+	                                                  sceneSnapshot.instanceCount);
+	prevInstancesCopy.copyFromExternal<EntityInstanceData>(incrementalPrevEntityInstances, sceneSnapshot.entityInstances,
+	                                                       sceneSnapshot.instanceCount);
+	prevInstancesCopy.copyFromExternal<EntityTransformHistory>(incrementalPrevTransformHistories,
+	                                                           sceneSnapshot.entityTransformHistories,
+	                                                           sceneSnapshot.instanceCount);
+	prevInstancesCopy.copyFromExternal<Vec4f>(incrementalPrevInstanceBounds, sceneSnapshot.instanceBounds,
+	                                          sceneSnapshot.instanceCount);
+	prevInstancesCopy.execute();
+	incrementalPrevGASVersionSum = sceneSnapshot.gasVersionSum;
+
+	// Rays are stored by raygen (also in a full trace), they are compared with the previous ones only when patching.
+	incrementalPrevRays->resize(requestCtx.rayCount, false, canPatch);
+	incrementalPrevRanges->resize(requestCtx.rayCount, false, canPatch);
+	requestCtx.incrementalPrevRays = incrementalPrevRays->getWritePtr();
+	requestCtx.incrementalPrevRanges = incrementalPrevRanges->getWritePtr();
+	requestCtx.incrementalChangedBounds = canPatch ? incrementalChangedBounds->getReadPtr() : nullptr;
+	requestCtx.incrementalChangedBoundsCount = canPatch ? incrementalChangedBoundsCount->getReadPtr() : nullptr;
+	incrementalPrevRequestCtx = requestCtx;
+}
+
+void RaytraceNode::setResultCache(bool enabled)
+{
+	isResultCacheEnabled = enabled;
+	resultCacheKey.reset();
+}
+
+bool RaytraceNode::isResultCacheHit(const RaytraceRequestContext& requestCtx, const SceneSnapshot& sceneSnapshot)
+{
+	// Random (per frame) results cannot be kept; dense output arrays are trimmed to the hit count, losing the rest.
+	bool isDeterministic = requestCtx.rayAngularNoiseStDev == 0.0f && requestCtx.hitDistanceNoiseStDevBase == 0.0f &&
+	                       requestCtx.hitDistanceNoiseStDevRisePerMeter == 0.0f &&
+	                       requestCtx.weatherExtinctionCoefficient == 0.0f;
+	if (!isResultCacheEnabled || !isDeterministic || requestCtx.denseHitCount != nullptr) {
+		resultCacheKey.reset();
+		return false;
+	}
+
+	ResultCacheKey key = {
+	    .requestCtx = requestCtx,
+	    .asVersion = sceneSnapshot.asVersion,
+	    .gasVersionSum = sceneSnapshot.gasVersionSum,
+	    .sbtVersion = sceneSnapshot.sbtVersion,
+	    .upstreamRevisions = getUpstreamRevisions(),
+	};
+	auto getInputs = [](const ResultCacheKey& k) {
+		const RaytraceRequestContext& c = k.requestCtx;
+		return std::tie(c.rays, c.raysTransform, c.rayDirections, c.rayRanges, c.rayRangesCount, c.rayTimeOffsets,
+		                c.rayTimeOffsetsCount, c.doApplyDistortion, c.textures, k.asVersion, k.gasVersionSum, k.sbtVersion,
+		                k.upstreamRevisions);
+	};
+	// Velocities (and time slices) depend on poses at the previous frame time, which are the newest ones once all entities
+	// stopped (see EntityTransformHistory); the same AS version implies the same histories.
+	bool usesPrevFramePoses = requestCtx.pointAbsVelocity != nullptr || requestCtx.pointRelVelocity != nullptr ||
+	                          requestCtx.radialSpeed != nullptr || requestCtx.rayTimeOffsets != nullptr;
+	auto isPrevFramePoseSame = [&](const RaytraceRequestContext& prev) {
+		return !usesPrevFramePoses || prev.prevSceneTime == requestCtx.prevSceneTime ||
+		       std::min(prev.prevSceneTime, requestCtx.prevSceneTime) >= sceneSnapshot.lastMotionTime;
+	};
+	// Contents of ray arrays may change only with revisions of the nodes providing them.
+	bool isHit = resultCacheKey.has_value() && getInputs(*resultCacheKey) == getInputs(key) &&
+	             isPrevOutputReusable(resultCacheKey->requestCtx, requestCtx) &&
+	             isPrevFramePoseSame(resultCacheKey->requestCtx) &&
+	             (requestCtx.timestamp == nullptr || resultCacheKey->requestCtx.sceneTime == requestCtx.sceneTime);
+	resultCacheKey = std::move(key);
+	if (isHit) {
+		PerformanceCounters::instance().raytraceCacheHitCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	return isHit;
+}
+
+std::vector<std::pair<const Node*, uint64_t>> RaytraceNode::getUpstreamRevisions() const
+{
+	// Random frames of this node are not counted, its results are kept only without noise.
+	std::vector<std::pair<const Node*, uint64_t>> revisions = {{this, validationCount}};
+	std::vector<Node::Ptr> pending = getInputs();
+	while (!pending.empty()) {
+		Node::Ptr node = pending.back();
+		pending.pop_back();
+		revisions.emplace_back(node.get(), node->getRevision());
+		pending.insert(pending.end(), node->getInputs().begin(), node->getInputs().end());
+	}
+	return revisions;
+}
+
+RaytraceRequestContext RaytraceNode::makeRequestCtx(const SceneSnapshot& sceneSnapshot)
+{
+	if (fusedFormatFields.empty()) {
+		for (auto const& [_, data] : fieldData) {
+			data->resize(raysNode->getRayCount() * getReturnCount(), false, false);
+		}
+	}
+	else {
+		fusedFormatData->resize(raysNode->getRayCount() * getReturnCount() * getPointSize(fusedFormatFields), false, false);
+	}
+	if (isDenseOutput) {
+		denseHitCount->resize(1, false, false);
+		CHECK_CUDA(cudaMemsetAsync(denseHitCount->getWritePtr(), 0, sizeof(uint32_t), getStreamHandle()));
+	}
+
+	auto rayDirections = raysNode->getRayDirections();
+	const Mat3x4f* raysPtr = rayDirections.has_value() ? nullptr :
+	                                                     raysNode->getRays()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	const Vec3f* rayDirectionsPtr = rayDirections.has_value() ?
+	                                    (*rayDirections)->asSubclass<DeviceAsyncArray>()->getReadPtr() :
+	                                    nullptr;
 
 	// Optional
 	auto rayRanges = raysNode->getRanges();
 	auto ringIds = raysNode->getRingIds();
 	auto timeOffsets = raysNode->getTimeOffsets();
 
-	// Note: requestCtx is a HostPinnedArray just for convenience (Host meme accessible from GPU), may be optimized.
-	requestCtxHst->resize(1, true, false);
-	requestCtxHst->at(0) = RaytraceRequestContext{
+	bool isRaySkipping = raySkippingMissFrameCount > 0;
+	if (isRaySkipping && rayMissFrameCounts->getCount() != raysNode->getRayCount()) {
+		rayMissFrameCounts->resize(raysNode->getRayCount(), true, false);
+	}
+
+	return RaytraceRequestContext{
 	    .sensorLinearVelocityXYZ = sensorLinearVelocityXYZ,
 	    .sensorAngularVelocityRPY = sensorAngularVelocityRPY,
 	    .doApplyDistortion = doApplyDistortion,
 	    .nearNonHitDistance = nearNonHitDistance,
 	    .farNonHitDistance = farNonHitDistance,
 	    .rays = raysPtr,
+	    .raysTransform = raysNode->getPendingRayTransform().value_or(Mat3x4f::identity()),
+	    .rayDirections = rayDirectionsPtr,
 	    .rayCount = raysNode->getRayCount(),
+	    .rayLayoutWidth = getRayLayoutWidth(),
 	    .rayOriginToWorld = raysNode->getCumulativeRayTransfrom(),
+	    .doTransformOutput = outputFrame != RGL_OUTPUT_FRAME_WORLD || outputFrameTransform != Mat3x4f::identity(),
+	    .worldToOutput = getWorldToOutputTransform(),
 	    .rayRanges = rayRanges.has_value() ? (*rayRanges)->asSubclass<DeviceAsyncArray>()->getReadPtr() :
 	                                         defaultRange->getReadPtr(),
 	    .rayRangesCount = rayRanges.has_value() ? (*rayRanges)->getCount() : defaultRange->getCount(),
@@ -94,9 +704,39 @@ void RaytraceNode::enqueueExecImpl()
 	    .ringIdsCount = ringIds.has_value() ? (*ringIds)->getCount() : 0,
 	    .rayTimeOffsets = timeOffsets.has_value() ? (*timeOffsets)->asSubclass<DeviceAsyncArray>()->getReadPtr() : nullptr,
 	    .rayTimeOffsetsCount = timeOffsets.has_value() ? (*timeOffsets)->getCount() : 0,
-	    .scene = sceneAS,
-	    .sceneTime = Scene::instance().getTime().value_or(Time::zero()).asSeconds(),
-	    .sceneDeltaTime = static_cast<float>(Scene::instance().getDeltaTime().value_or(Time::zero()).asSeconds()),
+	    .scene = sceneSnapshot.as,
+	    .visibilityMask = visibilityMask,
+	    .entityInstances = sceneSnapshot.entityInstances,
+	    .entityTransformHistories = sceneSnapshot.entityTransformHistories,
+	    .textures = Texture::getDeviceTable(),
+	    .sceneTime = sceneSnapshot.time.value_or(Time::zero()).asSeconds(),
+	    .prevSceneTime =
+	        (sceneSnapshot.time.value_or(Time::zero()) - sceneSnapshot.deltaTime.value_or(Time::zero())).asSeconds(),
+	    .sceneDeltaTime = static_cast<float>(sceneSnapshot.deltaTime.value_or(Time::zero()).asSeconds()),
+	    .closestHitVariant = getClosestHitVariant(),
+	    .returnMode = returnMode,
+	    .returnCount = getReturnCount(),
+	    .beamHalfDivergence = beamDivergenceAngle / 2.0f,
+	    .beamSampleCount = beamDivergenceAngle > 0.0f ? static_cast<unsigned>(beamSampleCount) : 1,
+	    .beamReduction = beamReduction,
+	    .rayAngularNoiseMean = rayAngularNoiseMean,
+	    .rayAngularNoiseStDev = rayAngularNoiseStDev,
+	    .rayAngularNoiseAxis = rayAngularNoiseAxis,
+	    .hitDistanceNoiseMean = hitDistanceNoiseMean,
+	    .hitDistanceNoiseStDevBase = hitDistanceNoiseStDevBase,
+	    .hitDistanceNoiseStDevRisePerMeter = hitDistanceNoiseStDevRisePerMeter,
+	    .noiseSeed = randomSeed,
+	    .noiseFrame = randomFrameIdx++,
+	    .weatherExtinctionCoefficient = weatherExtinctionCoefficient,
+	    .weatherParticleIntensity = weatherParticleIntensity,
+	    .multipathBounceCount = static_cast<unsigned>(multipathBounceCount),
+	    .multipathReflectivity = multipathReflectivity,
+	    .rayMissFrameCounts = isRaySkipping ? rayMissFrameCounts->getWritePtr() : nullptr,
+	    .raySkippingMissFrameCount = static_cast<unsigned>(raySkippingMissFrameCount),
+	    .raySkippingProbePeriod = static_cast<unsigned>(raySkippingProbePeriod),
+	    .raySkippingFrame = isRaySkipping ? raySkippingFrameIdx++ : 0,
+	    .denseHitCount = isDenseOutput ? denseHitCount->getWritePtr() : nullptr,
+	    .formattedPointSize = static_cast<unsigned>(fusedFormatFields.empty() ? 0 : getPointSize(fusedFormatFields)),
 	    .xyz = getPtrTo<XYZ_VEC3_F32>(),
 	    .isHit = getPtrTo<IS_HIT_I32>(),
 	    .rayIdx = getPtrTo<RAY_IDX_U32>(),
@@ -105,6 +745,7 @@ void RaytraceNode::enqueueExecImpl()
 	    .intensity = getPtrTo<INTENSITY_F32>(),
 	    .timestamp = getPtrTo<TIME_STAMP_F64>(),
 	    .entityId = getPtrTo<ENTITY_ID_I32>(),
+	    .classId = getPtrTo<CLASS_ID_U16>(),
 	    .pointAbsVelocity = getPtrTo<ABSOLUTE_VELOCITY_VEC3_F32>(),
 	    .pointRelVelocity = getPtrTo<RELATIVE_VELOCITY_VEC3_F32>(),
 	    .radialSpeed = getPtrTo<RADIAL_SPEED_F32>(),
@@ -112,13 +753,12 @@ void RaytraceNode::enqueueExecImpl()
 	    .elevation = getPtrTo<ELEVATION_F32>(),
 	    .normal = getPtrTo<NORMAL_VEC3_F32>(),
 	    .incidentAngle = getPtrTo<INCIDENT_ANGLE_F32>(),
+	    .returnType = getPtrTo<RETURN_TYPE_U8>(),
+	    .xyzHalf = getPtrTo<XYZ_VEC3_F16>(),
+	    .distanceHalf = getPtrTo<DISTANCE_F16>(),
+	    .normalHalf = getPtrTo<NORMAL_VEC3_F16>(),
+	    .xyzQuantized = getPtrTo<XYZ_VEC3_I16>(),
 	};
-
-	requestCtxDev->copyFrom(requestCtxHst);
-	CUdeviceptr pipelineArgsPtr = requestCtxDev->getDeviceReadPtr();
-	std::size_t pipelineArgsSize = requestCtxDev->getSizeOf() * requestCtxDev->getCount();
-	CHECK_OPTIX(optixLaunch(Optix::getOrCreate().pipeline, getStreamHandle(), pipelineArgsPtr, pipelineArgsSize, &sceneSBT,
-	                        launchDims.x, launchDims.y, launchDims.y));
 }
 
 void RaytraceNode::setFields(const std::set<rgl_field_t>& fields)
@@ -138,6 +778,75 @@ void RaytraceNode::setFields(const std::set<rgl_field_t>& fields)
 	}
 }
 
+size_t RaytraceNode::getWidth() const
+{
+	if (isDenseOutput) {
+		this->synchronize();
+		return denseHitCountHost->at(0);
+	}
+	// Returns are stored one after another; for organized clouds, that means rows of the next return follow.
+	bool isOrganized = raysNode && raysNode->getLayout().has_value();
+	return isOrganized ? getRayLayoutWidth() : getRayLayoutWidth() * getReturnCount();
+}
+
+size_t RaytraceNode::getHeight() const
+{
+	if (isDenseOutput) {
+		return 1;
+	}
+	bool isOrganized = raysNode && raysNode->getLayout().has_value();
+	return isOrganized ? getRayLayoutHeight() * getReturnCount() : 1;
+}
+
+size_t RaytraceNode::getRayLayoutWidth() const
+{
+	if (!raysNode) {
+		return 0;
+	}
+	auto layout = raysNode->getLayout();
+	return layout.has_value() ? static_cast<size_t>(layout->x()) : raysNode->getRayCount();
+}
+
+size_t RaytraceNode::getRayLayoutHeight() const
+{
+	auto layout = raysNode ? raysNode->getLayout() : std::nullopt;
+	return layout.has_value() ? static_cast<size_t>(layout->y()) : 1;
+}
+
+unsigned RaytraceNode::getReturnCount() const
+{
+	bool isDual = returnMode == RGL_RETURN_MODE_DUAL_FIRST_LAST || returnMode == RGL_RETURN_MODE_DUAL_STRONGEST_LAST;
+	// Multipath returns follow the first return, see validateImpl().
+	return isDual ? 2 : 1 + static_cast<unsigned>(multipathBounceCount);
+}
+
+bool RaytraceNode::isRayPoseMaterialized() const
+{
+	return fieldData.contains(RAY_POSE_MAT3x4_F32) && (raysNode->getPendingRayTransform().has_value() || getReturnCount() > 1);
+}
+
+Mat3x4f RaytraceNode::getWorldToOutputTransform() const
+{
+	if (outputFrame == RGL_OUTPUT_FRAME_SENSOR) {
+		return outputFrameTransform * raysNode->getCumulativeRayTransfrom().inverse();
+	}
+	return outputFrameTransform;
+}
+
+unsigned RaytraceNode::getClosestHitVariant() const
+{
+	// Choose the leanest closest-hit program that computes all requested fields.
+	unsigned variant = 0;
+	if (fieldData.contains(NORMAL_VEC3_F32) || fieldData.contains(NORMAL_VEC3_F16) || fieldData.contains(INCIDENT_ANGLE_F32)) {
+		variant |= CLOSEST_HIT_FEATURE_NORMAL;
+	}
+	if (fieldData.contains(ABSOLUTE_VELOCITY_VEC3_F32) || fieldData.contains(RELATIVE_VELOCITY_VEC3_F32) ||
+	    fieldData.contains(RADIAL_SPEED_F32)) {
+		variant |= CLOSEST_HIT_FEATURE_VELOCITY;
+	}
+	return variant;
+}
+
 std::set<rgl_field_t> RaytraceNode::findFieldsToCompute()
 {
 	std::set<rgl_field_t> outFields;
@@ -166,6 +875,47 @@ std::set<rgl_field_t> RaytraceNode::findFieldsToCompute()
 	return outFields;
 }
 
+std::vector<rgl_field_t> RaytraceNode::findFusedFormat() const
+{
+	// Fields written by raygen; others (e.g. RAY_POSE_MAT3x4_F32) are computed separately.
+	static const std::set<rgl_field_t> fusableFields = {
+	    XYZ_VEC3_F32,    IS_HIT_I32,         RAY_IDX_U32,    RING_ID_U16,  DISTANCE_F32,    INTENSITY_F32,
+	    TIME_STAMP_F64,  ENTITY_ID_I32,      CLASS_ID_U16,   AZIMUTH_F32,  ELEVATION_F32,   RADIAL_SPEED_F32,
+	    NORMAL_VEC3_F32, INCIDENT_ANGLE_F32, RETURN_TYPE_U8, XYZ_VEC3_F16, DISTANCE_F16,    NORMAL_VEC3_F16,
+	    XYZ_VEC3_I16,    ABSOLUTE_VELOCITY_VEC3_F32,         RELATIVE_VELOCITY_VEC3_F32,
+	};
+	auto formatNode = getOutputs().size() == 1 ? std::dynamic_pointer_cast<FormatPointsNode>(getOutputs().front()) : nullptr;
+	if (formatNode == nullptr) {
+		return {};
+	}
+	const std::vector<rgl_field_t>& fields = formatNode->getFields();
+	std::set<rgl_field_t> uniqueFields;
+	for (auto&& field : fields) {
+		bool isFusable = isDummy(field) || (fusableFields.contains(field) && uniqueFields.insert(field).second);
+		if (!isFusable) {
+			return {};
+		}
+	}
+
+	// Fields are not written separately, so no node below may need them (they would be read through FormatPointsNode).
+	std::function<bool(const Node::Ptr&)> isOnlyFormatRequired = [&](const Node::Ptr& current) {
+		for (auto&& node : current->getOutputs()) {
+			if (auto pointNode = std::dynamic_pointer_cast<IPointsNode>(node)) {
+				for (auto&& field : pointNode->getRequiredFieldList()) {
+					if (field != RGL_FIELD_DYNAMIC_FORMAT && !isDummy(field)) {
+						return false;
+					}
+				}
+			}
+			if (!isOnlyFormatRequired(node)) {
+				return false;
+			}
+		}
+		return true;
+	};
+	return isOnlyFormatRequired(formatNode) ? fields : std::vector<rgl_field_t>{};
+}
+
 void RaytraceNode::setVelocity(const Vec3f& linearVelocity, const Vec3f& angularVelocity)
 {
 	sensorLinearVelocityXYZ = linearVelocity;
@@ -177,3 +927,33 @@ void RaytraceNode::setNonHitDistanceValues(float nearDistance, float farDistance
 	nearNonHitDistance = nearDistance;
 	farNonHitDistance = farDistance;
 }
+
+void RaytraceNode::setBeamDivergence(float divergenceAngle, int sampleCount, rgl_beam_reduction_t reduction)
+{
+	beamDivergenceAngle = divergenceAngle;
+	beamSampleCount = sampleCount;
+	beamReduction = reduction;
+}
+
+void RaytraceNode::setNoise(float angularMean, float angularStDev, rgl_axis_t angularAxis, float distanceMean,
+                            float distanceStDevBase, float distanceStDevRisePerMeter)
+{
+	rayAngularNoiseMean = angularMean;
+	rayAngularNoiseStDev = angularStDev;
+	rayAngularNoiseAxis = angularAxis;
+	hitDistanceNoiseMean = distanceMean;
+	hitDistanceNoiseStDevBase = distanceStDevBase;
+	hitDistanceNoiseStDevRisePerMeter = distanceStDevRisePerMeter;
+}
+
+void RaytraceNode::setWeather(float extinctionCoefficient, float particleIntensity)
+{
+	weatherExtinctionCoefficient = extinctionCoefficient;
+	weatherParticleIntensity = particleIntensity;
+}
+
+void RaytraceNode::setMultipath(int bounceCount, float reflectivity)
+{
+	multipathBounceCount = bounceCount;
+	multipathReflectivity = reflectivity;
+}
@@ -31,7 +31,8 @@ void SetRangeRaysNode::setParameters(const Vec2f* rangesRaw, size_t rangesCount)
 		}
 	}
 
-	ranges->copyFromExternal(rangesRaw, rangesCount);
+	ranges = SharedDeviceArrays::acquire(rangesRaw, rangesCount);
+	rangesHash = hashContent(rangesRaw, rangesCount);
 }
 
 void SetRangeRaysNode::validateImpl()
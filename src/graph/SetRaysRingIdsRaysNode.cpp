@@ -16,7 +16,8 @@
 
 void SetRingIdsRaysNode::setParameters(const int* ringIdsRaw, size_t ringIdsCount)
 {
-	ringIds->copyFromExternal(ringIdsRaw, ringIdsCount);
+	ringIds = SharedDeviceArrays::acquire(ringIdsRaw, ringIdsCount);
+	ringIdsHash = hashContent(ringIdsRaw, ringIdsCount);
 }
 
 void SetRingIdsRaysNode::validateImpl()
@@ -16,7 +16,8 @@
 
 void SetTimeOffsetsRaysNode::setParameters(const float* raysTimeOffsetsRaw, size_t raysTimeOffsetsCount)
 {
-	timeOffsets->copyFromExternal(raysTimeOffsetsRaw, raysTimeOffsetsCount);
+	timeOffsets = SharedDeviceArrays::acquire(raysTimeOffsetsRaw, raysTimeOffsetsCount);
+	timeOffsetsHash = hashContent(raysTimeOffsetsRaw, raysTimeOffsetsCount);
 }
 
 void SetTimeOffsetsRaysNode::validateImpl()
@@ -0,0 +1,223 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstring>
+
+#include <graph/NodesCore.hpp>
+#include <graph/GraphRunCtx.hpp>
+#include <macros/handleDestructorException.hpp>
+#include <RGLFields.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // _WIN32
+
+static_assert(sizeof(cudaIpcMemHandle_t) == RGL_SHM_IPC_HANDLE_SIZE);
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free, "readers in other processes rely on lock-free atomics");
+
+void ShmPublishPointsNode::setParameters(const char* shmName, int32_t slotCount, std::size_t slotDataSize,
+                                         bool exportDeviceBuffers)
+{
+#ifdef _WIN32
+	throw InvalidAPIArgument("shared memory publishing is not supported on Windows");
+#else
+	if (mapping != nullptr && this->shmName == shmName && this->slotCount == slotCount &&
+	    this->slotDataSize == slotDataSize && this->exportDeviceBuffers == exportDeviceBuffers) {
+		return;
+	}
+	destroyRing();
+	this->shmName = shmName;
+	this->slotCount = slotCount;
+	this->slotDataSize = slotDataSize;
+	this->exportDeviceBuffers = exportDeviceBuffers;
+	createRing();
+#endif // _WIN32
+}
+
+void ShmPublishPointsNode::validateImpl()
+{
+	IPointsNodeSingleInput::validateImpl();
+	if (!input->hasField(RGL_FIELD_DYNAMIC_FORMAT)) {
+		auto msg = fmt::format("{} requires a formatted point cloud", getName());
+		throw InvalidPipeline(msg);
+	}
+	layout = input->getRequiredFieldList();
+	if (layout.size() > RGL_SHM_MAX_FIELD_COUNT) {
+		auto msg = fmt::format("{} supports formats of at most {} fields, got {}", getName(), RGL_SHM_MAX_FIELD_COUNT,
+		                       layout.size());
+		throw InvalidPipeline(msg);
+	}
+}
+
+void ShmPublishPointsNode::enqueueExecImpl()
+{
+	std::size_t pointSize = getPointSize(layout);
+	std::size_t dataSize = input->getPointCount() * pointSize;
+	if (dataSize > slotDataSize) {
+		auto msg = fmt::format("{}: point cloud ({} bytes) does not fit in the slot ({} bytes)", getName(), dataSize,
+		                       slotDataSize);
+		throw InvalidPipeline(msg);
+	}
+
+	std::size_t slotIdx = writtenFrameCount % slotCount;
+	writtenFrameCount += 1;
+	auto commit = std::make_unique<SlotCommit>();
+	commit->ring = static_cast<rgl_shm_ring_header_t*>(mapping);
+	commit->slot = getSlotHeader(slotIdx);
+	commit->values.frame_id = getGraphRunCtx()->getFrameId();
+	std::optional<Time> sceneTime = getGraphRunCtx()->getSceneTime();
+	commit->values.timestamp_ns = sceneTime.has_value() ? sceneTime->asNanoseconds() : 0;
+	commit->values.width = static_cast<int32_t>(input->getWidth());
+	commit->values.height = static_cast<int32_t>(input->getHeight());
+	commit->values.point_size = static_cast<int32_t>(pointSize);
+	commit->values.field_count = static_cast<int32_t>(layout.size());
+	std::ranges::copy(layout, commit->values.fields);
+	commit->values.is_dense = input->isDense();
+
+	// Host functions do not call CUDA, they only update the slot's header in stream order, around the copies.
+	auto fieldData = input->getFieldData(RGL_FIELD_DYNAMIC_FORMAT);
+	cudaStream_t stream = getStreamHandle();
+	CHECK_CUDA(cudaLaunchHostFunc(stream, beginSlotWrite, commit->slot));
+	char* slotData = static_cast<char*>(mapping) + commit->slot->data_offset; // Constant, set in createRing()
+	CHECK_CUDA(cudaMemcpyAsync(slotData, fieldData->getRawReadPtr(), dataSize, cudaMemcpyDefault, stream));
+	if (exportDeviceBuffers) {
+		CHECK_CUDA(cudaMemcpyAsync(deviceBuffers.at(slotIdx), fieldData->getRawReadPtr(), dataSize, cudaMemcpyDefault, stream));
+	}
+	CHECK_CUDA(cudaLaunchHostFunc(stream, commitSlotWrite, commit.get()));
+	commit.release(); // Owned by commitSlotWrite
+}
+
+void ShmPublishPointsNode::beginSlotWrite(void* slotHeader)
+{
+	auto* slot = static_cast<rgl_shm_slot_header_t*>(slotHeader);
+	std::atomic_ref<uint64_t> sequence{slot->sequence};
+	sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	// Readers must observe the odd sequence before any modification of the slot.
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+void ShmPublishPointsNode::commitSlotWrite(void* slotCommit)
+{
+	std::unique_ptr<SlotCommit> commit{static_cast<SlotCommit*>(slotCommit)};
+	// Data offset and IPC handle are constant, other fields describe the frame.
+	const rgl_shm_slot_header_t& values = commit->values;
+	rgl_shm_slot_header_t* slot = commit->slot;
+	slot->frame_id = values.frame_id;
+	slot->timestamp_ns = values.timestamp_ns;
+	slot->width = values.width;
+	slot->height = values.height;
+	slot->point_size = values.point_size;
+	slot->field_count = values.field_count;
+	std::ranges::copy(values.fields, slot->fields);
+	slot->is_dense = values.is_dense;
+	std::atomic_ref<uint64_t> sequence{slot->sequence};
+	sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	std::atomic_ref<uint64_t>{commit->ring->latest_frame_id}.store(commit->values.frame_id, std::memory_order_release);
+}
+
+void ShmPublishPointsNode::createRing()
+{
+#ifndef _WIN32
+	std::size_t headersSize = sizeof(rgl_shm_ring_header_t) + slotCount * sizeof(rgl_shm_slot_header_t);
+	std::size_t alignedSlotDataSize = (slotDataSize + SLOT_DATA_ALIGNMENT - 1) / SLOT_DATA_ALIGNMENT * SLOT_DATA_ALIGNMENT;
+	std::size_t dataOffset = (headersSize + SLOT_DATA_ALIGNMENT - 1) / SLOT_DATA_ALIGNMENT * SLOT_DATA_ALIGNMENT;
+	mappingSize = dataOffset + slotCount * alignedSlotDataSize;
+
+	// Stale object (e.g. left by a crashed process) is replaced, so that readers do not see its content.
+	shm_unlink(shmName.c_str());
+	int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0) {
+		throw InvalidFilePath(fmt::format("could not create shared memory '{}': {}", shmName, std::strerror(errno)));
+	}
+	if (ftruncate(fd, static_cast<off_t>(mappingSize)) != 0) {
+		int error = errno;
+		close(fd);
+		shm_unlink(shmName.c_str());
+		throw std::runtime_error(fmt::format("could not resize shared memory '{}': {}", shmName, std::strerror(error)));
+	}
+	void* address = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd); // Mapping keeps the object open
+	if (address == MAP_FAILED) {
+		shm_unlink(shmName.c_str());
+		throw std::runtime_error(fmt::format("could not map shared memory '{}': {}", shmName, std::strerror(errno)));
+	}
+	mapping = address;
+	// Page-locked, so that copies from the GPU are asynchronous, see Node::ResultBuffer.
+	CHECK_CUDA(cudaHostRegister(mapping, mappingSize, cudaHostRegisterDefault));
+
+	// Memory from stream-ordered allocator cannot be exported with cudaIpcGetMemHandle.
+	for (int32_t slotIdx = 0; exportDeviceBuffers && slotIdx < slotCount; ++slotIdx) {
+		CHECK_CUDA(cudaMalloc(&deviceBuffers.emplace_back(), slotDataSize));
+	}
+	for (int32_t slotIdx = 0; slotIdx < slotCount; ++slotIdx) {
+		rgl_shm_slot_header_t* slot = getSlotHeader(slotIdx);
+		slot->data_offset = dataOffset + slotIdx * alignedSlotDataSize;
+		if (exportDeviceBuffers) {
+			cudaIpcMemHandle_t handle{};
+			CHECK_CUDA(cudaIpcGetMemHandle(&handle, deviceBuffers.at(slotIdx)));
+			std::memcpy(slot->device_ipc_handle, &handle, sizeof(handle));
+			slot->has_device_data = 1;
+		}
+	}
+
+	auto* ring = static_cast<rgl_shm_ring_header_t*>(mapping);
+	ring->version = RGL_SHM_RING_VERSION;
+	ring->slot_count = slotCount;
+	ring->slot_data_size = slotDataSize;
+	// Readers may open the object as soon as it is created; it is complete once the magic is set.
+	std::atomic_ref<uint32_t>{ring->magic}.store(RGL_SHM_RING_MAGIC, std::memory_order_release);
+	writtenFrameCount = 0;
+#endif // _WIN32
+}
+
+void ShmPublishPointsNode::destroyRing()
+{
+#ifndef _WIN32
+	if (mapping == nullptr) {
+		return;
+	}
+	// Pending copies and host functions of the last run access the ring.
+	CHECK_CUDA(cudaEventSynchronize(getExecCompletedEvent()));
+	for (auto&& buffer : deviceBuffers) {
+		CHECK_CUDA(cudaFree(buffer));
+	}
+	deviceBuffers.clear();
+	CHECK_CUDA(cudaHostUnregister(mapping));
+	munmap(mapping, mappingSize);
+	shm_unlink(shmName.c_str());
+	mapping = nullptr;
+	mappingSize = 0;
+#endif // _WIN32
+}
+
+rgl_shm_slot_header_t* ShmPublishPointsNode::getSlotHeader(std::size_t slotIdx) const
+{
+	auto* slots = reinterpret_cast<rgl_shm_slot_header_t*>(static_cast<char*>(mapping) + sizeof(rgl_shm_ring_header_t));
+	return slots + slotIdx;
+}
+
+std::string ShmPublishPointsNode::getArgsString() const
+{
+	return fmt::format("name={}, slots={}, slotSize={}, exportDevice={}", shmName, slotCount, slotDataSize,
+	                   exportDeviceBuffers);
+}
+
+ShmPublishPointsNode::~ShmPublishPointsNode()
+try {
+	destroyRing();
+}
+HANDLE_DESTRUCTOR_EXCEPTION
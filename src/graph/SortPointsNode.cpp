@@ -0,0 +1,106 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <RGLFields.hpp>
+#include <graph/GraphRunCtx.hpp>
+
+void SortPointsNode::setParameters(rgl_field_t keyField, bool descending)
+{
+	this->keyField = keyField;
+	this->descending = descending;
+}
+
+void SortPointsNode::validateImpl()
+{
+	IPointsNodeSingleInput::validateImpl();
+	// Needed to clear cache because fields in the pipeline may have changed
+	cacheManager.clear();
+}
+
+void SortPointsNode::enqueueExecImpl()
+{
+	cacheManager.trigger();
+	width = input->getPointCount();
+
+	// Sorting permutes points of the input, so it is composed with the input selection, if any (see IPointsSelection).
+	auto inputSelection = std::dynamic_pointer_cast<IPointsSelection>(input);
+	selectionSource = inputSelection != nullptr ? inputSelection->getSelectionSource() : input;
+
+	selectionIndices->resize(width, false, false);
+	if (width > 0) {
+		sortKeys->resize(width, false, false);
+		sortedKeys->resize(width, false, false);
+		pointIndices->resize(width, false, false);
+		tempStorage->resize(gpuSortVoxelKeysTempStorageSize(width), false, false);
+
+		auto keyData = input->getFieldData(keyField);
+		if (!isDeviceAccessible(keyData->getMemoryKind())) {
+			auto msg = fmt::format("{} requires its input to be device-accessible, {} is not", getName(), keyField);
+			throw InvalidPipeline(msg);
+		}
+		const Field<RAY_IDX_U32>::type* inputIndices = inputSelection != nullptr ? inputSelection->getSelectionIndicesPtr()
+		                                                                         : nullptr;
+		gpuComputeSortKeys(getStreamHandle(), width, keyField, keyData->getRawReadPtr(), descending, inputIndices,
+		                   sortKeys->getWritePtr(), pointIndices->getWritePtr());
+		gpuSortVoxelKeys(getStreamHandle(), width, sortKeys->getReadPtr(), sortedKeys->getWritePtr(),
+		                 pointIndices->getReadPtr(), selectionIndices->getWritePtr(), tempStorage->getWritePtr(),
+		                 tempStorage->getCount());
+	}
+
+	// getFieldData may be called in client's thread from rgl_graph_get_result_data
+	// Therefore, once we know what fields are requested, we compute them eagerly (see CompactByFieldPointsNode)
+	for (auto&& field : cacheManager.getKeys()) {
+		getFieldData(field);
+	}
+}
+
+IAnyArray::ConstPtr SortPointsNode::getFieldData(rgl_field_t field)
+{
+	std::lock_guard lock{getFieldDataMutex};
+
+	if (!cacheManager.contains(field)) {
+		auto fieldData = createArray<DeviceAsyncArray>(field, arrayMgr);
+		cacheManager.insert(field, fieldData, true);
+	}
+
+	if (!cacheManager.isLatest(field)) {
+		auto fieldData = cacheManager.getValue(field);
+		fieldData->resize(width, false, false);
+		if (width > 0) {
+			char* outPtr = static_cast<char*>(fieldData->getRawWritePtr());
+			auto sourceData = selectionSource->getFieldData(field);
+			if (!isDeviceAccessible(sourceData->getMemoryKind())) {
+				auto msg = fmt::format("{} requires its input to be device-accessible, {} is not", getName(), field);
+				throw InvalidPipeline(msg);
+			}
+			const char* sourcePtr = static_cast<const char*>(sourceData->getRawReadPtr());
+			gpuFilter(getStreamHandle(), width, nullptr, selectionIndices->getReadPtr(), outPtr, sourcePtr,
+			          getFieldSize(field));
+			if (!graphRunCtx.value()->isThisThreadGraphThread()) {
+				// API asks for a field which was not computed in enqueueExecImpl; it won't wait for the graph stream.
+				CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+			}
+		}
+		cacheManager.setUpdated(field);
+	}
+
+	return std::const_pointer_cast<const IAnyArray>(cacheManager.getValue(field));
+}
+
+std::string SortPointsNode::getArgsString() const
+{
+	return fmt::format("key={}, {}", toString(keyField), descending ? "descending" : "ascending");
+}
@@ -0,0 +1,90 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <RGLFields.hpp>
+
+void SpatialIndexPointsNode::enqueueExecImpl()
+{
+	size_t pointCount = input->getPointCount();
+	cellKeys->resize(pointCount, false, false);
+	sortedCellKeys->resize(pointCount, false, false);
+	pointIndices->resize(pointCount, false, false);
+	sortedPointIndices->resize(pointCount, false, false);
+	if (pointCount == 0) {
+		return;
+	}
+	tempStorage->resize(gpuSortVoxelKeysTempStorageSize(pointCount), false, false);
+	const auto* points = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+	gpuComputeVoxelKeys(getStreamHandle(), pointCount, points, Vec3f{cellSize}, nullptr, cellKeys->getWritePtr(),
+	                    pointIndices->getWritePtr());
+	gpuSortVoxelKeys(getStreamHandle(), pointCount, cellKeys->getReadPtr(), sortedCellKeys->getWritePtr(),
+	                 pointIndices->getReadPtr(), sortedPointIndices->getWritePtr(), tempStorage->getWritePtr(),
+	                 tempStorage->getCount());
+}
+
+const Field<IS_HIT_I32>::type* SpatialIndexPointsNode::getIsHitPtr() const
+{
+	if (!input->hasField(IS_HIT_I32)) {
+		return nullptr;
+	}
+	return input->getFieldDataTyped<IS_HIT_I32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+}
+
+void SpatialIndexPointsNode::queryNearest(const Vec3f* queries, size_t queryCount, float maxDistance, int32_t* outIndices,
+                                          float* outDistances)
+{
+	if (queryCount == 0) {
+		return;
+	}
+	cudaStream_t stream = CudaStream::getCopyStream()->getHandle();
+	queriesDev->copyFromExternal(queries, queryCount);
+	resultIndicesDev->resize(queryCount, false, false);
+	resultDistancesDev->resize(queryCount, false, false);
+	gpuQueryNearestPoints(stream, queryCount, queriesDev->getReadPtr(), cellSize, maxDistance, sortedCellKeys->getCount(),
+	                      input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr(),
+	                      getIsHitPtr(), sortedCellKeys->getReadPtr(), sortedPointIndices->getReadPtr(),
+	                      resultIndicesDev->getWritePtr(), resultDistancesDev->getWritePtr());
+	CHECK_CUDA(cudaMemcpyAsync(outIndices, resultIndicesDev->getReadPtr(), queryCount * sizeof(int32_t), cudaMemcpyDefault,
+	                           stream));
+	CHECK_CUDA(cudaMemcpyAsync(outDistances, resultDistancesDev->getReadPtr(), queryCount * sizeof(float), cudaMemcpyDefault,
+	                           stream));
+	CHECK_CUDA(cudaStreamSynchronize(stream));
+}
+
+void SpatialIndexPointsNode::queryRadius(const Vec3f* queries, size_t queryCount, float radius, int32_t maxNeighbourCount,
+                                         int32_t* outIndices, int32_t* outCounts)
+{
+	if (queryCount == 0) {
+		return;
+	}
+	cudaStream_t stream = CudaStream::getCopyStream()->getHandle();
+	queriesDev->copyFromExternal(queries, queryCount);
+	resultIndicesDev->resize(queryCount * maxNeighbourCount, false, false);
+	resultCountsDev->resize(queryCount, false, false);
+	gpuQueryRadiusPoints(stream, queryCount, queriesDev->getReadPtr(), cellSize, radius, maxNeighbourCount,
+	                     sortedCellKeys->getCount(),
+	                     input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr(),
+	                     getIsHitPtr(), sortedCellKeys->getReadPtr(), sortedPointIndices->getReadPtr(),
+	                     resultIndicesDev->getWritePtr(), resultCountsDev->getWritePtr());
+	CHECK_CUDA(cudaMemcpyAsync(outIndices, resultIndicesDev->getReadPtr(), queryCount * maxNeighbourCount * sizeof(int32_t),
+	                           cudaMemcpyDefault, stream));
+	CHECK_CUDA(cudaMemcpyAsync(outCounts, resultCountsDev->getReadPtr(), queryCount * sizeof(int32_t), cudaMemcpyDefault,
+	                           stream));
+	CHECK_CUDA(cudaStreamSynchronize(stream));
+}
+
+std::string SpatialIndexPointsNode::getArgsString() const { return fmt::format("cellSize={}", cellSize); }
@@ -65,14 +65,46 @@ void SpatialMergePointsNode::enqueueExecImpl()
 		width += input->getWidth();
 	}
 
+	// Fields available on the device are merged by a single kernel launch, instead of a copy per field per input.
 	// This could work lazily - merging only on demand
+	mergeDescsHost->clear(false);
+	std::size_t mergedFieldCount = 0;
 	for (const auto& [field, data] : mergedData) {
-		data->resize(0, false, false);
+		bool isOnDevice = std::ranges::all_of(pointInputs, [field](const IPointsNode::Ptr& input) {
+			return isDeviceAccessible(input->getFieldData(field)->getMemoryKind());
+		});
+		if (!isOnDevice) {
+			data->resize(0, false, false);
+			for (const auto& input : pointInputs) {
+				data->appendFrom(input->getFieldData(field));
+			}
+			continue;
+		}
+		data->resize(width, false, false);
+		std::size_t fieldSize = getFieldSize(field);
+		std::size_t pointOffset = 0;
 		for (const auto& input : pointInputs) {
-			const auto toMergeData = input->getFieldData(field);
-			data->appendFrom(toMergeData);
+			std::size_t pointCount = input->getPointCount();
+			mergeDescsHost->resize(mergeDescsHost->getCount() + 1, false, true);
+			(*mergeDescsHost)[mergeDescsHost->getCount() - 1] = GPUMergeDesc{
+			    .src = static_cast<const char*>(input->getFieldData(field)->getRawReadPtr()),
+			    .dst = static_cast<char*>(data->getRawWritePtr()) + pointOffset * fieldSize,
+			    .pointOffset = pointOffset,
+			    .pointCount = pointCount,
+			    .fieldSize = fieldSize,
+			};
+			pointOffset += pointCount;
 		}
+		++mergedFieldCount;
+	}
+	if (mergedFieldCount == 0 || width == 0) {
+		return;
 	}
+	// mergeDescsHost is not rebuilt before the copy ends, because nodes are synchronized between graph runs.
+	mergeDescs->resize(mergeDescsHost->getCount(), false, false);
+	CHECK_CUDA(cudaMemcpyAsync(mergeDescs->getWritePtr(), mergeDescsHost->getReadPtr(),
+	                           mergeDescsHost->getCount() * sizeof(GPUMergeDesc), cudaMemcpyHostToDevice, getStreamHandle()));
+	gpuMergePoints(getStreamHandle(), width, pointInputs.size(), mergedFieldCount, mergeDescs->getReadPtr());
 }
 
 bool SpatialMergePointsNode::isDense() const
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <graph/NodesCore.hpp>
+#include <graph/GraphRunCtx.hpp>
 #include <RGLFields.hpp>
 
 void TemporalMergePointsNode::setParameters(const std::vector<rgl_field_t>& fields)
@@ -22,15 +23,69 @@ void TemporalMergePointsNode::setParameters(const std::vector<rgl_field_t>& fiel
 	}
 
 	mergedData.clear();
+	ringData.clear();
+	ringFrames.clear();
+	ringHead = 0;
 	width = 0;
+	maxPointCount = 0;
+	timeWindow = 0.0;
 
 	for (auto&& field : fields) {
 		if (!mergedData.contains(field) && !isDummy(field)) {
-			mergedData.insert({field, createArray<HostPageableArray>(field)});
+			mergedData.insert({field, createMergeArray(field, false)});
 		}
 	}
 }
 
+void TemporalMergePointsNode::setParameters(const std::vector<rgl_field_t>& fields, std::size_t maxPointCount,
+                                            double timeWindow)
+{
+	setParameters(fields);
+	this->maxPointCount = maxPointCount;
+	this->timeWindow = timeWindow;
+
+	// Device memory is allocated once for the whole capacity; merged points are kept on the GPU for the children.
+	for (auto&& field : std::views::keys(mergedData)) {
+		mergedData.at(field) = createMergeArray(field, true);
+		auto ring = createMergeArray(field, true);
+		ring->resize(maxPointCount, false, false);
+		ringData.insert({field, ring});
+	}
+}
+
+void TemporalMergePointsNode::setManagedMemory(bool enabled)
+{
+	if (isManagedMemory == enabled) {
+		return;
+	}
+	isManagedMemory = enabled;
+	// Arrays are recreated in the requested kind of memory, dropping merged points.
+	std::vector<rgl_field_t> fields{std::views::keys(mergedData).begin(), std::views::keys(mergedData).end()};
+	if (isRingMode()) {
+		setParameters(fields, maxPointCount, timeWindow);
+	}
+	else {
+		setParameters(fields);
+	}
+}
+
+IAnyArray::Ptr TemporalMergePointsNode::createMergeArray(rgl_field_t field, bool isOnDevice)
+{
+	if (isManagedMemory) {
+		return createArray<DeviceManagedArray>(field, arrayMgr);
+	}
+	return isOnDevice ? createArray<DeviceAsyncArray>(field, arrayMgr) : createArray<HostPageableArray>(field);
+}
+
+void TemporalMergePointsNode::prefetchToDevice(const IAnyArray::Ptr& array, std::size_t offset, std::size_t count)
+{
+	if (array->getMemoryKind() != MemoryKind::DeviceManaged) {
+		return;
+	}
+	const char* ptr = static_cast<const char*>(array->getRawReadPtr()) + offset * array->getSizeOf();
+	MemoryKindOperations<MemoryKind::DeviceManaged>::prefetch(ptr, count * array->getSizeOf(), false, getStreamHandle());
+}
+
 void TemporalMergePointsNode::validateImpl()
 {
 	IPointsNodeSingleInput::validateImpl();
@@ -44,11 +99,99 @@ void TemporalMergePointsNode::validateImpl()
 
 void TemporalMergePointsNode::enqueueExecImpl()
 {
+	if (isRingMode()) {
+		enqueueRingMerge();
+		return;
+	}
+
 	// This could work lazily - merging only on demand
 	for (const auto& [field, data] : mergedData) {
 		size_t pointCount = input->getPointCount();
 		const auto toMergeData = input->getFieldData(field);
+		if (isManagedMemory) {
+			// Only the appended range is migrated to the device; older points may reside in the host memory.
+			std::size_t mergedCount = data->getCount();
+			data->resize(mergedCount + pointCount, false, true);
+			prefetchToDevice(data, mergedCount, pointCount);
+			char* dst = static_cast<char*>(data->getRawWritePtr()) + mergedCount * data->getSizeOf();
+			CHECK_CUDA(cudaMemcpyAsync(dst, toMergeData->getRawReadPtr(), pointCount * data->getSizeOf(), cudaMemcpyDefault,
+			                           getStreamHandle()));
+			continue;
+		}
 		data->appendFrom(toMergeData);
 	}
 	width += input->getWidth();
 }
+
+void TemporalMergePointsNode::enqueueRingMerge()
+{
+	// Eviction is done per merged point cloud and takes O(1) (amortized), regardless of the number of points.
+	std::optional<Time> now = graphRunCtx.value()->getSceneTime();
+	if (timeWindow > 0.0) {
+		if (!now.has_value()) {
+			throw InvalidPipeline("Temporal points merge with time window requires scene time to be set");
+		}
+		double oldestAllowed = now->asSeconds() - timeWindow;
+		while (!ringFrames.empty() && ringFrames.front().time->asSeconds() < oldestAllowed) {
+			ringFrames.pop_front();
+		}
+	}
+
+	// Point cloud larger than the ring buffer is truncated.
+	std::size_t pointCount = std::min(input->getPointCount(), maxPointCount);
+	if (pointCount > 0) {
+		mergeToRing(pointCount);
+		ringFrames.back().time = now;
+	}
+	if (ringFrames.empty()) {
+		ringHead = 0;
+	}
+
+	// Children get merged points in contiguous arrays; consecutive ring frames are copied at once.
+	width = 0;
+	for (auto&& frame : ringFrames) {
+		width += frame.count;
+	}
+	for (auto&& [field, merged] : mergedData) {
+		merged->resize(width, false, false);
+		prefetchToDevice(merged, 0, width);
+		const char* ringPtr = static_cast<const char*>(ringData.at(field)->getRawReadPtr());
+		char* mergedPtr = static_cast<char*>(merged->getRawWritePtr());
+		std::size_t fieldSize = getFieldSize(field);
+		std::size_t dstOffset = 0;
+		for (auto it = ringFrames.begin(); it != ringFrames.end();) {
+			std::size_t runOffset = it->offset;
+			std::size_t runCount = 0;
+			do {
+				runCount += it->count;
+				++it;
+			} while (it != ringFrames.end() && it->offset == runOffset + runCount);
+			CHECK_CUDA(cudaMemcpyAsync(mergedPtr + dstOffset * fieldSize, ringPtr + runOffset * fieldSize, runCount * fieldSize,
+			                           cudaMemcpyDeviceToDevice, getStreamHandle()));
+			dstOffset += runCount;
+		}
+	}
+}
+
+void TemporalMergePointsNode::mergeToRing(std::size_t pointCount)
+{
+	// Point clouds are not split on wrap-around, so that each is stored in one piece.
+	std::size_t writeOffset = ringHead + pointCount <= maxPointCount ? ringHead : 0;
+	auto overlapsWrite = [&](const RingFrame& frame) {
+		return frame.offset < writeOffset + pointCount && writeOffset < frame.offset + frame.count;
+	};
+	// The oldest point clouds are evicted first, until the written range is free.
+	while (std::ranges::any_of(ringFrames, overlapsWrite)) {
+		ringFrames.pop_front();
+	}
+
+	for (auto&& [field, ring] : ringData) {
+		std::size_t fieldSize = getFieldSize(field);
+		char* dst = static_cast<char*>(ring->getRawWritePtr()) + writeOffset * fieldSize;
+		const void* src = input->getFieldData(field)->getRawReadPtr();
+		prefetchToDevice(ring, writeOffset, pointCount);
+		CHECK_CUDA(cudaMemcpyAsync(dst, src, pointCount * fieldSize, cudaMemcpyDefault, getStreamHandle()));
+	}
+	ringFrames.push_back({.offset = writeOffset, .count = pointCount, .time = std::nullopt});
+	ringHead = writeOffset + pointCount;
+}
@@ -14,23 +14,63 @@
 
 #include <graph/NodesCore.hpp>
 #include <gpu/nodeKernels.hpp>
+#include <graph/GraphRunCtx.hpp>
+
+bool TransformPointsNode::canDeferTransform() const
+{
+	// Consumers accepting pending transform (e.g. further transforms or formatting) apply it themselves,
+	// so that chained transforms are applied at once, without intermediate arrays.
+	// XYZ copied to a result buffer (in the graph thread) has to be transformed here.
+	auto acceptsPendingXyzTransform = [](const Node::Ptr& output) { return output->acceptsPendingXyzTransform(); };
+	return !outputs.empty() && !hasResultBuffer(XYZ_VEC3_F32) && std::ranges::all_of(outputs, acceptsPendingXyzTransform);
+}
 
 void TransformPointsNode::enqueueExecImpl()
 {
-	auto pointCount = input->getWidth() * input->getHeight();
-	output->resize(pointCount, false, false);
+	isTransformDeferred = canDeferTransform();
+	inPlaceOutput = isTransformDeferred ? nullptr : getInPlaceFieldData<XYZ_VEC3_F32>();
+	if (isTransformDeferred) {
+		return;
+	}
+	const uint32_t* devicePointCount = input->getPointCountDevicePtr();
+	auto pointCount = devicePointCount != nullptr ? input->getPointCountUpperBound() : input->getPointCount();
+	if (inPlaceOutput == nullptr) {
+		output->resize(pointCount, false, false);
+	}
 	const auto inputField = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>();
 	const auto* inputPtr = inputField->getReadPtr();
-	auto* outputPtr = output->getWritePtr();
-	gpuTransformPoints(getStreamHandle(), pointCount, inputPtr, outputPtr, transform);
+	auto* outputPtr = getOutput()->getWritePtr();
+	gpuTransformPoints(getStreamHandle(), pointCount, devicePointCount, inputPtr, outputPtr, getComposedTransform());
 }
 
 IAnyArray::ConstPtr TransformPointsNode::getFieldData(rgl_field_t field)
 {
 	if (field == XYZ_VEC3_F32) {
-		return output;
+		bool isOutsideGraphThread = hasGraphRunCtx() && !graphRunCtx.value()->isThisThreadGraphThread();
+		if (isTransformDeferred && !isOutsideGraphThread) {
+			return input->getFieldData(XYZ_VEC3_F32); // Consumers apply getPendingXyzTransform()
+		}
+		if (isTransformDeferred && deferredOutputFrameId != getResultFrameId()) {
+			// Requested by the client (the node's work is done): input's XYZ is transformed already, see above.
+			output->resize(getPointCount(), false, false);
+			const auto inputField = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>();
+			gpuTransformPoints(getStreamHandle(), getPointCount(), nullptr, inputField->getReadPtr(), output->getWritePtr(),
+			                   transform);
+			CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+			deferredOutputFrameId = getResultFrameId();
+		}
+		// Outside of the graph thread, the array is trimmed to the exact count (see IPointsNode::getPointCountDevicePtr())
+		if (getPointCountDevicePtr() != nullptr && isOutsideGraphThread) {
+			getOutput()->resize(getPointCount(), false, true);
+		}
+		return getOutput();
 	}
 	return input->getFieldData(field);
 }
 
+IAnyArray::Ptr TransformPointsNode::getOwnedFieldData(rgl_field_t field)
+{
+	return field == XYZ_VEC3_F32 && !canDeferTransform() ? getOutput() : nullptr;
+}
+
 std::string TransformPointsNode::getArgsString() const { return fmt::format("TR={}", transform.translation()); }
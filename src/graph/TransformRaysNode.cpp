@@ -15,8 +15,19 @@
 #include <graph/NodesCore.hpp>
 #include <gpu/nodeKernels.hpp>
 
+void TransformRaysNode::validateImpl()
+{
+	IRaysNodeSingleInput::validateImpl();
+	auto isRaytraceNode = [](const Node::Ptr& node) { return std::dynamic_pointer_cast<RaytraceNode>(node) != nullptr; };
+	isTransformDeferred = !input->getRayDirections().has_value() && !input->getPendingRayTransform().has_value() &&
+	                      !outputs.empty() && std::ranges::all_of(outputs, isRaytraceNode);
+}
+
 void TransformRaysNode::enqueueExecImpl()
 {
+	if (input->getRayDirections().has_value() || isTransformDeferred) {
+		return;
+	}
 	transformedRays->resize(getRayCount(), false, false);
 
 	// Kernel Call
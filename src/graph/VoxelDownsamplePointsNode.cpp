@@ -0,0 +1,114 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <graph/NodesCore.hpp>
+#include <gpu/nodeKernels.hpp>
+#include <RGLFields.hpp>
+#include <graph/GraphRunCtx.hpp>
+
+void VoxelDownsamplePointsNode::validateImpl()
+{
+	IPointsNodeSingleInput::validateImpl();
+	// Needed to clear cache because fields in the pipeline may have changed
+	cacheManager.clear();
+}
+
+void VoxelDownsamplePointsNode::enqueueExecImpl()
+{
+	cacheManager.trigger();
+	size_t pointCount = input->getPointCount();
+
+	// Downsampling selects points of the input, so it is composed with the input selection, if any (see IPointsSelection).
+	auto inputSelection = std::dynamic_pointer_cast<IPointsSelection>(input);
+	selectionSource = inputSelection != nullptr ? inputSelection->getSelectionSource() : input;
+
+	// Everything is done on the device: the first point of each voxel is selected from points sorted by voxel keys.
+	selectionIndices->resize(pointCount, false, false);
+	width = 0;
+	if (pointCount > 0) {
+		voxelKeys->resize(pointCount, false, false);
+		sortedVoxelKeys->resize(pointCount, false, false);
+		pointIndices->resize(pointCount, false, false);
+		sortedPointIndices->resize(pointCount, false, false);
+		isFirstInVoxel->resize(pointCount, false, false);
+		voxelCount->resize(1, false, false);
+		voxelCountHost->resize(1, false, false);
+		tempStorage->resize(std::max(gpuSortVoxelKeysTempStorageSize(pointCount), gpuFindCompactionTempStorageSize(pointCount)),
+		                    false, false);
+
+		const auto* points = input->getFieldDataTyped<XYZ_VEC3_F32>()->asSubclass<DeviceAsyncArray>()->getReadPtr();
+		const Field<RAY_IDX_U32>::type* inputIndices = inputSelection != nullptr ? inputSelection->getSelectionIndicesPtr()
+		                                                                         : nullptr;
+		gpuComputeVoxelKeys(getStreamHandle(), pointCount, points, leafDims, inputIndices, voxelKeys->getWritePtr(),
+		                    pointIndices->getWritePtr());
+		gpuSortVoxelKeys(getStreamHandle(), pointCount, voxelKeys->getReadPtr(), sortedVoxelKeys->getWritePtr(),
+		                 pointIndices->getReadPtr(), sortedPointIndices->getWritePtr(), tempStorage->getWritePtr(),
+		                 tempStorage->getCount());
+		gpuMarkFirstInVoxel(getStreamHandle(), pointCount, sortedVoxelKeys->getReadPtr(), isFirstInVoxel->getWritePtr());
+		gpuFindCompaction(getStreamHandle(), pointCount, isFirstInVoxel->getReadPtr(), sortedPointIndices->getReadPtr(),
+		                  selectionIndices->getWritePtr(), voxelCount->getWritePtr(), tempStorage->getWritePtr(),
+		                  tempStorage->getCount());
+		CHECK_CUDA(cudaMemcpyAsync(voxelCountHost->getWritePtr(), voxelCount->getReadPtr(), sizeof(uint32_t),
+		                           cudaMemcpyDeviceToHost, getStreamHandle()));
+		// Field arrays are sized on host, so the count is needed here.
+		CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+		width = voxelCountHost->at(0);
+	}
+	selectionIndices->resize(width, false, true);
+
+	// getFieldData may be called in client's thread from rgl_graph_get_result_data
+	// Therefore, once we know what fields are requested, we compute them eagerly (see CompactByFieldPointsNode)
+	for (auto&& field : cacheManager.getKeys()) {
+		getFieldData(field);
+	}
+}
+
+IAnyArray::ConstPtr VoxelDownsamplePointsNode::getFieldData(rgl_field_t field)
+{
+	std::lock_guard lock{getFieldDataMutex};
+
+	if (!cacheManager.contains(field)) {
+		auto fieldData = createArray<DeviceAsyncArray>(field, arrayMgr);
+		cacheManager.insert(field, fieldData, true);
+	}
+
+	if (!cacheManager.isLatest(field)) {
+		auto fieldData = cacheManager.getValue(field);
+		fieldData->resize(width, false, false);
+		if (width > 0) {
+			char* outPtr = static_cast<char*>(fieldData->getRawWritePtr());
+			auto sourceData = selectionSource->getFieldData(field);
+			if (!isDeviceAccessible(sourceData->getMemoryKind())) {
+				auto msg = fmt::format("VoxelDownsamplePointsNode requires device-accessible input, {} is not", field);
+				throw InvalidPipeline(msg);
+			}
+			const char* sourcePtr = static_cast<const char*>(sourceData->getRawReadPtr());
+			gpuFilter(getStreamHandle(), width, nullptr, selectionIndices->getReadPtr(), outPtr, sourcePtr,
+			          getFieldSize(field));
+			if (!graphRunCtx.value()->isThisThreadGraphThread()) {
+				// API asks for a field which was not computed in enqueueExecImpl; it won't wait for the graph stream.
+				CHECK_CUDA(cudaStreamSynchronize(getStreamHandle()));
+			}
+		}
+		cacheManager.setUpdated(field);
+	}
+
+	return std::const_pointer_cast<const IAnyArray>(cacheManager.getValue(field));
+}
+
+size_t VoxelDownsamplePointsNode::getWidth() const
+{
+	this->synchronize();
+	return width;
+}
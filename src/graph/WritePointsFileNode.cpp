@@ -0,0 +1,375 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include <graph/NodesCore.hpp>
+#include <graph/GraphRunCtx.hpp>
+#include <macros/handleDestructorException.hpp>
+#include <RGLFields.hpp>
+#include <ThreadConfig.hpp>
+
+namespace {
+
+// LAS 1.2 public header block and point data record format 0 (ASPRS LAS specification, version 1.2)
+#pragma pack(push, 1)
+struct LasHeader
+{
+	char fileSignature[4];
+	uint16_t fileSourceId;
+	uint16_t globalEncoding;
+	uint8_t projectId[16];
+	uint8_t versionMajor;
+	uint8_t versionMinor;
+	char systemIdentifier[32];
+	char generatingSoftware[32];
+	uint16_t creationDayOfYear;
+	uint16_t creationYear;
+	uint16_t headerSize;
+	uint32_t pointDataOffset;
+	uint32_t variableLengthRecordCount;
+	uint8_t pointDataFormat;
+	uint16_t pointDataRecordLength;
+	uint32_t pointCount;
+	uint32_t pointCountByReturn[5];
+	double scale[3];
+	double offset[3];
+	double maxX, minX, maxY, minY, maxZ, minZ;
+};
+
+struct LasPoint
+{
+	int32_t x, y, z;
+	uint16_t intensity;
+	uint8_t returnFlags;
+	uint8_t classification;
+	int8_t scanAngleRank;
+	uint8_t userData;
+	uint16_t pointSourceId;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(LasHeader) == 227);
+static_assert(sizeof(LasPoint) == 20);
+
+constexpr double LAS_SCALE = 0.001; // Millimeter resolution
+constexpr uint8_t LAS_SINGLE_RETURN_FLAGS = 0b00001001; // Return number 1 of 1
+constexpr uint8_t LAS_MAX_CLASSIFICATION = 31;
+
+const char* getFileExtension(rgl_point_file_format_t format)
+{
+	switch (format) {
+		case RGL_POINT_FILE_FORMAT_PCD: return "pcd";
+		case RGL_POINT_FILE_FORMAT_PLY: return "ply";
+		case RGL_POINT_FILE_FORMAT_LAS: return "las";
+	}
+	throw std::invalid_argument(fmt::format("unknown point file format {}", static_cast<int>(format)));
+}
+
+const char* getPlyType(char kind, std::size_t size)
+{
+	switch (size) {
+		case 1: return kind == 'I' ? "char" : "uchar";
+		case 2: return kind == 'I' ? "short" : "ushort";
+		case 4: return kind == 'F' ? "float" : (kind == 'I' ? "int" : "uint");
+		case 8: return "double";
+	}
+	throw std::invalid_argument(fmt::format("no PLY type for {}-byte '{}' component", size, kind));
+}
+
+std::string makePcdHeader(const std::vector<rgl_field_t>& layout, std::size_t width, std::size_t height)
+{
+	std::string names, sizes, types, counts;
+	for (auto&& field : layout) {
+		auto componentNames = getFieldComponentNames(field);
+		if (componentNames.empty()) {
+			// Padding is skipped by PCD readers if named "_"
+			names += " _";
+			sizes += " 1";
+			types += " U";
+			counts += fmt::format(" {}", getFieldSize(field));
+			continue;
+		}
+		std::size_t componentSize = getFieldSize(field) / componentNames.size();
+		for (auto&& name : componentNames) {
+			names += " " + name;
+			sizes += fmt::format(" {}", componentSize);
+			types += fmt::format(" {}", getFieldComponentKind(field));
+			counts += " 1";
+		}
+	}
+	return fmt::format("# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\nFIELDS{}\nSIZE{}\nTYPE{}\nCOUNT{}\n"
+	                   "WIDTH {}\nHEIGHT {}\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS {}\nDATA binary\n",
+	                   names, sizes, types, counts, width, height, width * height);
+}
+
+std::string makePlyHeader(const std::vector<rgl_field_t>& layout, std::size_t pointCount)
+{
+	std::string header = fmt::format("ply\nformat binary_little_endian 1.0\nelement vertex {}\n", pointCount);
+	std::size_t paddingCount = 0;
+	for (auto&& field : layout) {
+		auto componentNames = getFieldComponentNames(field);
+		if (componentNames.empty()) {
+			// PLY has no notion of padding, it is described by byte properties
+			for (std::size_t byte = 0; byte < getFieldSize(field); ++byte) {
+				header += fmt::format("property uchar _padding{}\n", paddingCount++);
+			}
+			continue;
+		}
+		const char* type = getPlyType(getFieldComponentKind(field), getFieldSize(field) / componentNames.size());
+		for (auto&& name : componentNames) {
+			header += fmt::format("property {} {}\n", type, name);
+		}
+	}
+	return header + "end_header\n";
+}
+
+std::vector<char> makeLasFile(const std::vector<rgl_field_t>& layout, const char* data, std::size_t pointCount)
+{
+	std::optional<std::size_t> xyzOffset, intensityOffset, classIdOffset;
+	std::size_t pointSize = 0;
+	for (auto&& field : layout) {
+		if (field == XYZ_VEC3_F32) {
+			xyzOffset = pointSize;
+		}
+		if (field == INTENSITY_F32) {
+			intensityOffset = pointSize;
+		}
+		if (field == CLASS_ID_U16) {
+			classIdOffset = pointSize;
+		}
+		pointSize += getFieldSize(field);
+	}
+
+	// Non-hits of unorganized point clouds have no meaningful position, they are skipped.
+	std::vector<std::size_t> finitePoints;
+	Vec3f min{std::numeric_limits<float>::max()}, max{std::numeric_limits<float>::lowest()};
+	for (std::size_t pointIdx = 0; pointIdx < pointCount; ++pointIdx) {
+		Field<XYZ_VEC3_F32>::type xyz;
+		std::memcpy(&xyz, data + pointIdx * pointSize + xyzOffset.value(), sizeof(xyz));
+		if (!std::isfinite(xyz.x()) || !std::isfinite(xyz.y()) || !std::isfinite(xyz.z())) {
+			continue;
+		}
+		finitePoints.push_back(pointIdx);
+		for (int axis = 0; axis < 3; ++axis) {
+			min[axis] = std::min(min[axis], xyz[axis]);
+			max[axis] = std::max(max[axis], xyz[axis]);
+		}
+	}
+	if (finitePoints.empty()) {
+		min = max = Vec3f{0.0f};
+	}
+
+	std::vector<char> file(sizeof(LasHeader) + finitePoints.size() * sizeof(LasPoint));
+	LasHeader header{};
+	std::memcpy(header.fileSignature, "LASF", sizeof(header.fileSignature));
+	header.versionMajor = 1;
+	header.versionMinor = 2;
+	std::strncpy(header.systemIdentifier, "SIMULATION", sizeof(header.systemIdentifier));
+	std::strncpy(header.generatingSoftware, "RobotecGPULidar", sizeof(header.generatingSoftware));
+	auto today = std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now());
+	std::chrono::year_month_day date{today};
+	std::chrono::sys_days firstDayOfYear{date.year() / std::chrono::January / 1};
+	header.creationDayOfYear = static_cast<uint16_t>((today - firstDayOfYear).count() + 1);
+	header.creationYear = static_cast<uint16_t>(static_cast<int>(date.year()));
+	header.headerSize = sizeof(LasHeader);
+	header.pointDataOffset = sizeof(LasHeader);
+	header.pointDataFormat = 0;
+	header.pointDataRecordLength = sizeof(LasPoint);
+	header.pointCount = static_cast<uint32_t>(finitePoints.size());
+	header.pointCountByReturn[0] = header.pointCount;
+	for (int axis = 0; axis < 3; ++axis) {
+		header.scale[axis] = LAS_SCALE;
+		header.offset[axis] = min[axis];
+	}
+	header.maxX = max.x(), header.minX = min.x();
+	header.maxY = max.y(), header.minY = min.y();
+	header.maxZ = max.z(), header.minZ = min.z();
+	std::memcpy(file.data(), &header, sizeof(header));
+
+	auto* records = file.data() + sizeof(LasHeader);
+	for (auto&& pointIdx : finitePoints) {
+		const char* point = data + pointIdx * pointSize;
+		Field<XYZ_VEC3_F32>::type xyz;
+		std::memcpy(&xyz, point + xyzOffset.value(), sizeof(xyz));
+		LasPoint record{};
+		record.x = static_cast<int32_t>(std::lround((xyz.x() - header.offset[0]) / LAS_SCALE));
+		record.y = static_cast<int32_t>(std::lround((xyz.y() - header.offset[1]) / LAS_SCALE));
+		record.z = static_cast<int32_t>(std::lround((xyz.z() - header.offset[2]) / LAS_SCALE));
+		if (intensityOffset.has_value()) {
+			Field<INTENSITY_F32>::type intensity;
+			std::memcpy(&intensity, point + intensityOffset.value(), sizeof(intensity));
+			record.intensity = static_cast<uint16_t>(std::lround(std::clamp(intensity, 0.0f, 65535.0f)));
+		}
+		if (classIdOffset.has_value()) {
+			Field<CLASS_ID_U16>::type classId;
+			std::memcpy(&classId, point + classIdOffset.value(), sizeof(classId));
+			record.classification = static_cast<uint8_t>(std::min<Field<CLASS_ID_U16>::type>(classId, LAS_MAX_CLASSIFICATION));
+		}
+		record.returnFlags = LAS_SINGLE_RETURN_FLAGS;
+		std::memcpy(records, &record, sizeof(record));
+		records += sizeof(record);
+	}
+	return file;
+}
+
+} // namespace
+
+void WritePointsFileNode::setParameters(const char* pathPrefix, rgl_point_file_format_t format)
+{
+	getFileExtension(format); // Validates format
+	this->pathPrefix = pathPrefix;
+	this->format = format;
+}
+
+void WritePointsFileNode::validateImpl()
+{
+	IPointsNodeSingleInput::validateImpl();
+	if (!input->hasField(RGL_FIELD_DYNAMIC_FORMAT)) {
+		auto msg = fmt::format("{} requires a formatted point cloud", getName());
+		throw InvalidPipeline(msg);
+	}
+	layout = input->getRequiredFieldList();
+	if (format == RGL_POINT_FILE_FORMAT_LAS && std::ranges::find(layout, XYZ_VEC3_F32) == layout.end()) {
+		auto msg = fmt::format("{} requires {} to be formatted to write LAS files", getName(), toString(XYZ_VEC3_F32));
+		throw InvalidPipeline(msg);
+	}
+}
+
+void WritePointsFileNode::enqueueExecImpl()
+{
+	HostPinnedArray<char>::Ptr staging = stagingBuffers.at(nextStagingBufferIdx);
+	nextStagingBufferIdx = (nextStagingBufferIdx + 1) % STAGING_BUFFER_COUNT;
+	{
+		std::unique_lock lock{mutex};
+		if (writeError != nullptr) {
+			std::rethrow_exception(std::exchange(writeError, nullptr));
+		}
+		// Held by this function, the array and, possibly, a pending job.
+		jobCompleted.wait(lock, [&]() { return staging.use_count() == 2; });
+	}
+
+	std::size_t size = input->getPointCount() * getPointSize(layout);
+	staging->resize(size, false, false);
+	auto fieldData = input->getFieldData(RGL_FIELD_DYNAMIC_FORMAT);
+	CHECK_CUDA(cudaMemcpyAsync(staging->getRawWritePtr(), fieldData->getRawReadPtr(), size, cudaMemcpyDefault,
+	                           getStreamHandle()));
+	CudaEvent::Ptr dataReady = CudaEvent::create();
+	CHECK_CUDA(cudaEventRecord(dataReady->getHandle(), getStreamHandle()));
+
+	WriteJob job{
+	    .path = fmt::format("{}{:06}.{}", pathPrefix, getGraphRunCtx()->getFrameId(), getFileExtension(format)),
+	    .format = format,
+	    .layout = layout,
+	    .width = input->getWidth(),
+	    .height = input->getHeight(),
+	    .dataReady = std::move(dataReady),
+	    .data = std::move(staging),
+	};
+	{
+		std::lock_guard lock{mutex};
+		if (!writer.joinable()) {
+			writer = std::thread(&WritePointsFileNode::writerMain, this);
+		}
+		pendingJobs.push_back(std::move(job));
+	}
+	jobSubmitted.notify_one();
+}
+
+void WritePointsFileNode::writerMain()
+{
+	ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-file-writer"};
+	CudaDevice::bindCurrentThread();
+	while (true) {
+		std::optional<WriteJob> job;
+		{
+			std::unique_lock lock{mutex};
+			jobSubmitted.wait(lock, [this]() { return !pendingJobs.empty() || isShutdownRequested; });
+			// Pending files are written before shutdown, so that they are complete once the node is destroyed.
+			if (pendingJobs.empty()) {
+				return;
+			}
+			job = std::move(pendingJobs.front());
+			pendingJobs.pop_front();
+		}
+		std::exception_ptr error = nullptr;
+		try {
+			CHECK_CUDA(cudaEventSynchronize(job->dataReady->getHandle()));
+			writeFile(*job);
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+		{
+			std::lock_guard lock{mutex};
+			job.reset(); // Releases the staging buffer
+			if (error != nullptr && writeError == nullptr) {
+				writeError = error;
+			}
+		}
+		jobCompleted.notify_all();
+	}
+}
+
+void WritePointsFileNode::writeFile(const WriteJob& job)
+{
+	std::string header;
+	std::vector<char> lasFile;
+	const char* body = job.data->getReadPtr();
+	std::size_t bodySize = job.data->getCount();
+	switch (job.format) {
+		case RGL_POINT_FILE_FORMAT_PCD: header = makePcdHeader(job.layout, job.width, job.height); break;
+		case RGL_POINT_FILE_FORMAT_PLY: header = makePlyHeader(job.layout, job.width * job.height); break;
+		case RGL_POINT_FILE_FORMAT_LAS:
+			lasFile = makeLasFile(job.layout, body, job.width * job.height);
+			body = lasFile.data();
+			bodySize = lasFile.size();
+			break;
+	}
+
+	std::FILE* file = std::fopen(job.path.c_str(), "wb");
+	if (file == nullptr) {
+		throw InvalidFilePath(fmt::format("could not open '{}' for writing: {}", job.path, std::strerror(errno)));
+	}
+	// Formatted point cloud is already in the binary layout of PCD and PLY, it is written at once, without copies.
+	bool isWritten = std::fwrite(header.data(), 1, header.size(), file) == header.size() &&
+	                 std::fwrite(body, 1, bodySize, file) == bodySize;
+	bool isClosed = std::fclose(file) == 0;
+	if (!isWritten || !isClosed) {
+		throw InvalidFilePath(fmt::format("could not write '{}': {}", job.path, std::strerror(errno)));
+	}
+}
+
+std::string WritePointsFileNode::getArgsString() const
+{
+	return fmt::format("pathPrefix={}, format={}", pathPrefix, getFileExtension(format));
+}
+
+WritePointsFileNode::~WritePointsFileNode()
+try {
+	{
+		std::lock_guard lock{mutex};
+		isShutdownRequested = true;
+	}
+	jobSubmitted.notify_all();
+	if (writer.joinable()) {
+		writer.join();
+	}
+}
+HANDLE_DESTRUCTOR_EXCEPTION
@@ -24,12 +24,37 @@ void YieldPointsNode::setParameters(const std::vector<rgl_field_t>& fields)
 
 void YieldPointsNode::enqueueExecImpl()
 {
+	std::size_t hostCacheSize = 0;
+	hostCacheRanges.clear();
 	for (auto&& field : fields) {
 		results[field] = input->getFieldData(field);
+		if (isDummy(field)) {
+			continue;
+		}
+		std::size_t fieldSize = results.at(field)->getCount() * results.at(field)->getSizeOf();
+		hostCacheRanges[field] = {hostCacheSize, fieldSize};
+		hostCacheSize += (fieldSize + HOST_CACHE_ALIGNMENT - 1) / HOST_CACHE_ALIGNMENT * HOST_CACHE_ALIGNMENT;
 	}
-	if (results.contains(XYZ_VEC3_F32)) {
-		xyzHostCache->resize(results.at(XYZ_VEC3_F32)->getCount(), false, false);
-		CHECK_CUDA(cudaMemcpyAsync(xyzHostCache->getWritePtr(), results[XYZ_VEC3_F32]->getRawReadPtr(),
-		                           xyzHostCache->getCount() * xyzHostCache->getSizeOf(), cudaMemcpyDefault, getStreamHandle()));
+	hostCache->resize(hostCacheSize, false, false);
+	for (auto&& [field, range] : hostCacheRanges) {
+		CHECK_CUDA(cudaMemcpyAsync(hostCache->getWritePtr() + range.first, results.at(field)->getRawReadPtr(), range.second,
+		                           cudaMemcpyDefault, getStreamHandle()));
 	}
 }
+
+const void* YieldPointsNode::getHostCache(rgl_field_t field) const
+{
+	auto it = hostCacheRanges.find(field);
+	return it != hostCacheRanges.end() ? hostCache->getReadPtr() + it->second.first : nullptr;
+}
+
+void YieldPointsNode::reserveArrays(std::size_t maxPointCount)
+{
+	std::size_t maxHostCacheSize = 0;
+	for (auto&& field : fields) {
+		if (!isDummy(field)) {
+			maxHostCacheSize += getFieldSize(field) * maxPointCount + HOST_CACHE_ALIGNMENT;
+		}
+	}
+	hostCache->reserve(maxHostCacheSize, true);
+}
@@ -19,6 +19,7 @@
 #include <iterator>
 #include <array>
 #include <cmath>
+#include <cstdint>
 
 #include <macros/cuda.hpp>
 #include <macros/iteration.hpp>
@@ -233,6 +234,9 @@ using Vec2i = Vector<2, int>;
 using Vec3i = Vector<3, int>;
 using Vec4i = Vector<4, int>;
 
+using Vec3i16 = Vector<3, int16_t>;
+using Vec3u16 = Vector<3, uint16_t>; // Also bits of half-precision floats
+
 static_assert(std::is_trivially_copyable_v<Vec2f>);
 static_assert(std::is_trivially_copyable_v<Vec3f>);
 static_assert(std::is_trivially_copyable_v<Vec4f>);
@@ -19,6 +19,7 @@
 
 #include <typingUtils.hpp>
 #include <CudaStream.hpp>
+#include <PerformanceCounters.hpp>
 
 #include <memory/IAnyArray.hpp>
 #include <memory/InvalidArrayCast.hpp>
@@ -58,16 +59,27 @@ struct Array : public IAnyArray
 	std::size_t getCount() const override { return count; }
 	std::size_t getSizeOf() const override { return sizeof(T); }
 	std::size_t getCapacity() const override { return capacity; }
+	std::size_t getPeakCapacity() const override { return peakCapacity; }
 
 	void resize(std::size_t newCount, bool zeroInit, bool preserveData) override;
 	void reserve(std::size_t newCapacity, bool preserveData) override;
 	void clear(bool zero) override;
+	void release() override;
 
 	void copyFromExternal(const T* src, size_t srcCount);
 
 protected:
+	// Capacity is released if the count stayed at most 1/RELEASE_CAPACITY_RATIO of it for RELEASE_WINDOW_RESIZE_COUNT resizes
+	static constexpr std::size_t RELEASE_WINDOW_RESIZE_COUNT = 64;
+	static constexpr std::size_t RELEASE_CAPACITY_RATIO = 4;
+
+	void reallocate(std::size_t newCapacity, bool preserveData);
+
 	std::size_t count = {0};
 	std::size_t capacity = {0};
+	std::size_t peakCapacity = {0};
+	std::size_t releaseWindowResizeCount = {0};
+	std::size_t releaseWindowMaxCount = {0};
 	DataType* data = {nullptr};
 	MemoryOperations memOps;
 
@@ -83,4 +95,5 @@ protected:
 #include <memory/DeviceArray.inl>
 #include <memory/DeviceSyncArray.inl>
 #include <memory/DeviceAsyncArray.inl>
+#include <memory/DeviceManagedArray.inl>
 #include <memory/ArrayImpl.inl>
@@ -0,0 +1,67 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <macros/cuda.hpp>
+#include <memory/ArrayCopyBatch.hpp>
+
+void ArrayCopyBatch::add(void* dst, const void* src, std::size_t bytes)
+{
+	if (bytes == 0) {
+		return;
+	}
+	// Transfers continuing the previous one (e.g. fields laid out one after another on both sides) are coalesced.
+	if (!dsts.empty() && static_cast<char*>(dsts.back()) + sizes.back() == dst &&
+	    static_cast<char*>(srcs.back()) + sizes.back() == src) {
+		sizes.back() += bytes;
+		return;
+	}
+	dsts.emplace_back(dst);
+	srcs.emplace_back(const_cast<void*>(src));
+	sizes.emplace_back(bytes);
+}
+
+void ArrayCopyBatch::execute()
+{
+	if (dsts.empty()) {
+		return;
+	}
+	bool isBatched = false;
+#if CUDART_VERSION >= 12080
+	// Batched copies are not supported in the legacy null stream.
+	if (dsts.size() > 1 && stream->getHandle() != nullptr) {
+		cudaMemcpyAttributes attributes{};
+		attributes.srcAccessOrder = cudaMemcpySrcAccessOrderStream;
+		attributes.flags = cudaMemcpyFlagPreferOverlapWithCompute;
+		std::size_t attributesIdx = 0;
+#if CUDART_VERSION >= 13000
+		CHECK_CUDA(cudaMemcpyBatchAsync(dsts.data(), srcs.data(), sizes.data(), dsts.size(), &attributes, &attributesIdx, 1,
+		                                stream->getHandle()));
+#else
+		std::size_t failIdx = 0;
+		CHECK_CUDA(cudaMemcpyBatchAsync(dsts.data(), srcs.data(), sizes.data(), dsts.size(), &attributes, &attributesIdx, 1,
+		                                &failIdx, stream->getHandle()));
+#endif
+		isBatched = true;
+	}
+#endif
+	if (!isBatched) {
+		for (std::size_t i = 0; i < dsts.size(); ++i) {
+			CHECK_CUDA(cudaMemcpyAsync(dsts[i], srcs[i], sizes[i], cudaMemcpyDefault, stream->getHandle()));
+		}
+	}
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+	dsts.clear();
+	srcs.clear();
+	sizes.clear();
+}
@@ -0,0 +1,57 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include <cuda_runtime.h>
+
+#include <memory/Array.hpp>
+#include <CudaStream.hpp>
+
+/**
+ * Collects copies to many (usually small) arrays and performs them as a batch on a single stream.
+ * Transfers are enqueued together (with cudaMemcpyBatchAsync, if available), adjacent ones are coalesced,
+ * and the stream is synchronized once, instead of once per array, as in Array::copyFromExternal.
+ * Destination arrays are resized when the copy is added; their data is valid after execute().
+ */
+struct ArrayCopyBatch
+{
+	explicit ArrayCopyBatch(CudaStream::Ptr stream) : stream(std::move(stream)) {}
+
+	/**
+	 * Replaces data of dst with srcCount elements from src (either host or device memory).
+	 * Source memory must stay valid until execute() returns.
+	 */
+	template<typename T>
+	void copyFromExternal(const typename Array<T>::Ptr& dst, const T* src, std::size_t srcCount)
+	{
+		dst->resize(srcCount, false, false);
+		add(dst->getRawWritePtr(), src, srcCount * sizeof(T));
+	}
+
+	/**
+	 * Enqueues all collected copies and waits for their completion.
+	 */
+	void execute();
+
+private:
+	void add(void* dst, const void* src, std::size_t bytes);
+
+	CudaStream::Ptr stream;
+	std::vector<void*> dsts;
+	std::vector<void*> srcs;
+	std::vector<std::size_t> sizes;
+};
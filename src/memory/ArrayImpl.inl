@@ -1,12 +1,14 @@
 #pragma once
 
+#include <algorithm>
+
 #include <memory/Array.hpp>
 #include <macros/handleDestructorException.hpp>
 
 template<typename T>
 Array<T>::~Array() try {
 	if (data != nullptr) {
-		memOps.deallocate(data);
+		memOps.deallocate(data, sizeof(T) * capacity);
 		data = reinterpret_cast<T*>(0x0000DEAD);
 	}
 }
@@ -18,6 +20,7 @@ void Array<T>::copyFromExternal(const T *src, size_t srcCount) {
 
 	if (isHost(this->getMemoryKind())) {
 		memcpy(this->data, src, srcCount * sizeof(T));
+		PerformanceCounters::instance().addTransfer(true, true, srcCount * sizeof(T));
 		return;
 	}
 
@@ -27,6 +30,8 @@ void Array<T>::copyFromExternal(const T *src, size_t srcCount) {
 	                             : CudaStream::getNullStream();
 	CHECK_CUDA(cudaMemcpyAsync(this->getRawWritePtr(), src, srcCount * sizeof(T), cudaMemcpyDefault, copyStream->getHandle()));
 	CHECK_CUDA(cudaStreamSynchronize(copyStream->getHandle()));
+	// External data are passed to API calls from the host.
+	PerformanceCounters::instance().addTransfer(true, false, srcCount * sizeof(T));
 }
 
 template<typename T>
@@ -42,6 +47,13 @@ void Array<T>::clear(bool zero) {
 	count = 0;
 }
 
+template<typename T>
+void Array<T>::release() {
+	reallocate(0, false);
+	releaseWindowResizeCount = 0;
+	releaseWindowMaxCount = 0;
+}
+
 template<typename T>
 void Array<T>::reserve(std::size_t newCapacity, bool preserveData) {
 	if (!preserveData) {
@@ -52,24 +64,47 @@ void Array<T>::reserve(std::size_t newCapacity, bool preserveData) {
 		return;
 	}
 
-	T* newMem = reinterpret_cast<T*>(memOps.allocate(sizeof(T) * newCapacity));
+	reallocate(newCapacity, preserveData);
+}
 
-	if (preserveData && data != nullptr) {
+template<typename T>
+void Array<T>::reallocate(std::size_t newCapacity, bool preserveData) {
+	T* newMem = newCapacity > 0 ? reinterpret_cast<T*>(memOps.allocate(sizeof(T) * newCapacity)) : nullptr;
+	if (newCapacity > 0) {
+		PerformanceCounters::instance().arrayAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	count = preserveData ? std::min(count, newCapacity) : 0;
+	if (count > 0 && data != nullptr) {
 		memOps.copy(newMem, data, sizeof(T) * count);
 	}
 
 	if (data != nullptr) {
-		memOps.deallocate(data);
+		memOps.deallocate(data, sizeof(T) * capacity);
 	}
 
 	data = newMem;
 	capacity = newCapacity;
+	peakCapacity = std::max(peakCapacity, capacity);
 }
 
 template<typename T>
 void Array<T>::resize(std::size_t newCount, bool zeroInit, bool preserveData) {
-	// Ensure capacity
-	reserve(newCount, preserveData);
+	// Ensure capacity; grow geometrically, so that slowly growing (or fluctuating) arrays reach steady state quickly
+	std::size_t newCapacity = newCount > capacity ? std::max(newCount, capacity + capacity / 2) : newCount;
+	reserve(newCapacity, preserveData);
+
+	// Capacity is kept while counts fluctuate; it is released only if all counts in a window of resizes were much smaller.
+	// Resizes preserving data (e.g. trimming to the count known after the job) do not release it to avoid copying.
+	releaseWindowMaxCount = std::max(releaseWindowMaxCount, newCount);
+	if (++releaseWindowResizeCount >= RELEASE_WINDOW_RESIZE_COUNT && !preserveData) {
+		if (releaseWindowMaxCount * RELEASE_CAPACITY_RATIO <= capacity) {
+			reallocate(releaseWindowMaxCount + releaseWindowMaxCount / 2, false);
+			capacityReleaseCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		releaseWindowResizeCount = 0;
+		releaseWindowMaxCount = 0;
+	}
 
 	// Clear expanded part
 	if (newCount >= count && zeroInit) {
@@ -0,0 +1,87 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdexcept>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <macros/cuda.hpp>
+#include <memory/DeviceArena.hpp>
+#include <CudaDevice.hpp>
+
+DeviceArena& DeviceArena::instance()
+{
+	// Never destroyed: arrays may be freed during static destruction, after the arena would have been destroyed.
+	static DeviceArena* arena = new DeviceArena();
+	return *arena;
+}
+
+std::size_t DeviceArena::getSizeClass(std::size_t bytes)
+{
+	std::size_t sizeClass = 0;
+	while ((MIN_BLOCK_SIZE << sizeClass) < bytes) {
+		sizeClass += 1;
+	}
+	return sizeClass;
+}
+
+void* DeviceArena::allocate(std::size_t bytes, cudaStream_t stream)
+{
+	if (!isSuballocated(bytes)) {
+		auto msg = fmt::format("requested {} bytes from device arena, which serves at most {} bytes", bytes, MAX_BLOCK_SIZE);
+		throw std::invalid_argument(msg);
+	}
+	std::size_t sizeClass = getSizeClass(bytes);
+	std::scoped_lock lock(mutex);
+
+	void* block = nullptr;
+	if (auto it = freeBlocks.find({stream, sizeClass}); it != freeBlocks.end() && !it->second.empty()) {
+		block = it->second.back();
+		it->second.pop_back();
+	}
+	else {
+		std::size_t blockSize = MIN_BLOCK_SIZE << sizeClass;
+		if (slabOffset + blockSize > SLAB_SIZE) {
+			// Synchronous allocation, so that the slab is immediately valid on every stream.
+			void* slab = nullptr;
+			CudaDevice::markInUse();
+			CHECK_CUDA(cudaMalloc(&slab, SLAB_SIZE));
+			slabs.emplace_back(static_cast<char*>(slab));
+			slabOffset = 0;
+		}
+		// Blocks are power-of-two sized and carved in arbitrary order, so only MIN_BLOCK_SIZE alignment is guaranteed.
+		block = slabs.back() + slabOffset;
+		slabOffset += blockSize;
+	}
+	liveBlockSizeClasses.emplace(block, sizeClass);
+	return block;
+}
+
+bool DeviceArena::deallocate(void* ptr, cudaStream_t stream)
+{
+	std::scoped_lock lock(mutex);
+	auto it = liveBlockSizeClasses.find(ptr);
+	if (it == liveBlockSizeClasses.end()) {
+		return false;
+	}
+	freeBlocks[{stream, it->second}].emplace_back(ptr);
+	liveBlockSizeClasses.erase(it);
+	return true;
+}
+
+uint64_t DeviceArena::getSlabCount() const
+{
+	std::scoped_lock lock(mutex);
+	return slabs.size();
+}
@@ -0,0 +1,72 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cuda_runtime.h>
+
+/**
+ * Suballocator for small DeviceAsync arrays (e.g. single-element ranges, request contexts, field descriptors).
+ * Blocks are carved from large slabs and rounded up to power-of-two size classes.
+ * Freed blocks are kept on a per-stream free list and reused only by allocations on the same stream,
+ * which gives the same ordering guarantees as cudaFreeAsync / cudaMallocAsync.
+ * Slabs are never returned, so steady-state frames do not call the CUDA allocator for small arrays at all.
+ */
+struct DeviceArena
+{
+	static constexpr std::size_t MIN_BLOCK_SIZE = 256; // Same alignment as cudaMalloc
+	static constexpr std::size_t MAX_BLOCK_SIZE = 64 * 1024;
+	static constexpr std::size_t SLAB_SIZE = 4 * 1024 * 1024;
+
+	static DeviceArena& instance();
+
+	static bool isSuballocated(std::size_t bytes) { return bytes > 0 && bytes <= MAX_BLOCK_SIZE; }
+
+	/**
+	 * Returns a block of at least the given size, usable in stream order on the given stream.
+	 * Size must satisfy isSuballocated().
+	 */
+	void* allocate(std::size_t bytes, cudaStream_t stream);
+
+	/**
+	 * Returns block to the arena, if it was allocated from it.
+	 * @return false if the pointer does not come from the arena.
+	 */
+	bool deallocate(void* ptr, cudaStream_t stream);
+
+	uint64_t getSlabCount() const;
+
+	DeviceArena(const DeviceArena&) = delete;
+	DeviceArena(DeviceArena&&) = delete;
+	DeviceArena& operator=(const DeviceArena&) = delete;
+	DeviceArena& operator=(DeviceArena&&) = delete;
+
+private:
+	DeviceArena() = default;
+
+	static std::size_t getSizeClass(std::size_t bytes);
+
+	mutable std::mutex mutex;
+	std::vector<char*> slabs;
+	std::size_t slabOffset{SLAB_SIZE}; // Offset of the unused part of the last slab
+	std::unordered_map<void*, std::size_t> liveBlockSizeClasses;
+	std::map<std::pair<cudaStream_t, std::size_t>, std::vector<void*>> freeBlocks;
+};
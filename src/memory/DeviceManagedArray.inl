@@ -0,0 +1,78 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <IStreamBound.hpp>
+#include <StreamBoundObjectsManager.hpp>
+
+/**
+ * Array in unified memory, for working sets that may not fit in device memory (e.g. long accumulations of points).
+ * Memory prefers to reside on the device; pages not prefetched before use are migrated on access (page faults).
+ * @tparam T See base class
+ */
+template <typename T>
+struct DeviceManagedArray : public DeviceArray<T>, public IStreamBound
+{
+	using Ptr = std::shared_ptr<DeviceManagedArray<T>>;
+	using ConstPtr = std::shared_ptr<const DeviceManagedArray<T>>;
+
+	CudaStream::Ptr getStream() const override { return stream; }
+
+	void setStream(CudaStream::Ptr newStream) override
+	{
+		this->memOps = MemoryOperations::get<MemoryKind::DeviceManaged>(newStream);
+		this->stream = newStream;
+	}
+
+	MemoryKind getMemoryKind() const override { return MemoryKind::DeviceManaged; }
+
+	/**
+	 * Migrates elements [offset, offset + count) to the device in the array's stream, ahead of their use there.
+	 */
+	void prefetchToDevice(std::size_t offset, std::size_t count) const { prefetch(offset, count, false); }
+
+	/**
+	 * Migrates elements [offset, offset + count) to the host in the array's stream, e.g. to free device memory.
+	 */
+	void prefetchToHost(std::size_t offset, std::size_t count) const { prefetch(offset, count, true); }
+
+	static DeviceManagedArray<T>::Ptr create(StreamBoundObjectsManager& manager)
+	{
+		auto array = create(manager.getStream());
+		manager.registerObject(array);
+		return array;
+	}
+
+	static DeviceManagedArray<T>::Ptr create(CudaStream::Ptr stream)
+	{
+		return DeviceManagedArray<T>::Ptr(new DeviceManagedArray(stream));
+	}
+
+protected:
+	using DeviceArray<T>::DeviceArray;
+	DeviceManagedArray(CudaStream::Ptr streamArg)
+	  : DeviceArray<T>(MemoryOperations::get<MemoryKind::DeviceManaged>(streamArg))
+	  , stream(streamArg) {}
+
+	void prefetch(std::size_t offset, std::size_t count, bool toHost) const
+	{
+		count = std::min(count, this->count - std::min(offset, this->count));
+		MemoryKindOperations<MemoryKind::DeviceManaged>::prefetch(this->data + offset, count * sizeof(T), toHost,
+		                                                          stream->getHandle());
+	}
+
+protected:
+	CudaStream::Ptr stream; // Needed to implement IStreamBound
+};
@@ -0,0 +1,69 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <limits>
+
+#include <macros/cuda.hpp>
+#include <memory/DeviceMemoryPool.hpp>
+#include <CudaStream.hpp>
+#include <CudaDevice.hpp>
+
+DeviceMemoryPool& DeviceMemoryPool::instance()
+{
+	// Never destroyed: arrays may be freed during static destruction, after the pool would have been destroyed.
+	static DeviceMemoryPool* memoryPool = new DeviceMemoryPool();
+	return *memoryPool;
+}
+
+DeviceMemoryPool::DeviceMemoryPool()
+{
+	CudaDevice::markInUse();
+	int device = CudaDevice::getSelected();
+	cudaMemPoolProps props = {
+	    .allocType = cudaMemAllocationTypePinned,
+	    .handleTypes = cudaMemHandleTypeNone,
+	    .location = {.type = cudaMemLocationTypeDevice, .id = device},
+	};
+	CHECK_CUDA(cudaMemPoolCreate(&pool, &props));
+	configure(std::numeric_limits<uint64_t>::max(), 0);
+}
+
+void DeviceMemoryPool::configure(uint64_t releaseThreshold, uint64_t reservedSize)
+{
+	CHECK_CUDA(cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &releaseThreshold));
+	if (reservedSize == 0) {
+		return;
+	}
+	// Memory freed to the pool stays there as long as the release threshold is not exceeded.
+	void* ptr = nullptr;
+	cudaStream_t stream = CudaStream::getCopyStream()->getHandle();
+	CHECK_CUDA(cudaMallocFromPoolAsync(&ptr, reservedSize, pool, stream));
+	CHECK_CUDA(cudaFreeAsync(ptr, stream));
+	CHECK_CUDA(cudaStreamSynchronize(stream));
+}
+
+void* DeviceMemoryPool::allocateAsync(std::size_t bytes, cudaStream_t stream)
+{
+	void* ptr = nullptr;
+	CHECK_CUDA(cudaMallocFromPoolAsync(&ptr, bytes, pool, stream));
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return ptr;
+}
+
+uint64_t DeviceMemoryPool::getAttribute(cudaMemPoolAttr attribute) const
+{
+	uint64_t value = 0;
+	CHECK_CUDA(cudaMemPoolGetAttribute(pool, attribute, &value));
+	return value;
+}
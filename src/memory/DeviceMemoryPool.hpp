@@ -0,0 +1,59 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <cuda_runtime.h>
+
+/**
+ * Stream-ordered memory pool used by all DeviceAsync arrays.
+ * Unlike the default pool, by default it never releases memory back to the OS on synchronization,
+ * so that steady-state frames (with no growth of buffers) are served from the pool without driver allocations.
+ */
+struct DeviceMemoryPool
+{
+	static DeviceMemoryPool& instance();
+
+	/**
+	 * Sets the amount of unused memory the pool keeps on synchronization (the rest is released to the OS)
+	 * and pre-allocates (reserves) the given amount of memory in the pool.
+	 */
+	void configure(uint64_t releaseThreshold, uint64_t reservedSize);
+
+	void* allocateAsync(std::size_t bytes, cudaStream_t stream);
+
+	uint64_t getReservedBytes() const { return getAttribute(cudaMemPoolAttrReservedMemCurrent); }
+	uint64_t getUsedBytes() const { return getAttribute(cudaMemPoolAttrUsedMemCurrent); }
+
+	/**
+	 * Returns the number of allocations made from the pool since its creation.
+	 */
+	uint64_t getAllocationCount() const { return allocationCount.load(std::memory_order_relaxed); }
+
+	DeviceMemoryPool(const DeviceMemoryPool&) = delete;
+	DeviceMemoryPool(DeviceMemoryPool&&) = delete;
+	DeviceMemoryPool& operator=(const DeviceMemoryPool&) = delete;
+	DeviceMemoryPool& operator=(DeviceMemoryPool&&) = delete;
+
+private:
+	DeviceMemoryPool();
+
+	uint64_t getAttribute(cudaMemPoolAttr attribute) const;
+
+	cudaMemPool_t pool{nullptr};
+	std::atomic<uint64_t> allocationCount{0};
+};
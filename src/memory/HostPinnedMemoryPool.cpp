@@ -0,0 +1,125 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <macros/cuda.hpp>
+#include <memory/HostPinnedMemoryPool.hpp>
+#include <CudaDevice.hpp>
+
+HostPinnedMemoryPool& HostPinnedMemoryPool::instance()
+{
+	// Never destroyed: arrays may be freed during static destruction, after the pool would have been destroyed.
+	static HostPinnedMemoryPool* memoryPool = new HostPinnedMemoryPool();
+	return *memoryPool;
+}
+
+std::size_t HostPinnedMemoryPool::getSizeClass(std::size_t bytes)
+{
+	std::size_t sizeClass = 0;
+	while (getBlockSize(sizeClass) < bytes) {
+		sizeClass += 1;
+	}
+	return sizeClass;
+}
+
+void HostPinnedMemoryPool::configure(uint64_t maxCachedBytes)
+{
+	std::scoped_lock lock(mutex);
+	this->maxCachedBytes = maxCachedBytes;
+	releaseExcess();
+}
+
+void* HostPinnedMemoryPool::allocate(std::size_t bytes)
+{
+	std::size_t sizeClass = getSizeClass(bytes);
+	std::size_t blockSize = getBlockSize(sizeClass);
+	{
+		std::scoped_lock lock(mutex);
+		if (freeBlocks[sizeClass].empty() && !pendingBlocks[sizeClass].empty()) {
+			// Pending copies to or from all freed blocks are completed after that, so all of them can be reused.
+			CHECK_CUDA(cudaDeviceSynchronize());
+			for (auto&& [pendingSizeClass, blocks] : pendingBlocks) {
+				auto& ready = freeBlocks[pendingSizeClass];
+				ready.insert(ready.end(), blocks.begin(), blocks.end());
+				blocks.clear();
+			}
+		}
+		if (auto& ready = freeBlocks[sizeClass]; !ready.empty()) {
+			void* block = ready.back();
+			ready.pop_back();
+			cachedBytes -= blockSize;
+			usedBytes += blockSize;
+			liveBlockSizeClasses.emplace(block, sizeClass);
+			return block;
+		}
+	}
+
+	// Page-locking takes long, so other threads are not blocked meanwhile.
+	void* block = nullptr;
+	CudaDevice::markInUse();
+	CHECK_CUDA(cudaMallocHost(&block, blockSize));
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	std::scoped_lock lock(mutex);
+	usedBytes += blockSize;
+	liveBlockSizeClasses.emplace(block, sizeClass);
+	return block;
+}
+
+void HostPinnedMemoryPool::deallocate(void* ptr)
+{
+	std::scoped_lock lock(mutex);
+	auto it = liveBlockSizeClasses.find(ptr);
+	if (it == liveBlockSizeClasses.end()) {
+		// Called from destructors, hence not throwing; memory page-locked elsewhere is released directly.
+		CHECK_CUDA_NO_THROW(cudaFreeHost(ptr));
+		return;
+	}
+	std::size_t blockSize = getBlockSize(it->second);
+	usedBytes -= blockSize;
+	if (cachedBytes + blockSize > maxCachedBytes) {
+		// Synchronizes the device, hence pending copies of the block complete before it is released.
+		CHECK_CUDA(cudaFreeHost(ptr));
+	}
+	else {
+		pendingBlocks[it->second].emplace_back(ptr);
+		cachedBytes += blockSize;
+	}
+	liveBlockSizeClasses.erase(it);
+}
+
+void HostPinnedMemoryPool::releaseExcess()
+{
+	// Largest blocks are released first, as they are the least likely to be requested again.
+	for (auto* blocksBySizeClass : {&freeBlocks, &pendingBlocks}) {
+		for (auto it = blocksBySizeClass->rbegin(); it != blocksBySizeClass->rend() && cachedBytes > maxCachedBytes; ++it) {
+			auto& [sizeClass, blocks] = *it;
+			while (!blocks.empty() && cachedBytes > maxCachedBytes) {
+				CHECK_CUDA(cudaFreeHost(blocks.back()));
+				blocks.pop_back();
+				cachedBytes -= getBlockSize(sizeClass);
+			}
+		}
+	}
+}
+
+uint64_t HostPinnedMemoryPool::getCachedBytes() const
+{
+	std::scoped_lock lock(mutex);
+	return cachedBytes;
+}
+
+uint64_t HostPinnedMemoryPool::getUsedBytes() const
+{
+	std::scoped_lock lock(mutex);
+	return usedBytes;
+}
@@ -0,0 +1,75 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Pool of page-locked host memory used by all HostPinned arrays.
+ * Page-locking (cudaMallocHost) is expensive and serializes against other CUDA calls, so freed blocks are kept
+ * in power-of-two size classes and handed out again, as long as the cached amount does not exceed the configured limit.
+ * Freed blocks may still be targets of pending copies; unlike cudaFreeHost, deallocation does not synchronize the device.
+ * Therefore, blocks freed since the last synchronization are reused only after the device is synchronized once (in a batch),
+ * which is much cheaper than page-locking new memory.
+ */
+struct HostPinnedMemoryPool
+{
+	static constexpr std::size_t MIN_BLOCK_SIZE = 4 * 1024; // Page size
+	static constexpr uint64_t DEFAULT_MAX_CACHED_BYTES = 256 * 1024 * 1024;
+
+	static HostPinnedMemoryPool& instance();
+
+	/**
+	 * Sets the amount of freed memory the pool may keep; the excess is released immediately.
+	 */
+	void configure(uint64_t maxCachedBytes);
+
+	void* allocate(std::size_t bytes);
+	void deallocate(void* ptr);
+
+	uint64_t getCachedBytes() const;
+	uint64_t getUsedBytes() const;
+
+	/**
+	 * Returns the number of blocks page-locked by the pool since its creation.
+	 */
+	uint64_t getAllocationCount() const { return allocationCount.load(std::memory_order_relaxed); }
+
+	HostPinnedMemoryPool(const HostPinnedMemoryPool&) = delete;
+	HostPinnedMemoryPool(HostPinnedMemoryPool&&) = delete;
+	HostPinnedMemoryPool& operator=(const HostPinnedMemoryPool&) = delete;
+	HostPinnedMemoryPool& operator=(HostPinnedMemoryPool&&) = delete;
+
+private:
+	HostPinnedMemoryPool() = default;
+
+	static std::size_t getSizeClass(std::size_t bytes);
+	static std::size_t getBlockSize(std::size_t sizeClass) { return MIN_BLOCK_SIZE << sizeClass; }
+	void releaseExcess();
+
+	mutable std::mutex mutex;
+	uint64_t maxCachedBytes{DEFAULT_MAX_CACHED_BYTES};
+	uint64_t cachedBytes{0}; // Of both free and pending blocks
+	uint64_t usedBytes{0};
+	std::atomic<uint64_t> allocationCount{0};
+	std::unordered_map<void*, std::size_t> liveBlockSizeClasses;
+	std::map<std::size_t, std::vector<void*>> freeBlocks;    // Ready for reuse
+	std::map<std::size_t, std::vector<void*>> pendingBlocks; // Freed since the last synchronization of the device
+};
@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <typeindex>
 
 #include <memory/MemoryKind.hpp>
 #include <memory/InvalidArrayCast.hpp>
 #include <IStreamBound.hpp>
+#include <PerformanceCounters.hpp>
 #include <typingUtils.hpp>
 
 template<typename T>
@@ -89,13 +92,20 @@ struct IAnyArray : public std::enable_shared_from_this<IAnyArray>
 	 */
 	virtual std::size_t getCapacity() const = 0;
 
+	/**
+	 * @return Maximal capacity the array has had (high-water mark), in elements.
+	 */
+	virtual std::size_t getPeakCapacity() const = 0;
+
 	/**
 	 * @return Size in bytes of each array element.
 	 */
 	virtual std::size_t getSizeOf() const = 0;
 
 	/**
-	 * Expands or shrinks the array, possibly erasing existing elements. It does not reduce capacity.
+	 * Expands or shrinks the array, possibly erasing existing elements.
+	 * Capacity grows geometrically and is reduced only if the array stayed much smaller for many resizes discarding data,
+	 * so that fluctuating sizes do not cause reallocations (see Array::resize). Resizes preserving data never reduce it.
 	 * @param newCount Desired element count after operation.
 	 * @param zeroInit If true, elements will be zero-initialized. Otherwise, elements may have garbage values.
 	 * @param preserveData If false, resize will skip copying old data as an optimization.
@@ -116,6 +126,12 @@ struct IAnyArray : public std::enable_shared_from_this<IAnyArray>
 	 */
 	virtual void clear(bool zero) = 0;
 
+	/**
+	 * Removes all elements and frees the allocation. Stream-bound arrays return their memory in stream order,
+	 * so that it can be reused by allocations enqueued later in the stream. The array may be resized again afterwards.
+	 */
+	virtual void release() = 0;
+
 	/**
 	 * Replaces current data with data from src.
 	 */
@@ -141,26 +157,24 @@ struct IAnyArray : public std::enable_shared_from_this<IAnyArray>
 		if (this->typeIndex != src->typeIndex) {
 			throw std::runtime_error("attempted to append from Arrays with different data type");
 		}
-		std::size_t n = this->getCount() + src->getCount();
-		// Find next power of 2
-		n -= 1;
-		n |= n >> 1;
-		n |= n >> 2;
-		n |= n >> 4;
-		n |= n >> 8;
-		n |= n >> 16;
-		n |= n >> 32;
-		n += 1;
-		this->reserve(n, true);
+		// Capacity grows geometrically in resize, like for any other growing array
 		this->resize(this->getCount() + src->getCount(), false, true);
 		this->insertAt(src, this->getCount() - src->getCount());
 	}
 
+	/**
+	 * @return Number of times any array released its capacity, so that its data pointer changed without a resize up.
+	 * Holders of raw pointers to arrays of unchanged sizes (e.g. captured CUDA graphs) must refresh them when it changes.
+	 */
+	static uint64_t getCapacityReleaseCount() { return capacityReleaseCount.load(std::memory_order_relaxed); }
+
 	virtual ~IAnyArray() = default;
 
 protected:
 	IAnyArray(std::type_index typeIndex) : typeIndex(typeIndex) {}
 
+	static inline std::atomic<uint64_t> capacityReleaseCount{0};
+
 private:
 	void insertAt(IAnyArray::ConstPtr src, std::size_t skipCount)
 	{
@@ -172,6 +186,7 @@ private:
 		// Standard memcpy is faster + avoids the overhead of cudaMemcpy*
 		if (isHost(this->getMemoryKind()) && isHost(src->getMemoryKind())) {
 			memcpy(writePtr, src->getRawReadPtr(), byteCount);
+			PerformanceCounters::instance().addTransfer(true, true, byteCount);
 			return;
 		}
 
@@ -189,6 +204,7 @@ private:
 		                                                         CudaStream::getNullStream();
 		CHECK_CUDA(cudaMemcpyAsync(writePtr, src->getRawReadPtr(), byteCount, cudaMemcpyDefault, copyStream->getHandle()));
 		CHECK_CUDA(cudaStreamSynchronize(copyStream->getHandle()));
+		PerformanceCounters::instance().addTransfer(isHost(src->getMemoryKind()), isHost(this->getMemoryKind()), byteCount);
 	}
 
 	std::type_index typeIndex;
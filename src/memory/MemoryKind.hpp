@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 /** Enumerates kinds of CUDA memory used in RGL. @see MemoryOperations */
 enum struct MemoryKind
 {
@@ -39,8 +41,17 @@ enum struct MemoryKind
 	 * Operations on this type of memory happen in the CUDA null stream.
 	 */
 	HostPinned,
+
+	/**
+	 * Unified memory allocated with cudaMallocManaged, accessible from the device and the host.
+	 * Pages migrate on demand (or when prefetched), so arrays may exceed device memory at the cost of migration.
+	 * Operations on this type of memory happen in the array's stream.
+	 */
+	DeviceManaged,
 };
 
+constexpr std::size_t MEMORY_KIND_COUNT = static_cast<std::size_t>(MemoryKind::DeviceManaged) + 1;
+
 inline bool isDeviceAccessible(MemoryKind kind) { return kind != MemoryKind::HostPageable; }
 
 inline bool isHost(MemoryKind kind) { return kind == MemoryKind::HostPinned || kind == MemoryKind::HostPageable; }
\ No newline at end of file
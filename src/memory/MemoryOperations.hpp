@@ -14,91 +14,220 @@
 
 #pragma once
 
-#include <functional>
+#include <cstring>
+#include <optional>
 
 #include <macros/cuda.hpp>
 #include <memory/MemoryKind.hpp>
+#include <memory/DeviceArena.hpp>
+#include <memory/DeviceMemoryPool.hpp>
+#include <memory/HostPinnedMemoryPool.hpp>
 #include <CudaStream.hpp>
+#include <CudaDevice.hpp>
+#include <PerformanceCounters.hpp>
+
+/**
+ * Implements 4 basic memory operations needed to implement dynamic-size array for the given MemoryKind.
+ * Stream is used only by stream-ordered kinds (DeviceAsync, DeviceManaged).
+ * Warning: deallocate, copy and clear can work ONLY on the memory kind returned by allocate.
+ */
+template<MemoryKind memoryKind>
+struct MemoryKindOperations;
+
+template<>
+struct MemoryKindOperations<MemoryKind::HostPageable>
+{
+	static void* allocate(size_t bytes, cudaStream_t) { return malloc(bytes); }
+	static void deallocate(void* ptr, cudaStream_t) { free(ptr); }
+	static void copy(void* dst, const void* src, size_t bytes, cudaStream_t) { memcpy(dst, src, bytes); }
+	static void clear(void* dst, int value, size_t bytes, cudaStream_t) { memset(dst, value, bytes); }
+};
+
+template<>
+struct MemoryKindOperations<MemoryKind::HostPinned>
+{
+	static void* allocate(size_t bytes, cudaStream_t) { return HostPinnedMemoryPool::instance().allocate(bytes); }
+	static void deallocate(void* ptr, cudaStream_t) { HostPinnedMemoryPool::instance().deallocate(ptr); }
+	// Regular memcpy and memset avoid the overhead of cuda[Memcpy|Memset] and achieve higher performance.
+	static void copy(void* dst, const void* src, size_t bytes, cudaStream_t) { memcpy(dst, src, bytes); }
+	static void clear(void* dst, int value, size_t bytes, cudaStream_t) { memset(dst, value, bytes); }
+};
+
+template<>
+struct MemoryKindOperations<MemoryKind::DeviceSync>
+{
+	static void* allocate(size_t bytes, cudaStream_t)
+	{
+		void* ptr = nullptr;
+		CudaDevice::markInUse();
+		CHECK_CUDA(cudaMalloc(&ptr, bytes));
+		return ptr;
+	}
+	static void deallocate(void* ptr, cudaStream_t) { CHECK_CUDA(cudaFree(ptr)); }
+	static void copy(void* dst, const void* src, size_t bytes, cudaStream_t)
+	{
+		CHECK_CUDA(cudaMemcpy(dst, src, bytes, cudaMemcpyDeviceToDevice));
+	}
+	static void clear(void* dst, int value, size_t bytes, cudaStream_t) { CHECK_CUDA(cudaMemset(dst, value, bytes)); }
+};
+
+template<>
+struct MemoryKindOperations<MemoryKind::DeviceAsync>
+{
+	static void* allocate(size_t bytes, cudaStream_t stream)
+	{
+		if (DeviceArena::isSuballocated(bytes)) {
+			return DeviceArena::instance().allocate(bytes, stream);
+		}
+		return DeviceMemoryPool::instance().allocateAsync(bytes, stream);
+	}
+	static void deallocate(void* ptr, cudaStream_t stream)
+	{
+		if (DeviceArena::instance().deallocate(ptr, stream)) {
+			return;
+		}
+		CHECK_CUDA(cudaFreeAsync(ptr, stream));
+	}
+	static void copy(void* dst, const void* src, size_t bytes, cudaStream_t stream)
+	{
+		CHECK_CUDA(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDeviceToDevice, stream));
+	}
+	static void clear(void* dst, int value, size_t bytes, cudaStream_t stream)
+	{
+		CHECK_CUDA(cudaMemsetAsync(dst, value, bytes, stream));
+	}
+};
+
+template<>
+struct MemoryKindOperations<MemoryKind::DeviceManaged>
+{
+	static void* allocate(size_t bytes, cudaStream_t)
+	{
+		void* ptr = nullptr;
+		CudaDevice::markInUse();
+		CHECK_CUDA(cudaMallocManaged(&ptr, bytes, cudaMemAttachGlobal));
+		if (isConcurrentAccessSupported()) {
+			// Without the preference, pages accessed from the host would stay there.
+			CHECK_CUDA(cudaMemAdvise(ptr, bytes, cudaMemAdviseSetPreferredLocation, getLocation(false)));
+		}
+		return ptr;
+	}
+	static void deallocate(void* ptr, cudaStream_t) { CHECK_CUDA(cudaFree(ptr)); }
+	static void copy(void* dst, const void* src, size_t bytes, cudaStream_t stream)
+	{
+		CHECK_CUDA(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDefault, stream));
+	}
+	static void clear(void* dst, int value, size_t bytes, cudaStream_t stream)
+	{
+		CHECK_CUDA(cudaMemsetAsync(dst, value, bytes, stream));
+	}
+
+	/**
+	 * Migrates memory to the host or to the device in stream order.
+	 * No-op on devices which do not support concurrent managed access (pages migrate on access then).
+	 */
+	static void prefetch(const void* ptr, size_t bytes, bool toHost, cudaStream_t stream)
+	{
+		if (bytes == 0 || !isConcurrentAccessSupported()) {
+			return;
+		}
+#if CUDART_VERSION >= 13000
+		CHECK_CUDA(cudaMemPrefetchAsync(ptr, bytes, getLocation(toHost), 0, stream));
+#else
+		CHECK_CUDA(cudaMemPrefetchAsync(ptr, bytes, getLocation(toHost), stream));
+#endif
+	}
+
+private:
+	static bool isConcurrentAccessSupported()
+	{
+		static const bool isSupported = []() {
+			int value = 0;
+			CHECK_CUDA(cudaDeviceGetAttribute(&value, cudaDevAttrConcurrentManagedAccess, CudaDevice::getSelected()));
+			return value != 0;
+		}();
+		return isSupported;
+	}
+
+	static auto getLocation(bool isHost)
+	{
+#if CUDART_VERSION >= 13000
+		return isHost ? cudaMemLocation{.type = cudaMemLocationTypeHost, .id = 0} :
+		                cudaMemLocation{.type = cudaMemLocationTypeDevice, .id = CudaDevice::getSelected()};
+#else
+		return isHost ? cudaCpuDeviceId : CudaDevice::getSelected();
+#endif
+	}
+};
 
 /**
  * MemoryOperations encapsulate 4 basic memory operations needed to implement dynamic-size array.
+ * Operations are dispatched to MemoryKindOperations by the (fixed) memory kind, without type-erased calls,
+ * so that copying array contents on hot paths costs no more than the underlying operation.
+ * Allocations and copies are accounted per memory kind, see PerformanceCounters::MemoryKindCounters.
  * It also provides factory method to create MemoryOperations corresponding to those defined in MemoryKind enum.
  * Warning: deallocate, copy and clear can work ONLY on the memory kind returned by allocate.
  */
 struct MemoryOperations
 {
-	std::function<void*(size_t)> allocate;
-	std::function<void(void*)> deallocate;
-	std::function<void(void*, const void*, size_t)> copy;
-	std::function<void(void*, int value, size_t)> clear;
+	void* allocate(size_t bytes) const
+	{
+		void* ptr = dispatch([&]<MemoryKind kind>() { return Ops<kind>::allocate(bytes, getStreamHandle()); });
+		PerformanceCounters::instance().getMemoryKindCounters(kind).addAllocation(bytes);
+		return ptr;
+	}
+	// Size of the allocation is passed for accounting only.
+	void deallocate(void* ptr, size_t bytes) const
+	{
+		dispatch([&]<MemoryKind kind>() { Ops<kind>::deallocate(ptr, getStreamHandle()); });
+		PerformanceCounters::instance().getMemoryKindCounters(kind).addDeallocation(bytes);
+	}
+	void copy(void* dst, const void* src, size_t bytes) const
+	{
+		dispatch([&]<MemoryKind kind>() { Ops<kind>::copy(dst, src, bytes, getStreamHandle()); });
+		PerformanceCounters::instance().addTransfer(isHost(kind), isHost(kind), bytes);
+	}
+	void clear(void* dst, int value, size_t bytes) const
+	{
+		dispatch([&]<MemoryKind kind>() { Ops<kind>::clear(dst, value, bytes, getStreamHandle()); });
+	}
+
+	MemoryKind getKind() const { return kind; }
 
 	/** Returns MemoryOperations for given MemoryKind */
 	template<MemoryKind memoryKind>
 	static MemoryOperations get(std::optional<CudaStream::Ptr> maybeStream = std::nullopt)
 	{
-		// clang-format off
-		if constexpr (memoryKind == MemoryKind::HostPageable) {
-			return {
-				.allocate = malloc,
-				.deallocate = free,
-				.copy = memcpy,
-				.clear = memset };
-		}
-		else if constexpr (memoryKind == MemoryKind::HostPinned) {
-			return {
-				.allocate = [](size_t bytes) {
-					void* ptr = nullptr;
-					CHECK_CUDA(cudaMallocHost(&ptr, bytes));
-					return ptr;
-				},
-				.deallocate = [](void* ptr) {
-					CHECK_CUDA(cudaFreeHost(ptr));
-				},
-				// Regular memcpy and memset avoid the overhead of cuda[Memcpy|Memset] and achieve higher performance.
-				.copy = memcpy,
-				.clear = memset };
-		}
-		else if constexpr (memoryKind == MemoryKind::DeviceSync) {
-			return {
-				.allocate = [](size_t bytes) {
-					void* ptr = nullptr;
-					CHECK_CUDA(cudaMalloc(&ptr, bytes));
-					return ptr;
-				},
-				.deallocate = [](void* ptr) {
-					CHECK_CUDA(cudaFree(ptr));
-				},
-				.copy = [](void* dst, const void* src, size_t bytes) {
-					CHECK_CUDA(cudaMemcpy(dst, src, bytes, cudaMemcpyDeviceToDevice));
-				},
-				.clear = [=](void* dst, int value, size_t bytes) {
-					CHECK_CUDA(cudaMemset(dst, value, bytes));
-				}
-			};
-		}
-		else if constexpr (memoryKind == MemoryKind::DeviceAsync) {
-			auto stream = maybeStream.value();
-			return {
-				// Note: capture-by-value to ensure CudaStream lifetime.
-				.allocate = [=](size_t bytes) {
-					void* ptr = nullptr;
-					CHECK_CUDA(cudaMallocAsync(&ptr, bytes, stream->getHandle()));
-					return ptr;
-				},
-				.deallocate = [=](void* ptr) {
-					CHECK_CUDA(cudaFreeAsync(ptr, stream->getHandle()));
-				},
-				.copy = [=](void* dst, const void* src, size_t bytes) {
-					CHECK_CUDA(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDeviceToDevice, stream->getHandle()));
-				},
-				.clear = [=](void* dst, int value, size_t bytes) {
-					CHECK_CUDA(cudaMemsetAsync(dst, value, bytes, stream->getHandle()));
-				}
-			};
+		if constexpr (memoryKind == MemoryKind::DeviceAsync || memoryKind == MemoryKind::DeviceManaged) {
+			// Note: stream is held to ensure its lifetime.
+			return {memoryKind, maybeStream.value()};
 		}
 		else {
-			static_assert("invalid memory kind passed to MemoryOperations::get()");
+			return {memoryKind, nullptr};
 		}
-		// clang-format on
 	}
+
+private:
+	template<MemoryKind kind>
+	using Ops = MemoryKindOperations<kind>;
+
+	MemoryOperations(MemoryKind kind, CudaStream::Ptr stream) : kind(kind), stream(std::move(stream)) {}
+
+	cudaStream_t getStreamHandle() const { return stream != nullptr ? stream->getHandle() : nullptr; }
+
+	template<typename F>
+	decltype(auto) dispatch(F&& f) const
+	{
+		switch (kind) {
+			case MemoryKind::DeviceAsync: return f.template operator()<MemoryKind::DeviceAsync>();
+			case MemoryKind::DeviceSync: return f.template operator()<MemoryKind::DeviceSync>();
+			case MemoryKind::HostPageable: return f.template operator()<MemoryKind::HostPageable>();
+			case MemoryKind::HostPinned: return f.template operator()<MemoryKind::HostPinned>();
+			case MemoryKind::DeviceManaged: return f.template operator()<MemoryKind::DeviceManaged>();
+		}
+		throw std::invalid_argument("invalid memory kind passed to MemoryOperations");
+	}
+
+	MemoryKind kind;
+	CudaStream::Ptr stream;
 };
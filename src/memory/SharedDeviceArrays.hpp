@@ -0,0 +1,82 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+#include <vector>
+
+#include <memory/Array.hpp>
+#include <ContentHash.hpp>
+
+/**
+ * Content-addressed store of read-only device arrays, e.g. ray patterns of many identical lidars.
+ * Nodes (of any graph) uploading the same data get the same array, so that each content exists once in device memory.
+ * Arrays are bound to the NULL stream (they are never written after the upload) and freed once no node refers to them.
+ */
+struct SharedDeviceArrays
+{
+	template<typename T>
+	static typename DeviceAsyncArray<T>::ConstPtr acquire(const T* data, std::size_t count)
+	{
+		std::lock_guard lock{mutex};
+		std::erase_if(entries, [](const auto& entry) { return entry.second.array.expired(); });
+		Key key{typeid(T), count, hashContent(data, count)};
+		auto it = entries.find(key);
+		if (it != entries.end()) {
+			// Hash collisions are not shared, the content is verified against the host copy.
+			bool isSameContent = std::memcmp(it->second.content.data(), data, sizeof(T) * count) == 0;
+			auto array = std::dynamic_pointer_cast<const DeviceAsyncArray<T>>(it->second.array.lock());
+			return isSameContent ? array : upload(data, count);
+		}
+		auto array = upload(data, count);
+		const auto* bytes = reinterpret_cast<const std::byte*>(data);
+		entries.emplace(key, Entry{.array = array, .content = {bytes, bytes + sizeof(T) * count}});
+		return array;
+	}
+
+	/**
+	 * Returns the number of distinct arrays currently alive.
+	 */
+	static std::size_t getArrayCount()
+	{
+		std::lock_guard lock{mutex};
+		return std::ranges::count_if(entries, [](const auto& entry) { return !entry.second.array.expired(); });
+	}
+
+private:
+	using Key = std::tuple<std::type_index, std::size_t, uint64_t>; // Type, count, content hash
+
+	struct Entry
+	{
+		std::weak_ptr<const IAnyArray> array;
+		std::vector<std::byte> content;
+	};
+
+	template<typename T>
+	static typename DeviceAsyncArray<T>::Ptr upload(const T* data, std::size_t count)
+	{
+		auto array = DeviceAsyncArray<T>::create(CudaStream::getNullStream());
+		array->copyFromExternal(data, count); // Synchronous, arrays may be read in any stream
+		return array;
+	}
+
+	static inline std::mutex mutex;
+	static inline std::map<Key, Entry> entries;
+};
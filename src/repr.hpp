@@ -140,6 +140,40 @@ static inline std::string repr(rgl_node_t* node)
 	return fmt::format("{}{}", (void*) node, nodePointee);
 }
 
+template<>
+struct fmt::formatter<rgl_field_predicate_t>
+{
+	template<typename ParseContext>
+	constexpr auto parse(ParseContext& ctx)
+	{
+		return ctx.begin();
+	}
+
+	template<typename FormatContext>
+	auto format(const rgl_field_predicate_t& v, FormatContext& ctx)
+	{
+		return fmt::format_to(ctx.out(), "(field={}, comparison={}, value={})", v.field, static_cast<int32_t>(v.comparison),
+		                      v.value);
+	}
+};
+
+template<>
+struct fmt::formatter<rgl_region_t>
+{
+	template<typename ParseContext>
+	constexpr auto parse(ParseContext& ctx)
+	{
+		return ctx.begin();
+	}
+
+	template<typename FormatContext>
+	auto format(const rgl_region_t& v, FormatContext& ctx)
+	{
+		return fmt::format_to(ctx.out(), "(shape={}, min={}, max={}, exclude={})", static_cast<int32_t>(v.shape), v.min, v.max,
+		                      v.exclude);
+	}
+};
+
 template<>
 struct fmt::formatter<rgl_radar_scope_t>
 {
@@ -157,3 +191,24 @@ struct fmt::formatter<rgl_radar_scope_t>
 		                      v.radial_speed_separation_threshold, v.azimuth_separation_threshold);
 	}
 };
+
+template<>
+struct fmt::formatter<rgl_radar_fmcw_config_t>
+{
+	template<typename ParseContext>
+	constexpr auto parse(ParseContext& ctx)
+	{
+		return ctx.begin();
+	}
+
+	template<typename FormatContext>
+	auto format(const rgl_radar_fmcw_config_t& v, FormatContext& ctx)
+	{
+		return fmt::format_to(ctx.out(),
+		                      "(frequency={}, bandwidth={}, chirp_duration={}, samples={}x{}, power={}, gain={}, noise={}, "
+		                      "cfar: [guard={}, training={}, threshold={}])",
+		                      v.center_frequency, v.bandwidth, v.chirp_duration, v.chirp_count, v.samples_per_chirp,
+		                      v.power_transmitted, v.cumulative_device_gain, v.noise_power, v.cfar_guard_cells,
+		                      v.cfar_training_cells, v.cfar_threshold);
+	}
+};
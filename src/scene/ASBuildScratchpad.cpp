@@ -16,36 +16,136 @@
 #include <macros/optix.hpp>
 #include <macros/cuda.hpp>
 
-void ASBuildScratchpad::resizeToFit(OptixBuildInput input, OptixAccelBuildOptions options)
+std::mutex SharedASBuildTemp::mutex;
+std::unordered_map<cudaStream_t, DeviceSyncArray<std::byte>::Ptr> SharedASBuildTemp::buffers;
+
+SharedASBuildTemp::Lease SharedASBuildTemp::acquire(std::size_t bytes, CudaStream::Ptr stream)
+{
+	std::unique_lock lock{mutex};
+	auto& buffer = buffers[stream->getHandle()];
+	if (buffer == nullptr) {
+		buffer = DeviceSyncArray<std::byte>::create();
+	}
+	// Growing reallocates the buffer; freeing the old one waits for the builds using it to complete.
+	if (buffer->getCount() < bytes) {
+		buffer->resize(bytes, false, false);
+	}
+	return {buffer->getDeviceWritePtr(), buffer->getCount(), std::move(lock)};
+}
+
+std::size_t SharedASBuildTemp::getAllocatedBytes()
+{
+	std::scoped_lock lock{mutex};
+	std::size_t bytes = 0;
+	for (auto&& [stream, buffer] : buffers) {
+		bytes += buffer->getCapacity();
+	}
+	return bytes;
+}
+
+void ASBuildScratchpad::resizeToFit(OptixBuildInput input, OptixAccelBuildOptions options, bool useSharedTemp)
 {
 	OptixAccelBufferSizes bufferSizes;
 	CHECK_OPTIX(optixAccelComputeMemoryUsage(Optix::getOrCreate().context, &options, &input, 1, &bufferSizes));
 
 	// Short-circuit evaluation workaround
-	dTemp->resize(bufferSizes.tempSizeInBytes, false, false);
+	requiredTempBytes = bufferSizes.tempSizeInBytes;
+	if (!useSharedTemp) {
+		dTemp->resize(bufferSizes.tempSizeInBytes, false, false);
+	}
 	dFull->resize(bufferSizes.outputSizeInBytes, false, false);
-	dCompactedSize->resize(1, false, false);
+	// Emitted only by builds allowing compaction; not allocating it otherwise saves a device allocation per GAS.
+	if ((options.buildFlags & OPTIX_BUILD_FLAG_ALLOW_COMPACTION) != 0) {
+		dCompactedSize->resize(1, false, false);
+	}
 }
 
-void ASBuildScratchpad::doCompaction(OptixTraversableHandle& handle)
+std::size_t ASBuildScratchpad::getAllocatedBytes() const
 {
-	throw std::runtime_error("AS compaction is disabled due to performance reasons");
-	// TODO(prybicki): Too many lines for getting a number from GPU :(
-	// TODO(prybicki): Some time later, it turns out that this communication (async cpy + synchronize) is killing perf
-	// TODO(prybicki): This should remain disabled, until a real-world memory management subsystem is implemented
+	return dTemp->getCapacity() + dFull->getCapacity() + dCompact->getCapacity() +
+	       sizeof(uint64_t) * dCompactedSize->getCapacity();
+}
 
-	// Commented out due to introduction of Array<M,T>
-	// Should be re-implemented when needed using new interface
+void ASBuildScratchpad::release()
+{
+	resetCompaction();
+	// Freeing device memory waits for the pending work (e.g. raytracing) to complete.
+	dFull = DeviceSyncArray<std::byte>::create();
+}
+
+bool ASBuildScratchpad::progressCompaction(OptixTraversableHandle& handle, CudaStream::Ptr stream)
+{
+	if (compactionState != CompactionState::NotStarted) {
+		cudaError_t status = cudaEventQuery(compactionStepCompleted->getHandle());
+		if (status == cudaErrorNotReady) {
+			return false;
+		}
+		CHECK_CUDA(status);
+	}
+
+	switch (compactionState) {
+		case CompactionState::NotStarted: {
+			// Reading the compacted size is done asynchronously, since synchronous round-trip is a major slowdown.
+			if (compactionStepCompleted == nullptr) {
+				compactionStepCompleted = CudaEvent::create();
+			}
+			compactionStream = stream;
+			hCompactedSize->resize(1, false, false);
+			CHECK_CUDA(cudaMemcpyAsync(hCompactedSize->getWritePtr(), dCompactedSize->getReadPtr(), sizeof(uint64_t),
+			                           cudaMemcpyDeviceToHost, compactionStream->getHandle()));
+			CHECK_CUDA(cudaEventRecord(compactionStepCompleted->getHandle(), compactionStream->getHandle()));
+			compactionState = CompactionState::SizeRequested;
+			return false;
+		}
+		case CompactionState::SizeRequested: {
+			uint64_t compactedSize = (*hCompactedSize)[0];
+			if (compactedSize >= dFull->getCount()) {
+				compactionState = CompactionState::Finished; // Nothing to gain
+				return false;
+			}
+			dCompact->resize(compactedSize, false, false);
+			CHECK_OPTIX(optixAccelCompact(Optix::getOrCreate().context, compactionStream->getHandle(), handle,
+			                              dCompact->getDeviceWritePtr(), dCompact->getCount(), &compactedHandle));
+			CHECK_CUDA(cudaEventRecord(compactionStepCompleted->getHandle(), compactionStream->getHandle()));
+			compactionState = CompactionState::Compacting;
+			return false;
+		}
+		case CompactionState::Compacting: {
+			// Releasing the full AS is safe, since cudaFree waits for the pending work (e.g. raytracing) to complete.
+			std::swap(dFull, dCompact);
+			dCompact = DeviceSyncArray<std::byte>::create();
+			handle = compactedHandle;
+			compactionState = CompactionState::Finished;
+			return true;
+		}
+		case CompactionState::Finished: return false;
+	}
+	return false;
+}
 
-	// hCompactedSize->copyFromDeviceAsync(dCompactedSize, nullptr); // TODO: stream
-	// CHECK_CUDA(cudaStreamSynchronize(nullptr));
-	// uint64_t compactedSize = *hCompactedSize->readHost();
+void ASBuildScratchpad::compactNow(OptixTraversableHandle& handle, CudaStream::Ptr stream)
+{
+	hCompactedSize->resize(1, false, false);
+	CHECK_CUDA(cudaMemcpyAsync(hCompactedSize->getWritePtr(), dCompactedSize->getReadPtr(), sizeof(uint64_t),
+	                           cudaMemcpyDeviceToHost, stream->getHandle()));
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+	uint64_t compactedSize = (*hCompactedSize)[0];
+	if (compactedSize >= dFull->getCount()) {
+		return; // Nothing to gain
+	}
+	dCompact->resize(compactedSize, false, false);
+	CHECK_OPTIX(optixAccelCompact(Optix::getOrCreate().context, stream->getHandle(), handle, dCompact->getDeviceWritePtr(),
+	                              dCompact->getCount(), &handle));
+	// Releasing the full AS is safe, since cudaFree waits for the pending work (e.g. the compaction) to complete.
+	std::swap(dFull, dCompact);
+	dCompact = DeviceSyncArray<std::byte>::create();
+}
 
-	// dCompact.resizeToFit(compactedSize);
-	// CHECK_OPTIX(optixAccelCompact(Optix::getOrCreate().context,
-	//                               nullptr, // TODO: stream
-	//                               handle,
-	//                               dCompact.readDeviceRaw(),
-	//                               dCompact.getByteSize(),
-	//                               &handle));
+void ASBuildScratchpad::resetCompaction()
+{
+	if (compactionState == CompactionState::SizeRequested || compactionState == CompactionState::Compacting) {
+		CHECK_CUDA(cudaEventSynchronize(compactionStepCompleted->getHandle()));
+	}
+	dCompact = DeviceSyncArray<std::byte>::create();
+	compactionState = CompactionState::NotStarted;
 }
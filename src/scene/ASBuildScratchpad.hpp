@@ -15,24 +15,103 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <optix_stubs.h>
 
 #include <Optix.hpp>
+#include <CudaEvent.hpp>
 #include <memory/Array.hpp>
 
+/**
+ * Temporary buffers shared by all GAS builds and updates: their contents are not needed once a build completes,
+ * while per-mesh buffers would stay at their peak size. There is one buffer per stream building GASes (see
+ * Mesh::buildGASes); builds queued in the same stream use it in stream order, so they need no other synchronization.
+ */
+struct SharedASBuildTemp
+{
+	struct Lease
+	{
+		CUdeviceptr ptr;
+		std::size_t bytes;
+		std::unique_lock<std::mutex> lock;
+	};
+
+	/**
+	 * Returns the buffer of the given stream, grown to at least the given size.
+	 * The lease has to be kept until the build is queued.
+	 */
+	static Lease acquire(std::size_t bytes, CudaStream::Ptr stream);
+
+	static std::size_t getAllocatedBytes();
+
+private:
+	static std::mutex mutex;
+	static std::unordered_map<cudaStream_t, DeviceSyncArray<std::byte>::Ptr> buffers;
+};
+
 /**
  * Helper class to manage buffers used for building acceleration (GAS, IAS) structures and perform their compaction.
+ * Scratchpads of GASes use SharedASBuildTemp, so each one holds only the GAS itself (dFull), the transient compacted copy
+ * (dCompact, only while compaction is in progress) and its compacted size (only if compaction is allowed).
  */
 struct ASBuildScratchpad
 {
 	friend struct Mesh;
 	friend struct Scene;
 
-	void resizeToFit(OptixBuildInput input, OptixAccelBuildOptions options);
-	void doCompaction(OptixTraversableHandle& handle);
+	/**
+	 * Resizes the output buffer and the temporary one (unless the build uses SharedASBuildTemp) to fit the given build.
+	 */
+	void resizeToFit(OptixBuildInput input, OptixAccelBuildOptions options, bool useSharedTemp = false);
+
+	/**
+	 * Returns device memory held by the scratchpad, i.e. the AS (with its compacted copy, if any) and its own scratch.
+	 */
+	std::size_t getAllocatedBytes() const;
+
+	/**
+	 * Releases AS built in the scratchpad, e.g. to evict GAS of an unused mesh; it has to be built again before use.
+	 */
+	void release();
+
+	/**
+	 * Progresses asynchronous compaction of AS built with OPTIX_BUILD_FLAG_ALLOW_COMPACTION,
+	 * which emitted OPTIX_PROPERTY_TYPE_COMPACTED_SIZE into dCompactedSize.
+	 * Compaction is split into steps (reading compacted size, compacting), each one queued in the given stream.
+	 * Every call checks (without blocking) if the previous step has completed and if so, queues the next one.
+	 * When compaction is completed, the given handle and dFull are replaced with the compacted ones.
+	 * @return True if the handle has been replaced in this call.
+	 */
+	bool progressCompaction(OptixTraversableHandle& handle, CudaStream::Ptr stream);
+
+	/**
+	 * Compacts AS (built as described above) in the given stream, waiting on the host only to read the compacted size.
+	 * Meant for AS that are rebuilt rarely, for which a single stall is cheaper than tracking progress over frames.
+	 */
+	void compactNow(OptixTraversableHandle& handle, CudaStream::Ptr stream);
+
+	/**
+	 * Cancels compaction in progress (if any), e.g. because AS is about to be rebuilt.
+	 * Makes it possible to start a new compaction.
+	 */
+	void resetCompaction();
 
 private:
+	enum struct CompactionState
+	{
+		NotStarted,
+		SizeRequested,
+		Compacting,
+		Finished,
+	};
+	CompactionState compactionState{CompactionState::NotStarted};
+	CudaStream::Ptr compactionStream;
+	CudaEvent::Ptr compactionStepCompleted;
+	OptixTraversableHandle compactedHandle{0};
+	std::size_t requiredTempBytes{0};
+
 	HostPinnedArray<uint64_t>::Ptr hCompactedSize = HostPinnedArray<uint64_t>::create();
 	DeviceSyncArray<uint64_t>::Ptr dCompactedSize = DeviceSyncArray<uint64_t>::create();
 	DeviceSyncArray<std::byte>::Ptr dTemp = DeviceSyncArray<std::byte>::create();
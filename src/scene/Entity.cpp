@@ -12,25 +12,48 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include <scene/Entity.hpp>
 
 API_OBJECT_INSTANCE(Entity);
 
-std::shared_ptr<Entity> Entity::create(std::shared_ptr<Mesh> mesh)
+std::shared_ptr<Entity> Entity::create(std::shared_ptr<Mesh> mesh, std::shared_ptr<Scene> scene)
 {
-	auto entity = APIObject<Entity>::create(mesh);
-	Scene::instance().addEntity(entity);
+	auto entity = APIObject<Entity>::create(mesh, scene.get());
+	scene->addEntity(entity);
 	return entity;
 }
 
-Entity::Entity(std::shared_ptr<Mesh> mesh) : mesh(std::move(mesh)) {}
+std::vector<std::shared_ptr<Entity>> Entity::createInstanced(std::shared_ptr<Mesh> mesh, std::shared_ptr<Scene> scene,
+                                                             const Mat3x4f* transforms, std::size_t count)
+{
+	std::vector<std::shared_ptr<Entity>> entities;
+	entities.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		auto entity = APIObject<Entity>::create(mesh, scene.get());
+		entity->transformInfo = {transforms[i], scene->getTime()}; // As set by setTransform(), without its invalidations
+		entities.emplace_back(std::move(entity));
+	}
+	scene->addEntities(entities);
+	return entities;
+}
+
+Entity::Entity(std::shared_ptr<Mesh> mesh, Scene* scene) : mesh(mesh), baseMesh(std::move(mesh)), scene(scene) {}
 
 void Entity::setTransform(Mat3x4f newTransform)
 {
+	scene->releaseDeviceTransformSlot(*this);
+	pushTransformInfo({newTransform, scene->getTime()});
+	scene->requestASRefit(); // Instance transform and transform history
+}
+
+void Entity::pushTransformInfo(TransformWithTime newTransformInfo)
+{
+	std::shift_right(earlierTransformInfos.begin(), earlierTransformInfos.end(), 1);
+	earlierTransformInfos.front() = formerTransformInfo;
 	formerTransformInfo = transformInfo;
-	transformInfo = {newTransform, Scene::instance().getTime()};
-	Scene::instance().requestASRebuild();  // Current transform
-	Scene::instance().requestSBTRebuild(); // Previous transform
+	transformInfo = newTransformInfo;
 }
 
 void Entity::setId(int newId)
@@ -41,13 +64,58 @@ void Entity::setId(int newId)
 		throw std::invalid_argument(msg);
 	}
 	id = newId;
-	Scene::instance().requestASRebuild(); // Update instanceId field in AS
+	scene->requestASRefit(); // Update instanceId field in AS
+}
+
+void Entity::setClassId(Field<CLASS_ID_U16>::type newClassId)
+{
+	if (classId == newClassId) {
+		return;
+	}
+	classId = newClassId;
+	scene->requestSBTRebuild(); // Update EntityInstanceData
+}
+
+void Entity::setIntensity(float newIntensity)
+{
+	if (intensity == newIntensity) {
+		return;
+	}
+	intensity = newIntensity;
+	scene->requestSBTRebuild(); // Update EntityInstanceData
+}
+
+void Entity::setVisibilityMask(uint8_t mask)
+{
+	visibilityMask = mask;
+	scene->requestASRefit(); // Update visibilityMask field in AS
+}
+
+void Entity::setStatic(bool value)
+{
+	if (isStatic == value) {
+		return;
+	}
+	isStatic = value;
+	scene->requestInstanceOrderUpdate(); // Moves the instance between static and dynamic IAS
+}
+
+void Entity::setLodMesh(float minDistance, std::shared_ptr<Mesh> lodMesh)
+{
+	if (lodMesh == nullptr) {
+		lodMeshes.erase(minDistance);
+	}
+	else {
+		lodMeshes.insert_or_assign(minDistance, std::move(lodMesh));
+	}
+	// The selection is updated when the next snapshot is acquired; the replaced mesh may be the selected one.
+	scene->requestLodSelectionUpdate();
 }
 
 void Entity::setIntensityTexture(std::shared_ptr<Texture> texture)
 {
 	intensityTexture = texture;
-	Scene::instance().requestSBTRebuild();
+	scene->requestSBTRebuild();
 }
 
 std::optional<Mat3x4f> Entity::getPreviousFrameLocalToWorldTransform() const
@@ -64,7 +132,7 @@ std::optional<Mat3x4f> Entity::getPreviousFrameLocalToWorldTransform() const
 	}
 
 	bool formerTransformWasSetInPrecedingFrame = formerTransformInfo.time.has_value() &&
-	                                             formerTransformInfo.time == Scene::instance().getPrevTime();
+	                                             formerTransformInfo.time == scene->getPrevTime();
 	if (!formerTransformWasSetInPrecedingFrame) {
 		return std::nullopt;
 	}
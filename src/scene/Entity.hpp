@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <array>
+#include <map>
 #include <utility>
 
 #include <APIObject.hpp>
@@ -39,18 +41,55 @@ struct Entity : APIObject<Entity>
 	 * Factory methods which creates an Entity and adds it to the given Scene.
 	 * See constructor docs for more details.
 	 */
-	static std::shared_ptr<Entity> create(std::shared_ptr<Mesh> mesh);
+	static std::shared_ptr<Entity> create(std::shared_ptr<Mesh> mesh, std::shared_ptr<Scene> scene);
+
+	/**
+	 * Creates one Entity of the given mesh per transform and adds them all to the given Scene at once.
+	 */
+	static std::vector<std::shared_ptr<Entity>> createInstanced(std::shared_ptr<Mesh> mesh, std::shared_ptr<Scene> scene,
+	                                                            const Mat3x4f* transforms, std::size_t count);
+
+	/**
+	 * Returns the Scene this Entity belongs to. Entities are destroyed along with their Scene.
+	 */
+	Scene& getScene() const { return *scene; }
 
 	/**
 	 * Sets ID that will be used as a point attribute ENTITY_ID_I32 when a ray hits this entity.
 	 */
 	void setId(int newId);
 
+	/**
+	 * Sets semantic class that will be used as a point attribute CLASS_ID_U16 when a ray hits this entity.
+	 */
+	void setClassId(Field<CLASS_ID_U16>::type newClassId);
+
+	/**
+	 * Sets intensity reported as a point attribute INTENSITY_F32 when a ray hits this entity, unless its texture is sampled.
+	 */
+	void setIntensity(float newIntensity);
+
 	/**
 	 * Sets or updates Entity's transform.
 	 */
 	void setTransform(Mat3x4f newTransform);
 
+	/**
+	 * Registers (or removes, if null) a level-of-detail mesh used when the entity is at least minDistance away
+	 * from the LOD origin of its Scene (see Scene::setLodOrigin). Closer than any LOD, the mesh given at creation is used.
+	 */
+	void setLodMesh(float minDistance, std::shared_ptr<Mesh> lodMesh);
+
+	/**
+	 * Sets layers the entity belongs to, see rgl_entity_set_visibility_mask.
+	 */
+	void setVisibilityMask(uint8_t mask);
+
+	/**
+	 * Marks the entity as static (e.g. map geometry) or dynamic, see rgl_entity_set_static.
+	 */
+	void setStatic(bool value);
+
 	/**
 	 * Sets intensity texture that will be used as a point attribute INTENSITY_F32 when a ray hits this entity.
 	 */
@@ -67,12 +106,13 @@ struct Entity : APIObject<Entity>
 private:
 	/**
 	 * Creates Entity with given mesh and identity transform.
-	 * Before using Entity, it is required to register it on some Scene.
+	 * Before using Entity, it is required to register it on its Scene.
 	 * However, it cannot be done without having its shared_ptr,
 	 * therefore this constructor is private and Entity::create() should be used.
 	 * @param mesh Mesh used by this Entity. May be shared by multiple Entities.
+	 * @param scene Scene the Entity will be added to. Its time is used to track Entity's transforms.
 	 */
-	Entity(std::shared_ptr<Mesh> mesh);
+	Entity(std::shared_ptr<Mesh> mesh, Scene* scene);
 
 private:
 	struct TransformWithTime
@@ -82,9 +122,29 @@ private:
 	};
 	TransformWithTime transformInfo{Mat3x4f::identity(), std::nullopt};
 	TransformWithTime formerTransformInfo{Mat3x4f::identity(), std::nullopt};
+	// Transforms set before the former one, the newest first; all of them are in the history, see Scene::makeTransformHistory.
+	std::array<TransformWithTime, EntityTransformHistory::CAPACITY - 2> earlierTransformInfos{};
+
+	/**
+	 * Makes the given transform current, moving the previous ones back in the history.
+	 */
+	void pushTransformInfo(TransformWithTime newTransformInfo);
 
 	Field<ENTITY_ID_I32>::type id{RGL_DEFAULT_ENTITY_ID};
+	Field<CLASS_ID_U16>::type classId{RGL_DEFAULT_CLASS_ID};
+	float intensity{0.0f};
+	uint8_t visibilityMask{RGL_DEFAULT_VISIBILITY_MASK};
+	bool isStatic{false};
 
+	// Mesh used in AS and SBT, i.e. the selected LOD (see Scene::updateLodSelection) or the base mesh.
 	std::shared_ptr<Mesh> mesh{};
+	std::shared_ptr<Mesh> baseMesh{};
+	std::map<float, std::shared_ptr<Mesh>> lodMeshes; // By minimal distance
 	std::shared_ptr<Texture> intensityTexture{};
+
+	// Not owning: Scene owns its entities, which are destroyed with it.
+	Scene* scene;
+
+	// Set if the transform was last set from device memory; then, transformInfo.matrix is stale, see Scene.
+	std::optional<int32_t> deviceTransformSlot;
 };
@@ -14,9 +14,22 @@
 
 #include <scene/Mesh.hpp>
 #include <scene/Scene.hpp>
+#include <scene/MeshStreamer.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <limits>
+#include <map>
+#include <cuda_fp16.h>
 #include <gpu/helpersKernels.hpp>
+#include <ContentHash.hpp>
+#include <PerformanceCounters.hpp>
+#include <memory/ArrayCopyBatch.hpp>
+#if OPTIX_VERSION >= 70600
+#include <optix_micromap.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -24,40 +37,583 @@ API_OBJECT_INSTANCE(Mesh);
 
 Mesh::Mesh(const Vec3f* vertices, size_t vertexCount, const Vec3i* indices, size_t indexCount)
 {
-	dVertices->copyFromExternal(vertices, vertexCount);
-	dIndices->copyFromExternal(indices, indexCount);
+	ArrayCopyBatch geometryCopy{CudaStream::getNullStream()};
+	geometryCopy.copyFromExternal<Vec3f>(dVertices, vertices, vertexCount);
+	geometryCopy.copyFromExternal<Vec3i>(dIndices, indices, indexCount);
+	geometryCopy.execute();
+	updateBoundingSphere(vertices, vertexCount);
+}
+
+Mesh::Mesh(std::size_t vertexCount, std::size_t indexCount)
+{
+	dVertices->resize(vertexCount, false, false);
+	dIndices->resize(indexCount, false, false);
+}
+
+CudaStream::Ptr Mesh::getStream()
+{
+	static CudaStream::Ptr stream = CudaStream::create(cudaStreamNonBlocking);
+	return stream;
+}
+
+void Mesh::buildGASes(const std::vector<std::shared_ptr<Mesh>>& meshes)
+{
+	if (meshes.size() < 2) {
+		return; // Nothing to overlap, getGAS queues the build in the mesh stream
+	}
+	static std::vector<CudaStream::Ptr> buildStreams;
+	static std::vector<CudaEvent::Ptr> buildsQueuedEvents;
+	static CudaEvent::Ptr meshStreamEvent = CudaEvent::create();
+	if (buildStreams.empty()) {
+		for (std::size_t i = 0; i < GAS_BUILD_STREAM_COUNT; ++i) {
+			buildStreams.emplace_back(CudaStream::create(cudaStreamNonBlocking));
+			buildsQueuedEvents.emplace_back(CudaEvent::create());
+		}
+	}
+
+	std::size_t streamCount = std::min(meshes.size(), GAS_BUILD_STREAM_COUNT);
+	CHECK_CUDA(cudaEventRecord(meshStreamEvent->getHandle(), getStream()->getHandle()));
+	for (std::size_t i = 0; i < streamCount; ++i) {
+		CHECK_CUDA(cudaStreamWaitEvent(buildStreams[i]->getHandle(), meshStreamEvent->getHandle()));
+	}
+	for (std::size_t i = 0; i < meshes.size(); ++i) {
+		meshes[i]->getGAS(buildStreams[i % streamCount]);
+	}
+	for (std::size_t i = 0; i < streamCount; ++i) {
+		CHECK_CUDA(cudaEventRecord(buildsQueuedEvents[i]->getHandle(), buildStreams[i]->getHandle()));
+		CHECK_CUDA(cudaStreamWaitEvent(getStream()->getHandle(), buildsQueuedEvents[i]->getHandle()));
+	}
+}
+
+HostPinnedArray<std::byte>::Ptr& Mesh::getBatchStagingBuffer()
+{
+	// Kept between calls, since pinned memory allocation is expensive.
+	static HostPinnedArray<std::byte>::Ptr stagingBuffer = HostPinnedArray<std::byte>::create();
+	return stagingBuffer;
+}
+
+std::vector<std::shared_ptr<Mesh>> Mesh::createBatch(const std::vector<Geometry>& geometries, CudaStream::Ptr stream)
+{
+	std::size_t stagingSize = 0;
+	for (auto&& geometry : geometries) {
+		stagingSize += sizeof(Vec3f) * geometry.vertexCount + sizeof(Vec3i) * geometry.indexCount;
+	}
+	auto& staging = getBatchStagingBuffer();
+	staging->resize(stagingSize, false, false);
+
+	std::size_t stagingOffset = 0;
+	auto stageAndCopyAsync = [&](void* dst, const void* src, std::size_t bytes) {
+		std::memcpy(staging->getWritePtr() + stagingOffset, src, bytes);
+		CHECK_CUDA(cudaMemcpyAsync(dst, staging->getReadPtr() + stagingOffset, bytes, cudaMemcpyHostToDevice,
+		                           stream->getHandle()));
+		stagingOffset += bytes;
+	};
+
+	std::vector<std::shared_ptr<Mesh>> meshes;
+	meshes.reserve(geometries.size());
+	for (auto&& geometry : geometries) {
+		auto mesh = Mesh::create(geometry.vertexCount, geometry.indexCount);
+		stageAndCopyAsync(mesh->dVertices->getWritePtr(), geometry.vertices, sizeof(Vec3f) * geometry.vertexCount);
+		stageAndCopyAsync(mesh->dIndices->getWritePtr(), geometry.indices, sizeof(Vec3i) * geometry.indexCount);
+		mesh->updateBoundingSphere(geometry.vertices, geometry.vertexCount);
+		// GAS build is queued in the same stream, so it will wait for the copies above.
+		mesh->cachedGAS = mesh->buildGAS(stream);
+		meshes.emplace_back(mesh);
+	}
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+	return meshes;
+}
+
+void Mesh::configureCache(bool enabled, std::size_t budgetBytes)
+{
+	std::lock_guard lock{cacheMutex};
+	cacheBudgetBytes = enabled ? std::optional{budgetBytes} : std::nullopt;
+	evictRetainedOverBudget();
+}
+
+std::shared_ptr<Mesh> Mesh::createCached(const Vec3f* vertices, std::size_t vertexCount, const Vec3i* indices,
+                                         std::size_t indexCount)
+{
+	std::unique_lock lock{cacheMutex};
+	if (!cacheBudgetBytes.has_value()) {
+		lock.unlock();
+		return Mesh::create(vertices, vertexCount, indices, indexCount);
+	}
+	// Counts are part of the key, so hashes of vertices and indices may be just combined.
+	uint64_t hash = hashContent(vertices, vertexCount) ^ (hashContent(indices, indexCount) * 0x9e3779b97f4a7c15ULL);
+	CacheKey key{vertexCount, indexCount, hash};
+	auto it = std::ranges::find_if(retainedMeshes, [&](const auto& mesh) {
+		// Hash collisions are not reused, the content is verified against the device copy.
+		return mesh->cacheKey == key && mesh->hasGeometry(vertices, vertexCount, indices, indexCount);
+	});
+	if (it != retainedMeshes.end()) {
+		auto mesh = *it;
+		retainedMeshes.erase(it);
+		reregister(mesh);
+		return mesh;
+	}
+	lock.unlock();
+	auto mesh = Mesh::create(vertices, vertexCount, indices, indexCount);
+	mesh->cacheKey = key;
+	return mesh;
+}
+
+void Mesh::retainReleased(std::shared_ptr<Mesh> mesh)
+{
+	std::lock_guard lock{cacheMutex};
+	if (!cacheBudgetBytes.has_value() || !mesh->cacheKey.has_value()) {
+		return;
+	}
+	retainedMeshes.push_back(std::move(mesh));
+	evictRetainedOverBudget();
+}
+
+void Mesh::forEachRetained(const std::function<void(Mesh&)>& fn)
+{
+	std::lock_guard lock{cacheMutex};
+	for (auto&& mesh : retainedMeshes) {
+		fn(*mesh);
+	}
+}
+
+void Mesh::evictRetainedOverBudget()
+{
+	std::size_t retainedBytes = 0;
+	for (auto&& mesh : retainedMeshes) {
+		retainedBytes += mesh->getGASBytes() + mesh->getGeometryBytes();
+	}
+	std::size_t budget = cacheBudgetBytes.value_or(0);
+	while (!retainedMeshes.empty() && retainedBytes > budget) {
+		retainedBytes -= retainedMeshes.front()->getGASBytes() + retainedMeshes.front()->getGeometryBytes();
+		retainedMeshes.pop_front();
+	}
+}
+
+bool Mesh::hasGeometry(const Vec3f* vertices, std::size_t vertexCount, const Vec3i* indices, std::size_t indexCount) const
+{
+	if (dVertices->getCount() != vertexCount || dIndices->getCount() != indexCount) {
+		return false;
+	}
+	std::vector<Vec3f> meshVertices(vertexCount);
+	std::vector<Vec3i> meshIndices(indexCount);
+	CHECK_CUDA(cudaMemcpy(meshVertices.data(), dVertices->getReadPtr(), sizeof(Vec3f) * vertexCount, cudaMemcpyDeviceToHost));
+	CHECK_CUDA(cudaMemcpy(meshIndices.data(), dIndices->getReadPtr(), sizeof(Vec3i) * indexCount, cudaMemcpyDeviceToHost));
+	return std::memcmp(meshVertices.data(), vertices, sizeof(Vec3f) * vertexCount) == 0 &&
+	       std::memcmp(meshIndices.data(), indices, sizeof(Vec3i) * indexCount) == 0;
+}
+
+std::shared_ptr<Mesh> Mesh::createStreamed(std::vector<Vec3f> vertices, std::vector<Vec3i> indices)
+{
+	auto mesh = Mesh::create();
+	auto done = std::make_shared<std::promise<void>>();
+	mesh->streamingDone = done->get_future().share();
+	MeshStreamer::instance().submit([mesh, done, vertices = std::move(vertices), indices = std::move(indices)]() {
+		try {
+			CudaStream::Ptr stream = MeshStreamer::instance().getStream();
+			ArrayCopyBatch geometryCopy{stream};
+			geometryCopy.copyFromExternal<Vec3f>(mesh->dVertices, vertices.data(), vertices.size());
+			geometryCopy.copyFromExternal<Vec3i>(mesh->dIndices, indices.data(), indices.size());
+			geometryCopy.execute();
+			mesh->updateBoundingSphere(vertices.data(), vertices.size());
+			{
+				// Build options depend on settings of scenes, which client's threads may be changing.
+				auto editsLock = Scene::lockEdits();
+				mesh->cachedGAS = mesh->buildGAS(stream);
+			}
+			// The fence: the mesh becomes ready only when its GAS is complete, so scenes do not have to wait for this stream.
+			CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+		}
+		catch (...) {
+			mesh->streamingError = std::current_exception();
+		}
+		done->set_value();
+	});
+	return mesh;
+}
+
+std::shared_ptr<Mesh> Mesh::createSpheres(const Vec3f* centers, const float* radii, std::size_t sphereCount)
+{
+#if OPTIX_VERSION < 70500
+	throw std::invalid_argument("Invalid argument: sphere meshes require OptiX 7.5 or newer");
+#endif
+	auto mesh = Mesh::create();
+	mesh->primitiveType = MESH_PRIMITIVE_SPHERES;
+	for (std::size_t i = 0; i < sphereCount; ++i) {
+		if (!(radii[i] > 0.0f) || !std::isfinite(radii[i])) {
+			auto msg = fmt::format("Invalid argument: radius ({}) of sphere {} must be positive and finite", radii[i], i);
+			throw std::invalid_argument(msg);
+		}
+		mesh->maxRadius = std::max(mesh->maxRadius, radii[i]);
+	}
+	ArrayCopyBatch geometryCopy{CudaStream::getNullStream()};
+	geometryCopy.copyFromExternal<Vec3f>(mesh->dVertices, centers, sphereCount);
+	geometryCopy.copyFromExternal<float>(mesh->dRadii, radii, sphereCount);
+	geometryCopy.execute();
+	mesh->updateBoundingSphere(centers, sphereCount);
+	return mesh;
+}
+
+std::shared_ptr<Mesh> Mesh::createCurves(const Vec3f* vertices, const float* radii, std::size_t vertexCount,
+                                         const uint32_t* segmentIndices, std::size_t segmentCount)
+{
+	auto mesh = Mesh::create();
+	mesh->primitiveType = MESH_PRIMITIVE_CURVES;
+	for (std::size_t i = 0; i < vertexCount; ++i) {
+		if (!(radii[i] > 0.0f) || !std::isfinite(radii[i])) {
+			auto msg = fmt::format("Invalid argument: radius ({}) of vertex {} must be positive and finite", radii[i], i);
+			throw std::invalid_argument(msg);
+		}
+		mesh->maxRadius = std::max(mesh->maxRadius, radii[i]);
+	}
+	for (std::size_t i = 0; i < segmentCount; ++i) {
+		if (static_cast<std::size_t>(segmentIndices[i]) + 1 >= vertexCount) {
+			auto msg = fmt::format("Invalid argument: segment {} starts at vertex {}, which has no next vertex (count={})", i,
+			                       segmentIndices[i], vertexCount);
+			throw std::invalid_argument(msg);
+		}
+	}
+	ArrayCopyBatch geometryCopy{CudaStream::getNullStream()};
+	geometryCopy.copyFromExternal<Vec3f>(mesh->dVertices, vertices, vertexCount);
+	geometryCopy.copyFromExternal<float>(mesh->dRadii, radii, vertexCount);
+	geometryCopy.copyFromExternal<uint32_t>(mesh->dSegmentIndices, segmentIndices, segmentCount);
+	geometryCopy.execute();
+	mesh->updateBoundingSphere(vertices, vertexCount);
+	return mesh;
+}
+
+void Mesh::throwIfNotTriangles(const char* operation) const
+{
+	if (primitiveType != MESH_PRIMITIVE_TRIANGLES) {
+		throw std::invalid_argument(fmt::format("Invalid argument: cannot {} a mesh of spheres or curves", operation));
+	}
+}
+
+bool Mesh::isReady() const { return !isStreamingPending() && streamingError == nullptr; }
+
+bool Mesh::isStreamingPending() const
+{
+	return streamingDone.valid() && streamingDone.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void Mesh::waitForStreaming() const
+{
+	if (!streamingDone.valid()) {
+		return;
+	}
+	streamingDone.wait();
+	if (streamingError != nullptr) {
+		std::rethrow_exception(streamingError);
+	}
 }
 
 void Mesh::updateVertices(const Vec3f* vertices, std::size_t vertexCount)
 {
+	waitForStreaming();
+	if (isDataCompressed) {
+		throw std::invalid_argument("Invalid argument: cannot update vertices of a compressed mesh");
+	}
 	if (dVertices->getCount() != vertexCount) {
 		auto msg = fmt::format("Invalid argument: cannot update vertices because vertex counts do not match: old={}, new={}",
 		                       dVertices->getCount(), vertexCount);
 		throw std::invalid_argument(msg);
 	}
-	// Use dVertexSkinningDisplacement as a buffer
-	dVertexSkinningDisplacement->resize(vertexCount, false, false);
-	dVertexSkinningDisplacement->copyFromExternal(vertices, vertexCount);
+	// Previous update might still be copying from the staging buffer, but usually it has completed long ago.
+	CHECK_CUDA(cudaEventSynchronize(verticesStagingReleasedEvent->getHandle()));
+	hVerticesStaging->resize(vertexCount, false, false);
+	std::memcpy(hVerticesStaging->getWritePtr(), vertices, sizeof(Vec3f) * vertexCount);
+
+	// Queued in the mesh stream, so it will be ordered before GAS update and (through scene streams) raytracing.
+	CudaStream::Ptr stream = getStream();
+	enqueueVerticesUpdate(hVerticesStaging->getReadPtr(), vertexCount, stream);
+	CHECK_CUDA(cudaEventRecord(verticesStagingReleasedEvent->getHandle(), stream->getHandle()));
+}
 
-	// Update both displacements and vertices in a single kernel
-	gpuUpdateVertices(CudaStream::getNullStream()->getHandle(), vertexCount, dVertexSkinningDisplacement->getWritePtr(),
-	                  dVertices->getWritePtr());
-	CHECK_CUDA(cudaStreamSynchronize(CudaStream::getNullStream()->getHandle()));
+void Mesh::updateVerticesBatch(const std::vector<std::shared_ptr<Mesh>>& meshes,
+                               const std::vector<std::pair<const Vec3f*, std::size_t>>& vertices, CudaStream::Ptr stream)
+{
+	if (meshes.size() != vertices.size()) {
+		auto msg = fmt::format("Invalid argument: mesh count ({}) does not match vertex array count ({})", meshes.size(),
+		                       vertices.size());
+		throw std::invalid_argument(msg);
+	}
+	// Validate everything first to avoid partial update
+	std::size_t stagingSize = 0;
+	for (std::size_t i = 0; i < meshes.size(); ++i) {
+		meshes[i]->waitForStreaming();
+		if (meshes[i]->isDataCompressed) {
+			throw std::invalid_argument("Invalid argument: cannot update vertices of a compressed mesh");
+		}
+		if (meshes[i]->dVertices->getCount() != vertices[i].second) {
+			auto msg = fmt::format("Invalid argument: cannot update vertices because vertex counts do not match: old={}, new={}",
+			                       meshes[i]->dVertices->getCount(), vertices[i].second);
+			throw std::invalid_argument(msg);
+		}
+		stagingSize += sizeof(Vec3f) * vertices[i].second;
+	}
+	auto& staging = getBatchStagingBuffer();
+	staging->resize(stagingSize, false, false);
+
+	std::size_t stagingOffset = 0;
+	for (std::size_t i = 0; i < meshes.size(); ++i) {
+		auto [meshVertices, vertexCount] = vertices[i];
+		auto* stagedVertices = reinterpret_cast<Vec3f*>(staging->getWritePtr() + stagingOffset);
+		std::memcpy(stagedVertices, meshVertices, sizeof(Vec3f) * vertexCount);
+		meshes[i]->enqueueVerticesUpdate(stagedVertices, vertexCount, stream);
+		stagingOffset += sizeof(Vec3f) * vertexCount;
+	}
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+}
+
+void Mesh::enqueueVerticesUpdate(const Vec3f* stagedVertices, std::size_t vertexCount, CudaStream::Ptr stream)
+{
+	// Use dVertexSkinningDisplacement as a buffer, then update both displacements and vertices in a single kernel.
+	dVertexSkinningDisplacement->resize(vertexCount, false, false);
+	CHECK_CUDA(cudaMemcpyAsync(dVertexSkinningDisplacement->getWritePtr(), stagedVertices, sizeof(Vec3f) * vertexCount,
+	                           cudaMemcpyHostToDevice, stream->getHandle()));
+	gpuUpdateVertices(stream->getHandle(), vertexCount, dVertexSkinningDisplacement->getWritePtr(), dVertices->getWritePtr());
+	updateBoundingSphere(stagedVertices, vertexCount);
+	markVerticesUpdated();
+}
 
+void Mesh::markVerticesUpdated()
+{
+	// GAS of the mesh follows vertices, which no longer match the active keyframe (if any).
+	activeKeyframe.reset();
 	gasNeedsUpdate = true;
-	verticesFormerUpdateTime = verticesCurrentUpdateTime;
-	verticesCurrentUpdateTime = Scene::instance().getTime();
-	Scene::instance().requestASRebuild();  // Vertices themselves
-	Scene::instance().requestSBTRebuild(); // Vertices displacement
+	cacheKey.reset();
+	Scene::forEach([this](Scene& scene) {
+		VerticesUpdateTimes& times = verticesUpdateTimes[scene.getId()];
+		times.former = times.current;
+		times.current = scene.getTime();
+		scene.requestASRefit();    // Vertices themselves
+		scene.requestSBTRebuild(); // Vertices displacement
+	});
+}
+
+void Mesh::setKeyframes(const Vec3f* vertices, std::size_t vertexCount, std::size_t keyframeCount)
+{
+	waitForStreaming();
+	if (isDataCompressed) {
+		throw std::invalid_argument("Invalid argument: cannot set keyframes of a compressed mesh");
+	}
+	if (dVertices->getCount() * keyframeCount != vertexCount) {
+		auto msg = fmt::format("Invalid argument: cannot set keyframes because vertex counts do not match: mesh={}, "
+		                       "keyframes={} (for {} keyframes)",
+		                       dVertices->getCount(), vertexCount, keyframeCount);
+		throw std::invalid_argument(msg);
+	}
+
+	// GAS of the mesh provides the build input and options, reused for keyframes.
+	CudaStream::Ptr stream = getStream();
+	activeKeyframe.reset();
+	getGAS(stream);
+	OptixAccelBuildOptions keyframeOptions = buildOptions;
+	keyframeOptions.buildFlags &= ~OPTIX_BUILD_FLAG_ALLOW_UPDATE; // Keyframes are never updated
+	bool allowCompaction = (keyframeOptions.buildFlags & OPTIX_BUILD_FLAG_ALLOW_COMPACTION) != 0;
+
+	std::size_t keyframeVertexCount = dVertices->getCount();
+	std::vector<std::unique_ptr<Keyframe>> builtKeyframes;
+	for (std::size_t keyframeIdx = 0; keyframeIdx < keyframeCount; ++keyframeIdx) {
+		const Vec3f* keyframeVertices = vertices + keyframeIdx * keyframeVertexCount;
+		auto& keyframe = *builtKeyframes.emplace_back(std::make_unique<Keyframe>());
+		keyframe.dVertices->copyFromExternal(keyframeVertices, keyframeVertexCount);
+		updateBoundingSphere(keyframeVertices, keyframeVertexCount);
+		keyframe.boundingSphere = boundingSphere;
+
+		vertexBuffers[0] = keyframe.dVertices->getDeviceReadPtr();
+		keyframe.scratchpad.resizeToFit(buildInput, keyframeOptions, true);
+		auto temp = SharedASBuildTemp::acquire(keyframe.scratchpad.requiredTempBytes, stream);
+		OptixAccelEmitDesc emitDesc = {
+		    .result = keyframe.scratchpad.dCompactedSize->getDeviceReadPtr(),
+		    .type = OPTIX_PROPERTY_TYPE_COMPACTED_SIZE,
+		};
+		CHECK_OPTIX(optixAccelBuild(Optix::getOrCreate().context, stream->getHandle(), &keyframeOptions, &buildInput, 1,
+		                            temp.ptr, temp.bytes, keyframe.scratchpad.dFull->getDeviceReadPtr(),
+		                            keyframe.scratchpad.dFull->getSizeOf() * keyframe.scratchpad.dFull->getCount(),
+		                            &keyframe.gas, allowCompaction ? &emitDesc : nullptr, allowCompaction ? 1 : 0));
+		PerformanceCounters::instance().gasBuildCount.fetch_add(1, std::memory_order_relaxed);
+		temp.lock.unlock();
+		if (allowCompaction) {
+			keyframe.scratchpad.compactNow(keyframe.gas, stream);
+		}
+	}
+	vertexBuffers[0] = dVertices->getDeviceReadPtr(); // Restores input of GAS of the mesh, see updateGAS()
+	keyframes = std::move(builtKeyframes);
+	setKeyframe(0);
+}
+
+void Mesh::setKeyframe(std::size_t keyframeIdx)
+{
+	waitForStreaming();
+	if (keyframeIdx >= keyframes.size()) {
+		auto msg = fmt::format("Invalid argument: keyframe {} out of range, the mesh has {} keyframes", keyframeIdx,
+		                       keyframes.size());
+		throw std::invalid_argument(msg);
+	}
+	// As in enqueueVerticesUpdate(), but copied on the device; bounds are known, so nothing is read on the host.
+	const Keyframe& keyframe = *keyframes[keyframeIdx];
+	CudaStream::Ptr stream = getStream();
+	std::size_t vertexCount = dVertices->getCount();
+	dVertexSkinningDisplacement->resize(vertexCount, false, false);
+	CHECK_CUDA(cudaMemcpyAsync(dVertexSkinningDisplacement->getWritePtr(), keyframe.dVertices->getReadPtr(),
+	                           sizeof(Vec3f) * vertexCount, cudaMemcpyDeviceToDevice, stream->getHandle()));
+	gpuUpdateVertices(stream->getHandle(), vertexCount, dVertexSkinningDisplacement->getWritePtr(), dVertices->getWritePtr());
+	boundingSphere = keyframe.boundingSphere;
+	markVerticesUpdated(); // Scenes refit their IAS with the handle of the keyframe
+	activeKeyframe = keyframeIdx;
+	gasVersion += 1; // Conservatively, since switching back to a keyframe restores a handle used before
+}
+
+void Mesh::setSkinning(const Vec4i* boneIndices, const Vec4f* boneWeights, std::size_t vertexCount, std::size_t boneCount)
+{
+	waitForStreaming();
+	cacheKey.reset();
+	throwIfNotTriangles("skin");
+	if (isDataCompressed) {
+		throw std::invalid_argument("Invalid argument: cannot skin a compressed mesh");
+	}
+	if (dVertices->getCount() != vertexCount) {
+		auto msg = fmt::format("Invalid argument: cannot set skinning because vertex counts do not match: mesh={}, skinning={}",
+		                       dVertices->getCount(), vertexCount);
+		throw std::invalid_argument(msg);
+	}
+	for (std::size_t i = 0; i < vertexCount; ++i) {
+		float weightSum = 0.0f;
+		for (int j = 0; j < 4; ++j) {
+			if (boneWeights[i][j] != 0.0f && (boneIndices[i][j] < 0 || boneIndices[i][j] >= boneCount)) {
+				auto msg = fmt::format("Invalid argument: bone index ({}) of vertex {} is out of range [0, {})",
+				                       boneIndices[i][j], i, boneCount);
+				throw std::invalid_argument(msg);
+			}
+			weightSum += boneWeights[i][j];
+		}
+		// Required to keep skinned vertices within bounds of the bones (see updateBones).
+		bool areWeightsNonNegative = std::all_of(&boneWeights[i][0], &boneWeights[i][0] + 4, [](float w) { return w >= 0.0f; });
+		if (!areWeightsNonNegative || std::abs(weightSum - 1.0f) > 1e-3f) {
+			auto msg = fmt::format("Invalid argument: bone weights of vertex {} must be non-negative and sum up to 1", i);
+			throw std::invalid_argument(msg);
+		}
+	}
+
+	// Bind pose is the current state of vertices, possibly updated in the mesh stream.
+	std::vector<Vec3f> bindPose(vertexCount);
+	CHECK_CUDA(cudaMemcpyAsync(bindPose.data(), dVertices->getReadPtr(), sizeof(Vec3f) * vertexCount, cudaMemcpyDeviceToHost,
+	                           getStream()->getHandle()));
+	CHECK_CUDA(cudaStreamSynchronize(getStream()->getHandle()));
+
+	Skinning newSkinning;
+	constexpr float inf = std::numeric_limits<float>::infinity();
+	newSkinning.boneBounds.assign(boneCount, {Vec3f{inf}, Vec3f{-inf}});
+	for (std::size_t i = 0; i < vertexCount; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			if (boneWeights[i][j] == 0.0f) {
+				continue;
+			}
+			auto& [min, max] = newSkinning.boneBounds[boneIndices[i][j]];
+			for (int axis = 0; axis < 3; ++axis) {
+				min[axis] = std::min(min[axis], bindPose[i][axis]);
+				max[axis] = std::max(max[axis], bindPose[i][axis]);
+			}
+		}
+	}
+	ArrayCopyBatch skinningCopy{getStream()};
+	skinningCopy.copyFromExternal<Vec3f>(newSkinning.dBindPoseVertices, bindPose.data(), vertexCount);
+	skinningCopy.copyFromExternal<Vec4i>(newSkinning.dBoneIndices, boneIndices, vertexCount);
+	skinningCopy.copyFromExternal<Vec4f>(newSkinning.dBoneWeights, boneWeights, vertexCount);
+	skinningCopy.execute();
+	skinning = std::move(newSkinning);
+}
+
+void Mesh::updateBones(const Mat3x4f* boneTransforms, std::size_t boneCount)
+{
+	waitForStreaming();
+	if (!skinning.has_value()) {
+		throw std::invalid_argument("Invalid argument: cannot update bones of a mesh without skinning");
+	}
+	if (skinning->boneBounds.size() != boneCount) {
+		auto msg = fmt::format("Invalid argument: cannot update bones because bone counts do not match: old={}, new={}",
+		                       skinning->boneBounds.size(), boneCount);
+		throw std::invalid_argument(msg);
+	}
+	// Previous update might still be copying from the staging buffer, but usually it has completed long ago.
+	CHECK_CUDA(cudaEventSynchronize(verticesStagingReleasedEvent->getHandle()));
+	skinning->hBonesStaging->resize(boneCount, false, false);
+	std::memcpy(skinning->hBonesStaging->getWritePtr(), boneTransforms, sizeof(Mat3x4f) * boneCount);
+
+	CudaStream::Ptr stream = getStream();
+	skinning->dBones->resize(boneCount, false, false);
+	CHECK_CUDA(cudaMemcpyAsync(skinning->dBones->getWritePtr(), skinning->hBonesStaging->getReadPtr(),
+	                           sizeof(Mat3x4f) * boneCount, cudaMemcpyHostToDevice, stream->getHandle()));
+	CHECK_CUDA(cudaEventRecord(verticesStagingReleasedEvent->getHandle(), stream->getHandle()));
+	std::size_t vertexCount = dVertices->getCount();
+	dVertexSkinningDisplacement->resize(vertexCount, false, false);
+	gpuSkinVertices(stream->getHandle(), vertexCount, skinning->dBindPoseVertices->getReadPtr(),
+	                skinning->dBoneIndices->getReadPtr(), skinning->dBoneWeights->getReadPtr(), skinning->dBones->getReadPtr(),
+	                dVertexSkinningDisplacement->getWritePtr(), dVertices->getWritePtr());
+
+	// Skinned vertices are convex combinations of bones' transforms of bind-pose vertices, thus lie within the AABB
+	// of transformed bone bounds. Vertices are not read back, so the sphere bounds this AABB.
+	constexpr float inf = std::numeric_limits<float>::infinity();
+	Vec3f min{inf}, max{-inf};
+	for (std::size_t bone = 0; bone < boneCount; ++bone) {
+		auto&& [boneMin, boneMax] = skinning->boneBounds[bone];
+		if (boneMin.x() > boneMax.x()) {
+			continue; // Influences no vertex
+		}
+		for (int corner = 0; corner < 8; ++corner) {
+			Vec3f point{(corner & 1) ? boneMax.x() : boneMin.x(), (corner & 2) ? boneMax.y() : boneMin.y(),
+			            (corner & 4) ? boneMax.z() : boneMin.z()};
+			Vec3f transformed = boneTransforms[bone] * point;
+			for (int axis = 0; axis < 3; ++axis) {
+				min[axis] = std::min(min[axis], transformed[axis]);
+				max[axis] = std::max(max[axis], transformed[axis]);
+			}
+		}
+	}
+	Vec3f center = (min + max) / 2.0f;
+	boundingSphere = Vec4f{center.x(), center.y(), center.z(), ((max - min) / 2.0f).length()};
+	markVerticesUpdated();
+}
+
+void Mesh::updateBoundingSphere(const Vec3f* vertices, std::size_t vertexCount)
+{
+	// Centered in the AABB: not the smallest sphere, but cheap to compute and tight enough for culling.
+	Vec3f min = vertices[0], max = vertices[0];
+	for (std::size_t i = 1; i < vertexCount; ++i) {
+		for (int axis = 0; axis < 3; ++axis) {
+			min[axis] = std::min(min[axis], vertices[i][axis]);
+			max[axis] = std::max(max[axis], vertices[i][axis]);
+		}
+	}
+	Vec3f center = (min + max) / 2.0f;
+	float radiusSquared = 0.0f;
+	for (std::size_t i = 0; i < vertexCount; ++i) {
+		radiusSquared = std::max(radiusSquared, (vertices[i] - center).lengthSquared());
+	}
+	boundingSphere = Vec4f{center.x(), center.y(), center.z(), std::sqrt(radiusSquared) + maxRadius};
 }
 
 OptixTraversableHandle Mesh::getGAS(CudaStream::Ptr stream)
 {
+	waitForStreaming(); // Scenes use only ready meshes, so it does not block graph runs
+	if (activeKeyframe.has_value()) {
+		return keyframes[*activeKeyframe]->gas;
+	}
+	if (gasNeedsUpdate) {
+		// Pending compaction would race with the update. Compacted GAS is too small to be updated in-place, so rebuild it.
+		scratchpad.resetCompaction();
+		staticFrameCount = 0;
+		if (isGASCompacted) {
+			cachedGAS.reset();
+		}
+	}
 	if (!cachedGAS.has_value()) {
 		cachedGAS = buildGAS(stream);
+		gasVersion += 1;
 	}
 	if (gasNeedsUpdate) {
 		updateGAS(stream);
+		gasVersion += 1;
 	}
 	return *cachedGAS;
 }
@@ -70,83 +626,206 @@ void Mesh::updateGAS(CudaStream::Ptr stream)
 	// OptiX update disallows buffer sizes to change
 	OptixBuildInput updateInput = buildInput;
 	const CUdeviceptr vertexBuffers[1] = {dVertices->getDeviceReadPtr()};
-	updateInput.triangleArray.vertexBuffers = vertexBuffers;
-	updateInput.triangleArray.indexBuffer = dIndices->getDeviceReadPtr();
+	if (primitiveType == MESH_PRIMITIVE_TRIANGLES) {
+		updateInput.triangleArray.vertexBuffers = vertexBuffers;
+		updateInput.triangleArray.indexBuffer = dIndices->getDeviceReadPtr();
+	}
+	if (primitiveType == MESH_PRIMITIVE_CURVES) {
+		updateInput.curveArray.vertexBuffers = vertexBuffers;
+	}
+#if OPTIX_VERSION >= 70500
+	if (primitiveType == MESH_PRIMITIVE_SPHERES) {
+		updateInput.sphereArray.vertexBuffers = vertexBuffers;
+	}
+#endif
 
-	scratchpad.resizeToFit(updateInput, updateOptions);
+	scratchpad.resizeToFit(updateInput, updateOptions, true);
+	auto temp = SharedASBuildTemp::acquire(scratchpad.requiredTempBytes, stream);
 
 	// Fun fact: calling optixAccelBuild does not change anything visually, but introduces a significant slowdown
 	// Investigation is needed whether it needs to be called at all (OptiX documentation says yes, but it works without)
-	CHECK_OPTIX(optixAccelBuild(
-	    Optix::getOrCreate().context, stream->getHandle(), &updateOptions, &updateInput, 1,
-	    scratchpad.dTemp->getDeviceReadPtr(), scratchpad.dTemp->getSizeOf() * scratchpad.dTemp->getCount(),
-	    scratchpad.dFull->getDeviceReadPtr(), scratchpad.dFull->getSizeOf() * scratchpad.dFull->getCount(), &cachedGAS.value(),
-	    nullptr, // &emitDesc,
-	    0));
-
-	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+	CHECK_OPTIX(optixAccelBuild(Optix::getOrCreate().context, stream->getHandle(), &updateOptions, &updateInput, 1, temp.ptr,
+	                            temp.bytes, scratchpad.dFull->getDeviceReadPtr(),
+	                            scratchpad.dFull->getSizeOf() * scratchpad.dFull->getCount(), &cachedGAS.value(),
+	                            nullptr, // &emitDesc,
+	                            0));
+	PerformanceCounters::instance().gasBuildCount.fetch_add(1, std::memory_order_relaxed);
 
 	gasNeedsUpdate = false;
 }
 
 OptixTraversableHandle Mesh::buildGAS(CudaStream::Ptr stream)
 {
-	triangleInputFlags = OPTIX_GEOMETRY_FLAG_DISABLE_ANYHIT;
+	inputFlags = OPTIX_GEOMETRY_FLAG_DISABLE_ANYHIT;
 	vertexBuffers[0] = dVertices->getDeviceReadPtr();
+	radiusBuffers[0] = dRadii->getDeviceReadPtr();
 
-	buildInput = {
-	    .type = OPTIX_BUILD_INPUT_TYPE_TRIANGLES,
-	    .triangleArray = {
-	                      .vertexBuffers = vertexBuffers,
-	                      .numVertices = static_cast<unsigned int>(dVertices->getCount()),
-	                      .vertexFormat = OPTIX_VERTEX_FORMAT_FLOAT3,
-	                      .vertexStrideInBytes = sizeof(decltype(dVertices)::element_type::DataType),
-	                      .indexBuffer = dIndices->getDeviceReadPtr(),
-	                      .numIndexTriplets = static_cast<unsigned int>(dIndices->getCount()),
-	                      .indexFormat = OPTIX_INDICES_FORMAT_UNSIGNED_INT3,
-	                      .indexStrideInBytes = sizeof(decltype(dIndices)::element_type::DataType),
-	                      .flags = &triangleInputFlags,
-	                      .numSbtRecords = 1,
-	                      .sbtIndexOffsetBuffer = 0,
-	                      .sbtIndexOffsetSizeInBytes = 0,
-	                      .sbtIndexOffsetStrideInBytes = 0,
-	                      }
-    };
-
-	buildOptions = {.buildFlags = OPTIX_BUILD_FLAG_PREFER_FAST_TRACE | OPTIX_BUILD_FLAG_ALLOW_UPDATE,
-	                // | OPTIX_BUILD_FLAG_ALLOW_COMPACTION, // Temporarily disabled
+	if (primitiveType == MESH_PRIMITIVE_TRIANGLES) {
+		buildInput = {
+		    .type = OPTIX_BUILD_INPUT_TYPE_TRIANGLES,
+		    .triangleArray = {
+		                      .vertexBuffers = vertexBuffers,
+		                      .numVertices = static_cast<unsigned int>(dVertices->getCount()),
+		                      .vertexFormat = OPTIX_VERTEX_FORMAT_FLOAT3,
+		                      .vertexStrideInBytes = sizeof(decltype(dVertices)::element_type::DataType),
+		                      .indexBuffer = dIndices->getDeviceReadPtr(),
+		                      .numIndexTriplets = static_cast<unsigned int>(dIndices->getCount()),
+		                      .indexFormat = OPTIX_INDICES_FORMAT_UNSIGNED_INT3,
+		                      .indexStrideInBytes = sizeof(decltype(dIndices)::element_type::DataType),
+		                      .flags = &inputFlags,
+		                      .numSbtRecords = 1,
+		                      .sbtIndexOffsetBuffer = 0,
+		                      .sbtIndexOffsetSizeInBytes = 0,
+		                      .sbtIndexOffsetStrideInBytes = 0,
+		                      }
+        };
+#if OPTIX_VERSION >= 70600
+		if (dOpacityMicromapIndices->getCount() > 0) {
+			opacityMicromapUsage.count = static_cast<unsigned>(opacityMicromapUsageCount);
+			opacityMicromapUsage.subdivisionLevel = opacityMicromapSubdivisionLevel;
+			opacityMicromapUsage.format = OPTIX_OPACITY_MICROMAP_FORMAT_2_STATE;
+			OptixBuildInputOpacityMicromap& micromap = buildInput.triangleArray.opacityMicromap;
+			micromap.indexingMode = OPTIX_OPACITY_MICROMAP_ARRAY_INDEXING_MODE_INDEXED;
+			micromap.opacityMicromapArray = dOpacityMicromapArray->getDeviceReadPtr();
+			micromap.indexBuffer = dOpacityMicromapIndices->getDeviceReadPtr();
+			micromap.indexSizeInBytes = sizeof(int32_t);
+			micromap.indexStrideInBytes = sizeof(int32_t);
+			micromap.numMicromapUsageCounts = opacityMicromapUsageCount > 0 ? 1 : 0;
+			micromap.micromapUsageCounts = &opacityMicromapUsage;
+		}
+#endif
+	}
+	if (primitiveType == MESH_PRIMITIVE_CURVES) {
+		// OptiX names radii of curves widths.
+		buildInput = {
+		    .type = OPTIX_BUILD_INPUT_TYPE_CURVES,
+		    .curveArray = {
+		                   .curveType = OPTIX_PRIMITIVE_TYPE_ROUND_LINEAR,
+		                   .numPrimitives = static_cast<unsigned int>(dSegmentIndices->getCount()),
+		                   .vertexBuffers = vertexBuffers,
+		                   .numVertices = static_cast<unsigned int>(dVertices->getCount()),
+		                   .vertexStrideInBytes = sizeof(Vec3f),
+		                   .widthBuffers = radiusBuffers,
+		                   .widthStrideInBytes = sizeof(float),
+		                   .indexBuffer = dSegmentIndices->getDeviceReadPtr(),
+		                   .indexStrideInBytes = sizeof(uint32_t),
+		                   .flag = inputFlags,
+		                   }
+        };
+	}
+#if OPTIX_VERSION >= 70500
+	if (primitiveType == MESH_PRIMITIVE_SPHERES) {
+		buildInput = {
+		    .type = OPTIX_BUILD_INPUT_TYPE_SPHERES,
+		    .sphereArray = {
+		                    .vertexBuffers = vertexBuffers,
+		                    .vertexStrideInBytes = sizeof(Vec3f),
+		                    .numVertices = static_cast<unsigned int>(dVertices->getCount()),
+		                    .radiusBuffers = radiusBuffers,
+		                    .radiusStrideInBytes = sizeof(float),
+		                    .flags = &inputFlags,
+		                    .numSbtRecords = 1,
+		                    }
+        };
+	}
+#endif
+
+	// Compaction yields around 10% of memory save-up, but it is slow (e.g. 500us per model).
+	// Therefore, it is opt-in and done asynchronously later, see progressGASCompaction().
+	bool allowCompaction = false;
+	Scene::forEach([&allowCompaction](Scene& scene) { allowCompaction |= scene.isGASCompactionEnabled(); });
+	buildOptions = {.buildFlags = OPTIX_BUILD_FLAG_PREFER_FAST_TRACE | OPTIX_BUILD_FLAG_ALLOW_UPDATE |
+	                              (allowCompaction ? OPTIX_BUILD_FLAG_ALLOW_COMPACTION : 0),
 	                .operation = OPTIX_BUILD_OPERATION_BUILD};
 
-	scratchpad.resizeToFit(buildInput, buildOptions);
+	scratchpad.resetCompaction();
+	scratchpad.resizeToFit(buildInput, buildOptions, true);
+	auto temp = SharedASBuildTemp::acquire(scratchpad.requiredTempBytes, stream);
 
-	// OptixAccelEmitDesc emitDesc = {
-	// .result = scratchpad.dCompactedSize.readDeviceRaw(),
-	// .type = OPTIX_PROPERTY_TYPE_COMPACTED_SIZE,
-	// };
+	OptixAccelEmitDesc emitDesc = {
+	    .result = scratchpad.dCompactedSize->getDeviceReadPtr(),
+	    .type = OPTIX_PROPERTY_TYPE_COMPACTED_SIZE,
+	};
 
 	OptixTraversableHandle gasHandle;
 	CHECK_OPTIX(optixAccelBuild(
-	    Optix::getOrCreate().context, stream->getHandle(), &buildOptions, &buildInput, 1, scratchpad.dTemp->getDeviceReadPtr(),
-	    scratchpad.dTemp->getSizeOf() * scratchpad.dTemp->getCount(), scratchpad.dFull->getDeviceReadPtr(),
-	    scratchpad.dFull->getSizeOf() * scratchpad.dFull->getCount(), &gasHandle,
-	    nullptr, // &emitDesc,
-	    0));
-
-	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
-
-	// Compaction yields around 10% of memory save-up and slows down a lot (e.g. 500us per model)
-	// scratchpad.doCompaction(gasHandle);
+	    Optix::getOrCreate().context, stream->getHandle(), &buildOptions, &buildInput, 1, temp.ptr, temp.bytes,
+	    scratchpad.dFull->getDeviceReadPtr(), scratchpad.dFull->getSizeOf() * scratchpad.dFull->getCount(), &gasHandle,
+	    allowCompaction ? &emitDesc : nullptr, allowCompaction ? 1 : 0));
+	PerformanceCounters::instance().gasBuildCount.fetch_add(1, std::memory_order_relaxed);
 
 	gasNeedsUpdate = false;
+	isGASCompacted = false;
+	staticFrameCount = 0;
 	return gasHandle;
 }
 
+bool Mesh::progressGASCompaction(CudaStream::Ptr stream, std::size_t staticFrameThreshold)
+{
+	bool isCompactionAllowed = (buildOptions.buildFlags & OPTIX_BUILD_FLAG_ALLOW_COMPACTION) != 0;
+	if (!cachedGAS.has_value() || gasNeedsUpdate || isGASCompacted || !isCompactionAllowed) {
+		return false;
+	}
+	if (staticFrameCount < staticFrameThreshold) {
+		staticFrameCount += 1;
+		return false;
+	}
+	isGASCompacted = scratchpad.progressCompaction(*cachedGAS, stream);
+	return isGASCompacted;
+}
+
+void Mesh::evictGAS()
+{
+	// Compressed mesh has no exact vertices to build GAS from.
+	if (!cachedGAS.has_value() || isDataCompressed) {
+		return;
+	}
+	scratchpad.release();
+	cachedGAS.reset();
+	isGASCompacted = false;
+	staticFrameCount = 0;
+}
+
+std::size_t Mesh::getGASBytes() const
+{
+	std::size_t bytes = scratchpad.getAllocatedBytes();
+	for (auto&& keyframe : keyframes) {
+		bytes += keyframe->scratchpad.getAllocatedBytes();
+	}
+	return bytes;
+}
+
+std::size_t Mesh::getGeometryBytes() const
+{
+	std::size_t bytes = dVertices->getCapacity() * sizeof(Vec3f) + dIndices->getCapacity() * sizeof(Vec3i) +
+	                    dVertexSkinningDisplacement->getCapacity() * sizeof(Vec3f) +
+	                    (dIndices16->getCapacity() + dVerticesHalf->getCapacity()) * sizeof(uint16_t) +
+	                    dVerticesSnorm->getCapacity() * sizeof(int16_t) + dRadii->getCapacity() * sizeof(float) +
+	                    dSegmentIndices->getCapacity() * sizeof(uint32_t) + dOpacityMicromapArray->getCapacity() +
+	                    dOpacityMicromapIndices->getCapacity() * sizeof(int32_t);
+	if (dTextureCoords.has_value()) {
+		bytes += (*dTextureCoords)->getCapacity() * sizeof(Vec2f);
+	}
+	for (auto&& keyframe : keyframes) {
+		bytes += keyframe->dVertices->getCapacity() * sizeof(Vec3f);
+	}
+	if (skinning.has_value()) {
+		bytes += skinning->dBindPoseVertices->getCapacity() * sizeof(Vec3f) +
+		         skinning->dBoneIndices->getCapacity() * sizeof(Vec4i) +
+		         skinning->dBoneWeights->getCapacity() * sizeof(Vec4f) + skinning->dBones->getCapacity() * sizeof(Mat3x4f);
+	}
+	return bytes;
+}
+
 void Mesh::setTexCoords(const Vec2f* texCoords, std::size_t texCoordCount)
 {
-	if (texCoordCount != dVertices->getCount()) {
+	waitForStreaming();
+	cacheKey.reset();
+	throwIfNotTriangles("set texture coordinates of");
+	if (texCoordCount != getVertexCount()) {
 		auto msg = fmt::format("Invalid argument: cannot set texture coordinates because vertex count do not match with "
 		                       "texture coordinates count: vertices={}, textureCoords={}",
-		                       dVertices->getCount(), texCoordCount);
+		                       getVertexCount(), texCoordCount);
 		throw std::invalid_argument(msg);
 	}
 
@@ -155,12 +834,238 @@ void Mesh::setTexCoords(const Vec2f* texCoords, std::size_t texCoordCount)
 	}
 
 	dTextureCoords.value()->copyFromExternal(texCoords, texCoordCount);
-	gasNeedsUpdate = true;
-	Scene::instance().requestSBTRebuild();
+	Scene::forEach([](Scene& scene) { scene.requestSBTRebuild(); });
+}
+
+void Mesh::setOpacityMicromap(const uint8_t* alpha, int width, int height, float alphaCutoff, int subdivisionLevel)
+{
+	waitForStreaming();
+	cacheKey.reset();
+	throwIfNotTriangles("set opacity micromap of");
+#if OPTIX_VERSION < 70600
+	throw std::invalid_argument("Invalid argument: opacity micromaps require OptiX 7.6 or newer");
+#else
+	if (isDataCompressed) {
+		// GAS would have to be built again, from the exact vertices.
+		throw std::invalid_argument("Invalid argument: cannot set opacity micromap of a compressed mesh");
+	}
+	if (!dTextureCoords.has_value()) {
+		throw std::invalid_argument("Invalid argument: opacity micromap requires texture coordinates of the mesh");
+	}
+	if (subdivisionLevel < 0 || subdivisionLevel > OPTIX_OPACITY_MICROMAP_MAX_SUBDIVISION_LEVEL) {
+		auto msg = fmt::format("Invalid argument: opacity micromap subdivision level ({}) is out of range [0, {}]",
+		                       subdivisionLevel, OPTIX_OPACITY_MICROMAP_MAX_SUBDIVISION_LEVEL);
+		throw std::invalid_argument(msg);
+	}
+
+	CudaStream::Ptr stream = getStream();
+	std::size_t triangleCount = dIndices->getCount();
+	std::vector<Vec3i> indices(triangleCount);
+	std::vector<Vec2f> texCoords((*dTextureCoords)->getCount());
+	CHECK_CUDA(cudaMemcpyAsync(indices.data(), dIndices->getReadPtr(), sizeof(Vec3i) * indices.size(), cudaMemcpyDeviceToHost,
+	                           stream->getHandle()));
+	CHECK_CUDA(cudaMemcpyAsync(texCoords.data(), (*dTextureCoords)->getReadPtr(), sizeof(Vec2f) * texCoords.size(),
+	                           cudaMemcpyDeviceToHost, stream->getHandle()));
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+
+	auto isOpaque = [&](const Vec2f& uv) {
+		// Nearest texel, wrapped as in the texture objects (see Texture).
+		int x = static_cast<int>(std::floor(uv[0] * static_cast<float>(width))) % width;
+		int y = static_cast<int>(std::floor(uv[1] * static_cast<float>(height))) % height;
+		x = x < 0 ? x + width : x;
+		y = y < 0 ? y + height : y;
+		return static_cast<float>(alpha[y * width + x]) / 255.0f >= alphaCutoff;
+	};
+
+	// Two states (one bit) per micro-triangle, so that no any-hit program has to resolve unknown ones.
+	const unsigned microTriangleCount = 1u << (2 * subdivisionLevel);
+	const std::size_t micromapBytes = (microTriangleCount + 7) / 8;
+	std::vector<uint8_t> micromapData;
+	std::vector<OptixOpacityMicromapDesc> micromapDescs;
+	std::map<std::vector<uint8_t>, int32_t> micromapsByData;
+	std::vector<int32_t> micromapIndices(triangleCount);
+	std::size_t usageCount = 0;
+	std::vector<uint8_t> states(micromapBytes);
+	for (std::size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		const Vec2f& uvA = texCoords[indices[triangle].x()];
+		const Vec2f& uvB = texCoords[indices[triangle].y()];
+		const Vec2f& uvC = texCoords[indices[triangle].z()];
+		std::fill(states.begin(), states.end(), 0);
+		unsigned opaqueCount = 0;
+		for (unsigned micro = 0; micro < microTriangleCount; ++micro) {
+			float2 b0, b1, b2;
+			optixMicromapIndexToBaseBarycentrics(micro, subdivisionLevel, b0, b1, b2);
+			float u = (b0.x + b1.x + b2.x) / 3.0f;
+			float v = (b0.y + b1.y + b2.y) / 3.0f;
+			if (isOpaque((1 - u - v) * uvA + u * uvB + v * uvC)) {
+				states[micro / 8] |= static_cast<uint8_t>(1u << (micro % 8));
+				opaqueCount += 1;
+			}
+		}
+		if (opaqueCount == 0 || opaqueCount == microTriangleCount) {
+			micromapIndices[triangle] = opaqueCount == 0 ? OPTIX_OPACITY_MICROMAP_PREDEFINED_INDEX_FULLY_TRANSPARENT
+			                                             : OPTIX_OPACITY_MICROMAP_PREDEFINED_INDEX_FULLY_OPAQUE;
+			continue;
+		}
+		auto [it, isNew] = micromapsByData.emplace(states, static_cast<int32_t>(micromapDescs.size()));
+		if (isNew) {
+			OptixOpacityMicromapDesc& desc = micromapDescs.emplace_back();
+			desc.byteOffset = static_cast<unsigned>(micromapData.size());
+			desc.subdivisionLevel = static_cast<unsigned short>(subdivisionLevel);
+			desc.format = OPTIX_OPACITY_MICROMAP_FORMAT_2_STATE;
+			micromapData.insert(micromapData.end(), states.begin(), states.end());
+		}
+		micromapIndices[triangle] = it->second;
+		usageCount += 1;
+	}
+	if (micromapDescs.empty()) {
+		// Array must not be empty; this one is not referenced by any triangle.
+		OptixOpacityMicromapDesc& desc = micromapDescs.emplace_back();
+		desc.byteOffset = 0;
+		desc.subdivisionLevel = 0;
+		desc.format = OPTIX_OPACITY_MICROMAP_FORMAT_2_STATE;
+		micromapData.push_back(1);
+	}
+
+	auto dMicromapData = DeviceSyncArray<uint8_t>::create();
+	auto dMicromapDescs = DeviceSyncArray<OptixOpacityMicromapDesc>::create();
+	ArrayCopyBatch micromapCopy{stream};
+	micromapCopy.copyFromExternal<uint8_t>(dMicromapData, micromapData.data(), micromapData.size());
+	micromapCopy.copyFromExternal<OptixOpacityMicromapDesc>(dMicromapDescs, micromapDescs.data(), micromapDescs.size());
+	micromapCopy.copyFromExternal<int32_t>(dOpacityMicromapIndices, micromapIndices.data(), micromapIndices.size());
+	micromapCopy.execute();
+
+	OptixOpacityMicromapHistogramEntry histogram = {};
+	histogram.count = static_cast<unsigned>(micromapDescs.size());
+	histogram.subdivisionLevel = micromapDescs.front().subdivisionLevel;
+	histogram.format = OPTIX_OPACITY_MICROMAP_FORMAT_2_STATE;
+	OptixOpacityMicromapArrayBuildInput micromapInput = {};
+	micromapInput.flags = OPTIX_OPACITY_MICROMAP_FLAG_PREFER_FAST_TRACE;
+	micromapInput.inputBuffer = dMicromapData->getDeviceReadPtr();
+	micromapInput.perMicromapDescBuffer = dMicromapDescs->getDeviceReadPtr();
+	micromapInput.perMicromapDescStrideInBytes = sizeof(OptixOpacityMicromapDesc);
+	micromapInput.numMicromapHistogramEntries = 1;
+	micromapInput.micromapHistogramEntries = &histogram;
+	OptixMicromapBufferSizes micromapSizes = {};
+	CHECK_OPTIX(optixOpacityMicromapArrayComputeMemoryUsage(Optix::getOrCreate().context, &micromapInput, &micromapSizes));
+	auto dTemp = DeviceSyncArray<std::byte>::create();
+	dTemp->resize(micromapSizes.tempSizeInBytes, false, false);
+	dOpacityMicromapArray->resize(micromapSizes.outputSizeInBytes, false, false);
+	OptixMicromapBuffers micromapBuffers = {};
+	micromapBuffers.output = dOpacityMicromapArray->getDeviceReadPtr();
+	micromapBuffers.outputSizeInBytes = micromapSizes.outputSizeInBytes;
+	micromapBuffers.temp = dTemp->getDeviceReadPtr();
+	micromapBuffers.tempSizeInBytes = micromapSizes.tempSizeInBytes;
+	CHECK_OPTIX(optixOpacityMicromapArrayBuild(Optix::getOrCreate().context, stream->getHandle(), &micromapInput,
+	                                           &micromapBuffers));
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle())); // Inputs and temp are released on return
+	opacityMicromapUsageCount = usageCount;
+	opacityMicromapSubdivisionLevel = subdivisionLevel;
+
+	// Micromaps are a part of the build input, so GAS is built again by the next getGAS.
+	scratchpad.resetCompaction();
+	cachedGAS.reset();
+	isGASCompacted = false;
+	Scene::forEach([](Scene& scene) { scene.requestASRebuild(); });
+#endif
+}
+
+void Mesh::compress(rgl_vertex_format_t vertexFormat)
+{
+	waitForStreaming();
+	cacheKey.reset();
+	throwIfNotTriangles("compress");
+	if (isDataCompressed) {
+		throw std::invalid_argument("Invalid argument: mesh is already compressed");
+	}
+	if (skinning.has_value()) {
+		throw std::invalid_argument("Invalid argument: cannot compress a skinned mesh");
+	}
+	CudaStream::Ptr stream = getStream();
+	getGAS(stream);
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+
+	std::size_t vertexCount = dVertices->getCount();
+	std::size_t triangleCount = dIndices->getCount();
+	if (vertexCount <= std::numeric_limits<uint16_t>::max() + 1) {
+		std::vector<Vec3i> indices(triangleCount);
+		CHECK_CUDA(cudaMemcpy(indices.data(), dIndices->getReadPtr(), sizeof(Vec3i) * triangleCount, cudaMemcpyDeviceToHost));
+		std::vector<uint16_t> indices16(3 * triangleCount);
+		for (std::size_t i = 0; i < indices16.size(); ++i) {
+			indices16[i] = static_cast<uint16_t>(indices[i / 3][static_cast<int>(i % 3)]);
+		}
+		dIndices16->copyFromExternal(indices16.data(), indices16.size());
+		dIndices = DeviceSyncArray<Vec3i>::create();
+	}
+
+	if (vertexFormat != RGL_VERTEX_FORMAT_FLOAT32) {
+		std::vector<Vec3f> vertices(vertexCount);
+		CHECK_CUDA(cudaMemcpy(vertices.data(), dVertices->getReadPtr(), sizeof(Vec3f) * vertexCount, cudaMemcpyDeviceToHost));
+		if (vertexFormat == RGL_VERTEX_FORMAT_FLOAT16) {
+			std::vector<uint16_t> verticesHalf(3 * vertexCount);
+			for (std::size_t i = 0; i < verticesHalf.size(); ++i) {
+				__half value = __float2half_rn(vertices[i / 3][static_cast<int>(i % 3)]);
+				std::memcpy(&verticesHalf[i], &value, sizeof(uint16_t));
+			}
+			dVerticesHalf->copyFromExternal(verticesHalf.data(), verticesHalf.size());
+		}
+		if (vertexFormat == RGL_VERTEX_FORMAT_SNORM16) {
+			// Normalized to the AABB of the mesh, so that precision depends on its size rather than position.
+			Vec3f min = vertices.empty() ? Vec3f{0.0f} : vertices[0];
+			Vec3f max = min;
+			for (auto&& vertex : vertices) {
+				for (int axis = 0; axis < 3; ++axis) {
+					min[axis] = std::min(min[axis], vertex[axis]);
+					max[axis] = std::max(max[axis], vertex[axis]);
+				}
+			}
+			verticesSnormOffset = (min + max) / 2.0f;
+			for (int axis = 0; axis < 3; ++axis) {
+				float halfExtent = (max[axis] - min[axis]) / 2.0f;
+				verticesSnormScale[axis] = halfExtent > 0.0f ? halfExtent : 1.0f;
+			}
+			std::vector<int16_t> verticesSnorm(3 * vertexCount);
+			for (std::size_t i = 0; i < verticesSnorm.size(); ++i) {
+				int axis = static_cast<int>(i % 3);
+				float normalized = (vertices[i / 3][axis] - verticesSnormOffset[axis]) / verticesSnormScale[axis];
+				verticesSnorm[i] = static_cast<int16_t>(std::lround(std::clamp(normalized, -1.0f, 1.0f) * 32767.0f));
+			}
+			dVerticesSnorm->copyFromExternal(verticesSnorm.data(), verticesSnorm.size());
+		}
+		dVertices = DeviceSyncArray<Vec3f>::create();
+	}
+
+	// Vertices cannot be updated anymore, so neither can they be displaced.
+	dVertexSkinningDisplacement = DeviceSyncArray<Vec3f>::create();
+	hVerticesStaging = HostPinnedArray<Vec3f>::create();
+	verticesUpdateTimes.clear();
+	isDataCompressed = true;
+	Scene::forEach([](Scene& scene) { scene.requestSBTRebuild(); });
 }
-const Vec3f* Mesh::getSkinningDisplacementSinceLastFrame() const
+
+std::size_t Mesh::getVertexCount() const
+{
+	waitForStreaming();
+	if (dVerticesHalf->getCount() > 0) {
+		return dVerticesHalf->getCount() / 3;
+	}
+	if (dVerticesSnorm->getCount() > 0) {
+		return dVerticesSnorm->getCount() / 3;
+	}
+	return dVertices->getCount();
+}
+
+std::size_t Mesh::getTriangleCount() const
+{
+	waitForStreaming();
+	return dIndices16->getCount() > 0 ? dIndices16->getCount() / 3 : dIndices->getCount();
+}
+
+const Vec3f* Mesh::getSkinningDisplacementSinceLastFrame(const Scene& scene) const
 {
-	if (!verticesFormerUpdateTime.has_value() || verticesFormerUpdateTime != Scene::instance().getPrevTime()) {
+	auto times = verticesUpdateTimes.find(scene.getId());
+	if (times == verticesUpdateTimes.end() || !times->second.former.has_value() ||
+	    times->second.former != scene.getPrevTime()) {
 		return nullptr;
 	}
 	return dVertexSkinningDisplacement->getReadPtr();
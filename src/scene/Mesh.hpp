@@ -19,16 +19,28 @@
 #include <optix_stubs.h>
 
 #include <APIObject.hpp>
+#include <CudaEvent.hpp>
 #include <Optix.hpp>
 #include <math/Vector.hpp>
+#include <math/Mat3x4f.hpp>
 #include <macros/cuda.hpp>
 #include <macros/optix.hpp>
 #include <scene/ASBuildScratchpad.hpp>
 
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 #include <memory/Array.hpp>
 #include <Time.hpp>
 
+struct Scene;
+
 /**
  * Represents mesh data (at the moment vertices and indices) stored on the GPU.
  * Mesh, on its own, is not bound to any scene and can be used for different scenes.
@@ -38,53 +50,327 @@ struct Mesh : APIObject<Mesh>
 	friend APIObject<Mesh>;
 	friend struct Scene;
 
+	/**
+	 * Describes geometry of a mesh, used to create meshes in batches.
+	 */
+	struct Geometry
+	{
+		const Vec3f* vertices;
+		std::size_t vertexCount;
+		const Vec3i* indices;
+		std::size_t indexCount;
+	};
+
+	/**
+	 * Returns the stream shared by all meshes, in which their data is uploaded and GASes are built and updated.
+	 * Meshes may be used by multiple scenes, so they cannot use a stream of any of them; see Scene::enqueueWaitForMeshes().
+	 */
+	static CudaStream::Ptr getStream();
+
+	/**
+	 * Queues builds (and updates) of GASes of the given meshes, spread over multiple streams, so that small builds
+	 * run concurrently instead of one after another. Streams are ordered after the mesh stream (e.g. vertex updates)
+	 * and the mesh stream is ordered after them, so that no host synchronization is needed; getGAS returns built GASes.
+	 */
+	static void buildGASes(const std::vector<std::shared_ptr<Mesh>>& meshes);
+
+	/**
+	 * Creates multiple meshes at once. All data is staged through a single pinned buffer and copied asynchronously.
+	 * GASes are built eagerly, the stream is synchronized once at the end.
+	 */
+	static std::vector<std::shared_ptr<Mesh>> createBatch(const std::vector<Geometry>& geometries, CudaStream::Ptr stream);
+
+	/**
+	 * Configures retaining meshes released by the client (see retainReleased), so that createCached returns them again
+	 * instead of uploading the same geometry and building its GAS anew, e.g. when a map is loaded again after rgl_cleanup.
+	 * Retained meshes exceeding the budget are freed, least recently retained first; disabling frees all of them.
+	 */
+	static void configureCache(bool enabled, std::size_t budgetBytes);
+
+	/**
+	 * Creates a mesh, or registers again (with a new handle) a retained mesh of identical vertices and indices.
+	 */
+	static std::shared_ptr<Mesh> createCached(const Vec3f* vertices, std::size_t vertexCount, const Vec3i* indices,
+	                                          std::size_t indexCount);
+
+	/**
+	 * Retains the mesh being released by the client, if it was created by createCached and has not been modified since.
+	 */
+	static void retainReleased(std::shared_ptr<Mesh> mesh);
+
+	static void forEachRetained(const std::function<void(Mesh&)>& fn);
+
+	/**
+	 * Creates a mesh without waiting for its data to be uploaded and its GAS to be built; both are done in the background
+	 * by MeshStreamer, in a stream of its own, so graph runs using the mesh stream (see getStream()) are not stalled.
+	 * Until the mesh is ready, scenes keep its entities out of their snapshots (see Scene::addEntity) and operations
+	 * on the mesh (other than isReady) wait for the upload.
+	 */
+	static std::shared_ptr<Mesh> createStreamed(std::vector<Vec3f> vertices, std::vector<Vec3i> indices);
+
+	/**
+	 * Creates a mesh of spheres (e.g. particles or leaves), intersected by OptiX built-in programs instead of being
+	 * tessellated into triangles; GAS then holds one primitive per sphere. Requires OptiX 7.5 or newer.
+	 * Vertices of the mesh are centers of the spheres, so they can be updated as vertices of triangle meshes.
+	 */
+	static std::shared_ptr<Mesh> createSpheres(const Vec3f* centers, const float* radii, std::size_t sphereCount);
+
+	/**
+	 * Creates a mesh of round linear curves (e.g. cables or grass blades), intersected by OptiX built-in programs.
+	 * Segment i is a tube from vertex segmentIndices[i] to the next vertex, with radius interpolated linearly between them,
+	 * so a polyline of n vertices takes n - 1 segments. Vertices can be updated as vertices of triangle meshes.
+	 */
+	static std::shared_ptr<Mesh> createCurves(const Vec3f* vertices, const float* radii, std::size_t vertexCount,
+	                                          const uint32_t* segmentIndices, std::size_t segmentCount);
+
+	/**
+	 * Batched version of updateVertices. All data is staged through a single pinned buffer and copied asynchronously.
+	 * The stream is synchronized once at the end. Vertex counts must remain unchanged, otherwise an exception is thrown.
+	 */
+	static void updateVerticesBatch(const std::vector<std::shared_ptr<Mesh>>& meshes,
+	                                const std::vector<std::pair<const Vec3f*, std::size_t>>& vertices, CudaStream::Ptr stream);
+
 	/**
 	 * Updates vertices of this mesh. Vertex count must remain unchanged, otherwise an exception is thrown.
+	 * Vertices are staged in a pinned buffer and the update is queued in the mesh stream, without synchronizing it.
 	 * After this operation, GAS needs to be rebuilt. This is handled internally in getGAS.
 	 */
 	void updateVertices(const Vec3f* vertices, std::size_t vertexCount);
 
+	/**
+	 * Registers states of vertices repeated by a looped animation (e.g. a walk cycle, a rotating fan or a wheel),
+	 * each with a GAS of its own built up front, so that switching to a keyframe (see setKeyframe) needs neither
+	 * a vertex upload nor a GAS update. Vertices of all keyframes are given one after another, vertexCount per keyframe.
+	 * The mesh switches to the first keyframe. Meant to be done once, e.g. when loading an animated model.
+	 */
+	void setKeyframes(const Vec3f* vertices, std::size_t vertexCount, std::size_t keyframeCount);
+
+	/**
+	 * Switches the mesh to the given keyframe: GAS of the keyframe is used by scenes from now on, and its vertices
+	 * are copied on the device (as they are read by hit programs and give velocities, see updateVertices).
+	 * Queued in the mesh stream, without synchronizing it. Other modifications of vertices leave the keyframes.
+	 */
+	void setKeyframe(std::size_t keyframeIdx);
+	std::size_t getKeyframeCount() const { return keyframes.size(); }
+
+	/**
+	 * Makes the mesh skinned: its current vertices become the bind pose, deformed on the GPU by bone transforms
+	 * given in updateBones(). Influences (up to four bones per vertex) are uploaded once. Reads the vertices back to
+	 * compute bounds of the bones, so it is meant to be done once, e.g. when loading a character.
+	 */
+	void setSkinning(const Vec4i* boneIndices, const Vec4f* boneWeights, std::size_t vertexCount, std::size_t boneCount);
+
+	/**
+	 * Computes vertices of a skinned mesh (and their displacement, as updateVertices does) from the given bone transforms.
+	 * Only the transforms are staged and copied; skinning is queued in the mesh stream, without synchronizing it.
+	 */
+	void updateBones(const Mat3x4f* boneTransforms, std::size_t boneCount);
+
 	/**
 	 * Returns an array describing displacement of each vertex between current and previous state, due to skinning.
-	 * If vertices were not skinned in the previous frame, returns NULL (equivalent to an array of zero vectors).
+	 * If vertices were not skinned in the previous frame of the given scene, returns NULL (equivalent to an array of zeros).
 	 * @return Pointer do GPU-accessible array, same size as vertexCount. May be NULL.
 	 */
-	const Vec3f* getSkinningDisplacementSinceLastFrame() const;
+	const Vec3f* getSkinningDisplacementSinceLastFrame(const Scene& scene) const;
 
 	/**
 	 * Sets textures coordinates to the mesh. Vertex count and texture coordinates count must be equal.
-	 * After this operation, GAS needs to be rebuilt. This is handled internally in getGAS.
+	 * Texture coordinates are not a part of GAS, so it does not need to be rebuilt.
 	 */
 	void setTexCoords(const Vec2f* texCoords, std::size_t texCoordCount);
 
+	/**
+	 * Builds opacity micromaps of the triangles from the given alpha texture (R8 texels, sampled with wrapping at texture
+	 * coordinates of the mesh, see setTexCoords): each triangle is split into 4^subdivisionLevel micro-triangles, which are
+	 * opaque if alpha at their centers (normalized to [0, 1]) is at least alphaCutoff, and transparent otherwise.
+	 * Transparent micro-triangles are skipped by the hardware during traversal, so alpha-tested foliage needs no any-hit
+	 * program. Triangles of a single state need no micromap and identical micromaps are shared. GAS is built again.
+	 * Texture coordinates are read back and micromaps are computed on the host; meant to be done once, e.g. when loading.
+	 * Requires OptiX 7.6 or newer.
+	 */
+	void setOpacityMicromap(const uint8_t* alpha, int width, int height, float alphaCutoff, int subdivisionLevel);
+
+	/**
+	 * Stores indices in 16 bits (if there are at most 65536 vertices) and vertices in the given format, releasing the
+	 * exact data (see rgl_mesh_compress). GAS keeps its own copy of the geometry, so it is built from the exact vertices
+	 * beforehand; since it cannot be updated afterwards, vertices of compressed mesh cannot be updated either.
+	 * Data is converted on the host, which requires reading it back; meant to be done once, e.g. when loading a map.
+	 */
+	void compress(rgl_vertex_format_t vertexFormat);
+	bool isCompressed() const { return isDataCompressed; }
+
+	/**
+	 * Returns whether the data and GAS of the mesh are in device memory, i.e. if the mesh was not streamed (see
+	 * createStreamed) or its upload has completed successfully. Does not block.
+	 */
+	bool isReady() const;
+	bool isStreamingPending() const;
+
+	/**
+	 * Blocks until the streamed upload of the mesh (if any) completes; rethrows its error if it has failed.
+	 */
+	void waitForStreaming() const;
+
+	std::size_t getVertexCount() const;
+	std::size_t getTriangleCount() const; // Zero for spheres and curves
+
+	/**
+	 * Returns MESH_PRIMITIVE_* the mesh consists of; texture coordinates, skinning and compression need triangles.
+	 */
+	unsigned getPrimitiveType() const { return primitiveType; }
+
 	/**
 	 * Returns GAS for this mesh.
 	 * If no changes occurred (e.g. call to updateVertices), then returns cached GAS.
 	 * Otherwise, queues building GAS in the given stream, without synchronizing it.
 	 */
 	OptixTraversableHandle getGAS(CudaStream::Ptr stream);
+	bool isGASBuildPending() const { return !cachedGAS.has_value() || gasNeedsUpdate; }
+
+	/**
+	 * Progresses asynchronous compaction of GAS, which is started after GAS remained unchanged for the given number of frames.
+	 * Compaction is possible only if GAS was built when compaction was enabled in any Scene.
+	 * Does not block; compaction work is queued in the given stream.
+	 * @return True if GAS handle has changed, i.e. IAS needs to be refitted.
+	 */
+	bool progressGASCompaction(CudaStream::Ptr stream, std::size_t staticFrameThreshold);
+
+	/**
+	 * Releases GAS of the mesh to reclaim device memory, e.g. when the mesh has not been used by any scene for a while.
+	 * GAS is built again by the next call to getGAS. Must not be called while any scene version uses the GAS.
+	 * GAS of a compressed mesh is never evicted, since it could not be built again.
+	 */
+	void evictGAS();
+
+	/**
+	 * Returns device memory held by GAS (including its compacted copy) and by the geometry, respectively.
+	 */
+	std::size_t getGASBytes() const;
+	std::size_t getGeometryBytes() const;
+
+	/**
+	 * Returns the sphere bounding vertices of the mesh (xyz: center, w: radius) in mesh coordinates,
+	 * computed on the host from vertices given at creation or in the last update; used to cull instances.
+	 */
+	Vec4f getBoundingSphere() const { return boundingSphere; }
+
+	/**
+	 * Returns the number of builds and updates of GAS so far, i.e. changes of its contents not visible in its handle.
+	 */
+	uint64_t getGASVersion() const { return gasVersion; }
 
 private:
+	static constexpr std::size_t GAS_BUILD_STREAM_COUNT = 4; // See buildGASes()
+
 	Mesh(const Vec3f* vertices, std::size_t vertexCount, const Vec3i* indices, std::size_t indexCount);
 
+	// Allocates memory for the given geometry size, but leaves it uninitialized.
+	Mesh(std::size_t vertexCount, std::size_t indexCount);
+
+	// Leaves the mesh empty, i.e. to be filled by a streaming job.
+	Mesh() = default;
+
+	static HostPinnedArray<std::byte>::Ptr& getBatchStagingBuffer();
+	bool hasGeometry(const Vec3f* vertices, std::size_t vertexCount, const Vec3i* indices, std::size_t indexCount) const;
+	static void evictRetainedOverBudget(); // Requires cacheMutex
+	void throwIfNotTriangles(const char* operation) const;
+	void enqueueVerticesUpdate(const Vec3f* stagedVertices, std::size_t vertexCount, CudaStream::Ptr stream);
+	void updateBoundingSphere(const Vec3f* vertices, std::size_t vertexCount);
+	void markVerticesUpdated();
+
 	OptixTraversableHandle buildGAS(CudaStream::Ptr stream);
 	void updateGAS(CudaStream::Ptr stream);
 
 private:
 	ASBuildScratchpad scratchpad;
 	bool gasNeedsUpdate;
+	bool isGASCompacted{false};
+	std::size_t staticFrameCount{0};
 	std::optional<OptixTraversableHandle> cachedGAS;
+	uint64_t gasVersion{0};
+	uint64_t lastUsedEvictionPass{0}; // See Scene::evictUnusedGASes()
+	Vec4f boundingSphere{0.0f, 0.0f, 0.0f, 0.0f};
+
+	// Vertex count, index count and hash of the geometry given at creation, see createCached(); reset by modifications.
+	using CacheKey = std::tuple<std::size_t, std::size_t, uint64_t>;
+	std::optional<CacheKey> cacheKey;
+	static inline std::mutex cacheMutex;
+	static inline std::optional<std::size_t> cacheBudgetBytes; // Disabled if empty
+	static inline std::list<std::shared_ptr<Mesh>> retainedMeshes; // Least recently retained first
+
+	// Set by the streaming job once it finished (see createStreamed()); not valid for meshes created synchronously.
+	std::shared_future<void> streamingDone;
+	std::exception_ptr streamingError;
+
+	// Times of the last two vertex updates, in each scene's time (see Scene::getId()); all scenes may use the mesh.
+	struct VerticesUpdateTimes
+	{
+		std::optional<Time> current;
+		std::optional<Time> former;
+	};
+	std::unordered_map<uint64_t, VerticesUpdateTimes> verticesUpdateTimes;
+
+	// Staging buffer for updateVertices(); it may be overwritten once the event (recorded after the copy) completes.
+	// Declared before device arrays, so it is released after them (freeing device memory waits for pending copies).
+	HostPinnedArray<Vec3f>::Ptr hVerticesStaging = HostPinnedArray<Vec3f>::create();
+	CudaEvent::Ptr verticesStagingReleasedEvent = CudaEvent::create();
 
-	std::optional<Time> verticesCurrentUpdateTime;
-	std::optional<Time> verticesFormerUpdateTime;
 	DeviceSyncArray<Vec3f>::Ptr dVertices = DeviceSyncArray<Vec3f>::create();
 	DeviceSyncArray<Vec3i>::Ptr dIndices = DeviceSyncArray<Vec3i>::create();
 	DeviceSyncArray<Vec3f>::Ptr dVertexSkinningDisplacement = DeviceSyncArray<Vec3f>::create();
 	std::optional<DeviceSyncArray<Vec2f>::Ptr> dTextureCoords;
 
+	// See setSkinning(); bones are staged like vertices in updateVertices(), hence after the same event.
+	struct Skinning
+	{
+		HostPinnedArray<Mat3x4f>::Ptr hBonesStaging = HostPinnedArray<Mat3x4f>::create(); // Released after dBones
+		DeviceSyncArray<Vec3f>::Ptr dBindPoseVertices = DeviceSyncArray<Vec3f>::create();
+		DeviceSyncArray<Vec4i>::Ptr dBoneIndices = DeviceSyncArray<Vec4i>::create();
+		DeviceSyncArray<Vec4f>::Ptr dBoneWeights = DeviceSyncArray<Vec4f>::create();
+		DeviceSyncArray<Mat3x4f>::Ptr dBones = DeviceSyncArray<Mat3x4f>::create();
+		// Bind-pose AABB (min, max) of vertices influenced by each bone; skinned vertices lie within their transforms.
+		std::vector<std::pair<Vec3f, Vec3f>> boneBounds;
+	};
+	std::optional<Skinning> skinning;
+
+	// See setKeyframes(); GASes of keyframes share the build input (e.g. indices) of the mesh, except for vertices.
+	struct Keyframe
+	{
+		DeviceSyncArray<Vec3f>::Ptr dVertices = DeviceSyncArray<Vec3f>::create();
+		ASBuildScratchpad scratchpad;
+		OptixTraversableHandle gas;
+		Vec4f boundingSphere;
+	};
+	std::vector<std::unique_ptr<Keyframe>> keyframes;
+	std::optional<std::size_t> activeKeyframe; // Reset by other modifications of vertices, see markVerticesUpdated()
+
+	// Spheres and curves (see createSpheres and createCurves) have radii per vertex and no indices.
+	unsigned primitiveType{MESH_PRIMITIVE_TRIANGLES};
+	DeviceSyncArray<float>::Ptr dRadii = DeviceSyncArray<float>::create();
+	DeviceSyncArray<uint32_t>::Ptr dSegmentIndices = DeviceSyncArray<uint32_t>::create(); // First vertex of each segment
+	float maxRadius{0.0f}; // Added to the bounding sphere of vertices
+
+	// Opacity micromap array and micromap index of each triangle (or one of predefined indices), see setOpacityMicromap().
+	DeviceSyncArray<std::byte>::Ptr dOpacityMicromapArray = DeviceSyncArray<std::byte>::create();
+	DeviceSyncArray<int32_t>::Ptr dOpacityMicromapIndices = DeviceSyncArray<int32_t>::create();
+	std::size_t opacityMicromapUsageCount{0}; // Triangles using non-predefined micromaps
+	unsigned opacityMicromapSubdivisionLevel{0};
+
+	// Compressed alternatives of dVertices and dIndices (which are empty then), see compress().
+	bool isDataCompressed{false};
+	DeviceSyncArray<uint16_t>::Ptr dIndices16 = DeviceSyncArray<uint16_t>::create();     // Three per triangle
+	DeviceSyncArray<uint16_t>::Ptr dVerticesHalf = DeviceSyncArray<uint16_t>::create();  // Three per vertex
+	DeviceSyncArray<int16_t>::Ptr dVerticesSnorm = DeviceSyncArray<int16_t>::create();   // Three per vertex
+	Vec3f verticesSnormOffset{0.0f};
+	Vec3f verticesSnormScale{1.0f};
+
 	// Shared between buildGAS() and updateGAS()
 	OptixBuildInput buildInput;
 	CUdeviceptr vertexBuffers[1];
-	unsigned triangleInputFlags;
+	CUdeviceptr radiusBuffers[1];
+	unsigned inputFlags;
+#if OPTIX_VERSION >= 70600
+	OptixOpacityMicromapUsageCount opacityMicromapUsage;
+#endif
 	OptixAccelBuildOptions buildOptions;
 };
@@ -0,0 +1,74 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <scene/MeshStreamer.hpp>
+
+#include <Logger.hpp>
+#include <CudaDevice.hpp>
+#include <ThreadConfig.hpp>
+
+MeshStreamer& MeshStreamer::instance()
+{
+	static MeshStreamer streamer;
+	return streamer;
+}
+
+MeshStreamer::MeshStreamer() : worker(&MeshStreamer::workerMain, this) {}
+
+MeshStreamer::~MeshStreamer()
+{
+	{
+		std::lock_guard lock{mutex};
+		isShutdownRequested = true;
+	}
+	condition.notify_all();
+	worker.join();
+}
+
+void MeshStreamer::submit(std::function<void()> job)
+{
+	{
+		std::lock_guard lock{mutex};
+		pendingJobs.push_back(std::move(job));
+	}
+	condition.notify_one();
+}
+
+void MeshStreamer::workerMain()
+{
+	ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-mesh-stream"};
+	while (true) {
+		std::function<void()> job;
+		{
+			std::unique_lock lock{mutex};
+			condition.wait(lock, [this]() { return !pendingJobs.empty() || isShutdownRequested; });
+			if (isShutdownRequested) {
+				return;
+			}
+			job = std::move(pendingJobs.front());
+			pendingJobs.pop_front();
+		}
+		try {
+			CudaDevice::bindCurrentThread();
+			job();
+		}
+		catch (std::exception& e) {
+			RGL_ERROR("Mesh streaming job failed: {}", e.what());
+		}
+		catch (...) {
+			RGL_ERROR("Mesh streaming job failed with unknown exception");
+		}
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <CudaStream.hpp>
+
+/**
+ * Process-wide background thread uploading streamed meshes and building their GASes, see Mesh::createStreamed().
+ * Jobs are executed in order of submission, in a stream of their own (not Mesh::getStream()), so that neither client's
+ * threads nor graph runs (ordered after the mesh stream, see Scene::enqueueWaitForMeshes()) wait for them.
+ */
+struct MeshStreamer
+{
+	static MeshStreamer& instance();
+
+	/**
+	 * Queues a job executed by the streaming thread. Jobs report their errors on their own.
+	 */
+	void submit(std::function<void()> job);
+
+	CudaStream::Ptr getStream() const { return stream; }
+
+	MeshStreamer(const MeshStreamer&) = delete;
+	MeshStreamer(MeshStreamer&&) = delete;
+	MeshStreamer& operator=(const MeshStreamer&) = delete;
+	MeshStreamer& operator=(MeshStreamer&&) = delete;
+
+	~MeshStreamer();
+
+private:
+	MeshStreamer();
+
+	void workerMain();
+
+	CudaStream::Ptr stream = CudaStream::create(cudaStreamNonBlocking);
+	std::deque<std::function<void()>> pendingJobs;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool isShutdownRequested{false};
+	std::thread worker; // Started last, once other members are initialized
+};
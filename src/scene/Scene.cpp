@@ -12,24 +12,175 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
 #include <scene/Scene.hpp>
 #include <scene/Entity.hpp>
 #include <scene/Texture.hpp>
 #include <memory/Array.hpp>
+#include <gpu/helpersKernels.hpp>
+#include <PerformanceCounters.hpp>
+
+/**
+ * Helper to update a pair of host and device arrays, uploading only elements which changed.
+ * Changed elements are detected by bytewise comparison and consecutive ones are merged into a single copy.
+ * Arrays are resized to the given count; added elements are zero-initialized on both sides, so stay consistent.
+ */
+template<typename T>
+struct ChangedElementsUploader
+{
+	ChangedElementsUploader(HostPinnedArray<T>& hArray, DeviceSyncArray<T>& dArray, cudaStream_t stream, std::size_t count)
+	  : hArray(hArray), dArray(dArray), stream(stream)
+	{
+		hArray.resize(count, true, true);
+		dArray.resize(count, true, true);
+	}
+
+	void update(std::size_t idx, const T& element)
+	{
+		bool isChanged = std::memcmp(&element, &hArray[idx], sizeof(T)) != 0;
+		if (!isChanged) {
+			uploadChangedRange(idx);
+			return;
+		}
+		hArray[idx] = element;
+		anyChanged = true;
+		if (!changedBegin.has_value()) {
+			changedBegin = idx;
+		}
+		lastIdx = idx;
+	}
+
+	// Queues upload of the remaining changes, without synchronizing the stream.
+	void finish() { uploadChangedRange(lastIdx + 1); }
+
+	// Returns whether any element has changed since the previous call, e.g. to tell which range has changed.
+	bool takeAnyChanged() { return std::exchange(anyChanged, false); }
+
+private:
+	void uploadChangedRange(std::size_t changedEnd)
+	{
+		if (!changedBegin.has_value()) {
+			return;
+		}
+		CHECK_CUDA(cudaMemcpyAsync(dArray.getWritePtr() + *changedBegin, hArray.getReadPtr() + *changedBegin,
+		                           sizeof(T) * (changedEnd - *changedBegin), cudaMemcpyHostToDevice, stream));
+		changedBegin.reset();
+	}
+
+private:
+	HostPinnedArray<T>& hArray;
+	DeviceSyncArray<T>& dArray;
+	cudaStream_t stream;
+	std::optional<std::size_t> changedBegin;
+	std::size_t lastIdx{0};
+	bool anyChanged{false};
+};
+
+static bool isEventCompleted(const CudaEvent::Ptr& event)
+{
+	cudaError_t status = cudaEventQuery(event->getHandle());
+	if (status != cudaErrorNotReady) {
+		CHECK_CUDA(status);
+	}
+	return status == cudaSuccess;
+}
+
+API_OBJECT_INSTANCE(Scene);
 
-Scene& Scene::instance()
+std::shared_ptr<Scene> Scene::defaultInstance()
 {
-	static Scene scene;
+	// Constructed directly (not via APIObject::create), so that it is not registered in instances.
+	static std::shared_ptr<Scene> scene{new Scene()};
 	return scene;
 }
 
-Scene::Scene() : stream(CudaStream::create(cudaStreamNonBlocking)) {}
+std::shared_ptr<Scene> Scene::validateOrDefault(Scene* rawPtr)
+{
+	return rawPtr == nullptr ? defaultInstance() : validatePtr(rawPtr);
+}
+
+std::optional<std::size_t> Scene::gasEvictionBudgetBytes;
+std::size_t Scene::gasEvictionMinUnusedPassCount{0};
+uint64_t Scene::gasEvictionPass{0};
+
+void Scene::forEach(const std::function<void(Scene&)>& fn)
+{
+	auto editsLock = lockEdits();
+	fn(*defaultInstance());
+	for (auto&& scene : instances.getAll()) {
+		fn(*scene);
+	}
+}
+
+std::unique_lock<std::recursive_mutex> Scene::lockEdits()
+{
+	static std::recursive_mutex editsMutex;
+	return std::unique_lock{editsMutex};
+}
+
+// Note: streams have the lowest priority by default.
+Scene::Scene()
+  : stream(CudaStream::create(cudaStreamNonBlocking)), compactionStream(CudaStream::create(cudaStreamNonBlocking))
+{
+	static std::atomic<uint64_t> nextId{0};
+	id = nextId.fetch_add(1);
+}
+
+void Scene::setTime(Time time)
+{
+	prevTime = this->time;
+	this->time = time;
+	progressGASCompaction();
+}
+
+void Scene::progressGASCompaction()
+{
+	if (!gasCompactionStaticFrameThreshold.has_value()) {
+		return;
+	}
+	updateSBTMeshes();
+	// GAS builds and updates are queued in the scene stream, compaction must not start before they complete.
+	for (auto&& buffer : optixStructsBuffers) {
+		CHECK_CUDA(cudaStreamWaitEvent(compactionStream->getHandle(), buffer.asBuiltEvent->getHandle()));
+	}
+	bool anyGASChanged = false;
+	for (auto&& mesh : sbtMeshes) {
+		anyGASChanged |= mesh->progressGASCompaction(compactionStream, *gasCompactionStaticFrameThreshold);
+	}
+	if (anyGASChanged) {
+		// Instances will use compacted GAS handles; meshes may be used by other scenes as well.
+		Scene::forEach([](Scene& scene) { scene.requestASRefit(); });
+	}
+}
 
 std::size_t Scene::getObjectCount() const { return entities.size(); }
 
 void Scene::clear()
 {
 	entities.clear();
+	entityIndices.clear();
+	pendingEntities.clear();
+	sbtMeshes.clear(); // Release meshes
+	meshSBTIndices.clear();
+	sbtMeshesNeedUpdate = true;
+	instanceOrder.clear(); // Release entities
+	instanceOrderNeedsUpdate = true;
+	// Called when no graph is running, so resources of all versions can be released.
+	for (auto&& buffer : optixStructsBuffers) {
+		buffer.meshes.clear();
+		buffer.textures.clear();
+		buffer.releasedEvents.clear();
+	}
+	retiredVersions.clear();
+	deviceTransformSlotCount = 0;
+	freeDeviceTransformSlots.clear();
 	requestASRebuild();
 	requestSBTRebuild();
 	time.reset();
@@ -38,147 +189,1096 @@ void Scene::clear()
 
 void Scene::addEntity(std::shared_ptr<Entity> entity)
 {
-	entities.insert(entity);
+	if (!entity->mesh->isReady()) {
+		pendingEntities.insert(entity);
+		return;
+	}
+	if (entityIndices.emplace(entity.get(), entities.size()).second) {
+		entities.emplace_back(std::move(entity));
+	}
+	sbtMeshesNeedUpdate = true;
+	instanceOrderNeedsUpdate = true;
+	requestASRebuild();
+	requestSBTRebuild();
+}
+
+void Scene::addEntities(const std::vector<std::shared_ptr<Entity>>& newEntities)
+{
+	entities.reserve(entities.size() + newEntities.size());
+	entityIndices.reserve(entities.size() + newEntities.size());
+	for (auto&& entity : newEntities) {
+		if (!entity->mesh->isReady()) {
+			pendingEntities.insert(entity);
+		}
+		else if (entityIndices.emplace(entity.get(), entities.size()).second) {
+			entities.emplace_back(entity);
+		}
+	}
+	sbtMeshesNeedUpdate = true;
+	instanceOrderNeedsUpdate = true;
 	requestASRebuild();
 	requestSBTRebuild();
 }
 
+std::shared_ptr<Scene> Scene::fork(std::unordered_map<const Entity*, std::shared_ptr<Entity>>& outEntityCopies)
+{
+	auto forked = Scene::create();
+	forked->time = time;
+	forked->prevTime = prevTime;
+	forked->maxASRefitCount = maxASRefitCount;
+	forked->gasCompactionStaticFrameThreshold = gasCompactionStaticFrameThreshold;
+	forked->raytraceBatchingEnabled = raytraceBatchingEnabled;
+	forked->lodOrigin = lodOrigin;
+
+	// Transforms set from device memory are known only there; copies take them as if they were set from the host.
+	std::vector<Mat3x4f> deviceTransforms(dDeviceTransforms->getCount());
+	std::vector<Mat3x4f> deviceFormerTransforms(dDeviceFormerTransforms->getCount());
+	if (!deviceTransforms.empty()) {
+		CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+		CHECK_CUDA(cudaMemcpy(deviceTransforms.data(), dDeviceTransforms->getReadPtr(),
+		                      sizeof(Mat3x4f) * deviceTransforms.size(), cudaMemcpyDeviceToHost));
+		CHECK_CUDA(cudaMemcpy(deviceFormerTransforms.data(), dDeviceFormerTransforms->getReadPtr(),
+		                      sizeof(Mat3x4f) * deviceFormerTransforms.size(), cudaMemcpyDeviceToHost));
+	}
+
+	std::vector<std::shared_ptr<Entity>> copies;
+	copies.reserve(entities.size() + pendingEntities.size());
+	auto copyEntity = [&](const std::shared_ptr<Entity>& entity) {
+		auto copy = APIObject<Entity>::create(entity->baseMesh, forked.get());
+		copy->transformInfo = entity->transformInfo;
+		copy->formerTransformInfo = entity->formerTransformInfo;
+		copy->earlierTransformInfos = entity->earlierTransformInfos;
+		if (entity->deviceTransformSlot.has_value()) {
+			copy->transformInfo.matrix = deviceTransforms[*entity->deviceTransformSlot];
+			copy->formerTransformInfo.matrix = deviceFormerTransforms[*entity->deviceTransformSlot];
+			copy->earlierTransformInfos = {}; // Not kept in device memory
+		}
+		copy->id = entity->id;
+		copy->classId = entity->classId;
+		copy->intensity = entity->intensity;
+		copy->visibilityMask = entity->visibilityMask;
+		copy->isStatic = entity->isStatic;
+		copy->mesh = entity->mesh;
+		copy->lodMeshes = entity->lodMeshes;
+		copy->intensityTexture = entity->intensityTexture;
+		outEntityCopies.emplace(entity.get(), copy);
+		copies.emplace_back(std::move(copy));
+	};
+	std::ranges::for_each(entities, copyEntity);
+	std::ranges::for_each(pendingEntities, copyEntity);
+	forked->addEntities(copies);
+	return forked;
+}
+
 void Scene::removeEntity(std::shared_ptr<Entity> entity)
 {
-	entities.erase(entity);
+	releaseDeviceTransformSlot(*entity);
+	if (pendingEntities.erase(entity) > 0) {
+		return;
+	}
+	auto it = entityIndices.find(entity.get());
+	if (it == entityIndices.end()) {
+		return;
+	}
+	std::size_t idx = it->second;
+	entityIndices.erase(it);
+	if (idx != entities.size() - 1) {
+		entities[idx] = std::move(entities.back());
+		entityIndices[entities[idx].get()] = idx;
+	}
+	entities.pop_back();
+	sbtMeshesNeedUpdate = true;
+	instanceOrderNeedsUpdate = true;
 	requestASRebuild();
 	requestSBTRebuild();
 }
 
-OptixTraversableHandle Scene::getASLocked()
+void Scene::setEntityTransformsFromDevice(const std::vector<std::shared_ptr<Entity>>& updatedEntities,
+                                          const Mat3x4f* dTransforms, cudaEvent_t readyEvent)
 {
-	std::lock_guard optixStructsLock(optixStructsMutex);
-	if (!cachedAS.has_value()) {
-		cachedAS = buildAS();
+	std::vector<Vec2i> slots;
+	slots.reserve(updatedEntities.size());
+	for (auto&& entity : updatedEntities) {
+		bool isNew = !entity->deviceTransformSlot.has_value();
+		if (isNew) {
+			if (freeDeviceTransformSlots.empty()) {
+				entity->deviceTransformSlot = deviceTransformSlotCount++;
+			}
+			else {
+				entity->deviceTransformSlot = freeDeviceTransformSlots.back();
+				freeDeviceTransformSlots.pop_back();
+			}
+			if (entity->isStatic) {
+				requestInstanceOrderUpdate(); // Its transform is no longer known on the host, so it becomes dynamic
+			}
+		}
+		slots.emplace_back(*entity->deviceTransformSlot, isNew ? 1 : 0);
+		// The matrix is known only on the device; times are enough to place both transforms in the history.
+		entity->pushTransformInfo({entity->transformInfo.matrix, getTime()});
 	}
-	return *cachedAS;
+
+	cudaStream_t streamHandle = getStream()->getHandle();
+	if (dDeviceTransforms->getCount() < deviceTransformSlotCount) {
+		// Reallocation copies data outside of the scene stream, so it must not overlap with kernels using the arrays.
+		CHECK_CUDA(cudaStreamSynchronize(streamHandle));
+		dDeviceTransforms->resize(deviceTransformSlotCount, false, true);
+		dDeviceFormerTransforms->resize(deviceTransformSlotCount, false, true);
+	}
+	if (readyEvent != nullptr) {
+		CHECK_CUDA(cudaStreamWaitEvent(streamHandle, readyEvent));
+	}
+	// The previous update has completed (see below), so the slots array is not in use.
+	dUpdatedDeviceTransformSlots->copyFromExternal(slots.data(), slots.size());
+	gpuUpdateDeviceTransforms(streamHandle, slots.size(), dUpdatedDeviceTransformSlots->getReadPtr(), dTransforms,
+	                          dDeviceTransforms->getWritePtr(), dDeviceFormerTransforms->getWritePtr());
+	// Usually quick: the scene stream is idle between building snapshots. Afterwards, the client may reuse its array.
+	CHECK_CUDA(cudaStreamSynchronize(streamHandle));
+
+	requestASRefit(); // Instance transforms and transform histories
 }
 
-OptixShaderBindingTable Scene::getSBTLocked()
+void Scene::releaseDeviceTransformSlot(Entity& entity)
+{
+	if (!entity.deviceTransformSlot.has_value()) {
+		return;
+	}
+	freeDeviceTransformSlots.push_back(*entity.deviceTransformSlot);
+	entity.deviceTransformSlot.reset();
+	if (entity.isStatic) {
+		requestInstanceOrderUpdate();
+	}
+}
+
+void Scene::updateDeviceTransformTargets(OptixStructsBuffer& buffer)
+{
+	// Targets may still be read by kernels of the previous build of this buffer (queued before both events).
+	waitForPendingUploads(buffer.asBuiltEvent);
+	waitForPendingUploads(buffer.sbtUploadedEvent);
+	std::vector<Vec2i> targets;
+	int32_t instanceIdx = 0;
+	for (auto&& entity : instanceOrder) {
+		if (entity->deviceTransformSlot.has_value()) {
+			targets.emplace_back(instanceIdx, *entity->deviceTransformSlot);
+		}
+		instanceIdx += 1;
+	}
+	buffer.dDeviceTransformTargets->copyFromExternal(targets.data(), targets.size());
+}
+
+SceneSnapshot Scene::acquireSnapshotLocked() { return std::move(acquireSnapshotsLocked(1).front()); }
+
+std::vector<SceneSnapshot> Scene::acquireSnapshotsLocked(std::size_t count)
+{
+	auto editsLock = lockEdits();
+	std::unique_lock optixStructsLock(optixStructsMutex);
+	releaseRetiredVersions();
+	addReadyEntities();
+	evictUnusedGASes();
+	updateLodSelection();
+
+	bool isCurrentUpToDate = optixStructsBuffers[currentBufferIdx].asVersion == asVersion &&
+	                         optixStructsBuffers[currentBufferIdx].sbtVersion == sbtVersion;
+	if (!isCurrentUpToDate) {
+		// The current version may be in use, the next one is built in the other buffer.
+		std::size_t nextBufferIdx = (currentBufferIdx + 1) % OPTIX_STRUCTS_BUFFER_COUNT;
+		OptixStructsBuffer& buffer = optixStructsBuffers[nextBufferIdx];
+		prepareBufferForReuse(buffer, optixStructsLock);
+		updateSBTMeshes();
+		updateInstanceOrder();
+		if (buffer.asVersion != asVersion) {
+			PerformanceCounters::ScopedTimer timer{PerformanceCounters::instance().asBuild};
+			// E.g. after a tile of the map has been loaded, many GASes are built at once; instances use them afterwards.
+			std::vector<std::shared_ptr<Mesh>> meshesToBuild;
+			std::copy_if(sbtMeshes.begin(), sbtMeshes.end(), std::back_inserter(meshesToBuild),
+			             [](auto&& mesh) { return mesh->isGASBuildPending(); });
+			Mesh::buildGASes(meshesToBuild);
+			// Two-level AS rebuilds only its dynamic IAS after too many refits, keeping the static one (see refitAS).
+			bool canRefit = buffer.entitySetVersion == entitySetVersion &&
+			                (buffer.asRefitCount < maxASRefitCount || buffer.staticInstanceCount > 0) &&
+			                getObjectCount() > 0;
+			canRefit ? refitAS(buffer) : buildAS(buffer);
+			(canRefit ? PerformanceCounters::instance().iasRefitCount : PerformanceCounters::instance().iasBuildCount)
+			    .fetch_add(1, std::memory_order_relaxed);
+		}
+		if (buffer.sbtVersion != sbtVersion) {
+			PerformanceCounters::ScopedTimer timer{PerformanceCounters::instance().sbtBuild};
+			buildSBT(buffer);
+		}
+		buffer.meshes = sbtMeshes;
+		for (auto&& entity : entities) {
+			if (entity->intensityTexture != nullptr) {
+				buffer.textures.emplace_back(entity->intensityTexture);
+			}
+		}
+		currentBufferIdx = nextBufferIdx;
+	}
+
+	OptixStructsBuffer& buffer = optixStructsBuffers[currentBufferIdx];
+	// Events of the current version accumulate as long as the scene is unchanged; completed ones are not needed.
+	// Unrecorded event is reported as completed, so this is possible only when all snapshots were released.
+	if (buffer.pendingReleaseCount == 0) {
+		std::erase_if(buffer.releasedEvents, isEventCompleted);
+	}
+	buffer.pendingReleaseCount += count;
+	std::vector<SceneSnapshot> snapshots;
+	for (std::size_t i = 0; i < count; ++i) {
+		snapshots.push_back(SceneSnapshot{
+		    .as = buffer.asHandle,
+		    .sbt = buffer.sbt,
+		    .entityInstances = getObjectCount() > 0 ? buffer.dEntityInstanceData->getReadPtr() : nullptr,
+		    .entityTransformHistories = getObjectCount() > 0 ? buffer.dTransformHistories->getReadPtr() : nullptr,
+		    .time = getTime(),
+		    .deltaTime = getDeltaTime(),
+		    .instances = getObjectCount() > 0 ? buffer.dInstances->getReadPtr() : nullptr,
+		    .instanceBounds = instanceBoundsEnabled && getObjectCount() > 0 ? buffer.dInstanceBounds->getReadPtr() : nullptr,
+		    .instanceCount = getObjectCount(),
+		    .asVersion = buffer.asVersion.value_or(0),
+		    .gasVersionSum = buffer.gasVersionSum,
+		    .sbtVersion = buffer.sbtVersion.value_or(0),
+		    .lastMotionTime = buffer.lastMotionTime,
+		    .bufferIdx = currentBufferIdx,
+		    .releasedEvent = buffer.releasedEvents.emplace_back(CudaEvent::create()),
+		});
+	}
+	return snapshots;
+}
+
+void Scene::enqueueWaitForSnapshotLocked(const SceneSnapshot& snapshot, cudaStream_t waitingStream)
 {
 	std::lock_guard optixStructsLock(optixStructsMutex);
-	if (!cachedSBT.has_value()) {
-		cachedSBT = buildSBT();
+	const OptixStructsBuffer& buffer = optixStructsBuffers.at(snapshot.bufferIdx);
+	CHECK_CUDA(cudaStreamWaitEvent(waitingStream, buffer.asBuiltEvent->getHandle()));
+	CHECK_CUDA(cudaStreamWaitEvent(waitingStream, buffer.sbtUploadedEvent->getHandle()));
+}
+
+void Scene::releaseSnapshotLocked(const SceneSnapshot& snapshot, cudaStream_t lastReadingStream)
+{
+	{
+		std::lock_guard optixStructsLock(optixStructsMutex);
+		CHECK_CUDA_NO_THROW(cudaEventRecord(snapshot.releasedEvent->getHandle(), lastReadingStream));
+		optixStructsBuffers.at(snapshot.bufferIdx).pendingReleaseCount -= 1;
+	}
+	snapshotReleased.notify_all();
+}
+
+void Scene::raycastLocked(const Vec3f* origins, const Vec3f* directions, std::size_t count, float maxDistance,
+                          rgl_raycast_hit_t* outHits)
+{
+	SceneSnapshot snapshot = acquireSnapshotLocked();
+	// Tracing in the scene stream is ordered after the build of the snapshot; the next build waits for its release anyway.
+	cudaStream_t raycastStream = getStream()->getHandle();
+	try {
+		// With unified addressing, copies from host and device memory are done in the same way.
+		dRaycastOrigins->resize(count, false, false);
+		dRaycastDirections->resize(count, false, false);
+		dRaycastRays->resize(count, false, false);
+		dRaycastHits->resize(count, false, false);
+		CHECK_CUDA(cudaMemcpyAsync(dRaycastOrigins->getWritePtr(), origins, sizeof(Vec3f) * count, cudaMemcpyDefault,
+		                           raycastStream));
+		CHECK_CUDA(cudaMemcpyAsync(dRaycastDirections->getWritePtr(), directions, sizeof(Vec3f) * count, cudaMemcpyDefault,
+		                           raycastStream));
+		gpuMakeRays(raycastStream, count, dRaycastOrigins->getReadPtr(), dRaycastDirections->getReadPtr(),
+		            dRaycastRays->getWritePtr());
+		Vec2f range{0.0f, maxDistance};
+		dRaycastRange->copyFromExternal(&range, 1);
+
+		// Hits are written as interleaved (formatted) points of two fields.
+		RaytraceRequestContext requestCtx = {
+		    .nearNonHitDistance = std::numeric_limits<float>::infinity(),
+		    .farNonHitDistance = std::numeric_limits<float>::infinity(),
+		    .rays = dRaycastRays->getReadPtr(),
+		    .raysTransform = Mat3x4f::identity(),
+		    .rayCount = count,
+		    .rayLayoutWidth = count,
+		    .rayOriginToWorld = Mat3x4f::identity(),
+		    .worldToOutput = Mat3x4f::identity(),
+		    .rayRanges = dRaycastRange->getReadPtr(),
+		    .rayRangesCount = 1,
+		    .scene = snapshot.as,
+		    .visibilityMask = RGL_DEFAULT_VISIBILITY_MASK,
+		    .entityInstances = snapshot.entityInstances,
+		    .entityTransformHistories = snapshot.entityTransformHistories,
+		    .textures = Texture::getDeviceTable(),
+		    .sceneTime = snapshot.time.value_or(Time::zero()).asSeconds(),
+		    .returnMode = RGL_RETURN_MODE_FIRST,
+		    .returnCount = 1,
+		    .beamSampleCount = 1,
+		    .formattedPointSize = sizeof(rgl_raycast_hit_t),
+		    .distance = &dRaycastHits->getWritePtr()->distance,
+		    .entityId = &dRaycastHits->getWritePtr()->entity_id,
+		};
+		std::size_t launchSize = sizeof(RaytraceLaunchParams) + sizeof(RaytraceRequestContext);
+		hRaycastLaunch->resize(launchSize, false, false);
+		dRaycastLaunch->resize(launchSize, false, false);
+		RaytraceLaunchParams launchParams = {
+		    .requests = reinterpret_cast<const RaytraceRequestContext*>(dRaycastLaunch->getReadPtr() +
+		                                                                sizeof(RaytraceLaunchParams)),
+		    .requestCount = 1,
+		    .useShaderExecutionReordering = Optix::getOrCreate().isShaderExecutionReorderingSupported,
+		};
+		std::memcpy(hRaycastLaunch->getWritePtr(), &launchParams, sizeof(RaytraceLaunchParams));
+		std::memcpy(hRaycastLaunch->getWritePtr() + sizeof(RaytraceLaunchParams), &requestCtx, sizeof(RaytraceRequestContext));
+		CHECK_CUDA(cudaMemcpyAsync(dRaycastLaunch->getWritePtr(), hRaycastLaunch->getReadPtr(), launchSize,
+		                           cudaMemcpyHostToDevice, raycastStream));
+
+		enqueueWaitForSnapshotLocked(snapshot, raycastStream);
+		CHECK_OPTIX(optixLaunch(Optix::getOrCreate().pipeline, raycastStream, dRaycastLaunch->getDeviceReadPtr(),
+		                        sizeof(RaytraceLaunchParams), &snapshot.sbt, static_cast<unsigned>(count), 1, 1));
+		CHECK_CUDA(cudaMemcpyAsync(outHits, dRaycastHits->getReadPtr(), sizeof(rgl_raycast_hit_t) * count, cudaMemcpyDefault,
+		                           raycastStream));
+	}
+	catch (...) {
+		releaseSnapshotLocked(snapshot, raycastStream);
+		throw;
+	}
+	releaseSnapshotLocked(snapshot, raycastStream);
+	CHECK_CUDA(cudaStreamSynchronize(raycastStream));
+}
+
+void Scene::prepareBufferForReuse(OptixStructsBuffer& buffer, std::unique_lock<std::mutex>& lock)
+{
+	// Snapshots are released as soon as graph threads have queued their raytracing, so this wait is short.
+	// It is necessary, because an event can be waited for only after it was recorded.
+	snapshotReleased.wait(lock, [&buffer]() { return buffer.pendingReleaseCount == 0; });
+
+	// Buffers may be reallocated only when the set of entities changes (by resize on growth),
+	// which is not safe while they are still being read, so such (less frequent) changes wait on the host.
+	bool mayReallocate = buffer.entitySetVersion != entitySetVersion;
+	for (auto&& releasedEvent : buffer.releasedEvents) {
+		if (mayReallocate) {
+			CHECK_CUDA(cudaEventSynchronize(releasedEvent->getHandle()));
+		}
+		else {
+			CHECK_CUDA(cudaStreamWaitEvent(getStream()->getHandle(), releasedEvent->getHandle()));
+		}
 	}
-	return *cachedSBT;
+	retiredVersions.push_back({.releasedEvents = std::move(buffer.releasedEvents),
+	                           .meshes = std::move(buffer.meshes),
+	                           .textures = std::move(buffer.textures)});
+	buffer.releasedEvents.clear();
+	buffer.meshes.clear();
+	buffer.textures.clear();
+}
+
+void Scene::releaseRetiredVersions()
+{
+	std::erase_if(retiredVersions, [](const RetiredVersion& version) {
+		return std::ranges::all_of(version.releasedEvents, isEventCompleted);
+	});
+}
+
+void Scene::enqueueWaitForMeshes()
+{
+	// Meshes are shared by scenes, so their uploads and GAS builds are queued in a common stream (see Mesh::getStream()).
+	// Scene stream is ordered after the ones queued so far, i.e. the ones of meshes used by the version being built.
+	CHECK_CUDA(cudaEventRecord(meshesReadyEvent->getHandle(), Mesh::getStream()->getHandle()));
+	CHECK_CUDA(cudaStreamWaitEvent(getStream()->getHandle(), meshesReadyEvent->getHandle()));
+}
+
+void Scene::waitForPendingUploads(CudaEvent::Ptr uploadEvent)
+{
+	// Usually completed long ago, i.e. in the previous frame.
+	CHECK_CUDA(cudaEventSynchronize(uploadEvent->getHandle()));
+}
+
+void Scene::setLodOrigin(Vec3f origin)
+{
+	lodOrigin = origin;
+	lodSelectionNeedsUpdate = true;
 }
 
-OptixShaderBindingTable Scene::buildSBT()
+void Scene::addReadyEntities()
 {
-	static DeviceSyncArray<HitgroupRecord>::Ptr dHitgroupRecords = DeviceSyncArray<HitgroupRecord>::create();
-	static DeviceSyncArray<RaygenRecord>::Ptr dRaygenRecords = DeviceSyncArray<RaygenRecord>::create();
-	static DeviceSyncArray<MissRecord>::Ptr dMissRecords = DeviceSyncArray<MissRecord>::create();
-	static HostPinnedArray<HitgroupRecord>::Ptr hHitgroupRecords = HostPinnedArray<HitgroupRecord>::create();
+	for (auto it = pendingEntities.begin(); it != pendingEntities.end();) {
+		// Entities whose streaming has failed stay pending; the error is reported by rgl_mesh_is_ready.
+		if (!(*it)->mesh->isReady()) {
+			++it;
+			continue;
+		}
+		auto entity = *it;
+		it = pendingEntities.erase(it);
+		addEntity(entity);
+	}
+}
+
+void Scene::forEachMesh(const std::function<void(Mesh&)>& fn)
+{
+	std::unordered_set<Mesh*> visitedMeshes;
+	auto visit = [&](const std::shared_ptr<Mesh>& mesh) {
+		if (visitedMeshes.insert(mesh.get()).second) {
+			fn(*mesh);
+		}
+	};
+	forEach([&](Scene& scene) {
+		for (auto&& entity : scene.entities) {
+			visit(entity->mesh);
+		}
+		for (auto&& entity : scene.pendingEntities) {
+			visit(entity->mesh);
+		}
+	});
+	for (auto&& mesh : Mesh::instances.getAll()) {
+		visit(mesh);
+	}
+	Mesh::forEachRetained([&](Mesh& mesh) {
+		if (visitedMeshes.insert(&mesh).second) {
+			fn(mesh);
+		}
+	});
+}
+
+void Scene::configureGASEviction(std::optional<std::size_t> budgetBytes, std::size_t minUnusedPassCount)
+{
+	auto editsLock = lockEdits();
+	gasEvictionBudgetBytes = budgetBytes;
+	gasEvictionMinUnusedPassCount = minUnusedPassCount;
+}
+
+void Scene::evictUnusedGASes()
+{
+	if (!gasEvictionBudgetBytes.has_value()) {
+		return;
+	}
+	gasEvictionPass += 1;
+
+	// Meshes used by any scene, including the ones of versions that may still be used by graphs.
+	// Other buffers keep references to meshes of older versions, which are overwritten before the buffer is used again.
+	std::size_t gasBytes = 0;
+	std::unordered_set<const Mesh*> usedMeshes;
+	auto markUsed = [&](const std::shared_ptr<Mesh>& mesh) {
+		if (usedMeshes.insert(mesh.get()).second) {
+			mesh->lastUsedEvictionPass = gasEvictionPass;
+			gasBytes += mesh->getGASBytes();
+		}
+	};
+	forEach([&](Scene& scene) {
+		for (auto&& entity : scene.entities) {
+			markUsed(entity->mesh);
+		}
+		for (std::size_t bufferIdx = 0; bufferIdx < OPTIX_STRUCTS_BUFFER_COUNT; ++bufferIdx) {
+			auto&& buffer = scene.optixStructsBuffers[bufferIdx];
+			if (bufferIdx == scene.currentBufferIdx || buffer.pendingReleaseCount > 0) {
+				std::for_each(buffer.meshes.begin(), buffer.meshes.end(), markUsed);
+			}
+		}
+		for (auto&& version : scene.retiredVersions) {
+			std::for_each(version.meshes.begin(), version.meshes.end(), markUsed);
+		}
+	});
 
-	hHitgroupRecords->reserve(entities.size(), false);
-	hHitgroupRecords->clear(false);
+	// Unused meshes are kept alive only by their handles; streamed ones are evicted once ready.
+	std::vector<std::shared_ptr<Mesh>> candidates;
+	for (auto&& mesh : Mesh::instances.getAll()) {
+		if (usedMeshes.contains(mesh.get())) {
+			continue;
+		}
+		gasBytes += mesh->getGASBytes();
+		bool isLongUnused = gasEvictionPass - mesh->lastUsedEvictionPass >= gasEvictionMinUnusedPassCount;
+		if (mesh->getGASBytes() > 0 && mesh->isReady() && isLongUnused) {
+			candidates.emplace_back(mesh);
+		}
+	}
+	if (gasBytes <= *gasEvictionBudgetBytes) {
+		return;
+	}
+	std::sort(candidates.begin(), candidates.end(),
+	          [](auto&& lhs, auto&& rhs) { return lhs->lastUsedEvictionPass < rhs->lastUsedEvictionPass; });
+	for (auto&& mesh : candidates) {
+		if (gasBytes <= *gasEvictionBudgetBytes) {
+			break;
+		}
+		std::size_t meshGASBytes = mesh->getGASBytes();
+		mesh->evictGAS();
+		gasBytes -= meshGASBytes - mesh->getGASBytes();
+	}
+}
+
+std::size_t Scene::getIASBytes() const
+{
+	std::size_t bytes = 0;
+	for (auto&& buffer : optixStructsBuffers) {
+		bytes += buffer.scratchpad.getAllocatedBytes() + buffer.staticScratchpad.getAllocatedBytes() +
+		         buffer.topScratchpad.getAllocatedBytes();
+		bytes += (buffer.dInstances->getCapacity() + buffer.dTopInstances->getCapacity()) * sizeof(OptixInstance);
+		bytes += buffer.dInstanceBounds->getCapacity() * sizeof(Vec4f);
+		bytes += buffer.dTransformHistories->getCapacity() * sizeof(EntityTransformHistory);
+		bytes += buffer.dMotionTransforms->getCapacity() * sizeof(OptixStructsBuffer::MotionTransform);
+		bytes += buffer.dDeviceTransformTargets->getCapacity() * sizeof(Vec2i);
+	}
+	bytes += (dDeviceTransforms->getCapacity() + dDeviceFormerTransforms->getCapacity()) * sizeof(Mat3x4f);
+	bytes += dUpdatedDeviceTransformSlots->getCapacity() * sizeof(Vec2i);
+	return bytes;
+}
+
+std::size_t Scene::getSBTBytes() const
+{
+	std::size_t bytes = dRaygenRecords->getCapacity() * sizeof(RaygenRecord) + dMissRecords->getCapacity() * sizeof(MissRecord);
+	for (auto&& buffer : optixStructsBuffers) {
+		bytes += buffer.dHitgroupRecords->getCapacity() * sizeof(HitgroupRecord);
+		bytes += buffer.dEntityInstanceData->getCapacity() * sizeof(EntityInstanceData);
+	}
+	return bytes;
+}
+
+void Scene::updateLodSelection()
+{
+	if (!lodSelectionNeedsUpdate && !lodOrigin.has_value()) {
+		return;
+	}
+	bool anyChanged = false;
 	for (auto&& entity : entities) {
-		auto& mesh = entity->mesh;
-		std::optional<Mat3x4f> prevFrameTransform = entity->getPreviousFrameLocalToWorldTransform();
-		hHitgroupRecords->append(HitgroupRecord{
-		    .data = {
-		             .vertex = mesh->dVertices->getReadPtr(),
-		             .index = mesh->dIndices->getReadPtr(),
-		             .vertexCount = mesh->dVertices->getCount(),
-		             .indexCount = mesh->dIndices->getCount(),
-		             .textureCoords = mesh->dTextureCoords.has_value() ? mesh->dTextureCoords.value()->getReadPtr() : nullptr,
-		             .textureCoordsCount = mesh->dTextureCoords.has_value() ? mesh->dTextureCoords.value()->getCount() : 0,
-		             .texture = entity->intensityTexture != nullptr ? entity->intensityTexture->getTextureObject() : 0,
-		             .prevFrameLocalToWorld = prevFrameTransform.value_or(Mat3x4f::identity()),
-		             .hasPrevFrameLocalToWorld = prevFrameTransform.has_value(),
-		             .vertexDisplacementSincePrevFrame = mesh->getSkinningDisplacementSinceLastFrame(),
-		             }
-        });
-		HitgroupRecord& last = hHitgroupRecords->at(hHitgroupRecords->getCount() - 1);
-		CHECK_OPTIX(optixSbtRecordPackHeader(Optix::getOrCreate().hitgroupPG, last.header));
-	}
-	dHitgroupRecords->copyFrom(hHitgroupRecords);
-
-	RaygenRecord hRaygenRecord = {};
-	CHECK_OPTIX(optixSbtRecordPackHeader(Optix::getOrCreate().raygenPG, &hRaygenRecord));
-	dRaygenRecords->copyFromExternal(&hRaygenRecord, 1);
-
-	MissRecord hMissRecord = {};
-	CHECK_OPTIX(optixSbtRecordPackHeader(Optix::getOrCreate().missPG, &hMissRecord));
-	dMissRecords->copyFromExternal(&hMissRecord, 1);
-
-	return OptixShaderBindingTable{
+		std::shared_ptr<Mesh> selected = entity->baseMesh;
+		if (lodOrigin.has_value() && !entity->lodMeshes.empty()) {
+			float distance = (entity->transformInfo.matrix.translation() - *lodOrigin).length();
+			auto farther = entity->lodMeshes.upper_bound(distance);
+			if (farther != entity->lodMeshes.begin() && std::prev(farther)->second->isReady()) {
+				selected = std::prev(farther)->second;
+			}
+		}
+		if (selected != entity->mesh) {
+			entity->mesh = std::move(selected);
+			anyChanged = true;
+		}
+	}
+	lodSelectionNeedsUpdate = false;
+	if (anyChanged) {
+		// Instances refer to other GASes and hitgroup records; the set of entities is unchanged, so refit is enough.
+		sbtMeshesNeedUpdate = true;
+		requestASRefit();
+		requestSBTRebuild();
+	}
+}
+
+void Scene::updateSBTMeshes()
+{
+	if (!sbtMeshesNeedUpdate) {
+		return;
+	}
+	// Meshes are assigned hitgroup record indices in order of their first appearance.
+	sbtMeshes.clear();
+	meshSBTIndices.clear();
+	for (auto&& entity : entities) {
+		auto [_, inserted] = meshSBTIndices.try_emplace(entity->mesh.get(), static_cast<unsigned int>(sbtMeshes.size()));
+		if (inserted) {
+			sbtMeshes.emplace_back(entity->mesh);
+		}
+	}
+	sbtMeshesNeedUpdate = false;
+}
+
+void Scene::updateInstanceOrder()
+{
+	if (!instanceOrderNeedsUpdate) {
+		return;
+	}
+	// Entities posed from device memory change without the host knowing, so they are always dynamic.
+	instanceOrder.assign(entities.begin(), entities.end());
+	auto dynamicInstances = std::ranges::stable_partition(instanceOrder, [](const std::shared_ptr<Entity>& entity) {
+		return entity->isStatic && !entity->deviceTransformSlot.has_value();
+	});
+	staticInstanceCount = static_cast<std::size_t>(std::distance(instanceOrder.begin(), dynamicInstances.begin()));
+	instanceOrderNeedsUpdate = false;
+}
+
+void Scene::requestInstanceOrderUpdate()
+{
+	instanceOrderNeedsUpdate = true;
+	requestASRebuild();
+	requestSBTRebuild(); // Entity data is in order of instances
+}
+
+HitgroupRecord Scene::makeHitgroupRecord(const Mesh& mesh, unsigned closestHitVariant)
+{
+	// Record is compared bytewise with the previous one, so padding must be deterministic.
+	HitgroupRecord record;
+	std::memset(&record, 0, sizeof(record));
+	const auto& header = hitgroupRecordHeaders.at(mesh.getPrimitiveType()).at(closestHitVariant);
+	std::memcpy(record.header, header.data(), header.size());
+
+	auto readPtrOrNull = [](const auto& array) { return array->getCount() > 0 ? array->getReadPtr() : nullptr; };
+	record.data.vertex = readPtrOrNull(mesh.dVertices);
+	record.data.index = readPtrOrNull(mesh.dIndices);
+	record.data.vertexCount = mesh.getVertexCount();
+	record.data.indexCount = mesh.getTriangleCount();
+	record.data.index16 = readPtrOrNull(mesh.dIndices16);
+	record.data.vertexHalf = readPtrOrNull(mesh.dVerticesHalf);
+	record.data.vertexSnorm = readPtrOrNull(mesh.dVerticesSnorm);
+	record.data.vertexSnormOffset = mesh.verticesSnormOffset;
+	record.data.vertexSnormScale = mesh.verticesSnormScale;
+	record.data.segmentIndex = readPtrOrNull(mesh.dSegmentIndices);
+	record.data.textureCoords = mesh.dTextureCoords.has_value() ? mesh.dTextureCoords.value()->getReadPtr() : nullptr;
+	record.data.textureCoordsCount = mesh.dTextureCoords.has_value() ? mesh.dTextureCoords.value()->getCount() : 0;
+	record.data.vertexDisplacementSincePrevFrame = mesh.getSkinningDisplacementSinceLastFrame(*this);
+	return record;
+}
+
+EntityInstanceData Scene::makeEntityInstanceData(const Entity& entity)
+{
+	// Same as above, data is compared bytewise.
+	EntityInstanceData data;
+	std::memset(&data, 0, sizeof(data));
+
+	const Texture* texture = entity.intensityTexture.get();
+	data.textureIdx = texture != nullptr ? texture->getTableIndex() : 0;
+	data.textureTexelCount = texture != nullptr ? static_cast<float>(texture->getWidth() * texture->getHeight()) : 0.0f;
+	data.intensity = entity.intensity;
+	data.classId = entity.classId;
+	return data;
+}
+
+void Scene::buildSBT(OptixStructsBuffer& buffer)
+{
+	// Raygen and miss records do not depend on the scene content, so they are built only once.
+	if (dRaygenRecords->getCount() == 0) {
+		RaygenRecord hRaygenRecord = {};
+		CHECK_OPTIX(optixSbtRecordPackHeader(Optix::getOrCreate().raygenPG, &hRaygenRecord));
+		dRaygenRecords->copyFromExternal(&hRaygenRecord, 1);
+
+		MissRecord hMissRecord = {};
+		CHECK_OPTIX(optixSbtRecordPackHeader(Optix::getOrCreate().missPG, &hMissRecord));
+		dMissRecords->copyFromExternal(&hMissRecord, 1);
+
+		for (unsigned primitiveType = 0; primitiveType < MESH_PRIMITIVE_TYPE_COUNT; ++primitiveType) {
+			for (unsigned variant = 0; variant < CLOSEST_HIT_VARIANT_COUNT; ++variant) {
+				OptixProgramGroup programGroup = Optix::getOrCreate().hitgroupPGs[primitiveType][variant];
+				if (programGroup == nullptr) {
+					continue; // Primitive type not supported, no mesh can have it
+				}
+				HitgroupRecord hHitgroupRecord = {};
+				CHECK_OPTIX(optixSbtRecordPackHeader(programGroup, &hHitgroupRecord));
+				auto& header = hitgroupRecordHeaders[primitiveType][variant];
+				std::memcpy(header.data(), hHitgroupRecord.header, header.size());
+			}
+		}
+	}
+
+	updateSBTMeshes();
+	updateInstanceOrder();
+	waitForPendingUploads(buffer.sbtUploadedEvent);
+
+	// Hitgroup records and entity data are kept between builds; only the elements that changed are uploaded.
+	// Each mesh has consecutive records for all closest-hit variants, selected by SBT offset in optixTrace.
+	ChangedElementsUploader<HitgroupRecord> recordUploader{*buffer.hHitgroupRecords, *buffer.dHitgroupRecords,
+	                                                       getStream()->getHandle(),
+	                                                       sbtMeshes.size() * CLOSEST_HIT_VARIANT_COUNT};
+	for (std::size_t idx = 0; idx < sbtMeshes.size(); ++idx) {
+		for (unsigned variant = 0; variant < CLOSEST_HIT_VARIANT_COUNT; ++variant) {
+			recordUploader.update(idx * CLOSEST_HIT_VARIANT_COUNT + variant, makeHitgroupRecord(*sbtMeshes[idx], variant));
+		}
+	}
+	recordUploader.finish();
+
+	// Entity data must be in the same order as instances in IAS.
+	ChangedElementsUploader<EntityInstanceData> entityDataUploader{
+	    *buffer.hEntityInstanceData, *buffer.dEntityInstanceData, getStream()->getHandle(), entities.size()};
+	std::size_t idx = 0;
+	for (auto&& entity : instanceOrder) {
+		entityDataUploader.update(idx++, makeEntityInstanceData(*entity));
+	}
+	entityDataUploader.finish();
+	CHECK_CUDA(cudaEventRecord(buffer.sbtUploadedEvent->getHandle(), getStream()->getHandle()));
+
+	buffer.sbtVersion = sbtVersion;
+	buffer.sbt = OptixShaderBindingTable{
 	    .raygenRecord = dRaygenRecords->getDeviceReadPtr(),
 	    .missRecordBase = dMissRecords->getDeviceReadPtr(),
 	    .missRecordStrideInBytes = sizeof(MissRecord),
 	    .missRecordCount = 1U,
-	    .hitgroupRecordBase = getObjectCount() > 0 ? dHitgroupRecords->getDeviceReadPtr() : static_cast<CUdeviceptr>(0),
+	    .hitgroupRecordBase = getObjectCount() > 0 ? buffer.dHitgroupRecords->getDeviceReadPtr() : static_cast<CUdeviceptr>(0),
 	    .hitgroupRecordStrideInBytes = sizeof(HitgroupRecord),
-	    .hitgroupRecordCount = static_cast<unsigned>(dHitgroupRecords->getCount()),
+	    .hitgroupRecordCount = static_cast<unsigned>(buffer.dHitgroupRecords->getCount()),
+	};
+}
+
+OptixInstance Scene::makeInstance(const Entity& entity)
+{
+	OptixInstance instance = {
+	    .instanceId = static_cast<unsigned int>(entity.id),
+	    // NOTE: this assumes a single SBT record (per closest-hit variant) per GAS
+	    .sbtOffset = meshSBTIndices.at(entity.mesh.get()) * CLOSEST_HIT_VARIANT_COUNT,
+	    .visibilityMask = entity.visibilityMask,
+	    // Opacity micromaps are two-state (see Mesh::setOpacityMicromap), so transparent parts are skipped without any-hit.
+	    .flags = OPTIX_INSTANCE_FLAG_DISABLE_ANYHIT,
+	    .traversableHandle = entity.mesh->getGAS(Mesh::getStream()),
+	};
+	entity.transformInfo.matrix.toRaw(instance.transform);
+	return instance;
+}
+
+OptixMatrixMotionTransform Scene::makeMotionTransform(const Entity& entity, OptixTraversableHandle gas)
+{
+	// Same as instances, motion transforms are compared bytewise.
+	OptixMatrixMotionTransform motionTransform;
+	std::memset(&motionTransform, 0, sizeof(motionTransform));
+	motionTransform.child = gas;
+
+	// Keys are relative to the instance transform, in milliseconds since the scene time (same as ray time offsets).
+	// The first key is the current pose, the second one extrapolates the motion since the previous frame by a frame.
+	// Transforms set from device memory are not known on the host, so such entities are not motion-blurred.
+	// Keys of still entities do not depend on time, so that they stay unchanged (and are not uploaded) between frames.
+	Mat3x4f extrapolated = Mat3x4f::identity();
+	float frameTimeMs = 1.0f;
+	std::optional<Mat3x4f> prevFrameTransform = entity.getPreviousFrameLocalToWorldTransform();
+	std::optional<Time> deltaTime = getDeltaTime();
+	bool isMoving = prevFrameTransform.has_value() &&
+	                std::memcmp(prevFrameTransform->rc, entity.transformInfo.matrix.rc, sizeof(Mat3x4f::rc)) != 0;
+	if (isMoving && deltaTime.has_value() && deltaTime->asSeconds() > 0.0 && !entity.deviceTransformSlot.has_value()) {
+		// Matrices are interpolated linearly, so the extrapolated pose is 2 * current - previous (in world space).
+		Mat3x4f relativePrevFrameTransform = entity.transformInfo.matrix.inverse() * *prevFrameTransform;
+		for (int row = 0; row < 3; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				extrapolated.rc[row][col] = 2.0f * extrapolated.rc[row][col] - relativePrevFrameTransform.rc[row][col];
+			}
+		}
+		frameTimeMs = static_cast<float>(deltaTime->asSeconds() * 1000.0);
+	}
+	motionTransform.motionOptions = {
+	    .numKeys = 2,
+	    .flags = OPTIX_MOTION_FLAG_NONE, // Rays out of the time range see the nearest key
+	    .timeBegin = 0.0f,
+	    .timeEnd = frameTimeMs,
+	};
+	Mat3x4f::identity().toRaw(motionTransform.transform[0]);
+	extrapolated.toRaw(motionTransform.transform[1]);
+	return motionTransform;
+}
+
+Vec4f Scene::makeInstanceBounds(const Entity& entity)
+{
+	// Transforms set from device memory are not known on the host, so such entities are never culled.
+	if (entity.deviceTransformSlot.has_value()) {
+		return Vec4f{0.0f, 0.0f, 0.0f, std::numeric_limits<float>::infinity()};
+	}
+	const Mat3x4f& transform = entity.transformInfo.matrix;
+	Vec4f localSphere = entity.mesh->getBoundingSphere();
+	Vec3f center = transform * Vec3f{localSphere.x(), localSphere.y(), localSphere.z()};
+	Vec3f scale = transform.scaleVec();
+	float radius = localSphere[3] * std::max({scale.x(), scale.y(), scale.z()});
+	std::optional<Mat3x4f> prevFrameTransform = entity.getPreviousFrameLocalToWorldTransform();
+	if (Optix::isMotionBlurEnabled() && prevFrameTransform.has_value()) {
+		// Motion-blurred instance may move by its displacement since the previous frame, see makeMotionTransform().
+		radius += (transform.translation() - prevFrameTransform->translation()).length();
+	}
+	return Vec4f{center.x(), center.y(), center.z(), radius};
+}
+
+// Entities posed only once stay in that pose at any time.
+static double getLastMotionTime(const EntityTransformHistory& history)
+{
+	return history.count > 1 ? history.times[0] : -std::numeric_limits<double>::infinity();
+}
+
+EntityTransformHistory Scene::makeTransformHistory(const Entity& entity)
+{
+	// Same as instances, histories are compared bytewise.
+	EntityTransformHistory history;
+	std::memset(&history, 0, sizeof(history));
+
+	// Matrices set from device memory are scattered by a kernel (see buildAS), only the current and former ones are kept.
+	// A transform set without scene time cannot be placed in the history, and neither can the older ones.
+	int capacity = entity.deviceTransformSlot.has_value() ? 2 : EntityTransformHistory::CAPACITY;
+	bool isTimed = entity.transformInfo.time.has_value();
+	history.transforms[0] = entity.transformInfo.matrix;
+	history.times[0] = entity.transformInfo.time.value_or(Time::zero()).asSeconds();
+	history.count = 1;
+	auto appendOlder = [&](const Entity::TransformWithTime& info) {
+		isTimed = isTimed && info.time.has_value() && history.count < capacity;
+		if (isTimed) {
+			history.transforms[history.count] = info.matrix;
+			history.times[history.count] = info.time->asSeconds();
+			history.count += 1;
+		}
 	};
+	appendOlder(entity.formerTransformInfo);
+	std::ranges::for_each(entity.earlierTransformInfos, appendOlder);
+	return history;
 }
 
-OptixTraversableHandle Scene::buildAS()
+void Scene::buildAS(OptixStructsBuffer& buffer)
 {
+	buffer.asVersion = asVersion;
+	buffer.entitySetVersion = entitySetVersion;
+	buffer.asRefitCount = 0;
+	buffer.lastMotionTime = -std::numeric_limits<double>::infinity();
+	waitForPendingUploads(buffer.asBuiltEvent);
+
 	if (getObjectCount() == 0) {
-		return static_cast<OptixTraversableHandle>(0);
+		buffer.asHandle = static_cast<OptixTraversableHandle>(0);
+		return;
 	}
 
 	// Construct Instance Acceleration Structures based on Entities present on the scene
-	// TODO: this approach may be inefficient - most of the time only transform changes
-	auto instances = HostPinnedArray<OptixInstance>::create();
-	instances->reserve(entities.size(), false);
-	for (auto&& entity : entities) {
-		int idx = instances->getCount();
-		OptixInstance instance = {
-		    .instanceId = static_cast<unsigned int>(entity->id),
-		    .sbtOffset = static_cast<unsigned int>(idx), // NOTE: this assumes a single SBT record per GAS
-		    .visibilityMask = 255,
-		    .flags = OPTIX_INSTANCE_FLAG_DISABLE_ANYHIT,
-		    .traversableHandle = entity->mesh->getGAS(getStream()),
+	updateSBTMeshes();
+	updateInstanceOrder();
+	buffer.staticInstanceCount = staticInstanceCount;
+	buffer.staticGASVersionSum = 0;
+	buffer.gasVersionSum = 0;
+	bool isMotionBlurEnabled = Optix::isMotionBlurEnabled();
+	buffer.hInstances->reserve(entities.size(), false);
+	buffer.hInstanceBounds->reserve(instanceBoundsEnabled ? entities.size() : 0, false);
+	buffer.hTransformHistories->reserve(entities.size(), false);
+	buffer.hMotionTransforms->reserve(isMotionBlurEnabled ? entities.size() : 0, false);
+	if (isMotionBlurEnabled) {
+		// Reallocated only if the count has changed, i.e. when prepareBufferForReuse() waited for graphs on the host.
+		buffer.dMotionTransforms->resize(entities.size(), false, false);
+		buffer.motionTransformHandles.resize(entities.size());
+		for (std::size_t idx = 0; idx < entities.size(); ++idx) {
+			CUdeviceptr motionTransform = buffer.dMotionTransforms->getDeviceReadPtr() +
+			                              idx * sizeof(OptixMatrixMotionTransform);
+			CHECK_OPTIX(optixConvertPointerToTraversableHandle(Optix::getOrCreate().context, motionTransform,
+			                                                   OPTIX_TRAVERSABLE_TYPE_MATRIX_MOTION_TRANSFORM,
+			                                                   &buffer.motionTransformHandles[idx]));
+		}
+	}
+	for (std::size_t idx = 0; idx < instanceOrder.size(); ++idx) {
+		OptixInstance instance = makeInstance(*instanceOrder[idx]);
+		if (isMotionBlurEnabled) {
+			buffer.hMotionTransforms->append(makeMotionTransform(*instanceOrder[idx], instance.traversableHandle));
+			instance.traversableHandle = buffer.motionTransformHandles[idx];
+		}
+		buffer.hInstances->append(instance);
+		if (instanceBoundsEnabled) {
+			buffer.hInstanceBounds->append(makeInstanceBounds(*instanceOrder[idx]));
+		}
+		EntityTransformHistory history = makeTransformHistory(*instanceOrder[idx]);
+		buffer.hTransformHistories->append(history);
+		buffer.lastMotionTime = std::max(buffer.lastMotionTime, getLastMotionTime(history));
+		if (idx < staticInstanceCount) {
+			buffer.staticGASVersionSum += instanceOrder[idx]->mesh->getGASVersion();
+		}
+		buffer.gasVersionSum += instanceOrder[idx]->mesh->getGASVersion();
+	}
+
+	enqueueWaitForMeshes();
+
+	// Copies are queued in the scene stream, since graphs of the previous version may still read instances (culling).
+	// If the count has changed, so did the set of entities, and prepareBufferForReuse() waited for them on the host.
+	buffer.dInstances->resize(buffer.hInstances->getCount(), false, false);
+	CHECK_CUDA(cudaMemcpyAsync(buffer.dInstances->getWritePtr(), buffer.hInstances->getReadPtr(),
+	                           sizeof(OptixInstance) * buffer.hInstances->getCount(), cudaMemcpyHostToDevice,
+	                           getStream()->getHandle()));
+	if (instanceBoundsEnabled) {
+		buffer.dInstanceBounds->resize(buffer.hInstanceBounds->getCount(), false, false);
+		CHECK_CUDA(cudaMemcpyAsync(buffer.dInstanceBounds->getWritePtr(), buffer.hInstanceBounds->getReadPtr(),
+		                           sizeof(Vec4f) * buffer.hInstanceBounds->getCount(), cudaMemcpyHostToDevice,
+		                           getStream()->getHandle()));
+	}
+	buffer.dTransformHistories->resize(buffer.hTransformHistories->getCount(), false, false);
+	CHECK_CUDA(cudaMemcpyAsync(buffer.dTransformHistories->getWritePtr(), buffer.hTransformHistories->getReadPtr(),
+	                           sizeof(EntityTransformHistory) * buffer.hTransformHistories->getCount(),
+	                           cudaMemcpyHostToDevice, getStream()->getHandle()));
+	if (isMotionBlurEnabled) {
+		CHECK_CUDA(cudaMemcpyAsync(buffer.dMotionTransforms->getWritePtr(), buffer.hMotionTransforms->getReadPtr(),
+		                           sizeof(OptixMatrixMotionTransform) * buffer.hMotionTransforms->getCount(),
+		                           cudaMemcpyHostToDevice, getStream()->getHandle()));
+	}
+	updateDeviceTransformTargets(buffer);
+	if (buffer.dDeviceTransformTargets->getCount() > 0) {
+		gpuScatterInstanceTransforms(getStream()->getHandle(), buffer.dDeviceTransformTargets->getCount(),
+		                             buffer.dDeviceTransformTargets->getReadPtr(), dDeviceTransforms->getReadPtr(),
+		                             buffer.dInstances->getWritePtr());
+		gpuScatterTransformHistories(getStream()->getHandle(), buffer.dDeviceTransformTargets->getCount(),
+		                             buffer.dDeviceTransformTargets->getReadPtr(), dDeviceTransforms->getReadPtr(),
+		                             dDeviceFormerTransforms->getReadPtr(), buffer.dTransformHistories->getWritePtr());
+	}
+
+	if (buffer.staticInstanceCount > 0) {
+		buildTwoLevelAS(buffer, true, false);
+	}
+	else {
+		buffer.instanceInput = {
+		    .type = OPTIX_BUILD_INPUT_TYPE_INSTANCES,
+		    .instanceArray = {.instances = buffer.dInstances->getDeviceReadPtr(),
+		                      .numInstances = static_cast<unsigned int>(buffer.dInstances->getCount())},
+		};
+		enqueueIASBuild(buffer.scratchpad, buffer.instanceInput, instanceBuildOptions, buffer.asHandle);
+	}
+
+	// Scene stream waits for GASes of meshes queued in makeInstance(), so the event covers them as well.
+	CHECK_CUDA(cudaEventRecord(buffer.asBuiltEvent->getHandle(), getStream()->getHandle()));
+
+	// scratchpad.doCompaction(sceneHandle);
+}
+
+void Scene::refitAS(OptixStructsBuffer& buffer)
+{
+	// Entities did not change since the last build of this buffer, so their order matches the order of hInstances.
+	buffer.asVersion = asVersion;
+	cudaStream_t streamHandle = getStream()->getHandle();
+	waitForPendingUploads(buffer.asBuiltEvent);
+	ChangedElementsUploader<OptixInstance> uploader{*buffer.hInstances, *buffer.dInstances, streamHandle, entities.size()};
+	std::optional<ChangedElementsUploader<OptixMatrixMotionTransform>> motionUploader;
+	if (Optix::isMotionBlurEnabled()) {
+		motionUploader.emplace(*buffer.hMotionTransforms, *buffer.dMotionTransforms, streamHandle, entities.size());
+	}
+	uint64_t staticGASVersionSum = 0;
+	uint64_t gasVersionSum = 0;
+	bool staticInstancesChanged = false;
+	for (std::size_t idx = 0; idx < instanceOrder.size(); ++idx) {
+		OptixInstance instance = makeInstance(*instanceOrder[idx]);
+		if (motionUploader.has_value()) {
+			motionUploader->update(idx, makeMotionTransform(*instanceOrder[idx], instance.traversableHandle));
+			instance.traversableHandle = buffer.motionTransformHandles[idx];
+		}
+		uploader.update(idx, instance);
+		if (idx < buffer.staticInstanceCount) {
+			staticGASVersionSum += instanceOrder[idx]->mesh->getGASVersion();
+		}
+		gasVersionSum += instanceOrder[idx]->mesh->getGASVersion();
+		if (idx + 1 == buffer.staticInstanceCount) {
+			// Bounds of motion transforms are baked into the static IAS as well.
+			bool staticMotionChanged = motionUploader.has_value() && motionUploader->takeAnyChanged();
+			staticInstancesChanged = uploader.takeAnyChanged() || staticMotionChanged ||
+			                         staticGASVersionSum != buffer.staticGASVersionSum;
+		}
+	}
+	uploader.finish();
+	if (motionUploader.has_value()) {
+		motionUploader->finish();
+	}
+	buffer.staticGASVersionSum = staticGASVersionSum;
+	buffer.gasVersionSum = gasVersionSum;
+	if (instanceBoundsEnabled) {
+		// Enabling bounds requests a rebuild, so the build of this buffer has already sized them.
+		ChangedElementsUploader<Vec4f> boundsUploader{*buffer.hInstanceBounds, *buffer.dInstanceBounds, streamHandle,
+		                                              entities.size()};
+		for (std::size_t idx = 0; idx < instanceOrder.size(); ++idx) {
+			boundsUploader.update(idx, makeInstanceBounds(*instanceOrder[idx]));
+		}
+		boundsUploader.finish();
+	}
+	// Histories change along with instances, so they are versioned with the AS (see SceneSnapshot).
+	ChangedElementsUploader<EntityTransformHistory> historyUploader{*buffer.hTransformHistories, *buffer.dTransformHistories,
+	                                                                streamHandle, entities.size()};
+	buffer.lastMotionTime = -std::numeric_limits<double>::infinity();
+	for (std::size_t idx = 0; idx < instanceOrder.size(); ++idx) {
+		EntityTransformHistory history = makeTransformHistory(*instanceOrder[idx]);
+		historyUploader.update(idx, history);
+		buffer.lastMotionTime = std::max(buffer.lastMotionTime, getLastMotionTime(history));
+	}
+	historyUploader.finish();
+	enqueueWaitForMeshes();
+	updateDeviceTransformTargets(buffer);
+	if (buffer.dDeviceTransformTargets->getCount() > 0) {
+		gpuScatterInstanceTransforms(streamHandle, buffer.dDeviceTransformTargets->getCount(),
+		                             buffer.dDeviceTransformTargets->getReadPtr(), dDeviceTransforms->getReadPtr(),
+		                             buffer.dInstances->getWritePtr());
+		gpuScatterTransformHistories(streamHandle, buffer.dDeviceTransformTargets->getCount(),
+		                             buffer.dDeviceTransformTargets->getReadPtr(), dDeviceTransforms->getReadPtr(),
+		                             dDeviceFormerTransforms->getReadPtr(), buffer.dTransformHistories->getWritePtr());
+	}
+
+	if (buffer.staticInstanceCount > 0) {
+		// Dynamic IAS is rebuilt from time to time, like the single one below; static IAS only when its instances change.
+		buildTwoLevelAS(buffer, staticInstancesChanged, buffer.asRefitCount < maxASRefitCount);
+	}
+	else {
+		OptixAccelBuildOptions refitOptions = instanceBuildOptions;
+		refitOptions.operation = OPTIX_BUILD_OPERATION_UPDATE;
+		enqueueIASBuild(buffer.scratchpad, buffer.instanceInput, refitOptions, buffer.asHandle);
+		buffer.asRefitCount += 1;
+	}
+
+	CHECK_CUDA(cudaEventRecord(buffer.asBuiltEvent->getHandle(), streamHandle));
+}
+
+void Scene::buildTwoLevelAS(OptixStructsBuffer& buffer, bool rebuildStatic, bool refitDynamic)
+{
+	std::size_t staticCount = buffer.staticInstanceCount;
+	std::size_t dynamicCount = buffer.dInstances->getCount() - staticCount;
+	if (rebuildStatic) {
+		buffer.staticInstanceInput = {
+		    .type = OPTIX_BUILD_INPUT_TYPE_INSTANCES,
+		    .instanceArray = {.instances = buffer.dInstances->getDeviceReadPtr(),
+		                      .numInstances = static_cast<unsigned int>(staticCount)},
 		};
-		entity->transformInfo.matrix.toRaw(instance.transform);
-		instances->append(instance);
+		enqueueIASBuild(buffer.staticScratchpad, buffer.staticInstanceInput, instanceBuildOptions, buffer.staticASHandle);
+		// Static IAS is used for many frames, so it is compacted right away, although reading its size stalls the host.
+		buffer.staticScratchpad.compactNow(buffer.staticASHandle, getStream());
+	}
+	if (dynamicCount == 0) {
+		buffer.asHandle = buffer.staticASHandle; // Instance indices are the same as in the top-level IAS
+		return;
 	}
 
-	dInstances->resize(instances->getCount(), false, false);
-	dInstances->copyFrom(instances);
+	OptixAccelBuildOptions dynamicOptions = instanceBuildOptions;
+	if (refitDynamic) {
+		dynamicOptions.operation = OPTIX_BUILD_OPERATION_UPDATE;
+		buffer.asRefitCount += 1;
+	}
+	else {
+		buffer.instanceInput = {
+		    .type = OPTIX_BUILD_INPUT_TYPE_INSTANCES,
+		    .instanceArray = {.instances = buffer.dInstances->getDeviceReadPtr() + staticCount * sizeof(OptixInstance),
+		                      .numInstances = static_cast<unsigned int>(dynamicCount)},
+		};
+		buffer.asRefitCount = 0;
+	}
+	enqueueIASBuild(buffer.scratchpad, buffer.instanceInput, dynamicOptions, buffer.dynamicASHandle);
 
-	OptixBuildInput instanceInput = {
+	// Bounds of children are baked into the top-level IAS, so it is rebuilt after each change; it has only two instances.
+	auto makeChildInstance = [](OptixTraversableHandle handle, std::size_t firstInstanceIdx) {
+		OptixInstance instance = {
+		    .instanceId = static_cast<unsigned int>(firstInstanceIdx), // See getEntityInstanceIndex() in closest-hit
+		    .visibilityMask = 0xFF,
+		    .flags = OPTIX_INSTANCE_FLAG_NONE,
+		    .traversableHandle = handle,
+		};
+		Mat3x4f::identity().toRaw(instance.transform);
+		return instance;
+	};
+	ChangedElementsUploader<OptixInstance> topUploader{*buffer.hTopInstances, *buffer.dTopInstances,
+	                                                   getStream()->getHandle(), 2};
+	topUploader.update(0, makeChildInstance(buffer.staticASHandle, 0));
+	topUploader.update(1, makeChildInstance(buffer.dynamicASHandle, staticCount));
+	topUploader.finish();
+	OptixBuildInput topInput = {
 	    .type = OPTIX_BUILD_INPUT_TYPE_INSTANCES,
-	    .instanceArray = {.instances = dInstances->getDeviceReadPtr(),
-	                      .numInstances = static_cast<unsigned int>(dInstances->getCount())},
+	    .instanceArray = {.instances = buffer.dTopInstances->getDeviceReadPtr(), .numInstances = 2},
 	};
+	OptixAccelBuildOptions topOptions = {.buildFlags = OPTIX_BUILD_FLAG_PREFER_FAST_BUILD,
+	                                     .operation = OPTIX_BUILD_OPERATION_BUILD};
+	enqueueIASBuild(buffer.topScratchpad, topInput, topOptions, buffer.asHandle);
+}
 
-	OptixAccelBuildOptions accelBuildOptions = {
-	    .buildFlags =
-	        OPTIX_BUILD_FLAG_ALLOW_UPDATE // TODO(prybicki): figure out if there's a faster way to update than the current one
-	        | OPTIX_BUILD_FLAG_ALLOW_COMPACTION,
-	    .operation = OPTIX_BUILD_OPERATION_BUILD};
-
-	scratchpad.resizeToFit(instanceInput, accelBuildOptions);
+void Scene::enqueueIASBuild(ASBuildScratchpad& scratchpad, const OptixBuildInput& input,
+                            const OptixAccelBuildOptions& options, OptixTraversableHandle& handle)
+{
+	// OptiX update disallows buffer sizes to change, so input of an update has to be the same as in the last build.
+	scratchpad.resizeToFit(input, options);
 
+	bool emitsCompactedSize = options.operation == OPTIX_BUILD_OPERATION_BUILD &&
+	                          (options.buildFlags & OPTIX_BUILD_FLAG_ALLOW_COMPACTION) != 0;
 	OptixAccelEmitDesc emitDesc = {
 	    .result = scratchpad.dCompactedSize->getDeviceReadPtr(),
 	    .type = OPTIX_PROPERTY_TYPE_COMPACTED_SIZE,
 	};
 
-	OptixTraversableHandle sceneHandle;
-	CHECK_OPTIX(optixAccelBuild(Optix::getOrCreate().context, getStream()->getHandle(), &accelBuildOptions, &instanceInput, 1,
+	CHECK_OPTIX(optixAccelBuild(Optix::getOrCreate().context, getStream()->getHandle(), &options, &input, 1,
 	                            scratchpad.dTemp->getDeviceReadPtr(),
 	                            scratchpad.dTemp->getSizeOf() * scratchpad.dTemp->getCount(),
 	                            scratchpad.dFull->getDeviceReadPtr(),
-	                            scratchpad.dFull->getSizeOf() * scratchpad.dFull->getCount(), &sceneHandle, &emitDesc, 1));
+	                            scratchpad.dFull->getSizeOf() * scratchpad.dFull->getCount(), &handle,
+	                            emitsCompactedSize ? &emitDesc : nullptr, emitsCompactedSize ? 1 : 0));
+}
 
-	CHECK_CUDA(cudaStreamSynchronize(getStream()->getHandle()));
+void Scene::requestASRebuild()
+{
+	entitySetVersion += 1;
+	asVersion += 1;
+}
 
-	// scratchpad.doCompaction(sceneHandle);
+void Scene::requestASRefit() { asVersion += 1; }
 
-	return sceneHandle;
+void Scene::enableInstanceBounds()
+{
+	auto editsLock = lockEdits(); // Called when RaytraceNode is modified, concurrently with edits of other threads
+	if (!instanceBoundsEnabled) {
+		instanceBoundsEnabled = true;
+		requestASRebuild();
+	}
 }
 
-void Scene::requestASRebuild() { cachedAS.reset(); }
-
-void Scene::requestSBTRebuild() { cachedSBT.reset(); }
+void Scene::requestSBTRebuild() { sbtVersion += 1; }
 
 CudaStream::Ptr Scene::getStream() const { return stream; }
@@ -15,52 +15,167 @@
 #pragma once
 
 #include <set>
+#include <array>
+#include <list>
 #include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <string>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 #include <scene/ASBuildScratchpad.hpp>
 #include <APIObject.hpp>
+#include <CudaEvent.hpp>
 
 #include <Time.hpp>
 #include <gpu/ShaderBindingTableTypes.h>
+#include <gpu/RaytraceRequestContext.hpp>
 #include <memory/Array.hpp>
 
 struct Entity;
+struct Mesh;
+struct Texture;
+
+/**
+ * Immutable version of AS and SBT (along with scene time) used by a single graph run.
+ * Obtained in client's thread when the run is scheduled, released by the graph thread after its raytracing is enqueued.
+ */
+struct SceneSnapshot
+{
+	OptixTraversableHandle as;
+	OptixShaderBindingTable sbt;
+	const EntityInstanceData* entityInstances;
+	const EntityTransformHistory* entityTransformHistories; // In order of entityInstances, versioned with the AS
+	std::optional<Time> time;
+	std::optional<Time> deltaTime;
+
+	// Instances of the AS (in order of entityInstances) and their bounds, used to build culled AS (see RaytraceNode).
+	// Bounds are world-space spheres (xyz: center, w: radius), available only if enabled (see enableInstanceBounds()).
+	const OptixInstance* instances;
+	const Vec4f* instanceBounds;
+	std::size_t instanceCount;
+	uint64_t asVersion;     // Snapshots with the same version have the same instances
+	uint64_t gasVersionSum; // Sum of Mesh::getGASVersion() over instances, changes whenever any of their GASes is updated
+	uint64_t sbtVersion;    // Snapshots with the same version have the same entity data (e.g. ids, textures)
+	double lastMotionTime;  // Newest time (seconds) in histories of entities posed more than once, -inf if there are none
+
+	// Internal, used by Scene to track the use of the version.
+	std::size_t bufferIdx{0};
+	CudaEvent::Ptr releasedEvent{nullptr}; // Recorded after the last work reading this version
+};
 
 /**
  * Class responsible for managing objects and meshes, building AS and SBT.
- * Ported from the PoC code which assumed 1:1 mesh:object relationship.
- * Because of that, when some objects share a mesh, SBT records will be duplicated.
- * This will still work, but it causes pointless CPU -> GPU copies.
- * TODO(prybicki): fix it
+ * Scenes are independent: each has its own entities, time, settings, stream and versions of AS and SBT.
+ * Meshes (and their GASes) are shared by all scenes, see enqueueWaitForMeshes().
+ * SBT contains a hitgroup record per Mesh and closest-hit variant, shared by all Entities using it.
+ * Per-Entity data (e.g. texture) is stored in a separate buffer indexed by the instance index.
+ * Recent poses of entities (see EntityTransformHistory) are stored likewise, but uploaded along with instances,
+ * so that moving entities (in almost every frame) does not rebuild the SBT.
+ * If there are static entities (see Entity::setStatic), AS is two-level: a static IAS, rebuilt (and compacted) only when
+ * static instances change, and a dynamic IAS, refitted in each version, are children of a top-level IAS.
+ * Instances (and entity data) are ordered static-first, so that each child IAS covers a contiguous range of them.
+ * With motion blur enabled (see Optix::configureMotionBlur), each instance references its GAS via a motion transform
+ * extrapolating the entity's motion since the previous frame over the following one (see makeMotionTransform()).
  *
  * This class may be accessed from different threads:
- * - client's thread doing API calls, modifying scene
- * - graph execution threads, requesting AS and SBT from RaytraceNode
- * As of now, Scene is not thread-safe, i.e. it is meant to be accessed only from the client's thread.
- * Calls that modify the scene waits until all current graph threads finish (done in API calls).
- * The only case when graph thread accesses scene is getAS() and getSBT(), which are locked.
+ * - client's threads doing API calls, modifying scene
+ * - graph execution threads, using snapshots of AS and SBT in RaytraceNode
+ * Client's threads modify scenes (and acquire snapshots) only with lockEdits() held, graph threads use only snapshots.
+ * Snapshots are double-buffered: graphs raytrace an immutable version, while the next one is built in the other buffer.
+ * Therefore, changing entities (poses, ids, textures, adding and removing) does not wait for running graphs.
+ * Calls that modify meshes or textures still wait until all current graph threads finish (done in API calls).
+ * A buffer is rebuilt in the scene stream only after the work of graphs using its previous version (GPU-side wait).
+ * Meshes and textures referenced by a version are retained until such work completes.
+ * AS and SBT (and meshes) are prepared asynchronously in the scene stream; graph streams are ordered after it with events,
+ * see enqueueWaitForSnapshotLocked().
  *
  */
-struct Scene
+struct Scene : APIObject<Scene>
 {
-	static Scene& instance();
+	friend struct APIObject<Scene>;
 
-	Scene(const Scene&) = delete;
-	Scene(Scene&&) = delete;
-	Scene& operator=(const Scene&) = delete;
-	Scene& operator=(Scene&&) = delete;
+	/**
+	 * Returns the default scene, used when API calls are given no (NULL) scene.
+	 * Unlike scenes created with rgl_scene_create, it is not registered in instances and cannot be destroyed.
+	 */
+	static std::shared_ptr<Scene> defaultInstance();
 
+	/**
+	 * Returns the scene of the given handle (see validatePtr) or the default scene, if the handle is NULL.
+	 */
+	static std::shared_ptr<Scene> validateOrDefault(Scene* rawPtr);
+
+	/**
+	 * Calls the function for the default scene and all created scenes, e.g. to propagate changes of shared meshes.
+	 */
+	static void forEach(const std::function<void(Scene&)>& fn);
+
+	/**
+	 * Locks edits of all scenes (entities, settings and changes propagated from meshes) made by client's threads.
+	 * A single lock is used, because meshes are shared by scenes; edits are short, unlike the work of graphs using snapshots.
+	 * Acquiring a snapshot holds it as well, so that the snapshot contains either all or none of the changes of an API call.
+	 */
+	static std::unique_lock<std::recursive_mutex> lockEdits();
+
+	/**
+	 * Returns identifier unique in the process, i.e. not reused after the scene is destroyed (unlike its address).
+	 */
+	uint64_t getId() const { return id; }
+
+	/**
+	 * Adds the entity to the scene. If its mesh is not ready yet (see Mesh::createStreamed), the entity is kept aside
+	 * and joins the scene in the first snapshot acquired after the mesh becomes ready.
+	 */
 	void addEntity(std::shared_ptr<Entity> entity);
+
+	/**
+	 * Adds many entities at once (e.g. instances of vegetation), invalidating AS and SBT once for all of them.
+	 */
+	void addEntities(const std::vector<std::shared_ptr<Entity>>& newEntities);
 	void removeEntity(std::shared_ptr<Entity> entity);
 	void clear();
 
-	void setTime(Time time)
-	{
-		prevTime = this->time;
-		this->time = time;
-	}
+	/**
+	 * Creates a scene with copies of all entities (with their transforms of the last two updates) and the time of this one,
+	 * e.g. to branch scenario variations from a common prefix. Copies refer to the same meshes and textures, so nothing is
+	 * uploaded and GASes are shared; AS and SBT of the new scene are built when its first snapshot is acquired.
+	 * @param outEntityCopies Receives the copy of each entity of this scene.
+	 */
+	std::shared_ptr<Scene> fork(std::unordered_map<const Entity*, std::shared_ptr<Entity>>& outEntityCopies);
+
+	/**
+	 * Sets transforms of entities of this scene from an array in device memory, without a round trip through the host.
+	 * The array is read in the scene stream after the given event (if not null); it may be reused when this call returns.
+	 * Transforms are kept in device memory (both current and former, for velocity) and scattered into instances
+	 * (and transform histories) with kernels in each build of AS, until entity's pose is set from the host.
+	 */
+	void setEntityTransformsFromDevice(const std::vector<std::shared_ptr<Entity>>& updatedEntities, const Mat3x4f* dTransforms,
+	                                   cudaEvent_t readyEvent);
+
+	/**
+	 * Makes the entity's transform no longer taken from device memory, see setEntityTransformsFromDevice().
+	 */
+	void releaseDeviceTransformSlot(Entity& entity);
+
+	/**
+	 * Sets the point (usually the ego vehicle's position) to which distances of entities are measured to select
+	 * their level-of-detail meshes (see Entity::setLodMesh). The selection is updated when acquiring snapshots.
+	 * Selection uses transforms set from the host; entities posed from device memory keep their previous selection.
+	 */
+	void setLodOrigin(Vec3f origin);
+	void requestLodSelectionUpdate() { lodSelectionNeedsUpdate = true; }
+
+	/**
+	 * Requests reordering instances, required when an entity has become static or dynamic. Implies AS and SBT rebuild.
+	 */
+	void requestInstanceOrderUpdate();
+
+	/**
+	 * Sets scene time, which also marks the beginning of a new frame (e.g. for GAS compaction purposes).
+	 */
+	void setTime(Time time);
 	std::optional<Time> getTime() const { return time; }
 	std::optional<Time> getPrevTime() const { return prevTime; }
 	std::optional<Time> getDeltaTime() const { return prevTime.has_value() ? std::optional(*time - *prevTime) : std::nullopt; }
@@ -69,29 +184,275 @@ struct Scene
 
 	CudaStream::Ptr getStream() const;
 
-	OptixTraversableHandle getASLocked();
-	OptixShaderBindingTable getSBTLocked();
+	/**
+	 * Returns the current version of AS and SBT, building it first if the scene has changed.
+	 * Called in client's thread. Each snapshot must be released with releaseSnapshotLocked().
+	 */
+	SceneSnapshot acquireSnapshotLocked();
+
+	/**
+	 * Counterpart of acquireSnapshotLocked() for graphs run together (see GraphRunCtx::runBatch()):
+	 * AS and SBT are prepared once and all the snapshots refer to the same version and time.
+	 */
+	std::vector<SceneSnapshot> acquireSnapshotsLocked(std::size_t count);
+
+	/**
+	 * Makes work queued later in the given stream wait until AS and SBT of the snapshot are ready, without blocking the host.
+	 */
+	void enqueueWaitForSnapshotLocked(const SceneSnapshot& snapshot, cudaStream_t waitingStream);
 
+	/**
+	 * Marks that all work reading the snapshot has been queued in the given stream. Does not throw.
+	 */
+	void releaseSnapshotLocked(const SceneSnapshot& snapshot, cudaStream_t lastReadingStream);
+
+	/**
+	 * Traces rays given by world origins and directions in the current version of AS (without a graph),
+	 * writing the closest hit of each ray; returns when hits are written. Arrays may be in host or device memory.
+	 */
+	void raycastLocked(const Vec3f* origins, const Vec3f* directions, std::size_t count, float maxDistance,
+	                   rgl_raycast_hit_t* outHits);
+
+	/**
+	 * Requests a full rebuild of the IAS, required when the set of entities changed.
+	 */
 	void requestASRebuild();
+
+	/**
+	 * Requests an update (refit) of the IAS, which is valid only when the set of entities is unchanged.
+	 * It should be used when only instance properties (e.g. transform, id or GAS contents) changed.
+	 * If the IAS was not built yet (or a rebuild has been requested), a full rebuild will be done instead.
+	 */
+	void requestASRefit();
 	void requestSBTRebuild();
 
+	/**
+	 * Sets the number of consecutive IAS refits after which a full rebuild is forced.
+	 * Refitting degrades BVH quality over time, so it is beneficial to rebuild it from time to time.
+	 * Setting zero disables refitting.
+	 */
+	void setMaxASRefitCount(std::size_t count) { maxASRefitCount = count; }
+
+	/**
+	 * Enables (or disables, if nullopt) GAS compaction of meshes that remained unchanged for the given number of frames.
+	 * Compaction is done asynchronously in a low-priority stream; compacted GAS is used starting from the next IAS build.
+	 * Applies only to GASes built after enabling compaction.
+	 */
+	void setGASCompaction(std::optional<std::size_t> staticFrameThreshold)
+	{
+		gasCompactionStaticFrameThreshold = staticFrameThreshold;
+	}
+	bool isGASCompactionEnabled() const { return gasCompactionStaticFrameThreshold.has_value(); }
+
+	/**
+	 * Enables tracing rays of all RaytraceNodes in a graph in a single launch, see GraphRunCtx::getRaytraceBatch().
+	 */
+	void setRaytraceBatching(bool enabled) { raytraceBatchingEnabled = enabled; }
+	bool isRaytraceBatchingEnabled() const { return raytraceBatchingEnabled; }
+
+	/**
+	 * Calls the function for each mesh used by entities of any scene or kept by the client, once per mesh.
+	 */
+	static void forEachMesh(const std::function<void(Mesh&)>& fn);
+
+	/**
+	 * Returns device memory held by all versions of IAS (with their instances, bounds and transforms) and SBT, respectively.
+	 */
+	std::size_t getIASBytes() const;
+	std::size_t getSBTBytes() const;
+
+	/**
+	 * Enables (or disables, if nullopt) evicting GASes of meshes unused by all scenes (no entity uses them and no version
+	 * refers to them), least recently used first, while memory of all GASes exceeds the budget.
+	 * Evicted GASes are built again when needed. Checked whenever a snapshot is acquired (an eviction pass);
+	 * GAS is evicted only if its mesh has been unused for at least the given number of passes.
+	 */
+	static void configureGASEviction(std::optional<std::size_t> budgetBytes, std::size_t minUnusedPassCount);
+
+	/**
+	 * Makes snapshots provide world-space bounds of instances, computed on the host in each AS build.
+	 * Requested by RaytraceNodes culling instances; never disabled, since it is cheap compared to the AS build.
+	 */
+	void enableInstanceBounds();
+
 private:
+	/**
+	 * Buffers of a single version of AS and SBT. Each buffer keeps its own mirrors of device data,
+	 * so that only elements changed since the version previously built in this buffer have to be uploaded.
+	 */
+	struct OptixStructsBuffer
+	{
+		ASBuildScratchpad scratchpad;
+		OptixTraversableHandle asHandle{0};
+
+		// Two-level AS: static IAS over the first staticInstanceCount instances, dynamic IAS over the rest
+		// (built with scratchpad and instanceInput) and the top-level IAS (asHandle); unused if there are no static ones.
+		ASBuildScratchpad staticScratchpad;
+		ASBuildScratchpad topScratchpad;
+		OptixTraversableHandle staticASHandle{0};
+		OptixTraversableHandle dynamicASHandle{0};
+		OptixBuildInput staticInstanceInput;
+		std::size_t staticInstanceCount{0};
+		uint64_t staticGASVersionSum{0}; // Sum of Mesh::getGASVersion() over static instances, to detect GAS updates
+		uint64_t gasVersionSum{0};       // The same over all instances, see SceneSnapshot::gasVersionSum
+		double lastMotionTime{0.0};      // See SceneSnapshot::lastMotionTime
+		HostPinnedArray<OptixInstance>::Ptr hTopInstances = HostPinnedArray<OptixInstance>::create();
+		DeviceSyncArray<OptixInstance>::Ptr dTopInstances = DeviceSyncArray<OptixInstance>::create();
+		OptixShaderBindingTable sbt{};
+
+		// Versions of the scene state this buffer has been built from (see Scene::asVersion etc.).
+		std::optional<uint64_t> asVersion;
+		std::optional<uint64_t> sbtVersion;
+		std::optional<uint64_t> entitySetVersion;
+		std::size_t asRefitCount{0};
+
+		// Recorded in the scene stream after queuing work on AS and SBT, respectively.
+		// Before host-side staging buffers are reused, the corresponding previous upload has to complete.
+		CudaEvent::Ptr asBuiltEvent = CudaEvent::create();
+		CudaEvent::Ptr sbtUploadedEvent = CudaEvent::create();
+
+		// hInstances mirrors dInstances and is used to find instances that need to be updated.
+		// TODO: allow non-heap creation;
+		HostPinnedArray<OptixInstance>::Ptr hInstances = HostPinnedArray<OptixInstance>::create();
+		DeviceSyncArray<OptixInstance>::Ptr dInstances = DeviceSyncArray<OptixInstance>::create();
+		OptixBuildInput instanceInput; // Shared between buildAS() and refitAS()
+		HostPinnedArray<Vec4f>::Ptr hInstanceBounds = HostPinnedArray<Vec4f>::create();
+		DeviceSyncArray<Vec4f>::Ptr dInstanceBounds = DeviceSyncArray<Vec4f>::create();
+		HostPinnedArray<EntityTransformHistory>::Ptr hTransformHistories = HostPinnedArray<EntityTransformHistory>::create();
+		DeviceSyncArray<EntityTransformHistory>::Ptr dTransformHistories = DeviceSyncArray<EntityTransformHistory>::create();
+
+		// Motion transforms in order of instances, used only with motion blur enabled.
+		// Their handles depend on device addresses, so they are computed when dMotionTransforms is (re)allocated.
+		using MotionTransform = OptixMatrixMotionTransform;
+		HostPinnedArray<MotionTransform>::Ptr hMotionTransforms = HostPinnedArray<MotionTransform>::create();
+		DeviceSyncArray<MotionTransform>::Ptr dMotionTransforms = DeviceSyncArray<MotionTransform>::create();
+		std::vector<OptixTraversableHandle> motionTransformHandles;
+
+		HostPinnedArray<HitgroupRecord>::Ptr hHitgroupRecords = HostPinnedArray<HitgroupRecord>::create();
+		DeviceSyncArray<HitgroupRecord>::Ptr dHitgroupRecords = DeviceSyncArray<HitgroupRecord>::create();
+		HostPinnedArray<EntityInstanceData>::Ptr hEntityInstanceData = HostPinnedArray<EntityInstanceData>::create();
+		DeviceSyncArray<EntityInstanceData>::Ptr dEntityInstanceData = DeviceSyncArray<EntityInstanceData>::create();
+
+		// (instance index, device transform slot) of entities posed from device memory, see updateDeviceTransformTargets().
+		DeviceSyncArray<Vec2i>::Ptr dDeviceTransformTargets = DeviceSyncArray<Vec2i>::create();
+
+		// Objects referenced by the version, retained until work of graphs using it completes.
+		std::vector<std::shared_ptr<Mesh>> meshes;
+		std::vector<std::shared_ptr<Texture>> textures;
+
+		// Snapshots not released yet and events of released ones.
+		std::size_t pendingReleaseCount{0};
+		std::vector<CudaEvent::Ptr> releasedEvents;
+	};
+
+	// Objects of an overwritten version, which may still be used by the work of graphs.
+	struct RetiredVersion
+	{
+		std::vector<CudaEvent::Ptr> releasedEvents;
+		std::vector<std::shared_ptr<Mesh>> meshes;
+		std::vector<std::shared_ptr<Texture>> textures;
+	};
+
+	static constexpr std::size_t OPTIX_STRUCTS_BUFFER_COUNT = 2;
+
 	Scene();
 
-	OptixShaderBindingTable buildSBT();
-	OptixTraversableHandle buildAS();
+	void prepareBufferForReuse(OptixStructsBuffer& buffer, std::unique_lock<std::mutex>& lock);
+	void releaseRetiredVersions();
+	void enqueueWaitForMeshes();
+	void buildSBT(OptixStructsBuffer& buffer);
+	void buildAS(OptixStructsBuffer& buffer);
+	void refitAS(OptixStructsBuffer& buffer);
+	void waitForPendingUploads(CudaEvent::Ptr uploadEvent);
+	void addReadyEntities();
+	static void evictUnusedGASes();
+	void updateLodSelection();
+	void updateDeviceTransformTargets(OptixStructsBuffer& buffer);
+	void progressGASCompaction();
+	void updateSBTMeshes();
+	void updateInstanceOrder();
+	void buildTwoLevelAS(OptixStructsBuffer& buffer, bool rebuildStatic, bool refitDynamic);
+	void enqueueIASBuild(ASBuildScratchpad& scratchpad, const OptixBuildInput& input, const OptixAccelBuildOptions& options,
+	                     OptixTraversableHandle& handle);
+	OptixInstance makeInstance(const Entity& entity);
+	OptixMatrixMotionTransform makeMotionTransform(const Entity& entity, OptixTraversableHandle gas);
+	HitgroupRecord makeHitgroupRecord(const Mesh& mesh, unsigned closestHitVariant);
+	Vec4f makeInstanceBounds(const Entity& entity);
+	EntityTransformHistory makeTransformHistory(const Entity& entity);
+	EntityInstanceData makeEntityInstanceData(const Entity& entity);
 
 private:
+	// See configureGASEviction(); guarded by lockEdits().
+	static std::optional<std::size_t> gasEvictionBudgetBytes;
+	static std::size_t gasEvictionMinUnusedPassCount;
+	static uint64_t gasEvictionPass;
+
+	uint64_t id;
 	CudaStream::Ptr stream;
-	std::set<std::shared_ptr<Entity>> entities;
-	ASBuildScratchpad scratchpad;
+	CudaStream::Ptr compactionStream;
+	CudaEvent::Ptr meshesReadyEvent = CudaEvent::create();
+	// Dense, in no particular order; removal swaps the last entity into the freed position (see entityIndices).
+	std::vector<std::shared_ptr<Entity>> entities;
+	std::unordered_map<const Entity*, std::size_t> entityIndices;
+	std::set<std::shared_ptr<Entity>> pendingEntities; // Waiting for their meshes to be streamed, see addEntity()
 
 	std::mutex optixStructsMutex;
-	std::optional<OptixTraversableHandle> cachedAS;
-	std::optional<OptixShaderBindingTable> cachedSBT;
+	std::condition_variable snapshotReleased;
+	std::array<OptixStructsBuffer, OPTIX_STRUCTS_BUFFER_COUNT> optixStructsBuffers;
+	std::size_t currentBufferIdx{0};
+	std::list<RetiredVersion> retiredVersions;
+
+	// Incremented on each change of the scene affecting AS, SBT or the set of entities (requiring IAS rebuild), respectively.
+	uint64_t asVersion{0};
+	uint64_t sbtVersion{0};
+	uint64_t entitySetVersion{0};
+
+	std::size_t maxASRefitCount{64};
+	std::optional<std::size_t> gasCompactionStaticFrameThreshold;
+	bool raytraceBatchingEnabled{false};
+	bool instanceBoundsEnabled{false};
+
+	// Meshes used by entities, in order of their hitgroup records.
+	bool sbtMeshesNeedUpdate{true};
+	std::vector<std::shared_ptr<Mesh>> sbtMeshes;
+	std::unordered_map<const Mesh*, unsigned int> meshSBTIndices;
+
+	// Entities in order of instances and entity data: static ones first (see updateInstanceOrder), then dynamic ones.
+	bool instanceOrderNeedsUpdate{true};
+	std::vector<std::shared_ptr<Entity>> instanceOrder;
+	std::size_t staticInstanceCount{0};
+
+	// Raygen and miss records do not depend on the scene content and are shared by all versions.
+	DeviceSyncArray<RaygenRecord>::Ptr dRaygenRecords = DeviceSyncArray<RaygenRecord>::create();
+	DeviceSyncArray<MissRecord>::Ptr dMissRecords = DeviceSyncArray<MissRecord>::create();
+	// Indexed by MESH_PRIMITIVE_* and closest-hit variant, as program groups (see Optix::hitgroupPGs).
+	std::array<std::array<std::array<char, OPTIX_SBT_RECORD_HEADER_SIZE>, CLOSEST_HIT_VARIANT_COUNT>, MESH_PRIMITIVE_TYPE_COUNT>
+	    hitgroupRecordHeaders;
+
+	OptixAccelBuildOptions instanceBuildOptions = {.buildFlags = OPTIX_BUILD_FLAG_ALLOW_UPDATE |
+	                                                              OPTIX_BUILD_FLAG_ALLOW_COMPACTION,
+	                                               .operation = OPTIX_BUILD_OPERATION_BUILD};
+
+	// Transforms of entities posed from device memory, indexed by Entity::deviceTransformSlot (see Entity).
+	// Updated only in the scene stream, by setEntityTransformsFromDevice(); slots of released entities are reused.
+	DeviceSyncArray<Mat3x4f>::Ptr dDeviceTransforms = DeviceSyncArray<Mat3x4f>::create();
+	DeviceSyncArray<Mat3x4f>::Ptr dDeviceFormerTransforms = DeviceSyncArray<Mat3x4f>::create();
+	DeviceSyncArray<Vec2i>::Ptr dUpdatedDeviceTransformSlots = DeviceSyncArray<Vec2i>::create();
+	int32_t deviceTransformSlotCount{0};
+	std::vector<int32_t> freeDeviceTransformSlots;
+
+	// Entities move and the origin changes in almost every frame, so the selection is checked in each snapshot.
+	std::optional<Vec3f> lodOrigin;
+	bool lodSelectionNeedsUpdate{false};
 
-	// TODO: allow non-heap creation;
-	DeviceSyncArray<OptixInstance>::Ptr dInstances = DeviceSyncArray<OptixInstance>::create();
+	// Buffers of raycastLocked(), which launch params are followed by the single request.
+	DeviceSyncArray<Vec3f>::Ptr dRaycastOrigins = DeviceSyncArray<Vec3f>::create();
+	DeviceSyncArray<Vec3f>::Ptr dRaycastDirections = DeviceSyncArray<Vec3f>::create();
+	DeviceSyncArray<Mat3x4f>::Ptr dRaycastRays = DeviceSyncArray<Mat3x4f>::create();
+	DeviceSyncArray<Vec2f>::Ptr dRaycastRange = DeviceSyncArray<Vec2f>::create();
+	DeviceSyncArray<rgl_raycast_hit_t>::Ptr dRaycastHits = DeviceSyncArray<rgl_raycast_hit_t>::create();
+	HostPinnedArray<std::byte>::Ptr hRaycastLaunch = HostPinnedArray<std::byte>::create();
+	DeviceSyncArray<std::byte>::Ptr dRaycastLaunch = DeviceSyncArray<std::byte>::create();
 
 	std::optional<Time> time;
 	std::optional<Time> prevTime;
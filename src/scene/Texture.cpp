@@ -14,63 +14,257 @@
 
 #include <scene/Texture.hpp>
 #include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
 #include "RGLFields.hpp"
 
+std::vector<cudaTextureObject_t> Texture::hTextureTable = {0};
+std::vector<uint32_t> Texture::freeTableSlots;
+DeviceSyncArray<cudaTextureObject_t>::Ptr Texture::dTextureTable;
+std::unordered_multimap<std::size_t, std::weak_ptr<Texture::Storage>> Texture::storagesByHash;
+
 API_OBJECT_INSTANCE(Texture);
 
-Texture::Texture(const void* texels, int width, int height)
-try : resolution(width, height) {
-	createTextureObject(texels, width, height);
+Texture::Texture(const void* texels, int width, int height, int mipLevelCount, rgl_texture_format_t format)
+  : resolution(width, height), mipLevelCount(getMaxMipLevelCount(width, height, format, mipLevelCount))
+{
+	if (format == RGL_TEXTURE_FORMAT_BC4 && (width % 4 != 0 || height % 4 != 0)) {
+		auto msg = fmt::format("Invalid argument: BC4 texture dimensions must be multiples of 4: width={}, height={}", width,
+		                       height);
+		throw std::invalid_argument(msg);
+	}
+
+	std::vector<Level> levels;
+	const auto* texelsBegin = static_cast<const TextureTexelFormat*>(texels);
+	std::vector<TextureTexelFormat> level(texelsBegin, texelsBegin + static_cast<std::size_t>(width) * height);
+	for (int levelIdx = 0, levelWidth = width, levelHeight = height; levelIdx < this->mipLevelCount; ++levelIdx) {
+		levels.emplace_back(format == RGL_TEXTURE_FORMAT_BC4 ? encodeBC4(level, levelWidth, levelHeight) :
+		                                                       Level(level.begin(), level.end()));
+		if (levelIdx + 1 < this->mipLevelCount) {
+			level = downsample(level, levelWidth, levelHeight);
+			levelWidth = std::max(1, levelWidth / 2);
+			levelHeight = std::max(1, levelHeight / 2);
+		}
+	}
+	storage = getOrCreateStorage(levels, width, height, format);
 }
-catch (...) {
-	cleanup();
-	throw;
+
+const cudaTextureObject_t* Texture::getDeviceTable()
+{
+	return dTextureTable != nullptr ? dTextureTable->getReadPtr() : nullptr;
 }
 
-void Texture::createTextureObject(const void* texels, int width, int height)
+int Texture::getMaxMipLevelCount(int width, int height, rgl_texture_format_t format, int requestedCount)
 {
-	cudaResourceDesc res_desc = {};
+	int minLevelSize = format == RGL_TEXTURE_FORMAT_BC4 ? 4 : 1;
+	int levelCount = 1;
+	while (levelCount < requestedCount && width % (2 * minLevelSize) == 0 && height % (2 * minLevelSize) == 0) {
+		width /= 2;
+		height /= 2;
+		levelCount += 1;
+	}
+	// Odd dimensions of uncompressed levels are rounded down, so halving may continue until both are 1.
+	while (format == RGL_TEXTURE_FORMAT_R8 && levelCount < requestedCount && (width > 1 || height > 1)) {
+		width = std::max(1, width / 2);
+		height = std::max(1, height / 2);
+		levelCount += 1;
+	}
+	return levelCount;
+}
 
-	int32_t numComponents = 1;
+std::shared_ptr<Texture::Storage> Texture::getOrCreateStorage(const std::vector<Level>& levels, int width, int height,
+                                                              rgl_texture_format_t format)
+{
+	std::size_t hash = std::hash<int>{}(width) ^ (std::hash<int>{}(height) << 1) ^ (std::hash<int>{}(format) << 2);
+	for (auto&& level : levels) {
+		auto bytes = std::string_view(reinterpret_cast<const char*>(level.data()), level.size());
+		hash = hash * 31 + std::hash<std::string_view>{}(bytes);
+	}
 
-	cudaChannelFormatDesc channel_desc = cudaCreateChannelDesc<TextureTexelFormat>();
+	auto [begin, end] = storagesByHash.equal_range(hash);
+	for (auto it = begin; it != end;) {
+		auto storage = it->second.lock();
+		if (storage == nullptr) {
+			it = storagesByHash.erase(it);
+			continue;
+		}
+		bool isSameLayout = storage->width == width && storage->height == height && storage->format == format &&
+		                    storage->mipLevelCount == static_cast<int>(levels.size());
+		if (isSameLayout && hasContent(*storage, levels)) {
+			return storage;
+		}
+		++it;
+	}
+	auto storage = createStorage(levels, width, height, format);
+	storagesByHash.emplace(hash, storage);
+	return storage;
+}
 
-	int32_t pitch = width * numComponents * sizeof(TextureTexelFormat);
+std::shared_ptr<Texture::Storage> Texture::createStorage(const std::vector<Level>& levels, int width, int height,
+                                                         rgl_texture_format_t format)
+{
+	// Owned from the beginning, so that partially created resources are released if anything throws.
+	auto storage = std::make_shared<Storage>();
+	storage->width = width;
+	storage->height = height;
+	storage->format = format;
+	storage->mipLevelCount = static_cast<int>(levels.size());
 
-	// TODO prybicki
-	// Should we leave it like this, or add new copiers in DeivceBuffer.hpp?
-	// Current copyFromExternal and ensureDeviceCanFit are not working with cudaArray_t
-	CHECK_CUDA(cudaMallocArray(&dPixelArray, &channel_desc, width, height));
+	cudaChannelFormatDesc channel_desc = format == RGL_TEXTURE_FORMAT_BC4 ?
+	                                         cudaCreateChannelDesc(8, 0, 0, 0, cudaChannelFormatKindUnsignedBlockCompressed4) :
+	                                         cudaCreateChannelDesc<TextureTexelFormat>();
+	cudaExtent extent = make_cudaExtent(width, height, 0);
+	CHECK_CUDA(cudaMallocMipmappedArray(&storage->mipmappedArray, &channel_desc, extent, storage->mipLevelCount));
 
-	CHECK_CUDA(cudaMemcpy2DToArray(dPixelArray, 0, 0, texels, pitch, pitch, height, cudaMemcpyHostToDevice));
+	for (int levelIdx = 0; levelIdx < storage->mipLevelCount; ++levelIdx) {
+		cudaArray_t dLevelArray = nullptr;
+		CHECK_CUDA(cudaGetMipmappedArrayLevel(&dLevelArray, storage->mipmappedArray, levelIdx));
+		auto [rowBytes, rowCount] = getLevelRowBytesAndCount(std::max(1, width >> levelIdx), std::max(1, height >> levelIdx),
+		                                                     format);
+		CHECK_CUDA(cudaMemcpy2DToArray(dLevelArray, 0, 0, levels[levelIdx].data(), rowBytes, rowBytes, rowCount,
+		                               cudaMemcpyHostToDevice));
+	}
 
-	res_desc.resType = cudaResourceTypeArray;
-	res_desc.res.array.array = dPixelArray;
+	cudaResourceDesc res_desc = {};
+	res_desc.resType = cudaResourceTypeMipmappedArray;
+	res_desc.res.mipmap.mipmap = storage->mipmappedArray;
 
 	cudaTextureDesc tex_desc = {};
 
 	tex_desc.addressMode[0] = cudaAddressModeWrap;
 	tex_desc.addressMode[1] = cudaAddressModeWrap;
 	tex_desc.filterMode = cudaFilterModePoint;
-	tex_desc.readMode = cudaReadModeElementType;
+	// Required by block-compressed formats; texels are scaled back to their byte range when sampled.
+	tex_desc.readMode = cudaReadModeNormalizedFloat;
 	tex_desc.normalizedCoords = 1;
 	tex_desc.maxAnisotropy = 1;
-	tex_desc.maxMipmapLevelClamp = 99;
+	tex_desc.maxMipmapLevelClamp = static_cast<float>(storage->mipLevelCount - 1);
 	tex_desc.minMipmapLevelClamp = 0;
 	tex_desc.mipmapFilterMode = cudaFilterModePoint;
 	tex_desc.borderColor[0] = 1.0f;
 
-	CHECK_CUDA(cudaCreateTextureObject(&dTextureObject, &res_desc, &tex_desc, nullptr));
+	CHECK_CUDA(cudaCreateTextureObject(&storage->textureObject, &res_desc, &tex_desc, nullptr));
+
+	if (freeTableSlots.empty()) {
+		freeTableSlots.push_back(static_cast<uint32_t>(hTextureTable.size()));
+		hTextureTable.push_back(0);
+	}
+	storage->tableIdx = freeTableSlots.back();
+	freeTableSlots.pop_back();
+	hTextureTable[storage->tableIdx] = storage->textureObject;
+	// Textures are created while no graph is running, so the table may be reallocated.
+	if (dTextureTable == nullptr) {
+		dTextureTable = DeviceSyncArray<cudaTextureObject_t>::create();
+	}
+	dTextureTable->copyFromExternal(hTextureTable.data(), hTextureTable.size());
+	return storage;
 }
 
-Texture::~Texture() { cleanup(); }
+bool Texture::hasContent(const Storage& storage, const std::vector<Level>& levels)
+{
+	Level deviceLevel;
+	for (int levelIdx = 0; levelIdx < storage.mipLevelCount; ++levelIdx) {
+		cudaArray_t dLevelArray = nullptr;
+		CHECK_CUDA(cudaGetMipmappedArrayLevel(&dLevelArray, storage.mipmappedArray, levelIdx));
+		auto [rowBytes, rowCount] = getLevelRowBytesAndCount(std::max(1, storage.width >> levelIdx),
+		                                                     std::max(1, storage.height >> levelIdx), storage.format);
+		deviceLevel.resize(rowBytes * rowCount);
+		CHECK_CUDA(cudaMemcpy2DFromArray(deviceLevel.data(), rowBytes, dLevelArray, 0, 0, rowBytes, rowCount,
+		                                 cudaMemcpyDeviceToHost));
+		if (deviceLevel != levels[levelIdx]) {
+			return false;
+		}
+	}
+	return true;
+}
 
-void Texture::cleanup()
+std::size_t Texture::getAllocatedBytes()
 {
-	cudaDestroyTextureObject(dTextureObject);
-	dTextureObject = 0;
-	if (dPixelArray != nullptr) {
-		cudaFreeArray(dPixelArray);
-		dPixelArray = nullptr;
+	std::size_t bytes = dTextureTable->getCapacity() * sizeof(cudaTextureObject_t);
+	for (auto&& [hash, weakStorage] : storagesByHash) {
+		auto storage = weakStorage.lock();
+		if (storage == nullptr) {
+			continue;
+		}
+		for (int levelIdx = 0; levelIdx < storage->mipLevelCount; ++levelIdx) {
+			auto [rowBytes, rowCount] = getLevelRowBytesAndCount(std::max(1, storage->width >> levelIdx),
+			                                                     std::max(1, storage->height >> levelIdx), storage->format);
+			bytes += rowBytes * rowCount;
+		}
+	}
+	return bytes;
+}
+
+std::pair<std::size_t, std::size_t> Texture::getLevelRowBytesAndCount(int width, int height, rgl_texture_format_t format)
+{
+	if (format == RGL_TEXTURE_FORMAT_BC4) {
+		return {static_cast<std::size_t>(width / 4) * 8, static_cast<std::size_t>(height / 4)};
+	}
+	return {static_cast<std::size_t>(width) * sizeof(TextureTexelFormat), static_cast<std::size_t>(height)};
+}
+
+std::vector<TextureTexelFormat> Texture::downsample(const std::vector<TextureTexelFormat>& texels, int width, int height)
+{
+	int outWidth = std::max(1, width / 2);
+	int outHeight = std::max(1, height / 2);
+	std::vector<TextureTexelFormat> out(static_cast<std::size_t>(outWidth) * outHeight);
+	for (int y = 0; y < outHeight; ++y) {
+		for (int x = 0; x < outWidth; ++x) {
+			int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+			int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+			unsigned sum = texels[y0 * width + x0] + texels[y0 * width + x1] + texels[y1 * width + x0] +
+			               texels[y1 * width + x1];
+			out[y * outWidth + x] = static_cast<TextureTexelFormat>((sum + 2) / 4);
+		}
+	}
+	return out;
+}
+
+std::vector<uint8_t> Texture::encodeBC4(const std::vector<TextureTexelFormat>& texels, int width, int height)
+{
+	std::vector<uint8_t> blocks(static_cast<std::size_t>(width / 4) * (height / 4) * 8);
+	uint8_t* block = blocks.data();
+	for (int blockY = 0; blockY < height; blockY += 4) {
+		for (int blockX = 0; blockX < width; blockX += 4, block += 8) {
+			uint8_t blockTexels[16];
+			for (int i = 0; i < 16; ++i) {
+				blockTexels[i] = texels[(blockY + i / 4) * width + blockX + i % 4];
+			}
+			// Endpoints max > min select the 8-value palette: max, min and 6 values interpolated between them.
+			uint8_t max = *std::max_element(blockTexels, blockTexels + 16);
+			uint8_t min = *std::min_element(blockTexels, blockTexels + 16);
+			block[0] = max;
+			block[1] = min;
+			uint64_t indexBits = 0;
+			if (max > min) {
+				for (int i = 0; i < 16; ++i) {
+					// Palette is ordered: max (0), 6 interpolated from max to min (2..7), min (1).
+					int step = (7 * (max - blockTexels[i]) + (max - min) / 2) / (max - min);
+					uint64_t index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+					indexBits |= index << (3 * i);
+				}
+			}
+			for (int byte = 0; byte < 6; ++byte) {
+				block[2 + byte] = static_cast<uint8_t>(indexBits >> (8 * byte));
+			}
+		}
+	}
+	return blocks;
+}
+
+Texture::Storage::~Storage()
+{
+	if (tableIdx != 0) {
+		// Stale entry is not uploaded; the slot is overwritten (and uploaded) by the next created storage.
+		hTextureTable[tableIdx] = 0;
+		freeTableSlots.push_back(tableIdx);
+	}
+	cudaDestroyTextureObject(textureObject);
+	if (mipmappedArray != nullptr) {
+		cudaFreeMipmappedArray(mipmappedArray);
 	}
 }
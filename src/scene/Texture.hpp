@@ -13,37 +13,103 @@
 // limitations under the License.
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <APIObject.hpp>
 #include <math/Vector.hpp>
+#include <memory/Array.hpp>
 #include <rgl/api/core.h>
+#include <RGLFields.hpp>
 
+/**
+ * Intensity texture. GPU memory is shared by Textures created from identical data, see Storage.
+ */
 struct Texture : APIObject<Texture>
 {
 	friend APIObject<Texture>;
 
-	~Texture();
-
 	Vec2i getResolution() const { return resolution; }
 
 	size_t getWidth() const { return resolution.x(); }
 
 	size_t getHeight() const { return resolution.y(); }
 
-	cudaTextureObject_t getTextureObject() const { return dTextureObject; }
+	cudaTextureObject_t getTextureObject() const { return storage->textureObject; }
+
+	int getMipLevelCount() const { return mipLevelCount; }
+
+	/**
+	 * Returns index of the texture object in the device table (see getDeviceTable), never zero.
+	 */
+	uint32_t getTableIndex() const { return storage->tableIdx; }
+
+	/**
+	 * Returns device table of texture objects of all Textures, where index 0 holds no texture.
+	 * Table may be reallocated when a Texture is created, so the pointer should be read when enqueueing raytracing.
+	 */
+	static const cudaTextureObject_t* getDeviceTable();
 
+	/**
+	 * Returns device memory held by texels of all Textures (de-duplicated storages are counted once) and the device table.
+	 */
+	static std::size_t getAllocatedBytes();
+
+	/**
+	 * Returns the number of levels (at most requested) of a mip chain that can be stored in the given format.
+	 * Block-compressed levels must consist of whole blocks, so their dimensions must remain multiples of 4.
+	 */
+	static int getMaxMipLevelCount(int width, int height, rgl_texture_format_t format, int requestedCount);
 
 private:
-	Texture(const void* texels, int width, int height);
+	/**
+	 * Texture object with its mip levels in GPU memory, occupying a slot in the device table.
+	 * Storages are de-duplicated by a hash of their content, confirmed by comparing the content itself.
+	 */
+	struct Storage
+	{
+		~Storage();
+
+		int width;
+		int height;
+		rgl_texture_format_t format;
+		int mipLevelCount;
+
+		cudaTextureObject_t textureObject{0};
+		cudaMipmappedArray_t mipmappedArray{nullptr};
+		uint32_t tableIdx{0};
+	};
+	using Level = std::vector<uint8_t>; // Bytes of a mip level, as stored on the GPU
+
+	Texture(const void* texels, int width, int height, int mipLevelCount = 1,
+	        rgl_texture_format_t format = RGL_TEXTURE_FORMAT_R8);
 
 	Texture(const Texture&) = delete;            // non construction-copyable
 	Texture& operator=(const Texture&) = delete; // non copyable
 
-	void createTextureObject(const void* texels, int width, int height);
+	static std::shared_ptr<Storage> getOrCreateStorage(const std::vector<Level>& levels, int width, int height,
+	                                                   rgl_texture_format_t format);
+	static std::shared_ptr<Storage> createStorage(const std::vector<Level>& levels, int width, int height,
+	                                              rgl_texture_format_t format);
+	static bool hasContent(const Storage& storage, const std::vector<Level>& levels);
+	// Copies between a level and the host (in either direction) are made in rows of texels or rows of blocks.
+	static std::pair<std::size_t, std::size_t> getLevelRowBytesAndCount(int width, int height, rgl_texture_format_t format);
 
-	void cleanup();
+	// Box-filtered half-resolution level; odd dimensions drop their last row or column.
+	static std::vector<TextureTexelFormat> downsample(const std::vector<TextureTexelFormat>& texels, int width, int height);
+	// BC4 (unsigned) blocks of 8 bytes per 4x4 texels, in row-major order of blocks.
+	static std::vector<uint8_t> encodeBC4(const std::vector<TextureTexelFormat>& texels, int width, int height);
 
 	Vec2i resolution{-1};
+	int mipLevelCount{1};
+	std::shared_ptr<Storage> storage;
 
-	cudaTextureObject_t dTextureObject;
-	cudaArray_t dPixelArray;
+	// Slots of the device table of texture objects; slot 0 is reserved for no texture.
+	static std::vector<cudaTextureObject_t> hTextureTable;
+	static std::vector<uint32_t> freeTableSlots;
+	static DeviceSyncArray<cudaTextureObject_t>::Ptr dTextureTable;
+	// Storages by hash of their content; expired ones are removed on lookup.
+	static std::unordered_multimap<std::size_t, std::weak_ptr<Storage>> storagesByHash;
 };
\ No newline at end of file
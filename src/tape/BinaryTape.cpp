@@ -0,0 +1,186 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <tape/BinaryTape.hpp>
+#include <RGLExceptions.hpp>
+#include <Logger.hpp>
+#include <macros/handleDestructorException.hpp>
+
+BinaryTapeWriter::BinaryTapeWriter(const std::filesystem::path& path)
+{
+	file = fopen(path.string().c_str(), "wb");
+	if (file == nullptr) {
+		throw InvalidFilePath(fmt::format("rgl_tape_record_begin: could not open tape file '{}' due to the error: {}",
+		                                  path.string(), std::strerror(errno)));
+	}
+	BinaryTapeHeader header{.formatVersion = BINARY_TAPE_FORMAT_VERSION, .reserved = 0};
+	std::memcpy(header.magic, BINARY_TAPE_MAGIC, sizeof(header.magic));
+	writeToFile(&header, sizeof(header));
+}
+
+BinaryTapeWriter::~BinaryTapeWriter()
+try {
+	BinaryTapeFooter footer{.indexOffset = fileOffset, .callCount = callOffsets.size()};
+	writeToFile(callOffsets.data(), callOffsets.size() * sizeof(uint64_t));
+
+	footer.nameTableOffset = fileOffset;
+	footer.nameCount = fnNames.size();
+	for (auto&& fnName : fnNames) {
+		auto length = static_cast<uint32_t>(fnName.size());
+		writeToFile(&length, sizeof(length));
+		writeToFile(fnName.data(), fnName.size());
+	}
+	std::memcpy(footer.magic, BINARY_TAPE_MAGIC, sizeof(footer.magic));
+	writeToFile(&footer, sizeof(footer));
+
+	if (fclose(file)) {
+		RGL_WARN("rgl_tape_record_end: failed to close tape file due to the error: {}", std::strerror(errno));
+	}
+}
+HANDLE_DESTRUCTOR_EXCEPTION
+
+void BinaryTapeWriter::writeCall(std::string_view fnName, int64_t timestampNs, const BinaryTapeArgs& args)
+{
+	auto [it, inserted] = fnNameIndices.try_emplace(std::string(fnName), static_cast<uint32_t>(fnNames.size()));
+	if (inserted) {
+		fnNames.emplace_back(fnName);
+	}
+	BinaryTapeCallHeader callHeader{
+	    .timestampNs = timestampNs, .fnNameIdx = it->second, .argsSize = static_cast<uint32_t>(args.size())};
+	callOffsets.push_back(fileOffset);
+	writeToFile(&callHeader, sizeof(callHeader));
+	writeToFile(args.data(), args.size());
+}
+
+void BinaryTapeArgs::writeString(std::string_view value)
+{
+	auto length = static_cast<uint32_t>(value.size());
+	writeTagged(BinaryTapeArgTag::String, length);
+	writeRaw(value.data(), value.size());
+}
+
+void BinaryTapeArgs::writeRaw(const void* src, std::size_t size)
+{
+	auto srcBytes = static_cast<const uint8_t*>(src);
+	bytes.insert(bytes.end(), srcBytes, srcBytes + size);
+}
+
+void BinaryTapeWriter::writeToFile(const void* src, std::size_t size)
+{
+	if (size > 0 && fwrite(src, 1, size, file) != size) {
+		throw RecordError(fmt::format("Failed to write data to tape file"));
+	}
+	fileOffset += size;
+}
+
+BinaryTapeReader::BinaryTapeReader(const std::filesystem::path& path)
+  : file(std::make_unique<MappedFile>(path.string().c_str()))
+{
+	if (file->size() < sizeof(BinaryTapeHeader) + sizeof(BinaryTapeFooter)) {
+		throw RecordError("Invalid Tape: Binary tape file is too short");
+	}
+	auto header = read<BinaryTapeHeader>(0);
+	if (std::memcmp(header.magic, BINARY_TAPE_MAGIC, sizeof(header.magic)) != 0) {
+		throw RecordError("Invalid Tape: Binary tape file has invalid header");
+	}
+	if (header.formatVersion != BINARY_TAPE_FORMAT_VERSION) {
+		throw RecordError(fmt::format("Unsupported Tape format: Binary tape format version {} (expected {})",
+		                              header.formatVersion, BINARY_TAPE_FORMAT_VERSION));
+	}
+	auto footer = read<BinaryTapeFooter>(file->size() - sizeof(BinaryTapeFooter));
+	if (std::memcmp(footer.magic, BINARY_TAPE_MAGIC, sizeof(footer.magic)) != 0) {
+		throw RecordError("Invalid Tape: Binary tape file has no index (recording has not been finished)");
+	}
+	indexOffset = footer.indexOffset;
+	callCount = footer.callCount;
+	getChecked(indexOffset, callCount * sizeof(uint64_t));
+
+	uint64_t nameOffset = footer.nameTableOffset;
+	for (uint64_t nameIdx = 0; nameIdx < footer.nameCount; ++nameIdx) {
+		auto length = read<uint32_t>(nameOffset);
+		auto name = reinterpret_cast<const char*>(getChecked(nameOffset + sizeof(length), length));
+		fnNames.emplace_back(name, length);
+		nameOffset += sizeof(length) + length;
+	}
+}
+
+const uint8_t* BinaryTapeReader::getChecked(uint64_t offset, uint64_t size) const
+{
+	if (offset > file->size() || size > file->size() - offset) {
+		throw RecordError(fmt::format("Invalid Tape: Binary tape offset with size ({}+{}) out of range ({})", offset, size,
+		                              file->size()));
+	}
+	return file->data() + offset;
+}
+
+BinaryTapeCallHeader BinaryTapeReader::getCallHeader(std::size_t callIdx) const
+{
+	if (callIdx >= callCount) {
+		throw RecordError(fmt::format("Invalid Tape: call index {} out of range ({})", callIdx, callCount));
+	}
+	return read<BinaryTapeCallHeader>(read<uint64_t>(indexOffset + callIdx * sizeof(uint64_t)));
+}
+
+TapeCall decodeBinaryTapeCall(const std::string& fnName, int64_t timestampNs, const uint8_t* args, std::size_t argsSize)
+{
+	std::size_t argOffset = 0;
+	auto readChecked = [&]<typename T>(T& value) {
+		if (sizeof(T) > argsSize - argOffset) {
+			throw RecordError(fmt::format("Invalid Tape: arguments of {} are truncated", fnName));
+		}
+		std::memcpy(&value, args + argOffset, sizeof(T));
+		argOffset += sizeof(T);
+		return value;
+	};
+	YAML::Node argsNode{YAML::NodeType::Sequence};
+	while (argOffset < argsSize) {
+		uint8_t tag = 0;
+		int64_t intValue = 0;
+		uint64_t uintValue = 0;
+		float floatValue = 0.0f;
+		double doubleValue = 0.0;
+		uint8_t boolValue = 0;
+		uint32_t length = 0;
+		switch (static_cast<BinaryTapeArgTag>(readChecked(tag))) {
+			case BinaryTapeArgTag::Null: argsNode.push_back(YAML::Node{YAML::NodeType::Null}); break;
+			case BinaryTapeArgTag::Int: argsNode.push_back(readChecked(intValue)); break;
+			case BinaryTapeArgTag::UInt: argsNode.push_back(readChecked(uintValue)); break;
+			case BinaryTapeArgTag::Float: argsNode.push_back(readChecked(floatValue)); break;
+			case BinaryTapeArgTag::Double: argsNode.push_back(readChecked(doubleValue)); break;
+			case BinaryTapeArgTag::Bool: argsNode.push_back(readChecked(boolValue) != 0); break;
+			case BinaryTapeArgTag::String: {
+				readChecked(length);
+				if (length > argsSize - argOffset) {
+					throw RecordError(fmt::format("Invalid Tape: arguments of {} are truncated", fnName));
+				}
+				argsNode.push_back(std::string(reinterpret_cast<const char*>(args + argOffset), length));
+				argOffset += length;
+				break;
+			}
+			default: throw RecordError(fmt::format("Invalid Tape: unknown argument tag {}", static_cast<int>(tag)));
+		}
+	}
+	YAML::Node call;
+	call[fnName]["t"] = timestampNs;
+	call[fnName]["a"] = argsNode;
+	return TapeCall(call);
+}
+
+TapeCall BinaryTapeReader::getCall(std::size_t callIdx) const
+{
+	uint64_t callOffset = read<uint64_t>(indexOffset + callIdx * sizeof(uint64_t));
+	auto header = getCallHeader(callIdx);
+	const uint8_t* args = getChecked(callOffset + sizeof(BinaryTapeCallHeader), header.argsSize);
+	return decodeBinaryTapeCall(getFnName(callIdx), header.timestampNs, args, header.argsSize);
+}
@@ -0,0 +1,216 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <tape/MappedFile.hpp>
+#include <tape/TapeCall.hpp>
+
+/**
+ * Binary tape format, a compact alternative to the YAML list of calls. The file consists of:
+ * - BinaryTapeHeader;
+ * - sequence of calls, each one is BinaryTapeCallHeader followed by argsSize bytes of arguments;
+ *   each argument is BinaryTapeArgTag followed by its value (strings are prefixed by uint32_t length);
+ * - index: offsets (uint64_t) of calls' headers;
+ * - function name table: names (prefixed by uint32_t length) referenced by BinaryTapeCallHeader::fnNameIdx;
+ * - BinaryTapeFooter.
+ * Values are stored unaligned, in the native byte order. Arrays are stored in the side binary file, as in YAML tapes.
+ */
+static constexpr char BINARY_TAPE_MAGIC[8] = "RGLTAPE";
+static constexpr uint32_t BINARY_TAPE_FORMAT_VERSION = 1;
+
+struct BinaryTapeHeader
+{
+	char magic[8];
+	uint32_t formatVersion;
+	uint32_t reserved;
+};
+
+struct BinaryTapeCallHeader
+{
+	int64_t timestampNs;
+	uint32_t fnNameIdx;
+	uint32_t argsSize;
+};
+
+struct BinaryTapeFooter
+{
+	uint64_t indexOffset;
+	uint64_t callCount;
+	uint64_t nameTableOffset;
+	uint64_t nameCount;
+	char magic[8];
+};
+
+enum class BinaryTapeArgTag : uint8_t
+{
+	Null,
+	Int,
+	UInt,
+	Float,
+	Double,
+	Bool,
+	String,
+};
+
+/**
+ * Encoded arguments of a single call, see BinaryTapeWriter::writeCall.
+ */
+struct BinaryTapeArgs
+{
+	void clear() { bytes.clear(); }
+	const uint8_t* data() const { return bytes.data(); }
+	std::size_t size() const { return bytes.size(); }
+
+	void writeArg(std::nullptr_t) { writeTag(BinaryTapeArgTag::Null); }
+	void writeArg(bool value) { writeTagged(BinaryTapeArgTag::Bool, static_cast<uint8_t>(value)); }
+	void writeArg(float value) { writeTagged(BinaryTapeArgTag::Float, value); }
+	void writeArg(double value) { writeTagged(BinaryTapeArgTag::Double, value); }
+	void writeArg(const std::string& value) { writeString(value); }
+	void writeArg(const char* value) { value == nullptr ? writeArg(nullptr) : writeString(value); }
+
+	template<typename T>
+	    requires std::is_integral_v<T>
+	void writeArg(T value)
+	{
+		if constexpr (std::is_signed_v<T>) {
+			writeTagged(BinaryTapeArgTag::Int, static_cast<int64_t>(value));
+		}
+		else {
+			writeTagged(BinaryTapeArgTag::UInt, static_cast<uint64_t>(value));
+		}
+	}
+
+	// Output pointers (e.g. bool* out_alive) are not dereferenced; their value is irrelevant for playback.
+	template<typename T>
+	void writeArg(T* value)
+	{
+		if constexpr (std::is_same_v<std::remove_cv_t<T>, char>) {
+			writeArg(static_cast<const char*>(value));
+		}
+		else {
+			writeTagged(BinaryTapeArgTag::UInt, reinterpret_cast<uint64_t>(value));
+		}
+	}
+
+private:
+	void writeTag(BinaryTapeArgTag tag) { bytes.push_back(static_cast<uint8_t>(tag)); }
+	void writeString(std::string_view value);
+	void writeRaw(const void* src, std::size_t size);
+
+	template<typename T>
+	void writeTagged(BinaryTapeArgTag tag, T value)
+	{
+		writeTag(tag);
+		writeRaw(&value, sizeof(T));
+	}
+
+	std::vector<uint8_t> bytes;
+};
+
+/**
+ * Framing of calls streamed over a socket, see TapeRecorder(const std::string&) and rglServer. Each call is sent as
+ * BinaryTapeStreamCallHeader, the function name, its encoded arguments (BinaryTapeArgs) and the arrays they refer to;
+ * offsets of arrays are relative to the call. The receiver answers each call with BinaryTapeStreamStatus,
+ * followed by the error string if the call has failed.
+ */
+static constexpr uint32_t BINARY_TAPE_STREAM_MAGIC = 0x52474C43; // "RGLC"
+
+struct BinaryTapeStreamCallHeader
+{
+	uint32_t magic;
+	uint32_t fnNameSize;
+	uint32_t argsSize;
+	uint32_t reserved;
+	int64_t timestampNs;
+	uint64_t binarySize;
+};
+static_assert(sizeof(BinaryTapeStreamCallHeader) == 32);
+
+struct BinaryTapeStreamStatus
+{
+	int32_t status; // rgl_status_t
+	uint32_t errorSize;
+};
+static_assert(sizeof(BinaryTapeStreamStatus) == 8);
+
+/**
+ * Decodes arguments encoded with BinaryTapeArgs to the same YAML structure as calls of YAML tapes, see TapeCall.
+ * Used for calls of binary tapes and calls received over sockets (see TapeRecorder's streaming and rglServer).
+ */
+TapeCall decodeBinaryTapeCall(const std::string& fnName, int64_t timestampNs, const uint8_t* args, std::size_t argsSize);
+
+/**
+ * Writes calls to the binary tape. The index and the footer are written on destruction,
+ * i.e. the tape is not playable if recording has not been finished.
+ */
+struct BinaryTapeWriter
+{
+	explicit BinaryTapeWriter(const std::filesystem::path& path);
+	~BinaryTapeWriter();
+
+	BinaryTapeWriter(const BinaryTapeWriter&) = delete;
+	BinaryTapeWriter& operator=(const BinaryTapeWriter&) = delete;
+
+	void writeCall(std::string_view fnName, int64_t timestampNs, const BinaryTapeArgs& args);
+
+private:
+	void writeToFile(const void* src, std::size_t size);
+
+	FILE* file{nullptr};
+	uint64_t fileOffset{0};
+	std::vector<uint64_t> callOffsets;
+	std::unordered_map<std::string, uint32_t> fnNameIndices;
+	std::vector<std::string> fnNames;
+};
+
+/**
+ * Memory-maps the binary tape, so that playback starts without parsing it and any call can be accessed directly.
+ * Calls are decoded to the same YAML structure as calls of YAML tapes, see TapeCall.
+ */
+struct BinaryTapeReader
+{
+	explicit BinaryTapeReader(const std::filesystem::path& path);
+
+	std::size_t getCallCount() const { return callCount; }
+	const std::string& getFnName(std::size_t callIdx) const { return fnNames.at(getCallHeader(callIdx).fnNameIdx); }
+	TapeCall getCall(std::size_t callIdx) const;
+
+private:
+	BinaryTapeCallHeader getCallHeader(std::size_t callIdx) const;
+	const uint8_t* getChecked(uint64_t offset, uint64_t size) const;
+
+	template<typename T>
+	T read(uint64_t offset) const
+	{
+		T value;
+		std::memcpy(&value, getChecked(offset, sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	std::unique_ptr<MappedFile> file;
+	uint64_t indexOffset{0};
+	std::size_t callCount{0};
+	std::vector<std::string> fnNames;
+};
@@ -14,9 +14,16 @@
 
 #pragma once
 
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <yaml-cpp/yaml.h>
 
 #include <Logger.hpp>
+#include <tape/MappedFile.hpp>
 
 // Type used as a key in TapePlayer object registry
 using TapeAPIObjectID = size_t;
@@ -25,8 +32,24 @@ struct PlaybackState
 {
 	explicit PlaybackState(const char* binaryFilePath);
 
+	/**
+	 * Creates a state reading binary data from memory given with setBinaryData, e.g. received with each call by rglServer.
+	 */
+	PlaybackState() = default;
+	void setBinaryData(const uint8_t* data, std::size_t size)
+	{
+		binaryData = data;
+		binarySize = size;
+	}
+
 	void clear();
 
+	/**
+	 * Destroys objects created in the playback, including the default scene (if set) with its entities, then clears the state.
+	 * Unlike rgl_cleanup, objects of other playbacks (e.g. other clients of rglServer) are not affected.
+	 */
+	void destroyObjects();
+
 	template<typename T>
 	T* getPtr(const YAML::Node& offsetYamlNode)
 	{
@@ -35,15 +58,22 @@ struct PlaybackState
 			static_assert(std::is_trivially_copyable_v<T>);
 			sizeOfType = sizeof(T);
 		}
-		if (fileMmap == nullptr) {
+		if (binaryData == nullptr) {
 			throw std::runtime_error("Trying to get tape binary data but it is empty");
 		}
 		auto offset = offsetYamlNode.as<size_t>();
-		if (offset + sizeOfType > mmapSize) {
+		if (offset + sizeOfType > binarySize) {
 			throw std::runtime_error(fmt::format("Tape binary offset with size of requested type ({}+{}) out of range ({})",
-			                                     offset, sizeOfType, mmapSize));
+			                                     offset, sizeOfType, binarySize));
 		}
-		return reinterpret_cast<T*>(fileMmap + offset);
+		return reinterpret_cast<T*>(binaryData + offset);
+	}
+
+	// Scene arguments may be NULL (default scene), which has no entry in scenes.
+	rgl_scene_t getScene(const YAML::Node& sceneYamlNode)
+	{
+		auto sceneId = sceneYamlNode.as<TapeAPIObjectID>();
+		return sceneId == 0 ? defaultScene : scenes.at(sceneId);
 	}
 
 	~PlaybackState();
@@ -51,11 +81,19 @@ struct PlaybackState
 	std::unordered_map<TapeAPIObjectID, rgl_mesh_t> meshes;
 	std::unordered_map<TapeAPIObjectID, rgl_entity_t> entities;
 	std::unordered_map<TapeAPIObjectID, rgl_texture_t> textures;
+	std::unordered_map<TapeAPIObjectID, rgl_scene_t> scenes;
 	std::unordered_map<TapeAPIObjectID, rgl_node_t> nodes;
 
+	// Played in place of NULL (default scene) arguments, e.g. the scene of a client of rglServer.
+	rgl_scene_t defaultScene{nullptr};
+
+	// Memory of buffers registered with rgl_graph_set_result_buffer; kept until the buffers are unregistered in clear().
+	std::map<std::pair<rgl_node_t, rgl_field_t>, std::list<std::vector<char>>> resultBuffers;
+
 private:
-	uint8_t* fileMmap{nullptr};
-	size_t mmapSize{0};
+	void unregisterResultBuffers();
 
-	void mmapInit(const char* path);
+	std::unique_ptr<MappedFile> binaryFile;
+	const uint8_t* binaryData{nullptr};
+	std::size_t binarySize{0};
 };
@@ -22,30 +22,94 @@ class TapeCore
 	static void tape_get_version_info(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_get_extension_info(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_configure_logging(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_logging_queue(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_device_memory_pool(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_get_device_memory_pool_stats(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_host_pinned_memory_pool(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_get_host_pinned_memory_pool_stats(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_get_memory_usage(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_get_memory_kind_stats(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_gas_eviction(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_mesh_cache(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_performance_sampling(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_metrics(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_get_metrics_text(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_trace_start(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_trace_stop(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_get_performance_counters(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_program_cache(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_motion_blur(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_max_register_count(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_warmup(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_device(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_get_device_count(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_configure_threads(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_cleanup(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_mesh_create(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_create_async(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_create_spheres(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_create_curves(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_is_ready(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_mesh_destroy(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_mesh_update_vertices(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_set_skinning(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_update_bones(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_set_keyframes(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_set_keyframe(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_compress(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_mesh_set_texture_coords(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_mesh_set_opacity_micromap(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_texture_create(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_texture_create_mipmapped(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_texture_destroy(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_entity_create(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_entity_destroy(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_entity_set_pose(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_entity_set_id(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_entity_set_class_id(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_entity_set_intensity(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_entity_set_intensity_texture(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_entity_set_lod_mesh(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_entity_set_visibility_mask(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_entity_set_static(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_scene_create(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_scene_destroy(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_scene_fork(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_scene_set_time(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_scene_configure_gas_compaction(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_scene_configure_raytrace_batching(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_scene_set_lod_origin(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_scene_raycast_batch(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_run(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_prepare(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_destroy(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_get_result_size(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_result_frame_id(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_get_result_data(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_results(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_result_data_async(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_result_device_ptr(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_result_chunk(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_result_dlpack(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_set_result_buffer(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_result_buffer_status(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_node_add_child(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_node_remove_child(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_node_set_priority(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_graph_node_get_priority(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_set_gpu_priority(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_set_random_seed(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_configure_result_cache(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_configure_memory_reuse(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_configure_frame_dropping(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_dropped_frame_count(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_graph_get_node_stats(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_rays_from_mat3x4f(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_rays_from_directions(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_rays_from_pattern(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_rays_set_range(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_rays_set_ring_ids(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_rays_set_layout(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_rays_set_time_offsets(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_rays_transform(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_transform(const YAML::Node& yamlNode, PlaybackState& state);
@@ -53,18 +117,54 @@ class TapeCore
 	static void tape_node_raytrace_configure_velocity(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_raytrace_configure_distortion(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_raytrace_configure_non_hits(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_return_mode(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_beam_divergence(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_noise(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_weather(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_multipath(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_visibility_mask(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_culling(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_incremental(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_ray_sorting(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_time_slicing(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_streaming(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_ray_skipping(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_dense_output(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_fused_format(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_raytrace_configure_output_frame(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_format(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_yield(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_shm_publish(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_write_file(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_compress(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_compact(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_compact_by_field(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_compact_by_predicates(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_compact_by_region(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_range_image(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_occupancy_grid(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_occupancy_grid_configure_ray_casting(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_spatial_merge(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_temporal_merge(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_temporal_merge_ring(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_temporal_merge_configure_managed_memory(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_from_array(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_filter_ground(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_filter_ground_plane(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_voxel_downsample(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_sort(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_estimate_normals(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_cluster_euclidean(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_cluster_boxes(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_spatial_index(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_spatial_index_query_nearest(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_spatial_index_query_radius(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_points_radar_postprocess(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_points_radar_range_doppler(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_gaussian_noise_angular_ray(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_gaussian_noise_angular_hitpoint(const YAML::Node& yamlNode, PlaybackState& state);
 	static void tape_node_gaussian_noise_distance(const YAML::Node& yamlNode, PlaybackState& state);
+	static void tape_node_gaussian_noise_transform_points(const YAML::Node& yamlNode, PlaybackState& state);
 
 	// Called once in the translation unit
 	static inline bool autoExtendTapeFunctions = std::invoke([]() {
@@ -73,30 +173,94 @@ class TapeCore
 		    TAPE_CALL_MAPPING("rgl_get_version_info", TapeCore::tape_get_version_info),
 		    TAPE_CALL_MAPPING("rgl_get_extension_info", TapeCore::tape_get_extension_info),
 		    TAPE_CALL_MAPPING("rgl_configure_logging", TapeCore::tape_configure_logging),
+		    TAPE_CALL_MAPPING("rgl_configure_logging_queue", TapeCore::tape_configure_logging_queue),
+		    TAPE_CALL_MAPPING("rgl_configure_device_memory_pool", TapeCore::tape_configure_device_memory_pool),
+		    TAPE_CALL_MAPPING("rgl_get_device_memory_pool_stats", TapeCore::tape_get_device_memory_pool_stats),
+		    TAPE_CALL_MAPPING("rgl_configure_host_pinned_memory_pool", TapeCore::tape_configure_host_pinned_memory_pool),
+		    TAPE_CALL_MAPPING("rgl_get_host_pinned_memory_pool_stats", TapeCore::tape_get_host_pinned_memory_pool_stats),
+		    TAPE_CALL_MAPPING("rgl_get_memory_usage", TapeCore::tape_get_memory_usage),
+		    TAPE_CALL_MAPPING("rgl_get_memory_kind_stats", TapeCore::tape_get_memory_kind_stats),
+		    TAPE_CALL_MAPPING("rgl_configure_gas_eviction", TapeCore::tape_configure_gas_eviction),
+		    TAPE_CALL_MAPPING("rgl_configure_mesh_cache", TapeCore::tape_configure_mesh_cache),
+		    TAPE_CALL_MAPPING("rgl_configure_performance_sampling", TapeCore::tape_configure_performance_sampling),
+		    TAPE_CALL_MAPPING("rgl_configure_metrics", TapeCore::tape_configure_metrics),
+		    TAPE_CALL_MAPPING("rgl_get_metrics_text", TapeCore::tape_get_metrics_text),
+		    TAPE_CALL_MAPPING("rgl_trace_start", TapeCore::tape_trace_start),
+		    TAPE_CALL_MAPPING("rgl_trace_stop", TapeCore::tape_trace_stop),
+		    TAPE_CALL_MAPPING("rgl_get_performance_counters", TapeCore::tape_get_performance_counters),
+		    TAPE_CALL_MAPPING("rgl_configure_program_cache", TapeCore::tape_configure_program_cache),
+		    TAPE_CALL_MAPPING("rgl_configure_motion_blur", TapeCore::tape_configure_motion_blur),
+		    TAPE_CALL_MAPPING("rgl_configure_max_register_count", TapeCore::tape_configure_max_register_count),
+		    TAPE_CALL_MAPPING("rgl_warmup", TapeCore::tape_warmup),
+		    TAPE_CALL_MAPPING("rgl_configure_device", TapeCore::tape_configure_device),
+		    TAPE_CALL_MAPPING("rgl_get_device_count", TapeCore::tape_get_device_count),
+		    TAPE_CALL_MAPPING("rgl_configure_threads", TapeCore::tape_configure_threads),
 		    TAPE_CALL_MAPPING("rgl_cleanup", TapeCore::tape_cleanup),
 		    TAPE_CALL_MAPPING("rgl_mesh_create", TapeCore::tape_mesh_create),
+		    TAPE_CALL_MAPPING("rgl_mesh_create_async", TapeCore::tape_mesh_create_async),
+		    TAPE_CALL_MAPPING("rgl_mesh_create_spheres", TapeCore::tape_mesh_create_spheres),
+		    TAPE_CALL_MAPPING("rgl_mesh_create_curves", TapeCore::tape_mesh_create_curves),
+		    TAPE_CALL_MAPPING("rgl_mesh_is_ready", TapeCore::tape_mesh_is_ready),
 		    TAPE_CALL_MAPPING("rgl_mesh_destroy", TapeCore::tape_mesh_destroy),
 		    TAPE_CALL_MAPPING("rgl_mesh_update_vertices", TapeCore::tape_mesh_update_vertices),
+		    TAPE_CALL_MAPPING("rgl_mesh_set_skinning", TapeCore::tape_mesh_set_skinning),
+		    TAPE_CALL_MAPPING("rgl_mesh_update_bones", TapeCore::tape_mesh_update_bones),
+		    TAPE_CALL_MAPPING("rgl_mesh_set_keyframes", TapeCore::tape_mesh_set_keyframes),
+		    TAPE_CALL_MAPPING("rgl_mesh_set_keyframe", TapeCore::tape_mesh_set_keyframe),
+		    TAPE_CALL_MAPPING("rgl_mesh_compress", TapeCore::tape_mesh_compress),
 		    TAPE_CALL_MAPPING("rgl_mesh_set_texture_coords", TapeCore::tape_mesh_set_texture_coords),
+		    TAPE_CALL_MAPPING("rgl_mesh_set_opacity_micromap", TapeCore::tape_mesh_set_opacity_micromap),
 		    TAPE_CALL_MAPPING("rgl_texture_create", TapeCore::tape_texture_create),
+		    TAPE_CALL_MAPPING("rgl_texture_create_mipmapped", TapeCore::tape_texture_create_mipmapped),
 		    TAPE_CALL_MAPPING("rgl_texture_destroy", TapeCore::tape_texture_destroy),
 		    TAPE_CALL_MAPPING("rgl_entity_create", TapeCore::tape_entity_create),
 		    TAPE_CALL_MAPPING("rgl_entity_destroy", TapeCore::tape_entity_destroy),
 		    TAPE_CALL_MAPPING("rgl_entity_set_pose", TapeCore::tape_entity_set_pose),
 		    TAPE_CALL_MAPPING("rgl_entity_set_id", TapeCore::tape_entity_set_id),
+		    TAPE_CALL_MAPPING("rgl_entity_set_class_id", TapeCore::tape_entity_set_class_id),
+		    TAPE_CALL_MAPPING("rgl_entity_set_intensity", TapeCore::tape_entity_set_intensity),
 		    TAPE_CALL_MAPPING("rgl_entity_set_intensity_texture", TapeCore::tape_entity_set_intensity_texture),
+		    TAPE_CALL_MAPPING("rgl_entity_set_lod_mesh", TapeCore::tape_entity_set_lod_mesh),
+		    TAPE_CALL_MAPPING("rgl_entity_set_visibility_mask", TapeCore::tape_entity_set_visibility_mask),
+		    TAPE_CALL_MAPPING("rgl_entity_set_static", TapeCore::tape_entity_set_static),
+		    TAPE_CALL_MAPPING("rgl_scene_create", TapeCore::tape_scene_create),
+		    TAPE_CALL_MAPPING("rgl_scene_destroy", TapeCore::tape_scene_destroy),
+		    TAPE_CALL_MAPPING("rgl_scene_fork", TapeCore::tape_scene_fork),
 		    TAPE_CALL_MAPPING("rgl_scene_set_time", TapeCore::tape_scene_set_time),
+		    TAPE_CALL_MAPPING("rgl_scene_configure_gas_compaction", TapeCore::tape_scene_configure_gas_compaction),
+		    TAPE_CALL_MAPPING("rgl_scene_configure_raytrace_batching", TapeCore::tape_scene_configure_raytrace_batching),
+		    TAPE_CALL_MAPPING("rgl_scene_set_lod_origin", TapeCore::tape_scene_set_lod_origin),
+		    TAPE_CALL_MAPPING("rgl_scene_raycast_batch", TapeCore::tape_scene_raycast_batch),
 		    TAPE_CALL_MAPPING("rgl_graph_run", TapeCore::tape_graph_run),
+		    TAPE_CALL_MAPPING("rgl_graph_prepare", TapeCore::tape_graph_prepare),
 		    TAPE_CALL_MAPPING("rgl_graph_destroy", TapeCore::tape_graph_destroy),
 		    TAPE_CALL_MAPPING("rgl_graph_get_result_size", TapeCore::tape_graph_get_result_size),
+		    TAPE_CALL_MAPPING("rgl_graph_get_result_frame_id", TapeCore::tape_graph_get_result_frame_id),
 		    TAPE_CALL_MAPPING("rgl_graph_get_result_data", TapeCore::tape_graph_get_result_data),
+		    TAPE_CALL_MAPPING("rgl_graph_get_results", TapeCore::tape_graph_get_results),
+		    TAPE_CALL_MAPPING("rgl_graph_get_result_data_async", TapeCore::tape_graph_get_result_data_async),
+		    TAPE_CALL_MAPPING("rgl_graph_get_result_device_ptr", TapeCore::tape_graph_get_result_device_ptr),
+		    TAPE_CALL_MAPPING("rgl_graph_get_result_chunk", TapeCore::tape_graph_get_result_chunk),
+		    TAPE_CALL_MAPPING("rgl_graph_get_result_dlpack", TapeCore::tape_graph_get_result_dlpack),
+		    TAPE_CALL_MAPPING("rgl_graph_set_result_buffer", TapeCore::tape_graph_set_result_buffer),
+		    TAPE_CALL_MAPPING("rgl_graph_get_result_buffer_status", TapeCore::tape_graph_get_result_buffer_status),
 		    TAPE_CALL_MAPPING("rgl_graph_node_add_child", TapeCore::tape_graph_node_add_child),
 		    TAPE_CALL_MAPPING("rgl_graph_node_remove_child", TapeCore::tape_graph_node_remove_child),
 		    TAPE_CALL_MAPPING("rgl_graph_node_set_priority", TapeCore::tape_graph_node_set_priority),
 		    TAPE_CALL_MAPPING("rgl_graph_node_get_priority", TapeCore::tape_graph_node_get_priority),
+		    TAPE_CALL_MAPPING("rgl_graph_set_gpu_priority", TapeCore::tape_graph_set_gpu_priority),
+		    TAPE_CALL_MAPPING("rgl_graph_set_random_seed", TapeCore::tape_graph_set_random_seed),
+		    TAPE_CALL_MAPPING("rgl_graph_configure_result_cache", TapeCore::tape_graph_configure_result_cache),
+		    TAPE_CALL_MAPPING("rgl_graph_configure_memory_reuse", TapeCore::tape_graph_configure_memory_reuse),
+		    TAPE_CALL_MAPPING("rgl_graph_configure_frame_dropping", TapeCore::tape_graph_configure_frame_dropping),
+		    TAPE_CALL_MAPPING("rgl_graph_get_dropped_frame_count", TapeCore::tape_graph_get_dropped_frame_count),
+		    TAPE_CALL_MAPPING("rgl_graph_get_node_stats", TapeCore::tape_graph_get_node_stats),
 		    TAPE_CALL_MAPPING("rgl_node_rays_from_mat3x4f", TapeCore::tape_node_rays_from_mat3x4f),
+		    TAPE_CALL_MAPPING("rgl_node_rays_from_directions", TapeCore::tape_node_rays_from_directions),
+		    TAPE_CALL_MAPPING("rgl_node_rays_from_pattern", TapeCore::tape_node_rays_from_pattern),
 		    TAPE_CALL_MAPPING("rgl_node_rays_set_range", TapeCore::tape_node_rays_set_range),
 		    TAPE_CALL_MAPPING("rgl_node_rays_set_ring_ids", TapeCore::tape_node_rays_set_ring_ids),
+		    TAPE_CALL_MAPPING("rgl_node_rays_set_layout", TapeCore::tape_node_rays_set_layout),
 		    TAPE_CALL_MAPPING("rgl_node_rays_set_time_offsets", TapeCore::tape_node_rays_set_time_offsets),
 		    TAPE_CALL_MAPPING("rgl_node_rays_transform", TapeCore::tape_node_rays_transform),
 		    TAPE_CALL_MAPPING("rgl_node_points_transform", TapeCore::tape_node_points_transform),
@@ -104,18 +268,60 @@ class TapeCore
 		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_velocity", TapeCore::tape_node_raytrace_configure_velocity),
 		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_distortion", TapeCore::tape_node_raytrace_configure_distortion),
 		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_non_hits", TapeCore::tape_node_raytrace_configure_non_hits),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_return_mode", TapeCore::tape_node_raytrace_configure_return_mode),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_beam_divergence",
+		                      TapeCore::tape_node_raytrace_configure_beam_divergence),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_noise", TapeCore::tape_node_raytrace_configure_noise),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_weather", TapeCore::tape_node_raytrace_configure_weather),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_multipath", TapeCore::tape_node_raytrace_configure_multipath),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_visibility_mask",
+		                      TapeCore::tape_node_raytrace_configure_visibility_mask),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_culling", TapeCore::tape_node_raytrace_configure_culling),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_incremental", TapeCore::tape_node_raytrace_configure_incremental),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_ray_sorting", TapeCore::tape_node_raytrace_configure_ray_sorting),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_time_slicing", TapeCore::tape_node_raytrace_configure_time_slicing),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_streaming", TapeCore::tape_node_raytrace_configure_streaming),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_ray_skipping", TapeCore::tape_node_raytrace_configure_ray_skipping),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_dense_output", TapeCore::tape_node_raytrace_configure_dense_output),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_fused_format", TapeCore::tape_node_raytrace_configure_fused_format),
+		    TAPE_CALL_MAPPING("rgl_node_raytrace_configure_output_frame", TapeCore::tape_node_raytrace_configure_output_frame),
 		    TAPE_CALL_MAPPING("rgl_node_points_format", TapeCore::tape_node_points_format),
 		    TAPE_CALL_MAPPING("rgl_node_points_yield", TapeCore::tape_node_points_yield),
+		    TAPE_CALL_MAPPING("rgl_node_points_shm_publish", TapeCore::tape_node_points_shm_publish),
+		    TAPE_CALL_MAPPING("rgl_node_points_write_file", TapeCore::tape_node_points_write_file),
+		    TAPE_CALL_MAPPING("rgl_node_points_compress", TapeCore::tape_node_points_compress),
 		    TAPE_CALL_MAPPING("rgl_node_points_compact", TapeCore::tape_node_points_compact),
 		    TAPE_CALL_MAPPING("rgl_node_points_compact_by_field", TapeCore::tape_node_points_compact_by_field),
+		    TAPE_CALL_MAPPING("rgl_node_points_compact_by_predicates", TapeCore::tape_node_points_compact_by_predicates),
+		    TAPE_CALL_MAPPING("rgl_node_points_compact_by_region", TapeCore::tape_node_points_compact_by_region),
+		    TAPE_CALL_MAPPING("rgl_node_points_range_image", TapeCore::tape_node_points_range_image),
+		    TAPE_CALL_MAPPING("rgl_node_points_occupancy_grid", TapeCore::tape_node_points_occupancy_grid),
+		    TAPE_CALL_MAPPING("rgl_node_points_occupancy_grid_configure_ray_casting",
+		                      TapeCore::tape_node_points_occupancy_grid_configure_ray_casting),
 		    TAPE_CALL_MAPPING("rgl_node_points_spatial_merge", TapeCore::tape_node_points_spatial_merge),
 		    TAPE_CALL_MAPPING("rgl_node_points_temporal_merge", TapeCore::tape_node_points_temporal_merge),
+		    TAPE_CALL_MAPPING("rgl_node_points_temporal_merge_ring", TapeCore::tape_node_points_temporal_merge_ring),
+		    TAPE_CALL_MAPPING("rgl_node_points_temporal_merge_configure_managed_memory",
+		                      TapeCore::tape_node_points_temporal_merge_configure_managed_memory),
 		    TAPE_CALL_MAPPING("rgl_node_points_from_array", TapeCore::tape_node_points_from_array),
 		    TAPE_CALL_MAPPING("rgl_node_points_filter_ground", TapeCore::tape_node_points_filter_ground),
+		    TAPE_CALL_MAPPING("rgl_node_points_filter_ground_plane", TapeCore::tape_node_points_filter_ground_plane),
+		    TAPE_CALL_MAPPING("rgl_node_points_voxel_downsample", TapeCore::tape_node_points_voxel_downsample),
+		    TAPE_CALL_MAPPING("rgl_node_points_sort", TapeCore::tape_node_points_sort),
+		    TAPE_CALL_MAPPING("rgl_node_points_estimate_normals", TapeCore::tape_node_points_estimate_normals),
+		    TAPE_CALL_MAPPING("rgl_node_points_cluster_euclidean", TapeCore::tape_node_points_cluster_euclidean),
+		    TAPE_CALL_MAPPING("rgl_node_points_cluster_boxes", TapeCore::tape_node_points_cluster_boxes),
+		    TAPE_CALL_MAPPING("rgl_node_points_spatial_index", TapeCore::tape_node_points_spatial_index),
+		    TAPE_CALL_MAPPING("rgl_node_points_spatial_index_query_nearest",
+		                      TapeCore::tape_node_points_spatial_index_query_nearest),
+		    TAPE_CALL_MAPPING("rgl_node_points_spatial_index_query_radius",
+		                      TapeCore::tape_node_points_spatial_index_query_radius),
 		    TAPE_CALL_MAPPING("rgl_node_points_radar_postprocess", TapeCore::tape_node_points_radar_postprocess),
+		    TAPE_CALL_MAPPING("rgl_node_points_radar_range_doppler", TapeCore::tape_node_points_radar_range_doppler),
 		    TAPE_CALL_MAPPING("rgl_node_gaussian_noise_angular_ray", TapeCore::tape_node_gaussian_noise_angular_ray),
 		    TAPE_CALL_MAPPING("rgl_node_gaussian_noise_angular_hitpoint", TapeCore::tape_node_gaussian_noise_angular_hitpoint),
 		    TAPE_CALL_MAPPING("rgl_node_gaussian_noise_distance", TapeCore::tape_node_gaussian_noise_distance),
+		    TAPE_CALL_MAPPING("rgl_node_gaussian_noise_transform_points", TapeCore::tape_node_gaussian_noise_transform_points),
 		};
 		TapePlayer::extendTapeFunctions(tapeFunctions);
 		return true;
@@ -21,6 +21,7 @@
 #include <tape/tapeDefinitions.hpp>
 #include <RGLExceptions.hpp>
 #include <tape/TapeCall.hpp>
+#include <macros/checkRGL.hpp>
 
 namespace fs = std::filesystem;
 
@@ -28,12 +29,17 @@ TapePlayer::TapePlayer(const char* path) : path(path)
 {
 	playbackState = std::make_unique<PlaybackState>(getBinPath().c_str());
 
-	yamlRoot = YAML::LoadFile(getYamlPath());
-	if (yamlRoot.IsNull()) {
-		throw RecordError("Invalid Tape: Empty YAML file detected");
+	if (fs::exists(getTapePath())) {
+		binaryTape = std::make_unique<BinaryTapeReader>(getTapePath());
 	}
-	if (yamlRoot.IsMap()) {
-		throw RecordError("Unsupported Tape format: Detected outdated format");
+	else {
+		yamlRoot = YAML::LoadFile(getYamlPath());
+		if (yamlRoot.IsNull()) {
+			throw RecordError("Invalid Tape: Empty YAML file detected");
+		}
+		if (yamlRoot.IsMap()) {
+			throw RecordError("Unsupported Tape format: Detected outdated format");
+		}
 	}
 
 	checkTapeVersion();
@@ -45,6 +51,23 @@ std::string TapePlayer::getBinPath() const { return fs::path(path).concat(BIN_EX
 
 std::string TapePlayer::getYamlPath() const { return fs::path(path).concat(YAML_EXTENSION).string(); }
 
+std::string TapePlayer::getTapePath() const { return fs::path(path).concat(TAPE_EXTENSION).string(); }
+
+TapeCall TapePlayer::getTapeCall(APICallIdx idx) const
+{
+	return binaryTape != nullptr ? binaryTape->getCall(idx) : TapeCall(yamlRoot[idx]);
+}
+
+TapePlayer::APICallIdx TapePlayer::getTapeCallCount() const
+{
+	return static_cast<APICallIdx>(binaryTape != nullptr ? binaryTape->getCallCount() : yamlRoot.size());
+}
+
+std::string TapePlayer::getFnName(APICallIdx idx) const
+{
+	return binaryTape != nullptr ? binaryTape->getFnName(idx) : yamlRoot[idx].begin()->first.as<std::string>();
+}
+
 void TapePlayer::checkTapeVersion()
 {
 	auto versionCallIdx = findFirst({RGL_VERSION});
@@ -64,8 +87,8 @@ void TapePlayer::checkTapeVersion()
 
 std::optional<TapePlayer::APICallIdx> TapePlayer::findFirst(std::set<std::string_view> fnNames)
 {
-	for (APICallIdx idx = 0; idx < yamlRoot.size(); ++idx) {
-		if (fnNames.contains(yamlRoot[idx].begin()->first.as<std::string>())) {
+	for (APICallIdx idx = 0; idx < getTapeCallCount(); ++idx) {
+		if (fnNames.contains(getFnName(idx))) {
 			return idx;
 		}
 	}
@@ -74,9 +97,9 @@ std::optional<TapePlayer::APICallIdx> TapePlayer::findFirst(std::set<std::string
 
 std::optional<TapePlayer::APICallIdx> TapePlayer::findLast(std::set<std::string_view> fnNames)
 {
-	for (APICallIdx idx = 0; idx < yamlRoot.size(); ++idx) {
-		auto rIdx = yamlRoot.size() - 1 - idx;
-		if (fnNames.contains(yamlRoot[idx].begin()->first.as<std::string>())) {
+	for (APICallIdx idx = 0; idx < getTapeCallCount(); ++idx) {
+		auto rIdx = getTapeCallCount() - 1 - idx;
+		if (fnNames.contains(getFnName(idx))) {
 			return rIdx;
 		}
 	}
@@ -86,8 +109,8 @@ std::optional<TapePlayer::APICallIdx> TapePlayer::findLast(std::set<std::string_
 std::vector<TapePlayer::APICallIdx> TapePlayer::findAll(std::set<std::string_view> fnNames)
 {
 	std::vector<APICallIdx> result;
-	for (APICallIdx idx = 0; idx < yamlRoot.size(); ++idx) {
-		if (fnNames.contains((yamlRoot[idx].begin()->first.as<std::string>()))) {
+	for (APICallIdx idx = 0; idx < getTapeCallCount(); ++idx) {
+		if (fnNames.contains(getFnName(idx))) {
 			result.push_back(idx);
 		}
 	}
@@ -96,7 +119,7 @@ std::vector<TapePlayer::APICallIdx> TapePlayer::findAll(std::set<std::string_vie
 
 void TapePlayer::playThrough(APICallIdx last)
 {
-	assert(last < yamlRoot.size());
+	assert(last < getTapeCallCount());
 	for (; nextCallIdx <= last; ++nextCallIdx) {
 		playThis(nextCallIdx);
 	}
@@ -105,8 +128,8 @@ void TapePlayer::playThrough(APICallIdx last)
 void TapePlayer::playUntil(std::optional<APICallIdx> breakpoint)
 {
 	assert(!breakpoint.has_value() || nextCallIdx < breakpoint.value());
-	auto end = breakpoint.value_or(yamlRoot.size());
-	assert(end <= yamlRoot.size());
+	auto end = breakpoint.value_or(getTapeCallCount());
+	assert(end <= getTapeCallCount());
 	for (; nextCallIdx < end; ++nextCallIdx) {
 		playThis(nextCallIdx);
 	}
@@ -114,37 +137,126 @@ void TapePlayer::playUntil(std::optional<APICallIdx> breakpoint)
 
 void TapePlayer::playThis(APICallIdx idx)
 {
-	const TapeCall& call = getTapeCall(idx);
-	if (!tapeFunctions.contains(call.getFnName())) {
+	if (isIsolated && isGlobalCall(getFnName(idx))) {
+		return;
+	}
+	playCall(getTapeCall(idx), *playbackState);
+}
+
+void TapePlayer::playCall(const TapeCall& call, PlaybackState& state)
+{
+	auto it = tapeFunctions.find(call.getFnName());
+	if (it == tapeFunctions.end()) {
 		throw RecordError(fmt::format("unknown function to play: {}", call.getFnName()));
 	}
-	tapeFunctions[call.getFnName()](call.getArgsNode(), *playbackState);
+	it->second(call.getArgsNode(), state);
 }
 
+bool TapePlayer::isGlobalCall(std::string_view fnName)
+{
+	return fnName == "rgl_cleanup" || fnName.starts_with("rgl_tape_") || fnName.starts_with("rgl_configure_") ||
+	       fnName.starts_with("rgl_replication_") || fnName.starts_with("rgl_trace_");
+}
+
+void TapePlayer::isolate()
+{
+	isIsolated = true;
+	if (playbackState->defaultScene == nullptr) {
+		CHECK_RGL(rgl_scene_create(&playbackState->defaultScene));
+	}
+}
 
-void TapePlayer::playApproximatelyRealtime()
+void TapePlayer::playApproximatelyRealtime(std::optional<APICallIdx> breakpoint)
 {
 	// Approximation comes from the fact that we don't account for the time it takes to execute the function
 	// This could be fixed by moving TAPE_HOOK to the beginning of the API call
 	// It might be a good idea to do so, because it would record failed calls.
+	// Playback may start in the middle of the tape, e.g. after seek().
 	auto beginTimestamp = std::chrono::steady_clock::now();
-	for (; nextCallIdx < yamlRoot.size(); ++nextCallIdx) {
+	auto beginCallNs = std::chrono::nanoseconds(0);
+	if (nextCallIdx < getTapeCallCount()) {
+		beginCallNs = std::chrono::nanoseconds(getTapeCall(nextCallIdx).getTimestamp().asNanoseconds());
+	}
+	auto end = breakpoint.value_or(getTapeCallCount());
+	assert(end <= getTapeCallCount());
+	for (; nextCallIdx < end; ++nextCallIdx) {
 		TapeCall nextCall = getTapeCall(nextCallIdx);
-		auto nextCallNs = std::chrono::nanoseconds(nextCall.getTimestamp().asNanoseconds());
+		auto nextCallNs = std::chrono::nanoseconds(nextCall.getTimestamp().asNanoseconds()) - beginCallNs;
 		auto elapsed = std::chrono::steady_clock::now() - beginTimestamp;
 		std::this_thread::sleep_for(nextCallNs - elapsed);
 		playThis(nextCallIdx);
 	}
 }
 
+// Calls overwriting state of the object given as their first argument, so that only the last one of a sequence matters.
+static bool isStateSettingCall(std::string_view fnName)
+{
+	static const std::set<std::string_view> stateSettingFnNames = {
+	    "rgl_entity_set_pose",         "rgl_entity_set_id",  "rgl_mesh_update_vertices",
+	    "rgl_mesh_set_texture_coords", "rgl_scene_set_time", "rgl_graph_node_set_priority",
+	    "rgl_mesh_set_keyframe",
+	};
+	// Node functions create or update the node.
+	return stateSettingFnNames.contains(fnName) || (fnName.starts_with("rgl_node_") && fnName != "rgl_node_is_alive");
+}
+
+static bool isSkippedOnSeek(std::string_view fnName)
+{
+	return fnName == "rgl_graph_run" || fnName.starts_with("rgl_graph_get_result_") || fnName == "rgl_graph_get_node_stats";
+}
+
+void TapePlayer::seek(APICallIdx target)
+{
+	assert(nextCallIdx <= target && target <= getTapeCallCount());
+	using StateKey = std::pair<std::string, TapeAPIObjectID>;
+	// Each sequence of state-setting calls is played at the position of its first call, with arguments of the last one.
+	std::vector<std::optional<APICallIdx>> callsToPlay(target - nextCallIdx);
+	std::map<StateKey, APICallIdx> sequenceBegins;
+	for (APICallIdx idx = nextCallIdx; idx < target; ++idx) {
+		std::string fnName = getFnName(idx);
+		if (isSkippedOnSeek(fnName)) {
+			continue;
+		}
+		if (!isStateSettingCall(fnName)) {
+			callsToPlay[idx - nextCallIdx] = idx;
+			// Sequences end when their object is destroyed, because its ID may be reused by a new object.
+			if (fnName == "rgl_cleanup") {
+				sequenceBegins.clear();
+			}
+			if (fnName == "rgl_graph_destroy") {
+				std::erase_if(sequenceBegins, [](auto&& entry) { return isStateSettingCall(entry.first.first); });
+			}
+			if (fnName == "rgl_entity_destroy" || fnName == "rgl_mesh_destroy") {
+				auto objectId = getTapeCall(idx).getArgsNode()[0].as<TapeAPIObjectID>();
+				std::erase_if(sequenceBegins, [&](auto&& entry) { return entry.first.second == objectId; });
+			}
+			continue;
+		}
+		auto objectId = getTapeCall(idx).getArgsNode()[0].as<TapeAPIObjectID>();
+		auto [sequenceBegin, isNewSequence] = sequenceBegins.try_emplace(StateKey{fnName, objectId}, idx);
+		callsToPlay[sequenceBegin->second - nextCallIdx] = idx;
+	}
+	for (auto&& callIdx : callsToPlay) {
+		if (callIdx.has_value()) {
+			playThis(callIdx.value());
+		}
+	}
+	nextCallIdx = target;
+}
+
 void TapePlayer::reset()
 {
-	auto status = rgl_cleanup();
-	if (status != RGL_SUCCESS) {
+	if (isIsolated) {
+		playbackState->destroyObjects();
+	}
+	else if (auto status = rgl_cleanup(); status != RGL_SUCCESS) {
 		const char* error = nullptr;
 		rgl_get_last_error_string(&error);
 		throw RecordError(fmt::format("Failed to reset playback state: {}", error));
 	}
 	nextCallIdx = 0;
 	playbackState = std::make_unique<PlaybackState>(getBinPath().c_str());
+	if (isIsolated) {
+		CHECK_RGL(rgl_scene_create(&playbackState->defaultScene));
+	}
 }
@@ -15,8 +15,10 @@
 #pragma once
 
 #include <optional>
+#include <string_view>
 
 #include <rgl/api/core.h>
+#include <tape/BinaryTape.hpp>
 #include <tape/PlaybackState.hpp>
 #include <tape/TapeCall.hpp>
 
@@ -35,7 +37,11 @@ struct TapePlayer
 	explicit TapePlayer(const char* path);
 	static void extendTapeFunctions(std::map<std::string, TapeFunction> map) { tapeFunctions.insert(map.begin(), map.end()); }
 
-	TapeCall getTapeCall(APICallIdx idx) const { return TapeCall(yamlRoot[idx]); }
+	/**
+	 * Binary tapes (see BinaryTape.hpp) are preferred; YAML tapes are played if there is no binary one.
+	 */
+	TapeCall getTapeCall(APICallIdx idx) const;
+	APICallIdx getTapeCallCount() const;
 
 	void checkTapeVersion();
 
@@ -44,20 +50,51 @@ struct TapePlayer
 	std::vector<APICallIdx> findAll(std::set<std::string_view> fnNames);
 
 	void playThis(APICallIdx idx);
+
+	/**
+	 * Plays the call (which may come from outside of any tape) with the given state.
+	 */
+	static void playCall(const TapeCall& call, PlaybackState& state);
+
+	/**
+	 * Calls affecting the whole library rather than objects of the tape, e.g. rgl_cleanup or rgl_configure_*.
+	 */
+	static bool isGlobalCall(std::string_view fnName);
+
+	/**
+	 * Makes the playback independent of other playbacks in the process, so that several tapes may be played concurrently:
+	 * NULL (default scene) arguments are played in a scene of the player, global calls (see isGlobalCall) are skipped,
+	 * and reset() destroys objects of the tape only, instead of calling rgl_cleanup.
+	 */
+	void isolate();
+
 	void playThrough(APICallIdx last);
 	void playUntil(std::optional<APICallIdx> breakpoint = std::nullopt);
-	void playApproximatelyRealtime();
+	void playApproximatelyRealtime(std::optional<APICallIdx> breakpoint = std::nullopt);
 	void reset();
 
+	/**
+	 * Moves playback forward to the given call (i.e. it will be played next) faster than playing all calls before it.
+	 * Each sequence of calls setting the same state (e.g. pose of an entity, parameters of a node) is played once,
+	 * with arguments of its last call; graph runs and reading their results are skipped.
+	 * Therefore, state depending on the history of runs (e.g. velocities, temporally merged points) is not reproduced.
+	 */
+	void seek(APICallIdx target);
+
 	rgl_node_t getNodeHandle(TapeAPIObjectID key) { return playbackState->nodes.at(key); }
 
 private:
+	std::string getFnName(APICallIdx idx) const;
+
+	std::unique_ptr<BinaryTapeReader> binaryTape;
 	YAML::Node yamlRoot{};
 	APICallIdx nextCallIdx{};
 	std::unique_ptr<PlaybackState> playbackState;
 	std::string path;
+	bool isIsolated{false};
 
 	static inline std::map<std::string, TapeFunction> tapeFunctions = {};
 	std::string getBinPath() const;
 	std::string getYamlPath() const;
+	std::string getTapePath() const;
 };
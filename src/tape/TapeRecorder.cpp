@@ -14,17 +14,97 @@
 
 #include <filesystem>
 
+#ifndef _WIN32
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // _WIN32
+
 #include <tape/TapeRecorder.hpp>
 #include <tape/tapeDefinitions.hpp>
+#include <PerformanceCounters.hpp>
+#include <ThreadConfig.hpp>
 #include <rgl/api/core.h>
 
 namespace fs = std::filesystem;
 
 std::optional<TapeRecorder> tapeRecorder;
+std::optional<TapeRecorder> replicationRecorder;
+
+#ifndef _WIN32
+static int connectToServer(const std::string& address)
+{
+	auto error = [&](std::string_view reason) {
+		return RecordError(fmt::format("rgl_replication_begin: could not connect to '{}': {}", address, reason));
+	};
+	std::size_t colon = address.rfind(':');
+	if (address.starts_with('/') || colon == std::string::npos) {
+		sockaddr_un unixAddress{.sun_family = AF_UNIX};
+		if (address.size() >= sizeof(unixAddress.sun_path)) {
+			throw error("socket path is too long");
+		}
+		std::strncpy(unixAddress.sun_path, address.c_str(), sizeof(unixAddress.sun_path) - 1);
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) != 0) {
+			std::string reason = std::strerror(errno);
+			if (fd >= 0) {
+				close(fd);
+			}
+			throw error(reason);
+		}
+		return fd;
+	}
+	addrinfo hints{.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+	addrinfo* addresses = nullptr;
+	std::string host = address.substr(0, colon), port = address.substr(colon + 1);
+	if (int status = getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses); status != 0) {
+		throw error(gai_strerror(status));
+	}
+	int fd = -1;
+	for (addrinfo* it = addresses; it != nullptr && fd < 0; it = it->ai_next) {
+		fd = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+		if (fd >= 0 && connect(fd, it->ai_addr, it->ai_addrlen) != 0) {
+			close(fd);
+			fd = -1;
+		}
+	}
+	freeaddrinfo(addresses);
+	if (fd < 0) {
+		throw error(std::strerror(errno));
+	}
+	return fd;
+}
+
+static void sendExactly(int fd, const void* data, std::size_t size)
+{
+	const auto* bytes = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t count = send(fd, bytes, size, MSG_NOSIGNAL);
+		if (count <= 0) {
+			throw RecordError(fmt::format("rgl_replication: connection lost: {}", std::strerror(errno)));
+		}
+		bytes += count;
+		size -= count;
+	}
+}
 
-TapeRecorder::TapeRecorder(const fs::path& path)
+static void receiveExactly(int fd, void* data, std::size_t size)
+{
+	auto* bytes = static_cast<char*>(data);
+	while (size > 0) {
+		ssize_t count = recv(fd, bytes, size, 0);
+		if (count <= 0) {
+			throw RecordError("rgl_replication: connection closed by the server");
+		}
+		bytes += count;
+		size -= count;
+	}
+}
+#endif // _WIN32
+
+TapeRecorder::TapeRecorder(const fs::path& path) : tapeWriter(std::in_place, fs::path(path).concat(TAPE_EXTENSION))
 {
-	std::string pathYaml = fs::path(path).concat(YAML_EXTENSION).string();
 	std::string pathBin = fs::path(path).concat(BIN_EXTENSION).string();
 
 	fileBin = fopen(pathBin.c_str(), "wb");
@@ -33,35 +113,177 @@ TapeRecorder::TapeRecorder(const fs::path& path)
 		                                  "due to the error: {}",
 		                                  pathBin, std::strerror(errno)));
 	}
-	fileYaml.open(pathYaml);
-	if (fileYaml.fail()) {
-		throw InvalidFilePath(fmt::format("rgl_tape_record_begin: could not open yaml file '{}' "
-		                                  "due to the error: {}",
-		                                  pathYaml, std::strerror(errno)));
+
+	beginTimestamp = std::chrono::steady_clock::now();
+	writer = std::thread(&TapeRecorder::writerMain, this);
+	try {
+		recordRGLVersion();
+	}
+	catch (...) {
+		finish();
+		throw;
 	}
+}
 
-	yamlEmitter << YAML::BeginSeq;
+TapeRecorder::TapeRecorder(const std::string& serverAddress)
+{
+#ifdef _WIN32
+	throw RecordError("rgl_replication_begin() is not supported on Windows");
+#else
+	socketFd = connectToServer(serverAddress);
 	beginTimestamp = std::chrono::steady_clock::now();
-	TapeRecorder::recordRGLVersion();
+	writer = std::thread(&TapeRecorder::writerMain, this);
+	try {
+		recordRGLVersion();
+	}
+	catch (...) {
+		finish();
+		close(socketFd);
+		throw;
+	}
+#endif // _WIN32
 }
 
 TapeRecorder::~TapeRecorder()
 {
 	// TODO(prybicki): SIOF with Logger !!!
-	yamlEmitter << YAML::EndSeq;
-	fileYaml << yamlEmitter.c_str();
-	fileYaml.close();
-	if (fileYaml.fail()) {
-		RGL_WARN("rgl_tape_record_end: failed to close yaml file due to the error: {}", std::strerror(errno));
+	if (std::exception_ptr error = finish(); error != nullptr) {
+		try {
+			std::rethrow_exception(error);
+		}
+		catch (std::exception& e) {
+			RGL_WARN("rgl_tape_record_end: tape has not been fully written due to the error: {}", e.what());
+		}
+	}
+	if (isStreaming()) {
+#ifndef _WIN32
+		close(socketFd);
+#endif // _WIN32
+		return;
 	}
+	RGL_DEBUG("rgl_tape_record_end: {} repeated arrays ({} bytes) were not written again", deduplicatedBlobCount,
+	          deduplicatedBytes);
 	if (fclose(fileBin)) {
 		RGL_WARN("rgl_tape_record_end: failed to close binary file due to the error: {}", std::strerror(errno));
 	}
 }
 
+std::exception_ptr TapeRecorder::finish()
+{
+	if (writer.joinable()) {
+		{
+			std::lock_guard lock{queueMutex};
+			isFinishRequested = true;
+		}
+		callQueued.notify_one();
+		writer.join();
+	}
+	std::lock_guard lock{queueMutex};
+	return writerError;
+}
+
 void TapeRecorder::recordRGLVersion()
 {
 	int32_t major, minor, patch;
 	rgl_get_version_info(&major, &minor, &patch);
-	tapeRecorder->recordApiCall("rgl_get_version_info", major, minor, patch);
+	recordApiCall("rgl_get_version_info", major, minor, patch);
+}
+
+void TapeRecorder::enqueueStagedCall()
+{
+	std::unique_lock lock{queueMutex};
+	if (writerError != nullptr) {
+		std::rethrow_exception(writerError);
+	}
+	std::size_t callSize = stagedCall.getSize();
+	// A call larger than the whole queue is accepted once the queue is empty.
+	auto canQueue = [&]() { return queuedBytes == 0 || queuedBytes + callSize <= QUEUE_CAPACITY_BYTES; };
+	if (!canQueue()) {
+		PerformanceCounters::ScopedTimer stallTimer{PerformanceCounters::instance().tapeStall};
+		callWritten.wait(lock, canQueue);
+	}
+	queuedBytes += callSize;
+	PerformanceCounters::instance().updateTapeQueueBytes(queuedBytes);
+	queuedCalls.push_back(std::move(stagedCall));
+	stagedCall = RecordedCall{};
+	if (!recycledCalls.empty()) {
+		stagedCall = std::move(recycledCalls.back());
+		recycledCalls.pop_back();
+	}
+	lock.unlock();
+	callQueued.notify_one();
+}
+
+void TapeRecorder::writerMain()
+{
+	ThreadConfig::ScopedThread registration{ThreadRole::Io, "rgl-tape-writer"};
+	while (true) {
+		RecordedCall call;
+		{
+			std::unique_lock lock{queueMutex};
+			callQueued.wait(lock, [this]() { return !queuedCalls.empty() || isFinishRequested; });
+			if (queuedCalls.empty()) {
+				return;
+			}
+			call = std::move(queuedCalls.front());
+			queuedCalls.pop_front();
+		}
+
+		// After an error, remaining calls are only drained; writerError is modified only by this thread.
+		std::exception_ptr error = nullptr;
+		if (writerError == nullptr) {
+			try {
+				if (isStreaming()) {
+					sendCall(call);
+				}
+				else {
+					FWRITE(call.binData.data(), sizeof(uint8_t), call.binData.size(), fileBin);
+					tapeWriter->writeCall(call.fnName, call.timestampNs, call.args);
+				}
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+		}
+
+		{
+			std::lock_guard lock{queueMutex};
+			queuedBytes -= call.getSize();
+			PerformanceCounters::instance().updateTapeQueueBytes(queuedBytes);
+			if (error != nullptr) {
+				writerError = error;
+			}
+			if (call.getSize() <= MAX_RECYCLED_CALL_BYTES && recycledCalls.size() < MAX_RECYCLED_CALL_COUNT) {
+				recycledCalls.push_back(std::move(call));
+			}
+		}
+		callWritten.notify_all();
+	}
+}
+
+void TapeRecorder::sendCall(const RecordedCall& call)
+{
+#ifndef _WIN32
+	BinaryTapeStreamCallHeader header{
+	    .magic = BINARY_TAPE_STREAM_MAGIC,
+	    .fnNameSize = static_cast<uint32_t>(call.fnName.size()),
+	    .argsSize = static_cast<uint32_t>(call.args.size()),
+	    .reserved = 0,
+	    .timestampNs = call.timestampNs,
+	    .binarySize = call.binData.size(),
+	};
+	sendExactly(socketFd, &header, sizeof(header));
+	sendExactly(socketFd, call.fnName.data(), call.fnName.size());
+	sendExactly(socketFd, call.args.data(), call.args.size());
+	sendExactly(socketFd, call.binData.data(), call.binData.size());
+
+	// Played calls may fail, e.g. if the server does not allow them; replication continues with the following calls.
+	BinaryTapeStreamStatus status{};
+	receiveExactly(socketFd, &status, sizeof(status));
+	std::string error(status.errorSize, '\0');
+	receiveExactly(socketFd, error.data(), error.size());
+	if (status.status != RGL_SUCCESS) {
+		RGL_WARN("rgl_replication: {} failed on the server (code={}): {}", call.fnName, status.status, error);
+	}
+#endif // _WIN32
 }
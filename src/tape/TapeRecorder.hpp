@@ -14,25 +14,47 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <string>
 #include <optional>
 #include <fstream>
-
-#include <yaml-cpp/yaml.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <rgl/api/core.h>
+#include <tape/BinaryTape.hpp>
+#include <ContentHash.hpp>
 #include <RGLExceptions.hpp>
 #include <Logger.hpp>
 
 #ifdef _WIN32
 #define TAPE_HOOK(...)
+#define TAPE_HOOK_AS(fnName, ...)
 #else
 #define TAPE_HOOK(...)                                                                                                         \
-	do                                                                                                                         \
-		if (tapeRecorder.has_value()) {                                                                                        \
+	do {                                                                                                                       \
+		if (tapeRecorder.has_value()) [[unlikely]] {                                                                           \
 			tapeRecorder->recordApiCall(__func__ __VA_OPT__(, ) __VA_ARGS__);                                                  \
 		}                                                                                                                      \
-	while (0)
+		if (replicationRecorder.has_value()) [[unlikely]] {                                                                    \
+			replicationRecorder->recordApiCall(__func__ __VA_OPT__(, ) __VA_ARGS__);                                           \
+		}                                                                                                                      \
+	} while (0)
+
+// Records call under the given name, e.g. to record a batched call as a sequence of equivalent single calls.
+#define TAPE_HOOK_AS(fnName, ...)                                                                                              \
+	do {                                                                                                                       \
+		if (tapeRecorder.has_value()) [[unlikely]] {                                                                           \
+			tapeRecorder->recordApiCall(fnName __VA_OPT__(, ) __VA_ARGS__);                                                    \
+		}                                                                                                                      \
+		if (replicationRecorder.has_value()) [[unlikely]] {                                                                    \
+			replicationRecorder->recordApiCall(fnName __VA_OPT__(, ) __VA_ARGS__);                                             \
+		}                                                                                                                      \
+	} while (0)
 #endif // _WIN32
 
 #define TAPE_ARRAY(data, count) std::make_pair(data, count)
@@ -44,108 +66,181 @@
 		}                                                                                                                      \
 	while (0)
 
+/**
+ * Records API calls to the tape. Arguments are encoded (and arrays copied) into a queue of recorded calls
+ * in the client's thread, while the files are written in a dedicated writer thread.
+ * When the queue exceeds QUEUE_CAPACITY_BYTES, API calls wait for the writer (see tape_stall_* performance counters).
+ */
 struct TapeRecorder
 {
 	explicit TapeRecorder(const std::filesystem::path& path);
+
+	/**
+	 * Streams calls to the server at the given address ("<host>:<port>" or a path of a Unix domain socket), which plays
+	 * them (see rglServer), instead of writing files; arrays are sent with each call, without deduplication.
+	 * Errors reported by the server for played calls are logged as warnings.
+	 */
+	explicit TapeRecorder(const std::string& serverAddress);
 	~TapeRecorder();
 
 	/**
-	 * Emits lines like: "rgl_get_version_info: {t: 61323, a: [0, 16, 2]}"
+	 * Records the call with its arguments converted by valueToTape().
+	 * fnName must have static storage duration (e.g. __func__), because it is written asynchronously.
 	 */
 	template<typename... Args>
-	void recordApiCall(std::string fnName, Args&&... args)
+	void recordApiCall(std::string_view fnName, Args&&... args)
 	{
 		auto timestamp =
 		    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - beginTimestamp).count();
-		// clang-format off
-		yamlEmitter << YAML::BeginMap << YAML::Key << fnName << YAML::Flow
-		                << YAML::BeginMap
-		                    << YAML::Key << "t" << YAML::Value << timestamp
-		                    << YAML::Key << "a" << YAML::Value << YAML::BeginSeq << emitArgs(args...) << YAML::EndSeq
-		                << YAML::EndMap
-		            << YAML::EndMap;
-		// clang-format on
+		std::lock_guard lock{stagingMutex};
+		if (isStreaming()) {
+			currentBinOffset = 0; // Arrays are sent with each call, see writeToBin()
+		}
+		stagedCall.args.clear();
+		stagedCall.binData.clear();
+		stagedCall.fnName = fnName;
+		stagedCall.timestampNs = timestamp;
+		(stagedCall.args.writeArg(valueToTape(args)), ...);
+		enqueueStagedCall();
 	}
 
-	static void recordRGLVersion();
-
-private: // Methods
 	/**
-	 * Appends all arguments to the yaml file via template recursion.
-	 * Returns nil-potent YAML::EMITTER_MANIP to allow chaining << operator.
+	 * Waits until all recorded calls are written and stops the writer thread.
+	 * Returns the error which stopped writing the tape, if any.
 	 */
-	template<typename T, typename... Args>
-	YAML::EMITTER_MANIP emitArgs(T&& head, Args&&... tail)
-	{
-		yamlEmitter << valueToYaml(head);
-		return emitArgs(tail...);
-	}
-	YAML::EMITTER_MANIP emitArgs() { return YAML::Auto; }
-
-	uintptr_t valueToYaml(void* value) { return (uintptr_t) value; }
-	uintptr_t valueToYaml(rgl_mesh_t value) { return (uintptr_t) value; }
-	uintptr_t valueToYaml(rgl_node_t value) { return (uintptr_t) value; }
-	uintptr_t valueToYaml(rgl_scene_t value) { return (uintptr_t) value; }
-	uintptr_t valueToYaml(rgl_node_t* value) { return (uintptr_t) *value; }
-	uintptr_t valueToYaml(rgl_entity_t value) { return (uintptr_t) value; }
-	uintptr_t valueToYaml(rgl_mesh_t* value) { return (uintptr_t) *value; }
-	uintptr_t valueToYaml(rgl_texture_t value) { return (uintptr_t) value; }
-	uintptr_t valueToYaml(rgl_scene_t* value) { return (uintptr_t) *value; }
-	uintptr_t valueToYaml(rgl_entity_t* value) { return (uintptr_t) *value; }
-	uintptr_t valueToYaml(rgl_texture_t* value) { return (uintptr_t) *value; }
-	size_t valueToYaml(const rgl_vec3f* value) { return writeToBin(value, 1); }
-	size_t valueToYaml(const rgl_mat3x4f* value) { return writeToBin(value, 1); }
+	std::exception_ptr finish();
+
+	void recordRGLVersion();
+
+private: // Methods
+	uintptr_t valueToTape(void* value) { return (uintptr_t) value; }
+	uintptr_t valueToTape(rgl_mesh_t value) { return (uintptr_t) value; }
+	uintptr_t valueToTape(rgl_node_t value) { return (uintptr_t) value; }
+	uintptr_t valueToTape(rgl_scene_t value) { return (uintptr_t) value; }
+	uintptr_t valueToTape(rgl_node_t* value) { return (uintptr_t) *value; }
+	uintptr_t valueToTape(rgl_entity_t value) { return (uintptr_t) value; }
+	uintptr_t valueToTape(rgl_mesh_t* value) { return (uintptr_t) *value; }
+	uintptr_t valueToTape(rgl_texture_t value) { return (uintptr_t) value; }
+	uintptr_t valueToTape(rgl_scene_t* value) { return (uintptr_t) *value; }
+	uintptr_t valueToTape(rgl_entity_t* value) { return (uintptr_t) *value; }
+	uintptr_t valueToTape(rgl_texture_t* value) { return (uintptr_t) *value; }
+	size_t valueToTape(const rgl_vec3f* value) { return writeToBin(value, 1); }
+	size_t valueToTape(const rgl_mat3x4f* value) { return writeToBin(value, 1); }
 
 	template<typename T>
-	std::enable_if_t<!std::is_enum_v<T>, T> valueToYaml(T value)
+	std::enable_if_t<!std::is_enum_v<T>, T> valueToTape(T value)
 	{
 		return value;
 	}
 
 	template<typename T, typename N>
-	size_t valueToYaml(std::pair<T, N> value)
+	size_t valueToTape(std::pair<T, N> value)
 	{
 		return writeToBin(value.first, value.second);
 	}
 
 	template<typename N>
-	size_t valueToYaml(std::pair<const void*, N> value)
+	size_t valueToTape(std::pair<const void*, N> value)
 	{
 		return writeToBin(static_cast<const char*>(value.first), value.second);
 	}
 
 	template<typename T>
-	std::enable_if_t<std::is_enum_v<T>, std::string> valueToYaml(T value)
+	std::enable_if_t<std::is_enum_v<T>, std::string> valueToTape(T value)
 	{
 		return std::to_string(static_cast<std::underlying_type_t<T>>(value));
 	}
 
-	int valueToYaml(int32_t* value) { return *value; }
+	int valueToTape(int32_t* value) { return *value; }
+	uint64_t valueToTape(uint64_t* value) { return *value; }
 
+	/**
+	 * Stages the array to be appended to the binary file, returns its offset in the file.
+	 * Arrays are padded to 16 bytes, which keeps their offsets aligned for playback.
+	 * Repeated arrays (e.g. meshes reloaded by level streaming) are stored once and their offset is shared by calls.
+	 */
 	template<typename T>
 	size_t writeToBin(const T* source, size_t elemCount)
 	{
-		size_t elemSize = sizeof(T);
-		uint8_t remainder = (elemSize * elemCount) % 16;
-		uint8_t bytesToAdd = (16 - remainder) % 16;
-
-		FWRITE(source, elemSize, elemCount, fileBin);
-		if (remainder != 0) {
-			uint8_t zeros[16];
-			FWRITE(zeros, sizeof(uint8_t), bytesToAdd, fileBin);
+		size_t size = sizeof(T) * elemCount;
+		uint64_t hash = 0;
+		bool isDeduplicated = size >= MIN_DEDUPLICATED_BLOB_BYTES && !isStreaming();
+		if (isDeduplicated) {
+			hash = hashContent(source, elemCount);
+			if (auto it = binBlobs.find(hash); it != binBlobs.end() && it->second.size == size) {
+				deduplicatedBlobCount += 1;
+				deduplicatedBytes += size;
+				return it->second.offset;
+			}
 		}
 
+		size_t paddedSize = (size + 15) / 16 * 16;
+		auto sourceBytes = reinterpret_cast<const uint8_t*>(source);
+		stagedCall.binData.insert(stagedCall.binData.end(), sourceBytes, sourceBytes + size);
+		stagedCall.binData.resize(stagedCall.binData.size() + paddedSize - size, 0);
+
 		size_t outBinOffset = currentBinOffset;
-		currentBinOffset += elemSize * elemCount + bytesToAdd;
+		currentBinOffset += paddedSize;
+		if (isDeduplicated) {
+			binBlobs.try_emplace(hash, BinBlob{.offset = outBinOffset, .size = size});
+		}
 		return outBinOffset;
 	}
 
+	void enqueueStagedCall();
+	void writerMain();
+	bool isStreaming() const { return socketFd >= 0; }
+	struct RecordedCall;
+	void sendCall(const RecordedCall& call);
+
 private: // Fields
-	std::ofstream fileYaml;
-	YAML::Emitter yamlEmitter;
-	FILE* fileBin;
-	size_t currentBinOffset = 0;
+	struct RecordedCall
+	{
+		std::string_view fnName;
+		int64_t timestampNs{0};
+		BinaryTapeArgs args;
+		std::vector<uint8_t> binData; // Arrays to be appended to the binary file
+
+		std::size_t getSize() const { return args.size() + binData.size(); }
+	};
+
+	struct BinBlob
+	{
+		size_t offset;
+		size_t size;
+	};
+
+	// Hashing small arrays (e.g. poses) costs more than writing them again.
+	static constexpr std::size_t MIN_DEDUPLICATED_BLOB_BYTES = 256;
+	static constexpr std::size_t QUEUE_CAPACITY_BYTES = 256 * 1024 * 1024;
+	// Buffers of written calls are reused to avoid allocations in steady state, unless they grew large (e.g. meshes).
+	static constexpr std::size_t MAX_RECYCLED_CALL_COUNT = 64;
+	static constexpr std::size_t MAX_RECYCLED_CALL_BYTES = 1024 * 1024;
+
+	// Either files are written (tapeWriter and fileBin) or calls are streamed to the socket.
+	std::optional<BinaryTapeWriter> tapeWriter;
+	FILE* fileBin{nullptr};
+	int socketFd{-1};
 	std::chrono::time_point<std::chrono::steady_clock> beginTimestamp;
+
+	// Serializes client threads recording calls, keeps offsets in the binary file in order of queued calls.
+	std::mutex stagingMutex;
+	RecordedCall stagedCall;
+	size_t currentBinOffset = 0;
+	std::unordered_map<uint64_t, BinBlob> binBlobs; // Arrays already staged, by hashContent() of their data
+	size_t deduplicatedBlobCount = 0;
+	size_t deduplicatedBytes = 0;
+
+	std::mutex queueMutex;
+	std::condition_variable callQueued;
+	std::condition_variable callWritten;
+	std::deque<RecordedCall> queuedCalls;
+	std::vector<RecordedCall> recycledCalls;
+	std::size_t queuedBytes{0};
+	std::exception_ptr writerError;
+	bool isFinishRequested{false};
+	std::thread writer;
 };
 
 extern std::optional<TapeRecorder> tapeRecorder;
+extern std::optional<TapeRecorder> replicationRecorder; // See rgl_replication_begin
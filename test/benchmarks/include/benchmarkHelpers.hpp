@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <helpers/geometryData.hpp>
+#include <math/Mat3x4f.hpp>
+#include <rgl/api/core.h>
+
+// Benchmarks do not recover from errors; reporting a partial measurement would be misleading.
+#define CHECK_RGL(call)                                                                                                        \
+	do {                                                                                                                       \
+		if (rgl_status_t status = (call); status != RGL_SUCCESS) {                                                             \
+			const char* errorString = nullptr;                                                                                 \
+			rgl_get_last_error_string(&errorString);                                                                           \
+			throw std::runtime_error(std::string(#call) + " failed: " + errorString);                                          \
+		}                                                                                                                      \
+	} while (0)
+
+static constexpr float ENTITY_SPACING = 4.0f * CUBE_HALF_EDGE;
+static constexpr float ENTITY_DISTANCE = 20.0f;
+
+inline rgl_mesh_t makeBenchmarkCubeMesh()
+{
+	rgl_mesh_t mesh = nullptr;
+	CHECK_RGL(rgl_mesh_create(&mesh, cubeVertices, std::size(cubeVertices), cubeIndices, std::size(cubeIndices)));
+	return mesh;
+}
+
+/**
+ * Pose of the entity placed on a square grid facing the lidar at the origin (along Z axis).
+ */
+inline Mat3x4f getGridPose(int32_t entityIdx, int32_t entityCount)
+{
+	int32_t side = static_cast<int32_t>(std::ceil(std::sqrt(static_cast<float>(entityCount))));
+	float offset = static_cast<float>(side - 1) * ENTITY_SPACING / 2.0f;
+	float x = static_cast<float>(entityIdx % side) * ENTITY_SPACING - offset;
+	float y = static_cast<float>(entityIdx / side) * ENTITY_SPACING - offset;
+	return Mat3x4f::translation(x, y, ENTITY_DISTANCE);
+}
+
+/**
+ * Spawns cubes on the default scene, sharing a single mesh, arranged with getGridPose().
+ */
+inline std::vector<rgl_entity_t> spawnCubeGrid(int32_t entityCount)
+{
+	rgl_mesh_t mesh = makeBenchmarkCubeMesh();
+	std::vector<rgl_entity_t> entities(entityCount, nullptr);
+	for (int32_t entityIdx = 0; entityIdx < entityCount; ++entityIdx) {
+		rgl_mat3x4f pose = getGridPose(entityIdx, entityCount).toRGL();
+		CHECK_RGL(rgl_entity_create(&entities[entityIdx], nullptr, mesh));
+		CHECK_RGL(rgl_entity_set_pose(entities[entityIdx], &pose));
+	}
+	return entities;
+}
+
+/**
+ * Rays evenly spread in a frustum of the given field of view (in degrees), centered on Z axis.
+ */
+inline std::vector<rgl_mat3x4f> makeFrustumRays(int32_t rayCount, float fovDeg = 90.0f)
+{
+	int32_t side = static_cast<int32_t>(std::ceil(std::sqrt(static_cast<float>(rayCount))));
+	float step = fovDeg / static_cast<float>(side);
+	std::vector<rgl_mat3x4f> rays;
+	rays.reserve(rayCount);
+	for (int32_t rayIdx = 0; rayIdx < rayCount; ++rayIdx) {
+		float azimuth = static_cast<float>(rayIdx % side) * step - fovDeg / 2.0f;
+		float elevation = static_cast<float>(rayIdx / side) * step - fovDeg / 2.0f;
+		rays.emplace_back(Mat3x4f::rotationDeg(elevation, azimuth, 0.0f).toRGL());
+	}
+	return rays;
+}
+
+inline rgl_node_t makeRaysNode(int32_t rayCount, float fovDeg = 90.0f)
+{
+	std::vector<rgl_mat3x4f> rays = makeFrustumRays(rayCount, fovDeg);
+	rgl_node_t raysNode = nullptr;
+	CHECK_RGL(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), static_cast<int32_t>(rays.size())));
+	return raysNode;
+}
+
+/**
+ * Runs the graph and waits for results of the given node, so that each iteration measures a complete frame.
+ */
+inline int32_t runAndWait(rgl_node_t graphNode, rgl_node_t resultNode, rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32)
+{
+	int32_t count = 0, sizeOf = 0;
+	CHECK_RGL(rgl_graph_run(graphNode));
+	CHECK_RGL(rgl_graph_get_result_size(resultNode, field, &count, &sizeOf));
+	return count;
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+#include <benchmarkHelpers.hpp>
+
+/**
+ * Many independent sensor graphs (rays, raytrace, compaction) on a shared scene, run concurrently in each frame:
+ * measures how the scheduler scales with the number of graphs.
+ * Reported latencies are of whole frames, i.e. until results of all graphs are available.
+ * CPU utilization is the process' CPU time (of graph threads and of the client's thread) per wall time, in cores.
+ */
+static void BM_ManyGraphs(benchmark::State& state)
+{
+	auto graphCount = static_cast<int32_t>(state.range(0));
+	auto rayCount = static_cast<int32_t>(state.range(1));
+	auto entityCount = static_cast<int32_t>(state.range(2));
+	spawnCubeGrid(entityCount);
+
+	std::vector<rgl_node_t> raytraceNodes(graphCount, nullptr), compactNodes(graphCount, nullptr);
+	for (int32_t graphIdx = 0; graphIdx < graphCount; ++graphIdx) {
+		rgl_node_t rays = makeRaysNode(rayCount);
+		CHECK_RGL(rgl_node_raytrace(&raytraceNodes[graphIdx], nullptr));
+		CHECK_RGL(rgl_node_points_compact_by_field(&compactNodes[graphIdx], RGL_FIELD_IS_HIT_I32));
+		CHECK_RGL(rgl_graph_node_add_child(rays, raytraceNodes[graphIdx]));
+		CHECK_RGL(rgl_graph_node_add_child(raytraceNodes[graphIdx], compactNodes[graphIdx]));
+		runAndWait(raytraceNodes[graphIdx], compactNodes[graphIdx]); // Warm-up
+	}
+
+	std::vector<double> frameTimesMs;
+	rgl_performance_counters_t countersBefore, countersAfter;
+	CHECK_RGL(rgl_get_performance_counters(&countersBefore));
+	std::clock_t cpuBegin = std::clock();
+	auto wallBegin = std::chrono::steady_clock::now();
+	for (auto _ : state) {
+		auto frameBegin = std::chrono::steady_clock::now();
+		for (auto&& raytrace : raytraceNodes) {
+			CHECK_RGL(rgl_graph_run(raytrace));
+		}
+		for (auto&& compact : compactNodes) {
+			int32_t count = 0, sizeOf = 0;
+			CHECK_RGL(rgl_graph_get_result_size(compact, RGL_FIELD_XYZ_VEC3_F32, &count, &sizeOf));
+			benchmark::DoNotOptimize(count);
+		}
+		frameTimesMs.emplace_back(
+		    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameBegin).count());
+	}
+	double wallTimeS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallBegin).count();
+	double cpuTimeS = static_cast<double>(std::clock() - cpuBegin) / CLOCKS_PER_SEC;
+	CHECK_RGL(rgl_get_performance_counters(&countersAfter));
+
+	auto getPercentile = [&frameTimesMs](double percentile) {
+		auto idx = static_cast<std::size_t>(percentile * static_cast<double>(frameTimesMs.size() - 1));
+		std::nth_element(frameTimesMs.begin(), frameTimesMs.begin() + idx, frameTimesMs.end());
+		return frameTimesMs[idx];
+	};
+	state.SetItemsProcessed(state.iterations() * graphCount * rayCount); // Aggregate rays per second
+	state.counters["graphs"] = graphCount;
+	state.counters["frame_p50_ms"] = getPercentile(0.5);
+	state.counters["frame_p99_ms"] = getPercentile(0.99);
+	state.counters["cpu_cores"] = wallTimeS > 0.0 ? cpuTimeS / wallTimeS : 0.0;
+	double synchronizeAllMs = countersAfter.synchronize_all_time_ms - countersBefore.synchronize_all_time_ms;
+	state.counters["sync_all_ms"] = benchmark::Counter(synchronizeAllMs, benchmark::Counter::kAvgIterations);
+	CHECK_RGL(rgl_cleanup());
+}
+
+BENCHMARK(BM_ManyGraphs)
+    ->ArgNames({"graphs", "rays", "entities"})
+    ->ArgsProduct({{1, 4, 16, 64}, {10'000, 100'000}, {100, 10'000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,88 @@
+#include <array>
+#include <numbers>
+
+#include <benchmarkHelpers.hpp>
+
+/**
+ * Typical lidar postprocessing: raytracing followed by removal of non-hits, formatting and prefetching results to host.
+ * About half of the rays miss the scene, so that compaction has work to do.
+ */
+static void BM_CompactFormatYield(benchmark::State& state)
+{
+	constexpr int32_t ENTITY_COUNT = 100;
+	auto rayCount = static_cast<int32_t>(state.range(0));
+	spawnCubeGrid(ENTITY_COUNT);
+
+	std::array<rgl_field_t, 3> fields = {RGL_FIELD_XYZ_VEC3_F32, RGL_FIELD_INTENSITY_F32, RGL_FIELD_DISTANCE_F32};
+	rgl_node_t rays = makeRaysNode(rayCount, 120.0f), raytrace = nullptr, compact = nullptr, format = nullptr, yield = nullptr;
+	CHECK_RGL(rgl_node_raytrace(&raytrace, nullptr));
+	CHECK_RGL(rgl_node_points_compact_by_field(&compact, RGL_FIELD_IS_HIT_I32));
+	CHECK_RGL(rgl_node_points_format(&format, fields.data(), fields.size()));
+	CHECK_RGL(rgl_node_points_yield(&yield, fields.data(), fields.size()));
+	CHECK_RGL(rgl_graph_node_add_child(rays, raytrace));
+	CHECK_RGL(rgl_graph_node_add_child(raytrace, compact));
+	CHECK_RGL(rgl_graph_node_add_child(compact, format));
+	CHECK_RGL(rgl_graph_node_add_child(compact, yield));
+	runAndWait(raytrace, format, RGL_FIELD_DYNAMIC_FORMAT);
+
+	for (auto _ : state) {
+		CHECK_RGL(rgl_graph_run(raytrace));
+		int32_t count = 0, sizeOf = 0;
+		CHECK_RGL(rgl_graph_get_result_size(format, RGL_FIELD_DYNAMIC_FORMAT, &count, &sizeOf));
+		CHECK_RGL(rgl_graph_get_result_size(yield, RGL_FIELD_XYZ_VEC3_F32, &count, &sizeOf));
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * rayCount);
+	CHECK_RGL(rgl_cleanup());
+}
+
+/**
+ * Radar postprocessing of dense clusters of hits: the scene is a tightly packed grid of cubes in front of the radar,
+ * so that most of the rays hit and clusters have to be merged.
+ */
+static void BM_RadarPostprocess(benchmark::State& state)
+{
+	constexpr float FOV_DEG = 60.0f;
+	auto rayCount = static_cast<int32_t>(state.range(0));
+	spawnCubeGrid(static_cast<int32_t>(state.range(1)));
+
+	rgl_radar_scope_t radarScope{
+	    .begin_distance = 0.0f,
+	    .end_distance = 2.0f * ENTITY_DISTANCE,
+	    .distance_separation_threshold = 0.3f,
+	    .radial_speed_separation_threshold = 0.3f,
+	    .azimuth_separation_threshold = 8.0f * (std::numbers::pi_v<float> / 180.0f),
+	};
+	float angleStepRad = FOV_DEG / std::sqrt(static_cast<float>(rayCount)) * (std::numbers::pi_v<float> / 180.0f);
+
+	rgl_node_t rays = makeRaysNode(rayCount, FOV_DEG), raytrace = nullptr, compact = nullptr, radar = nullptr;
+	CHECK_RGL(rgl_node_raytrace(&raytrace, nullptr));
+	CHECK_RGL(rgl_node_points_compact_by_field(&compact, RGL_FIELD_IS_HIT_I32));
+	CHECK_RGL(rgl_node_points_radar_postprocess(&radar, &radarScope, 1, angleStepRad, angleStepRad, 79E9f, 31.0f, 27.0f,
+	                                            60.0f, 1.0f));
+	CHECK_RGL(rgl_graph_node_add_child(rays, raytrace));
+	CHECK_RGL(rgl_graph_node_add_child(raytrace, compact));
+	CHECK_RGL(rgl_graph_node_add_child(compact, radar));
+	runAndWait(raytrace, radar);
+
+	int32_t detectionCount = 0;
+	for (auto _ : state) {
+		detectionCount = runAndWait(raytrace, radar);
+	}
+	state.SetItemsProcessed(state.iterations() * rayCount);
+	state.counters["detections"] = detectionCount;
+	CHECK_RGL(rgl_cleanup());
+}
+
+BENCHMARK(BM_CompactFormatYield)
+    ->ArgName("rays")
+    ->RangeMultiplier(10)
+    ->Range(10'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_RadarPostprocess)
+    ->ArgNames({"rays", "entities"})
+    ->ArgsProduct({{10'000, 100'000}, {100, 1'000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
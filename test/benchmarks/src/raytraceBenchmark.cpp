@@ -0,0 +1,30 @@
+#include <benchmarkHelpers.hpp>
+
+/**
+ * Raytracing of a static scene: measures a complete frame (launch and synchronization) in steady state.
+ */
+static void BM_Raytrace(benchmark::State& state)
+{
+	auto rayCount = static_cast<int32_t>(state.range(0));
+	auto entityCount = static_cast<int32_t>(state.range(1));
+	spawnCubeGrid(entityCount);
+
+	rgl_node_t rays = makeRaysNode(rayCount), raytrace = nullptr;
+	CHECK_RGL(rgl_node_raytrace(&raytrace, nullptr));
+	CHECK_RGL(rgl_graph_node_add_child(rays, raytrace));
+	runAndWait(raytrace, raytrace); // Warm-up: builds acceleration structures and allocates buffers
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(runAndWait(raytrace, raytrace));
+	}
+	state.SetItemsProcessed(state.iterations() * rayCount);
+	state.counters["rays"] = rayCount;
+	state.counters["entities"] = entityCount;
+	CHECK_RGL(rgl_cleanup());
+}
+
+BENCHMARK(BM_Raytrace)
+    ->ArgNames({"rays", "entities"})
+    ->ArgsProduct({{10'000, 100'000, 1'000'000, 4'000'000}, {1, 100, 10'000, 100'000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,47 @@
+#include <benchmarkHelpers.hpp>
+
+/**
+ * Frame in which N of the scene's entities have moved: measures acceleration structure update followed by raytracing.
+ */
+static void BM_MovingEntities(benchmark::State& state)
+{
+	constexpr int32_t RAY_COUNT = 100'000;
+	constexpr int32_t ENTITY_COUNT = 10'000;
+	auto movingCount = static_cast<int32_t>(state.range(0));
+	std::vector<rgl_entity_t> entities = spawnCubeGrid(ENTITY_COUNT);
+
+	rgl_node_t rays = makeRaysNode(RAY_COUNT), raytrace = nullptr;
+	CHECK_RGL(rgl_node_raytrace(&raytrace, nullptr));
+	CHECK_RGL(rgl_graph_node_add_child(rays, raytrace));
+	runAndWait(raytrace, raytrace);
+
+	rgl_performance_counters_t countersBefore, countersAfter;
+	CHECK_RGL(rgl_get_performance_counters(&countersBefore));
+	int64_t frame = 0;
+	for (auto _ : state) {
+		// Entities oscillate along Z axis, so that they stay within the lidar's field of view.
+		float shift = (frame++ % 2 == 0) ? CUBE_HALF_EDGE : 0.0f;
+		for (int32_t entityIdx = 0; entityIdx < movingCount; ++entityIdx) {
+			rgl_mat3x4f pose = (Mat3x4f::translation(0.0f, 0.0f, shift) * getGridPose(entityIdx, ENTITY_COUNT)).toRGL();
+			CHECK_RGL(rgl_entity_set_pose(entities[entityIdx], &pose));
+		}
+		benchmark::DoNotOptimize(runAndWait(raytrace, raytrace));
+	}
+	CHECK_RGL(rgl_get_performance_counters(&countersAfter));
+
+	uint64_t asBuildCount = countersAfter.as_build_count - countersBefore.as_build_count;
+	double asBuildTimeMs = countersAfter.as_build_time_ms - countersBefore.as_build_time_ms;
+	state.counters["moving"] = movingCount;
+	state.counters["as_builds"] = benchmark::Counter(static_cast<double>(asBuildCount), benchmark::Counter::kAvgIterations);
+	state.counters["as_build_ms"] = benchmark::Counter(asBuildTimeMs, benchmark::Counter::kAvgIterations);
+	CHECK_RGL(rgl_cleanup());
+}
+
+BENCHMARK(BM_MovingEntities)
+    ->ArgName("moving")
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1'000)
+    ->Arg(10'000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,53 @@
+#include <cstdlib>
+#include <filesystem>
+
+#include <benchmarkHelpers.hpp>
+#include <rgl/api/extensions/tape.h>
+
+static constexpr const char* TAPE_PATH_ENV_VARIABLE = "RGL_BENCHMARK_TAPE_PATH";
+
+/**
+ * Records a tape of a few lidar frames, used when no tape is provided in RGL_BENCHMARK_TAPE_PATH.
+ */
+static std::string recordSyntheticTape()
+{
+	constexpr int32_t FRAME_COUNT = 10;
+	std::string path = (std::filesystem::temp_directory_path() / "rgl_benchmark_tape").string();
+	CHECK_RGL(rgl_tape_record_begin(path.c_str()));
+
+	std::vector<rgl_entity_t> entities = spawnCubeGrid(100);
+	rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32;
+	rgl_node_t rays = makeRaysNode(100'000), raytrace = nullptr, compact = nullptr, format = nullptr;
+	CHECK_RGL(rgl_node_raytrace(&raytrace, nullptr));
+	CHECK_RGL(rgl_node_points_compact_by_field(&compact, RGL_FIELD_IS_HIT_I32));
+	CHECK_RGL(rgl_node_points_format(&format, &field, 1));
+	CHECK_RGL(rgl_graph_node_add_child(rays, raytrace));
+	CHECK_RGL(rgl_graph_node_add_child(raytrace, compact));
+	CHECK_RGL(rgl_graph_node_add_child(compact, format));
+	for (int32_t frame = 0; frame < FRAME_COUNT; ++frame) {
+		rgl_mat3x4f pose = (Mat3x4f::translation(0.0f, 0.0f, static_cast<float>(frame)) * getGridPose(0, 100)).toRGL();
+		CHECK_RGL(rgl_entity_set_pose(entities[0], &pose));
+		runAndWait(raytrace, format, RGL_FIELD_DYNAMIC_FORMAT);
+	}
+	CHECK_RGL(rgl_cleanup());
+	CHECK_RGL(rgl_tape_record_end());
+	return path;
+}
+
+/**
+ * Playback of a tape as fast as possible: measures the code paths exercised by the recorded application,
+ * including object creation and API overhead, which other benchmarks exclude from their measurements.
+ */
+static void BM_TapePlayback(benchmark::State& state)
+{
+	const char* providedPath = std::getenv(TAPE_PATH_ENV_VARIABLE);
+	std::string path = providedPath != nullptr ? providedPath : recordSyntheticTape();
+	state.SetLabel(std::filesystem::path(path).filename().string());
+
+	for (auto _ : state) {
+		CHECK_RGL(rgl_tape_play(path.c_str()));
+	}
+	CHECK_RGL(rgl_cleanup());
+}
+
+BENCHMARK(BM_TapePlayback)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -87,6 +87,20 @@ static std::function<Field<RAY_POSE_MAT3x4_F32>::type(int)> genRayPose = [](int
 	return Mat3x4f::TRS(Vec3f(tr(randomGenerator), tr(randomGenerator), tr(randomGenerator)),
 	                    Vec3f(rotDeg(randomGenerator), rotDeg(randomGenerator), rotDeg(randomGenerator)));
 };
+static std::function<Field<CLASS_ID_U16>::type(int)> genClassId = [](int i) { return i % 16; };
+// Bits of finite, positive half-precision floats
+static std::function<Field<XYZ_VEC3_F16>::type(int)> genCoordHalf = [](int i) {
+	return Vec3u16{i % 0x7C00, (i + 1) % 0x7C00, (i + 2) % 0x7C00};
+};
+static std::function<Field<DISTANCE_F16>::type(int)> genDistanceHalf = [](int i) { return i % 0x7C00; };
+static std::function<Field<NORMAL_VEC3_F16>::type(int)> genNormalHalf = [](int i) {
+	return Vec3u16{i % 0x3C00, (i + 1) % 0x3C00, (i + 2) % 0x3C00};
+};
+static std::function<Field<XYZ_VEC3_I16>::type(int)> genCoordQuantized = [](int i) {
+	return Vec3i16{i % INT16_MAX, -(i % INT16_MAX), (i / 2) % INT16_MAX};
+};
+static std::function<Field<CURVATURE_F32>::type(int)> genCurvature = [](int i) { return static_cast<float>(i % 100) / 300; };
+static std::function<Field<CLUSTER_ID_I32>::type(int)> genClusterId = [](int i) { return i % 10 - 1; };
 
 static std::function<Field<IS_HIT_I32>::type(int)> genHalfHit = [](int i) { return i % 2; };
 static std::function<Field<IS_HIT_I32>::type(int)> genAllNonHit = [](int i) { return 0; };
@@ -304,6 +304,13 @@ private:
 		{NORMAL_VEC3_F32, [&](std::size_t count) {setFieldValues<NORMAL_VEC3_F32>(generateFieldValues(count, genNormal));}},
 		{INCIDENT_ANGLE_F32, [&](std::size_t count) {setFieldValues<INCIDENT_ANGLE_F32>(generateFieldValues(count, genIncidentAngle));}},
 		{RAY_POSE_MAT3x4_F32, [&](std::size_t count) {setFieldValues<RAY_POSE_MAT3x4_F32>(generateFieldValues(count, genRayPose));}},
+		{CLASS_ID_U16, [&](std::size_t count) {setFieldValues<CLASS_ID_U16>(generateFieldValues(count, genClassId));}},
+		{XYZ_VEC3_F16, [&](std::size_t count) {setFieldValues<XYZ_VEC3_F16>(generateFieldValues(count, genCoordHalf));}},
+		{DISTANCE_F16, [&](std::size_t count) {setFieldValues<DISTANCE_F16>(generateFieldValues(count, genDistanceHalf));}},
+		{NORMAL_VEC3_F16, [&](std::size_t count) {setFieldValues<NORMAL_VEC3_F16>(generateFieldValues(count, genNormalHalf));}},
+		{XYZ_VEC3_I16, [&](std::size_t count) {setFieldValues<XYZ_VEC3_I16>(generateFieldValues(count, genCoordQuantized));}},
+		{CURVATURE_F32, [&](std::size_t count) {setFieldValues<CURVATURE_F32>(generateFieldValues(count, genCurvature));}},
+		{CLUSTER_ID_I32, [&](std::size_t count) {setFieldValues<CLUSTER_ID_I32>(generateFieldValues(count, genClusterId));}},
 	};
 	// clang-format on
 
@@ -1,4 +1,8 @@
 #include <filesystem>
+#include <future>
+
+#include <cuda_runtime.h>
+#include <optix.h>
 
 #include "helpers/sceneHelpers.hpp"
 #include "helpers/commonHelpers.hpp"
@@ -9,6 +13,9 @@
 #include "rgl/api/extensions/tape.h"
 #include "math/Mat3x4f.hpp"
 #include "tape/tapeDefinitions.hpp"
+#include "tape/BinaryTape.hpp"
+#include "tape/TapePlayer.hpp"
+#include "DLPack.hpp"
 
 #if RGL_BUILD_PCL_EXTENSION
 #include "rgl/api/extensions/pcl.h"
@@ -143,6 +150,26 @@ TEST_F(TapeTest, OutdatedStructureYAML)
 	EXPECT_RGL_TAPE_ERROR(rgl_tape_play(recordPath.c_str()), "Unsupported Tape format: Detected outdated format");
 }
 
+TEST_F(TapeTest, UnfinishedBinaryTape)
+{
+	std::string tapePath = createTempFilePath("unfinishedBinary", TAPE_EXTENSION);
+	std::string binPath = createTempFilePath("unfinishedBinary", BIN_EXT);
+	std::string recordPath = createTempFilePath("unfinishedBinary", "");
+
+	BinaryTapeHeader header{};
+	std::memcpy(header.magic, BINARY_TAPE_MAGIC, sizeof(header.magic));
+	header.formatVersion = BINARY_TAPE_FORMAT_VERSION;
+	std::vector<char> calls(sizeof(BinaryTapeFooter), 0);
+	std::ofstream tapeStream(tapePath, std::ios::binary);
+	tapeStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	tapeStream.write(calls.data(), static_cast<std::streamsize>(calls.size()));
+	tapeStream.close();
+	createEmptyFile(binPath);
+
+	EXPECT_RGL_TAPE_ERROR(rgl_tape_play(recordPath.c_str()),
+	                      "Invalid Tape: Binary tape file has no index (recording has not been finished)");
+}
+
 TEST_F(TapeTest, RecordPlayLoggingCall)
 {
 	std::string loggingRecordPath{(std::filesystem::temp_directory_path() / std::filesystem::path("loggingRecord")).string()};
@@ -163,6 +190,159 @@ TEST_F(TapeTest, RecordPlayLoggingCall)
 	EXPECT_RGL_SUCCESS(rgl_tape_play(loggingRecordPath.c_str()));
 }
 
+TEST_F(TapeTest, RecordPlayManyCallsAsynchronously)
+{
+	std::string recordPath{(std::filesystem::temp_directory_path() / std::filesystem::path("manyCallsRecord")).string()};
+	constexpr int UPDATE_COUNT = 1000;
+
+	ASSERT_RGL_SUCCESS(rgl_tape_record_begin(recordPath.c_str()));
+	rgl_mesh_t mesh = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_mesh_create(&mesh, cubeVertices, ARRAY_SIZE(cubeVertices), cubeIndices, ARRAY_SIZE(cubeIndices)));
+	for (int i = 0; i < UPDATE_COUNT; ++i) {
+		ASSERT_RGL_SUCCESS(rgl_mesh_update_vertices(mesh, cubeVertices, ARRAY_SIZE(cubeVertices)));
+	}
+	ASSERT_RGL_SUCCESS(rgl_tape_record_end());
+
+	rgl_performance_counters_t counters;
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&counters));
+	EXPECT_GE(counters.tape_queue_peak_bytes, sizeof(cubeVertices));
+
+	// All queued calls must have been written when recording ends.
+	EXPECT_RGL_SUCCESS(rgl_tape_play(recordPath.c_str()));
+}
+
+TEST_F(TapeTest, RecordRepeatedArraysOnce)
+{
+	std::string recordPath{(std::filesystem::temp_directory_path() / std::filesystem::path("repeatedArraysRecord")).string()};
+	constexpr int MESH_COUNT = 100;
+	// Large enough to be deduplicated; indices reference only the first cube.
+	std::vector<rgl_vec3f> vertices(1024, rgl_vec3f{});
+	std::copy(std::begin(cubeVertices), std::end(cubeVertices), vertices.begin());
+	size_t verticesSize = vertices.size() * sizeof(rgl_vec3f);
+
+	ASSERT_RGL_SUCCESS(rgl_tape_record_begin(recordPath.c_str()));
+	for (int i = 0; i < MESH_COUNT; ++i) {
+		rgl_mesh_t mesh = nullptr;
+		ASSERT_RGL_SUCCESS(rgl_mesh_create(&mesh, vertices.data(), static_cast<int32_t>(vertices.size()), cubeIndices,
+		                                   ARRAY_SIZE(cubeIndices)));
+		ASSERT_RGL_SUCCESS(rgl_mesh_destroy(mesh));
+	}
+	ASSERT_RGL_SUCCESS(rgl_tape_record_end());
+
+	EXPECT_LT(std::filesystem::file_size(recordPath + BIN_EXT), 2 * verticesSize);
+	EXPECT_RGL_SUCCESS(rgl_tape_play(recordPath.c_str()));
+}
+
+TEST_F(TapeTest, ReplicationInvalidArguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_replication_begin(nullptr), "address != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_replication_begin(""), "address[0]");
+	EXPECT_RGL_TAPE_ERROR(rgl_replication_end(), "no replication active");
+	// Nothing listens there, connecting must fail instead of dropping the calls.
+	std::string socketPath{(std::filesystem::temp_directory_path() / std::filesystem::path("noRglServer.sock")).string()};
+	EXPECT_RGL_TAPE_ERROR(rgl_replication_begin(socketPath.c_str()), "could not connect");
+	EXPECT_RGL_TAPE_ERROR(rgl_replication_end(), "no replication active");
+}
+
+TEST_F(TapeTest, SeekToLastFrame)
+{
+	std::string recordPath{(std::filesystem::temp_directory_path() / std::filesystem::path("seekRecord")).string()};
+	constexpr int FRAME_COUNT = 50;
+	constexpr float FIRST_DISTANCE = 10.0f;
+
+	ASSERT_RGL_SUCCESS(rgl_tape_record_begin(recordPath.c_str()));
+	rgl_mesh_t mesh = nullptr;
+	rgl_entity_t entity = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_mesh_create(&mesh, cubeVertices, ARRAY_SIZE(cubeVertices), cubeIndices, ARRAY_SIZE(cubeIndices)));
+	ASSERT_RGL_SUCCESS(rgl_entity_create(&entity, nullptr, mesh));
+	rgl_node_t rays = nullptr, raytrace = nullptr;
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&rays, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytrace, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(rays, raytrace));
+	for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+		rgl_mat3x4f pose = Mat3x4f::translation(0.0f, 0.0f, FIRST_DISTANCE + static_cast<float>(frame)).toRGL();
+		ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(rays));
+	}
+	ASSERT_RGL_SUCCESS(rgl_tape_record_end());
+	ASSERT_RGL_SUCCESS(rgl_cleanup());
+
+	TapePlayer player{recordPath.c_str()};
+	std::vector<TapePlayer::APICallIdx> runs = player.findAll({"rgl_graph_run"});
+	ASSERT_EQ(runs.size(), static_cast<size_t>(FRAME_COUNT));
+	player.seek(runs.back());
+	player.playThis(runs.back());
+
+	auto raytraceId = player.getTapeCall(player.findFirst({"rgl_node_raytrace"}).value()).getArgsNode()[0];
+	rgl_node_t playedRaytrace = player.getNodeHandle(raytraceId.as<TapeAPIObjectID>());
+	int32_t count = 0, sizeOf = 0;
+	rgl_vec3f hitPoint;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(playedRaytrace, RGL_FIELD_XYZ_VEC3_F32, &count, &sizeOf));
+	ASSERT_EQ(count, 1);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(playedRaytrace, RGL_FIELD_XYZ_VEC3_F32, &hitPoint));
+	EXPECT_FLOAT_EQ(hitPoint.value[2], FIRST_DISTANCE + static_cast<float>(FRAME_COUNT - 1) - CUBE_HALF_EDGE);
+}
+
+TEST_F(TapeTest, IsolatedPlayersDoNotShareScenes)
+{
+	std::string recordPath{(std::filesystem::temp_directory_path() / std::filesystem::path("isolatedRecord")).string()};
+	constexpr float DISTANCE = 10.0f;
+
+	ASSERT_RGL_SUCCESS(rgl_tape_record_begin(recordPath.c_str()));
+	rgl_mesh_t mesh = nullptr;
+	rgl_entity_t entity = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_mesh_create(&mesh, cubeVertices, ARRAY_SIZE(cubeVertices), cubeIndices, ARRAY_SIZE(cubeIndices)));
+	ASSERT_RGL_SUCCESS(rgl_entity_create(&entity, nullptr, mesh));
+	rgl_mat3x4f pose = Mat3x4f::translation(0.0f, 0.0f, DISTANCE).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+	rgl_node_t rays = nullptr, raytrace = nullptr;
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&rays, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytrace, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(rays, raytrace));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(rays));
+	ASSERT_RGL_SUCCESS(rgl_configure_motion_blur(false)); // Global calls are skipped by isolated players
+	ASSERT_RGL_SUCCESS(rgl_tape_record_end());
+	ASSERT_RGL_SUCCESS(rgl_cleanup());
+
+	// Tapes are played concurrently, each one in a scene of its own.
+	std::vector<std::unique_ptr<TapePlayer>> players;
+	std::vector<std::future<void>> playbacks;
+	for (int i = 0; i < 2; ++i) {
+		players.emplace_back(std::make_unique<TapePlayer>(recordPath.c_str()));
+		players.back()->isolate();
+		playbacks.emplace_back(std::async(std::launch::async, [&player = *players.back()]() { player.playUntil(); }));
+	}
+	for (auto&& playback : playbacks) {
+		ASSERT_NO_THROW(playback.get());
+	}
+	auto raytraceId = players[0]->getTapeCall(players[0]->findFirst({"rgl_node_raytrace"}).value()).getArgsNode()[0];
+	for (auto&& player : players) {
+		rgl_node_t playedRaytrace = player->getNodeHandle(raytraceId.as<TapeAPIObjectID>());
+		rgl_vec3f hitPoint;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(playedRaytrace, RGL_FIELD_XYZ_VEC3_F32, &hitPoint));
+		EXPECT_FLOAT_EQ(hitPoint.value[2], DISTANCE - CUBE_HALF_EDGE);
+	}
+
+	// The default scene is not modified; resetting a player destroys objects of its tape only.
+	rgl_node_t ownRays = nullptr, ownRaytrace = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&ownRays, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&ownRaytrace, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(ownRays, ownRaytrace));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(ownRays));
+	int32_t isHit = 1;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(ownRaytrace, RGL_FIELD_IS_HIT_I32, &isHit));
+	EXPECT_EQ(isHit, 0);
+	rgl_node_t firstPlayedRaytrace = players[0]->getNodeHandle(raytraceId.as<TapeAPIObjectID>());
+	players[0]->reset();
+	bool isAlive = true;
+	ASSERT_RGL_SUCCESS(rgl_node_is_alive(firstPlayedRaytrace, &isAlive));
+	EXPECT_FALSE(isAlive);
+	ASSERT_RGL_SUCCESS(rgl_node_is_alive(ownRaytrace, &isAlive));
+	EXPECT_TRUE(isAlive);
+}
+
 TEST_F(TapeTest, RecordPlayAllCalls)
 {
 	std::string allCallsRecordPath{(std::filesystem::temp_directory_path() / std::filesystem::path("allCallsRecord")).string()};
@@ -176,16 +356,78 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	int32_t major, minor, patch;
 	EXPECT_RGL_SUCCESS(rgl_get_version_info(&major, &minor, &patch));
 
+	uint64_t reservedBytes, usedBytes, allocationCount;
+	EXPECT_RGL_SUCCESS(rgl_configure_device_memory_pool(UINT64_MAX, 0));
+	EXPECT_RGL_SUCCESS(rgl_get_device_memory_pool_stats(&reservedBytes, &usedBytes, &allocationCount));
+	EXPECT_RGL_SUCCESS(rgl_configure_host_pinned_memory_pool(64 * 1024 * 1024));
+	EXPECT_RGL_SUCCESS(rgl_get_host_pinned_memory_pool_stats(&reservedBytes, &usedBytes, &allocationCount));
+	rgl_memory_usage_t memoryUsage;
+	EXPECT_RGL_SUCCESS(rgl_get_memory_usage(&memoryUsage));
+	rgl_memory_kind_stats_t memoryKindStats;
+	EXPECT_RGL_SUCCESS(rgl_get_memory_kind_stats(RGL_MEMORY_KIND_DEVICE_ASYNC, &memoryKindStats));
+	EXPECT_RGL_SUCCESS(rgl_configure_gas_eviction(UINT64_MAX, 0));
+	EXPECT_RGL_SUCCESS(rgl_configure_mesh_cache(false, 0));
+
+	rgl_performance_counters_t performanceCounters;
+	EXPECT_RGL_SUCCESS(rgl_configure_performance_sampling(0));
+	EXPECT_RGL_SUCCESS(rgl_get_performance_counters(&performanceCounters));
+	const char* metricsText = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_configure_metrics(false, 0));
+	EXPECT_RGL_SUCCESS(rgl_get_metrics_text(&metricsText));
+	EXPECT_RGL_SUCCESS(rgl_trace_start(16));
+	EXPECT_RGL_SUCCESS(rgl_trace_stop(createTempFilePath("tapeTrace", ".json").c_str()));
+	EXPECT_RGL_SUCCESS(rgl_warmup());
+	EXPECT_RGL_SUCCESS(rgl_configure_threads(nullptr, 0, nullptr, 0, false));
+	int32_t deviceCount = 0;
+	EXPECT_RGL_SUCCESS(rgl_get_device_count(&deviceCount));
+
 	// Note: the logging using tape test has been moved to another test case (RecordPlayLoggingCall) to not change the logging level of this test case.
 
 	rgl_mesh_t mesh = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_mesh_create(&mesh, cubeVertices, ARRAY_SIZE(cubeVertices), cubeIndices, ARRAY_SIZE(cubeIndices)));
 	EXPECT_RGL_SUCCESS(rgl_mesh_update_vertices(mesh, cubeVertices, ARRAY_SIZE(cubeVertices)));
+	std::vector<int32_t> boneIndices(4 * ARRAY_SIZE(cubeVertices), 0);
+	std::vector<float> boneWeights(4 * ARRAY_SIZE(cubeVertices), 0.0f);
+	for (int i = 0; i < ARRAY_SIZE(cubeVertices); ++i) {
+		boneWeights[4 * i] = 1.0f;
+	}
+	EXPECT_RGL_SUCCESS(rgl_mesh_set_skinning(mesh, boneIndices.data(), boneWeights.data(), ARRAY_SIZE(cubeVertices), 1));
+	EXPECT_RGL_SUCCESS(rgl_mesh_update_bones(mesh, &identityTf, 1));
+	std::vector<rgl_vec3f> keyframeVertices(cubeVertices, cubeVertices + ARRAY_SIZE(cubeVertices));
+	keyframeVertices.insert(keyframeVertices.end(), cubeVertices, cubeVertices + ARRAY_SIZE(cubeVertices));
+	EXPECT_RGL_SUCCESS(rgl_mesh_set_keyframes(mesh, keyframeVertices.data(), keyframeVertices.size(), 2));
+	EXPECT_RGL_SUCCESS(rgl_mesh_set_keyframe(mesh, 1));
+
+	rgl_mesh_t batchMesh = nullptr;
+	const rgl_vec3f* batchVertices = cubeVertices;
+	const rgl_vec3i* batchIndices = cubeIndices;
+	int32_t batchVertexCount = ARRAY_SIZE(cubeVertices), batchIndexCount = ARRAY_SIZE(cubeIndices);
+	EXPECT_RGL_SUCCESS(rgl_mesh_create_batch(&batchMesh, 1, &batchVertices, &batchVertexCount, &batchIndices, &batchIndexCount));
+	EXPECT_RGL_SUCCESS(rgl_mesh_update_vertices_batch(&batchMesh, 1, &batchVertices, &batchVertexCount));
+	EXPECT_RGL_SUCCESS(rgl_mesh_compress(batchMesh, RGL_VERTEX_FORMAT_SNORM16));
+
+	rgl_mesh_t asyncMesh = nullptr;
+	bool isAsyncMeshReady = false;
+	EXPECT_RGL_SUCCESS(
+	    rgl_mesh_create_async(&asyncMesh, cubeVertices, ARRAY_SIZE(cubeVertices), cubeIndices, ARRAY_SIZE(cubeIndices)));
+	EXPECT_RGL_SUCCESS(rgl_mesh_is_ready(asyncMesh, &isAsyncMeshReady));
+
+	rgl_mesh_t curvesMesh = nullptr;
+	std::vector<float> curveRadii = {0.1f, 0.2f, 0.1f};
+	std::vector<int32_t> curveSegments = {0, 1};
+	EXPECT_RGL_SUCCESS(rgl_mesh_create_curves(&curvesMesh, cubeVertices, curveRadii.data(), curveRadii.size(),
+	                                          curveSegments.data(), curveSegments.size()));
 
 	rgl_entity_t entity = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_entity_create(&entity, nullptr, mesh));
 	EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity, &identityTf));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_pose_batch(&entity, 1, &identityTf));
+	rgl_entity_t instancedEntities[2] = {};
+	std::vector<rgl_mat3x4f> instanceTfs = {identityTf, identityTf};
+	EXPECT_RGL_SUCCESS(rgl_entity_create_instanced(instancedEntities, nullptr, mesh, instanceTfs.data(), instanceTfs.size()));
 	EXPECT_RGL_SUCCESS(rgl_entity_set_id(entity, 1));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_class_id(entity, 7));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_intensity(entity, 100.0f));
 
 	rgl_texture_t texture = nullptr;
 	int width = 1024;
@@ -193,15 +435,57 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	auto textureRawData = generateCheckerboardTexture<TextureTexelFormat>(width, height);
 
 	EXPECT_RGL_SUCCESS(rgl_texture_create(&texture, textureRawData.data(), width, height));
+	rgl_texture_t mipmappedTexture = nullptr;
+	EXPECT_RGL_SUCCESS(
+	    rgl_texture_create_mipmapped(&mipmappedTexture, textureRawData.data(), width, height, 4, RGL_TEXTURE_FORMAT_BC4));
+	EXPECT_RGL_SUCCESS(rgl_texture_destroy(mipmappedTexture));
 	EXPECT_RGL_SUCCESS(rgl_mesh_set_texture_coords(mesh, cubeUVs, 8));
+#if OPTIX_VERSION >= 70600
+	EXPECT_RGL_SUCCESS(rgl_mesh_set_opacity_micromap(mesh, textureRawData.data(), width, height, 0.5f, 2));
+#endif
 	EXPECT_RGL_SUCCESS(rgl_entity_set_intensity_texture(entity, texture));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_lod_mesh(entity, batchMesh, 100.0f));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_lod_mesh(entity, nullptr, 100.0f));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_visibility_mask(entity, 0x03));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_static(entity, true));
 
 	EXPECT_RGL_SUCCESS(rgl_scene_set_time(nullptr, 1.5 * 1e9));
+	EXPECT_RGL_SUCCESS(rgl_scene_configure_gas_compaction(nullptr, false, 0));
+	EXPECT_RGL_SUCCESS(rgl_scene_configure_raytrace_batching(nullptr, false));
+	rgl_vec3f lodOrigin = {0.0f, 0.0f, 0.0f};
+	EXPECT_RGL_SUCCESS(rgl_scene_set_lod_origin(nullptr, &lodOrigin));
+	rgl_vec3f raycastDirection = {0.0f, 0.0f, 1.0f};
+	rgl_raycast_hit_t raycastHit;
+	EXPECT_RGL_SUCCESS(rgl_scene_raycast_batch(nullptr, &lodOrigin, &raycastDirection, 1, 100.0f, &raycastHit));
+
+	rgl_scene_t scene = nullptr;
+	rgl_entity_t sceneEntity = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_scene_create(&scene));
+	EXPECT_RGL_SUCCESS(rgl_entity_create(&sceneEntity, scene, mesh));
+	EXPECT_RGL_SUCCESS(rgl_scene_set_time(scene, 1.5 * 1e9));
+	EXPECT_RGL_SUCCESS(rgl_scene_configure_gas_compaction(scene, false, 0));
+	EXPECT_RGL_SUCCESS(rgl_scene_configure_raytrace_batching(scene, false));
+	rgl_scene_t forkedScene = nullptr;
+	rgl_entity_t forkedEntity = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_scene_fork(&forkedScene, scene, &sceneEntity, 1, &forkedEntity));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_pose(forkedEntity, &identityTf));
+	EXPECT_RGL_SUCCESS(rgl_scene_destroy(forkedScene));
+	EXPECT_RGL_SUCCESS(rgl_scene_destroy(scene));
 
 	rgl_node_t useRays = nullptr;
 	std::vector<rgl_mat3x4f> rays = {identityTf, identityTf};
 	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRays, rays.data(), rays.size()));
 
+	rgl_node_t raysFromDirections = nullptr;
+	std::vector<rgl_vec3f> directions = {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysFromDirections, directions.data(), directions.size()));
+
+	rgl_node_t raysFromPattern = nullptr;
+	std::vector<float> ringElevations = {-0.1f, 0.0f, 0.1f};
+	std::vector<float> ringTimeOffsets = {0.0f, 0.001f, 0.002f};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_pattern(&raysFromPattern, ringElevations.data(), ringTimeOffsets.data(),
+	                                              ringElevations.size(), -0.5f, 0.01f, 100, 0.05f));
+
 	rgl_node_t setRingIds = nullptr;
 	std::vector<int> rings = {0, 1};
 	EXPECT_RGL_SUCCESS(rgl_node_rays_set_ring_ids(&setRingIds, rings.data(), rings.size()));
@@ -214,6 +498,9 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	rgl_vec2f range = {0.0f, 1.0f};
 	EXPECT_RGL_SUCCESS(rgl_node_rays_set_range(&setRange, &range, 1));
 
+	rgl_node_t setLayout = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_rays_set_layout(&setLayout, 2, 1));
+
 	rgl_node_t transformRays = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_node_rays_transform(&transformRays, &identityTf));
 
@@ -233,6 +520,27 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	float farNonHitDistance = 2.0f;
 	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_non_hits(raytrace, nearNonHitDistance, farNonHitDistance));
 
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_return_mode(raytrace, RGL_RETURN_MODE_DUAL_FIRST_LAST));
+
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_beam_divergence(raytrace, 0.003f, 4, RGL_BEAM_REDUCTION_NEAREST));
+
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_noise(raytrace, 0.0f, 0.001f, RGL_AXIS_Y, 0.0f, 0.02f, 0.001f));
+
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_weather(raytrace, 0.01f, 0.5f));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_multipath(raytrace, 0, 1.0f));
+
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_visibility_mask(raytrace, 0x01));
+
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_culling(raytrace, 100.0f, 1.0f));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_incremental(raytrace, true));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_ray_sorting(raytrace, true));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_time_slicing(raytrace, 1));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_streaming(raytrace, 1));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_ray_skipping(raytrace, 0, 1));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_dense_output(raytrace, false));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_fused_format(raytrace, true));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_output_frame(raytrace, RGL_OUTPUT_FRAME_SENSOR, &identityTf));
+
 	rgl_node_t format = nullptr;
 	std::vector<rgl_field_t> fields = {RGL_FIELD_XYZ_VEC3_F32, RGL_FIELD_DISTANCE_F32};
 	EXPECT_RGL_SUCCESS(rgl_node_points_format(&format, fields.data(), fields.size()));
@@ -240,12 +548,43 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	rgl_node_t yield = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_node_points_format(&yield, fields.data(), fields.size()));
 
+	rgl_node_t shmPublish = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_shm_publish(&shmPublish, "/rgl_tape_test", 2, 1024, false));
+
+	rgl_node_t writeFile = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_write_file(&writeFile, "tape_test_", RGL_POINT_FILE_FORMAT_PLY));
+
+	rgl_node_t compress = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_compress(&compress, 0.001f));
+
 	rgl_node_t compact = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compact, RGL_FIELD_IS_HIT_I32));
 
 	rgl_node_t compactByField = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compactByField, IS_HIT_I32));
 
+	rgl_node_t compactByPredicates = nullptr;
+	std::vector<rgl_field_predicate_t> predicates = {
+	    {RGL_FIELD_DISTANCE_F32,  RGL_COMPARISON_LESS,      50.0},
+	    {RGL_FIELD_ENTITY_ID_I32, RGL_COMPARISON_NOT_EQUAL, 1.0 },
+    };
+	EXPECT_RGL_SUCCESS(
+	    rgl_node_points_compact_by_predicates(&compactByPredicates, predicates.data(), predicates.size(), false));
+
+	rgl_node_t compactByRegion = nullptr;
+	rgl_region_t region = {RGL_REGION_SHAPE_CYLINDER, {0.5f, 0.0f, -1.0f}, {50.0f, 0.0f, 1.0f}, false};
+	EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_region(&compactByRegion, &region, 1));
+
+	rgl_node_t rangeImage = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_range_image(&rangeImage, 16, 1024, -3.14159f, 3.14159f));
+
+	rgl_node_t occupancyGrid = nullptr;
+	rgl_vec3f gridMin = {-10.0f, -10.0f, -1.0f};
+	rgl_vec3f cellSize = {0.5f, 0.5f, 2.0f};
+	EXPECT_RGL_SUCCESS(rgl_node_points_occupancy_grid(&occupancyGrid, &gridMin, &cellSize, 40, 40, 1, true));
+	rgl_vec3f rayOrigin = {0.0f, 0.0f, 0.0f};
+	EXPECT_RGL_SUCCESS(rgl_node_points_occupancy_grid_configure_ray_casting(occupancyGrid, true, &rayOrigin));
+
 	rgl_node_t spatialMerge = nullptr;
 	std::vector<rgl_field_t> sMergeFields = {RGL_FIELD_XYZ_VEC3_F32, RGL_FIELD_DISTANCE_F32, RGL_FIELD_PADDING_32};
 	EXPECT_RGL_SUCCESS(rgl_node_points_spatial_merge(&spatialMerge, sMergeFields.data(), sMergeFields.size()));
@@ -254,6 +593,11 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	std::vector<rgl_field_t> tMergeFields = {RGL_FIELD_XYZ_VEC3_F32, RGL_FIELD_DISTANCE_F32, RGL_FIELD_PADDING_32};
 	EXPECT_RGL_SUCCESS(rgl_node_points_temporal_merge(&temporalMerge, tMergeFields.data(), tMergeFields.size()));
 
+	rgl_node_t temporalMergeRing = nullptr;
+	EXPECT_RGL_SUCCESS(
+	    rgl_node_points_temporal_merge_ring(&temporalMergeRing, tMergeFields.data(), tMergeFields.size(), 1024, 0.5));
+	EXPECT_RGL_SUCCESS(rgl_node_points_temporal_merge_configure_managed_memory(temporalMergeRing, true));
+
 	rgl_node_t usePoints = nullptr;
 	std::vector<rgl_field_t> usePointsFields = {RGL_FIELD_XYZ_VEC3_F32};
 	std::vector<::Field<XYZ_VEC3_F32>::type> usePointsData = {
@@ -263,15 +607,52 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	EXPECT_RGL_SUCCESS(rgl_node_points_from_array(&usePoints, usePointsData.data(), usePointsData.size(),
 	                                              usePointsFields.data(), usePointsFields.size()));
 
+	// Recorded as rgl_node_points_from_array with the current content.
+	rgl_node_t useDevicePoints = nullptr;
+	void* devicePointsData = nullptr;
+	EXPECT_EQ(cudaMalloc(&devicePointsData, sizeof(rgl_vec3f) * usePointsData.size()), cudaSuccess);
+	EXPECT_EQ(cudaMemcpy(devicePointsData, usePointsData.data(), sizeof(rgl_vec3f) * usePointsData.size(),
+	                     cudaMemcpyHostToDevice),
+	          cudaSuccess);
+	EXPECT_RGL_SUCCESS(rgl_node_points_from_device_array(&useDevicePoints, devicePointsData, usePointsData.size(),
+	                                                     usePointsFields.data(), usePointsFields.size()));
+	EXPECT_RGL_SUCCESS(rgl_graph_destroy(useDevicePoints));
+	EXPECT_EQ(cudaFree(devicePointsData), cudaSuccess);
+
 	rgl_node_t radarPostprocess = nullptr;
 	rgl_radar_scope_t radarScope{0.0f, 1.0f, 1.0f, 1.0f, 1.0f};
 	EXPECT_RGL_SUCCESS(
 	    rgl_node_points_radar_postprocess(&radarPostprocess, &radarScope, 1, 1.0f, 1.0f, 79E9f, 31.0f, 27.0f, 60.0f, 1.0f));
 
+	rgl_node_t radarRangeDoppler = nullptr;
+	rgl_radar_fmcw_config_t fmcwConfig{77E9f, 1E9f, 50E-6f, 256, 128, 31.0f, 27.0f, -100.0f, 2, 8, 12.0f};
+	EXPECT_RGL_SUCCESS(rgl_node_points_radar_range_doppler(&radarRangeDoppler, &fmcwConfig, 0.01f, 0.01f));
+
 	rgl_node_t filterGround = nullptr;
 	rgl_vec3f sensorUpVector = {0.0f, 1.0f, 0.0f};
 	EXPECT_RGL_SUCCESS(rgl_node_points_filter_ground(&filterGround, &sensorUpVector, 0.1f));
 
+	rgl_node_t filterGroundPlane = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_filter_ground_plane(&filterGroundPlane, &sensorUpVector, 0.1f, 0.1f, 0.1f, 64));
+
+	rgl_node_t voxelDownsample = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_voxel_downsample(&voxelDownsample, 1.0f, 1.0f, 1.0f));
+
+	rgl_node_t sortPoints = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_sort(&sortPoints, RGL_FIELD_AZIMUTH_F32, true));
+
+	rgl_node_t estimateNormals = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_estimate_normals(&estimateNormals, 0.5f));
+
+	rgl_node_t clusterEuclidean = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_cluster_euclidean(&clusterEuclidean, 0.5f, 3, 1000));
+
+	rgl_node_t clusterBoxes = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_cluster_boxes(&clusterBoxes));
+
+	rgl_node_t spatialIndex = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_points_spatial_index(&spatialIndex, 0.5f));
+
 	rgl_node_t compactByFieldGround = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compactByFieldGround, IS_GROUND_I32));
 
@@ -285,6 +666,9 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	rgl_qos_policy_history_t qos_h = QOS_POLICY_HISTORY_KEEP_LAST;
 	EXPECT_RGL_SUCCESS(rgl_node_points_ros2_publish_with_qos(&ros2pubqos, "pointcloud_ex", "rgl", qos_r, qos_d, qos_h, 10));
 	EXPECT_RGL_SUCCESS(rgl_node_publish_ros2_radarscan(&radarscanPub, "radarscan", "rgl", qos_r, qos_d, qos_h, 10));
+	rgl_node_t devicePointsPub = nullptr;
+	EXPECT_RGL_SUCCESS(
+	    rgl_node_points_ros2_publish_device(&devicePointsPub, "pointcloud_device", "rgl", qos_r, qos_d, qos_h, 10));
 #endif
 
 	rgl_node_t noiseAngularRay = nullptr;
@@ -296,6 +680,10 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	rgl_node_t noiseDistance = nullptr;
 	EXPECT_RGL_SUCCESS(rgl_node_gaussian_noise_distance(&noiseDistance, 0.1f, 0.1f, 0.01f));
 
+	rgl_node_t noiseTransformPoints = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_gaussian_noise_transform_points(&noiseTransformPoints, 0.1f, 0.1f, RGL_AXIS_X, 0.1f, 0.1f,
+	                                                            0.01f, &identityTf));
+
 	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRays, setTimeOffsets));
 	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(setTimeOffsets, setRange));
 	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(setRange, raytrace));
@@ -307,7 +695,9 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(raytrace, filterGround));
 	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(filterGround, compactByFieldGround));
 
+	EXPECT_RGL_SUCCESS(rgl_graph_prepare(raytrace, 1024));
 	EXPECT_RGL_SUCCESS(rgl_graph_run(raytrace));
+	EXPECT_RGL_SUCCESS(rgl_graph_run_batch(&raytrace, 1));
 
 #if RGL_BUILD_PCL_EXTENSION
 	rgl_node_t downsample = nullptr;
@@ -325,9 +715,49 @@ TEST_F(TapeTest, RecordPlayAllCalls)
 	int32_t outCount, outSizeOf;
 	EXPECT_RGL_SUCCESS(rgl_graph_get_result_size(format, RGL_FIELD_DYNAMIC_FORMAT, &outCount, &outSizeOf));
 
+	uint64_t outFrameId;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_frame_id(format, &outFrameId));
+
+	rgl_node_stats_t nodeStats;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_node_stats(format, &nodeStats));
+
+	EXPECT_RGL_SUCCESS(rgl_graph_set_random_seed(format, 42));
+	EXPECT_RGL_SUCCESS(rgl_graph_set_gpu_priority(format, 1));
+	EXPECT_RGL_SUCCESS(rgl_graph_configure_result_cache(format, true));
+	EXPECT_RGL_SUCCESS(rgl_graph_configure_memory_reuse(format, false));
+	EXPECT_RGL_SUCCESS(rgl_graph_configure_frame_dropping(format, false));
+	int32_t droppedFrameCount = 0;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_dropped_frame_count(format, &droppedFrameCount));
+
 	std::vector<char> tmpVec;
 	tmpVec.reserve(outCount * outSizeOf);
 	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(format, RGL_FIELD_DYNAMIC_FORMAT, tmpVec.data()));
+	rgl_field_t formatField = RGL_FIELD_DYNAMIC_FORMAT;
+	void* formatDst = tmpVec.data();
+	EXPECT_RGL_SUCCESS(rgl_graph_get_results(format, &formatField, 1, &formatDst, nullptr));
+
+	std::promise<rgl_status_t> asyncStatus;
+	auto onResultDelivered = [](rgl_status_t status, void* promise) {
+		static_cast<std::promise<rgl_status_t>*>(promise)->set_value(status);
+	};
+	EXPECT_RGL_SUCCESS(
+	    rgl_graph_get_result_data_async(format, RGL_FIELD_DYNAMIC_FORMAT, tmpVec.data(), onResultDelivered, &asyncStatus));
+	EXPECT_EQ(asyncStatus.get_future().get(), RGL_SUCCESS);
+
+	const void* outDevicePtr;
+	void* outEvent;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_device_ptr(format, RGL_FIELD_DYNAMIC_FORMAT, &outDevicePtr, &outCount, &outEvent));
+
+	void* outDLManagedTensor = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_dlpack(format, RGL_FIELD_DYNAMIC_FORMAT, &outDLManagedTensor, &outEvent));
+	auto* outTensor = static_cast<dlpack::ManagedTensor*>(outDLManagedTensor);
+	outTensor->deleter(outTensor);
+
+	std::vector<char> resultBuffer(outCount * outSizeOf + 1);
+	bool outReady;
+	EXPECT_RGL_SUCCESS(rgl_graph_set_result_buffer(format, RGL_FIELD_DYNAMIC_FORMAT, resultBuffer.data(), resultBuffer.size()));
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_buffer_status(format, RGL_FIELD_DYNAMIC_FORMAT, &outReady, &outCount));
+	EXPECT_RGL_SUCCESS(rgl_graph_set_result_buffer(format, RGL_FIELD_DYNAMIC_FORMAT, nullptr, 0));
 
 	EXPECT_RGL_SUCCESS(rgl_graph_destroy(setRingIds));
 	EXPECT_RGL_SUCCESS(rgl_entity_destroy(entity));
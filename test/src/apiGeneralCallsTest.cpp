@@ -2,8 +2,13 @@
 #include <helpers/fileHelpers.hpp>
 
 #include <Logger.hpp>
+#include <math/Mat3x4f.hpp>
 #include <rgl/api/extensions/tape.h>
 
+#ifndef _WIN32
+#include <sched.h>
+#endif // _WIN32
+
 using namespace ::testing;
 
 class GeneralCallsTest : public RGLTest
@@ -54,4 +59,143 @@ TEST_F(GeneralCallsTest, rgl_configure_logging)
 	EXPECT_THAT(logFile, HasSubstr("[error]: This is RGL error log."));
 	EXPECT_THAT(logFile, HasSubstr("[critical]: This is RGL critical log."));
 	EXPECT_RGL_SUCCESS(rgl_configure_logging(RGL_LOG_LEVEL_OFF, nullptr, false));
-}
\ No newline at end of file
+}
+
+TEST_F(GeneralCallsTest, rgl_configure_logging_queue)
+{
+	constexpr int MESSAGE_COUNT = 1000;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_logging_queue(-1), "queue_size >= 0");
+	EXPECT_RGL_SUCCESS(rgl_configure_logging(RGL_LOG_LEVEL_INFO, logFilePath.c_str(), false));
+	ASSERT_RGL_SUCCESS(rgl_configure_logging_queue(8));
+	for (int i = 0; i < MESSAGE_COUNT; ++i) {
+		RGL_INFO("Queued message {}", i);
+	}
+	rgl_performance_counters_t counters;
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&counters));
+	EXPECT_LE(counters.log_dropped_count, MESSAGE_COUNT);
+
+	// Queue is drained when logging becomes synchronous again; the newest messages are never dropped.
+	ASSERT_RGL_SUCCESS(rgl_configure_logging_queue(0));
+	Logger::getOrCreate().flush();
+	EXPECT_THAT(readFileStr(logFilePath), HasSubstr(fmt::format("Queued message {}", MESSAGE_COUNT - 1)));
+	EXPECT_RGL_SUCCESS(rgl_configure_logging(RGL_LOG_LEVEL_OFF, nullptr, false));
+}
+
+TEST_F(GeneralCallsTest, rgl_configure_device_memory_pool)
+{
+	constexpr uint64_t RESERVED_SIZE = 16 * 1024 * 1024;
+	uint64_t reservedBytes = 0, usedBytes = 0, allocationCount = 0;
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_device_memory_pool(0, 1), "reserved_size <= release_threshold");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_get_device_memory_pool_stats(nullptr, &usedBytes, &allocationCount),
+	                            "out_reserved_bytes != nullptr");
+
+	// Reserved memory is kept in the pool
+	ASSERT_RGL_SUCCESS(rgl_configure_device_memory_pool(UINT64_MAX, RESERVED_SIZE));
+	ASSERT_RGL_SUCCESS(rgl_get_device_memory_pool_stats(&reservedBytes, &usedBytes, &allocationCount));
+	EXPECT_GE(reservedBytes, RESERVED_SIZE);
+	EXPECT_LE(usedBytes, reservedBytes);
+}
+
+TEST_F(GeneralCallsTest, rgl_configure_host_pinned_memory_pool)
+{
+	uint64_t cachedBytes = 0, usedBytes = 0, allocationCount = 0;
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_get_host_pinned_memory_pool_stats(nullptr, &usedBytes, &allocationCount),
+	                            "out_cached_bytes != nullptr");
+
+	// Releasing all cached memory
+	ASSERT_RGL_SUCCESS(rgl_configure_host_pinned_memory_pool(0));
+	ASSERT_RGL_SUCCESS(rgl_get_host_pinned_memory_pool_stats(&cachedBytes, &usedBytes, &allocationCount));
+	EXPECT_EQ(cachedBytes, 0);
+	ASSERT_RGL_SUCCESS(rgl_configure_host_pinned_memory_pool(256 * 1024 * 1024));
+}
+
+TEST_F(GeneralCallsTest, rgl_configure_program_cache)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_program_cache(true, "", 0), "cache_path == nullptr || cache_path[0] != '\\0'");
+
+	// Programs are compiled in warmup, so configuring their cache is too late afterwards.
+	ASSERT_RGL_SUCCESS(rgl_warmup());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_program_cache(true, nullptr, 0), "has to be configured before");
+}
+
+TEST_F(GeneralCallsTest, rgl_configure_motion_blur)
+{
+	// The pipeline is compiled in warmup, so enabling motion blur is too late afterwards.
+	ASSERT_RGL_SUCCESS(rgl_warmup());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_motion_blur(true), "has to be configured before");
+}
+
+TEST_F(GeneralCallsTest, rgl_configure_max_register_count)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_max_register_count(-1), "max_register_count >= 0");
+
+	// Programs are compiled in warmup, so their register limit cannot be changed afterwards.
+	ASSERT_RGL_SUCCESS(rgl_warmup());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_max_register_count(64), "has to be configured before");
+}
+
+TEST_F(GeneralCallsTest, rgl_configure_device)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_device(-1), "device_index >= 0");
+
+	// Resources are created in warmup, so selecting the device is too late afterwards.
+	ASSERT_RGL_SUCCESS(rgl_warmup());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_device(0), "has to be selected before");
+}
+
+TEST_F(GeneralCallsTest, rgl_get_device_count)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_get_device_count(nullptr), "out_device_count != nullptr");
+
+	// Tests run on a GPU, whose index is in range.
+	int32_t deviceCount = 0;
+	ASSERT_RGL_SUCCESS(rgl_get_device_count(&deviceCount));
+	EXPECT_GE(deviceCount, 1);
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_device(deviceCount), "are available");
+}
+
+#ifndef _WIN32
+TEST_F(GeneralCallsTest, rgl_configure_threads)
+{
+	int32_t invalidCpu = -1;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_threads(nullptr, 1, nullptr, 0, false),
+	                            "graph_worker_cpus != nullptr || graph_worker_cpu_count == 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_threads(nullptr, 0, &invalidCpu, 1, false), "isValidCpu");
+
+	// Graph workers are started on the first run.
+	rgl_node_t rays = nullptr;
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&rays, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(rays));
+
+	cpu_set_t processCpus;
+	ASSERT_EQ(sched_getaffinity(0, sizeof(processCpus), &processCpus), 0);
+	int32_t workerCpu = 0;
+	while (!CPU_ISSET(workerCpu, &processCpus)) {
+		++workerCpu;
+	}
+	ASSERT_RGL_SUCCESS(rgl_configure_threads(&workerCpu, 1, nullptr, 0, false));
+
+	// Running workers are pinned, they are found by their names.
+	int workerCount = 0;
+	for (auto&& task : std::filesystem::directory_iterator("/proc/self/task")) {
+		std::string name;
+		std::ifstream{task.path() / "comm"} >> name; // Files in /proc have no size, they are read as streams
+		if (!name.starts_with("rgl-graph-")) {
+			continue;
+		}
+		cpu_set_t workerCpus;
+		ASSERT_EQ(sched_getaffinity(std::stoi(task.path().filename().string()), sizeof(workerCpus), &workerCpus), 0);
+		EXPECT_EQ(CPU_COUNT(&workerCpus), 1);
+		EXPECT_TRUE(CPU_ISSET(workerCpu, &workerCpus));
+		++workerCount;
+	}
+	EXPECT_GT(workerCount, 0);
+
+	ASSERT_RGL_SUCCESS(rgl_configure_threads(nullptr, 0, nullptr, 0, false));
+}
+#endif // _WIN32
@@ -0,0 +1,59 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+
+class CudaGraphCaptureTest : public RGLTest
+{};
+
+/**
+ * Transform points, format and yield are captured into a CUDA graph after a couple of runs with unchanged sizes.
+ * Results of replayed runs must reflect changes upstream (scene), and node modifications must not be ignored.
+ */
+TEST_F(CudaGraphCaptureTest, replayed_runs_should_reflect_changes)
+{
+	constexpr float EPSILON = 1e-4f;
+	rgl_entity_t cube = spawnCubeOnScene(Mat3x4f::identity());
+
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(0.5f, 0, 0).toRGL()};
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32};
+	rgl_mat3x4f pointsTransform = Mat3x4f::translation(0, 10, 0).toRGL();
+
+	rgl_node_t raysNode = nullptr, raytraceNode = nullptr, compactNode = nullptr;
+	rgl_node_t transformNode = nullptr, formatNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compactNode, RGL_FIELD_IS_HIT_I32));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transformNode, &pointsTransform));
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, compactNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(compactNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, formatNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(formatNode, yieldNode));
+
+	auto checkRun = [&](float cubeDistance, float offsetY) {
+		rgl_mat3x4f cubePose = Mat3x4f::translation(0, 0, cubeDistance).toRGL();
+		ASSERT_RGL_SUCCESS(rgl_entity_set_pose(cube, &cubePose));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+		TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, fields);
+		ASSERT_EQ(outPointCloud.getPointCount(), rays.size());
+		for (auto&& point : outPointCloud.getFieldValues<XYZ_VEC3_F32>()) {
+			EXPECT_NEAR(point.y(), offsetY, EPSILON);
+			EXPECT_NEAR(point.z(), cubeDistance - CUBE_HALF_EDGE, EPSILON);
+		}
+	};
+
+	for (int i = 0; i < 5; ++i) {
+		checkRun(5.0f + static_cast<float>(i), 10.0f);
+	}
+
+	pointsTransform = Mat3x4f::translation(0, -3, 0).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transformNode, &pointsTransform));
+	for (int i = 0; i < 5; ++i) {
+		checkRun(5.0f + static_cast<float>(i), -3.0f);
+	}
+}
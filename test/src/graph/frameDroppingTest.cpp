@@ -0,0 +1,61 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/graphHelpers.hpp>
+
+#include <api/apiCommon.hpp>
+
+#include <chrono>
+#include <thread>
+
+class FrameDroppingTest : public RGLTest
+{
+protected:
+	static constexpr double SLEEP = 0.2;
+	Vec3f data[1] = {{}};
+	rgl_field_t fields[1] = {XYZ_VEC3_F32};
+	rgl_node_t fromArray = nullptr, sleep = nullptr;
+
+	void SetUp() override
+	{
+		ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArray, data, 1, fields, 1));
+		createOrUpdateNode<SleepNode>(&sleep, SLEEP);
+		ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArray, sleep));
+	}
+
+	int32_t getDroppedFrameCount()
+	{
+		int32_t count = -1;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_dropped_frame_count(sleep, &count));
+		return count;
+	}
+};
+
+TEST_F(FrameDroppingTest, invalid_arguments)
+{
+	int32_t count = 0;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_configure_frame_dropping(nullptr, true), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_dropped_frame_count(nullptr, &count), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_dropped_frame_count(sleep, nullptr), "out_count != nullptr");
+	EXPECT_EQ(getDroppedFrameCount(), 0); // Never run
+}
+
+TEST_F(FrameDroppingTest, run_should_be_dropped_while_previous_is_in_progress)
+{
+	ASSERT_RGL_SUCCESS(rgl_graph_configure_frame_dropping(fromArray, true));
+
+	// The second run is requested while the first one sleeps in the graph thread.
+	ASSERT_RGL_SUCCESS(rgl_graph_run(fromArray));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(fromArray));
+	EXPECT_EQ(getDroppedFrameCount(), 1);
+
+	// Once the previous run has completed (and the scheduler's thread is done with it), the next one is not dropped.
+	int32_t outCount = 0, outSize = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(sleep, XYZ_VEC3_F32, &outCount, &outSize));
+	std::this_thread::sleep_for(std::chrono::duration<double>(SLEEP));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(fromArray));
+	EXPECT_EQ(getDroppedFrameCount(), 1);
+
+	// Without frame dropping, the run waits for the previous one.
+	ASSERT_RGL_SUCCESS(rgl_graph_configure_frame_dropping(sleep, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(fromArray));
+	EXPECT_EQ(getDroppedFrameCount(), 1);
+}
@@ -1,6 +1,12 @@
+#include <future>
+
+#include <cuda_runtime.h>
+
 #include <helpers/commonHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
 
 #include <math/Mat3x4f.hpp>
+#include <DLPack.hpp>
 
 #if RGL_BUILD_PCL_EXTENSION
 #include <rgl/api/extensions/pcl.h>
@@ -33,4 +39,233 @@ TEST_F(GraphGetResultTest, GetResultsSizeWithoutPriorRun)
 	// Test
 	int32_t count, size;
 	EXPECT_RGL_STATUS(rgl_graph_get_result_size(pointsFromArray, RGL_FIELD_XYZ_VEC3_F32, &count, &size), RGL_INVALID_PIPELINE);
-}
\ No newline at end of file
+}
+TEST_F(GraphGetResultTest, GetResultsFrameId)
+{
+	rgl_node_t pointsFromArray = nullptr, yield = nullptr, transform = nullptr;
+	rgl_vec3f points = {0};
+	rgl_field_t fields = RGL_FIELD_XYZ_VEC3_F32;
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	uint64_t frameId = 0;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, &points, 1, &fields, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yield, &fields, 1));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(pointsFromArray, yield));
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_frame_id(nullptr, &frameId), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_frame_id(yield, nullptr), "out_frame_id != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_frame_id(yield, &frameId));
+	EXPECT_EQ(frameId, 0);
+
+	for (uint64_t run = 1; run <= 3; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_frame_id(yield, &frameId));
+		EXPECT_EQ(frameId, run);
+	}
+
+	// Frame ids continue after changing graph's structure
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transform, &identity));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(pointsFromArray, transform));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_frame_id(transform, &frameId));
+	EXPECT_EQ(frameId, 4);
+}
+
+TEST_F(GraphGetResultTest, GetResultsIntoRegisteredBuffer)
+{
+	std::vector<rgl_vec3f> points = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}};
+	rgl_field_t fields = RGL_FIELD_XYZ_VEC3_F32;
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	rgl_node_t pointsFromArray = nullptr, transform = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, points.data(), points.size(), &fields, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transform, &identity));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(pointsFromArray, transform));
+
+	bool ready = false;
+	int32_t count = 0;
+	std::vector<rgl_vec3f> resultBuffer(points.size());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_set_result_buffer(transform, fields, resultBuffer.data(), 0), "buffer_size > 0");
+	EXPECT_RGL_STATUS(rgl_graph_get_result_buffer_status(transform, fields, &ready, &count), RGL_INVALID_PIPELINE,
+	                  "no result buffer");
+
+	int64_t bufferSize = static_cast<int64_t>(resultBuffer.size() * sizeof(rgl_vec3f));
+	ASSERT_RGL_SUCCESS(rgl_graph_set_result_buffer(transform, fields, resultBuffer.data(), bufferSize));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+	do {
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_buffer_status(transform, fields, &ready, &count));
+	} while (!ready);
+	ASSERT_EQ(count, points.size());
+	for (int i = 0; i < count; ++i) {
+		EXPECT_EQ(resultBuffer[i].value[0], points[i].value[0]);
+		EXPECT_EQ(resultBuffer[i].value[1], points[i].value[1]);
+		EXPECT_EQ(resultBuffer[i].value[2], points[i].value[2]);
+	}
+
+	// Too small buffer fails the run
+	ASSERT_RGL_SUCCESS(rgl_graph_set_result_buffer(transform, fields, resultBuffer.data(), sizeof(rgl_vec3f)));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+	rgl_status_t status = RGL_SUCCESS;
+	do {
+		status = rgl_graph_get_result_buffer_status(transform, fields, &ready, &count);
+	} while (status == RGL_SUCCESS && !ready);
+	EXPECT_EQ(status, RGL_INVALID_PIPELINE);
+
+	ASSERT_RGL_SUCCESS(rgl_graph_set_result_buffer(transform, fields, nullptr, 0));
+}
+
+TEST_F(GraphGetResultTest, GetResultsOfMultipleFields)
+{
+	constexpr std::size_t POINT_COUNT = 10;
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, INTENSITY_F32, DISTANCE_F32};
+	TestPointCloud pointCloud(fields, POINT_COUNT);
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	rgl_node_t usePoints = pointCloud.createUsePointsNode(), transform = nullptr, yield = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transform, &identity));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yield, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePoints, transform));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transform, yield));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePoints));
+
+	std::vector<Field<XYZ_VEC3_F32>::type> xyz(POINT_COUNT);
+	std::vector<Field<INTENSITY_F32>::type> intensity(POINT_COUNT);
+	std::vector<Field<DISTANCE_F32>::type> distance(POINT_COUNT);
+	std::vector<void*> dsts = {xyz.data(), intensity.data(), distance.data()};
+	std::vector<int32_t> counts(fields.size(), -1);
+	void* nullDst = nullptr;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_results(yield, nullptr, 1, dsts.data(), nullptr), "fields != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_results(yield, fields.data(), 0, dsts.data(), nullptr), "field_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_results(yield, fields.data(), 1, nullptr, nullptr), "dsts != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_results(yield, fields.data(), 1, &nullDst, nullptr), "dsts[i] != nullptr");
+
+	// Yielded fields are copied from the host cache, fields of other nodes from the device.
+	for (rgl_node_t node : {yield, transform}) {
+		ASSERT_RGL_SUCCESS(rgl_graph_get_results(node, fields.data(), fields.size(), dsts.data(), counts.data()));
+		EXPECT_THAT(counts, testing::Each(POINT_COUNT));
+		for (int i = 0; i < POINT_COUNT; ++i) {
+			EXPECT_EQ(xyz[i].x(), pointCloud.getFieldValue<XYZ_VEC3_F32>(i).x());
+			EXPECT_EQ(xyz[i].y(), pointCloud.getFieldValue<XYZ_VEC3_F32>(i).y());
+			EXPECT_EQ(xyz[i].z(), pointCloud.getFieldValue<XYZ_VEC3_F32>(i).z());
+			EXPECT_EQ(intensity[i], pointCloud.getFieldValue<INTENSITY_F32>(i));
+			EXPECT_EQ(distance[i], pointCloud.getFieldValue<DISTANCE_F32>(i));
+		}
+	}
+
+	rgl_field_t missingField = RING_ID_U16;
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_get_results(transform, &missingField, 1, dsts.data(), nullptr), "does not provide");
+}
+
+TEST_F(GraphGetResultTest, GetResultsDevicePtr)
+{
+	std::vector<rgl_vec3f> points = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}};
+	rgl_field_t fields = RGL_FIELD_XYZ_VEC3_F32;
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	rgl_node_t pointsFromArray = nullptr, transform = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, points.data(), points.size(), &fields, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transform, &identity));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(pointsFromArray, transform));
+
+	const void* devicePtr = nullptr;
+	void* event = nullptr;
+	int32_t count = 0;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_device_ptr(transform, fields, nullptr, &count, &event),
+	                            "out_device_ptr != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_device_ptr(transform, fields, &devicePtr, &count, nullptr),
+	                            "out_event != nullptr");
+	EXPECT_RGL_STATUS(rgl_graph_get_result_device_ptr(transform, fields, &devicePtr, &count, &event), RGL_INVALID_PIPELINE,
+	                  "it hasn't been run yet");
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_device_ptr(transform, fields, &devicePtr, &count, &event));
+	ASSERT_EQ(count, points.size());
+
+	std::vector<rgl_vec3f> hostPoints(count);
+	ASSERT_EQ(cudaEventSynchronize(static_cast<cudaEvent_t>(event)), cudaSuccess);
+	ASSERT_EQ(cudaMemcpy(hostPoints.data(), devicePtr, count * sizeof(rgl_vec3f), cudaMemcpyDeviceToHost), cudaSuccess);
+	for (int i = 0; i < count; ++i) {
+		EXPECT_EQ(hostPoints[i].value[0], points[i].value[0]);
+		EXPECT_EQ(hostPoints[i].value[1], points[i].value[1]);
+		EXPECT_EQ(hostPoints[i].value[2], points[i].value[2]);
+	}
+}
+
+TEST_F(GraphGetResultTest, GetResultsDLPack)
+{
+	std::vector<rgl_vec3f> points = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}};
+	rgl_field_t fields = RGL_FIELD_XYZ_VEC3_F32;
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	rgl_node_t pointsFromArray = nullptr, transform = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, points.data(), points.size(), &fields, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transform, &identity));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(pointsFromArray, transform));
+
+	void* managedTensor = nullptr;
+	void* event = nullptr;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_dlpack(transform, fields, nullptr, &event),
+	                            "out_dl_managed_tensor != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_dlpack(transform, fields, &managedTensor, nullptr),
+	                            "out_event != nullptr");
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_get_result_dlpack(transform, RING_ID_U16, &managedTensor, &event),
+	                            "does not provide");
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_dlpack(transform, fields, &managedTensor, &event));
+	auto* tensor = static_cast<dlpack::ManagedTensor*>(managedTensor);
+	EXPECT_EQ(tensor->tensor.device.deviceType, dlpack::CUDA);
+	EXPECT_EQ(tensor->tensor.ndim, 2);
+	EXPECT_EQ(tensor->tensor.shape[0], points.size());
+	EXPECT_EQ(tensor->tensor.shape[1], 3);
+	EXPECT_EQ(tensor->tensor.dtype.code, dlpack::FLOAT);
+	EXPECT_EQ(tensor->tensor.dtype.bits, 32);
+	EXPECT_EQ(tensor->tensor.dtype.lanes, 1);
+	EXPECT_EQ(tensor->tensor.strides, nullptr);
+
+	// The tensor holds the memory also after the graph is destroyed.
+	ASSERT_RGL_SUCCESS(rgl_graph_destroy(pointsFromArray));
+	std::vector<rgl_vec3f> hostPoints(points.size());
+	ASSERT_EQ(cudaEventSynchronize(static_cast<cudaEvent_t>(event)), cudaSuccess);
+	ASSERT_EQ(cudaMemcpy(hostPoints.data(), tensor->tensor.data, points.size() * sizeof(rgl_vec3f), cudaMemcpyDeviceToHost),
+	          cudaSuccess);
+	tensor->deleter(tensor);
+	for (int i = 0; i < points.size(); ++i) {
+		EXPECT_EQ(hostPoints[i].value[0], points[i].value[0]);
+		EXPECT_EQ(hostPoints[i].value[1], points[i].value[1]);
+		EXPECT_EQ(hostPoints[i].value[2], points[i].value[2]);
+	}
+}
+
+TEST_F(GraphGetResultTest, GetResultsDataAsync)
+{
+	std::vector<rgl_vec3f> points = {{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}};
+	rgl_field_t fields = RGL_FIELD_XYZ_VEC3_F32;
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	rgl_node_t pointsFromArray = nullptr, transform = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, points.data(), points.size(), &fields, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transform, &identity));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(pointsFromArray, transform));
+
+	auto onResultDelivered = [](rgl_status_t status, void* promise) {
+		static_cast<std::promise<rgl_status_t>*>(promise)->set_value(status);
+	};
+	std::vector<rgl_vec3f> result(points.size());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_data_async(transform, fields, result.data(), nullptr, nullptr),
+	                            "callback != nullptr");
+	EXPECT_RGL_STATUS(rgl_graph_get_result_data_async(transform, fields, result.data(), onResultDelivered, nullptr),
+	                  RGL_INVALID_PIPELINE, "it hasn't been run yet");
+
+	// Request issued right after the run (likely before the node is enqueued) and after the graph is synchronized.
+	for (bool isSynchronized : {false, true}) {
+		std::ranges::fill(result, rgl_vec3f{});
+		std::promise<rgl_status_t> delivered;
+		ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+		if (isSynchronized) {
+			ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(transform, fields, nullptr, nullptr));
+		}
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data_async(transform, fields, result.data(), onResultDelivered, &delivered));
+		ASSERT_EQ(delivered.get_future().get(), RGL_SUCCESS);
+		for (int i = 0; i < points.size(); ++i) {
+			EXPECT_EQ(result[i].value[0], points[i].value[0]);
+			EXPECT_EQ(result[i].value[1], points[i].value[1]);
+			EXPECT_EQ(result[i].value[2], points[i].value[2]);
+		}
+	}
+}
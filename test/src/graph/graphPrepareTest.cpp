@@ -0,0 +1,45 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <api/apiCommon.hpp>
+#include <graph/NodesCore.hpp>
+
+class GraphPrepareTest : public RGLTest
+{};
+
+TEST_F(GraphPrepareTest, invalid_arguments)
+{
+	rgl_node_t yield = nullptr;
+	rgl_field_t field = XYZ_VEC3_F32;
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yield, &field, 1));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_prepare(nullptr, 1), "raw_node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_prepare(yield, -1), "max_ray_count >= 0");
+}
+
+/**
+ * Arrays reserved by rgl_graph_prepare fit results of the runs, so that they are not reallocated in the first run.
+ */
+TEST_F(GraphPrepareTest, first_run_should_use_reserved_arrays)
+{
+	constexpr int32_t MAX_POINT_COUNT = 1024;
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, DISTANCE_F32};
+	TestPointCloud inPointCloud(fields, MAX_POINT_COUNT / 2);
+	rgl_node_t usePoints = inPointCloud.createUsePointsNode();
+	rgl_node_t format = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&format, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePoints, format));
+
+	ASSERT_RGL_SUCCESS(rgl_graph_prepare(format, MAX_POINT_COUNT));
+	auto formatNode = Node::validatePtr<FormatPointsNode>(format);
+	auto hostFrame = formatNode->getHostFrame();
+	const std::size_t pointSize = getPointSize(fields);
+	EXPECT_GE(hostFrame->getCapacity(), MAX_POINT_COUNT * pointSize);
+	const void* reservedData = hostFrame->getRawReadPtr();
+	hostFrame.reset(); // Frames held by the client are not reused
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(format));
+	int32_t outCount = 0, outSize = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(format, RGL_FIELD_DYNAMIC_FORMAT, &outCount, &outSize));
+	EXPECT_EQ(outCount, MAX_POINT_COUNT / 2);
+	EXPECT_EQ(formatNode->getHostFrame()->getRawReadPtr(), reservedData);
+}
@@ -0,0 +1,122 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+
+class MemoryReuseTest : public RGLTest
+{};
+
+TEST_F(MemoryReuseTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_configure_memory_reuse(nullptr, true), "node != nullptr");
+}
+
+/**
+ * Intermediates of a chain are released once consumed; yielded results must be intact in each run,
+ * while fields backed by released intermediates must not be served to the client.
+ */
+TEST_F(MemoryReuseTest, yielded_results_should_be_intact_in_each_run)
+{
+	constexpr float EPSILON = 1e-4f;
+	constexpr std::size_t POINT_COUNT = 1000;
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, DISTANCE_F32};
+	std::vector<rgl_field_t> yieldFields = {XYZ_VEC3_F32};
+	Mat3x4f firstTf = Mat3x4f::translation(1, 2, 3);
+	Mat3x4f secondTf = Mat3x4f::rotationDeg(0, 0, 90);
+	rgl_mat3x4f firstTfRGL = firstTf.toRGL(), secondTfRGL = secondTf.toRGL();
+
+	TestPointCloud pointCloud(fields, POINT_COUNT);
+	rgl_node_t usePointsNode = pointCloud.createUsePointsNode();
+	rgl_node_t firstTransformNode = nullptr, noiseNode = nullptr, secondTransformNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&firstTransformNode, &firstTfRGL));
+	ASSERT_RGL_SUCCESS(rgl_node_gaussian_noise_distance(&noiseNode, 0.0f, 0.0f, 0.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&secondTransformNode, &secondTfRGL));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, yieldFields.data(), yieldFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, firstTransformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(firstTransformNode, noiseNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(noiseNode, secondTransformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(secondTransformNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_configure_memory_reuse(yieldNode, true));
+
+	TestPointCloud expectedPointCloud = pointCloud;
+	expectedPointCloud.transform(secondTf * firstTf);
+	auto expectedPoints = expectedPointCloud.getFieldValues<XYZ_VEC3_F32>();
+	for (int run = 0; run < 3; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		auto outPoints = TestPointCloud::createFromNode(yieldNode, yieldFields).getFieldValues<XYZ_VEC3_F32>();
+		ASSERT_EQ(outPoints.size(), POINT_COUNT);
+		for (int i = 0; i < POINT_COUNT; ++i) {
+			EXPECT_NEAR(outPoints[i].x(), expectedPoints[i].x(), EPSILON);
+			EXPECT_NEAR(outPoints[i].y(), expectedPoints[i].y(), EPSILON);
+			EXPECT_NEAR(outPoints[i].z(), expectedPoints[i].z(), EPSILON);
+		}
+	}
+
+	// XYZ of the first transform is released; its distance is forwarded from the (pinned) input.
+	std::vector<Field<XYZ_VEC3_F32>::type> xyz(POINT_COUNT);
+	std::vector<Field<DISTANCE_F32>::type> distance(POINT_COUNT);
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_get_result_data(firstTransformNode, XYZ_VEC3_F32, xyz.data()), "memory reuse");
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(firstTransformNode, DISTANCE_F32, distance.data()));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_get_result_data(noiseNode, DISTANCE_F32, distance.data()), "memory reuse");
+
+	// Without memory reuse, intermediates are kept again.
+	ASSERT_RGL_SUCCESS(rgl_graph_configure_memory_reuse(yieldNode, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(noiseNode, XYZ_VEC3_F32, xyz.data()));
+}
+
+/**
+ * Noise nodes being the only consumers of their (released) inputs overwrite input's arrays in place;
+ * results must not accumulate between runs, also when followed by deferred (chained) transforms.
+ */
+TEST_F(MemoryReuseTest, in_place_chain_should_give_results_of_each_run)
+{
+	constexpr float EPSILON = 1e-4f;
+	constexpr std::size_t POINT_COUNT = 1000;
+	constexpr float DISTANCE_ERROR = 0.5f;
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, DISTANCE_F32};
+	Mat3x4f firstTf = Mat3x4f::translation(1, 2, 3);
+	Mat3x4f secondTf = Mat3x4f::rotationDeg(0, 0, 90);
+	rgl_mat3x4f firstTfRGL = firstTf.toRGL(), secondTfRGL = secondTf.toRGL();
+
+	TestPointCloud pointCloud(fields, POINT_COUNT);
+	rgl_node_t usePointsNode = pointCloud.createUsePointsNode();
+	rgl_node_t firstNoiseNode = nullptr, secondNoiseNode = nullptr, firstTransformNode = nullptr, secondTransformNode = nullptr,
+	           yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_gaussian_noise_distance(&firstNoiseNode, DISTANCE_ERROR, 0.0f, 0.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_gaussian_noise_distance(&secondNoiseNode, DISTANCE_ERROR, 0.0f, 0.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&firstTransformNode, &firstTfRGL));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&secondTransformNode, &secondTfRGL));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, firstNoiseNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(firstNoiseNode, secondNoiseNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(secondNoiseNode, firstTransformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(firstTransformNode, secondTransformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(secondTransformNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_configure_memory_reuse(yieldNode, true));
+
+	// Points are moved away from the origin by both noise nodes.
+	std::vector<Field<XYZ_VEC3_F32>::type> expectedPoints = pointCloud.getFieldValues<XYZ_VEC3_F32>();
+	std::vector<Field<DISTANCE_F32>::type> expectedDistances = pointCloud.getFieldValues<DISTANCE_F32>();
+	for (int i = 0; i < POINT_COUNT; ++i) {
+		expectedPoints[i] = secondTf * firstTf * (expectedPoints[i] + expectedPoints[i].normalized() * 2 * DISTANCE_ERROR);
+		expectedDistances[i] += 2 * DISTANCE_ERROR;
+	}
+	for (int run = 0; run < 3; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, fields);
+		auto outPoints = outPointCloud.getFieldValues<XYZ_VEC3_F32>();
+		auto outDistances = outPointCloud.getFieldValues<DISTANCE_F32>();
+		ASSERT_EQ(outPoints.size(), POINT_COUNT);
+		for (int i = 0; i < POINT_COUNT; ++i) {
+			EXPECT_NEAR(outPoints[i].x(), expectedPoints[i].x(), EPSILON);
+			EXPECT_NEAR(outPoints[i].y(), expectedPoints[i].y(), EPSILON);
+			EXPECT_NEAR(outPoints[i].z(), expectedPoints[i].z(), EPSILON);
+			EXPECT_NEAR(outDistances[i], expectedDistances[i], EPSILON);
+		}
+	}
+
+	// Overwritten arrays of the first noise node are not available to the client.
+	std::vector<Field<DISTANCE_F32>::type> distance(POINT_COUNT);
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_get_result_data(firstNoiseNode, DISTANCE_F32, distance.data()), "memory reuse");
+}
@@ -2,6 +2,8 @@
 #include <helpers/sceneHelpers.hpp>
 #include <helpers/lidarHelpers.hpp>
 
+#include <api/apiCommon.hpp>
+#include <graph/GraphRunCtx.hpp>
 #include <math/Mat3x4f.hpp>
 #include <Logger.hpp>
 
@@ -62,4 +64,44 @@ TEST_F(GraphNodeRemovalTest, NodeRemoval)
 #else
 	RGL_WARN("RGL compiled without PCL extension. Tests will not save PCD!");
 #endif
-}
\ No newline at end of file
+}
+TEST_F(GraphNodeRemovalTest, ToggledBranchKeepsGraphRunCtx)
+{
+	std::vector<rgl_vec3f> points = {rgl_vec3f{1, 2, 3}, rgl_vec3f{4, 5, 6}};
+	rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32;
+	rgl_mat3x4f translateXTf = Mat3x4f::TRS({3, 0, 0}).toRGL();
+	rgl_node_t fromArray = nullptr, yield = nullptr, debugTransform = nullptr, debugYield = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArray, points.data(), points.size(), &field, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yield, &field, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&debugTransform, &translateXTf));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&debugYield, &field, 1));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArray, yield));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(debugTransform, debugYield));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(fromArray));
+
+	auto yieldNode = Node::validatePtr(yield);
+	auto graphRunCtx = yieldNode->getGraphRunCtx();
+	auto yieldStream = graphRunCtx->getNodeStream(*yieldNode);
+
+	for (int i = 0; i < 2; ++i) {
+		// Attach the debug branch
+		ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArray, debugTransform));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(fromArray));
+		EXPECT_EQ(Node::validatePtr(debugYield)->getGraphRunCtx(), graphRunCtx);
+		EXPECT_EQ(graphRunCtx->getNodeStream(*yieldNode), yieldStream);
+		std::vector<rgl_vec3f> debugPoints(points.size());
+		int32_t outCount = 0, outSize = 0;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(debugYield, field, &outCount, &outSize));
+		ASSERT_EQ(outCount, points.size());
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(debugYield, field, debugPoints.data()));
+		EXPECT_EQ(debugPoints[0].value[0], points[0].value[0] + 3);
+
+		// Detach it
+		ASSERT_RGL_SUCCESS(rgl_graph_node_remove_child(fromArray, debugTransform));
+		EXPECT_FALSE(Node::validatePtr(debugTransform)->hasGraphRunCtx());
+		EXPECT_FALSE(Node::validatePtr(debugYield)->hasGraphRunCtx());
+		ASSERT_RGL_SUCCESS(rgl_graph_run(fromArray));
+		EXPECT_EQ(yieldNode->getGraphRunCtx(), graphRunCtx);
+		EXPECT_EQ(graphRunCtx->getNodes().size(), 2);
+	}
+}
@@ -0,0 +1,141 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <helpers/commonHelpers.hpp>
+
+class GraphNodeStatsTest : public RGLTest
+{
+protected:
+	~GraphNodeStatsTest() override
+	{
+		EXPECT_RGL_SUCCESS(rgl_configure_performance_sampling(0));
+		EXPECT_RGL_SUCCESS(rgl_configure_metrics(false, 0));
+	}
+};
+
+TEST_F(GraphNodeStatsTest, invalid_arguments)
+{
+	rgl_node_stats_t stats;
+	rgl_performance_counters_t counters;
+	rgl_node_t pointsFromArray = nullptr;
+	rgl_vec3f point = {0};
+	rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, &point, 1, &field, 1));
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_performance_sampling(-1), "frame_interval >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_get_performance_counters(nullptr), "out_counters != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_node_stats(nullptr, &stats), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_node_stats(pointsFromArray, nullptr), "out_stats != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_metrics(true, -1), "http_port >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_metrics(true, 65536), "http_port <= UINT16_MAX");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_get_metrics_text(nullptr), "out_text != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_trace_start(0), "max_event_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_trace_stop(nullptr), "file_path != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_trace_stop("trace.json"), "not being recorded");
+}
+
+TEST_F(GraphNodeStatsTest, every_nth_run_is_sampled)
+{
+	constexpr int32_t SAMPLING_INTERVAL = 2;
+	constexpr int32_t RUN_COUNT = 4;
+	rgl_node_t pointsFromArray = nullptr;
+	rgl_vec3f point = {0};
+	rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, &point, 1, &field, 1));
+
+	rgl_node_stats_t stats;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_node_stats(pointsFromArray, &stats));
+	EXPECT_EQ(stats.sample_count, 0);
+
+	rgl_performance_counters_t countersBefore, countersAfter;
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&countersBefore));
+	ASSERT_RGL_SUCCESS(rgl_configure_performance_sampling(SAMPLING_INTERVAL));
+	for (int32_t run = 0; run < RUN_COUNT; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(pointsFromArray, field, &point));
+	}
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&countersAfter));
+
+	// Results have been waited for, so GPU times of the last sampled run are available.
+	ASSERT_RGL_SUCCESS(rgl_graph_get_node_stats(pointsFromArray, &stats));
+	EXPECT_EQ(stats.sample_count, RUN_COUNT / SAMPLING_INTERVAL);
+	EXPECT_GT(stats.enqueue_cpu_time_ms, 0.0f);
+	EXPECT_GE(stats.exec_gpu_time_ms, 0.0f);
+	EXPECT_GE(stats.result_copy_gpu_time_ms, 0.0f);
+	EXPECT_GE(stats.array_peak_bytes, sizeof(point));
+
+	EXPECT_EQ(countersAfter.sampled_node_run_count - countersBefore.sampled_node_run_count, RUN_COUNT / SAMPLING_INTERVAL);
+	EXPECT_EQ(countersAfter.result_copy_count - countersBefore.result_copy_count, RUN_COUNT);
+	EXPECT_GE(countersAfter.result_copy_time_ms, countersBefore.result_copy_time_ms);
+}
+
+TEST_F(GraphNodeStatsTest, zero_interval_disables_sampling)
+{
+	ASSERT_RGL_SUCCESS(rgl_configure_performance_sampling(0));
+	rgl_node_t pointsFromArray = nullptr;
+	rgl_vec3f point = {0};
+	rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, &point, 1, &field, 1));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(pointsFromArray, field, &point));
+
+	rgl_node_stats_t stats;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_node_stats(pointsFromArray, &stats));
+	EXPECT_EQ(stats.sample_count, 0);
+}
+
+TEST_F(GraphNodeStatsTest, trace_contains_api_and_gpu_ranges)
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "rgl_trace_test.json";
+	rgl_node_t pointsFromArray = nullptr;
+	rgl_vec3f point = {0};
+	rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, &point, 1, &field, 1));
+
+	ASSERT_RGL_SUCCESS(rgl_trace_start(1024));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_trace_start(1024), "already being recorded");
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(pointsFromArray, field, &point));
+	ASSERT_RGL_SUCCESS(rgl_trace_stop(path.string().c_str()));
+
+	std::ifstream file(path);
+	std::string trace{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+	EXPECT_NE(trace.find("\"name\":\"rgl_graph_run\""), std::string::npos);
+	EXPECT_NE(trace.find("\"name\":\"rgl_graph_get_result_data\""), std::string::npos);
+	EXPECT_NE(trace.find("\"pid\":2,"), std::string::npos); // GPU execution of the node
+	EXPECT_NE(trace.find("\"dropped_event_count\":0"), std::string::npos);
+	std::filesystem::remove(path);
+}
+
+TEST_F(GraphNodeStatsTest, metrics_contain_run_latencies_and_transfers)
+{
+	constexpr int32_t RUN_COUNT = 3;
+	rgl_node_t pointsFromArray = nullptr;
+	rgl_vec3f point = {0};
+	rgl_field_t field = RGL_FIELD_XYZ_VEC3_F32;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&pointsFromArray, &point, 1, &field, 1));
+
+	rgl_performance_counters_t countersBefore, countersAfter;
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&countersBefore));
+	ASSERT_RGL_SUCCESS(rgl_configure_metrics(true, 0));
+	for (int32_t run = 0; run < RUN_COUNT; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray));
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(pointsFromArray, field, &point));
+	}
+	ASSERT_RGL_SUCCESS(rgl_graph_run(pointsFromArray)); // Awaits the latency measurement of the previous run
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&countersAfter));
+
+	EXPECT_GE(countersAfter.device_to_host_bytes - countersBefore.device_to_host_bytes, RUN_COUNT * sizeof(point));
+	EXPECT_GT(countersAfter.device_array_bytes, 0);
+
+	const char* text = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_get_metrics_text(&text));
+	std::string metrics{text};
+	EXPECT_NE(metrics.find("# TYPE rgl_graph_run_latency_seconds histogram"), std::string::npos);
+	EXPECT_NE(metrics.find("le=\"+Inf\"}"), std::string::npos);
+	EXPECT_NE(metrics.find("rgl_transferred_bytes_total{direction=\"device_to_host\"}"), std::string::npos);
+	EXPECT_NE(metrics.find("rgl_traced_rays_total"), std::string::npos);
+	EXPECT_TRUE(metrics.ends_with("# EOF\n"));
+}
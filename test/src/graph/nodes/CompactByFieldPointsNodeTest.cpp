@@ -176,6 +176,71 @@ TEST_P(CompactByFieldPointsNodeTest, multiple_compactions_applied_to_same_data)
 	EXPECT_EQ(*outPointCloud, *inPointCloudWithoutNonHits);
 }
 
+TEST_P(CompactByFieldPointsNodeTest, compaction_followed_by_format)
+{
+	int pointsCount = GetParam();
+
+	auto&& [inPointCloud, inNode] = createPointCloud(pointsCount, genRandHit);
+	runGraphWithAssertions(inNode);
+
+	rgl_node_t formatNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, pointFields.data(), pointFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(compactByFieldPointsNode, formatNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(inNode));
+
+	inPointCloud->removeNonHitPoints();
+	EXPECT_EQ(TestPointCloud::createFromFormatNode(formatNode, pointFields), *inPointCloud);
+}
+
+TEST_P(CompactByFieldPointsNodeTest, chained_compactions_followed_by_format)
+{
+	int pointsCount = GetParam();
+
+	auto&& [inPointCloud, inNode] = createPointCloud(pointsCount, genRandHit);
+
+	rgl_node_t firstCompactNode = nullptr, secondCompactNode = nullptr, formatNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_field(&firstCompactNode, IS_HIT_I32));
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_field(&secondCompactNode, IS_HIT_I32));
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, pointFields.data(), pointFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(inNode, firstCompactNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(firstCompactNode, secondCompactNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(secondCompactNode, formatNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(inNode));
+
+	inPointCloud->removeNonHitPoints();
+	EXPECT_EQ(TestPointCloud::createFromNode(secondCompactNode, pointFields), *inPointCloud);
+	EXPECT_EQ(TestPointCloud::createFromFormatNode(formatNode, pointFields), *inPointCloud);
+}
+
+TEST_P(CompactByFieldPointsNodeTest, compaction_followed_by_transform_and_format)
+{
+	int pointsCount = GetParam();
+
+	auto&& [inPointCloud, inNode] = createPointCloud(pointsCount, genRandHit);
+	Mat3x4f transform = Mat3x4f::TRS({1.0f, 2.0f, 3.0f}, {0.0f, 0.0f, 90.0f});
+	rgl_mat3x4f rglTransform = transform.toRGL();
+
+	rgl_node_t transformNode = nullptr, formatNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compactByFieldPointsNode, IS_HIT_I32));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transformNode, &rglTransform));
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, pointFields.data(), pointFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(inNode, compactByFieldPointsNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(compactByFieldPointsNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, formatNode));
+	// Point count of the compaction is consumed by the following nodes on the GPU; results have the exact count anyway.
+	ASSERT_RGL_SUCCESS(rgl_graph_run(inNode));
+
+	inPointCloud->removeNonHitPoints();
+	inPointCloud->transform(transform);
+	std::vector<TestPointCloud> outPointClouds = {TestPointCloud::createFromNode(transformNode, pointFields),
+	                                              TestPointCloud::createFromFormatNode(formatNode, pointFields)};
+	for (auto&& outPointCloud : outPointClouds) {
+		ASSERT_EQ(outPointCloud.getPointCount(), inPointCloud->getPointCount());
+		checkIfNearEqual(outPointCloud.getFieldValues<XYZ_VEC3_F32>(), inPointCloud->getFieldValues<XYZ_VEC3_F32>(), EPSILON_F);
+		EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>(), inPointCloud->getFieldValues<IS_HIT_I32>());
+	}
+}
+
 TEST_F(CompactByFieldPointsNodeTest, should_work_when_empty_point_cloud)
 {
 	rgl_node_t emptyPointCloudOutputNode = nullptr;
@@ -202,3 +267,61 @@ TEST_F(CompactByFieldPointsNodeTest, without_IS_HIT_field)
 
 	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(compactByFieldPointsNode), "IS_HIT_I32");
 }
+
+TEST_F(CompactByFieldPointsNodeTest, invalid_argument_predicates)
+{
+	rgl_field_predicate_t predicate = {DISTANCE_F32, RGL_COMPARISON_LESS, 1.0};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_predicates(nullptr, &predicate, 1, false), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_predicates(&compactByFieldPointsNode, nullptr, 1, false),
+	                            "predicates != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_predicates(&compactByFieldPointsNode, &predicate, 0, false),
+	                            "predicate_count > 0");
+
+	rgl_field_predicate_t vectorPredicate = {XYZ_VEC3_F32, RGL_COMPARISON_EQUAL, 0.0};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_predicates(&compactByFieldPointsNode, &vectorPredicate, 1, false),
+	                            "isScalar");
+	rgl_field_predicate_t invalidComparison = {DISTANCE_F32, static_cast<rgl_comparison_t>(-1), 0.0};
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_points_compact_by_predicates(&compactByFieldPointsNode, &invalidComparison, 1, false), "comparison");
+	rgl_field_predicate_t nanPredicate = {DISTANCE_F32, RGL_COMPARISON_LESS, std::numeric_limits<double>::quiet_NaN()};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_predicates(&compactByFieldPointsNode, &nanPredicate, 1, false),
+	                            "isnan");
+}
+
+TEST_P(CompactByFieldPointsNodeTest, points_matching_predicates)
+{
+	int pointsCount = GetParam();
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, ENTITY_ID_I32, DISTANCE_F32};
+	TestPointCloud inPointCloud(fields, pointsCount);
+	auto entityIds = generateFieldValues<Field<ENTITY_ID_I32>::type>(pointsCount, [](int i) { return i % 3; });
+	auto distances = generateFieldValues<Field<DISTANCE_F32>::type>(pointsCount,
+	                                                                [](int i) { return static_cast<float>(i % 10); });
+	inPointCloud.setFieldValues<ENTITY_ID_I32>(entityIds);
+	inPointCloud.setFieldValues<DISTANCE_F32>(distances);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	std::vector<rgl_field_predicate_t> predicates = {
+	    {ENTITY_ID_I32, RGL_COMPARISON_NOT_EQUAL, 1.0},
+	    {DISTANCE_F32,  RGL_COMPARISON_LESS,      4.5},
+    };
+	rgl_node_t matchAllNode = nullptr, matchAnyNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_predicates(&matchAllNode, predicates.data(), predicates.size(), false));
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_predicates(&matchAnyNode, predicates.data(), predicates.size(), true));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, matchAllNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, matchAnyNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	std::vector<Field<DISTANCE_F32>::type> expectedAllDistances, expectedAnyDistances;
+	for (int i = 0; i < pointsCount; ++i) {
+		bool isEntityMatched = entityIds[i] != 1;
+		bool isDistanceMatched = distances[i] < 4.5f;
+		if (isEntityMatched && isDistanceMatched) {
+			expectedAllDistances.push_back(distances[i]);
+		}
+		if (isEntityMatched || isDistanceMatched) {
+			expectedAnyDistances.push_back(distances[i]);
+		}
+	}
+	EXPECT_EQ(TestPointCloud::createFromNode(matchAllNode, fields).getFieldValues<DISTANCE_F32>(), expectedAllDistances);
+	EXPECT_EQ(TestPointCloud::createFromNode(matchAnyNode, fields).getFieldValues<DISTANCE_F32>(), expectedAnyDistances);
+}
@@ -0,0 +1,133 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <math/Mat3x4f.hpp>
+#include <RGLFields.hpp>
+#include <algorithm>
+#include <functional>
+
+class CompactByRegionPointsNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t compactByRegionNode = nullptr;
+	std::vector<rgl_field_t> pointFields = {XYZ_VEC3_F32, IS_HIT_I32};
+
+	// Points on a regular grid spanning [-GRID_HALF_SIZE, GRID_HALF_SIZE] on every axis.
+	static constexpr int GRID_HALF_SIZE = 5;
+
+	static std::vector<Field<XYZ_VEC3_F32>::type> makeGridPoints()
+	{
+		std::vector<Field<XYZ_VEC3_F32>::type> points;
+		for (int x = -GRID_HALF_SIZE; x <= GRID_HALF_SIZE; ++x) {
+			for (int y = -GRID_HALF_SIZE; y <= GRID_HALF_SIZE; ++y) {
+				for (int z = -GRID_HALF_SIZE; z <= GRID_HALF_SIZE; ++z) {
+					points.emplace_back(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+				}
+			}
+		}
+		return points;
+	}
+
+	std::vector<Field<XYZ_VEC3_F32>::type> runAndGetPoints(const std::vector<rgl_region_t>& regions)
+	{
+		auto inPoints = makeGridPoints();
+		TestPointCloud inPointCloud(pointFields, inPoints.size());
+		inPointCloud.setFieldValues<XYZ_VEC3_F32>(inPoints);
+		rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+		EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_region(&compactByRegionNode, regions.data(), regions.size()));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, compactByRegionNode));
+		EXPECT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		return TestPointCloud::createFromNode(compactByRegionNode, pointFields).getFieldValues<XYZ_VEC3_F32>();
+	}
+
+	static std::vector<Field<XYZ_VEC3_F32>::type> filterGridPoints(const std::function<bool(const Vec3f&)>& predicate)
+	{
+		std::vector<Field<XYZ_VEC3_F32>::type> points;
+		std::ranges::copy_if(makeGridPoints(), std::back_inserter(points), predicate);
+		return points;
+	}
+};
+
+TEST_F(CompactByRegionPointsNodeTest, invalid_arguments)
+{
+	rgl_region_t box = {RGL_REGION_SHAPE_BOX, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, false};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_region(nullptr, &box, 1), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_region(&compactByRegionNode, &box, -1), "region_count >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_region(&compactByRegionNode, nullptr, 1), "regions != nullptr");
+
+	rgl_region_t invalidBox = {RGL_REGION_SHAPE_BOX, {-1.0f, 1.0f, -1.0f}, {1.0f, -1.0f, 1.0f}, false};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_region(&compactByRegionNode, &invalidBox, 1), "region.min");
+	rgl_region_t invalidCylinder = {RGL_REGION_SHAPE_CYLINDER, {-1.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 1.0f}, false};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_region(&compactByRegionNode, &invalidCylinder, 1), "region.min");
+	rgl_region_t invalidShape = {static_cast<rgl_region_shape_t>(-1), {}, {}, false};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compact_by_region(&compactByRegionNode, &invalidShape, 1), "region.shape");
+
+	EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_region(&compactByRegionNode, nullptr, 0));
+	EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_region(&compactByRegionNode, &box, 1));
+}
+
+TEST_F(CompactByRegionPointsNodeTest, no_regions_should_keep_all_points)
+{
+	checkIfNearEqual(makeGridPoints(), runAndGetPoints({}));
+}
+
+TEST_F(CompactByRegionPointsNodeTest, box)
+{
+	std::vector<rgl_region_t> regions = {
+	    {RGL_REGION_SHAPE_BOX, {-1.0f, 0.0f, 2.0f}, {1.0f, 3.0f, 2.0f}, false}
+    };
+	auto expected = filterGridPoints([](const Vec3f& p) {
+		return p.x() >= -1.0f && p.x() <= 1.0f && p.y() >= 0.0f && p.y() <= 3.0f && p.z() == 2.0f;
+	});
+	checkIfNearEqual(expected, runAndGetPoints(regions));
+}
+
+TEST_F(CompactByRegionPointsNodeTest, cylinder)
+{
+	std::vector<rgl_region_t> regions = {
+	    {RGL_REGION_SHAPE_CYLINDER, {1.5f, 0.0f, -2.0f}, {3.0f, 0.0f, 0.0f}, false}
+    };
+	auto expected = filterGridPoints([](const Vec3f& p) {
+		float radius = std::hypot(p.x(), p.y());
+		return radius >= 1.5f && radius <= 3.0f && p.z() >= -2.0f && p.z() <= 0.0f;
+	});
+	checkIfNearEqual(expected, runAndGetPoints(regions));
+}
+
+TEST_F(CompactByRegionPointsNodeTest, excluded_distance_band_combined_with_box)
+{
+	std::vector<rgl_region_t> regions = {
+	    {RGL_REGION_SHAPE_BOX,           {0.0f, -5.0f, -5.0f}, {5.0f, 5.0f, 5.0f}, false},
+	    {RGL_REGION_SHAPE_DISTANCE_BAND, {0.0f, 0.0f, 0.0f},   {2.5f, 0.0f, 0.0f}, true },
+    };
+	auto expected = filterGridPoints([](const Vec3f& p) { return p.x() >= 0.0f && p.length() > 2.5f; });
+	checkIfNearEqual(expected, runAndGetPoints(regions));
+}
+
+TEST_F(CompactByRegionPointsNodeTest, should_compose_with_previous_compaction)
+{
+	std::vector<Field<XYZ_VEC3_F32>::type> inPoints = {
+	    {1.0f, 0.0f, 0.0f},
+        {2.0f, 0.0f, 0.0f},
+        {3.0f, 0.0f, 0.0f},
+        {4.0f, 0.0f, 0.0f}
+    };
+	TestPointCloud inPointCloud(pointFields, inPoints.size());
+	inPointCloud.setFieldValues<XYZ_VEC3_F32>(inPoints);
+	inPointCloud.setFieldValues<IS_HIT_I32>({1, 0, 1, 1});
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	rgl_node_t compactByFieldNode = nullptr;
+	rgl_region_t band = {RGL_REGION_SHAPE_DISTANCE_BAND, {1.5f, 0.0f, 0.0f}, {3.5f, 0.0f, 0.0f}, false};
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compactByFieldNode, IS_HIT_I32));
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_region(&compactByRegionNode, &band, 1));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, compactByFieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(compactByFieldNode, compactByRegionNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	std::vector<Field<XYZ_VEC3_F32>::type> expected = {
+	    {3.0f, 0.0f, 0.0f}
+    };
+	checkIfNearEqual(expected, TestPointCloud::createFromNode(compactByRegionNode, pointFields).getFieldValues<XYZ_VEC3_F32>());
+}
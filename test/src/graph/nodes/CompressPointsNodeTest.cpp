@@ -0,0 +1,122 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+class CompressPointsNodeTest : public RGLTest
+{
+protected:
+	static constexpr float XYZ_STEP = 0.001f;
+	rgl_node_t compressNode = nullptr;
+
+	std::vector<char> runAndGetStream(TestPointCloud& pointCloud)
+	{
+		rgl_node_t usePointsNode = pointCloud.createUsePointsNode();
+		EXPECT_RGL_SUCCESS(rgl_node_points_compress(&compressNode, XYZ_STEP));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, compressNode));
+		EXPECT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		int32_t outCount = 0, outSize = 0;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_size(compressNode, RGL_FIELD_DYNAMIC_FORMAT, &outCount, &outSize));
+		EXPECT_EQ(outSize, 1);
+		std::vector<char> stream(outCount);
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(compressNode, RGL_FIELD_DYNAMIC_FORMAT, stream.data()));
+		return stream;
+	}
+
+	// Reference decoder of the layout documented with rgl_compressed_points_header_t.
+	static std::vector<Vec3i> decode(const std::vector<char>& stream)
+	{
+		rgl_compressed_points_header_t header;
+		std::memcpy(&header, stream.data(), sizeof(header));
+		EXPECT_EQ(header.magic, RGL_COMPRESSED_POINTS_MAGIC);
+		EXPECT_EQ(header.version, RGL_COMPRESSED_POINTS_VERSION);
+		EXPECT_EQ(header.xyz_step, XYZ_STEP);
+
+		std::vector<Vec3i> points;
+		std::size_t offset = sizeof(header);
+		while (points.size() < header.point_count) {
+			rgl_compressed_block_header_t block;
+			std::memcpy(&block, stream.data() + offset, sizeof(block));
+			offset += sizeof(block);
+			std::size_t blockPointCount = std::min<std::size_t>(header.point_count - points.size(),
+			                                                    RGL_COMPRESSED_POINTS_BLOCK_SIZE);
+			std::vector<Vec3i> blockPoints(blockPointCount, Vec3i{block.first[0], block.first[1], block.first[2]});
+			for (int axis = 0; axis < 3; ++axis) {
+				std::size_t bitWidth = block.bit_widths[axis];
+				std::size_t wordCount = ((blockPointCount - 1) * bitWidth + 31) / 32;
+				std::vector<uint32_t> words(wordCount + 1, 0);
+				std::memcpy(words.data(), stream.data() + offset, wordCount * sizeof(uint32_t));
+				offset += wordCount * sizeof(uint32_t);
+				for (std::size_t i = 1; i < blockPointCount && bitWidth > 0; ++i) {
+					std::size_t bit = (i - 1) * bitWidth;
+					uint64_t bits = (static_cast<uint64_t>(words[bit / 32 + 1]) << 32 | words[bit / 32]) >> (bit % 32);
+					auto encoded = static_cast<uint32_t>(bits & ((uint64_t{1} << bitWidth) - 1));
+					auto delta = static_cast<int32_t>((encoded >> 1) ^ -(encoded & 1));
+					blockPoints[i][axis] = blockPoints[i - 1][axis] + delta;
+				}
+			}
+			points.insert(points.end(), blockPoints.begin(), blockPoints.end());
+		}
+		EXPECT_EQ(offset, stream.size());
+		return points;
+	}
+
+	static Vec3i quantize(const Vec3f& point)
+	{
+		return {static_cast<int>(std::lround(point.x() / XYZ_STEP)), static_cast<int>(std::lround(point.y() / XYZ_STEP)),
+		        static_cast<int>(std::lround(point.z() / XYZ_STEP))};
+	}
+};
+
+TEST_F(CompressPointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compress(nullptr, XYZ_STEP), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_compress(&compressNode, 0.0f), "xyz_step > 0.0f");
+	EXPECT_RGL_SUCCESS(rgl_node_points_compress(&compressNode, XYZ_STEP));
+}
+
+TEST_F(CompressPointsNodeTest, should_decode_to_quantized_points)
+{
+	// Two full blocks and a partial one, with arbitrary (far from each other) points.
+	constexpr std::size_t POINT_COUNT = 2 * RGL_COMPRESSED_POINTS_BLOCK_SIZE + 7;
+	TestPointCloud pointCloud({XYZ_VEC3_F32}, POINT_COUNT);
+	std::vector<char> stream = runAndGetStream(pointCloud);
+
+	std::vector<Vec3i> decoded = decode(stream);
+	ASSERT_EQ(decoded.size(), POINT_COUNT);
+	for (int i = 0; i < POINT_COUNT; ++i) {
+		Vec3i expected = quantize(pointCloud.getFieldValue<XYZ_VEC3_F32>(i));
+		for (int axis = 0; axis < 3; ++axis) {
+			EXPECT_NEAR(decoded[i][axis], expected[axis], 1) << "point " << i; // Division on the device may differ in ULP
+		}
+	}
+}
+
+TEST_F(CompressPointsNodeTest, should_compress_points_in_firing_order)
+{
+	// A ring of points 10 m around the sensor, one per 0.2 deg, as in a single channel of a rotating lidar.
+	constexpr std::size_t POINT_COUNT = 1800;
+	TestPointCloud pointCloud({XYZ_VEC3_F32}, POINT_COUNT);
+	std::vector<Field<XYZ_VEC3_F32>::type> points;
+	for (int i = 0; i < POINT_COUNT; ++i) {
+		float azimuth = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / POINT_COUNT;
+		points.emplace_back(10.0f * std::cos(azimuth), 10.0f * std::sin(azimuth), -1.5f);
+	}
+	pointCloud.setFieldValues<XYZ_VEC3_F32>(points);
+	std::vector<char> stream = runAndGetStream(pointCloud);
+
+	// Deltas of about 35 mm take 7 bits per axis instead of 32 bits of a float.
+	EXPECT_LT(stream.size(), pointCloud.getPointByteSize() * POINT_COUNT / 4);
+	std::vector<Vec3i> decoded = decode(stream);
+	ASSERT_EQ(decoded.size(), POINT_COUNT);
+	for (int i = 0; i < POINT_COUNT; ++i) {
+		Vec3i expected = quantize(points[i]);
+		for (int axis = 0; axis < 3; ++axis) {
+			EXPECT_NEAR(decoded[i][axis], expected[axis], 1) << "point " << i;
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+#include <RGLFields.hpp>
+
+#include <cmath>
+
+class EstimateNormalsPointsNodeTest : public RGLTest
+{
+protected:
+	static constexpr float EPSILON = 1e-4f;
+	rgl_node_t estimateNormalsNode = nullptr;
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, NORMAL_VEC3_F32, CURVATURE_F32};
+};
+
+TEST_F(EstimateNormalsPointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_estimate_normals(nullptr, 0.5f), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_estimate_normals(&estimateNormalsNode, 0.0f), "radius > 0.0f");
+	EXPECT_RGL_SUCCESS(rgl_node_points_estimate_normals(&estimateNormalsNode, 0.5f));
+}
+
+TEST_F(EstimateNormalsPointsNodeTest, should_estimate_normals_of_unorganized_plane)
+{
+	// Tilted plane z = 2 + 0.5x sampled in a 10x10 grid, and an isolated point.
+	std::vector<Field<XYZ_VEC3_F32>::type> points;
+	for (int x = 0; x < 10; ++x) {
+		for (int y = 0; y < 10; ++y) {
+			points.emplace_back(0.1f * x, 0.1f * y, 2.0f + 0.05f * x);
+		}
+	}
+	points.emplace_back(10.0f, 10.0f, 10.0f);
+	TestPointCloud inPointCloud({XYZ_VEC3_F32}, points.size());
+	inPointCloud.setFieldValues<XYZ_VEC3_F32>(points);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_estimate_normals(&estimateNormalsNode, 0.25f));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, estimateNormalsNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(estimateNormalsNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), points.size());
+	// Oriented towards the sensor, i.e. the origin of the point cloud's frame.
+	Vec3f expectedNormal = Vec3f{0.5f, 0.0f, -1.0f}.normalized();
+	for (int i = 0; i < points.size() - 1; ++i) {
+		Vec3f normal = outPointCloud.getFieldValue<NORMAL_VEC3_F32>(i);
+		for (int axis = 0; axis < 3; ++axis) {
+			EXPECT_NEAR(normal[axis], expectedNormal[axis], EPSILON) << "point " << i;
+		}
+		EXPECT_NEAR(outPointCloud.getFieldValue<CURVATURE_F32>(i), 0.0f, EPSILON) << "point " << i;
+	}
+	EXPECT_TRUE(std::isnan(outPointCloud.getFieldValue<NORMAL_VEC3_F32>(points.size() - 1).x()));
+	EXPECT_TRUE(std::isnan(outPointCloud.getFieldValue<CURVATURE_F32>(points.size() - 1)));
+}
+
+TEST_F(EstimateNormalsPointsNodeTest, should_estimate_normals_of_organized_point_cloud)
+{
+	constexpr int WIDTH = 8;
+	constexpr int HEIGHT = 6;
+	constexpr float CUBE_DISTANCE = 5.0f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	std::vector<rgl_mat3x4f> rays;
+	for (int y = 0; y < HEIGHT; ++y) {
+		for (int x = 0; x < WIDTH; ++x) {
+			rays.emplace_back(Mat3x4f::translation(static_cast<float>(x) * 0.1f, static_cast<float>(y) * 0.1f, 0).toRGL());
+		}
+	}
+	rgl_node_t raysNode = nullptr, setLayoutNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_set_layout(&setLayoutNode, WIDTH, HEIGHT));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_estimate_normals(&estimateNormalsNode, 0.25f));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, setLayoutNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(setLayoutNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, estimateNormalsNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(estimateNormalsNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), WIDTH * HEIGHT);
+	for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+		Vec3f normal = outPointCloud.getFieldValue<NORMAL_VEC3_F32>(i);
+		EXPECT_NEAR(normal.x(), 0.0f, EPSILON) << "point " << i;
+		EXPECT_NEAR(normal.y(), 0.0f, EPSILON) << "point " << i;
+		EXPECT_NEAR(normal.z(), -1.0f, EPSILON) << "point " << i;
+		EXPECT_NEAR(outPointCloud.getFieldValue<CURVATURE_F32>(i), 0.0f, EPSILON) << "point " << i;
+	}
+}
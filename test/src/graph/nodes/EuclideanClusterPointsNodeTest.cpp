@@ -0,0 +1,101 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <RGLFields.hpp>
+
+#include <cmath>
+#include <limits>
+
+class EuclideanClusterPointsNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t clusterNode = nullptr, boxesNode = nullptr;
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, CLUSTER_ID_I32};
+
+	// Appends a line of points along X, spaced by the step.
+	static void addLine(std::vector<Field<XYZ_VEC3_F32>::type>& points, Vec3f begin, int count, float step)
+	{
+		for (int i = 0; i < count; ++i) {
+			points.emplace_back(begin + Vec3f{step * i, 0.0f, 0.0f});
+		}
+	}
+};
+
+TEST_F(EuclideanClusterPointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_cluster_euclidean(nullptr, 0.5f, 1, 10), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_cluster_euclidean(&clusterNode, 0.0f, 1, 10), "tolerance > 0.0f");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_cluster_euclidean(&clusterNode, 0.5f, 0, 10), "min_cluster_size > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_cluster_euclidean(&clusterNode, 0.5f, 5, 4),
+	                            "max_cluster_size >= min_cluster_size");
+	EXPECT_RGL_SUCCESS(rgl_node_points_cluster_euclidean(&clusterNode, 0.5f, 1, 10));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_cluster_boxes(nullptr), "node != nullptr");
+	EXPECT_RGL_SUCCESS(rgl_node_points_cluster_boxes(&boxesNode));
+}
+
+TEST_F(EuclideanClusterPointsNodeTest, should_segment_clusters_and_compute_their_boxes)
+{
+	constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+	// Two separated lines (the second one crossing many cells), a too small cluster, and a non-finite point.
+	std::vector<Field<XYZ_VEC3_F32>::type> points;
+	addLine(points, {0.0f, 0.0f, 0.0f}, 10, 0.1f);
+	addLine(points, {-5.0f, 3.0f, 1.0f}, 40, 0.25f);
+	addLine(points, {20.0f, 20.0f, 20.0f}, 2, 0.1f);
+	points.emplace_back(nan, nan, nan);
+	// Interleave the first line with the rest, so that cluster ids are ordered by the lowest point index.
+	std::swap(points[1], points[15]);
+
+	TestPointCloud inPointCloud({XYZ_VEC3_F32}, points.size());
+	inPointCloud.setFieldValues<XYZ_VEC3_F32>(points);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_cluster_euclidean(&clusterNode, 0.3f, 3, 100));
+	ASSERT_RGL_SUCCESS(rgl_node_points_cluster_boxes(&boxesNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, clusterNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(clusterNode, boxesNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(clusterNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), points.size());
+	for (int i = 0; i < points.size(); ++i) {
+		const Vec3f& point = points[i];
+		int32_t expectedId = !std::isfinite(point.x()) || point.x() >= 20.0f ? -1 : point.y() > 1.0f ? 1 : 0;
+		EXPECT_EQ(outPointCloud.getFieldValue<CLUSTER_ID_I32>(i), expectedId) << "point " << i;
+	}
+
+	int32_t boxCount = 0, boxSize = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(boxesNode, RGL_FIELD_DYNAMIC_FORMAT, &boxCount, &boxSize));
+	ASSERT_EQ(boxCount, 2);
+	ASSERT_EQ(boxSize, sizeof(rgl_cluster_box_t));
+	std::vector<rgl_cluster_box_t> boxes(boxCount);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(boxesNode, RGL_FIELD_DYNAMIC_FORMAT, boxes.data()));
+
+	EXPECT_EQ(boxes[0].point_count, 10);
+	EXPECT_FLOAT_EQ(boxes[0].min.value[0], 0.0f);
+	EXPECT_FLOAT_EQ(boxes[0].max.value[0], 0.9f);
+	EXPECT_FLOAT_EQ(boxes[0].max.value[1], 0.0f);
+	EXPECT_EQ(boxes[1].point_count, 40);
+	EXPECT_FLOAT_EQ(boxes[1].min.value[0], -5.0f);
+	EXPECT_FLOAT_EQ(boxes[1].max.value[0], -5.0f + 0.25f * 39);
+	EXPECT_FLOAT_EQ(boxes[1].min.value[1], 3.0f);
+	EXPECT_FLOAT_EQ(boxes[1].max.value[2], 1.0f);
+}
+
+TEST_F(EuclideanClusterPointsNodeTest, should_reject_clusters_larger_than_max_size)
+{
+	std::vector<Field<XYZ_VEC3_F32>::type> points;
+	addLine(points, {0.0f, 0.0f, 0.0f}, 20, 0.1f);
+	addLine(points, {0.0f, 10.0f, 0.0f}, 5, 0.1f);
+	TestPointCloud inPointCloud({XYZ_VEC3_F32}, points.size());
+	inPointCloud.setFieldValues<XYZ_VEC3_F32>(points);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_cluster_euclidean(&clusterNode, 0.15f, 1, 10));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, clusterNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(clusterNode, outFields);
+	for (int i = 0; i < points.size(); ++i) {
+		EXPECT_EQ(outPointCloud.getFieldValue<CLUSTER_ID_I32>(i), i < 20 ? -1 : 0) << "point " << i;
+	}
+}
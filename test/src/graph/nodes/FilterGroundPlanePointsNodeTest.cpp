@@ -0,0 +1,61 @@
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+#include <math/Vector.hpp>
+
+struct FilterGroundPlanePointsNodeTest : public RGLTest
+{
+	static const inline rgl_vec3f UP_VEC = {0.0f, 0.0f, 1.0f};
+
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32};
+	rgl_node_t filterGroundPlaneNode = nullptr;
+};
+
+TEST_F(FilterGroundPlanePointsNodeTest, invalid_argument_node)
+{
+	const rgl_vec3f zeroVec = {0.0f, 0.0f, 0.0f};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_filter_ground_plane(nullptr, &UP_VEC, 0.1f, 0.1f, 0.1f, 64),
+	                            "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_filter_ground_plane(&filterGroundPlaneNode, nullptr, 0.1f, 0.1f, 0.1f, 64),
+	                            "sensor_up_vector != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_filter_ground_plane(&filterGroundPlaneNode, &UP_VEC, -1.0f, 0.1f, 0.1f, 64),
+	                            "ground_angle_threshold >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_filter_ground_plane(&filterGroundPlaneNode, &UP_VEC, 0.1f, -1.0f, 0.1f, 64),
+	                            "ground_distance_threshold >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_filter_ground_plane(&filterGroundPlaneNode, &UP_VEC, 0.1f, 0.1f, -1.0f, 64),
+	                            "ground_filter_distance >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_filter_ground_plane(&filterGroundPlaneNode, &UP_VEC, 0.1f, 0.1f, 0.1f, 0),
+	                            "max_iterations > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_filter_ground_plane(&filterGroundPlaneNode, &zeroVec, 0.1f, 0.1f, 0.1f, 64),
+	                            "upVector.length() > 0.0f");
+}
+
+TEST_F(FilterGroundPlanePointsNodeTest, marks_points_off_the_plane)
+{
+	// Ground grid with a few points above it
+	std::vector<Vec3f> points;
+	for (int x = 0; x < 10; ++x) {
+		for (int y = 0; y < 10; ++y) {
+			points.emplace_back(static_cast<float>(x), static_cast<float>(y), -1.0f);
+		}
+	}
+	constexpr int elevatedPointCount = 5;
+	for (int i = 0; i < elevatedPointCount; ++i) {
+		points.emplace_back(static_cast<float>(i), 0.5f, 1.0f);
+	}
+
+	rgl_node_t fromArrayNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArrayNode, points.data(), points.size(), fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_filter_ground_plane(&filterGroundPlaneNode, &UP_VEC, 0.1f, 0.05f, 0.05f, 256));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArrayNode, filterGroundPlaneNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(filterGroundPlaneNode));
+
+	int32_t outCount = 0, outSizeOf = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(filterGroundPlaneNode, IS_GROUND_I32, &outCount, &outSizeOf));
+	ASSERT_EQ(outCount, points.size());
+	std::vector<Field<IS_GROUND_I32>::type> nonGround(outCount);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(filterGroundPlaneNode, IS_GROUND_I32, nonGround.data()));
+	for (int i = 0; i < outCount; ++i) {
+		EXPECT_EQ(nonGround.at(i), points.at(i)[2] > 0.0f);
+	}
+}
@@ -11,6 +11,7 @@
 
 #include <numeric>
 #include <random>
+#include <set>
 
 static constexpr int MULTIPLE_FORMATS_COUNT = 15;
 
@@ -338,4 +339,30 @@ TEST_F(FormatPointsNodeTest, changing_required_fields_between_runs)
 		ASSERT_RGL_SUCCESS(rgl_graph_run(raytrace));
 		ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(compact, format)); // Restore connection for the next loop iteration
 	}
-}
\ No newline at end of file
+}
+TEST_F(FormatPointsNodeTest, held_host_frame_should_not_be_overwritten)
+{
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32};
+	TestPointCloud firstPointCloud(fields, 100);
+	rgl_node_t inNode = firstPointCloud.createUsePointsNode();
+	runGraphWithAssertions(inNode, fields);
+
+	auto node = Node::validatePtr<FormatPointsNode>(formatNode);
+	HostPinnedArray<char>::ConstPtr firstFrame = node->getHostFrame();
+	std::vector<char> firstFrameData(firstFrame->getReadPtr(), firstFrame->getReadPtr() + firstFrame->getCount());
+
+	TestPointCloud secondPointCloud = firstPointCloud;
+	secondPointCloud.transform(Mat3x4f::translation(1, 2, 3));
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&inNode, secondPointCloud.getData(), secondPointCloud.getPointCount(),
+	                                              fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(inNode));
+	EXPECT_EQ(TestPointCloud::createFromFormatNode(formatNode, fields), secondPointCloud);
+	EXPECT_NE(node->getHostFrame(), firstFrame);
+	EXPECT_EQ(std::vector<char>(firstFrame->getReadPtr(), firstFrame->getReadPtr() + firstFrame->getCount()), firstFrameData);
+
+	// Without holders, buffers are reused.
+	std::set<const void*> frameBuffers = {firstFrame.get(), node->getHostFrame().get()};
+	firstFrame.reset();
+	ASSERT_RGL_SUCCESS(rgl_graph_run(inNode));
+	EXPECT_TRUE(frameBuffers.contains(node->getHostFrame().get()));
+}
@@ -1,3 +1,5 @@
+#include <cuda_runtime.h>
+
 #include <helpers/testPointCloud.hpp>
 #include <helpers/commonHelpers.hpp>
 
@@ -73,3 +75,36 @@ TEST_P(FromArrayPointsNodeTest, use_case)
 	checkIfNearEqual(pointCloud->getFieldValues<IS_HIT_I32>(), outputPointCloud.getFieldValues<IS_HIT_I32>(), EPSILON_F);
 	checkIfNearEqual(pointCloud->getFieldValues<INTENSITY_F32>(), outputPointCloud.getFieldValues<INTENSITY_F32>(), EPSILON_F);
 }
+
+TEST_P(FromArrayPointsNodeTest, device_array_should_be_read_in_each_run)
+{
+	int pointsCount = GetParam();
+	pointCloud = std::make_unique<TestPointCloud>(pointFields, pointsCount);
+	std::size_t pointsSize = pointCloud->getPointCount() * pointCloud->getPointByteSize();
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_from_device_array(&usePointsNode, pointCloud->getData(),
+	                                                              pointCloud->getPointCount(), pointFields.data(),
+	                                                              pointFields.size()),
+	                            "not device-accessible");
+
+	void* devicePoints = nullptr;
+	ASSERT_EQ(cudaMalloc(&devicePoints, pointsSize), cudaSuccess);
+	ASSERT_EQ(cudaMemcpy(devicePoints, pointCloud->getData(), pointsSize, cudaMemcpyHostToDevice), cudaSuccess);
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_device_array(&usePointsNode, devicePoints, pointCloud->getPointCount(),
+	                                                     pointFields.data(), pointFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	TestPointCloud outputPointCloud = TestPointCloud::createFromNode(usePointsNode, pointFields);
+	checkIfNearEqual(pointCloud->getFieldValues<XYZ_VEC3_F32>(), outputPointCloud.getFieldValues<XYZ_VEC3_F32>(), EPSILON_F);
+	checkIfNearEqual(pointCloud->getFieldValues<INTENSITY_F32>(), outputPointCloud.getFieldValues<INTENSITY_F32>(), EPSILON_F);
+
+	// Updated content is picked up by the next run, without calling the API again.
+	TestPointCloud nextPointCloud(pointFields, pointsCount);
+	nextPointCloud.transform(Mat3x4f::translation(1, 2, 3));
+	ASSERT_EQ(cudaMemcpy(devicePoints, nextPointCloud.getData(), pointsSize, cudaMemcpyHostToDevice), cudaSuccess);
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	outputPointCloud = TestPointCloud::createFromNode(usePointsNode, pointFields);
+	checkIfNearEqual(nextPointCloud.getFieldValues<XYZ_VEC3_F32>(), outputPointCloud.getFieldValues<XYZ_VEC3_F32>(), EPSILON_F);
+
+	ASSERT_RGL_SUCCESS(rgl_graph_destroy(usePointsNode));
+	ASSERT_EQ(cudaFree(devicePoints), cudaSuccess);
+}
@@ -0,0 +1,70 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+
+class FromDirectionsRaysNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t raysNode = nullptr;
+	std::vector<rgl_vec3f> directions = {
+	    {0.0f, 0.0f, 1.0f},
+	    {0.0f, 0.0f, 2.0f}, // Not normalized
+	    {1.0f, 0.0f, 0.0f},
+	};
+};
+
+TEST_F(FromDirectionsRaysNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_rays_from_directions(nullptr, directions.data(), directions.size()),
+	                            "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_rays_from_directions(&raysNode, nullptr, directions.size()),
+	                            "directions != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_rays_from_directions(&raysNode, directions.data(), 0), "ray_count > 0");
+}
+
+TEST_F(FromDirectionsRaysNodeTest, transformed_rays_should_hit_as_transforms)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float SENSOR_Z = 1.0f;
+	constexpr float EPSILON = 1e-4f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	rgl_mat3x4f sensorPose = Mat3x4f::translation(0, 0, SENSOR_Z).toRGL();
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, IS_HIT_I32, DISTANCE_F32};
+	rgl_node_t transformNode = nullptr, raytraceNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, directions.data(), directions.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, fields);
+	ASSERT_EQ(outPointCloud.getPointCount(), directions.size());
+	auto outIsHits = outPointCloud.getFieldValues<IS_HIT_I32>();
+	auto outDistances = outPointCloud.getFieldValues<DISTANCE_F32>();
+	auto outXyz = outPointCloud.getFieldValues<XYZ_VEC3_F32>();
+	for (int i = 0; i < 2; ++i) {
+		EXPECT_EQ(outIsHits.at(i), 1);
+		EXPECT_NEAR(outDistances.at(i), CUBE_DISTANCE - CUBE_HALF_EDGE - SENSOR_Z, EPSILON);
+		EXPECT_NEAR(outXyz.at(i).z(), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+	}
+	EXPECT_EQ(outIsHits.at(2), 0);
+}
+
+TEST_F(FromDirectionsRaysNodeTest, invalid_pipeline_ray_pose_field)
+{
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, RAY_POSE_MAT3x4_F32};
+	rgl_node_t raytraceNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, directions.data(), directions.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(raysNode), "RAY_POSE_MAT3x4_F32");
+}
@@ -1,5 +1,9 @@
 #include <helpers/commonHelpers.hpp>
 #include <helpers/mathHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
 
 class FromMat3x4fRaysNodeTest : public RGLTest
 {
@@ -34,3 +38,35 @@ TEST_F(FromMat3x4fRaysNodeTest, valid_arguments)
 	// If (*raysFromMatNode) != nullptr
 	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysFromMatNode, &identityTestTransform, sizeof(identityTestTransform)));
 }
+
+TEST_F(FromMat3x4fRaysNodeTest, identical_rays_should_be_skipped_and_changed_rays_applied)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float EPSILON = 1e-4f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(0, 0, 1).toRGL()};
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, DISTANCE_F32};
+	rgl_node_t raytraceNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysFromMatNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysFromMatNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysFromMatNode));
+
+	// Passing the same data again
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysFromMatNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysFromMatNode));
+	auto outDistances = TestPointCloud::createFromNode(yieldNode, fields).getFieldValues<DISTANCE_F32>();
+	EXPECT_NEAR(outDistances.at(0), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+	EXPECT_NEAR(outDistances.at(1), CUBE_DISTANCE - CUBE_HALF_EDGE - 1.0f, EPSILON);
+
+	// Same count, different data
+	rays.at(1) = Mat3x4f::translation(0, 0, 2).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysFromMatNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysFromMatNode));
+	outDistances = TestPointCloud::createFromNode(yieldNode, fields).getFieldValues<DISTANCE_F32>();
+	EXPECT_NEAR(outDistances.at(0), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+	EXPECT_NEAR(outDistances.at(1), CUBE_DISTANCE - CUBE_HALF_EDGE - 2.0f, EPSILON);
+}
@@ -0,0 +1,75 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+
+#include <cmath>
+
+class FromPatternRaysNodeTest : public RGLTest
+{
+protected:
+	static constexpr int AZIMUTH_STEP_COUNT = 8;
+	static constexpr float AZIMUTH_START = -0.4f;
+	static constexpr float AZIMUTH_STEP = 0.1f;
+	static constexpr float AZIMUTH_STEP_TIME = 0.05f;
+
+	rgl_node_t raysNode = nullptr;
+	std::vector<float> ringElevations = {-0.2f, 0.0f, 0.15f};
+	std::vector<float> ringTimeOffsets = {0.0f, 0.01f, 0.02f};
+};
+
+TEST_F(FromPatternRaysNodeTest, invalid_arguments)
+{
+	auto createNode = [&](rgl_node_t* node, const float* elevations, const float* timeOffsets, int32_t ringCount,
+	                      int32_t azimuthStepCount) {
+		return rgl_node_rays_from_pattern(node, elevations, timeOffsets, ringCount, AZIMUTH_START, AZIMUTH_STEP,
+		                                  azimuthStepCount, AZIMUTH_STEP_TIME);
+	};
+	const int32_t ringCount = static_cast<int32_t>(ringElevations.size());
+
+	EXPECT_RGL_INVALID_ARGUMENT(createNode(nullptr, ringElevations.data(), ringTimeOffsets.data(), ringCount,
+	                                       AZIMUTH_STEP_COUNT),
+	                            "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(createNode(&raysNode, nullptr, ringTimeOffsets.data(), ringCount, AZIMUTH_STEP_COUNT),
+	                            "ring_elevations != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(createNode(&raysNode, ringElevations.data(), nullptr, ringCount, AZIMUTH_STEP_COUNT),
+	                            "ring_time_offsets != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(createNode(&raysNode, ringElevations.data(), ringTimeOffsets.data(), 0, AZIMUTH_STEP_COUNT),
+	                            "ring_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(createNode(&raysNode, ringElevations.data(), ringTimeOffsets.data(), ringCount, 0),
+	                            "azimuth_step_count > 0");
+}
+
+TEST_F(FromPatternRaysNodeTest, rays_follow_pattern_angles_and_rings)
+{
+	constexpr float EPSILON = 1e-4f;
+	constexpr float NON_HIT_DISTANCE = 10.0f;
+
+	// Nothing is hit, so points lie on the rays in the non-hit distance.
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, RING_ID_U16};
+	rgl_node_t raytraceNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_pattern(&raysNode, ringElevations.data(), ringTimeOffsets.data(),
+	                                              ringElevations.size(), AZIMUTH_START, AZIMUTH_STEP, AZIMUTH_STEP_COUNT,
+	                                              AZIMUTH_STEP_TIME));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_non_hits(raytraceNode, NON_HIT_DISTANCE, NON_HIT_DISTANCE));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	// Row-major layout: azimuth steps in a row, rings in consecutive rows.
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, fields);
+	ASSERT_EQ(outPointCloud.getPointCount(), ringElevations.size() * AZIMUTH_STEP_COUNT);
+	auto outXyz = outPointCloud.getFieldValues<XYZ_VEC3_F32>();
+	auto outRingIds = outPointCloud.getFieldValues<RING_ID_U16>();
+	for (int ringIdx = 0; ringIdx < ringElevations.size(); ++ringIdx) {
+		for (int azimuthIdx = 0; azimuthIdx < AZIMUTH_STEP_COUNT; ++azimuthIdx) {
+			int pointIdx = ringIdx * AZIMUTH_STEP_COUNT + azimuthIdx;
+			Vec3f point = outXyz.at(pointIdx);
+			EXPECT_NEAR(std::atan2(point.x(), point.z()), AZIMUTH_START + AZIMUTH_STEP * azimuthIdx, EPSILON);
+			EXPECT_NEAR(std::asin(point.y() / NON_HIT_DISTANCE), ringElevations.at(ringIdx), EPSILON);
+			EXPECT_EQ(outRingIds.at(pointIdx), ringIdx);
+		}
+	}
+}
@@ -1,4 +1,7 @@
 #include <helpers/commonHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <RGLFields.hpp>
 
 class GaussianNoiseDistanceNodeTest : public RGLTest
 {
@@ -31,3 +34,42 @@ TEST_F(GaussianNoiseDistanceNodeTest, valid_arguments)
 	// If (*gaussianNoiseNode) != nullptr
 	EXPECT_RGL_SUCCESS(rgl_node_gaussian_noise_distance(&gaussianNoiseNode, 0.1f, 0.1f, 0.01f));
 }
+
+TEST_F(GaussianNoiseDistanceNodeTest, seeded_graphs_should_give_identical_results)
+{
+	constexpr int POINT_COUNT = 1000;
+	TestPointCloud pointCloud({XYZ_VEC3_F32, DISTANCE_F32}, POINT_COUNT);
+	auto runAndGetDistances = [&](rgl_node_t noiseNode, rgl_node_t entryNode) {
+		EXPECT_RGL_SUCCESS(rgl_graph_run(entryNode));
+		std::vector<::Field<DISTANCE_F32>::type> distances(POINT_COUNT);
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(noiseNode, DISTANCE_F32, distances.data()));
+		return distances;
+	};
+	auto makeGraph = [&](rgl_node_t& noiseNode) {
+		rgl_node_t usePointsNode = pointCloud.createUsePointsNode();
+		noiseNode = nullptr;
+		EXPECT_RGL_SUCCESS(rgl_node_gaussian_noise_distance(&noiseNode, 0.0f, 0.1f, 0.01f));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, noiseNode));
+		return usePointsNode;
+	};
+
+	rgl_node_t noiseA = nullptr, noiseB = nullptr;
+	rgl_node_t graphA = makeGraph(noiseA);
+	rgl_node_t graphB = makeGraph(noiseB);
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_set_random_seed(nullptr, 42), "node != nullptr");
+	ASSERT_RGL_SUCCESS(rgl_graph_set_random_seed(graphA, 42));
+	ASSERT_RGL_SUCCESS(rgl_graph_set_random_seed(graphB, 42));
+
+	// Noise differs between frames, but the same frames of identically seeded graphs are bit-identical.
+	auto firstFrameA = runAndGetDistances(noiseA, graphA);
+	auto secondFrameA = runAndGetDistances(noiseA, graphA);
+	EXPECT_NE(firstFrameA, secondFrameA);
+	EXPECT_EQ(runAndGetDistances(noiseB, graphB), firstFrameA);
+	EXPECT_EQ(runAndGetDistances(noiseB, graphB), secondFrameA);
+
+	// Seeding restarts the sequence; another seed gives other noise.
+	ASSERT_RGL_SUCCESS(rgl_graph_set_random_seed(graphA, 42));
+	EXPECT_EQ(runAndGetDistances(noiseA, graphA), firstFrameA);
+	ASSERT_RGL_SUCCESS(rgl_graph_set_random_seed(graphA, 43));
+	EXPECT_NE(runAndGetDistances(noiseA, graphA), firstFrameA);
+}
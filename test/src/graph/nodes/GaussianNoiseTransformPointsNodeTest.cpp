@@ -0,0 +1,63 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/mathHelpers.hpp>
+
+#include <RGLFields.hpp>
+#include <math/Mat3x4f.hpp>
+
+class GaussianNoiseTransformPointsNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t gaussianNoiseNode = nullptr;
+	rgl_mat3x4f transform = Mat3x4f::TRS({1.0f, 2.0f, 3.0f}, {0.0f, 0.0f, 90.0f}).toRGL();
+};
+
+TEST_F(GaussianNoiseTransformPointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_gaussian_noise_transform_points(nullptr, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, 0.0f, 0.0f, &transform),
+	    "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_gaussian_noise_transform_points(&gaussianNoiseNode, 0.0f, -1.0f, RGL_AXIS_X, 0.0f, 0.0f, 0.0f, &transform),
+	    "angular_st_dev >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_gaussian_noise_transform_points(&gaussianNoiseNode, 0.0f, 0.0f, (rgl_axis_t) 4, 0.0f,
+	                                                                     0.0f, 0.0f, &transform),
+	                            "angular_axis");
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_gaussian_noise_transform_points(&gaussianNoiseNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, -1.0f, 0.0f, &transform),
+	    "distance_st_dev_base >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_gaussian_noise_transform_points(&gaussianNoiseNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, 0.0f, -1.0f, &transform),
+	    "distance_st_dev_rise_per_meter >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_gaussian_noise_transform_points(&gaussianNoiseNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, 0.0f, 0.0f, nullptr),
+	    "transform != nullptr");
+}
+
+TEST_F(GaussianNoiseTransformPointsNodeTest, matches_transform_without_noise)
+{
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32};
+	std::vector<Vec3f> points = {
+	    {1.0f, 0.0f, 0.0f},
+	    {0.0f, 5.0f, 0.0f},
+	    {-2.0f, 3.0f, 4.0f},
+	};
+
+	rgl_node_t fromArrayNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArrayNode, points.data(), points.size(), fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(
+	    rgl_node_gaussian_noise_transform_points(&gaussianNoiseNode, 0.0f, 0.0f, RGL_AXIS_Z, 0.0f, 0.0f, 0.0f, &transform));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArrayNode, gaussianNoiseNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(gaussianNoiseNode));
+
+	int32_t outCount = 0, outSizeOf = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(gaussianNoiseNode, XYZ_VEC3_F32, &outCount, &outSizeOf));
+	ASSERT_EQ(outCount, points.size());
+	std::vector<Vec3f> outPoints(outCount);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(gaussianNoiseNode, XYZ_VEC3_F32, outPoints.data()));
+	for (int i = 0; i < outCount; ++i) {
+		Vec3f expected = Mat3x4f::fromRGL(transform) * points.at(i);
+		EXPECT_NEAR(outPoints.at(i)[0], expected[0], 1e-4f);
+		EXPECT_NEAR(outPoints.at(i)[1], expected[1], 1e-4f);
+		EXPECT_NEAR(outPoints.at(i)[2], expected[2], 1e-4f);
+	}
+}
@@ -0,0 +1,18 @@
+#include <helpers/commonHelpers.hpp>
+
+#include <rgl/api/extensions/gl.h>
+
+class GlVisualizePointsNodeTest : public RGLTest
+{};
+
+// Windows are not opened in tests, which may run without a display.
+TEST_F(GlVisualizePointsNodeTest, invalid_arguments)
+{
+	rgl_node_t node = nullptr;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_visualize_gl(nullptr, "points", 800, 600, 5.0f), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_visualize_gl(&node, nullptr, 800, 600, 5.0f), "window_name != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_visualize_gl(&node, "", 800, 600, 5.0f), "window_name[0]");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_visualize_gl(&node, "points", 0, 600, 5.0f), "window_width > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_visualize_gl(&node, "points", 800, 0, 5.0f), "window_height > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_visualize_gl(&node, "points", 800, 600, 0.0f), "color_height_period > 0.0f");
+}
@@ -0,0 +1,114 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+
+class OccupancyGridPointsNodeTest : public RGLTest
+{
+protected:
+	// A row of 4 unit cells along X axis, centered on it.
+	rgl_node_t occupancyGridNode = nullptr;
+	rgl_vec3f gridMin = {0.0f, -0.5f, -0.5f};
+	rgl_vec3f cellSize = {1.0f, 1.0f, 1.0f};
+	std::vector<rgl_field_t> inFields = {XYZ_VEC3_F32, IS_HIT_I32};
+
+	std::vector<rgl_occupancy_cell_t> getCells()
+	{
+		int32_t outCount = 0, outSize = 0;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_size(occupancyGridNode, RGL_FIELD_DYNAMIC_FORMAT, &outCount, &outSize));
+		EXPECT_EQ(outSize, sizeof(rgl_occupancy_cell_t));
+		std::vector<rgl_occupancy_cell_t> cells(outCount);
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(occupancyGridNode, RGL_FIELD_DYNAMIC_FORMAT, cells.data()));
+		return cells;
+	}
+};
+
+TEST_F(OccupancyGridPointsNodeTest, invalid_arguments)
+{
+	rgl_vec3f zeroCellSize = {1.0f, 0.0f, 1.0f};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_occupancy_grid(nullptr, &gridMin, &cellSize, 4, 1, 1, false),
+	                            "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_occupancy_grid(&occupancyGridNode, nullptr, &cellSize, 4, 1, 1, false),
+	                            "grid_min != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &zeroCellSize, 4, 1, 1, false),
+	                            "cell_size");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &cellSize, 4, 0, 1, false),
+	                            "size_y > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &cellSize, 65536, 65536, 1, false),
+	                            "size_x");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_occupancy_grid_configure_ray_casting(nullptr, true, &gridMin),
+	                            "node != nullptr");
+	EXPECT_RGL_SUCCESS(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &cellSize, 4, 1, 1, false));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_occupancy_grid_configure_ray_casting(occupancyGridNode, true, nullptr),
+	                            "ray_origin != nullptr");
+	EXPECT_RGL_SUCCESS(rgl_node_points_occupancy_grid_configure_ray_casting(occupancyGridNode, true, &gridMin));
+}
+
+TEST_F(OccupancyGridPointsNodeTest, should_count_hits_and_heights)
+{
+	TestPointCloud inPointCloud(inFields, 5);
+	inPointCloud.setFieldValues<XYZ_VEC3_F32>(
+	    {Vec3f{0.5f, 0.0f, -0.25f}, Vec3f{0.7f, 0.1f, 0.25f}, Vec3f{2.5f, 0.0f, 0.0f}, Vec3f{3.5f, 0.0f, 0.0f},
+	     Vec3f{9.0f, 0.0f, 0.0f}});
+	inPointCloud.setFieldValues<IS_HIT_I32>({1, 1, 1, 0, 1});
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &cellSize, 4, 1, 1, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, occupancyGridNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	// Non-hit and the point outside the grid are skipped, cells are cleared in every run.
+	for (int run = 0; run < 2; ++run) {
+		std::vector<rgl_occupancy_cell_t> cells = getCells();
+		ASSERT_EQ(cells.size(), 4);
+		EXPECT_EQ(cells[0].hit_count, 2);
+		EXPECT_EQ(cells[0].min_height, -0.25f);
+		EXPECT_EQ(cells[0].max_height, 0.25f);
+		EXPECT_EQ(cells[1].hit_count, 0);
+		EXPECT_EQ(cells[1].min_height, std::numeric_limits<float>::infinity());
+		EXPECT_EQ(cells[1].max_height, -std::numeric_limits<float>::infinity());
+		EXPECT_EQ(cells[2].hit_count, 1);
+		EXPECT_EQ(cells[3].hit_count, 0);
+		for (auto&& cell : cells) {
+			EXPECT_EQ(cell.miss_count, 0);
+		}
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	}
+}
+
+TEST_F(OccupancyGridPointsNodeTest, should_cast_rays_and_accumulate)
+{
+	// Rays come from behind the grid; the hit ends in the last cell, the non-hit in the third one.
+	TestPointCloud inPointCloud(inFields, 2);
+	inPointCloud.setFieldValues<XYZ_VEC3_F32>({Vec3f{3.5f, 0.0f, 0.0f}, Vec3f{2.5f, 0.0f, 0.0f}});
+	inPointCloud.setFieldValues<IS_HIT_I32>({1, 0});
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	rgl_vec3f rayOrigin = {-1.0f, 0.0f, 0.0f};
+	ASSERT_RGL_SUCCESS(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &cellSize, 4, 1, 1, true));
+	ASSERT_RGL_SUCCESS(rgl_node_points_occupancy_grid_configure_ray_casting(occupancyGridNode, true, &rayOrigin));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, occupancyGridNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	std::vector<rgl_occupancy_cell_t> cells = getCells();
+	ASSERT_EQ(cells.size(), 4);
+	std::vector<int32_t> expectedHits = {0, 0, 0, 2};
+	std::vector<int32_t> expectedMisses = {4, 4, 4, 0};
+	for (int i = 0; i < cells.size(); ++i) {
+		EXPECT_EQ(cells[i].hit_count, expectedHits[i]);
+		EXPECT_EQ(cells[i].miss_count, expectedMisses[i]);
+	}
+
+	// Setting the same grid again keeps accumulated cells, changing it clears them.
+	ASSERT_RGL_SUCCESS(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &cellSize, 4, 1, 1, true));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	EXPECT_EQ(getCells()[3].hit_count, 3);
+	ASSERT_RGL_SUCCESS(rgl_node_points_occupancy_grid(&occupancyGridNode, &gridMin, &cellSize, 2, 1, 1, true));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	cells = getCells();
+	ASSERT_EQ(cells.size(), 2);
+	EXPECT_EQ(cells[0].miss_count, 2);
+	EXPECT_EQ(cells[1].miss_count, 2);
+	EXPECT_EQ(cells[1].hit_count, 0);
+}
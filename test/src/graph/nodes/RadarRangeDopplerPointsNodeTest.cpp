@@ -0,0 +1,84 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include <math/Mat3x4f.hpp>
+#include <RGLFields.hpp>
+
+class RadarRangeDopplerPointsNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t rangeDopplerNode = nullptr;
+	rgl_radar_fmcw_config_t config{
+	    .center_frequency = 77E9f,
+	    .bandwidth = 1.5E9f,
+	    .chirp_duration = 50E-6f,
+	    .samples_per_chirp = 64,
+	    .chirp_count = 32,
+	    .power_transmitted = 31.0f,
+	    .cumulative_device_gain = 27.0f,
+	    .noise_power = -200.0f,
+	    .cfar_guard_cells = 2,
+	    .cfar_training_cells = 4,
+	    .cfar_threshold = 12.0f,
+	};
+	std::vector<rgl_field_t> inFields = {DISTANCE_F32, RADIAL_SPEED_F32, RAY_POSE_MAT3x4_F32, NORMAL_VEC3_F32, XYZ_VEC3_F32};
+	std::vector<rgl_field_t> outFields = {DISTANCE_F32, RADIAL_SPEED_F32, POWER_F32, SNR_F32, IS_HIT_I32};
+};
+
+TEST_F(RadarRangeDopplerPointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_radar_range_doppler(nullptr, &config, 0.01f, 0.01f), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_radar_range_doppler(&rangeDopplerNode, nullptr, 0.01f, 0.01f),
+	                            "config != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_radar_range_doppler(&rangeDopplerNode, &config, 0.0f, 0.01f),
+	                            "ray_azimuth_step > 0");
+	rgl_radar_fmcw_config_t invalidConfig = config;
+	invalidConfig.bandwidth = 0.0f;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_radar_range_doppler(&rangeDopplerNode, &invalidConfig, 0.01f, 0.01f),
+	                            "bandwidth > 0");
+	invalidConfig = config;
+	invalidConfig.chirp_count = 1;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_radar_range_doppler(&rangeDopplerNode, &invalidConfig, 0.01f, 0.01f),
+	                            "chirp_count > 1");
+	EXPECT_RGL_SUCCESS(rgl_node_points_radar_range_doppler(&rangeDopplerNode, &config, 0.01f, 0.01f));
+}
+
+TEST_F(RadarRangeDopplerPointsNodeTest, should_detect_target_in_its_range_doppler_cell)
+{
+	constexpr float SPEED_OF_LIGHT = 299'792'458.0f;
+	const float rangeBinSize = SPEED_OF_LIGHT / (2.0f * config.bandwidth);
+	const float speedBinSize = SPEED_OF_LIGHT / (2.0f * config.center_frequency * config.chirp_duration * config.chirp_count);
+	constexpr int targetRangeBin = 20;
+	constexpr int targetSpeedBin = 3;
+	const float targetDistance = targetRangeBin * rangeBinSize;
+
+	// A surface facing the radar along the ray, and a non-hit.
+	TestPointCloud inPointCloud(inFields, 2);
+	inPointCloud.setFieldValues<DISTANCE_F32>({targetDistance, std::numeric_limits<float>::infinity()});
+	inPointCloud.setFieldValues<RADIAL_SPEED_F32>({targetSpeedBin * speedBinSize, 0.0f});
+	inPointCloud.setFieldValues<RAY_POSE_MAT3x4_F32>({Mat3x4f::identity(), Mat3x4f::identity()});
+	inPointCloud.setFieldValues<NORMAL_VEC3_F32>({Vec3f{0.0f, 0.0f, -1.0f}, Vec3f{0.0f, 0.0f, -1.0f}});
+	inPointCloud.setFieldValues<XYZ_VEC3_F32>({Vec3f{0.0f, 0.0f, targetDistance}, Vec3f{0.0f, 0.0f, 0.0f}});
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_radar_range_doppler(&rangeDopplerNode, &config, 0.01f, 0.01f));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, rangeDopplerNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	int32_t outCount = 0, outSize = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(rangeDopplerNode, DISTANCE_F32, &outCount, &outSize));
+	ASSERT_EQ(outCount, config.samples_per_chirp * config.chirp_count);
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(rangeDopplerNode, outFields);
+	auto power = outPointCloud.getFieldValues<POWER_F32>();
+	auto isDetection = outPointCloud.getFieldValues<IS_HIT_I32>();
+	const auto targetCell = (targetSpeedBin + config.chirp_count / 2) * config.samples_per_chirp + targetRangeBin;
+	EXPECT_EQ(std::distance(power.begin(), std::max_element(power.begin(), power.end())), targetCell);
+	EXPECT_EQ(isDetection.at(targetCell), 1);
+	EXPECT_GT(outPointCloud.getFieldValues<SNR_F32>().at(targetCell), config.cfar_threshold);
+	EXPECT_NEAR(outPointCloud.getFieldValues<DISTANCE_F32>().at(targetCell), targetDistance, 1E-3f);
+	EXPECT_NEAR(outPointCloud.getFieldValues<RADIAL_SPEED_F32>().at(targetCell), targetSpeedBin * speedBinSize, 1E-3f);
+}
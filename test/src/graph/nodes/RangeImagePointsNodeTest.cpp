@@ -0,0 +1,68 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+
+class RangeImagePointsNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t rangeImageNode = nullptr;
+	std::vector<rgl_field_t> inFields = {XYZ_VEC3_F32,  IS_HIT_I32,    RING_ID_U16,  AZIMUTH_F32,
+	                                     DISTANCE_F32, INTENSITY_F32, ENTITY_ID_I32};
+	std::vector<rgl_field_t> outFields = {IS_HIT_I32, DISTANCE_F32, INTENSITY_F32, ENTITY_ID_I32};
+};
+
+TEST_F(RangeImagePointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_range_image(nullptr, 2, 4, -1.0f, 1.0f), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_range_image(&rangeImageNode, 0, 4, -1.0f, 1.0f), "height > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_range_image(&rangeImageNode, 2, 0, -1.0f, 1.0f), "width > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_range_image(&rangeImageNode, 65536, 65536, -1.0f, 1.0f), "height");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_range_image(&rangeImageNode, 2, 4, 1.0f, 1.0f), "azimuth_min < azimuth_max");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_range_image(&rangeImageNode, 2, 4, -1.0f, NAN), "isfinite(azimuth_max)");
+	EXPECT_RGL_SUCCESS(rgl_node_points_range_image(&rangeImageNode, 2, 4, -1.0f, 1.0f));
+}
+
+TEST_F(RangeImagePointsNodeTest, should_keep_nearest_point_in_each_pixel)
+{
+	// Image of 2 rows and 4 columns, each column spans 1 radian of azimuth.
+	TestPointCloud inPointCloud(inFields, 6);
+	inPointCloud.setFieldValues<IS_HIT_I32>({1, 1, 1, 0, 1, 1});
+	inPointCloud.setFieldValues<RING_ID_U16>({0, 0, 1, 1, 5, 1});
+	inPointCloud.setFieldValues<AZIMUTH_F32>({-1.5f, -1.2f, 1.5f, 0.5f, 0.5f, 2.0f});
+	inPointCloud.setFieldValues<DISTANCE_F32>({5.0f, 3.0f, 7.0f, 1.0f, 1.0f, 1.0f});
+	inPointCloud.setFieldValues<INTENSITY_F32>({10.0f, 20.0f, 30.0f, 40.0f, 50.0f, 60.0f});
+	inPointCloud.setFieldValues<ENTITY_ID_I32>({1, 2, 3, 4, 5, 6});
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_range_image(&rangeImageNode, 2, 4, -2.0f, 2.0f));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, rangeImageNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	int32_t outCount = 0, outSize = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(rangeImageNode, DISTANCE_F32, &outCount, &outSize));
+	ASSERT_EQ(outCount, 2 * 4);
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(rangeImageNode, outFields);
+	std::vector<Field<IS_HIT_I32>::type> expectedIsHit = {1, 0, 0, 0, 0, 0, 0, 1};
+	std::vector<Field<DISTANCE_F32>::type> expectedDistance = {3.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 7.0f};
+	std::vector<Field<INTENSITY_F32>::type> expectedIntensity = {20.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 30.0f};
+	std::vector<Field<ENTITY_ID_I32>::type> expectedEntityId = {2, 0, 0, 0, 0, 0, 0, 3};
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>(), expectedIsHit);
+	EXPECT_EQ(outPointCloud.getFieldValues<DISTANCE_F32>(), expectedDistance);
+	EXPECT_EQ(outPointCloud.getFieldValues<INTENSITY_F32>(), expectedIntensity);
+	EXPECT_EQ(outPointCloud.getFieldValues<ENTITY_ID_I32>(), expectedEntityId);
+}
+
+TEST_F(RangeImagePointsNodeTest, should_not_provide_other_fields)
+{
+	TestPointCloud inPointCloud(inFields, 1);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+	rgl_node_t yieldNode = nullptr;
+	std::vector<rgl_field_t> yieldFields = {XYZ_VEC3_F32};
+	ASSERT_RGL_SUCCESS(rgl_node_points_range_image(&rangeImageNode, 2, 4, -2.0f, 2.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, yieldFields.data(), yieldFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, rangeImageNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(rangeImageNode, yieldNode));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(usePointsNode), "XYZ_VEC3_F32");
+}
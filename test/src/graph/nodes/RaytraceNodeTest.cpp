@@ -5,6 +5,10 @@
 
 #include <ranges>
 #include <cmath>
+#include <cstring>
+
+#include <cuda_fp16.h>
+#include <cuda_runtime.h>
 
 #include <math/Mat3x4f.hpp>
 
@@ -271,3 +275,1000 @@ TEST_F(RaytraceNodeTest, config_non_hit_far_distance_should_correctly_change_out
 		EXPECT_EQ(outIsHits.at(i), 0);
 	}
 }
+
+TEST_F(RaytraceNodeTest, batching_should_not_impact_results)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float SENSOR_B_OFFSET = -1.0f;
+	constexpr float EPSILON = 1e-4f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	// Sensors with different ray counts, connected by a spatial merge to form a single graph.
+	std::vector<rgl_mat3x4f> raysA = {Mat3x4f::identity().toRGL()};
+	std::vector<rgl_mat3x4f> raysB = {
+	    Mat3x4f::translation(0, 0, SENSOR_B_OFFSET).toRGL(),
+	    Mat3x4f::translation(0.1f, 0, SENSOR_B_OFFSET).toRGL(),
+	    Mat3x4f::translation(-0.1f, 0, SENSOR_B_OFFSET).toRGL(),
+	};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, DISTANCE_F32, NORMAL_VEC3_F32};
+	std::vector<rgl_field_t> mergeFields = {XYZ_VEC3_F32};
+
+	rgl_node_t raysANode = nullptr, raysBNode = nullptr, raytraceBNode = nullptr;
+	rgl_node_t yieldANode = nullptr, yieldBNode = nullptr, mergeNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysANode, raysA.data(), raysA.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysBNode, raysB.data(), raysB.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceBNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldANode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldBNode, outFields.data(), 2)); // Different fields, w/o normals
+	ASSERT_RGL_SUCCESS(rgl_node_points_spatial_merge(&mergeNode, mergeFields.data(), mergeFields.size()));
+
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysANode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldANode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(yieldANode, mergeNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysBNode, raytraceBNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceBNode, yieldBNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(yieldBNode, mergeNode));
+
+	for (bool enableBatching : {false, true, false}) {
+		ASSERT_RGL_SUCCESS(rgl_scene_configure_raytrace_batching(nullptr, enableBatching));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raysANode));
+
+		TestPointCloud outA = TestPointCloud::createFromNode(yieldANode, outFields);
+		ASSERT_EQ(outA.getPointCount(), raysA.size());
+		EXPECT_NEAR(outA.getFieldValues<DISTANCE_F32>().at(0), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+		EXPECT_NEAR(outA.getFieldValues<NORMAL_VEC3_F32>().at(0).z(), -1.0f, EPSILON);
+
+		TestPointCloud outB = TestPointCloud::createFromNode(yieldBNode, {XYZ_VEC3_F32, DISTANCE_F32});
+		ASSERT_EQ(outB.getPointCount(), raysB.size());
+		for (auto&& distance : outB.getFieldValues<DISTANCE_F32>()) {
+			EXPECT_NEAR(distance, CUBE_DISTANCE - CUBE_HALF_EDGE - SENSOR_B_OFFSET, EPSILON);
+		}
+
+		int32_t outCount = 0, outSizeOf = 0;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(mergeNode, XYZ_VEC3_F32, &outCount, &outSizeOf));
+		EXPECT_EQ(outCount, static_cast<int32_t>(raysA.size() + raysB.size()));
+	}
+
+	ASSERT_RGL_SUCCESS(rgl_scene_configure_raytrace_batching(nullptr, false));
+}
+
+TEST_F(RaytraceNodeTest, config_return_mode_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_return_mode(raytraceNode, RGL_RETURN_MODE_FIRST),
+	                            "node != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_return_mode(raytraceNode, static_cast<rgl_return_mode_t>(-1)),
+	                            "return_mode");
+}
+
+TEST_F(RaytraceNodeTest, config_return_mode_dual_first_last)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float EPSILON = 1e-4f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	// The first ray passes through the cube (front and back face), the second one misses it.
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(3 * CUBE_HALF_EDGE, 0, 0).toRGL()};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32, DISTANCE_F32, RETURN_TYPE_U8};
+
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_return_mode(raytraceNode, RGL_RETURN_MODE_DUAL_FIRST_LAST));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	// Return-major order: first returns of all rays, then last returns of all rays.
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), 2 * rays.size());
+	auto outIsHits = outPointCloud.getFieldValues<IS_HIT_I32>();
+	auto outDistances = outPointCloud.getFieldValues<DISTANCE_F32>();
+	auto outReturnTypes = outPointCloud.getFieldValues<RETURN_TYPE_U8>();
+
+	EXPECT_EQ(outIsHits.at(0), 1);
+	EXPECT_NEAR(outDistances.at(0), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+	EXPECT_EQ(outReturnTypes.at(0), RGL_RETURN_TYPE_FIRST);
+	EXPECT_EQ(outIsHits.at(1), 0);
+	EXPECT_EQ(outReturnTypes.at(1), RGL_RETURN_TYPE_FIRST);
+
+	EXPECT_EQ(outIsHits.at(2), 1);
+	EXPECT_NEAR(outDistances.at(2), CUBE_DISTANCE + CUBE_HALF_EDGE, EPSILON);
+	EXPECT_EQ(outReturnTypes.at(2), RGL_RETURN_TYPE_LAST);
+	EXPECT_EQ(outIsHits.at(3), 0);
+	EXPECT_EQ(outReturnTypes.at(3), RGL_RETURN_TYPE_LAST);
+}
+
+TEST_F(RaytraceNodeTest, config_beam_divergence_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_beam_divergence(raytraceNode, 0.0f, 1, RGL_BEAM_REDUCTION_NEAREST),
+	                            "node != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_beam_divergence(raytraceNode, -1.0f, 1, RGL_BEAM_REDUCTION_NEAREST),
+	                            "divergence_angle");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_beam_divergence(raytraceNode, 0.1f, 0, RGL_BEAM_REDUCTION_NEAREST),
+	                            "sample_count > 0");
+}
+
+TEST_F(RaytraceNodeTest, config_beam_divergence_invalid_pipeline_dual_return)
+{
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	rgl_node_t raysNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_beam_divergence(raytraceNode, 0.01f, 4, RGL_BEAM_REDUCTION_NEAREST));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_return_mode(raytraceNode, RGL_RETURN_MODE_DUAL_FIRST_LAST));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(raysNode), "beam divergence");
+}
+
+TEST_F(RaytraceNodeTest, config_beam_divergence_should_hit_edge_missed_by_central_ray)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float EDGE_MARGIN = 0.05f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	// The ray passes just beside the cube; some sub-rays of a 0.1 rad beam hit its front face.
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::translation(CUBE_HALF_EDGE + EDGE_MARGIN, 0, 0).toRGL()};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32, DISTANCE_F32};
+
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	EXPECT_EQ(TestPointCloud::createFromNode(yieldNode, outFields).getFieldValues<IS_HIT_I32>().at(0), 0);
+
+	for (auto reduction : {RGL_BEAM_REDUCTION_NEAREST, RGL_BEAM_REDUCTION_MEAN, RGL_BEAM_REDUCTION_STRONGEST}) {
+		ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_beam_divergence(raytraceNode, 0.1f, 16, reduction));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+		TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+		ASSERT_EQ(outPointCloud.getPointCount(), rays.size());
+		EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(0), 1);
+		EXPECT_NEAR(outPointCloud.getFieldValues<DISTANCE_F32>().at(0), CUBE_DISTANCE - CUBE_HALF_EDGE, 0.01f);
+	}
+}
+
+TEST_F(RaytraceNodeTest, config_noise_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, 0.0f, 0.0f),
+	                            "node != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, -1.0f, RGL_AXIS_X, 0.0f, 0.0f, 0.0f),
+	                            "angular_st_dev >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, 0.0f, static_cast<rgl_axis_t>(4), 0.0f, 0.0f, 0.0f),
+	    "angular_axis");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, -1.0f, 0.0f),
+	                            "distance_st_dev_base >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, 0.0f, -1.0f),
+	                            "distance_st_dev_rise_per_meter >= 0");
+}
+
+TEST_F(RaytraceNodeTest, config_noise_distance_mean_should_shift_hits_only)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float DISTANCE_MEAN = 0.25f;
+	constexpr float EPSILON = 1e-4f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	// The first ray hits the cube, the second one misses it.
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(3 * CUBE_HALF_EDGE, 0, 0).toRGL()};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32, DISTANCE_F32};
+
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, 0.0f, RGL_AXIS_X, DISTANCE_MEAN, 0.0f, 0.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), rays.size());
+	auto outIsHits = outPointCloud.getFieldValues<IS_HIT_I32>();
+	auto outDistances = outPointCloud.getFieldValues<DISTANCE_F32>();
+	auto outXyz = outPointCloud.getFieldValues<XYZ_VEC3_F32>();
+
+	EXPECT_EQ(outIsHits.at(0), 1);
+	EXPECT_NEAR(outDistances.at(0), CUBE_DISTANCE - CUBE_HALF_EDGE + DISTANCE_MEAN, EPSILON);
+	EXPECT_NEAR(outXyz.at(0).z(), CUBE_DISTANCE - CUBE_HALF_EDGE + DISTANCE_MEAN, EPSILON);
+	EXPECT_EQ(outIsHits.at(1), 0);
+	EXPECT_TRUE(std::isinf(outDistances.at(1)));
+}
+
+TEST_F(RaytraceNodeTest, config_weather_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_weather(raytraceNode, 0.0f, 0.0f), "node != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_weather(raytraceNode, -1.0f, 0.0f), "extinction_coefficient >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_weather(raytraceNode, 0.0f, -1.0f), "particle_intensity >= 0");
+}
+
+TEST_F(RaytraceNodeTest, config_weather_dense_fog_should_terminate_rays_before_surface)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float EXTINCTION_COEFFICIENT = 10.0f; // Chance of reaching the cube is exp(-45)
+	constexpr float PARTICLE_INTENSITY = 0.5f;
+	constexpr int RAY_COUNT = 100;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	// Rays are identical, but particles are drawn independently per ray.
+	std::vector<rgl_mat3x4f> rays(RAY_COUNT, Mat3x4f::identity().toRGL());
+	std::vector<rgl_field_t> outFields = {IS_HIT_I32, DISTANCE_F32, ENTITY_ID_I32, INTENSITY_F32};
+
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_weather(raytraceNode, EXTINCTION_COEFFICIENT, PARTICLE_INTENSITY));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), rays.size());
+	auto outIsHits = outPointCloud.getFieldValues<IS_HIT_I32>();
+	auto outDistances = outPointCloud.getFieldValues<DISTANCE_F32>();
+	auto outEntityIds = outPointCloud.getFieldValues<ENTITY_ID_I32>();
+	auto outIntensities = outPointCloud.getFieldValues<INTENSITY_F32>();
+
+	for (int i = 0; i < RAY_COUNT; ++i) {
+		EXPECT_EQ(outIsHits.at(i), 1);
+		EXPECT_LT(outDistances.at(i), CUBE_DISTANCE - CUBE_HALF_EDGE);
+		EXPECT_EQ(outEntityIds.at(i), RGL_ENTITY_INVALID_ID);
+		EXPECT_EQ(outIntensities.at(i), PARTICLE_INTENSITY);
+	}
+	// Distances are spread around the mean free path.
+	EXPECT_NE(outDistances.front(), outDistances.back());
+}
+
+TEST_F(RaytraceNodeTest, config_weather_disabled_should_not_impact_hits)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float EPSILON = 1e-4f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	std::vector<rgl_field_t> outFields = {IS_HIT_I32, DISTANCE_F32};
+
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_weather(raytraceNode, 10.0f, 0.5f));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_weather(raytraceNode, 0.0f, 0.5f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(0), 1);
+	EXPECT_NEAR(outPointCloud.getFieldValues<DISTANCE_F32>().at(0), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+}
+
+TEST_F(RaytraceNodeTest, config_multipath_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_multipath(raytraceNode, 1, 1.0f), "node != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_multipath(raytraceNode, -1, 1.0f), "bounce_count");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_multipath(raytraceNode, 4, 1.0f), "bounce_count");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_multipath(raytraceNode, 1, 0.0f), "reflectivity");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_multipath(raytraceNode, 1, 1.5f), "reflectivity");
+}
+
+TEST_F(RaytraceNodeTest, config_multipath_invalid_pipeline_dual_return)
+{
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	rgl_node_t raysNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_multipath(raytraceNode, 1, 1.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_return_mode(raytraceNode, RGL_RETURN_MODE_DUAL_FIRST_LAST));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(raysNode), "multipath");
+}
+
+TEST_F(RaytraceNodeTest, config_multipath_should_report_reflected_surface_along_ray)
+{
+	constexpr float MIRROR_DISTANCE = 5.0f;
+	constexpr float WALL_OFFSET = 5.0f;
+	constexpr float RAY_OFFSET = -0.5f * CUBE_HALF_EDGE;
+	constexpr float WALL_INTENSITY = 100.0f;
+	constexpr float REFLECTIVITY = 0.5f;
+	constexpr float EPSILON = 1e-3f;
+
+	// The cube rotated by 45 degrees reflects the ray (offset from its edge) towards -X, where the wall is.
+	const float mirrorHitZ = MIRROR_DISTANCE - RAY_OFFSET - std::sqrt(2.0f) * CUBE_HALF_EDGE;
+	spawnCubeOnScene(Mat3x4f::TRS({0, 0, MIRROR_DISTANCE}, {0, 45, 0}));
+	rgl_entity_t wall = spawnCubeOnScene(Mat3x4f::translation(-WALL_OFFSET, 0, mirrorHitZ));
+	ASSERT_RGL_SUCCESS(rgl_entity_set_intensity(wall, WALL_INTENSITY));
+	const float pathLength = mirrorHitZ + (WALL_OFFSET - CUBE_HALF_EDGE + RAY_OFFSET);
+
+	// The second ray misses everything.
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::translation(RAY_OFFSET, 0, 0).toRGL(),
+	                                 Mat3x4f::translation(10 * CUBE_HALF_EDGE, 0, 0).toRGL()};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32, DISTANCE_F32, INTENSITY_F32, RETURN_TYPE_U8};
+
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_multipath(raytraceNode, 1, REFLECTIVITY));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	// Return-major order: first returns of all rays, then multipath returns of all rays.
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), 2 * rays.size());
+	auto outXyz = outPointCloud.getFieldValues<XYZ_VEC3_F32>();
+	auto outIsHits = outPointCloud.getFieldValues<IS_HIT_I32>();
+	auto outDistances = outPointCloud.getFieldValues<DISTANCE_F32>();
+	auto outIntensities = outPointCloud.getFieldValues<INTENSITY_F32>();
+	auto outReturnTypes = outPointCloud.getFieldValues<RETURN_TYPE_U8>();
+
+	EXPECT_EQ(outIsHits.at(0), 1);
+	EXPECT_NEAR(outDistances.at(0), mirrorHitZ, EPSILON);
+	EXPECT_EQ(outReturnTypes.at(0), RGL_RETURN_TYPE_FIRST);
+	EXPECT_EQ(outIsHits.at(1), 0);
+
+	EXPECT_EQ(outIsHits.at(2), 1);
+	EXPECT_NEAR(outDistances.at(2), pathLength, EPSILON);
+	EXPECT_NEAR(outXyz.at(2).x(), RAY_OFFSET, EPSILON);
+	EXPECT_NEAR(outXyz.at(2).z(), pathLength, EPSILON);
+	EXPECT_NEAR(outIntensities.at(2), WALL_INTENSITY * REFLECTIVITY, EPSILON);
+	EXPECT_EQ(outReturnTypes.at(2), RGL_RETURN_TYPE_MULTIPATH);
+	EXPECT_EQ(outIsHits.at(3), 0);
+	EXPECT_EQ(outReturnTypes.at(3), RGL_RETURN_TYPE_MULTIPATH);
+}
+
+TEST_F(RaytraceNodeTest, config_visibility_mask_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_visibility_mask(raytraceNode, 0x01), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_visibility_mask(nullptr, 0x01), "entity != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_visibility_mask(raytraceNode, 0), "mask > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_visibility_mask(raytraceNode, 0x100), "mask <= 0xFF");
+	rgl_entity_t entity = spawnCubeOnScene(Mat3x4f::identity());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_visibility_mask(entity, -1), "mask >= 0");
+}
+
+TEST_F(RaytraceNodeTest, config_visibility_mask_should_cull_entities_in_other_layers)
+{
+	constexpr int32_t LIDAR_LAYER = 0x01;
+	constexpr int32_t RADAR_LAYER = 0x02;
+	constexpr float NEAR_DISTANCE = 5.0f;
+	constexpr float FAR_DISTANCE = 10.0f;
+	constexpr float EPSILON = 1e-4f;
+	// Both sensors see the far cube, only the radar sees the near reflector.
+	rgl_entity_t reflector = spawnCubeOnScene(Mat3x4f::translation(0, 0, NEAR_DISTANCE));
+	ASSERT_RGL_SUCCESS(rgl_entity_set_visibility_mask(reflector, RADAR_LAYER));
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, FAR_DISTANCE));
+
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	rgl_node_t raysNode = nullptr, lidarNode = nullptr, radarNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&lidarNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&radarNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_visibility_mask(lidarNode, LIDAR_LAYER));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_visibility_mask(radarNode, RADAR_LAYER | LIDAR_LAYER));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, lidarNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, radarNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	::Field<DISTANCE_F32>::type lidarDistance = 0.0f, radarDistance = 0.0f;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(lidarNode, DISTANCE_F32, &lidarDistance));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(radarNode, DISTANCE_F32, &radarDistance));
+	EXPECT_NEAR(lidarDistance, FAR_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+	EXPECT_NEAR(radarDistance, NEAR_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+}
+
+TEST_F(RaytraceNodeTest, config_culling_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_culling(raytraceNode, 10.0f, 1.0f), "node != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_culling(raytraceNode, -1.0f, 1.0f), "range >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_culling(raytraceNode, 10.0f, -1.0f), "movement_threshold >= 0");
+}
+
+TEST_F(RaytraceNodeTest, config_culling_should_hide_entities_out_of_range)
+{
+	constexpr float NEAR_DISTANCE = 5.0f;
+	constexpr float FAR_DISTANCE = 50.0f;
+	constexpr float CULLING_RANGE = 20.0f;
+	constexpr float MOVEMENT_THRESHOLD = 1.0f;
+	constexpr float EPSILON = 1e-4f;
+	// Rays go along Z (towards the far cube) and along X (towards the near cube).
+	spawnCubeOnScene(Mat3x4f::translation(NEAR_DISTANCE, 0, 0));
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, FAR_DISTANCE));
+
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::rotationDeg(0, 90, 0).toRGL()};
+	std::vector<rgl_field_t> outFields = {IS_HIT_I32, DISTANCE_F32};
+	rgl_node_t raysNode = nullptr, transformNode = nullptr, yieldNode = nullptr;
+	rgl_mat3x4f sensorPose = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_culling(raytraceNode, CULLING_RANGE, MOVEMENT_THRESHOLD));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	auto runAndGetPointCloud = [&]() {
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raysNode));
+		return TestPointCloud::createFromNode(yieldNode, outFields);
+	};
+
+	// The far cube is out of range.
+	TestPointCloud outPointCloud = runAndGetPointCloud();
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(0), 0);
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(1), 1);
+	EXPECT_NEAR(outPointCloud.getFieldValues<DISTANCE_F32>().at(1), NEAR_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+
+	// After moving closer to the far cube, the culled AS is rebuilt; the near cube is now out of range.
+	sensorPose = Mat3x4f::translation(0, 0, FAR_DISTANCE - NEAR_DISTANCE - CULLING_RANGE / 2.0f).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+	outPointCloud = runAndGetPointCloud();
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(0), 1);
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(1), 0);
+
+	// Disabling culling restores the whole scene.
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_culling(raytraceNode, 0.0f, 0.0f));
+	outPointCloud = runAndGetPointCloud();
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(0), 1);
+}
+
+TEST_F(RaytraceNodeTest, compact_fields_should_match_full_precision_fields)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	const Vec3f sensorPosition{0.3f, -0.2f, 0.1f};
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::rotationDeg(5, 0, 0).toRGL(),
+	                                 Mat3x4f::rotationDeg(0, -5, 0).toRGL()};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, DISTANCE_F32, NORMAL_VEC3_F32,
+	                                      XYZ_VEC3_F16, DISTANCE_F16, NORMAL_VEC3_F16, XYZ_VEC3_I16};
+	rgl_node_t raysNode = nullptr, transformNode = nullptr, yieldNode = nullptr;
+	rgl_mat3x4f sensorPose = Mat3x4f::translation(sensorPosition).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	auto halfToFloat = [](uint16_t bits) { return __half2float(__half{__half_raw{bits}}); };
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_EQ(outPointCloud.getPointCount(), rays.size());
+	for (int i = 0; i < outPointCloud.getPointCount(); ++i) {
+		Vec3f xyz = outPointCloud.getFieldValue<XYZ_VEC3_F32>(i);
+		Vec3f normal = outPointCloud.getFieldValue<NORMAL_VEC3_F32>(i);
+		float distance = outPointCloud.getFieldValue<DISTANCE_F32>(i);
+		Vec3u16 xyzHalf = outPointCloud.getFieldValue<XYZ_VEC3_F16>(i);
+		Vec3u16 normalHalf = outPointCloud.getFieldValue<NORMAL_VEC3_F16>(i);
+		Vec3i16 xyzQuantized = outPointCloud.getFieldValue<XYZ_VEC3_I16>(i);
+		// Half-precision has 11 significant bits.
+		EXPECT_NEAR(halfToFloat(outPointCloud.getFieldValue<DISTANCE_F16>(i)), distance, distance / 1024.0f);
+		for (int axis = 0; axis < 3; ++axis) {
+			EXPECT_NEAR(halfToFloat(xyzHalf[axis]), xyz[axis], std::abs(xyz[axis]) / 1024.0f);
+			EXPECT_NEAR(halfToFloat(normalHalf[axis]), normal[axis], 1.0f / 1024.0f);
+			float expectedSteps = std::round((xyz[axis] - sensorPosition[axis]) / RGL_QUANTIZED_XYZ_STEP);
+			EXPECT_NEAR(xyzQuantized[axis], expectedSteps, 1.0f);
+		}
+	}
+}
+
+TEST_F(RaytraceNodeTest, config_incremental_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_incremental(raytraceNode, true), "node != nullptr");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_incremental(raytraceNode, true));
+}
+
+TEST_F(RaytraceNodeTest, config_incremental_should_match_full_trace)
+{
+	constexpr float NEAR_DISTANCE = 5.0f;
+	constexpr float FAR_DISTANCE = 20.0f;
+	rgl_entity_t nearCube = spawnCubeOnScene(Mat3x4f::translation(NEAR_DISTANCE, 0, 0));
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, FAR_DISTANCE));
+
+	// Rays go along Z (towards the far cube), along X (towards the near cube) and along -Z (towards nothing).
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::rotationDeg(0, 90, 0).toRGL(),
+	                                 Mat3x4f::rotationDeg(0, 180, 0).toRGL()};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32, ENTITY_ID_I32};
+	rgl_node_t raysNode = nullptr, transformNode = nullptr, fullNode = nullptr;
+	rgl_node_t yieldNode = nullptr, fullYieldNode = nullptr;
+	rgl_mat3x4f sensorPose = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_incremental(raytraceNode, true));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&fullNode, nullptr));
+	// Non-hits are given finite coordinates to compare them.
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_non_hits(raytraceNode, 0.0f, 100.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_non_hits(fullNode, 0.0f, 100.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&fullYieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	// The full trace runs in a separate graph, so that the incremental node is not batched with it.
+	rgl_node_t fullRaysNode = nullptr, fullTransformNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&fullRaysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&fullTransformNode, &sensorPose));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fullRaysNode, fullTransformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fullTransformNode, fullNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fullNode, fullYieldNode));
+
+	auto expectSameAsFullTrace = [&]() {
+		ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+		ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&fullTransformNode, &sensorPose));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(fullRaysNode));
+		TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+		TestPointCloud expectedPointCloud = TestPointCloud::createFromNode(fullYieldNode, outFields);
+		checkIfNearEqual(expectedPointCloud.getFieldValues<XYZ_VEC3_F32>(), outPointCloud.getFieldValues<XYZ_VEC3_F32>());
+		EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>(), expectedPointCloud.getFieldValues<IS_HIT_I32>());
+		EXPECT_EQ(outPointCloud.getFieldValues<ENTITY_ID_I32>(), expectedPointCloud.getFieldValues<ENTITY_ID_I32>());
+		return outPointCloud;
+	};
+
+	// The first run is traced in full, then only rays reaching changes: the moved cube, a new one and a new sensor pose.
+	expectSameAsFullTrace();
+	expectSameAsFullTrace();
+	rgl_mat3x4f nearCubePose = Mat3x4f::translation(NEAR_DISTANCE + 2.0f, 0, 0).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(nearCube, &nearCubePose));
+	expectSameAsFullTrace();
+	rgl_entity_t backCube = spawnCubeOnScene(Mat3x4f::translation(0, 0, -NEAR_DISTANCE));
+	EXPECT_EQ(expectSameAsFullTrace().getFieldValues<IS_HIT_I32>().at(2), 1);
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(backCube));
+	EXPECT_EQ(expectSameAsFullTrace().getFieldValues<IS_HIT_I32>().at(2), 0);
+	sensorPose = Mat3x4f::translation(0, 0.5f, 0).toRGL();
+	expectSameAsFullTrace();
+}
+
+TEST_F(RaytraceNodeTest, result_cache_should_skip_unchanged_runs)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_configure_result_cache(nullptr, true), "node != nullptr");
+
+	constexpr float CUBE_DISTANCE = 5.0f;
+	rgl_entity_t cube = spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32};
+	rgl_node_t raysNode = nullptr, transformNode = nullptr, yieldNode = nullptr;
+	rgl_mat3x4f sensorPose = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_configure_result_cache(yieldNode, true));
+
+	// Returns whether the run kept the previous output instead of tracing.
+	auto runAndCheck = [&](std::optional<float> expectedHitZ = std::nullopt) {
+		rgl_performance_counters_t before, after;
+		EXPECT_RGL_SUCCESS(rgl_get_performance_counters(&before));
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raysNode));
+		EXPECT_RGL_SUCCESS(rgl_get_performance_counters(&after));
+		TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+		EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>().at(0), 1);
+		if (expectedHitZ.has_value()) {
+			EXPECT_NEAR(outPointCloud.getFieldValues<XYZ_VEC3_F32>().at(0).z(), *expectedHitZ, 1e-4f);
+		}
+		return after.raytrace_cache_hit_count > before.raytrace_cache_hit_count;
+	};
+	const float cubeFaceZ = CUBE_DISTANCE - 1.0f;
+	EXPECT_FALSE(runAndCheck(cubeFaceZ));
+	EXPECT_TRUE(runAndCheck(cubeFaceZ));
+
+	// Any change of the scene or the sensor pose is traced.
+	rgl_mat3x4f cubePose = Mat3x4f::translation(0, 0, CUBE_DISTANCE + 2.0f).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(cube, &cubePose));
+	EXPECT_FALSE(runAndCheck(cubeFaceZ + 2.0f));
+	EXPECT_TRUE(runAndCheck(cubeFaceZ + 2.0f));
+	sensorPose = Mat3x4f::translation(0, 0, 1.0f).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformNode, &sensorPose));
+	EXPECT_FALSE(runAndCheck(cubeFaceZ + 2.0f));
+	EXPECT_TRUE(runAndCheck(cubeFaceZ + 2.0f));
+
+	// Noisy results are never kept.
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, 0.001f, 0.0f));
+	EXPECT_FALSE(runAndCheck());
+	EXPECT_FALSE(runAndCheck());
+	ASSERT_RGL_SUCCESS(rgl_graph_configure_result_cache(raysNode, false));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_noise(raytraceNode, 0.0f, 0.0f, RGL_AXIS_X, 0.0f, 0.0f, 0.0f));
+	EXPECT_FALSE(runAndCheck(cubeFaceZ + 2.0f));
+	EXPECT_FALSE(runAndCheck(cubeFaceZ + 2.0f));
+}
+
+TEST_F(RaytraceNodeTest, config_ray_sorting_should_keep_output_order)
+{
+	// A few rays towards each of the cubes on all sides, interleaved as in scattered patterns.
+	constexpr float CUBE_DISTANCE = 5.0f;
+	const std::vector<Vec3f> directions = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+	for (auto&& direction : directions) {
+		spawnCubeOnScene(Mat3x4f::translation(direction * CUBE_DISTANCE * (1.0f + direction.y() * 0.5f)));
+	}
+	std::vector<rgl_vec3f> rayDirections;
+	for (int i = 0; i < 60; ++i) {
+		Vec3f direction = directions[(i * 7) % directions.size()] + Vec3f{0.01f, 0.02f, 0.03f} * static_cast<float>(i % 5);
+		rayDirections.push_back({direction.x(), direction.y(), direction.z()});
+	}
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, DISTANCE_F32, RAY_IDX_U32};
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, rayDirections.data(), rayDirections.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	TestPointCloud expectedPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_ray_sorting(raytraceNode, true));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+
+	checkIfNearEqual(expectedPointCloud.getFieldValues<XYZ_VEC3_F32>(), outPointCloud.getFieldValues<XYZ_VEC3_F32>());
+	checkIfNearEqual(expectedPointCloud.getFieldValues<DISTANCE_F32>(), outPointCloud.getFieldValues<DISTANCE_F32>());
+	for (int i = 0; i < rayDirections.size(); ++i) {
+		EXPECT_EQ(outPointCloud.getFieldValue<RAY_IDX_U32>(i), i);
+	}
+}
+
+TEST_F(RaytraceNodeTest, config_time_slicing_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_time_slicing(nullptr, 2), "node != nullptr");
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_time_slicing(raytraceNode, 0), "slice_count > 0");
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_time_slicing(raytraceNode, 2));
+}
+
+TEST_F(RaytraceNodeTest, config_time_slicing_should_trace_moving_entities_at_ray_times)
+{
+	// The cube moves 1 m along X between frames 100 ms apart; rays fired later in the sweep see it further away.
+	constexpr float FRAME_TIME_MS = 100.0f;
+	constexpr int RAY_COUNT = 10;
+	rgl_entity_t cube = spawnCubeOnScene(Mat3x4f::translation(10, 0, 0));
+	ASSERT_RGL_SUCCESS(rgl_scene_set_time(nullptr, 0));
+	rgl_mat3x4f cubePose = Mat3x4f::translation(10, 0, 0).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(cube, &cubePose));
+	ASSERT_RGL_SUCCESS(rgl_scene_set_time(nullptr, static_cast<uint64_t>(FRAME_TIME_MS * 1'000'000)));
+	cubePose = Mat3x4f::translation(11, 0, 0).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(cube, &cubePose));
+
+	// Time offsets are shuffled, slices are formed by time anyway.
+	std::vector<rgl_vec3f> rayDirections;
+	std::vector<float> timeOffsets;
+	for (int i = 0; i < RAY_COUNT; ++i) {
+		rayDirections.push_back({1, 0.01f * static_cast<float>(i), 0});
+		timeOffsets.push_back(FRAME_TIME_MS / RAY_COUNT * static_cast<float>((i * 3) % RAY_COUNT));
+	}
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32};
+	rgl_node_t raysNode = nullptr, timeOffsetsNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, rayDirections.data(), rayDirections.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_set_time_offsets(&timeOffsetsNode, timeOffsets.data(), timeOffsets.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, timeOffsetsNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(timeOffsetsNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	// Without slicing, all rays see the cube in its current pose.
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	for (int i = 0; i < RAY_COUNT; ++i) {
+		EXPECT_EQ(outPointCloud.getFieldValue<IS_HIT_I32>(i), 1);
+		EXPECT_NEAR(outPointCloud.getFieldValue<XYZ_VEC3_F32>(i).x(), 10.0f, 1e-4f);
+	}
+
+	// With a slice per ray, each ray sees the cube extrapolated to its time offset.
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_time_slicing(raytraceNode, RAY_COUNT));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	for (int i = 0; i < RAY_COUNT; ++i) {
+		EXPECT_EQ(outPointCloud.getFieldValue<IS_HIT_I32>(i), 1);
+		EXPECT_NEAR(outPointCloud.getFieldValue<XYZ_VEC3_F32>(i).x(), 10.0f + timeOffsets[i] / FRAME_TIME_MS, 1e-4f);
+	}
+}
+
+TEST_F(RaytraceNodeTest, config_streaming_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_streaming(nullptr, 2), "node != nullptr");
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_streaming(raytraceNode, 0), "chunk_count > 0");
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_streaming(raytraceNode, 2));
+
+	void* event = nullptr;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_chunk(nullptr, 0, nullptr, nullptr, &event), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_chunk(raytraceNode, -1, nullptr, nullptr, &event), "chunk_index >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_chunk(raytraceNode, 0, nullptr, nullptr, nullptr), "out_event != nullptr");
+}
+
+TEST_F(RaytraceNodeTest, config_streaming_should_match_full_trace)
+{
+	constexpr int WIDTH = 10, HEIGHT = 3, CHUNK_COUNT = 4;
+	spawnCubeOnScene(Mat3x4f::translation(5, 0, 0));
+	std::vector<rgl_vec3f> rayDirections;
+	for (int row = 0; row < HEIGHT; ++row) {
+		for (int column = 0; column < WIDTH; ++column) {
+			rayDirections.push_back({1, 0.1f * static_cast<float>(column - WIDTH / 2), 0.1f * static_cast<float>(row)});
+		}
+	}
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32, DISTANCE_F32};
+	rgl_node_t raysNode = nullptr, layoutNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, rayDirections.data(), rayDirections.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_set_layout(&layoutNode, WIDTH, HEIGHT));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, layoutNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(layoutNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	TestPointCloud expectedPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	void* event = nullptr;
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_get_result_chunk(raytraceNode, 0, nullptr, nullptr, &event), "does not stream");
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_streaming(raytraceNode, CHUNK_COUNT));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	// Chunks cover all columns in order.
+	int32_t nextColumn = 0;
+	for (int chunkIdx = 0; chunkIdx < CHUNK_COUNT; ++chunkIdx) {
+		int32_t columnBegin = -1, columnCount = 0;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_chunk(raytraceNode, chunkIdx, &columnBegin, &columnCount, &event));
+		ASSERT_EQ(cudaEventSynchronize(static_cast<cudaEvent_t>(event)), cudaSuccess);
+		EXPECT_EQ(columnBegin, nextColumn);
+		EXPECT_GT(columnCount, 0);
+		nextColumn += columnCount;
+	}
+	EXPECT_EQ(nextColumn, WIDTH);
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_get_result_chunk(raytraceNode, CHUNK_COUNT, nullptr, nullptr, &event),
+	                            "has 4 chunks");
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	checkIfNearEqual(expectedPointCloud.getFieldValues<XYZ_VEC3_F32>(), outPointCloud.getFieldValues<XYZ_VEC3_F32>());
+	checkIfNearEqual(expectedPointCloud.getFieldValues<DISTANCE_F32>(), outPointCloud.getFieldValues<DISTANCE_F32>());
+	EXPECT_EQ(expectedPointCloud.getFieldValues<IS_HIT_I32>(), outPointCloud.getFieldValues<IS_HIT_I32>());
+
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_dense_output(raytraceNode, true));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(raysNode), "not supported with dense output");
+}
+
+TEST_F(RaytraceNodeTest, config_ray_skipping_invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_ray_skipping(nullptr, 2, 10), "node != nullptr");
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_ray_skipping(raytraceNode, -1, 10), "miss_frame_count >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_ray_skipping(raytraceNode, 256, 10), "miss_frame_count <=");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_ray_skipping(raytraceNode, 2, 0), "probe_period > 0");
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_ray_skipping(raytraceNode, 2, 10));
+}
+
+TEST_F(RaytraceNodeTest, config_ray_skipping_should_probe_skipped_rays)
+{
+	// Rays towards +X hit the cube, rays towards -X miss until the cube is moved there.
+	constexpr int MISS_FRAME_COUNT = 2;
+	constexpr int PROBE_PERIOD = 4;
+	rgl_entity_t cube = spawnCubeOnScene(Mat3x4f::translation(5, 0, 0));
+	std::vector<rgl_vec3f> rayDirections;
+	for (int i = 0; i < 20; ++i) {
+		float offset = 0.01f * static_cast<float>(i);
+		rayDirections.push_back(i % 2 == 0 ? rgl_vec3f{1, offset, 0} : rgl_vec3f{-1, offset, 0});
+	}
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32};
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, rayDirections.data(), rayDirections.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_ray_skipping(raytraceNode, MISS_FRAME_COUNT, PROBE_PERIOD));
+
+	auto runAndGetHits = [&]() {
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raysNode));
+		return TestPointCloud::createFromNode(yieldNode, outFields).getFieldValues<IS_HIT_I32>();
+	};
+	for (int run = 0; run < MISS_FRAME_COUNT + 1; ++run) {
+		auto isHit = runAndGetHits();
+		for (int i = 0; i < rayDirections.size(); ++i) {
+			EXPECT_EQ(isHit[i], i % 2 == 0 ? 1 : 0);
+		}
+	}
+
+	// Skipped rays find the cube only when probed; within a probe period, each of them is probed and then traced again.
+	rgl_mat3x4f cubePose = Mat3x4f::translation(-5, 0, 0).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(cube, &cubePose));
+	auto isHit = runAndGetHits();
+	int probedHitCount = 0;
+	for (int i = 0; i < rayDirections.size(); ++i) {
+		probedHitCount += isHit[i];
+	}
+	EXPECT_LT(probedHitCount, rayDirections.size() / 2);
+	for (int run = 1; run < PROBE_PERIOD; ++run) {
+		isHit = runAndGetHits();
+	}
+	for (int i = 0; i < rayDirections.size(); ++i) {
+		EXPECT_EQ(isHit[i], i % 2 == 0 ? 0 : 1);
+	}
+}
+
+TEST_F(RaytraceNodeTest, config_dense_output_should_output_only_hits)
+{
+	// Every other ray hits the cube in front of the sensor, the rest go away from it.
+	constexpr float CUBE_DISTANCE = 5.0f;
+	spawnCubeOnScene(Mat3x4f::translation(CUBE_DISTANCE, 0, 0));
+	std::vector<rgl_vec3f> rayDirections;
+	for (int i = 0; i < 40; ++i) {
+		float offset = 0.01f * static_cast<float>(i);
+		rayDirections.push_back(i % 2 == 0 ? rgl_vec3f{1, offset, -offset} : rgl_vec3f{-1, offset, offset});
+	}
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, IS_HIT_I32, DISTANCE_F32, RAY_IDX_U32};
+	rgl_node_t raysNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, rayDirections.data(), rayDirections.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	TestPointCloud fullPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_dense_output(raytraceNode, true));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	TestPointCloud densePointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+
+	ASSERT_EQ(densePointCloud.getPointCount(), rayDirections.size() / 2);
+	std::vector<bool> isRayOutput(rayDirections.size(), false);
+	for (int i = 0; i < densePointCloud.getPointCount(); ++i) {
+		uint32_t rayIdx = densePointCloud.getFieldValue<RAY_IDX_U32>(i);
+		ASSERT_LT(rayIdx, rayDirections.size());
+		EXPECT_FALSE(isRayOutput[rayIdx]);
+		isRayOutput[rayIdx] = true;
+		EXPECT_EQ(densePointCloud.getFieldValue<IS_HIT_I32>(i), 1);
+		EXPECT_EQ(fullPointCloud.getFieldValue<IS_HIT_I32>(rayIdx), 1);
+		EXPECT_NEAR(densePointCloud.getFieldValue<DISTANCE_F32>(i), fullPointCloud.getFieldValue<DISTANCE_F32>(rayIdx),
+		            EPSILON_F);
+	}
+}
+
+TEST_F(RaytraceNodeTest, config_dense_output_should_require_first_return_mode)
+{
+	spawnCubeOnScene(Mat3x4f::identity());
+	const rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	rgl_node_t raysNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_dense_output(raytraceNode, true));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_return_mode(raytraceNode, RGL_RETURN_MODE_DUAL_FIRST_LAST));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(raysNode), "first return mode only");
+}
+
+TEST_F(RaytraceNodeTest, config_fused_format_should_match_formatting)
+{
+	spawnCubeOnScene(Mat3x4f::translation(5.0f, 0, 0));
+	std::vector<rgl_vec3f> rayDirections;
+	for (int i = 0; i < 40; ++i) {
+		float offset = 0.01f * static_cast<float>(i);
+		rayDirections.push_back(i % 2 == 0 ? rgl_vec3f{1, offset, -offset} : rgl_vec3f{-1, offset, offset});
+	}
+	// Unaligned layout, with padding (not initialized by formatting, so compared without it).
+	std::vector<rgl_field_t> fields = {IS_HIT_I32, RETURN_TYPE_U8, XYZ_VEC3_F32, PADDING_16, DISTANCE_F32, RAY_IDX_U32};
+	rgl_node_t raysNode = nullptr, formatNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, rayDirections.data(), rayDirections.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_non_hits(raytraceNode, 0.0f, 100.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, formatNode));
+
+	auto runAndGetFormatted = [&]() {
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raysNode));
+		int32_t outCount = 0, outSize = 0;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_size(formatNode, RGL_FIELD_DYNAMIC_FORMAT, &outCount, &outSize));
+		EXPECT_EQ(outSize, getPointSize(fields));
+		std::vector<char> formatted(outCount * outSize);
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(formatNode, RGL_FIELD_DYNAMIC_FORMAT, formatted.data()));
+		for (int i = 0; i < outCount; ++i) {
+			std::memset(formatted.data() + i * outSize + getPointSize({IS_HIT_I32, RETURN_TYPE_U8, XYZ_VEC3_F32}), 0,
+			            getFieldSize(PADDING_16));
+		}
+		return formatted;
+	};
+
+	std::vector<char> expected = runAndGetFormatted();
+	ASSERT_EQ(expected.size(), rayDirections.size() * getPointSize(fields));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_fused_format(raytraceNode, true));
+	EXPECT_EQ(runAndGetFormatted(), expected);
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_dense_output(raytraceNode, true));
+	EXPECT_EQ(runAndGetFormatted().size(), expected.size() / 2);
+}
+
+TEST_F(RaytraceNodeTest, config_output_frame_invalid_arguments)
+{
+	const rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_output_frame(nullptr, RGL_OUTPUT_FRAME_SENSOR, &identity),
+	                            "node != nullptr");
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_output_frame(raytraceNode, (rgl_output_frame_t) 2, &identity),
+	                            "frame");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_raytrace_configure_output_frame(raytraceNode, RGL_OUTPUT_FRAME_SENSOR, nullptr),
+	                            "transform != nullptr");
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_output_frame(raytraceNode, RGL_OUTPUT_FRAME_SENSOR, &identity));
+}
+
+TEST_F(RaytraceNodeTest, config_output_frame_should_match_transformed_points)
+{
+	// A cube hit by half of the rays of a moved and rotated sensor; the other half uses finite non-hit distance.
+	spawnCubeOnScene(Mat3x4f::translation(5.0f, 2.0f, 1.0f));
+	const Mat3x4f sensorPose = Mat3x4f::TRS({0.0f, 2.0f, 1.0f}, {0.0f, 90.0f, 0.0f});
+	const Mat3x4f sensorToOutput = Mat3x4f::TRS({0.5f, 0.0f, 0.0f}, {30.0f, 0.0f, 0.0f});
+	std::vector<rgl_vec3f> rayDirections;
+	for (int i = 0; i < 40; ++i) {
+		float offset = 0.01f * static_cast<float>(i);
+		rayDirections.push_back(i % 2 == 0 ? rgl_vec3f{offset, -offset, 1} : rgl_vec3f{offset, offset, -1});
+	}
+	const rgl_mat3x4f sensorPoseRGL = sensorPose.toRGL();
+	const rgl_mat3x4f identityRGL = Mat3x4f::identity().toRGL();
+	const rgl_mat3x4f sensorToOutputRGL = sensorToOutput.toRGL();
+	const rgl_mat3x4f worldToOutputRGL = (sensorToOutput * sensorPose.inverse()).toRGL();
+	std::vector<rgl_field_t> outFields = {XYZ_VEC3_F32, NORMAL_VEC3_F32, IS_HIT_I32};
+	rgl_node_t raysNode = nullptr, raysTransformNode = nullptr, transformNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_directions(&raysNode, rayDirections.data(), rayDirections.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&raysTransformNode, &sensorPoseRGL));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_non_hits(raytraceNode, 0.0f, 20.0f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transformNode, &worldToOutputRGL));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, outFields.data(), outFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raysTransformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysTransformNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, yieldNode));
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+	TestPointCloud expectedPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+	ASSERT_EQ(expectedPointCloud.getPointCount(), rayDirections.size());
+
+	// Transforming the output in RaytraceNode instead, given either relative to the sensor or to the world.
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transformNode, &identityRGL));
+	for (auto&& [frame, transform] : {std::pair{RGL_OUTPUT_FRAME_SENSOR, &sensorToOutputRGL},
+	                                  std::pair{RGL_OUTPUT_FRAME_WORLD, &worldToOutputRGL}}) {
+		ASSERT_RGL_SUCCESS(rgl_node_raytrace_configure_output_frame(raytraceNode, frame, transform));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+		TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, outFields);
+		EXPECT_EQ(expectedPointCloud.getFieldValues<IS_HIT_I32>(), outPointCloud.getFieldValues<IS_HIT_I32>());
+		checkIfNearEqual(expectedPointCloud.getFieldValues<XYZ_VEC3_F32>(), outPointCloud.getFieldValues<XYZ_VEC3_F32>(),
+		                 1e-4f);
+		// TransformPointsNode does not transform normals.
+		for (int i = 0; i < rayDirections.size(); i += 2) {
+			Vec3f expectedNormal = Mat3x4f::fromRGL(worldToOutputRGL).rotation() *
+			                       expectedPointCloud.getFieldValue<NORMAL_VEC3_F32>(i);
+			Vec3f outNormal = outPointCloud.getFieldValue<NORMAL_VEC3_F32>(i);
+			for (int axis = 0; axis < 3; ++axis) {
+				EXPECT_NEAR(outNormal[axis], expectedNormal[axis], 1e-5f);
+			}
+		}
+	}
+}
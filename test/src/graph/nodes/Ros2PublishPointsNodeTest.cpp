@@ -3,12 +3,63 @@
 #include <helpers/testPointCloud.hpp>
 
 #include <rgl/api/extensions/ros2.h>
+#include <rgl/api/extensions/ros2_device_point_cloud.hpp>
 
 #include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
 
 class Ros2PublishPointsNodeTest : public RGLTest
 {};
 
+TEST_F(Ros2PublishPointsNodeTest, should_receive_sent_data)
+{
+	const auto POINT_COUNT = 5;
+	const auto TOPIC_NAME = "rgl_test_pointcloud";
+	const auto FRAME_ID = "rgl_test_frame_id";
+	const auto NODE_NAME = "rgl_test_node";
+	const auto WAIT_TIME_SECS = 1;
+	const auto MESSAGE_REPEATS = 3;
+	std::vector<rgl_field_t> fields{XYZ_VEC3_F32};
+	TestPointCloud input(fields, POINT_COUNT);
+
+	// Create nodes
+	rgl_node_t inputNode = input.createUsePointsNode(), format = nullptr, ros2pub = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&format, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_ros2_publish(&ros2pub, TOPIC_NAME, FRAME_ID));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(inputNode, format));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(format, ros2pub));
+
+	// Messages are published asynchronously, so the subscriber must receive every one of them after the runs.
+	std::atomic<int> messageCount = 0;
+	auto node = std::make_shared<rclcpp::Node>(NODE_NAME, rclcpp::NodeOptions{});
+	auto subscriber = node->create_subscription<sensor_msgs::msg::PointCloud2>(
+	    TOPIC_NAME, rclcpp::QoS(10), [&](const sensor_msgs::msg::PointCloud2::ConstSharedPtr msg) {
+		    EXPECT_EQ(msg->width * msg->height, POINT_COUNT);
+		    EXPECT_EQ(msg->header.frame_id, FRAME_ID);
+		    ASSERT_EQ(msg->data.size(), POINT_COUNT * sizeof(Field<XYZ_VEC3_F32>::type));
+		    for (int i = 0; i < POINT_COUNT; ++i) {
+			    Field<XYZ_VEC3_F32>::type point;
+			    std::memcpy(&point, msg->data.data() + i * sizeof(point), sizeof(point));
+			    EXPECT_EQ(point.x(), input.getFieldValue<XYZ_VEC3_F32>(i).x());
+			    EXPECT_EQ(point.y(), input.getFieldValue<XYZ_VEC3_F32>(i).y());
+			    EXPECT_EQ(point.z(), input.getFieldValue<XYZ_VEC3_F32>(i).z());
+		    }
+		    ++messageCount;
+	    });
+
+	for (int i = 0; i < MESSAGE_REPEATS; ++i) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(inputNode));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	do {
+		rclcpp::spin_some(node);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	} while (messageCount != MESSAGE_REPEATS &&
+	         std::chrono::steady_clock::now() - start < std::chrono::seconds(WAIT_TIME_SECS));
+	ASSERT_EQ(messageCount, MESSAGE_REPEATS);
+}
+
 TEST_F(Ros2PublishPointsNodeTest, should_throw_invalid_pipeline_when_ros2_shutdown)
 {
 	std::vector<rgl_field_t> fields{XYZ_VEC3_F32};
@@ -82,4 +133,80 @@ TEST_F(Ros2PublishPointsNodeTest, should_throw_invalid_pipeline_when_no_formatte
 	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(points, ros2pubWithQos));
 
 	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(ros2pubWithQos), "requires a formatted point cloud");
-}
\ No newline at end of file
+}
+
+TEST_F(Ros2PublishPointsNodeTest, should_receive_device_data_intra_process)
+{
+	const auto POINT_COUNT = 5;
+	const auto TOPIC_NAME = "rgl_test_device_pointcloud";
+	const auto FRAME_ID = "rgl_test_frame_id";
+	const auto NODE_NAME = "rgl_test_device_node";
+	const auto WAIT_TIME_SECS = 1;
+	std::vector<rgl_field_t> fields{XYZ_VEC3_F32};
+	TestPointCloud input(fields, POINT_COUNT);
+
+	rgl_node_t inputNode = input.createUsePointsNode(), format = nullptr, ros2pub = nullptr;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_ros2_publish_device(&ros2pub, TOPIC_NAME, FRAME_ID,
+	                                                                QOS_POLICY_RELIABILITY_RELIABLE,
+	                                                                QOS_POLICY_DURABILITY_TRANSIENT_LOCAL,
+	                                                                QOS_POLICY_HISTORY_KEEP_LAST, 10),
+	                            "volatile durability");
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&format, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_ros2_publish_device(&ros2pub, TOPIC_NAME, FRAME_ID, QOS_POLICY_RELIABILITY_RELIABLE,
+	                                                       QOS_POLICY_DURABILITY_VOLATILE, QOS_POLICY_HISTORY_KEEP_LAST, 10));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(inputNode, format));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(format, ros2pub));
+
+	std::atomic<int> messageCount = 0;
+	auto node = std::make_shared<rclcpp::Node>(NODE_NAME, rclcpp::NodeOptions{}.use_intra_process_comms(true));
+	using AdaptedType = rclcpp::TypeAdapter<rgl::Ros2DevicePointCloud, sensor_msgs::msg::PointCloud2>;
+	auto subscriber = node->create_subscription<AdaptedType>(
+	    TOPIC_NAME, rclcpp::QoS(10), [&](const rgl::Ros2DevicePointCloud& msg) {
+		    EXPECT_EQ(msg.description.width * msg.description.height, POINT_COUNT);
+		    EXPECT_EQ(msg.description.header.frame_id, FRAME_ID);
+		    EXPECT_TRUE(msg.description.data.empty());
+		    ASSERT_EQ(msg.getDataSize(), POINT_COUNT * sizeof(Field<XYZ_VEC3_F32>::type));
+		    std::vector<Field<XYZ_VEC3_F32>::type> points(POINT_COUNT);
+		    ASSERT_EQ(cudaEventSynchronize(msg.dataReady), cudaSuccess);
+		    ASSERT_EQ(cudaMemcpy(points.data(), msg.deviceData, msg.getDataSize(), cudaMemcpyDeviceToHost), cudaSuccess);
+		    for (int i = 0; i < POINT_COUNT; ++i) {
+			    EXPECT_EQ(points[i].x(), input.getFieldValue<XYZ_VEC3_F32>(i).x());
+			    EXPECT_EQ(points[i].y(), input.getFieldValue<XYZ_VEC3_F32>(i).y());
+			    EXPECT_EQ(points[i].z(), input.getFieldValue<XYZ_VEC3_F32>(i).z());
+		    }
+		    ++messageCount;
+	    });
+
+	ASSERT_RGL_SUCCESS(rgl_graph_run(inputNode));
+
+	auto start = std::chrono::steady_clock::now();
+	do {
+		rclcpp::spin_some(node);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	} while (messageCount == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(WAIT_TIME_SECS));
+	ASSERT_EQ(messageCount, 1);
+}
+
+TEST_F(Ros2PublishPointsNodeTest, configure_ros2_when_no_ros2_node_exists)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_ros2(false, -1), "executor_thread_count >= 0");
+
+	rgl_node_t ros2pub = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_ros2_publish(&ros2pub, "pointcloud", "rglFrame"));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_ros2(true, 2), "no ROS2 node exists");
+	ASSERT_RGL_SUCCESS(rgl_graph_destroy(ros2pub));
+
+	// The node of RGL is created again with the configuration, then spun in its own threads.
+	ASSERT_RGL_SUCCESS(rgl_configure_ros2(true, 2));
+	std::vector<rgl_field_t> fields{XYZ_VEC3_F32};
+	TestPointCloud pointCloud(fields, 10);
+	rgl_node_t points = pointCloud.createUsePointsNode(), format = nullptr;
+	ros2pub = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&format, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_ros2_publish(&ros2pub, "pointcloud", "rglFrame"));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(points, format));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(format, ros2pub));
+	EXPECT_RGL_SUCCESS(rgl_graph_run(points));
+	ASSERT_RGL_SUCCESS(rgl_graph_destroy(points));
+	EXPECT_RGL_SUCCESS(rgl_configure_ros2(false, 0));
+}
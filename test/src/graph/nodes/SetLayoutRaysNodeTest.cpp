@@ -0,0 +1,83 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+
+class SetLayoutRaysNodeTest : public RGLTest
+{
+protected:
+	static constexpr int WIDTH = 4;
+	static constexpr int HEIGHT = 3;
+
+	rgl_node_t setLayoutNode = nullptr, raysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays;
+
+	// Rays in row-major order, x and y translation are column and row indices respectively.
+	void initializeRays(int width, int height)
+	{
+		rays.clear();
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				rays.emplace_back(Mat3x4f::translation(static_cast<float>(x) * 0.1f, static_cast<float>(y) * 0.1f, 0).toRGL());
+			}
+		}
+	}
+};
+
+TEST_F(SetLayoutRaysNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_rays_set_layout(nullptr, WIDTH, HEIGHT), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_rays_set_layout(&setLayoutNode, 0, HEIGHT), "width > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_rays_set_layout(&setLayoutNode, WIDTH, 0), "height > 0");
+}
+
+TEST_F(SetLayoutRaysNodeTest, valid_arguments)
+{
+	ASSERT_RGL_SUCCESS(rgl_node_rays_set_layout(&setLayoutNode, WIDTH, HEIGHT));
+	EXPECT_THAT(setLayoutNode, testing::NotNull());
+
+	// If (*setLayoutNode) != nullptr
+	EXPECT_RGL_SUCCESS(rgl_node_rays_set_layout(&setLayoutNode, WIDTH, HEIGHT));
+}
+
+TEST_F(SetLayoutRaysNodeTest, invalid_pipeline_layout_does_not_match_ray_count)
+{
+	initializeRays(WIDTH, HEIGHT);
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_set_layout(&setLayoutNode, WIDTH + 1, HEIGHT));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, setLayoutNode));
+
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(setLayoutNode), "layout doesn't match number of rays");
+}
+
+TEST_F(SetLayoutRaysNodeTest, raytrace_outputs_organized_point_cloud)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	initializeRays(WIDTH, HEIGHT);
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, DISTANCE_F32};
+	rgl_node_t yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_set_layout(&setLayoutNode, WIDTH, HEIGHT));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, setLayoutNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(setLayoutNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, fields);
+	ASSERT_EQ(outPointCloud.getPointCount(), WIDTH * HEIGHT);
+
+	// Points must be in the same (row-major) order as rays.
+	auto outPoints = outPointCloud.getFieldValues<XYZ_VEC3_F32>();
+	auto outDistances = outPointCloud.getFieldValues<DISTANCE_F32>();
+	for (int i = 0; i < WIDTH * HEIGHT; ++i) {
+		Vec3f rayOrigin = Mat3x4f::fromRGL(rays[i]).translation();
+		EXPECT_NEAR(outPoints[i].x(), rayOrigin.x(), 1e-4f);
+		EXPECT_NEAR(outPoints[i].y(), rayOrigin.y(), 1e-4f);
+		EXPECT_NEAR(outDistances[i], CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	}
+}
@@ -0,0 +1,144 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class ShmPublishPointsNodeTest : public RGLTest
+{
+protected:
+	static constexpr const char* SHM_NAME = "/rgl_shm_publish_test";
+	static constexpr int32_t SLOT_COUNT = 2;
+	static constexpr int64_t SLOT_DATA_SIZE = 4096;
+
+	rgl_node_t shmNode = nullptr;
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, DISTANCE_F32};
+
+	// Maps the shared memory as an out-of-process reader would do.
+	struct Reader
+	{
+		Reader()
+		{
+			int fd = shm_open(SHM_NAME, O_RDONLY, 0);
+			EXPECT_GE(fd, 0);
+			struct stat stats
+			{};
+			fstat(fd, &stats);
+			size = stats.st_size;
+			mapping = static_cast<const char*>(mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0));
+			close(fd);
+		}
+		~Reader() { munmap(const_cast<char*>(mapping), size); }
+
+		const rgl_shm_ring_header_t& ring() const { return *reinterpret_cast<const rgl_shm_ring_header_t*>(mapping); }
+		const rgl_shm_slot_header_t& slot(int32_t idx) const
+		{
+			return reinterpret_cast<const rgl_shm_slot_header_t*>(mapping + sizeof(rgl_shm_ring_header_t))[idx];
+		}
+
+		const char* mapping{nullptr};
+		std::size_t size{0};
+	};
+
+	void runAndWait(rgl_node_t usePointsNode)
+	{
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		int32_t outCount = 0, outSize = 0;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(shmNode, RGL_FIELD_DYNAMIC_FORMAT, &outCount, &outSize));
+	}
+};
+
+TEST_F(ShmPublishPointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_shm_publish(nullptr, SHM_NAME, SLOT_COUNT, SLOT_DATA_SIZE, false),
+	                            "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_shm_publish(&shmNode, nullptr, SLOT_COUNT, SLOT_DATA_SIZE, false),
+	                            "shm_name != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_shm_publish(&shmNode, "no_slash", SLOT_COUNT, SLOT_DATA_SIZE, false),
+	                            "shm_name[0] == '/'");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_shm_publish(&shmNode, SHM_NAME, 0, SLOT_DATA_SIZE, false), "slot_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_shm_publish(&shmNode, SHM_NAME, SLOT_COUNT, 0, false), "slot_data_size > 0");
+	EXPECT_RGL_SUCCESS(rgl_node_points_shm_publish(&shmNode, SHM_NAME, SLOT_COUNT, SLOT_DATA_SIZE, false));
+}
+
+TEST_F(ShmPublishPointsNodeTest, should_require_formatted_input)
+{
+	TestPointCloud inPointCloud(fields, 10);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+	ASSERT_RGL_SUCCESS(rgl_node_points_shm_publish(&shmNode, SHM_NAME, SLOT_COUNT, SLOT_DATA_SIZE, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, shmNode));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(usePointsNode), "requires a formatted point cloud");
+}
+
+TEST_F(ShmPublishPointsNodeTest, should_write_frames_to_consecutive_slots)
+{
+	TestPointCloud inPointCloud(fields, 10);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+	rgl_node_t formatNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_shm_publish(&shmNode, SHM_NAME, SLOT_COUNT, SLOT_DATA_SIZE, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, formatNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(formatNode, shmNode));
+
+	Reader reader;
+	ASSERT_EQ(reader.ring().magic, RGL_SHM_RING_MAGIC);
+	EXPECT_EQ(reader.ring().version, RGL_SHM_RING_VERSION);
+	EXPECT_EQ(reader.ring().slot_count, SLOT_COUNT);
+	EXPECT_EQ(reader.ring().slot_data_size, SLOT_DATA_SIZE);
+	EXPECT_EQ(reader.ring().latest_frame_id, 0);
+
+	for (int frame = 0; frame < 3; ++frame) {
+		runAndWait(usePointsNode);
+		const rgl_shm_slot_header_t& slot = reader.slot(frame % SLOT_COUNT);
+		EXPECT_EQ(reader.ring().latest_frame_id, slot.frame_id);
+		EXPECT_EQ(slot.sequence % 2, 0);
+		EXPECT_EQ(slot.width, 10);
+		EXPECT_EQ(slot.height, 1);
+		EXPECT_EQ(slot.point_size, static_cast<int32_t>(getPointSize(fields)));
+		ASSERT_EQ(slot.field_count, static_cast<int32_t>(fields.size()));
+		EXPECT_TRUE(std::equal(fields.begin(), fields.end(), slot.fields));
+		EXPECT_EQ(slot.has_device_data, 0);
+		EXPECT_EQ(slot.data_offset % 256, 0);
+		ASSERT_LE(slot.data_offset + SLOT_DATA_SIZE, reader.size);
+		EXPECT_EQ(std::memcmp(reader.mapping + slot.data_offset, inPointCloud.getData(), inPointCloud.getPointByteSize() * 10),
+		          0);
+	}
+	// The first slot has been overwritten by the third frame.
+	EXPECT_EQ(reader.slot(0).frame_id, reader.slot(1).frame_id + 1);
+}
+
+TEST_F(ShmPublishPointsNodeTest, should_export_device_buffers)
+{
+	TestPointCloud inPointCloud(fields, 10);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+	rgl_node_t formatNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_shm_publish(&shmNode, SHM_NAME, SLOT_COUNT, SLOT_DATA_SIZE, true));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, formatNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(formatNode, shmNode));
+	runAndWait(usePointsNode);
+
+	// IPC handles cannot be opened in the exporting process, only check that they are provided.
+	Reader reader;
+	const std::vector<char> zeroHandle(RGL_SHM_IPC_HANDLE_SIZE, 0);
+	for (int32_t slotIdx = 0; slotIdx < SLOT_COUNT; ++slotIdx) {
+		EXPECT_EQ(reader.slot(slotIdx).has_device_data, 1);
+		EXPECT_NE(std::memcmp(reader.slot(slotIdx).device_ipc_handle, zeroHandle.data(), zeroHandle.size()), 0);
+	}
+}
+
+TEST_F(ShmPublishPointsNodeTest, should_fail_when_point_cloud_exceeds_slot)
+{
+	TestPointCloud inPointCloud(fields, 1000);
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+	rgl_node_t formatNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_format(&formatNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_shm_publish(&shmNode, SHM_NAME, SLOT_COUNT, SLOT_DATA_SIZE, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, formatNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(formatNode, shmNode));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(usePointsNode), "does not fit in the slot");
+}
@@ -0,0 +1,60 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+
+class SortPointsNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t sortNode = nullptr;
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, IS_HIT_I32, AZIMUTH_F32, TIME_STAMP_F64, RAY_IDX_U32};
+};
+
+TEST_F(SortPointsNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_sort(nullptr, AZIMUTH_F32, false), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_sort(&sortNode, XYZ_VEC3_F32, false), "isScalar(key_field)");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_sort(&sortNode, RGL_FIELD_DYNAMIC_FORMAT, false), "isScalar(key_field)");
+	EXPECT_RGL_SUCCESS(rgl_node_points_sort(&sortNode, AZIMUTH_F32, false));
+}
+
+TEST_F(SortPointsNodeTest, should_sort_stably_by_key_field)
+{
+	TestPointCloud inPointCloud(fields, 5);
+	inPointCloud.setFieldValues<AZIMUTH_F32>({0.5f, -1.0f, 0.5f, -0.0f, -2.0f});
+	inPointCloud.setFieldValues<TIME_STAMP_F64>({1e-3, 5e-4, 0.0, 1e-3, 2e-3});
+	inPointCloud.setFieldValues<RAY_IDX_U32>({0, 1, 2, 3, 4});
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_sort(&sortNode, AZIMUTH_F32, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, sortNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(sortNode, fields);
+	EXPECT_EQ(outPointCloud.getFieldValues<RAY_IDX_U32>(), std::vector<Field<RAY_IDX_U32>::type>({4, 1, 3, 0, 2}));
+	EXPECT_EQ(outPointCloud.getFieldValues<TIME_STAMP_F64>(),
+	          std::vector<Field<TIME_STAMP_F64>::type>({2e-3, 5e-4, 1e-3, 1e-3, 0.0}));
+
+	ASSERT_RGL_SUCCESS(rgl_node_points_sort(&sortNode, TIME_STAMP_F64, true));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	outPointCloud = TestPointCloud::createFromNode(sortNode, fields);
+	EXPECT_EQ(outPointCloud.getFieldValues<RAY_IDX_U32>(), std::vector<Field<RAY_IDX_U32>::type>({4, 0, 3, 1, 2}));
+}
+
+TEST_F(SortPointsNodeTest, should_restore_order_after_compaction)
+{
+	TestPointCloud inPointCloud(fields, 6);
+	inPointCloud.setFieldValues<IS_HIT_I32>({1, 0, 1, 1, 0, 1});
+	inPointCloud.setFieldValues<RAY_IDX_U32>({5, 4, 3, 2, 1, 0});
+	rgl_node_t usePointsNode = inPointCloud.createUsePointsNode();
+
+	rgl_node_t compactNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compactNode, IS_HIT_I32));
+	ASSERT_RGL_SUCCESS(rgl_node_points_sort(&sortNode, RAY_IDX_U32, false));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, compactNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(compactNode, sortNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(sortNode, fields);
+	EXPECT_EQ(outPointCloud.getFieldValues<RAY_IDX_U32>(), std::vector<Field<RAY_IDX_U32>::type>({0, 2, 3, 5}));
+	EXPECT_EQ(outPointCloud.getFieldValues<IS_HIT_I32>(), std::vector<Field<IS_HIT_I32>::type>({1, 1, 1, 1}));
+}
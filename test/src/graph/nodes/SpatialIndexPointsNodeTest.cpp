@@ -0,0 +1,102 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <RGLFields.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+class SpatialIndexPointsNodeTest : public RGLTest
+{
+protected:
+	rgl_node_t spatialIndexNode = nullptr;
+
+	// Points of a 10x10x10 grid with 1 m spacing; the point (x, y, z) has index 100x + 10y + z.
+	void runOnGrid(float cellSize)
+	{
+		std::vector<Field<XYZ_VEC3_F32>::type> points;
+		for (int x = 0; x < 10; ++x) {
+			for (int y = 0; y < 10; ++y) {
+				for (int z = 0; z < 10; ++z) {
+					points.emplace_back(x, y, z);
+				}
+			}
+		}
+		pointCloud = std::make_unique<TestPointCloud>(std::vector<rgl_field_t>{XYZ_VEC3_F32}, points.size());
+		pointCloud->setFieldValues<XYZ_VEC3_F32>(points);
+		rgl_node_t usePointsNode = pointCloud->createUsePointsNode();
+		ASSERT_RGL_SUCCESS(rgl_node_points_spatial_index(&spatialIndexNode, cellSize));
+		ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, spatialIndexNode));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+	}
+
+	std::unique_ptr<TestPointCloud> pointCloud;
+};
+
+TEST_F(SpatialIndexPointsNodeTest, invalid_arguments)
+{
+	rgl_vec3f query = {0.0f, 0.0f, 0.0f};
+	int32_t index = 0, count = 0;
+	float distance = 0.0f;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_spatial_index(nullptr, 1.0f), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_spatial_index(&spatialIndexNode, 0.0f), "cell_size > 0.0f");
+	EXPECT_RGL_SUCCESS(rgl_node_points_spatial_index(&spatialIndexNode, 1.0f));
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_points_spatial_index_query_nearest(spatialIndexNode, &query, 1, 0.0f, &index, &distance),
+	    "max_distance > 0.0f");
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_points_spatial_index_query_radius(spatialIndexNode, &query, 1, 1.0f, 0, &index, &count),
+	    "max_neighbour_count > 0");
+	// Not run yet
+	EXPECT_RGL_INVALID_PIPELINE(
+	    rgl_node_points_spatial_index_query_nearest(spatialIndexNode, &query, 1, 1.0f, &index, &distance),
+	    "it hasn't been run yet");
+}
+
+TEST_F(SpatialIndexPointsNodeTest, should_find_nearest_points)
+{
+	runOnGrid(1.0f);
+	std::vector<rgl_vec3f> queries = {
+	    {2.1f, 3.2f, 4.3f},   // Inside
+	    {-1.5f, 0.0f, 0.0f},  // Outside, within the max distance
+	    {50.0f, 50.0f, 50.0f} // Too far
+	};
+	std::vector<int32_t> indices(queries.size());
+	std::vector<float> distances(queries.size());
+	ASSERT_RGL_SUCCESS(rgl_node_points_spatial_index_query_nearest(spatialIndexNode, queries.data(), queries.size(), 2.0f,
+	                                                               indices.data(), distances.data()));
+	EXPECT_EQ(indices[0], 234);
+	EXPECT_NEAR(distances[0], std::sqrt(0.01f + 0.04f + 0.09f), 1e-5f);
+	EXPECT_EQ(indices[1], 0);
+	EXPECT_FLOAT_EQ(distances[1], 1.5f);
+	EXPECT_EQ(indices[2], -1);
+	EXPECT_TRUE(std::isinf(distances[2]));
+}
+
+TEST_F(SpatialIndexPointsNodeTest, should_find_points_within_radius)
+{
+	runOnGrid(0.5f);
+	constexpr int32_t MAX_NEIGHBOURS = 8;
+	std::vector<rgl_vec3f> queries = {
+	    {5.0f, 5.0f, 5.0f}, // The point and its 6 face neighbours
+	    {0.0f, 0.0f, 0.0f}, // Corner: the point and 3 neighbours
+	};
+	std::vector<int32_t> indices(queries.size() * MAX_NEIGHBOURS);
+	std::vector<int32_t> counts(queries.size());
+	ASSERT_RGL_SUCCESS(rgl_node_points_spatial_index_query_radius(spatialIndexNode, queries.data(), queries.size(), 1.1f,
+	                                                              MAX_NEIGHBOURS, indices.data(), counts.data()));
+	ASSERT_EQ(counts[0], 7);
+	ASSERT_EQ(counts[1], 4);
+	std::vector<int32_t> found0(indices.begin(), indices.begin() + counts[0]);
+	std::ranges::sort(found0);
+	EXPECT_EQ(found0, (std::vector<int32_t>{455, 545, 554, 555, 556, 565, 655}));
+	std::vector<int32_t> found1(indices.begin() + MAX_NEIGHBOURS, indices.begin() + MAX_NEIGHBOURS + counts[1]);
+	std::ranges::sort(found1);
+	EXPECT_EQ(found1, (std::vector<int32_t>{0, 1, 10, 100}));
+	EXPECT_EQ(indices[MAX_NEIGHBOURS - 1], -1);
+
+	// Truncated to the limit.
+	ASSERT_RGL_SUCCESS(rgl_node_points_spatial_index_query_radius(spatialIndexNode, queries.data(), 1, 1.1f, 3, indices.data(),
+	                                                              counts.data()));
+	EXPECT_EQ(counts[0], 3);
+}
@@ -133,4 +133,37 @@ TEST_F(SpatialMergePointsNodeTest, spatial_merge_from_raytraces)
 #else
 	RGL_WARN("RGL compiled without PCL extension. Tests will not save PCD!");
 #endif
-}
\ No newline at end of file
+}
+TEST_F(SpatialMergePointsNodeTest, spatial_merge_preserves_input_order)
+{
+	struct Point
+	{
+		float intensity;
+		float azimuth;
+	};
+	std::vector<Point> firstPoints = {{1.0f, 0.1f}, {2.0f, 0.2f}};
+	std::vector<Point> secondPoints = {{3.0f, 0.3f}, {4.0f, 0.4f}, {5.0f, 0.5f}};
+
+	rgl_node_t firstInput = nullptr, secondInput = nullptr;
+	ASSERT_RGL_SUCCESS(
+	    rgl_node_points_from_array(&firstInput, firstPoints.data(), firstPoints.size(), fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(
+	    rgl_node_points_from_array(&secondInput, secondPoints.data(), secondPoints.size(), fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_spatial_merge(&spatialMergePointsNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(firstInput, spatialMergePointsNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(secondInput, spatialMergePointsNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(spatialMergePointsNode));
+
+	std::vector<Point> expected = firstPoints;
+	expected.insert(expected.end(), secondPoints.begin(), secondPoints.end());
+	int32_t outCount = 0, outSizeOf = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(spatialMergePointsNode, RGL_FIELD_INTENSITY_F32, &outCount, &outSizeOf));
+	ASSERT_EQ(outCount, expected.size());
+	std::vector<float> intensities(outCount), azimuths(outCount);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(spatialMergePointsNode, RGL_FIELD_INTENSITY_F32, intensities.data()));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(spatialMergePointsNode, RGL_FIELD_AZIMUTH_F32, azimuths.data()));
+	for (int i = 0; i < outCount; ++i) {
+		EXPECT_EQ(intensities.at(i), expected.at(i).intensity);
+		EXPECT_EQ(azimuths.at(i), expected.at(i).azimuth);
+	}
+}
@@ -48,6 +48,74 @@ TEST_F(TemporalMergePointsNodeTest, valid_arguments)
 	EXPECT_RGL_SUCCESS(rgl_node_points_temporal_merge(&temporalMergePointsNode, fields.data(), fields.size()));
 }
 
+TEST_F(TemporalMergePointsNodeTest, invalid_argument_ring)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_points_temporal_merge_ring(&temporalMergePointsNode, fields.data(), fields.size(), 0, 0.0),
+	    "max_point_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_node_points_temporal_merge_ring(&temporalMergePointsNode, fields.data(), fields.size(), 10, -1.0),
+	    "time_window >= 0.0");
+}
+
+TEST_F(TemporalMergePointsNodeTest, ring_evicts_oldest_point_clouds)
+{
+	const int32_t POINTS_PER_RUN = 4;
+	const int32_t MAX_POINT_COUNT = 10;
+	rgl_field_t intensityField = RGL_FIELD_INTENSITY_F32;
+
+	rgl_node_t usePoints = nullptr;
+	std::vector<float> expected;
+	for (int run = 0; run < 3; ++run) {
+		std::vector<float> intensities(POINTS_PER_RUN, static_cast<float>(run));
+		ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&usePoints, intensities.data(), POINTS_PER_RUN, &intensityField, 1));
+		if (run == 0) {
+			ASSERT_RGL_SUCCESS(
+			    rgl_node_points_temporal_merge_ring(&temporalMergePointsNode, &intensityField, 1, MAX_POINT_COUNT, 0.0));
+			ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePoints, temporalMergePointsNode));
+		}
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePoints));
+	}
+
+	// The third point cloud does not fit, so the first one is evicted.
+	int32_t outCount = 0, outSizeOf = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(temporalMergePointsNode, intensityField, &outCount, &outSizeOf));
+	ASSERT_EQ(outCount, 2 * POINTS_PER_RUN);
+	std::vector<float> outData(outCount);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(temporalMergePointsNode, intensityField, outData.data()));
+	for (int i = 0; i < outCount; ++i) {
+		EXPECT_EQ(outData.at(i), i < POINTS_PER_RUN ? 1.0f : 2.0f);
+	}
+}
+
+TEST_F(TemporalMergePointsNodeTest, managed_memory_keeps_merged_point_clouds)
+{
+	const int32_t POINTS_PER_RUN = 4;
+	rgl_field_t intensityField = RGL_FIELD_INTENSITY_F32;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_temporal_merge_configure_managed_memory(nullptr, true), "node != nullptr");
+
+	rgl_node_t usePoints = nullptr;
+	for (int run = 0; run < 3; ++run) {
+		std::vector<float> intensities(POINTS_PER_RUN, static_cast<float>(run));
+		ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&usePoints, intensities.data(), POINTS_PER_RUN, &intensityField, 1));
+		if (run == 0) {
+			ASSERT_RGL_SUCCESS(rgl_node_points_temporal_merge(&temporalMergePointsNode, &intensityField, 1));
+			ASSERT_RGL_SUCCESS(rgl_node_points_temporal_merge_configure_managed_memory(temporalMergePointsNode, true));
+			ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePoints, temporalMergePointsNode));
+		}
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePoints));
+	}
+
+	int32_t outCount = 0, outSizeOf = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(temporalMergePointsNode, intensityField, &outCount, &outSizeOf));
+	ASSERT_EQ(outCount, 3 * POINTS_PER_RUN);
+	std::vector<float> outData(outCount);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(temporalMergePointsNode, intensityField, outData.data()));
+	for (int i = 0; i < outCount; ++i) {
+		EXPECT_EQ(outData.at(i), static_cast<float>(i / POINTS_PER_RUN));
+	}
+}
+
 TEST_F(TemporalMergePointsNodeTest, temporal_merge)
 {
 	auto mesh = makeCubeMesh();
@@ -77,4 +77,40 @@ TEST_P(TransformPointsNodeTest, use_case)
 	// TODO When we are testing big values of point translation, numerical errors appears.
 	//  For example for 100000 unit of translation, error after rotation can extend 0.001 unit.
 	//  To investigate in better times.
-}
\ No newline at end of file
+}
+TEST_P(TransformPointsNodeTest, chained_transforms_should_be_applied_at_once)
+{
+	auto [pointsCount, transform] = GetParam();
+	rgl_node_t firstTransformNode = nullptr, secondTransformNode = nullptr, formatNode = nullptr;
+
+	TestPointCloud pointCloud = TestPointCloud(fields, pointsCount);
+	rgl_node_t usePointsNode = pointCloud.createUsePointsNode();
+	EXPECT_RGL_SUCCESS(rgl_node_points_transform(&firstTransformNode, &transform));
+	EXPECT_RGL_SUCCESS(rgl_node_points_transform(&secondTransformNode, &complexTestTransform));
+	EXPECT_RGL_SUCCESS(rgl_node_points_format(&formatNode, fields.data(), fields.size()));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, firstTransformNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(firstTransformNode, secondTransformNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(secondTransformNode, formatNode));
+
+	// Both transforms are deferred to formatting; XYZ of the transform nodes is still available on request.
+	for (int run = 0; run < 2; ++run) {
+		EXPECT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		TestPointCloud firstPointCloud = TestPointCloud::createFromNode(firstTransformNode, fields);
+		TestPointCloud formattedPointCloud = TestPointCloud::createFromFormatNode(formatNode, fields);
+
+		TestPointCloud expectedPointCloud = pointCloud;
+		expectedPointCloud.transform(Mat3x4f::fromRGL(transform));
+		checkIfNearEqual(expectedPointCloud.getFieldValues<XYZ_VEC3_F32>(), firstPointCloud.getFieldValues<XYZ_VEC3_F32>(),
+		                 EPSILON_F);
+		expectedPointCloud.transform(Mat3x4f::fromRGL(complexTestTransform));
+		checkIfNearEqual(expectedPointCloud.getFieldValues<XYZ_VEC3_F32>(),
+		                 formattedPointCloud.getFieldValues<XYZ_VEC3_F32>(), 1e-4f);
+		checkIfNearEqual(pointCloud.getFieldValues<INTENSITY_F32>(), formattedPointCloud.getFieldValues<INTENSITY_F32>(),
+		                 EPSILON_F);
+
+		// The input changes between runs, so that the output of the previous run is not reused.
+		pointCloud.transform(Mat3x4f::translation(1.0f, 0.0f, 0.0f));
+		EXPECT_RGL_SUCCESS(rgl_node_points_from_array(&usePointsNode, pointCloud.getData(), pointsCount, fields.data(),
+		                                              fields.size()));
+	}
+}
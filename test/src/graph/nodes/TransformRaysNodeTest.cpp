@@ -1,5 +1,9 @@
 #include <helpers/commonHelpers.hpp>
 #include <helpers/mathHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
 
 class TransformRaysNodeTest : public RGLTest
 {
@@ -27,3 +31,47 @@ TEST_F(TransformRaysNodeTest, valid_arguments)
 	// If (*raysFromMatNode) != nullptr
 	EXPECT_RGL_SUCCESS(rgl_node_rays_transform(&transformRaysNode, &identityTestTransform));
 }
+
+TEST_F(TransformRaysNodeTest, transform_deferred_to_raytrace_should_match_transformed_rays)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float EPSILON = 1e-4f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	// Raytrace is the only consumer of the transform, so the transform is applied in raygen.
+	Mat3x4f transform = Mat3x4f::TRS({0.1f, 0.2f, 1.0f}, {0.0f, 0.0f, 30.0f});
+	rgl_mat3x4f transformRGL = transform.toRGL();
+	std::vector<Mat3x4f> rays = {Mat3x4f::identity(), Mat3x4f::translation(0.2f, 0.0f, 0.0f),
+	                             Mat3x4f::rotationDeg(0.0f, 10.0f, 0.0f)};
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, DISTANCE_F32, RAY_POSE_MAT3x4_F32};
+
+	rgl_node_t raysNode = nullptr, raytraceNode = nullptr, yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(
+	    rgl_node_rays_from_mat3x4f(&raysNode, reinterpret_cast<const rgl_mat3x4f*>(rays.data()), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_rays_transform(&transformRaysNode, &transformRGL));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, transformRaysNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformRaysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+	TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNode, fields);
+	ASSERT_EQ(outPointCloud.getPointCount(), rays.size());
+	auto outXyz = outPointCloud.getFieldValues<XYZ_VEC3_F32>();
+	auto outRayPoses = outPointCloud.getFieldValues<RAY_POSE_MAT3x4_F32>();
+	for (int i = 0; i < rays.size(); ++i) {
+		Mat3x4f expectedRay = transform * rays.at(i);
+		Vec3f origin = expectedRay * Vec3f{0, 0, 0};
+		Vec3f dir = expectedRay * Vec3f{0, 0, 1} - origin;
+		float expectedT = (CUBE_DISTANCE - CUBE_HALF_EDGE - origin.z()) / dir.z();
+		EXPECT_NEAR(outXyz.at(i).z(), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+		EXPECT_NEAR(outXyz.at(i).x(), origin.x() + dir.x() * expectedT, EPSILON);
+		EXPECT_NEAR(outXyz.at(i).y(), origin.y() + dir.y() * expectedT, EPSILON);
+		for (int row = 0; row < 3; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				EXPECT_NEAR(outRayPoses.at(i).rc[row][col], expectedRay.rc[row][col], EPSILON);
+			}
+		}
+	}
+}
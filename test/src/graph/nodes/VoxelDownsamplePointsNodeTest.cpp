@@ -0,0 +1,55 @@
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+#include <math/Vector.hpp>
+
+#include <algorithm>
+
+struct VoxelDownsamplePointsNodeTest : public RGLTest
+{
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, INTENSITY_F32};
+	rgl_node_t voxelDownsampleNode = nullptr;
+};
+
+TEST_F(VoxelDownsamplePointsNodeTest, invalid_argument_node)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_voxel_downsample(nullptr, 1.0f, 1.0f, 1.0f), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_voxel_downsample(&voxelDownsampleNode, 0.0f, 1.0f, 1.0f),
+	                            "leaf_size_x > 0.0f");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_voxel_downsample(&voxelDownsampleNode, 1.0f, -1.0f, 1.0f),
+	                            "leaf_size_y > 0.0f");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_voxel_downsample(&voxelDownsampleNode, 1.0f, 1.0f, 0.0f),
+	                            "leaf_size_z > 0.0f");
+}
+
+TEST_F(VoxelDownsamplePointsNodeTest, keeps_first_point_of_each_voxel)
+{
+	struct Point
+	{
+		Vec3f xyz;
+		float intensity;
+	};
+	// The first two points share a voxel, so only the first of them is expected in the output.
+	std::vector<Point> points = {
+	    {{0.1f, 0.1f, 0.1f}, 1.0f},
+	    {{0.2f, 0.2f, 0.2f}, 2.0f},
+	    {{1.5f, 0.1f, 0.1f}, 3.0f},
+	    {{-0.5f, 0.1f, 0.1f}, 4.0f},
+	};
+
+	rgl_node_t fromArrayNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArrayNode, points.data(), points.size(), fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_voxel_downsample(&voxelDownsampleNode, 1.0f, 1.0f, 1.0f));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArrayNode, voxelDownsampleNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(voxelDownsampleNode));
+
+	int32_t outCount = 0, outSizeOf = 0;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_size(voxelDownsampleNode, RGL_FIELD_INTENSITY_F32, &outCount, &outSizeOf));
+	ASSERT_EQ(outCount, 3);
+	std::vector<float> intensities(outCount);
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(voxelDownsampleNode, RGL_FIELD_INTENSITY_F32, intensities.data()));
+
+	// Output is ordered by voxels, not by input order.
+	std::sort(intensities.begin(), intensities.end());
+	EXPECT_EQ(intensities, std::vector<float>({1.0f, 3.0f, 4.0f}));
+}
@@ -0,0 +1,135 @@
+#include <helpers/testPointCloud.hpp>
+#include <helpers/commonHelpers.hpp>
+
+#include <RGLFields.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+class WritePointsFileNodeTest : public RGLTest
+{
+protected:
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "rgl_write_points_file_test";
+	std::string pathPrefix = (directory / "cloud_").string();
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32, PADDING_32, INTENSITY_F32, CLASS_ID_U16};
+	rgl_node_t usePointsNode = nullptr, formatNode = nullptr, writeNode = nullptr;
+
+	void SetUp() override
+	{
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+	}
+
+	void TearDown() override { std::filesystem::remove_all(directory); }
+
+	// Returns formatted point cloud of the last frame (padding bytes are not initialized by formatting).
+	std::string runFrames(TestPointCloud& pointCloud, rgl_point_file_format_t format, int frameCount)
+	{
+		usePointsNode = pointCloud.createUsePointsNode();
+		EXPECT_RGL_SUCCESS(rgl_node_points_format(&formatNode, fields.data(), fields.size()));
+		EXPECT_RGL_SUCCESS(rgl_node_points_write_file(&writeNode, pathPrefix.c_str(), format));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, formatNode));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(formatNode, writeNode));
+		for (int frame = 0; frame < frameCount; ++frame) {
+			EXPECT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		}
+		int32_t outCount = 0, outSize = 0;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_size(formatNode, RGL_FIELD_DYNAMIC_FORMAT, &outCount, &outSize));
+		std::string formatted(outCount * outSize, '\0');
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(formatNode, RGL_FIELD_DYNAMIC_FORMAT, formatted.data()));
+		// Files are complete once the node is destroyed.
+		EXPECT_RGL_SUCCESS(rgl_graph_destroy(usePointsNode));
+		return formatted;
+	}
+
+	std::string readFile(const std::string& path)
+	{
+		std::ifstream file{path, std::ios::binary};
+		EXPECT_TRUE(file.is_open()) << path;
+		return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	}
+};
+
+TEST_F(WritePointsFileNodeTest, invalid_arguments)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_write_file(nullptr, "cloud_", RGL_POINT_FILE_FORMAT_PCD), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_write_file(&writeNode, nullptr, RGL_POINT_FILE_FORMAT_PCD),
+	                            "path_prefix != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_write_file(&writeNode, "", RGL_POINT_FILE_FORMAT_PCD), "path_prefix[0]");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_node_points_write_file(&writeNode, "cloud_", (rgl_point_file_format_t) 3), "format");
+	EXPECT_RGL_SUCCESS(rgl_node_points_write_file(&writeNode, "cloud_", RGL_POINT_FILE_FORMAT_LAS));
+}
+
+TEST_F(WritePointsFileNodeTest, should_require_formatted_input)
+{
+	TestPointCloud pointCloud(fields, 10);
+	usePointsNode = pointCloud.createUsePointsNode();
+	ASSERT_RGL_SUCCESS(rgl_node_points_write_file(&writeNode, pathPrefix.c_str(), RGL_POINT_FILE_FORMAT_PCD));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, writeNode));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(usePointsNode), "requires a formatted point cloud");
+}
+
+TEST_F(WritePointsFileNodeTest, should_write_binary_pcd_file_per_frame)
+{
+	TestPointCloud pointCloud(fields, 10);
+	std::string formatted = runFrames(pointCloud, RGL_POINT_FILE_FORMAT_PCD, 3);
+
+	std::string expectedHeader = "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\n"
+	                             "FIELDS x y z _ intensity class_id\nSIZE 4 4 4 1 4 2\nTYPE F F F U F U\nCOUNT 1 1 1 4 1 1\n"
+	                             "WIDTH 10\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS 10\nDATA binary\n";
+	for (int frame = 1; frame <= 3; ++frame) {
+		std::string file = readFile(fmt::format("{}{:06}.pcd", pathPrefix, frame));
+		EXPECT_EQ(file.substr(0, expectedHeader.size()), expectedHeader);
+		EXPECT_EQ(file.size(), expectedHeader.size() + pointCloud.getPointByteSize() * 10);
+	}
+	EXPECT_EQ(readFile(fmt::format("{}{:06}.pcd", pathPrefix, 3)), expectedHeader + formatted);
+}
+
+TEST_F(WritePointsFileNodeTest, should_write_binary_ply_file)
+{
+	TestPointCloud pointCloud(fields, 10);
+	std::string formatted = runFrames(pointCloud, RGL_POINT_FILE_FORMAT_PLY, 1);
+
+	std::string expectedHeader = "ply\nformat binary_little_endian 1.0\nelement vertex 10\n"
+	                             "property float x\nproperty float y\nproperty float z\n"
+	                             "property uchar _padding0\nproperty uchar _padding1\n"
+	                             "property uchar _padding2\nproperty uchar _padding3\n"
+	                             "property float intensity\nproperty ushort class_id\nend_header\n";
+	EXPECT_EQ(readFile(fmt::format("{}{:06}.ply", pathPrefix, 1)), expectedHeader + formatted);
+}
+
+TEST_F(WritePointsFileNodeTest, should_write_las_file_skipping_non_finite_points)
+{
+	TestPointCloud pointCloud(fields, 3);
+	constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+	pointCloud.setFieldValues<XYZ_VEC3_F32>({Vec3f{1.0f, 2.0f, 3.0f}, Vec3f{nan, nan, nan}, Vec3f{-1.0f, 0.5f, 4.0f}});
+	pointCloud.setFieldValues<INTENSITY_F32>({100.0f, 0.0f, 70000.0f});
+	pointCloud.setFieldValues<CLASS_ID_U16>({2, 0, 40});
+	runFrames(pointCloud, RGL_POINT_FILE_FORMAT_LAS, 1);
+
+	constexpr std::size_t HEADER_SIZE = 227, POINT_SIZE = 20;
+	std::string file = readFile(fmt::format("{}{:06}.las", pathPrefix, 1));
+	ASSERT_EQ(file.size(), HEADER_SIZE + 2 * POINT_SIZE);
+	EXPECT_EQ(file.substr(0, 4), "LASF");
+	auto read = [&]<typename T>(std::size_t offset, T) {
+		T value;
+		std::memcpy(&value, file.data() + offset, sizeof(T));
+		return value;
+	};
+	EXPECT_EQ(read(107, uint32_t{}), 2);   // Number of point records
+	EXPECT_EQ(read(179, double{}), 1.0);   // Max X
+	EXPECT_EQ(read(187, double{}), -1.0);  // Min X
+	EXPECT_EQ(read(219, double{}), 3.0);   // Min Z
+
+	// Coordinates are relative to the minimum (offset), in millimeters.
+	std::size_t second = HEADER_SIZE + POINT_SIZE;
+	EXPECT_EQ(read(second + 0, int32_t{}), 0);
+	EXPECT_EQ(read(second + 4, int32_t{}), 0);
+	EXPECT_EQ(read(second + 8, int32_t{}), 1000);
+	EXPECT_EQ(read(HEADER_SIZE + 0, int32_t{}), 2000);
+	EXPECT_EQ(read(HEADER_SIZE + 12, uint16_t{}), 100);
+	EXPECT_EQ(read(second + 12, uint16_t{}), 65535);
+	EXPECT_EQ(read(HEADER_SIZE + 15, uint8_t{}), 2);
+	EXPECT_EQ(read(second + 15, uint8_t{}), 31);
+}
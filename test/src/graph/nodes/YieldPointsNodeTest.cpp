@@ -1,3 +1,4 @@
+#include <helpers/testPointCloud.hpp>
 #include <helpers/commonHelpers.hpp>
 
 class YieldPointsNodeTest : public RGLTest
@@ -37,3 +38,18 @@ TEST_F(YieldPointsNodeTest, valid_arguments)
 	// If (*yieldNode) != nullptr
 	EXPECT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
 }
+
+TEST_F(YieldPointsNodeTest, yields_all_fields)
+{
+	std::vector<rgl_field_t> pointFields = {XYZ_VEC3_F32, INTENSITY_F32, ENTITY_ID_I32, DISTANCE_F32};
+	TestPointCloud pointCloud(pointFields, 100);
+	rgl_node_t usePointsNode = pointCloud.createUsePointsNode();
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, pointFields.data(), pointFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(usePointsNode, yieldNode));
+
+	// Repeated runs reuse the host cache
+	for (int run = 0; run < 3; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(usePointsNode));
+		EXPECT_EQ(TestPointCloud::createFromNode(yieldNode, pointFields), pointCloud);
+	}
+}
@@ -0,0 +1,108 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+
+#if RGL_BUILD_PCL_EXTENSION
+#include <rgl/api/extensions/pcl.h>
+#endif
+
+class ParallelBranchesTest : public RGLTest
+{};
+
+/**
+ * Branches after fan-out are executed in separate streams; each of them must observe complete output of the raytrace.
+ */
+TEST_F(ParallelBranchesTest, fan_out_branches_should_produce_independent_results)
+{
+	constexpr float EPSILON = 1e-4f;
+	constexpr float CUBE_DISTANCE = 5.0f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(0.5f, 0, 0).toRGL()};
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32};
+	std::vector<float> offsetsY = {10.0f, -3.0f, 7.0f};
+
+	rgl_node_t raysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+
+	std::vector<rgl_node_t> yieldNodes;
+	for (auto&& offsetY : offsetsY) {
+		rgl_mat3x4f transform = Mat3x4f::translation(0, offsetY, 0).toRGL();
+		rgl_node_t transformNode = nullptr, yieldNode = nullptr;
+		ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transformNode, &transform));
+		ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+		ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, transformNode));
+		ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, yieldNode));
+		yieldNodes.push_back(yieldNode);
+	}
+
+	for (int run = 0; run < 3; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+		for (std::size_t i = 0; i < yieldNodes.size(); ++i) {
+			TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNodes[i], fields);
+			ASSERT_EQ(outPointCloud.getPointCount(), rays.size());
+			for (auto&& point : outPointCloud.getFieldValues<XYZ_VEC3_F32>()) {
+				EXPECT_NEAR(point.y(), offsetsY[i], EPSILON);
+				EXPECT_NEAR(point.z(), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+			}
+		}
+	}
+}
+
+#if RGL_BUILD_PCL_EXTENSION
+/**
+ * Host compute nodes (PCL) are executed on a worker pool; their outputs must still observe their results,
+ * while the independent branch is enqueued without waiting for them.
+ */
+TEST_F(ParallelBranchesTest, host_compute_branch_should_gate_only_its_outputs)
+{
+	constexpr float EPSILON = 1e-4f;
+	constexpr float CUBE_DISTANCE = 5.0f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	// Dense grid of parallel rays hitting the cube face; down-sampling keeps roughly one point per leaf.
+	std::vector<rgl_mat3x4f> rays;
+	for (int x = 0; x < 20; ++x) {
+		for (int y = 0; y < 20; ++y) {
+			rays.push_back(Mat3x4f::translation(-0.5f + 0.05f * x, -0.5f + 0.05f * y, 0).toRGL());
+		}
+	}
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32};
+	rgl_mat3x4f offset = Mat3x4f::translation(0, 10.0f, 0).toRGL();
+
+	rgl_node_t raysNode = nullptr, raytraceNode = nullptr, downsampleNode = nullptr, downsampledYieldNode = nullptr,
+	           transformNode = nullptr, transformedYieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_downsample(&downsampleNode, 0.5f, 0.5f, 0.5f));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&downsampledYieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transformNode, &offset));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&transformedYieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, downsampleNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(downsampleNode, downsampledYieldNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, transformNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(transformNode, transformedYieldNode));
+
+	for (int run = 0; run < 3; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raysNode));
+
+		TestPointCloud transformed = TestPointCloud::createFromNode(transformedYieldNode, fields);
+		ASSERT_EQ(transformed.getPointCount(), rays.size());
+		for (auto&& point : transformed.getFieldValues<XYZ_VEC3_F32>()) {
+			EXPECT_NEAR(point.z(), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+		}
+
+		TestPointCloud downsampled = TestPointCloud::createFromNode(downsampledYieldNode, fields);
+		EXPECT_GT(downsampled.getPointCount(), 0);
+		EXPECT_LT(downsampled.getPointCount(), rays.size());
+		for (auto&& point : downsampled.getFieldValues<XYZ_VEC3_F32>()) {
+			EXPECT_NEAR(point.z(), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+		}
+	}
+}
+#endif
@@ -0,0 +1,77 @@
+#include <helpers/commonHelpers.hpp>
+#include <helpers/sceneHelpers.hpp>
+#include <helpers/testPointCloud.hpp>
+
+#include <math/Mat3x4f.hpp>
+
+class RunBatchTest : public RGLTest
+{
+protected:
+	std::vector<rgl_field_t> fields = {XYZ_VEC3_F32};
+
+	// Lidar with a single ray, looking along Z from the given offset along X.
+	rgl_node_t createLidarGraph(float offsetX, rgl_node_t* outYieldNode)
+	{
+		rgl_mat3x4f ray = Mat3x4f::translation(offsetX, 0, 0).toRGL();
+		rgl_node_t raysNode = nullptr, raytraceNode = nullptr;
+		EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, &ray, 1));
+		EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+		EXPECT_RGL_SUCCESS(rgl_node_points_yield(outYieldNode, fields.data(), fields.size()));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, *outYieldNode));
+		return raysNode;
+	}
+};
+
+TEST_F(RunBatchTest, invalid_arguments)
+{
+	rgl_node_t node = nullptr;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_run_batch(nullptr, 1), "nodes != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_run_batch(&node, 0), "node_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_run_batch(&node, 1), "nodes[i] != nullptr");
+}
+
+TEST_F(RunBatchTest, should_run_each_graph_of_the_batch)
+{
+	constexpr float EPSILON = 1e-4f;
+	constexpr float CUBE_DISTANCE = 5.0f;
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	std::vector<float> offsetsX = {-0.5f, 0.0f, 0.5f};
+	std::vector<rgl_node_t> graphNodes, yieldNodes(offsetsX.size());
+	for (std::size_t i = 0; i < offsetsX.size(); ++i) {
+		graphNodes.push_back(createLidarGraph(offsetsX[i], &yieldNodes[i]));
+	}
+	// Nodes of the same graph run it once.
+	graphNodes.push_back(yieldNodes.front());
+
+	for (int run = 0; run < 3; ++run) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run_batch(graphNodes.data(), graphNodes.size()));
+		for (std::size_t i = 0; i < yieldNodes.size(); ++i) {
+			TestPointCloud outPointCloud = TestPointCloud::createFromNode(yieldNodes[i], fields);
+			ASSERT_EQ(outPointCloud.getPointCount(), 1);
+			EXPECT_NEAR(outPointCloud.getFieldValue<XYZ_VEC3_F32>(0).x(), offsetsX[i], EPSILON);
+			EXPECT_NEAR(outPointCloud.getFieldValue<XYZ_VEC3_F32>(0).z(), CUBE_DISTANCE - CUBE_HALF_EDGE, EPSILON);
+		}
+	}
+}
+
+TEST_F(RunBatchTest, invalid_graph_should_fail_the_whole_batch)
+{
+	rgl_node_t yieldNode = nullptr, invalidYieldNode = nullptr;
+	rgl_node_t graphNodes[] = {createLidarGraph(0.0f, &yieldNode), nullptr};
+	std::vector<rgl_field_t> missingFields = {INTENSITY_F32};
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&graphNodes[1], &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&invalidYieldNode, missingFields.data(), missingFields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(graphNodes[1], invalidYieldNode));
+
+	// Rays are not a point cloud.
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run_batch(graphNodes, 2), "looked for");
+
+	// The valid graph runs once the invalid one is left out.
+	ASSERT_RGL_SUCCESS(rgl_graph_run_batch(graphNodes, 1));
+	int32_t outCount = -1, outSize = -1;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_size(yieldNode, XYZ_VEC3_F32, &outCount, &outSize));
+	EXPECT_EQ(outCount, 1);
+}
@@ -1,6 +1,7 @@
 #include <helpers/commonHelpers.hpp>
 
 #include <RGLFields.hpp>
+#include <math/Mat3x4f.hpp>
 
 #include <api/apiCommon.hpp>
 #include <helpers/graphHelpers.hpp>
@@ -219,3 +220,65 @@ TEST_F(SetNodePriority, AddChild)
     };
 	EXPECT_TRUE(prioritiesMatch(expectedPriorities2));
 }
+
+TEST_F(SetNodePriority, SeparateGraphsRunInParallel)
+{
+	if (std::thread::hardware_concurrency() < 2) {
+		GTEST_SKIP() << "graph scheduler has a single worker thread";
+	}
+	rgl_node_t fromArrayA = nullptr, sleepA = nullptr, nodeA = nullptr;
+	rgl_node_t fromArrayB = nullptr, nodeB = nullptr;
+
+	// Graph A is slow and has lower priority
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArrayA, data, 1, fields, 1));
+	createOrUpdateNode<SleepNode>(&sleepA, 10 * SLEEP);
+	createOrUpdateNode<RecordTimeNode>(&nodeA);
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArrayA, sleepA));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(sleepA, nodeA));
+
+	// Graph B is fast and has higher priority
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArrayB, data, 1, fields, 1));
+	createOrUpdateNode<RecordTimeNode>(&nodeB);
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArrayB, nodeB));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_set_priority(nodeB, 1));
+
+	// Graph B should not wait for graph A, which was run earlier
+	for (int i = 0; i < CHECKS; ++i) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(fromArrayA));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(fromArrayB));
+		double timestampB = dynamic_cast<RecordTimeNode*>(nodeB)->getMeasurement();
+		double timestampA = dynamic_cast<RecordTimeNode*>(nodeA)->getMeasurement();
+		ASSERT_LE(timestampB, timestampA);
+	}
+}
+
+TEST_F(SetNodePriority, GpuPriority)
+{
+	rgl_node_t fromArray = nullptr, transform = nullptr;
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	ASSERT_RGL_SUCCESS(rgl_node_points_from_array(&fromArray, data, 1, fields, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_points_transform(&transform, &identity));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(fromArray, transform));
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_set_gpu_priority(nullptr, 0), "node != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_graph_set_gpu_priority(fromArray, -1), "priority >= 0");
+
+	int leastPriority = 0, greatestPriority = 0;
+	CHECK_CUDA(cudaDeviceGetStreamPriorityRange(&leastPriority, &greatestPriority));
+	auto runAndGetStreamPriority = [&]() {
+		EXPECT_RGL_SUCCESS(rgl_graph_run(fromArray));
+		auto node = Node::validatePtr(transform);
+		int priority = 0;
+		CHECK_CUDA(cudaStreamGetPriority(node->getGraphRunCtx()->getNodeStream(*node)->getHandle(), &priority));
+		return priority;
+	};
+
+	// By default, streams have the lowest priority; it follows node priorities unless set explicitly.
+	EXPECT_EQ(runAndGetStreamPriority(), leastPriority);
+	ASSERT_RGL_SUCCESS(rgl_graph_node_set_priority(transform, 1));
+	EXPECT_EQ(runAndGetStreamPriority(), std::max(leastPriority - 1, greatestPriority));
+	ASSERT_RGL_SUCCESS(rgl_graph_set_gpu_priority(fromArray, 0));
+	EXPECT_EQ(runAndGetStreamPriority(), leastPriority);
+	ASSERT_RGL_SUCCESS(rgl_graph_set_gpu_priority(fromArray, 1000));
+	EXPECT_EQ(runAndGetStreamPriority(), greatestPriority);
+}
@@ -2,6 +2,13 @@
 
 #include <memory/InvalidArrayCast.hpp>
 #include <memory/Array.hpp>
+#include <memory/ArrayCopyBatch.hpp>
+#include <memory/DeviceArena.hpp>
+#include <memory/DeviceMemoryPool.hpp>
+#include <memory/HostPinnedMemoryPool.hpp>
+#include <memory/SharedDeviceArrays.hpp>
+
+#include <rgl/api/core.h>
 
 /*
  * TEST PURPOSE:
@@ -51,6 +58,172 @@ TEST_F(ArrayOps, ResizeChangesCount)
 	EXPECT_LE(array->getCapacity(), END_SIZE);
 }
 
+TEST_F(ArrayOps, ResizeGrowsCapacityGeometrically)
+{
+	array->resize(100, false, false);
+	EXPECT_EQ(array->getCapacity(), 100);
+	array->resize(101, false, true);
+	EXPECT_EQ(array->getCount(), 101);
+	EXPECT_EQ(array->getCapacity(), 150);
+	array->resize(10, false, true);
+	EXPECT_EQ(array->getCapacity(), 150);
+}
+
+TEST_F(ArrayOps, ResizeReleasesCapacityOnlyAfterStayingSmaller)
+{
+	array->resize(1000, false, false);
+	EXPECT_EQ(array->getCapacity(), 1000);
+
+	// Fluctuating counts reaching the capacity now and then keep it.
+	for (int i = 0; i < 200; ++i) {
+		array->resize(i % 50 == 0 ? 1000 : 10, false, false);
+	}
+	EXPECT_EQ(array->getCapacity(), 1000);
+
+	// Staying much smaller for long enough releases it, with a margin above the counts seen.
+	rgl_performance_counters_t countersBefore, countersAfter;
+	ASSERT_EQ(rgl_get_performance_counters(&countersBefore), RGL_SUCCESS);
+	for (int i = 0; i < 200; ++i) {
+		array->resize(100, false, false);
+	}
+	ASSERT_EQ(rgl_get_performance_counters(&countersAfter), RGL_SUCCESS);
+	EXPECT_EQ(array->getCapacity(), 150);
+	EXPECT_EQ(array->getPeakCapacity(), 1000);
+	EXPECT_EQ(countersAfter.array_allocation_count - countersBefore.array_allocation_count, 1);
+}
+
+TEST_F(ArrayOps, AppendGrowsCapacityGeometrically)
+{
+	auto chunk = HostPinnedArray<Type>::create();
+	chunk->resize(10, true, false);
+	for (int i = 0; i < 100; ++i) {
+		array->appendFrom(chunk);
+	}
+	EXPECT_EQ(array->getCount(), 1000);
+	EXPECT_LT(array->getCapacity(), 1500);
+	EXPECT_EQ(array->at(999), 0);
+}
+
+TEST_F(ArrayOps, MemoryKindStatsCountAllocationsAndCopies)
+{
+	// The array is pinned, so its allocations are not counted as pageable host or device memory.
+	rgl_memory_kind_stats_t pinnedBefore, pinnedAfter, deviceBefore, deviceAfter;
+	rgl_performance_counters_t countersBefore, countersAfter;
+	ASSERT_EQ(rgl_get_memory_kind_stats(RGL_MEMORY_KIND_HOST_PINNED, &pinnedBefore), RGL_SUCCESS);
+	ASSERT_EQ(rgl_get_memory_kind_stats(RGL_MEMORY_KIND_DEVICE_SYNC, &deviceBefore), RGL_SUCCESS);
+	ASSERT_EQ(rgl_get_performance_counters(&countersBefore), RGL_SUCCESS);
+
+	array->resize(100, true, false);
+	array->resize(1000, false, true); // Reallocates preserving 100 elements
+	auto deviceArray = DeviceSyncArray<Type>::create();
+	deviceArray->copyFrom(array);
+	ASSERT_EQ(rgl_get_memory_kind_stats(RGL_MEMORY_KIND_HOST_PINNED, &pinnedAfter), RGL_SUCCESS);
+	ASSERT_EQ(rgl_get_memory_kind_stats(RGL_MEMORY_KIND_DEVICE_SYNC, &deviceAfter), RGL_SUCCESS);
+	ASSERT_EQ(rgl_get_performance_counters(&countersAfter), RGL_SUCCESS);
+
+	EXPECT_EQ(pinnedAfter.allocation_count - pinnedBefore.allocation_count, 2);
+	EXPECT_EQ(pinnedAfter.deallocation_count - pinnedBefore.deallocation_count, 1);
+	EXPECT_EQ(pinnedAfter.live_bytes - pinnedBefore.live_bytes, array->getCapacity() * sizeof(Type));
+	EXPECT_GE(pinnedAfter.peak_bytes, pinnedAfter.live_bytes);
+	EXPECT_EQ(deviceAfter.live_bytes - deviceBefore.live_bytes, deviceArray->getCapacity() * sizeof(Type));
+	EXPECT_EQ(countersAfter.host_to_host_bytes - countersBefore.host_to_host_bytes, 100 * sizeof(Type));
+	EXPECT_EQ(countersAfter.host_to_device_bytes - countersBefore.host_to_device_bytes, 1000 * sizeof(Type));
+
+	// Steady state: resizes within the capacity do not allocate.
+	for (int i = 0; i < 10; ++i) {
+		array->resize(900 + i, false, false);
+	}
+	ASSERT_EQ(rgl_get_memory_kind_stats(RGL_MEMORY_KIND_HOST_PINNED, &pinnedBefore), RGL_SUCCESS);
+	EXPECT_EQ(pinnedBefore.allocation_count, pinnedAfter.allocation_count);
+
+	deviceArray.reset();
+	ASSERT_EQ(rgl_get_memory_kind_stats(RGL_MEMORY_KIND_DEVICE_SYNC, &deviceAfter), RGL_SUCCESS);
+	EXPECT_EQ(deviceAfter.live_bytes, deviceBefore.live_bytes);
+	EXPECT_EQ(rgl_get_memory_kind_stats(static_cast<rgl_memory_kind_t>(5), &deviceAfter), RGL_INVALID_ARGUMENT);
+}
+
+TEST(DeviceArena, SmallArraysDoNotAllocateInSteadyState)
+{
+	auto stream = CudaStream::create();
+	auto createAndDestroySmallArrays = [&]() {
+		std::vector<DeviceAsyncArray<int>::Ptr> arrays;
+		for (int i = 0; i < 16; ++i) {
+			arrays.emplace_back(DeviceAsyncArray<int>::create(stream));
+			arrays.back()->resize(1 + i * 64, true, false);
+		}
+	};
+	createAndDestroySmallArrays();
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+
+	uint64_t poolAllocationCount = DeviceMemoryPool::instance().getAllocationCount();
+	uint64_t slabCount = DeviceArena::instance().getSlabCount();
+	for (int frame = 0; frame < 8; ++frame) {
+		createAndDestroySmallArrays();
+	}
+	CHECK_CUDA(cudaStreamSynchronize(stream->getHandle()));
+	EXPECT_EQ(DeviceMemoryPool::instance().getAllocationCount(), poolAllocationCount);
+	EXPECT_EQ(DeviceArena::instance().getSlabCount(), slabCount);
+}
+
+TEST(HostPinnedMemoryPool, ArraysDoNotPageLockMemoryInSteadyState)
+{
+	auto createAndDestroyArrays = [&]() {
+		std::vector<HostPinnedArray<int>::Ptr> arrays;
+		for (int i = 0; i < 16; ++i) {
+			arrays.emplace_back(HostPinnedArray<int>::create());
+			arrays.back()->resize(1 + i * 1024, true, false);
+		}
+	};
+	createAndDestroyArrays();
+
+	uint64_t allocationCount = HostPinnedMemoryPool::instance().getAllocationCount();
+	for (int frame = 0; frame < 8; ++frame) {
+		createAndDestroyArrays();
+	}
+	EXPECT_EQ(HostPinnedMemoryPool::instance().getAllocationCount(), allocationCount);
+}
+
+TEST(ArrayCopyBatch, CopiesExternalDataToManyArrays)
+{
+	auto stream = CudaStream::create();
+	std::vector<int> first = {1, 2, 3}, second = {4, 5};
+	auto firstArray = DeviceAsyncArray<int>::create(stream);
+	auto secondArray = DeviceAsyncArray<int>::create(stream);
+
+	ArrayCopyBatch batch{stream};
+	batch.copyFromExternal<int>(firstArray, first.data(), first.size());
+	batch.copyFromExternal<int>(secondArray, second.data(), second.size());
+	batch.execute();
+
+	auto hostArray = HostPinnedArray<int>::create();
+	hostArray->copyFrom(firstArray);
+	EXPECT_EQ(std::vector<int>(hostArray->getReadPtr(), hostArray->getReadPtr() + hostArray->getCount()), first);
+	hostArray->copyFrom(secondArray);
+	EXPECT_EQ(std::vector<int>(hostArray->getReadPtr(), hostArray->getReadPtr() + hostArray->getCount()), second);
+}
+
+TEST(SharedDeviceArrays, IdenticalContentIsStoredOnce)
+{
+	std::vector<float> pattern = {1.0f, 2.0f, 3.0f}, otherPattern = {1.0f, 2.0f, 4.0f};
+	std::size_t arrayCount = SharedDeviceArrays::getArrayCount();
+	auto first = SharedDeviceArrays::acquire(pattern.data(), pattern.size());
+	auto second = SharedDeviceArrays::acquire(pattern.data(), pattern.size());
+	auto other = SharedDeviceArrays::acquire(otherPattern.data(), otherPattern.size());
+	EXPECT_EQ(first, second);
+	EXPECT_NE(first, other);
+	EXPECT_EQ(SharedDeviceArrays::getArrayCount(), arrayCount + 2);
+
+	auto hostArray = HostPinnedArray<float>::create();
+	hostArray->copyFrom(second);
+	EXPECT_EQ(std::vector<float>(hostArray->getReadPtr(), hostArray->getReadPtr() + hostArray->getCount()), pattern);
+
+	// Arrays are freed once no longer referenced.
+	first.reset();
+	second.reset();
+	other.reset();
+	EXPECT_EQ(SharedDeviceArrays::getArrayCount(), arrayCount);
+}
+
 // TODO(nebraszka): write more tests:
 // TODO: resizing test
 // TODO: copy test
@@ -1,3 +1,5 @@
+#include <cuda_runtime.h>
+
 #include "helpers/commonHelpers.hpp"
 #include "helpers/sceneHelpers.hpp"
 #include "helpers/mathHelpers.hpp"
@@ -19,7 +21,7 @@ TEST_F(EntityTest, rgl_entity_create_destroy)
 	// Invalid args, note: scene can be nullptr here.
 	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_create(nullptr, nullptr, nullptr), "entity != nullptr");
 	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_create(&entity, nullptr, nullptr), "mesh != nullptr");
-	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_create(&entity, (rgl_scene_t) 0x1234, mesh), "scene == nullptr");
+	EXPECT_RGL_INVALID_OBJECT(rgl_entity_create(&entity, (rgl_scene_t) 0x1234, mesh), "Scene 0x1234");
 	EXPECT_RGL_INVALID_OBJECT(rgl_entity_create(&entity, nullptr, (rgl_mesh_t) 0x1234), "Mesh 0x1234");
 
 	// Correct create
@@ -48,4 +50,232 @@ TEST_F(EntityTest, rgl_entity_set_pose)
 
 	// Correct set_pose
 	EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity, &identityTestTransform));
-}
\ No newline at end of file
+}
+TEST_F(EntityTest, rgl_entity_set_pose_batch)
+{
+	constexpr float NEAR_DISTANCE = 5.0f;
+	constexpr float FAR_DISTANCE = 10.0f;
+	std::vector<rgl_entity_t> entities = {spawnCubeOnScene(Mat3x4f::translation(0, 0, FAR_DISTANCE)),
+	                                      spawnCubeOnScene(Mat3x4f::translation(0, 0, 2 * FAR_DISTANCE))};
+	std::vector<rgl_mat3x4f> transforms = {Mat3x4f::translation(0, 0, NEAR_DISTANCE).toRGL(),
+	                                       Mat3x4f::translation(0, 0, FAR_DISTANCE).toRGL()};
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_pose_batch(nullptr, 1, transforms.data()), "entities != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_pose_batch(entities.data(), 0, transforms.data()), "entity_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_pose_batch(entities.data(), 2, nullptr), "transforms != nullptr");
+
+	// Invalid entity does not modify the valid ones
+	std::vector<rgl_entity_t> invalidEntities = {entities[0], (rgl_entity_t) 0x1234};
+	EXPECT_RGL_INVALID_OBJECT(rgl_entity_set_pose_batch(invalidEntities.data(), 2, transforms.data()), "Entity 0x1234");
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	::Field<DISTANCE_F32>::type outDistance;
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, FAR_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	// Correct set_pose_batch
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose_batch(entities.data(), entities.size(), transforms.data()));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, NEAR_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+}
+
+TEST_F(EntityTest, rgl_entity_create_instanced)
+{
+	constexpr int INSTANCE_COUNT = 100;
+	constexpr float SPACING = 5.0f;
+	rgl_mesh_t mesh = makeCubeMesh();
+	std::vector<rgl_entity_t> entities(INSTANCE_COUNT);
+	std::vector<rgl_mat3x4f> transforms;
+	for (int i = 0; i < INSTANCE_COUNT; ++i) {
+		transforms.emplace_back(Mat3x4f::translation(0, 0, SPACING * static_cast<float>(i + 1)).toRGL());
+	}
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_create_instanced(nullptr, nullptr, mesh, transforms.data(), INSTANCE_COUNT),
+	                            "out_entities != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_create_instanced(entities.data(), nullptr, nullptr, transforms.data(), 1),
+	                            "mesh != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_create_instanced(entities.data(), nullptr, mesh, nullptr, 1),
+	                            "transforms != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_create_instanced(entities.data(), nullptr, mesh, transforms.data(), 0), "count > 0");
+
+	ASSERT_RGL_SUCCESS(rgl_entity_create_instanced(entities.data(), nullptr, mesh, transforms.data(), INSTANCE_COUNT));
+	for (auto&& entity : entities) {
+		ASSERT_THAT(entity, NotNull());
+	}
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	::Field<DISTANCE_F32>::type outDistance;
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, SPACING - CUBE_HALF_EDGE, 1e-4f);
+
+	// Instances are regular entities, removing the nearest one reveals the next.
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(entities[0]));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, 2 * SPACING - CUBE_HALF_EDGE, 1e-4f);
+}
+
+TEST_F(EntityTest, rgl_entity_set_pose_batch_device)
+{
+	constexpr float NEAR_DISTANCE = 5.0f;
+	constexpr float FAR_DISTANCE = 10.0f;
+	std::vector<rgl_entity_t> entities = {spawnCubeOnScene(Mat3x4f::translation(0, 0, FAR_DISTANCE)),
+	                                      spawnCubeOnScene(Mat3x4f::translation(0, 0, 2 * FAR_DISTANCE))};
+	std::vector<rgl_mat3x4f> transforms = {Mat3x4f::translation(0, 0, NEAR_DISTANCE).toRGL(),
+	                                       Mat3x4f::translation(0, 0, FAR_DISTANCE).toRGL()};
+	rgl_mat3x4f* dTransforms = nullptr;
+	ASSERT_EQ(cudaMalloc(&dTransforms, transforms.size() * sizeof(rgl_mat3x4f)), cudaSuccess);
+	ASSERT_EQ(cudaMemcpy(dTransforms, transforms.data(), transforms.size() * sizeof(rgl_mat3x4f), cudaMemcpyHostToDevice),
+	          cudaSuccess);
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_pose_batch_device(nullptr, 1, dTransforms, nullptr), "entities != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_pose_batch_device(entities.data(), 0, dTransforms, nullptr),
+	                            "entity_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_pose_batch_device(entities.data(), 2, nullptr, nullptr),
+	                            "device_transforms != nullptr");
+	std::vector<rgl_entity_t> repeatedEntities = {entities[0], entities[0]};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_pose_batch_device(repeatedEntities.data(), 2, dTransforms, nullptr),
+	                            "repeated");
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	::Field<DISTANCE_F32>::type outDistance;
+
+	// Transforms are read before the call returns, so the array may be overwritten afterwards.
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose_batch_device(entities.data(), entities.size(), dTransforms, nullptr));
+	ASSERT_EQ(cudaMemset(dTransforms, 0, transforms.size() * sizeof(rgl_mat3x4f)), cudaSuccess);
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, NEAR_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	// Setting the pose from the host takes precedence again.
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entities[0], &transforms[1]));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, FAR_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	ASSERT_EQ(cudaFree(dTransforms), cudaSuccess);
+}
+
+TEST_F(EntityTest, rgl_entity_set_lod_mesh)
+{
+	constexpr float ENTITY_DISTANCE = 10.0f;
+	constexpr float LOD_DISTANCE = 5.0f;
+	constexpr float LOD_HALF_EDGE = 2.0f * CUBE_HALF_EDGE;
+	rgl_entity_t entity = spawnCubeOnScene(Mat3x4f::translation(0, 0, ENTITY_DISTANCE));
+	rgl_mesh_t lodMesh = nullptr;
+	ASSERT_RGL_SUCCESS(
+	    rgl_mesh_create(&lodMesh, cubeVerticesX2, ARRAY_SIZE(cubeVerticesX2), cubeIndices, ARRAY_SIZE(cubeIndices)));
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_lod_mesh(nullptr, lodMesh, LOD_DISTANCE), "entity != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_lod_mesh(entity, lodMesh, 0.0f), "min_distance > 0.0f");
+	EXPECT_RGL_INVALID_OBJECT(rgl_entity_set_lod_mesh(entity, (rgl_mesh_t) 0x1234, LOD_DISTANCE), "Mesh 0x1234");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_set_lod_origin(nullptr, nullptr), "origin != nullptr");
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	auto getDistance = [&]() {
+		::Field<DISTANCE_F32>::type distance = 0.0f;
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &distance));
+		return distance;
+	};
+
+	// Without the LOD origin, the base mesh is used.
+	ASSERT_RGL_SUCCESS(rgl_entity_set_lod_mesh(entity, lodMesh, LOD_DISTANCE));
+	EXPECT_NEAR(getDistance(), ENTITY_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	rgl_vec3f farOrigin = {0.0f, 0.0f, 0.0f};
+	ASSERT_RGL_SUCCESS(rgl_scene_set_lod_origin(nullptr, &farOrigin));
+	EXPECT_NEAR(getDistance(), ENTITY_DISTANCE - LOD_HALF_EDGE, 1e-4f);
+
+	rgl_vec3f nearOrigin = {0.0f, 0.0f, ENTITY_DISTANCE - LOD_DISTANCE / 2.0f};
+	ASSERT_RGL_SUCCESS(rgl_scene_set_lod_origin(nullptr, &nearOrigin));
+	EXPECT_NEAR(getDistance(), ENTITY_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	// Removed LOD is no longer used.
+	ASSERT_RGL_SUCCESS(rgl_scene_set_lod_origin(nullptr, &farOrigin));
+	ASSERT_RGL_SUCCESS(rgl_entity_set_lod_mesh(entity, nullptr, LOD_DISTANCE));
+	EXPECT_NEAR(getDistance(), ENTITY_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+}
+
+TEST_F(EntityTest, rgl_entity_set_pose_repeatedly)
+{
+	// Moving a single entity many times exercises both IAS refits and periodic full rebuilds.
+	constexpr int FRAME_COUNT = 200;
+	constexpr float START_DISTANCE = 5.0f;
+	rgl_entity_t movingCube = spawnCubeOnScene(Mat3x4f::translation(0, 0, START_DISTANCE));
+	spawnCubeOnScene(Mat3x4f::translation(0, 10 * CUBE_HALF_EDGE, START_DISTANCE)); // Static, never hit
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+
+	for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+		float cubeDistance = START_DISTANCE + static_cast<float>(frame % 10);
+		auto pose = Mat3x4f::translation(0, 0, cubeDistance).toRGL();
+		ASSERT_RGL_SUCCESS(rgl_entity_set_pose(movingCube, &pose));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+
+		::Field<DISTANCE_F32>::type outDistance;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		EXPECT_NEAR(outDistance, cubeDistance - CUBE_HALF_EDGE, 1e-4f);
+	}
+}
+
+TEST_F(EntityTest, rgl_entity_modified_while_graph_is_running)
+{
+	// Graph raytraces the scene version from the moment it was run, later changes are visible in the next run.
+	constexpr int FRAME_COUNT = 50;
+	constexpr float START_DISTANCE = 5.0f;
+	rgl_entity_t movingCube = spawnCubeOnScene(Mat3x4f::translation(0, 0, START_DISTANCE));
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+
+	float cubeDistance = START_DISTANCE;
+	for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		float tracedDistance = cubeDistance;
+		cubeDistance = START_DISTANCE + static_cast<float>((frame + 1) % 10);
+		auto pose = Mat3x4f::translation(0, 0, cubeDistance).toRGL();
+		ASSERT_RGL_SUCCESS(rgl_entity_set_pose(movingCube, &pose));
+
+		::Field<DISTANCE_F32>::type outDistance;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		EXPECT_NEAR(outDistance, tracedDistance - CUBE_HALF_EDGE, 1e-4f);
+	}
+
+	// Destroying entity must not affect the run in progress.
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(movingCube));
+	::Field<DISTANCE_F32>::type outDistance;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, cubeDistance - CUBE_HALF_EDGE, 1e-4f);
+}
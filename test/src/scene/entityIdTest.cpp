@@ -110,3 +110,72 @@ TEST_F(EntityIdTest, BaseTest)
 //	}
 #endif
 }
+
+// Two entities sharing the same mesh must be distinguishable (shared hitgroup record, separate per-entity data).
+TEST_F(EntityIdTest, SharedMesh)
+{
+	constexpr int ENTITY1_ID = 1;
+	constexpr int ENTITY2_ID = 2;
+	constexpr float ENTITY2_X_POS = 10.0f;
+
+	rgl_mesh_t sharedMesh = makeCubeMesh();
+	rgl_entity_t entity1 = makeEntity(sharedMesh);
+	rgl_entity_t entity2 = makeEntity(sharedMesh);
+	auto pose1 = Mat3x4f::translation(0, 0, 5).toRGL();
+	auto pose2 = Mat3x4f::translation(ENTITY2_X_POS, 0, 5).toRGL();
+	EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity1, &pose1));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity2, &pose2));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_id(entity1, ENTITY1_ID));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_id(entity2, ENTITY2_ID));
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(ENTITY2_X_POS, 0, 0).toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+
+	std::vector<::Field<ENTITY_ID_I32>::type> outID(rays.size());
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, ENTITY_ID_I32, outID.data()));
+	EXPECT_EQ(outID[0], ENTITY1_ID);
+	EXPECT_EQ(outID[1], ENTITY2_ID);
+}
+
+// Class IDs are shared by entities and reported for hits only; changing one is visible in the next run.
+TEST_F(EntityIdTest, ClassId)
+{
+	constexpr int CLASS_ID = 42;
+	constexpr float ENTITY2_X_POS = 10.0f;
+
+	rgl_mesh_t sharedMesh = makeCubeMesh();
+	rgl_entity_t entity1 = makeEntity(sharedMesh);
+	rgl_entity_t entity2 = makeEntity(sharedMesh);
+	auto pose1 = Mat3x4f::translation(0, 0, 5).toRGL();
+	auto pose2 = Mat3x4f::translation(ENTITY2_X_POS, 0, 5).toRGL();
+	EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity1, &pose1));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity2, &pose2));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_class_id(nullptr, CLASS_ID), "entity != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_class_id(entity1, -1), "class_id >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_class_id(entity1, 65536), "class_id >= 0");
+	EXPECT_RGL_SUCCESS(rgl_entity_set_class_id(entity1, CLASS_ID));
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(ENTITY2_X_POS, 0, 0).toRGL(),
+	                                 Mat3x4f::translation(-ENTITY2_X_POS, 0, 0).toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+
+	std::vector<::Field<CLASS_ID_U16>::type> outClassId(rays.size());
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, CLASS_ID_U16, outClassId.data()));
+	EXPECT_EQ(outClassId[0], CLASS_ID);
+	EXPECT_EQ(outClassId[1], RGL_DEFAULT_CLASS_ID);
+	EXPECT_EQ(outClassId[2], RGL_DEFAULT_CLASS_ID); // Non-hit
+
+	EXPECT_RGL_SUCCESS(rgl_entity_set_class_id(entity2, CLASS_ID));
+	EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, CLASS_ID_U16, outClassId.data()));
+	EXPECT_EQ(outClassId[0], CLASS_ID);
+	EXPECT_EQ(outClassId[1], CLASS_ID);
+}
@@ -126,6 +126,55 @@ struct TestScene
 	std::vector<DynamicCube> cubes;
 };
 
+class EntityVelocityTest : public RGLTest
+{};
+
+TEST_F(EntityVelocityTest, velocity_is_measured_from_pose_at_previous_frame_time)
+{
+	constexpr uint64_t NS_PER_SECOND = 1'000'000'000;
+	rgl_entity_t cube = makeEntity();
+
+	// A single ray along Z axis hits the cube moving along it.
+	rgl_node_t raysNode = nullptr, raytraceNode = nullptr, yieldNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	std::vector<rgl_field_t> fields = {IS_HIT_I32, ABSOLUTE_VELOCITY_VEC3_F32};
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&raysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, yieldNode));
+
+	auto setFrame = [&](uint64_t timeS, std::optional<float> cubeZ) {
+		ASSERT_RGL_SUCCESS(rgl_scene_set_time(nullptr, timeS * NS_PER_SECOND));
+		if (cubeZ.has_value()) {
+			rgl_mat3x4f pose = Mat3x4f::translation(0, 0, *cubeZ).toRGL();
+			ASSERT_RGL_SUCCESS(rgl_entity_set_pose(cube, &pose));
+		}
+	};
+	auto getVelocityZ = [&]() {
+		::Field<IS_HIT_I32>::type isHit{};
+		::Field<ABSOLUTE_VELOCITY_VEC3_F32>::type velocity{};
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(yieldNode, IS_HIT_I32, &isHit));
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(yieldNode, ABSOLUTE_VELOCITY_VEC3_F32, &velocity));
+		EXPECT_TRUE(isHit);
+		return velocity.z();
+	};
+
+	setFrame(0, 5.0f);
+	setFrame(1, 6.0f);
+	EXPECT_NEAR(getVelocityZ(), 1.0f, 1e-4f);
+
+	// Not posed in this frame, so it stays still, although nothing in the scene has changed.
+	setFrame(2, std::nullopt);
+	EXPECT_NEAR(getVelocityZ(), 0.0f, 1e-4f);
+
+	// Not posed in the previous frame: its pose then is interpolated between the ones set at 1 s and 4 s.
+	setFrame(3, std::nullopt);
+	setFrame(4, 8.0f);
+	EXPECT_NEAR(getVelocityZ(), 2.0f / 3.0f, 1e-4f);
+}
+
 /**
  * This test is meant to be run together with RViz2 to visualize results.
  * - linear velocity
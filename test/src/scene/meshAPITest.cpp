@@ -2,6 +2,14 @@
 #include <helpers/sceneHelpers.hpp>
 #include <helpers/mathHelpers.hpp>
 
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include <optix.h>
+
+#include <RGLFields.hpp>
+
 #define VERTICES cubeVertices
 #define INDICES cubeIndices
 
@@ -36,6 +44,22 @@ TEST_F(MeshTest, rgl_mesh_create_destroy)
 	EXPECT_RGL_INVALID_OBJECT(rgl_mesh_destroy((rgl_mesh_t) 0x1234), "Mesh 0x1234");
 }
 
+TEST_F(MeshTest, stale_handle_should_be_invalid_after_slot_reuse)
+{
+	rgl_mesh_t staleMesh = makeCubeMesh();
+	ASSERT_RGL_SUCCESS(rgl_mesh_destroy(staleMesh));
+
+	// The released slot is reused, but the new handle has a different generation.
+	rgl_mesh_t mesh = makeCubeMesh();
+	EXPECT_NE(mesh, staleMesh);
+	bool isAlive = true;
+	ASSERT_RGL_SUCCESS(rgl_mesh_is_alive(staleMesh, &isAlive));
+	EXPECT_FALSE(isAlive);
+	EXPECT_RGL_INVALID_OBJECT(rgl_mesh_update_vertices(staleMesh, VERTICES, ARRAY_SIZE(VERTICES)), "Mesh");
+	ASSERT_RGL_SUCCESS(rgl_mesh_is_alive(mesh, &isAlive));
+	EXPECT_TRUE(isAlive);
+}
+
 TEST_F(MeshTest, rgl_mesh_update_vertices)
 {
 	rgl_mesh_t mesh = makeCubeMesh();
@@ -50,4 +74,534 @@ TEST_F(MeshTest, rgl_mesh_update_vertices)
 
 	// Correct update_vertices
 	EXPECT_RGL_SUCCESS(rgl_mesh_update_vertices(mesh, VERTICES, ARRAY_SIZE(VERTICES)));
-}
\ No newline at end of file
+}
+
+TEST_F(MeshTest, batch_create_update)
+{
+	constexpr int MESH_COUNT = 2;
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr float CUBE_SPACING = 10.0f;
+
+	std::array<rgl_mesh_t, MESH_COUNT> meshes{};
+	std::array<const rgl_vec3f*, MESH_COUNT> vertices = {cubeVertices, cubeVertices};
+	std::array<int32_t, MESH_COUNT> vertexCounts = {ARRAY_SIZE(cubeVertices), ARRAY_SIZE(cubeVertices)};
+	std::array<const rgl_vec3i*, MESH_COUNT> indices = {cubeIndices, cubeIndices};
+	std::array<int32_t, MESH_COUNT> indexCounts = {ARRAY_SIZE(cubeIndices), ARRAY_SIZE(cubeIndices)};
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_batch(nullptr, 0, nullptr, nullptr, nullptr, nullptr), "out_meshes != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_batch(meshes.data(), 0, nullptr, nullptr, nullptr, nullptr), "mesh_count > 0");
+	std::array<int32_t, MESH_COUNT> invalidCounts = {ARRAY_SIZE(cubeVertices), 0};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_batch(meshes.data(), MESH_COUNT, vertices.data(), invalidCounts.data(),
+	                                                  indices.data(), indexCounts.data()),
+	                            "vertex_counts[i] > 0");
+
+	// Correct create
+	ASSERT_RGL_SUCCESS(rgl_mesh_create_batch(meshes.data(), MESH_COUNT, vertices.data(), vertexCounts.data(), indices.data(),
+	                                         indexCounts.data()));
+	std::vector<rgl_mat3x4f> rays;
+	for (int i = 0; i < MESH_COUNT; ++i) {
+		ASSERT_THAT(meshes[i], NotNull());
+		rgl_entity_t entity = makeEntity(meshes[i]);
+		rgl_mat3x4f pose = Mat3x4f::translation(i * CUBE_SPACING, 0, CUBE_DISTANCE).toRGL();
+		ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+		rays.push_back(Mat3x4f::translation(i * CUBE_SPACING, 0, 0).toRGL());
+	}
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+
+	auto expectDistances = [&](float halfEdge) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		std::array<::Field<DISTANCE_F32>::type, MESH_COUNT> outDistances{};
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, outDistances.data()));
+		for (auto&& distance : outDistances) {
+			EXPECT_NEAR(distance, CUBE_DISTANCE - halfEdge, 1e-4f);
+		}
+	};
+	expectDistances(CUBE_HALF_EDGE);
+
+	// Invalid update
+	std::array<int32_t, MESH_COUNT> mismatchedCounts = {ARRAY_SIZE(cubeVertices), ARRAY_SIZE(cubeVertices) + 1};
+	std::array<const rgl_vec3f*, MESH_COUNT> verticesX2 = {cubeVerticesX2, cubeVerticesX2};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_update_vertices_batch(meshes.data(), MESH_COUNT, verticesX2.data(),
+	                                                           mismatchedCounts.data()),
+	                            "vertex counts do not match");
+	expectDistances(CUBE_HALF_EDGE); // No mesh is modified when validation fails
+
+	// Correct update
+	ASSERT_RGL_SUCCESS(rgl_mesh_update_vertices_batch(meshes.data(), MESH_COUNT, verticesX2.data(), vertexCounts.data()));
+	expectDistances(2 * CUBE_HALF_EDGE);
+}
+
+TEST_F(MeshTest, async_create)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	rgl_mesh_t mesh = nullptr;
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_async(nullptr, nullptr, 0, nullptr, 0), "out_mesh != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_async(&mesh, VERTICES, ARRAY_SIZE(VERTICES), INDICES, 0), "index_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_is_ready(nullptr, nullptr), "mesh != nullptr");
+
+	// Synchronously created meshes are always ready
+	bool isReady = false;
+	rgl_mesh_t syncMesh = makeCubeMesh();
+	ASSERT_RGL_SUCCESS(rgl_mesh_is_ready(syncMesh, &isReady));
+	EXPECT_TRUE(isReady);
+
+	// Entity may be created before the mesh is ready; it becomes visible in the first run after that.
+	ASSERT_RGL_SUCCESS(rgl_mesh_create_async(&mesh, VERTICES, ARRAY_SIZE(VERTICES), INDICES, ARRAY_SIZE(INDICES)));
+	rgl_entity_t entity = makeEntity(mesh);
+	rgl_mat3x4f pose = Mat3x4f::translation(0, 0, CUBE_DISTANCE).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	do {
+		ASSERT_RGL_SUCCESS(rgl_mesh_is_ready(mesh, &isReady));
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	} while (!isReady && std::chrono::steady_clock::now() < deadline);
+	ASSERT_TRUE(isReady);
+
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	::Field<DISTANCE_F32>::type outDistance = 0.0f;
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	// Operations on the mesh are available as on any other
+	EXPECT_RGL_SUCCESS(rgl_mesh_update_vertices(mesh, VERTICES, ARRAY_SIZE(VERTICES)));
+}
+
+TEST_F(MeshTest, gas_eviction)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	rgl_mesh_t mesh = makeCubeMesh();
+	rgl_entity_t entity = makeEntity(mesh);
+	rgl_mat3x4f pose = Mat3x4f::translation(0, 0, CUBE_DISTANCE).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	auto runAndGetDistance = [&]() {
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		::Field<DISTANCE_F32>::type outDistance = 0.0f;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		return outDistance;
+	};
+	EXPECT_NEAR(runAndGetDistance(), CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_get_memory_usage(nullptr), "out_usage != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_configure_gas_eviction(0, -1), "min_unused_frames >= 0");
+	rgl_memory_usage_t usage{};
+	ASSERT_RGL_SUCCESS(rgl_get_memory_usage(&usage));
+	EXPECT_GT(usage.gas_bytes, 0);
+	EXPECT_GT(usage.gas_scratch_bytes, 0);
+	EXPECT_GT(usage.mesh_bytes, 0);
+	EXPECT_GT(usage.ias_bytes, 0);
+	EXPECT_GT(usage.sbt_bytes, 0);
+	uint64_t usedGASBytes = usage.gas_bytes;
+
+	// The mesh is kept by the client, but no longer used by the scene; its GAS is evicted once no version refers to it.
+	ASSERT_RGL_SUCCESS(rgl_configure_gas_eviction(0, 0));
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(entity));
+	runAndGetDistance();
+	runAndGetDistance();
+	ASSERT_RGL_SUCCESS(rgl_get_memory_usage(&usage));
+	EXPECT_LT(usage.gas_bytes, usedGASBytes);
+
+	// Evicted GAS is built again when the mesh is used
+	entity = makeEntity(mesh);
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+	EXPECT_NEAR(runAndGetDistance(), CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	ASSERT_RGL_SUCCESS(rgl_configure_gas_eviction(UINT64_MAX, 0));
+}
+
+TEST_F(MeshTest, mesh_cache)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	rgl_mat3x4f pose = Mat3x4f::translation(0, 0, CUBE_DISTANCE).toRGL();
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	auto spawnAndGetDistance = [&](rgl_mesh_t mesh) {
+		rgl_entity_t entity = makeEntity(mesh);
+		EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		::Field<DISTANCE_F32>::type outDistance = 0.0f;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		EXPECT_RGL_SUCCESS(rgl_entity_destroy(entity));
+		return outDistance;
+	};
+	auto getUsage = []() {
+		rgl_memory_usage_t usage{};
+		EXPECT_RGL_SUCCESS(rgl_get_memory_usage(&usage));
+		return usage;
+	};
+	ASSERT_RGL_SUCCESS(rgl_configure_mesh_cache(true, UINT64_MAX));
+
+	// The destroyed mesh is retained with its GAS and given again (with a new handle) for the same geometry.
+	rgl_mesh_t mesh = makeCubeMesh();
+	EXPECT_NEAR(spawnAndGetDistance(mesh), CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	rgl_memory_usage_t usedUsage = getUsage();
+	ASSERT_RGL_SUCCESS(rgl_mesh_destroy(mesh));
+	EXPECT_EQ(getUsage().mesh_bytes, usedUsage.mesh_bytes);
+	EXPECT_EQ(getUsage().gas_bytes, usedUsage.gas_bytes);
+	rgl_mesh_t reusedMesh = makeCubeMesh();
+	EXPECT_NE(reusedMesh, mesh);
+	EXPECT_RGL_INVALID_OBJECT(rgl_mesh_destroy(mesh), "Mesh");
+	EXPECT_NEAR(spawnAndGetDistance(reusedMesh), CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	EXPECT_EQ(getUsage().mesh_bytes, usedUsage.mesh_bytes);
+	EXPECT_EQ(getUsage().gas_bytes, usedUsage.gas_bytes);
+
+	// Modified meshes are not retained.
+	ASSERT_RGL_SUCCESS(rgl_mesh_update_vertices(reusedMesh, VERTICES, ARRAY_SIZE(VERTICES)));
+	ASSERT_RGL_SUCCESS(rgl_mesh_destroy(reusedMesh));
+	EXPECT_LT(getUsage().mesh_bytes, usedUsage.mesh_bytes);
+
+	// Disabling the cache frees retained meshes.
+	mesh = makeCubeMesh();
+	ASSERT_RGL_SUCCESS(rgl_mesh_destroy(mesh));
+	EXPECT_EQ(getUsage().mesh_bytes, usedUsage.mesh_bytes);
+	ASSERT_RGL_SUCCESS(rgl_configure_mesh_cache(false, 0));
+	EXPECT_LT(getUsage().mesh_bytes, usedUsage.mesh_bytes);
+}
+
+TEST_F(MeshTest, skinning)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr int VERTEX_COUNT = ARRAY_SIZE(VERTICES);
+	rgl_mesh_t mesh = makeCubeMesh();
+	rgl_entity_t entity = makeEntity(mesh);
+	rgl_mat3x4f pose = Mat3x4f::translation(0, 0, CUBE_DISTANCE).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+
+	// Vertices with negative z follow the second bone, the others are blended halfway between both bones.
+	std::vector<int32_t> boneIndices(4 * VERTEX_COUNT, 0);
+	std::vector<float> boneWeights(4 * VERTEX_COUNT, 0.0f);
+	for (int i = 0; i < VERTEX_COUNT; ++i) {
+		boneIndices[4 * i + 1] = 1;
+		boneWeights[4 * i] = VERTICES[i].value[2] < 0 ? 0.0f : 0.5f;
+		boneWeights[4 * i + 1] = VERTICES[i].value[2] < 0 ? 1.0f : 0.5f;
+	}
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_skinning(mesh, boneIndices.data(), boneWeights.data(), VERTEX_COUNT, 1),
+	                            "out of range");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_skinning(mesh, boneIndices.data(), boneWeights.data(), VERTEX_COUNT - 1, 2),
+	                            "vertex counts do not match");
+	std::vector<float> unnormalizedWeights(4 * VERTEX_COUNT, 1.0f);
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_skinning(mesh, boneIndices.data(), unnormalizedWeights.data(), VERTEX_COUNT, 2),
+	                            "sum up to 1");
+	rgl_mat3x4f identity = Mat3x4f::identity().toRGL();
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_update_bones(mesh, &identity, 1), "without skinning");
+
+	ASSERT_RGL_SUCCESS(rgl_mesh_set_skinning(mesh, boneIndices.data(), boneWeights.data(), VERTEX_COUNT, 2));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_update_bones(mesh, &identity, 1), "bone counts do not match");
+
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	auto expectDistance = [&](float expectedDistance) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		::Field<DISTANCE_F32>::type outDistance = 0.0f;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		EXPECT_NEAR(outDistance, expectedDistance, 1e-4f);
+	};
+
+	// Identity bones keep the bind pose
+	std::array<rgl_mat3x4f, 2> bones = {identity, identity};
+	ASSERT_RGL_SUCCESS(rgl_mesh_update_bones(mesh, bones.data(), bones.size()));
+	expectDistance(CUBE_DISTANCE - CUBE_HALF_EDGE);
+
+	// The near face (negative z) follows the second bone entirely
+	bones[1] = Mat3x4f::translation(0, 0, -1.0f).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_mesh_update_bones(mesh, bones.data(), bones.size()));
+	expectDistance(CUBE_DISTANCE - CUBE_HALF_EDGE - 1.0f);
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_compress(mesh, RGL_VERTEX_FORMAT_FLOAT16), "skinned");
+}
+
+TEST_F(MeshTest, curves)
+{
+	constexpr float CURVE_DISTANCE = 5.0f;
+	// Polyline across the ray, thicker in the middle, and a separate segment behind it.
+	std::vector<rgl_vec3f> vertices = {
+	    {-1.0f, 0.0f, CURVE_DISTANCE},
+	    {0.0f, 0.0f, CURVE_DISTANCE},
+	    {1.0f, 0.0f, CURVE_DISTANCE},
+	    {0.0f, -1.0f, 2 * CURVE_DISTANCE},
+	    {0.0f, 1.0f, 2 * CURVE_DISTANCE},
+	};
+	std::vector<float> radii = {0.1f, 0.5f, 0.1f, 0.2f, 0.2f};
+	std::vector<int32_t> segments = {0, 1, 3};
+	rgl_mesh_t mesh = nullptr;
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_curves(&mesh, vertices.data(), radii.data(), 1, segments.data(), 1),
+	                            "vertex_count > 1");
+	std::vector<int32_t> negativeSegments = {-1};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_curves(&mesh, vertices.data(), radii.data(), vertices.size(),
+	                                                   negativeSegments.data(), negativeSegments.size()),
+	                            "segment_indices[i] >= 0");
+	std::vector<int32_t> danglingSegments = {4};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_curves(&mesh, vertices.data(), radii.data(), vertices.size(),
+	                                                   danglingSegments.data(), danglingSegments.size()),
+	                            "no next vertex");
+	std::vector<float> zeroRadii(vertices.size(), 0.0f);
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_curves(&mesh, vertices.data(), zeroRadii.data(), vertices.size(),
+	                                                   segments.data(), segments.size()),
+	                            "must be positive");
+
+	ASSERT_RGL_SUCCESS(
+	    rgl_mesh_create_curves(&mesh, vertices.data(), radii.data(), vertices.size(), segments.data(), segments.size()));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_compress(mesh, RGL_VERTEX_FORMAT_FLOAT16), "spheres or curves");
+	makeEntity(mesh);
+
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	::Field<DISTANCE_F32>::type outDistance = 0.0f;
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, CURVE_DISTANCE - 0.5f, 1e-3f);
+
+	// Vertices are control points, so moving the polyline away reveals the segment behind it.
+	vertices[1].value[1] = vertices[0].value[1] = vertices[2].value[1] = 10.0f;
+	ASSERT_RGL_SUCCESS(rgl_mesh_update_vertices(mesh, vertices.data(), vertices.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, 2 * CURVE_DISTANCE - 0.2f, 1e-3f);
+}
+
+#if OPTIX_VERSION >= 70500
+TEST_F(MeshTest, spheres)
+{
+	constexpr float SPHERE_DISTANCE = 5.0f;
+	std::vector<rgl_vec3f> centers = {
+	    {0.0f, 0.0f, SPHERE_DISTANCE},
+	    {0.0f, 0.0f, 2 * SPHERE_DISTANCE},
+	};
+	std::vector<float> radii = {0.5f, 1.0f};
+	rgl_mesh_t mesh = nullptr;
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_spheres(&mesh, centers.data(), nullptr, 2), "radii != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_spheres(&mesh, centers.data(), radii.data(), 0), "sphere_count > 0");
+	std::vector<float> negativeRadii = {0.5f, -1.0f};
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_create_spheres(&mesh, centers.data(), negativeRadii.data(), 2), "must be positive");
+
+	ASSERT_RGL_SUCCESS(rgl_mesh_create_spheres(&mesh, centers.data(), radii.data(), centers.size()));
+	std::vector<rgl_vec2f> uvs(centers.size());
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_texture_coords(mesh, uvs.data(), uvs.size()), "spheres or curves");
+	rgl_entity_t entity = makeEntity(mesh);
+
+	rgl_mat3x4f ray = Mat3x4f::identity().toRGL();
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, &ray, 1));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	::Field<DISTANCE_F32>::type outDistance = 0.0f;
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, SPHERE_DISTANCE - 0.5f, 1e-3f);
+
+	// Spheres are regular meshes, transformed by their entities.
+	rgl_mat3x4f pose = Mat3x4f::translation(0, 0, 1.0f).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+	EXPECT_NEAR(outDistance, SPHERE_DISTANCE + 0.5f, 1e-3f);
+}
+#endif
+
+#if OPTIX_VERSION >= 70600
+TEST_F(MeshTest, opacity_micromap)
+{
+	constexpr float QUAD_DISTANCE = 5.0f;
+	// Quad facing the rays, with the left half of its texture transparent.
+	std::vector<rgl_vec3f> vertices = {
+	    {-1.0f, -1.0f, QUAD_DISTANCE},
+	    {1.0f, -1.0f, QUAD_DISTANCE},
+	    {1.0f, 1.0f, QUAD_DISTANCE},
+	    {-1.0f, 1.0f, QUAD_DISTANCE},
+	};
+	std::vector<rgl_vec3i> indices = {
+	    {0, 1, 2},
+	    {0, 2, 3},
+	};
+	std::vector<rgl_vec2f> uvs = {
+	    {0.0f, 0.0f},
+	    {1.0f, 0.0f},
+	    {1.0f, 1.0f},
+	    {0.0f, 1.0f},
+	};
+	std::vector<uint8_t> alpha = {0, 255};
+	rgl_mesh_t mesh = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_mesh_create(&mesh, vertices.data(), vertices.size(), indices.data(), indices.size()));
+
+	// Invalid args
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_opacity_micromap(mesh, nullptr, 2, 1, 0.5f, 4), "alpha_texels != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_opacity_micromap(mesh, alpha.data(), 2, 1, 0.5f, 4), "texture coordinates");
+	ASSERT_RGL_SUCCESS(rgl_mesh_set_texture_coords(mesh, uvs.data(), uvs.size()));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_opacity_micromap(mesh, alpha.data(), 2, 1, 0.5f, 13), "out of range");
+
+	makeEntity(mesh);
+	std::vector<rgl_mat3x4f> rays;
+	for (float y : {0.5f, -0.5f}) {
+		rays.emplace_back(Mat3x4f::translation(-0.5f, y, 0).toRGL());
+		rays.emplace_back(Mat3x4f::translation(0.5f, y, 0).toRGL());
+	}
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	auto expectHits = [&](const std::vector<::Field<IS_HIT_I32>::type>& expectedHits) {
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		std::vector<::Field<IS_HIT_I32>::type> isHit(rays.size());
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, IS_HIT_I32, isHit.data()));
+		EXPECT_EQ(isHit, expectedHits);
+	};
+
+	// Without any micromap, the quad is solid.
+	expectHits({1, 1, 1, 1});
+
+	// Each triangle spans both halves of the texture, so both get micromaps.
+	ASSERT_RGL_SUCCESS(rgl_mesh_set_opacity_micromap(mesh, alpha.data(), 2, 1, 0.5f, 4));
+	expectHits({0, 1, 0, 1});
+
+	// Cutoff above any alpha makes the whole quad transparent (predefined state, no micromap).
+	ASSERT_RGL_SUCCESS(rgl_mesh_set_opacity_micromap(mesh, alpha.data(), 2, 1, 1.5f, 4));
+	expectHits({0, 0, 0, 0});
+}
+#endif
+
+TEST_F(MeshTest, gas_compaction)
+{
+	constexpr int FRAME_COUNT = 10;
+	constexpr int STATIC_FRAME_COUNT = 2;
+	constexpr float CUBE_DISTANCE = 5.0f;
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_configure_gas_compaction(nullptr, true, -1), "static_frame_count >= 0");
+	ASSERT_RGL_SUCCESS(rgl_scene_configure_gas_compaction(nullptr, true, STATIC_FRAME_COUNT));
+	spawnCubeOnScene(Mat3x4f::translation(0, 0, CUBE_DISTANCE));
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+
+	// Results must be the same before, during and after compaction.
+	for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+		ASSERT_RGL_SUCCESS(rgl_scene_set_time(nullptr, frame * 1'000'000));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+
+		::Field<DISTANCE_F32>::type outDistance;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		EXPECT_NEAR(outDistance, CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	}
+
+	ASSERT_RGL_SUCCESS(rgl_scene_configure_gas_compaction(nullptr, false, 0));
+}
+
+TEST_F(MeshTest, keyframes)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+	constexpr int KEYFRAME_COUNT = 3;
+	rgl_mesh_t mesh = makeCubeMesh();
+	std::vector<rgl_vec3f> keyframeVertices;
+	for (int keyframe = 0; keyframe < KEYFRAME_COUNT; ++keyframe) {
+		for (auto&& vertex : cubeVertices) {
+			keyframeVertices.push_back({vertex.value[0], vertex.value[1], vertex.value[2] + static_cast<float>(keyframe)});
+		}
+	}
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_keyframes(nullptr, keyframeVertices.data(), keyframeVertices.size(), 1),
+	                            "mesh != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_keyframes(mesh, keyframeVertices.data(), keyframeVertices.size(), 0),
+	                            "keyframe_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_keyframes(mesh, keyframeVertices.data(), keyframeVertices.size(), 2),
+	                            "vertex counts do not match");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_keyframe(mesh, -1), "keyframe_index >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_set_keyframe(mesh, 0), "out of range");
+	ASSERT_RGL_SUCCESS(rgl_mesh_set_keyframes(mesh, keyframeVertices.data(), keyframeVertices.size(), KEYFRAME_COUNT));
+
+	rgl_entity_t entity = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_entity_create(&entity, nullptr, mesh));
+	rgl_mat3x4f pose = Mat3x4f::translation(0, 0, CUBE_DISTANCE).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	auto getDistance = [&]() {
+		::Field<DISTANCE_F32>::type outDistance;
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		return outDistance;
+	};
+	EXPECT_NEAR(getDistance(), CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f); // First keyframe
+
+	// Looping over keyframes builds no GASes.
+	rgl_performance_counters_t countersBefore, countersAfter;
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&countersBefore));
+	for (int frame = 0; frame < 2 * KEYFRAME_COUNT; ++frame) {
+		int keyframe = frame % KEYFRAME_COUNT;
+		ASSERT_RGL_SUCCESS(rgl_mesh_set_keyframe(mesh, keyframe));
+		EXPECT_NEAR(getDistance(), CUBE_DISTANCE + static_cast<float>(keyframe) - CUBE_HALF_EDGE, 1e-4f);
+	}
+	ASSERT_RGL_SUCCESS(rgl_get_performance_counters(&countersAfter));
+	EXPECT_EQ(countersAfter.gas_build_count, countersBefore.gas_build_count);
+
+	// Updating vertices leaves keyframes.
+	ASSERT_RGL_SUCCESS(rgl_mesh_update_vertices(mesh, cubeVertices, ARRAY_SIZE(cubeVertices)));
+	EXPECT_NEAR(getDistance(), CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	ASSERT_RGL_SUCCESS(rgl_mesh_set_keyframe(mesh, 2));
+	EXPECT_NEAR(getDistance(), CUBE_DISTANCE + 2.0f - CUBE_HALF_EDGE, 1e-4f);
+}
+
+TEST_F(MeshTest, rgl_mesh_compress)
+{
+	constexpr float CUBE_DISTANCE = 5.0f;
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_compress(nullptr, RGL_VERTEX_FORMAT_FLOAT16), "mesh != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_compress(makeCubeMesh(), static_cast<rgl_vertex_format_t>(3)), "vertex_format");
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+
+	// Hit points are computed from compressed vertices, which represent the cube exactly in any format.
+	for (auto format : {RGL_VERTEX_FORMAT_FLOAT32, RGL_VERTEX_FORMAT_FLOAT16, RGL_VERTEX_FORMAT_SNORM16}) {
+		rgl_mesh_t mesh = makeCubeMesh();
+		ASSERT_RGL_SUCCESS(rgl_mesh_compress(mesh, format));
+		EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_compress(mesh, format), "already compressed");
+		EXPECT_RGL_INVALID_ARGUMENT(rgl_mesh_update_vertices(mesh, VERTICES, ARRAY_SIZE(VERTICES)), "compressed mesh");
+
+		rgl_entity_t entity = makeEntity(mesh);
+		rgl_mat3x4f pose = Mat3x4f::translation(0, 0, CUBE_DISTANCE).toRGL();
+		ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+		ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		::Field<DISTANCE_F32>::type outDistance;
+		ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &outDistance));
+		EXPECT_NEAR(outDistance, CUBE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+		ASSERT_RGL_SUCCESS(rgl_entity_destroy(entity));
+	}
+}
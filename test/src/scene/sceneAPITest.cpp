@@ -0,0 +1,268 @@
+#include <cuda_runtime.h>
+
+#include "helpers/commonHelpers.hpp"
+#include "helpers/sceneHelpers.hpp"
+
+#include "RGLFields.hpp"
+
+#include <array>
+#include <thread>
+
+using namespace ::testing;
+
+class SceneTest : public RGLTest
+{
+protected:
+	// Traces a single ray along Z axis, where test cubes are placed.
+	static rgl_node_t makeRaytraceGraph(rgl_scene_t scene)
+	{
+		rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+		std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+		EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+		EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, scene));
+		EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+		return raytraceNode;
+	}
+
+	static ::Field<DISTANCE_F32>::type runAndGetDistance(rgl_node_t raytraceNode)
+	{
+		EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+		::Field<IS_HIT_I32>::type isHit = 0;
+		::Field<DISTANCE_F32>::type distance = 0.0f;
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, IS_HIT_I32, &isHit));
+		EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, DISTANCE_F32, &distance));
+		return isHit ? distance : std::numeric_limits<float>::infinity();
+	}
+
+	static rgl_entity_t spawnCube(rgl_scene_t scene, float distance)
+	{
+		rgl_entity_t entity = nullptr;
+		rgl_mat3x4f pose = Mat3x4f::translation(0, 0, distance).toRGL();
+		EXPECT_RGL_SUCCESS(rgl_entity_create(&entity, scene, makeCubeMesh()));
+		EXPECT_RGL_SUCCESS(rgl_entity_set_pose(entity, &pose));
+		return entity;
+	}
+};
+
+TEST_F(SceneTest, rgl_scene_create_destroy)
+{
+	rgl_scene_t scene = nullptr;
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_create(nullptr), "out_scene != nullptr");
+	ASSERT_RGL_SUCCESS(rgl_scene_create(&scene));
+	ASSERT_THAT(scene, NotNull());
+
+	// Entities are destroyed along with their scene.
+	rgl_entity_t entity = spawnCube(scene, 5.0f);
+	ASSERT_RGL_SUCCESS(rgl_scene_destroy(scene));
+	bool isAlive = true;
+	ASSERT_RGL_SUCCESS(rgl_entity_is_alive(entity, &isAlive));
+	EXPECT_FALSE(isAlive);
+
+	EXPECT_RGL_INVALID_OBJECT(rgl_scene_destroy(scene), "Scene");
+	EXPECT_RGL_INVALID_OBJECT(rgl_scene_set_time(scene, 0), "Scene");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_destroy(nullptr), "scene != nullptr");
+	EXPECT_RGL_INVALID_OBJECT(rgl_scene_destroy((rgl_scene_t) 0x1234), "Scene 0x1234");
+}
+
+TEST_F(SceneTest, scenes_should_be_independent)
+{
+	constexpr float DEFAULT_SCENE_DISTANCE = 5.0f;
+	constexpr float OTHER_SCENE_DISTANCE = 10.0f;
+	rgl_scene_t otherScene = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_scene_create(&otherScene));
+	spawnCube(nullptr, DEFAULT_SCENE_DISTANCE);
+	rgl_entity_t otherCube = spawnCube(otherScene, OTHER_SCENE_DISTANCE);
+
+	rgl_node_t defaultGraph = makeRaytraceGraph(nullptr);
+	rgl_node_t otherGraph = makeRaytraceGraph(otherScene);
+	EXPECT_NEAR(runAndGetDistance(defaultGraph), DEFAULT_SCENE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	EXPECT_NEAR(runAndGetDistance(otherGraph), OTHER_SCENE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	// Removing an entity from one scene does not affect the other one.
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(otherCube));
+	EXPECT_EQ(runAndGetDistance(otherGraph), std::numeric_limits<float>::infinity());
+	EXPECT_NEAR(runAndGetDistance(defaultGraph), DEFAULT_SCENE_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+
+	// Time is kept per scene.
+	std::vector<rgl_field_t> fields = {TIME_STAMP_F64};
+	rgl_node_t yieldNode = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_scene_set_time(nullptr, 1'000'000'000));
+	ASSERT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, fields.data(), fields.size()));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(otherGraph, yieldNode));
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(otherGraph), "TIME_STAMP_F64");
+	ASSERT_RGL_SUCCESS(rgl_scene_set_time(otherScene, 1'000'000'000));
+	EXPECT_RGL_SUCCESS(rgl_graph_run(otherGraph));
+}
+
+TEST_F(SceneTest, rgl_scene_fork_should_branch_from_checkpoint)
+{
+	constexpr float FORKED_DISTANCE = 5.0f;
+	rgl_scene_t scene = nullptr, checkpoint = nullptr, branch = nullptr, otherBranch = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_scene_create(&scene));
+	rgl_entity_t cube = spawnCube(scene, FORKED_DISTANCE);
+	rgl_entity_t otherCube = spawnCube(nullptr, FORKED_DISTANCE);
+
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_fork(nullptr, scene, nullptr, 0, nullptr), "out_scene != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_fork(&checkpoint, scene, nullptr, -1, nullptr), "entity_count >= 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_fork(&checkpoint, scene, nullptr, 1, nullptr), "entities != nullptr");
+	rgl_entity_t branchCube = nullptr;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_fork(&checkpoint, scene, &otherCube, 1, &branchCube), "does not belong");
+
+	// Modifying the source or the fork does not affect the other one.
+	ASSERT_RGL_SUCCESS(rgl_scene_fork(&checkpoint, scene, nullptr, 0, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_scene_fork(&branch, checkpoint, nullptr, 0, nullptr));
+	rgl_entity_t otherBranchCube = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_scene_fork(&otherBranch, scene, &cube, 1, &otherBranchCube));
+	rgl_mat3x4f farPose = Mat3x4f::translation(0, 0, 2 * FORKED_DISTANCE).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(cube, &farPose));
+	EXPECT_NEAR(runAndGetDistance(makeRaytraceGraph(scene)), 2 * FORKED_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	EXPECT_NEAR(runAndGetDistance(makeRaytraceGraph(branch)), FORKED_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(otherBranchCube));
+	EXPECT_EQ(runAndGetDistance(makeRaytraceGraph(otherBranch)), std::numeric_limits<float>::infinity());
+
+	// The checkpoint, never raytraced, may be forked again.
+	ASSERT_RGL_SUCCESS(rgl_scene_destroy(branch));
+	ASSERT_RGL_SUCCESS(rgl_scene_fork(&branch, checkpoint, nullptr, 0, nullptr));
+	EXPECT_NEAR(runAndGetDistance(makeRaytraceGraph(branch)), FORKED_DISTANCE - CUBE_HALF_EDGE, 1e-4f);
+}
+
+TEST_F(SceneTest, graph_raytracing_different_scenes_should_be_invalid)
+{
+	rgl_scene_t otherScene = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_scene_create(&otherScene));
+
+	rgl_node_t useRaysNode = nullptr, defaultRaytrace = nullptr, otherRaytrace = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&defaultRaytrace, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&otherRaytrace, otherScene));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, defaultRaytrace));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, otherRaytrace));
+
+	EXPECT_RGL_INVALID_PIPELINE(rgl_graph_run(useRaysNode), "same scene");
+}
+
+TEST_F(SceneTest, static_and_dynamic_entities_should_be_raytraced)
+{
+	rgl_entity_t staticCube = spawnCube(nullptr, 5.0f);
+	rgl_entity_t dynamicCube = spawnCube(nullptr, 10.0f);
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_static(nullptr, true), "entity != nullptr");
+	ASSERT_RGL_SUCCESS(rgl_entity_set_static(staticCube, true));
+	rgl_node_t raytraceNode = makeRaytraceGraph(nullptr);
+	EXPECT_NEAR(runAndGetDistance(raytraceNode), 5.0f - CUBE_HALF_EDGE, 1e-4f);
+
+	// Moving either entity is visible, regardless of which IAS is rebuilt.
+	rgl_mat3x4f pose = Mat3x4f::translation(0, 0, 3.0f).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(dynamicCube, &pose));
+	EXPECT_NEAR(runAndGetDistance(raytraceNode), 3.0f - CUBE_HALF_EDGE, 1e-4f);
+	pose = Mat3x4f::translation(0, 0, 2.0f).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(staticCube, &pose));
+	EXPECT_NEAR(runAndGetDistance(raytraceNode), 2.0f - CUBE_HALF_EDGE, 1e-4f);
+
+	// Only static entities left, then none.
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(dynamicCube));
+	EXPECT_NEAR(runAndGetDistance(raytraceNode), 2.0f - CUBE_HALF_EDGE, 1e-4f);
+	ASSERT_RGL_SUCCESS(rgl_entity_set_static(staticCube, false));
+	EXPECT_NEAR(runAndGetDistance(raytraceNode), 2.0f - CUBE_HALF_EDGE, 1e-4f);
+	ASSERT_RGL_SUCCESS(rgl_entity_destroy(staticCube));
+	EXPECT_EQ(runAndGetDistance(raytraceNode), std::numeric_limits<float>::infinity());
+}
+
+TEST_F(SceneTest, entities_and_graphs_should_be_used_from_different_threads)
+{
+	constexpr int ITERATIONS = 100;
+	constexpr float MIN_DISTANCE = 5.0f, MAX_DISTANCE = 10.0f;
+	rgl_entity_t cube = spawnCube(nullptr, MIN_DISTANCE);
+	std::array<rgl_node_t, 2> graphs = {makeRaytraceGraph(nullptr), makeRaytraceGraph(nullptr)};
+
+	std::vector<std::thread> threads;
+	threads.emplace_back([&]() {
+		for (int i = 0; i < ITERATIONS; ++i) {
+			float distance = MIN_DISTANCE + (MAX_DISTANCE - MIN_DISTANCE) * static_cast<float>(i) / ITERATIONS;
+			rgl_mat3x4f pose = Mat3x4f::translation(0, 0, distance).toRGL();
+			EXPECT_RGL_SUCCESS(rgl_entity_set_pose(cube, &pose));
+		}
+	});
+	for (auto&& graph : graphs) {
+		threads.emplace_back([graph]() {
+			for (int i = 0; i < ITERATIONS; ++i) {
+				float distance = runAndGetDistance(graph);
+				EXPECT_GE(distance, MIN_DISTANCE - CUBE_HALF_EDGE - 1e-4f);
+				EXPECT_LE(distance, MAX_DISTANCE - CUBE_HALF_EDGE + 1e-4f);
+			}
+		});
+	}
+	for (auto&& thread : threads) {
+		thread.join();
+	}
+}
+
+TEST_F(SceneTest, last_error_should_be_kept_per_thread)
+{
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_create(nullptr), "out_scene != nullptr");
+	std::thread([]() {
+		rgl_scene_t scene = nullptr;
+		EXPECT_RGL_SUCCESS(rgl_scene_create(&scene));
+	}).join();
+	const char* error = nullptr;
+	rgl_get_last_error_string(&error);
+	EXPECT_THAT(error, HasSubstr("out_scene != nullptr"));
+}
+
+TEST_F(SceneTest, rgl_scene_raycast_batch_invalid_arguments)
+{
+	rgl_vec3f origin = {0, 0, 0}, direction = {0, 0, 1};
+	rgl_raycast_hit_t hit;
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_raycast_batch(nullptr, nullptr, &direction, 1, 10.0f, &hit), "origins != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_raycast_batch(nullptr, &origin, nullptr, 1, 10.0f, &hit), "directions != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_raycast_batch(nullptr, &origin, &direction, 0, 10.0f, &hit), "ray_count > 0");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_raycast_batch(nullptr, &origin, &direction, 1, 0.0f, &hit), "max_distance > 0.0f");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_scene_raycast_batch(nullptr, &origin, &direction, 1, 10.0f, nullptr),
+	                            "out_hits != nullptr");
+}
+
+TEST_F(SceneTest, rgl_scene_raycast_batch_should_report_closest_hits)
+{
+	constexpr int32_t CUBE_ID = 7;
+	rgl_scene_t scene = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_scene_create(&scene));
+	ASSERT_RGL_SUCCESS(rgl_entity_set_id(spawnCube(scene, 5.0f), CUBE_ID));
+
+	// Towards the cube, away from it and towards it from the other side (with a non-normalized direction).
+	std::vector<rgl_vec3f> origins = {{0, 0, 0}, {0, 0, 0}, {0, 0, 10}};
+	std::vector<rgl_vec3f> directions = {{0, 0, 1}, {0, 0, -1}, {0, 0, -2}};
+	auto checkHits = [&](const std::vector<rgl_raycast_hit_t>& hits) {
+		EXPECT_NEAR(hits[0].distance, 4.0f, 1e-4f);
+		EXPECT_EQ(hits[0].entity_id, CUBE_ID);
+		EXPECT_EQ(hits[1].distance, std::numeric_limits<float>::infinity());
+		EXPECT_EQ(hits[1].entity_id, RGL_ENTITY_INVALID_ID);
+		EXPECT_NEAR(hits[2].distance, 4.0f, 1e-4f);
+		EXPECT_EQ(hits[2].entity_id, CUBE_ID);
+	};
+	std::vector<rgl_raycast_hit_t> hits(origins.size());
+	ASSERT_RGL_SUCCESS(rgl_scene_raycast_batch(scene, origins.data(), directions.data(), origins.size(), 100.0f, hits.data()));
+	checkHits(hits);
+
+	// Surfaces beyond the maximum distance are not hit.
+	ASSERT_RGL_SUCCESS(rgl_scene_raycast_batch(scene, origins.data(), directions.data(), 1, 3.0f, hits.data()));
+	EXPECT_EQ(hits[0].distance, std::numeric_limits<float>::infinity());
+
+	// Arrays may be in device memory as well.
+	rgl_vec3f *dOrigins = nullptr, *dDirections = nullptr;
+	rgl_raycast_hit_t* dHits = nullptr;
+	ASSERT_EQ(cudaMalloc(&dOrigins, origins.size() * sizeof(rgl_vec3f)), cudaSuccess);
+	ASSERT_EQ(cudaMalloc(&dDirections, directions.size() * sizeof(rgl_vec3f)), cudaSuccess);
+	ASSERT_EQ(cudaMalloc(&dHits, hits.size() * sizeof(rgl_raycast_hit_t)), cudaSuccess);
+	ASSERT_EQ(cudaMemcpy(dOrigins, origins.data(), origins.size() * sizeof(rgl_vec3f), cudaMemcpyHostToDevice), cudaSuccess);
+	ASSERT_EQ(cudaMemcpy(dDirections, directions.data(), directions.size() * sizeof(rgl_vec3f), cudaMemcpyHostToDevice),
+	          cudaSuccess);
+	ASSERT_RGL_SUCCESS(rgl_scene_raycast_batch(scene, dOrigins, dDirections, origins.size(), 100.0f, dHits));
+	std::vector<rgl_raycast_hit_t> deviceHits(hits.size());
+	ASSERT_EQ(cudaMemcpy(deviceHits.data(), dHits, hits.size() * sizeof(rgl_raycast_hit_t), cudaMemcpyDeviceToHost),
+	          cudaSuccess);
+	checkHits(deviceHits);
+	EXPECT_EQ(cudaFree(dOrigins), cudaSuccess);
+	EXPECT_EQ(cudaFree(dDirections), cudaSuccess);
+	EXPECT_EQ(cudaFree(dHits), cudaSuccess);
+}
@@ -36,6 +36,12 @@ TEST_F(TextureTest, rgl_texture_invalid_argument)
 	EXPECT_RGL_INVALID_ARGUMENT(rgl_texture_create(&texture, textureRawData.data(), -1, 100), "width > 0");
 	initializeArgumentsLambda();
 	EXPECT_RGL_INVALID_ARGUMENT(rgl_texture_create(&texture, textureRawData.data(), 100, 0), "height > 0");
+	initializeArgumentsLambda();
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_texture_create_mipmapped(&texture, textureRawData.data(), 8, 8, 0, RGL_TEXTURE_FORMAT_R8),
+	                            "mip_level_count > 0");
+	initializeArgumentsLambda();
+	EXPECT_RGL_INVALID_ARGUMENT(
+	    rgl_texture_create_mipmapped(&texture, textureRawData.data(), 99, 99, 1, RGL_TEXTURE_FORMAT_BC4), "multiples of 4");
 }
 
 TEST_P(TextureTest, rgl_texture_reading)
@@ -138,3 +144,112 @@ TEST_P(TextureTest, rgl_texture_use_case)
 
 #endif
 }
+
+// Uniform texture is preserved by BC4 compression and in every mip level, which is selected based on the beam footprint.
+TEST_P(TextureTest, rgl_texture_mipmapped_reading)
+{
+	auto [width, height, value] = GetParam();
+	int paddedWidth = (width + 3) / 4 * 4, paddedHeight = (height + 3) / 4 * 4;
+
+	rgl_texture_t texture = nullptr;
+	rgl_entity_t entity = nullptr;
+	rgl_mesh_t mesh = makeCubeMesh();
+	auto textureRawData = generateStaticColorTexture<TextureTexelFormat>(paddedWidth, paddedHeight, value);
+
+	EXPECT_RGL_SUCCESS(rgl_texture_create_mipmapped(&texture, textureRawData.data(), paddedWidth, paddedHeight, 8,
+	                                                RGL_TEXTURE_FORMAT_BC4));
+	EXPECT_RGL_SUCCESS(rgl_mesh_set_texture_coords(mesh, cubeUVs, ARRAY_SIZE(cubeUVs)));
+	EXPECT_RGL_SUCCESS(rgl_entity_create(&entity, nullptr, mesh));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_intensity_texture(entity, texture));
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr, compactNode = nullptr, yieldNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = makeLidar3dRays(360, 360, 0.36, 0.36);
+	std::vector<rgl_field_t> yieldFields = {INTENSITY_F32};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace_configure_beam_divergence(raytraceNode, 0.1f, 1, RGL_BEAM_REDUCTION_NEAREST));
+	EXPECT_RGL_SUCCESS(rgl_node_points_compact_by_field(&compactNode, RGL_FIELD_IS_HIT_I32));
+	EXPECT_RGL_SUCCESS(rgl_node_points_yield(&yieldNode, yieldFields.data(), yieldFields.size()));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(raytraceNode, compactNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(compactNode, yieldNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+
+	int32_t outCount = 0, outSizeOf = 0;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_size(yieldNode, INTENSITY_F32, &outCount, &outSizeOf));
+	std::vector<::Field<INTENSITY_F32>::type> outIntensity(outCount);
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(yieldNode, INTENSITY_F32, outIntensity.data()));
+	for (auto&& intensity : outIntensity) {
+		EXPECT_NEAR(((float) value), intensity, EPSILON_F);
+	}
+}
+
+// Textures created from identical data share GPU memory, which must outlive each of them.
+TEST_F(TextureTest, identical_textures_should_be_independent)
+{
+	constexpr TextureTexelFormat VALUE = 100;
+	auto textureRawData = generateStaticColorTexture<TextureTexelFormat>(64, 64, VALUE);
+	rgl_texture_t texture = nullptr, identicalTexture = nullptr;
+	ASSERT_RGL_SUCCESS(rgl_texture_create(&texture, textureRawData.data(), 64, 64));
+	ASSERT_RGL_SUCCESS(rgl_texture_create(&identicalTexture, textureRawData.data(), 64, 64));
+	EXPECT_NE(texture, identicalTexture);
+
+	rgl_mesh_t mesh = makeCubeMesh();
+	rgl_entity_t entity = nullptr;
+	EXPECT_RGL_SUCCESS(rgl_mesh_set_texture_coords(mesh, cubeUVs, ARRAY_SIZE(cubeUVs)));
+	EXPECT_RGL_SUCCESS(rgl_entity_create(&entity, nullptr, mesh));
+	EXPECT_RGL_SUCCESS(rgl_entity_set_intensity_texture(entity, identicalTexture));
+	ASSERT_RGL_SUCCESS(rgl_texture_destroy(texture));
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL()};
+	EXPECT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	EXPECT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	EXPECT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	EXPECT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+
+	::Field<INTENSITY_F32>::type outIntensity = 0.0f;
+	EXPECT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, INTENSITY_F32, &outIntensity));
+	EXPECT_NEAR(static_cast<float>(VALUE), outIntensity, EPSILON_F);
+}
+
+// Entities without textures report their constant intensity; textured ones sample the texture instead.
+TEST_F(TextureTest, constant_intensity_without_texture)
+{
+	constexpr float INTENSITY = 42.0f;
+	constexpr float TEXTURE_VALUE = 100.0f;
+	constexpr float ENTITY2_X_POS = 10.0f;
+
+	rgl_mesh_t mesh = makeCubeMesh();
+	rgl_entity_t entity1 = makeEntity(mesh);
+	rgl_entity_t entity2 = makeEntity(mesh);
+	auto pose1 = Mat3x4f::translation(0, 0, 5).toRGL();
+	auto pose2 = Mat3x4f::translation(ENTITY2_X_POS, 0, 5).toRGL();
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity1, &pose1));
+	ASSERT_RGL_SUCCESS(rgl_entity_set_pose(entity2, &pose2));
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_intensity(nullptr, INTENSITY), "entity != nullptr");
+	EXPECT_RGL_INVALID_ARGUMENT(rgl_entity_set_intensity(entity1, -1.0f), "intensity >= 0.0f");
+	ASSERT_RGL_SUCCESS(rgl_entity_set_intensity(entity1, INTENSITY));
+
+	rgl_node_t useRaysNode = nullptr, raytraceNode = nullptr;
+	std::vector<rgl_mat3x4f> rays = {Mat3x4f::identity().toRGL(), Mat3x4f::translation(ENTITY2_X_POS, 0, 0).toRGL()};
+	ASSERT_RGL_SUCCESS(rgl_node_rays_from_mat3x4f(&useRaysNode, rays.data(), rays.size()));
+	ASSERT_RGL_SUCCESS(rgl_node_raytrace(&raytraceNode, nullptr));
+	ASSERT_RGL_SUCCESS(rgl_graph_node_add_child(useRaysNode, raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+
+	std::vector<::Field<INTENSITY_F32>::type> outIntensity(rays.size());
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, INTENSITY_F32, outIntensity.data()));
+	EXPECT_NEAR(outIntensity[0], INTENSITY, EPSILON_F);
+	EXPECT_NEAR(outIntensity[1], 0.0f, EPSILON_F);
+
+	// The texture takes precedence.
+	rgl_texture_t texture = nullptr;
+	auto textureRawData = generateStaticColorTexture<TextureTexelFormat>(4, 4, static_cast<TextureTexelFormat>(TEXTURE_VALUE));
+	ASSERT_RGL_SUCCESS(rgl_texture_create(&texture, textureRawData.data(), 4, 4));
+	ASSERT_RGL_SUCCESS(rgl_mesh_set_texture_coords(mesh, cubeUVs, ARRAY_SIZE(cubeUVs)));
+	ASSERT_RGL_SUCCESS(rgl_entity_set_intensity_texture(entity1, texture));
+	ASSERT_RGL_SUCCESS(rgl_graph_run(raytraceNode));
+	ASSERT_RGL_SUCCESS(rgl_graph_get_result_data(raytraceNode, INTENSITY_F32, outIntensity.data()));
+	EXPECT_NEAR(outIntensity[0], TEXTURE_VALUE, EPSILON_F);
+}
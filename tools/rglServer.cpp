@@ -0,0 +1,197 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "spdlog/fmt/fmt.h"
+#include "api/apiCommon.hpp"
+#include "tape/TapePlayer.hpp"
+#include "macros/checkRGL.hpp"
+
+/**
+ * Server mode: a single process owns the GPU context, OptiX and the map (meshes and their GASes, played from a tape),
+ * and serves many simulation clients connected through a local (Unix domain) socket, so that shared assets take
+ * GPU memory once per machine instead of once per client. Listening on a TCP port, it serves as a remote worker
+ * replicating the scene of another process (see rgl_replication_begin).
+ *
+ * Each client gets its own Scene, forked from the map (see rgl_scene_fork), in place of the default one.
+ * Clients stream API calls encoded as in tapes (see BinaryTapeStreamCallHeader) and receive the status of each call;
+ * object arguments are IDs chosen by the client, e.g. its handles. Results are meant to be received through shared
+ * memory, e.g. with rgl_node_points_shm_publish, whose ring buffers (and CUDA IPC handles of device buffers) local clients
+ * open directly; remote workers publish them with their graphs. Objects of a client are destroyed when it disconnects.
+ */
+
+static constexpr std::size_t MAX_REQUEST_BYTES = std::size_t{1} << 30;
+
+static bool readExactly(int fd, void* data, std::size_t size)
+{
+	auto* bytes = static_cast<char*>(data);
+	while (size > 0) {
+		ssize_t count = read(fd, bytes, size);
+		if (count <= 0) {
+			return false; // Disconnected
+		}
+		bytes += count;
+		size -= count;
+	}
+	return true;
+}
+
+static bool writeExactly(int fd, const void* data, std::size_t size)
+{
+	const auto* bytes = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t count = send(fd, bytes, size, MSG_NOSIGNAL);
+		if (count <= 0) {
+			return false;
+		}
+		bytes += count;
+		size -= count;
+	}
+	return true;
+}
+
+static int listenOn(std::string_view address)
+{
+	bool isTcp = address.starts_with("tcp:");
+	int fd = socket(isTcp ? AF_INET : AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	int status = -1;
+	if (isTcp) {
+		int reuse = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		sockaddr_in tcpAddress{.sin_family = AF_INET, .sin_port = htons(std::stoi(std::string(address.substr(4))))};
+		tcpAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+		status = bind(fd, reinterpret_cast<sockaddr*>(&tcpAddress), sizeof(tcpAddress));
+	}
+	else {
+		sockaddr_un unixAddress{.sun_family = AF_UNIX};
+		if (address.size() >= sizeof(unixAddress.sun_path)) {
+			close(fd);
+			errno = ENAMETOOLONG;
+			return -1;
+		}
+		address.copy(unixAddress.sun_path, address.size());
+		unlink(unixAddress.sun_path);
+		status = bind(fd, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress));
+	}
+	if (status != 0 || listen(fd, SOMAXCONN) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static void serveClient(int fd)
+{
+	PlaybackState state;
+	CHECK_RGL(rgl_scene_fork(&state.defaultScene, nullptr, nullptr, 0, nullptr));
+	std::string fnName;
+	std::vector<uint8_t> args, binary;
+	BinaryTapeStreamCallHeader request{};
+	while (readExactly(fd, &request, sizeof(request))) {
+		std::size_t requestBytes = std::size_t{request.fnNameSize} + request.argsSize + request.binarySize;
+		if (request.magic != BINARY_TAPE_STREAM_MAGIC || requestBytes > MAX_REQUEST_BYTES) {
+			fmt::print(stderr, "rglServer: invalid request, disconnecting the client\n");
+			break;
+		}
+		fnName.resize(request.fnNameSize);
+		args.resize(request.argsSize);
+		binary.resize(request.binarySize);
+		if (!readExactly(fd, fnName.data(), fnName.size()) || !readExactly(fd, args.data(), args.size()) ||
+		    !readExactly(fd, binary.data(), binary.size())) {
+			break;
+		}
+		rgl_status_t status = RGL_SUCCESS;
+		std::string error;
+		try {
+			TapeCall call = decodeBinaryTapeCall(fnName, request.timestampNs, args.data(), args.size());
+			// Global calls would affect all clients; the version is recorded at the beginning of each stream.
+			if (TapePlayer::isGlobalCall(call.getFnName())) {
+				throw std::invalid_argument(fmt::format("{} is not allowed in server mode", call.getFnName()));
+			}
+			state.setBinaryData(binary.data(), binary.size());
+			lastStatusCode = RGL_SUCCESS;
+			TapePlayer::playCall(call, state);
+			if (lastStatusCode != RGL_SUCCESS) {
+				status = lastStatusCode;
+				error = getLastErrorString();
+			}
+		}
+		catch (std::exception& e) {
+			status = RGL_TAPE_ERROR;
+			error = e.what();
+		}
+		BinaryTapeStreamStatus response{.status = status, .errorSize = static_cast<uint32_t>(error.size())};
+		if (!writeExactly(fd, &response, sizeof(response)) || !writeExactly(fd, error.data(), error.size())) {
+			break;
+		}
+	}
+	state.destroyObjects();
+	close(fd);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3) {
+		fmt::print(stderr, "USAGE: {} <socket-path>|tcp:<port> [<path-to-map-tape-without-suffix>]\n", argv[0]);
+		fmt::print(stderr, "  The map tape is played once into the default scene, which clients' scenes are forked from\n");
+		return 1;
+	}
+	const char* listenAddress = argv[1];
+	std::optional<TapePlayer> mapPlayer; // Keeps handles of the map alive
+	if (argc == 3) {
+		mapPlayer.emplace(argv[2]);
+		mapPlayer->playUntil();
+	}
+
+	int listenFd = listenOn(listenAddress);
+	if (listenFd < 0) {
+		fmt::print(stderr, "rglServer: cannot listen on {}: {}\n", listenAddress, std::strerror(errno));
+		return 1;
+	}
+	fmt::print("rglServer: listening on {}\n", listenAddress);
+	while (true) {
+		int clientFd = accept(listenFd, nullptr, nullptr);
+		if (clientFd < 0) {
+			fmt::print(stderr, "rglServer: accept failed: {}\n", std::strerror(errno));
+			continue;
+		}
+		// Clients use separate scenes and graphs, so their calls may be played concurrently.
+		std::thread([clientFd]() {
+			try {
+				serveClient(clientFd);
+			}
+			catch (std::exception& e) {
+				fmt::print(stderr, "rglServer: client failed: {}\n", e.what());
+				close(clientFd);
+			}
+		}).detach();
+	}
+}
@@ -0,0 +1,167 @@
+// Copyright 2024 Robotec.AI
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#include "spdlog/fmt/fmt.h"
+
+namespace fs = std::filesystem;
+
+// Exit code telling `git bisect run` that the revision cannot be tested (e.g. the tape cannot be played).
+static constexpr int BISECT_SKIP_EXIT_CODE = 125;
+
+/**
+ * A line of the report written by `tapePlayer --benchmark --report`.
+ */
+struct ReportedCall
+{
+	std::string fnName;
+	double meanLatencyMs;
+	std::string resultChecksum; // "-" if the call does not read results
+};
+
+static std::vector<ReportedCall> readReport(const fs::path& path)
+{
+	std::ifstream file{path};
+	if (!file) {
+		throw std::runtime_error(fmt::format("cannot read report {}", path.string()));
+	}
+	std::vector<ReportedCall> calls;
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line.starts_with('#')) {
+			continue;
+		}
+		std::stringstream fields{line};
+		std::size_t idx = 0;
+		ReportedCall call;
+		if (!(fields >> idx >> call.fnName >> call.meanLatencyMs >> call.resultChecksum) || idx != calls.size()) {
+			throw std::runtime_error(fmt::format("invalid line in report {}: {}", path.string(), line));
+		}
+		calls.push_back(call);
+	}
+	return calls;
+}
+
+/**
+ * Benchmarks the tape with the given tapePlayer executable (linked with the RGL build to compare) and reads its report.
+ * Output of the player is kept in a log next to the report.
+ */
+static std::vector<ReportedCall> playTape(std::string_view label, const std::string& playerPath, const std::string& tapePath,
+                                          int loopCount)
+{
+	fs::path reportPath = fs::temp_directory_path() / fmt::format("tapeCompare-{}-{}.tsv", getpid(), label);
+	fs::path logPath = fs::path(reportPath).replace_extension(".log");
+	std::string command = fmt::format("'{}' --benchmark --loops {} --report '{}' '{}' > '{}' 2>&1", playerPath, loopCount,
+	                                  reportPath.string(), tapePath, logPath.string());
+	fmt::print("Playing with {} build: {}\n", label, playerPath);
+	if (std::system(command.c_str()) != 0) {
+		throw std::runtime_error(fmt::format("{} build failed to play the tape, see {}", label, logPath.string()));
+	}
+	auto calls = readReport(reportPath);
+	fs::remove(reportPath);
+	return calls;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string_view> args(argv + 1, argv + argc);
+	auto takeOption = [&](std::string_view name) -> std::optional<std::string> {
+		auto option = std::ranges::find(args, name);
+		if (option == args.end() || std::next(option) == args.end()) {
+			return std::nullopt;
+		}
+		std::string value{*std::next(option)};
+		args.erase(option, std::next(option, 2));
+		return value;
+	};
+	int loopCount = std::stoi(takeOption("--loops").value_or("3"));
+	double thresholdPercent = std::stod(takeOption("--threshold").value_or("10"));
+	if (args.size() != 3 || loopCount < 1 || thresholdPercent < 0.0) {
+		fmt::print(stderr,
+		           "USAGE: {} [--loops <count>] [--threshold <percent>] <baseline-tapePlayer> <candidate-tapePlayer> "
+		           "<path-to-tape-without-suffix>\n",
+		           argv[0]);
+		fmt::print(stderr, "  Plays the tape with tapePlayer executables of two RGL builds and compares latencies of calls\n");
+		fmt::print(stderr, "  and checksums of results read by the tape. Exits with 1 if results differ or any function\n");
+		fmt::print(stderr, "  is slower by more than the threshold (10% by default), and with 125 if a build cannot play\n");
+		fmt::print(stderr, "  the tape, so that it may be used with `git bisect run`.\n");
+		return 2;
+	}
+
+	std::vector<ReportedCall> baseline, candidate;
+	try {
+		baseline = playTape("baseline", std::string(args[0]), std::string(args[2]), loopCount);
+		candidate = playTape("candidate", std::string(args[1]), std::string(args[2]), loopCount);
+	}
+	catch (std::exception& e) {
+		fmt::print(stderr, "tapeCompare: {}\n", e.what());
+		return BISECT_SKIP_EXIT_CODE;
+	}
+	if (baseline.size() != candidate.size()) {
+		fmt::print(stderr, "tapeCompare: builds played different numbers of calls ({} vs {})\n", baseline.size(),
+		           candidate.size());
+		return BISECT_SKIP_EXIT_CODE;
+	}
+
+	struct FunctionTotals
+	{
+		int count{0};
+		double baselineMs{0.0};
+		double candidateMs{0.0};
+	};
+	std::map<std::string, FunctionTotals> functions;
+	std::vector<std::size_t> differentResults;
+	for (std::size_t idx = 0; idx < baseline.size(); ++idx) {
+		FunctionTotals& totals = functions[baseline[idx].fnName];
+		totals.count += 1;
+		totals.baselineMs += baseline[idx].meanLatencyMs;
+		totals.candidateMs += candidate[idx].meanLatencyMs;
+		if (baseline[idx].resultChecksum != candidate[idx].resultChecksum) {
+			differentResults.push_back(idx);
+		}
+	}
+
+	bool isRegression = false;
+	fmt::print("\n{:<48} {:>8} {:>14} {:>14} {:>9}\n", "[ms, sum of mean latencies]", "count", "baseline", "candidate",
+	           "change");
+	for (auto&& [fnName, totals] : functions) {
+		double changePercent = totals.baselineMs > 0.0 ? 100.0 * (totals.candidateMs / totals.baselineMs - 1.0) : 0.0;
+		bool isSlower = changePercent > thresholdPercent;
+		isRegression |= isSlower;
+		fmt::print("{:<48} {:>8} {:>14.3f} {:>14.3f} {:>+8.1f}%{}\n", fnName, totals.count, totals.baselineMs,
+		           totals.candidateMs, changePercent, isSlower ? " SLOWER" : "");
+	}
+
+	constexpr std::size_t MAX_PRINTED_DIFFERENCES = 20;
+	fmt::print("\nCalls with different results: {}\n", differentResults.size());
+	for (std::size_t i = 0; i < std::min(differentResults.size(), MAX_PRINTED_DIFFERENCES); ++i) {
+		std::size_t idx = differentResults[i];
+		fmt::print("  call {} {}: {} vs {}\n", idx, baseline[idx].fnName, baseline[idx].resultChecksum,
+		           candidate[idx].resultChecksum);
+	}
+	return isRegression || !differentResults.empty() ? 1 : 0;
+}
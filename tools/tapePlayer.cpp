@@ -12,19 +12,346 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <vector>
+
 #include "spdlog/fmt/fmt.h"
 #include "tape/TapePlayer.hpp"
+#include "graph/NodesCore.hpp"
+#include "macros/checkRGL.hpp"
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+/**
+ * Measurements of the tape played as fast as possible, see playBenchmark().
+ */
+struct BenchmarkStats
+{
+	// Bucket i counts latencies in [2^(i-1), 2^i) microseconds; the first one counts latencies below 1us.
+	static constexpr std::size_t HISTOGRAM_BUCKET_COUNT = 24;
+
+	struct Latencies
+	{
+		std::vector<double> samplesMs;
+		std::array<uint64_t, HISTOGRAM_BUCKET_COUNT> histogram{};
+
+		void add(double latencyMs)
+		{
+			samplesMs.push_back(latencyMs);
+			auto latencyUs = static_cast<uint64_t>(latencyMs * 1000.0);
+			std::size_t bucket = latencyUs == 0 ? 0 : std::bit_width(latencyUs);
+			histogram[std::min(bucket, HISTOGRAM_BUCKET_COUNT - 1)] += 1;
+		}
+	};
+
+	std::map<std::string, Latencies> callLatencies;
+	Latencies graphRunWallTimes;
+	Latencies graphRunGpuTimes;
+	uint64_t rayCount{0};
+	Milliseconds totalTime{0};
+
+	void addGraphRun(const Node::Ptr& runNode, Clock::time_point runBegin);
+	void print() const;
+};
+
+/**
+ * Latency and checksum of results of each call of the tape, written with --report and compared by tapeCompare.
+ */
+struct CallReport
+{
+	struct Entry
+	{
+		std::string fnName;
+		double totalLatencyMs{0.0};
+		int playCount{0};
+		std::optional<uint64_t> resultChecksum; // Of the last loop; only calls reading results to the host have one
+	};
+	std::vector<Entry> entries; // Indexed by calls of the tape
+
+	void addResultChecksum(TapePlayer::APICallIdx idx, rgl_node_t node, rgl_field_t field);
+	void write(const std::string& path) const;
+};
+
+/**
+ * Waits for the graph run to complete, so that its wall time and GPU time (summed over nodes) can be attributed to it.
+ * This prevents overlapping consecutive runs with the client's thread, but not runs of other graphs already in progress.
+ */
+void BenchmarkStats::addGraphRun(const Node::Ptr& runNode, Clock::time_point runBegin)
+{
+	std::set<Node::Ptr> nodes = runNode->getConnectedComponentNodes();
+	for (auto&& node : nodes) {
+		node->waitForResultsEnqueued();
+		CHECK_CUDA(cudaEventSynchronize(node->getExecCompletedEvent()));
+	}
+	graphRunWallTimes.add(Milliseconds(Clock::now() - runBegin).count());
+
+	double gpuTimeMs = 0.0;
+	for (auto&& node : nodes) {
+		rgl_node_stats_t stats = node->getStats();
+		gpuTimeMs += stats.exec_gpu_time_ms + stats.result_copy_gpu_time_ms;
+	}
+	graphRunGpuTimes.add(gpuTimeMs);
+
+	for (auto&& raytraceNode : Node::getNodesOfType<RaytraceNode>(nodes)) {
+		rayCount += raytraceNode->getRayCount();
+	}
+}
+
+void BenchmarkStats::print() const
+{
+	auto percentile = [](std::vector<double> samples, double fraction) {
+		std::ranges::sort(samples);
+		return samples[static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1))];
+	};
+	auto printRow = [&](std::string_view name, const Latencies& latencies) {
+		if (latencies.samplesMs.empty()) {
+			return;
+		}
+		const auto& samples = latencies.samplesMs;
+		double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+		fmt::print("{:<48} {:>8} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}\n", name, samples.size(), mean,
+		           percentile(samples, 0.5), percentile(samples, 0.9), percentile(samples, 0.99),
+		           *std::ranges::max_element(samples));
+	};
+	auto printHistogram = [](std::string_view name, const Latencies& latencies) {
+		fmt::print("{:<48}", name);
+		for (std::size_t bucket = 0; bucket < HISTOGRAM_BUCKET_COUNT; ++bucket) {
+			if (latencies.histogram[bucket] > 0) {
+				fmt::print(" <{}us:{}", uint64_t{1} << bucket, latencies.histogram[bucket]);
+			}
+		}
+		fmt::print("\n");
+	};
+
+	fmt::print("{:<48} {:>8} {:>10} {:>10} {:>10} {:>10} {:>10}\n", "[ms]", "count", "mean", "p50", "p90", "p99", "max");
+	for (auto&& [fnName, latencies] : callLatencies) {
+		printRow(fnName, latencies);
+	}
+	printRow("graph run: wall time", graphRunWallTimes);
+	printRow("graph run: GPU time (sum over nodes)", graphRunGpuTimes);
+
+	fmt::print("\nLatency histograms:\n");
+	for (auto&& [fnName, latencies] : callLatencies) {
+		printHistogram(fnName, latencies);
+	}
+
+	double totalSeconds = totalTime.count() / 1000.0;
+	fmt::print("\nTotal time: {:.3f} s, graph runs: {}, rays: {}, throughput: {:.3e} rays/s\n", totalSeconds,
+	           graphRunWallTimes.samplesMs.size(), rayCount, static_cast<double>(rayCount) / totalSeconds);
+}
+
+/**
+ * Reads the result again (outside of measured latency) and hashes it with FNV-1a.
+ * Results depending on random state (e.g. noise) differ between runs, so they are not comparable.
+ */
+void CallReport::addResultChecksum(TapePlayer::APICallIdx idx, rgl_node_t node, rgl_field_t field)
+{
+	int32_t count = 0, sizeOf = 0;
+	CHECK_RGL(rgl_graph_get_result_size(node, field, &count, &sizeOf));
+	std::vector<uint8_t> data(std::size_t(count) * sizeOf);
+	CHECK_RGL(rgl_graph_get_result_data(node, field, data.data()));
+	uint64_t checksum = 0xcbf29ce484222325;
+	for (auto&& byte : data) {
+		checksum = (checksum ^ byte) * 0x100000001b3;
+	}
+	entries.at(idx).resultChecksum = checksum;
+}
+
+void CallReport::write(const std::string& path) const
+{
+	std::ofstream file{path};
+	if (!file) {
+		throw std::invalid_argument(fmt::format("cannot write report to {}", path));
+	}
+	file << "# call\tfunction\tmean latency [ms]\tresult checksum\n";
+	for (std::size_t idx = 0; idx < entries.size(); ++idx) {
+		const Entry& entry = entries[idx];
+		double meanLatencyMs = entry.playCount > 0 ? entry.totalLatencyMs / entry.playCount : 0.0;
+		std::string checksum = entry.resultChecksum.has_value() ? fmt::format("{:016x}", *entry.resultChecksum) : "-";
+		file << fmt::format("{}\t{}\t{:.6f}\t{}\n", idx, entry.fnName, meanLatencyMs, checksum);
+	}
+}
+
+/**
+ * Plays the tape as fast as possible, measuring latency of each API call and each graph run.
+ */
+BenchmarkStats playBenchmark(TapePlayer& player, int loopCount, CallReport* report)
+{
+	// Time each node in every run, so that GPU time of graph runs can be reported.
+	CHECK_RGL(rgl_configure_performance_sampling(1));
+	BenchmarkStats stats;
+	if (report != nullptr) {
+		report->entries.resize(player.getTapeCallCount());
+	}
+	auto benchmarkBegin = Clock::now();
+	for (int loop = 0; loop < loopCount; ++loop) {
+		for (TapePlayer::APICallIdx idx = 0; idx < player.getTapeCallCount(); ++idx) {
+			TapeCall call = player.getTapeCall(idx);
+			auto callBegin = Clock::now();
+			player.playThis(idx);
+			double latencyMs = Milliseconds(Clock::now() - callBegin).count();
+			stats.callLatencies[call.getFnName()].add(latencyMs);
+			if (call.getFnName() == "rgl_graph_run") {
+				rgl_node_t runNode = player.getNodeHandle(call.getArgsNode()[0].as<TapeAPIObjectID>());
+				stats.addGraphRun(Node::validatePtr(runNode), callBegin);
+			}
+			if (report == nullptr) {
+				continue;
+			}
+			CallReport::Entry& entry = report->entries.at(idx);
+			entry.fnName = call.getFnName();
+			entry.totalLatencyMs += latencyMs;
+			entry.playCount += 1;
+			if (call.getFnName() == "rgl_graph_get_result_data" || call.getFnName() == "rgl_graph_get_result_data_async") {
+				rgl_node_t node = player.getNodeHandle(call.getArgsNode()[0].as<TapeAPIObjectID>());
+				report->addResultChecksum(idx, node, static_cast<rgl_field_t>(call.getArgsNode()[1].as<int>()));
+			}
+		}
+		player.reset();
+		CHECK_RGL(rgl_configure_performance_sampling(1)); // In case the tape has changed it
+	}
+	stats.totalTime = Clock::now() - benchmarkBegin;
+	return stats;
+}
+
+/**
+ * Benchmarks the tapes on up to jobCount threads at once; a single tape is played alone.
+ * Concurrent tapes are isolated (see TapePlayer::isolate), i.e. each one is played in a scene of its own
+ * and their global calls (e.g. rgl_configure_*) are skipped.
+ * Returns false if playing any of the tapes failed.
+ */
+bool playBenchmarks(const std::vector<std::string>& tapePaths, int jobCount, int loopCount,
+                    const std::optional<std::string>& reportPath)
+{
+	std::vector<std::optional<BenchmarkStats>> stats(tapePaths.size());
+	std::vector<std::string> errors(tapePaths.size());
+	std::atomic<std::size_t> nextTapeIdx{0};
+	auto playTapes = [&]() {
+		for (std::size_t tapeIdx = nextTapeIdx++; tapeIdx < tapePaths.size(); tapeIdx = nextTapeIdx++) {
+			try {
+				TapePlayer player{tapePaths[tapeIdx].c_str()};
+				if (jobCount > 1) {
+					player.isolate();
+				}
+				CallReport report;
+				stats[tapeIdx] = playBenchmark(player, loopCount, reportPath.has_value() ? &report : nullptr);
+				if (reportPath.has_value()) {
+					report.write(*reportPath);
+				}
+			}
+			catch (std::exception& e) {
+				errors[tapeIdx] = e.what();
+			}
+		}
+	};
+	auto benchmarkBegin = Clock::now();
+	std::vector<std::thread> workers;
+	for (int job = 0; job < std::min<int>(jobCount, tapePaths.size()); ++job) {
+		workers.emplace_back(playTapes);
+	}
+	for (auto&& worker : workers) {
+		worker.join();
+	}
+	Milliseconds totalTime = Clock::now() - benchmarkBegin;
+
+	uint64_t totalRayCount = 0;
+	for (std::size_t tapeIdx = 0; tapeIdx < tapePaths.size(); ++tapeIdx) {
+		if (tapePaths.size() > 1) {
+			fmt::print("\n=== {} ===\n", tapePaths[tapeIdx]);
+		}
+		if (!stats[tapeIdx].has_value()) {
+			fmt::print(stderr, "Playing {} failed: {}\n", tapePaths[tapeIdx], errors[tapeIdx]);
+			continue;
+		}
+		stats[tapeIdx]->print();
+		totalRayCount += stats[tapeIdx]->rayCount;
+	}
+	if (tapePaths.size() > 1) {
+		double totalSeconds = totalTime.count() / 1000.0;
+		fmt::print("\nAll tapes ({} jobs): {:.3f} s, rays: {}, throughput: {:.3e} rays/s\n", jobCount, totalSeconds,
+		           totalRayCount, static_cast<double>(totalRayCount) / totalSeconds);
+	}
+	return std::ranges::all_of(stats, [](auto&& tapeStats) { return tapeStats.has_value(); });
+}
+
+/**
+ * Plays frames [startFrame, startFrame + frameCount) in real time, seeking to the first one.
+ * Frames are delimited by rgl_graph_run calls, i.e. a frame begins with its run.
+ */
+void playFramesRealtime(TapePlayer& player, int startFrame, std::optional<int> frameCount)
+{
+	std::vector<TapePlayer::APICallIdx> runs = player.findAll({"rgl_graph_run"});
+	if (startFrame >= static_cast<int>(runs.size())) {
+		throw std::invalid_argument(
+		    fmt::format("start frame {} out of range, the tape has {} frames", startFrame, runs.size()));
+	}
+	player.seek(runs[startFrame]);
+	if (frameCount.has_value() && startFrame + frameCount.value() < static_cast<int>(runs.size())) {
+		player.playApproximatelyRealtime(runs[startFrame + frameCount.value()]);
+	}
+	else {
+		player.playApproximatelyRealtime();
+	}
+}
 
 int main(int argc, char** argv)
 {
-	if (argc != 2) {
-		fmt::print(stderr, "USAGE: {} <path-to-tape-without-suffix>\n", argv[0]);
+	std::vector<std::string_view> args(argv + 1, argv + argc);
+	auto takeStringOption = [&](std::string_view name) -> std::optional<std::string> {
+		auto option = std::ranges::find(args, name);
+		if (option == args.end() || std::next(option) == args.end()) {
+			return std::nullopt;
+		}
+		std::string value{*std::next(option)};
+		args.erase(option, std::next(option, 2));
+		return value;
+	};
+	auto takeOption = [&](std::string_view name) -> std::optional<int> {
+		auto value = takeStringOption(name);
+		return value.has_value() ? std::optional<int>(std::stoi(*value)) : std::nullopt;
+	};
+	bool isBenchmark = !args.empty() && args.front() == "--benchmark";
+	if (isBenchmark) {
+		args.erase(args.begin());
+	}
+	int loopCount = takeOption("--loops").value_or(1);
+	int jobCount = takeOption("--jobs").value_or(1);
+	std::optional<std::string> reportPath = takeStringOption("--report");
+	int startFrame = takeOption("--start-frame").value_or(0);
+	std::optional<int> frameCount = takeOption("--frame-count");
+	bool areTapeCountsValid = isBenchmark ? !args.empty() && (!reportPath.has_value() || args.size() == 1) : args.size() == 1;
+	if (!areTapeCountsValid || loopCount < 1 || jobCount < 1 || startFrame < 0 || frameCount.value_or(1) < 1) {
+		fmt::print(stderr,
+		           "USAGE: {} [--benchmark [--loops <count>] [--jobs <count>] [--report <path>]] "
+		           "[--start-frame <index> [--frame-count <count>]] <path-to-tape-without-suffix>...\n",
+		           argv[0]);
+		fmt::print(stderr, "  --benchmark    plays the tape as fast as possible and reports latencies and throughput\n");
+		fmt::print(stderr, "  --jobs         benchmarks up to the given number of tapes concurrently, each in its own scene\n");
+		fmt::print(stderr, "  --report       writes latency and result checksum of each call of the tape, see tapeCompare\n");
+		fmt::print(stderr, "  --start-frame  seeks to the given rgl_graph_run (skipping previous runs) before playing\n");
 		return 1;
 	}
-	TapePlayer player{argv[1]};
+	if (isBenchmark) {
+		return playBenchmarks(std::vector<std::string>(args.begin(), args.end()), jobCount, loopCount, reportPath) ? 0 : 1;
+	}
+	TapePlayer player{std::string(args.front()).c_str()};
 	while (true) {
-		player.playApproximatelyRealtime();
+		playFramesRealtime(player, startFrame, frameCount);
 		player.reset();
 	}
 	return 0;
-}
\ No newline at end of file
+}